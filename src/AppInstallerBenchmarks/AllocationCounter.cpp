@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new of the process to count allocations; the array and nothrow forms
+// are implemented by the runtime in terms of these. Only the count is kept, so the cost is one atomic increment.
+namespace
+{
+    std::atomic_size_t s_allocationCount{ 0 };
+}
+
+void* operator new(size_t size)
+{
+    ++s_allocationCount;
+
+    if (void* result = std::malloc(size ? size : 1))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace AppInstaller::Benchmarks
+{
+    size_t GetAllocationCount()
+    {
+        return s_allocationCount.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Benchmark.h"
+#include <SQLiteWrapper.h>
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        constexpr int s_GroupWidth = 20;
+        constexpr int s_NameWidth = 44;
+        constexpr int s_LatencyWidth = 12;
+        constexpr int s_CountWidth = 10;
+        constexpr int s_AllocationsWidth = 14;
+        constexpr int s_ThroughputWidth = 12;
+
+        std::string FormatLatency(std::chrono::nanoseconds latency)
+        {
+            std::ostringstream stream;
+            stream << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(latency).count() << "ms";
+            return stream.str();
+        }
+    }
+
+    void LatencySamples::Add(std::chrono::nanoseconds latency)
+    {
+        m_samples.emplace_back(latency);
+        m_sorted = false;
+    }
+
+    std::chrono::nanoseconds LatencySamples::Percentile(double percentile) const
+    {
+        if (m_samples.empty())
+        {
+            return {};
+        }
+
+        if (!m_sorted)
+        {
+            std::sort(m_samples.begin(), m_samples.end());
+            m_sorted = true;
+        }
+
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * m_samples.size()));
+        return m_samples[std::clamp<size_t>(rank, 1, m_samples.size()) - 1];
+    }
+
+    BenchmarkResult RunBenchmark(std::string group, std::string name, size_t iterations, const std::function<size_t()>& operation)
+    {
+        BenchmarkResult result;
+        result.Group = std::move(group);
+        result.Name = std::move(name);
+
+        try
+        {
+            result.ResultCount = operation();
+
+            size_t preparedBefore = SQLite::Statement::GetPreparedCount();
+            size_t allocationsBefore = GetAllocationCount();
+
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                auto start = std::chrono::steady_clock::now();
+                operation();
+                result.Samples.Add(std::chrono::steady_clock::now() - start);
+            }
+
+            if (iterations)
+            {
+                result.StatementsPerRun = static_cast<double>(SQLite::Statement::GetPreparedCount() - preparedBefore) / iterations;
+                result.AllocationsPerRun = static_cast<double>(GetAllocationCount() - allocationsBefore) / iterations;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            result.Completed = false;
+            result.Note = e.what();
+        }
+
+        return result;
+    }
+
+    void WriteReportHeader(std::ostream& out)
+    {
+        out << std::left << std::setw(s_GroupWidth) << "Group" << std::setw(s_NameWidth) << "Benchmark" << std::right <<
+            std::setw(s_LatencyWidth) << "p50" << std::setw(s_LatencyWidth) << "p99" <<
+            std::setw(s_CountWidth) << "Results" << std::setw(s_CountWidth) << "Prepared" << std::setw(s_AllocationsWidth) << "Allocations" <<
+            std::setw(s_ThroughputWidth) << "p50 MB/s" << std::setw(s_ThroughputWidth) << "p50 items/s" << std::endl;
+    }
+
+    void WriteReportLine(std::ostream& out, const BenchmarkResult& result)
+    {
+        out << std::left << std::setw(s_GroupWidth) << result.Group << std::setw(s_NameWidth) << result.Name << std::right;
+
+        if (result.Completed)
+        {
+            out << std::setw(s_LatencyWidth) << FormatLatency(result.Samples.Percentile(50)) <<
+                std::setw(s_LatencyWidth) << FormatLatency(result.Samples.Percentile(99)) <<
+                std::setw(s_CountWidth) << result.ResultCount <<
+                std::setw(s_CountWidth) << std::fixed << std::setprecision(1) << result.StatementsPerRun <<
+                std::setw(s_AllocationsWidth) << result.AllocationsPerRun;
+
+            double p50 = std::chrono::duration<double>(result.Samples.Percentile(50)).count();
+            if ((result.BytesPerRun || result.ItemsPerRun) && p50 > 0)
+            {
+                out << std::setw(s_ThroughputWidth) << std::setprecision(1) << (result.BytesPerRun / (1024.0 * 1024.0)) / p50;
+
+                if (result.ItemsPerRun)
+                {
+                    out << std::setw(s_ThroughputWidth) << result.ItemsPerRun / p50;
+                }
+            }
+        }
+        else
+        {
+            out << "  " << result.Note;
+        }
+
+        out << std::endl;
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The latencies of the runs of an operation.
+    struct LatencySamples
+    {
+        void Add(std::chrono::nanoseconds latency);
+
+        size_t Count() const { return m_samples.size(); }
+
+        // Gets the latency at the given percentile (0 to 100), using the nearest rank.
+        std::chrono::nanoseconds Percentile(double percentile) const;
+
+    private:
+        mutable std::vector<std::chrono::nanoseconds> m_samples;
+        mutable bool m_sorted = true;
+    };
+
+    // Gets the number of allocations made through the global operator new by the process.
+    size_t GetAllocationCount();
+
+    // A line of a benchmark report.
+    struct BenchmarkResult
+    {
+        std::string Group;
+        std::string Name;
+        // Whether the operation could be run; if not, Note holds the reason.
+        bool Completed = true;
+        LatencySamples Samples;
+        // The number of items produced by one run of the operation.
+        size_t ResultCount = 0;
+        // The number of SQLite statements prepared by one run of the operation.
+        double StatementsPerRun = 0;
+        // The number of allocations made by one run of the operation.
+        double AllocationsPerRun = 0;
+        // The number of bytes transferred by one run of the operation, if it is measured by throughput.
+        uint64_t BytesPerRun = 0;
+        // The number of requests, files or other items handled by one run of the operation, if it is measured by their rate.
+        double ItemsPerRun = 0;
+        std::string Note;
+    };
+
+    // Runs the operation the given number of times, timing each run and counting the statements prepared and allocations made.
+    // The operation returns the number of items that it produced. It is run once before timing, so that the first sample
+    // does not include one time costs; an exception from any run is reported as the operation not being completed.
+    BenchmarkResult RunBenchmark(std::string group, std::string name, size_t iterations, const std::function<size_t()>& operation);
+
+    // Writes the column headings of the report.
+    void WriteReportHeader(std::ostream& out);
+
+    // Writes a line of the report.
+    void WriteReportLine(std::ostream& out, const BenchmarkResult& result);
+}
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerRuntime.h>
+
+#include <filesystem>
+
+
+// The test hooks of the core libraries that the benchmarks use; they are declared by the tests in the same way.
+namespace AppInstaller
+{
+    namespace Runtime
+    {
+        void TestHook_SetPathOverride(PathName target, const std::filesystem::path& path);
+    }
+
+    namespace Utility
+    {
+        void TestHook_SetDownloadBufferSize(DWORD size);
+    }
+}
@@ -0,0 +1,368 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "CompositeSourceBenchmarks.h"
+#include "Benchmark.h"
+#include <Microsoft/SQLiteIndex.h>
+#include <Microsoft/SQLiteIndexSource.h>
+#include <SQLiteWrapper.h>
+#include <winget/Manifest.h>
+#include <winget/RepositorySource.h>
+
+using namespace std::string_view_literals;
+using namespace AppInstaller::Manifest;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        // A fixed seed, so that every run generates the same sources.
+        constexpr std::mt19937::result_type s_Seed = 0x436f6d70;
+
+        // How an installed package relates to the available source.
+        enum class Correlation
+        {
+            // The available source has a package with the same product code or package family name.
+            SystemReference,
+            // The available source has a package with the same name and publisher in its AppsAndFeaturesEntries.
+            NameAndPublisher,
+            // The available source has nothing for the package.
+            None,
+        };
+
+        // The real world names and publishers that the installed packages are made from, paired by line.
+        struct Corpus
+        {
+            std::vector<std::string> Names;
+            std::vector<std::string> Publishers;
+        };
+
+        std::vector<std::string> ReadLines(const std::filesystem::path& path)
+        {
+            std::ifstream stream{ path };
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), !stream);
+
+            std::vector<std::string> result;
+            std::string line;
+            while (std::getline(stream, line))
+            {
+                result.emplace_back(std::move(line));
+            }
+
+            return result;
+        }
+
+        Corpus ReadCorpus(const std::filesystem::path& directory)
+        {
+            Corpus result;
+            result.Names = ReadLines(directory / "InputNames.txt");
+            result.Publishers = ReadLines(directory / "InputPublishers.txt");
+            THROW_HR_IF(E_UNEXPECTED, result.Names.empty() || result.Names.size() != result.Publishers.size());
+            return result;
+        }
+
+        std::string MakeProductCode(std::mt19937& random)
+        {
+            std::ostringstream stream;
+            stream << '{' << std::hex << std::uppercase << std::setfill('0') <<
+                std::setw(8) << random() << '-' << std::setw(4) << (random() & 0xFFFF) << '-' << std::setw(4) << (random() & 0xFFFF) << '-' <<
+                std::setw(4) << (random() & 0xFFFF) << '-' << std::setw(8) << random() << std::setw(4) << (random() & 0xFFFF) << '}';
+            return stream.str();
+        }
+
+        // Makes a package family name from the name and publisher, as MSIX packages are commonly named.
+        std::string MakePackageFamilyName(std::string_view publisher, std::string_view name, std::mt19937& random)
+        {
+            std::string result;
+            for (char c : std::string{ publisher } + '.' + std::string{ name })
+            {
+                if (std::isalnum(static_cast<unsigned char>(c)) || c == '.')
+                {
+                    result += c;
+                }
+            }
+
+            static constexpr std::string_view s_PublisherIdCharacters = "0123456789abcdefghjkmnpqrstvwxyz";
+            result += '_';
+            for (size_t i = 0; i < 13; ++i)
+            {
+                result += s_PublisherIdCharacters[random() % s_PublisherIdCharacters.size()];
+            }
+
+            return result;
+        }
+
+        // An installed package, along with how it should correlate.
+        struct InstalledEntry
+        {
+            std::string Name;
+            std::string Publisher;
+            std::string ProductCode;
+            std::string PackageFamilyName;
+            Correlation Correlates = Correlation::None;
+        };
+
+        // Makes the installed packages; one in four is MSIX-like, the rest ARP-like.
+        // Two in five correlate through their system reference strings and one in five by name and publisher.
+        std::vector<InstalledEntry> MakeInstalledEntries(const Corpus& corpus, size_t count, std::mt19937& random)
+        {
+            std::vector<InstalledEntry> result;
+            result.reserve(count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                InstalledEntry entry;
+                size_t line = i % corpus.Names.size();
+                entry.Name = corpus.Names[line];
+                entry.Publisher = corpus.Publishers[line];
+
+                // Past the end of the corpus, keep the names distinct.
+                if (i >= corpus.Names.size())
+                {
+                    entry.Name += " (" + std::to_string(i / corpus.Names.size()) + ')';
+                }
+
+                if (i % 4 == 0)
+                {
+                    entry.PackageFamilyName = MakePackageFamilyName(entry.Publisher, entry.Name, random);
+                }
+                else if (i % 3 == 0)
+                {
+                    // Inno setup style key names.
+                    entry.ProductCode = MakePackageFamilyName(entry.Publisher, entry.Name, random) + "_is1";
+                }
+                else
+                {
+                    entry.ProductCode = MakeProductCode(random);
+                }
+
+                switch (i % 5)
+                {
+                case 0:
+                case 1:
+                    entry.Correlates = Correlation::SystemReference;
+                    break;
+                case 2:
+                    entry.Correlates = Correlation::NameAndPublisher;
+                    break;
+                default:
+                    entry.Correlates = Correlation::None;
+                    break;
+                }
+
+                result.emplace_back(std::move(entry));
+            }
+
+            return result;
+        }
+
+        SQLiteIndex CreateInstalledIndex(const std::vector<InstalledEntry>& entries)
+        {
+            SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
+
+            for (const auto& entry : entries)
+            {
+                Manifest::Manifest manifest;
+                manifest.Installers.emplace_back();
+                manifest.DefaultLocalization.Add<Localization::PackageName>(entry.Name);
+                manifest.DefaultLocalization.Add<Localization::Publisher>(entry.Publisher);
+                manifest.Version = "1.0";
+
+                std::filesystem::path path;
+                InstallerTypeEnum installedType;
+
+                if (!entry.PackageFamilyName.empty())
+                {
+                    manifest.Id = entry.PackageFamilyName;
+                    manifest.DefaultLocalization.Add<Localization::Tags>({ "msix" });
+                    manifest.Installers[0].PackageFamilyName = entry.PackageFamilyName;
+                    path = entry.PackageFamilyName;
+                    installedType = InstallerTypeEnum::Msix;
+                }
+                else
+                {
+                    manifest.Id = entry.ProductCode;
+                    manifest.DefaultLocalization.Add<Localization::Tags>({ "ARP" });
+                    manifest.Installers[0].ProductCode = entry.ProductCode;
+                    path = entry.ProductCode;
+                    installedType = (entry.ProductCode[0] == '{' ? InstallerTypeEnum::Msi : InstallerTypeEnum::Exe);
+                }
+
+                auto manifestId = index.AddManifest(manifest, path);
+                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, InstallerTypeToString(installedType));
+                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledScope, "Machine");
+            }
+
+            return index;
+        }
+
+        // Writes the available index, with two versions of each package that correlates and single versions of unrelated
+        // packages to fill it to the requested size. It is built in memory and written out, as published indexes are.
+        void CreateAvailableIndex(const std::filesystem::path& path, const std::vector<InstalledEntry>& entries, size_t manifestCount, std::mt19937& random)
+        {
+            SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
+            size_t added = 0;
+
+            auto addManifest = [&](Manifest::Manifest& manifest, const InstalledEntry* entry)
+            {
+                for (std::string_view version : { "1.0"sv, "2.0"sv })
+                {
+                    if (added >= manifestCount)
+                    {
+                        return;
+                    }
+
+                    manifest.Version = version;
+                    manifest.Installers.clear();
+                    manifest.Installers.emplace_back();
+                    manifest.Installers[0].Commands = { manifest.Moniker };
+
+                    if (entry && entry->Correlates == Correlation::SystemReference)
+                    {
+                        manifest.Installers[0].PackageFamilyName = entry->PackageFamilyName;
+                        manifest.Installers[0].ProductCode = entry->ProductCode;
+                    }
+                    else if (entry && entry->Correlates == Correlation::NameAndPublisher)
+                    {
+                        manifest.Installers[0].AppsAndFeaturesEntries.emplace_back();
+                        manifest.Installers[0].AppsAndFeaturesEntries[0].DisplayName = entry->Name;
+                        manifest.Installers[0].AppsAndFeaturesEntries[0].Publisher = entry->Publisher;
+                    }
+                    else
+                    {
+                        manifest.Installers[0].ProductCode = MakeProductCode(random);
+                    }
+
+                    index.AddManifest(manifest, std::filesystem::path{ "manifests" } / manifest.Id / manifest.Version / "manifest.yaml");
+                    ++added;
+                }
+            };
+
+            size_t package = 0;
+            for (const auto& entry : entries)
+            {
+                if (entry.Correlates == Correlation::None)
+                {
+                    continue;
+                }
+
+                Manifest::Manifest manifest;
+                manifest.Id = "Installed.Package" + std::to_string(package++);
+                manifest.Moniker = "installed" + std::to_string(package);
+                manifest.DefaultLocalization.Add<Localization::PackageName>(entry.Name);
+                manifest.DefaultLocalization.Add<Localization::Publisher>(entry.Publisher);
+                addManifest(manifest, &entry);
+            }
+
+            while (added < manifestCount)
+            {
+                Manifest::Manifest manifest;
+                manifest.Id = "Filler.Package" + std::to_string(package++);
+                manifest.Moniker = "filler" + std::to_string(package);
+                manifest.DefaultLocalization.Add<Localization::PackageName>("Filler Package " + std::to_string(package));
+                manifest.DefaultLocalization.Add<Localization::Publisher>("Filler Publisher " + std::to_string(package % 1000));
+                addManifest(manifest, nullptr);
+            }
+
+            index.PrepareForPackaging();
+            index.CopyTo(path.u8string());
+        }
+
+        // Searches the available source for each installed package's system reference strings, one request per package,
+        // which is the correlation that the composite source does when it cannot batch the requests.
+        size_t SearchSystemReferencesPerPackage(const Source& installed, const Source& available)
+        {
+            size_t result = 0;
+
+            for (const auto& match : installed.Search({}).Matches)
+            {
+                auto installedVersion = match.Package->GetInstalledVersion();
+
+                SearchRequest request;
+                for (const auto& pfn : installedVersion->GetMultiProperty(PackageVersionMultiProperty::PackageFamilyName))
+                {
+                    request.Inclusions.emplace_back(PackageMatchField::PackageFamilyName, MatchType::Exact, pfn.get());
+                }
+
+                for (const auto& productCode : installedVersion->GetMultiProperty(PackageVersionMultiProperty::ProductCode))
+                {
+                    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, productCode.get());
+                }
+
+                if (!request.Inclusions.empty())
+                {
+                    result += available.Search(request).Matches.size();
+                }
+            }
+
+            return result;
+        }
+
+        // Counts the correlated packages that have an update, as upgrade --all determines which packages to update.
+        size_t CountUpdates(const Source& composite)
+        {
+            size_t result = 0;
+
+            for (const auto& match : composite.Search({}).Matches)
+            {
+                if (match.Package->IsUpdateAvailable())
+                {
+                    ++result;
+                }
+            }
+
+            return result;
+        }
+
+        void RunSuite(const CompositeSourceBenchmarkOptions& options, const Corpus& corpus, size_t installedCount, std::ostream& out)
+        {
+            std::string group = std::to_string(installedCount) + '/' + std::to_string(options.AvailableCount);
+            std::mt19937 random{ s_Seed };
+
+            auto installedEntries = MakeInstalledEntries(corpus, installedCount, random);
+            std::filesystem::path availablePath = options.WorkingDirectory / ("composite_available_" + std::to_string(installedCount) + ".db");
+            std::filesystem::remove(availablePath);
+            CreateAvailableIndex(availablePath, installedEntries, options.AvailableCount, random);
+
+            {
+                SourceDetails installedDetails;
+                installedDetails.Name = "Benchmark Installed";
+                installedDetails.Identifier = "*BenchmarkInstalled";
+                installedDetails.Origin = SourceOrigin::Predefined;
+                Source installed{ std::make_shared<SQLiteIndexSource>(installedDetails, CreateInstalledIndex(installedEntries), Synchronization::CrossProcessReaderWriteLock{}, true) };
+
+                SourceDetails availableDetails;
+                availableDetails.Name = "Benchmark Available";
+                availableDetails.Identifier = "Benchmark.Available." + std::to_string(installedCount);
+                availableDetails.Origin = SourceOrigin::User;
+                Source available{ std::make_shared<SQLiteIndexSource>(availableDetails, SQLiteIndex::Open(availablePath.u8string(), SQLiteIndex::OpenDisposition::ImmutableMapped)) };
+
+                Source composite{ installed, available };
+
+                WriteReportHeader(out);
+                WriteReportLine(out, RunBenchmark(group, "Installed/Search", options.Iterations, [&]() { return installed.Search({}).Matches.size(); }));
+                WriteReportLine(out, RunBenchmark(group, "Available/PerPackageInclusions", options.Iterations, [&]() { return SearchSystemReferencesPerPackage(installed, available); }));
+                WriteReportLine(out, RunBenchmark(group, "Composite/Search", options.Iterations, [&]() { return composite.Search({}).Matches.size(); }));
+                WriteReportLine(out, RunBenchmark(group, "Composite/Search+IsUpdateAvailable", options.Iterations, [&]() { return CountUpdates(composite); }));
+            }
+
+            std::error_code error;
+            std::filesystem::remove(availablePath, error);
+        }
+    }
+
+    void RunCompositeSourceBenchmarks(const CompositeSourceBenchmarkOptions& options, std::ostream& out)
+    {
+        Corpus corpus = ReadCorpus(options.CorpusDirectory);
+        std::filesystem::create_directories(options.WorkingDirectory);
+
+        for (size_t installedCount : options.InstalledCounts)
+        {
+            out << std::endl;
+            RunSuite(options, corpus, installedCount, out);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The inputs to the composite source correlation benchmarks.
+    struct CompositeSourceBenchmarkOptions
+    {
+        // The number of installed packages to generate; the suite is run for each.
+        std::vector<size_t> InstalledCounts{ 500, 2000, 5000 };
+
+        // The number of manifests in the available source, including those that correlate with installed packages.
+        size_t AvailableCount = 20000;
+
+        // The number of timed runs of each stage.
+        size_t Iterations = 10;
+
+        // The directory containing InputNames.txt and InputPublishers.txt.
+        std::filesystem::path CorpusDirectory;
+
+        // The directory to write the generated available index to.
+        std::filesystem::path WorkingDirectory;
+    };
+
+    // Generates installed and available sources and times the stages of correlating them.
+    void RunCompositeSourceBenchmarks(const CompositeSourceBenchmarkOptions& options, std::ostream& out);
+}
@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "DownloadBenchmarks.h"
+#include "Benchmark.h"
+#include "BenchmarkHooks.h"
+#include <AppInstallerDownloader.h>
+#include <AppInstallerProgress.h>
+#include <AppInstallerStrings.h>
+#include <HttpStream/HttpRandomAccessStream.h>
+
+using namespace AppInstaller::Utility;
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::Storage::Streams;
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        // A fixed seed, so that every run reads the same files in the same way.
+        constexpr std::mt19937::result_type s_Seed = 0x446f776e;
+
+        // The size of each read of a sequential pass through a stream.
+        constexpr uint32_t s_SequentialReadSize = 64 * 1024;
+
+        // Discards everything written to it.
+        struct NullBuffer : public std::streambuf
+        {
+        protected:
+            int_type overflow(int_type c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+        };
+
+        std::string FormatSize(uint64_t size)
+        {
+            if (size >= 1024 * 1024 && size % (1024 * 1024) == 0)
+            {
+                return std::to_string(size / (1024 * 1024)) + "MB";
+            }
+
+            return std::to_string(size / 1024) + "KB";
+        }
+
+        // Writes a file of random bytes, so that nothing on the way can compress it.
+        std::filesystem::path WriteServedFile(const std::filesystem::path& directory, uint64_t size)
+        {
+            std::filesystem::path result = directory / ("benchmark_" + std::to_string(size) + ".bin");
+            if (std::filesystem::exists(result) && std::filesystem::file_size(result) == size)
+            {
+                return result;
+            }
+
+            std::mt19937 random{ s_Seed };
+            std::vector<uint32_t> block(64 * 1024);
+            std::ofstream stream{ result, std::ios::binary | std::ios::trunc };
+
+            for (uint64_t written = 0; written < size;)
+            {
+                std::generate(block.begin(), block.end(), std::ref(random));
+                auto count = static_cast<std::streamsize>(std::min<uint64_t>(block.size() * sizeof(uint32_t), size - written));
+                stream.write(reinterpret_cast<const char*>(block.data()), count);
+                written += count;
+            }
+
+            THROW_HR_IF(E_FAIL, !stream);
+            return result;
+        }
+
+        uint64_t ReadAt(const IRandomAccessStream& stream, uint64_t position, uint32_t size)
+        {
+            Buffer buffer{ size };
+            stream.Seek(position);
+            return stream.ReadAsync(buffer, size, InputStreamOptions::None).get().Length();
+        }
+
+        uint64_t ReadSequential(const IRandomAccessStream& stream, uint64_t position, uint64_t size)
+        {
+            uint64_t result = 0;
+            for (uint64_t end = position + size; position < end; position += s_SequentialReadSize)
+            {
+                result += ReadAt(stream, position, static_cast<uint32_t>(std::min<uint64_t>(s_SequentialReadSize, end - position)));
+            }
+            return result;
+        }
+
+        // The ways in which the random access stream is read.
+        enum class AccessPattern
+        {
+            // The whole file, from start to end.
+            Sequential,
+            // Small reads at random positions.
+            Random,
+            // As a package reader does: the central directory at the end, scattered reads of the entries, then the start of the file.
+            Package,
+        };
+
+        std::string_view ToString(AccessPattern pattern)
+        {
+            switch (pattern)
+            {
+            case AccessPattern::Sequential: return "Sequential";
+            case AccessPattern::Random: return "Random";
+            default: return "Package";
+            }
+        }
+
+        uint64_t ReadWithPattern(const IRandomAccessStream& stream, AccessPattern pattern)
+        {
+            uint64_t size = stream.Size();
+            std::mt19937_64 random{ s_Seed };
+            uint64_t result = 0;
+
+            auto readRandom = [&](size_t count, uint32_t readSize)
+            {
+                std::uniform_int_distribution<uint64_t> position{ 0, size > readSize ? size - readSize : 0 };
+                for (size_t i = 0; i < count; ++i)
+                {
+                    result += ReadAt(stream, position(random), static_cast<uint32_t>(std::min<uint64_t>(readSize, size)));
+                }
+            };
+
+            switch (pattern)
+            {
+            case AccessPattern::Sequential:
+                result = ReadSequential(stream, 0, size);
+                break;
+            case AccessPattern::Random:
+                readRandom(64, 16 * 1024);
+                break;
+            case AccessPattern::Package:
+            {
+                uint64_t directorySize = std::min<uint64_t>(64 * 1024, size);
+                result += ReadSequential(stream, size - directorySize, directorySize);
+                readRandom(32, 8 * 1024);
+                result += ReadSequential(stream, 0, std::min<uint64_t>(1024 * 1024, size));
+                break;
+            }
+            }
+
+            return result;
+        }
+
+        void RunSuite(const DownloadBenchmarkOptions& options, const std::filesystem::path& servedFile, uint64_t fileSize, uint32_t delayMs, uint64_t bytesPerSecond, std::ostream& out)
+        {
+            std::string group = FormatSize(fileSize) + '/' + std::to_string(delayMs) + "ms/" + (bytesPerSecond ? FormatSize(bytesPerSecond) + "ps" : "unlimited");
+            std::string url = options.BaseUrl + "/Benchmarks/" + servedFile.filename().u8string() +
+                "?delayMs=" + std::to_string(delayMs) + "&bytesPerSecond=" + std::to_string(bytesPerSecond);
+
+            auto addThroughput = [&](BenchmarkResult&& result, uint64_t bytes)
+            {
+                result.BytesPerRun = bytes;
+                WriteReportLine(out, result);
+            };
+
+            WriteReportHeader(out);
+
+            for (uint32_t bufferSize : options.BufferSizes)
+            {
+                TestHook_SetDownloadBufferSize(bufferSize);
+                auto bufferName = FormatSize(bufferSize);
+
+                for (bool computeHash : { false, true })
+                {
+                    addThroughput(RunBenchmark(group, (computeHash ? "DownloadToStream+Hash/" : "DownloadToStream/") + bufferName, options.Iterations, [&]()
+                        {
+                            NullBuffer nullBuffer;
+                            std::ostream dest{ &nullBuffer };
+                            ProgressCallback progress;
+                            DownloadToStream(url, dest, DownloadType::Manifest, progress, computeHash);
+                            return static_cast<size_t>(fileSize);
+                        }), fileSize);
+                }
+
+                // Goes through Delivery Optimization when the settings allow it, and then the ranged WinINet download.
+                std::filesystem::path dest = options.WorkingDirectory / servedFile.filename();
+                addThroughput(RunBenchmark(group, "Download/Installer/" + bufferName, options.Iterations, [&]()
+                    {
+                        std::filesystem::remove(dest);
+                        ProgressCallback progress;
+                        Download(url, dest, DownloadType::Installer, progress, true);
+                        return static_cast<size_t>(std::filesystem::file_size(dest));
+                    }), fileSize);
+
+                std::error_code error;
+                std::filesystem::remove(dest, error);
+            }
+
+            TestHook_SetDownloadBufferSize(0);
+
+            Uri uri{ ConvertToUTF16(url) };
+
+            for (const auto& [pageSize, maxPages] : options.CachePolicies)
+            {
+                for (AccessPattern pattern : { AccessPattern::Sequential, AccessPattern::Random, AccessPattern::Package })
+                {
+                    uint64_t bytesRead = 0;
+                    auto result = RunBenchmark(group, "HttpRandomAccessStream/" + std::string{ ToString(pattern) } + '/' + FormatSize(pageSize) + 'x' + std::to_string(maxPages), options.Iterations, [&]()
+                        {
+                            // A new stream for each run, so that every run starts with an empty cache.
+                            auto stream = HttpStream::HttpRandomAccessStream::CreateAsync(uri, pageSize, maxPages).get();
+                            bytesRead = ReadWithPattern(stream, pattern);
+                            return static_cast<size_t>(bytesRead);
+                        });
+                    addThroughput(std::move(result), bytesRead);
+                }
+            }
+        }
+    }
+
+    void RunDownloadBenchmarks(const DownloadBenchmarkOptions& options, std::ostream& out)
+    {
+        THROW_HR_IF_MSG(E_INVALIDARG, options.BaseUrl.empty() || options.ServeDirectory.empty(), "The download benchmarks need the URL and static file root of a running LocalhostWebServer");
+
+        std::filesystem::path servedDirectory = options.ServeDirectory / "Benchmarks";
+        std::filesystem::create_directories(servedDirectory);
+        std::filesystem::create_directories(options.WorkingDirectory);
+
+        for (uint64_t fileSize : options.FileSizes)
+        {
+            std::filesystem::path servedFile = WriteServedFile(servedDirectory, fileSize);
+
+            for (uint32_t delayMs : options.DelaysMs)
+            {
+                for (uint64_t bytesPerSecond : options.BytesPerSecond)
+                {
+                    out << std::endl;
+                    RunSuite(options, servedFile, fileSize, delayMs, bytesPerSecond, out);
+                }
+            }
+        }
+    }
+}
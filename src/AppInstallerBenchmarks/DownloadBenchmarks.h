@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The inputs to the download benchmarks, which run against LocalhostWebServer.
+    struct DownloadBenchmarkOptions
+    {
+        // The URL that the server serves its static file root from (for instance https://localhost:5001/TestKit).
+        std::string BaseUrl;
+
+        // The static file root of the server, where the files to download are written.
+        std::filesystem::path ServeDirectory;
+
+        // The sizes of the files to download.
+        std::vector<uint64_t> FileSizes{ 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024 };
+
+        // The delays for the server to inject before each response, in milliseconds.
+        std::vector<uint32_t> DelaysMs{ 0, 50 };
+
+        // The bandwidths for the server to limit each response to, in bytes per second; zero is unlimited.
+        std::vector<uint64_t> BytesPerSecond{ 0 };
+
+        // The buffer sizes of the WinINet downloads to compare.
+        std::vector<uint32_t> BufferSizes{ 64 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+
+        // The { page size, maximum pages } of the HttpRandomAccessStream caches to compare.
+        std::vector<std::pair<uint32_t, uint32_t>> CachePolicies{ { 64 * 1024, 400 }, { 128 * 1024, 200 }, { 1024 * 1024, 25 } };
+
+        // The number of timed runs of each benchmark.
+        size_t Iterations = 5;
+
+        // The directory to download files to.
+        std::filesystem::path WorkingDirectory;
+    };
+
+    // Writes files of each size to the server and times downloading and reading them under each network condition.
+    void RunDownloadBenchmarks(const DownloadBenchmarkOptions& options, std::ostream& out);
+}
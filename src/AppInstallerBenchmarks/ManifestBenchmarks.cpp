@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "ManifestBenchmarks.h"
+#include "Benchmark.h"
+#include <AppInstallerStrings.h>
+#include <winget/ManifestSchemaValidation.h>
+#include <winget/ManifestValidation.h>
+#include <winget/ManifestYamlParser.h>
+#include <winget/Yaml.h>
+
+#include <Psapi.h>
+
+using namespace AppInstaller::Manifest;
+using namespace AppInstaller::Manifest::YamlParser;
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        // The files of one manifest, read into memory so that the stages do not include reading the disk.
+        struct CorpusManifest
+        {
+            std::vector<std::string> FileNames;
+            std::vector<std::string> Contents;
+        };
+
+        struct Corpus
+        {
+            std::vector<CorpusManifest> Manifests;
+            size_t FileCount = 0;
+            uint64_t Bytes = 0;
+        };
+
+        bool IsYamlFile(const std::filesystem::path& path)
+        {
+            auto extension = path.extension().u8string();
+            return Utility::CaseInsensitiveEquals(extension, ".yaml") || Utility::CaseInsensitiveEquals(extension, ".yml");
+        }
+
+        Corpus ReadCorpus(const ManifestBenchmarkOptions& options)
+        {
+            THROW_HR_IF_MSG(E_INVALIDARG, !std::filesystem::is_directory(options.CorpusDirectory), "The manifest benchmarks need a directory of manifests");
+
+            // Group the files by directory; a sorted map keeps the corpus in the same order on every run.
+            std::map<std::filesystem::path, std::vector<std::filesystem::path>> directories;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator{ options.CorpusDirectory })
+            {
+                if (entry.is_regular_file() && IsYamlFile(entry.path()))
+                {
+                    directories[entry.path().parent_path()].emplace_back(entry.path());
+                }
+            }
+
+            Corpus result;
+
+            for (auto& [directory, files] : directories)
+            {
+                if (options.MaxManifests && result.Manifests.size() >= options.MaxManifests)
+                {
+                    break;
+                }
+
+                std::sort(files.begin(), files.end());
+
+                CorpusManifest manifest;
+                for (const auto& file : files)
+                {
+                    std::ifstream stream{ file, std::ios_base::in | std::ios_base::binary };
+                    manifest.FileNames.emplace_back(file.filename().u8string());
+                    manifest.Contents.emplace_back(Utility::ReadEntireStream(stream));
+                    result.Bytes += manifest.Contents.back().size();
+                }
+
+                result.FileCount += files.size();
+                result.Manifests.emplace_back(std::move(manifest));
+            }
+
+            return result;
+        }
+
+        std::vector<YamlManifestInfo> LoadManifest(const CorpusManifest& manifest)
+        {
+            std::vector<YamlManifestInfo> result;
+
+            for (size_t i = 0; i < manifest.Contents.size(); ++i)
+            {
+                YamlManifestInfo doc;
+                doc.Root = YAML::Load(manifest.Contents[i]);
+                doc.FileName = manifest.FileNames[i];
+                result.emplace_back(std::move(doc));
+            }
+
+            return result;
+        }
+
+        PROCESS_MEMORY_COUNTERS_EX GetMemoryCounters()
+        {
+            PROCESS_MEMORY_COUNTERS_EX result{};
+            THROW_LAST_ERROR_IF(!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&result), sizeof(result)));
+            return result;
+        }
+
+        std::string FormatMegabytes(size_t bytes)
+        {
+            std::ostringstream stream;
+            stream << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << "MB";
+            return stream.str();
+        }
+    }
+
+    void RunManifestBenchmarks(const ManifestBenchmarkOptions& options, std::ostream& out)
+    {
+        Corpus corpus = ReadCorpus(options);
+        std::string group = std::to_string(corpus.Manifests.size()) + " manifests";
+
+        out << std::endl << "Read " << corpus.Manifests.size() << " manifests in " << corpus.FileCount << " files (" << FormatMegabytes(corpus.Bytes) << ") from " <<
+            options.CorpusDirectory.u8string() << std::endl;
+
+        // The stages after loading start from these, so that each times only its own work.
+        // Manifests that fail a stage are counted and left out of the stages that depend on it.
+        size_t privateBytesBefore = GetMemoryCounters().PrivateUsage;
+        std::vector<std::vector<YamlManifestInfo>> loaded;
+        std::vector<ManifestVer> versions;
+        size_t failedLoads = 0;
+
+        for (const auto& manifest : corpus.Manifests)
+        {
+            try
+            {
+                auto docs = LoadManifest(manifest);
+
+                // Parsing once determines the manifest version and sets the type of each document, which schema validation needs.
+                ParseManifest(docs);
+                const auto& versionNode = docs[0].Root["ManifestVersion"];
+                versions.emplace_back(versionNode ? versionNode.as<std::string>() : std::string{ "0.1.0" });
+                loaded.emplace_back(std::move(docs));
+            }
+            catch (const std::exception&)
+            {
+                ++failedLoads;
+            }
+        }
+
+        size_t privateBytesAfter = GetMemoryCounters().PrivateUsage;
+        size_t heldBytes = privateBytesAfter > privateBytesBefore ? privateBytesAfter - privateBytesBefore : 0;
+
+        std::vector<Manifest::Manifest> manifests;
+        for (auto& docs : loaded)
+        {
+            manifests.emplace_back(ParseManifest(docs));
+        }
+
+        size_t loadedFiles = 0;
+        for (const auto& docs : loaded)
+        {
+            loadedFiles += docs.size();
+        }
+
+        auto report = [&](BenchmarkResult&& result, double items, uint64_t bytes)
+        {
+            result.ItemsPerRun = items;
+            result.BytesPerRun = bytes;
+            WriteReportLine(out, result);
+        };
+
+        WriteReportHeader(out);
+
+        report(RunBenchmark(group, "YAML::Load", options.Iterations, [&]()
+            {
+                size_t result = 0;
+                for (const auto& manifest : corpus.Manifests)
+                {
+                    for (const auto& contents : manifest.Contents)
+                    {
+                        try
+                        {
+                            YAML::Load(contents);
+                            ++result;
+                        }
+                        catch (const std::exception&) {}
+                    }
+                }
+                return result;
+            }), static_cast<double>(corpus.FileCount), corpus.Bytes);
+
+        report(RunBenchmark(group, "ManifestSchemaValidation", options.Iterations, [&]()
+            {
+                size_t result = 0;
+                for (size_t i = 0; i < loaded.size(); ++i)
+                {
+                    if (ValidateAgainstSchema(loaded[i], versions[i]).empty())
+                    {
+                        ++result;
+                    }
+                }
+                return result;
+            }), static_cast<double>(loadedFiles), 0);
+
+        // This includes the checks of the input files and merging of multiple files that come before population.
+        report(RunBenchmark(group, "ManifestYamlPopulator", options.Iterations, [&]()
+            {
+                size_t result = 0;
+                for (auto& docs : loaded)
+                {
+                    ParseManifest(docs);
+                    ++result;
+                }
+                return result;
+            }), static_cast<double>(loaded.size()), 0);
+
+        report(RunBenchmark(group, "ValidateManifest", options.Iterations, [&]()
+            {
+                size_t result = 0;
+                for (const auto& manifest : manifests)
+                {
+                    if (ValidateManifest(manifest).empty())
+                    {
+                        ++result;
+                    }
+                }
+                return result;
+            }), static_cast<double>(manifests.size()), 0);
+
+        report(RunBenchmark(group, "Load+FullValidation", options.Iterations, [&]()
+            {
+                ManifestValidateOption validateOption;
+                validateOption.FullValidation = true;
+
+                size_t result = 0;
+                for (const auto& manifest : corpus.Manifests)
+                {
+                    try
+                    {
+                        auto docs = LoadManifest(manifest);
+                        ParseManifest(docs, validateOption);
+                        ++result;
+                    }
+                    catch (const std::exception&) {}
+                }
+                return result;
+            }), static_cast<double>(corpus.Manifests.size()), corpus.Bytes);
+
+        out << "Manifests that failed to parse: " << failedLoads << std::endl <<
+            "Held by the loaded documents: " << FormatMegabytes(heldBytes) << std::endl <<
+            "Peak working set: " << FormatMegabytes(GetMemoryCounters().PeakWorkingSetSize) << std::endl;
+    }
+}
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <filesystem>
+#include <ostream>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The inputs to the manifest parsing and validation benchmarks.
+    struct ManifestBenchmarkOptions
+    {
+        // The directory to find manifests under, such as the manifests directory of a winget-pkgs clone.
+        // Each directory that directly contains YAML files is one manifest, made of all of those files.
+        std::filesystem::path CorpusDirectory;
+
+        // The maximum number of manifests to read from the corpus; zero for all of them.
+        size_t MaxManifests = 0;
+
+        // The number of timed passes over the corpus for each stage.
+        size_t Iterations = 3;
+    };
+
+    // Reads a corpus of manifests into memory and times each stage of parsing and validating them over all of it.
+    void RunManifestBenchmarks(const ManifestBenchmarkOptions& options, std::ostream& out);
+}
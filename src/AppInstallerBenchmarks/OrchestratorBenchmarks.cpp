@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "OrchestratorBenchmarks.h"
+#include "Benchmark.h"
+#include <ContextOrchestrator.h>
+#include <COMContext.h>
+#include <Commands/COMCommand.h>
+#include <AppInstallerStrings.h>
+#include <winget/Manifest.h>
+#include <winget/MemoryBudget.h>
+#include <winget/PerformanceCounters.h>
+
+#include <Psapi.h>
+
+using namespace AppInstaller::CLI;
+using namespace AppInstaller::CLI::Execution;
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        // The times at which an item went through each stage.
+        struct ItemTimes
+        {
+            std::chrono::steady_clock::time_point Enqueued;
+            std::chrono::steady_clock::time_point DownloadStarted;
+            std::chrono::steady_clock::time_point DownloadFinished;
+            std::chrono::steady_clock::time_point InstallStarted;
+            std::chrono::steady_clock::time_point Completed;
+        };
+
+        // Stands in for one of the commands of an install, taking the given time without touching the network or the system.
+        // It has the name of the real command, so that it runs in the same queue.
+        struct SimulatedCommand : public Command
+        {
+            SimulatedCommand(std::string_view name, std::chrono::milliseconds duration, std::chrono::steady_clock::time_point& started, std::chrono::steady_clock::time_point* finished) :
+                Command(name, {}), m_duration(duration), m_started(started), m_finished(finished) {}
+
+        protected:
+            void ExecuteInternal(Context&) const override
+            {
+                m_started = std::chrono::steady_clock::now();
+                std::this_thread::sleep_for(m_duration);
+
+                if (m_finished)
+                {
+                    *m_finished = std::chrono::steady_clock::now();
+                }
+            }
+
+        private:
+            std::chrono::milliseconds m_duration;
+            std::chrono::steady_clock::time_point& m_started;
+            std::chrono::steady_clock::time_point* m_finished;
+        };
+
+        // The samples of all of the runs of a load.
+        struct LoadSamples
+        {
+            BenchmarkResult Throughput;
+            BenchmarkResult EndToEnd;
+            BenchmarkResult DownloadWait;
+            BenchmarkResult OperationWait;
+            BenchmarkResult Lookup;
+        };
+
+        uint64_t GetWorkingSet()
+        {
+            PROCESS_MEMORY_COUNTERS counters{};
+            counters.cb = sizeof(counters);
+            THROW_LAST_ERROR_IF(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)));
+            return counters.WorkingSetSize;
+        }
+
+        std::string FormatMegabytes(int64_t bytes)
+        {
+            std::ostringstream stream;
+            stream << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / (1024 * 1024) << "MB";
+            return stream.str();
+        }
+
+        // Submits an install from each of the clients at once, each from its own thread, and waits for all of them.
+        void RunLoad(const OrchestratorBenchmarkOptions& options, size_t clientCount, size_t run, LoadSamples& samples)
+        {
+            ContextOrchestrator& orchestrator = ContextOrchestrator::Instance();
+            std::vector<ItemTimes> times(clientCount);
+            std::vector<std::shared_ptr<OrchestratorQueueItem>> items;
+            std::vector<std::vector<std::chrono::nanoseconds>> lookups(clientCount);
+
+            for (size_t i = 0; i < clientCount; ++i)
+            {
+                std::string packageId = "Benchmark.Package." + std::to_string(run) + "." + std::to_string(i);
+
+                // The manifest is added to the installing source as the item is queued, which takes the index lock.
+                auto context = std::make_unique<COMContext>();
+                Manifest::Manifest manifest;
+                manifest.Id = packageId;
+                manifest.Version = "1.0";
+                context->Add<Data::Manifest>(std::move(manifest));
+
+                auto item = std::make_shared<OrchestratorQueueItem>(
+                    OrchestratorQueueItemId{ Utility::ConvertToUTF16(packageId), L"Benchmark" }, std::move(context), PackageOperationType::Install);
+                item->SetCallerId(static_cast<DWORD>(i));
+                item->AddCommand(std::make_unique<SimulatedCommand>(
+                    COMDownloadCommand::CommandName, std::chrono::milliseconds{ options.DownloadMs }, times[i].DownloadStarted, &times[i].DownloadFinished));
+                item->AddCommand(std::make_unique<SimulatedCommand>(
+                    COMInstallCommand::CommandName, std::chrono::milliseconds{ options.InstallMs }, times[i].InstallStarted, nullptr));
+                items.emplace_back(std::move(item));
+            }
+
+            std::promise<void> startSignal;
+            std::shared_future<void> start = startSignal.get_future().share();
+            std::vector<std::thread> clients;
+
+            for (size_t i = 0; i < clientCount; ++i)
+            {
+                clients.emplace_back([&, i]()
+                    {
+                        start.wait();
+
+                        const auto& item = items[i];
+                        times[i].Enqueued = std::chrono::steady_clock::now();
+                        orchestrator.EnqueueAndRunItem(item);
+
+                        while (WaitForSingleObject(item->GetCompletedEvent().get(), options.PollMs) == WAIT_TIMEOUT)
+                        {
+                            auto lookupStart = std::chrono::steady_clock::now();
+                            orchestrator.GetQueueItem(item->GetId());
+                            lookups[i].emplace_back(std::chrono::steady_clock::now() - lookupStart);
+                        }
+
+                        times[i].Completed = std::chrono::steady_clock::now();
+                    });
+            }
+
+            auto loadStart = std::chrono::steady_clock::now();
+            startSignal.set_value();
+
+            for (auto& client : clients)
+            {
+                client.join();
+            }
+
+            samples.Throughput.Samples.Add(std::chrono::steady_clock::now() - loadStart);
+
+            for (size_t i = 0; i < clientCount; ++i)
+            {
+                const ItemTimes& item = times[i];
+                samples.EndToEnd.Samples.Add(item.Completed - item.Enqueued);
+                samples.DownloadWait.Samples.Add(item.DownloadStarted - item.Enqueued);
+                samples.OperationWait.Samples.Add(item.InstallStarted - item.DownloadFinished);
+
+                for (auto lookup : lookups[i])
+                {
+                    samples.Lookup.Samples.Add(lookup);
+                }
+            }
+        }
+
+        void RunSuite(const OrchestratorBenchmarkOptions& options, size_t clientCount, std::ostream& out)
+        {
+            std::string group = std::to_string(clientCount) + " clients";
+
+            LoadSamples samples;
+            samples.Throughput.Name = "Throughput";
+            samples.EndToEnd.Name = "EndToEnd";
+            samples.DownloadWait.Name = "QueueWait/download";
+            samples.OperationWait.Name = "QueueWait/operation";
+            samples.Lookup.Name = "GetQueueItem";
+
+            for (BenchmarkResult* result : { &samples.Throughput, &samples.EndToEnd, &samples.DownloadWait, &samples.OperationWait, &samples.Lookup })
+            {
+                result->Group = group;
+            }
+
+            auto locksBefore = Performance::Counters::GetSnapshot().Locks;
+            uint64_t workingSetBefore = GetWorkingSet();
+
+            try
+            {
+                // An untimed run first, so that the orchestrator and its installing source are created
+                LoadSamples warmup;
+                RunLoad(options, clientCount, 0, warmup);
+                locksBefore = Performance::Counters::GetSnapshot().Locks;
+                workingSetBefore = GetWorkingSet();
+
+                for (size_t run = 1; run <= options.Iterations; ++run)
+                {
+                    RunLoad(options, clientCount, run, samples);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                samples.Throughput.Completed = false;
+                samples.Throughput.Note = e.what();
+                WriteReportLine(out, samples.Throughput);
+                return;
+            }
+
+            samples.Throughput.ItemsPerRun = static_cast<double>(clientCount);
+            samples.Throughput.ResultCount = clientCount;
+
+            WriteReportHeader(out);
+            WriteReportLine(out, samples.Throughput);
+            WriteReportLine(out, samples.EndToEnd);
+            WriteReportLine(out, samples.DownloadWait);
+            WriteReportLine(out, samples.OperationWait);
+            WriteReportLine(out, samples.Lookup);
+
+            // What is left after the items are gone would show up as growth with every run
+            out << group << ": working set grew by " << FormatMegabytes(static_cast<int64_t>(GetWorkingSet()) - static_cast<int64_t>(workingSetBefore)) <<
+                " over " << options.Iterations << " runs; peak " << FormatMegabytes(static_cast<int64_t>(Performance::GetPeakWorkingSet())) << std::endl;
+
+            for (const auto& lock : Performance::Counters::GetSnapshot().Locks)
+            {
+                auto before = std::find_if(locksBefore.begin(), locksBefore.end(), [&](const auto& other) { return other.Name == lock.Name; });
+                Performance::Counters::LockContention delta = lock;
+                if (before != locksBefore.end())
+                {
+                    delta.Acquisitions -= before->Acquisitions;
+                    delta.ContendedAcquisitions -= before->ContendedAcquisitions;
+                    delta.WaitTime -= before->WaitTime;
+                }
+
+                if (delta.Acquisitions)
+                {
+                    out << group << ": lock " << lock.Name << " taken " << delta.Acquisitions << " times, " << delta.ContendedAcquisitions <<
+                        " contended, waited " << std::chrono::duration_cast<std::chrono::milliseconds>(delta.WaitTime).count() << "ms in total" << std::endl;
+                }
+            }
+        }
+    }
+
+    void RunOrchestratorBenchmarks(const OrchestratorBenchmarkOptions& options, std::ostream& out)
+    {
+        for (size_t clientCount : options.ClientCounts)
+        {
+            out << std::endl;
+            RunSuite(options, clientCount, out);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The inputs to the orchestrator benchmarks, which put the queues of the COM server under concurrent load in process.
+    struct OrchestratorBenchmarkOptions
+    {
+        // The number of clients that each submit an install at the same time; the suite is run for each.
+        std::vector<size_t> ClientCounts{ 10, 100, 250 };
+
+        // The time that the simulated download and install of each item take, in milliseconds.
+        uint32_t DownloadMs = 20;
+        uint32_t InstallMs = 5;
+
+        // How often each client looks up its item while waiting for it, as callers polling for progress do, in milliseconds.
+        uint32_t PollMs = 10;
+
+        // The number of timed runs of each load.
+        size_t Iterations = 3;
+    };
+
+    // Times concurrent installs through the ContextOrchestrator and reports the throughput, the queue waits,
+    // the growth of the working set, and the contention on the orchestrator, queue and index locks.
+    void RunOrchestratorBenchmarks(const OrchestratorBenchmarkOptions& options, std::ostream& out);
+}
@@ -0,0 +1,470 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "RestSourceBenchmarks.h"
+#include "Benchmark.h"
+#include <Rest/RestClient.h>
+#include <Rest/RestSource.h>
+#include <Rest/Schema/HttpClientHelper.h>
+#include <Rest/Schema/1_0/Json/ManifestDeserializer.h>
+#include <Rest/Schema/1_0/Json/SearchResponseDeserializer.h>
+#include <Rest/Schema/1_1/Json/ManifestDeserializer.h>
+#include <winget/RepositorySearch.h>
+#include <winget/RepositorySource.h>
+
+using namespace std::string_view_literals;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Rest;
+using namespace AppInstaller::Repository::Rest::Schema;
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        // Never resolved; every request is answered by the pipeline stage of the mock.
+        constexpr std::string_view s_RestSourceUrl = "https://rest.benchmark.invalid/api"sv;
+
+        constexpr std::string_view s_PackageIdPrefix = "Benchmark.Package"sv;
+
+        // The locales that the versions are given besides the default, in order.
+        constexpr std::string_view s_Locales[] = { "fr-FR"sv, "de-DE"sv, "ja-JP"sv, "es-ES"sv, "it-IT"sv, "pt-BR"sv, "zh-CN"sv, "ko-KR"sv, "ru-RU"sv, "nl-NL"sv };
+
+        // A schema version for the mock to report in its information.
+        struct SchemaVariant
+        {
+            std::string_view Name;
+            std::vector<std::string> ServerSupportedVersions;
+            std::vector<std::string> SupportedFeatures;
+        };
+
+        const SchemaVariant s_Schemas[] =
+        {
+            { "1.0"sv, { "1.0.0" }, {} },
+            { "1.1"sv, { "1.0.0", "1.1.0" }, {} },
+            { "1.1+Batch"sv, { "1.0.0", "1.1.0" }, { "BatchPackageManifests" } },
+        };
+
+        std::string GetPackageId(size_t package)
+        {
+            return std::string{ s_PackageIdPrefix } + std::to_string(package);
+        }
+
+        std::string GetVersion(size_t version)
+        {
+            return "1." + std::to_string(version) + ".0";
+        }
+
+        web::json::value MakeString(std::string_view value)
+        {
+            return web::json::value::string(utility::conversions::to_string_t(std::string{ value }));
+        }
+
+        std::string ToUtf8(const web::json::value& value)
+        {
+            return utility::conversions::to_utf8string(value.serialize());
+        }
+
+        web::json::value MakeLocale(size_t package, std::string_view locale)
+        {
+            std::string packageId = GetPackageId(package);
+            web::json::value result = web::json::value::object();
+            result[L"PackageLocale"] = MakeString(locale);
+            result[L"Publisher"] = MakeString("Benchmark Publisher " + std::to_string(package % 97));
+            result[L"PackageName"] = MakeString("Benchmark Package " + std::to_string(package));
+            result[L"License"] = MakeString("Benchmark License");
+            result[L"ShortDescription"] = MakeString("The short description of " + packageId + " in " + std::string{ locale });
+            result[L"Description"] = MakeString("The description of " + packageId + " in " + std::string{ locale } +
+                ", long enough to be representative of the descriptions that packages give, which often run to a paragraph or more of text.");
+
+            web::json::value tags = web::json::value::array();
+            for (size_t i = 0; i < 5; ++i)
+            {
+                tags[i] = MakeString("tag" + std::to_string((package + i) % 50));
+            }
+            result[L"Tags"] = std::move(tags);
+
+            return result;
+        }
+
+        web::json::value MakeInstaller(size_t package, size_t version, std::string_view architecture)
+        {
+            web::json::value result = web::json::value::object();
+            result[L"Architecture"] = MakeString(architecture);
+            result[L"InstallerType"] = MakeString("msi");
+            result[L"InstallerUrl"] = MakeString("https://installer.benchmark.invalid/" + GetPackageId(package) + '/' + GetVersion(version) + '/' + std::string{ architecture } + ".msi");
+            result[L"InstallerSha256"] = MakeString("011048877dfaef109801b3f3ab2b60afc74f3fc4f7b3430e0c897f5da1df84b6");
+            result[L"ProductCode"] = MakeString('{' + GetPackageId(package) + '.' + std::to_string(version) + '.' + std::string{ architecture } + '}');
+            result[L"Scope"] = MakeString("machine");
+            return result;
+        }
+
+        // Makes the data of the package manifests response for a package, with every version of it.
+        std::string MakeManifestData(size_t package, size_t versionCount, size_t localeCount)
+        {
+            web::json::value versions = web::json::value::array();
+
+            for (size_t version = 0; version < versionCount; ++version)
+            {
+                web::json::value versionObject = web::json::value::object();
+                versionObject[L"PackageVersion"] = MakeString(GetVersion(version));
+
+                web::json::value defaultLocale = MakeLocale(package, "en-US");
+                defaultLocale[L"Moniker"] = MakeString("benchmark" + std::to_string(package));
+                versionObject[L"DefaultLocale"] = std::move(defaultLocale);
+
+                web::json::value locales = web::json::value::array();
+                for (size_t i = 0; i < localeCount; ++i)
+                {
+                    locales[i] = MakeLocale(package, s_Locales[i]);
+                }
+                versionObject[L"Locales"] = std::move(locales);
+
+                web::json::value installers = web::json::value::array();
+                installers[0] = MakeInstaller(package, version, "x64");
+                installers[1] = MakeInstaller(package, version, "x86");
+                versionObject[L"Installers"] = std::move(installers);
+
+                versions[versions.size()] = std::move(versionObject);
+            }
+
+            web::json::value result = web::json::value::object();
+            result[L"PackageIdentifier"] = MakeString(GetPackageId(package));
+            result[L"Versions"] = std::move(versions);
+            return ToUtf8(result);
+        }
+
+        // Makes a page of the search response, for the packages in [begin, end).
+        std::string MakeSearchPage(size_t begin, size_t end, size_t versionCount, std::optional<size_t> nextPage)
+        {
+            web::json::value data = web::json::value::array();
+
+            for (size_t package = begin; package < end; ++package)
+            {
+                web::json::value versions = web::json::value::array();
+                for (size_t version = 0; version < versionCount; ++version)
+                {
+                    web::json::value productCodes = web::json::value::array();
+                    productCodes[0] = MakeString('{' + GetPackageId(package) + '.' + std::to_string(version) + ".x64}");
+                    productCodes[1] = MakeString('{' + GetPackageId(package) + '.' + std::to_string(version) + ".x86}");
+
+                    web::json::value versionObject = web::json::value::object();
+                    versionObject[L"PackageVersion"] = MakeString(GetVersion(version));
+                    versionObject[L"ProductCodes"] = std::move(productCodes);
+                    versions[version] = std::move(versionObject);
+                }
+
+                web::json::value packageObject = web::json::value::object();
+                packageObject[L"PackageIdentifier"] = MakeString(GetPackageId(package));
+                packageObject[L"PackageName"] = MakeString("Benchmark Package " + std::to_string(package));
+                packageObject[L"Publisher"] = MakeString("Benchmark Publisher " + std::to_string(package % 97));
+                packageObject[L"Versions"] = std::move(versions);
+                data[package - begin] = std::move(packageObject);
+            }
+
+            web::json::value result = web::json::value::object();
+            result[L"Data"] = std::move(data);
+            if (nextPage)
+            {
+                result[L"ContinuationToken"] = MakeString(std::to_string(nextPage.value()));
+            }
+            return ToUtf8(result);
+        }
+
+        // Passes every request of the client to the given function rather than sending it.
+        struct RequestHandler : public web::http::http_pipeline_stage
+        {
+            RequestHandler(std::function<pplx::task<web::http::http_response>(web::http::http_request)> handler) : m_handler(std::move(handler)) {}
+
+            pplx::task<web::http::http_response> propagate(web::http::http_request request) override
+            {
+                return m_handler(std::move(request));
+            }
+
+        private:
+            std::function<pplx::task<web::http::http_response>(web::http::http_request)> m_handler;
+        };
+
+        // An in-process REST source of generated packages, which answers the information, search and package manifests
+        // requests that reach the pipeline stage of the client. It counts the requests and the bytes of the responses.
+        struct MockRestSource
+        {
+            MockRestSource(const RestSourceBenchmarkOptions& options, size_t packageCount, size_t versionCount, const SchemaVariant& schema) :
+                m_packageCount(packageCount), m_versionCount(versionCount), m_localeCount(std::min(options.LocaleCount, std::size(s_Locales)))
+            {
+                web::json::value information = web::json::value::object();
+                information[L"SourceIdentifier"] = MakeString("Benchmark.Rest");
+
+                web::json::value versions = web::json::value::array();
+                for (const auto& version : schema.ServerSupportedVersions)
+                {
+                    versions[versions.size()] = MakeString(version);
+                }
+                information[L"ServerSupportedVersions"] = std::move(versions);
+
+                web::json::value features = web::json::value::array();
+                for (const auto& feature : schema.SupportedFeatures)
+                {
+                    features[features.size()] = MakeString(feature);
+                }
+                information[L"SupportedFeatures"] = std::move(features);
+
+                web::json::value response = web::json::value::object();
+                response[L"Data"] = std::move(information);
+                m_information = ToUtf8(response);
+
+                size_t pageSize = std::max<size_t>(options.PageSize, 1);
+                for (size_t begin = 0; begin < packageCount; begin += pageSize)
+                {
+                    size_t end = std::min(packageCount, begin + pageSize);
+                    m_searchPages.emplace_back(MakeSearchPage(begin, end, versionCount, end < packageCount ? std::optional<size_t>{ m_searchPages.size() + 1 } : std::nullopt));
+                }
+            }
+
+            // Creates the stage to give to the client, which delays every response by the given latency.
+            std::shared_ptr<web::http::http_pipeline_stage> CreateHandler(std::chrono::milliseconds latency)
+            {
+                return std::make_shared<RequestHandler>([this, latency](web::http::http_request request)
+                    {
+                        return Handle(std::move(request)).then([this, latency](std::optional<std::string> body)
+                            {
+                                if (latency.count())
+                                {
+                                    std::this_thread::sleep_for(latency);
+                                }
+
+                                ++m_requests;
+
+                                if (!body)
+                                {
+                                    return web::http::http_response{ web::http::status_codes::NotFound };
+                                }
+
+                                m_bytesServed += body->size();
+
+                                web::http::http_response response{ web::http::status_codes::OK };
+                                response.set_body(std::move(body).value(), "application/json; charset=utf-8");
+                                return response;
+                            });
+                    });
+            }
+
+            size_t GetRequestCount() const { return m_requests; }
+
+            uint64_t GetBytesServed() const { return m_bytesServed; }
+
+        private:
+            pplx::task<std::optional<std::string>> Handle(web::http::http_request request)
+            {
+                utility::string_t path = request.request_uri().path();
+                std::wstring_view lastSegment{ path };
+                lastSegment = lastSegment.substr(lastSegment.find_last_of(L'/') + 1);
+
+                if (request.method() == web::http::methods::GET && lastSegment == L"information")
+                {
+                    return pplx::task_from_result(std::optional<std::string>{ m_information });
+                }
+                else if (request.method() == web::http::methods::POST && lastSegment == L"manifestSearch")
+                {
+                    size_t page = 0;
+                    utility::string_t continuationToken;
+                    if (request.headers().match(L"ContinuationToken", continuationToken))
+                    {
+                        page = std::stoull(continuationToken);
+                    }
+
+                    return pplx::task_from_result(page < m_searchPages.size() ? std::optional<std::string>{ m_searchPages[page] } : std::nullopt);
+                }
+                else if (request.method() == web::http::methods::POST && lastSegment == L"packageManifests")
+                {
+                    return request.extract_json().then([this](const web::json::value& body)
+                        {
+                            std::string result = "{\"Data\":[";
+                            bool first = true;
+
+                            for (const auto& id : body.at(L"PackageIdentifiers").as_array())
+                            {
+                                auto package = ParsePackage(id.as_string());
+                                if (package)
+                                {
+                                    result += (first ? "" : ",");
+                                    result += GetManifestData(package.value());
+                                    first = false;
+                                }
+                            }
+
+                            result += "]}";
+                            return std::optional<std::string>{ std::move(result) };
+                        });
+                }
+                else if (request.method() == web::http::methods::GET && path.find(L"/packageManifests/") != utility::string_t::npos)
+                {
+                    auto package = ParsePackage(utility::string_t{ lastSegment });
+                    return pplx::task_from_result(package ? std::optional<std::string>{ "{\"Data\":" + GetManifestData(package.value()) + '}' } : std::nullopt);
+                }
+
+                return pplx::task_from_result(std::optional<std::string>{});
+            }
+
+            std::optional<size_t> ParsePackage(const utility::string_t& id) const
+            {
+                std::string value = utility::conversions::to_utf8string(id);
+                if (value.compare(0, s_PackageIdPrefix.size(), s_PackageIdPrefix) != 0)
+                {
+                    return {};
+                }
+
+                size_t package = std::stoull(value.substr(s_PackageIdPrefix.size()));
+                return package < m_packageCount ? std::optional<size_t>{ package } : std::nullopt;
+            }
+
+            // The manifests are made the first time that they are requested, which is in the untimed run.
+            const std::string& GetManifestData(size_t package)
+            {
+                std::lock_guard<std::mutex> lock{ m_manifestsLock };
+
+                auto itr = m_manifests.find(package);
+                if (itr == m_manifests.end())
+                {
+                    itr = m_manifests.emplace(package, MakeManifestData(package, m_versionCount, m_localeCount)).first;
+                }
+
+                return itr->second;
+            }
+
+            size_t m_packageCount;
+            size_t m_versionCount;
+            size_t m_localeCount;
+            std::string m_information;
+            std::vector<std::string> m_searchPages;
+            std::mutex m_manifestsLock;
+            std::map<size_t, std::string> m_manifests;
+            std::atomic<size_t> m_requests = 0;
+            std::atomic<uint64_t> m_bytesServed = 0;
+        };
+
+        // Times parsing a package manifests response and a page of the search response, which does not depend on the source size or latency.
+        void RunParseSuite(const RestSourceBenchmarkOptions& options, size_t versionCount, std::ostream& out)
+        {
+            std::string group = "Parse/" + std::to_string(versionCount) + 'v';
+            size_t localeCount = std::min(options.LocaleCount, std::size(s_Locales));
+            size_t pageSize = std::max<size_t>(options.PageSize, 1);
+
+            std::string manifestText = "{\"Data\":" + MakeManifestData(0, versionCount, localeCount) + '}';
+            std::string searchText = MakeSearchPage(0, pageSize, versionCount, 1);
+
+            utility::string_t manifestWide = utility::conversions::to_string_t(manifestText);
+            utility::string_t searchWide = utility::conversions::to_string_t(searchText);
+            web::json::value manifestJson = web::json::value::parse(manifestWide);
+            web::json::value searchJson = web::json::value::parse(searchWide);
+
+            auto report = [&](BenchmarkResult&& result, const std::string& text)
+            {
+                result.BytesPerRun = text.size();
+                WriteReportLine(out, result);
+            };
+
+            WriteReportHeader(out);
+            report(RunBenchmark(group, "Json/PackageManifests", options.Iterations, [&]() { return web::json::value::parse(manifestWide).size(); }), manifestText);
+            report(RunBenchmark(group, "ManifestDeserializer/1.0", options.Iterations, [&]() { return V1_0::Json::ManifestDeserializer{}.Deserialize(manifestJson).size(); }), manifestText);
+            report(RunBenchmark(group, "ManifestDeserializer/1.1", options.Iterations, [&]() { return V1_1::Json::ManifestDeserializer{}.Deserialize(manifestJson).size(); }), manifestText);
+            report(RunBenchmark(group, "Json/Search", options.Iterations, [&]() { return web::json::value::parse(searchWide).size(); }), searchText);
+            report(RunBenchmark(group, "SearchResponseDeserializer", options.Iterations, [&]() { return V1_0::Json::SearchResponseDeserializer{}.Deserialize(searchJson).Matches.size(); }), searchText);
+        }
+
+        // Times searching the mock and getting manifests from it through each schema version, with the given latency.
+        void RunSuite(const RestSourceBenchmarkOptions& options, size_t packageCount, size_t versionCount, uint32_t latencyMs, std::ostream& out)
+        {
+            std::string group = std::to_string(packageCount) + '/' + std::to_string(versionCount) + "v/" + std::to_string(latencyMs) + "ms";
+
+            std::vector<std::string> packageIds;
+            for (size_t i = 0; i < std::min(options.ManifestPackages, packageCount); ++i)
+            {
+                packageIds.emplace_back(GetPackageId(i));
+            }
+
+            WriteReportHeader(out);
+
+            for (const auto& schema : s_Schemas)
+            {
+                MockRestSource mock{ options, packageCount, versionCount, schema };
+                HttpClientHelper helper{ mock.CreateHandler(std::chrono::milliseconds{ latencyMs }) };
+
+                SourceDetails details;
+                details.Name = "Benchmark Rest";
+                details.Type = "Microsoft.Rest";
+                details.Arg = s_RestSourceUrl;
+                details.Identifier = "Benchmark.Rest";
+                auto source = std::make_shared<RestSource>(details, SourceInformation{}, RestClient::Create(std::string{ s_RestSourceUrl }, {}, helper));
+
+                // Reports the requests made and the bytes received by the last run along with the latency.
+                auto run = [&](std::string_view name, const std::function<size_t()>& operation)
+                {
+                    size_t requests = 0;
+                    uint64_t bytes = 0;
+
+                    auto result = RunBenchmark(group, std::string{ name } + '/' + std::string{ schema.Name }, options.Iterations, [&]()
+                        {
+                            size_t requestsBefore = mock.GetRequestCount();
+                            uint64_t bytesBefore = mock.GetBytesServed();
+                            size_t count = operation();
+                            requests = mock.GetRequestCount() - requestsBefore;
+                            bytes = mock.GetBytesServed() - bytesBefore;
+                            return count;
+                        });
+
+                    result.ItemsPerRun = static_cast<double>(requests);
+                    result.BytesPerRun = bytes;
+                    WriteReportLine(out, result);
+                };
+
+                run("Search", [&]() { return source->GetRestClient().Search({}).Matches.size(); });
+
+                run("Search+GetManifest", [&]()
+                    {
+                        SearchRequest request;
+                        request.MaximumResults = packageIds.size();
+
+                        size_t result = 0;
+                        for (const auto& match : source->Search(request).Matches)
+                        {
+                            match.Package->GetLatestAvailableVersion()->GetManifest();
+                            ++result;
+                        }
+                        return result;
+                    });
+
+                run("GetManifestsForPackages", [&]()
+                    {
+                        size_t result = 0;
+                        for (const auto& manifests : source->GetRestClient().GetManifestsForPackages(packageIds))
+                        {
+                            result += manifests.size();
+                        }
+                        return result;
+                    });
+            }
+        }
+    }
+
+    void RunRestSourceBenchmarks(const RestSourceBenchmarkOptions& options, std::ostream& out)
+    {
+        for (size_t versionCount : options.VersionCounts)
+        {
+            out << std::endl;
+            RunParseSuite(options, versionCount, out);
+        }
+
+        for (size_t packageCount : options.PackageCounts)
+        {
+            for (size_t versionCount : options.VersionCounts)
+            {
+                for (uint32_t latencyMs : options.LatenciesMs)
+                {
+                    out << std::endl;
+                    RunSuite(options, packageCount, versionCount, latencyMs, out);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The inputs to the REST source benchmarks, which run against an in-process mock of a REST source.
+    struct RestSourceBenchmarkOptions
+    {
+        // The number of packages in the mock source; the suite is run for each.
+        std::vector<size_t> PackageCounts{ 1000, 10000 };
+
+        // The number of versions of each package, which sets the size of the search and package manifests responses.
+        std::vector<size_t> VersionCounts{ 1, 20 };
+
+        // The number of locales of each version besides the default.
+        size_t LocaleCount = 5;
+
+        // The number of packages in each page of the search results; the rest follow through a continuation token.
+        size_t PageSize = 100;
+
+        // The latencies to add to every response, in milliseconds.
+        std::vector<uint32_t> LatenciesMs{ 0, 20 };
+
+        // The number of packages whose manifests are retrieved after a search.
+        size_t ManifestPackages = 20;
+
+        // The number of timed runs of each stage.
+        size_t Iterations = 10;
+    };
+
+    // Times parsing the responses of a REST source, and searching it and getting manifests from it through each schema version.
+    void RunRestSourceBenchmarks(const RestSourceBenchmarkOptions& options, std::ostream& out);
+}
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SQLiteIndexBenchmarks.h"
+#include "Benchmark.h"
+#include <Microsoft/SQLiteIndex.h>
+#include <SQLiteWrapper.h>
+#include <winget/Manifest.h>
+
+using namespace AppInstaller::Manifest;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Utility;
+
+
+namespace AppInstaller::Benchmarks
+{
+    namespace
+    {
+        // A fixed seed, so that every run generates the same indexes.
+        constexpr std::mt19937::result_type s_Seed = 0x57696e47;
+
+        // The number of distinct publishers among the generated packages.
+        constexpr size_t s_PublisherCount = 1000;
+
+        constexpr std::string_view s_Words[] =
+        {
+            "archive", "browser", "cloud", "code", "compiler", "database", "debugger", "design", "editor", "email",
+            "finance", "game", "graphics", "image", "media", "music", "network", "notes", "office", "photo",
+            "player", "remote", "security", "shell", "studio", "sync", "terminal", "text", "utility", "video",
+        };
+
+        constexpr PackageMatchField s_Fields[] =
+        {
+            PackageMatchField::Id,
+            PackageMatchField::Name,
+            PackageMatchField::Moniker,
+            PackageMatchField::Command,
+            PackageMatchField::Tag,
+            PackageMatchField::PackageFamilyName,
+            PackageMatchField::ProductCode,
+            PackageMatchField::NormalizedNameAndPublisher,
+            PackageMatchField::Market,
+        };
+
+        constexpr MatchType s_MatchTypes[] =
+        {
+            MatchType::Exact,
+            MatchType::CaseInsensitive,
+            MatchType::StartsWith,
+            MatchType::Fuzzy,
+            MatchType::Substring,
+            MatchType::FuzzySubstring,
+            MatchType::Wildcard,
+        };
+
+        // The values of one generated package that searches can look for.
+        struct PackageValues
+        {
+            std::string Id;
+            std::string Name;
+            std::string Publisher;
+            std::string Moniker;
+            std::string Command;
+            std::string Tag;
+            std::string PackageFamilyName;
+            std::string ProductCode;
+        };
+
+        std::string_view PickWord(std::mt19937& random)
+        {
+            return s_Words[std::uniform_int_distribution<size_t>{ 0, std::size(s_Words) - 1 }(random)];
+        }
+
+        std::string MakeProductCode(std::mt19937& random)
+        {
+            std::ostringstream stream;
+            stream << '{' << std::hex << std::uppercase << std::setfill('0') <<
+                std::setw(8) << random() << '-' << std::setw(4) << (random() & 0xFFFF) << '-' << std::setw(4) << (random() & 0xFFFF) << '-' <<
+                std::setw(4) << (random() & 0xFFFF) << '-' << std::setw(8) << random() << std::setw(4) << (random() & 0xFFFF) << '}';
+            return stream.str();
+        }
+
+        // Adds manifests for generated packages, with one to three versions each, until the index holds the given number.
+        // Returns the values of a package from the middle of the index.
+        PackageValues PopulateIndex(SQLiteIndex& index, size_t manifestCount)
+        {
+            std::mt19937 random{ s_Seed };
+            std::uniform_int_distribution<size_t> versionCount{ 1, 3 };
+            PackageValues result;
+            size_t added = 0;
+
+            for (size_t package = 0; added < manifestCount; ++package)
+            {
+                PackageValues values;
+                std::string publisher = "Publisher" + std::to_string(package % s_PublisherCount);
+                std::string name = "Package" + std::to_string(package);
+
+                values.Id = publisher + '.' + name;
+                values.Name = std::string{ PickWord(random) } + ' ' + name + ' ' + std::string{ PickWord(random) };
+                values.Publisher = publisher + " Corporation";
+                values.Moniker = "pkg" + std::to_string(package);
+                values.Command = values.Moniker + "cmd";
+                values.Tag = PickWord(random);
+                values.PackageFamilyName = values.Id + "_8wekyb3d8bbwe";
+
+                Manifest::Manifest manifest;
+                manifest.Id = values.Id;
+                manifest.Moniker = values.Moniker;
+                manifest.DefaultLocalization.Add<Localization::PackageName>(values.Name);
+                manifest.DefaultLocalization.Add<Localization::Publisher>(values.Publisher);
+                manifest.DefaultLocalization.Add<Localization::Tags>({ values.Tag, std::string{ PickWord(random) } });
+
+                size_t versions = std::min(versionCount(random), manifestCount - added);
+                for (size_t version = 1; version <= versions; ++version)
+                {
+                    manifest.Version = std::to_string(version) + ".0." + std::to_string(package % 100);
+
+                    values.ProductCode = MakeProductCode(random);
+                    manifest.Installers.clear();
+                    manifest.Installers.push_back({});
+                    manifest.Installers[0].Commands = { values.Command };
+                    manifest.Installers[0].PackageFamilyName = values.PackageFamilyName;
+                    manifest.Installers[0].ProductCode = values.ProductCode;
+                    manifest.Installers[0].AppsAndFeaturesEntries.push_back({});
+                    manifest.Installers[0].AppsAndFeaturesEntries[0].DisplayName = values.Name;
+                    manifest.Installers[0].AppsAndFeaturesEntries[0].Publisher = values.Publisher;
+
+                    index.AddManifest(manifest, std::filesystem::path{ "manifests" } / publisher / name / manifest.Version / "manifest.yaml");
+                    ++added;
+                }
+
+                if (added <= manifestCount / 2 || result.Id.empty())
+                {
+                    result = std::move(values);
+                }
+            }
+
+            return result;
+        }
+
+        // Gets the value to search for that matches the package through the given match type.
+        std::string GetSearchValue(std::string_view value, MatchType type)
+        {
+            switch (type)
+            {
+            case MatchType::CaseInsensitive:
+                return ToLower(value);
+            case MatchType::StartsWith:
+                return std::string{ value.substr(0, std::max<size_t>(1, value.size() / 2)) };
+            case MatchType::Substring:
+            case MatchType::FuzzySubstring:
+                return std::string{ value.substr(value.size() / 4, std::max<size_t>(1, value.size() / 2)) };
+            case MatchType::Wildcard:
+                return std::string{ value.substr(0, std::max<size_t>(1, value.size() / 2)) } + '*';
+            default:
+                return std::string{ value };
+            }
+        }
+
+        std::string_view GetFieldValue(const PackageValues& values, PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id: return values.Id;
+            case PackageMatchField::Name: return values.Name;
+            case PackageMatchField::Moniker: return values.Moniker;
+            case PackageMatchField::Command: return values.Command;
+            case PackageMatchField::Tag: return values.Tag;
+            case PackageMatchField::PackageFamilyName: return values.PackageFamilyName;
+            case PackageMatchField::ProductCode: return values.ProductCode;
+            case PackageMatchField::NormalizedNameAndPublisher: return values.Name;
+            default: return "en-US";
+            }
+        }
+
+        BenchmarkResult RunSearch(const SQLiteIndex& index, std::string group, std::string name, const SearchRequest& request, size_t iterations)
+        {
+            return RunBenchmark(std::move(group), std::move(name), iterations, [&]() { return index.Search(request).Matches.size(); });
+        }
+
+        void RunSuite(const SQLiteIndexBenchmarkOptions& options, Schema::Version version, size_t manifestCount, std::ostream& out)
+        {
+            std::ostringstream groupStream;
+            groupStream << version << '/' << manifestCount;
+            std::string group = groupStream.str();
+
+            std::filesystem::path indexPath = options.WorkingDirectory / ("index_" + std::to_string(version.MajorVersion) + '_' + std::to_string(version.MinorVersion) + '_' + std::to_string(manifestCount) + ".db");
+            std::filesystem::remove(indexPath);
+
+            PackageValues probe;
+            {
+                // Built in memory and then written out, as the indexes of the sources are published after being packaged.
+                auto buildStart = std::chrono::steady_clock::now();
+                SQLiteIndex builder = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, version);
+                probe = PopulateIndex(builder, manifestCount);
+                builder.PrepareForPackaging();
+                builder.CopyTo(indexPath.u8string());
+
+                out << group << ": generated " << manifestCount << " manifests in " <<
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count() << "ms" << std::endl;
+            }
+
+            WriteReportHeader(out);
+
+            {
+                SQLiteIndex index = SQLiteIndex::Open(indexPath.u8string(), SQLiteIndex::OpenDisposition::ImmutableMapped);
+
+                for (MatchType type : s_MatchTypes)
+                {
+                    SearchRequest request;
+                    request.Query = RequestMatch(type, GetSearchValue(probe.Name, type));
+                    WriteReportLine(out, RunSearch(index, group, "Query/" + std::string{ ToString(type) }, request, options.Iterations));
+                }
+
+                for (PackageMatchField field : s_Fields)
+                {
+                    for (MatchType type : s_MatchTypes)
+                    {
+                        SearchRequest request;
+
+                        if (field == PackageMatchField::NormalizedNameAndPublisher)
+                        {
+                            request.Inclusions.emplace_back(field, type, GetSearchValue(probe.Name, type), GetSearchValue(probe.Publisher, type));
+                        }
+                        else
+                        {
+                            request.Inclusions.emplace_back(field, type, GetSearchValue(GetFieldValue(probe, field), type));
+                        }
+
+                        WriteReportLine(out, RunSearch(index, group, std::string{ ToString(field) } + '/' + std::string{ ToString(type) }, request, options.Iterations));
+                    }
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::remove(indexPath, error);
+        }
+    }
+
+    std::vector<Schema::Version> GetAllSchemaVersions()
+    {
+        std::vector<Schema::Version> result;
+
+        // An empty index resolves the latest minor version for us.
+        SQLiteIndex current = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::LatestForMajor(1));
+
+        for (uint32_t minor = 0; minor <= current.GetVersion().MinorVersion; ++minor)
+        {
+            result.emplace_back(Schema::Version{ 1, minor });
+        }
+
+        return result;
+    }
+
+    void RunSQLiteIndexSearchBenchmarks(const SQLiteIndexBenchmarkOptions& options, std::ostream& out)
+    {
+        std::vector<Schema::Version> versions = options.Versions.empty() ? GetAllSchemaVersions() : options.Versions;
+        std::filesystem::create_directories(options.WorkingDirectory);
+
+        for (size_t manifestCount : options.ManifestCounts)
+        {
+            for (const auto& version : versions)
+            {
+                out << std::endl;
+                RunSuite(options, version, manifestCount, out);
+            }
+        }
+    }
+}
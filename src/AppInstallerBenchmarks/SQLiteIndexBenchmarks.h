@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <Microsoft/Schema/Version.h>
+
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+
+namespace AppInstaller::Benchmarks
+{
+    // The inputs to the index search benchmarks.
+    struct SQLiteIndexBenchmarkOptions
+    {
+        // The number of manifests to put in each generated index; the suite is run for each.
+        std::vector<size_t> ManifestCounts{ 10000 };
+
+        // The schema versions to generate indexes of; empty to use all of the known versions.
+        std::vector<Repository::Microsoft::Schema::Version> Versions;
+
+        // The number of timed searches for each combination of field and match type.
+        size_t Iterations = 50;
+
+        // The directory to write the generated indexes to.
+        std::filesystem::path WorkingDirectory;
+    };
+
+    // Gets all of the schema versions known to the implementation.
+    std::vector<Repository::Microsoft::Schema::Version> GetAllSchemaVersions();
+
+    // Generates synthetic indexes and times searches against them for every field and match type.
+    void RunSQLiteIndexSearchBenchmarks(const SQLiteIndexBenchmarkOptions& options, std::ostream& out);
+}
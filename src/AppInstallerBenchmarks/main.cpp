@@ -0,0 +1,315 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "BenchmarkHooks.h"
+#include "CompositeSourceBenchmarks.h"
+#include "DownloadBenchmarks.h"
+#include "ManifestBenchmarks.h"
+#include "OrchestratorBenchmarks.h"
+#include "RestSourceBenchmarks.h"
+#include "SQLiteIndexBenchmarks.h"
+
+using namespace AppInstaller;
+using namespace AppInstaller::Benchmarks;
+using namespace AppInstaller::Repository::Microsoft;
+
+namespace
+{
+    void Usage()
+    {
+        std::cout << "Usage: AppInstallerBenchmarks.exe [options]" << std::endl <<
+            "  --suite <name>[,<name>...]            The suites to run: index, composite, download, rest, manifest, orchestrator (default index)" << std::endl <<
+            "  --iterations <count>                  The number of timed runs for each benchmark (default 50 for index, 10 for composite, 5 for download, 10 for rest, 3 for manifest and orchestrator)" << std::endl <<
+            "  --dir <path>                          The directory to write the generated data to (default the temp directory)" << std::endl <<
+            "index:" << std::endl <<
+            "  --manifests <count>[,<count>...]      The number of manifests in each generated index (default 10000)" << std::endl <<
+            "  --schema <major.minor>[,<version>...] The index schema versions to benchmark (default all)" << std::endl <<
+            "composite:" << std::endl <<
+            "  --installed <count>[,<count>...]      The number of installed packages to generate (default 500,2000,5000)" << std::endl <<
+            "  --available <count>                   The number of manifests in the available source (default 20000)" << std::endl <<
+            "  --data <path>                         The directory containing InputNames.txt and InputPublishers.txt (default TestData beside the executable)" << std::endl <<
+            "download:" << std::endl <<
+            "  --url <url>                           The URL of the static files of a running LocalhostWebServer (for instance https://localhost:5001/TestKit)" << std::endl <<
+            "  --serve <path>                        The static file root of that server" << std::endl <<
+            "  --sizes <bytes>[,<bytes>...]          The sizes of the files to download (default 1MB, 16MB and 64MB)" << std::endl <<
+            "  --delays <ms>[,<ms>...]               The delays to inject before each response (default 0,50)" << std::endl <<
+            "  --bandwidths <bytes>[,<bytes>...]     The bytes per second to limit each response to; 0 is unlimited (default 0)" << std::endl <<
+            "  --buffers <bytes>[,<bytes>...]        The download buffer sizes to compare (default 64KB, 1MB and 4MB)" << std::endl <<
+            "rest:" << std::endl <<
+            "  --packages <count>[,<count>...]       The number of packages in the mock source (default 1000,10000)" << std::endl <<
+            "  --versions <count>[,<count>...]       The number of versions of each package (default 1,20)" << std::endl <<
+            "  --locales <count>                     The number of locales of each version besides the default, up to 10 (default 5)" << std::endl <<
+            "  --page-size <count>                   The number of packages in each page of the search results (default 100)" << std::endl <<
+            "  --latencies <ms>[,<ms>...]            The latencies to add to every response (default 0,20)" << std::endl <<
+            "  --manifest-packages <count>           The number of packages whose manifests are retrieved (default 20)" << std::endl <<
+            "manifest:" << std::endl <<
+            "  --corpus <path>                       The directory to read manifests from, such as the manifests directory of winget-pkgs" << std::endl <<
+            "  --max-manifests <count>               The maximum number of manifests to read (default all)" << std::endl <<
+            "orchestrator:" << std::endl <<
+            "  --clients <count>[,<count>...]        The number of clients that submit an install at the same time (default 10,100,250)" << std::endl <<
+            "  --download-ms <ms>                    The time that the simulated download of each item takes (default 20)" << std::endl <<
+            "  --install-ms <ms>                     The time that the simulated install of each item takes (default 5)" << std::endl <<
+            "  --poll-ms <ms>                        How often each client looks up its item while it waits (default 10)" << std::endl;
+    }
+
+    std::vector<std::string> SplitList(const std::string& value)
+    {
+        std::vector<std::string> result;
+        std::istringstream stream{ value };
+        std::string item;
+
+        while (std::getline(stream, item, ','))
+        {
+            if (!item.empty())
+            {
+                result.emplace_back(std::move(item));
+            }
+        }
+
+        return result;
+    }
+
+    template <typename T>
+    std::vector<T> ParseCounts(const std::string& value)
+    {
+        std::vector<T> result;
+        for (const auto& count : SplitList(value))
+        {
+            result.emplace_back(static_cast<T>(std::stoull(count)));
+        }
+        return result;
+    }
+
+    Schema::Version ParseSchemaVersion(const std::string& value)
+    {
+        size_t separator = value.find('.');
+        if (separator == std::string::npos)
+        {
+            throw std::invalid_argument("Schema versions must be of the form <major>.<minor>: " + value);
+        }
+
+        return { static_cast<uint32_t>(std::stoul(value.substr(0, separator))), static_cast<uint32_t>(std::stoul(value.substr(separator + 1))) };
+    }
+
+    std::filesystem::path GetExecutableDirectory()
+    {
+        wchar_t fullFileName[1024];
+        DWORD chars = ARRAYSIZE(fullFileName);
+        THROW_LAST_ERROR_IF(!QueryFullProcessImageNameW(GetCurrentProcess(), 0, fullFileName, &chars));
+
+        std::filesystem::path result{ fullFileName };
+        result.remove_filename();
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> suites{ "index" };
+    std::optional<size_t> iterations;
+    std::filesystem::path workingDirectory = std::filesystem::temp_directory_path() / "WinGetBenchmarks";
+    SQLiteIndexBenchmarkOptions indexOptions;
+    CompositeSourceBenchmarkOptions compositeOptions;
+    DownloadBenchmarkOptions downloadOptions;
+    RestSourceBenchmarkOptions restOptions;
+    ManifestBenchmarkOptions manifestOptions;
+    OrchestratorBenchmarkOptions orchestratorOptions;
+
+    try
+    {
+        winrt::init_apartment();
+        compositeOptions.CorpusDirectory = GetExecutableDirectory() / "TestData";
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+
+            if (arg == "-?" || arg == "--help")
+            {
+                Usage();
+                return 0;
+            }
+
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for " << arg << std::endl;
+                Usage();
+                return 1;
+            }
+
+            std::string value = argv[++i];
+
+            if (arg == "--suite")
+            {
+                suites = SplitList(value);
+            }
+            else if (arg == "--iterations")
+            {
+                iterations = std::stoull(value);
+            }
+            else if (arg == "--dir")
+            {
+                workingDirectory = value;
+            }
+            else if (arg == "--manifests")
+            {
+                indexOptions.ManifestCounts = ParseCounts<size_t>(value);
+            }
+            else if (arg == "--schema")
+            {
+                for (const auto& version : SplitList(value))
+                {
+                    indexOptions.Versions.emplace_back(ParseSchemaVersion(version));
+                }
+            }
+            else if (arg == "--installed")
+            {
+                compositeOptions.InstalledCounts = ParseCounts<size_t>(value);
+            }
+            else if (arg == "--available")
+            {
+                compositeOptions.AvailableCount = std::stoull(value);
+            }
+            else if (arg == "--data")
+            {
+                compositeOptions.CorpusDirectory = value;
+            }
+            else if (arg == "--url")
+            {
+                downloadOptions.BaseUrl = value;
+            }
+            else if (arg == "--serve")
+            {
+                downloadOptions.ServeDirectory = value;
+            }
+            else if (arg == "--sizes")
+            {
+                downloadOptions.FileSizes = ParseCounts<uint64_t>(value);
+            }
+            else if (arg == "--delays")
+            {
+                downloadOptions.DelaysMs = ParseCounts<uint32_t>(value);
+            }
+            else if (arg == "--bandwidths")
+            {
+                downloadOptions.BytesPerSecond = ParseCounts<uint64_t>(value);
+            }
+            else if (arg == "--buffers")
+            {
+                downloadOptions.BufferSizes = ParseCounts<uint32_t>(value);
+            }
+            else if (arg == "--packages")
+            {
+                restOptions.PackageCounts = ParseCounts<size_t>(value);
+            }
+            else if (arg == "--versions")
+            {
+                restOptions.VersionCounts = ParseCounts<size_t>(value);
+            }
+            else if (arg == "--locales")
+            {
+                restOptions.LocaleCount = std::stoull(value);
+            }
+            else if (arg == "--page-size")
+            {
+                restOptions.PageSize = std::stoull(value);
+            }
+            else if (arg == "--latencies")
+            {
+                restOptions.LatenciesMs = ParseCounts<uint32_t>(value);
+            }
+            else if (arg == "--manifest-packages")
+            {
+                restOptions.ManifestPackages = std::stoull(value);
+            }
+            else if (arg == "--corpus")
+            {
+                manifestOptions.CorpusDirectory = value;
+            }
+            else if (arg == "--max-manifests")
+            {
+                manifestOptions.MaxManifests = std::stoull(value);
+            }
+            else if (arg == "--clients")
+            {
+                orchestratorOptions.ClientCounts = ParseCounts<size_t>(value);
+            }
+            else if (arg == "--download-ms")
+            {
+                orchestratorOptions.DownloadMs = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (arg == "--install-ms")
+            {
+                orchestratorOptions.InstallMs = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (arg == "--poll-ms")
+            {
+                orchestratorOptions.PollMs = static_cast<uint32_t>(std::stoul(value));
+            }
+            else
+            {
+                std::cerr << "Unknown option " << arg << std::endl;
+                Usage();
+                return 1;
+            }
+        }
+
+        // The composite source creates a tracking catalog for the available source, which would otherwise be left in the user's state.
+        Runtime::TestHook_SetPathOverride(Runtime::PathName::LocalState, workingDirectory / "LocalState");
+
+        indexOptions.WorkingDirectory = workingDirectory;
+        compositeOptions.WorkingDirectory = workingDirectory;
+        downloadOptions.WorkingDirectory = workingDirectory / "Downloads";
+
+        if (iterations)
+        {
+            indexOptions.Iterations = iterations.value();
+            compositeOptions.Iterations = iterations.value();
+            downloadOptions.Iterations = iterations.value();
+            restOptions.Iterations = iterations.value();
+            manifestOptions.Iterations = iterations.value();
+            orchestratorOptions.Iterations = iterations.value();
+        }
+
+        for (const auto& suite : suites)
+        {
+            if (suite == "index")
+            {
+                RunSQLiteIndexSearchBenchmarks(indexOptions, std::cout);
+            }
+            else if (suite == "composite")
+            {
+                RunCompositeSourceBenchmarks(compositeOptions, std::cout);
+            }
+            else if (suite == "download")
+            {
+                RunDownloadBenchmarks(downloadOptions, std::cout);
+            }
+            else if (suite == "rest")
+            {
+                RunRestSourceBenchmarks(restOptions, std::cout);
+            }
+            else if (suite == "manifest")
+            {
+                RunManifestBenchmarks(manifestOptions, std::cout);
+            }
+            else if (suite == "orchestrator")
+            {
+                RunOrchestratorBenchmarks(orchestratorOptions, std::cout);
+            }
+            else
+            {
+                std::cerr << "Unknown suite " << suite << std::endl;
+                Usage();
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -36,6 +36,12 @@ namespace AppInstaller::CLI::Execution
 
     void COMContext::OnProgress(uint64_t current, uint64_t maximum, ProgressType progressType)
     {
+        if (progressType == ProgressType::Bytes)
+        {
+            m_lastBytesCurrent = current;
+            m_lastBytesMaximum = maximum;
+        }
+
         FireCallbacks(ReportType::Progressing, current, maximum, progressType, m_executionStage);
     }
 
@@ -51,6 +57,11 @@ namespace AppInstaller::CLI::Execution
         GetThreadGlobals().GetTelemetryLogger().SetExecutionStage(static_cast<uint32_t>(m_executionStage));
     }
 
+    void COMContext::ReportExecutionStageCompleted()
+    {
+        FireCallbacks(ReportType::ExecutionStageCompleted, m_lastBytesCurrent, m_lastBytesMaximum, ProgressType::Bytes, m_executionStage);
+    }
+
     void COMContext::SetContextLoggers(const std::wstring_view telemetryCorrelationJson, const std::string& caller)
     {
         m_correlationData = telemetryCorrelationJson;
@@ -13,6 +13,8 @@ namespace AppInstaller::CLI::Execution
         BeginProgress,
         Progressing,
         EndProgress,
+        // The commands of the current queue have finished; the item is waiting for the next queue.
+        ExecutionStageCompleted,
     };
 
     class NullStreamBuf : public std::streambuf {};
@@ -58,6 +60,9 @@ namespace AppInstaller::CLI::Execution
         //Execution::Context
         void SetExecutionStage(CLI::Workflow::ExecutionStage executionPhase);
 
+        // Reports that the work of the current stage is done, along with the last bytes progress of the stage.
+        void ReportExecutionStageCompleted();
+
         CLI::Workflow::ExecutionStage GetExecutionStage() const { return m_executionStage; }
 
         void AddProgressCallbackFunction(ProgressCallBackFunction&& f);
@@ -79,5 +84,7 @@ namespace AppInstaller::CLI::Execution
         std::vector<ProgressCallBackFunction> m_comProgressCallbacks;
         std::wstring m_correlationData = L"";
         std::mutex m_callbackLock;
+        uint64_t m_lastBytesCurrent = 0;
+        uint64_t m_lastBytesMaximum = 0;
     };
 }
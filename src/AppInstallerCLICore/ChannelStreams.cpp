@@ -52,6 +52,8 @@ namespace AppInstaller::CLI::Execution
         {
             Write(TextFormat::Default, true);
         }
+
+        m_out.flush();
     }
 
     void BaseStream::Disable()
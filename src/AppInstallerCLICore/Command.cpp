@@ -2,9 +2,15 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Command.h"
+#include "JsonOutput.h"
 #include "Resources.h"
+#include "TableOutput.h"
+#include <winget/Performance.h>
 #include <winget/UserSettings.h>
 
+#include <iomanip>
+#include <limits>
+
 using namespace std::string_view_literals;
 using namespace AppInstaller::Utility::literals;
 using namespace AppInstaller::Settings;
@@ -13,6 +19,41 @@ namespace AppInstaller::CLI
 {
     constexpr std::string_view s_Command_ArgName_SilentAndInteractive = "silent|interactive"sv;
 
+    namespace
+    {
+        void OutputPerformanceSummary(Execution::TableOutput<3>& table, const std::vector<Performance::TimingSummary>& summary, size_t depth)
+        {
+            for (const auto& entry : summary)
+            {
+                std::ostringstream time;
+                time << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(entry.Total).count();
+
+                table.OutputLine({ std::string(depth * 2, ' ') + entry.Name, std::to_string(entry.Count), time.str() });
+                OutputPerformanceSummary(table, entry.Children, depth + 1);
+            }
+        }
+
+        // Displays the timings collected while executing the command, and logs them as JSON for tools to consume.
+        void OutputPerformanceSummary(Execution::Context& context)
+        {
+            auto summary = Performance::GetTimingSummary();
+            AICLI_LOG_LARGE_STRING(CLI, Info, << "Performance summary:", Performance::TimingSummaryToJson(summary));
+
+            context.Reporter.Info() << std::endl;
+
+            // Size the columns over every line, as the names are indented by their depth.
+            Execution::TableOutput<3> table(context.Reporter,
+                {
+                    Resource::String::PerfHeaderOperation,
+                    Resource::String::PerfHeaderCount,
+                    Resource::String::PerfHeaderTime
+                }, std::numeric_limits<size_t>::max());
+
+            OutputPerformanceSummary(table, summary, 0);
+            table.Complete();
+        }
+    }
+
     const Utility::LocIndString CommandException::Message() const
     {
         if (m_replace)
@@ -691,6 +732,12 @@ namespace AppInstaller::CLI
             }
         }
 
+        if (execArgs.Contains(Execution::Args::Type::OutputFormat) &&
+            !Execution::ConvertToOutputFormat(execArgs.GetArg(Execution::Args::Type::OutputFormat)))
+        {
+            throw CommandException(Resource::String::InvalidArgumentValueError, Argument::ForType(Execution::Args::Type::OutputFormat).Name(), { "json"_lis, "jsonl"_lis });
+        }
+
         ValidateArgumentsInternal(execArgs);
     }
 
@@ -809,6 +856,12 @@ namespace AppInstaller::CLI
         }
         else
         {
+            // Structured output replaces everything else that would be written, so that it can be consumed directly.
+            if (context.Args.Contains(Execution::Args::Type::OutputFormat))
+            {
+                context.Reporter.SetChannel(Execution::Reporter::Channel::Json);
+            }
+
             ExecuteInternal(context);
         }
     }
@@ -870,11 +923,13 @@ namespace AppInstaller::CLI
     {
         try
         {
-            if (!Settings::User().GetWarnings().empty())
+            // Reporting settings warnings requires loading the settings, which a lightweight invocation avoids.
+            if (WI_IsFlagClear(context.GetFlags(), Execution::ContextFlag::Lightweight) && !Settings::User().GetWarnings().empty())
             {
                 context.Reporter.Warn() << Resource::String::SettingsWarnings << std::endl;
             }
 
+            Performance::ScopedTimer timer{ command->FullName() };
             command->Execute(context);
         }
         catch (...)
@@ -882,6 +937,11 @@ namespace AppInstaller::CLI
             context.SetTerminationHR(Workflow::HandleException(context, std::current_exception()));
         }
 
+        if (Performance::IsCollectionEnabled())
+        {
+            OutputPerformanceSummary(context);
+        }
+
         if (SUCCEEDED(context.GetTerminationHR()))
         {
             Logging::Telemetry().LogCommandSuccess(command->FullName());
@@ -95,6 +95,15 @@ namespace AppInstaller::CLI
         virtual void OutputHelp(Execution::Reporter& reporter, const CommandException* exception = nullptr) const;
         virtual std::string HelpLink() const { return {}; }
 
+        // Whether the command opens the default sources and the installed source, so that they can be opened during startup.
+        virtual bool OpensDefaultAndInstalledSources() const { return false; }
+
+        // Whether the command opens the installed source, so that it can be opened during startup even if the available sources vary.
+        virtual bool OpensInstalledSource() const { return OpensDefaultAndInstalledSources(); }
+
+        // The resource strings that the output of the command uses heavily, so that they can be loaded during startup.
+        virtual std::vector<Resource::StringId> PreloadedResourceStrings() const { return {}; }
+
         virtual std::unique_ptr<Command> FindSubCommand(Invocation& inv) const;
         virtual void ParseArguments(Invocation& inv, Execution::Args& execArgs) const;
         virtual void ValidateArguments(Execution::Args& execArgs) const;
@@ -21,7 +21,8 @@ namespace AppInstaller::CLI
             Workflow::ReportExecutionStage(ExecutionStage::Discovery) <<
             Workflow::SelectInstaller <<
             Workflow::EnsureApplicableInstaller <<
-            Workflow::DownloadSinglePackage;
+            Workflow::DownloadSinglePackage <<
+            Workflow::LockInstallerFile;
     }
 
     // IMPORTANT: To use this command, the caller should have already executed the COMDownloadCommand
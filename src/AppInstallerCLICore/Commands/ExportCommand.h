@@ -19,6 +19,8 @@ namespace AppInstaller::CLI
 
         std::string HelpLink() const override;
 
+        bool OpensDefaultAndInstalledSources() const override { return true; }
+
     protected:
         void ExecuteInternal(Execution::Context& context) const override;
     };
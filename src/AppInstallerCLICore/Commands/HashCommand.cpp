@@ -3,20 +3,155 @@
 #include "pch.h"
 #include "HashCommand.h"
 #include "Workflows/WorkflowBase.h"
+#include "JsonOutput.h"
 #include "Resources.h"
 
 #include <AppInstallerMsixInfo.h>
+#include <winget/ThreadGlobals.h>
+
+#include <atomic>
+#include <limits>
+#include <thread>
 
 namespace AppInstaller::CLI
 {
     using namespace std::string_view_literals;
     using namespace Utility::literals;
 
+    namespace
+    {
+        // The most files that are hashed at once; each has a couple of large reads outstanding.
+        constexpr size_t s_MaximumHashConcurrency = 8;
+
+        struct FileHashResult
+        {
+            std::filesystem::path Path;
+            Utility::SHA256::HashBuffer Sha256;
+            Utility::SHA256::HashBuffer SignatureSha256;
+            HRESULT SignatureResult = S_OK;
+            std::exception_ptr Exception;
+        };
+
+        // Expands the given paths, replacing directories with the files directly within them.
+        // Returns an empty value when one of them does not exist.
+        std::optional<std::vector<std::filesystem::path>> GetFilesToHash(Execution::Context& context)
+        {
+            std::vector<std::filesystem::path> result;
+
+            for (const auto& arg : *context.Args.GetArgs(Execution::Args::Type::HashFile))
+            {
+                std::filesystem::path path = Utility::ConvertToUTF16(arg);
+
+                if (!std::filesystem::exists(path))
+                {
+                    context.Reporter.Error() << Resource::String::VerifyFileFailedNotExist << ' ' << path.u8string() << std::endl;
+                    return {};
+                }
+
+                if (std::filesystem::is_directory(path))
+                {
+                    std::vector<std::filesystem::path> directoryFiles;
+                    for (const auto& entry : std::filesystem::directory_iterator{ path })
+                    {
+                        if (entry.is_regular_file())
+                        {
+                            directoryFiles.emplace_back(entry.path());
+                        }
+                    }
+
+                    std::sort(directoryFiles.begin(), directoryFiles.end());
+                    std::move(directoryFiles.begin(), directoryFiles.end(), std::back_inserter(result));
+                }
+                else
+                {
+                    result.emplace_back(std::move(path));
+                }
+            }
+
+            return result;
+        }
+
+        void ComputeFileHash(FileHashResult& result, bool includeSignature)
+        {
+            try
+            {
+                result.Sha256 = Utility::SHA256::ComputeHashFromFile(result.Path);
+
+                if (includeSignature)
+                {
+                    try
+                    {
+                        Msix::MsixInfo msixInfo{ result.Path };
+                        auto signature = msixInfo.GetSignature();
+                        result.SignatureSha256 = Utility::SHA256::ComputeHash(signature.data(), static_cast<uint32_t>(signature.size()));
+                    }
+                    catch (const wil::ResultException& re)
+                    {
+                        result.SignatureResult = re.GetErrorCode();
+                    }
+                }
+            }
+            catch (...)
+            {
+                result.Exception = std::current_exception();
+            }
+        }
+
+        // Hashes the files on as many threads as are useful; the results are in the same order as the files.
+        std::vector<FileHashResult> ComputeFileHashes(Execution::Context& context, std::vector<std::filesystem::path> files, bool includeSignature)
+        {
+            std::vector<FileHashResult> results(files.size());
+            for (size_t i = 0; i < files.size(); ++i)
+            {
+                results[i].Path = std::move(files[i]);
+            }
+
+            size_t workerCount = std::min({ results.size(), s_MaximumHashConcurrency, static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())) });
+            if (workerCount <= 1)
+            {
+                for (auto& result : results)
+                {
+                    ComputeFileHash(result, includeSignature);
+                }
+
+                return results;
+            }
+
+            AICLI_LOG(CLI, Info, << "Hashing " << results.size() << " files with " << workerCount << " threads");
+
+            std::atomic<size_t> nextResult = 0;
+            std::vector<std::future<void>> workers;
+
+            for (size_t i = 0; i < workerCount; ++i)
+            {
+                auto threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(context.GetThreadGlobals(), ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+
+                workers.emplace_back(std::async(std::launch::async, [&, threadGlobals]()
+                    {
+                        auto previousThreadGlobals = threadGlobals->SetForCurrentThread();
+
+                        for (size_t j = nextResult++; j < results.size(); j = nextResult++)
+                        {
+                            ComputeFileHash(results[j], includeSignature);
+                        }
+                    }));
+            }
+
+            for (auto& worker : workers)
+            {
+                worker.wait();
+            }
+
+            return results;
+        }
+    }
+
     std::vector<Argument> HashCommand::GetArguments() const
     {
         return {
-            Argument::ForType(Execution::Args::Type::HashFile),
+            Argument::ForType(Execution::Args::Type::HashFile).SetCountLimit(std::numeric_limits<size_t>::max()),
             Argument::ForType(Execution::Args::Type::Msix),
+            Argument::ForType(Execution::Args::Type::OutputFormat),
         };
     }
 
@@ -37,33 +172,80 @@ namespace AppInstaller::CLI
 
     void HashCommand::ExecuteInternal(Execution::Context& context) const
     {
-        context <<
-            Workflow::VerifyFile(Execution::Args::Type::HashFile) <<
-            [](Execution::Context& context)
+        auto files = GetFilesToHash(context);
+        if (!files)
+        {
+            AICLI_TERMINATE_CONTEXT(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+        }
+
+        bool includeSignature = context.Args.Contains(Execution::Args::Type::Msix);
+        // A single file keeps the original output, without its path
+        bool showPaths = files->size() != 1;
+        std::vector<FileHashResult> results = ComputeFileHashes(context, std::move(files).value(), includeSignature);
+
+        Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+        std::optional<Execution::JsonRecordOutput> records;
+        if (format != Execution::OutputFormat::Table)
         {
-            auto inputFile = context.Args.GetArg(Execution::Args::Type::HashFile);
-            std::ifstream inStream{ Utility::ConvertToUTF16(inputFile), std::ifstream::binary };
+            records.emplace(context.Reporter, format);
+        }
 
-            context.Reporter.Info() << "Sha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(inStream)) } << std::endl;
+        HRESULT firstFailure = S_OK;
 
-            if (context.Args.Contains(Execution::Args::Type::Msix))
+        for (const auto& result : results)
+        {
+            if (result.Exception)
             {
-                try
+                HRESULT hr = Workflow::HandleException(context, result.Exception);
+                AICLI_LOG(CLI, Error, << "Failed to hash file: " << result.Path.u8string());
+                firstFailure = FAILED(firstFailure) ? firstFailure : hr;
+                continue;
+            }
+
+            if (records)
+            {
+                Json::Value record{ Json::ValueType::objectValue };
+                record["path"] = result.Path.u8string();
+                record["sha256"] = Utility::SHA256::ConvertToString(result.Sha256);
+                if (includeSignature && SUCCEEDED(result.SignatureResult))
                 {
-                    Msix::MsixInfo msixInfo{ inputFile };
-                    auto signature = msixInfo.GetSignature();
-                    auto signatureHash = Utility::SHA256::ComputeHash(signature.data(), static_cast<uint32_t>(signature.size()));
+                    record["signatureSha256"] = Utility::SHA256::ConvertToString(result.SignatureSha256);
+                }
 
-                    context.Reporter.Info() << "SignatureSha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(signatureHash) } << std::endl;
+                records->OutputRecord(record);
+            }
+            else
+            {
+                if (showPaths)
+                {
+                    context.Reporter.Info() << Utility::LocIndString{ result.Path.u8string() } << std::endl;
                 }
-                catch (const wil::ResultException& re)
+
+                context.Reporter.Info() << "Sha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(result.Sha256) } << std::endl;
+
+                if (includeSignature && SUCCEEDED(result.SignatureResult))
                 {
-                    context.Reporter.Warn() << 
-                        Resource::String::MsixSignatureHashFailed << std::endl <<
-                        Resource::String::VerifyFileSignedMsix << std::endl;
-                    AICLI_TERMINATE_CONTEXT(re.GetErrorCode());
+                    context.Reporter.Info() << "SignatureSha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(result.SignatureSha256) } << std::endl;
                 }
             }
-        };
+
+            if (FAILED(result.SignatureResult))
+            {
+                context.Reporter.Warn() <<
+                    Resource::String::MsixSignatureHashFailed << std::endl <<
+                    Resource::String::VerifyFileSignedMsix << std::endl;
+                firstFailure = FAILED(firstFailure) ? firstFailure : result.SignatureResult;
+            }
+        }
+
+        if (records)
+        {
+            records->Complete();
+        }
+
+        if (FAILED(firstFailure))
+        {
+            AICLI_TERMINATE_CONTEXT(firstFailure);
+        }
     }
 }
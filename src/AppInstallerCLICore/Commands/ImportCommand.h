@@ -17,6 +17,10 @@ namespace AppInstaller::CLI
 
         std::string HelpLink() const override;
 
+        // The available sources come from the import file, but the installed source is always needed,
+        // and reading it overlaps parsing and validating the file.
+        bool OpensInstalledSource() const override { return true; }
+
     protected:
         void ExecuteInternal(Execution::Context& context) const override;
     };
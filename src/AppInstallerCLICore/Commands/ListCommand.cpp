@@ -24,6 +24,7 @@ namespace AppInstaller::CLI
             Argument::ForType(Execution::Args::Type::Exact),
             Argument::ForType(Execution::Args::Type::CustomHeader),
             Argument::ForType(Execution::Args::Type::AcceptSourceAgreements),
+            Argument::ForType(Execution::Args::Type::OutputFormat),
         };
     }
 
@@ -68,6 +69,18 @@ namespace AppInstaller::CLI
         return "https://aka.ms/winget-command-list";
     }
 
+    std::vector<Resource::StringId> ListCommand::PreloadedResourceStrings() const
+    {
+        return {
+            Resource::String::SearchName,
+            Resource::String::SearchId,
+            Resource::String::SearchVersion,
+            Resource::String::AvailableHeader,
+            Resource::String::SearchSource,
+            Resource::String::AvailableUpgrades,
+        };
+    }
+
     void ListCommand::ExecuteInternal(Execution::Context& context) const
     {
         context.SetFlags(Execution::ContextFlag::TreatSourceFailuresAsWarning);
@@ -4,6 +4,7 @@
 #include "SourceCommand.h"
 #include "Workflows/CompletionFlow.h"
 #include "Workflows/SourceFlow.h"
+#include "Workflows/UpdateFlow.h"
 #include "Workflows/WorkflowBase.h"
 #include "Resources.h"
 
@@ -157,7 +158,8 @@ namespace AppInstaller::CLI
     {
         context <<
             Workflow::GetSourceListWithFilter <<
-            Workflow::UpdateSources;
+            Workflow::UpdateSources <<
+            Workflow::UpdateUpgradeSnapshot;
     }
 
     std::vector<Argument> SourceRemoveCommand::GetArguments() const
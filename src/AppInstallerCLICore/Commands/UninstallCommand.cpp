@@ -16,7 +16,7 @@ namespace AppInstaller::CLI
     {
         return
         {
-            Argument::ForType(Args::Type::Query),
+            Argument::ForType(Args::Type::Query).SetCountLimit(std::numeric_limits<size_t>::max()),
             Argument::ForType(Args::Type::Manifest),
             Argument::ForType(Args::Type::Id),
             Argument::ForType(Args::Type::Name),
@@ -117,6 +117,13 @@ namespace AppInstaller::CLI
                 Workflow::SearchSourceUsingManifest <<
                 Workflow::EnsureOneMatchFromSearchResult(true);
         }
+        else if (context.Args.GetCount(Execution::Args::Type::Query) > 1)
+        {
+            // find and uninstall the package of each query
+            context <<
+                Workflow::UninstallMultiplePackages;
+            return;
+        }
         else
         {
             // search for a single package to uninstall
@@ -18,6 +18,8 @@ namespace AppInstaller::CLI
 
         std::string HelpLink() const override;
 
+        bool OpensDefaultAndInstalledSources() const override { return true; }
+
     protected:
         void ValidateArgumentsInternal(Execution::Args& execArgs) const override;
         void ExecuteInternal(Execution::Context& context) const override;
@@ -43,7 +43,8 @@ namespace AppInstaller::CLI
         // either for upgrading or for listing available upgrades.
         bool HasArgumentsForMultiplePackages(Execution::Args& execArgs)
         {
-            return execArgs.Contains(Args::Type::All);  
+            return execArgs.Contains(Args::Type::All) ||
+                execArgs.Contains(Args::Type::Prefetch);
         }
 
         // Determines whether there are any arguments only used as options during an upgrade,
@@ -73,7 +74,7 @@ namespace AppInstaller::CLI
         {
             // Valid arguments for list are only those related to the sources and which packages to include.
             // Instead of checking for them, we check that there aren't any other arguments present.
-            return !execArgs.Contains(Args::Type::All) &&
+            return !HasArgumentsForMultiplePackages(execArgs) &&
                 !HasArgumentsForSinglePackage(execArgs) &&
                 !HasArgumentsForInstallOptions(execArgs);
         }
@@ -101,7 +102,9 @@ namespace AppInstaller::CLI
             Argument::ForType(Args::Type::AcceptSourceAgreements),
             Argument::ForType(Execution::Args::Type::CustomHeader),
             Argument{ "all", Argument::NoAlias, Args::Type::All, Resource::String::UpdateAllArgumentDescription, ArgumentType::Flag },
-            Argument{ "include-unknown", Argument::NoAlias, Args::Type::IncludeUnknown, Resource::String::IncludeUnknownArgumentDescription, ArgumentType::Flag }
+            Argument{ "include-unknown", Argument::NoAlias, Args::Type::IncludeUnknown, Resource::String::IncludeUnknownArgumentDescription, ArgumentType::Flag },
+            Argument{ "prefetch", Argument::NoAlias, Args::Type::Prefetch, Resource::String::PrefetchArgumentDescription, ArgumentType::Flag },
+            Argument::ForType(Args::Type::OutputFormat),
         };
     }
 
@@ -155,6 +158,22 @@ namespace AppInstaller::CLI
         return "https://aka.ms/winget-command-upgrade";
     }
 
+    std::vector<Resource::StringId> UpgradeCommand::PreloadedResourceStrings() const
+    {
+        return {
+            Resource::String::SearchName,
+            Resource::String::SearchId,
+            Resource::String::SearchVersion,
+            Resource::String::AvailableHeader,
+            Resource::String::SearchSource,
+            Resource::String::AvailableUpgrades,
+            Resource::String::ReportIdentityFound,
+            Resource::String::InstallerHashVerified,
+            Resource::String::InstallFlowStartingPackageInstall,
+            Resource::String::InstallFlowInstallSuccess,
+        };
+    }
+
     void UpgradeCommand::ValidateArgumentsInternal(Execution::Args& execArgs) const
     {
         if (execArgs.Contains(Execution::Args::Type::Manifest) &&
@@ -176,6 +195,12 @@ namespace AppInstaller::CLI
         {
             throw CommandException(Resource::String::InvalidArgumentWithoutQueryError);
         }
+
+        // Only the list of available upgrades has records to write.
+        if (execArgs.Contains(Args::Type::OutputFormat) && !ShouldListUpgrade(execArgs))
+        {
+            throw CommandException(Resource::String::OutputFormatNotApplicable);
+        }
     }
 
     void UpgradeCommand::ExecuteInternal(Execution::Context& context) const
@@ -191,7 +216,16 @@ namespace AppInstaller::CLI
 
         context <<
             Workflow::ReportExecutionStage(ExecutionStage::Discovery) <<
-            Workflow::OpenSource() <<
+            Workflow::OpenSource();
+
+        // While the installed packages and sources are unchanged, the list of upgrades can come from the snapshot
+        // without opening the installed source at all.
+        if (ShouldListUpgrade(context.Args) && !context.IsTerminated() && Workflow::TryReportUpgradeSnapshot(context))
+        {
+            return;
+        }
+
+        context <<
             Workflow::OpenCompositeSource(Repository::PredefinedSource::Installed);
 
         if (ShouldListUpgrade(context.Args))
@@ -201,11 +235,12 @@ namespace AppInstaller::CLI
                 SearchSourceForMany <<
                 HandleSearchResultFailures <<
                 EnsureMatchesFromSearchResult(true) <<
-                ReportListResult(true);
+                ReportListResult(true) <<
+                SaveUpgradeSnapshot;
         }
-        else if (context.Args.Contains(Execution::Args::Type::All))
+        else if (context.Args.Contains(Execution::Args::Type::All) || context.Args.Contains(Execution::Args::Type::Prefetch))
         {
-            // --all switch updates all packages found
+            // --all switch updates all packages found; --prefetch only downloads their installers
             context <<
                 SearchSourceForMany <<
                 HandleSearchResultFailures <<
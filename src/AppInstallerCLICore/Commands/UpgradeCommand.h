@@ -18,6 +18,10 @@ namespace AppInstaller::CLI
 
         std::string HelpLink() const override;
 
+        bool OpensDefaultAndInstalledSources() const override { return true; }
+
+        std::vector<Resource::StringId> PreloadedResourceStrings() const override;
+
     protected:
         void ValidateArgumentsInternal(Execution::Args& execArgs) const override;
         void ExecuteInternal(Execution::Context& context) const override;
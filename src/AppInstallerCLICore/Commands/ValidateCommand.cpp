@@ -5,16 +5,185 @@
 #include "Workflows/WorkflowBase.h"
 #include "Workflows/DependenciesFlow.h"
 #include "Resources.h"
+#include <winget/ThreadGlobals.h>
+
+#include <atomic>
+#include <thread>
 
 namespace AppInstaller::CLI
 {
     using namespace std::string_view_literals;
     using namespace AppInstaller::Manifest;
 
+    namespace
+    {
+        // The most manifests that are validated at once.
+        constexpr size_t s_MaximumValidationConcurrency = 8;
+
+        struct ManifestValidationResult
+        {
+            std::filesystem::path Path;
+            HRESULT Result = S_OK;
+            std::string Message;
+            std::exception_ptr Exception;
+        };
+
+        ManifestValidateOption GetValidateOption()
+        {
+            ManifestValidateOption validateOption;
+            validateOption.FullValidation = true;
+            validateOption.ThrowOnWarning = true;
+            return validateOption;
+        }
+
+        // Finds the directories in the tree under the root, including itself, that directly contain YAML files.
+        std::vector<std::filesystem::path> FindManifestDirectories(const std::filesystem::path& root)
+        {
+            std::vector<std::filesystem::path> result;
+
+            auto containsYaml = [](const std::filesystem::path& directory)
+            {
+                for (const auto& entry : std::filesystem::directory_iterator{ directory })
+                {
+                    if (entry.is_regular_file() && Utility::CaseInsensitiveEquals(entry.path().extension().u8string(), ".yaml"))
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+            if (containsYaml(root))
+            {
+                result.emplace_back(root);
+            }
+
+            for (const auto& entry : std::filesystem::recursive_directory_iterator{ root })
+            {
+                if (entry.is_directory() && containsYaml(entry.path()))
+                {
+                    result.emplace_back(entry.path());
+                }
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        void ValidateManifestDirectory(ManifestValidationResult& result)
+        {
+            try
+            {
+                (void)YamlParser::CreateFromPath(result.Path, GetValidateOption());
+            }
+            catch (const ManifestException& e)
+            {
+                result.Result = e.IsWarningOnly() ? APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_WARNING : APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE;
+                result.Message = e.GetManifestErrorMessage();
+            }
+            catch (...)
+            {
+                result.Result = APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE;
+                result.Exception = std::current_exception();
+            }
+        }
+
+        // Validates every manifest in the tree under the given path, on as many threads as are useful, and reports each of them in order.
+        void ValidateManifestTree(Execution::Context& context)
+        {
+            std::filesystem::path root = Utility::ConvertToUTF16(context.Args.GetArg(Execution::Args::Type::ValidateManifest));
+
+            std::vector<ManifestValidationResult> results;
+            for (auto& directory : FindManifestDirectories(root))
+            {
+                results.emplace_back().Path = std::move(directory);
+            }
+
+            if (results.empty())
+            {
+                context.Reporter.Error() << Resource::String::ManifestValidationNoneFound << std::endl;
+                AICLI_TERMINATE_CONTEXT(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+            }
+
+            size_t workerCount = std::min({ results.size(), s_MaximumValidationConcurrency, static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())) });
+            AICLI_LOG(CLI, Info, << "Validating " << results.size() << " manifests with " << workerCount << " threads");
+
+            std::atomic<size_t> nextResult = 0;
+            std::vector<std::future<void>> workers;
+
+            for (size_t i = 0; i < workerCount; ++i)
+            {
+                auto threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(context.GetThreadGlobals(), ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+
+                workers.emplace_back(std::async(std::launch::async, [&, threadGlobals]()
+                    {
+                        auto previousThreadGlobals = threadGlobals->SetForCurrentThread();
+
+                        for (size_t j = nextResult++; j < results.size(); j = nextResult++)
+                        {
+                            ValidateManifestDirectory(results[j]);
+                        }
+                    }));
+            }
+
+            for (auto& worker : workers)
+            {
+                worker.wait();
+            }
+
+            size_t warningCount = 0;
+            size_t failureCount = 0;
+
+            for (const auto& result : results)
+            {
+                context.Reporter.Info() << Utility::LocIndString{ result.Path.u8string() } << std::endl;
+
+                if (result.Exception)
+                {
+                    context.Reporter.Error() << Resource::String::ManifestValidationFail << std::endl;
+                    Workflow::HandleException(context, result.Exception);
+                    ++failureCount;
+                }
+                else if (result.Result == APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE)
+                {
+                    context.Reporter.Error() << Resource::String::ManifestValidationFail << std::endl;
+                    context.Reporter.Info() << result.Message << std::endl;
+                    ++failureCount;
+                }
+                else if (result.Result == APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_WARNING)
+                {
+                    context.Reporter.Warn() << Resource::String::ManifestValidationWarning << std::endl;
+                    context.Reporter.Info() << result.Message << std::endl;
+                    ++warningCount;
+                }
+                else
+                {
+                    context.Reporter.Info() << Resource::String::ManifestValidationSuccess << std::endl;
+                }
+            }
+
+            context.Reporter.Info() << std::endl <<
+                Resource::String::ManifestValidationSummaryTotal << ' ' << results.size() << std::endl <<
+                Resource::String::ManifestValidationSummaryWarning << ' ' << warningCount << std::endl <<
+                Resource::String::ManifestValidationSummaryFailed << ' ' << failureCount << std::endl;
+
+            if (failureCount)
+            {
+                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE);
+            }
+            else if (warningCount)
+            {
+                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_WARNING);
+            }
+        }
+    }
+
     std::vector<Argument> ValidateCommand::GetArguments() const
     {
         return {
             Argument::ForType(Execution::Args::Type::ValidateManifest),
+            Argument{ "recurse", Argument::NoAlias, Execution::Args::Type::ValidateRecurse, Resource::String::ValidateRecurseArgumentDescription, ArgumentType::Flag },
         };
     }
 
@@ -35,18 +204,22 @@ namespace AppInstaller::CLI
 
     void ValidateCommand::ExecuteInternal(Execution::Context& context) const
     {
+        context << Workflow::VerifyPath(Execution::Args::Type::ValidateManifest);
+
+        if (context.Args.Contains(Execution::Args::Type::ValidateRecurse))
+        {
+            context << ValidateManifestTree;
+            return;
+        }
+
         context <<
-            Workflow::VerifyPath(Execution::Args::Type::ValidateManifest) <<
             [](Execution::Context& context)
         {
             auto inputFile = Utility::ConvertToUTF16(context.Args.GetArg(Execution::Args::Type::ValidateManifest));
 
             try
             {
-                ManifestValidateOption validateOption;
-                validateOption.FullValidation = true;
-                validateOption.ThrowOnWarning = true;
-                auto manifest = YamlParser::CreateFromPath(inputFile, validateOption);
+                auto manifest = YamlParser::CreateFromPath(inputFile, GetValidateOption());
 
                 context.Add<Execution::Data::Manifest>(manifest);
                 context <<
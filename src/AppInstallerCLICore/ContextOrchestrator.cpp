@@ -6,6 +6,7 @@
 #include "COMContext.h"
 #include "Commands/COMCommand.h"
 #include "winget/UserSettings.h"
+#include <winget/PerformanceCounters.h>
 #include <Commands/RootCommand.h>
 
 namespace AppInstaller::CLI::Execution
@@ -16,15 +17,14 @@ namespace AppInstaller::CLI::Execution
         constexpr static std::string_view OperationCommandQueueName = "operation"sv;
 
         // Callback function used by worker threads in the queue.
-        // context must be a pointer to a queue item.
-        void CALLBACK OrchestratorQueueWorkCallback(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WORK)
+        // context must be a pointer to the queue.
+        void CALLBACK OrchestratorQueueWorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK)
         {
-            auto queueItem = reinterpret_cast<OrchestratorQueueItem*>(context);
-            auto queue = queueItem->GetCurrentQueue();
-            if (queue)
-            {
-                queue->RunItem(queueItem->GetId());
-            }
+            // Items such as downloads and installs take a long time; let the pool know so that it can start other threads for short work.
+            CallbackMayRunLong(instance);
+
+            auto queue = reinterpret_cast<OrchestratorQueue*>(context);
+            while (queue->RunNextItem());
         }
 
         // Get command queue name based on command name.
@@ -86,7 +86,7 @@ namespace AppInstaller::CLI::Execution
 
     void ContextOrchestrator::EnqueueAndRunItem(std::shared_ptr<OrchestratorQueueItem> item)
     {
-        std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
 
         if (item->IsOnFirstCommand())
         {
@@ -99,7 +99,7 @@ namespace AppInstaller::CLI::Execution
 
     void ContextOrchestrator::RemoveItemInState(const OrchestratorQueueItem& item, OrchestratorQueueItemState state)
     {
-        std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
         for (const auto& queue : m_commandQueues)
         {
             if (queue.second->RemoveItemInState(item, state, true))
@@ -119,7 +119,7 @@ namespace AppInstaller::CLI::Execution
 
     std::shared_ptr<OrchestratorQueueItem> ContextOrchestrator::GetQueueItem(const OrchestratorQueueItemId& queueItemId)
     {
-        std::lock_guard<std::mutex> lock{ m_queueLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lock{ m_queueLock };
 
         return FindById(queueItemId);
     }
@@ -142,29 +142,110 @@ namespace AppInstaller::CLI::Execution
         }
     }
 
-    _Requires_lock_held_(m_queueLock)
-    std::deque<std::shared_ptr<OrchestratorQueueItem>>::iterator OrchestratorQueue::FindIteratorById(const OrchestratorQueueItemId& comparisonQueueItemId)
+    std::map<std::string, OrchestratorQueueMetrics> ContextOrchestrator::GetQueueMetrics()
     {
-        return std::find_if(m_queueItems.begin(), m_queueItems.end(), [&comparisonQueueItemId](const std::shared_ptr<OrchestratorQueueItem>& item) {return (item->GetId().IsSame(comparisonQueueItemId)); });
+        std::map<std::string, OrchestratorQueueMetrics> result;
+
+        for (const auto& queue : m_commandQueues)
+        {
+            result.emplace(queue.first, queue.second->GetMetrics());
+        }
+
+        return result;
+    }
+
+    void ContextOrchestrator::SetAllowedThreads(std::string_view queueName, UINT32 allowedThreads)
+    {
+        THROW_HR_IF(E_INVALIDARG, queueName == OperationCommandQueueName && allowedThreads != 1);
+
+        auto itr = m_commandQueues.find(std::string{ queueName });
+        THROW_HR_IF(E_NOT_SET, itr == m_commandQueues.end());
+
+        itr->second->SetAllowedThreads(allowedThreads);
+    }
+
+    bool OrchestratorQueue::ScheduleKey::operator<(const ScheduleKey& other) const
+    {
+        if (Priority != other.Priority)
+        {
+            return Priority > other.Priority;
+        }
+
+        if (CallerTag != other.CallerTag)
+        {
+            return CallerTag < other.CallerTag;
+        }
+
+        return Sequence < other.Sequence;
     }
 
     _Requires_lock_held_(m_queueLock)
     std::shared_ptr<OrchestratorQueueItem> OrchestratorQueue::FindById(const OrchestratorQueueItemId& comparisonQueueItemId)
     {
-        auto itr = FindIteratorById(comparisonQueueItemId);
+        auto itr = m_queueItems.find(comparisonQueueItemId);
         if (itr != m_queueItems.end())
         {
-            return *itr;
+            return itr->second;
         }
 
         return {};
     }
 
+    _Requires_lock_held_(m_queueLock)
+    std::shared_ptr<OrchestratorQueueItem> OrchestratorQueue::PopNextScheduledItem()
+    {
+        auto itr = m_schedule.begin();
+        if (itr == m_schedule.end())
+        {
+            return {};
+        }
+
+        std::shared_ptr<OrchestratorQueueItem> item = std::move(itr->second);
+        m_currentTag = std::max(m_currentTag, itr->first.CallerTag);
+        m_schedule.erase(itr);
+
+        // A caller whose next tag has been caught up with would get the current tag anyway, so forget it.
+        auto callerItr = m_callerNextTag.find(item->GetCallerId());
+        if (callerItr != m_callerNextTag.end() && callerItr->second <= m_currentTag)
+        {
+            m_callerNextTag.erase(callerItr);
+        }
+
+        if (item->GetState() == OrchestratorQueueItemState::Queued)
+        {
+            auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - item->GetQueuedTime());
+            ++m_startedItems;
+            m_totalWaitTime += waitTime;
+            m_longestWaitTime = std::max(m_longestWaitTime, waitTime);
+
+            AICLI_LOG(CLI, Verbose, << "Queue " << m_commandName << " starting item after waiting " << waitTime.count() << "ms; " << m_schedule.size() << " items still waiting");
+        }
+
+        UpdateQueueDepth();
+        return item;
+    }
+
+    _Requires_lock_held_(m_queueLock)
+    void OrchestratorQueue::SubmitWorkers()
+    {
+        while (m_workers < m_allowedThreads && m_workers < m_schedule.size())
+        {
+            ++m_workers;
+            SubmitThreadpoolWork(m_work.get());
+        }
+    }
+
+    _Requires_lock_held_(m_queueLock)
+    void OrchestratorQueue::UpdateQueueDepth()
+    {
+        Performance::Counters::SetQueueDepth(m_commandName, m_schedule.size(), m_queueItems.size() - m_schedule.size());
+    }
+
     void OrchestratorQueue::EnqueueItem(std::shared_ptr<OrchestratorQueueItem> item)
     {
         {
-            std::lock_guard<std::mutex> lockQueue{ m_queueLock };
-            m_queueItems.push_back(item);
+            std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
+            m_queueItems.emplace(item->GetId(), item);
         }
 
         // Add the package to the Installing source so that it can be queried using the Source interface.
@@ -175,63 +256,85 @@ namespace AppInstaller::CLI::Execution
         }
 
         {
-            std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+            std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
             item->SetState(OrchestratorQueueItemState::Queued);
+            item->SetQueuedTime(std::chrono::steady_clock::now());
+
+            uint64_t& callerNextTag = m_callerNextTag[item->GetCallerId()];
+            uint64_t callerTag = std::max(callerNextTag, m_currentTag);
+            callerNextTag = callerTag + 1;
+
+            m_schedule.emplace(ScheduleKey{ item->GetPriority(), callerTag, m_nextSequence++ }, item);
+            UpdateQueueDepth();
         }
     }
 
     OrchestratorQueue::OrchestratorQueue(std::string_view commandName, UINT32 allowedThreads) :
-        m_commandName(commandName), m_allowedThreads(allowedThreads)
+        m_commandName(commandName), m_allowedThreads(allowedThreads), m_queueLock(std::string{ "OrchestratorQueue." }.append(commandName))
+    {
+        m_work.reset(CreateThreadpoolWork(OrchestratorQueueWorkCallback, this, nullptr));
+        THROW_LAST_ERROR_IF_NULL(m_work);
+    }
+
+    void OrchestratorQueue::EnqueueAndRunItem(std::shared_ptr<OrchestratorQueueItem> item)
     {
-        m_threadPool.reset(CreateThreadpool(nullptr));
-        THROW_LAST_ERROR_IF_NULL(m_threadPool);
-        m_threadPoolCleanupGroup.reset(CreateThreadpoolCleanupGroup());
-        THROW_LAST_ERROR_IF_NULL(m_threadPoolCleanupGroup);
-        InitializeThreadpoolEnvironment(&m_threadPoolCallbackEnviron);
-        SetThreadpoolCallbackPool(&m_threadPoolCallbackEnviron, m_threadPool.get());
-        SetThreadpoolCallbackCleanupGroup(&m_threadPoolCallbackEnviron, m_threadPoolCleanupGroup.get(), nullptr);
-
-        THROW_LAST_ERROR_IF(!SetThreadpoolThreadMinimum(m_threadPool.get(), 1));
-        SetThreadpoolThreadMaximum(m_threadPool.get(), m_allowedThreads);
+        EnqueueItem(item);
+        item->SetCurrentQueue(this);
+
+        std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
+        SubmitWorkers();
     }
 
-    OrchestratorQueue::~OrchestratorQueue()
+    OrchestratorQueueMetrics OrchestratorQueue::GetMetrics()
     {
-        CloseThreadpoolCleanupGroupMembers(m_threadPoolCleanupGroup.get(), false, nullptr);
+        std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
+
+        OrchestratorQueueMetrics result;
+        result.QueuedItems = m_schedule.size();
+        result.RunningItems = m_queueItems.size() - m_schedule.size();
+        result.AllowedThreads = m_allowedThreads;
+        result.StartedItems = m_startedItems;
+        result.TotalWaitTime = m_totalWaitTime;
+        result.LongestWaitTime = m_longestWaitTime;
+        return result;
     }
 
-    void OrchestratorQueue::EnqueueAndRunItem(std::shared_ptr<OrchestratorQueueItem> item)
+    void OrchestratorQueue::SetAllowedThreads(UINT32 allowedThreads)
     {
-        EnqueueItem(item);
+        THROW_HR_IF(E_INVALIDARG, allowedThreads == 0);
 
-        item->SetCurrentQueue(this);
-        auto work = CreateThreadpoolWork(OrchestratorQueueWorkCallback, item.get(), &m_threadPoolCallbackEnviron);
-        SubmitThreadpoolWork(work);
+        std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
+        m_allowedThreads = allowedThreads;
+
+        // When the limit is lowered, the extra workers stop as they finish their current items.
+        SubmitWorkers();
     }
 
-    void OrchestratorQueue::RunItem(const OrchestratorQueueItemId& itemId)
+    bool OrchestratorQueue::RunNextItem()
     {
         try
         {
             std::shared_ptr<OrchestratorQueueItem> item;
             bool isCancelled = false;
+            std::chrono::steady_clock::time_point startTime;
 
-            // Try to find the item in the queue.
+            // Take the next item from the schedule.
             {
-                std::lock_guard<std::mutex> lockQueue{ m_queueLock };
-                item = FindById(itemId);
-
-                if (!item)
+                std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
+                if (m_workers > m_allowedThreads || m_schedule.empty())
                 {
-                    // Item should be in the queue; this shouldn't happen.
-                    return;
+                    --m_workers;
+                    return false;
                 }
 
+                item = PopNextScheduledItem();
+
                 // Only run if the item is queued and not cancelled.
                 if (item->GetState() == OrchestratorQueueItemState::Queued)
                 {
                     // Mark it as running so that it cannot be cancelled by other threads.
                     item->SetState(OrchestratorQueueItemState::Running);
+                    startTime = std::chrono::steady_clock::now();
                 }
                 else if (item->GetState() == OrchestratorQueueItemState::Cancelled)
                 {
@@ -243,6 +346,7 @@ namespace AppInstaller::CLI::Execution
             {
                 // Do this separate from above block as the Remove function needs to manage the lock.
                 RemoveItemInState(*item, OrchestratorQueueItemState::Cancelled, true);
+                return true;
             }
 
             // Get the item's command and execute it.
@@ -272,12 +376,18 @@ namespace AppInstaller::CLI::Execution
 
             item->GetContext().EnableCtrlHandler(false);
 
+            Performance::Counters::RecordQueueItem(m_commandName, item->GetId().GetPackageId(), startTime - item->GetQueuedTime(), std::chrono::steady_clock::now() - startTime, terminationHR);
+
             if (FAILED(terminationHR) || item->IsComplete())
             {
                 RemoveItemInState(*item, OrchestratorQueueItemState::Running, true);
             }
             else
             {
+                // Let listeners know this stage is done while the item waits in the next queue,
+                // e.g. that the installer is staged and waiting for the operation queue.
+                item->GetContext().ReportExecutionStageCompleted();
+
                 // Remove item from this queue and add it to the queue for the next command.
                 RemoveItemInState(*item, OrchestratorQueueItemState::Running, false);
                 ContextOrchestrator::Instance().EnqueueAndRunItem(item);
@@ -286,6 +396,8 @@ namespace AppInstaller::CLI::Execution
         catch (...)
         {
         }
+
+        return true;
     }
 
     bool OrchestratorQueue::RemoveItemInState(const OrchestratorQueueItem& item, OrchestratorQueueItemState state, bool isGlobalRemove)
@@ -296,11 +408,11 @@ namespace AppInstaller::CLI::Execution
         bool foundItem = false;
 
         {
-            std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+            std::lock_guard<Performance::Counters::CountedMutex> lockQueue{ m_queueLock };
 
             // Look for the item. It's ok if the item is not found since multiple listeners may try to remove the same item.
-            auto itr = FindIteratorById(item.GetId());
-            if (itr != m_queueItems.end() && (*itr)->GetState() == state)
+            auto itr = m_queueItems.find(item.GetId());
+            if (itr != m_queueItems.end() && itr->second->GetState() == state)
             {
                 foundItem = true;
 
@@ -309,12 +421,13 @@ namespace AppInstaller::CLI::Execution
                 // it, we simply mark it as cancelled.
                 if (state == OrchestratorQueueItemState::Running || state == OrchestratorQueueItemState::Cancelled)
                 {
-                    (*itr)->SetCurrentQueue(nullptr);
+                    itr->second->SetCurrentQueue(nullptr);
                     m_queueItems.erase(itr);
+                    UpdateQueueDepth();
                 }
                 else if (state == OrchestratorQueueItemState::Queued)
                 {
-                    (*itr)->SetState(OrchestratorQueueItemState::Cancelled);
+                    itr->second->SetState(OrchestratorQueueItemState::Cancelled);
                 }
             }
         }
@@ -334,6 +447,16 @@ namespace AppInstaller::CLI::Execution
                 (GetSourceId() == comparedId.GetSourceId()));
     }
 
+    bool OrchestratorQueueItemId::operator<(const OrchestratorQueueItemId& other) const
+    {
+        if (GetPackageId() != other.GetPackageId())
+        {
+            return GetPackageId() < other.GetPackageId();
+        }
+
+        return GetSourceId() < other.GetSourceId();
+    }
+
     std::unique_ptr<OrchestratorQueueItem> OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring packageId, std::wstring sourceId, std::unique_ptr<COMContext> context, bool isUpgrade)
     {
         std::unique_ptr<OrchestratorQueueItem> item = std::make_unique<OrchestratorQueueItem>(OrchestratorQueueItemId(std::move(packageId), std::move(sourceId)), std::move(context), isUpgrade ? PackageOperationType::Upgrade : PackageOperationType::Install);
@@ -9,7 +9,10 @@
 #include "CompletionData.h"
 #include "Command.h"
 #include "COMContext.h"
+#include <winget/PerformanceCounters.h>
 
+#include <chrono>
+#include <map>
 #include <string_view>
 
 namespace AppInstaller::CLI::Execution
@@ -33,6 +36,9 @@ namespace AppInstaller::CLI::Execution
         std::wstring_view GetSourceId() const { return m_sourceId; }
 
         bool IsSame(const OrchestratorQueueItemId& comparisonQueueItemId) const;
+
+        // Orders ids so that they can be used as keys; ids that are the same are equivalent.
+        bool operator<(const OrchestratorQueueItemId& other) const;
     private:
         std::wstring m_packageId;
         std::wstring m_sourceId;
@@ -48,6 +54,14 @@ namespace AppInstaller::CLI::Execution
         Uninstall,
     };
 
+    // The priority of an item, relative to the other items waiting in the same queue.
+    enum class OrchestratorQueueItemPriority
+    {
+        Low,
+        Normal,
+        High,
+    };
+
     struct OrchestratorQueueItem
     {
         OrchestratorQueueItem(OrchestratorQueueItemId id, std::unique_ptr<COMContext> context, PackageOperationType operationType) :
@@ -78,6 +92,18 @@ namespace AppInstaller::CLI::Execution
         bool IsApplicableForInstallingSource() const { return m_operationType == PackageOperationType::Install || m_operationType == PackageOperationType::Upgrade; }
         PackageOperationType GetPackageOperationType() const { return m_operationType; }
 
+        // Items with a higher priority are run before any waiting items of lower priority.
+        OrchestratorQueueItemPriority GetPriority() const { return m_priority; }
+        void SetPriority(OrchestratorQueueItemPriority priority) { m_priority = priority; }
+
+        // Identifies the caller that submitted the item; waiting items of the same priority are shared fairly between callers.
+        DWORD GetCallerId() const { return m_callerId; }
+        void SetCallerId(DWORD callerId) { m_callerId = callerId; }
+
+        // The time at which the item was last queued.
+        std::chrono::steady_clock::time_point GetQueuedTime() const { return m_queuedTime; }
+        void SetQueuedTime(std::chrono::steady_clock::time_point queuedTime) { m_queuedTime = queuedTime; }
+
     private:
         OrchestratorQueueItemState m_state = OrchestratorQueueItemState::NotQueued;
         std::unique_ptr<COMContext> m_context;
@@ -87,6 +113,25 @@ namespace AppInstaller::CLI::Execution
         bool m_isOnFirstCommand = true;
         OrchestratorQueue* m_currentQueue = nullptr;
         PackageOperationType m_operationType = PackageOperationType::None;
+        OrchestratorQueueItemPriority m_priority = OrchestratorQueueItemPriority::Normal;
+        DWORD m_callerId = 0;
+        std::chrono::steady_clock::time_point m_queuedTime{};
+    };
+
+    // A snapshot of the state of one of the queues.
+    struct OrchestratorQueueMetrics
+    {
+        // The number of items waiting to be run.
+        size_t QueuedItems = 0;
+        // The number of items currently running.
+        size_t RunningItems = 0;
+        // The number of items allowed to run at the same time.
+        UINT32 AllowedThreads = 0;
+        // The number of items that have been started since the queue was created.
+        uint64_t StartedItems = 0;
+        // The total and the longest time that started items spent waiting to be run.
+        std::chrono::milliseconds TotalWaitTime{};
+        std::chrono::milliseconds LongestWaitTime{};
     };
 
     struct OrchestratorQueueItemFactory
@@ -112,8 +157,15 @@ namespace AppInstaller::CLI::Execution
         void AddItemManifestToInstallingSource(const OrchestratorQueueItem& queueItem);
         void RemoveItemManifestFromInstallingSource(const OrchestratorQueueItem& queueItem);
 
+        // Gets the metrics of every queue, by queue name.
+        std::map<std::string, OrchestratorQueueMetrics> GetQueueMetrics();
+
+        // Changes the number of items that the named queue allows to run at the same time.
+        // The operation queue always runs a single item, as installs cannot be done concurrently.
+        void SetAllowedThreads(std::string_view queueName, UINT32 allowedThreads);
+
     private:
-        std::mutex m_queueLock;
+        Performance::Counters::CountedMutex m_queueLock{ "ContextOrchestrator" };
         void AddCommandQueue(std::string_view commandName, UINT32 allowedThreads);
         void RemoveItemInState(const OrchestratorQueueItem& item, OrchestratorQueueItemState state);
 
@@ -127,10 +179,11 @@ namespace AppInstaller::CLI::Execution
     // One of the queues used by the orchestrator.
     // All items in the queue execute the same command.
     // The queue allows multiple items to run at the same time, up to a limit.
+    // Items run on the process thread pool, which is shared with the other work of the process; the limit
+    // is enforced by the number of workers the queue has submitted, so an idle queue holds no threads.
     struct OrchestratorQueue
     {
         OrchestratorQueue(std::string_view commandName, UINT32 allowedThreads);
-        ~OrchestratorQueue();
 
         // Name of the command this queue can execute
         std::string_view CommandName() const { return m_commandName; }
@@ -147,30 +200,66 @@ namespace AppInstaller::CLI::Execution
         _Requires_lock_held_(m_queueLock)
         std::shared_ptr<OrchestratorQueueItem> FindById(const OrchestratorQueueItemId& queueItemId);
 
-        // Runs a single item from the queue.
-        void RunItem(const OrchestratorQueueItemId& itemId);
+        // Runs the waiting item that should go next.
+        // Returns false, having given up the worker of the calling thread, if there is no item to run or the queue has too many workers.
+        bool RunNextItem();
+
+        // Gets the current metrics of the queue.
+        OrchestratorQueueMetrics GetMetrics();
+
+        // Changes the number of threads allowed to run items in this queue.
+        void SetAllowedThreads(UINT32 allowedThreads);
 
     private:
+        // The order in which waiting items are run; the lowest key runs next.
+        // Within a priority, each caller is given a tag one past its previous item, but never behind the
+        // tag of the last item started. This alternates between callers rather than running a large batch
+        // from one caller before a single item from another.
+        struct ScheduleKey
+        {
+            OrchestratorQueueItemPriority Priority;
+            uint64_t CallerTag;
+            uint64_t Sequence;
+
+            bool operator<(const ScheduleKey& other) const;
+        };
+
         // Enqueues an item.
         void EnqueueItem(std::shared_ptr<OrchestratorQueueItem> item);
 
+        // Removes the next item to run from the schedule, recording how long it waited.
+        _Requires_lock_held_(m_queueLock)
+        std::shared_ptr<OrchestratorQueueItem> PopNextScheduledItem();
+
+        // Submits workers until either the allowed number are running or there is one for every waiting item.
+        _Requires_lock_held_(m_queueLock)
+        void SubmitWorkers();
+
+        // Publishes the current number of waiting and running items to the performance counters.
         _Requires_lock_held_(m_queueLock)
-        std::deque<std::shared_ptr<OrchestratorQueueItem>>::iterator FindIteratorById(const OrchestratorQueueItemId& comparisonQueueItemId);
+        void UpdateQueueDepth();
 
         std::string_view m_commandName;
 
         // Number of threads allowed to run items in this queue.
-        const UINT32 m_allowedThreads;
-
-        // Thread pool for this queue, and associated objects.
-        // All work items will be added to the callback environment, and the cleanup group
-        // will manage their closing.
-        // See https://docs.microsoft.com/windows/win32/procthread/using-the-thread-pool-functions
-        TP_CALLBACK_ENVIRON m_threadPoolCallbackEnviron;
-        wil::unique_any<PTP_POOL, decltype(CloseThreadpool), CloseThreadpool> m_threadPool;
-        wil::unique_any<PTP_CLEANUP_GROUP, decltype(CloseThreadpoolCleanupGroup), CloseThreadpoolCleanupGroup> m_threadPoolCleanupGroup;
-
-        std::mutex m_queueLock;
-        std::deque<std::shared_ptr<OrchestratorQueueItem>> m_queueItems;
+        UINT32 m_allowedThreads;
+
+        Performance::Counters::CountedMutex m_queueLock;
+        // The work is submitted once for every worker; each worker runs whichever item is next in the schedule until there are none left.
+        // Destroying it waits for the running workers to finish.
+        wil::unique_threadpool_work_nocancel m_work;
+        // The number of workers submitted and not yet finished.
+        UINT32 m_workers = 0;
+        // All items in the queue, whether waiting or running.
+        std::map<OrchestratorQueueItemId, std::shared_ptr<OrchestratorQueueItem>> m_queueItems;
+        // The items waiting to be run.
+        std::map<ScheduleKey, std::shared_ptr<OrchestratorQueueItem>> m_schedule;
+        std::map<DWORD, uint64_t> m_callerNextTag;
+        uint64_t m_currentTag = 0;
+        uint64_t m_nextSequence = 0;
+
+        uint64_t m_startedItems = 0;
+        std::chrono::milliseconds m_totalWaitTime{};
+        std::chrono::milliseconds m_longestWaitTime{};
     };
 }
@@ -4,7 +4,11 @@
 #include "Public/AppInstallerCLICore.h"
 #include "Commands/RootCommand.h"
 #include "ExecutionContext.h"
+#include "Workflows/EarlySourceOpen.h"
 #include "Workflows/WorkflowBase.h"
+#include <winget/MemoryBudget.h>
+#include <winget/Performance.h>
+#include <winget/PerformanceCounters.h>
 #include <winget/UserSettings.h>
 #include "Commands/InstallCommand.h"
 #include "COMContext.h"
@@ -17,6 +21,7 @@ using namespace winrt;
 using namespace winrt::Windows::Foundation;
 using namespace AppInstaller::CLI;
 using namespace AppInstaller::Utility::literals;
+using namespace std::string_view_literals;
 
 namespace AppInstaller::CLI
 {
@@ -45,6 +50,39 @@ namespace AppInstaller::CLI
         private:
             UINT m_previousCP = 0;
         };
+
+        // The timings are enabled ahead of parsing the arguments so that the startup stages are included.
+        bool ContainsPerfArgument(int argc, wchar_t const** argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                if (argv[i] == L"--perf"sv)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Determines whether the invocation only needs the minimum of initialization.
+        // These are the invocations that need to feel instantaneous, and that neither read settings nor produce anything worth logging.
+        bool IsLightweightInvocation(int argc, wchar_t const** argv)
+        {
+            if (argc < 2)
+            {
+                return false;
+            }
+
+            std::wstring_view first = argv[1];
+            if (first == L"complete"sv)
+            {
+                return true;
+            }
+
+            int expectedArgs = ContainsPerfArgument(argc, argv) ? 3 : 2;
+            return argc == expectedArgs && (first == L"--version"sv || first == L"-v"sv);
+        }
     }
 
     int CoreMain(int argc, wchar_t const** argv) try
@@ -60,24 +98,66 @@ namespace AppInstaller::CLI
 
         Logging::UseGlobalTelemetryLoggerActivityIdOnly();
 
+        // Source updates may have been left running while the command used the existing data.
+        // Declared before the context so that they are waited on after it, and any sources it holds, are released.
+        auto waitForSourceUpdates = wil::scope_exit([]() { Repository::Source::WaitForDetachedUpdates(); });
+
+        if (ContainsPerfArgument(argc, argv))
+        {
+            Performance::EnableCollection();
+        }
+
+        // Lightweight invocations get no log file; they do not load the settings that control it, and their logs are not worth the cost of creating it.
+        bool isLightweight = IsLightweightInvocation(argc, argv);
+
         Execution::Context context{ std::cout, std::cin };
         auto previousThreadGlobals = context.SetForCurrentThread();
         context.EnableCtrlHandler();
 
-        // Enable all logging for this phase; we will update once we have the arguments
-        Logging::Log().EnableChannel(Logging::Channel::All);
-        Logging::Log().SetLevel(Settings::User().Get<Settings::Setting::LoggingLevelPreference>());
-        Logging::AddFileLogger();
+        if (isLightweight)
+        {
+            context.SetFlags(Execution::ContextFlag::Lightweight);
+        }
+        else
+        {
+            Performance::ScopedTimer timer{ "Startup::Logging" };
+
+            // Enable all logging for this phase; we will update once we have the arguments
+            Logging::Log().EnableChannel(Logging::Channel::All);
+            Logging::Log().SetLevel(Settings::User().Get<Settings::Setting::LoggingLevelPreference>());
+            if (Settings::User().Get<Settings::Setting::LoggingBinaryTrace>())
+            {
+                Logging::AddBinaryTraceLogger();
+            }
+            else
+            {
+                Logging::AddFileLogger();
+            }
+        }
+
         Logging::EnableWilFailureTelemetry();
 
         // Set output to UTF8
         ConsoleOutputCPRestore utf8CP(CP_UTF8);
 
+        // Without a buffer, each insertion into the output is its own write to the console, which is slow over remote connections.
+        // Buffered, the writes of a line or a progress frame are coalesced and written at each std::endl and std::flush,
+        // when input is read (std::cin is tied to std::cout), and at exit.
+        static constexpr size_t s_outputBufferSize = 64 * 1024;
+        setvbuf(stdout, nullptr, _IOFBF, s_outputBufferSize);
+
         Logging::Telemetry().SetCaller("winget-cli");
-        Logging::Telemetry().LogStartup();
 
-        // Initiate the background cleanup of the log file location.
-        Logging::BeginLogFileCleanup();
+        if (!isLightweight)
+        {
+            {
+                Performance::ScopedTimer timer{ "Startup::Telemetry" };
+                Logging::Telemetry().LogStartup();
+            }
+
+            // Initiate the background cleanup of the log file location.
+            Logging::BeginLogFileCleanup();
+        }
 
         context << Workflow::ReportExecutionStage(Workflow::ExecutionStage::ParseArgs);
 
@@ -102,8 +182,13 @@ namespace AppInstaller::CLI
         // The root command is our fallback in the event of very bad or very little input
         std::unique_ptr<Command> command = std::make_unique<RootCommand>();
 
+        // Waited on as the invocation ends, after the command has taken what it needs from the cache.
+        std::future<void> preloadedStrings;
+
         try
         {
+            Performance::ScopedTimer timer{ "Startup::ParseArguments" };
+
             std::unique_ptr<Command> subCommand = command->FindSubCommand(invocation);
             while (subCommand)
             {
@@ -112,6 +197,19 @@ namespace AppInstaller::CLI
             }
             Logging::Telemetry().LogCommand(command->FullName());
 
+            // Start opening the sources now, so that their I/O overlaps processing the arguments.
+            // Whether they are used depends on the arguments; any that are not are cancelled once the command completes.
+            if (!isLightweight && command->OpensInstalledSource())
+            {
+                context.Add<Execution::Data::EarlySourceOpen>(std::make_shared<Workflow::EarlySourceOpen>(context, command->OpensDefaultAndInstalledSources()));
+            }
+
+            // Creating the resource loader, and resolving the strings of the output, then overlaps opening the sources.
+            if (!isLightweight)
+            {
+                preloadedStrings = Resource::Loader::PreloadStrings(command->PreloadedResourceStrings());
+            }
+
             command->ParseArguments(invocation, context.Args);
 
             // Change logging level to Info if Verbose not requested
@@ -120,7 +218,16 @@ namespace AppInstaller::CLI
                 Logging::Log().SetLevel(Logging::Level::Verbose);
             }
 
-            context.UpdateForArgs();
+            if (context.Args.Contains(Execution::Args::Type::Perf))
+            {
+                Performance::EnableCollection();
+            }
+
+            // The visual style is only needed for progress, and requires loading the settings.
+            if (!isLightweight)
+            {
+                context.UpdateForArgs();
+            }
 
             command->ValidateArguments(context.Args);
         }
@@ -140,7 +247,14 @@ namespace AppInstaller::CLI
             return APPINSTALLER_CLI_ERROR_BLOCKED_BY_POLICY;
         }
 
-        return Execute(context, command);
+        int result = Execute(context, command);
+
+        if (!isLightweight)
+        {
+            Performance::LogPeakWorkingSet();
+        }
+
+        return result;
     }
     // End of the line exceptions that are not ever expected.
     // Telemetry cannot be reliable beyond this point, so don't let these happen.
@@ -152,5 +266,14 @@ namespace AppInstaller::CLI
     void ServerInitialize()
     {
         AppInstaller::CLI::Execution::COMContext::SetLoggers();
+        Performance::Counters::StartPublishing();
+
+        // The server lives across many catalog connections, so keep the installed packages up to date rather than reading them for each one.
+        Repository::Source::TrackInstalledChanges();
+    }
+
+    std::chrono::milliseconds ServerIdleTimeout()
+    {
+        return Settings::User().Get<Settings::Setting::ServerIdleTimeoutInSeconds>();
     }
 }
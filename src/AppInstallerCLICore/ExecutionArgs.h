@@ -54,6 +54,7 @@ namespace AppInstaller::CLI::Execution
 
             //Validate Command
             ValidateManifest,
+            ValidateRecurse,
 
             // Complete Command
             Word,
@@ -63,6 +64,7 @@ namespace AppInstaller::CLI::Execution
             // Export Command
             OutputFile,
             IncludeVersions,
+            SkipAgreementsCheck,
 
             // Import Command
             ImportFile,
@@ -82,10 +84,13 @@ namespace AppInstaller::CLI::Execution
             Help, // Show command usage
             Info, // Show general info about WinGet
             VerboseLogs, // Increases winget logging level to verbose
+            Perf, // Displays the time spent in each operation
             DependencySource, // Index source to be queried against for finding dependencies
             CustomHeader, // Optional Rest source header
             AcceptSourceAgreements, // Accept all source agreements
             IncludeUnknown, // Used in Upgrade command to allow upgrades of packages with unknown versions
+            Prefetch, // Used in Upgrade command to download the installers of all available upgrades without installing them
+            OutputFormat, // Writes the results as json or jsonl records, instead of a table
 
             // Used for demonstration purposes
             ExperimentalArg,
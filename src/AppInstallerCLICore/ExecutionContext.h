@@ -59,6 +59,8 @@ namespace AppInstaller::CLI::Execution
         // TODO: Remove when the source interface is refactored.
         TreatSourceFailuresAsWarning = 0x10,
         ShowSearchResultsOnPartialFailure = 0x20,
+        // The invocation must be as fast as possible, such as for shell completion, so only the initialization that it needs is done.
+        Lightweight = 0x40,
     };
 
     DEFINE_ENUM_FLAG_OPERATORS(ContextFlag);
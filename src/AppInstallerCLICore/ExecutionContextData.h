@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <winget/ARPKeySnapshot.h>
 #include <winget/RepositorySource.h>
+#include <winget/UpgradeSnapshot.h>
 #include <winget/Manifest.h>
 #include "CompletionData.h"
 #include "PackageCollection.h"
@@ -15,6 +17,17 @@
 #include <vector>
 
 
+namespace AppInstaller::CLI::Workflow
+{
+    struct InstallerPrefetch;
+    struct EarlySourceOpen;
+    struct DependencyLookupCache;
+    struct ManifestComparatorOptions;
+    struct MsixStaging;
+    struct InstallRecordBatch;
+    struct MsiTransaction;
+}
+
 namespace AppInstaller::CLI::Execution
 {
     // Names a piece of data stored in the context by a workflow step.
@@ -47,9 +60,32 @@ namespace AppInstaller::CLI::Execution
         // On import: Sources for the imported packages
         Sources,
         ARPSnapshot,
+        ARPKeySnapshot,
         Dependencies,
         DependencySource,
         AllowedArchitectures,
+        // On import and upgrade all: The background downloads of the installers of PackagesToInstall
+        InstallerPrefetch,
+        // On commands that use the default and installed sources: The opens of them started during startup
+        EarlySourceOpen,
+        // On installing multiple packages: The dependency searches shared by all of the packages
+        DependencyLookupCache,
+        // On upgrade all: The settings and system inputs of installer selection, read once for all of the packages
+        ManifestComparatorOptions,
+        // On installing multiple packages: The background staging of the MSIX packages
+        MsixStaging,
+        // On MSIX install from a URL: The full name of the package, read along with its signature
+        MsixPackageFullName,
+        // On installing multiple packages: The installations waiting to be recorded to the tracking catalogs
+        InstallRecordBatch,
+        // On listing upgrades: The fingerprints that the list is computed from, to be stored with it
+        UpgradeSnapshot,
+        // On COM download: A handle to the verified installer file that prevents it from being modified before it is installed
+        InstallerFileLock,
+        // On installing multiple packages: The path of the prefetched installer and the result of its security scan
+        InstallerScanResult,
+        // On installing multiple packages: The Windows Installer transaction that consecutive direct MSI installs are grouped into
+        MsiTransaction,
         Max
     };
 
@@ -190,6 +226,12 @@ namespace AppInstaller::CLI::Execution
             using value_t = std::vector<std::tuple<Utility::LocIndString, Utility::LocIndString, Utility::LocIndString>>;
         };
 
+        template <>
+        struct DataMapping<Data::ARPKeySnapshot>
+        {
+            using value_t = Repository::ARPKeySnapshot;
+        };
+
         template <>
         struct DataMapping<Data::Dependencies>
         {
@@ -207,5 +249,71 @@ namespace AppInstaller::CLI::Execution
         {
             using value_t = std::vector<Utility::Architecture>;
         };
+
+        template <>
+        struct DataMapping<Data::InstallerPrefetch>
+        {
+            using value_t = std::shared_ptr<Workflow::InstallerPrefetch>;
+        };
+
+        template <>
+        struct DataMapping<Data::EarlySourceOpen>
+        {
+            using value_t = std::shared_ptr<Workflow::EarlySourceOpen>;
+        };
+
+        template <>
+        struct DataMapping<Data::DependencyLookupCache>
+        {
+            using value_t = std::shared_ptr<Workflow::DependencyLookupCache>;
+        };
+
+        template <>
+        struct DataMapping<Data::ManifestComparatorOptions>
+        {
+            using value_t = std::shared_ptr<const Workflow::ManifestComparatorOptions>;
+        };
+
+        template <>
+        struct DataMapping<Data::MsixStaging>
+        {
+            using value_t = std::shared_ptr<Workflow::MsixStaging>;
+        };
+
+        template <>
+        struct DataMapping<Data::MsixPackageFullName>
+        {
+            using value_t = std::string;
+        };
+
+        template <>
+        struct DataMapping<Data::InstallRecordBatch>
+        {
+            using value_t = std::shared_ptr<Workflow::InstallRecordBatch>;
+        };
+
+        template <>
+        struct DataMapping<Data::UpgradeSnapshot>
+        {
+            using value_t = Repository::UpgradeSnapshot;
+        };
+
+        template <>
+        struct DataMapping<Data::InstallerFileLock>
+        {
+            using value_t = std::shared_ptr<wil::unique_hfile>;
+        };
+
+        template <>
+        struct DataMapping<Data::InstallerScanResult>
+        {
+            using value_t = std::pair<std::filesystem::path, HRESULT>;
+        };
+
+        template <>
+        struct DataMapping<Data::MsiTransaction>
+        {
+            using value_t = std::shared_ptr<Workflow::MsiTransaction>;
+        };
     }
 }
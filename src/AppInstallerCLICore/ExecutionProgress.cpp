@@ -213,14 +213,58 @@ namespace AppInstaller::CLI::Execution
             {
                 m_out << Progress::Construct(Progress::State::None);
             }
+
+            m_out << std::flush;
         }
 
         m_canceled = false;
         m_spinnerRunning = false;
     }
 
+    ProgressBar::~ProgressBar()
+    {
+        StopDrawing();
+    }
+
     void ProgressBar::ShowProgress(uint64_t current, uint64_t maximum, ProgressType type)
     {
+        m_current = current;
+        m_maximum = maximum;
+        m_type = type;
+        ++m_updateCount;
+
+        if (!m_drawJob.valid())
+        {
+            m_stopDrawing.ResetEvent();
+            m_drawJob = std::async(std::launch::async, &ProgressBar::DrawProgressInternal, this);
+        }
+    }
+
+    void ProgressBar::DrawProgressInternal()
+    {
+        // Fast enough to appear smooth, while keeping the cost of drawing small however often progress is reported.
+        constexpr DWORD s_drawIntervalInMilliseconds = 100;
+
+        do
+        {
+            DrawLatestProgress();
+        }
+        while (WaitForSingleObject(m_stopDrawing.get(), s_drawIntervalInMilliseconds) == WAIT_TIMEOUT);
+    }
+
+    void ProgressBar::DrawLatestProgress()
+    {
+        uint64_t updateCount = m_updateCount;
+        if (updateCount == m_drawnUpdateCount)
+        {
+            return;
+        }
+
+        m_drawnUpdateCount = updateCount;
+        uint64_t current = m_current;
+        uint64_t maximum = m_maximum;
+        ProgressType type = m_type;
+
         if (current < m_lastCurrent)
         {
             ClearLine();
@@ -235,12 +279,29 @@ namespace AppInstaller::CLI::Execution
             ShowProgressNoVT(current, maximum, type);
         }
 
+        // Each frame is written to the console at once
+        m_out << std::flush;
+
         m_lastCurrent = current;
         m_isVisible = true;
     }
 
+    void ProgressBar::StopDrawing()
+    {
+        if (m_drawJob.valid())
+        {
+            m_stopDrawing.SetEvent();
+            m_drawJob.get();
+
+            // Show where the progress ended, even if it was reported since the last interval
+            DrawLatestProgress();
+        }
+    }
+
     void ProgressBar::EndProgress(bool hideProgressWhenDone)
     {
+        StopDrawing();
+
         if (m_isVisible)
         {
             if (hideProgressWhenDone)
@@ -260,6 +321,7 @@ namespace AppInstaller::CLI::Execution
                 m_out << Progress::Construct(Progress::State::None);
             }
 
+            m_out << std::flush;
             m_isVisible = false;
         }
     }
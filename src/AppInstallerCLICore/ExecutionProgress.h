@@ -60,12 +60,16 @@ namespace AppInstaller::CLI::Execution
     };
 
     // Displays progress 
+    // The progress given is only recorded; it is drawn at a fixed interval on a separate thread,
+    // so that frequent updates neither wait on the console nor spend their time redrawing.
     class ProgressBar : public details::ProgressVisualizerBase
     {
     public:
         ProgressBar(BaseStream& stream, bool enableVT) :
             details::ProgressVisualizerBase(stream, enableVT) {}
 
+        ~ProgressBar();
+
         void ShowProgress(uint64_t current, uint64_t maximum, ProgressType type);
 
         void EndProgress(bool hideProgressWhenDone);
@@ -76,6 +80,24 @@ namespace AppInstaller::CLI::Execution
         std::atomic<bool> m_isVisible = false;
         uint64_t m_lastCurrent = 0;
 
+        // The latest progress, and a count of the updates to it so that unchanged progress is not redrawn.
+        std::atomic<uint64_t> m_current = 0;
+        std::atomic<uint64_t> m_maximum = 0;
+        std::atomic<ProgressType> m_type = ProgressType::None;
+        std::atomic<uint64_t> m_updateCount = 0;
+        uint64_t m_drawnUpdateCount = 0;
+
+        wil::unique_event m_stopDrawing{ wil::EventOptions::ManualReset };
+        std::future<void> m_drawJob;
+
+        void DrawProgressInternal();
+
+        // Draws the latest progress if it has changed since it was last drawn.
+        void DrawLatestProgress();
+
+        // Stops the drawing thread, if it is running, and draws the final progress.
+        void StopDrawing();
+
         void ClearLine();
 
         void ShowProgressNoVT(uint64_t current, uint64_t maximum, ProgressType type);
@@ -44,6 +44,8 @@ namespace AppInstaller::CLI::Execution
         {
             Output,
             Completion,
+            // Only structured records, from the --output argument.
+            Json,
         };
 
         // The level for the Output channel.
@@ -83,6 +85,9 @@ namespace AppInstaller::CLI::Execution
         // Get a stream for outputting completion words.
         OutputStream Completion() { return OutputStream(*m_out, m_channel == Channel::Completion, false); }
 
+        // Get a stream for outputting structured records; these are never formatted.
+        OutputStream Json() { return OutputStream(*m_out, m_channel == Channel::Json, false); }
+
         // Gets a stream for output of the given level.
         OutputStream GetOutputStream(Level level);
 
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "JsonOutput.h"
+
+
+namespace AppInstaller::CLI::Execution
+{
+    using namespace std::string_view_literals;
+
+    std::optional<OutputFormat> ConvertToOutputFormat(std::string_view value)
+    {
+        if (Utility::CaseInsensitiveEquals(value, "json"sv))
+        {
+            return OutputFormat::Json;
+        }
+        else if (Utility::CaseInsensitiveEquals(value, "jsonl"sv))
+        {
+            return OutputFormat::JsonLines;
+        }
+
+        return {};
+    }
+
+    OutputFormat GetOutputFormat(const Args& args)
+    {
+        if (args.Contains(Args::Type::OutputFormat))
+        {
+            return ConvertToOutputFormat(args.GetArg(Args::Type::OutputFormat)).value_or(OutputFormat::Table);
+        }
+
+        return OutputFormat::Table;
+    }
+
+    JsonRecordOutput::JsonRecordOutput(Reporter& reporter, OutputFormat format) :
+        m_reporter(reporter), m_format(format)
+    {
+        THROW_HR_IF(E_INVALIDARG, format == OutputFormat::Table);
+
+        Json::StreamWriterBuilder writerBuilder;
+        writerBuilder.settings_["indentation"] = "";
+        writerBuilder.settings_["emitUTF8"] = true;
+        m_writer.reset(writerBuilder.newStreamWriter());
+    }
+
+    void JsonRecordOutput::OutputRecord(const Json::Value& record)
+    {
+        m_record.str({});
+
+        if (m_format == OutputFormat::Json)
+        {
+            m_record << (m_empty ? '[' : ',') << '\n';
+        }
+
+        m_writer->write(record, &m_record);
+
+        if (m_format == OutputFormat::JsonLines)
+        {
+            m_record << '\n';
+        }
+
+        m_reporter.Json() << m_record.str();
+        m_empty = false;
+    }
+
+    void JsonRecordOutput::Complete()
+    {
+        if (m_format == OutputFormat::Json)
+        {
+            m_reporter.Json() << (m_empty ? "[]\n"sv : "\n]\n"sv);
+        }
+
+        m_reporter.Json() << std::flush;
+    }
+}
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "ExecutionArgs.h"
+#include "ExecutionReporter.h"
+
+#include <json.h>
+
+#include <memory>
+#include <optional>
+#include <string_view>
+
+
+namespace AppInstaller::CLI::Execution
+{
+    // The formats that results can be written in.
+    enum class OutputFormat
+    {
+        // The default, localized table.
+        Table,
+        // A single JSON array of records.
+        Json,
+        // One JSON object per line.
+        JsonLines,
+    };
+
+    // Converts the value of the output argument; returns an empty value if it is not recognized.
+    std::optional<OutputFormat> ConvertToOutputFormat(std::string_view value);
+
+    // Gets the format that the results should be written in.
+    OutputFormat GetOutputFormat(const Args& args);
+
+    // Writes records to the JSON channel as they are produced, rather than collecting them first.
+    // The property names are fixed, as they are meant to be read by tools rather than people.
+    struct JsonRecordOutput
+    {
+        JsonRecordOutput(Reporter& reporter, OutputFormat format);
+
+        JsonRecordOutput(const JsonRecordOutput&) = delete;
+        JsonRecordOutput& operator=(const JsonRecordOutput&) = delete;
+
+        void OutputRecord(const Json::Value& record);
+
+        // Ends the output; for the Json format, this closes the array (which is empty if there were no records).
+        void Complete();
+
+        bool IsEmpty() const { return m_empty; }
+
+    private:
+        Reporter& m_reporter;
+        OutputFormat m_format;
+        std::unique_ptr<Json::StreamWriter> m_writer;
+        std::ostringstream m_record;
+        bool m_empty = true;
+    };
+}
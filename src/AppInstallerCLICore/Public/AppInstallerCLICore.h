@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <chrono>
 
 namespace AppInstaller::CLI
 {
@@ -9,4 +10,7 @@ namespace AppInstaller::CLI
 
     // Initializes the Windows Package Manager COM server.
     void ServerInitialize();
+
+    // Gets how long the Windows Package Manager COM server stays running once it has no more clients.
+    std::chrono::milliseconds ServerIdleTimeout();
 }
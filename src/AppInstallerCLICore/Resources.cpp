@@ -39,7 +39,41 @@ namespace AppInstaller::CLI::Resource
     std::string Loader::ResolveString(
         std::wstring_view resKey) const
     {
-        return Utility::ConvertToUTF8(m_wingetLoader.GetString(resKey));
+        {
+            std::lock_guard<std::mutex> lock{ m_cacheLock };
+            auto itr = m_cache.find(resKey);
+            if (itr != m_cache.end())
+            {
+                return itr->second;
+            }
+        }
+
+        // Resolved outside of the lock; a string resolved by two threads at once gets the same value from each.
+        std::string value = Utility::ConvertToUTF8(m_wingetLoader.GetString(resKey));
+
+        std::lock_guard<std::mutex> lock{ m_cacheLock };
+        m_cache.try_emplace(std::wstring{ resKey }, value);
+        return value;
+    }
+
+    std::future<void> Loader::PreloadStrings(std::vector<StringId> ids)
+    {
+        return std::async(std::launch::async, [ids = std::move(ids)]()
+            {
+                try
+                {
+                    const Loader& loader = Instance();
+                    for (const auto& id : ids)
+                    {
+                        (void)loader.ResolveString(id);
+                    }
+                }
+                catch (...)
+                {
+                    // Output gets the same failure when it loads the strings itself.
+                    LOG_CAUGHT_EXCEPTION_MSG("Failed to preload resource strings");
+                }
+            });
     }
 
     Utility::LocIndView GetFixedString(FixedString fs)
@@ -6,7 +6,12 @@
 
 #include <winrt/Windows.ApplicationModel.Resources.h>
 
+#include <future>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace AppInstaller::CLI::Resource
 {
@@ -65,6 +70,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(ExportCommandShortDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ExportedPackageRequiresLicenseAgreement);
         WINGET_DEFINE_RESOURCE_STRINGID(ExportIncludeVersionsArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(ExportSkipAgreementsCheckArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ExportSourceArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ExternalDependencies);
         WINGET_DEFINE_RESOURCE_STRINGID(ExtraPositionalError);
@@ -127,6 +133,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(InstallerHashVerified);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallerLogAvailable);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallFlowInstallSuccess);
+        WINGET_DEFINE_RESOURCE_STRINGID(InstallFlowMsiTransactionRolledBack);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallFlowRegistrationDeferred);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallFlowReturnCodeAlreadyInstalled);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallFlowReturnCodeBlockedByPolicy);
@@ -166,7 +173,11 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(MainHomepage);
         WINGET_DEFINE_RESOURCE_STRINGID(ManifestArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationFail);
+        WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationNoneFound);
         WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationSuccess);
+        WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationSummaryFailed);
+        WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationSummaryTotal);
+        WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationSummaryWarning);
         WINGET_DEFINE_RESOURCE_STRINGID(ManifestValidationWarning);
         WINGET_DEFINE_RESOURCE_STRINGID(MissingArgumentError);
         WINGET_DEFINE_RESOURCE_STRINGID(MonikerArgumentDescription);
@@ -195,17 +206,27 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(OpenSourceFailedNoSourceDefined);
         WINGET_DEFINE_RESOURCE_STRINGID(Options);
         WINGET_DEFINE_RESOURCE_STRINGID(OutputFileArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(OutputFormatArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(OutputFormatNotApplicable);
         WINGET_DEFINE_RESOURCE_STRINGID(OverrideArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(Package);
         WINGET_DEFINE_RESOURCE_STRINGID(PackageAgreementsNotAgreedTo);
         WINGET_DEFINE_RESOURCE_STRINGID(PackageAgreementsPrompt);
         WINGET_DEFINE_RESOURCE_STRINGID(PackageDependencies);
         WINGET_DEFINE_RESOURCE_STRINGID(PendingWorkError);
+        WINGET_DEFINE_RESOURCE_STRINGID(PerfArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(PerfHeaderCount);
+        WINGET_DEFINE_RESOURCE_STRINGID(PerfHeaderOperation);
+        WINGET_DEFINE_RESOURCE_STRINGID(PerfHeaderTime);
         WINGET_DEFINE_RESOURCE_STRINGID(PoliciesDisabled);
         WINGET_DEFINE_RESOURCE_STRINGID(PoliciesEnabled);
         WINGET_DEFINE_RESOURCE_STRINGID(PoliciesPolicy);
         WINGET_DEFINE_RESOURCE_STRINGID(PoliciesState);
         WINGET_DEFINE_RESOURCE_STRINGID(PositionArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(PrefetchArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(PrefetchFailed);
+        WINGET_DEFINE_RESOURCE_STRINGID(PrefetchHasFailures);
+        WINGET_DEFINE_RESOURCE_STRINGID(PrefetchNotRequired);
         WINGET_DEFINE_RESOURCE_STRINGID(PrivacyStatement);
         WINGET_DEFINE_RESOURCE_STRINGID(PromptOptionNo);
         WINGET_DEFINE_RESOURCE_STRINGID(PromptOptionYes);
@@ -336,6 +357,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(UninstallFailedWithCode);
         WINGET_DEFINE_RESOURCE_STRINGID(UninstallFlowStartingPackageUninstall);
         WINGET_DEFINE_RESOURCE_STRINGID(UninstallFlowUninstallSuccess);
+        WINGET_DEFINE_RESOURCE_STRINGID(UninstallMultipleHasFailures);
         WINGET_DEFINE_RESOURCE_STRINGID(UnrecognizedCommand);
         WINGET_DEFINE_RESOURCE_STRINGID(UpdateAllArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(UpdateNotApplicable);
@@ -351,6 +373,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(ValidateCommandReportDependencies);
         WINGET_DEFINE_RESOURCE_STRINGID(ValidateCommandShortDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ValidateManifestArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(ValidateRecurseArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(VerboseLogsArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(VerifyFileFailedIsDirectory);
         WINGET_DEFINE_RESOURCE_STRINGID(VerifyFileFailedNotExist);
@@ -388,10 +411,17 @@ namespace AppInstaller::CLI::Resource
         static const Loader& Instance();
 
         // Gets the the string resource value.
+        // Values are cached for the life of the process, as output often uses the same strings many times.
         std::string ResolveString(std::wstring_view resKey) const;
 
+        // Creates the loader and resolves the given strings on a background thread, so that output does not wait on them.
+        // The returned future completes once they are all in the cache.
+        static std::future<void> PreloadStrings(std::vector<StringId> ids);
+
     private:
         winrt::Windows::ApplicationModel::Resources::ResourceLoader m_wingetLoader;
+        mutable std::mutex m_cacheLock;
+        mutable std::map<std::wstring, std::string, std::less<>> m_cache;
 
         Loader();
     };
@@ -36,6 +36,7 @@ namespace AppInstaller::CLI::Execution
     {
         using header_t = std::array<Resource::LocString, FieldCount>;
         using line_t = std::array<std::string, FieldCount>;
+        using widths_t = std::array<size_t, FieldCount>;
 
         TableOutput(Reporter& reporter, header_t&& header, size_t sizingBuffer = 50) :
             m_reporter(reporter), m_sizingBuffer(sizingBuffer)
@@ -52,14 +53,17 @@ namespace AppInstaller::CLI::Execution
         {
             m_empty = false;
 
+            // The width of each cell is measured once, as it is needed both to size the columns and to pad or trim the cell.
+            widths_t widths = GetWidths(line);
+
             if (m_buffer.size() < m_sizingBuffer)
             {
-                m_buffer.emplace_back(std::move(line));
+                m_buffer.push_back({ std::move(line), widths });
             }
             else
             {
                 EvaluateAndFlushBuffer();
-                OutputLineToStream(line);
+                OutputLineToStream(line, widths);
             }
         }
 
@@ -86,13 +90,35 @@ namespace AppInstaller::CLI::Execution
             bool SpaceAfter = true;
         };
 
+        // A line held until the columns are sized, along with the width of each of its cells.
+        struct BufferedLine
+        {
+            line_t Line;
+            widths_t Widths;
+        };
+
         Reporter& m_reporter;
         std::array<Column, FieldCount> m_columns;
         size_t m_sizingBuffer;
-        std::vector<line_t> m_buffer;
+        std::vector<BufferedLine> m_buffer;
         bool m_bufferEvaluated = false;
         bool m_empty = true;
 
+        // Reused for every line, so that the output is written a whole line at a time without allocating for each one.
+        std::string m_output;
+
+        static widths_t GetWidths(const line_t& line)
+        {
+            widths_t result{};
+
+            for (size_t i = 0; i < FieldCount; ++i)
+            {
+                result[i] = Utility::UTF8ColumnWidth(line[i]);
+            }
+
+            return result;
+        }
+
         void EvaluateAndFlushBuffer()
         {
             if (m_bufferEvaluated)
@@ -105,7 +131,7 @@ namespace AppInstaller::CLI::Execution
             {
                 for (size_t i = 0; i < FieldCount; ++i)
                 {
-                    m_columns[i].MaxLength = std::max(m_columns[i].MaxLength, Utility::UTF8ColumnWidth(line[i]));
+                    m_columns[i].MaxLength = std::max(m_columns[i].MaxLength, line.Widths[i]);
                 }
             }
 
@@ -171,67 +197,80 @@ namespace AppInstaller::CLI::Execution
                 totalRequired = consoleWidth - 1;
             }
 
-            // Header line
+            // The header and the buffered lines are written together, with a single flush.
             line_t headerLine;
+            widths_t headerWidths{};
 
             for (size_t i = 0; i < FieldCount; ++i)
             {
                 headerLine[i] = m_columns[i].Name.get();
+                headerWidths[i] = m_columns[i].MinLength;
             }
 
-            OutputLineToStream(headerLine);
+            m_output.clear();
+            m_output.reserve((totalRequired + 1) * (m_buffer.size() + 2));
 
-            m_reporter.Info() << std::string(totalRequired, '-') << std::endl;
+            AppendLine(m_output, headerLine, headerWidths);
+            m_output.append(totalRequired, '-');
+            m_output += '\n';
 
             for (const auto& line : m_buffer)
             {
-                OutputLineToStream(line);
+                AppendLine(m_output, line.Line, line.Widths);
             }
 
+            m_reporter.Info() << m_output << std::flush;
+
             m_bufferEvaluated = true;
         }
 
-        void OutputLineToStream(const line_t& line)
+        void OutputLineToStream(const line_t& line, const widths_t& widths)
         {
-            auto out = m_reporter.Info();
+            m_output.clear();
+            AppendLine(m_output, line, widths);
+            m_reporter.Info() << m_output << std::flush;
+        }
 
+        void AppendLine(std::string& out, const line_t& line, const widths_t& widths) const
+        {
             for (size_t i = 0; i < FieldCount; ++i)
             {
                 const auto& col = m_columns[i];
 
                 if (col.MaxLength)
                 {
-                    size_t valueLength = Utility::UTF8ColumnWidth(line[i]);
+                    size_t valueLength = widths[i];
 
                     if (valueLength > col.MaxLength)
                     {
                         size_t actualWidth;
-                        out << Utility::UTF8TrimRightToColumnWidth(line[i], col.MaxLength - 1, actualWidth) << "\xE2\x80\xA6"; // UTF8 encoding of ellipsis (…) character
+                        out += Utility::UTF8TrimRightToColumnWidth(line[i], col.MaxLength - 1, actualWidth);
+                        out += "\xE2\x80\xA6"; // UTF8 encoding of ellipsis (…) character
 
                         // Some characters take 2 unit space, the trimmed string length might be 1 less than the expected length.
                         if (actualWidth != col.MaxLength - 1)
                         {
-                            out << ' ';
+                            out += ' ';
                         }
 
                         if (col.SpaceAfter)
                         {
-                            out << ' ';
+                            out += ' ';
                         }
                     }
                     else
                     {
-                        out << line[i];
+                        out += line[i];
 
                         if (col.SpaceAfter)
                         {
-                            out << std::string(col.MaxLength - valueLength + 1, ' ');
+                            out.append(col.MaxLength - valueLength + 1, ' ');
                         }
                     }
                 }
             }
 
-            out << std::endl;
+            out += '\n';
         }
     };
 }
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "CompletionFlow.h"
+#include <winget/CompletionIndex.h>
 
 namespace AppInstaller::CLI::Workflow
 {
@@ -22,6 +23,181 @@ namespace AppInstaller::CLI::Workflow
                 stream << value << std::endl;
             }
         }
+
+        bool ContainsAnyArg(const Execution::Args& args, std::initializer_list<Execution::Args::Type> types)
+        {
+            return std::any_of(types.begin(), types.end(), [&](Execution::Args::Type type) { return args.Contains(type); });
+        }
+
+        // Completes the values of a field from the completion indexes, without opening the sources.
+        bool TryCompleteFieldFromIndex(Execution::Context& context, const std::vector<Repository::CompletionIndex>& indexes, std::vector<Repository::PackageMatchField> fields)
+        {
+            // Filters are applied as substring matches against fields that are not in the index; leave those to the search.
+            if (ContainsAnyArg(context.Args, { Execution::Args::Type::Id, Execution::Args::Type::Name, Execution::Args::Type::Moniker,
+                Execution::Args::Type::Tag, Execution::Args::Type::Command, Execution::Args::Type::Count, Execution::Args::Type::Exact }))
+            {
+                return false;
+            }
+
+            const std::string& word = context.Get<Data::CompletionData>().Word();
+
+            std::vector<std::string> values;
+            for (const auto& index : indexes)
+            {
+                for (auto field : fields)
+                {
+                    auto fieldValues = index.Complete(field, word);
+                    std::move(fieldValues.begin(), fieldValues.end(), std::back_inserter(values));
+                }
+            }
+
+            std::sort(values.begin(), values.end());
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+
+            auto stream = context.Reporter.Completion();
+            for (const auto& value : values)
+            {
+                OutputCompletionString(stream, value);
+            }
+
+            return true;
+        }
+
+        // Completes the versions or channels of the single package that the arguments refer to from the completion indexes.
+        bool TryCompleteVersionsFromIndex(Execution::Context& context, const std::vector<Repository::CompletionIndex>& indexes, bool channels)
+        {
+            const auto& args = context.Args;
+
+            // Exact matching and filters on fields that are not in the index are left to the search.
+            if (ContainsAnyArg(args, { Execution::Args::Type::Tag, Execution::Args::Type::Command, Execution::Args::Type::Exact }))
+            {
+                return false;
+            }
+
+            std::vector<std::pair<Execution::Args::Type, Repository::PackageMatchField>> filters;
+            for (auto [type, field] : {
+                std::make_pair(Execution::Args::Type::Id, Repository::PackageMatchField::Id),
+                std::make_pair(Execution::Args::Type::Name, Repository::PackageMatchField::Name),
+                std::make_pair(Execution::Args::Type::Moniker, Repository::PackageMatchField::Moniker) })
+            {
+                if (args.Contains(type))
+                {
+                    filters.emplace_back(type, field);
+                }
+            }
+
+            if (!args.Contains(Execution::Args::Type::Query) && filters.empty())
+            {
+                return false;
+            }
+
+            const Repository::CompletionIndex* matchIndex = nullptr;
+            uint32_t matchPackage = 0;
+            size_t matchCount = 0;
+
+            for (const auto& index : indexes)
+            {
+                std::vector<uint32_t> candidates;
+                if (args.Contains(Execution::Args::Type::Query))
+                {
+                    candidates = index.FindPackages(args.GetArg(Execution::Args::Type::Query),
+                        { Repository::PackageMatchField::Id, Repository::PackageMatchField::Name, Repository::PackageMatchField::Moniker });
+                }
+                else
+                {
+                    candidates = index.FindPackages(args.GetArg(filters[0].first), { filters[0].second });
+                }
+
+                for (const auto& filter : filters)
+                {
+                    auto filtered = index.FindPackages(args.GetArg(filter.first), { filter.second });
+                    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                        [&](uint32_t package) { return std::find(filtered.begin(), filtered.end(), package) == filtered.end(); }), candidates.end());
+                }
+
+                if (!candidates.empty())
+                {
+                    matchIndex = &index;
+                    matchPackage = candidates[0];
+                }
+
+                matchCount += candidates.size();
+            }
+
+            if (matchCount == 0)
+            {
+                // The query may be a package family name or product code, which are not in the index.
+                return false;
+            }
+            else if (matchCount > 1)
+            {
+                AICLI_LOG(CLI, Verbose, << "Completion index found multiple packages, cannot complete");
+                return true;
+            }
+
+            const std::string& word = context.Get<Data::CompletionData>().Word();
+            auto stream = context.Reporter.Completion();
+
+            std::vector<std::string> values;
+            for (const auto& vc : matchIndex->GetVersions(matchPackage))
+            {
+                const std::string& value = (channels ? vc.GetChannel().ToString() : vc.GetVersion().ToString());
+                if ((word.empty() || Utility::ICUCaseInsensitiveStartsWith(value, word)) &&
+                    std::find(values.begin(), values.end(), value) == values.end())
+                {
+                    values.emplace_back(value);
+                }
+            }
+
+            for (const auto& value : values)
+            {
+                OutputCompletionString(stream, value);
+            }
+
+            return true;
+        }
+
+        // Attempts to complete the value from the completion indexes of the sources, which is much faster than opening them.
+        // Returns false if the completion must be done by searching the sources instead.
+        bool TryCompleteFromIndex(Execution::Context& context, Execution::Args::Type type)
+        {
+            try
+            {
+                auto indexes = Repository::CompletionIndex::TryOpenForSources(context.Args.GetArg(Execution::Args::Type::Source));
+                if (!indexes)
+                {
+                    return false;
+                }
+
+                switch (type)
+                {
+                case Execution::Args::Type::Query:
+                    if (context.Get<Data::CompletionData>().Word().empty())
+                    {
+                        return false;
+                    }
+                    return TryCompleteFieldFromIndex(context, indexes.value(),
+                        { Repository::PackageMatchField::Id, Repository::PackageMatchField::Name, Repository::PackageMatchField::Moniker });
+                case Execution::Args::Type::Id:
+                    return TryCompleteFieldFromIndex(context, indexes.value(), { Repository::PackageMatchField::Id });
+                case Execution::Args::Type::Name:
+                    return TryCompleteFieldFromIndex(context, indexes.value(), { Repository::PackageMatchField::Name });
+                case Execution::Args::Type::Moniker:
+                    return TryCompleteFieldFromIndex(context, indexes.value(), { Repository::PackageMatchField::Moniker });
+                case Execution::Args::Type::Version:
+                    return TryCompleteVersionsFromIndex(context, indexes.value(), false);
+                case Execution::Args::Type::Channel:
+                    return TryCompleteVersionsFromIndex(context, indexes.value(), true);
+                }
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(CLI, Info, << "Unable to complete from the index, falling back to searching the sources");
+            }
+
+            return false;
+        }
     }
 
     void CompleteSourceName(Execution::Context& context)
@@ -103,6 +279,11 @@ namespace AppInstaller::CLI::Workflow
 
     void CompleteWithSingleSemanticsForValue::operator()(Execution::Context& context) const
     {
+        if (TryCompleteFromIndex(context, m_type))
+        {
+            return;
+        }
+
         switch (m_type)
         {
         case Execution::Args::Type::Query:
@@ -120,6 +120,22 @@ namespace AppInstaller::CLI::Workflow
         if (context.Contains(Execution::Data::PackageVersion))
         {
             const auto& packageVersion = context.Get<Execution::Data::PackageVersion>();
+
+            // The command's own source already holds the installed packages, correlated when it was opened, and nothing
+            // has been installed since; so use them along with the source of the package rather than opening them again.
+            Repository::Source installedSource;
+            if (context.Contains(Execution::Data::Source))
+            {
+                installedSource = context.Get<Execution::Data::Source>().GetInstalledSource();
+            }
+
+            if (installedSource)
+            {
+                AICLI_LOG(CLI, Verbose, << "Using the open installed source for dependencies");
+                context.Add<Execution::Data::DependencySource>(Repository::Source{ installedSource, packageVersion->GetSource(), Repository::CompositeSearchBehavior::AvailablePackages });
+                return;
+            }
+
             context.Add<Execution::Data::DependencySource>(packageVersion->GetSource());
             context <<
                 Workflow::OpenCompositeSource(Repository::PredefinedSource::Installed, true);
@@ -162,12 +178,23 @@ namespace AppInstaller::CLI::Workflow
             AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_INTERNAL_ERROR); 
         }
 
+        // Use the lookups of the whole install batch if there is one.
+        std::shared_ptr<DependencyLookupCache> lookupCache;
+        if (context.Contains(Execution::Data::DependencyLookupCache))
+        {
+            lookupCache = context.Get<Execution::Data::DependencyLookupCache>();
+        }
+        else
+        {
+            lookupCache = std::make_shared<DependencyLookupCache>();
+        }
+
         std::map<string_t, DependencyPackageCandidate> idToPackageMap;
         bool foundError = false;
         DependencyGraph dependencyGraph(rootAsDependency, rootDependencies, 
             [&](Dependency node)
             {
-                DependencyNodeProcessor nodeProcessor(context);
+                DependencyNodeProcessor nodeProcessor(context, lookupCache);
 
                 auto result = nodeProcessor.EvaluateDependencies(node);
                 DependencyList list = nodeProcessor.GetDependencyList();
@@ -186,6 +213,12 @@ namespace AppInstaller::CLI::Workflow
                 return list;
             });
 
+        // Search for each level of the graph at once; the nodes are still evaluated one at a time, in the same order.
+        dependencyGraph.SetPrefetchFunction([&](const std::vector<Dependency>& frontier)
+            {
+                lookupCache->Prefetch(context, context.Get<Execution::Data::DependencySource>(), frontier);
+            });
+
         dependencyGraph.BuildGraph();
 
         if (foundError)
@@ -196,7 +229,17 @@ namespace AppInstaller::CLI::Workflow
 
         if (dependencyGraph.HasLoop())
         {
-            context.Reporter.Warn() << Resource::String::DependenciesFlowContainsLoop;
+            auto warn = context.Reporter.Warn();
+            warn << Resource::String::DependenciesFlowContainsLoop;
+
+            const auto& loop = dependencyGraph.GetLoop();
+            for (size_t i = 0; i < loop.size(); ++i)
+            {
+                warn << (i == 0 ? ": " : " -> ") << loop[i].Id;
+            }
+
+            warn << std::endl;
+            AICLI_LOG(CLI, Warning, << "Dependency graph has a loop starting at " << (loop.empty() ? std::string{} : loop.front().Id));
         }
 
         const auto& installationOrder = dependencyGraph.GetInstallationOrder();
@@ -55,8 +55,9 @@ namespace AppInstaller::CLI::Workflow
     };
 
     // Sets up the source used to get the dependencies.
+    // The installed packages of the composite Source are reused when there is one.
     // Required Args: None
-    // Inputs: PackageVersion, Manifest
+    // Inputs: PackageVersion, Manifest, Source?
     // Outputs: DependencySource
     void OpenDependencySource(Execution::Context& context);
 }
\ No newline at end of file
@@ -3,25 +3,179 @@
 #include "pch.h"
 #include "DependencyNodeProcessor.h"
 #include "ManifestComparator.h"
+#include <winget/ThreadGlobals.h>
+
+#include <future>
 
 using namespace AppInstaller::Manifest;
 using namespace AppInstaller::Repository;
 
 namespace AppInstaller::CLI::Workflow
 {
-    DependencyNodeProcessor::DependencyNodeProcessor(Execution::Context& context)
-        : m_context(context) {}
+    namespace
+    {
+        // The maximum number of dependency searches to run at once; each may be a request to a remote source.
+        constexpr size_t s_MaxConcurrentDependencyLookups = 8;
+    }
+
+    void DependencyLookupCache::Prefetch(Execution::Context& context, const Source& source, const std::vector<Dependency>& dependencies)
+    {
+        std::vector<std::pair<std::string, const Dependency*>> toLookup;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            for (const auto& dependency : dependencies)
+            {
+                std::string key = GetKey(source, dependency);
+                if (m_lookups.find(key) == m_lookups.end() &&
+                    std::find_if(toLookup.begin(), toLookup.end(), [&](const auto& entry) { return entry.first == key; }) == toLookup.end())
+                {
+                    toLookup.emplace_back(std::move(key), &dependency);
+                }
+            }
+        }
+
+        if (toLookup.empty())
+        {
+            return;
+        }
+
+        std::vector<std::shared_ptr<const Lookup>> results(toLookup.size());
+        std::atomic<size_t> nextLookup = 0;
+
+        auto runLookups = [&]()
+        {
+            for (size_t i = nextLookup++; i < toLookup.size(); i = nextLookup++)
+            {
+                results[i] = DoLookup(source, *toLookup[i].second, true);
+            }
+        };
+
+        size_t workerCount = std::min(s_MaxConcurrentDependencyLookups, toLookup.size()) - 1;
+        AICLI_LOG(CLI, Verbose, << "Searching for " << toLookup.size() << " dependencies with " << (workerCount + 1) << " concurrent searches");
+
+        std::vector<std::future<void>> workers;
+        workers.reserve(workerCount);
+
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            // Created here rather than on the worker, as creating them touches the parent.
+            auto threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(context.GetThreadGlobals(), ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+
+            workers.emplace_back(std::async(std::launch::async, [&runLookups, threadGlobals]()
+                {
+                    auto previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    runLookups();
+                }));
+        }
+
+        // Use the calling thread as well rather than leaving it idle.
+        runLookups();
+
+        for (auto& worker : workers)
+        {
+            worker.get();
+        }
+
+        std::lock_guard<std::mutex> lock{ m_lock };
+        for (size_t i = 0; i < toLookup.size(); ++i)
+        {
+            m_lookups.emplace(std::move(toLookup[i].first), std::move(results[i]));
+        }
+    }
+
+    std::shared_ptr<const DependencyLookupCache::Lookup> DependencyLookupCache::Get(const Source& source, const Dependency& dependency)
+    {
+        std::string key = GetKey(source, dependency);
+        std::shared_ptr<const Lookup> result;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            auto itr = m_lookups.find(key);
+            if (itr != m_lookups.end())
+            {
+                result = itr->second;
+            }
+        }
+
+        if (!result)
+        {
+            result = DoLookup(source, dependency, false);
+
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_lookups.emplace(std::move(key), result);
+        }
+
+        if (result->Exception)
+        {
+            std::rethrow_exception(result->Exception);
+        }
+
+        return result;
+    }
+
+    std::string DependencyLookupCache::GetKey(const Source& source, const Dependency& dependency)
+    {
+        std::string result = source.GetIdentifier();
+
+        if (source.IsComposite())
+        {
+            for (const auto& availableSource : source.GetAvailableSources())
+            {
+                result += '|';
+                result += availableSource.GetIdentifier();
+            }
+        }
+
+        result += '\0';
+        result += Utility::FoldCase(dependency.Id);
+        return result;
+    }
+
+    std::shared_ptr<const DependencyLookupCache::Lookup> DependencyLookupCache::DoLookup(const Source& source, const Dependency& dependency, bool getManifest)
+    {
+        auto result = std::make_shared<Lookup>();
+
+        try
+        {
+            SearchRequest searchRequest;
+            searchRequest.Filters.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, dependency.Id));
+            result->Matches = source.Search(searchRequest).Matches;
+
+            // Only retrieve the manifest when the evaluation of this node is going to need it.
+            if (getManifest && result->Matches.size() == 1)
+            {
+                const auto& package = result->Matches[0].Package;
+                auto installedVersion = package->GetInstalledVersion();
+                auto latestVersion = package->GetLatestAvailableVersion();
+                Dependency node = dependency;
+
+                if (latestVersion && !(installedVersion && node.IsVersionOk(Utility::Version(installedVersion->GetProperty(PackageVersionProperty::Version)))))
+                {
+                    result->LatestManifest = latestVersion->GetManifest();
+                }
+            }
+        }
+        catch (...)
+        {
+            result->Exception = std::current_exception();
+        }
+
+        return result;
+    }
+
+    DependencyNodeProcessor::DependencyNodeProcessor(Execution::Context& context, std::shared_ptr<DependencyLookupCache> lookupCache)
+        : m_context(context), m_lookupCache(lookupCache ? std::move(lookupCache) : std::make_shared<DependencyLookupCache>()) {}
 
     DependencyNodeProcessorResult DependencyNodeProcessor::EvaluateDependencies(Dependency& dependencyNode)
     {
-        SearchRequest searchRequest;
         const auto& source = m_context.Get<Execution::Data::DependencySource>();
         auto error = m_context.Reporter.Error();
         auto info = m_context.Reporter.Info();
 
-        searchRequest.Filters.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, dependencyNode.Id));
-
-        const auto& matches = source.Search(searchRequest).Matches;
+        auto lookup = m_lookupCache->Get(source, dependencyNode);
+        const auto& matches = lookup->Matches;
 
         if (matches.empty())
         {
@@ -64,7 +218,7 @@ namespace AppInstaller::CLI::Workflow
             return DependencyNodeProcessorResult::Error;
         }
 
-        m_nodeManifest = m_nodePackageLatestVersion->GetManifest();
+        m_nodeManifest = (lookup->LatestManifest ? lookup->LatestManifest.value() : m_nodePackageLatestVersion->GetManifest());
         m_nodeManifest.ApplyLocale();
 
         if (m_nodeManifest.Installers.empty())
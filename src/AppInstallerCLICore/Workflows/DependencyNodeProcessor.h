@@ -18,9 +18,35 @@ namespace AppInstaller::CLI::Workflow
         Skipped,
     };
 
+    // The results of searching the dependency source for dependency nodes, kept per source and package id.
+    // It is shared by the packages of an install batch, so that dependencies they have in common are only searched for once.
+    struct DependencyLookupCache
+    {
+        struct Lookup
+        {
+            std::vector<ResultMatch> Matches;
+            // The manifest of the latest available version; only retrieved ahead of time when it is expected to be needed.
+            std::optional<Manifest::Manifest> LatestManifest;
+            std::exception_ptr Exception;
+        };
+
+        // Searches for all of the given dependencies that have not already been searched for, at the same time.
+        void Prefetch(Execution::Context& context, const Source& source, const std::vector<Dependency>& dependencies);
+
+        // Gets the result of the search for the dependency, searching now if it has not been; rethrows any error from the search.
+        std::shared_ptr<const Lookup> Get(const Source& source, const Dependency& dependency);
+
+    private:
+        static std::string GetKey(const Source& source, const Dependency& dependency);
+        static std::shared_ptr<const Lookup> DoLookup(const Source& source, const Dependency& dependency, bool getManifest);
+
+        std::mutex m_lock;
+        std::map<std::string, std::shared_ptr<const Lookup>> m_lookups;
+    };
+
     struct DependencyNodeProcessor
     {
-        DependencyNodeProcessor(Execution::Context& context);
+        DependencyNodeProcessor(Execution::Context& context, std::shared_ptr<DependencyLookupCache> lookupCache = {});
 
         DependencyNodeProcessorResult EvaluateDependencies(Dependency& dependencyNode);
 
@@ -36,6 +62,7 @@ namespace AppInstaller::CLI::Workflow
 
     private:
         Execution::Context& m_context;
+        std::shared_ptr<DependencyLookupCache> m_lookupCache;
         DependencyList m_dependenciesList;
         std::shared_ptr<IPackageVersion> m_nodePackageLatestVersion;
         std::shared_ptr<IPackageVersion> m_nodePackageInstalledVersion;
@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "DownloadFlow.h"
+#include "WorkflowBase.h"
 
 #include <AppInstallerMsixInfo.h>
+#include <AppInstallerSynchronization.h>
+#include <winget/InstallerCache.h>
+#include <winget/UserSettings.h>
 
 namespace AppInstaller::CLI::Workflow
 {
@@ -108,8 +112,7 @@ namespace AppInstaller::CLI::Workflow
             if (std::filesystem::exists(filePath))
             {
                 AICLI_LOG(CLI, Info, << "Found existing installer file at '" << filePath << "'. Verifying file hash.");
-                std::ifstream inStream{ filePath, std::ifstream::binary };
-                fileHash = SHA256::ComputeHash(inStream);
+                fileHash = SHA256::ComputeHashFromFile(filePath);
 
                 if (SHA256::AreEqual(expectedHash, fileHash))
                 {
@@ -123,6 +126,36 @@ namespace AppInstaller::CLI::Workflow
             return false;
         }
 
+        // Determines whether the installer comes from a source that is trusted, so that it does not need a security scan.
+        bool IsInstallerFromTrustedSource(const Execution::Context& context)
+        {
+            return context.Contains(Execution::Data::PackageVersion) &&
+                context.Get<Execution::Data::PackageVersion>()->GetSource() &&
+                WI_IsFlagSet(context.Get<Execution::Data::PackageVersion>()->GetSource().GetDetails().TrustLevel, SourceTrustLevel::Trusted);
+        }
+
+        // Determines whether the file at the path is the same file that the handle has open.
+        bool IsSameFile(HANDLE handle, const std::filesystem::path& path)
+        {
+            // Read attributes access does not conflict with the sharing of the lock handle
+            wil::unique_hfile pathFile{ CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 0, nullptr) };
+            if (!pathFile)
+            {
+                return false;
+            }
+
+            BY_HANDLE_FILE_INFORMATION handleInfo{};
+            BY_HANDLE_FILE_INFORMATION pathInfo{};
+            if (!GetFileInformationByHandle(handle, &handleInfo) || !GetFileInformationByHandle(pathFile.get(), &pathInfo))
+            {
+                return false;
+            }
+
+            return handleInfo.dwVolumeSerialNumber == pathInfo.dwVolumeSerialNumber &&
+                handleInfo.nFileIndexHigh == pathInfo.nFileIndexHigh &&
+                handleInfo.nFileIndexLow == pathInfo.nFileIndexLow;
+        }
+
         // Complicated rename algorithm due to somewhat arbitrary failures.
         // 1. First, try to rename.
         // 2. Then, create an empty file for the target, and attempt to rename.
@@ -184,8 +217,111 @@ namespace AppInstaller::CLI::Workflow
             // but it is better to succeed the operation and leave a file around than to fail.
             std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
         }
+
+        // Copies the installer with the given hash from the installer cache, if one is configured and has it.
+        bool TryGetInstallerFromCache(const SHA256::HashBuffer& hash, const std::filesystem::path& target)
+        {
+            try
+            {
+                auto cache = InstallerCache::GetUserCache();
+                return (cache && cache->TryGet(hash, target));
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION_MSG("Failed to get installer from cache");
+                return false;
+            }
+        }
+
+        // Adds the verified installer to the installer cache, if one is configured.
+        void AddInstallerToCache(const SHA256::HashBuffer& hash, const std::filesystem::path& source)
+        {
+            try
+            {
+                auto cache = InstallerCache::GetUserCache();
+                if (cache)
+                {
+                    cache->Add(hash, source);
+                }
+            }
+            CATCH_LOG_MSG("Failed to add installer to cache");
+        }
+
+        // Takes the lock that serializes downloads of the installer with the given hash across processes.
+        // A process that waits on it can then find the installer in the cache rather than downloading it again.
+        Synchronization::CrossProcessReaderWriteLock LockInstallerDownload(const SHA256::HashBuffer& hash, IProgressCallback& progress)
+        {
+            return Synchronization::CrossProcessReaderWriteLock::LockExclusive("WinGetInstallerDownload_" + SHA256::ConvertToString(hash), progress);
+        }
+
+        // Determines whether DownloadInstaller will download a file for the installer.
+        bool InstallerRequiresDownload(const ManifestInstaller& installer)
+        {
+            switch (installer.InstallerType)
+            {
+            case InstallerTypeEnum::Exe:
+            case InstallerTypeEnum::Burn:
+            case InstallerTypeEnum::Inno:
+            case InstallerTypeEnum::Msi:
+            case InstallerTypeEnum::Nullsoft:
+            case InstallerTypeEnum::Wix:
+                return true;
+            case InstallerTypeEnum::Msix:
+                return installer.SignatureSha256.empty();
+            default:
+                return false;
+            }
+        }
     }
 
+    struct InstallerPrefetch::Job : public IProgressSink
+    {
+        Job(Execution::Context& context, bool backgroundPriority, bool scanInstaller) : PackageContext(context)
+        {
+            const auto& installer = context.Get<Execution::Data::Installer>().value();
+            Url = installer.Url;
+            Sha256 = installer.Sha256;
+            Path = GetInstallerBaseDownloadPath(context) / GetInstallerPreHashValidationFileName(context);
+            ScanInstaller = scanInstaller && !IsInstallerFromTrustedSource(context);
+
+            Info.DisplayName = Resource::GetFixedString(Resource::FixedString::ProductName);
+            Info.ContentId = SHA256::ConvertToString(installer.Sha256);
+            Info.BackgroundPriority = backgroundPriority;
+
+            Completed = CompletedPromise.get_future();
+        }
+
+        void OnProgress(uint64_t current, uint64_t maximum, ProgressType type) override
+        {
+            if (type == ProgressType::Bytes)
+            {
+                Current = current;
+                Maximum = maximum;
+            }
+        }
+
+        void BeginProgress() override {}
+
+        void EndProgress(bool) override {}
+
+        Execution::Context& PackageContext;
+        std::string Url;
+        SHA256::HashBuffer Sha256;
+        std::filesystem::path Path;
+        Utility::DownloadInfo Info;
+        bool ScanInstaller = false;
+
+        // Set before the job completes, if the installer was scanned.
+        std::optional<HRESULT> ScanResult;
+
+        ProgressCallback Progress{ this };
+        std::atomic<uint64_t> Current = 0;
+        std::atomic<uint64_t> Maximum = 0;
+
+        std::promise<void> CompletedPromise;
+        std::future<void> Completed;
+    };
+
     void DownloadInstaller(Execution::Context& context)
     {
         // Check if file was already downloaded.
@@ -279,6 +415,9 @@ namespace AppInstaller::CLI::Workflow
 
     void DownloadInstallerFile(Execution::Context& context)
     {
+        // A scan by the prefetch does not apply to a file downloaded again
+        context.Remove(Execution::Data::InstallerScanResult);
+
         context << GetInstallerDownloadPath;
         if (context.IsTerminated())
         {
@@ -293,43 +432,91 @@ namespace AppInstaller::CLI::Workflow
         // Use the SHA256 hash of the installer as the identifier for the download
         downloadInfo.ContentId = SHA256::ConvertToString(installer.Sha256);
 
-        context.Reporter.Info() << "Downloading " << Execution::UrlEmphasis << installer.Url << std::endl;
+        if (TryGetInstallerFromCache(installer.Sha256, installerPath))
+        {
+            context.Reporter.Info() << "Using cached installer for " << Execution::UrlEmphasis << installer.Url << std::endl;
+            context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, installer.Sha256));
+            return;
+        }
+
+        // Wait for any other process downloading the same installer; it will have added it to the cache once done.
+        auto downloadLock = context.Reporter.ExecuteWithProgress([&](IProgressCallback& progress) { return LockInstallerDownload(installer.Sha256, progress); }, true);
+        if (!downloadLock)
+        {
+            context.Reporter.Info() << "Package download canceled." << std::endl;
+            AICLI_TERMINATE_CONTEXT(E_ABORT);
+        }
+
+        if (TryGetInstallerFromCache(installer.Sha256, installerPath))
+        {
+            context.Reporter.Info() << "Using cached installer for " << Execution::UrlEmphasis << installer.Url << std::endl;
+            context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, installer.Sha256));
+            return;
+        }
+
+        // Mirrors are tried before the original url, moving on to the next one when a download fails.
+        // Whichever url the installer comes from, it is held to the hash from the manifest.
+        std::vector<std::string> urls = GetMirroredUrls(installer.Url, Settings::User().Get<Settings::Setting::NetworkInstallerMirrors>());
 
         std::optional<std::vector<BYTE>> hash;
 
-        const int MaxRetryCount = 2;
-        for (int retryCount = 0; retryCount < MaxRetryCount; ++retryCount)
+        for (size_t urlIndex = 0; urlIndex < urls.size(); ++urlIndex)
         {
+            const std::string& url = urls[urlIndex];
+            bool isLastUrl = (urlIndex == urls.size() - 1);
+
+            context.Reporter.Info() << "Downloading " << Execution::UrlEmphasis << url << std::endl;
+
+            const int MaxRetryCount = isLastUrl ? 2 : 1;
             bool success = false;
-            try
-            {
-                hash = context.Reporter.ExecuteWithProgress(std::bind(Utility::Download,
-                    installer.Url,
-                    installerPath,
-                    Utility::DownloadType::Installer,
-                    std::placeholders::_1,
-                    true,
-                    downloadInfo));
 
-                success = true;
-            }
-            catch (...)
+            for (int retryCount = 0; retryCount < MaxRetryCount; ++retryCount)
             {
-                if (retryCount < MaxRetryCount - 1)
+                try
                 {
-                    AICLI_LOG(CLI, Info, << "Failed to download, waiting a bit and retry. Url: " << installer.Url);
-                    Sleep(500);
+                    hash = context.Reporter.ExecuteWithProgress(std::bind(Utility::Download,
+                        url,
+                        installerPath,
+                        Utility::DownloadType::Installer,
+                        std::placeholders::_1,
+                        true,
+                        downloadInfo));
+
+                    success = true;
                 }
-                else
+                catch (...)
+                {
+                    if (retryCount < MaxRetryCount - 1)
+                    {
+                        AICLI_LOG(CLI, Info, << "Failed to download, waiting a bit and retry. Url: " << url);
+                        Sleep(500);
+                    }
+                    else if (!isLastUrl)
+                    {
+                        LOG_CAUGHT_EXCEPTION_MSG("Failed to download from mirror, trying the next url. Url: %hs", url.c_str());
+                    }
+                    else
+                    {
+                        throw;
+                    }
+                }
+
+                if (success)
                 {
-                    throw;
+                    break;
                 }
             }
 
-            if (success)
+            // A mirror that returned different content is skipped as well; the original url decides the result.
+            if (success && (isLastUrl || !hash || SHA256::AreEqual(installer.Sha256, hash.value())))
             {
                 break;
             }
+
+            if (success)
+            {
+                AICLI_LOG(CLI, Warning, << "Installer from mirror does not match the manifest hash, trying the next url. Url: " << url);
+            }
         }
 
         if (!hash)
@@ -338,6 +525,11 @@ namespace AppInstaller::CLI::Workflow
             AICLI_TERMINATE_CONTEXT(E_ABORT);
         }
 
+        if (SHA256::AreEqual(installer.Sha256, hash.value()))
+        {
+            AddInstallerToCache(installer.Sha256, installerPath);
+        }
+
         context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, hash.value()));
     }
 
@@ -356,6 +548,9 @@ namespace AppInstaller::CLI::Workflow
             auto signatureHash = SHA256::ComputeHash(signature.data(), static_cast<uint32_t>(signature.size()));
 
             context.Add<Execution::Data::HashPair>(std::make_pair(installer.SignatureSha256, signatureHash));
+
+            // Keep the full name while the package is open, so that deploying it from the URL need not open it again
+            context.Add<Execution::Data::MsixPackageFullName>(msixInfo.GetPackageFullName());
         }
         catch (const winrt::hresult_error& e)
         {
@@ -419,9 +614,7 @@ namespace AppInstaller::CLI::Workflow
 
             context.SetFlags(Execution::ContextFlag::InstallerHashMatched);
 
-            if (context.Contains(Execution::Data::PackageVersion) &&
-                context.Get<Execution::Data::PackageVersion>()->GetSource() &&
-                WI_IsFlagSet(context.Get<Execution::Data::PackageVersion>()->GetSource().GetDetails().TrustLevel, SourceTrustLevel::Trusted))
+            if (IsInstallerFromTrustedSource(context))
             {
                 context.SetFlags(Execution::ContextFlag::InstallerTrusted);
             }
@@ -439,7 +632,19 @@ namespace AppInstaller::CLI::Workflow
             else if (WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerHashMatched))
             {
                 const auto& installer = context.Get<Execution::Data::Installer>();
-                HRESULT hr = Utility::ApplyMotwUsingIAttachmentExecuteIfApplicable(context.Get<Execution::Data::InstallerPath>(), installer.value().Url, URLZONE_INTERNET);
+                const auto& installerPath = context.Get<Execution::Data::InstallerPath>();
+
+                HRESULT hr = S_OK;
+                if (context.Contains(Execution::Data::InstallerScanResult) && context.Get<Execution::Data::InstallerScanResult>().first == installerPath)
+                {
+                    // The hash of the file matched again, so it is the one that the prefetch scanned
+                    hr = context.Get<Execution::Data::InstallerScanResult>().second;
+                    AICLI_LOG(CLI, Info, << "Using the security scan result from the prefetch of the installer: " << WINGET_OSTREAM_FORMAT_HRESULT(hr));
+                }
+                else
+                {
+                    hr = Utility::ApplyMotwUsingIAttachmentExecuteIfApplicable(installerPath, installer.value().Url, URLZONE_INTERNET);
+                }
 
                 // Not using SUCCEEDED(hr) to check since there are cases file is missing after a successful scan
                 if (hr != S_OK)
@@ -469,10 +674,27 @@ namespace AppInstaller::CLI::Workflow
 
         if (context.Contains(Execution::Data::InstallerPath))
         {
-            // Get the hash from the installer file
             const auto& installerPath = context.Get<Execution::Data::InstallerPath>();
-            std::ifstream inStream{ installerPath, std::ifstream::binary };
-            auto existingFileHash = SHA256::ComputeHash(inStream);
+
+            if (context.Contains(Execution::Data::InstallerFileLock) && context.Contains(Execution::Data::HashPair))
+            {
+                // The lock only shares reads, so if it still refers to the file at the path, the file is the one that was hashed
+                // and reading it again is not needed. Releasing the lock here leaves the same window before the install as a rehash does.
+                std::shared_ptr<wil::unique_hfile> fileLock = context.Get<Execution::Data::InstallerFileLock>();
+                context.Remove(Execution::Data::InstallerFileLock);
+
+                if (fileLock && *fileLock && IsSameFile(fileLock->get(), installerPath))
+                {
+                    AICLI_LOG(CLI, Info, << "Installer file was locked since it was verified; using the hash from the download.");
+                    context << VerifyInstallerHash;
+                    return;
+                }
+
+                AICLI_LOG(CLI, Info, << "Installer file lock does not match the installer path; computing the hash again.");
+            }
+
+            // Get the hash from the installer file
+            auto existingFileHash = SHA256::ComputeHashFromFile(installerPath);
             context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, existingFileHash));
         }
         else if (installer.InstallerType == InstallerTypeEnum::MSStore)
@@ -519,6 +741,26 @@ namespace AppInstaller::CLI::Workflow
         AICLI_LOG(CLI, Info, << "Successfully renamed downloaded installer. Path: " << installerPath);
     }
 
+    void LockInstallerFile(Execution::Context& context)
+    {
+        if (!context.Contains(Execution::Data::InstallerPath))
+        {
+            // No installer downloaded, nothing to lock.
+            return;
+        }
+
+        const auto& installerPath = context.Get<Execution::Data::InstallerPath>();
+        wil::unique_hfile file{ CreateFileW(installerPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        if (!file)
+        {
+            // Not fatal; the hash will be computed again before the install.
+            AICLI_LOG(CLI, Warning, << "Failed to lock installer file: " << GetLastError());
+            return;
+        }
+
+        context.Add<Execution::Data::InstallerFileLock>(std::make_shared<wil::unique_hfile>(std::move(file)));
+    }
+
     void RemoveInstaller(Execution::Context& context)
     {
         // Path may not be present if installed from a URL for MSIX
@@ -529,4 +771,207 @@ namespace AppInstaller::CLI::Workflow
             RemoveInstallerFile(path);
         }
     }
+
+    void PrefetchInstallers(Execution::Context& context)
+    {
+        size_t concurrency = Settings::User().Get<Settings::Setting::NetworkDownloadConcurrency>();
+        if (context.Get<Execution::Data::PackagesToInstall>().size() > 1 && concurrency > 1)
+        {
+            context.Add<Execution::Data::InstallerPrefetch>(std::make_shared<InstallerPrefetch>(context, concurrency, false, true));
+        }
+    }
+
+    void DownloadInstallersForLater(Execution::Context& context)
+    {
+        auto& packagesToInstall = context.Get<Execution::Data::PackagesToInstall>();
+
+        // One download at a time, at background priority, as nothing is waiting to install them
+        InstallerPrefetch prefetch{ context, 1, true };
+
+        bool allSucceeded = true;
+        size_t packagesCount = packagesToInstall.size();
+        size_t packagesProgress = 0;
+
+        for (auto& packageContext : packagesToInstall)
+        {
+            packagesProgress++;
+            context.Reporter.Info() << "(" << packagesProgress << "/" << packagesCount << ") ";
+
+            Execution::Context& downloadContext = *packageContext;
+            auto previousThreadGlobals = downloadContext.SetForCurrentThread();
+
+            downloadContext << ReportManifestIdentityWithVersion;
+
+            if (!InstallerRequiresDownload(downloadContext.Get<Execution::Data::Installer>().value()))
+            {
+                downloadContext.Reporter.Info() << Resource::String::PrefetchNotRequired << std::endl;
+                continue;
+            }
+
+            prefetch.Wait(downloadContext);
+
+            if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
+            {
+                context.Reporter.Info() << Resource::String::Cancelled << std::endl;
+                return;
+            }
+
+            // The prefetch removes files that do not match, so this only rereads the hash of a verified file
+            downloadContext << CheckForExistingInstaller;
+
+            if (downloadContext.Contains(Execution::Data::InstallerPath))
+            {
+                downloadContext.Reporter.Info() << Resource::String::InstallerHashVerified << std::endl;
+            }
+            else
+            {
+                downloadContext.Reporter.Error() << Resource::String::PrefetchFailed << std::endl;
+                allSucceeded = false;
+            }
+        }
+
+        if (!allSucceeded)
+        {
+            context.Reporter.Error() << Resource::String::PrefetchHasFailures << std::endl;
+            AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_DOWNLOAD_FAILED);
+        }
+    }
+
+    InstallerPrefetch::InstallerPrefetch(Execution::Context& context, size_t concurrency, bool backgroundPriority, bool scanInstallers)
+    {
+        for (auto& packageContext : context.Get<Execution::Data::PackagesToInstall>())
+        {
+            const auto& installer = packageContext->Get<Execution::Data::Installer>();
+            if (!installer || !InstallerRequiresDownload(installer.value()))
+            {
+                continue;
+            }
+
+            // Leave existing files for CheckForExistingInstaller to verify
+            auto basePath = GetInstallerBaseDownloadPath(*packageContext);
+            if (std::filesystem::exists(basePath / GetInstallerPreHashValidationFileName(*packageContext)) ||
+                std::filesystem::exists(basePath / GetInstallerPostHashValidationFileName(*packageContext)))
+            {
+                continue;
+            }
+
+            m_jobs.emplace_back(std::make_unique<Job>(*packageContext, backgroundPriority, scanInstallers));
+        }
+
+        size_t workerCount = std::min(concurrency, m_jobs.size());
+        AICLI_LOG(CLI, Info, << "Prefetching " << m_jobs.size() << " installers with " << workerCount << " concurrent downloads");
+
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            // Created here rather than on the worker, as creating them touches the parent.
+            auto threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(context.GetThreadGlobals(), ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+
+            m_workers.emplace_back(std::async(std::launch::async, [this, threadGlobals]()
+                {
+                    auto previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    RunJobs();
+                }));
+        }
+    }
+
+    InstallerPrefetch::~InstallerPrefetch()
+    {
+        for (auto& job : m_jobs)
+        {
+            job->Progress.Cancel();
+        }
+
+        for (auto& worker : m_workers)
+        {
+            worker.wait();
+        }
+    }
+
+    void InstallerPrefetch::Wait(Execution::Context& packageContext)
+    {
+        auto itr = std::find_if(m_jobs.begin(), m_jobs.end(), [&](const std::unique_ptr<Job>& job) { return &job->PackageContext == &packageContext; });
+        if (itr == m_jobs.end())
+        {
+            return;
+        }
+
+        Job& job = **itr;
+        if (job.Completed.wait_for(0ms) != std::future_status::ready)
+        {
+            packageContext.Reporter.Info() << "Downloading " << Execution::UrlEmphasis << job.Url << std::endl;
+
+            packageContext.Reporter.ExecuteWithProgress([&](IProgressCallback& progress)
+                {
+                    bool cancelled = false;
+
+                    while (job.Completed.wait_for(100ms) != std::future_status::ready)
+                    {
+                        if (!cancelled && progress.IsCancelled())
+                        {
+                            job.Progress.Cancel();
+                            cancelled = true;
+                        }
+
+                        uint64_t maximum = job.Maximum;
+                        if (maximum)
+                        {
+                            progress.OnProgress(job.Current, maximum, ProgressType::Bytes);
+                        }
+                    }
+                });
+        }
+
+        if (job.ScanResult)
+        {
+            packageContext.Add<Execution::Data::InstallerScanResult>(std::make_pair(job.Path, job.ScanResult.value()));
+        }
+    }
+
+    void InstallerPrefetch::RunJobs()
+    {
+        for (size_t i = m_nextJob++; i < m_jobs.size(); i = m_nextJob++)
+        {
+            Job& job = *m_jobs[i];
+
+            if (!job.Progress.IsCancelled() && !TryGetInstallerFromCache(job.Sha256, job.Path))
+            {
+                try
+                {
+                    auto downloadLock = LockInstallerDownload(job.Sha256, job.Progress);
+                    if (!downloadLock || TryGetInstallerFromCache(job.Sha256, job.Path))
+                    {
+                        job.CompletedPromise.set_value();
+                        continue;
+                    }
+
+                    AICLI_LOG(CLI, Info, << "Prefetching installer from " << job.Url << " to " << job.Path);
+                    auto hash = Utility::Download(job.Url, job.Path, Utility::DownloadType::Installer, job.Progress, true, job.Info);
+
+                    if (!hash || !SHA256::AreEqual(job.Sha256, hash.value()))
+                    {
+                        // Let the normal download flow retry and report the failure
+                        AICLI_LOG(CLI, Info, << "Prefetched installer was cancelled or has a hash mismatch; removing it. Url: " << job.Url);
+                        RemoveInstallerFile(job.Path);
+                    }
+                    else
+                    {
+                        AddInstallerToCache(job.Sha256, job.Path);
+
+                        if (job.ScanInstaller)
+                        {
+                            // Scanned here so that it overlaps the downloads of the packages after this one
+                            job.ScanResult = Utility::ApplyMotwUsingIAttachmentExecuteIfApplicable(job.Path, job.Url, URLZONE_INTERNET);
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION_MSG("Failed to prefetch installer");
+                    RemoveInstallerFile(job.Path);
+                }
+            }
+
+            job.CompletedPromise.set_value();
+        }
+    }
 }
@@ -36,8 +36,9 @@ namespace AppInstaller::CLI::Workflow
     void GetMsixSignatureHash(Execution::Context& context);
 
     // Re-verify the installer hash. This is used in Com install commands where download and install are in separate phases.
+    // If the file has been locked since it was verified, the hash from the download is kept rather than reading the file again.
     // Required Args: None
-    // Inputs: InstallerPath, Installer
+    // Inputs: InstallerPath, Installer, InstallerFileLock?
     // Outputs: HashPair
     void ReverifyInstallerHash(Execution::Context& context);
 
@@ -48,8 +49,9 @@ namespace AppInstaller::CLI::Workflow
     void VerifyInstallerHash(Execution::Context& context);
 
     // Update Motw of the downloaded installer if applicable
+    // Uses the result of the scan done by the prefetch when it is for the same file, rather than scanning again.
     // Required Args: None
-    // Inputs: HashPair, InstallerPath?, SourceId?
+    // Inputs: HashPair, InstallerPath?, SourceId?, InstallerScanResult?
     // Outputs: None
     void UpdateInstallerFileMotwIfApplicable(Execution::Context& context);
 
@@ -61,9 +63,63 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void RenameDownloadedInstaller(Execution::Context& context);
 
+    // Opens the verified installer file, denying writes and deletes to others until it is reverified.
+    // This is used in Com install commands where download and install are in separate phases.
+    // Required Args: None
+    // Inputs: InstallerPath
+    // Outputs: InstallerFileLock
+    void LockInstallerFile(Execution::Context& context);
+
     // Deletes the installer file.
     // Required Args: None
     // Inputs: InstallerPath
     // Outputs: None
     void RemoveInstaller(Execution::Context& context);
+
+    // Starts downloading the installers of multiple packages in the background, if enabled by settings.
+    // Required Args: None
+    // Inputs: PackagesToInstall
+    // Outputs: InstallerPrefetch (only if started)
+    void PrefetchInstallers(Execution::Context& context);
+
+    // Downloads and verifies the installers of multiple packages at background priority, without installing them.
+    // A later install of the same packages finds them in the installer cache, or where CheckForExistingInstaller looks.
+    // Required Args: None
+    // Inputs: PackagesToInstall
+    // Outputs: None
+    void DownloadInstallersForLater(Execution::Context& context);
+
+    // Downloads the installers for multiple packages in the background, ahead of their installation.
+    // Files are placed where CheckForExistingInstaller will find them, so DownloadInstaller still verifies
+    // the hash and downloads the installer itself if the prefetch failed.
+    struct InstallerPrefetch
+    {
+        // Starts downloading the installers of PackagesToInstall, in install order, with at most the given number at once.
+        // Background priority lets the downloads yield the network to other uses.
+        // Scanning runs the security scan of UpdateInstallerFileMotwIfApplicable on each verified download, while the next one downloads.
+        InstallerPrefetch(Execution::Context& context, size_t concurrency, bool backgroundPriority = false, bool scanInstallers = false);
+
+        InstallerPrefetch(const InstallerPrefetch&) = delete;
+        InstallerPrefetch& operator=(const InstallerPrefetch&) = delete;
+
+        InstallerPrefetch(InstallerPrefetch&&) = delete;
+        InstallerPrefetch& operator=(InstallerPrefetch&&) = delete;
+
+        // Cancels any outstanding downloads and waits for them to stop.
+        ~InstallerPrefetch();
+
+        // Waits for the download of the installer of the given package to complete, showing its progress.
+        // If the installer was scanned, adds the result to the package context as InstallerScanResult.
+        // Does nothing if the package was not prefetched.
+        void Wait(Execution::Context& packageContext);
+
+    private:
+        struct Job;
+
+        void RunJobs();
+
+        std::vector<std::unique_ptr<Job>> m_jobs;
+        std::atomic<size_t> m_nextJob = 0;
+        std::vector<std::future<void>> m_workers;
+    };
 }
@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "EarlySourceOpen.h"
+#include <winget/ThreadGlobals.h>
+
+namespace AppInstaller::CLI::Workflow
+{
+    using namespace AppInstaller::Repository;
+
+    struct EarlySourceOpen::Open
+    {
+        using Result = std::pair<Source, std::vector<SourceDetails>>;
+
+        Open(Execution::Context& context, std::function<Source()> create)
+        {
+            // Created here rather than on the worker, as creating them touches the parent.
+            auto threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(context.GetThreadGlobals(), ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+
+            m_result = std::async(std::launch::async, [this, threadGlobals, create = std::move(create)]()
+                {
+                    auto previousThreadGlobals = threadGlobals->SetForCurrentThread();
+
+                    Result result;
+                    result.first = create();
+                    if (result.first)
+                    {
+                        result.second = result.first.Open(m_progress);
+                    }
+                    return result;
+                });
+        }
+
+        ~Open()
+        {
+            m_progress.Cancel();
+            if (m_result.valid())
+            {
+                m_result.wait();
+            }
+        }
+
+        // Waits for the open to complete, showing progress while it does; returns an empty source if it failed or was cancelled.
+        Result Take(Execution::Context& context)
+        {
+            if (!m_result.valid())
+            {
+                return {};
+            }
+
+            if (m_result.wait_for(0ms) != std::future_status::ready)
+            {
+                context.Reporter.ExecuteWithProgress([&](IProgressCallback& progress)
+                    {
+                        while (m_result.wait_for(100ms) != std::future_status::ready)
+                        {
+                            if (progress.IsCancelled())
+                            {
+                                m_progress.Cancel();
+                            }
+                        }
+                    }, true);
+            }
+
+            try
+            {
+                Result result = m_result.get();
+                if (m_progress.IsCancelled())
+                {
+                    return {};
+                }
+
+                return result;
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION_MSG("Opening the source early failed; it will be opened again");
+                return {};
+            }
+        }
+
+    private:
+        ProgressCallback m_progress;
+        std::future<Result> m_result;
+    };
+
+    EarlySourceOpen::EarlySourceOpen(Execution::Context& context, bool openDefaultSources)
+    {
+        AICLI_LOG(CLI, Info, << "Opening the " << (openDefaultSources ? "default and " : "") << "installed sources early");
+
+        if (openDefaultSources)
+        {
+            m_defaultSources = std::make_unique<Open>(context, []() { return Source{ std::string_view{} }; });
+        }
+
+        m_installedSource = std::make_unique<Open>(context, []() { return Source{ PredefinedSource::Installed }; });
+    }
+
+    EarlySourceOpen::~EarlySourceOpen() = default;
+
+    Source EarlySourceOpen::TakeDefaultSources(Execution::Context& context, std::vector<SourceDetails>& updateFailures)
+    {
+        if (!m_defaultSources)
+        {
+            updateFailures.clear();
+            return {};
+        }
+
+        auto result = m_defaultSources->Take(context);
+        updateFailures = std::move(result.second);
+        return std::move(result.first);
+    }
+
+    Source EarlySourceOpen::TakePredefinedSource(Execution::Context& context, PredefinedSource predefinedSource)
+    {
+        if (predefinedSource != PredefinedSource::Installed)
+        {
+            return {};
+        }
+
+        return std::move(m_installedSource->Take(context).first);
+    }
+}
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "ExecutionContext.h"
+#include <winget/RepositorySource.h>
+
+#include <memory>
+#include <vector>
+
+namespace AppInstaller::CLI::Workflow
+{
+    // Opens the sources that a command is expected to use on background threads, so that their I/O overlaps
+    // the rest of the startup. A source is only taken if the arguments call for the same one that was opened;
+    // any that are not taken are cancelled and waited for on destruction.
+    struct EarlySourceOpen
+    {
+        // Starts opening the predefined installed source, and the default available sources if requested.
+        EarlySourceOpen(Execution::Context& context, bool openDefaultSources = true);
+
+        EarlySourceOpen(const EarlySourceOpen&) = delete;
+        EarlySourceOpen& operator=(const EarlySourceOpen&) = delete;
+
+        EarlySourceOpen(EarlySourceOpen&&) = delete;
+        EarlySourceOpen& operator=(EarlySourceOpen&&) = delete;
+
+        ~EarlySourceOpen();
+
+        // Takes the default available sources, waiting for them to be open, along with any that failed to update.
+        // Returns an empty source if they were already taken or failed to open; the caller should open them again to report the failure.
+        Repository::Source TakeDefaultSources(Execution::Context& context, std::vector<Repository::SourceDetails>& updateFailures);
+
+        // Takes the given predefined source, waiting for it to be open.
+        // Returns an empty source if it is not the one that was opened, was already taken, or failed to open.
+        Repository::Source TakePredefinedSource(Execution::Context& context, Repository::PredefinedSource predefinedSource);
+
+    private:
+        struct Open;
+
+        std::unique_ptr<Open> m_defaultSources;
+        std::unique_ptr<Open> m_installedSource;
+    };
+}
@@ -96,6 +96,8 @@ namespace AppInstaller::CLI::Workflow
     {
         const auto& searchResult = context.Get<Execution::Data::SearchResult>();
         const bool includeVersions = context.Args.Contains(Execution::Args::Type::IncludeVersions);
+        // Checking for agreements requires retrieving the manifest of every exported package
+        const bool checkAgreements = !context.Args.Contains(Execution::Args::Type::SkipAgreementsCheck);
         PackageCollection exportedPackages;
         exportedPackages.ClientVersion = Runtime::GetClientVersion().get();
         auto& exportedSources = exportedPackages.Sources;
@@ -119,7 +121,7 @@ namespace AppInstaller::CLI::Workflow
             AICLI_LOG(CLI, Info,
                 << "Installed package is available. Package Id [" << availablePackageVersion->GetProperty(PackageVersionProperty::Id) << "], Source [" << sourceDetails.Identifier << "]");
 
-            if (!availablePackageVersion->GetManifest().DefaultLocalization.Get<Manifest::Localization::Agreements>().empty())
+            if (checkAgreements && !availablePackageVersion->GetManifest().DefaultLocalization.Get<Manifest::Localization::Agreements>().empty())
             {
                 // Report that the package requires accepting license terms
                 AICLI_LOG(CLI, Warning, << "Package [" << installedPackageVersion->GetProperty(PackageVersionProperty::Name) << "] requires license agreement to install");
@@ -260,24 +262,41 @@ namespace AppInstaller::CLI::Workflow
                 AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_INTERNAL_ERROR);
             }
 
-            // Search for all the packages in the source.
-            // Each search is done in a sub context to search everything regardless of previous failures.
+            // Search for all the packages in the source with a single request; inclusions are OR'ed together.
+            // The results are then split by package and each is handled in a sub context to process everything regardless of previous failures.
             Repository::Source source{ context.Get<Execution::Data::Source>(), *sourceItr, CompositeSearchBehavior::AllPackages };
             AICLI_LOG(CLI, Info, << "Searching for packages requested from source [" << requiredSource.Details.Identifier << "]");
+
+            SearchRequest searchRequest;
+            for (const auto& packageRequest : requiredSource.Packages)
+            {
+                searchRequest.Inclusions.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, packageRequest.Id.get()));
+            }
+
+            SearchResult sourceSearchResult = source.Search(searchRequest);
+
             for (const auto& packageRequest : requiredSource.Packages)
             {
                 AICLI_LOG(CLI, Info, << "Searching for package [" << packageRequest.Id << "]");
 
-                // Search for the current package
-                SearchRequest searchRequest;
-                searchRequest.Filters.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, packageRequest.Id.get()));
+                // Collect the matches for the current package
+                SearchResult packageSearchResult;
+                packageSearchResult.Truncated = sourceSearchResult.Truncated;
+                packageSearchResult.Failures = sourceSearchResult.Failures;
+                for (const auto& match : sourceSearchResult.Matches)
+                {
+                    if (Utility::CaseInsensitiveEquals(match.Package->GetProperty(PackageProperty::Id).get(), packageRequest.Id.get()))
+                    {
+                        packageSearchResult.Matches.emplace_back(match);
+                    }
+                }
 
                 auto searchContextPtr = context.CreateSubContext();
                 Execution::Context& searchContext = *searchContextPtr;
                 auto previousThreadGlobals = searchContext.SetForCurrentThread();
 
                 searchContext.Add<Execution::Data::Source>(source);
-                searchContext.Add<Execution::Data::SearchResult>(source.Search(searchRequest));
+                searchContext.Add<Execution::Data::SearchResult>(std::move(packageSearchResult));
 
                 // TODO: In the future, it would be better to not have to convert back and forth from a string
                 searchContext.Args.AddArg(Execution::Args::Type::InstallScope, ScopeToString(packageRequest.Scope));
@@ -11,7 +11,12 @@
 #include "MsiInstallFlow.h"
 #include "WorkflowBase.h"
 #include "Workflows/DependenciesFlow.h"
+#include "Workflows/DependencyNodeProcessor.h"
 #include <AppInstallerDeployment.h>
+#include <AppInstallerMsixInfo.h>
+#include <winget/MemoryBudget.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/UserSettings.h>
 
 using namespace winrt::Windows::ApplicationModel::Store::Preview::InstallControl;
 using namespace winrt::Windows::Foundation;
@@ -44,6 +49,14 @@ namespace AppInstaller::CLI::Workflow
             }
         }
 
+        // Discards progress, for the installs that run alongside others.
+        struct DiscardProgressSink : public IProgressSink
+        {
+            void OnProgress(uint64_t, uint64_t, ProgressType) override {}
+            void BeginProgress() override {}
+            void EndProgress(bool) override {}
+        };
+
         bool ShouldUseDirectMSIInstall(InstallerTypeEnum type, bool isSilentInstall)
         {
             switch (type)
@@ -56,6 +69,22 @@ namespace AppInstaller::CLI::Workflow
             }
         }
 
+        // Determines whether the install of the package can join the MSI transaction of the packages before it.
+        // Only direct MSI installs can; anything else that may run while the transaction is active, such as the install of a
+        // dependency or of an uninstaller, would have to wait on it.
+        bool CanJoinMsiTransaction(Execution::Context& context)
+        {
+            const auto& installer = context.Get<Execution::Data::Installer>().value();
+
+            if (!ShouldUseDirectMSIInstall(installer.InstallerType, context.Args.Contains(Execution::Args::Type::Silent)) ||
+                installer.Dependencies.HasAnyOf(DependencyType::Package))
+            {
+                return false;
+            }
+
+            return !(WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerExecutionUseUpdate) && installer.UpdateBehavior == UpdateBehaviorEnum::UninstallPrevious);
+        }
+
         struct ExpectedReturnCode
         {
             ExpectedReturnCode(ExpectedReturnCodeEnum installerReturnCode, HRESULT hr, Resource::StringId message) :
@@ -295,9 +324,46 @@ namespace AppInstaller::CLI::Workflow
 
         try
         {
+            // The package may already have been staged from its URL in the background, in which case only its registration remains.
+            std::optional<std::string> stagedPackageFullName;
+            if (context.Contains(Execution::Data::MsixStaging) && !context.Contains(Execution::Data::InstallerPath) &&
+                WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerTrusted))
+            {
+                stagedPackageFullName = context.Get<Execution::Data::MsixStaging>()->Take(context);
+            }
+
             registrationDeferred = context.Reporter.ExecuteWithProgress([&](IProgressCallback& callback)
             {
-                return Deployment::AddPackageWithDeferredFallback(uri, WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerTrusted), callback);
+                if (stagedPackageFullName)
+                {
+                    // In the event of a failure we want to ensure that the package is not left on the system.
+                    auto removePackage = wil::scope_exit([&]() {
+                        try
+                        {
+                            Deployment::RemovePackage(stagedPackageFullName.value(), callback);
+                        }
+                        CATCH_LOG();
+                    });
+
+                    bool result = Deployment::RegisterStagedPackage(stagedPackageFullName.value(), callback);
+                    removePackage.release();
+                    return result;
+                }
+
+                std::optional<std::string> packageFullName;
+                if (!context.Contains(Execution::Data::InstallerPath) && context.Contains(Execution::Data::MsixPackageFullName))
+                {
+                    packageFullName = context.Get<Execution::Data::MsixPackageFullName>();
+
+                    // When another version of the package is installed, deploying from the URL lets AppX compare the block maps
+                    // and only fetch the blocks that changed, rather than the whole package.
+                    if (Msix::GetPackageFullNameFromFamilyName(Msix::GetPackageFamilyNameFromFullName(packageFullName.value())))
+                    {
+                        AICLI_LOG(CLI, Info, << "Package family is installed; deploying " << packageFullName.value() << " from the URL as a differential update");
+                    }
+                }
+
+                return Deployment::AddPackageWithDeferredFallback(uri, WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerTrusted), callback, packageFullName);
             });
         }
         catch (const wil::ResultException& re)
@@ -426,7 +492,107 @@ namespace AppInstaller::CLI::Workflow
         bool allSucceeded = true;
         size_t packagesCount = context.Get<Execution::Data::PackagesToInstall>().size();
         size_t packagesProgress = 0;
-        
+
+        // Download the installers ahead of the serialized installs, so the network is not idle while each one runs
+        context << Workflow::PrefetchInstallers;
+        auto stopPrefetch = wil::scope_exit([&]()
+            {
+                if (context.Contains(Execution::Data::InstallerPrefetch))
+                {
+                    context.Get<Execution::Data::InstallerPrefetch>().reset();
+                }
+            });
+
+        // Likewise stage the MSIX packages, as the deployment service does each one slowly and in turn
+        context << Workflow::StageMsixPackages;
+        auto stopStaging = wil::scope_exit([&]()
+            {
+                if (context.Contains(Execution::Data::MsixStaging))
+                {
+                    context.Get<Execution::Data::MsixStaging>()->Complete();
+                }
+            });
+
+        // Packages in a batch often share dependencies, so only search for each of them once.
+        auto dependencyLookupCache = std::make_shared<DependencyLookupCache>();
+
+        // With a memory budget, the manifest of each package is released once it is installed rather than holding all of them to the end.
+        bool releaseManifests = Performance::GetMemoryBudget().has_value();
+
+        // Packages that can be installed alongside the others are, when allowed to.
+        size_t installConcurrency = Settings::User().Get<Settings::Setting::InstallConcurrency>();
+        bool installConcurrently = installConcurrency > 1 && packagesCount > 1;
+
+        // Record the installations to the tracking catalogs together at the end, rather than committing each of them.
+        // Holding the records keeps a copy of each manifest, so they are recorded as they go when there is a memory budget.
+        // Concurrent installs always use the batch, so that the tracking catalogs are only written from this thread.
+        std::shared_ptr<InstallRecordBatch> installRecordBatch;
+        if (!releaseManifests || installConcurrently)
+        {
+            installRecordBatch = std::make_shared<InstallRecordBatch>();
+        }
+        auto flushInstallRecords = wil::scope_exit([&]()
+            {
+                if (installRecordBatch)
+                {
+                    installRecordBatch->Flush();
+                }
+            });
+
+        // Declared after the records are flushed, so that any concurrent installs are waited for before they are.
+        std::optional<ConcurrentInstalls> concurrentInstalls;
+        if (installConcurrently)
+        {
+            concurrentInstalls.emplace(installConcurrency);
+        }
+
+        // Consecutive direct MSI installs share a transaction when allowed to; it is rolled back if this returns before it is committed.
+        std::shared_ptr<MsiTransaction> msiTransaction;
+        if (!installConcurrently && packagesCount > 1 && Settings::User().Get<Settings::Setting::InstallMsiTransaction>())
+        {
+            msiTransaction = std::make_shared<MsiTransaction>();
+        }
+        auto rollBackMsiTransaction = wil::scope_exit([&]()
+            {
+                if (msiTransaction)
+                {
+                    LOG_IF_FAILED(msiTransaction->End(false));
+                }
+            });
+
+        // Checks the results of the concurrent installs once they are complete; returns false if the operation was aborted.
+        auto completeConcurrentInstalls = [&]()
+            {
+                for (Execution::Context* installContext : concurrentInstalls->Wait())
+                {
+                    if (installContext->IsTerminated())
+                    {
+                        AICLI_LOG(CLI, Info, << "Concurrent install of [" << installContext->Get<Execution::Data::Manifest>().Id <<
+                            "] failed with: " << WINGET_OSTREAM_FORMAT_HRESULT(installContext->GetTerminationHR()));
+
+                        if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
+                        {
+                            // This means that the subcontext being terminated is due to an overall abort
+                            context.Reporter.Info() << Resource::String::Cancelled << std::endl;
+                            return false;
+                        }
+
+                        if (m_ignorableInstallResults.end() == std::find(m_ignorableInstallResults.begin(), m_ignorableInstallResults.end(), installContext->GetTerminationHR()))
+                        {
+                            allSucceeded = false;
+                        }
+                    }
+
+                    if (releaseManifests)
+                    {
+                        installContext->Remove(Execution::Data::Manifest);
+                        installContext->Remove(Execution::Data::Dependencies);
+                    }
+                }
+
+                return true;
+            };
+
         for (auto& packageContext : context.Get<Execution::Data::PackagesToInstall>())
         {
             packagesProgress++;
@@ -436,16 +602,78 @@ namespace AppInstaller::CLI::Workflow
             Execution::Context& installContext = *packageContext;
             auto previousThreadGlobals = installContext.SetForCurrentThread();
 
+            if (installRecordBatch)
+            {
+                installContext.Add<Execution::Data::InstallRecordBatch>(installRecordBatch);
+            }
+
             installContext << Workflow::ReportIdentityAndInstallationDisclaimer;
+
+            if (msiTransaction)
+            {
+                if (CanJoinMsiTransaction(installContext))
+                {
+                    installContext.Add<Execution::Data::MsiTransaction>(msiTransaction);
+                }
+                else if (FAILED(msiTransaction->End(true)))
+                {
+                    allSucceeded = false;
+                }
+            }
+
+            // A dependency of this package may be among those being installed concurrently, so let them finish first.
+            if (concurrentInstalls && installContext.Get<Execution::Data::Installer>()->Dependencies.HasAnyOf(DependencyType::Package))
+            {
+                if (!completeConcurrentInstalls())
+                {
+                    return;
+                }
+            }
+
             if (!m_ignorePackageDependencies)
             {
+                installContext.Add<Execution::Data::DependencyLookupCache>(dependencyLookupCache);
                 installContext << Workflow::ManagePackageDependencies(m_dependenciesReportMessage);
             }
+            if (context.Contains(Execution::Data::InstallerPrefetch) && !installContext.IsTerminated())
+            {
+                context.Get<Execution::Data::InstallerPrefetch>()->Wait(installContext);
+            }
             installContext << Workflow::DownloadInstaller;
+
+            if (concurrentInstalls && !installContext.IsTerminated() && ConcurrentInstalls::CanInstallConcurrently(installContext))
+            {
+                // The result is checked once all of the concurrent installs are complete
+                concurrentInstalls->Start(installContext);
+                installContext.Reporter.Info() << std::endl;
+                continue;
+            }
+
+            size_t msiTransactionInstalls = msiTransaction ? msiTransaction->InstallCount() : 0;
+
             installContext << Workflow::InstallPackageInstaller;
 
+            if (msiTransaction && installContext.IsTerminated() && msiTransaction->InstallCount() > msiTransactionInstalls)
+            {
+                // The installs before this one in the transaction are rolled back along with it.
+                AICLI_LOG(CLI, Warning, << "Install of [" << installContext.Get<Execution::Data::Manifest>().Id << "] failed; rolling back the MSI transaction of " << msiTransaction->InstallCount() << " installs");
+                LOG_IF_FAILED(msiTransaction->End(false));
+
+                if (msiTransactionInstalls > 0)
+                {
+                    installContext.Reporter.Warn() << Resource::String::InstallFlowMsiTransactionRolledBack << std::endl;
+                    allSucceeded = false;
+                }
+            }
+
             installContext.Reporter.Info() << std::endl;
 
+            if (releaseManifests)
+            {
+                installContext.Remove(Execution::Data::Manifest);
+                installContext.Remove(Execution::Data::Dependencies);
+            }
+
             if (installContext.IsTerminated())
             {
                 if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
@@ -462,12 +690,286 @@ namespace AppInstaller::CLI::Workflow
             }
         }
 
+        if (concurrentInstalls && !completeConcurrentInstalls())
+        {
+            return;
+        }
+
+        if (msiTransaction && FAILED(msiTransaction->End(true)))
+        {
+            allSucceeded = false;
+        }
+
         if (!allSucceeded)
         {
             AICLI_TERMINATE_CONTEXT(m_resultOnFailure);
         }
     }
 
+    struct MsixStaging::Job
+    {
+        Job(Execution::Context& context) : PackageContext(context), Url(context.Get<Execution::Data::Installer>()->Url)
+        {
+            Completed = CompletedPromise.get_future();
+        }
+
+        Execution::Context& PackageContext;
+        std::string Url;
+        ProgressCallback Progress;
+
+        // Set by the worker before completing.
+        std::optional<std::string> PackageFullName;
+        bool Taken = false;
+
+        std::promise<void> CompletedPromise;
+        std::future<void> Completed;
+    };
+
+    MsixStaging::MsixStaging(Execution::Context& context, size_t concurrency)
+    {
+        for (auto& packageContext : context.Get<Execution::Data::PackagesToInstall>())
+        {
+            const auto& installer = packageContext->Get<Execution::Data::Installer>();
+
+            // Only packages that are deployed from their URL, after checking their signature hash remotely, are staged;
+            // the others are not verified until their download, which happens in turn.
+            if (!installer || installer->InstallerType != InstallerTypeEnum::Msix || installer->SignatureSha256.empty())
+            {
+                continue;
+            }
+
+            const auto& packageVersion = packageContext->Get<Execution::Data::PackageVersion>();
+            if (!packageVersion || !packageVersion->GetSource() ||
+                WI_IsFlagClear(packageVersion->GetSource().GetDetails().TrustLevel, SourceTrustLevel::Trusted))
+            {
+                continue;
+            }
+
+            m_jobs.emplace_back(std::make_unique<Job>(*packageContext));
+        }
+
+        size_t workerCount = std::min(concurrency, m_jobs.size());
+        AICLI_LOG(CLI, Info, << "Staging " << m_jobs.size() << " MSIX packages with " << workerCount << " concurrent operations");
+
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            // Created here rather than on the worker, as creating them touches the parent.
+            auto threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(context.GetThreadGlobals(), ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+
+            m_workers.emplace_back(std::async(std::launch::async, [this, threadGlobals]()
+                {
+                    auto previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    RunJobs();
+                }));
+        }
+    }
+
+    MsixStaging::~MsixStaging()
+    {
+        Complete();
+    }
+
+    std::optional<std::string> MsixStaging::Take(Execution::Context& packageContext)
+    {
+        auto itr = std::find_if(m_jobs.begin(), m_jobs.end(), [&](const std::unique_ptr<Job>& job) { return &job->PackageContext == &packageContext; });
+        if (itr == m_jobs.end())
+        {
+            return {};
+        }
+
+        Job& job = **itr;
+        if (job.Completed.wait_for(0ms) != std::future_status::ready)
+        {
+            packageContext.Reporter.ExecuteWithProgress([&](IProgressCallback& progress)
+                {
+                    bool cancelled = false;
+
+                    while (job.Completed.wait_for(100ms) != std::future_status::ready)
+                    {
+                        if (!cancelled && progress.IsCancelled())
+                        {
+                            job.Progress.Cancel();
+                            cancelled = true;
+                        }
+                    }
+                }, true);
+        }
+
+        if (!job.PackageFullName)
+        {
+            return {};
+        }
+
+        job.Taken = true;
+        return job.PackageFullName;
+    }
+
+    void MsixStaging::Complete()
+    {
+        if (m_completed.exchange(true))
+        {
+            return;
+        }
+
+        for (auto& job : m_jobs)
+        {
+            job->Progress.Cancel();
+        }
+
+        for (auto& worker : m_workers)
+        {
+            worker.wait();
+        }
+
+        // Packages that were staged but never taken were not installed, so do not leave them on the system.
+        for (auto& job : m_jobs)
+        {
+            if (job->PackageFullName && !job->Taken)
+            {
+                try
+                {
+                    ProgressCallback progress;
+                    Deployment::RemovePackage(job->PackageFullName.value(), progress);
+                }
+                CATCH_LOG();
+            }
+        }
+    }
+
+    void MsixStaging::RunJobs()
+    {
+        for (size_t i = m_nextJob++; i < m_jobs.size(); i = m_nextJob++)
+        {
+            Job& job = *m_jobs[i];
+
+            if (!job.Progress.IsCancelled())
+            {
+                try
+                {
+                    std::string packageFullName = Msix::MsixInfo{ job.Url }.GetPackageFullName();
+
+                    // Removing a staged package that is not taken would remove one that is already installed with the same full name.
+                    if (Deployment::IsPackageInstalled(packageFullName))
+                    {
+                        AICLI_LOG(CLI, Info, << "Not staging package that is already installed: " << packageFullName);
+                    }
+                    else
+                    {
+                        Deployment::StagePackage(job.Url, job.Progress);
+                        job.PackageFullName = std::move(packageFullName);
+                    }
+                }
+                catch (...)
+                {
+                    // Let the normal install flow retry and report the failure
+                    LOG_CAUGHT_EXCEPTION_MSG("Failed to stage MSIX package");
+                }
+            }
+
+            job.CompletedPromise.set_value();
+        }
+    }
+
+    void StageMsixPackages(Execution::Context& context)
+    {
+        size_t concurrency = Settings::User().Get<Settings::Setting::NetworkDownloadConcurrency>();
+
+        size_t msixCount = 0;
+        for (const auto& packageContext : context.Get<Execution::Data::PackagesToInstall>())
+        {
+            const auto& installer = packageContext->Get<Execution::Data::Installer>();
+            if (installer && installer->InstallerType == InstallerTypeEnum::Msix)
+            {
+                ++msixCount;
+            }
+        }
+
+        if (msixCount > 1 && concurrency > 1)
+        {
+            auto staging = std::make_shared<MsixStaging>(context, concurrency);
+            context.Add<Execution::Data::MsixStaging>(staging);
+
+            for (auto& packageContext : context.Get<Execution::Data::PackagesToInstall>())
+            {
+                packageContext->Add<Execution::Data::MsixStaging>(staging);
+            }
+        }
+    }
+
+    ConcurrentInstalls::~ConcurrentInstalls()
+    {
+        Wait();
+    }
+
+    bool ConcurrentInstalls::CanInstallConcurrently(Execution::Context& packageContext)
+    {
+        // Of the installers that do not write to ARP, Store installs are left in turn as the Store manages its own queue of them.
+        const auto& installer = packageContext.Get<Execution::Data::Installer>();
+        return installer && installer->InstallerType == InstallerTypeEnum::Msix;
+    }
+
+    void ConcurrentInstalls::Start(Execution::Context& packageContext)
+    {
+        for (;;)
+        {
+            size_t inProgress = 0;
+            Install* oldest = nullptr;
+
+            for (auto& install : m_installs)
+            {
+                if (install.Completed.wait_for(0ms) != std::future_status::ready)
+                {
+                    ++inProgress;
+                    if (!oldest)
+                    {
+                        oldest = &install;
+                    }
+                }
+            }
+
+            if (inProgress < m_concurrency)
+            {
+                break;
+            }
+
+            oldest->Completed.wait();
+        }
+
+        static DiscardProgressSink s_discardProgress;
+        packageContext.Reporter.SetProgressSink(&s_discardProgress);
+
+        AICLI_LOG(CLI, Info, << "Starting concurrent install of [" << packageContext.Get<Execution::Data::Manifest>().Id << "]");
+
+        Execution::Context* installContext = &packageContext;
+        m_installs.emplace_back(Install{ installContext, std::async(std::launch::async, [installContext]()
+            {
+                auto previousThreadGlobals = installContext->SetForCurrentThread();
+
+                try
+                {
+                    *installContext << Workflow::InstallPackageInstaller;
+                }
+                catch (...)
+                {
+                    installContext->Terminate(Workflow::HandleException(*installContext, std::current_exception()));
+                }
+            }) });
+    }
+
+    std::vector<Execution::Context*> ConcurrentInstalls::Wait()
+    {
+        std::vector<Execution::Context*> result;
+
+        for (auto& install : m_installs)
+        {
+            install.Completed.wait();
+            result.emplace_back(install.PackageContext);
+        }
+
+        m_installs.clear();
+        return result;
+    }
+
     void SnapshotARPEntries(Execution::Context& context) try
     {
         // Ensure that installer type might actually write to ARP, otherwise this is a waste of time
@@ -475,6 +977,15 @@ namespace AppInstaller::CLI::Workflow
 
         if (installer && MightWriteToARP(installer->InstallerType))
         {
+            // Recording only the keys avoids reading every entry now; afterward, only the entries that changed need to be read.
+            auto keySnapshot = ARPKeySnapshot::TryCreate();
+            if (keySnapshot)
+            {
+                AICLI_LOG(CLI, Verbose, << "Recorded snapshot of " << keySnapshot->Size() << " ARP keys");
+                context.Add<Execution::Data::ARPKeySnapshot>(std::move(keySnapshot).value());
+                return;
+            }
+
             Source arpSource = context.Reporter.ExecuteWithProgress(
                 [](IProgressCallback& progress)
                 {
@@ -506,10 +1017,8 @@ namespace AppInstaller::CLI::Workflow
 
     void ReportARPChanges(Execution::Context& context) try
     {
-        if (context.Contains(Execution::Data::ARPSnapshot))
+        if (context.Contains(Execution::Data::ARPKeySnapshot) || context.Contains(Execution::Data::ARPSnapshot))
         {
-            const auto& entries = context.Get<Execution::Data::ARPSnapshot>();
-
             // Open it again to get the (potentially) changed ARP entries
             Source arpSource = context.Reporter.ExecuteWithProgress(
                 [](IProgressCallback& progress)
@@ -521,21 +1030,56 @@ namespace AppInstaller::CLI::Workflow
 
             std::vector<ResultMatch> changes;
 
-            for (auto& entry : arpSource.Search({}).Matches)
+            if (context.Contains(Execution::Data::ARPKeySnapshot))
             {
-                auto installed = entry.Package->GetInstalledVersion();
+                // Only the entries whose keys are new or have been written are looked up
+                std::vector<std::string> changedProductCodes;
 
-                if (installed)
+                auto currentKeySnapshot = ARPKeySnapshot::TryCreate();
+                if (currentKeySnapshot)
                 {
-                    auto entryKey = std::make_tuple(
-                        entry.Package->GetProperty(PackageProperty::Id),
-                        installed->GetProperty(PackageVersionProperty::Version),
-                        installed->GetProperty(PackageVersionProperty::Channel));
+                    changedProductCodes = context.Get<Execution::Data::ARPKeySnapshot>().GetChangedProductCodes(currentKeySnapshot.value());
+                }
+
+                AICLI_LOG(CLI, Verbose, << "Found " << changedProductCodes.size() << " changed ARP keys");
+
+                if (!changedProductCodes.empty())
+                {
+                    SearchRequest changedSearchRequest;
+                    for (const auto& productCode : changedProductCodes)
+                    {
+                        changedSearchRequest.Inclusions.emplace_back(PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, productCode));
+                    }
 
-                    auto itr = std::lower_bound(entries.begin(), entries.end(), entryKey);
-                    if (itr == entries.end() || *itr != entryKey)
+                    for (auto& entry : arpSource.Search(changedSearchRequest).Matches)
                     {
-                        changes.emplace_back(std::move(entry));
+                        if (entry.Package->GetInstalledVersion())
+                        {
+                            changes.emplace_back(std::move(entry));
+                        }
+                    }
+                }
+            }
+            else
+            {
+                const auto& entries = context.Get<Execution::Data::ARPSnapshot>();
+
+                for (auto& entry : arpSource.Search({}).Matches)
+                {
+                    auto installed = entry.Package->GetInstalledVersion();
+
+                    if (installed)
+                    {
+                        auto entryKey = std::make_tuple(
+                            entry.Package->GetProperty(PackageProperty::Id),
+                            installed->GetProperty(PackageVersionProperty::Version),
+                            installed->GetProperty(PackageVersionProperty::Channel));
+
+                        auto itr = std::lower_bound(entries.begin(), entries.end(), entryKey);
+                        if (itr == entries.end() || *itr != entryKey)
+                        {
+                            changes.emplace_back(std::move(entry));
+                        }
                     }
                 }
             }
@@ -686,6 +1230,12 @@ namespace AppInstaller::CLI::Workflow
             return;
         }
 
+        if (context.Contains(Data::InstallRecordBatch))
+        {
+            context.Get<Data::InstallRecordBatch>()->Add(context);
+            return;
+        }
+
         auto trackingCatalog = context.Get<Data::PackageVersion>()->GetSource().GetTrackingCatalog();
 
         trackingCatalog.RecordInstall(
@@ -693,4 +1243,48 @@ namespace AppInstaller::CLI::Workflow
             context.Get<Data::Installer>().value(),
             WI_IsFlagSet(context.GetFlags(), ContextFlag::InstallerExecutionUseUpdate));
     }
+
+    InstallRecordBatch::~InstallRecordBatch()
+    {
+        Flush();
+    }
+
+    void InstallRecordBatch::Add(Execution::Context& context)
+    {
+        std::lock_guard<std::mutex> lock{ m_pendingLock };
+
+        const auto& source = context.Get<Data::PackageVersion>()->GetSource();
+
+        auto [itr, added] = m_pending.try_emplace(source.GetIdentifier());
+        if (added)
+        {
+            itr->second.Catalog = source.GetTrackingCatalog();
+        }
+
+        Repository::PackageTrackingCatalog::InstallRecord record;
+        record.PackageManifest = context.Get<Data::Manifest>();
+        record.Installer = context.Get<Data::Installer>().value();
+        record.IsUpgrade = WI_IsFlagSet(context.GetFlags(), ContextFlag::InstallerExecutionUseUpdate);
+        itr->second.Records.emplace_back(std::move(record));
+    }
+
+    void InstallRecordBatch::Flush()
+    {
+        std::lock_guard<std::mutex> lock{ m_pendingLock };
+
+        for (auto& [identifier, pending] : m_pending)
+        {
+            try
+            {
+                pending.Catalog.RecordInstalls(pending.Records);
+            }
+            catch (...)
+            {
+                AICLI_LOG(CLI, Error, << "Failed to record " << pending.Records.size() << " installs from source: " << identifier);
+                LOG_CAUGHT_EXCEPTION();
+            }
+        }
+
+        m_pending.clear();
+    }
 }
@@ -3,6 +3,15 @@
 #pragma once
 #include "ExecutionContext.h"
 
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace AppInstaller::CLI::Workflow
 {
     using namespace std::string_view_literals;
@@ -161,21 +170,132 @@ namespace AppInstaller::CLI::Workflow
         bool m_ensurePackageAgreements;
     };
 
+    // Stages the MSIX packages of PackagesToInstall in the background, before the serialized installs reach them.
+    // Only packages from trusted sources that are deployed from their URL can be staged, as staging does not check SmartScreen.
+    struct MsixStaging
+    {
+        // Starts staging the MSIX packages of PackagesToInstall, in install order, with at most the given number at once.
+        MsixStaging(Execution::Context& context, size_t concurrency);
+
+        MsixStaging(const MsixStaging&) = delete;
+        MsixStaging& operator=(const MsixStaging&) = delete;
+
+        MsixStaging(MsixStaging&&) = delete;
+        MsixStaging& operator=(MsixStaging&&) = delete;
+
+        ~MsixStaging();
+
+        // Waits for the package of the given context to be staged, showing progress while it is.
+        // Returns the full name of the staged package, which the caller must then register or remove;
+        // returns an empty value if the package was not staged.
+        std::optional<std::string> Take(Execution::Context& packageContext);
+
+        // Cancels any outstanding staging, waits for it to stop, and removes the staged packages that were not taken.
+        void Complete();
+
+    private:
+        struct Job;
+
+        void RunJobs();
+
+        std::vector<std::unique_ptr<Job>> m_jobs;
+        std::atomic<size_t> m_nextJob = 0;
+        std::vector<std::future<void>> m_workers;
+        std::atomic_bool m_completed = false;
+    };
+
+    // Starts staging the MSIX packages of PackagesToInstall when there are several that can be.
+    // Required Args: None
+    // Inputs: PackagesToInstall
+    // Outputs: MsixStaging (on each of PackagesToInstall)
+    void StageMsixPackages(Execution::Context& context);
+
+    // Installs packages whose installers do not write to ARP on background threads, while the others are installed in turn.
+    // Those installers can run alongside any other, as there are no ARP changes to correlate with them and they do not use the Windows Installer.
+    struct ConcurrentInstalls
+    {
+        // Installs at most the given number of packages at once.
+        ConcurrentInstalls(size_t concurrency) : m_concurrency(concurrency) {}
+
+        ConcurrentInstalls(const ConcurrentInstalls&) = delete;
+        ConcurrentInstalls& operator=(const ConcurrentInstalls&) = delete;
+
+        ConcurrentInstalls(ConcurrentInstalls&&) = delete;
+        ConcurrentInstalls& operator=(ConcurrentInstalls&&) = delete;
+
+        ~ConcurrentInstalls();
+
+        // Determines whether the package of the given context can be installed concurrently with others.
+        static bool CanInstallConcurrently(Execution::Context& packageContext);
+
+        // Starts installing the package of the given context, first waiting for an install to complete if the maximum are in progress.
+        // The progress of the install is not shown, as it would be drawn over that of the others.
+        void Start(Execution::Context& packageContext);
+
+        // Waits for all of the started installs to complete, returning their contexts in the order they were started.
+        std::vector<Execution::Context*> Wait();
+
+    private:
+        struct Install
+        {
+            Execution::Context* PackageContext;
+            std::future<void> Completed;
+        };
+
+        size_t m_concurrency;
+        std::vector<Install> m_installs;
+    };
+
     // Stores the existing set of packages in ARP.
+    // When possible, only the ARP keys and their last write times are recorded.
     // Required Args: None
     // Inputs: Installer
-    // Outputs: ARPSnapshot
+    // Outputs: ARPKeySnapshot or ARPSnapshot
     void SnapshotARPEntries(Execution::Context& context);
 
-    // Reports on the changes between the stored ARPSnapshot and the current values.
+    // Reports on the changes between the stored snapshot and the current values.
     // Required Args: None
-    // Inputs: ARPSnapshot?, Manifest, PackageVersion
+    // Inputs: ARPKeySnapshot?, ARPSnapshot?, Manifest, PackageVersion
     // Outputs: None
     void ReportARPChanges(Execution::Context& context);
 
-    // Records the installation to the tracking catalog.
+    // Records the installation to the tracking catalog, or adds it to the InstallRecordBatch when there is one.
     // Required Args: None
-    // Inputs: PackageVersion?, Manifest, Installer
+    // Inputs: PackageVersion?, Manifest, Installer, InstallRecordBatch?
     // Outputs: None
     void RecordInstall(Execution::Context& context);
+
+    // Holds the installations of several packages so that each tracking catalog records them in a single transaction.
+    struct InstallRecordBatch
+    {
+        InstallRecordBatch() = default;
+
+        InstallRecordBatch(const InstallRecordBatch&) = delete;
+        InstallRecordBatch& operator=(const InstallRecordBatch&) = delete;
+
+        InstallRecordBatch(InstallRecordBatch&&) = delete;
+        InstallRecordBatch& operator=(InstallRecordBatch&&) = delete;
+
+        // Records anything still pending.
+        ~InstallRecordBatch();
+
+        // Adds the installation of the given context to the batch.
+        void Add(Execution::Context& context);
+
+        // Records all of the pending installations to their tracking catalogs.
+        // Failures are logged rather than thrown, as the packages have already been installed.
+        void Flush();
+
+    private:
+        struct Pending
+        {
+            Repository::PackageTrackingCatalog Catalog;
+            std::vector<Repository::PackageTrackingCatalog::InstallRecord> Records;
+        };
+
+        // Keyed on the identifier of the source of the packages.
+        std::map<std::string, Pending> m_pending;
+        // Installs that run concurrently add to the batch from their threads.
+        std::mutex m_pendingLock;
+    };
 }
@@ -4,6 +4,7 @@
 #include "WorkflowBase.h"
 #include "ExecutionContext.h"
 #include "ManifestComparator.h"
+#include <winget/InstallerApplicability.h>
 #include <winget/UserSettings.h>
 
 using namespace AppInstaller::CLI;
@@ -22,40 +23,69 @@ namespace AppInstaller::CLI::Workflow
 {
     namespace
     {
+        Manifest::ScopeEnum ConvertScope(Settings::ScopePreference scope)
+        {
+            switch (scope)
+            {
+            case Settings::ScopePreference::None: return Manifest::ScopeEnum::Unknown;
+            case Settings::ScopePreference::User: return Manifest::ScopeEnum::User;
+            case Settings::ScopePreference::Machine: return Manifest::ScopeEnum::Machine;
+            }
+
+            return Manifest::ScopeEnum::Unknown;
+        }
+
         struct OSVersionFilter : public details::FilterField
         {
             OSVersionFilter() : details::FilterField("OS Version") {}
 
             InapplicabilityFlags IsApplicable(const Manifest::ManifestInstaller& installer) override
             {
-                if (installer.MinOSVersion.empty() || Runtime::IsCurrentOSVersionGreaterThanOrEqual(Utility::Version(installer.MinOSVersion)))
+                if (installer.MinOSVersion.empty())
                 {
                     return InapplicabilityFlags::None;
                 }
 
-                return InapplicabilityFlags::OSVersion;
+                // Most installers of a package share a minimum version, so only check each one against the system once.
+                auto itr = m_results.find(installer.MinOSVersion);
+                if (itr == m_results.end())
+                {
+                    itr = m_results.emplace(installer.MinOSVersion, Runtime::IsCurrentOSVersionGreaterThanOrEqual(Utility::Version(installer.MinOSVersion))).first;
+                }
+
+                return (itr->second ? InapplicabilityFlags::None : InapplicabilityFlags::OSVersion);
             }
 
+            bool AppliesToSummary() const override { return true; }
+
             std::string ExplainInapplicable(const Manifest::ManifestInstaller& installer) override
             {
                 std::string result = "Current OS is lower than MinOSVersion ";
                 result += installer.MinOSVersion;
                 return result;
             }
+
+        private:
+            std::map<std::string, bool> m_results;
         };
 
         struct MachineArchitectureComparator : public details::ComparisonField
         {
-            MachineArchitectureComparator() : details::ComparisonField("Machine Architecture") {}
+            MachineArchitectureComparator(Utility::Architecture systemArchitecture) :
+                details::ComparisonField("Machine Architecture"), m_systemArchitecture(systemArchitecture)
+            {
+                InitializePriorities();
+            }
 
-            MachineArchitectureComparator(std::vector<Utility::Architecture> allowedArchitectures) :
-                details::ComparisonField("Machine Architecture"), m_allowedArchitectures(std::move(allowedArchitectures))
+            MachineArchitectureComparator(std::vector<Utility::Architecture> allowedArchitectures, Utility::Architecture systemArchitecture) :
+                details::ComparisonField("Machine Architecture"), m_allowedArchitectures(std::move(allowedArchitectures)), m_systemArchitecture(systemArchitecture)
             {
                 AICLI_LOG(CLI, Verbose, << "Architecture Comparator created with allowed architectures: " << Utility::ConvertContainerToString(m_allowedArchitectures, Utility::ToString));
+                InitializePriorities();
             }
 
             // TODO: At some point we can do better about matching the currently installed architecture
-            static std::unique_ptr<MachineArchitectureComparator> Create(const Execution::Context& context, const Repository::IPackageVersion::Metadata&)
+            static std::unique_ptr<MachineArchitectureComparator> Create(const Execution::Context& context, const Repository::IPackageVersion::Metadata&, const ManifestComparatorOptions& options)
             {
                 if (context.Contains(Execution::Data::AllowedArchitectures))
                 {
@@ -95,11 +125,11 @@ namespace AppInstaller::CLI::Workflow
                             }
                         }
 
-                        return std::make_unique<MachineArchitectureComparator>(std::move(result));
+                        return std::make_unique<MachineArchitectureComparator>(std::move(result), options.SystemArchitecture);
                     }
                 }
 
-                return std::make_unique<MachineArchitectureComparator>();
+                return std::make_unique<MachineArchitectureComparator>(options.SystemArchitecture);
             }
 
             InapplicabilityFlags IsApplicable(const Manifest::ManifestInstaller& installer) override
@@ -113,6 +143,8 @@ namespace AppInstaller::CLI::Workflow
                 return InapplicabilityFlags::None;
             }
 
+            bool AppliesToSummary() const override { return true; }
+
             std::string ExplainInapplicable(const Manifest::ManifestInstaller& installer) override
             {
                 std::string result;
@@ -148,7 +180,23 @@ namespace AppInstaller::CLI::Workflow
             }
 
         private:
-            int CheckAllowedArchitecture(Utility::Architecture architecture)
+            // The priority of every architecture is computed up front, indexed by the value of the architecture plus one so that Unknown is included.
+            static constexpr size_t PriorityCount = static_cast<size_t>(Utility::Architecture::Arm64) + 2;
+
+            static size_t GetPriorityIndex(Utility::Architecture architecture)
+            {
+                return static_cast<size_t>(static_cast<int>(architecture) + 1);
+            }
+
+            void InitializePriorities()
+            {
+                for (size_t i = 0; i < PriorityCount; ++i)
+                {
+                    m_priorities[i] = ComputeAllowedArchitecture(static_cast<Utility::Architecture>(static_cast<int>(i) - 1));
+                }
+            }
+
+            int ComputeAllowedArchitecture(Utility::Architecture architecture) const
             {
                 if (m_allowedArchitectures.empty())
                 {
@@ -160,16 +208,24 @@ namespace AppInstaller::CLI::Workflow
                 }
             }
 
-            bool IsSystemArchitectureUnsupportedByInstaller(const ManifestInstaller& installer)
+            int CheckAllowedArchitecture(Utility::Architecture architecture) const
+            {
+                size_t index = GetPriorityIndex(architecture);
+                return (index < PriorityCount ? m_priorities[index] : ComputeAllowedArchitecture(architecture));
+            }
+
+            bool IsSystemArchitectureUnsupportedByInstaller(const ManifestInstaller& installer) const
             {
                 auto unsupportedItr = std::find(
                     installer.UnsupportedOSArchitectures.begin(),
                     installer.UnsupportedOSArchitectures.end(),
-                    Utility::GetSystemArchitecture());
+                    m_systemArchitecture);
                 return unsupportedItr != installer.UnsupportedOSArchitectures.end();
             }
 
             std::vector<Utility::Architecture> m_allowedArchitectures;
+            Utility::Architecture m_systemArchitecture;
+            std::array<int, PriorityCount> m_priorities{};
         };
 
         struct InstalledTypeComparator : public details::ComparisonField
@@ -212,6 +268,8 @@ namespace AppInstaller::CLI::Workflow
                 return InapplicabilityFlags::InstalledType;
             }
 
+            bool AppliesToSummary() const override { return true; }
+
             std::string ExplainInapplicable(const Manifest::ManifestInstaller& installer) override
             {
                 std::string result = "Installed package type '" + std::string{ Manifest::InstallerTypeToString(m_installedType) } +
@@ -272,6 +330,8 @@ namespace AppInstaller::CLI::Workflow
                 return InapplicabilityFlags::InstalledScope;
             }
 
+            bool AppliesToSummary() const override { return true; }
+
             std::string ExplainInapplicable(const Manifest::ManifestInstaller& installer) override
             {
                 std::string result = "Installer scope does not match currently installed scope: ";
@@ -290,10 +350,10 @@ namespace AppInstaller::CLI::Workflow
             ScopeComparator(Manifest::ScopeEnum preference, Manifest::ScopeEnum requirement) :
                 details::ComparisonField("Scope"), m_preference(preference), m_requirement(requirement) {}
 
-            static std::unique_ptr<ScopeComparator> Create(const Execution::Args& args)
+            static std::unique_ptr<ScopeComparator> Create(const Execution::Args& args, const ManifestComparatorOptions& options)
             {
                 // Preference will always come from settings
-                Manifest::ScopeEnum preference = ConvertScope(Settings::User().Get<Settings::Setting::InstallScopePreference>());
+                Manifest::ScopeEnum preference = options.ScopePreference;
 
                 // Requirement may come from args or settings; args overrides settings.
                 Manifest::ScopeEnum requirement = Manifest::ScopeEnum::Unknown;
@@ -304,7 +364,7 @@ namespace AppInstaller::CLI::Workflow
                 }
                 else
                 {
-                    requirement = ConvertScope(Settings::User().Get<Settings::Setting::InstallScopeRequirement>());
+                    requirement = options.ScopeRequirement;
                 }
 
                 if (preference != Manifest::ScopeEnum::Unknown || requirement != Manifest::ScopeEnum::Unknown)
@@ -327,6 +387,8 @@ namespace AppInstaller::CLI::Workflow
                 return InapplicabilityFlags::Scope;
             }
 
+            bool AppliesToSummary() const override { return true; }
+
             std::string ExplainInapplicable(const Manifest::ManifestInstaller& installer) override
             {
                 std::string result = "Installer scope does not match required scope: ";
@@ -342,18 +404,6 @@ namespace AppInstaller::CLI::Workflow
             }
 
         private:
-            static Manifest::ScopeEnum ConvertScope(Settings::ScopePreference scope)
-            {
-                switch (scope)
-                {
-                case Settings::ScopePreference::None: return Manifest::ScopeEnum::Unknown;
-                case Settings::ScopePreference::User: return Manifest::ScopeEnum::User;
-                case Settings::ScopePreference::Machine: return Manifest::ScopeEnum::Machine;
-                }
-
-                return Manifest::ScopeEnum::Unknown;
-            }
-
             Manifest::ScopeEnum m_preference;
             Manifest::ScopeEnum m_requirement;
         };
@@ -418,18 +468,12 @@ namespace AppInstaller::CLI::Workflow
                 AICLI_LOG(CLI, Verbose, << "Locale Comparator created with Required Locales: " << m_requirementAsString << " , Preferred Locales: " << m_preferenceAsString);
             }
 
-            static std::unique_ptr<LocaleComparator> Create(const Execution::Args& args)
+            static std::unique_ptr<LocaleComparator> Create(const Execution::Args& args, const ManifestComparatorOptions& options)
             {
-                std::vector<std::string> preference;
+                // Preference will come from winget settings or Preferred Languages settings, as resolved by the options.
+                std::vector<std::string> preference = options.LocalePreference;
                 std::vector<std::string> requirement;
 
-                // Preference will come from winget settings or Preferred Languages settings. winget settings takes precedence.
-                preference = Settings::User().Get<Settings::Setting::InstallLocalePreference>();
-                if (preference.empty())
-                {
-                    preference = Locale::GetUserPreferredLanguages();
-                }
-
                 // Requirement may come from args or settings; args overrides settings.
                 if (args.Contains(Execution::Args::Type::Locale))
                 {
@@ -437,7 +481,7 @@ namespace AppInstaller::CLI::Workflow
                 }
                 else
                 {
-                    requirement = Settings::User().Get<Settings::Setting::InstallLocaleRequirement>();
+                    requirement = options.LocaleRequirement;
                 }
 
                 if (!preference.empty() || !requirement.empty())
@@ -514,9 +558,9 @@ namespace AppInstaller::CLI::Workflow
                 AICLI_LOG(CLI, Verbose, << "Market Filter created with market: " << m_market);
             }
 
-            static std::unique_ptr<MarketFilter> Create()
+            static std::unique_ptr<MarketFilter> Create(const ManifestComparatorOptions& options)
             {
-                return std::make_unique<MarketFilter>(Runtime::GetOSRegion());
+                return std::make_unique<MarketFilter>(options.Market);
             }
 
             InapplicabilityFlags IsApplicable(const Manifest::ManifestInstaller& installer) override
@@ -563,11 +607,44 @@ namespace AppInstaller::CLI::Workflow
         };
     }
 
+    ManifestComparatorOptions ManifestComparatorOptions::Create()
+    {
+        ManifestComparatorOptions result;
+
+        result.ScopePreference = ConvertScope(Settings::User().Get<Settings::Setting::InstallScopePreference>());
+        result.ScopeRequirement = ConvertScope(Settings::User().Get<Settings::Setting::InstallScopeRequirement>());
+
+        // winget settings take precedence over the Preferred Languages settings.
+        result.LocalePreference = Settings::User().Get<Settings::Setting::InstallLocalePreference>();
+        if (result.LocalePreference.empty())
+        {
+            result.LocalePreference = Locale::GetUserPreferredLanguages();
+        }
+
+        result.LocaleRequirement = Settings::User().Get<Settings::Setting::InstallLocaleRequirement>();
+        result.Market = Runtime::GetOSRegion();
+        result.SystemArchitecture = Utility::GetSystemArchitecture();
+
+        return result;
+    }
+
     ManifestComparator::ManifestComparator(const Execution::Context& context, const Repository::IPackageVersion::Metadata& installationMetadata)
     {
+        std::optional<ManifestComparatorOptions> createdOptions;
+        const ManifestComparatorOptions* options = nullptr;
+
+        if (context.Contains(Execution::Data::ManifestComparatorOptions) && context.Get<Execution::Data::ManifestComparatorOptions>())
+        {
+            options = context.Get<Execution::Data::ManifestComparatorOptions>().get();
+        }
+        else
+        {
+            options = &createdOptions.emplace(ManifestComparatorOptions::Create());
+        }
+
         AddFilter(std::make_unique<OSVersionFilter>());
         AddFilter(InstalledScopeFilter::Create(installationMetadata));
-        AddFilter(MarketFilter::Create());
+        AddFilter(MarketFilter::Create(*options));
 
         // Filter order is not important, but comparison order determines priority.
         // TODO: There are improvements to be made here around ordering, especially in the context of implicit vs explicit vs command line preferences.
@@ -580,11 +657,11 @@ namespace AppInstaller::CLI::Workflow
         }
         else
         {
-            AddComparator(LocaleComparator::Create(context.Args));
+            AddComparator(LocaleComparator::Create(context.Args, *options));
         }
 
-        AddComparator(ScopeComparator::Create(context.Args));
-        AddComparator(MachineArchitectureComparator::Create(context, installationMetadata));
+        AddComparator(ScopeComparator::Create(context.Args, *options));
+        AddComparator(MachineArchitectureComparator::Create(context, installationMetadata, *options));
     }
 
     InstallerAndInapplicabilities ManifestComparator::GetPreferredInstaller(const Manifest::Manifest& manifest)
@@ -636,6 +713,46 @@ namespace AppInstaller::CLI::Workflow
         return inapplicabilityResult;
     }
 
+    std::optional<std::vector<InapplicabilityFlags>> ManifestComparator::GetSummaryInapplicabilities(const Repository::IPackageVersion::Metadata& availableMetadata)
+    {
+        auto summaryItr = availableMetadata.find(Repository::PackageVersionMetadata::InstallerApplicability);
+        if (summaryItr == availableMetadata.end())
+        {
+            return {};
+        }
+
+        auto installers = Repository::InstallerApplicability::Parse(summaryItr->second);
+        if (!installers || installers->empty())
+        {
+            return {};
+        }
+
+        std::vector<InapplicabilityFlags> result;
+
+        for (const auto& installer : installers.value())
+        {
+            InapplicabilityFlags inapplicability = InapplicabilityFlags::None;
+
+            for (const auto& filter : m_filters)
+            {
+                if (filter->AppliesToSummary())
+                {
+                    WI_SetAllFlags(inapplicability, filter->IsApplicable(installer));
+                }
+            }
+
+            if (inapplicability == InapplicabilityFlags::None)
+            {
+                // This installer may be applicable, depending on the fields that are not in the summary.
+                return {};
+            }
+
+            result.push_back(inapplicability);
+        }
+
+        return result;
+    }
+
     bool ManifestComparator::IsFirstBetter(
         const Manifest::ManifestInstaller& first,
         const Manifest::ManifestInstaller& second)
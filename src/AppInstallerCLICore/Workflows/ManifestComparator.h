@@ -47,6 +47,10 @@ namespace AppInstaller::CLI::Workflow
             // Will only be called when IsApplicable returns false.
             virtual std::string ExplainInapplicable(const Manifest::ManifestInstaller& installer) = 0;
 
+            // Determines if the filter only looks at fields that are kept in the installer applicability summary of the index,
+            // and so can be applied to the installers parsed from it.
+            virtual bool AppliesToSummary() const { return false; }
+
         private:
             std::string_view m_name;
         };
@@ -63,6 +67,22 @@ namespace AppInstaller::CLI::Workflow
         };
     }
 
+    // The inputs to the comparator that come from user settings and the system, rather than from the context.
+    // Reading these is not free, so a caller that creates a comparator for many packages can capture them once and share them through
+    // Data::ManifestComparatorOptions; the arguments of each context still override them.
+    struct ManifestComparatorOptions
+    {
+        // Reads the current values of the inputs.
+        static ManifestComparatorOptions Create();
+
+        Manifest::ScopeEnum ScopePreference = Manifest::ScopeEnum::Unknown;
+        Manifest::ScopeEnum ScopeRequirement = Manifest::ScopeEnum::Unknown;
+        std::vector<std::string> LocalePreference;
+        std::vector<std::string> LocaleRequirement;
+        std::string Market;
+        Utility::Architecture SystemArchitecture = Utility::Architecture::Unknown;
+    };
+
     struct InstallerAndInapplicabilities
     {
         std::optional<Manifest::ManifestInstaller> installer;
@@ -80,6 +100,10 @@ namespace AppInstaller::CLI::Workflow
         // Determines if an installer is applicable.
         InapplicabilityFlags IsApplicable(const Manifest::ManifestInstaller& installer);
 
+        // Uses the installer applicability summary in the metadata of an available version to rule it out without its manifest.
+        // Returns the inapplicabilities of every installer if none of them can be applicable, or an empty value if the manifest must be checked.
+        std::optional<std::vector<InapplicabilityFlags>> GetSummaryInapplicabilities(const Repository::IPackageVersion::Metadata& availableMetadata);
+
         // Determines if the first installer is a better choice.
         bool IsFirstBetter(
             const Manifest::ManifestInstaller& first,
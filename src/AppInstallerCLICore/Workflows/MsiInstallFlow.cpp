@@ -3,12 +3,14 @@
 #include "pch.h"
 #include "MsiInstallFlow.h"
 #include "winget/MsiExecArguments.h"
+#include <msiquery.h>
 
 namespace AppInstaller::CLI::Workflow
 {
     namespace
     {
-        std::optional<UINT> InvokeMsiInstallProduct(const std::filesystem::path& installerPath, const Msi::MsiParsedArguments& msiArgs, IProgressCallback&)
+        // Applies the logging and UI options of the arguments to the following Windows Installer operations of this process.
+        void SetMsiOptions(const Msi::MsiParsedArguments& msiArgs)
         {
             if (msiArgs.LogFile)
             {
@@ -22,10 +24,51 @@ namespace AppInstaller::CLI::Workflow
 
             // Returns old UI level. We don't need to reset it so we ignore it.
             MsiSetInternalUI(msiArgs.UILevel, nullptr);
+        }
+
+        std::optional<UINT> InvokeMsiInstallProduct(const std::filesystem::path& installerPath, const Msi::MsiParsedArguments& msiArgs, IProgressCallback&)
+        {
+            SetMsiOptions(msiArgs);
 
             // TODO: Use progress callback
             return MsiInstallProductW(installerPath.c_str(), msiArgs.Properties.c_str());
         }
+
+        std::optional<UINT> InvokeMsiUninstallProduct(const Utility::LocIndString& productCode, const Msi::MsiParsedArguments& msiArgs, IProgressCallback&)
+        {
+            SetMsiOptions(msiArgs);
+
+            return MsiConfigureProductExW(
+                Utility::ConvertToUTF16(productCode.get()).c_str(),
+                INSTALLLEVEL_DEFAULT,
+                INSTALLSTATE_ABSENT,
+                msiArgs.Properties.c_str());
+        }
+
+        // Gets the options that msiexec would be given to uninstall a product.
+        std::string GetMsiUninstallArgs(Execution::Context& context)
+        {
+            std::string args;
+
+            // If interactive is requested, use the default UI level instead of Reduced or Full as the installer may not use them.
+            if (context.Args.Contains(Execution::Args::Type::Silent))
+            {
+                args = "/qn";
+            }
+            else if (!context.Args.Contains(Execution::Args::Type::Interactive))
+            {
+                args = "/qb";
+            }
+
+            if (context.Args.Contains(Execution::Args::Type::Log))
+            {
+                args += " /log \"";
+                args += context.Args.GetArg(Execution::Args::Type::Log);
+                args += '"';
+            }
+
+            return args;
+        }
     }
 
     void DirectMSIInstallImpl(Execution::Context& context)
@@ -36,6 +79,11 @@ namespace AppInstaller::CLI::Workflow
 
         Msi::MsiParsedArguments parsedArgs = Msi::ParseMSIArguments(context.Get<Execution::Data::InstallerArgs>());
 
+        if (context.Contains(Execution::Data::MsiTransaction))
+        {
+            context.Get<Execution::Data::MsiTransaction>()->Join();
+        }
+
         auto installResult = context.Reporter.ExecuteWithProgress(
             std::bind(InvokeMsiInstallProduct,
                 installerPath,
@@ -52,4 +100,88 @@ namespace AppInstaller::CLI::Workflow
             context.Add<Execution::Data::OperationReturnCode>(installResult.value());
         }
     }
+
+    void DirectMSIUninstallImpl(Execution::Context& context)
+    {
+        const auto& productCodes = context.Get<Execution::Data::ProductCodes>();
+        context.Reporter.Info() << Resource::String::UninstallFlowStartingPackageUninstall << std::endl;
+
+        Msi::MsiParsedArguments parsedArgs = Msi::ParseMSIArguments(GetMsiUninstallArgs(context));
+
+        for (const auto& productCode : productCodes)
+        {
+            AICLI_LOG(CLI, Info, << "Removing: " << productCode);
+            auto uninstallResult = context.Reporter.ExecuteWithProgress(
+                std::bind(InvokeMsiUninstallProduct,
+                    productCode,
+                    parsedArgs,
+                    std::placeholders::_1));
+
+            if (!uninstallResult)
+            {
+                context.Reporter.Warn() << Resource::String::UninstallAbandoned << std::endl;
+                AICLI_TERMINATE_CONTEXT(E_ABORT);
+            }
+            else if (uninstallResult.value() != ERROR_SUCCESS)
+            {
+                const auto installedPackageVersion = context.Get<Execution::Data::InstalledPackageVersion>();
+                Logging::Telemetry().LogUninstallerFailure(
+                    installedPackageVersion->GetProperty(Repository::PackageVersionProperty::Id),
+                    installedPackageVersion->GetProperty(Repository::PackageVersionProperty::Version),
+                    "MsiConfigureProductEx",
+                    uninstallResult.value());
+
+                context.Add<Execution::Data::OperationReturnCode>(uninstallResult.value());
+                context.Reporter.Error() << Resource::String::UninstallFailedWithCode << ' ' << uninstallResult.value() << std::endl;
+                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_EXEC_UNINSTALL_COMMAND_FAILED);
+            }
+        }
+
+        context.Reporter.Info() << Resource::String::UninstallFlowUninstallSuccess << std::endl;
+    }
+
+    MsiTransaction::~MsiTransaction()
+    {
+        if (IsActive())
+        {
+            LOG_IF_FAILED(End(false));
+        }
+    }
+
+    void MsiTransaction::Join()
+    {
+        if (!IsActive())
+        {
+            // The event for changes of the owner is not needed, as the transaction is only ever owned by this process.
+            HANDLE changeOfOwnerEvent = nullptr;
+            THROW_IF_WIN32_ERROR(MsiBeginTransaction(L"WinGet", 0, &m_transaction, &changeOfOwnerEvent));
+            AICLI_LOG(CLI, Info, << "Began MSI transaction");
+        }
+
+        ++m_installCount;
+    }
+
+    HRESULT MsiTransaction::End(bool commit)
+    {
+        if (!IsActive())
+        {
+            return S_OK;
+        }
+
+        AICLI_LOG(CLI, Info, << (commit ? "Committing" : "Rolling back") << " MSI transaction of " << m_installCount << " installs");
+
+        UINT result = MsiEndTransaction(commit ? MSITRANSACTIONSTATE_COMMIT : MSITRANSACTIONSTATE_ROLLBACK);
+        MsiCloseHandle(m_transaction);
+        m_transaction = 0;
+        m_installCount = 0;
+
+        if (!commit && result != ERROR_SUCCESS)
+        {
+            // A failed install may already have rolled back the transaction, in which case there is nothing left to end.
+            AICLI_LOG(CLI, Info, << "Ending the rolled back MSI transaction returned: " << result);
+            return S_OK;
+        }
+
+        return HRESULT_FROM_WIN32(result);
+    }
 }
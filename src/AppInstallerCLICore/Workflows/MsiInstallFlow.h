@@ -10,4 +10,42 @@ namespace AppInstaller::CLI::Workflow
     // Inputs: InstallerArgs, Installer, InstallerPath, Manifest
     // Outputs: OperationReturnCode
     void DirectMSIInstallImpl(Execution::Context& context);
+
+    // Uninstalls the products with the Windows Installer API in this process, rather than through msiexec.
+    // Required Args: None
+    // Inputs: InstalledPackageVersion, ProductCodes
+    // Outputs: OperationReturnCode?
+    void DirectMSIUninstallImpl(Execution::Context& context);
+
+    // Groups consecutive direct MSI installs into a single Windows Installer transaction, which creates one restore point for all of them.
+    // Windows Installer rolls back all of the installs in the transaction if any of them fails.
+    struct MsiTransaction
+    {
+        MsiTransaction() = default;
+
+        MsiTransaction(const MsiTransaction&) = delete;
+        MsiTransaction& operator=(const MsiTransaction&) = delete;
+
+        MsiTransaction(MsiTransaction&&) = delete;
+        MsiTransaction& operator=(MsiTransaction&&) = delete;
+
+        // Rolls back the transaction if it was not ended.
+        ~MsiTransaction();
+
+        // Begins the transaction if it is not already active; the following installs by this process are part of it.
+        void Join();
+
+        // Determines whether the transaction has been begun and not yet ended.
+        bool IsActive() const { return m_transaction != 0; }
+
+        // Gets the number of installs that have joined the transaction.
+        size_t InstallCount() const { return m_installCount; }
+
+        // Ends the transaction, committing or rolling back all of the installs in it.
+        HRESULT End(bool commit);
+
+    private:
+        MSIHANDLE m_transaction = 0;
+        size_t m_installCount = 0;
+    };
 }
@@ -32,17 +32,19 @@ namespace AppInstaller::CLI::Workflow
 
             wil::unique_process_handle process{ execInfo.hProcess };
 
-            // Wait for installation to finish
-            while (!progress.IsCancelled())
+            // Wait for installation to finish or for the operation to be cancelled
+            wil::unique_event cancelEvent;
+            cancelEvent.create(wil::EventOptions::ManualReset);
+            auto removeCancel = progress.SetCancellationFunction([&cancelEvent]() { cancelEvent.SetEvent(); });
+
+            // Check to handle cancellation before SetCancellationFunction
+            if (!progress.IsCancelled())
             {
-                DWORD waitResult = WaitForSingleObject(process.get(), 250);
-                if (waitResult == WAIT_OBJECT_0)
-                {
-                    break;
-                }
-                if (waitResult != WAIT_TIMEOUT)
+                HANDLE waitHandles[] = { process.get(), cancelEvent.get() };
+                DWORD waitResult = WaitForMultipleObjects(ARRAYSIZE(waitHandles), waitHandles, FALSE, INFINITE);
+                if (waitResult != WAIT_OBJECT_0 && waitResult != WAIT_OBJECT_0 + 1)
                 {
-                    THROW_LAST_ERROR_MSG("Unexpected WaitForSingleObjectResult: %lu", waitResult);
+                    THROW_LAST_ERROR_MSG("Unexpected WaitForMultipleObjects result: %lu", waitResult);
                 }
             }
 
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "ShowFlow.h"
+#include "JsonOutput.h"
 #include "ManifestComparator.h"
 #include "TableOutput.h"
 
@@ -12,8 +13,105 @@ using namespace AppInstaller::Utility::literals;
 
 namespace AppInstaller::CLI::Workflow
 {
+    namespace
+    {
+        // Sets the value only if it is not empty, matching the fields that are shown for the table.
+        void SetIfNotEmpty(Json::Value& record, const char* name, const std::string& value)
+        {
+            if (!value.empty())
+            {
+                record[name] = value;
+            }
+        }
+
+        // Writes the package and installer information as a single record.
+        void ShowManifestInfoRecord(Execution::Context& context, Execution::OutputFormat format)
+        {
+            const auto& manifest = context.Get<Execution::Data::Manifest>();
+            const auto& installer = context.Get<Execution::Data::Installer>();
+            const auto& localization = manifest.CurrentLocalization;
+
+            Json::Value record{ Json::ValueType::objectValue };
+            record["id"] = manifest.Id;
+            record["name"] = localization.Get<Manifest::Localization::PackageName>();
+            record["version"] = manifest.Version;
+            SetIfNotEmpty(record, "channel", manifest.Channel);
+            record["publisher"] = localization.Get<Manifest::Localization::Publisher>();
+            SetIfNotEmpty(record, "publisherUrl", localization.Get<Manifest::Localization::PublisherUrl>());
+            SetIfNotEmpty(record, "publisherSupportUrl", localization.Get<Manifest::Localization::PublisherSupportUrl>());
+            SetIfNotEmpty(record, "author", localization.Get<Manifest::Localization::Author>());
+            SetIfNotEmpty(record, "moniker", manifest.Moniker);
+            SetIfNotEmpty(record, "shortDescription", localization.Get<Manifest::Localization::ShortDescription>());
+            SetIfNotEmpty(record, "description", localization.Get<Manifest::Localization::Description>());
+            SetIfNotEmpty(record, "homepage", localization.Get<Manifest::Localization::PackageUrl>());
+            record["license"] = localization.Get<Manifest::Localization::License>();
+            SetIfNotEmpty(record, "licenseUrl", localization.Get<Manifest::Localization::LicenseUrl>());
+            SetIfNotEmpty(record, "privacyUrl", localization.Get<Manifest::Localization::PrivacyUrl>());
+            SetIfNotEmpty(record, "copyright", localization.Get<Manifest::Localization::Copyright>());
+            SetIfNotEmpty(record, "copyrightUrl", localization.Get<Manifest::Localization::CopyrightUrl>());
+            SetIfNotEmpty(record, "releaseNotes", localization.Get<Manifest::Localization::ReleaseNotes>());
+            SetIfNotEmpty(record, "releaseNotesUrl", localization.Get<Manifest::Localization::ReleaseNotesUrl>());
+
+            auto agreements = localization.Get<Manifest::Localization::Agreements>();
+            if (!agreements.empty())
+            {
+                Json::Value& agreementsValue = record["agreements"] = Json::Value{ Json::ValueType::arrayValue };
+                for (const auto& agreement : agreements)
+                {
+                    Json::Value agreementValue{ Json::ValueType::objectValue };
+                    SetIfNotEmpty(agreementValue, "label", agreement.Label);
+                    SetIfNotEmpty(agreementValue, "text", agreement.AgreementText);
+                    SetIfNotEmpty(agreementValue, "url", agreement.AgreementUrl);
+                    agreementsValue.append(std::move(agreementValue));
+                }
+            }
+
+            if (installer)
+            {
+                Json::Value& installerValue = record["installer"] = Json::Value{ Json::ValueType::objectValue };
+                installerValue["type"] = std::string{ Manifest::InstallerTypeToString(installer->InstallerType) };
+                SetIfNotEmpty(installerValue, "locale", installer->Locale);
+                SetIfNotEmpty(installerValue, "url", installer->Url);
+                if (!installer->Sha256.empty())
+                {
+                    installerValue["sha256"] = Utility::SHA256::ConvertToString(installer->Sha256);
+                }
+                SetIfNotEmpty(installerValue, "productId", installer->ProductId);
+                SetIfNotEmpty(installerValue, "releaseDate", installer->ReleaseDate);
+            }
+            else
+            {
+                record["installer"] = Json::Value{ Json::ValueType::nullValue };
+            }
+
+            Execution::JsonRecordOutput output{ context.Reporter, format };
+            output.OutputRecord(record);
+            output.Complete();
+        }
+
+        void ShowVersionRecords(Execution::Context& context, Execution::OutputFormat format, const std::vector<Repository::PackageVersionKey>& versions)
+        {
+            Execution::JsonRecordOutput output{ context.Reporter, format };
+            for (const auto& version : versions)
+            {
+                Json::Value record{ Json::ValueType::objectValue };
+                record["version"] = version.Version;
+                record["channel"] = version.Channel;
+                output.OutputRecord(record);
+            }
+            output.Complete();
+        }
+    }
+
     void ShowManifestInfo(Execution::Context& context)
     {
+        Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+        if (format != Execution::OutputFormat::Table)
+        {
+            ShowManifestInfoRecord(context, format);
+            return;
+        }
+
         context << ShowPackageInfo << ShowInstallerInfo;
     }
 
@@ -197,6 +295,14 @@ namespace AppInstaller::CLI::Workflow
     void ShowManifestVersion(Execution::Context& context)
     {
         const auto& manifest = context.Get<Execution::Data::Manifest>();
+
+        Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+        if (format != Execution::OutputFormat::Table)
+        {
+            ShowVersionRecords(context, format, { Repository::PackageVersionKey{ {}, manifest.Version, manifest.Channel } });
+            return;
+        }
+
         Execution::TableOutput<2> table(context.Reporter, { Resource::String::ShowVersion, Resource::String::ShowChannel });
         table.OutputLine({ manifest.Version, manifest.Channel });
         table.Complete();
@@ -206,6 +312,13 @@ namespace AppInstaller::CLI::Workflow
     {
         auto versions = context.Get<Execution::Data::Package>()->GetAvailableVersionKeys();
 
+        Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+        if (format != Execution::OutputFormat::Table)
+        {
+            ShowVersionRecords(context, format, versions);
+            return;
+        }
+
         Execution::TableOutput<2> table(context.Reporter, { Resource::String::ShowVersion, Resource::String::ShowChannel });
         for (const auto& version : versions)
         {
@@ -192,6 +192,28 @@ namespace AppInstaller::CLI::Workflow
         }
 
         const std::vector<Repository::SourceDetails>& sources = context.Get<Data::SourceList>();
+
+        if (sources.size() > 1)
+        {
+            // Updating all sources together lets them be updated concurrently.
+            Repository::Source source{ std::string_view{} };
+            for (const auto& sd : sources)
+            {
+                context.Reporter.Info() << Resource::String::SourceUpdateOne << ' ' << sd.Name << "..."_liv << std::endl;
+            }
+
+            auto updateFunction = [&](IProgressCallback& progress)->std::vector<Repository::SourceDetails> { return source.Update(progress); };
+            std::vector<Repository::SourceDetails> failedSources = context.Reporter.ExecuteWithProgress(updateFunction);
+
+            for (const auto& sd : sources)
+            {
+                bool failed = std::any_of(failedSources.begin(), failedSources.end(), [&](const Repository::SourceDetails& failed) { return failed.Name == sd.Name; });
+                context.Reporter.Info() << sd.Name << ": "_liv << (failed ? Resource::String::Cancelled : Resource::String::Done) << std::endl;
+            }
+
+            return;
+        }
+
         for (const auto& sd : sources)
         {
             Repository::Source source{ sd.Name };
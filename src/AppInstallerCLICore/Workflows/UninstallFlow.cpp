@@ -5,6 +5,7 @@
 #include "WorkflowBase.h"
 #include "DependenciesFlow.h"
 #include "ShellExecuteInstallerHandler.h"
+#include "MsiInstallFlow.h"
 #include "AppInstallerMsixInfo.h"
 
 #include <AppInstallerDeployment.h>
@@ -50,6 +51,22 @@ namespace AppInstaller::CLI::Workflow
 
             std::vector<Item> Items;
         };
+
+        // Drops the progress of the uninstalls that run alongside the others, as it would be drawn over theirs.
+        struct DiscardProgressSink : public IProgressSink
+        {
+            void OnProgress(uint64_t, uint64_t, ProgressType) override {}
+            void BeginProgress() override {}
+            void EndProgress(bool) override {}
+        };
+
+        // Determines whether the package can be removed alongside the others; MSIX removal does not use the MSI mutex,
+        // while Store packages are left in turn as the Store manages its own queue.
+        bool CanUninstallConcurrently(Execution::Context& context)
+        {
+            const std::string installedTypeString = context.Get<Execution::Data::InstalledPackageVersion>()->GetMetadata()[PackageVersionMetadata::InstalledType];
+            return ConvertToInstallerTypeEnum(installedTypeString) == InstallerTypeEnum::Msix;
+        }
     }
 
     void UninstallSinglePackage(Execution::Context& context)
@@ -65,6 +82,178 @@ namespace AppInstaller::CLI::Workflow
             Workflow::RecordUninstall;
     }
 
+    void UninstallMultiplePackages(Execution::Context& context)
+    {
+        std::vector<std::unique_ptr<Execution::Context>> packageContexts;
+        std::set<std::string> packageIds;
+        HRESULT firstFailure = S_OK;
+
+        auto recordFailure = [&](const Execution::Context& packageContext)
+            {
+                if (SUCCEEDED(firstFailure))
+                {
+                    firstFailure = packageContext.GetTerminationHR();
+                }
+            };
+
+        // Find every package first; they all search the same source, so the installed packages are only read once.
+        std::vector<std::string> queries = *context.Args.GetArgs(Execution::Args::Type::Query);
+        for (const auto& query : queries)
+        {
+            auto packageContextPtr = context.CreateSubContext();
+            Execution::Context& packageContext = *packageContextPtr;
+            auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+            // Each package is found with its own query, and the rest of the arguments.
+            for (auto type : context.Args.GetTypes())
+            {
+                if (type == Execution::Args::Type::Query)
+                {
+                    continue;
+                }
+
+                const auto* values = context.Args.GetArgs(type);
+                if (values->empty())
+                {
+                    packageContext.Args.AddArg(type);
+                }
+
+                for (const auto& value : *values)
+                {
+                    packageContext.Args.AddArg(type, value);
+                }
+            }
+
+            packageContext.Args.AddArg(Execution::Args::Type::Query, query);
+            packageContext.Add<Execution::Data::Source>(context.Get<Execution::Data::Source>());
+
+            packageContext <<
+                Workflow::SearchSourceForSingle <<
+                Workflow::HandleSearchResultFailures <<
+                Workflow::EnsureOneMatchFromSearchResult(true) <<
+                Workflow::GetInstalledPackageVersion <<
+                Workflow::GetUninstallInfo;
+
+            if (packageContext.IsTerminated())
+            {
+                if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
+                {
+                    context.Reporter.Info() << Resource::String::Cancelled << std::endl;
+                    return;
+                }
+
+                recordFailure(packageContext);
+                continue;
+            }
+
+            // Several queries can find the same package, which is only uninstalled once.
+            if (packageIds.emplace(packageContext.Get<Execution::Data::Package>()->GetProperty(PackageProperty::Id)).second)
+            {
+                packageContexts.emplace_back(std::move(packageContextPtr));
+            }
+        }
+
+        struct ConcurrentUninstall
+        {
+            Execution::Context* PackageContext;
+            std::future<void> Completed;
+        };
+
+        std::vector<ConcurrentUninstall> concurrentUninstalls;
+        auto waitForConcurrentUninstalls = wil::scope_exit([&]()
+            {
+                for (auto& uninstall : concurrentUninstalls)
+                {
+                    uninstall.Completed.wait();
+                }
+            });
+
+        size_t packagesCount = packageContexts.size();
+        size_t packagesProgress = 0;
+
+        for (auto& packageContextPtr : packageContexts)
+        {
+            Execution::Context& packageContext = *packageContextPtr;
+            auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+            packagesProgress++;
+            context.Reporter.Info() << "(" << packagesProgress << "/" << packagesCount << ") ";
+            packageContext << Workflow::ReportPackageIdentity;
+
+            if (CanUninstallConcurrently(packageContext))
+            {
+                static DiscardProgressSink s_discardProgress;
+                packageContext.Reporter.SetProgressSink(&s_discardProgress);
+
+                // The uninstall is recorded once it is complete, so that the tracking catalogs are only written from this thread.
+                Execution::Context* uninstallContext = &packageContext;
+                concurrentUninstalls.emplace_back(ConcurrentUninstall{ uninstallContext, std::async(std::launch::async, [uninstallContext]()
+                    {
+                        auto previousThreadGlobals = uninstallContext->SetForCurrentThread();
+
+                        try
+                        {
+                            *uninstallContext <<
+                                Workflow::ReportExecutionStage(ExecutionStage::Execution) <<
+                                Workflow::ExecuteUninstaller;
+                        }
+                        catch (...)
+                        {
+                            uninstallContext->Terminate(Workflow::HandleException(*uninstallContext, std::current_exception()));
+                        }
+                    }) });
+                continue;
+            }
+
+            packageContext <<
+                Workflow::GetDependenciesInfoForUninstall <<
+                Workflow::ReportDependencies(Resource::String::UninstallCommandReportDependencies) <<
+                Workflow::ReportExecutionStage(ExecutionStage::Execution) <<
+                Workflow::ExecuteUninstaller <<
+                Workflow::ReportExecutionStage(ExecutionStage::PostExecution) <<
+                Workflow::RecordUninstall;
+
+            packageContext.Reporter.Info() << std::endl;
+
+            if (packageContext.IsTerminated())
+            {
+                if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
+                {
+                    context.Reporter.Info() << Resource::String::Cancelled << std::endl;
+                    return;
+                }
+
+                recordFailure(packageContext);
+            }
+        }
+
+        waitForConcurrentUninstalls.reset();
+
+        for (auto& uninstall : concurrentUninstalls)
+        {
+            Execution::Context& packageContext = *uninstall.PackageContext;
+            auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+            if (packageContext.IsTerminated())
+            {
+                AICLI_LOG(CLI, Info, << "Concurrent uninstall of [" << packageContext.Get<Execution::Data::Package>()->GetProperty(PackageProperty::Id) <<
+                    "] failed with: " << WINGET_OSTREAM_FORMAT_HRESULT(packageContext.GetTerminationHR()));
+                recordFailure(packageContext);
+                continue;
+            }
+
+            packageContext <<
+                Workflow::ReportExecutionStage(ExecutionStage::PostExecution) <<
+                Workflow::RecordUninstall;
+        }
+
+        if (FAILED(firstFailure))
+        {
+            context.Reporter.Error() << Resource::String::UninstallMultipleHasFailures << std::endl;
+            AICLI_TERMINATE_CONTEXT(firstFailure);
+        }
+    }
+
     void GetUninstallInfo(Execution::Context& context)
     {
         auto installedPackageVersion = context.Get<Execution::Data::InstalledPackageVersion>();
@@ -144,7 +333,15 @@ namespace AppInstaller::CLI::Workflow
             break;
         case InstallerTypeEnum::Msi:
         case InstallerTypeEnum::Wix:
-            context << Workflow::ShellExecuteMsiExecUninstall;
+            // As with installs, use the Windows Installer API directly rather than launching msiexec when allowed to.
+            if (context.Args.Contains(Execution::Args::Type::Silent) || Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::DirectMSI))
+            {
+                context << Workflow::DirectMSIUninstallImpl;
+            }
+            else
+            {
+                context << Workflow::ShellExecuteMsiExecUninstall;
+            }
             break;
         case InstallerTypeEnum::Msix:
         case InstallerTypeEnum::MSStore:
@@ -12,6 +12,14 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void UninstallSinglePackage(Execution::Context& context);
 
+    // Uninstalls the package found for each of the queries.
+    // All of the packages are found before any are uninstalled, so the source, and the installed packages, are only read once.
+    // The packages are uninstalled in turn, except for MSIX packages, which are removed alongside the others.
+    // Required Args: Query
+    // Inputs: Source
+    // Outputs: None
+    void UninstallMultiplePackages(Execution::Context& context);
+
     // Gets the command string or package family names used to uninstall the package.
     // Required Args: None
     // Inputs: InstalledPackageVersion
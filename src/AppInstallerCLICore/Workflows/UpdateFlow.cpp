@@ -4,9 +4,13 @@
 #include "pch.h"
 #include "WorkflowBase.h"
 #include "DependenciesFlow.h"
+#include "DownloadFlow.h"
 #include "InstallFlow.h"
 #include "UpdateFlow.h"
 #include "ManifestComparator.h"
+#include <winget/ThreadGlobals.h>
+
+#include <future>
 
 using namespace AppInstaller::Repository;
 
@@ -14,6 +18,9 @@ namespace AppInstaller::CLI::Workflow
 {
     namespace
     {
+        // The maximum number of packages to check for an applicable update at once; each may download manifests from a remote source.
+        constexpr size_t s_MaxConcurrentApplicabilityChecks = 8;
+
         bool IsUpdateVersionApplicable(const Utility::Version& installedVersion, const Utility::Version& updateVersion)
         {
             return (installedVersion < updateVersion || updateVersion.IsLatest());
@@ -33,6 +40,121 @@ namespace AppInstaller::CLI::Workflow
 
             packagesToInstall.emplace_back(std::move(packageContext));
         }
+
+        // Gets the installed packages in the search results that have an upgrade available, including those with an unknown version.
+        std::vector<UpgradeSnapshot::Entry> GetUpgradeSnapshotEntries(const SearchResult& searchResult)
+        {
+            std::vector<UpgradeSnapshot::Entry> result;
+
+            for (const auto& match : searchResult.Matches)
+            {
+                auto installedVersion = match.Package->GetInstalledVersion();
+                if (!installedVersion || !match.Package->IsUpdateAvailable())
+                {
+                    continue;
+                }
+
+                auto latestVersion = match.Package->GetLatestAvailableVersion();
+                if (!latestVersion)
+                {
+                    continue;
+                }
+
+                UpgradeSnapshot::Entry entry;
+                entry.Name = match.Package->GetProperty(PackageProperty::Name);
+                entry.Id = match.Package->GetProperty(PackageProperty::Id);
+                entry.InstalledVersion = installedVersion->GetProperty(PackageVersionProperty::Version);
+                entry.AvailableVersion = latestVersion->GetProperty(PackageVersionProperty::Version);
+                entry.SourceName = latestVersion->GetProperty(PackageVersionProperty::SourceName);
+                result.emplace_back(std::move(entry));
+            }
+
+            return result;
+        }
+
+        // Only a complete list can be reused.
+        bool CanSaveUpgradeSnapshot(const SearchResult& searchResult)
+        {
+            return !searchResult.Truncated && searchResult.Failures.empty();
+        }
+
+        // Finds the applicable update of each package, a number of packages at a time.
+        // Each context is only used by the thread that checks it, with its own thread globals.
+        void SelectApplicableUpdates(const std::vector<std::unique_ptr<Execution::Context>>& updateContexts)
+        {
+            if (updateContexts.empty())
+            {
+                return;
+            }
+
+            std::atomic<size_t> nextContext = 0;
+
+            auto selectUpdates = [&]()
+            {
+                for (size_t i = nextContext++; i < updateContexts.size(); i = nextContext++)
+                {
+                    Execution::Context& updateContext = *updateContexts[i];
+                    auto previousThreadGlobals = updateContext.SetForCurrentThread();
+
+                    try
+                    {
+                        updateContext <<
+                            Workflow::GetInstalledPackageVersion <<
+                            Workflow::ReportExecutionStage(ExecutionStage::Discovery) <<
+                            SelectLatestApplicableUpdate(false);
+                    }
+                    catch (...)
+                    {
+                        // Stop the other workers from starting on more packages, as a failure ends the whole command.
+                        nextContext = updateContexts.size();
+                        throw;
+                    }
+                }
+            };
+
+            size_t workerCount = std::min(s_MaxConcurrentApplicabilityChecks, updateContexts.size()) - 1;
+            AICLI_LOG(CLI, Info, << "Checking " << updateContexts.size() << " packages for an applicable update with " << (workerCount + 1) << " concurrent checks");
+
+            std::vector<std::future<void>> workers;
+            workers.reserve(workerCount);
+
+            for (size_t i = 0; i < workerCount; ++i)
+            {
+                workers.emplace_back(std::async(std::launch::async, selectUpdates));
+            }
+
+            // Use the calling thread as well rather than leaving it idle.
+            std::exception_ptr failure;
+            try
+            {
+                selectUpdates();
+            }
+            catch (...)
+            {
+                failure = std::current_exception();
+            }
+
+            // Every worker must complete before returning, as they use the contexts.
+            for (auto& worker : workers)
+            {
+                try
+                {
+                    worker.get();
+                }
+                catch (...)
+                {
+                    if (!failure)
+                    {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
     }
 
     void SelectLatestApplicableUpdate::operator()(Execution::Context& context) const
@@ -54,6 +176,18 @@ namespace AppInstaller::CLI::Workflow
                 if (IsUpdateVersionApplicable(installedVersion, Utility::Version(key.Version)))
                 {
                     auto packageVersion = package->GetAvailableVersion(key);
+
+                    // When the index summarizes the installers, a version that cannot apply is skipped without getting its manifest.
+                    // An installer ruled out only by its installed type is still checked with the manifest, as whether that is the
+                    // only reason depends on the fields that are not in the summary.
+                    auto summaryInapplicabilities = manifestComparator.GetSummaryInapplicabilities(packageVersion->GetMetadata());
+                    if (summaryInapplicabilities &&
+                        std::find(summaryInapplicabilities->begin(), summaryInapplicabilities->end(), InapplicabilityFlags::InstalledType) == summaryInapplicabilities->end())
+                    {
+                        AICLI_LOG(CLI, Info, << "Skipping version " << key.Version << " as the index shows that none of its installers are applicable");
+                        continue;
+                    }
+
                     auto manifest = packageVersion->GetManifest();
 
                     // Check applicable Installer
@@ -145,16 +279,23 @@ namespace AppInstaller::CLI::Workflow
         bool updateAllFoundUpdate = false;
         int unknownPackagesCount = 0;
 
+        // Installer selection reads the same settings and system values for every package, so only read them once.
+        auto comparatorOptions = std::make_shared<const ManifestComparatorOptions>(ManifestComparatorOptions::Create());
+
+        // The contexts are created here rather than on the workers, as creating them touches the parent.
+        std::vector<std::unique_ptr<Execution::Context>> updateContexts;
+        updateContexts.reserve(matches.size());
+
         for (const auto& match : matches)
         {
             // We want to do best effort to update all applicable updates regardless on previous update failure
             auto updateContextPtr = context.CreateSubContext();
             Execution::Context& updateContext = *updateContextPtr;
-            auto previousThreadGlobals = updateContext.SetForCurrentThread();
             auto installedVersion = match.Package->GetInstalledVersion();
 
             updateContext.Add<Execution::Data::Package>(match.Package);
-            
+            updateContext.Add<Execution::Data::ManifestComparatorOptions>(comparatorOptions);
+
             if (context.Args.Contains(Execution::Args::Type::IncludeUnknown))
             {
                 updateContext.Args.AddArg(Execution::Args::Type::IncludeUnknown);
@@ -166,12 +307,15 @@ namespace AppInstaller::CLI::Workflow
                 continue;
             }
 
-            updateContext <<
-                Workflow::GetInstalledPackageVersion <<
-                Workflow::ReportExecutionStage(ExecutionStage::Discovery) <<
-                SelectLatestApplicableUpdate(false);
+            updateContexts.emplace_back(std::move(updateContextPtr));
+        }
+
+        SelectApplicableUpdates(updateContexts);
 
-            if (updateContext.GetTerminationHR() == APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE)
+        // Assembled in the order of the matches, regardless of the order that the checks completed in.
+        for (auto& updateContextPtr : updateContexts)
+        {
+            if (updateContextPtr->GetTerminationHR() == APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE)
             {
                 continue;
             }
@@ -185,6 +329,13 @@ namespace AppInstaller::CLI::Workflow
         {
             context.Add<Execution::Data::PackagesToInstall>(std::move(packagesToInstall));
             context.Reporter.Info() << std::endl;
+
+            if (context.Args.Contains(Execution::Args::Type::Prefetch))
+            {
+                context << DownloadInstallersForLater;
+                return;
+            }
+
             context <<
                 InstallMultiplePackages(
                     Resource::String::InstallAndUpgradeCommandsReportDependencies,
@@ -192,4 +343,131 @@ namespace AppInstaller::CLI::Workflow
                     { APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE });
         }
     }
+
+    bool TryReportUpgradeSnapshot(Execution::Context& context)
+    {
+        if (!Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::UpgradeSnapshot))
+        {
+            return false;
+        }
+
+        // The fingerprints are taken before anything is read, so that a change made while the list is computed is seen next time.
+        UpgradeSnapshot current;
+        current.SourcesFingerprint = UpgradeSnapshot::GetSourcesFingerprint(context.Get<Execution::Data::Source>());
+        if (current.SourcesFingerprint.empty())
+        {
+            return false;
+        }
+
+        current.InstalledFingerprint = UpgradeSnapshot::GetInstalledFingerprint();
+        if (current.InstalledFingerprint.empty())
+        {
+            return false;
+        }
+
+        auto snapshot = UpgradeSnapshot::Load();
+        if (!snapshot || !snapshot->IsCurrent(current.InstalledFingerprint, current.SourcesFingerprint))
+        {
+            context.Add<Execution::Data::UpgradeSnapshot>(std::move(current));
+            return false;
+        }
+
+        AICLI_LOG(CLI, Info, << "Listing " << snapshot->Entries.size() << " available upgrades from the upgrade snapshot");
+
+        bool includeUnknown = context.Args.Contains(Execution::Args::Type::IncludeUnknown);
+        std::vector<ListResultRow> rows;
+        int unknownPackagesCount = 0;
+
+        for (auto& entry : snapshot->Entries)
+        {
+            if (!includeUnknown && Utility::Version(entry.InstalledVersion).IsUnknown())
+            {
+                unknownPackagesCount++;
+                continue;
+            }
+
+            ListResultRow row;
+            row.Name = Utility::LocIndString{ std::move(entry.Name) };
+            row.Id = Utility::LocIndString{ std::move(entry.Id) };
+            row.InstalledVersion = Utility::LocIndString{ std::move(entry.InstalledVersion) };
+            row.AvailableVersion = Utility::LocIndString{ std::move(entry.AvailableVersion) };
+            row.SourceName = Utility::LocIndString{ std::move(entry.SourceName) };
+            rows.emplace_back(std::move(row));
+        }
+
+        ReportListRows(context, rows, true, false, unknownPackagesCount);
+        return true;
+    }
+
+    void SaveUpgradeSnapshot(Execution::Context& context)
+    {
+        if (!context.Contains(Execution::Data::UpgradeSnapshot))
+        {
+            return;
+        }
+
+        const auto& searchResult = context.Get<Execution::Data::SearchResult>();
+        if (!CanSaveUpgradeSnapshot(searchResult))
+        {
+            return;
+        }
+
+        UpgradeSnapshot& snapshot = context.Get<Execution::Data::UpgradeSnapshot>();
+        snapshot.Entries = GetUpgradeSnapshotEntries(searchResult);
+        snapshot.Save();
+    }
+
+    void UpdateUpgradeSnapshot(Execution::Context& context) try
+    {
+        if (!Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::UpgradeSnapshot))
+        {
+            return;
+        }
+
+        auto computeFunction = [&](IProgressCallback& progress)
+        {
+            Source availableSource{ std::string_view{} };
+            if (!availableSource)
+            {
+                return;
+            }
+
+            availableSource.Open(progress);
+
+            UpgradeSnapshot snapshot;
+            snapshot.SourcesFingerprint = UpgradeSnapshot::GetSourcesFingerprint(availableSource);
+            if (snapshot.SourcesFingerprint.empty() || progress.IsCancelled())
+            {
+                return;
+            }
+
+            snapshot.InstalledFingerprint = UpgradeSnapshot::GetInstalledFingerprint();
+            if (snapshot.InstalledFingerprint.empty())
+            {
+                return;
+            }
+
+            Source installedSource{ PredefinedSource::Installed };
+            installedSource.Open(progress);
+
+            SearchResult searchResult = Source{ installedSource, availableSource }.Search({});
+            if (!CanSaveUpgradeSnapshot(searchResult) || progress.IsCancelled())
+            {
+                return;
+            }
+
+            snapshot.Entries = GetUpgradeSnapshotEntries(searchResult);
+            snapshot.Save();
+
+            AICLI_LOG(CLI, Info, << "Stored an upgrade snapshot of " << snapshot.Entries.size() << " available upgrades");
+        };
+
+        context.Reporter.ExecuteWithProgress(computeFunction, true);
+    }
+    catch (...)
+    {
+        // The snapshot is only an optimization; the update itself has already succeeded.
+        LOG_CAUGHT_EXCEPTION();
+        AICLI_LOG(CLI, Warning, << "Failed to compute the upgrade snapshot");
+    }
 }
@@ -32,4 +32,25 @@ namespace AppInstaller::CLI::Workflow
     // Inputs: SearchResult
     // Outputs: None
     void UpdateAllApplicable(Execution::Context& context);
+
+    // Reports the list of available upgrades from the stored snapshot, if the snapshot is enabled and still current.
+    // Returns true if the list was reported. Otherwise, the fingerprints that the list is about to be computed from are output
+    // so that SaveUpgradeSnapshot can store the list with them.
+    // Required Args: None
+    // Inputs: Source
+    // Outputs: UpgradeSnapshot?
+    bool TryReportUpgradeSnapshot(Execution::Context& context);
+
+    // Stores the available upgrades in the search results as the snapshot for the fingerprints found by TryReportUpgradeSnapshot.
+    // Required Args: None
+    // Inputs: SearchResult, UpgradeSnapshot?
+    // Outputs: None
+    void SaveUpgradeSnapshot(Execution::Context& context);
+
+    // Computes the available upgrades from all of the sources and stores them as the snapshot, if the snapshot is enabled.
+    // Used after a source update, which is when the stored snapshot stops being current.
+    // Required Args: None
+    // Inputs: None
+    // Outputs: None
+    void UpdateUpgradeSnapshot(Execution::Context& context);
 }
\ No newline at end of file
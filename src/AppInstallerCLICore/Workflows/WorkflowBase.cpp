@@ -2,10 +2,13 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "WorkflowBase.h"
+#include "EarlySourceOpen.h"
 #include "ExecutionContext.h"
+#include "JsonOutput.h"
 #include "ManifestComparator.h"
 #include "TableOutput.h"
 #include <winget/ManifestYamlParser.h>
+#include <winget/Performance.h>
 
 
 namespace AppInstaller::CLI::Workflow
@@ -31,6 +34,30 @@ namespace AppInstaller::CLI::Workflow
             }
         }
 
+        // Writes the search result as records, with the match criteria as separate values rather than a descriptor.
+        void ReportSearchResultRecords(Execution::Context& context, Execution::OutputFormat format)
+        {
+            auto& searchResult = context.Get<Execution::Data::SearchResult>();
+            Execution::JsonRecordOutput output{ context.Reporter, format };
+
+            for (const auto& match : searchResult.Matches)
+            {
+                auto latestVersion = match.Package->GetLatestAvailableVersion();
+
+                Json::Value record{ Json::ValueType::objectValue };
+                record["name"] = latestVersion->GetProperty(PackageVersionProperty::Name).get();
+                record["id"] = latestVersion->GetProperty(PackageVersionProperty::Id).get();
+                record["version"] = latestVersion->GetProperty(PackageVersionProperty::Version).get();
+                record["source"] = latestVersion->GetProperty(PackageVersionProperty::SourceName).get();
+                record["matchField"] = std::string{ ToString(match.MatchCriteria.Field) };
+                record["matchValue"] = match.MatchCriteria.Value;
+
+                output.OutputRecord(record);
+            }
+
+            output.Complete();
+        }
+
         void ReportIdentity(Execution::Context& context, std::string_view name, std::string_view id)
         {
             context.Reporter.Info() << Resource::String::ReportIdentityFound << ' ' << Execution::NameEmphasis << name << " [" << Execution::IdEmphasis << id << ']' << std::endl;
@@ -45,6 +72,27 @@ namespace AppInstaller::CLI::Workflow
         {
             Repository::Source source;
 
+            // The default sources may have been opened while the arguments were processed.
+            if (sourceName.empty() && !context.Args.Contains(Execution::Args::Type::CustomHeader) && context.Contains(Execution::Data::EarlySourceOpen))
+            {
+                std::vector<SourceDetails> updateFailures;
+                source = context.Get<Execution::Data::EarlySourceOpen>()->TakeDefaultSources(context, updateFailures);
+
+                if (source)
+                {
+                    for (const auto& s : updateFailures)
+                    {
+                        context.Reporter.Warn() << Resource::String::SourceOpenWithFailedUpdate << ' ' << s.Name << std::endl;
+                    }
+
+                    return source;
+                }
+                else if (context.IsTerminated())
+                {
+                    return {};
+                }
+            }
+
             try
             {
                 source = Source{ sourceName };
@@ -361,20 +409,34 @@ namespace AppInstaller::CLI::Workflow
     void OpenPredefinedSource::operator()(Execution::Context& context) const
     {
         Repository::Source source;
-        try
-        {
-            source = Source{ m_predefinedSource };
 
-            // A well known predefined source should return a value.
-            THROW_HR_IF(E_UNEXPECTED, !source);
-
-            auto openFunction = [&](IProgressCallback& progress)->std::vector<Repository::SourceDetails> { return source.Open(progress); };
-            context.Reporter.ExecuteWithProgress(openFunction, true);
+        // The source may have been opened while the arguments were processed.
+        if (context.Contains(Execution::Data::EarlySourceOpen))
+        {
+            source = context.Get<Execution::Data::EarlySourceOpen>()->TakePredefinedSource(context, m_predefinedSource);
+            if (context.IsTerminated())
+            {
+                return;
+            }
         }
-        catch (...)
+
+        if (!source)
         {
-            context.Reporter.Error() << Resource::String::SourceOpenPredefinedFailedSuggestion << std::endl;
-            throw;
+            try
+            {
+                source = Source{ m_predefinedSource };
+
+                // A well known predefined source should return a value.
+                THROW_HR_IF(E_UNEXPECTED, !source);
+
+                auto openFunction = [&](IProgressCallback& progress)->std::vector<Repository::SourceDetails> { return source.Open(progress); };
+                context.Reporter.ExecuteWithProgress(openFunction, true);
+            }
+            catch (...)
+            {
+                context.Reporter.Error() << Resource::String::SourceOpenPredefinedFailedSuggestion << std::endl;
+                throw;
+            }
         }
 
         if (m_forDependencies)
@@ -543,6 +605,13 @@ namespace AppInstaller::CLI::Workflow
 
     void ReportSearchResult(Execution::Context& context)
     {
+        Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+        if (format != Execution::OutputFormat::Table)
+        {
+            ReportSearchResultRecords(context, format);
+            return;
+        }
+
         auto& searchResult = context.Get<Execution::Data::SearchResult>();
 
         bool sourceIsComposite = context.Get<Execution::Data::Source>().IsComposite();
@@ -693,9 +762,29 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
-    void ReportListResult::operator()(Execution::Context& context) const
+    void ReportListRows(Execution::Context& context, const std::vector<ListResultRow>& rows, bool onlyShowUpgrades, bool truncated, int unknownPackagesCount)
     {
-        auto& searchResult = context.Get<Execution::Data::SearchResult>();
+        // The summary lines are only for the table.
+        Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+        if (format != Execution::OutputFormat::Table)
+        {
+            Execution::JsonRecordOutput records{ context.Reporter, format };
+
+            for (const auto& row : rows)
+            {
+                Json::Value record{ Json::ValueType::objectValue };
+                record["name"] = row.Name.get();
+                record["id"] = row.Id.get();
+                record["installedVersion"] = row.InstalledVersion.get();
+                record["availableVersion"] = (row.AvailableVersion.empty() ? Json::Value{ Json::ValueType::nullValue } : Json::Value{ row.AvailableVersion.get() });
+                record["source"] = row.SourceName.get();
+
+                records.OutputRecord(record);
+            }
+
+            records.Complete();
+            return;
+        }
 
         Execution::TableOutput<5> table(context.Reporter,
             {
@@ -707,10 +796,56 @@ namespace AppInstaller::CLI::Workflow
             });
 
         int availableUpgradesCount = 0;
-        int unknownPackagesCount = 0;
         auto &source = context.Get<Execution::Data::Source>();
         bool shouldShowSource = source.IsComposite() && source.GetAvailableSources().size() > 1;
 
+        for (const auto& row : rows)
+        {
+            if (!row.AvailableVersion.empty())
+            {
+                availableUpgradesCount++;
+            }
+
+            table.OutputLine({
+                row.Name,
+                row.Id,
+                row.InstalledVersion,
+                row.AvailableVersion,
+                shouldShowSource ? row.SourceName : ""s
+                });
+        }
+
+        table.Complete();
+
+        if (table.IsEmpty())
+        {
+            context.Reporter.Info() << Resource::String::NoInstalledPackageFound << std::endl;
+        }
+        else
+        {
+            if (truncated)
+            {
+                context.Reporter.Info() << '<' << Resource::String::SearchTruncated << '>' << std::endl;
+            }
+
+            if (onlyShowUpgrades)
+            {
+                context.Reporter.Info() << availableUpgradesCount << ' ' << Resource::String::AvailableUpgrades << std::endl;
+            }
+        }
+        if (onlyShowUpgrades && unknownPackagesCount > 0 && !context.Args.Contains(Execution::Args::Type::IncludeUnknown))
+        {
+            context.Reporter.Info() << unknownPackagesCount << " " << (unknownPackagesCount == 1 ? Resource::String::UpgradeUnknownCountSingle : Resource::String::UpgradeUnknownCount) << std::endl;
+        }
+    }
+
+    void ReportListResult::operator()(Execution::Context& context) const
+    {
+        auto& searchResult = context.Get<Execution::Data::SearchResult>();
+
+        std::vector<ListResultRow> rows;
+        int unknownPackagesCount = 0;
+
         for (const auto& match : searchResult.Matches)
         {
             auto installedVersion = match.Package->GetInstalledVersion();
@@ -730,54 +865,28 @@ namespace AppInstaller::CLI::Workflow
                 // The only time we don't want to output a line is when filtering and no update is available.
                 if (updateAvailable || !m_onlyShowUpgrades)
                 {
-                    Utility::LocIndString availableVersion, sourceName;
+                    ListResultRow row;
+                    row.Name = match.Package->GetProperty(PackageProperty::Name);
+                    row.Id = match.Package->GetProperty(PackageProperty::Id);
+                    row.InstalledVersion = installedVersion->GetProperty(PackageVersionProperty::Version);
 
                     if (latestVersion)
                     {
                         if (updateAvailable)
                         {
-                            availableVersion = latestVersion->GetProperty(PackageVersionProperty::Version);
-                            availableUpgradesCount++;
+                            row.AvailableVersion = latestVersion->GetProperty(PackageVersionProperty::Version);
                         }
 
                         // Always show the source for correlated packages
-                        sourceName = latestVersion->GetProperty(PackageVersionProperty::SourceName);
+                        row.SourceName = latestVersion->GetProperty(PackageVersionProperty::SourceName);
                     }
 
-                    table.OutputLine({
-                        match.Package->GetProperty(PackageProperty::Name),
-                        match.Package->GetProperty(PackageProperty::Id),
-                        installedVersion->GetProperty(PackageVersionProperty::Version),
-                        availableVersion,
-                        shouldShowSource ? sourceName : ""s
-                        });
+                    rows.emplace_back(std::move(row));
                 }
             }
         }
 
-        table.Complete();
-
-        if (table.IsEmpty())
-        {
-            context.Reporter.Info() << Resource::String::NoInstalledPackageFound << std::endl;
-        }
-        else
-        {
-            if (searchResult.Truncated)
-            {
-                context.Reporter.Info() << '<' << Resource::String::SearchTruncated << '>' << std::endl;
-            }
-
-            if (m_onlyShowUpgrades)
-            {
-                context.Reporter.Info() << availableUpgradesCount << ' ' << Resource::String::AvailableUpgrades << std::endl;
-            }
-        }
-        if (m_onlyShowUpgrades && unknownPackagesCount > 0 && !context.Args.Contains(Execution::Args::Type::IncludeUnknown))
-        {
-            context.Reporter.Info() << unknownPackagesCount << " " << (unknownPackagesCount == 1 ? Resource::String::UpgradeUnknownCountSingle : Resource::String::UpgradeUnknownCount) << std::endl;
-        }
-
+        ReportListRows(context, rows, m_onlyShowUpgrades, searchResult.Truncated, unknownPackagesCount);
     }
 
     void EnsureMatchesFromSearchResult::operator()(Execution::Context& context) const
@@ -1141,6 +1250,7 @@ AppInstaller::CLI::Execution::Context& operator<<(AppInstaller::CLI::Execution::
         if (context.ShouldExecuteWorkflowTask(task))
 #endif
         {
+            AppInstaller::Performance::ScopedTimer timer{ task.GetName(), task.IsFunction() ? reinterpret_cast<const void*>(task.GetFunction()) : nullptr };
             task(context);
         }
     }
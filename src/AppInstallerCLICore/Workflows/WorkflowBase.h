@@ -50,6 +50,10 @@ namespace AppInstaller::CLI::Workflow
 
         const std::string& GetName() const { return m_name; }
 
+        bool IsFunction() const { return m_isFunc; }
+
+        Func GetFunction() const { return m_func; }
+
     private:
         bool m_isFunc = false;
         Func m_func = nullptr;
@@ -163,6 +167,23 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void ReportSearchResult(Execution::Context& context);
 
+    // A line of the output of the list command.
+    struct ListResultRow
+    {
+        Utility::LocIndString Name;
+        Utility::LocIndString Id;
+        Utility::LocIndString InstalledVersion;
+        // Empty if no upgrade is available.
+        Utility::LocIndString AvailableVersion;
+        Utility::LocIndString SourceName;
+    };
+
+    // Outputs the given lines as the list command would show them; onlyShowUpgrades includes the upgrade summary lines.
+    // Required Args: None
+    // Inputs: Source
+    // Outputs: None
+    void ReportListRows(Execution::Context& context, const std::vector<ListResultRow>& rows, bool onlyShowUpgrades, bool truncated = false, int unknownPackagesCount = 0);
+
     // Outputs the search results as the list command would show.
     // Required Args: None
     // Inputs: SearchResult
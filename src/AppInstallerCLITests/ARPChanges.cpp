@@ -101,6 +101,9 @@ struct TestContext : public Context
         // Inject our source
         TestHook_SetSourceFactoryOverride(std::string{ Repository::Microsoft::PredefinedInstalledSourceFactory::Type() }, SourceFactory);
 
+        // Use the full snapshot by default, as the ARP keys of the system do not reflect our source
+        TestHook_SetARPKeySnapshotOverride([]() { return std::optional<ARPKeySnapshot>{}; });
+
         Source = std::make_shared<TestSource>();
         Source->SearchFunction = [&](const SearchRequest& request)
         {
@@ -118,6 +121,7 @@ struct TestContext : public Context
     ~TestContext()
     {
         TestHook_ClearSourceFactoryOverrides();
+        TestHook_SetARPKeySnapshotOverride({});
         TestHook_SetTelemetryOverride({});
     }
 
@@ -423,3 +427,59 @@ TEST_CASE("ARPChanges_MultiChange_MultiMatch_MultiOverlap", "[ARPChanges][workfl
     context << ReportARPChanges;
     context.ExpectEvent(2, 2, 2);
 }
+
+TEST_CASE("ARPChanges_KeySnapshot_OnlyChangedEntriesRead", "[ARPChanges][workflow]")
+{
+    TestContext context;
+
+    auto now = std::chrono::system_clock::now();
+
+    ARPKeySnapshot::Entries before;
+    before[{ "Machine|X64", "Id1" }] = now;
+    before[{ "Machine|X64", "Id2" }] = now;
+
+    ARPKeySnapshot::Entries after = before;
+    after[{ "Machine|X64", "Id2" }] = now + std::chrono::seconds(1);
+    after[{ "User|X64", "EverythingId1" }] = now;
+
+    std::vector<ARPKeySnapshot> snapshots{ ARPKeySnapshot{ before }, ARPKeySnapshot{ after } };
+    size_t snapshotIndex = 0;
+    TestHook_SetARPKeySnapshotOverride([&]() { return std::optional<ARPKeySnapshot>{ snapshots.at(snapshotIndex++) }; });
+
+    context << SnapshotARPEntries;
+    REQUIRE(context.Contains(Data::ARPKeySnapshot));
+    REQUIRE(!context.Contains(Data::ARPSnapshot));
+
+    context.AddEverythingResult("EverythingId1", "EverythingName1", "EverythingPublisher1", "EverythingVersion1");
+
+    std::vector<std::string> requestedProductCodes;
+    context.Source->SearchFunction = [&](const SearchRequest& request)
+    {
+        REQUIRE(!request.IsForEverything());
+
+        SearchResult result;
+        for (const auto& inclusion : request.Inclusions)
+        {
+            if (inclusion.Field != PackageMatchField::ProductCode)
+            {
+                continue;
+            }
+
+            requestedProductCodes.emplace_back(inclusion.Value);
+
+            for (const auto& match : context.EverythingResult.Matches)
+            {
+                if (match.Package->GetProperty(PackageProperty::Id).get() == inclusion.Value)
+                {
+                    result.Matches.emplace_back(match);
+                }
+            }
+        }
+        return result;
+    };
+
+    context << ReportARPChanges;
+
+    REQUIRE(requestedProductCodes == std::vector<std::string>{ "EverythingId1", "Id2" });
+    context.ExpectEvent(2, 0, 0);
+}
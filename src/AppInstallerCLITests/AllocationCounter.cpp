@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new of the test process to count allocations for the budget tests; the array and
+// nothrow forms are implemented by the runtime in terms of these. Only the count is kept, so the cost is one atomic increment.
+namespace
+{
+    std::atomic_size_t s_allocationCount{ 0 };
+}
+
+void* operator new(size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* result = std::malloc(size ? size : 1))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace TestCommon
+{
+    size_t GetAllocationCount()
+    {
+        return s_allocationCount.load(std::memory_order_relaxed);
+    }
+}
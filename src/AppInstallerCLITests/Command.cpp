@@ -498,3 +498,28 @@ TEST_CASE("ParseArguments_UnknownName", "[command]")
 
     REQUIRE_COMMAND_EXCEPTION(command.ParseArguments(inv, args), values[1]);
 }
+
+TEST_CASE("PreloadedResourceStrings_AreCached", "[command]")
+{
+    RootCommand root;
+
+    for (const auto& command : root.GetCommands())
+    {
+        auto strings = command->PreloadedResourceStrings();
+        if (strings.empty())
+        {
+            continue;
+        }
+
+        INFO(GetCommandName(command));
+        Resource::Loader::PreloadStrings(strings).get();
+
+        for (const auto& id : strings)
+        {
+            // The preloaded value is the one that output gets
+            std::string value = Resource::Loader::Instance().ResolveString(id);
+            REQUIRE(!value.empty());
+            REQUIRE(value == Resource::LocString{ id }.get());
+        }
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <AppInstallerErrors.h>
+#include <winget/CompletionIndex.h>
+
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Utility;
+
+namespace
+{
+    std::vector<CompletionIndex::Package> CreateTestPackages()
+    {
+        std::vector<CompletionIndex::Package> result;
+
+        CompletionIndex::Package& first = result.emplace_back();
+        first.Id = "Contoso.Editor";
+        first.Name = "Contoso Editor";
+        first.Moniker = "editor";
+        first.Versions.emplace_back(Version{ "2.0" }, Channel{ "" });
+        first.Versions.emplace_back(Version{ "1.5" }, Channel{ "beta" });
+        first.Versions.emplace_back(Version{ "1.0" }, Channel{ "" });
+
+        CompletionIndex::Package& second = result.emplace_back();
+        second.Id = "Contoso.Terminal";
+        second.Name = "Terminal";
+        second.Versions.emplace_back(Version{ "3.1" }, Channel{ "" });
+
+        CompletionIndex::Package& third = result.emplace_back();
+        third.Id = "Fabrikam.Editor";
+        third.Name = "Fabrikam Editor";
+        third.Moniker = "fabedit";
+        third.Versions.emplace_back(Version{ "10" }, Channel{ "" });
+
+        return result;
+    }
+}
+
+TEST_CASE("CompletionIndex_Complete", "[completionindex]")
+{
+    TempFile indexFile{ "completion", ".idx" };
+    CompletionIndex::Create(indexFile, CreateTestPackages());
+
+    CompletionIndex index{ indexFile.GetPath() };
+
+    auto ids = index.Complete(PackageMatchField::Id, "contoso.");
+    REQUIRE(ids == std::vector<std::string>{ "Contoso.Editor", "Contoso.Terminal" });
+
+    auto names = index.Complete(PackageMatchField::Name, "CONTOSO");
+    REQUIRE(names == std::vector<std::string>{ "Contoso Editor" });
+
+    auto monikers = index.Complete(PackageMatchField::Moniker, "");
+    REQUIRE(monikers == std::vector<std::string>{ "editor", "fabedit" });
+
+    REQUIRE(index.Complete(PackageMatchField::Id, "Wingtip").empty());
+    REQUIRE_THROWS_HR(index.Complete(PackageMatchField::Tag, "c"), E_INVALIDARG);
+}
+
+TEST_CASE("CompletionIndex_FindPackagesAndVersions", "[completionindex]")
+{
+    TempFile indexFile{ "completion", ".idx" };
+    CompletionIndex::Create(indexFile, CreateTestPackages());
+
+    CompletionIndex index{ indexFile.GetPath() };
+
+    // Only an equal value matches, not a prefix.
+    REQUIRE(index.FindPackages("Contoso", { PackageMatchField::Id, PackageMatchField::Name }).empty());
+
+    auto editor = index.FindPackages("EDITOR", { PackageMatchField::Id, PackageMatchField::Name, PackageMatchField::Moniker });
+    REQUIRE(editor.size() == 1);
+    REQUIRE(index.FindPackages("editor", { PackageMatchField::Id }).empty());
+
+    auto versions = index.GetVersions(editor[0]);
+    REQUIRE(versions.size() == 3);
+    REQUIRE(versions[0].GetVersion().ToString() == "2.0");
+    REQUIRE(versions[1].GetVersion().ToString() == "1.5");
+    REQUIRE(versions[1].GetChannel().ToString() == "beta");
+    REQUIRE(versions[2].GetVersion().ToString() == "1.0");
+
+    auto terminal = index.FindPackages("contoso.terminal", { PackageMatchField::Id });
+    REQUIRE(terminal.size() == 1);
+    REQUIRE(index.GetVersions(terminal[0]).size() == 1);
+}
+
+TEST_CASE("CompletionIndex_Replace", "[completionindex]")
+{
+    TempFile indexFile{ "completion", ".idx" };
+    CompletionIndex::Create(indexFile, CreateTestPackages());
+
+    {
+        CompletionIndex index{ indexFile.GetPath() };
+        REQUIRE(index.Complete(PackageMatchField::Id, "").size() == 3);
+    }
+
+    std::vector<CompletionIndex::Package> packages;
+    packages.emplace_back().Id = "Wingtip.Tool";
+    CompletionIndex::Create(indexFile, packages);
+
+    CompletionIndex index{ indexFile.GetPath() };
+    REQUIRE(index.Complete(PackageMatchField::Id, "") == std::vector<std::string>{ "Wingtip.Tool" });
+}
+
+TEST_CASE("CompletionIndex_Invalid", "[completionindex]")
+{
+    TempFile indexFile{ "completion", ".idx" };
+
+    {
+        std::ofstream stream{ indexFile.GetPath(), std::ios::binary };
+        stream << "This is not a completion index, but it is long enough to have a header.";
+    }
+
+    REQUIRE_THROWS_HR(CompletionIndex{ indexFile.GetPath() }, APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+}
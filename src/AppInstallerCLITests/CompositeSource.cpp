@@ -10,6 +10,7 @@
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
+using namespace std::chrono_literals;
 using namespace TestCommon;
 using namespace AppInstaller;
 using namespace AppInstaller::Repository;
@@ -727,6 +728,107 @@ TEST_CASE("CompositeSource_AvailableSearchFailure", "[CompositeSource]")
     REQUIRE(searchFailure == expectedHR);
 }
 
+TEST_CASE("CompositeSource_AvailableSearchIsParallel", "[CompositeSource]")
+{
+    std::string firstName = "Name1";
+    std::string secondName = "Name2";
+
+    // Each search waits for the other to begin; this can only complete quickly if they run at the same time.
+    std::promise<void> firstStarted;
+    std::promise<void> secondStarted;
+    std::shared_future<void> firstStartedFuture = firstStarted.get_future().share();
+    std::shared_future<void> secondStartedFuture = secondStarted.get_future().share();
+    std::atomic<bool> overlapped = true;
+
+    std::shared_ptr<ComponentTestSource> firstAvailable = std::make_shared<ComponentTestSource>();
+    firstAvailable->SearchFunction = [&](const SearchRequest&)
+    {
+        firstStarted.set_value();
+        if (secondStartedFuture.wait_for(5s) != std::future_status::ready)
+        {
+            overlapped = false;
+        }
+
+        SearchResult result;
+        result.Matches.emplace_back(MakeAvailable().WithDefaultName(firstName), Criteria());
+        return result;
+    };
+
+    std::shared_ptr<ComponentTestSource> secondAvailable = std::make_shared<ComponentTestSource>();
+    secondAvailable->SearchFunction = [&](const SearchRequest&)
+    {
+        secondStarted.set_value();
+        if (firstStartedFuture.wait_for(5s) != std::future_status::ready)
+        {
+            overlapped = false;
+        }
+
+        SearchResult result;
+        result.Matches.emplace_back(MakeAvailable().WithDefaultName(secondName), Criteria());
+        return result;
+    };
+
+    CompositeSource Composite("*CompositeSource_AvailableSearchIsParallel");
+    Composite.AddAvailableSource(Source{ firstAvailable });
+    Composite.AddAvailableSource(Source{ secondAvailable });
+
+    SearchResult result = Composite.Search({});
+
+    REQUIRE(overlapped);
+
+    // Equivalent matches are kept in source order, regardless of which source finished first
+    REQUIRE(result.Matches.size() == 2);
+    REQUIRE(result.Matches[0].Package->GetLatestAvailableVersion()->GetProperty(PackageVersionProperty::Name).get() == firstName);
+    REQUIRE(result.Matches[1].Package->GetLatestAvailableVersion()->GetProperty(PackageVersionProperty::Name).get() == secondName);
+}
+
+TEST_CASE("CompositeSource_BatchedCorrelation", "[CompositeSource]")
+{
+    constexpr size_t installedCount = 20;
+
+    CompositeTestSetup setup;
+    for (size_t i = 0; i < installedCount; ++i)
+    {
+        std::string index = std::to_string(i);
+        setup.Installed->Everything.Matches.emplace_back(MakeInstalled().WithId("Installed" + index).WithPFN("sortof_apfn" + index), Criteria());
+    }
+
+    size_t searchCount = 0;
+    setup.Available->SearchFunction = [&](const SearchRequest& request)
+    {
+        ++searchCount;
+
+        // Every package shares the default name and publisher, so only the family name distinguishes them
+        SearchResult result;
+        for (const auto& inclusion : request.Inclusions)
+        {
+            if (inclusion.Field == PackageMatchField::PackageFamilyName)
+            {
+                result.Matches.emplace_back(MakeAvailable().WithId("Available_" + inclusion.Value).WithPFN(inclusion.Value), Criteria());
+            }
+        }
+        return result;
+    };
+
+    SearchResult result = setup.Search();
+
+    REQUIRE(searchCount < installedCount);
+    REQUIRE(result.Matches.size() == installedCount);
+
+    for (const auto& match : result.Matches)
+    {
+        auto installedVersion = match.Package->GetInstalledVersion();
+        REQUIRE(installedVersion);
+
+        auto latestAvailable = match.Package->GetLatestAvailableVersion();
+        REQUIRE(latestAvailable);
+
+        auto pfns = installedVersion->GetMultiProperty(PackageVersionMultiProperty::PackageFamilyName);
+        REQUIRE(pfns.size() == 1);
+        REQUIRE(latestAvailable->GetProperty(PackageVersionProperty::Id).get() == "Available_" + pfns[0].get());
+    }
+}
+
 TEST_CASE("CompositeSource_InstalledToAvailableCorrelationSearchFailure", "[CompositeSource]")
 {
     HRESULT expectedHR = E_BLUETOOTH_ATT_ATTRIBUTE_NOT_LONG;
@@ -942,3 +1044,100 @@ TEST_CASE("CompositeSource_TrackingFound_NotInstalled", "[CompositeSource]")
 
     REQUIRE(result.Matches.empty());
 }
+
+// Creates an index of the given number of packages, each with a product code that the other index also has.
+// The installed index has version 1.0 of each package, and the available index has versions 1.0 and 2.0.
+SQLiteIndex CreateCorrelationBudgetIndex(size_t packageCount, bool installed)
+{
+    SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+
+    for (size_t i = 0; i < packageCount; ++i)
+    {
+        std::string number = std::to_string(i);
+
+        Manifest::Manifest manifest = MakeDefaultManifest();
+        manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>("Budget Package " + number);
+        manifest.Installers[0].ProductCode = "{budget-" + number + "}";
+
+        if (installed)
+        {
+            manifest.Id = manifest.Installers[0].ProductCode;
+            auto manifestId = index.AddManifest(manifest, manifest.Id);
+            index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, Manifest::InstallerTypeToString(Manifest::InstallerTypeEnum::Exe));
+        }
+        else
+        {
+            manifest.Id = "Budget.Package" + number;
+            for (std::string_view version : { "1.0"sv, "2.0"sv })
+            {
+                manifest.Version = version;
+                index.AddManifest(manifest, manifest.Id + '.' + manifest.Version);
+            }
+        }
+    }
+
+    return index;
+}
+
+// Counts a composite search that correlates the given number of installed packages, and checks each of them for an update.
+OperationCounts CountCorrelation(size_t packageCount)
+{
+    auto tracking = std::make_shared<SQLiteIndexSource>(SourceDetails{}, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+    TestSourceFactory trackingFactory{ [&](const SourceDetails&) { return tracking; } };
+    TestHook_SetSourceFactoryOverride(std::string{ PackageTrackingCatalogSourceFactory::Type() }, trackingFactory);
+    auto removeOverride = wil::scope_exit([]() { TestHook_ClearSourceFactoryOverrides(); });
+
+    SourceDetails installedDetails;
+    installedDetails.Identifier = "*BudgetInstalled";
+    SourceDetails availableDetails;
+    availableDetails.Identifier = "BudgetAvailable";
+
+    CompositeSource composite{ "*Tests" };
+    composite.SetInstalledSource(Source{ std::make_shared<SQLiteIndexSource>(installedDetails, CreateCorrelationBudgetIndex(packageCount, true), Synchronization::CrossProcessReaderWriteLock{}, true) });
+    composite.AddAvailableSource(Source{ std::make_shared<SQLiteIndexSource>(availableDetails, CreateCorrelationBudgetIndex(packageCount, false)) });
+
+    // Search once beforehand so that the statements are cached, as they are for every search after the first.
+    composite.Search({});
+
+    size_t resultCount = 0;
+    size_t updateCount = 0;
+    OperationCounter counter;
+
+    {
+        auto results = composite.Search({});
+        resultCount = results.Matches.size();
+
+        for (const auto& match : results.Matches)
+        {
+            updateCount += match.Package->IsUpdateAvailable() ? 1 : 0;
+        }
+    }
+
+    OperationCounts result = counter.Get();
+
+    REQUIRE(resultCount == packageCount);
+    REQUIRE(updateCount == packageCount);
+
+    return result;
+}
+
+TEST_CASE("CompositeSource_Correlation_Budget", "[CompositeSource][budget]")
+{
+    // The costs of each installed package beyond the first set; the fixed costs of a search cancel out.
+    // Both counts are enough for the available sources to be searched in batches.
+    constexpr size_t fewerPackages = 40;
+    constexpr size_t morePackages = 120;
+    constexpr size_t addedPackages = morePackages - fewerPackages;
+
+    constexpr size_t statementsPreparedPerPackage = 1;
+    constexpr size_t stepsPerPackage = 48;
+    constexpr size_t allocationsPerPackage = 512;
+
+    OperationCounts fewer = CountCorrelation(fewerPackages);
+    OperationCounts more = CountCorrelation(morePackages);
+
+    REQUIRE(more.StatementsPrepared <= fewer.StatementsPrepared + statementsPreparedPerPackage * addedPackages);
+    REQUIRE(more.StatementSteps <= fewer.StatementSteps + stepsPerPackage * addedPackages);
+    REQUIRE(more.Allocations <= fewer.Allocations + allocationsPerPackage * addedPackages);
+    REQUIRE(more.RegistryCalls == fewer.RegistryCalls);
+}
@@ -128,6 +128,128 @@ TEST_CASE("DependencyGraph_EasyToSeeLoop", "[dependencyGraph][dependencies]")
     REQUIRE(installationOrder.at(1).Id == "EasyToSeeLoop");
 }
 
+TEST_CASE("DependencyGraph_PrefetchFrontiers", "[dependencyGraph][dependencies]")
+{
+    std::map<std::string, std::vector<std::string>> dependencies{
+        { "Root", { "A", "B" } },
+        { "A", { "C" } },
+        { "B", { "C", "D" } },
+        { "C", {} },
+        { "D", {} },
+    };
+
+    std::vector<std::string> evaluated;
+    auto getDependencies = [&](const Dependency& node)
+    {
+        evaluated.emplace_back(node.Id);
+
+        DependencyList result;
+        for (const auto& id : dependencies.at(node.Id))
+        {
+            result.Add(Dependency(DependencyType::Package, id));
+        }
+        return result;
+    };
+
+    Dependency root(DependencyType::Package, "Root");
+
+    DependencyGraph withoutPrefetch(root, getDependencies);
+    withoutPrefetch.BuildGraph();
+    auto expectedEvaluated = evaluated;
+    evaluated.clear();
+
+    std::vector<std::vector<std::string>> frontiers;
+    DependencyGraph withPrefetch(root, getDependencies);
+    withPrefetch.SetPrefetchFunction([&](const std::vector<Dependency>& frontier)
+        {
+            auto& ids = frontiers.emplace_back();
+            for (const auto& node : frontier)
+            {
+                ids.emplace_back(node.Id);
+            }
+        });
+    withPrefetch.BuildGraph();
+
+    REQUIRE(frontiers == std::vector<std::vector<std::string>>{ { "A", "B" }, { "C", "D" } });
+    REQUIRE(evaluated == expectedEvaluated);
+    REQUIRE(!withPrefetch.HasLoop());
+
+    auto expectedOrder = withoutPrefetch.GetInstallationOrder();
+    auto order = withPrefetch.GetInstallationOrder();
+    REQUIRE(order.size() == 5);
+    REQUIRE(order == expectedOrder);
+    REQUIRE(order.back().Id == "Root");
+}
+
+TEST_CASE("DependencyGraph_LoopPath", "[dependencyGraph][dependencies]")
+{
+    std::map<std::string, std::vector<std::string>> dependencies{
+        { "Root", { "A" } },
+        { "A", { "B", "D" } },
+        { "B", { "C" } },
+        { "C", { "A" } },
+        { "D", {} },
+    };
+
+    Dependency root(DependencyType::Package, "Root");
+    DependencyGraph graph(root, [&](const Dependency& node)
+        {
+            DependencyList result;
+            for (const auto& id : dependencies.at(node.Id))
+            {
+                result.Add(Dependency(DependencyType::Package, id));
+            }
+            return result;
+        });
+
+    graph.BuildGraph();
+
+    REQUIRE(graph.HasLoop());
+
+    auto loop = graph.GetLoop();
+    REQUIRE(loop.size() == 4);
+    REQUIRE(loop[0].Id == "A");
+    REQUIRE(loop[1].Id == "B");
+    REQUIRE(loop[2].Id == "C");
+    REQUIRE(loop[3].Id == "A");
+
+    // There is still an order for every node.
+    auto order = graph.GetInstallationOrder();
+    REQUIRE(order.size() == 5);
+    REQUIRE(order.back().Id == "Root");
+}
+
+// This skipped test case measures the time needed to order a wide graph, where many packages share the same dependencies.
+TEST_CASE("DependencyGraph_Benchmark", "[.]")
+{
+    constexpr size_t count = 5000;
+    constexpr size_t fanOut = 8;
+
+    auto getId = [](size_t i) { return std::string{ "Node." } + std::to_string(i); };
+
+    Dependency root(DependencyType::Package, getId(0));
+    DependencyGraph graph(root, [&](const Dependency& node)
+        {
+            size_t index = std::stoul(node.Id.substr(5));
+
+            DependencyList result;
+            for (size_t i = index + 1; i <= std::min(index + fanOut, count - 1); ++i)
+            {
+                result.Add(Dependency(DependencyType::Package, getId(i)));
+            }
+            return result;
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    graph.BuildGraph();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    REQUIRE(!graph.HasLoop());
+    REQUIRE(graph.GetInstallationOrder().size() == count);
+    REQUIRE(graph.GetInstallationOrder().front().Id == getId(count - 1));
+    WARN("Built and ordered a graph of " << count << " nodes in " << elapsed.count() << "us");
+}
+
 TEST_CASE("DependencyNodeProcessor_SkipInstalled", "[dependencies]")
 {
     TestCommon::TempFile installResultPath("TestExeInstalled.txt");
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <winget/DownloadScheduler.h>
+
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Settings;
+using namespace AppInstaller::Utility;
+
+TEST_CASE("DownloadScheduler_Priority", "[downloadScheduler]")
+{
+    REQUIRE(GetDownloadPriority(DownloadType::Index) == DownloadPriority::Index);
+    REQUIRE(GetDownloadPriority(DownloadType::Manifest) == DownloadPriority::Manifest);
+    REQUIRE(GetDownloadPriority(DownloadType::Installer) == DownloadPriority::Installer);
+    REQUIRE(GetDownloadPriority(DownloadType::Installer, true) == DownloadPriority::Index);
+}
+
+TEST_CASE("DownloadScheduler_ConnectionsPerHost", "[downloadScheduler]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::NetworkMaxConnectionsPerHost>(1);
+
+    ProgressCallback progress;
+    ProgressCallback cancelled;
+    cancelled.Cancel();
+
+    {
+        DownloadSlot first{ "https://example.com/first", DownloadPriority::Installer, progress };
+        REQUIRE(first);
+
+        // The host is at its limit, so a second download waits until it is cancelled
+        DownloadSlot second{ "https://EXAMPLE.com/second", DownloadPriority::Installer, cancelled };
+        REQUIRE(!second);
+
+        // Other hosts, and urls without one, are not held back
+        DownloadSlot otherHost{ "https://example.org/first", DownloadPriority::Index, progress };
+        REQUIRE(otherHost);
+
+        DownloadSlot local{ "C:\\Temp\\installer.exe", DownloadPriority::Installer, cancelled };
+        REQUIRE(local);
+    }
+
+    // The connection is returned once the first download is done
+    DownloadSlot again{ "https://example.com/again", DownloadPriority::Index, cancelled };
+    REQUIRE(again);
+}
@@ -59,6 +59,20 @@ TEST_CASE("DownloadValidFileAndCancel", "[Downloader]")
     REQUIRE(!waitResult.has_value());
 }
 
+TEST_CASE("GetMirroredUrls", "[Downloader]")
+{
+    std::vector<std::string> mirrors{ "https://mirror1.contoso.com/winget/", "https://mirror2.contoso.com" };
+
+    REQUIRE(GetMirroredUrls("https://dl.fabrikam.com/app/setup.exe?v=1", mirrors) == std::vector<std::string>{
+        "https://mirror1.contoso.com/winget/dl.fabrikam.com/app/setup.exe?v=1",
+        "https://mirror2.contoso.com/dl.fabrikam.com/app/setup.exe?v=1",
+        "https://dl.fabrikam.com/app/setup.exe?v=1" });
+
+    // Without mirrors, or for a local path, only the original is used.
+    REQUIRE(GetMirroredUrls("https://dl.fabrikam.com/setup.exe", {}) == std::vector<std::string>{ "https://dl.fabrikam.com/setup.exe" });
+    REQUIRE(GetMirroredUrls("C:\\setup.exe", mirrors) == std::vector<std::string>{ "C:\\setup.exe" });
+}
+
 TEST_CASE("DownloadInvalidUrl", "[Downloader]")
 {
     TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "TestCommon.h"
 #include "Commands/HashCommand.h"
+#include <JsonOutput.h>
 
 using namespace std::string_literals;
 using namespace TestCommon;
@@ -20,4 +21,40 @@ TEST_CASE("HashCommandWithTestMsix", "[Sha256Hash]")
 
     REQUIRE(hashOutput.str().find("Sha256: 6a2d3683fa19bf00e58e07d1313d20a5f5735ebbd6a999d33381d28740ee07ea") != std::string::npos);
     REQUIRE(hashOutput.str().find("SignatureSha256: 138781c3e6f635240353f3d14d1d57bdcb89413e49be63b375e6a5d7b93b0d07") != std::string::npos);
+}
+
+TEST_CASE("HashCommandWithMultipleFiles", "[Sha256Hash]")
+{
+    TestCommon::TempDirectory tempDirectory("HashCommandDirectory");
+    std::filesystem::copy_file(TestDataFile("TestSignedApp.msix"), tempDirectory.GetPath() / "First.msix");
+    std::filesystem::copy_file(TestDataFile("TestSignedApp.msix"), tempDirectory.GetPath() / "Second.msix");
+
+    std::ostringstream hashOutput;
+    Execution::Context context{ hashOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::HashFile, TestDataFile("TestSignedApp.msix").GetPath().u8string());
+    context.Args.AddArg(Execution::Args::Type::HashFile, tempDirectory.GetPath().u8string());
+    context.Args.AddArg(Execution::Args::Type::Msix);
+    context.Args.AddArg(Execution::Args::Type::OutputFormat, "jsonl"s);
+    HashCommand hashCommand({});
+
+    hashCommand.Execute(context);
+    REQUIRE(!context.IsTerminated());
+
+    std::istringstream records{ hashOutput.str() };
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::vector<std::string> paths;
+    std::string line;
+    while (std::getline(records, line))
+    {
+        Json::Value record;
+        std::string errors;
+        REQUIRE(reader->parse(line.c_str(), line.c_str() + line.size(), &record, &errors));
+        REQUIRE(record["sha256"].asString() == "6a2d3683fa19bf00e58e07d1313d20a5f5735ebbd6a999d33381d28740ee07ea");
+        REQUIRE(record["signatureSha256"].asString() == "138781c3e6f635240353f3d14d1d57bdcb89413e49be63b375e6a5d7b93b0d07");
+        paths.emplace_back(std::filesystem::path{ AppInstaller::Utility::ConvertToUTF16(record["path"].asString()) }.filename().u8string());
+    }
+
+    // The records are in the order the files were given, with those of a directory sorted
+    REQUIRE(paths == std::vector<std::string>{ "TestSignedApp.msix", "First.msix", "Second.msix" });
 }
\ No newline at end of file
@@ -30,6 +30,75 @@ TEST_CASE("ValidateAndExtractResponse_NotFound", "[RestSource]")
     REQUIRE_THROWS_HR(helper.HandleGet(L"https://testUri"), APPINSTALLER_CLI_ERROR_RESTSOURCE_ENDPOINT_NOT_FOUND);
 }
 
+TEST_CASE("HttpClientHelper_ReusesClientPerBaseUri", "[RestSource]")
+{
+    std::vector<utility::string_t> requestedUris;
+
+    HttpClientHelper helper{ GetTestRestRequestHandler([&](const web::http::http_request& request)
+        {
+            requestedUris.emplace_back(request.absolute_uri().to_string());
+            return web::http::status_codes::OK;
+        }) };
+
+    // Copies share the clients of the original
+    HttpClientHelper copy = helper;
+
+    REQUIRE_NOTHROW(helper.HandleGet(L"https://testUri/information"));
+    REQUIRE_NOTHROW(copy.HandlePost(L"https://testUri/manifestSearch?continuation=1", {}));
+    REQUIRE_NOTHROW(helper.HandleGet(L"https://otherUri:8443/packageManifests/Foo.Bar"));
+
+    REQUIRE(requestedUris.size() == 3);
+    REQUIRE(requestedUris[0] == L"https://testuri/information");
+    REQUIRE(requestedUris[1] == L"https://testuri/manifestSearch?continuation=1");
+    REQUIRE(requestedUris[2] == L"https://otheruri:8443/packageManifests/Foo.Bar");
+}
+
+TEST_CASE("HttpClientHelper_ConditionalRequestUsesCachedResponse", "[RestSource]")
+{
+    TestCommon::TempDirectory cacheDirectory{ "RestResponseCache" };
+    size_t requestCount = 0;
+    size_t notModifiedCount = 0;
+
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+            web::http::http_response response;
+
+            auto itr = request.headers().find(web::http::header_names::if_none_match);
+            if (itr != request.headers().end() && itr->second == L"\"v1\"")
+            {
+                ++notModifiedCount;
+                response.set_status_code(web::http::status_codes::NotModified);
+            }
+            else
+            {
+                response.set_body(web::json::value::parse(L"{ \"Data\": \"value\" }"));
+                response.headers().set_content_type(web::http::details::mime_types::application_json);
+                response.headers().add(web::http::header_names::etag, L"\"v1\"");
+                response.set_status_code(web::http::status_codes::OK);
+            }
+
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler, std::make_shared<HttpResponseCache>(cacheDirectory.GetPath()) };
+
+    auto first = helper.HandleGet(L"https://testUri/packageManifests/Foo");
+    REQUIRE(first);
+    REQUIRE(notModifiedCount == 0);
+
+    auto second = helper.HandleGet(L"https://testUri/packageManifests/Foo");
+    REQUIRE(second);
+    REQUIRE(notModifiedCount == 1);
+    REQUIRE(second.value() == first.value());
+
+    // A different request is not served from the cache
+    auto other = helper.HandleGet(L"https://testUri/packageManifests/Foo", { { L"Version", L"1.1.0" } });
+    REQUIRE(other);
+    REQUIRE(notModifiedCount == 1);
+    REQUIRE(requestCount == 3);
+}
+
 TEST_CASE("EnsureDefaultUserAgent", "[RestSource]")
 {
     HttpClientHelper helper{ GetTestRestRequestHandler([](const web::http::http_request& request)
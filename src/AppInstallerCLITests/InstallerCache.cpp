@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestHooks.h"
+#include <winget/InstallerCache.h>
+#include <winget/PerformanceCounters.h>
+
+using namespace AppInstaller::Utility;
+using namespace TestCommon;
+
+namespace
+{
+    SHA256::HashBuffer WriteFileWithContent(const std::filesystem::path& path, std::string_view content)
+    {
+        std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+        stream << content;
+        return SHA256::ComputeHash(content);
+    }
+
+    std::string ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream stream{ path, std::ios::binary };
+        return ReadEntireStream(stream);
+    }
+}
+
+TEST_CASE("InstallerCache_AddAndGet", "[InstallerCache]")
+{
+    TempDirectory cacheRoot{ "InstallerCache" };
+    TempDirectory workDir{ "InstallerCacheWork" };
+
+    InstallerCache cache{ cacheRoot.GetPath(), 1024 * 1024 };
+
+    std::filesystem::path source = workDir.GetPath() / "source";
+    auto hash = WriteFileWithContent(source, "installer content");
+
+    std::filesystem::path target = workDir.GetPath() / "target";
+    REQUIRE_FALSE(cache.TryGet(hash, target));
+
+    cache.Add(hash, source);
+    REQUIRE(cache.TryGet(hash, target));
+    REQUIRE(ReadFile(target) == "installer content");
+}
+
+TEST_CASE("InstallerCache_HitRateCounters", "[InstallerCache]")
+{
+    AppInstaller::Performance::Counters::TestHook_ResetCounters();
+    auto resetCounters = wil::scope_exit([]() { AppInstaller::Performance::Counters::TestHook_ResetCounters(); });
+
+    TempDirectory cacheRoot{ "InstallerCache" };
+    TempDirectory workDir{ "InstallerCacheWork" };
+
+    InstallerCache cache{ cacheRoot.GetPath(), 1024 * 1024 };
+
+    std::filesystem::path source = workDir.GetPath() / "source";
+    auto hash = WriteFileWithContent(source, "installer content");
+
+    std::filesystem::path target = workDir.GetPath() / "target";
+    REQUIRE_FALSE(cache.TryGet(hash, target));
+
+    cache.Add(hash, source);
+    REQUIRE(cache.TryGet(hash, target));
+    REQUIRE(cache.TryGet(hash, target));
+
+    auto snapshot = AppInstaller::Performance::Counters::GetSnapshot();
+    REQUIRE(snapshot.InstallerCacheHits == 2);
+    REQUIRE(snapshot.InstallerCacheMisses == 1);
+    REQUIRE(snapshot.InstallerCacheHitBytes == 2 * std::string_view{ "installer content" }.size());
+}
+
+TEST_CASE("InstallerCache_CorruptEntryIsRemoved", "[InstallerCache]")
+{
+    TempDirectory cacheRoot{ "InstallerCache" };
+    TempDirectory workDir{ "InstallerCacheWork" };
+
+    InstallerCache cache{ cacheRoot.GetPath(), 1024 * 1024 };
+
+    std::filesystem::path source = workDir.GetPath() / "source";
+    auto hash = WriteFileWithContent(source, "installer content");
+    cache.Add(hash, source);
+
+    // Replace the content of the entry behind the cache's back
+    std::string hashString = SHA256::ConvertToString(hash);
+    std::filesystem::path entry = cacheRoot.GetPath() / hashString.substr(0, 2) / hashString;
+    REQUIRE(std::filesystem::exists(entry));
+    WriteFileWithContent(entry, "tampered content");
+
+    std::filesystem::path target = workDir.GetPath() / "target";
+    REQUIRE_FALSE(cache.TryGet(hash, target));
+    REQUIRE_FALSE(std::filesystem::exists(entry));
+    REQUIRE_FALSE(std::filesystem::exists(target));
+}
+
+TEST_CASE("InstallerCache_EvictsLeastRecentlyUsed", "[InstallerCache]")
+{
+    TempDirectory cacheRoot{ "InstallerCache" };
+    TempDirectory workDir{ "InstallerCacheWork" };
+
+    // Room for two of the entries below
+    InstallerCache cache{ cacheRoot.GetPath(), 20 };
+
+    std::filesystem::path first = workDir.GetPath() / "first";
+    auto firstHash = WriteFileWithContent(first, "0123456789");
+    std::filesystem::path second = workDir.GetPath() / "second";
+    auto secondHash = WriteFileWithContent(second, "abcdefghij");
+    std::filesystem::path third = workDir.GetPath() / "third";
+    auto thirdHash = WriteFileWithContent(third, "ABCDEFGHIJ");
+
+    cache.Add(firstHash, first);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    cache.Add(secondHash, second);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Using the first entry makes the second the least recently used
+    std::filesystem::path target = workDir.GetPath() / "target";
+    REQUIRE(cache.TryGet(firstHash, target));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    cache.Add(thirdHash, third);
+
+    REQUIRE(cache.TryGet(firstHash, target));
+    REQUIRE_FALSE(cache.TryGet(secondHash, target));
+    REQUIRE(cache.TryGet(thirdHash, target));
+}
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <JsonOutput.h>
+
+using namespace AppInstaller::CLI;
+using namespace AppInstaller::CLI::Execution;
+
+namespace
+{
+    Json::Value CreateTestRecord(std::string_view id)
+    {
+        Json::Value result{ Json::ValueType::objectValue };
+        result["id"] = std::string{ id };
+        result["name"] = "Name \"quoted\"";
+        return result;
+    }
+}
+
+TEST_CASE("JsonOutput_ConvertToOutputFormat", "[jsonoutput]")
+{
+    REQUIRE(ConvertToOutputFormat("json") == OutputFormat::Json);
+    REQUIRE(ConvertToOutputFormat("JSONL") == OutputFormat::JsonLines);
+    REQUIRE(!ConvertToOutputFormat("table"));
+    REQUIRE(!ConvertToOutputFormat(""));
+}
+
+TEST_CASE("JsonOutput_Json", "[jsonoutput]")
+{
+    std::istringstream in;
+    std::ostringstream out;
+    Reporter reporter{ out, in };
+    reporter.SetChannel(Reporter::Channel::Json);
+
+    JsonRecordOutput output{ reporter, OutputFormat::Json };
+    output.OutputRecord(CreateTestRecord("Id.One"));
+    output.OutputRecord(CreateTestRecord("Id.Two"));
+
+    // Other output is not written to the channel.
+    reporter.Info() << "Not a record" << std::endl;
+
+    output.Complete();
+
+    REQUIRE(out.str() ==
+        "[\n"
+        "{\"id\":\"Id.One\",\"name\":\"Name \\\"quoted\\\"\"},\n"
+        "{\"id\":\"Id.Two\",\"name\":\"Name \\\"quoted\\\"\"}\n"
+        "]\n");
+
+    Json::Value parsed;
+    std::string json = out.str();
+    std::string errors;
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    REQUIRE(reader->parse(json.c_str(), json.c_str() + json.size(), &parsed, &errors));
+    REQUIRE(parsed.size() == 2);
+    REQUIRE(parsed[1]["id"].asString() == "Id.Two");
+}
+
+TEST_CASE("JsonOutput_JsonEmpty", "[jsonoutput]")
+{
+    std::istringstream in;
+    std::ostringstream out;
+    Reporter reporter{ out, in };
+    reporter.SetChannel(Reporter::Channel::Json);
+
+    JsonRecordOutput output{ reporter, OutputFormat::Json };
+    output.Complete();
+
+    REQUIRE(output.IsEmpty());
+    REQUIRE(out.str() == "[]\n");
+}
+
+TEST_CASE("JsonOutput_JsonLines", "[jsonoutput]")
+{
+    std::istringstream in;
+    std::ostringstream out;
+    Reporter reporter{ out, in };
+    reporter.SetChannel(Reporter::Channel::Json);
+
+    JsonRecordOutput output{ reporter, OutputFormat::JsonLines };
+    output.OutputRecord(CreateTestRecord("Id.One"));
+    output.OutputRecord(CreateTestRecord("Id.Two"));
+    output.Complete();
+
+    REQUIRE(out.str() ==
+        "{\"id\":\"Id.One\",\"name\":\"Name \\\"quoted\\\"\"}\n"
+        "{\"id\":\"Id.Two\",\"name\":\"Name \\\"quoted\\\"\"}\n");
+}
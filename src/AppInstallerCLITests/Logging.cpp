@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <winget/BinaryTraceLogger.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Logging;
+
+namespace
+{
+    std::vector<uint8_t> ReadAllBytes(const std::filesystem::path& path)
+    {
+        std::ifstream stream{ path, std::ios::binary };
+        return { std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+    }
+
+    template <typename T>
+    T ReadValue(const std::vector<uint8_t>& bytes, size_t offset)
+    {
+        T result{};
+        REQUIRE(offset + sizeof(T) <= bytes.size());
+        memcpy(&result, bytes.data() + offset, sizeof(T));
+        return result;
+    }
+
+    bool Contains(const std::vector<uint8_t>& bytes, std::string_view value)
+    {
+        return std::search(bytes.begin(), bytes.end(), value.begin(), value.end()) != bytes.end();
+    }
+}
+
+TEST_CASE("TraceEvent_Format", "[logging]")
+{
+    TraceEventDescriptor descriptor{ 1, "int {} string {} bool {} double {}"sv };
+
+    TraceEventArguments arguments;
+    arguments.AddAll(42, "text"sv, true, 1.5);
+
+    REQUIRE(FormatTraceEvent(descriptor, arguments.Get()) == "int 42 string text bool 1 double 1.5");
+}
+
+TEST_CASE("TraceEvent_Format_MissingArguments", "[logging]")
+{
+    TraceEventDescriptor descriptor{ 1, "first {} second {}"sv };
+
+    TraceEventArguments arguments;
+    arguments.Add(-7);
+
+    REQUIRE(FormatTraceEvent(descriptor, arguments.Get()) == "first -7 second {}");
+}
+
+TEST_CASE("TraceEvent_Format_LargeArgument", "[logging]")
+{
+    TraceEventDescriptor descriptor{ 1, "[{}] [{}]"sv };
+    std::string large(1000, 'a');
+
+    TraceEventArguments arguments;
+    arguments.AddAll(large, "after"s);
+
+    REQUIRE(FormatTraceEvent(descriptor, arguments.Get()) == "["s + large + "] [after]");
+}
+
+TEST_CASE("BinaryTraceLogger_WritesRecords", "[logging]")
+{
+    TempFile tempFile{ "binarytrace"s, ".wgtrace"s };
+    constexpr size_t capacity = 64 * 1024;
+
+    {
+        BinaryTraceLogger logger{ tempFile.GetPath(), capacity };
+        logger.Write(Channel::Test, Level::Info, "A plain message");
+
+        TraceEventDescriptor descriptor{ 200, "Event value {}"sv };
+        TraceEventArguments arguments;
+        arguments.Add("event argument"sv);
+
+        logger.WriteEvent(Channel::Test, Level::Info, descriptor, arguments.Get());
+        logger.WriteEvent(Channel::Test, Level::Info, descriptor, arguments.Get());
+    }
+
+    auto bytes = ReadAllBytes(tempFile.GetPath());
+
+    // The unused part of the file is released.
+    REQUIRE(bytes.size() < capacity);
+    REQUIRE(std::string_view{ reinterpret_cast<const char*>(bytes.data()), 7 } == "WGTRACE"sv);
+    REQUIRE(ReadValue<uint32_t>(bytes, 8) == 1);
+    REQUIRE(ReadValue<uint64_t>(bytes, 24) == bytes.size());
+    REQUIRE(ReadValue<uint64_t>(bytes, 32) == 0);
+
+    REQUIRE(Contains(bytes, "A plain message"sv));
+    REQUIRE(Contains(bytes, "Event value {}"sv));
+    REQUIRE(Contains(bytes, "event argument"sv));
+
+    // The event is only defined once, before its first use.
+    std::string_view definition = "Event value {}"sv;
+    auto first = std::search(bytes.begin(), bytes.end(), definition.begin(), definition.end());
+    REQUIRE(std::search(first + 1, bytes.end(), definition.begin(), definition.end()) == bytes.end());
+}
+
+TEST_CASE("BinaryTraceLogger_DropsWhenFull", "[logging]")
+{
+    TempFile tempFile{ "binarytrace"s, ".wgtrace"s };
+
+    {
+        BinaryTraceLogger logger{ tempFile.GetPath(), 256 };
+
+        for (size_t i = 0; i < 10; ++i)
+        {
+            logger.Write(Channel::Test, Level::Info, "A message that takes up a good amount of space");
+        }
+    }
+
+    auto bytes = ReadAllBytes(tempFile.GetPath());
+
+    REQUIRE(bytes.size() <= 256);
+    REQUIRE(ReadValue<uint64_t>(bytes, 32) > 0);
+}
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <Microsoft/ManifestCache.h>
+
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Utility;
+using namespace TestCommon;
+
+namespace
+{
+    std::filesystem::path GetEntryPath(const std::filesystem::path& root, const SHA256::HashBuffer& hash)
+    {
+        std::string hashString = SHA256::ConvertToString(hash);
+        return root / hashString.substr(0, 2) / hashString;
+    }
+}
+
+TEST_CASE("ManifestCache_AddAndGet", "[ManifestCache]")
+{
+    TempDirectory cacheRoot{ "ManifestCache" };
+    ManifestCache cache{ cacheRoot.GetPath(), 1024 * 1024 };
+
+    std::string contents = "PackageIdentifier: Contoso.Editor";
+    auto hash = SHA256::ComputeHash(contents);
+
+    REQUIRE_FALSE(cache.Get(hash));
+
+    cache.Add(hash, contents);
+    auto result = cache.Get(hash);
+    REQUIRE(result);
+    REQUIRE(result.value() == contents);
+}
+
+TEST_CASE("ManifestCache_CorruptEntryIsRemoved", "[ManifestCache]")
+{
+    TempDirectory cacheRoot{ "ManifestCache" };
+    ManifestCache cache{ cacheRoot.GetPath(), 1024 * 1024 };
+
+    std::string contents = "PackageIdentifier: Contoso.Editor";
+    auto hash = SHA256::ComputeHash(contents);
+    cache.Add(hash, contents);
+
+    // Replace the content of the entry behind the cache's back
+    std::filesystem::path entry = GetEntryPath(cacheRoot.GetPath(), hash);
+    REQUIRE(std::filesystem::exists(entry));
+    {
+        std::ofstream stream{ entry, std::ios::binary | std::ios::trunc };
+        stream << "PackageIdentifier: Fabrikam.Editor";
+    }
+
+    REQUIRE_FALSE(cache.Get(hash));
+    REQUIRE_FALSE(std::filesystem::exists(entry));
+}
+
+TEST_CASE("ManifestCache_EvictsLeastRecentlyUsed", "[ManifestCache]")
+{
+    TempDirectory cacheRoot{ "ManifestCache" };
+
+    // Room for two of the entries below
+    ManifestCache cache{ cacheRoot.GetPath(), 20 };
+
+    auto firstHash = SHA256::ComputeHash("0123456789");
+    auto secondHash = SHA256::ComputeHash("abcdefghij");
+    auto thirdHash = SHA256::ComputeHash("ABCDEFGHIJ");
+
+    cache.Add(firstHash, "0123456789");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    cache.Add(secondHash, "abcdefghij");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Using the first entry makes the second the least recently used
+    REQUIRE(cache.Get(firstHash));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    cache.Add(thirdHash, "ABCDEFGHIJ");
+
+    REQUIRE(cache.Get(firstHash));
+    REQUIRE_FALSE(cache.Get(secondHash));
+    REQUIRE(cache.Get(thirdHash));
+}
@@ -5,6 +5,7 @@
 #include <ExecutionContext.h>
 #include <COMContext.h>
 #include <Workflows/ManifestComparator.h>
+#include <winget/InstallerApplicability.h>
 #include <winget/UserSettings.h>
 
 using namespace std::string_literals;
@@ -640,3 +641,61 @@ TEST_CASE("ManifestComparator_MarketFilter", "[manifest_comparator]")
         RequireInapplicabilities(inapplicabilities, { InapplicabilityFlags::Market});
     }
 }
+
+TEST_CASE("ManifestComparator_SharedOptions", "[manifest_comparator]")
+{
+    Manifest manifest;
+    MarketsInfo markets;
+    markets.AllowedMarkets = { "XX" };
+    AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Exe, ScopeEnum::User, {}, "en-US", {}, markets);
+    ManifestInstaller expected = AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Exe, ScopeEnum::Machine, {}, "en-US", {}, markets);
+
+    // The options given through the context are used in place of the settings and system values.
+    auto options = std::make_shared<ManifestComparatorOptions>(ManifestComparatorOptions::Create());
+    options->Market = "XX";
+    options->ScopeRequirement = ScopeEnum::Machine;
+
+    ManifestComparatorTestContext context;
+    context.Add<Data::ManifestComparatorOptions>(options);
+
+    ManifestComparator mc(context, {});
+    auto [result, inapplicabilities] = mc.GetPreferredInstaller(manifest);
+
+    RequireInstaller(result, expected);
+    RequireInapplicabilities(inapplicabilities, { InapplicabilityFlags::Scope });
+
+    // The arguments of the context still take precedence.
+    context.Args.AddArg(Args::Type::InstallScope, ScopeToString(ScopeEnum::User));
+    ManifestComparator argsComparator(context, {});
+    auto [argsResult, argsInapplicabilities] = argsComparator.GetPreferredInstaller(manifest);
+
+    REQUIRE(argsResult);
+    REQUIRE(argsResult->Scope == ScopeEnum::User);
+    RequireInapplicabilities(argsInapplicabilities, { InapplicabilityFlags::Scope });
+}
+
+TEST_CASE("ManifestComparator_SummaryInapplicabilities", "[manifest_comparator]")
+{
+    ManifestComparator mc(ManifestComparatorTestContext{}, {});
+    IPackageVersion::Metadata metadata;
+
+    // Without a summary, the manifest must be examined.
+    REQUIRE(!mc.GetSummaryInapplicabilities(metadata));
+
+    Manifest manifest;
+    AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Exe, ScopeEnum::Unknown, "10.0.99999.0");
+    metadata[PackageVersionMetadata::InstallerApplicability] = InstallerApplicability::Create(manifest);
+
+    auto inapplicabilities = mc.GetSummaryInapplicabilities(metadata);
+    REQUIRE(inapplicabilities);
+    RequireInapplicabilities(inapplicabilities.value(), { InapplicabilityFlags::OSVersion });
+
+    // A single installer that may be applicable means that the manifest must be examined.
+    AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Exe, ScopeEnum::Unknown, "10.0.0.0");
+    metadata[PackageVersionMetadata::InstallerApplicability] = InstallerApplicability::Create(manifest);
+    REQUIRE(!mc.GetSummaryInapplicabilities(metadata));
+
+    // As does a summary that cannot be read.
+    metadata[PackageVersionMetadata::InstallerApplicability] = "not a summary";
+    REQUIRE(!mc.GetSummaryInapplicabilities(metadata));
+}
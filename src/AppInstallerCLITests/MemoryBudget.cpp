@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <winget/MemoryBudget.h>
+
+using namespace TestCommon;
+using namespace AppInstaller::Performance;
+using namespace AppInstaller::Settings;
+
+TEST_CASE("MemoryBudget_NoBudget", "[memoryBudget]")
+{
+    TestUserSettings settings;
+
+    REQUIRE(!GetMemoryBudget());
+    REQUIRE(!GetSQLiteCacheSizeLimitInKB());
+    REQUIRE(!GetPackageReadCacheLimit());
+}
+
+TEST_CASE("MemoryBudget_Limits", "[memoryBudget]")
+{
+    TestUserSettings settings;
+
+    settings.Set<Setting::MemoryBudgetInMB>(512);
+    REQUIRE(GetMemoryBudget() == 512ull * 1024 * 1024);
+    REQUIRE(GetSQLiteCacheSizeLimitInKB() == 512u);
+    REQUIRE(GetPackageReadCacheLimit() == 8ull * 1024 * 1024);
+
+    // The SQLite limit never goes above the default, nor so low that the cache is of no use.
+    settings.Set<Setting::MemoryBudgetInMB>(64);
+    REQUIRE(GetSQLiteCacheSizeLimitInKB() == 128u);
+
+    settings.Set<Setting::MemoryBudgetInMB>(8192);
+    REQUIRE(GetSQLiteCacheSizeLimitInKB() == 2000u);
+}
+
+TEST_CASE("MemoryBudget_PeakWorkingSet", "[memoryBudget]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::MemoryBudgetInMB>(64);
+
+    uint64_t before = GetPeakWorkingSet();
+    REQUIRE(before > 0);
+
+    {
+        // Touch every page so that the allocation is in the working set.
+        std::vector<char> allocation(16 * 1024 * 1024, 'a');
+        REQUIRE(allocation.back() == 'a');
+    }
+
+    // The peak never goes down, and the allocation could only have raised it.
+    REQUIRE(GetPeakWorkingSet() >= before);
+
+    // Over the budget or not, this only logs.
+    LogPeakWorkingSet();
+}
@@ -3,11 +3,14 @@
 #include "pch.h"
 #include "TestCommon.h"
 #include <AppInstallerMsixInfo.h>
+#include <HttpStream/HttpDiskCache.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 using namespace TestCommon;
 using namespace AppInstaller;
+using namespace AppInstaller::Utility::HttpStream;
+using namespace winrt::Windows::Security::Cryptography;
 
 constexpr std::string_view s_MsixFile_1 = "index.1.0.0.0.msix";
 constexpr std::string_view s_MsixFile_2 = "index.2.0.0.0.msix";
@@ -64,3 +67,76 @@ TEST_CASE("MsixInfo_WriteFile", "[msixinfo]")
 
     REQUIRE(1 == std::filesystem::file_size(file));
 }
+
+TEST_CASE("HttpDiskCache_ReadWritePages", "[msixinfo]")
+{
+    TempDirectory cacheDirectory{ "HttpDiskCache" };
+    constexpr UINT32 pageSize = 4;
+    constexpr ULONG64 fileSize = 10;
+    constexpr ULONG64 maximumSize = 1024;
+
+    auto diskCache = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/package.msix", L"\"etag1\"", fileSize, pageSize, maximumSize);
+    REQUIRE(diskCache);
+    REQUIRE(!diskCache->ReadPage(0));
+
+    std::vector<uint8_t> firstPage{ 1, 2, 3, 4 };
+    std::vector<uint8_t> lastPage{ 9, 10 };
+    diskCache->WritePage(0, CryptographicBuffer::CreateFromByteArray(firstPage));
+    diskCache->WritePage(8, CryptographicBuffer::CreateFromByteArray(lastPage));
+
+    // A page of the wrong length is not saved
+    diskCache->WritePage(4, CryptographicBuffer::CreateFromByteArray(lastPage));
+    REQUIRE(!diskCache->ReadPage(4));
+
+    // The pages are read back by a cache for the same version
+    auto sameVersion = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/package.msix", L"\"etag1\"", fileSize, pageSize, maximumSize);
+    REQUIRE(sameVersion);
+
+    auto readFirstPage = sameVersion->ReadPage(0);
+    REQUIRE(readFirstPage);
+    winrt::com_array<uint8_t> readBytes;
+    CryptographicBuffer::CopyToByteArray(readFirstPage, readBytes);
+    REQUIRE(std::vector<uint8_t>(readBytes.begin(), readBytes.end()) == firstPage);
+
+    auto readLastPage = sameVersion->ReadPage(8);
+    REQUIRE(readLastPage);
+    REQUIRE(readLastPage.Length() == lastPage.size());
+
+    // But not by a cache for a different version
+    auto otherVersion = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/package.msix", L"\"etag2\"", fileSize, pageSize, maximumSize);
+    REQUIRE(otherVersion);
+    REQUIRE(!otherVersion->ReadPage(0));
+}
+
+TEST_CASE("HttpDiskCache_RequiresStrongETag", "[msixinfo]")
+{
+    TempDirectory cacheDirectory{ "HttpDiskCache" };
+
+    REQUIRE(!HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/package.msix", L"", 10, 4, 1024));
+    REQUIRE(!HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/package.msix", L"W/\"etag1\"", 10, 4, 1024));
+    REQUIRE(!HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/package.msix", L"\"etag1\"", 10, 4, 0));
+}
+
+TEST_CASE("HttpDiskCache_RemovesLeastRecentlyUsed", "[msixinfo]")
+{
+    TempDirectory cacheDirectory{ "HttpDiskCache" };
+    std::vector<uint8_t> page{ 1, 2, 3, 4 };
+
+    // Each entry holds a single page, so the maximum size fits only one of them
+    auto first = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/first.msix", L"\"etag1\"", 4, 4, 4);
+    REQUIRE(first);
+    first->WritePage(0, CryptographicBuffer::CreateFromByteArray(page));
+
+    auto second = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/second.msix", L"\"etag1\"", 4, 4, 4);
+    REQUIRE(second);
+    second->WritePage(0, CryptographicBuffer::CreateFromByteArray(page));
+
+    // Opening the second entry again removes the first, which is over the size and was used less recently
+    auto secondAgain = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/second.msix", L"\"etag1\"", 4, 4, 4);
+    REQUIRE(secondAgain);
+    REQUIRE(secondAgain->ReadPage(0));
+
+    auto firstAgain = HttpDiskCache::Create(cacheDirectory.GetPath(), L"https://example.com/first.msix", L"\"etag1\"", 4, 4, 4);
+    REQUIRE(firstAgain);
+    REQUIRE(!firstAgain->ReadPage(0));
+}
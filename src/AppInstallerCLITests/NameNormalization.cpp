@@ -131,3 +131,96 @@ TEST_CASE("NameNorm_KBNumbers", "[name_norm]")
 
     REQUIRE(normer.Normalize("Fix for (KB42)", {}).Name() == "FixforKB42");
 }
+
+TEST_CASE("NameNorm_Cache", "[name_norm]")
+{
+    NameNormalizer normer(NormalizationVersion::Initial);
+    NameNormalizer otherNormer(NormalizationVersion::Initial);
+
+    auto first = normer.Normalize("Awesome App 1.2.3 (x64) en-US", "Awesome Company, Inc.");
+    auto second = otherNormer.Normalize("Awesome App 1.2.3 (x64) en-US", "Awesome Company, Inc.");
+    auto nameOnly = normer.NormalizeName("Awesome App 1.2.3 (x64) en-US");
+
+    REQUIRE(first.Name() == "AwesomeApp");
+    REQUIRE(first.Name() == second.Name());
+    REQUIRE(first.Name() == nameOnly.Name());
+    REQUIRE(first.Architecture() == Architecture::X64);
+    REQUIRE(first.Architecture() == second.Architecture());
+    REQUIRE(first.Locale() == "en-us");
+    REQUIRE(first.Locale() == second.Locale());
+    REQUIRE(first.Publisher() == second.Publisher());
+    REQUIRE(first.Publisher() == normer.NormalizePublisher("Awesome Company, Inc."));
+}
+
+// This skipped test case measures the time needed to normalize the names and publishers in the test data,
+// both initially and when the results are already known.
+TEST_CASE("NameNorm_Benchmark", "[.]")
+{
+    std::ifstream namesStream(TestCommon::TestDataFile("InputNames.txt").GetPath());
+    REQUIRE(namesStream);
+    std::ifstream publishersStream(TestCommon::TestDataFile("InputPublishers.txt").GetPath());
+    REQUIRE(publishersStream);
+
+    std::vector<std::pair<std::string, std::string>> values;
+    std::string name;
+    std::string publisher;
+    while (std::getline(namesStream, name) && std::getline(publishersStream, publisher))
+    {
+        values.emplace_back(std::move(name), std::move(publisher));
+    }
+    REQUIRE(!values.empty());
+
+    NameNormalizer normer(NormalizationVersion::Initial);
+
+    auto measure = [&]()
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& value : values)
+        {
+            normer.Normalize(value.first, value.second);
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto initial = measure();
+    auto repeated = measure();
+
+    WARN("Normalized " << values.size() << " values in " << initial << "us; repeated in " << repeated << "us");
+}
+
+TEST_CASE("NameNorm_Parallel", "[name_norm]")
+{
+    std::vector<std::string> names{ "Name x86", "Name (64 bit) en-US", "Fix for (KB42)", "Product Version 1.2.3 (es-mx)", "Program installed at C:\\Program Files\\App" };
+
+    NameNormalizer normer(NormalizationVersion::Initial);
+    std::vector<NormalizedName> expected;
+    for (const auto& name : names)
+    {
+        expected.emplace_back(normer.NormalizeName(name));
+    }
+
+    // Normalizers share their expressions, which can be used from many threads at once
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+        results.emplace_back(std::async(std::launch::async, [&]()
+            {
+                NameNormalizer threadNormer(NormalizationVersion::Initial);
+                bool result = true;
+                for (int j = 0; j < 50; ++j)
+                {
+                    for (size_t k = 0; k < names.size(); ++k)
+                    {
+                        NormalizedName actual = (j % 2 ? normer : threadNormer).NormalizeName(names[k]);
+                        result = result && actual.Name() == expected[k].Name() && actual.Architecture() == expected[k].Architecture() && actual.Locale() == expected[k].Locale();
+                    }
+                }
+                return result;
+            }));
+    }
+
+    for (auto& result : results)
+    {
+        REQUIRE(result.get());
+    }
+}
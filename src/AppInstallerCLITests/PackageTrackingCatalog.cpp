@@ -161,6 +161,41 @@ TEST_CASE("TrackingCatalog_Upgrade", "[tracking_catalog]")
         manifest.Version);
 }
 
+TEST_CASE("TrackingCatalog_InstallBatch", "[tracking_catalog]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    auto source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    PackageTrackingCatalog catalog = CreatePackageTrackingCatalogForSource(source);
+
+    std::vector<PackageTrackingCatalog::InstallRecord> records;
+    records.push_back({ manifest, manifest.Installers[0], false });
+
+    Manifest secondManifest = manifest;
+    secondManifest.Id = "Second.Package";
+    records.push_back({ secondManifest, secondManifest.Installers[0], false });
+
+    auto versions = catalog.RecordInstalls(records);
+    REQUIRE(versions.size() == 2);
+
+    for (const auto& id : { manifest.Id, secondManifest.Id })
+    {
+        SearchRequest request;
+        request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, id);
+
+        SearchResult result = catalog.Search(request);
+        REQUIRE(result.Matches.size() == 1);
+
+        auto metadata = result.Matches[0].Package->GetLatestAvailableVersion()->GetMetadata();
+        REQUIRE(metadata.find(PackageVersionMetadata::TrackingWriteTime) != metadata.end());
+    }
+}
+
 TEST_CASE("TrackingCatalog_Uninstall", "[tracking_catalog]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestHooks.h"
+#include <winget/Performance.h>
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Performance;
+
+namespace
+{
+    // Resets the timings both before and after the test.
+    struct ResetTimings
+    {
+        ResetTimings() { TestHook_ResetTimings(); }
+        ~ResetTimings() { TestHook_ResetTimings(); }
+    };
+
+    void TimedFunction() {}
+}
+
+TEST_CASE("ScopedTimer_DisabledByDefault", "[performance]")
+{
+    ResetTimings reset;
+
+    {
+        ScopedTimer timer{ "Outer" };
+    }
+
+    REQUIRE(!IsCollectionEnabled());
+    REQUIRE(GetTimingSummary().empty());
+}
+
+TEST_CASE("ScopedTimer_NestsAndCounts", "[performance]")
+{
+    ResetTimings reset;
+    EnableCollection();
+
+    {
+        ScopedTimer outer{ "Outer" };
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ScopedTimer inner{ "Inner" };
+            std::this_thread::sleep_for(1ms);
+        }
+
+        ScopedTimer other{ "Other" };
+    }
+
+    {
+        ScopedTimer outer{ "Outer" };
+    }
+
+    auto summary = GetTimingSummary();
+    REQUIRE(summary.size() == 1);
+
+    const auto& outer = summary[0];
+    REQUIRE(outer.Name == "Outer");
+    REQUIRE(outer.Count == 2);
+    REQUIRE(outer.Children.size() == 2);
+
+    const auto& inner = outer.Children[0];
+    REQUIRE(inner.Name == "Inner");
+    REQUIRE(inner.Count == 3);
+    REQUIRE(inner.Total >= 3ms);
+    REQUIRE(inner.Children.empty());
+    REQUIRE(outer.Total >= inner.Total);
+
+    REQUIRE(outer.Children[1].Name == "Other");
+    REQUIRE(outer.Children[1].Count == 1);
+}
+
+TEST_CASE("ScopedTimer_Function", "[performance]")
+{
+    ResetTimings reset;
+    EnableCollection();
+
+    {
+        ScopedTimer first{ {}, reinterpret_cast<const void*>(&TimedFunction) };
+    }
+    {
+        ScopedTimer second{ {}, reinterpret_cast<const void*>(&TimedFunction) };
+    }
+
+    auto summary = GetTimingSummary();
+    REQUIRE(summary.size() == 1);
+    REQUIRE(summary[0].Count == 2);
+    REQUIRE(!summary[0].Name.empty());
+}
+
+TEST_CASE("ScopedTimer_OtherThreadAtTopLevel", "[performance]")
+{
+    ResetTimings reset;
+    EnableCollection();
+
+    {
+        ScopedTimer outer{ "Outer" };
+
+        std::thread thread{ []() { ScopedTimer background{ "Background" }; } };
+        thread.join();
+    }
+
+    auto summary = GetTimingSummary();
+    REQUIRE(summary.size() == 2);
+    REQUIRE(summary[0].Name == "Outer");
+    REQUIRE(summary[0].Children.empty());
+    REQUIRE(summary[1].Name == "Background");
+}
+
+TEST_CASE("TimingSummary_Json", "[performance]")
+{
+    std::vector<TimingSummary> summary;
+
+    TimingSummary& outer = summary.emplace_back();
+    outer.Name = "Outer";
+    outer.Count = 2;
+    outer.Total = 5ms;
+
+    TimingSummary& inner = outer.Children.emplace_back();
+    inner.Name = "Inner";
+    inner.Count = 1;
+    inner.Total = 1500us;
+
+    Json::Value root;
+    std::string json = TimingSummaryToJson(summary);
+    std::string errors;
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    REQUIRE(reader->parse(json.c_str(), json.c_str() + json.size(), &root, &errors));
+
+    REQUIRE(root.isArray());
+    REQUIRE(root.size() == 1);
+    REQUIRE(root[0]["name"].asString() == "Outer");
+    REQUIRE(root[0]["count"].asUInt64() == 2);
+    REQUIRE(root[0]["totalMs"].asDouble() == 5.0);
+    REQUIRE(root[0]["children"][0]["name"].asString() == "Inner");
+    REQUIRE(root[0]["children"][0]["totalMs"].asDouble() == 1.5);
+    REQUIRE(!root[0]["children"][0].isMember("children"));
+}
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestHooks.h"
+#include <winget/PerformanceCounters.h>
+
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Performance::Counters;
+
+namespace
+{
+    // Resets the counters both before and after the test.
+    struct ResetCounters
+    {
+        ResetCounters() { TestHook_ResetCounters(); }
+        ~ResetCounters() { TestHook_ResetCounters(); }
+    };
+}
+
+TEST_CASE("PerformanceCounters_SearchHistogram", "[performance]")
+{
+    ResetCounters reset;
+
+    RecordSearch(5ms);
+    RecordSearch(10ms);
+    RecordSearch(75ms);
+    RecordSearch(1min);
+
+    auto snapshot = GetSnapshot();
+    REQUIRE(snapshot.Search.Count == 4);
+    REQUIRE(snapshot.Search.Maximum == 1min);
+    REQUIRE(snapshot.Search.Total == 5ms + 10ms + 75ms + 1min);
+
+    // A duration on a bound belongs to the bucket that it bounds.
+    REQUIRE(snapshot.Search.Buckets[0] == 2);
+    REQUIRE(snapshot.Search.Buckets[1] == 0);
+    REQUIRE(snapshot.Search.Buckets[2] == 1);
+    REQUIRE(snapshot.Search.Buckets.back() == 1);
+
+    REQUIRE(snapshot.SourceOpen.Count == 0);
+}
+
+TEST_CASE("PerformanceCounters_QueueDepthAndItems", "[performance]")
+{
+    ResetCounters reset;
+
+    SetQueueDepth("download", 3, 1);
+    SetQueueDepth("operation", 1, 1);
+    SetQueueDepth("download", 2, 2);
+    RecordQueueItem("download", L"Test.Package", 20ms, 2s, S_OK);
+
+    auto snapshot = GetSnapshot();
+    REQUIRE(snapshot.Queues.size() == 2);
+    REQUIRE(snapshot.Queues[0].Name == "download");
+    REQUIRE(snapshot.Queues[0].QueuedItems == 2);
+    REQUIRE(snapshot.Queues[0].RunningItems == 2);
+    REQUIRE(snapshot.Queues[1].Name == "operation");
+
+    REQUIRE(snapshot.QueueWait.Count == 1);
+    REQUIRE(snapshot.QueueWait.Buckets[1] == 1);
+    REQUIRE(snapshot.QueueRun.Count == 1);
+    REQUIRE(snapshot.QueueRun.Maximum == 2s);
+}
+
+TEST_CASE("PerformanceCounters_Downloads", "[performance]")
+{
+    ResetCounters reset;
+
+    {
+        ActiveDownload first;
+        ActiveDownload second;
+        AddDownloadedBytes(100);
+        AddDownloadedBytes(28);
+
+        auto snapshot = GetSnapshot();
+        REQUIRE(snapshot.ActiveDownloads == 2);
+        REQUIRE(snapshot.DownloadedBytes == 128);
+    }
+
+    auto snapshot = GetSnapshot();
+    REQUIRE(snapshot.ActiveDownloads == 0);
+    REQUIRE(snapshot.DownloadedBytes == 128);
+}
+
+TEST_CASE("PerformanceCounters_LockContention", "[performance]")
+{
+    ResetCounters reset;
+
+    CountedMutex first{ "Test.Lock" };
+    CountedMutex second{ "Test.Lock" };
+
+    second.lock();
+    second.unlock();
+
+    first.lock();
+    REQUIRE(!first.try_lock());
+
+    std::promise<void> waiting;
+    std::thread waiter([&]()
+        {
+            waiting.set_value();
+            std::lock_guard<CountedMutex> lock{ first };
+        });
+
+    waiting.get_future().wait();
+    std::this_thread::sleep_for(50ms);
+    first.unlock();
+    waiter.join();
+
+    auto snapshot = GetSnapshot();
+    auto itr = std::find_if(snapshot.Locks.begin(), snapshot.Locks.end(), [](const LockContention& lock) { return lock.Name == "Test.Lock"; });
+    REQUIRE(itr != snapshot.Locks.end());
+
+    // Both mutexes are counted together; the failed try_lock is not an acquisition
+    REQUIRE(itr->Acquisitions == 3);
+    REQUIRE(itr->ContendedAcquisitions == 1);
+    REQUIRE(itr->WaitTime > 0us);
+}
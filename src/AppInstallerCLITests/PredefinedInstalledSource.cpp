@@ -163,7 +163,7 @@ TEST_CASE("ARPHelper_GetBoolValue_DoesNotExist", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE_FALSE(helper.GetBoolValue(key, valueName));
+    REQUIRE_FALSE(helper.GetBoolValue(key.ReadAllValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_NotDword", "[arphelper][list]")
@@ -176,7 +176,7 @@ TEST_CASE("ARPHelper_GetBoolValue_NotDword", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE_FALSE(helper.GetBoolValue(key, valueName));
+    REQUIRE_FALSE(helper.GetBoolValue(key.ReadAllValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_Zero", "[arphelper][list]")
@@ -189,7 +189,7 @@ TEST_CASE("ARPHelper_GetBoolValue_Zero", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE_FALSE(helper.GetBoolValue(key, valueName));
+    REQUIRE_FALSE(helper.GetBoolValue(key.ReadAllValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_One", "[arphelper][list]")
@@ -202,7 +202,7 @@ TEST_CASE("ARPHelper_GetBoolValue_One", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE(helper.GetBoolValue(key, valueName));
+    REQUIRE(helper.GetBoolValue(key.ReadAllValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_FortyTwo", "[arphelper][list]")
@@ -215,7 +215,7 @@ TEST_CASE("ARPHelper_GetBoolValue_FortyTwo", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE(helper.GetBoolValue(key, valueName));
+    REQUIRE(helper.GetBoolValue(key.ReadAllValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_DetermineVersion_DisplayVersion", "[arphelper][list]")
@@ -230,7 +230,7 @@ TEST_CASE("ARPHelper_DetermineVersion_DisplayVersion", "[arphelper][list]")
     SetRegistryValue(root.get(), helper.VersionMajor, 3);
     SetRegistryValue(root.get(), helper.VersionMinor, 14);
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadAllValues());
     REQUIRE(result == "1.0");
 }
 
@@ -245,7 +245,7 @@ TEST_CASE("ARPHelper_DetermineVersion_Version", "[arphelper][list]")
     SetRegistryValue(root.get(), helper.VersionMajor, 3);
     SetRegistryValue(root.get(), helper.VersionMinor, 14);
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadAllValues());
     REQUIRE(result == "3.14");
 }
 
@@ -259,7 +259,7 @@ TEST_CASE("ARPHelper_DetermineVersion_VersionMajorMinor", "[arphelper][list]")
     SetRegistryValue(root.get(), helper.VersionMajor, 3);
     SetRegistryValue(root.get(), helper.VersionMinor, 14);
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadAllValues());
     REQUIRE(result == "3.14");
 }
 
@@ -270,7 +270,7 @@ TEST_CASE("ARPHelper_DetermineVersion_Unknown", "[arphelper][list]")
 
     ARPHelper helper;
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadAllValues());
     REQUIRE(result == Version::CreateUnknown().ToString());
 }
 
@@ -385,6 +385,195 @@ TEST_CASE("ARPHelper_PopulateIndexFromKey_Two", "[arphelper][list]")
     VerifyEntryAgainstIndex(index, result.Matches[0].first, entry2);
 }
 
+TEST_CASE("ARPHelper_PopulateIndexFromKey_Incremental", "[arphelper][list]")
+{
+    using namespace std::chrono_literals;
+
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+
+    ARPEntry entry1("FirstEntry", "Test Name", "1.2");
+    ARPEntry entry2("SecondEntry", "Different Test Name", "31.4");
+    ARPEntry entry3("ThirdEntry", "Another Test Name", "2.7");
+
+    AddARPEntryToKey(root.get(), helper, entry1);
+    AddARPEntryToKey(root.get(), helper, entry2);
+
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+
+    auto populate = [&]()
+    {
+        Microsoft::InstalledIndexEntries entries{ index };
+        helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", &entries);
+        entries.RemoveUnseen(index);
+        return entries.HasChanges();
+    };
+
+    auto verifyEntry = [&](const ARPEntry& entry)
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Exact, entry.EntryName);
+        auto result = index.Search(request);
+        REQUIRE(result.Matches.size() == 1);
+
+        auto versionKeys = index.GetVersionKeysById(result.Matches[0].first);
+        REQUIRE(versionKeys.size() == 1);
+
+        auto manifestId = index.GetManifestIdByKey(result.Matches[0].first, versionKeys[0].GetVersion().ToString(), versionKeys[0].GetChannel().ToString());
+        REQUIRE(manifestId);
+        VerifyEntryAgainstIndex(index, manifestId.value(), entry);
+    };
+
+    REQUIRE(populate());
+    REQUIRE(index.Search({}).Matches.size() == 2);
+
+    // Nothing changed, so nothing is read again
+    REQUIRE_FALSE(populate());
+    REQUIRE(index.Search({}).Matches.size() == 2);
+
+    // The last write time of a key is not precise enough to distinguish writes that happen immediately after each other
+    std::this_thread::sleep_for(100ms);
+
+    REQUIRE(RegDeleteKeyW(root.get(), ConvertToUTF16(entry1.EntryName).c_str()) == ERROR_SUCCESS);
+    entry2.DisplayVersion = "31.5";
+    AddARPEntryToKey(root.get(), helper, entry2);
+    AddARPEntryToKey(root.get(), helper, entry3);
+
+    REQUIRE(populate());
+    REQUIRE(index.Search({}).Matches.size() == 2);
+    verifyEntry(entry2);
+    verifyEntry(entry3);
+}
+
+TEST_CASE("ARPHelper_ReadEntriesFromKey_AddedInOrder", "[arphelper][list]")
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+
+    ARPEntry entry1("FirstEntry", "Test Name", "1.2");
+    ARPEntry entry2("SecondEntry", "Different Test Name", "31.4");
+    AddARPEntryToKey(root.get(), helper, entry1);
+    AddARPEntryToKey(root.get(), helper, entry2);
+
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    Microsoft::InstalledIndexEntries entries{ index };
+
+    // The same key read as two locations; the first location read is the one that is kept.
+    auto firstRead = helper.ReadEntriesFromKey(key, s_TestScope, "FirstArchitecture", &entries);
+    auto secondRead = helper.ReadEntriesFromKey(key, s_TestScope, "SecondArchitecture", &entries);
+    REQUIRE(firstRead.size() == 2);
+    REQUIRE(secondRead.size() == 2);
+
+    helper.AddEntriesToIndex(index, firstRead, s_TestScope, "FirstArchitecture", &entries);
+    helper.AddEntriesToIndex(index, secondRead, s_TestScope, "SecondArchitecture", &entries);
+    entries.RemoveUnseen(index);
+
+    REQUIRE(index.Search({}).Matches.size() == 2);
+
+    // Reading again with the entries from the index skips reading the values of the location that was kept.
+    Microsoft::InstalledIndexEntries existingEntries{ index };
+    for (const auto& entry : helper.ReadEntriesFromKey(key, s_TestScope, "FirstArchitecture", &existingEntries))
+    {
+        REQUIRE_FALSE(entry.IsRead);
+    }
+    for (const auto& entry : helper.ReadEntriesFromKey(key, s_TestScope, "SecondArchitecture", &existingEntries))
+    {
+        REQUIRE(entry.IsRead);
+    }
+}
+
+struct ARPReadCounts
+{
+    OperationCounts Read;
+    OperationCounts Populate;
+    OperationCounts Reread;
+};
+
+// Counts reading a key with the given number of entries, populating an index from it, and then reading it again
+// with the entries from the index as an incremental update does.
+ARPReadCounts CountARPReads(size_t entryCount)
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+
+    for (size_t i = 0; i < entryCount; ++i)
+    {
+        std::string number = std::to_string(i);
+        ARPEntry entry("BudgetEntry" + number, "Budget Name " + number, "1.0." + number);
+        entry.Publisher = "Budget Publisher";
+        entry.InstallLocation = "BudgetLocation";
+        entry.UninstallString = "Budget Uninstall";
+        entry.QuietUninstallString = "Budget Quiet Uninstall";
+        AddARPEntryToKey(root.get(), helper, entry);
+    }
+
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    ARPReadCounts result;
+    size_t readCount = 0;
+
+    {
+        Microsoft::InstalledIndexEntries entries{ index };
+        OperationCounter counter;
+        readCount = helper.ReadEntriesFromKey(key, s_TestScope, "TestArchitecture", &entries).size();
+        result.Read = counter.Get();
+    }
+
+    {
+        Microsoft::InstalledIndexEntries entries{ index };
+        OperationCounter counter;
+        helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", &entries);
+        result.Populate = counter.Get();
+    }
+
+    size_t rereadValues = 0;
+    {
+        Microsoft::InstalledIndexEntries entries{ index };
+        OperationCounter counter;
+        for (const auto& entry : helper.ReadEntriesFromKey(key, s_TestScope, "TestArchitecture", &entries))
+        {
+            rereadValues += entry.IsRead ? 1 : 0;
+        }
+        result.Reread = counter.Get();
+    }
+
+    REQUIRE(readCount == entryCount);
+    REQUIRE(rereadValues == 0);
+    REQUIRE(index.Search({}).Matches.size() == entryCount);
+
+    return result;
+}
+
+TEST_CASE("ARPHelper_PopulateIndexFromKey_Budget", "[arphelper][list][budget]")
+{
+    // The costs of each entry beyond the first set; the fixed costs of reading a key cancel out.
+    constexpr size_t fewerEntries = 20;
+    constexpr size_t moreEntries = 60;
+    constexpr size_t addedEntries = moreEntries - fewerEntries;
+
+    // An entry is enumerated and opened, and its values are read in a single pass.
+    constexpr size_t registryCallsPerEntry = 16;
+    constexpr size_t allocationsPerEntryRead = 192;
+    // An entry that has not changed since it was added to the index is only enumerated.
+    constexpr size_t registryCallsPerEntryReread = 2;
+
+    ARPReadCounts fewer = CountARPReads(fewerEntries);
+    ARPReadCounts more = CountARPReads(moreEntries);
+
+    REQUIRE(more.Read.RegistryCalls <= fewer.Read.RegistryCalls + registryCallsPerEntry * addedEntries);
+    REQUIRE(more.Read.Allocations <= fewer.Read.Allocations + allocationsPerEntryRead * addedEntries);
+
+    // Populating the index reads each entry once, like the read alone.
+    REQUIRE(more.Populate.RegistryCalls <= fewer.Populate.RegistryCalls + registryCallsPerEntry * addedEntries);
+
+    REQUIRE(more.Reread.RegistryCalls <= fewer.Reread.RegistryCalls + registryCallsPerEntryReread * addedEntries);
+}
+
 TEST_CASE("PredefinedInstalledSource_Create", "[installed][list]")
 {
     auto source = CreatePredefinedInstalledSource();
@@ -400,3 +589,30 @@ TEST_CASE("PredefinedInstalledSource_Search", "[installed][list]")
 
     REQUIRE_FALSE(results.Matches.empty());
 }
+
+TEST_CASE("PredefinedInstalledSource_Search_PackageFamilyName", "[installed][list]")
+{
+    auto msixSource = CreatePredefinedInstalledSource(Factory::Filter::MSIX);
+    auto msixResults = msixSource->Search({});
+
+    if (msixResults.Matches.empty())
+    {
+        WARN("No MSIX packages are installed");
+        return;
+    }
+
+    auto familyNames = msixResults.Matches[0].Package->GetInstalledVersion()->GetMultiProperty(PackageVersionMultiProperty::PackageFamilyName);
+    REQUIRE(familyNames.size() == 1);
+
+    // The full installed source only looks up the requested family, but must find the same package.
+    auto source = CreatePredefinedInstalledSource();
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::PackageFamilyName, MatchType::Exact, familyNames[0].get());
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "NotAProductCode");
+
+    auto results = source->Search(request);
+
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(results.Matches[0].Package->GetProperty(PackageProperty::Id) == msixResults.Matches[0].Package->GetProperty(PackageProperty::Id));
+}
@@ -84,3 +84,35 @@ TEST_CASE("Regex_ForEach", "[regex]")
             }
         });
 }
+
+TEST_CASE("Regex_SharedExpression", "[regex]")
+{
+    SharedExpression vowels{ "(a|e|i|o|u)", Options::CaseInsensitive };
+
+    REQUIRE(vowels.IsMatch(L"A"));
+    REQUIRE(!vowels.IsMatch(L"b"));
+
+    // Each thread matches with its own clone, so the results are not mixed up between threads
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+        results.emplace_back(std::async(std::launch::async, [&vowels]()
+            {
+                bool result = true;
+                for (int j = 0; j < 200; ++j)
+                {
+                    result = result && vowels.Replace(L"The quick brown fox", L"_") == L"Th_ q__ck br_wn f_x";
+                    result = result && vowels.IsMatch(L"e") && !vowels.IsMatch(L"x");
+                }
+                return result;
+            }));
+    }
+
+    for (auto& result : results)
+    {
+        REQUIRE(result.get());
+    }
+
+    // The clone is kept for the thread
+    REQUIRE(&vowels.ForCurrentThread() == &vowels.ForCurrentThread());
+}
@@ -169,3 +169,49 @@ TEST_CASE("Values_DWORD", "[registry]")
     REQUIRE(value->GetType() == Value::Type::DWord);
     REQUIRE(value->GetValue<Value::Type::DWord>() == valueValue);
 }
+
+TEST_CASE("ReadAllValues", "[registry]")
+{
+    std::wstring stringValueName = L"TestStringValue";
+    std::wstring stringValue = L"TestValueValue";
+    std::wstring dwordValueName = L"TestDWordValue";
+    DWORD dwordValue = 42;
+
+    wil::unique_hkey root = RegCreateVolatileTestRoot();
+    SetRegistryValue(root.get(), stringValueName, stringValue);
+    SetRegistryValue(root.get(), dwordValueName, dwordValue);
+
+    Key key{ root.get(), L"" };
+
+    auto values = key.ReadAllValues();
+    REQUIRE(values.size() == 2);
+
+    auto value = values[stringValueName];
+    REQUIRE(value);
+    REQUIRE(value->GetType() == Value::Type::String);
+    REQUIRE(value->GetValue<Value::Type::String>() == ConvertToUTF8(stringValue));
+
+    // Names are case insensitive, as with reading a single value
+    value = values[L"testdwordvalue"];
+    REQUIRE(value);
+    REQUIRE(value->GetType() == Value::Type::DWord);
+    REQUIRE(value->GetValue<Value::Type::DWord>() == dwordValue);
+
+    REQUIRE(!values[L"NotAValue"]);
+}
+
+TEST_CASE("NotifyOnChange", "[registry]")
+{
+    wil::unique_hkey root = RegCreateVolatileTestRoot();
+    Key key{ root.get(), L"" };
+
+    wil::unique_event changed;
+    changed.create();
+    key.NotifyOnChange(changed.get());
+    REQUIRE(!changed.is_signaled());
+
+    // Changes to subkeys are included
+    wil::unique_hkey subkey = RegCreateVolatileSubKey(root.get(), L"SubKey");
+    SetRegistryValue(subkey.get(), L"Value", L"Data");
+    REQUIRE(changed.wait(1000));
+}
@@ -5,6 +5,7 @@
 #include "TestRestRequestHandler.h"
 #include <Rest/RestClient.h>
 #include <Rest/Schema/IRestClient.h>
+#include <Rest/Schema/RestHelper.h>
 #include <AppInstallerVersions.h>
 #include <set>
 #include <AppInstallerErrors.h>
@@ -82,6 +83,9 @@ TEST_CASE("GetInformation_Success", "[RestSource]")
               ],
               "UnsupportedPackageMatchFields": [
                 "Moniker"
+              ],
+              "SupportedFeatures": [
+                "BatchPackageManifests"
               ]
         }})delimiter");
 
@@ -104,6 +108,8 @@ TEST_CASE("GetInformation_Success", "[RestSource]")
     REQUIRE(information.UnsupportedQueryParameters.at(0) == "Moniker");
     REQUIRE(information.UnsupportedPackageMatchFields.size() == 1);
     REQUIRE(information.UnsupportedPackageMatchFields.at(0) == "Moniker");
+    REQUIRE(information.SupportedFeatures.size() == 1);
+    REQUIRE(information.SupportedFeatures.at(0) == "BatchPackageManifests");
 }
 
 TEST_CASE("GetInformation_Fail_AgreementsWithoutIdentifier", "[RestSource]")
@@ -210,3 +216,91 @@ TEST_CASE("RestClientCreate_1.1_Success", "[RestSource]")
     REQUIRE(information.UnsupportedPackageMatchFields.size() == 1);
     REQUIRE(information.UnsupportedPackageMatchFields.at(0) == "Moniker");
 }
+
+TEST_CASE("RestClientCreate_SearchUsesHelper", "[RestSource]")
+{
+    utility::string_t information = _XPLATSTR(
+        R"delimiter({
+            "Data" : {
+              "SourceIdentifier": "Source123",
+              "ServerSupportedVersions": [
+                "1.0.0"]
+        }})delimiter");
+
+    utility::string_t search = _XPLATSTR(
+        R"delimiter({
+            "Data" : [
+               {
+              "PackageIdentifier": "git.package",
+              "PackageName": "package",
+              "Publisher": "git",
+              "Versions": [
+                {
+                    "PackageVersion": "1.0.0"
+                }]
+            }]
+        })delimiter");
+
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            web::http::http_response response;
+            response.set_body(web::json::value::parse(request.method() == web::http::methods::GET ? information : search));
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    RestClient client = RestClient::Create(utility::conversions::to_utf8string(TestRestUri), {}, HttpClientHelper{ handler });
+    IRestClient::SearchResult result = client.Search({});
+    REQUIRE(result.Matches.size() == 1);
+    REQUIRE(result.Matches[0].PackageInformation.PackageIdentifier == "git.package");
+}
+
+TEST_CASE("RestClientCreate_UsesInformationCache", "[RestSource]")
+{
+    TestCommon::TempDirectory cacheDirectory{ "RestInformationCache" };
+    auto informationCache = std::make_shared<RestInformationCache>(cacheDirectory.GetPath());
+
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : {
+              "SourceIdentifier": "Source123",
+              "ServerSupportedVersions": [
+                "1.0.0",
+                "1.1.0"]
+        }})delimiter");
+
+    size_t requestCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+            web::http::http_response response;
+            response.set_body(web::json::value::parse(sample));
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    std::string restApi = utility::conversions::to_utf8string(TestRestUri);
+    HttpClientHelper helper{ handler, {} };
+
+    RestClient first = RestClient::Create(restApi, {}, helper, informationCache);
+    REQUIRE(requestCount == 1);
+
+    RestClient second = RestClient::Create(restApi, {}, helper, informationCache);
+    REQUIRE(requestCount == 1);
+    REQUIRE(second.GetSourceIdentifier() == "Source123");
+    REQUIRE(second.GetSourceInformation().ServerSupportedVersions.size() == 2);
+
+    SECTION("Different header")
+    {
+        RestClient withHeader = RestClient::Create(restApi, "header", helper, informationCache);
+        REQUIRE(requestCount == 2);
+    }
+    SECTION("Removed")
+    {
+        informationCache->Remove(RestHelper::GetRestAPIBaseUri(restApi));
+        RestClient afterRemove = RestClient::Create(restApi, {}, helper, informationCache);
+        REQUIRE(requestCount == 2);
+    }
+}
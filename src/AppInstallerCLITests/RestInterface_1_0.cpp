@@ -4,6 +4,7 @@
 #include "TestCommon.h"
 #include "TestRestRequestHandler.h"
 #include <Rest/Schema/1_0/Interface.h>
+#include <Rest/Schema/1_0/Json/ManifestDeserializer.h>
 #include <Rest/Schema/IRestClient.h>
 #include <AppInstallerVersions.h>
 #include <AppInstallerErrors.h>
@@ -374,6 +375,155 @@ TEST_CASE("Search_ContinuationToken", "[RestSource][Interface_1_0]")
     REQUIRE(resultsWithSize1.Matches.size() == requestWithSize1.MaximumResults);
 }
 
+TEST_CASE("Search_ContinuationToken_PagesInOrder", "[RestSource][Interface_1_0]")
+{
+    // Each page has one package; the token names the next page, and the last page has none.
+    std::atomic<int> requestCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+
+            int page = 0;
+            auto tokenHeader = request.headers().find(L"ContinuationToken");
+            if (tokenHeader != request.headers().end())
+            {
+                page = std::stoi(tokenHeader->second);
+            }
+
+            std::wstring packageId = L"page" + std::to_wstring(page) + L".package";
+            web::json::value version;
+            version[L"PackageVersion"] = web::json::value::string(L"1.0.0");
+            web::json::value package;
+            package[L"PackageIdentifier"] = web::json::value::string(packageId);
+            package[L"PackageName"] = web::json::value::string(L"package");
+            package[L"Publisher"] = web::json::value::string(L"publisher");
+            package[L"Versions"] = web::json::value::array({ version });
+
+            web::json::value body;
+            body[L"Data"] = web::json::value::array({ package });
+            if (page < 3)
+            {
+                body[L"ContinuationToken"] = web::json::value::string(std::to_wstring(page + 1));
+            }
+
+            web::http::http_response response;
+            response.set_body(body);
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler };
+    Interface v1{ TestRestUriString, std::move(helper) };
+
+    SECTION("All pages")
+    {
+        Schema::IRestClient::SearchResult results = v1.Search({});
+        REQUIRE_FALSE(results.Truncated);
+        REQUIRE(results.Matches.size() == 4);
+        for (size_t i = 0; i < results.Matches.size(); ++i)
+        {
+            REQUIRE(results.Matches[i].PackageInformation.PackageIdentifier == "page" + std::to_string(i) + ".package");
+        }
+        REQUIRE(requestCount == 4);
+    }
+    SECTION("Stops at the maximum")
+    {
+        SearchRequest request{};
+        request.MaximumResults = 2;
+        Schema::IRestClient::SearchResult results = v1.Search(request);
+        REQUIRE(results.Truncated);
+        REQUIRE(results.Matches.size() == 2);
+        REQUIRE(requestCount == 2);
+    }
+    SECTION("Async")
+    {
+        pplx::task<Schema::IRestClient::SearchResult> search = v1.SearchAsync({});
+        Schema::IRestClient::SearchResult results = search.get();
+        REQUIRE(results.Matches.size() == 4);
+        REQUIRE(results.Matches[3].PackageInformation.PackageIdentifier == "page3.package");
+        REQUIRE(requestCount == 4);
+    }
+}
+
+TEST_CASE("Search_Inclusions_SearchedSeparately", "[RestSource][Interface_1_0]")
+{
+    // Each inclusion matches its own package and a package shared by all of them.
+    std::atomic<int> requestCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+
+            auto createPackage = [](const std::wstring& packageId)
+            {
+                web::json::value version;
+                version[L"PackageVersion"] = web::json::value::string(L"1.0.0");
+                web::json::value package;
+                package[L"PackageIdentifier"] = web::json::value::string(packageId);
+                package[L"PackageName"] = web::json::value::string(L"package");
+                package[L"Publisher"] = web::json::value::string(L"publisher");
+                package[L"Versions"] = web::json::value::array({ version });
+                return package;
+            };
+
+            web::json::value requestBody = request.extract_json().get();
+            std::vector<web::json::value> packages;
+            for (const auto& inclusion : requestBody.at(L"Inclusions").as_array())
+            {
+                packages.emplace_back(createPackage(inclusion.at(L"RequestMatch").at(L"KeyWord").as_string() + L".package"));
+            }
+            packages.emplace_back(createPackage(L"shared.package"));
+
+            web::json::value body;
+            body[L"Data"] = web::json::value::array(packages);
+
+            web::http::http_response response;
+            response.set_body(body);
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler };
+    Interface v1{ TestRestUriString, std::move(helper) };
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "a");
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "b");
+    request.Inclusions.emplace_back(PackageMatchField::PackageFamilyName, MatchType::Exact, "c");
+
+    TestUserSettings settings;
+
+    SECTION("Single request")
+    {
+        Schema::IRestClient::SearchResult results = v1.Search(request);
+        REQUIRE(results.Matches.size() == 4);
+        REQUIRE(requestCount == 1);
+    }
+    SECTION("Separate requests")
+    {
+        settings.Set<AppInstaller::Settings::Setting::NetworkRestSearchConcurrency>(2);
+
+        Schema::IRestClient::SearchResult results = v1.Search(request);
+        REQUIRE_FALSE(results.Truncated);
+        REQUIRE(results.Matches.size() == 4);
+        REQUIRE(results.Matches[0].PackageInformation.PackageIdentifier == "a.package");
+        REQUIRE(results.Matches[1].PackageInformation.PackageIdentifier == "shared.package");
+        REQUIRE(results.Matches[2].PackageInformation.PackageIdentifier == "b.package");
+        REQUIRE(results.Matches[3].PackageInformation.PackageIdentifier == "c.package");
+        REQUIRE(requestCount == 3);
+    }
+    SECTION("Separate requests stop at the maximum")
+    {
+        settings.Set<AppInstaller::Settings::Setting::NetworkRestSearchConcurrency>(2);
+        request.MaximumResults = 3;
+
+        Schema::IRestClient::SearchResult results = v1.Search(request);
+        REQUIRE(results.Truncated);
+        REQUIRE(results.Matches.size() == 3);
+    }
+}
+
 TEST_CASE("Search_BadResponse_NoVersions", "[RestSource][Interface_1_0]")
 {
     utility::string_t sample = _XPLATSTR(
@@ -458,6 +608,107 @@ TEST_CASE("GetManifests_GoodResponse", "[RestSource][Interface_1_0]")
     sampleManifest.VerifyInstallers_AllFields(manifest);
 }
 
+TEST_CASE("ManifestDeserializer_DeserializeAndRelease", "[RestSource][Interface_1_0]")
+{
+    // Three versions of the required fields manifest, out of order.
+    web::json::value response = web::json::value::parse(GetGoodManifest_RequiredFields());
+    web::json::array& versions = response[L"Data"][L"Versions"].as_array();
+    web::json::value version = versions.at(0);
+    versions[0][L"PackageVersion"] = web::json::value::string(L"2.0.0");
+    version[L"PackageVersion"] = web::json::value::string(L"10.0.0");
+    response[L"Data"][L"Versions"][1] = version;
+    version[L"PackageVersion"] = web::json::value::string(L"1.0.0");
+    response[L"Data"][L"Versions"][2] = version;
+
+    Json::ManifestDeserializer deserializer;
+
+    SECTION("All")
+    {
+        std::vector<Manifest> manifests = deserializer.DeserializeAndRelease(response);
+        REQUIRE(manifests.size() == 3);
+        REQUIRE(manifests[0].Version == "2.0.0");
+        REQUIRE(manifests[1].Version == "10.0.0");
+        REQUIRE(manifests[2].Version == "1.0.0");
+
+        for (const auto& released : response[L"Data"][L"Versions"].as_array())
+        {
+            REQUIRE(released.is_null());
+        }
+    }
+    SECTION("Latest")
+    {
+        Json::ManifestDeserializer::VersionSelection selection;
+        selection.LatestOnly = true;
+
+        std::vector<Manifest> manifests = deserializer.DeserializeAndRelease(response, selection);
+        REQUIRE(manifests.size() == 1);
+        REQUIRE(manifests[0].Id == "Foo.Bar");
+        REQUIRE(manifests[0].Version == "10.0.0");
+    }
+    SECTION("Version")
+    {
+        Json::ManifestDeserializer::VersionSelection selection;
+        selection.Version = "1.0.0";
+
+        std::vector<Manifest> manifests = deserializer.DeserializeAndRelease(response, selection);
+        REQUIRE(manifests.size() == 1);
+        REQUIRE(manifests[0].Version == "1.0.0");
+    }
+    SECTION("Other channel")
+    {
+        Json::ManifestDeserializer::VersionSelection selection;
+        selection.Version = "1.0.0";
+        selection.Channel = "beta";
+
+        REQUIRE(deserializer.DeserializeAndRelease(response, selection).empty());
+    }
+}
+
+TEST_CASE("GetManifestByVersion_OnlyRequestedVersionIsDeserialized", "[RestSource][Interface_1_0]")
+{
+    // The source ignores the version parameter and returns every version, one of which is not valid.
+    web::json::value response = web::json::value::parse(GetGoodManifest_RequiredFields());
+    web::json::value version = response[L"Data"][L"Versions"][0];
+    version[L"PackageVersion"] = web::json::value::string(L"6.0.0");
+    response[L"Data"][L"Versions"][1] = version;
+    version[L"PackageVersion"] = web::json::value::string(L"4.0.0");
+    version.erase(L"Installers");
+    response[L"Data"][L"Versions"][2] = version;
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, response.serialize()) };
+    Interface v1{ TestRestUriString, std::move(helper) };
+
+    auto manifest = v1.GetManifestByVersion("Foo.Bar", "5.0.0", "");
+    REQUIRE(manifest);
+    REQUIRE(manifest->Version == "5.0.0");
+
+    auto latest = v1.GetManifestByVersion("Foo.Bar", "", "");
+    REQUIRE(latest);
+    REQUIRE(latest->Version == "6.0.0");
+
+    REQUIRE_THROWS_HR(v1.GetManifestByVersion("Foo.Bar", "4.0.0", ""), APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA);
+}
+
+TEST_CASE("GetManifestsAsync_GoodResponse", "[RestSource][Interface_1_0]")
+{
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, GetGoodManifest_RequiredFields()) };
+    Interface v1{ TestRestUriString, std::move(helper) };
+
+    std::vector<Manifest> manifests = v1.GetManifestsAsync("Foo.Bar").get();
+    REQUIRE(manifests.size() == 1);
+    REQUIRE(manifests[0].Id == "Foo.Bar");
+    REQUIRE(manifests[0].Version == "5.0.0");
+}
+
+TEST_CASE("GetManifestsAsync_NotFoundCode", "[RestSource][Interface_1_0]")
+{
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::NotFound) };
+    Interface v1{ TestRestUriString, std::move(helper) };
+
+    pplx::task<std::vector<Manifest>> request = v1.GetManifestsAsync("Foo.Bar");
+    REQUIRE_THROWS_HR(request.get(), APPINSTALLER_CLI_ERROR_RESTSOURCE_ENDPOINT_NOT_FOUND);
+}
+
 TEST_CASE("GetManifests_BadResponse_SuccessCode", "[RestSource][Interface_1_0]")
 {
     utility::string_t badManifest = _XPLATSTR(
@@ -555,4 +555,112 @@ TEST_CASE("GetManifests_GoodResponse_V1_1", "[RestSource][Interface_1_0]")
     REQUIRE(manifest.Channel == "");
     sampleManifest.VerifyLocalizations_AllFields(manifest);
     sampleManifest.VerifyInstallers_AllFields(manifest);
-}
\ No newline at end of file
+}
+TEST_CASE("GetManifestsForPackages", "[RestSource][Interface_1_1]")
+{
+    auto getSamplePackage = [](std::string_view id)
+    {
+        std::string result = R"delimiter({
+            "PackageIdentifier": "<ID>",
+            "Versions": [
+                {
+                    "PackageVersion": "5.0.0",
+                    "DefaultLocale": {
+                        "PackageLocale": "en-us",
+                        "Publisher": "Foo",
+                        "PackageName": "Bar",
+                        "License": "Foo bar license",
+                        "ShortDescription": "Foo bar description"
+                    },
+                    "Installers": [
+                        {
+                            "Architecture": "x64",
+                            "InstallerSha256": "011048877dfaef109801b3f3ab2b60afc74f3fc4f7b3430e0c897f5da1df84b6",
+                            "InstallerType": "exe",
+                            "InstallerUrl": "https://installer.example.com/foobar.exe"
+                        }
+                    ]
+                }
+            ]
+        })delimiter";
+
+        result.replace(result.find("<ID>"), 4, id);
+        return web::json::value::parse(ConvertToUTF16(result));
+    };
+
+    std::atomic<size_t> postCount = 0;
+    std::atomic<size_t> getCount = 0;
+
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            web::json::value body;
+            body[L"Data"] = web::json::value::null();
+
+            if (request.method() == web::http::methods::POST)
+            {
+                // Respond with the packages in the opposite order to the request
+                ++postCount;
+                const auto& ids = request.extract_json().get().at(L"PackageIdentifiers").as_array();
+                web::json::value data = web::json::value::array();
+                for (size_t i = 0; i < ids.size(); ++i)
+                {
+                    data[i] = getSamplePackage(ConvertToUTF8(ids.at(ids.size() - 1 - i).as_string()));
+                }
+                body[L"Data"] = std::move(data);
+            }
+            else
+            {
+                ++getCount;
+                utility::string_t path = request.relative_uri().path();
+                body[L"Data"] = getSamplePackage(ConvertToUTF8(path.substr(path.rfind(L'/') + 1)));
+            }
+
+            web::http::http_response response;
+            response.set_body(body);
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    IRestClient::Information info;
+    std::vector<std::string> packageIds = { "Foo.Bar", "Foo.Baz", "Foo.Qux" };
+
+    SECTION("Batch request")
+    {
+        info.SupportedFeatures.emplace_back("BatchPackageManifests");
+    }
+    SECTION("Individual requests")
+    {
+    }
+
+    Interface v1_1{ TestRestUriString, info, {}, HttpClientHelper{ handler } };
+    auto results = v1_1.GetManifestsForPackages(packageIds);
+
+    REQUIRE(results.size() == packageIds.size());
+    for (size_t i = 0; i < packageIds.size(); ++i)
+    {
+        REQUIRE(results[i].size() == 1);
+        REQUIRE(results[i][0].Id == packageIds[i]);
+        REQUIRE(results[i][0].Version == "5.0.0");
+    }
+
+    if (info.SupportedFeatures.empty())
+    {
+        REQUIRE(postCount == 0);
+        REQUIRE(getCount == packageIds.size());
+    }
+    else
+    {
+        REQUIRE(postCount == 1);
+        REQUIRE(getCount == 0);
+    }
+}
+
+TEST_CASE("SupportsDependencyClosure", "[RestSource][Interface_1_1]")
+{
+    IRestClient::Information info;
+    REQUIRE(!Interface{ TestRestUriString, info }.SupportsDependencyClosure());
+
+    info.SupportedFeatures.emplace_back("dependencyclosure");
+    REQUIRE(Interface{ TestRestUriString, info }.SupportsDependencyClosure());
+}
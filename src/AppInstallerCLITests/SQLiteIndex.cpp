@@ -19,6 +19,13 @@
 #include <Microsoft/Schema/1_0/CommandsTable.h>
 #include <Microsoft/Schema/1_0/SearchResultsTable.h>
 #include <Microsoft/Schema/1_4/DependenciesTable.h>
+#include <Microsoft/Schema/1_5/FullTextTable.h>
+#include <Microsoft/Schema/1_6/VersionKeyTable.h>
+#include <Microsoft/Schema/1_7/InstallerApplicabilityTable.h>
+#include <Microsoft/Schema/1_8/TrigramTable.h>
+#include <Microsoft/Schema/1_9/FoldedValueTable.h>
+#include <winget/InstallerApplicability.h>
+#include <winget/ManifestYamlParser.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -34,7 +41,7 @@ SQLiteIndex CreateTestIndex(const std::string& filePath, std::optional<Schema::V
     // If no specific version requested, then use generator to run against the last 3 versions.
     if (!version)
     {
-        version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version::Latest());
+        version = GENERATE(Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version::Latest());
     }
 
     return SQLiteIndex::CreateNew(filePath, version.value());
@@ -72,6 +79,66 @@ Schema::Version TestPrepareForRead(SQLiteIndex& index)
             return version;
         }
     }
+    else if (index.GetVersion() == Schema::Version{ 1, 5 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 });
+
+        if (version != Schema::Version{ 1, 5 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 6 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 });
+
+        if (version != Schema::Version{ 1, 6 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 7 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 });
+
+        if (version != Schema::Version{ 1, 7 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 8 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 }, Schema::Version{ 1, 8 });
+
+        if (version != Schema::Version{ 1, 8 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 9 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 }, Schema::Version{ 1, 8 }, Schema::Version{ 1, 9 });
+
+        if (version != Schema::Version{ 1, 9 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 10 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 }, Schema::Version{ 1, 8 }, Schema::Version{ 1, 9 }, Schema::Version{ 1, 10 });
+
+        if (version != Schema::Version{ 1, 10 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
 
     return index.GetVersion();
 }
@@ -330,6 +397,12 @@ std::string GetNameStringById(const SQLiteIndex& index, SQLite::rowid_t id)
     return GetPropertyStringById(index, id, PackageVersionProperty::Name);
 }
 
+std::string ReadFileContents(const std::filesystem::path& file)
+{
+    std::ifstream stream(file, std::ios_base::in | std::ios_base::binary);
+    return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+}
+
 std::string GetPathStringByKey(const SQLiteIndex& index, SQLite::rowid_t id, std::string_view version, std::string_view channel)
 {
     return GetPropertyStringByKey(index, id, PackageVersionProperty::RelativePath, version, channel);
@@ -371,6 +444,14 @@ TEST_CASE("SQLiteIndexCreateLatestAndReopen", "[sqliteindex]")
         Schema::Version versionRead = index.GetVersion();
         REQUIRE(versionRead == versionCreated);
     }
+
+    // Reopen the index for memory mapped immutable read
+    {
+        INFO("Trying with ImmutableMapped");
+        SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::ImmutableMapped);
+        Schema::Version versionRead = index.GetVersion();
+        REQUIRE(versionRead == versionCreated);
+    }
 }
 
 TEST_CASE("SQLiteIndexCreateAndAddManifest", "[sqliteindex]")
@@ -397,6 +478,155 @@ TEST_CASE("SQLiteIndexCreateAndAddManifestFile", "[sqliteindex]")
     index.AddManifest(manifestFile, manifestPath);
 }
 
+TEST_CASE("SQLiteIndex_AddManifests", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    TestDataFile manifestFile1{ "Manifest-Good.yaml" };
+    TestDataFile manifestFile2{ "Manifest-Good-SystemReferenceComplex.yaml" };
+
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> manifests;
+    manifests.emplace_back(manifestFile1, "microsoft/msixsdk/microsoft.msixsdk-1.7.32.yaml");
+    manifests.emplace_back(manifestFile2, "microsoft/sysrefcomp/microsoft.sysrefcomp-1.7.32.yaml");
+
+    auto ids = index.AddManifests(manifests);
+    REQUIRE(ids.size() == 2);
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "microsoft.sysrefcomp");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(index.GetPropertyByManifestId(results.Matches[0].first, PackageVersionProperty::RelativePath) == manifests[1].second.u8string());
+}
+
+TEST_CASE("SQLiteIndex_AddManifest_PathPartCacheInvalidation", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    auto makeManifest = [](std::string id)
+    {
+        Manifest manifest;
+        manifest.Installers.push_back({});
+        manifest.Id = id;
+        manifest.DefaultLocalization.Add<Localization::PackageName>("Test Name");
+        manifest.Version = "1.0.0";
+        return manifest;
+    };
+
+    Manifest manifest1 = makeManifest("test.one");
+    Manifest manifest2 = makeManifest("test.two");
+    Manifest manifest3 = makeManifest("test.three");
+
+    index.AddManifest(manifest1, "test/one/test.one-1.0.0.yaml");
+
+    {
+        // Parts created inside of the rolled back savepoint must not be reused from the cache
+        auto savepoint = index.CreateSavepoint("pathpartcache_test");
+        index.AddManifest(manifest2, "test/two/test.two-1.0.0.yaml");
+        savepoint.Rollback();
+    }
+
+    index.AddManifest(manifest2, "test/two/test.two-1.0.0.yaml");
+    REQUIRE(index.CheckConsistency(true));
+
+    // Removing a manifest removes its parts, which must not be reused from the cache
+    index.RemoveManifest(manifest1, "test/one/test.one-1.0.0.yaml");
+    index.AddManifest(manifest3, "test/one/test.three-1.0.0.yaml");
+    REQUIRE(index.CheckConsistency(true));
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "test.three");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(index.GetPropertyByManifestId(results.Matches[0].first, PackageVersionProperty::RelativePath) == "test/one/test.three-1.0.0.yaml");
+}
+
+TEST_CASE("SQLiteIndex_ApplyManifestChanges", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    TestDataFile manifestFile1{ "Manifest-Good.yaml" };
+    TestDataFile manifestFile2{ "Manifest-Good-SystemReferenceComplex.yaml" };
+
+    std::filesystem::path relativePath1 = "microsoft/msixsdk/microsoft.msixsdk-1.7.32.yaml";
+    std::filesystem::path relativePath2 = "microsoft/sysrefcomp/microsoft.sysrefcomp-1.7.32.yaml";
+    std::filesystem::path movedPath2 = "microsoft/moved/microsoft.sysrefcomp-1.7.32.yaml";
+
+    index.AddManifest(manifestFile1, relativePath1);
+
+    auto findRelativePath = [&](std::string_view id)
+    {
+        SearchRequest request;
+        request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, id);
+
+        auto results = index.Search(request);
+        return results.Matches.empty() ? std::optional<std::string>{} : index.GetPropertyByManifestId(results.Matches[0].first, PackageVersionProperty::RelativePath);
+    };
+
+    // An unchanged manifest does not modify the index
+    REQUIRE(!index.ApplyManifestChanges({ { SQLiteIndex::ManifestChangeType::Modified, manifestFile1, relativePath1 } }));
+
+    REQUIRE(index.ApplyManifestChanges({
+        { SQLiteIndex::ManifestChangeType::Modified, manifestFile1, relativePath1 },
+        { SQLiteIndex::ManifestChangeType::Added, manifestFile2, relativePath2 },
+        }));
+    REQUIRE(findRelativePath("microsoft.sysrefcomp") == relativePath2.u8string());
+
+    // Moving a manifest removes it by its old path, which no longer has a file
+    REQUIRE(index.ApplyManifestChanges({
+        { SQLiteIndex::ManifestChangeType::Added, manifestFile2, movedPath2 },
+        { SQLiteIndex::ManifestChangeType::Removed, {}, relativePath2 },
+        }));
+    REQUIRE(findRelativePath("microsoft.sysrefcomp") == movedPath2.u8string());
+
+    // Nothing is changed if any of the changes fail
+    REQUIRE_THROWS(index.ApplyManifestChanges({
+        { SQLiteIndex::ManifestChangeType::Removed, {}, movedPath2 },
+        { SQLiteIndex::ManifestChangeType::Removed, {}, relativePath2 },
+        }));
+    REQUIRE(findRelativePath("microsoft.sysrefcomp") == movedPath2.u8string());
+
+    REQUIRE(index.ApplyManifestChanges({
+        { SQLiteIndex::ManifestChangeType::Removed, {}, relativePath1 },
+        { SQLiteIndex::ManifestChangeType::Removed, {}, movedPath2 },
+        }));
+    REQUIRE(index.Search({}).Matches.empty());
+    REQUIRE(index.CheckConsistency(true));
+}
+
+TEST_CASE("SQLiteIndex_AddManifests_InvalidManifest", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    TestDataFile manifestFile1{ "Manifest-Good-SystemReferenceComplex.yaml" };
+    TestDataFile manifestFile2{ "Manifest-Bad-ArchInvalid.yaml" };
+
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> manifests;
+    manifests.emplace_back(manifestFile1, "microsoft/sysrefcomp/microsoft.sysrefcomp-1.7.32.yaml");
+    manifests.emplace_back(manifestFile2, "microsoft/msixsdk/microsoft.msixsdk-1.7.32.yaml");
+
+    REQUIRE_THROWS(index.AddManifests(manifests));
+
+    // Nothing is added if any of the manifests is not valid.
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "microsoft.sysrefcomp");
+    REQUIRE(index.Search(request).Matches.empty());
+}
+
 TEST_CASE("SQLiteIndexCreateAndAddManifestDuplicate", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -488,6 +718,68 @@ TEST_CASE("SQLiteIndex_AddManifestWithDependencies", "[sqliteindex][V1_4]")
     index.AddManifest(manifest, GetPathFromManifest(manifest));
 }
 
+TEST_CASE("SQLiteIndex_DependencyClosure", "[sqliteindex][V1_4]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    // Top -> Middle -> Bottom, where Middle also depends on Shared without a version; Other only depends on Shared.
+    Manifest bottom, shared, middle, top, other;
+    SQLiteIndex index = SimpleTestSetup(tempFile, bottom, Schema::Version::Latest());
+
+    CreateFakeManifest(shared, "Shared");
+    index.AddManifest(shared, GetPathFromManifest(shared));
+
+    CreateFakeManifest(middle, "Middle");
+    middle.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, bottom.Id, "1.0.0"));
+    middle.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, shared.Id));
+    index.AddManifest(middle, GetPathFromManifest(middle));
+
+    CreateFakeManifest(top, "Top");
+    top.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, middle.Id, "1.0.0"));
+    index.AddManifest(top, GetPathFromManifest(top));
+
+    CreateFakeManifest(other, "Other");
+    other.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, shared.Id, "1.0.0"));
+    index.AddManifest(other, GetPathFromManifest(other));
+
+    auto topManifestId = index.GetManifestIdByManifest(top);
+    REQUIRE(topManifestId);
+
+    auto dependencies = index.GetDependencyClosureByManifestRowId(topManifestId.value());
+    REQUIRE(dependencies.size() == 3);
+
+    size_t unversioned = 0;
+    for (const auto& entry : dependencies)
+    {
+        unversioned += (entry.MinVersion.empty() ? 1 : 0);
+    }
+    REQUIRE(unversioned == 1);
+
+    // Bottom is depended on by Middle, which is depended on by Top; Other is not involved.
+    auto dependents = index.GetDependentClosureById(bottom.Id);
+    REQUIRE(dependents.size() == 2);
+    for (const auto& entry : dependents)
+    {
+        REQUIRE(entry.MinVersion == "1.0.0");
+        REQUIRE(entry.ManifestId != index.GetManifestIdByManifest(other).value());
+    }
+
+    // Both Middle and Other depend on Shared, and Top depends on Middle.
+    REQUIRE(index.GetDependentClosureById(shared.Id).size() == 3);
+    REQUIRE(index.GetDependentClosureById(top.Id).empty());
+
+    // Every dependency row, and only the manifests of packages that are depended on.
+    auto snapshot = index.GetDependencySnapshot();
+    REQUIRE(snapshot.Dependencies.size() == 4);
+    REQUIRE(snapshot.Manifests.size() == 3);
+    for (const auto& entry : snapshot.Manifests)
+    {
+        REQUIRE((entry.Id == bottom.Id || entry.Id == shared.Id || entry.Id == middle.Id));
+        REQUIRE(entry.Version == "1.0.0");
+    }
+}
+
 TEST_CASE("SQLiteIndex_AddManifestWithDependencies_MissingPackage", "[sqliteindex][V1_4]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -1580,6 +1872,467 @@ TEST_CASE("SQLiteIndex_PrepareForPackaging", "[sqliteindex]")
     index.PrepareForPackaging();
 }
 
+TEST_CASE("SQLiteIndex_DeferIndices", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    auto indexExists = [&](std::string_view name)
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        Statement statement = Statement::Create(connection, "select count(*) from sqlite_master where type = 'index' and name = ?");
+        statement.Bind(1, name);
+        REQUIRE(statement.Step());
+        return statement.GetColumn<int64_t>(0) != 0;
+    };
+
+    Manifest manifest;
+    CreateFakeManifest(manifest, "Test");
+    manifest.Installers[0].PackageFamilyName = "Test_pfn";
+    std::string relativePath = GetPathFromManifest(manifest);
+
+    {
+        SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version::Latest(), SQLiteIndex::CreateOptions::DeferIndices);
+        index.AddManifest(manifest, relativePath);
+
+        Manifest other;
+        CreateFakeManifest(other, "Other");
+        index.AddManifest(other, GetPathFromManifest(other));
+
+        // Updates and removals still work without the deferred indices.
+        other.DefaultLocalization.Add<Localization::Tags>({ "t3" });
+        REQUIRE(index.UpdateManifest(other, GetPathFromManifest(other)));
+        index.RemoveManifest(other, GetPathFromManifest(other));
+    }
+
+    REQUIRE(!indexExists("tags_map_index"));
+    REQUIRE(!indexExists("pfns_map_index"));
+
+    {
+        SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::ReadWrite);
+        index.PrepareForPackaging();
+    }
+
+    // Only the indices that are kept for the packaged index are built.
+    REQUIRE(!indexExists("tags_map_index"));
+    REQUIRE(indexExists("pfns_map_index"));
+
+    SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::Read);
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::PackageFamilyName, MatchType::Exact, "test_pfn");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+}
+
+TEST_CASE("SQLiteIndex_PrepareForPackaging_FullTextSearch", "[sqliteindex][V1_5]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Awesome Name", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Id2", "Other Thing", "Moniker2", "Version", "Channel", { "AwesomeTag" }, { "Command" }, "Path2" },
+        { "Id3", "Unrelated", "Moniker3", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        }, Schema::Version{ 1, 5 });
+
+    index.PrepareForPackaging();
+
+    bool fullTextAvailable = false;
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        fullTextAvailable = Schema::V1_5::FullTextTable::IsAvailable(connection);
+    }
+    INFO("Full text table available: " << fullTextAvailable);
+
+    // Substring matches are the same whether or not the full text table could be created
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "WESOME");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 2);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Id1");
+    REQUIRE(results.Matches[0].second.Field == PackageMatchField::Name);
+    REQUIRE(GetIdStringById(index, results.Matches[1].first) == "Id2");
+    REQUIRE(results.Matches[1].second.Field == PackageMatchField::Tag);
+
+    if (fullTextAvailable)
+    {
+        REQUIRE(results.Ranks.size() == 2);
+    }
+
+    // Values that are too short for the full text table still find results
+    request.Query = RequestMatch(MatchType::Substring, "d3");
+
+    results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Id3");
+    REQUIRE(results.Ranks.empty());
+
+    // Fuzzy matching is only supported through the full text table
+    request.Query.reset();
+    request.Inclusions.emplace_back(PackageMatchField::Name, MatchType::Fuzzy, "thing");
+
+    results = index.Search(request);
+    REQUIRE(results.Matches.size() == (fullTextAvailable ? 1 : 0));
+}
+
+TEST_CASE("SQLiteIndex_TrigramTable_Distance", "[sqliteindex][V1_8]")
+{
+    REQUIRE(Schema::V1_8::TrigramTable::GetDistance("kitten", "sitting", false) == 3);
+    REQUIRE(Schema::V1_8::TrigramTable::GetDistance("FIREFOX", "firefox", false) == 0);
+    REQUIRE(Schema::V1_8::TrigramTable::GetDistance("firefix", "Mozilla Firefox", true) == 1);
+    REQUIRE(Schema::V1_8::TrigramTable::GetDistance("firefix", "Mozilla Firefox", false) == 9);
+
+    REQUIRE(Schema::V1_8::TrigramTable::GetMaximumDistance("vs") == 0);
+    REQUIRE(Schema::V1_8::TrigramTable::GetMaximumDistance("git") == 1);
+    REQUIRE(Schema::V1_8::TrigramTable::GetMaximumDistance("Mozilla.Firefox") == 2);
+}
+
+TEST_CASE("SQLiteIndex_PrepareForPackaging_FuzzySearch", "[sqliteindex][V1_8]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Mozilla.Firefax", "Some Browser", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Mozilla.Firefox", "Mozilla Firefox", "Moniker2", "Version", "Channel", { "Tag" }, { "Command" }, "Path2" },
+        { "Other.Package", "Unrelated", "Moniker3", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        }, Schema::Version{ 1, 8 });
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Fuzzy, "mozila.firefox");
+
+    // Without the trigram table, there is nothing to perform the fuzzy match against
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.empty());
+
+    index.PrepareForPackaging();
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(Schema::V1_8::TrigramTable::IsAvailable(connection));
+    }
+
+    // Both ids are within the allowed distance, and the closest is first even though it was added last
+    results = index.Search(request);
+    REQUIRE(results.Matches.size() == 2);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Mozilla.Firefox");
+    REQUIRE(results.Matches[0].second.Type == MatchType::Fuzzy);
+    REQUIRE(GetIdStringById(index, results.Matches[1].first) == "Mozilla.Firefax");
+
+    // The order is kept when the results are limited
+    request.MaximumResults = 1;
+    results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Mozilla.Firefox");
+    REQUIRE(results.Truncated);
+
+    // A fuzzy substring matches the closest part of the name
+    request.MaximumResults = 0;
+    request.Inclusions.clear();
+    request.Inclusions.emplace_back(PackageMatchField::Name, MatchType::FuzzySubstring, "firefix");
+
+    results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Mozilla.Firefox");
+
+    // Values that are too far away are not matched
+    request.Inclusions.clear();
+    request.Inclusions.emplace_back(PackageMatchField::Name, MatchType::Fuzzy, "chrome");
+
+    results = index.Search(request);
+    REQUIRE(results.Matches.empty());
+}
+
+TEST_CASE("SQLiteIndex_PrepareForPackaging_FoldedValues", "[sqliteindex][V1_9]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "\xC3\x89" "clair Editor", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Id2", "Other Thing", "Moniker2", "Version", "Channel", { "EditTag" }, { "Command" }, "Path2" },
+        { "Id3", "Unrelated", "Moniker3", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        }, Schema::Version{ 1, 9 });
+
+    auto searchForIds = [&](PackageMatchField field, MatchType type, const std::string& value)
+    {
+        SearchRequest request;
+        request.Inclusions.emplace_back(field, type, value);
+
+        std::vector<std::string> result;
+        for (const auto& match : index.Search(request).Matches)
+        {
+            result.emplace_back(GetIdStringById(index, match.first));
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    auto runSearches = [&]()
+    {
+        REQUIRE(searchForIds(PackageMatchField::Id, MatchType::CaseInsensitive, "ID2") == std::vector<std::string>{ "Id2" });
+        REQUIRE(searchForIds(PackageMatchField::Name, MatchType::CaseInsensitive, "\xC3\xA9" "CLAIR EDITOR") == std::vector<std::string>{ "Id1" });
+        REQUIRE(searchForIds(PackageMatchField::Name, MatchType::StartsWith, "\xC3\xA9" "cl") == std::vector<std::string>{ "Id1" });
+        REQUIRE(searchForIds(PackageMatchField::Moniker, MatchType::StartsWith, "MONIKER") == std::vector<std::string>{ "Id1", "Id2", "Id3" });
+        REQUIRE(searchForIds(PackageMatchField::Tag, MatchType::StartsWith, "edit") == std::vector<std::string>{ "Id2" });
+        REQUIRE(searchForIds(PackageMatchField::Tag, MatchType::CaseInsensitive, "TAG") == std::vector<std::string>{ "Id1", "Id3" });
+        REQUIRE(searchForIds(PackageMatchField::Command, MatchType::CaseInsensitive, "comm").empty());
+        REQUIRE(searchForIds(PackageMatchField::Id, MatchType::StartsWith, "%").empty());
+    };
+
+    // The results are the same through the value tables and the folded values
+    runSearches();
+
+    index.PrepareForPackaging();
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(Schema::V1_9::FoldedValueTable::IsAvailable(connection));
+    }
+
+    runSearches();
+}
+
+TEST_CASE("SQLiteIndex_ManifestContent", "[sqliteindex][V1_10]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    TestDataFile manifestFile{ "Manifest-Good.yaml" };
+    std::string olderContent;
+    {
+        std::ifstream stream{ manifestFile.GetPath(), std::ios::binary };
+        olderContent = AppInstaller::Utility::ReadEntireStream(stream);
+    }
+
+    TempFile newerManifestFile{ "repolibtest_manifest"s, ".yaml"s };
+    std::string newerContent = olderContent;
+    REQUIRE(AppInstaller::Utility::FindAndReplace(newerContent, "Version: 1.7.32", "Version: 1.7.33"));
+    {
+        std::ofstream stream{ newerManifestFile.GetPath(), std::ios::binary | std::ios::trunc };
+        stream << newerContent;
+    }
+
+    std::filesystem::path olderPath{ "microsoft/msixsdk/microsoft.msixsdk-1.7.32.yaml" };
+    std::filesystem::path newerPath{ "microsoft/msixsdk/microsoft.msixsdk-1.7.33.yaml" };
+
+    {
+        // The content is only stored on request.
+        TempFile defaultTempFile{ "repolibtest_tempdb"s, ".db"s };
+        SQLiteIndex index = SQLiteIndex::CreateNew(defaultTempFile, Schema::Version::Latest());
+        SQLiteIndex::IdType manifestId = index.AddManifest(manifestFile, olderPath);
+        REQUIRE(!index.GetManifestContentById(manifestId));
+    }
+
+    uint32_t versions = GENERATE(1u, 2u);
+
+    SQLiteIndex::IdType olderId = 0;
+    SQLiteIndex::IdType newerId = 0;
+
+    {
+        SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version::Latest(), SQLiteIndex::CreateOptions::ManifestContentSupport);
+        index.SetManifestContentVersions(versions);
+
+        olderId = index.AddManifest(manifestFile, olderPath);
+        newerId = index.AddManifest(newerManifestFile, newerPath);
+
+        REQUIRE(index.GetManifestContentById(olderId) == olderContent);
+        REQUIRE(index.GetManifestContentById(newerId) == newerContent);
+        REQUIRE(YamlParser::Create(index.GetManifestContentById(newerId).value()).Version == "1.7.33");
+
+        index.PrepareForPackaging();
+    }
+
+    SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::Read);
+
+    // Only the highest versions of each package keep their content.
+    REQUIRE(index.GetManifestContentById(newerId) == newerContent);
+    REQUIRE(index.GetManifestContentById(olderId).has_value() == (versions > 1));
+}
+
+TEST_CASE("SQLiteIndex_PrepareForPackaging_Statistics", "[sqliteindex][V1_5]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version1", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Id1", "Name1", "Moniker", "Version2", "Channel", { "Tag" }, { "Command" }, "Path2" },
+        { "Id2", "Name2", "Moniker2", "Version1", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        }, Schema::Version{ 1, 5 });
+
+    index.PrepareForPackaging();
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+            Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals("sqlite_stat1"sv);
+
+        Statement statement = builder.Prepare(connection);
+        REQUIRE(statement.Step());
+        REQUIRE(statement.GetColumn<int>(0) == 1);
+    }
+
+    // Lookups through the covering index return the same data
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, "Id1");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+
+    auto versions = index.GetVersionKeysById(results.Matches[0].first);
+    REQUIRE(versions.size() == 2);
+}
+
+TEST_CASE("SQLiteIndex_VersionKey_MatchesVersionOrder", "[sqliteindex][V1_6]")
+{
+    std::vector<std::string> versions =
+    {
+        "unknown", "", "0.1", "1.0-alpha", "1.0-beta", "1.0-beta.1", "1.0", "1.0.0", "1.0.1", "1.2", "1.10", "1.10.0.1",
+        "2.fork", "2", "v2", "18446744073709551616", "latest", "LATEST",
+    };
+
+    for (const auto& a : versions)
+    {
+        for (const auto& b : versions)
+        {
+            INFO(a << " | " << b);
+            Version versionA{ a };
+            Version versionB{ b };
+            auto keyA = Schema::V1_6::VersionKeyTable::GetKey(versionA);
+            auto keyB = Schema::V1_6::VersionKeyTable::GetKey(versionB);
+
+            REQUIRE((versionA < versionB) == (keyA < keyB));
+            REQUIRE((versionA == versionB) == (keyA == keyB));
+        }
+    }
+}
+
+TEST_CASE("SQLiteIndex_VersionKey_GetVersionKeysById", "[sqliteindex][V1_6]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "1.2", "", { "Tag" }, { "Command" }, "Path1" },
+        { "Id1", "Name1", "Moniker", "1.10", "", { "Tag" }, { "Command" }, "Path2" },
+        { "Id1", "Name1", "Moniker", "1.10-beta", "", { "Tag" }, { "Command" }, "Path3" },
+        { "Id1", "Name1", "Moniker", "2.0", "beta", { "Tag" }, { "Command" }, "Path4" },
+        { "Id2", "Name2", "Moniker2", "1.10", "", { "Tag" }, { "Command" }, "Path5" },
+        }, Schema::Version{ 1, 6 });
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, "Id1");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    SQLiteIndex::IdType id = results.Matches[0].first;
+
+    auto versions = index.GetVersionKeysById(id);
+    REQUIRE(versions.size() == 4);
+    REQUIRE(versions[0].ToString() == "1.10");
+    REQUIRE(versions[1].ToString() == "1.10-beta");
+    REQUIRE(versions[2].ToString() == "1.2");
+    REQUIRE(versions[3].ToString() == "2.0[beta]");
+
+    // Keys for versions that are still referenced are kept
+    auto manifestId = index.GetManifestIdByKey(id, "1.10", "");
+    REQUIRE(manifestId);
+    index.RemoveManifestById(manifestId.value());
+    REQUIRE(index.CheckConsistency(true));
+
+    versions = index.GetVersionKeysById(id);
+    REQUIRE(versions.size() == 3);
+    REQUIRE(versions[0].ToString() == "1.10-beta");
+}
+
+TEST_CASE("SQLiteIndex_VersionKey_GetManifestIdByKey", "[sqliteindex][V1_6]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "1.2", "", { "Tag" }, { "Command" }, "Path1" },
+        { "Id1", "Name1", "Moniker", "1.10", "", { "Tag" }, { "Command" }, "Path2" },
+        { "Id1", "Name1", "Moniker", "1.10-Beta", "", { "Tag" }, { "Command" }, "Path3" },
+        { "Id1", "Name1", "Moniker", "2.0", "beta", { "Tag" }, { "Command" }, "Path4" },
+        { "Id2", "Name2", "Moniker2", "3.0", "", { "Tag" }, { "Command" }, "Path5" },
+        }, Schema::Version{ 1, 6 });
+
+    // The lookups must not depend on the indices that are removed for packaging
+    index.PrepareForPackaging();
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, "Id1");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    SQLiteIndex::IdType id = results.Matches[0].first;
+
+    // The highest version wins, even though it is not the highest as a string
+    REQUIRE(GetPathStringByKey(index, id, "", "") == "Path2");
+    REQUIRE(GetPathStringByKey(index, id, "", "beta") == "Path4");
+    REQUIRE(GetPathStringByKey(index, id, "1.10-beta", "") == "Path3");
+    REQUIRE(GetPathStringByKey(index, id, "1.2", "") == "Path1");
+
+    // A version of a different package does not match
+    REQUIRE(!index.GetManifestIdByKey(id, "3.0", ""));
+    REQUIRE(!index.GetManifestIdByKey(id, "2.0", ""));
+    REQUIRE(!index.GetManifestIdByKey(id, "", "gamma"));
+}
+
+TEST_CASE("SQLiteIndex_Delta", "[sqliteindex]")
+{
+    TempFile fromFile{ "repolibtest_tempdb"s, ".db"s };
+    TempFile toFile{ "repolibtest_tempdb"s, ".db"s };
+    TempFile deltaFile{ "repolibtest_delta"s, ".delta"s };
+    TempFile resultFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary files named: " << fromFile.GetPath() << ", " << toFile.GetPath());
+
+    {
+        SQLiteIndex index = SearchTestSetup(fromFile, {
+            { "Id1", "Name1", "Moniker", "Version1", "Channel", { "Tag" }, { "Command" }, "Path1" },
+            { "Id2", "Name2", "Moniker2", "Version1", "Channel", { "Tag" }, { "Command" }, "Path2" },
+            }, Schema::Version::Latest());
+        index.PrepareForPackaging();
+    }
+
+    {
+        SQLiteIndex index = SearchTestSetup(toFile, {
+            { "Id1", "Name1", "Moniker", "Version1", "Channel", { "Tag" }, { "Command" }, "Path1" },
+            { "Id1", "Name1", "Moniker", "Version2", "Channel", { "Tag" }, { "Command" }, "Path3" },
+            { "Id2", "Name2", "Moniker2", "Version1", "Channel", { "Tag" }, { "Command" }, "Path2" },
+            }, Schema::Version::Latest());
+        index.PrepareForPackaging();
+    }
+
+    SQLiteIndex::CreateDelta(fromFile, toFile, deltaFile);
+    SQLiteIndex::ApplyDelta(fromFile, deltaFile, resultFile);
+
+    REQUIRE(std::filesystem::file_size(resultFile.GetPath()) == std::filesystem::file_size(toFile.GetPath()));
+    REQUIRE(ReadFileContents(resultFile) == ReadFileContents(toFile));
+
+    {
+        SQLiteIndex index = SQLiteIndex::Open(resultFile, SQLiteIndex::OpenDisposition::Read);
+
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Exact, "Id1");
+
+        auto results = index.Search(request);
+        REQUIRE(results.Matches.size() == 1);
+        REQUIRE(index.GetVersionKeysById(results.Matches[0].first).size() == 2);
+    }
+
+    // The delta only applies to the index that it was created from
+    REQUIRE_THROWS_HR(SQLiteIndex::ApplyDelta(toFile, deltaFile, resultFile), APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+}
+
 TEST_CASE("SQLiteIndex_Search_IdExactMatch", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -2103,6 +2856,36 @@ TEST_CASE("SQLiteIndex_Search_QueryAndMultipleFilters", "[sqliteindex]")
     REQUIRE(result == "Id3");
 }
 
+TEST_CASE("SQLiteIndex_Search_SeedFromSelectiveFilter", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version", "Channel", { "utilities" }, { "com1" }, "Path1" },
+        { "Id2", "Name2", "Moniker", "Version", "Channel", { "utilities" }, { "com2" }, "Path2" },
+        { "Id2", "Name2", "Moniker", "Version2", "Channel", { "utilities" }, { "com2" }, "Path3" },
+        { "Id3", "Name3", "Moniker", "Version", "Channel", { "other" }, { "com3" }, "Path4" },
+        });
+
+    TestPrepareForRead(index);
+
+    SearchRequest request;
+    request.Filters.emplace_back(PackageMatchField::Tag, MatchType::Exact, "utilities");
+    request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, "Id2");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Id2");
+
+    // The match is still attributed to the first filter, even though the results were seeded from the id
+    REQUIRE(results.Matches[0].second.Field == PackageMatchField::Tag);
+    REQUIRE(results.Matches[0].second.Value == "utilities");
+
+    request.Filters[1].Value = "Id3";
+    REQUIRE(index.Search(request).Matches.empty());
+}
+
 TEST_CASE("SQLiteIndex_Search_SimpleICULike", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -2582,7 +3365,50 @@ TEST_CASE("SQLiteIndex_CheckConsistency_Failure", "[sqliteindex][V1_1]")
         SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::ReadWrite);
 
         REQUIRE(!index.CheckConsistency(true));
+
+        // Every check is run and reported when logging, and only the broken reference is inconsistent
+        std::vector<SQLiteIndex::ConsistencyCheckResult> results;
+        REQUIRE(!index.CheckConsistency(true, results));
+        REQUIRE(results.size() == 9);
+
+        for (const auto& checkResult : results)
+        {
+            INFO(checkResult.Name);
+            REQUIRE(checkResult.Consistent == (checkResult.Name != "manifest_ids"));
+        }
+    }
+}
+
+TEST_CASE("SQLiteIndex_CheckConsistency_ResultsInOrder", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version::Latest());
+
+    Manifest manifest;
+    manifest.Installers.push_back({});
+    manifest.Id = "test.id";
+    manifest.DefaultLocalization.Add<Localization::PackageName>("Test Name");
+    manifest.Version = "1.0.0";
+    index.AddManifest(manifest, "test/id/test.id-1.0.0.yaml");
+
+    std::vector<SQLiteIndex::ConsistencyCheckResult> results;
+    REQUIRE(index.CheckConsistency(false, results));
+    REQUIRE(!results.empty());
+    REQUIRE(results.front().Name == "manifest_ids");
+    REQUIRE(results.back().Name == "versionkeys");
+
+    for (const auto& checkResult : results)
+    {
+        REQUIRE(checkResult.Consistent);
     }
+
+    // Changes that are not yet committed are checked on the connection that made them
+    auto savepoint = index.CreateSavepoint("checkconsistency_test");
+    std::vector<SQLiteIndex::ConsistencyCheckResult> savepointResults;
+    REQUIRE(index.CheckConsistency(false, savepointResults));
+    REQUIRE(savepointResults.size() == results.size());
 }
 
 TEST_CASE("SQLiteIndex_GetMultiProperty_PackageFamilyName", "[sqliteindex]")
@@ -2865,3 +3691,238 @@ TEST_CASE("SQLiteIndex_ManifestHash_Missing", "[sqliteindex]")
 
     REQUIRE(!hashResult);
 }
+
+TEST_CASE("SQLiteIndex_ManifestHash_Lookup", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    SHA256::HashBuffer hash = SHA256::ComputeHash(data, sizeof(data));
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    Manifest manifest;
+    manifest.Id = "Foo";
+    manifest.Version = "Bar";
+    manifest.StreamSha256 = hash;
+    index.AddManifest(manifest, "path");
+
+    auto manifestId = index.GetManifestIdByManifest(manifest);
+    REQUIRE(manifestId);
+
+    auto hashManifestId = index.GetManifestIdByHash(hash);
+    REQUIRE(hashManifestId);
+    REQUIRE(hashManifestId.value() == manifestId.value());
+
+    uint8_t otherData[4] = { 4, 3, 2, 1 };
+    REQUIRE(!index.GetManifestIdByHash(SHA256::ComputeHash(otherData, sizeof(otherData))));
+
+    // Unchanged content at the same path does not modify the index, but a new path does
+    REQUIRE(!index.UpdateManifest(manifest, "path"));
+    REQUIRE(index.UpdateManifest(manifest, "other/path"));
+    REQUIRE(GetPropertyStringByKey(index, index.Search({}).Matches[0].first, PackageVersionProperty::RelativePath, "Bar", "") == "other/path");
+
+    index.RemoveManifest(manifest, "other/path");
+    REQUIRE(index.Search({}).Matches.empty());
+    REQUIRE(!index.GetManifestIdByHash(hash));
+
+    index.PrepareForPackaging();
+    REQUIRE(!index.GetManifestIdByHash(hash));
+}
+
+TEST_CASE("SQLiteIndex_GetPropertiesByManifestIds", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version1", "Channel", { "Tag" }, { "Command" }, "Path1", {}, {} },
+        { "Id2", "Name2", "Moniker", "Version2", "", { "Tag" }, { "Command" }, "Path2", {}, {} },
+        });
+
+    TestPrepareForRead(index);
+
+    std::vector<SQLite::rowid_t> manifestIds;
+    for (const auto& match : index.Search({}).Matches)
+    {
+        auto manifestId = index.GetManifestIdByKey(match.first, {}, {});
+        REQUIRE(manifestId);
+        manifestIds.emplace_back(manifestId.value());
+    }
+    REQUIRE(manifestIds.size() == 2);
+
+    // Include a manifest id that does not exist
+    manifestIds.emplace_back(manifestIds[0] + manifestIds[1] + 1);
+
+    auto properties = index.GetPropertiesByManifestIds(manifestIds,
+        { PackageVersionProperty::Id, PackageVersionProperty::Name, PackageVersionProperty::Version, PackageVersionProperty::Channel, PackageVersionProperty::RelativePath });
+
+    REQUIRE(properties.size() == 2);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto itr = properties.find(manifestIds[i]);
+        REQUIRE(itr != properties.end());
+
+        for (auto property : { PackageVersionProperty::Id, PackageVersionProperty::Name, PackageVersionProperty::Version, PackageVersionProperty::Channel, PackageVersionProperty::RelativePath })
+        {
+            auto single = index.GetPropertyByManifestId(manifestIds[i], property);
+            REQUIRE(single);
+            REQUIRE(itr->second.at(property) == single.value());
+        }
+    }
+}
+
+TEST_CASE("InstallerApplicability_RoundTrip", "[sqliteindex]")
+{
+    Manifest manifest;
+    ManifestInstaller& first = manifest.Installers.emplace_back();
+    first.Arch = Architecture::X64;
+    first.Scope = ScopeEnum::Machine;
+    first.InstallerType = InstallerTypeEnum::Msi;
+    first.AppsAndFeaturesEntries.emplace_back().InstallerType = InstallerTypeEnum::Exe;
+    first.MinOSVersion = "10.0.17763.0";
+    first.UnsupportedOSArchitectures = { Architecture::Arm, Architecture::Arm64 };
+
+    ManifestInstaller& second = manifest.Installers.emplace_back();
+    second.Arch = Architecture::Neutral;
+    second.InstallerType = InstallerTypeEnum::Zip;
+
+    auto installers = InstallerApplicability::Parse(InstallerApplicability::Create(manifest));
+    REQUIRE(installers);
+    REQUIRE(installers->size() == 2);
+
+    const auto& firstResult = installers->at(0);
+    REQUIRE(firstResult.Arch == Architecture::X64);
+    REQUIRE(firstResult.Scope == ScopeEnum::Machine);
+    REQUIRE(firstResult.InstallerType == InstallerTypeEnum::Msi);
+    REQUIRE(firstResult.AppsAndFeaturesEntries.size() == 1);
+    REQUIRE(firstResult.AppsAndFeaturesEntries[0].InstallerType == InstallerTypeEnum::Exe);
+    REQUIRE(firstResult.MinOSVersion == "10.0.17763.0");
+    REQUIRE(firstResult.UnsupportedOSArchitectures == std::vector<Architecture>{ Architecture::Arm, Architecture::Arm64 });
+
+    const auto& secondResult = installers->at(1);
+    REQUIRE(secondResult.Arch == Architecture::Neutral);
+    REQUIRE(secondResult.Scope == ScopeEnum::Unknown);
+    REQUIRE(secondResult.InstallerType == InstallerTypeEnum::Zip);
+    REQUIRE(secondResult.AppsAndFeaturesEntries.empty());
+    REQUIRE(secondResult.MinOSVersion.empty());
+    REQUIRE(secondResult.UnsupportedOSArchitectures.empty());
+
+    REQUIRE(InstallerApplicability::Parse("")->empty());
+    REQUIRE(!InstallerApplicability::Parse("x64|machine|msi"));
+}
+
+TEST_CASE("SQLiteIndex_InstallerApplicability", "[sqliteindex][V1_7]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    Manifest manifest;
+    CreateFakeManifest(manifest, "Test");
+    manifest.Installers[0].Arch = Architecture::X64;
+    manifest.Installers[0].InstallerType = InstallerTypeEnum::Msix;
+    std::string relativePath = GetPathFromManifest(manifest);
+
+    {
+        // The table is only created on request.
+        TempFile defaultTempFile{ "repolibtest_tempdb"s, ".db"s };
+        SQLiteIndex index = SQLiteIndex::CreateNew(defaultTempFile, Schema::Version::Latest());
+        index.AddManifest(manifest, relativePath);
+
+        auto manifestId = index.GetManifestIdByManifest(manifest);
+        REQUIRE(manifestId);
+        REQUIRE(index.GetMetadataByManifestId(manifestId.value()).empty());
+    }
+
+    SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version::Latest(), SQLiteIndex::CreateOptions::InstallerApplicabilitySupport);
+    index.AddManifest(manifest, relativePath);
+
+    auto manifestId = index.GetManifestIdByManifest(manifest);
+    REQUIRE(manifestId);
+
+    auto metadata = index.GetMetadataByManifestId(manifestId.value());
+    REQUIRE(metadata.size() == 1);
+    REQUIRE(metadata[0].first == PackageVersionMetadata::InstallerApplicability);
+    REQUIRE(metadata[0].second == InstallerApplicability::Create(manifest));
+
+    // A change to only the installers is still an update to the index.
+    manifest.Installers[0].Arch = Architecture::Arm64;
+    REQUIRE(index.UpdateManifest(manifest, relativePath));
+    REQUIRE(!index.UpdateManifest(manifest, relativePath));
+
+    metadata = index.GetMetadataByManifestId(manifestId.value());
+    REQUIRE(metadata.size() == 1);
+    REQUIRE(metadata[0].second == InstallerApplicability::Create(manifest));
+
+    index.RemoveManifest(manifest, relativePath);
+
+    Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+    REQUIRE(Schema::V1_7::InstallerApplicabilityTable::Exists(connection));
+    REQUIRE(!Schema::V1_7::InstallerApplicabilityTable::GetSummaryByManifestId(connection, manifestId.value()));
+}
+
+TEST_CASE("SQLiteIndex_Immutable_ConcurrentReads", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        SQLiteIndex index = SearchTestSetup(tempFile, {
+            { "Id1", "Name1", "Moniker", "Version1", "Channel", { "Tag" }, { "Command" }, "Path1", {}, {} },
+            { "Id2", "Name2", "Moniker", "Version2", "", { "Tag" }, { "Command" }, "Path2", {}, {} },
+            { "Id3", "Name3", "Other", "Version3", "", { "Tag" }, { "Command" }, "Path3", {}, {} },
+            });
+    }
+
+    SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::ImmutableMapped);
+
+    SearchRequest request;
+    request.Filters.emplace_back(PackageMatchField::Moniker, MatchType::Exact, "Moniker");
+
+    auto getIds = [](const Schema::ISQLiteIndex::SearchResult& result)
+    {
+        std::vector<SQLite::rowid_t> ids;
+        for (const auto& match : result.Matches)
+        {
+            ids.emplace_back(match.first);
+        }
+        return ids;
+    };
+
+    auto expected = getIds(index.Search(request));
+    REQUIRE(expected.size() == 2);
+
+    // Readers beyond the first are given pooled connections rather than waiting on each other.
+    std::vector<std::future<bool>> readers;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        readers.emplace_back(std::async(std::launch::async, [&]()
+            {
+                for (size_t j = 0; j < 20; ++j)
+                {
+                    auto ids = getIds(index.Search(request));
+                    if (ids != expected)
+                    {
+                        return false;
+                    }
+
+                    for (auto id : ids)
+                    {
+                        if (index.GetVersionKeysById(id).size() != 1)
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }));
+    }
+
+    for (auto& reader : readers)
+    {
+        REQUIRE(reader.get());
+    }
+}
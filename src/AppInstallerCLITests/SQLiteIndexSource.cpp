@@ -194,3 +194,160 @@ TEST_CASE("SQLiteIndexSource_IsSame", "[sqliteindexsource]")
 
     REQUIRE(result1.Matches[0].Package->IsSame(result2.Matches[0].Package.get()));
 }
+
+TEST_CASE("SQLiteIndexSource_PackageOutlivesResult", "[sqliteindexsource]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    std::shared_ptr<SQLiteIndexSource> source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, manifest.Id);
+
+    std::shared_ptr<IPackage> package;
+
+    {
+        auto results = source->Search(request);
+        REQUIRE(results.Matches.size() == 1);
+        package = results.Matches[0].Package;
+    }
+
+    // The arena holding the package must remain alive after the rest of the result is gone.
+    REQUIRE(package->GetProperty(PackageProperty::Id) == manifest.Id);
+    REQUIRE(package->GetLatestAvailableVersion());
+}
+
+TEST_CASE("SQLiteIndexSource_Search_Callback", "[sqliteindexsource]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    std::shared_ptr<SQLiteIndexSource> source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, manifest.Id);
+
+    std::vector<ResultMatch> matches;
+    bool truncated = source->Search(request, [&](ResultMatch&& match)
+        {
+            matches.emplace_back(std::move(match));
+            return false;
+        });
+
+    // Stopping after the last match does not truncate the results.
+    REQUIRE(!truncated);
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0].Package);
+    REQUIRE(matches[0].Package->GetProperty(PackageProperty::Id) == manifest.Id);
+}
+
+TEST_CASE("SQLiteIndexSource_GetManifest_ParsesOnce", "[sqliteindexsource]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    std::shared_ptr<SQLiteIndexSource> source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    size_t parseCount = 0;
+    auto parseManifest = [&]() { ++parseCount; return manifest; };
+
+    auto first = source->GetManifest(1, parseManifest);
+    auto second = source->GetManifest(1, parseManifest);
+    REQUIRE(parseCount == 1);
+    REQUIRE(first.Id == manifest.Id);
+    REQUIRE(second.Id == manifest.Id);
+
+    source->GetManifest(2, parseManifest);
+    REQUIRE(parseCount == 2);
+}
+
+// Creates a source over an in memory index that has the given number of packages, each with an id that starts with "Budget.".
+static std::shared_ptr<SQLiteIndexSource> CreateBudgetTestSource(size_t packageCount)
+{
+    SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
+
+    for (size_t i = 0; i < packageCount; ++i)
+    {
+        std::string number = std::to_string(i);
+
+        Manifest manifest;
+        manifest.Id = "Budget.Package" + number;
+        manifest.Version = "1.0";
+        manifest.DefaultLocalization.Add<Localization::PackageName>("Budget Package " + number);
+        manifest.DefaultLocalization.Add<Localization::Publisher>("Budget Publisher");
+        manifest.Installers.emplace_back();
+
+        index.AddManifest(manifest, manifest.Id + ".yaml");
+    }
+
+    SourceDetails details;
+    details.Name = "BudgetTestSource";
+    details.Identifier = "*BudgetTestSource";
+    return std::make_shared<SQLiteIndexSource>(details, std::move(index));
+}
+
+// Counts a search that finds every package of the source, reading the properties that search shows for each result.
+static OperationCounts CountSearch(const SQLiteIndexSource& source, size_t expectedCount)
+{
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::StartsWith, "Budget.");
+
+    // Search once beforehand so that the statements are cached, as they are for every search after the first.
+    source.Search(request);
+
+    size_t resultCount = 0;
+    size_t propertyCount = 0;
+    OperationCounter counter;
+
+    {
+        auto results = source.Search(request);
+        resultCount = results.Matches.size();
+
+        for (const auto& match : results.Matches)
+        {
+            propertyCount += match.Package->GetProperty(PackageProperty::Id).get().empty() ? 0 : 1;
+            propertyCount += match.Package->GetProperty(PackageProperty::Name).get().empty() ? 0 : 1;
+        }
+    }
+
+    OperationCounts result = counter.Get();
+
+    REQUIRE(resultCount == expectedCount);
+    REQUIRE(propertyCount == expectedCount * 2);
+
+    return result;
+}
+
+TEST_CASE("SQLiteIndexSource_Search_Budget", "[sqliteindexsource][budget]")
+{
+    // The costs of each result beyond the first set; the fixed costs of a search cancel out.
+    // Both counts stay below the size of a single batch of prefetched properties.
+    constexpr size_t fewerPackages = 50;
+    constexpr size_t morePackages = 150;
+    constexpr size_t addedPackages = morePackages - fewerPackages;
+
+    constexpr size_t stepsPerResult = 16;
+    constexpr size_t allocationsPerResult = 128;
+
+    auto fewerSource = CreateBudgetTestSource(fewerPackages);
+    auto moreSource = CreateBudgetTestSource(morePackages);
+
+    OperationCounts fewer = CountSearch(*fewerSource, fewerPackages);
+    OperationCounts more = CountSearch(*moreSource, morePackages);
+
+    // The properties of the results are read with cached statements, and in batches rather than one query per result.
+    REQUIRE(more.StatementsPrepared <= fewer.StatementsPrepared);
+    REQUIRE(more.StatementSteps <= fewer.StatementSteps + stepsPerResult * addedPackages);
+    REQUIRE(more.Allocations <= fewer.Allocations + allocationsPerResult * addedPackages);
+    REQUIRE(more.RegistryCalls == fewer.RegistryCalls);
+}
@@ -136,6 +136,38 @@ TEST_CASE("SQLiteWrapperFileCreateAndReopen", "[sqlitewrapper]")
     }
 }
 
+TEST_CASE("SQLiteWrapper_WriteAheadLogging", "[sqlitewrapper]")
+{
+    TestCommon::TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    int firstVal = 1;
+    std::string secondVal = "test";
+
+    Connection writer = Connection::Create(tempFile, Connection::OpenDisposition::Create);
+    REQUIRE(writer.EnableWriteAheadLogging(256, std::chrono::milliseconds(100)));
+
+    CreateSimpleTestTable(writer);
+    InsertIntoSimpleTestTable(writer, firstVal, secondVal);
+
+    Connection reader = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+
+    {
+        // The reader sees the last commit while a write is in progress
+        Savepoint savepoint = Savepoint::Create(writer, "test_savepoint");
+        UpdateSimpleTestTable(writer, firstVal + 1, secondVal);
+
+        SelectFromSimpleTestTableOnlyOneRow(reader, firstVal, secondVal);
+
+        savepoint.Commit();
+    }
+
+    SelectFromSimpleTestTableOnlyOneRow(reader, firstVal + 1, secondVal);
+
+    Connection memory = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+    REQUIRE_FALSE(memory.EnableWriteAheadLogging(256, std::chrono::milliseconds(100)));
+}
+
 TEST_CASE("SQLiteWrapperSavepointRollback", "[sqlitewrapper]")
 {
     Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
@@ -260,6 +292,110 @@ TEST_CASE("SQLiteWrapperSavepointReuse", "[sqlitewrapper]")
     }
 }
 
+TEST_CASE("SQLiteWrapper_Profiling", "[sqlitewrapper]")
+{
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+    REQUIRE(connection.GetProfile().empty());
+
+    connection.EnableProfiling();
+
+    CreateSimpleTestTable(connection);
+    InsertIntoSimpleTestTable(connection, 1, "1");
+    InsertIntoSimpleTestTable(connection, 2, "2");
+    InsertIntoSimpleTestTable(connection, 3, "3");
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Statement select = Statement::Create(connection, s_selectFromSimpleTestTableSQL);
+        while (select.Step()) {}
+    }
+
+    auto profile = connection.GetProfile();
+    auto select = std::find_if(profile.begin(), profile.end(), [](const Connection::StatementProfile& entry) { return entry.SQL == s_selectFromSimpleTestTableSQL; });
+    REQUIRE(select != profile.end());
+    REQUIRE(select->Executions == 2);
+    REQUIRE(select->Rows == 6);
+    REQUIRE(select->MaxTime <= select->TotalTime);
+
+    // Ordered by descending total time
+    for (size_t i = 1; i < profile.size(); ++i)
+    {
+        REQUIRE(profile[i - 1].TotalTime >= profile[i].TotalTime);
+    }
+}
+
+TEST_CASE("SQLiteWrapper_CacheSizeLimit", "[sqlitewrapper]")
+{
+    TestCommon::TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    // About 4 MB of rows, twice the default page cache.
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::Create);
+        CreateSimpleTestTable(connection);
+
+        Savepoint savepoint = Savepoint::Create(connection, s_savepoint);
+        std::string value(2048, 'a');
+        for (int i = 0; i < 2048; ++i)
+        {
+            InsertIntoSimpleTestTable(connection, i, value);
+        }
+        savepoint.Commit();
+    }
+
+    auto getCacheUsed = [](Connection& connection)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            Statement select = Statement::Create(connection, s_selectFromSimpleTestTableSQL);
+            while (select.Step()) {}
+        }
+
+        int current = 0;
+        int highwater = 0;
+        REQUIRE(sqlite3_db_status(connection, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0) == SQLITE_OK);
+        return current;
+    };
+
+    constexpr uint32_t limit = 256;
+
+    Connection unlimited = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+    REQUIRE(getCacheUsed(unlimited) > static_cast<int>(4 * limit * 1024));
+
+    Connection limited = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+    limited.SetCacheSizeLimit(limit);
+
+    // The cache used includes the overhead of each page, on top of the page itself.
+    REQUIRE(getCacheUsed(limited) <= static_cast<int>(2 * limit * 1024));
+}
+
+TEST_CASE("SQLiteWrapper_ReadOnlyMappedCoversFile", "[sqlitewrapper]")
+{
+    TestCommon::TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::Create);
+        CreateSimpleTestTable(connection);
+
+        std::string value(1024, 'a');
+        for (int i = 0; i < 64; ++i)
+        {
+            InsertIntoSimpleTestTable(connection, i, value);
+        }
+    }
+
+    Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly, Connection::OpenFlags::ReadOnlyMapped);
+
+    Statement mmapSize = Statement::Create(connection, "PRAGMA mmap_size");
+    REQUIRE(mmapSize.Step());
+    REQUIRE(mmapSize.GetColumn<int64_t>(0) == static_cast<int64_t>(std::filesystem::file_size(tempFile.GetPath())));
+
+    Statement count = Statement::Create(connection, "select count(*) from simpletest");
+    REQUIRE(count.Step());
+    REQUIRE(count.GetColumn<int>(0) == 64);
+}
+
 TEST_CASE("SQLiteWrapper_EscapeStringForLike", "[sqlitewrapper]")
 {
     std::string escape(EscapeCharForLike);
@@ -585,3 +721,53 @@ TEST_CASE("SQLBuilder_InsertValueBinding", "[sqlbuilder]")
         REQUIRE(!select.Step());
     }
 }
+
+TEST_CASE("SQLBuilder_PrepareCached", "[sqlbuilder]")
+{
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+
+    CreateSimpleTestTable(connection);
+
+    InsertIntoSimpleTestTable(connection, 1, "1");
+    InsertIntoSimpleTestTable(connection, 2, "2");
+    InsertIntoSimpleTestTable(connection, 3, "3");
+
+    auto selectSecond = [&](int first)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(s_secondColumn).From(s_tableName).Where(s_firstColumn).Equals(first);
+
+        Statement statement = builder.PrepareCached(connection);
+        REQUIRE(statement.GetState() == Statement::State::Prepared);
+        REQUIRE(statement.Step());
+        return statement.GetColumn<std::string>(0);
+    };
+
+    REQUIRE(selectSecond(1) == "1");
+    REQUIRE(connection.GetStatementCacheStatistics().Hits == 0);
+    REQUIRE(connection.GetStatementCacheStatistics().Misses == 1);
+
+    // The same SQL with a different binding is served from the cache
+    REQUIRE(selectSecond(3) == "3");
+    REQUIRE(selectSecond(2) == "2");
+    REQUIRE(connection.GetStatementCacheStatistics().Hits == 2);
+    REQUIRE(connection.GetStatementCacheStatistics().Misses == 1);
+
+    // A statement that is still in use is not handed out again
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(s_secondColumn).From(s_tableName).Where(s_firstColumn).Equals(1);
+
+        Statement inUse = builder.PrepareCached(connection);
+        REQUIRE(inUse.Step());
+
+        REQUIRE(selectSecond(2) == "2");
+        REQUIRE(inUse.GetColumn<std::string>(0) == "1");
+        REQUIRE(connection.GetStatementCacheStatistics().Hits == 3);
+        REQUIRE(connection.GetStatementCacheStatistics().Misses == 2);
+    }
+
+    // Idle statements do not hold the database, so writes still succeed
+    UpdateSimpleTestTable(connection, 4, "4");
+    REQUIRE(selectSecond(4) == "4");
+}
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <Microsoft/SearchResultCache.h>
+
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace TestCommon;
+
+namespace
+{
+    SearchRequest CreateRequest(std::string_view query)
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Substring, query);
+        request.Filters.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "editor", "contoso");
+        return request;
+    }
+
+    SQLiteIndex::SearchResult CreateResult()
+    {
+        SQLiteIndex::SearchResult result;
+        result.Matches.emplace_back(7, PackageMatchFilter{ PackageMatchField::Name, MatchType::Substring, "Editor" });
+        result.Matches.emplace_back(3, PackageMatchFilter{ PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "editor", "contoso" });
+        result.Truncated = true;
+        return result;
+    }
+}
+
+TEST_CASE("SearchResultCache_AddAndGet", "[SearchResultCache]")
+{
+    TempFile cacheFile{ "SearchResultCache", ".db" };
+    SearchResultCache cache{ cacheFile.GetPath(), "1" };
+
+    SearchRequest request = CreateRequest("Editor");
+    REQUIRE_FALSE(cache.Get(request));
+
+    cache.Add(request, CreateResult());
+
+    auto result = cache.Get(request);
+    REQUIRE(result);
+    REQUIRE(result->Truncated);
+    REQUIRE(result->Matches.size() == 2);
+    REQUIRE(result->Matches[0].first == 7);
+    REQUIRE(result->Matches[0].second.Field == PackageMatchField::Name);
+    REQUIRE(result->Matches[0].second.Type == MatchType::Substring);
+    REQUIRE(result->Matches[0].second.Value == "Editor");
+    REQUIRE_FALSE(result->Matches[0].second.Additional);
+    REQUIRE(result->Matches[1].first == 3);
+    REQUIRE(result->Matches[1].second.Field == PackageMatchField::NormalizedNameAndPublisher);
+    REQUIRE(result->Matches[1].second.Additional);
+    REQUIRE(result->Matches[1].second.Additional.value() == "contoso");
+}
+
+TEST_CASE("SearchResultCache_RequestsAreDistinct", "[SearchResultCache]")
+{
+    TempFile cacheFile{ "SearchResultCache", ".db" };
+    SearchResultCache cache{ cacheFile.GetPath(), "1" };
+
+    cache.Add(CreateRequest("Editor"), CreateResult());
+
+    REQUIRE_FALSE(cache.Get(CreateRequest("Edito")));
+
+    SearchRequest otherAdditional = CreateRequest("Editor");
+    otherAdditional.Filters[0].Additional = AppInstaller::Utility::NormalizedString{ "fabrikam" };
+    REQUIRE_FALSE(cache.Get(otherAdditional));
+
+    SearchRequest otherLimit = CreateRequest("Editor");
+    otherLimit.MaximumResults = 1;
+    REQUIRE_FALSE(cache.Get(otherLimit));
+
+    REQUIRE(cache.Get(CreateRequest("Editor")));
+}
+
+TEST_CASE("SearchResultCache_IndexVersionChangeDiscardsEntries", "[SearchResultCache]")
+{
+    TempFile cacheFile{ "SearchResultCache", ".db" };
+    SearchRequest request = CreateRequest("Editor");
+
+    {
+        SearchResultCache cache{ cacheFile.GetPath(), "1" };
+        cache.Add(request, CreateResult());
+    }
+
+    {
+        SearchResultCache cache{ cacheFile.GetPath(), "1" };
+        REQUIRE(cache.Get(request));
+    }
+
+    {
+        SearchResultCache cache{ cacheFile.GetPath(), "2" };
+        REQUIRE_FALSE(cache.Get(request));
+    }
+
+    {
+        // The entries for the earlier version are gone rather than hidden.
+        SearchResultCache cache{ cacheFile.GetPath(), "1" };
+        REQUIRE_FALSE(cache.Get(request));
+    }
+}
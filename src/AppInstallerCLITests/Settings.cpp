@@ -281,3 +281,30 @@ TEST_CASE("AttemptSetOnNewValue", "[settings]")
     settingValue = ReadEntireStream(*result);
     REQUIRE(value2 == settingValue);
 }
+
+TEST_CASE("StreamVersionChangesOnWrite", "[settings]")
+{
+    StreamDefinition name{ Type::Standard, "testsettingname" };
+    name.Type = GENERATE(Type::Standard, Type::Secure);
+    INFO(ToString(name.Type));
+
+    Stream stream{ name };
+    StreamVersion initial = stream.GetVersion();
+    REQUIRE(initial.IsAvailable());
+    REQUIRE(initial == Stream{ name }.GetVersion());
+
+    // Reading does not change the version
+    std::ignore = stream.Get();
+    REQUIRE(initial == stream.GetVersion());
+
+    REQUIRE(Stream{ name }.Set("This is the test setting value"));
+    StreamVersion afterSet = stream.GetVersion();
+    REQUIRE(afterSet != initial);
+    REQUIRE(afterSet.Instance == initial.Instance);
+
+    Stream{ name }.Remove();
+    REQUIRE(stream.GetVersion() != afterSet);
+
+    // An unavailable version never matches
+    REQUIRE(StreamVersion{} != StreamVersion{});
+}
@@ -469,6 +469,52 @@ TEST_CASE("RepoSources_UpdateSource", "[sources]")
     REQUIRE((now - sources[0].LastUpdateTime) < 1s);
 }
 
+TEST_CASE("RepoSources_UpdateAllSourcesConcurrently", "[sources]")
+{
+    using namespace std::chrono_literals;
+
+    TestHook_ClearSourceFactoryOverrides();
+
+    // Each update waits for all of them to have started, which only happens if they run concurrently.
+    std::atomic<size_t> started = 0;
+    auto onUpdate = [&](const SourceDetails&)
+    {
+        ++started;
+        auto end = std::chrono::steady_clock::now() + 5s;
+        while (started < 3 && std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::sleep_for(10ms);
+        }
+    };
+
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = onUpdate;
+    TestHook_SetSourceFactoryOverride("testType", factory);
+    TestHook_SetSourceFactoryOverride("testType2", factory);
+    TestHook_SetSourceFactoryOverride("testType3", factory);
+
+    SetSetting(Stream::UserSources, s_ThreeSources);
+    SetSetting(Stream::SourcesMetadata, s_ThreeSourcesMetadata);
+
+    auto now = std::chrono::system_clock::now();
+
+    Source source{ std::string_view{} };
+    ProgressCallback progress;
+    auto failedSources = source.Update(progress);
+
+    REQUIRE(failedSources.empty());
+    REQUIRE(started == 3);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == 3);
+
+    for (const auto& details : sources)
+    {
+        INFO(details.Name);
+        REQUIRE((now - details.LastUpdateTime) < 5s);
+    }
+}
+
 TEST_CASE("RepoSources_UpdateSourceRetries", "[sources]")
 {
     using namespace std::chrono_literals;
@@ -594,6 +640,43 @@ TEST_CASE("RepoSources_UpdateOnOpen", "[sources]")
     REQUIRE(sources[0].LastUpdateTime != ConvertUnixEpochToSystemClock(0));
 }
 
+TEST_CASE("RepoSources_UpdateOnOpen_Detached", "[sources]")
+{
+    using namespace std::chrono_literals;
+
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    std::thread::id updateThread;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&) { updateThread = std::this_thread::get_id(); };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    // Past the default auto update interval, but well within the background update window.
+    int64_t lastUpdate = GetCurrentUnixEpoch() - 600;
+    std::string metadata = "Sources:\n  - Name: testName\n    LastUpdate: "s + std::to_string(lastUpdate) + "\n";
+
+    SetSetting(Stream::UserSources, s_SingleSource);
+    SetSetting(Stream::SourcesMetadata, metadata);
+
+    {
+        ProgressCallback progress;
+        auto source = OpenSource(name, progress);
+        REQUIRE(source);
+    }
+
+    Source::WaitForDetachedUpdates();
+
+    REQUIRE(updateThread != std::thread::id{});
+    REQUIRE(updateThread != std::this_thread::get_id());
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources[0].Name == name);
+    REQUIRE(sources[0].LastUpdateTime > ConvertUnixEpochToSystemClock(lastUpdate));
+}
+
 TEST_CASE("RepoSources_DropSourceByName", "[sources]")
 {
     SetSetting(Stream::UserSources, s_ThreeSources);
@@ -19,6 +19,9 @@ TEST_CASE("UTF8Length", "[strings]")
     REQUIRE(UTF8Length("bye\xE2\x80\xA6") == 4); // "bye…"
     REQUIRE(UTF8Length("\xf0\x9f\xa6\x86") == 1); // [duck emoji]
     REQUIRE(UTF8Length("\xf0\x9d\x85\xa0\xf0\x9d\x85\xa0") == 2); // [8th note][8th note]
+    REQUIRE(UTF8Length("a\r\nb") == 3);
+    REQUIRE(UTF8Length("longer than a single word") == 25);
+    REQUIRE(UTF8Length("longer than a w\xC3\xB6rd") == 20); // "longer than a wörd"
 }
 
 TEST_CASE("UTF8Substring", "[strings]")
@@ -31,6 +34,7 @@ TEST_CASE("UTF8Substring", "[strings]")
     REQUIRE(UTF8Substring("abcd", 1, 1) == "b");
     REQUIRE(UTF8Substring("abcd", 1, 3) == "bcd");
     REQUIRE(UTF8Substring("abcd", 4, 0) == "");
+    REQUIRE_THROWS_AS(UTF8Substring("abcd", 5, 0), std::out_of_range);
 
     const char* s = "\xf0\x9f\xa6\x86s like \xf0\x9f\x8c\x8a"; // [duck emoji]s like [wave emoji]
     REQUIRE(UTF8Substring(s, 0, 9) == "\xf0\x9f\xa6\x86s like \xf0\x9f\x8c\x8a");
@@ -52,6 +56,7 @@ TEST_CASE("UTF8ColumnWidth", "[strings]")
     REQUIRE(UTF8ColumnWidth("\xf0\x9d\x85\xa0\xf0\x9d\x85\xa0") == 2); // [8th note][8th note]
     REQUIRE(UTF8ColumnWidth("\xe6\xb5\x8b\xe8\xaf\x95") == 4); // 测试
     REQUIRE(UTF8ColumnWidth("te\xe6\xb5\x8bs\xe8\xaf\x95t") == 8); // te测s试t
+    REQUIRE(UTF8ColumnWidth("a\r\nb") == 3);
 }
 
 TEST_CASE("UTF8TrimRightToColumnWidth", "[strings]")
@@ -134,6 +139,8 @@ TEST_CASE("FoldCase", "[strings]")
     REQUIRE(FoldCase("foldcase"sv) == FoldCase("FOLDCASE"sv));
     REQUIRE(FoldCase(u8"f\xF6ldcase"sv) == FoldCase(u8"F\xD6LDCASE"sv));
     REQUIRE(FoldCase(u8"foldc\x430se"sv) == FoldCase(u8"FOLDC\x410SE"sv));
+    REQUIRE(FoldCase("Fold [Case] 123_Z@"sv) == "fold [case] 123_z@");
+    REQUIRE(FoldCase(u8"LONGER THAN A W\xD6RD"sv) == FoldCase(u8"longer than a w\xF6rd"sv));
 }
 
 TEST_CASE("ExpandEnvironmentVariables", "[strings]")
@@ -194,3 +201,53 @@ TEST_CASE("GetFileNameFromURI", "[strings]")
     REQUIRE(GetFileNameFromURI("https://github.com/microsoft/winget-cli/README.md").u8string() == "README.md");
     REQUIRE(GetFileNameFromURI("https://microsoft.com/").u8string() == "");
 }
+
+TEST_CASE("SHA256_ComputeHashFromFile", "[strings]")
+{
+    TestCommon::TempFile tempFile{ "hash", ".bin" };
+
+    // Span multiple read blocks and end on a partial one
+    size_t size = GENERATE(as<size_t>{}, 0, 1, 4 * 1024 * 1024, 9 * 1024 * 1024 + 17);
+
+    std::string contents(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+    {
+        contents[i] = static_cast<char>(i * 31 + (i >> 12));
+    }
+
+    {
+        std::ofstream out{ tempFile.GetPath(), std::ofstream::binary };
+        out.write(contents.data(), contents.size());
+    }
+
+    REQUIRE(SHA256::AreEqual(SHA256::ComputeHash(contents), SHA256::ComputeHashFromFile(tempFile.GetPath())));
+}
+
+TEST_CASE("ConvertToUTF", "[strings]")
+{
+    // "Façade 日本", split so that the hex escapes end where they should
+    std::wstring_view wide = L"Fa\x00E7" L"ade \x65E5\x672C";
+    std::string_view narrow = "Fa\xC3\xA7" "ade \xE6\x97\xA5\xE6\x9C\xAC";
+
+    REQUIRE(ConvertToUTF8(L"") == "");
+    REQUIRE(ConvertToUTF8(L"Plain ASCII text") == "Plain ASCII text");
+    REQUIRE(ConvertToUTF8(wide) == narrow);
+    REQUIRE(ConvertToUTF16("") == L"");
+    REQUIRE(ConvertToUTF16("Plain ASCII text") == L"Plain ASCII text");
+    REQUIRE(ConvertToUTF16(narrow) == wide);
+
+    // The buffers are reused, so a shorter result must not keep the end of a longer one.
+    std::string utf8Buffer;
+    ConvertToUTF8(wide, utf8Buffer);
+    REQUIRE(utf8Buffer == narrow);
+    ConvertToUTF8(L"abc", utf8Buffer);
+    REQUIRE(utf8Buffer == "abc");
+
+    std::wstring utf16Buffer;
+    ConvertToUTF16(narrow, utf16Buffer);
+    REQUIRE(utf16Buffer == wide);
+    ConvertToUTF16("abc", utf16Buffer);
+    REQUIRE(utf16Buffer == L"abc");
+    ConvertToUTF16("", utf16Buffer);
+    REQUIRE(utf16Buffer.empty());
+}
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <TableOutput.h>
+
+#include <regex>
+
+using namespace AppInstaller::CLI;
+using namespace AppInstaller::CLI::Execution;
+
+namespace
+{
+    TableOutput<3> CreateTestTable(Reporter& reporter, size_t sizingBuffer)
+    {
+        return { reporter, { Resource::String::SearchName, Resource::String::SearchId, Resource::String::SearchVersion }, sizingBuffer };
+    }
+
+    // Removes the formatting sequences that are written when the test is run from a console.
+    std::string GetText(const std::ostringstream& out)
+    {
+        return std::regex_replace(out.str(), std::regex{ "\x1b\\[[0-9;]*m" }, "");
+    }
+}
+
+TEST_CASE("TableOutput_SizesColumnsToContent", "[tableoutput]")
+{
+    std::istringstream in;
+    std::ostringstream out;
+    Reporter reporter{ out, in };
+
+    auto table = CreateTestTable(reporter, 50);
+    table.OutputLine({ "Short", "Id.One", "1.0" });
+    table.OutputLine({ "A much longer name", "Id.Two", "" });
+    table.Complete();
+
+    REQUIRE(GetText(out) ==
+        "Name               Id     Version\n"
+        "---------------------------------\n"
+        "Short              Id.One 1.0\n"
+        "A much longer name Id.Two \n");
+}
+
+TEST_CASE("TableOutput_TrimsLinesAfterSizing", "[tableoutput]")
+{
+    std::istringstream in;
+    std::ostringstream out;
+    Reporter reporter{ out, in };
+
+    // Only the first line is used to size the columns, so the second is trimmed to fit.
+    auto table = CreateTestTable(reporter, 1);
+    table.OutputLine({ "Short", "Id.One", "1.0" });
+    table.OutputLine({ "A much longer name", "Id", "2.0" });
+    table.Complete();
+
+    REQUIRE(GetText(out) ==
+        "Name  Id     Version\n"
+        "--------------------\n"
+        "Short Id.One 1.0\n"
+        "A mu\xE2\x80\xA6 Id     2.0\n");
+}
+
+TEST_CASE("TableOutput_Empty", "[tableoutput]")
+{
+    std::istringstream in;
+    std::ostringstream out;
+    Reporter reporter{ out, in };
+
+    auto table = CreateTestTable(reporter, 50);
+    REQUIRE(table.IsEmpty());
+    table.Complete();
+
+    REQUIRE(GetText(out).empty());
+}
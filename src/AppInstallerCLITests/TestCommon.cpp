@@ -4,7 +4,9 @@
 #include "TestCommon.h"
 #include "TestHooks.h"
 #include "winget/GroupPolicy.h"
+#include "winget/Registry.h"
 #include "winget/UserSettings.h"
+#include <SQLiteWrapper.h>
 
 namespace TestCommon
 {
@@ -205,6 +207,7 @@ namespace TestCommon
         if (!keepFileSettings)
         {
             m_settings.clear();
+            m_encoded.reset();
         }
 
         AppInstaller::Settings::SetUserSettingsOverride(this);
@@ -214,4 +217,31 @@ namespace TestCommon
     {
         AppInstaller::Settings::SetUserSettingsOverride(nullptr);
     }
+
+    namespace
+    {
+        OperationCounts GetCurrentOperationCounts()
+        {
+            OperationCounts result;
+            result.Allocations = GetAllocationCount();
+            result.StatementsPrepared = AppInstaller::Repository::SQLite::Statement::GetPreparedCount();
+            result.StatementSteps = AppInstaller::Repository::SQLite::Statement::GetStepCount();
+            result.RegistryCalls = AppInstaller::Registry::GetCallCount();
+            return result;
+        }
+    }
+
+    OperationCounter::OperationCounter() : m_start(GetCurrentOperationCounts()) {}
+
+    OperationCounts OperationCounter::Get() const
+    {
+        OperationCounts current = GetCurrentOperationCounts();
+
+        OperationCounts result;
+        result.Allocations = current.Allocations - m_start.Allocations;
+        result.StatementsPrepared = current.StatementsPrepared - m_start.StatementsPrepared;
+        result.StatementSteps = current.StatementSteps - m_start.StatementSteps;
+        result.RegistryCalls = current.RegistryCalls - m_start.RegistryCalls;
+        return result;
+    }
 }
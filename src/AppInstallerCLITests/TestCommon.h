@@ -130,4 +130,28 @@ namespace TestCommon
             m_settings[S].emplace<AppInstaller::Settings::details::SettingIndex(S)>(std::move(value));
         }
     };
+
+    // Gets the number of allocations that the process has made through the global operator new.
+    size_t GetAllocationCount();
+
+    // The counts of the operations that the budget tests hold hot paths to.
+    struct OperationCounts
+    {
+        size_t Allocations = 0;
+        size_t StatementsPrepared = 0;
+        size_t StatementSteps = 0;
+        size_t RegistryCalls = 0;
+    };
+
+    // Counts the operations made from its construction. The counters are for the whole process,
+    // so nothing else should run while a scenario is being counted.
+    struct OperationCounter
+    {
+        OperationCounter();
+
+        OperationCounts Get() const;
+
+    private:
+        OperationCounts m_start;
+    };
 }
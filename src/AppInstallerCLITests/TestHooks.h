@@ -10,6 +10,7 @@
 #include <AppInstallerTelemetry.h>
 #include <AppInstallerRuntime.h>
 #include <winget/UserSettings.h>
+#include <winget/ARPKeySnapshot.h>
 
 #ifdef AICLI_DISABLE_TEST_HOOKS
 static_assert(false, "Test hooks have been disabled");
@@ -27,6 +28,7 @@ namespace AppInstaller
     {
         void TestHook_SetSourceFactoryOverride(const std::string& type, std::function<std::unique_ptr<ISourceFactory>()>&& factory);
         void TestHook_ClearSourceFactoryOverrides();
+        void TestHook_SetARPKeySnapshotOverride(std::function<std::optional<ARPKeySnapshot>()>&& snapshot);
     }
 
     namespace Logging
@@ -38,4 +40,22 @@ namespace AppInstaller
     {
         void SetUserSettingsOverride(UserSettings* value);
     }
+
+    namespace Utility
+    {
+        // Replaces the size of the buffers used by the WinINet downloads; zero restores the default.
+        void TestHook_SetDownloadBufferSize(DWORD size);
+    }
+
+    namespace Performance
+    {
+        // Stops collection and discards all timings; no timer may be active when this is called.
+        void TestHook_ResetTimings();
+
+        namespace Counters
+        {
+            // Sets all of the counters back to zero.
+            void TestHook_ResetCounters();
+        }
+    }
 }
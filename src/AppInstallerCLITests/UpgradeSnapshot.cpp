@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include <winget/ARPKeySnapshot.h>
+#include <winget/UpgradeSnapshot.h>
+
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Settings;
+using namespace TestCommon;
+
+TEST_CASE("UpgradeSnapshot_SaveAndLoad", "[UpgradeSnapshot]")
+{
+    RemoveSetting(Stream::UpgradeSnapshot);
+    REQUIRE(!UpgradeSnapshot::Load());
+
+    UpgradeSnapshot snapshot;
+    snapshot.InstalledFingerprint = "installed";
+    snapshot.SourcesFingerprint = "sources";
+    snapshot.Entries.emplace_back(UpgradeSnapshot::Entry{ "Name1", "Id1", "1.0", "2.0", "Source1" });
+    snapshot.Entries.emplace_back(UpgradeSnapshot::Entry{ "Name2", "Id2", "Unknown", "3.0", "Source2" });
+    snapshot.Save();
+
+    auto loaded = UpgradeSnapshot::Load();
+    REQUIRE(loaded);
+    REQUIRE(loaded->InstalledFingerprint == "installed");
+    REQUIRE(loaded->SourcesFingerprint == "sources");
+    REQUIRE(loaded->Entries.size() == 2);
+    REQUIRE(loaded->Entries[0].Name == "Name1");
+    REQUIRE(loaded->Entries[0].Id == "Id1");
+    REQUIRE(loaded->Entries[0].InstalledVersion == "1.0");
+    REQUIRE(loaded->Entries[0].AvailableVersion == "2.0");
+    REQUIRE(loaded->Entries[0].SourceName == "Source1");
+    REQUIRE(loaded->Entries[1].Id == "Id2");
+    REQUIRE(loaded->Entries[1].InstalledVersion == "Unknown");
+
+    RemoveSetting(Stream::UpgradeSnapshot);
+}
+
+TEST_CASE("UpgradeSnapshot_InvalidContent", "[UpgradeSnapshot]")
+{
+    SetSetting(Stream::UpgradeSnapshot, "Version: 1\nUpgrades: [ not, a, list, of, maps");
+    REQUIRE(!UpgradeSnapshot::Load());
+
+    SetSetting(Stream::UpgradeSnapshot, "Version: 2\nInstalledFingerprint: a\nSourcesFingerprint: b\n");
+    REQUIRE(!UpgradeSnapshot::Load());
+
+    RemoveSetting(Stream::UpgradeSnapshot);
+}
+
+TEST_CASE("UpgradeSnapshot_IsCurrent", "[UpgradeSnapshot]")
+{
+    UpgradeSnapshot snapshot;
+    snapshot.InstalledFingerprint = "installed";
+    snapshot.SourcesFingerprint = "sources";
+
+    REQUIRE(snapshot.IsCurrent("installed", "sources"));
+    REQUIRE(!snapshot.IsCurrent("changed", "sources"));
+    REQUIRE(!snapshot.IsCurrent("installed", "changed"));
+    REQUIRE(!snapshot.IsCurrent("", "sources"));
+    REQUIRE(!snapshot.IsCurrent("installed", ""));
+
+    UpgradeSnapshot empty;
+    REQUIRE(!empty.IsCurrent("", ""));
+}
+
+TEST_CASE("ARPKeySnapshot_Fingerprint", "[UpgradeSnapshot][ARPChanges]")
+{
+    auto now = std::chrono::system_clock::now();
+
+    ARPKeySnapshot::Entries entries;
+    entries[{ "Machine|X64", "Id1" }] = now;
+    entries[{ "User|X64", "Id2" }] = now;
+
+    ARPKeySnapshot::Entries updated = entries;
+    updated[{ "User|X64", "Id2" }] = now + std::chrono::seconds(1);
+
+    ARPKeySnapshot::Entries added = entries;
+    added[{ "User|X64", "Id3" }] = now;
+
+    std::string fingerprint = ARPKeySnapshot{ entries }.GetFingerprint();
+    REQUIRE(!fingerprint.empty());
+    REQUIRE(fingerprint == ARPKeySnapshot{ entries }.GetFingerprint());
+    REQUIRE(fingerprint != ARPKeySnapshot{ updated }.GetFingerprint());
+    REQUIRE(fingerprint != ARPKeySnapshot{ added }.GetFingerprint());
+}
@@ -359,6 +359,427 @@ TEST_CASE("SettingAutoUpdateIntervalInMinutes", "[settings]")
     }
 }
 
+TEST_CASE("SettingBackgroundUpdateWindowInMinutes", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::BackgroundUpdateWindowInMinutes>() == 1440min);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "source": { "backgroundUpdateWindowInMinutes": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::BackgroundUpdateWindowInMinutes>() == 0min);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid type negative integer")
+    {
+        std::string_view json = R"({ "source": { "backgroundUpdateWindowInMinutes": -20 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::BackgroundUpdateWindowInMinutes>() == 1440min);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+    SECTION("Invalid type string")
+    {
+        std::string_view json = R"({ "source": { "backgroundUpdateWindowInMinutes": "not a number" } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::BackgroundUpdateWindowInMinutes>() == 1440min);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingNetworkDOPriority", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDOPriority>() == DOPriority::Foreground);
+        REQUIRE_FALSE(userSettingTest.Get<Setting::NetworkDOIndexDownloads>());
+        REQUIRE_FALSE(userSettingTest.Get<Setting::NetworkDOManifestDownloads>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "doPriority": "Background", "doIndexDownloads": true } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDOPriority>() == DOPriority::Background);
+        REQUIRE(userSettingTest.Get<Setting::NetworkDOIndexDownloads>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "network": { "doPriority": "high" } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDOPriority>() == DOPriority::Foreground);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingInstallConcurrency", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallConcurrency>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "installBehavior": { "concurrency": 4 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallConcurrency>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value 0")
+    {
+        std::string_view json = R"({ "installBehavior": { "concurrency": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallConcurrency>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+    SECTION("Invalid value too large")
+    {
+        std::string_view json = R"({ "installBehavior": { "concurrency": 100 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallConcurrency>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingInstallProgressInterval", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallProgressIntervalInMilliseconds>() == 250ms);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value 0")
+    {
+        std::string_view json = R"({ "installBehavior": { "progressIntervalInMilliseconds": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallProgressIntervalInMilliseconds>() == 0ms);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value too large")
+    {
+        std::string_view json = R"({ "installBehavior": { "progressIntervalInMilliseconds": 60000 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallProgressIntervalInMilliseconds>() == 250ms);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingNetworkDownloadConcurrency", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadConcurrency>() == 3);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "downloadConcurrency": 8 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadConcurrency>() == 8);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value 0")
+    {
+        std::string_view json = R"({ "network": { "downloadConcurrency": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadConcurrency>() == 3);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+    SECTION("Invalid value too large")
+    {
+        std::string_view json = R"({ "network": { "downloadConcurrency": 100 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadConcurrency>() == 3);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingNetworkDownloadSegments", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "downloadSegments": 1 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "network": { "downloadSegments": 17 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingNetworkRestSearchConcurrency", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkRestSearchConcurrency>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "restSearchConcurrency": 4 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkRestSearchConcurrency>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "network": { "restSearchConcurrency": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkRestSearchConcurrency>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingSourceDataOnlyStorage", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE_FALSE(userSettingTest.Get<Setting::SourceDataOnlyStorage>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Enabled")
+    {
+        std::string_view json = R"({ "source": { "dataOnlyStorage": true } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::SourceDataOnlyStorage>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+}
+
+TEST_CASE("SettingNetworkHttp2", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkHttp2>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Disabled")
+    {
+        std::string_view json = R"({ "network": { "http2": false } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE_FALSE(userSettingTest.Get<Setting::NetworkHttp2>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+}
+
+TEST_CASE("SettingNetworkInstallerMirrors", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkInstallerMirrors>().empty());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "installerMirrors": [ "https://mirror.contoso.com/winget/" ] } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkInstallerMirrors>() == std::vector<std::string>{ "https://mirror.contoso.com/winget/" });
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Insecure mirror")
+    {
+        std::string_view json = R"({ "network": { "installerMirrors": [ "https://mirror.contoso.com/", "http://mirror.contoso.com/" ] } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkInstallerMirrors>().empty());
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingPackageReadCache", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCachePageSizeInKB>() == 128);
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCacheMaximumPages>() == 200);
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCacheDiskSizeInMB>() == 0);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "packageReadCache": { "pageSizeInKB": 64, "maxPages": 1000, "diskSizeInMB": 64 } } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCachePageSizeInKB>() == 64);
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCacheMaximumPages>() == 1000);
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCacheDiskSizeInMB>() == 64);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "network": { "packageReadCache": { "pageSizeInKB": 1, "maxPages": 0, "diskSizeInMB": 5000 } } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCachePageSizeInKB>() == 128);
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCacheMaximumPages>() == 200);
+        REQUIRE(userSettingTest.Get<Setting::PackageReadCacheDiskSizeInMB>() == 0);
+        REQUIRE(userSettingTest.GetWarnings().size() == 3);
+    }
+}
+
+TEST_CASE("SettingMemoryBudget", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::MemoryBudgetInMB>() == 0);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "memory": { "budgetInMB": 512 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::MemoryBudgetInMB>() == 512);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "memory": { "budgetInMB": 16 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::MemoryBudgetInMB>() == 0);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingServerIdleTimeout", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::ServerIdleTimeoutInSeconds>() == 0s);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "server": { "idleTimeoutInSeconds": 300 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::ServerIdleTimeoutInSeconds>() == 300s);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "server": { "idleTimeoutInSeconds": 86400 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::ServerIdleTimeoutInSeconds>() == 0s);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
 TEST_CASE("SettingsExperimentalCmd", "[settings]")
 {
     DeleteUserSettingsFiles();
@@ -413,3 +834,180 @@ TEST_CASE("SettingsExperimentalCmd", "[settings]")
         REQUIRE(userSettingTest.GetWarnings().size() == 0);
     }
 }
+
+TEST_CASE("UserSettingsSnapshot", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    std::string_view json = R"({
+        "visual": { "progressBar": "retro" },
+        "source": { "autoUpdateIntervalInMinutes": "not a number" },
+        "network": { "downloadSegments": 2 },
+        "installBehavior": { "preferences": { "locale": [ "en-US", "fr-FR" ] } },
+        "logging": { "level": "verbose" },
+        "telemetry": { "disable": true }
+    })";
+    SetSetting(Stream::PrimaryUserSettings, json);
+
+    {
+        UserSettingsTest userSettingTest;
+        REQUIRE(userSettingTest.GetType() == UserSettingsType::Standard);
+    }
+
+    REQUIRE(std::filesystem::exists(UserSettings::SnapshotFilePath()));
+
+    SECTION("Reused")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.GetType() == UserSettingsType::Standard);
+        REQUIRE(userSettingTest.Get<Setting::ProgressBarVisualStyle>() == VisualStyle::Retro);
+        REQUIRE(userSettingTest.Get<Setting::AutoUpdateTimeInMinutes>() == 5min);
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 2);
+        REQUIRE(userSettingTest.Get<Setting::InstallLocalePreference>() == std::vector<std::string>{ "en-US", "fr-FR" });
+        REQUIRE(userSettingTest.Get<Setting::LoggingLevelPreference>() == Level::Verbose);
+        REQUIRE(userSettingTest.Get<Setting::TelemetryDisable>());
+
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+        REQUIRE(userSettingTest.GetWarnings()[0].Message == AppInstaller::StringResource::String::SettingsWarningInvalidFieldFormat);
+        REQUIRE(userSettingTest.GetWarnings()[0].Path == ".source.autoUpdateIntervalInMinutes");
+    }
+    SECTION("Settings changed without changing size")
+    {
+        std::string changed{ json };
+        changed.replace(changed.find("\"downloadSegments\": 2"), 21, "\"downloadSegments\": 3");
+        SetSetting(Stream::PrimaryUserSettings, changed);
+
+        UserSettingsTest userSettingTest;
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 3);
+    }
+    SECTION("Settings removed")
+    {
+        DeleteUserSettingsFiles();
+
+        UserSettingsTest userSettingTest;
+        REQUIRE(userSettingTest.GetType() == UserSettingsType::Default);
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 4);
+    }
+    SECTION("Snapshot corrupted")
+    {
+        {
+            std::ofstream stream{ UserSettings::SnapshotFilePath(), std::ios::binary | std::ios::trunc };
+            stream << "WGSETSNP and then some data that is not a snapshot";
+        }
+
+        UserSettingsTest userSettingTest;
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 2);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+    SECTION("Group policy applied after the snapshot")
+    {
+        auto policiesKey = RegCreateVolatileTestRoot();
+        SetRegistryValue(policiesKey.get(), SourceUpdateIntervalPolicyValueName, (DWORD)300);
+        GroupPolicyTestOverride policies{ policiesKey.get() };
+
+        UserSettingsTest userSettingTest;
+        REQUIRE(userSettingTest.Get<Setting::AutoUpdateTimeInMinutes>() == 300min);
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 2);
+
+        // The policy replaces the value from the file, along with its warning.
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Values decoded on first read from several threads")
+    {
+        UserSettingsTest userSettingTest;
+
+        std::vector<std::thread> threads;
+        std::atomic<size_t> matched = 0;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            threads.emplace_back([&]()
+                {
+                    if (userSettingTest.Get<Setting::InstallLocalePreference>() == std::vector<std::string>{ "en-US", "fr-FR" } &&
+                        userSettingTest.Get<Setting::NetworkDownloadSegments>() == 2)
+                    {
+                        ++matched;
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(matched == threads.size());
+    }
+    SECTION("Encoded values written back to the snapshot")
+    {
+        // Changing only the file time causes the snapshot to be rewritten from the values that were never decoded.
+        auto primaryPath = UserSettings::SettingsFilePath();
+        std::filesystem::last_write_time(primaryPath, std::filesystem::last_write_time(primaryPath) + 1h);
+
+        {
+            UserSettingsTest userSettingTest;
+            REQUIRE(userSettingTest.GetType() == UserSettingsType::Standard);
+        }
+
+        UserSettingsTest userSettingTest;
+        REQUIRE(userSettingTest.Get<Setting::ProgressBarVisualStyle>() == VisualStyle::Retro);
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 2);
+        REQUIRE(userSettingTest.Get<Setting::LoggingLevelPreference>() == Level::Verbose);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingInstallMsiTransaction", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE_FALSE(userSettingTest.Get<Setting::InstallMsiTransaction>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Enabled")
+    {
+        std::string_view json = R"({ "installBehavior": { "msiTransaction": true } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::InstallMsiTransaction>());
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+}
+
+TEST_CASE("SettingNetworkConnectionScheduling", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkMaxConnectionsPerHost>() == 6);
+        REQUIRE(userSettingTest.Get<Setting::NetworkBandwidthLimitInKBps>() == 0);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "maxConnectionsPerHost": 2, "bandwidthLimitInKBps": 512 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkMaxConnectionsPerHost>() == 2);
+        REQUIRE(userSettingTest.Get<Setting::NetworkBandwidthLimitInKBps>() == 512);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value")
+    {
+        std::string_view json = R"({ "network": { "maxConnectionsPerHost": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkMaxConnectionsPerHost>() == 6);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
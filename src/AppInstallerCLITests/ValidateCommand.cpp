@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "Commands/ValidateCommand.h"
+#include <AppInstallerErrors.h>
+#include <Resources.h>
+
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::CLI;
+
+TEST_CASE("ValidateCommandRecursive", "[ManifestValidation]")
+{
+    TestCommon::TempDirectory root("ValidateCommandTree");
+    std::filesystem::create_directories(root.GetPath() / "Good" / "1.0");
+    std::filesystem::create_directories(root.GetPath() / "Bad" / "1.0");
+    std::filesystem::create_directories(root.GetPath() / "Empty");
+    std::filesystem::copy(TestDataFile("ManifestV1_2-Singleton.yaml"), root.GetPath() / "Good" / "1.0");
+    std::filesystem::copy(TestDataFile("Manifest-Bad-IdMissing.yaml"), root.GetPath() / "Bad" / "1.0");
+
+    std::ostringstream validateOutput;
+    Execution::Context context{ validateOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::ValidateManifest, root.GetPath().u8string());
+    context.Args.AddArg(Execution::Args::Type::ValidateRecurse);
+    ValidateCommand validateCommand({});
+
+    validateCommand.Execute(context);
+    INFO(validateOutput.str());
+
+    // Only the directories with manifests are validated, and any failure fails the command
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE);
+    REQUIRE(validateOutput.str().find((root.GetPath() / "Good" / "1.0").u8string()) != std::string::npos);
+    REQUIRE(validateOutput.str().find((root.GetPath() / "Bad" / "1.0").u8string()) != std::string::npos);
+    REQUIRE(validateOutput.str().find((root.GetPath() / "Empty").u8string()) == std::string::npos);
+    REQUIRE(validateOutput.str().find(Resource::LocString(Resource::String::ManifestValidationSummaryTotal).get() + " 2") != std::string::npos);
+    REQUIRE(validateOutput.str().find(Resource::LocString(Resource::String::ManifestValidationSummaryFailed).get() + " 1") != std::string::npos);
+}
@@ -191,3 +191,49 @@ TEST_CASE("VersionUnknownLessThanLatest", "[versions]")
 {
     REQUIRE(Version::CreateUnknown() < Version::CreateLatest());
 }
+
+TEST_CASE("VersionCompareIntegerOnly", "[versions]")
+{
+    RequireLessThan("", "0.1");
+    RequireLessThan("1.2", "1.10");
+    RequireLessThan("1.2", "1.2.1");
+    RequireLessThan("1.0.9", "1.1");
+    RequireLessThan("1.2-beta", "1.2");
+    RequireLessThan("1.2", "1.3-beta");
+    RequireLessThan("1.2.3.4", "latest");
+
+    RequireEqual("", "0.0");
+    RequireEqual("1.2.0.0", "1.2");
+    RequireEqual("v1.2", "v1.2.0");
+
+    Version reassigned{ "1.fork" };
+    reassigned.Assign("2.0");
+    REQUIRE(reassigned.GetParts().size() == 1);
+    REQUIRE(reassigned == Version("2"));
+}
+
+// This skipped test case measures the time needed to sort a large list of versions.
+TEST_CASE("VersionSort_Benchmark", "[.]")
+{
+    constexpr size_t count = 100000;
+
+    std::vector<Version> versions;
+    versions.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::ostringstream stream;
+        stream << (i * 7919 % 97) << '.' << (i % 13) << '.' << (i * 31 % 1009);
+        if (i % 10 == 0)
+        {
+            stream << "-beta" << (i % 3);
+        }
+        versions.emplace_back(stream.str());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::sort(versions.begin(), versions.end());
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    REQUIRE(std::is_sorted(versions.begin(), versions.end()));
+    WARN("Sorted " << count << " versions in " << elapsed.count() << "us");
+}
@@ -12,6 +12,7 @@
 #include <AppInstallerStrings.h>
 #include <Workflows/ImportExportFlow.h>
 #include <Workflows/DownloadFlow.h>
+#include <Workflows/EarlySourceOpen.h>
 #include <Workflows/InstallFlow.h>
 #include <Workflows/MsiInstallFlow.h>
 #include <Workflows/UninstallFlow.h>
@@ -38,6 +39,7 @@
 #include <AppInstallerFileLogger.h>
 #include <Commands/ValidateCommand.h>
 #include <winget/Settings.h>
+#include <Microsoft/PredefinedInstalledSourceFactory.h>
 
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::Management::Deployment;
@@ -65,6 +67,22 @@ namespace
         {
             SearchResult result;
 
+            // Multiple inclusions are OR'ed together, so return the combined results of each one
+            if (!request.Query && request.Inclusions.size() > 1)
+            {
+                for (const auto& inclusion : request.Inclusions)
+                {
+                    SearchRequest singleRequest;
+                    singleRequest.Inclusions.emplace_back(inclusion);
+                    singleRequest.Filters = request.Filters;
+
+                    auto singleResult = Search(singleRequest);
+                    std::move(singleResult.Matches.begin(), singleResult.Matches.end(), std::back_inserter(result.Matches));
+                }
+
+                return result;
+            }
+
             std::string input;
 
             if (request.Query)
@@ -361,6 +379,16 @@ namespace
             wto.UseCount++;
 
             Override(wto);
+
+            WorkflowTaskOverride prefetch
+            { PrefetchInstallers, [](TestContext&)
+                {
+                    // Do nothing; the test installers are never downloaded.
+            } };
+
+            prefetch.UseCount++;
+
+            Override(prefetch);
         }
 
         TestContext(std::ostream& out, std::istream& in, bool isClone, std::shared_ptr<std::vector<WorkflowTaskOverride>> overrides) :
@@ -1598,6 +1626,80 @@ TEST_CASE("UpdateFlow_UpdateAllApplicable", "[UpdateFlow][workflow]")
     REQUIRE(std::filesystem::exists(updateMSStoreResultPath.GetPath()));
 }
 
+TEST_CASE("UpdateFlow_UpdateAllApplicable_MatchOrder", "[UpdateFlow][workflow]")
+{
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+
+    std::vector<std::string> matchIds;
+    std::vector<std::string> packageIds;
+    context.Override({ DownloadInstallersForLater, [&](TestContext& context)
+        {
+            for (const auto& match : context.Get<Execution::Data::SearchResult>().Matches)
+            {
+                matchIds.emplace_back(match.Package->GetProperty(AppInstaller::Repository::PackageProperty::Id).get());
+            }
+
+            for (const auto& package : context.Get<Execution::Data::PackagesToInstall>())
+            {
+                packageIds.emplace_back(package->Get<Execution::Data::Manifest>().Id);
+            }
+        } });
+
+    context.Args.AddArg(Execution::Args::Type::Prefetch);
+
+    UpgradeCommand update({});
+    update.Execute(context);
+    INFO(updateOutput.str());
+
+    // The applicability checks run concurrently, but the packages are in the order of the matches.
+    REQUIRE(packageIds.size() >= 3);
+
+    auto previousMatch = matchIds.begin();
+    for (const auto& id : packageIds)
+    {
+        auto match = std::find(matchIds.begin(), matchIds.end(), id);
+        REQUIRE(match != matchIds.end());
+        REQUIRE(match >= previousMatch);
+        previousMatch = match;
+    }
+}
+
+TEST_CASE("UpdateFlow_Prefetch", "[UpdateFlow][workflow]")
+{
+    TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
+    TestCommon::TempFile updateMsixResultPath("TestMsixInstalled.txt");
+    TestCommon::TempFile updateMSStoreResultPath("TestMSStoreUpdated.txt");
+
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    OverrideForShellExecute(context);
+    OverrideForMSIX(context);
+    OverrideForMSStore(context, true);
+
+    size_t packagesToDownload = 0;
+    context.Override({ DownloadInstallersForLater, [&](TestContext& context)
+        {
+            packagesToDownload = context.Get<Execution::Data::PackagesToInstall>().size();
+        } });
+
+    context.Args.AddArg(Execution::Args::Type::Prefetch);
+
+    UpgradeCommand update({});
+    update.Execute(context);
+    INFO(updateOutput.str());
+
+    // Verify the installers are downloaded for the same packages, but none are installed.
+    REQUIRE(packagesToDownload >= 3);
+    REQUIRE(!std::filesystem::exists(updateExeResultPath.GetPath()));
+    REQUIRE(!std::filesystem::exists(updateMsixResultPath.GetPath()));
+    REQUIRE(!std::filesystem::exists(updateMSStoreResultPath.GetPath()));
+}
+
 TEST_CASE("UpdateFlow_UpgradeWithDuplicateUpgradeItemsFound", "[UpdateFlow][workflow]")
 {
     TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
@@ -1834,6 +1936,45 @@ TEST_CASE("UninstallFlow_UninstallMSStore", "[UninstallFlow][workflow]")
     REQUIRE(uninstallResultStr.find("microsoft.skypeapp_kzf8qxf38zg5c") != std::string::npos);
 }
 
+TEST_CASE("UninstallFlow_UninstallMultiple", "[UninstallFlow][workflow]")
+{
+    TestCommon::TempFile exeUninstallResultPath("TestExeUninstalled.txt");
+    TestCommon::TempFile msixUninstallResultPath("TestMsixUninstalled.txt");
+
+    std::ostringstream uninstallOutput;
+    TestContext context{ uninstallOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    OverrideForExeUninstall(context);
+    OverrideForMSIXUninstall(context);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestExeInstaller"sv);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestMsixInstaller"sv);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.MissingApp"sv);
+    context.Args.AddArg(Execution::Args::Type::Silent);
+
+    UninstallCommand uninstall({});
+    uninstall.Execute(context);
+    INFO(uninstallOutput.str());
+
+    // Both of the packages that were found are uninstalled, with the query that was not found reported as a failure.
+    REQUIRE(std::filesystem::exists(exeUninstallResultPath.GetPath()));
+    std::ifstream exeUninstallResultFile(exeUninstallResultPath.GetPath());
+    REQUIRE(exeUninstallResultFile.is_open());
+    std::string exeUninstallResultStr;
+    std::getline(exeUninstallResultFile, exeUninstallResultStr);
+    REQUIRE(exeUninstallResultStr.find("/silence") != std::string::npos);
+
+    REQUIRE(std::filesystem::exists(msixUninstallResultPath.GetPath()));
+    std::ifstream msixUninstallResultFile(msixUninstallResultPath.GetPath());
+    REQUIRE(msixUninstallResultFile.is_open());
+    std::string msixUninstallResultStr;
+    std::getline(msixUninstallResultFile, msixUninstallResultStr);
+    REQUIRE(msixUninstallResultStr.find("20477fca-282d-49fb-b03e-371dca074f0f_8wekyb3d8bbwe") != std::string::npos);
+
+    REQUIRE(uninstallOutput.str().find(Resource::LocString(Resource::String::UninstallMultipleHasFailures).get()) != std::string::npos);
+    REQUIRE(context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_NO_APPLICATIONS_FOUND);
+}
+
 TEST_CASE("UninstallFlow_UninstallExeNotFound", "[UninstallFlow][workflow]")
 {
     TestCommon::TempFile uninstallResultPath("TestExeUninstalled.txt");
@@ -1926,6 +2067,28 @@ TEST_CASE("ExportFlow_ExportAll_WithVersions", "[ExportFlow][workflow]")
         }));
 }
 
+TEST_CASE("ExportFlow_ExportAll_SkipAgreementsCheck", "[ExportFlow][workflow]")
+{
+    TestCommon::TempFile exportResultPath("TestExport.json");
+
+    std::ostringstream exportOutput;
+    TestContext context{ exportOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    context.Args.AddArg(Execution::Args::Type::OutputFile, exportResultPath);
+    context.Args.AddArg(Execution::Args::Type::SkipAgreementsCheck);
+
+    ExportCommand exportCommand({});
+    exportCommand.Execute(context);
+    INFO(exportOutput.str());
+
+    // Skipping the check should not change the exported packages
+    const auto& exportedCollection = context.Get<Execution::Data::PackageCollection>();
+    REQUIRE(exportedCollection.Sources.size() == 1);
+    REQUIRE(exportedCollection.Sources[0].Packages.size() == 3);
+    REQUIRE(exportOutput.str().find(Resource::LocString(Resource::String::ExportedPackageRequiresLicenseAgreement).get()) == std::string::npos);
+}
+
 TEST_CASE("ImportFlow_Successful", "[ImportFlow][workflow]")
 {
     TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
@@ -2639,3 +2802,158 @@ TEST_CASE("AdminSetting_LocalManifestFiles", "[LocalManifests][workflow]")
         REQUIRE_THROWS(installCommand3.ValidateArguments(args3));
     }
 }
+
+TEST_CASE("EarlySourceOpen_SourcesTaken", "[workflow]")
+{
+    SetSetting(Stream::UserSources, R"(
+Sources:
+  - Name: winget
+    Type: ""
+    Arg: ""
+    Data: ""
+    IsTombstone: true
+  - Name: msstore
+    Type: ""
+    Arg: ""
+    Data: ""
+    IsTombstone: true
+  - Name: testName
+    Type: testType
+    Arg: testArg
+    Data: testData
+    IsTombstone: false
+)"sv);
+    auto removeSources = wil::scope_exit([]() { RemoveSetting(Stream::UserSources); });
+
+    std::atomic<size_t> availableOpens = 0;
+    TestSourceFactory availableFactory{ [&](const SourceDetails& details) { ++availableOpens; return std::shared_ptr<ISource>{ std::make_shared<TestSource>(details) }; } };
+    std::atomic<size_t> installedOpens = 0;
+    TestSourceFactory installedFactory{ [&](const SourceDetails& details) { ++installedOpens; return std::shared_ptr<ISource>{ std::make_shared<TestSource>(details) }; } };
+
+    TestHook_SetSourceFactoryOverride("testType", availableFactory);
+    TestHook_SetSourceFactoryOverride(std::string{ Repository::Microsoft::PredefinedInstalledSourceFactory::Type() }, installedFactory);
+    auto clearOverrides = wil::scope_exit([]() { TestHook_ClearSourceFactoryOverrides(); });
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    context.Add<Execution::Data::EarlySourceOpen>(std::make_shared<EarlySourceOpen>(context));
+
+    context << OpenSource() << OpenPredefinedSource(PredefinedSource::Installed);
+    INFO(output.str());
+
+    // The sources opened early are taken rather than opened again
+    REQUIRE(!context.IsTerminated());
+    REQUIRE(availableOpens == 1);
+    REQUIRE(installedOpens == 1);
+
+    // They can only be taken once; later opens happen as usual
+    context << OpenSource() << OpenPredefinedSource(PredefinedSource::Installed);
+    REQUIRE(!context.IsTerminated());
+    REQUIRE(availableOpens == 2);
+    REQUIRE(installedOpens == 2);
+}
+
+TEST_CASE("EarlySourceOpen_InstalledOnly", "[workflow]")
+{
+    std::atomic<size_t> installedOpens = 0;
+    TestSourceFactory installedFactory{ [&](const SourceDetails& details) { ++installedOpens; return std::shared_ptr<ISource>{ std::make_shared<TestSource>(details) }; } };
+
+    TestHook_SetSourceFactoryOverride(std::string{ Repository::Microsoft::PredefinedInstalledSourceFactory::Type() }, installedFactory);
+    auto clearOverrides = wil::scope_exit([]() { TestHook_ClearSourceFactoryOverrides(); });
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    auto earlySourceOpen = std::make_shared<EarlySourceOpen>(context, false);
+
+    // No default sources were opened to be taken
+    std::vector<SourceDetails> updateFailures;
+    REQUIRE(!earlySourceOpen->TakeDefaultSources(context, updateFailures));
+    REQUIRE(updateFailures.empty());
+
+    REQUIRE(earlySourceOpen->TakePredefinedSource(context, PredefinedSource::Installed));
+    REQUIRE(installedOpens == 1);
+}
+
+TEST_CASE("ReverifyInstallerHash_LockedInstallerFile", "[ReverifyInstallerHash][workflow]")
+{
+    TestCommon::TempFile installerFile("TestLockedInstaller", ".exe");
+    {
+        std::ofstream file(installerFile.GetPath(), std::ofstream::out | std::ofstream::binary);
+        file << "installer";
+    }
+    auto installerHash = SHA256::ComputeHashFromFile(installerFile.GetPath());
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+
+    ManifestInstaller installer;
+    installer.Sha256 = installerHash;
+    context.Add<Execution::Data::Installer>(installer);
+    context.Add<Execution::Data::InstallerPath>(installerFile.GetPath());
+    context.Add<Execution::Data::HashPair>(std::make_pair(installerHash, installerHash));
+
+    context << LockInstallerFile;
+    REQUIRE(context.Contains(Execution::Data::InstallerFileLock));
+
+    // Others cannot write the file while it is locked
+    wil::unique_hfile writeHandle{ CreateFileW(installerFile.GetPath().c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 0, nullptr) };
+    REQUIRE(!writeHandle);
+
+    context << ReverifyInstallerHash;
+    INFO(output.str());
+
+    REQUIRE(!context.IsTerminated());
+    REQUIRE(WI_IsFlagSet(context.GetFlags(), ContextFlag::InstallerHashMatched));
+
+    // The lock is released once the file is reverified
+    REQUIRE(!context.Contains(Execution::Data::InstallerFileLock));
+    writeHandle.reset(CreateFileW(installerFile.GetPath().c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 0, nullptr));
+    REQUIRE(writeHandle);
+}
+
+TEST_CASE("UpdateInstallerFileMotw_UsesPrefetchScanResult", "[DownloadInstaller][workflow]")
+{
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+
+    ManifestInstaller installer;
+    installer.Url = "https://example.com/installer.exe";
+    context.Add<Execution::Data::Installer>(installer);
+    context.Add<Execution::Data::InstallerPath>(TestDataFile("AppInstallerTestExeInstaller.exe"));
+    context.SetFlags(ContextFlag::InstallerHashMatched);
+
+    // The failure from the scan done by the prefetch is reported without scanning again
+    context.Add<Execution::Data::InstallerScanResult>(std::make_pair(context.Get<Execution::Data::InstallerPath>(), E_FAIL));
+
+    context << UpdateInstallerFileMotwIfApplicable;
+    INFO(output.str());
+
+    REQUIRE_TERMINATED_WITH(context, APPINSTALLER_CLI_ERROR_INSTALLER_SECURITY_CHECK_FAILED);
+    REQUIRE(output.str().find(Resource::LocString(Resource::String::InstallerFailedVirusScan).get()) != std::string::npos);
+}
+
+TEST_CASE("OpenDependencySource_ReusesInstalledSource", "[workflow][dependencies]")
+{
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+
+    auto installedSource = std::make_shared<TestSource>(SourceDetails{ "InstalledTestSource", "Microsoft.TestSource", "//arg", "", "*InstalledTestSource" });
+    auto availableSource = std::make_shared<TestSource>();
+    context.Add<Execution::Data::Source>(Source{ Source{ installedSource }, Source{ availableSource } });
+
+    auto manifest = YamlParser::CreateFromPath(TestDataFile("InstallFlowTest_Exe.yaml"));
+    context.Add<Execution::Data::PackageVersion>(TestPackageVersion::Make(manifest, availableSource));
+
+    context << Workflow::OpenDependencySource;
+    INFO(output.str());
+
+    REQUIRE_FALSE(context.IsTerminated());
+    const auto& dependencySource = context.Get<Execution::Data::DependencySource>();
+    REQUIRE(dependencySource.IsComposite());
+    REQUIRE(dependencySource.GetInstalledSource().GetIdentifier() == installedSource->GetIdentifier());
+}
@@ -5,6 +5,9 @@
 #include <AppInstallerSHA256.h>
 #include <winget/ManifestYamlParser.h>
 #include <winget/Yaml.h>
+#ifdef _DEBUG
+#include <crtdbg.h>
+#endif
 
 using namespace TestCommon;
 using namespace AppInstaller::Manifest;
@@ -287,6 +290,65 @@ TEST_CASE("ReadBadManifests", "[ManifestValidation]")
     }
 }
 
+TEST_CASE("ReadManifestsConcurrently", "[ManifestValidation]")
+{
+    // The compiled schemas are shared across threads; validating concurrently must give the same results.
+    std::vector<std::string> testFiles =
+    {
+        "Manifest-Good-Minimum.yaml",
+        "Manifest-Good-PackageFamilyNameOnExe-Ver1_2.yaml",
+        "ManifestV1-Singleton.yaml",
+        "ManifestV1_1-Singleton.yaml",
+        "Manifest-Bad-IdInvalid.yaml",
+        "Manifest-Bad-Sha256Invalid.yaml",
+        "Manifest-Bad-VersionMissing.yaml",
+    };
+
+    auto readManifest = [](const std::string& testFile)
+    {
+        try
+        {
+            (void)YamlParser::CreateFromPath(TestDataFile(testFile), GetTestManifestValidateOption());
+            return std::string{};
+        }
+        catch (const ManifestException& e)
+        {
+            return e.GetManifestErrorMessage();
+        }
+    };
+
+    std::vector<std::string> expected;
+    for (const auto& testFile : testFiles)
+    {
+        expected.emplace_back(readManifest(testFile));
+    }
+
+    constexpr size_t threadCount = 4;
+    std::vector<std::vector<std::string>> actual(threadCount);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([&, i]()
+            {
+                for (const auto& testFile : testFiles)
+                {
+                    actual[i].emplace_back(readManifest(testFile));
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto& results : actual)
+    {
+        REQUIRE(results == expected);
+    }
+}
+
 TEST_CASE("ManifestEncoding", "[ManifestValidation]")
 {
     ManifestTestCase TestCases[] =
@@ -667,6 +729,191 @@ TEST_CASE("ValidateV1_2GoodManifestAndVerifyContents", "[ManifestValidation]")
     VerifyV1ManifestContent(mergedManifest, false, ManifestVer{ s_ManifestVersionV1_2 });
 }
 
+TEST_CASE("YamlLoad_Structure", "[YAML]")
+{
+    using namespace std::string_view_literals;
+
+    Node root = AppInstaller::YAML::Load(R"(
+Scalar: value
+Empty:
+Sequence:
+  - one
+  - two
+Mapping:
+  Inner: &anchor inner
+  Nested: &nested
+    Key: nestedValue
+Alias: *anchor
+NestedAlias: *nested
+)"sv);
+
+    REQUIRE(root.IsMap());
+    REQUIRE(root.size() == 7);
+    REQUIRE(root["Scalar"sv].as<std::string>() == "value");
+    REQUIRE(root["Empty"sv].IsNull());
+    REQUIRE(root["Sequence"sv].IsSequence());
+    REQUIRE(root["Sequence"sv].size() == 2);
+    REQUIRE(root["Sequence"sv][1].as<std::string>() == "two");
+    REQUIRE(root["Mapping"sv]["Inner"sv].as<std::string>() == "inner");
+    REQUIRE(root["Alias"sv].as<std::string>() == "inner");
+    REQUIRE(root["NestedAlias"sv]["Key"sv].as<std::string>() == "nestedValue");
+    REQUIRE(root["Mapping"sv].Mark().line == 8);
+}
+
+TEST_CASE("YamlLoad_Errors", "[YAML]")
+{
+    using namespace std::string_view_literals;
+
+    REQUIRE_FALSE(AppInstaller::YAML::Load(""sv));
+    REQUIRE_THROWS_HR(AppInstaller::YAML::Load("? [ a, b ]\n: value\n"sv), APPINSTALLER_CLI_ERROR_YAML_INVALID_MAPPING_KEY);
+    REQUIRE_THROWS_AS(AppInstaller::YAML::Load("Key: *missing\n"sv), AppInstaller::YAML::Exception);
+    REQUIRE_THROWS_AS(AppInstaller::YAML::Load("Key: [ unterminated\n"sv), AppInstaller::YAML::Exception);
+}
+
+#ifdef _DEBUG
+namespace
+{
+    std::atomic<size_t> s_YamlLoadBenchmarkAllocations = 0;
+
+    int YamlLoadBenchmarkAllocHook(int allocType, void*, size_t, int, long, const unsigned char*, int)
+    {
+        if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC)
+        {
+            ++s_YamlLoadBenchmarkAllocations;
+        }
+        return TRUE;
+    }
+}
+#endif
+
+// This skipped test case measures the time, and in debug builds the number of allocations,
+// needed to load every YAML file in the test data into nodes.
+TEST_CASE("YamlLoad_Benchmark", "[.]")
+{
+    constexpr size_t iterations = 20;
+
+    std::vector<std::string> contents;
+    for (const auto& entry : std::filesystem::directory_iterator(TestDataFile(".").GetPath()))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".yaml")
+        {
+            std::ifstream stream(entry.path(), std::ios_base::in | std::ios_base::binary);
+            contents.emplace_back(AppInstaller::Utility::ReadEntireStream(stream));
+        }
+    }
+    REQUIRE(!contents.empty());
+
+#ifdef _DEBUG
+    s_YamlLoadBenchmarkAllocations = 0;
+    _CRT_ALLOC_HOOK previousHook = _CrtSetAllocHook(YamlLoadBenchmarkAllocHook);
+#endif
+
+    size_t loaded = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& content : contents)
+        {
+            try
+            {
+                AppInstaller::YAML::Load(content);
+                ++loaded;
+            }
+            catch (const AppInstaller::YAML::Exception&) {}
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+#ifdef _DEBUG
+    _CrtSetAllocHook(previousHook);
+    WARN("Allocations per load: " << (s_YamlLoadBenchmarkAllocations / std::max<size_t>(loaded, 1)));
+#endif
+
+    WARN("Loaded " << loaded << " documents from " << contents.size() << " files in " << elapsed.count() << "us");
+}
+
+#ifdef _DEBUG
+namespace
+{
+    // Creates a singleton manifest whose installers each override the given number of root dependencies.
+    std::string CreateManyInstallersManifest(size_t installers, size_t rootDependencies)
+    {
+        std::ostringstream stream;
+        stream <<
+            "PackageIdentifier: AppInstallerCliTest.ManyInstallers\n"
+            "PackageVersion: 1.0.0.0\n"
+            "PackageLocale: en-US\n"
+            "PackageName: AppInstaller Test Many Installers\n"
+            "Publisher: Microsoft Corporation\n"
+            "License: Test\n"
+            "ShortDescription: AppInstaller Test Many Installers\n";
+
+        if (rootDependencies)
+        {
+            stream << "Dependencies:\n  PackageDependencies:\n";
+            for (size_t i = 0; i < rootDependencies; ++i)
+            {
+                stream << "    - PackageIdentifier: AppInstallerCliTest.RootDependency" << i << "\n";
+            }
+        }
+
+        stream << "Installers:\n";
+        for (size_t i = 0; i < installers; ++i)
+        {
+            stream <<
+                "  - Architecture: x64\n"
+                "    InstallerLocale: en-" << (100 + i) << "\n"
+                "    InstallerUrl: https://ThisIsNotUsed/Installer" << i << ".exe\n"
+                "    InstallerType: exe\n"
+                "    InstallerSha256: 65DB2F2AC2686C7F2FD69D4A4C6683B888DC55BFA20A0E32CA9F838B51689A3B\n"
+                "    InstallerSwitches:\n"
+                "      Silent: /silence\n"
+                "      SilentWithProgress: /silentwithprogress\n"
+                "    Dependencies:\n"
+                "      PackageDependencies:\n"
+                "        - PackageIdentifier: AppInstallerCliTest.InstallerDependency" << i << "\n";
+        }
+
+        stream << "ManifestType: singleton\nManifestVersion: 1.0.0\n";
+        return stream.str();
+    }
+
+    // Counts the allocations made to create the manifest from the document, which is loaded before counting.
+    size_t CountManifestParseAllocations(const std::string& content)
+    {
+        std::vector<YamlManifestInfo> docs(1);
+        docs[0].Root = AppInstaller::YAML::Load(content);
+
+        s_YamlLoadBenchmarkAllocations = 0;
+        _CRT_ALLOC_HOOK previousHook = _CrtSetAllocHook(YamlLoadBenchmarkAllocHook);
+        auto restoreHook = wil::scope_exit([&]() { _CrtSetAllocHook(previousHook); });
+
+        Manifest manifest = ParseManifest(docs);
+        size_t result = s_YamlLoadBenchmarkAllocations;
+
+        REQUIRE(manifest.Installers.size() > 0);
+        return result;
+    }
+}
+
+TEST_CASE("ManifestParse_AllocationsDoNotScaleWithRootValues", "[ManifestValidation]")
+{
+    constexpr size_t installers = 40;
+    constexpr size_t rootDependencies = 50;
+
+    size_t withoutRootDependencies = CountManifestParseAllocations(CreateManyInstallersManifest(installers, 0));
+    size_t withRootDependencies = CountManifestParseAllocations(CreateManyInstallersManifest(installers, rootDependencies));
+    REQUIRE(withRootDependencies > withoutRootDependencies);
+
+    // Installers that override the root dependencies must not pay for copying them; reading them once is a few allocations each.
+    size_t rootDependencyAllocations = withRootDependencies - withoutRootDependencies;
+    INFO("Allocations for the root dependencies: " << rootDependencyAllocations);
+    REQUIRE(rootDependencyAllocations < installers * rootDependencies);
+}
+#endif
+
 YamlManifestInfo CreateYamlManifestInfo(std::string testDataFile)
 {
     YamlManifestInfo result;
@@ -778,4 +1025,72 @@ TEST_CASE("ManifestApplyLocale", "[ManifestValidation]")
     REQUIRE(manifest.CurrentLocalization.Locale == "fr-FR");
     REQUIRE(manifest.CurrentLocalization.Get<Localization::PackageName>() == "fr-FR package name");
     REQUIRE(manifest.CurrentLocalization.Get<Localization::Publisher>() == "es-MX publisher");
-}
\ No newline at end of file
+}
+
+TEST_CASE("ManifestApplyLocale_DeferredLocalizations", "[ManifestValidation]")
+{
+    Manifest manifest = YamlParser::CreateFromPath(TestDataFile("Manifest-Good-MultiLocale.yaml"));
+
+    // Only the locale is read until the data is needed.
+    REQUIRE(manifest.Localizations.size() == 2);
+    REQUIRE(manifest.Localizations[0].Locale == "en-GB");
+    REQUIRE(manifest.Localizations[0].IsDeferred());
+    REQUIRE(manifest.Localizations[1].Locale == "fr-FR");
+    REQUIRE(manifest.Localizations[1].IsDeferred());
+
+    // Copies share the population.
+    Manifest copy = manifest;
+
+    manifest.ApplyLocale("en-US");
+    REQUIRE(manifest.CurrentLocalization.Locale == "en-GB");
+    REQUIRE(manifest.CurrentLocalization.Get<Localization::PackageName>() == "en-GB package name");
+    REQUIRE(manifest.CurrentLocalization.Get<Localization::Publisher>() == "en-GB publisher");
+    REQUIRE_FALSE(manifest.Localizations[0].IsDeferred());
+    REQUIRE(manifest.Localizations[1].IsDeferred());
+    REQUIRE_FALSE(copy.Localizations[0].IsDeferred());
+
+    // Modifying a copy does not change the shared data.
+    copy.Localizations[0].Add<Localization::Publisher>("Modified publisher");
+    REQUIRE(copy.Localizations[0].Get<Localization::Publisher>() == "Modified publisher");
+    REQUIRE(manifest.Localizations[0].Get<Localization::Publisher>() == "en-GB publisher");
+
+    // Full validation populates everything up front, with the same results.
+    ManifestValidateOption validateOption;
+    validateOption.FullValidation = true;
+    Manifest validated = YamlParser::CreateFromPath(TestDataFile("Manifest-Good-MultiLocale.yaml"), validateOption);
+    REQUIRE(validated.Localizations.size() == 2);
+    REQUIRE_FALSE(validated.Localizations[1].IsDeferred());
+    REQUIRE(validated.Localizations[1].Get<Localization::PackageName>() == manifest.Localizations[1].Get<Localization::PackageName>());
+    REQUIRE(validated.Localizations[1].Contains(Localization::Publisher) == manifest.Localizations[1].Contains(Localization::Publisher));
+}
+
+TEST_CASE("ValidateManifest_InstallerUniquenessScopes", "[ManifestValidation]")
+{
+    auto hasDuplicateInstallerError = [](const std::vector<ScopeEnum>& scopes)
+    {
+        Manifest manifest;
+        manifest.Version = "1.0";
+
+        for (auto scope : scopes)
+        {
+            ManifestInstaller installer;
+            installer.InstallerType = InstallerTypeEnum::Msi;
+            installer.Arch = Architecture::X64;
+            installer.Scope = scope;
+            installer.Url = "https://example.com/installer.msi";
+            installer.Sha256 = SHA256::ConvertToBytes("65DB2F2AC2686C7F2FD69D4A4C6683B888DC55BFA20A0E32CA9F838B51689A3B");
+            manifest.Installers.emplace_back(std::move(installer));
+        }
+
+        auto errors = ValidateManifest(manifest);
+        return std::any_of(errors.begin(), errors.end(), [](const ValidationError& error) { return error.Message == ManifestError::DuplicateInstallerEntry; });
+    };
+
+    REQUIRE(!hasDuplicateInstallerError({ ScopeEnum::User, ScopeEnum::Machine }));
+    REQUIRE(hasDuplicateInstallerError({ ScopeEnum::User, ScopeEnum::User }));
+
+    // Unknown scope matches any other scope, in either order
+    REQUIRE(hasDuplicateInstallerError({ ScopeEnum::Unknown, ScopeEnum::Machine }));
+    REQUIRE(hasDuplicateInstallerError({ ScopeEnum::User, ScopeEnum::Machine, ScopeEnum::Unknown }));
+    REQUIRE(hasDuplicateInstallerError({ ScopeEnum::Unknown, ScopeEnum::Unknown }));
+}
@@ -4,6 +4,7 @@
 #include "Public/AppInstallerLogging.h"
 
 #include "Public/AppInstallerFileLogger.h"
+#include "Public/winget/BinaryTraceLogger.h"
 #include "Public/winget/TraceLogger.h"
 #include "Public/AppInstallerTelemetry.h"
 #include "Public/AppInstallerDateTime.h"
@@ -31,6 +32,170 @@ namespace AppInstaller::Logging
                 return (1ull << AsNum(channel));
             }
         }
+
+        // Reads a value of the given type from the encoded arguments, advancing past it.
+        template <typename T>
+        bool ReadArgumentValue(std::string_view& arguments, T& value)
+        {
+            if (arguments.size() < sizeof(T))
+            {
+                return false;
+            }
+
+            memcpy(&value, arguments.data(), sizeof(T));
+            arguments.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        // Appends the next encoded argument to the output as text.
+        bool AppendNextArgument(std::string_view& arguments, std::string& output)
+        {
+            uint8_t type = 0;
+            if (!ReadArgumentValue(arguments, type))
+            {
+                return false;
+            }
+
+            switch (static_cast<TraceEventArguments::Type>(type))
+            {
+            case TraceEventArguments::Type::Integer:
+            {
+                int64_t value = 0;
+                if (!ReadArgumentValue(arguments, value))
+                {
+                    return false;
+                }
+                output += std::to_string(value);
+                return true;
+            }
+            case TraceEventArguments::Type::Double:
+            {
+                double value = 0;
+                if (!ReadArgumentValue(arguments, value))
+                {
+                    return false;
+                }
+                std::ostringstream stream;
+                stream << value;
+                output += stream.str();
+                return true;
+            }
+            case TraceEventArguments::Type::Bool:
+            {
+                uint8_t value = 0;
+                if (!ReadArgumentValue(arguments, value))
+                {
+                    return false;
+                }
+                // Matches the default stream output of a bool.
+                output += (value ? '1' : '0');
+                return true;
+            }
+            case TraceEventArguments::Type::String:
+            {
+                uint32_t length = 0;
+                if (!ReadArgumentValue(arguments, length) || arguments.size() < length)
+                {
+                    return false;
+                }
+                output += arguments.substr(0, length);
+                arguments.remove_prefix(length);
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+    }
+
+    void TraceEventArguments::Add(bool value)
+    {
+        Type type = Type::Bool;
+        uint8_t encoded = (value ? 1 : 0);
+        Append(&type, sizeof(type));
+        Append(&encoded, sizeof(encoded));
+    }
+
+    void TraceEventArguments::Add(double value)
+    {
+        Type type = Type::Double;
+        Append(&type, sizeof(type));
+        Append(&value, sizeof(value));
+    }
+
+    void TraceEventArguments::Add(std::string_view value)
+    {
+        Type type = Type::String;
+        uint32_t length = static_cast<uint32_t>(std::min<size_t>(value.size(), std::numeric_limits<uint32_t>::max()));
+        Append(&type, sizeof(type));
+        Append(&length, sizeof(length));
+        Append(value.data(), length);
+    }
+
+    std::string_view TraceEventArguments::Get() const
+    {
+        if (m_overflow.empty())
+        {
+            return { m_inline, m_inlineSize };
+        }
+
+        return m_overflow;
+    }
+
+    void TraceEventArguments::AddInteger(int64_t value)
+    {
+        Type type = Type::Integer;
+        Append(&type, sizeof(type));
+        Append(&value, sizeof(value));
+    }
+
+    void TraceEventArguments::Append(const void* data, size_t size)
+    {
+        if (m_overflow.empty() && m_inlineSize + size <= sizeof(m_inline))
+        {
+            memcpy(m_inline + m_inlineSize, data, size);
+            m_inlineSize += size;
+        }
+        else
+        {
+            if (m_overflow.empty())
+            {
+                m_overflow.assign(m_inline, m_inlineSize);
+            }
+
+            m_overflow.append(static_cast<const char*>(data), size);
+        }
+    }
+
+    std::string FormatTraceEvent(const TraceEventDescriptor& descriptor, std::string_view arguments)
+    {
+        std::string result;
+        result.reserve(descriptor.Format.size() + arguments.size());
+
+        std::string_view format = descriptor.Format;
+
+        for (size_t placeholder = format.find("{}"); placeholder != std::string_view::npos; placeholder = format.find("{}"))
+        {
+            result += format.substr(0, placeholder);
+            format.remove_prefix(placeholder + 2);
+
+            if (!AppendNextArgument(arguments, result))
+            {
+                result += "{}";
+            }
+        }
+
+        result += format;
+        return result;
+    }
+
+    void ILogger::WriteEvent(Channel channel, Level level, const TraceEventDescriptor& descriptor, std::string_view arguments) noexcept try
+    {
+        Write(channel, level, FormatTraceEvent(descriptor, arguments));
+    }
+    catch (...)
+    {
+        // Just eat any exceptions here; better than losing logs
     }
 
     char const* GetChannelName(Channel channel)
@@ -92,24 +257,24 @@ namespace AppInstaller::Logging
 
     void DiagnosticLogger::EnableChannel(Channel channel)
     {
-        m_enabledChannels |= ConvertChannelToBitmask(channel);
+        m_enabledChannels.fetch_or(ConvertChannelToBitmask(channel), std::memory_order_relaxed);
     }
 
     void DiagnosticLogger::DisableChannel(Channel channel)
     {
-        m_enabledChannels &= ~ConvertChannelToBitmask(channel);
+        m_enabledChannels.fetch_and(~ConvertChannelToBitmask(channel), std::memory_order_relaxed);
     }
 
     void DiagnosticLogger::SetLevel(Level level)
     {
-        m_enabledLevel = level;
+        m_enabledLevel.store(level, std::memory_order_relaxed);
     }
 
     bool DiagnosticLogger::IsEnabled(Channel channel, Level level) const
     {
         return (!m_loggers.empty() &&
-                (m_enabledChannels & ConvertChannelToBitmask(channel)) != 0 &&
-                (AsNum(level) >= AsNum(m_enabledLevel)));
+                (m_enabledChannels.load(std::memory_order_relaxed) & ConvertChannelToBitmask(channel)) != 0 &&
+                (AsNum(level) >= AsNum(m_enabledLevel.load(std::memory_order_relaxed))));
     }
 
     void DiagnosticLogger::Write(Channel channel, Level level, std::string_view message)
@@ -125,6 +290,20 @@ namespace AppInstaller::Logging
         }
     }
 
+    void DiagnosticLogger::WriteEvent(Channel channel, Level level, const TraceEventDescriptor& descriptor, const TraceEventArguments& arguments)
+    {
+        THROW_HR_IF_MSG(E_INVALIDARG, channel == Channel::All, "Cannot write to all channels");
+
+        if (IsEnabled(channel, level))
+        {
+            std::string_view encoded = arguments.Get();
+            for (auto& logger : m_loggers)
+            {
+                logger->WriteEvent(channel, level, descriptor, encoded);
+            }
+        }
+    }
+
     void DiagnosticLogger::WriteDirect(Channel channel, Level level, std::string_view message)
     {
         THROW_HR_IF_MSG(E_INVALIDARG, channel == Channel::All, "Cannot write to all channels");
@@ -172,6 +351,11 @@ namespace AppInstaller::Logging
         Log().AddLogger(std::make_unique<TraceLogger>());
     }
 
+    void AddBinaryTraceLogger()
+    {
+        Log().AddLogger(std::make_unique<BinaryTraceLogger>());
+    }
+
     void BeginLogFileCleanup()
     {
         FileLogger::BeginCleanup(Runtime::GetPathTo(Runtime::PathName::DefaultLogLocation));
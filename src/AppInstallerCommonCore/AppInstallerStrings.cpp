@@ -92,6 +92,70 @@ namespace AppInstaller::Utility
             wil::unique_any<UBreakIterator*, decltype(ubrk_close), &ubrk_close> m_brk;
             int32_t m_currentBrk = 0;
         };
+
+        // Determines whether the input is entirely ASCII, checking a word at a time.
+        bool IsAscii(std::string_view input)
+        {
+            constexpr uint64_t s_HighBits = 0x8080808080808080;
+
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= input.length(); i += sizeof(uint64_t))
+            {
+                uint64_t word;
+                memcpy(&word, input.data() + i, sizeof(word));
+                if (word & s_HighBits)
+                {
+                    return false;
+                }
+            }
+
+            for (; i < input.length(); ++i)
+            {
+                if (static_cast<unsigned char>(input[i]) >= 0x80)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool IsAscii(std::wstring_view input)
+        {
+            static_assert(sizeof(wchar_t) == sizeof(uint16_t));
+            constexpr uint64_t s_NonAsciiBits = 0xFF80FF80FF80FF80;
+            constexpr size_t s_CharsPerWord = sizeof(uint64_t) / sizeof(wchar_t);
+
+            size_t i = 0;
+            for (; i + s_CharsPerWord <= input.length(); i += s_CharsPerWord)
+            {
+                uint64_t word;
+                memcpy(&word, input.data() + i, sizeof(word));
+                if (word & s_NonAsciiBits)
+                {
+                    return false;
+                }
+            }
+
+            return std::all_of(input.begin() + i, input.end(), [](wchar_t c) { return c < 0x80; });
+        }
+
+        // Copies ASCII from one character width to the other, which is all that converting it between encodings does.
+        template <typename Output, typename Input>
+        void CopyAscii(Input input, Output& output)
+        {
+            using OutputChar = typename Output::value_type;
+
+            output.resize(input.length());
+            std::transform(input.begin(), input.end(), output.begin(), [](auto c) { return static_cast<OutputChar>(c); });
+        }
+
+        // Determines whether every byte of the input is its own grapheme cluster that is one column wide.
+        // This is true of ASCII other than CR, which forms a single cluster with a following LF.
+        bool IsSingleColumnAscii(std::string_view input)
+        {
+            return IsAscii(input) && input.find('\r') == std::string_view::npos;
+        }
     }
 
     bool CaseInsensitiveEquals(std::string_view a, std::string_view b)
@@ -121,6 +185,13 @@ namespace AppInstaller::Utility
             return {};
         }
 
+        if (IsAscii(input))
+        {
+            std::string result;
+            CopyAscii(input, result);
+            return result;
+        }
+
         int utf8ByteCount = WideCharToMultiByte(CP_UTF8, 0, input.data(), wil::safe_cast<int>(input.length()), nullptr, 0, nullptr, nullptr);
         THROW_LAST_ERROR_IF(utf8ByteCount == 0);
 
@@ -134,6 +205,23 @@ namespace AppInstaller::Utility
         return result;
     }
 
+    void ConvertToUTF8(std::wstring_view input, std::string& output)
+    {
+        if (IsAscii(input))
+        {
+            CopyAscii(input, output);
+            return;
+        }
+
+        // A UTF16 code unit is at most 3 bytes of UTF8, so with room for that a single pass is enough.
+        output.resize(input.length() * 3);
+
+        int utf8BytesWritten = WideCharToMultiByte(CP_UTF8, 0, input.data(), wil::safe_cast<int>(input.length()), &output[0], wil::safe_cast<int>(output.size()), nullptr, nullptr);
+        THROW_LAST_ERROR_IF(utf8BytesWritten == 0);
+
+        output.resize(wil::safe_cast<size_t>(utf8BytesWritten));
+    }
+
     std::wstring ConvertToUTF16(std::string_view input, UINT codePage)
     {
         if (input.empty())
@@ -141,6 +229,13 @@ namespace AppInstaller::Utility
             return {};
         }
 
+        if (codePage == CP_UTF8 && IsAscii(input))
+        {
+            std::wstring result;
+            CopyAscii(input, result);
+            return result;
+        }
+
         int utf16CharCount = MultiByteToWideChar(codePage, 0, input.data(), wil::safe_cast<int>(input.length()), nullptr, 0);
         THROW_LAST_ERROR_IF(utf16CharCount == 0);
 
@@ -154,8 +249,30 @@ namespace AppInstaller::Utility
         return result;
     }
 
+    void ConvertToUTF16(std::string_view input, std::wstring& output, UINT codePage)
+    {
+        if (input.empty() || (codePage == CP_UTF8 && IsAscii(input)))
+        {
+            CopyAscii(input, output);
+            return;
+        }
+
+        // No code page produces more UTF16 code units than there are bytes, so with room for that a single pass is enough.
+        output.resize(input.length());
+
+        int utf16CharsWritten = MultiByteToWideChar(codePage, 0, input.data(), wil::safe_cast<int>(input.length()), &output[0], wil::safe_cast<int>(output.size()));
+        THROW_LAST_ERROR_IF(utf16CharsWritten == 0);
+
+        output.resize(wil::safe_cast<size_t>(utf16CharsWritten));
+    }
+
     size_t UTF8Length(std::string_view input)
     {
+        if (IsSingleColumnAscii(input))
+        {
+            return input.length();
+        }
+
         ICUBreakIterator itr{ input, UBRK_CHARACTER };
 
         size_t numGraphemeClusters = 0;
@@ -170,6 +287,11 @@ namespace AppInstaller::Utility
 
     size_t UTF8ColumnWidth(const NormalizedUTF8<NormalizationC>& input)
     {
+        if (IsSingleColumnAscii(input))
+        {
+            return input.length();
+        }
+
         ICUBreakIterator itr{ input, UBRK_CHARACTER };
 
         size_t columnWidth = 0;
@@ -189,6 +311,16 @@ namespace AppInstaller::Utility
 
     std::string_view UTF8Substring(std::string_view input, size_t offset, size_t count)
     {
+        if (IsSingleColumnAscii(input))
+        {
+            if (offset > input.length())
+            {
+                throw std::out_of_range("UTF8Substring: offset past end of input");
+            }
+
+            return input.substr(offset, count);
+        }
+
         ICUBreakIterator itr{ input, UBRK_CHARACTER };
 
         // Offset was past end, throw just like std::string::substr
@@ -215,6 +347,12 @@ namespace AppInstaller::Utility
 
     std::string UTF8TrimRightToColumnWidth(const NormalizedUTF8<NormalizationC>& input, size_t expectedWidth, size_t& actualWidth)
     {
+        if (IsSingleColumnAscii(input))
+        {
+            actualWidth = std::min(input.length(), expectedWidth);
+            return input.substr(0, actualWidth);
+        }
+
         ICUBreakIterator itr{ input, UBRK_CHARACTER };
 
         size_t columnWidth = 0;
@@ -249,9 +387,10 @@ namespace AppInstaller::Utility
 
     std::string Normalize(std::string_view input, NORM_FORM form)
     {
-        if (input.empty())
+        // ASCII is unchanged by every normalization form.
+        if (IsAscii(input))
         {
-            return {};
+            return std::string{ input };
         }
 
         return ConvertToUTF8(Normalize(ConvertToUTF16(input), form));
@@ -259,9 +398,10 @@ namespace AppInstaller::Utility
 
     std::wstring Normalize(std::wstring_view input, NORM_FORM form)
     {
-        if (input.empty())
+        // ASCII is unchanged by every normalization form.
+        if (IsAscii(input))
         {
-            return {};
+            return std::wstring{ input };
         }
 
         std::wstring result;
@@ -308,9 +448,18 @@ namespace AppInstaller::Utility
 
     std::string FoldCase(std::string_view input)
     {
-        if (input.empty())
+        // Default case folding only changes the upper case letters of ASCII.
+        if (IsAscii(input))
         {
-            return {};
+            std::string result{ input };
+            for (char& c : result)
+            {
+                if (c >= 'A' && c <= 'Z')
+                {
+                    c += ('a' - 'A');
+                }
+            }
+            return result;
         }
 
         wil::unique_any<UCaseMap*, decltype(ucasemap_close), &ucasemap_close> caseMap;
@@ -76,6 +76,9 @@ namespace AppInstaller::Logging
             }
         }
 
+        // How often the coalesced events are written while an operation continues.
+        constexpr auto s_TelemetryAggregationInterval = 30s;
+
         std::string_view LogExceptionTypeToString(FailureTypeEnum exceptionType)
         {
             switch (exceptionType)
@@ -95,15 +98,180 @@ namespace AppInstaller::Logging
         }
     }
 
+    namespace details
+    {
+        // Coalesces high frequency events and writes them as summaries from a background thread,
+        // so that the thread logging them only pays for finding and updating an entry.
+        // Everything still pending is written when the last logger that shares it is destroyed.
+        struct TelemetryEventAggregator
+        {
+            TelemetryEventAggregator(const GUID& activityId, const GUID& parentActivityId) :
+                m_activityId(activityId), m_parentActivityId(parentActivityId) {}
+
+            TelemetryEventAggregator(const TelemetryEventAggregator&) = delete;
+            TelemetryEventAggregator& operator=(const TelemetryEventAggregator&) = delete;
+
+            ~TelemetryEventAggregator()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    m_stopping = true;
+                }
+
+                if (m_writer.joinable())
+                {
+                    m_signal.notify_one();
+                    m_writer.join();
+                }
+
+                WriteSourceSearches(m_sourceSearches);
+            }
+
+            void AddSourceSearch(
+                const std::string& caller,
+                const std::wstring& correlationJson,
+                std::string_view sourceIdentifier,
+                std::string_view purpose,
+                uint64_t resultCount,
+                bool failed,
+                std::chrono::nanoseconds duration)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                EnsureWriter();
+
+                auto itr = std::find_if(m_sourceSearches.begin(), m_sourceSearches.end(),
+                    [&](const SourceSearchStats& stats) { return stats.SourceIdentifier == sourceIdentifier && stats.Purpose == purpose; });
+
+                if (itr == m_sourceSearches.end())
+                {
+                    SourceSearchStats& stats = m_sourceSearches.emplace_back();
+                    stats.Caller = caller;
+                    stats.CorrelationJson = correlationJson;
+                    stats.SourceIdentifier = sourceIdentifier;
+                    stats.Purpose = purpose;
+                    itr = m_sourceSearches.end() - 1;
+                }
+
+                itr->SearchCount += 1;
+                itr->FailureCount += (failed ? 1 : 0);
+                itr->ResultCount += resultCount;
+                itr->TotalDuration += duration;
+                itr->MaximumDuration = std::max(itr->MaximumDuration, duration);
+            }
+
+        private:
+            struct SourceSearchStats
+            {
+                std::string Caller;
+                std::wstring CorrelationJson;
+                std::string SourceIdentifier;
+                std::string Purpose;
+                UINT64 SearchCount = 0;
+                UINT64 FailureCount = 0;
+                UINT64 ResultCount = 0;
+                std::chrono::nanoseconds TotalDuration{};
+                std::chrono::nanoseconds MaximumDuration{};
+            };
+
+            // Must be called with the lock held.
+            void EnsureWriter()
+            {
+                if (!m_writer.joinable() && !m_writerFailed && !m_stopping)
+                {
+                    try
+                    {
+                        m_writer = std::thread(&TelemetryEventAggregator::WriterThread, this);
+                    }
+                    catch (...)
+                    {
+                        // Without a writer, everything is written when the aggregator is destroyed.
+                        m_writerFailed = true;
+                    }
+                }
+            }
+
+            void WriterThread() noexcept
+            {
+                std::vector<SourceSearchStats> sourceSearches;
+
+                for (;;)
+                {
+                    bool stopping = false;
+
+                    {
+                        std::unique_lock<std::mutex> lock{ m_lock };
+                        m_signal.wait_for(lock, s_TelemetryAggregationInterval, [this]() { return m_stopping; });
+
+                        // Anything left when stopping is written by the destructor.
+                        stopping = m_stopping;
+                        if (!stopping)
+                        {
+                            sourceSearches.swap(m_sourceSearches);
+                        }
+                    }
+
+                    if (stopping)
+                    {
+                        return;
+                    }
+
+                    WriteSourceSearches(sourceSearches);
+                    sourceSearches.clear();
+                }
+            }
+
+            void WriteSourceSearches(const std::vector<SourceSearchStats>& sourceSearches) const noexcept
+            {
+                for (const auto& stats : sourceSearches)
+                {
+                    TraceLoggingWriteActivity(
+                        g_hTraceProvider,
+                        "SourceSearchSummary",
+                        s_useGlobalTelemetryActivityId ? &s_globalTelemetryLoggerActivityId : &m_activityId,
+                        &m_parentActivityId,
+                        AICLI_TraceLoggingStringView(stats.Caller, "Caller"),
+                        TraceLoggingPackedFieldEx(stats.CorrelationJson.c_str(), static_cast<ULONG>((stats.CorrelationJson.size() + 1) * sizeof(wchar_t)), TlgInUNICODESTRING, TlgOutJSON, "CvJson"),
+                        AICLI_TraceLoggingStringView(stats.SourceIdentifier, "SourceIdentifier"),
+                        AICLI_TraceLoggingStringView(stats.Purpose, "Purpose"),
+                        TraceLoggingUInt64(stats.SearchCount, "SearchCount"),
+                        TraceLoggingUInt64(stats.FailureCount, "FailureCount"),
+                        TraceLoggingUInt64(stats.ResultCount, "ResultCount"),
+                        TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::microseconds>(stats.TotalDuration).count()), "TotalDurationMicroseconds"),
+                        TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::microseconds>(stats.MaximumDuration).count()), "MaximumDurationMicroseconds"),
+                        TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                        TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+                }
+            }
+
+            GUID m_activityId;
+            GUID m_parentActivityId;
+
+            std::mutex m_lock;
+            std::condition_variable m_signal;
+            std::vector<SourceSearchStats> m_sourceSearches;
+            bool m_stopping = false;
+            bool m_writerFailed = false;
+            std::thread m_writer;
+        };
+    }
+
     TelemetrySummary::TelemetrySummary(const TelemetrySummary& other)
     {
         this->IsCOMCall = other.IsCOMCall;
     }
 
-    TelemetryTraceLogger::TelemetryTraceLogger()
+    TelemetryTraceLogger::TelemetryTraceLogger() : TelemetryTraceLogger(true) {}
+
+    TelemetryTraceLogger::TelemetryTraceLogger(bool aggregateEvents)
     {
         std::ignore = CoCreateGuid(&m_activityId);
         m_subExecutionId = s_RootExecutionId;
+
+        if (aggregateEvents)
+        {
+            m_aggregator = std::make_shared<details::TelemetryEventAggregator>(m_activityId, m_parentActivityId);
+        }
     }
 
     const GUID* TelemetryTraceLogger::GetActivityId() const
@@ -189,8 +357,7 @@ namespace AppInstaller::Logging
 
     std::unique_ptr<TelemetryTraceLogger> TelemetryTraceLogger::CreateSubTraceLogger() const
     {
-        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !this->m_isInitialized);
-
+        // An uninitialized logger is copied as is, and the copy will initialize itself when needed.
         auto subTraceLogger = std::make_unique<TelemetryTraceLogger>(*this);
 
         subTraceLogger->m_parentActivityId = this->m_activityId;
@@ -515,6 +682,35 @@ namespace AppInstaller::Logging
         }
     }
 
+    void TelemetryTraceLogger::LogSourceSearch(std::string_view sourceIdentifier, std::string_view purpose, uint64_t resultCount, bool failed, std::chrono::nanoseconds duration) const noexcept try
+    {
+        if (IsTelemetryEnabled())
+        {
+            if (m_aggregator)
+            {
+                m_aggregator->AddSourceSearch(m_caller, m_telemetryCorrelationJsonW, sourceIdentifier, purpose, resultCount, failed, duration);
+            }
+            else
+            {
+                AICLI_TraceLoggingWriteActivity(
+                    "SourceSearchSummary",
+                    AICLI_TraceLoggingStringView(sourceIdentifier, "SourceIdentifier"),
+                    AICLI_TraceLoggingStringView(purpose, "Purpose"),
+                    TraceLoggingUInt64(1, "SearchCount"),
+                    TraceLoggingUInt64(failed ? 1 : 0, "FailureCount"),
+                    TraceLoggingUInt64(resultCount, "ResultCount"),
+                    TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()), "TotalDurationMicroseconds"),
+                    TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()), "MaximumDurationMicroseconds"),
+                    TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                    TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+            }
+        }
+    }
+    catch (...)
+    {
+        // Telemetry is best effort.
+    }
+
     void TelemetryTraceLogger::LogInstallerHashMismatch(
         std::string_view id,
         std::string_view version,
@@ -763,10 +959,32 @@ namespace AppInstaller::Logging
 
     bool TelemetryTraceLogger::IsTelemetryEnabled() const noexcept
     {
-        return g_IsTelemetryProviderEnabled && m_isInitialized && m_isSettingEnabled && m_isRuntimeEnabled;
+        if (!g_IsTelemetryProviderEnabled || !m_isRuntimeEnabled)
+        {
+            return false;
+        }
+
+        if (!m_isInitialized)
+        {
+            try
+            {
+                // Nothing is logged while the settings are themselves being loaded.
+                auto userSettings = Settings::TryGetUser();
+                if (userSettings)
+                {
+                    InitializeInternal(*userSettings);
+                }
+            }
+            catch (...)
+            {
+                // Reporting the failure would come back here; telemetry is best effort, so just leave it uninitialized.
+            }
+        }
+
+        return m_isInitialized && m_isSettingEnabled;
     }
 
-    void TelemetryTraceLogger::InitializeInternal(const AppInstaller::Settings::UserSettings& userSettings)
+    void TelemetryTraceLogger::InitializeInternal(const AppInstaller::Settings::UserSettings& userSettings) const
     {
         m_isSettingEnabled = !userSettings.Get<Settings::Setting::TelemetryDisable>();
         m_userProfile = Runtime::GetPathTo(Runtime::PathName::UserProfile).wstring();
@@ -803,7 +1021,8 @@ namespace AppInstaller::Logging
         }
         else
         {
-            static TelemetryTraceLogger processGlobalTelemetry;
+            // This may be destroyed while the loader lock is held, so it cannot wait for an aggregation thread.
+            static TelemetryTraceLogger processGlobalTelemetry{ false };
             processGlobalTelemetry.TryInitialize();
             return processGlobalTelemetry;
         }
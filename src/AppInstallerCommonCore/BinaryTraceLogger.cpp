@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/BinaryTraceLogger.h"
+
+#include "Public/AppInstallerFileLogger.h"
+#include "Public/AppInstallerRuntime.h"
+#include "Public/AppInstallerDateTime.h"
+
+
+namespace AppInstaller::Logging
+{
+    using namespace std::string_literals;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_binaryTraceLoggerDefaultFileExt = ".wgtrace"sv;
+    static constexpr std::string_view s_binaryTraceLoggerMagic = "WGTRACE\0"sv;
+    static constexpr uint32_t s_binaryTraceLoggerVersion = 1;
+
+    // Offsets of the file header fields.
+    static constexpr size_t s_binaryTraceLoggerHeader_Magic = 0;
+    static constexpr size_t s_binaryTraceLoggerHeader_Version = 8;
+    static constexpr size_t s_binaryTraceLoggerHeader_HeaderSize = 12;
+    static constexpr size_t s_binaryTraceLoggerHeader_Capacity = 16;
+    static constexpr size_t s_binaryTraceLoggerHeader_NextOffset = 24;
+    static constexpr size_t s_binaryTraceLoggerHeader_DroppedRecords = 32;
+    static constexpr size_t s_binaryTraceLoggerHeaderSize = 64;
+
+    // Offsets of the record header fields.
+    static constexpr size_t s_binaryTraceLoggerRecord_Size = 0;
+    static constexpr size_t s_binaryTraceLoggerRecord_Type = 4;
+    static constexpr size_t s_binaryTraceLoggerRecord_Channel = 5;
+    static constexpr size_t s_binaryTraceLoggerRecord_Level = 6;
+    static constexpr size_t s_binaryTraceLoggerRecord_ThreadId = 8;
+    static constexpr size_t s_binaryTraceLoggerRecord_Timestamp = 12;
+    static constexpr size_t s_binaryTraceLoggerRecordHeaderSize = 20;
+
+    // Records are padded to keep the size field of each one aligned; text payloads are trimmed of the padding when read.
+    static constexpr size_t s_binaryTraceLoggerRecordAlignment = 8;
+
+    namespace
+    {
+        template <typename T>
+        void WriteValue(uint8_t* destination, T value)
+        {
+            memcpy(destination, &value, sizeof(T));
+        }
+
+        volatile LONG64* GetHeaderField(uint8_t* view, size_t offset)
+        {
+            return reinterpret_cast<volatile LONG64*>(view + offset);
+        }
+    }
+
+    BinaryTraceLogger::BinaryTraceLogger()
+    {
+        m_filePath = Runtime::GetPathTo(Runtime::PathName::DefaultLogLocation);
+        m_filePath /= FileLogger::DefaultPrefix().data() + ('-' + Utility::GetCurrentTimeForFilename() + s_binaryTraceLoggerDefaultFileExt.data());
+        m_name = "binarytrace :: "s + m_filePath.u8string();
+
+        Open(DefaultCapacity);
+    }
+
+    BinaryTraceLogger::BinaryTraceLogger(const std::filesystem::path& filePath, size_t capacity)
+    {
+        m_filePath = filePath;
+        m_name = "binarytrace :: "s + m_filePath.u8string();
+
+        Open(capacity);
+    }
+
+    BinaryTraceLogger::~BinaryTraceLogger()
+    {
+        if (!m_view)
+        {
+            return;
+        }
+
+        LONG64 used = std::min<LONG64>(*GetHeaderField(m_view.get(), s_binaryTraceLoggerHeader_NextOffset), static_cast<LONG64>(m_capacity));
+
+        m_view.reset();
+        m_mapping.reset();
+
+        // Release the unused part of the file.
+        LARGE_INTEGER end{};
+        end.QuadPart = used;
+        if (SetFilePointerEx(m_file.get(), end, nullptr, FILE_BEGIN))
+        {
+            LOG_IF_WIN32_BOOL_FALSE(SetEndOfFile(m_file.get()));
+        }
+    }
+
+    std::string_view BinaryTraceLogger::DefaultExt()
+    {
+        return s_binaryTraceLoggerDefaultFileExt;
+    }
+
+    std::string BinaryTraceLogger::GetName() const
+    {
+        return m_name;
+    }
+
+    void BinaryTraceLogger::Write(Channel channel, Level level, std::string_view message) noexcept
+    {
+        WriteRecord(RecordType::Message, channel, level, message);
+    }
+
+    void BinaryTraceLogger::WriteDirect(std::string_view message) noexcept
+    {
+        // Direct writes have no channel, and are decoded without the usual prefix.
+        WriteRecord(RecordType::Message, Channel::All, Level::Info, message);
+    }
+
+    void BinaryTraceLogger::WriteEvent(Channel channel, Level level, const TraceEventDescriptor& descriptor, std::string_view arguments) noexcept
+    {
+        if (descriptor.Id >= m_definitionsWritten.size())
+        {
+            ILogger::WriteEvent(channel, level, descriptor, arguments);
+            return;
+        }
+
+        std::string_view id{ reinterpret_cast<const char*>(&descriptor.Id), sizeof(descriptor.Id) };
+
+        if (!m_definitionsWritten[descriptor.Id].exchange(true))
+        {
+            WriteRecord(RecordType::EventDefinition, channel, level, id, descriptor.Format);
+        }
+
+        WriteRecord(RecordType::Event, channel, level, id, arguments);
+    }
+
+    void BinaryTraceLogger::Open(size_t capacity)
+    {
+        THROW_HR_IF(E_INVALIDARG, capacity <= s_binaryTraceLoggerHeaderSize);
+        m_capacity = capacity;
+
+        m_file.reset(CreateFileW(m_filePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+        THROW_LAST_ERROR_IF(!m_file);
+
+        ULARGE_INTEGER size{};
+        size.QuadPart = capacity;
+        m_mapping.reset(CreateFileMappingW(m_file.get(), nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr));
+        THROW_LAST_ERROR_IF_NULL(m_mapping);
+
+        m_view.reset(static_cast<uint8_t*>(MapViewOfFile(m_mapping.get(), FILE_MAP_WRITE, 0, 0, capacity)));
+        THROW_LAST_ERROR_IF_NULL(m_view);
+
+        uint8_t* view = m_view.get();
+        memcpy(view + s_binaryTraceLoggerHeader_Magic, s_binaryTraceLoggerMagic.data(), s_binaryTraceLoggerMagic.size());
+        WriteValue(view + s_binaryTraceLoggerHeader_Version, s_binaryTraceLoggerVersion);
+        WriteValue(view + s_binaryTraceLoggerHeader_HeaderSize, static_cast<uint32_t>(s_binaryTraceLoggerHeaderSize));
+        WriteValue(view + s_binaryTraceLoggerHeader_Capacity, static_cast<uint64_t>(capacity));
+        WriteValue(view + s_binaryTraceLoggerHeader_NextOffset, static_cast<uint64_t>(s_binaryTraceLoggerHeaderSize));
+        WriteValue(view + s_binaryTraceLoggerHeader_DroppedRecords, static_cast<uint64_t>(0));
+    }
+
+    void BinaryTraceLogger::WriteRecord(RecordType type, Channel channel, Level level, std::string_view first, std::string_view second) noexcept
+    {
+        uint8_t* view = m_view.get();
+
+        size_t size = s_binaryTraceLoggerRecordHeaderSize + first.size() + second.size();
+        size = (size + s_binaryTraceLoggerRecordAlignment - 1) & ~(s_binaryTraceLoggerRecordAlignment - 1);
+
+        if (size > std::numeric_limits<uint32_t>::max())
+        {
+            InterlockedIncrement64(GetHeaderField(view, s_binaryTraceLoggerHeader_DroppedRecords));
+            return;
+        }
+
+        // Reserving the space is the only synchronization needed, as each writer then owns its part of the file.
+        LONG64 offset = InterlockedExchangeAdd64(GetHeaderField(view, s_binaryTraceLoggerHeader_NextOffset), static_cast<LONG64>(size));
+
+        if (static_cast<size_t>(offset) + size > m_capacity)
+        {
+            InterlockedIncrement64(GetHeaderField(view, s_binaryTraceLoggerHeader_DroppedRecords));
+            return;
+        }
+
+        uint8_t* record = view + offset;
+        auto timestamp = std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>>(std::chrono::system_clock::now().time_since_epoch());
+
+        WriteValue(record + s_binaryTraceLoggerRecord_Type, static_cast<uint8_t>(type));
+        WriteValue(record + s_binaryTraceLoggerRecord_Channel, static_cast<uint8_t>(channel));
+        WriteValue(record + s_binaryTraceLoggerRecord_Level, static_cast<uint8_t>(level));
+        WriteValue(record + s_binaryTraceLoggerRecord_ThreadId, static_cast<uint32_t>(GetCurrentThreadId()));
+        WriteValue(record + s_binaryTraceLoggerRecord_Timestamp, timestamp.count());
+
+        memcpy(record + s_binaryTraceLoggerRecordHeaderSize, first.data(), first.size());
+        memcpy(record + s_binaryTraceLoggerRecordHeaderSize + first.size(), second.data(), second.size());
+
+        // The size is written last, so that a reader never sees a partially written record.
+        InterlockedExchange(reinterpret_cast<volatile LONG*>(record + s_binaryTraceLoggerRecord_Size), static_cast<LONG>(size));
+    }
+}
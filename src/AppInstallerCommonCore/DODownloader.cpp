@@ -336,6 +336,68 @@ namespace AppInstaller::Utility
             std::condition_variable m_statusCV;
             DO_DOWNLOAD_STATUS m_currentStatus = {};
         };
+
+        // Runs the download, after setting its destination with the given function.
+        // Returns true for success and false for cancellation, and throws on error.
+        bool RunDownload(
+            const std::string& url,
+            IProgressCallback& progress,
+            const std::optional<DownloadInfo>& info,
+            const std::function<void(DeliveryOptimization::Download&)>& setDestination)
+        {
+            Manager manager;
+            DeliveryOptimization::Download download = manager.CreateDownload();
+
+            wil::com_ptr<DODownloadStatusCallback> callback;
+            THROW_IF_FAILED(DODownloadStatusCallback::Create(progress, &callback));
+
+            download.Uri(url);
+            download.ForegroundPriority((!info || !info->BackgroundPriority) &&
+                Settings::User().Get<Settings::Setting::NetworkDOPriority>() == Settings::DOPriority::Foreground);
+            setDestination(download);
+            download.CallbackInterface(callback.get());
+
+            if (info)
+            {
+                if (!info->DisplayName.empty())
+                {
+                    download.DisplayName(info->DisplayName);
+                }
+
+                if (!info->ContentId.empty())
+                {
+                    download.ContentId(info->ContentId);
+                }
+            }
+
+            download.Start();
+
+            auto cancelLifetime = progress.SetCancellationFunction([&download, &callback]()
+                {
+                    AICLI_LOG(Core, Info, << "Download cancelled.");
+                    download.Cancel();
+                    callback->Cancel();
+                });
+
+            // Check to handle cancellation between Start and SetCancellationFunction
+            if (progress.IsCancelled())
+            {
+                AICLI_LOG(Core, Info, << "Download cancelled.");
+                download.Cancel();
+                return false;
+            }
+
+            // Wait returns true for success, false for cancellation, and throws on error.
+            if (callback->Wait())
+            {
+                // Finalize is required to flush the data and change the file name.
+                download.Finalize();
+                AICLI_LOG(Core, Info, << "Download completed.");
+                return true;
+            }
+
+            return false;
+        }
     }
 
     // Debugging tip:
@@ -353,59 +415,72 @@ namespace AppInstaller::Utility
         // Remove the target file since DO will not overwrite
         std::filesystem::remove(dest);
 
-        DeliveryOptimization::Manager manager;
-        DeliveryOptimization::Download download = manager.CreateDownload();
-
-        wil::com_ptr<DeliveryOptimization::DODownloadStatusCallback> callback;
-        THROW_IF_FAILED(DeliveryOptimization::DODownloadStatusCallback::Create(progress, &callback));
-
-        download.Uri(url);
-        download.ForegroundPriority(true);
-        download.LocalPath(dest);
-        download.CallbackInterface(callback.get());
-
-        if (info)
-        {
-            if (!info->DisplayName.empty())
+        bool completed = DeliveryOptimization::RunDownload(url, progress, info, [&](DeliveryOptimization::Download& download)
             {
-                download.DisplayName(info->DisplayName);
-            }
+                download.LocalPath(dest);
+            });
 
-            if (!info->ContentId.empty())
-            {
-                download.ContentId(info->ContentId);
-            }
+        if (completed && computeHash)
+        {
+            return SHA256::ComputeHashFromFile(dest);
         }
 
-        download.Start();
+        return {};
+    }
 
-        auto cancelLifetime = progress.SetCancellationFunction([&download, &callback]()
+    std::optional<std::vector<BYTE>> DODownloadToStream(
+        const std::string& url,
+        std::ostream& dest,
+        IProgressCallback& progress,
+        bool computeHash,
+        std::optional<DownloadInfo> info)
+    {
+        AICLI_LOG(Core, Info, << "DeliveryOptimization downloading to stream from url: " << url);
+
+        // DO writes to the memory stream, which is only copied to the destination once the download has succeeded.
+        // This leaves the destination untouched if the caller falls back to another downloader.
+        wil::com_ptr<IStream> stream;
+        stream.attach(SHCreateMemStream(nullptr, 0));
+        THROW_IF_NULL_ALLOC(stream);
+
+        bool completed = DeliveryOptimization::RunDownload(url, progress, info, [&](DeliveryOptimization::Download& download)
             {
-                AICLI_LOG(Core, Info, << "Download cancelled.");
-                download.Cancel();
-                callback->Cancel();
+                download.StreamInterface(stream.get());
             });
 
-        // Check to handle cancellation between Start and SetCancellationFunction
-        if (progress.IsCancelled())
+        if (!completed)
         {
-            AICLI_LOG(Core, Info, << "Download cancelled.");
-            download.Cancel();
             return {};
         }
 
-        // Wait returns true for success, false for cancellation, and throws on error.
-        if (callback->Wait())
+        LARGE_INTEGER start{};
+        THROW_IF_FAILED(stream->Seek(start, STREAM_SEEK_SET, nullptr));
+
+        SHA256 hasher;
+        std::vector<BYTE> buffer(64 * 1024);
+
+        for (;;)
         {
-            // Finalize is required to flush the data and change the file name.
-            download.Finalize();
-            AICLI_LOG(Core, Info, << "Download completed.");
+            ULONG bytesRead = 0;
+            THROW_IF_FAILED(stream->Read(buffer.data(), static_cast<ULONG>(buffer.size()), &bytesRead));
+            if (bytesRead == 0)
+            {
+                break;
+            }
 
             if (computeHash)
             {
-                std::ifstream inStream{ dest, std::ifstream::binary };
-                return SHA256::ComputeHash(inStream);
+                hasher.Add(buffer.data(), bytesRead);
             }
+
+            dest.write(reinterpret_cast<const char*>(buffer.data()), bytesRead);
+        }
+
+        dest.flush();
+
+        if (computeHash)
+        {
+            return hasher.Get();
         }
 
         return {};
@@ -22,6 +22,14 @@ namespace AppInstaller::Utility
         bool computeHash,
         std::optional<DownloadInfo> info);
 
+    // Downloads the url into the given stream, which is only written to once the download has succeeded.
+    std::optional<std::vector<BYTE>> DODownloadToStream(
+        const std::string& url,
+        std::ostream& dest,
+        IProgressCallback& progress,
+        bool computeHash,
+        std::optional<DownloadInfo> info);
+
     // Returns true if the error from DODownload should be treated as fatal;
     // false if we should be able to fall back to other download methods.
     bool IsDOErrorFatal(HRESULT error);
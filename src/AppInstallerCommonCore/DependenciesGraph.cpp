@@ -26,6 +26,11 @@ namespace AppInstaller::Manifest
         m_toCheck = std::vector<Dependency>();
     }
 
+    void DependencyGraph::SetPrefetchFunction(std::function<void(const std::vector<Dependency>&)> prefetchFunction)
+    {
+        m_prefetch = std::move(prefetchFunction);
+    }
+
     void DependencyGraph::BuildGraph()
     {
         if (!m_rootDependencyEvaluated) 
@@ -45,21 +50,34 @@ namespace AppInstaller::Manifest
             return;
         }
 
-        for (unsigned int i = 0; i < m_toCheck.size(); ++i)
+        // Nodes are evaluated a frontier at a time; the nodes found while evaluating one frontier form the next.
+        for (size_t frontierStart = 0; frontierStart < m_toCheck.size();)
         {
-            auto node = m_toCheck.at(i);
+            size_t frontierEnd = m_toCheck.size();
 
-            const auto& nodeDependencies = getDependencies(node);
-            nodeDependencies.ApplyToType(DependencyType::Package, [&](Dependency dependency)
-                {
-                    if (!HasNode(dependency))
+            if (m_prefetch)
+            {
+                m_prefetch(std::vector<Dependency>(m_toCheck.begin() + frontierStart, m_toCheck.begin() + frontierEnd));
+            }
+
+            for (size_t i = frontierStart; i < frontierEnd; ++i)
+            {
+                auto node = m_toCheck.at(i);
+
+                const auto& nodeDependencies = getDependencies(node);
+                nodeDependencies.ApplyToType(DependencyType::Package, [&](Dependency dependency)
                     {
-                        m_toCheck.push_back(dependency);
-                        AddNode(dependency);
-                    }
+                        if (!HasNode(dependency))
+                        {
+                            m_toCheck.push_back(dependency);
+                            AddNode(dependency);
+                        }
+
+                        AddAdjacent(node, dependency);
+                    });
+            }
 
-                    AddAdjacent(node, dependency);
-                });
+            frontierStart = frontierEnd;
         }
 
         CheckForLoopsAndGetOrder();
@@ -88,47 +106,104 @@ namespace AppInstaller::Manifest
 
     void DependencyGraph::CheckForLoopsAndGetOrder()
     {
-        m_installationOrder = std::vector<Dependency>();
-        std::set<Dependency> visited;
-        m_HasLoop = HasLoopDFS(visited, m_root);
-    }
+        m_installationOrder.clear();
+        m_loop.clear();
+        m_HasLoop = false;
 
-    std::vector<Dependency> DependencyGraph::GetInstallationOrder()
-    {
-        return m_installationOrder;
-    }
+        // Give each node a dense index, so that the traversal only needs flat arrays.
+        std::vector<const Dependency*> nodes;
+        std::unordered_map<const Dependency*, size_t> indexes;
+        nodes.reserve(m_adjacents.size());
+        indexes.reserve(m_adjacents.size());
 
-    // TODO make this function iterative
-    bool DependencyGraph::HasLoopDFS(std::set<Dependency> visited, const Dependency& node)
-    {
-        bool loop = false;
+        for (const auto& entry : m_adjacents)
+        {
+            indexes.emplace(&entry.first, nodes.size());
+            nodes.push_back(&entry.first);
+        }
+
+        auto getIndex = [&](const Dependency& node)
+        {
+            auto itr = m_adjacents.find(node);
+            THROW_HR_IF(E_UNEXPECTED, itr == m_adjacents.end());
+            return indexes.at(&itr->first);
+        };
+
+        std::vector<std::vector<size_t>> adjacency(nodes.size());
+        for (const auto& entry : m_adjacents)
+        {
+            auto& edges = adjacency[indexes.at(&entry.first)];
+            edges.reserve(entry.second.size());
 
-        visited.insert(node);
-        auto lAdjacents = m_adjacents.at(node);
-        for (const auto& adjacent : m_adjacents.at(node))
+            for (const auto& adjacent : entry.second)
+            {
+                edges.push_back(getIndex(adjacent));
+            }
+        }
+
+        // A depth first search, where a node is added to the order once all of its dependencies have been.
+        // An edge to a node that is still on the path is a loop; the search continues past it so that there is a complete order even then.
+        enum class State : uint8_t
+        {
+            NotVisited,
+            OnPath,
+            Done,
+        };
+
+        std::vector<State> states(nodes.size(), State::NotVisited);
+
+        // The path from the root, with the index of the next edge to follow from each node.
+        std::vector<std::pair<size_t, size_t>> path;
+
+        size_t rootIndex = getIndex(m_root);
+        states[rootIndex] = State::OnPath;
+        path.emplace_back(rootIndex, 0);
+
+        while (!path.empty())
         {
-            auto search = visited.find(adjacent);
-            if (search == visited.end()) // if not found
+            size_t node = path.back().first;
+            size_t& nextEdge = path.back().second;
+
+            if (nextEdge < adjacency[node].size())
             {
-                if (HasLoopDFS(visited, adjacent))
+                size_t adjacent = adjacency[node][nextEdge++];
+
+                if (states[adjacent] == State::NotVisited)
+                {
+                    states[adjacent] = State::OnPath;
+                    path.emplace_back(adjacent, 0);
+                }
+                else if (states[adjacent] == State::OnPath)
                 {
-                    loop = true;
-                    // didn't break the loop to have a complete order at the end (even if a loop exists)
+                    if (!m_HasLoop)
+                    {
+                        auto loopStart = std::find_if(path.begin(), path.end(), [&](const auto& entry) { return entry.first == adjacent; });
+                        for (auto itr = loopStart; itr != path.end(); ++itr)
+                        {
+                            m_loop.push_back(*nodes[itr->first]);
+                        }
+                        m_loop.push_back(*nodes[adjacent]);
+                    }
+
+                    m_HasLoop = true;
                 }
             }
             else
             {
-                loop = true;
-                // didn't break the loop to have a complete order at the end (even if a loop exists)
+                states[node] = State::Done;
+                m_installationOrder.push_back(*nodes[node]);
+                path.pop_back();
             }
         }
+    }
 
-        // Adding to have an order even if a loop is present
-        if (std::find(m_installationOrder.begin(), m_installationOrder.end(), node) == m_installationOrder.end())
-        {
-            m_installationOrder.push_back(node);
-        }
+    std::vector<Dependency> DependencyGraph::GetInstallationOrder()
+    {
+        return m_installationOrder;
+    }
 
-        return loop;
+    std::vector<Dependency> DependencyGraph::GetLoop()
+    {
+        return m_loop;
     }
 }
\ No newline at end of file
@@ -109,13 +109,13 @@ namespace AppInstaller::Deployment
     bool AddPackageWithDeferredFallback(
         const std::string& uri,
         bool skipSmartScreen,
-        IProgressCallback& callback)
+        IProgressCallback& callback,
+        const std::optional<std::string>& knownPackageFullName)
     {
         PackageManager packageManager;
 
         // In the event of a failure we want to ensure that the package is not left on the system.
-        Msix::MsixInfo packageInfo{ uri };
-        std::wstring packageFullName = packageInfo.GetPackageFullNameWide();
+        std::wstring packageFullName = knownPackageFullName ? Utility::ConvertToUTF16(knownPackageFullName.value()) : Msix::MsixInfo{ uri }.GetPackageFullNameWide();
         auto removePackage = wil::scope_exit([&]() {
             try
             {
@@ -160,36 +160,54 @@ namespace AppInstaller::Deployment
         }
 
         // If we are skipping SmartScreen or the package was in use, stage then register the package.
-        {
-            size_t id = GetDeploymentOperationId();
-            AICLI_LOG(Core, Info, << "Starting StagePackageAsync operation #" << id << ": " << uri);
+        StagePackage(uri, callback);
+        bool registrationDeferred = RegisterStagedPackage(Utility::ConvertToUTF8(packageFullName), callback);
 
-            IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> stageOperation = packageManager.StagePackageAsync(uriObject, nullptr);
-            WaitForDeployment(stageOperation, id, callback);
-        }
+        removePackage.release();
+        return registrationDeferred;
+    }
+
+    void StagePackage(
+        const std::string& uri,
+        IProgressCallback& callback)
+    {
+        size_t id = GetDeploymentOperationId();
+        AICLI_LOG(Core, Info, << "Starting StagePackageAsync operation #" << id << ": " << uri);
 
-        bool registrationDeferred = false;
+        PackageManager packageManager;
+        IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> stageOperation = packageManager.StagePackageAsync(Uri{ Utility::ConvertToUTF16(uri) }, nullptr);
+        WaitForDeployment(stageOperation, id, callback);
+    }
 
-        {
-            size_t id = GetDeploymentOperationId();
-            AICLI_LOG(Core, Info, << "Starting RegisterPackageByFullNameAsync operation #" << id << ": " << Utility::ConvertToUTF8(packageFullName));
+    bool RegisterStagedPackage(
+        std::string_view packageFullName,
+        IProgressCallback& callback)
+    {
+        size_t id = GetDeploymentOperationId();
+        AICLI_LOG(Core, Info, << "Starting RegisterPackageByFullNameAsync operation #" << id << ": " << packageFullName);
 
-            IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> registerOperation =
-                packageManager.RegisterPackageByFullNameAsync(packageFullName, nullptr, DeploymentOptions::None);
-            HRESULT hr = WaitForDeployment(registerOperation, id, callback, false);
+        PackageManager packageManager;
+        winrt::hstring fullName = Utility::ConvertToUTF16(packageFullName).c_str();
+        IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> registerOperation =
+            packageManager.RegisterPackageByFullNameAsync(fullName, nullptr, DeploymentOptions::None);
+        HRESULT hr = WaitForDeployment(registerOperation, id, callback, false);
 
-            if (hr == HRESULT_FROM_WIN32(ERROR_PACKAGES_IN_USE))
-            {
-                registrationDeferred = true;
-            }
-            else
-            {
-                THROW_IF_FAILED(hr);
-            }
+        if (hr == HRESULT_FROM_WIN32(ERROR_PACKAGES_IN_USE))
+        {
+            return true;
         }
 
-        removePackage.release();
-        return registrationDeferred;
+        THROW_IF_FAILED(hr);
+        return false;
+    }
+
+    bool IsPackageInstalled(std::string_view packageFullName)
+    {
+        PackageManager packageManager;
+        winrt::hstring fullName = Utility::ConvertToUTF16(packageFullName).c_str();
+
+        // An empty user security id is the current user
+        return static_cast<bool>(packageManager.FindPackageForUser({}, fullName));
     }
 
     void RemovePackage(
@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/DownloadScheduler.h"
+#include "Public/winget/UserSettings.h"
+#include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerStrings.h"
+
+#include <array>
+
+
+namespace AppInstaller::Utility
+{
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        // How often a waiting download checks for cancellation.
+        constexpr auto s_cancellationCheckInterval = 100ms;
+
+        // After a pause this long, the pacing starts over, so that idle time is not saved up for a burst over the limit.
+        constexpr auto s_pacingIdleReset = 1s;
+
+        constexpr size_t s_priorityCount = static_cast<size_t>(DownloadPriority::Installer) + 1;
+
+        struct HostState
+        {
+            uint32_t Active = 0;
+            std::array<size_t, s_priorityCount> Waiting{};
+
+            bool HasWaitingAbove(DownloadPriority priority) const
+            {
+                for (size_t i = static_cast<size_t>(priority) + 1; i < s_priorityCount; ++i)
+                {
+                    if (Waiting[i])
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            bool IsUnused() const
+            {
+                return Active == 0 && std::all_of(Waiting.begin(), Waiting.end(), [](size_t count) { return count == 0; });
+            }
+        };
+
+        struct Scheduler
+        {
+            std::mutex Lock;
+            std::condition_variable Changed;
+            std::map<std::string, HostState> Hosts;
+        };
+
+        Scheduler& GetScheduler()
+        {
+            static Scheduler s_scheduler;
+            return s_scheduler;
+        }
+
+        struct Pacer
+        {
+            std::mutex Lock;
+            std::chrono::steady_clock::time_point WindowStart;
+            std::chrono::steady_clock::time_point WindowEnd;
+            uint64_t WindowBytes = 0;
+        };
+
+        Pacer& GetPacer()
+        {
+            static Pacer s_pacer;
+            return s_pacer;
+        }
+
+        // Gets the lowercased host, and port if any, of the url; empty if it has none.
+        std::string GetHost(std::string_view url)
+        {
+            size_t schemeEnd = url.find("://");
+            if (schemeEnd == std::string_view::npos)
+            {
+                return {};
+            }
+
+            std::string_view authority = url.substr(schemeEnd + 3);
+            authority = authority.substr(0, authority.find_first_of("/?#"));
+
+            // Drop any user info
+            size_t userInfoEnd = authority.rfind('@');
+            if (userInfoEnd != std::string_view::npos)
+            {
+                authority = authority.substr(userInfoEnd + 1);
+            }
+
+            return ToLower(authority);
+        }
+    }
+
+    DownloadPriority GetDownloadPriority(DownloadType type, bool backgroundPriority)
+    {
+        switch (type)
+        {
+        case DownloadType::Installer:
+            return backgroundPriority ? DownloadPriority::Index : DownloadPriority::Installer;
+        case DownloadType::Manifest:
+            return DownloadPriority::Manifest;
+        default:
+            return DownloadPriority::Index;
+        }
+    }
+
+    uint32_t GetMaximumConnectionsPerHost()
+    {
+        return Settings::User().Get<Settings::Setting::NetworkMaxConnectionsPerHost>();
+    }
+
+    DownloadSlot::DownloadSlot(std::string_view url, DownloadPriority priority, IProgressCallback& progress) :
+        m_host(GetHost(url))
+    {
+        if (m_host.empty())
+        {
+            m_acquired = true;
+            return;
+        }
+
+        uint32_t maximum = GetMaximumConnectionsPerHost();
+        size_t priorityIndex = static_cast<size_t>(priority);
+
+        Scheduler& scheduler = GetScheduler();
+        std::unique_lock<std::mutex> lock{ scheduler.Lock };
+
+        HostState& host = scheduler.Hosts[m_host];
+        ++host.Waiting[priorityIndex];
+
+        bool waited = false;
+        while (host.Active >= maximum || host.HasWaitingAbove(priority))
+        {
+            if (progress.IsCancelled())
+            {
+                --host.Waiting[priorityIndex];
+                if (host.IsUnused())
+                {
+                    scheduler.Hosts.erase(m_host);
+                }
+
+                // Another waiter may have been held back by this one
+                scheduler.Changed.notify_all();
+                return;
+            }
+
+            if (!waited)
+            {
+                AICLI_LOG(Core, Verbose, << "Waiting for a connection to " << m_host << "; " << host.Active << " in use");
+                waited = true;
+            }
+
+            scheduler.Changed.wait_for(lock, s_cancellationCheckInterval);
+        }
+
+        --host.Waiting[priorityIndex];
+        ++host.Active;
+        m_acquired = true;
+    }
+
+    DownloadSlot::~DownloadSlot()
+    {
+        if (!m_acquired || m_host.empty())
+        {
+            return;
+        }
+
+        Scheduler& scheduler = GetScheduler();
+        {
+            std::lock_guard<std::mutex> lock{ scheduler.Lock };
+
+            auto itr = scheduler.Hosts.find(m_host);
+            if (itr != scheduler.Hosts.end())
+            {
+                HostState& host = itr->second;
+                --host.Active;
+                if (host.IsUnused())
+                {
+                    scheduler.Hosts.erase(itr);
+                }
+            }
+        }
+
+        scheduler.Changed.notify_all();
+    }
+
+    void PaceDownloadedBytes(uint64_t bytes)
+    {
+        uint32_t limitInKBps = Settings::User().Get<Settings::Setting::NetworkBandwidthLimitInKBps>();
+        if (limitInKBps == 0 || bytes == 0)
+        {
+            return;
+        }
+
+        double bytesPerSecond = static_cast<double>(limitInKBps) * 1024;
+        std::chrono::steady_clock::duration delay{};
+
+        Pacer& pacer = GetPacer();
+        {
+            std::lock_guard<std::mutex> lock{ pacer.Lock };
+
+            auto now = std::chrono::steady_clock::now();
+            if (pacer.WindowBytes == 0 || now - pacer.WindowEnd > s_pacingIdleReset)
+            {
+                pacer.WindowStart = now;
+                pacer.WindowBytes = 0;
+            }
+
+            // The time by which all of the bytes of the window would have been read at the limit
+            pacer.WindowBytes += bytes;
+            auto due = pacer.WindowStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(pacer.WindowBytes) / bytesPerSecond));
+
+            pacer.WindowEnd = std::max(now, due);
+            if (due > now)
+            {
+                delay = due - now;
+            }
+        }
+
+        if (delay > std::chrono::steady_clock::duration::zero())
+        {
+            std::this_thread::sleep_for(delay);
+        }
+    }
+}
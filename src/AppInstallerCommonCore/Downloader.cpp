@@ -9,6 +9,10 @@
 #include "Public/AppInstallerStrings.h"
 #include "Public/AppInstallerLogging.h"
 #include "Public/AppInstallerTelemetry.h"
+#include "Public/winget/DownloadScheduler.h"
+#include "Public/winget/Performance.h"
+#include "Public/winget/PerformanceCounters.h"
+#include "Public/winget/ThreadGlobals.h"
 #include "Public/winget/UserSettings.h"
 #include "DODownloader.h"
 
@@ -17,6 +21,714 @@ using namespace AppInstaller::Settings;
 
 namespace AppInstaller::Utility
 {
+    // For AICLI_LOG usages with string literals.
+    #pragma warning(push)
+    #pragma warning(disable:26449)
+
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        // A download is only split into segments when each segment would be at least this large.
+        constexpr LONGLONG s_MinimumDownloadSegmentSize = 16 * 1024 * 1024;
+
+        constexpr DWORD s_DownloadBufferSize = 1024 * 1024; // 1MB
+
+        // When set, replaces the default buffer size; allows the buffer size to be compared by benchmarks.
+        DWORD s_DownloadBufferSizeOverride = 0;
+
+        DWORD GetDownloadBufferSize()
+        {
+            return (s_DownloadBufferSizeOverride ? s_DownloadBufferSizeOverride : s_DownloadBufferSize);
+        }
+
+        // Installers are downloaded with DO unless WinINet is chosen for them. The other types are only downloaded with it when enabled:
+        //  - Index :: A blob that changes at the same location, but one that every machine on a network downloads
+        //  - Manifest :: DO overhead may outweigh the benefit for small files
+        //  - WinGetUtil :: Intentionally not using DO at this time
+        bool ShouldDownloadWithDO(DownloadType type)
+        {
+            switch (type)
+            {
+            case DownloadType::Installer:
+            {
+                InstallerDownloader setting = User().Get<Setting::NetworkDownloader>();
+                return (setting == InstallerDownloader::Default || setting == InstallerDownloader::DeliveryOptimization);
+            }
+            case DownloadType::Index:
+                return User().Get<Setting::NetworkDOIndexDownloads>();
+            case DownloadType::Manifest:
+                return User().Get<Setting::NetworkDOManifestDownloads>();
+            default:
+                return false;
+            }
+        }
+
+        // Rethrows the DO failure unless it is one that should fall back to WinINet.
+        void HandleDOFailure(const std::string& url, const wil::ResultException& re)
+        {
+            // We need to be careful not to bypass metered networks or other reasons that might
+            // intentionally cause the download to be blocked.
+            HRESULT hr = re.GetErrorCode();
+            if (IsDOErrorFatal(hr))
+            {
+                throw;
+            }
+
+            // Send telemetry so that we can understand the reasons for DO failing
+            Logging::Telemetry().LogNonFatalDOError(url, hr);
+        }
+
+        wil::unique_hinternet OpenWinINetSession()
+        {
+            wil::unique_hinternet session(InternetOpenA(
+                Runtime::GetDefaultUserAgent().get().c_str(),
+                INTERNET_OPEN_TYPE_PRECONFIG,
+                NULL,
+                NULL,
+                0));
+            THROW_LAST_ERROR_IF_NULL_MSG(session, "InternetOpen() failed.");
+
+            if (User().Get<Setting::NetworkHttp2>())
+            {
+                DWORD protocols = HTTP_PROTOCOL_FLAG_HTTP2;
+                if (!InternetSetOptionA(session.get(), INTERNET_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols)))
+                {
+                    // Not supported before Windows 10; requests simply use HTTP/1.1
+                    AICLI_LOG(Core, Verbose, << "Failed to enable HTTP/2: " << GetLastError());
+                }
+            }
+
+            return session;
+        }
+
+        // A single session is shared by all of the downloads of the process, so that requests to the same host can share connections,
+        // and the proxy configuration is only resolved once. WinINet keeps the idle connections of a session to each host, so there is
+        // no need to hold a connection handle per host. Over HTTP/2, the concurrent requests to a host are multiplexed on one connection
+        // rather than each opening its own.
+        HINTERNET GetWinINetSession()
+        {
+            // Creation is attempted again by the next caller if it throws.
+            static wil::unique_hinternet s_session = OpenWinINetSession();
+            return s_session.get();
+        }
+
+        wil::unique_hinternet OpenWinINetUrl(HINTERNET session, const std::string& url, const std::string& headers = {})
+        {
+            wil::unique_hinternet urlFile(InternetOpenUrlA(
+                session,
+                url.c_str(),
+                headers.empty() ? NULL : headers.c_str(),
+                headers.empty() ? 0 : static_cast<DWORD>(-1),
+                INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS | // This allows http->https redirection
+                INTERNET_FLAG_KEEP_CONNECTION, // Return the connection to the session once the response is read, even if it was authenticated
+                0));
+            THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+
+            DWORD protocol = 0;
+            DWORD protocolSize = sizeof(protocol);
+            bool http2 = InternetQueryOptionA(urlFile.get(), INTERNET_OPTION_HTTP_PROTOCOL_USED, &protocol, &protocolSize) && WI_IsFlagSet(protocol, HTTP_PROTOCOL_FLAG_HTTP2);
+            Performance::Counters::RecordHttpRequest(http2);
+
+            return urlFile;
+        }
+
+        DWORD GetWinINetStatusCode(HINTERNET urlFile)
+        {
+            DWORD requestStatus = 0;
+            DWORD cbRequestStatus = sizeof(requestStatus);
+
+            THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile,
+                HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
+                &requestStatus,
+                &cbRequestStatus,
+                nullptr), "Query download request status failed.");
+
+            return requestStatus;
+        }
+
+        std::string GetByteRangeHeader(LONGLONG start, LONGLONG length)
+        {
+            std::ostringstream stream;
+            stream << "Range: bytes=" << start << '-' << (start + length - 1) << "\r\n";
+            return stream.str();
+        }
+
+        std::string QueryWinINetHeader(HINTERNET urlFile, DWORD infoLevel)
+        {
+            char value[512]{};
+            DWORD cbValue = sizeof(value);
+
+            if (!HttpQueryInfoA(urlFile, infoLevel, value, &cbValue, nullptr))
+            {
+                return {};
+            }
+
+            return { value, cbValue };
+        }
+
+        // Gets the total length from a Content-Range header value of the form "bytes 0-0/12345".
+        std::optional<LONGLONG> GetContentRangeTotalLength(std::string_view value)
+        {
+            size_t separator = value.rfind('/');
+            if (separator == std::string_view::npos || separator + 1 == value.length())
+            {
+                return {};
+            }
+
+            try
+            {
+                LONGLONG result = std::stoll(std::string{ value.substr(separator + 1) });
+                return (result > 0 ? std::optional<LONGLONG>{ result } : std::nullopt);
+            }
+            catch (...)
+            {
+                // A non-numeric value is allowed when the length is unknown ("*")
+                return {};
+            }
+        }
+
+        // The details of content that supports byte range requests.
+        struct RangeProbeResult
+        {
+            LONGLONG ContentLength = 0;
+            std::string ETag;
+            std::string LastModified;
+
+            // Gets the value to send with If-Range, so that a resumed range is only returned if the content is unchanged.
+            // Weak entity tags cannot be used for this; in that case the last modified time is used.
+            std::string GetRangeValidator() const
+            {
+                if (!ETag.empty() && !Utility::CaseInsensitiveStartsWith(ETag, "W/"))
+                {
+                    return ETag;
+                }
+
+                return LastModified;
+            }
+        };
+
+        // Determines whether the server supports byte range requests for the url.
+        std::optional<RangeProbeResult> ProbeByteRangeSupport(HINTERNET session, const std::string& url)
+        {
+            // A small range request is the definitive test; Accept-Ranges is optional and may be absent on servers that support them.
+            wil::unique_hinternet urlFile = OpenWinINetUrl(session, url, GetByteRangeHeader(0, 1));
+
+            DWORD requestStatus = GetWinINetStatusCode(urlFile.get());
+            if (requestStatus != HTTP_STATUS_PARTIAL_CONTENT)
+            {
+                AICLI_LOG(Core, Verbose, << "Byte range request returned status " << requestStatus << "; ranges are not supported");
+                return {};
+            }
+
+            if (Utility::CaseInsensitiveEquals(QueryWinINetHeader(urlFile.get(), HTTP_QUERY_ACCEPT_RANGES), "none"))
+            {
+                return {};
+            }
+
+            std::optional<LONGLONG> contentLength = GetContentRangeTotalLength(QueryWinINetHeader(urlFile.get(), HTTP_QUERY_CONTENT_RANGE));
+            if (!contentLength)
+            {
+                return {};
+            }
+
+            RangeProbeResult result;
+            result.ContentLength = contentLength.value();
+            result.ETag = QueryWinINetHeader(urlFile.get(), HTTP_QUERY_ETAG);
+            result.LastModified = QueryWinINetHeader(urlFile.get(), HTTP_QUERY_LAST_MODIFIED);
+            return result;
+        }
+
+        // A byte range of the target file that is downloaded by its own connection.
+        struct DownloadSegment
+        {
+            LONGLONG Start = 0;
+            LONGLONG Length = 0;
+            std::atomic<LONGLONG> Written = 0;
+            std::exception_ptr Exception;
+            std::future<void> Worker;
+        };
+
+        // The state of a partially completed ranged download, kept next to the target file so that a later attempt can resume it.
+        struct PartialDownloadState
+        {
+            std::string Url;
+            std::string ETag;
+            std::string LastModified;
+            LONGLONG ContentLength = 0;
+
+            struct Segment
+            {
+                LONGLONG Start = 0;
+                LONGLONG Length = 0;
+                LONGLONG Written = 0;
+            };
+
+            std::vector<Segment> Segments;
+        };
+
+        std::filesystem::path GetPartialDownloadStatePath(const std::filesystem::path& dest)
+        {
+            std::filesystem::path result = dest;
+            result += L".partial.json";
+            return result;
+        }
+
+        void RemovePartialDownloadState(const std::filesystem::path& dest)
+        {
+            std::error_code error;
+            std::filesystem::remove(GetPartialDownloadStatePath(dest), error);
+        }
+
+        std::optional<PartialDownloadState> ReadPartialDownloadState(const std::filesystem::path& dest)
+        {
+            std::ifstream stream{ GetPartialDownloadStatePath(dest), std::ios::binary };
+            if (!stream)
+            {
+                return {};
+            }
+
+            std::string content = Utility::ReadEntireStream(stream);
+
+            Json::Value root;
+            Json::CharReaderBuilder builder;
+            const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+            std::string error;
+
+            if (!reader->parse(content.c_str(), content.c_str() + content.size(), &root, &error) || !root.isObject() || !root["segments"].isArray())
+            {
+                AICLI_LOG(Core, Warning, << "Partial download state could not be parsed: " << error);
+                return {};
+            }
+
+            PartialDownloadState result;
+            result.Url = root["url"].asString();
+            result.ETag = root["etag"].asString();
+            result.LastModified = root["lastModified"].asString();
+            result.ContentLength = root["contentLength"].asInt64();
+
+            for (const auto& segment : root["segments"])
+            {
+                result.Segments.push_back({ segment["start"].asInt64(), segment["length"].asInt64(), segment["written"].asInt64() });
+            }
+
+            return result;
+        }
+
+        void WritePartialDownloadState(const std::filesystem::path& dest, const PartialDownloadState& state) try
+        {
+            Json::Value root{ Json::objectValue };
+            root["url"] = state.Url;
+            root["etag"] = state.ETag;
+            root["lastModified"] = state.LastModified;
+            root["contentLength"] = static_cast<Json::Int64>(state.ContentLength);
+
+            Json::Value& segments = root["segments"] = Json::Value{ Json::arrayValue };
+            for (const auto& segment : state.Segments)
+            {
+                Json::Value& value = segments.append(Json::Value{ Json::objectValue });
+                value["start"] = static_cast<Json::Int64>(segment.Start);
+                value["length"] = static_cast<Json::Int64>(segment.Length);
+                value["written"] = static_cast<Json::Int64>(segment.Written);
+            }
+
+            Json::StreamWriterBuilder writerBuilder;
+            writerBuilder.settings_["indentation"] = "";
+
+            std::ofstream stream{ GetPartialDownloadStatePath(dest), std::ios::binary | std::ios::trunc };
+            stream << Json::writeString(writerBuilder, root);
+        }
+        CATCH_LOG_MSG("Failed to write the partial download state");
+
+        // Determines whether the partial download can be continued against the content described by the probe.
+        bool CanResumePartialDownload(const PartialDownloadState& state, const std::string& url, const RangeProbeResult& probe, const std::filesystem::path& dest)
+        {
+            if (state.Url != url || state.ContentLength != probe.ContentLength || state.ETag != probe.ETag || state.LastModified != probe.LastModified ||
+                probe.GetRangeValidator().empty() || state.Segments.empty())
+            {
+                return false;
+            }
+
+            std::error_code error;
+            auto fileSize = std::filesystem::file_size(dest, error);
+            if (error || static_cast<LONGLONG>(fileSize) != state.ContentLength)
+            {
+                return false;
+            }
+
+            // The segments must cover the content exactly, in order.
+            LONGLONG expectedStart = 0;
+            for (const auto& segment : state.Segments)
+            {
+                if (segment.Start != expectedStart || segment.Length <= 0 || segment.Written < 0 || segment.Written > segment.Length)
+                {
+                    return false;
+                }
+
+                expectedStart += segment.Length;
+            }
+
+            return expectedStart == state.ContentLength;
+        }
+
+        void WriteToFileAt(HANDLE file, LONGLONG offset, const BYTE* buffer, DWORD size)
+        {
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+            DWORD bytesWritten = 0;
+            THROW_LAST_ERROR_IF(!WriteFile(file, buffer, size, &bytesWritten, &overlapped));
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_WRITE_FAULT), bytesWritten != size);
+        }
+
+        DWORD ReadFromFileAt(HANDLE file, LONGLONG offset, BYTE* buffer, DWORD size)
+        {
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+            DWORD bytesRead = 0;
+            THROW_LAST_ERROR_IF(!ReadFile(file, buffer, size, &bytesRead, &overlapped));
+            return bytesRead;
+        }
+
+        void DownloadSegmentToFile(
+            HINTERNET session,
+            const std::string& url,
+            const std::string& rangeValidator,
+            HANDLE file,
+            DownloadSegment& segment,
+            IProgressCallback& progress,
+            const std::atomic_bool& abort,
+            std::atomic_bool& contentChanged)
+        {
+            LONGLONG written = segment.Written;
+            if (written == segment.Length)
+            {
+                return;
+            }
+
+            std::string headers = GetByteRangeHeader(segment.Start + written, segment.Length - written);
+            if (!rangeValidator.empty())
+            {
+                headers += "If-Range: " + rangeValidator + "\r\n";
+            }
+
+            wil::unique_hinternet urlFile = OpenWinINetUrl(session, url, headers);
+
+            DWORD requestStatus = GetWinINetStatusCode(urlFile.get());
+            if (requestStatus != HTTP_STATUS_PARTIAL_CONTENT)
+            {
+                if (requestStatus == HTTP_STATUS_OK)
+                {
+                    // The server ignored the range, most likely because If-Range no longer matches
+                    contentChanged = true;
+                }
+
+                THROW_HR_MSG(MAKE_HRESULT(SEVERITY_ERROR, FACILITY_HTTP, requestStatus), "Byte range request status is not partial content.");
+            }
+
+            const DWORD bufferSize = GetDownloadBufferSize();
+            auto buffer = std::make_unique<BYTE[]>(bufferSize);
+            DWORD bytesRead = 0;
+
+            do
+            {
+                if (progress.IsCancelled() || abort)
+                {
+                    return;
+                }
+
+                THROW_LAST_ERROR_IF_MSG(!InternetReadFile(urlFile.get(), buffer.get(), bufferSize, &bytesRead), "InternetReadFile() failed.");
+
+                written = segment.Written;
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_DOWNLOAD_SIZE_MISMATCH, written + bytesRead > segment.Length);
+
+                if (bytesRead != 0)
+                {
+                    WriteToFileAt(file, segment.Start + written, buffer.get(), bytesRead);
+                    segment.Written = written + bytesRead;
+                    Performance::Counters::AddDownloadedBytes(bytesRead);
+                    PaceDownloadedBytes(bytesRead);
+                }
+
+            } while (bytesRead != 0);
+
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_DOWNLOAD_SIZE_MISMATCH, segment.Written != segment.Length);
+        }
+
+        // The time spent in each stage of a download, so that the log shows which one is limiting throughput.
+        struct DownloadStageTimes
+        {
+            std::chrono::steady_clock::duration Network{};
+            std::chrono::steady_clock::duration Hash{};
+            std::chrono::steady_clock::duration Write{};
+
+            void Log(LONGLONG bytes, bool hashed) const
+            {
+                auto throughput = [bytes](std::chrono::steady_clock::duration duration)
+                {
+                    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+                    std::ostringstream stream;
+                    stream << std::fixed << std::setprecision(1) <<
+                        (milliseconds > 0 ? (static_cast<double>(bytes) / (1024 * 1024)) / (static_cast<double>(milliseconds) / 1000) : 0.0) <<
+                        " MB/s (" << milliseconds << "ms)";
+                    return stream.str();
+                };
+
+                AICLI_LOG(Core, Info, << "Download stage throughput; network: " << throughput(Network) <<
+                    (hashed ? ", hash: " + throughput(Hash) : std::string{}) << ", write: " << throughput(Write));
+            }
+        };
+
+        // Creates an empty target file with the mark of the web, which is kept as the content is written to it.
+        void CreateEmptyDownloadFile(const std::filesystem::path& dest)
+        {
+            std::ofstream emptyDestFile(dest);
+            emptyDestFile.close();
+            ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
+        }
+
+        // Attempts to download the url into the file with byte range requests, over multiple connections when the content is large enough.
+        // A partial download left by a previous failed attempt is resumed if the content has not changed, and the state needed to resume
+        // is written next to the file if this attempt fails.
+        // Returns false if the server does not support ranges or the content is too small to benefit, in which
+        // case nothing has been written and the caller should fall back to a single stream.
+        bool WinINetTryDownloadRanged(
+            const std::string& url,
+            const std::filesystem::path& dest,
+            IProgressCallback& progress,
+            bool computeHash,
+            std::optional<std::vector<BYTE>>& result)
+        {
+            HINTERNET session = GetWinINetSession();
+
+            std::optional<RangeProbeResult> probe;
+            try
+            {
+                probe = ProbeByteRangeSupport(session, url);
+            }
+            catch (...)
+            {
+                // Let the single stream download report any real failure
+                LOG_CAUGHT_EXCEPTION_MSG("Byte range probe failed");
+            }
+
+            if (!probe || probe->ContentLength < s_MinimumDownloadSegmentSize)
+            {
+                RemovePartialDownloadState(dest);
+                return false;
+            }
+
+            LONGLONG contentLength = probe->ContentLength;
+            std::string rangeValidator = probe->GetRangeValidator();
+            std::vector<DownloadSegment> segments;
+
+            std::optional<PartialDownloadState> previousState = ReadPartialDownloadState(dest);
+            if (previousState && CanResumePartialDownload(previousState.value(), url, probe.value(), dest))
+            {
+                segments = std::vector<DownloadSegment>(previousState->Segments.size());
+                LONGLONG alreadyWritten = 0;
+
+                for (size_t i = 0; i < segments.size(); ++i)
+                {
+                    segments[i].Start = previousState->Segments[i].Start;
+                    segments[i].Length = previousState->Segments[i].Length;
+                    segments[i].Written = previousState->Segments[i].Written;
+                    alreadyWritten += previousState->Segments[i].Written;
+                }
+
+                AICLI_LOG(Core, Info, << "WinINet resuming download from url: " << url << " with " << alreadyWritten << " of " << contentLength << " bytes already present");
+            }
+            else
+            {
+                RemovePartialDownloadState(dest);
+                CreateEmptyDownloadFile(dest);
+
+                uint32_t segmentSetting = User().Get<Setting::NetworkDownloadSegments>();
+                LONGLONG segmentCount = std::clamp<LONGLONG>(contentLength / s_MinimumDownloadSegmentSize, 1, segmentSetting);
+                LONGLONG segmentLength = contentLength / segmentCount;
+
+                segments = std::vector<DownloadSegment>(static_cast<size_t>(segmentCount));
+                for (size_t i = 0; i < segments.size(); ++i)
+                {
+                    segments[i].Start = i * segmentLength;
+                    segments[i].Length = (i + 1 == segments.size() ? contentLength - segments[i].Start : segmentLength);
+                }
+
+                AICLI_LOG(Core, Info, << "WinINet downloading from url: " << url << " in " << segmentCount << " segments; size: " << contentLength);
+            }
+
+            // The file was created with the mark of the web; open it rather than replacing it.
+            wil::unique_hfile file{ CreateFileW(dest.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            THROW_LAST_ERROR_IF(!file);
+
+            FILE_END_OF_FILE_INFO endOfFile{};
+            endOfFile.EndOfFile.QuadPart = contentLength;
+            THROW_LAST_ERROR_IF(!SetFileInformationByHandle(file.get(), FileEndOfFileInfo, &endOfFile, sizeof(endOfFile)));
+
+            std::atomic_bool abort = false;
+            std::atomic_bool contentChanged = false;
+            ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+
+            // Ensure that the workers are stopped before anything they reference goes away, and record how far they got.
+            auto stopWorkers = wil::scope_exit([&]()
+                {
+                    abort = true;
+                    for (auto& segment : segments)
+                    {
+                        if (segment.Worker.valid())
+                        {
+                            segment.Worker.wait();
+                        }
+                    }
+
+                    bool complete = std::all_of(segments.begin(), segments.end(), [](const DownloadSegment& segment) { return segment.Written == segment.Length; });
+                    if (complete || contentChanged || rangeValidator.empty())
+                    {
+                        RemovePartialDownloadState(dest);
+                    }
+                    else
+                    {
+                        PartialDownloadState state;
+                        state.Url = url;
+                        state.ETag = probe->ETag;
+                        state.LastModified = probe->LastModified;
+                        state.ContentLength = contentLength;
+
+                        for (const auto& segment : segments)
+                        {
+                            state.Segments.push_back({ segment.Start, segment.Length, segment.Written });
+                        }
+
+                        WritePartialDownloadState(dest, state);
+                    }
+                });
+
+            for (auto& segment : segments)
+            {
+                // Created here rather than on the worker, as creating them touches the parent.
+                std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+                if (parentThreadGlobals)
+                {
+                    threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+                }
+
+                segment.Worker = std::async(std::launch::async, [&, threadGlobals]()
+                    {
+                        std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                        if (threadGlobals)
+                        {
+                            previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                        }
+
+                        try
+                        {
+                            DownloadSegmentToFile(session, url, rangeValidator, file.get(), segment, progress, abort, contentChanged);
+                        }
+                        catch (...)
+                        {
+                            segment.Exception = std::current_exception();
+                            abort = true;
+                        }
+                    });
+            }
+
+            // Hash the contiguous prefix of the file as the segments fill it in, so that the hash is ready when the download completes.
+            // When resuming, this covers the bytes written by the previous attempt as well.
+            SHA256 hashEngine;
+            LONGLONG bytesHashed = 0;
+            size_t hashSegment = 0;
+            const DWORD bufferSize = GetDownloadBufferSize();
+            auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+            while (true)
+            {
+                bool workersDone = true;
+                LONGLONG bytesDownloaded = 0;
+
+                for (const auto& segment : segments)
+                {
+                    bytesDownloaded += segment.Written;
+                    if (segment.Worker.wait_for(0ms) != std::future_status::ready)
+                    {
+                        workersDone = false;
+                    }
+                }
+
+                progress.OnProgress(bytesDownloaded, contentLength, ProgressType::Bytes);
+
+                if (computeHash && !abort)
+                {
+                    while (hashSegment < segments.size())
+                    {
+                        const auto& segment = segments[hashSegment];
+                        LONGLONG segmentWritten = segment.Written;
+                        LONGLONG available = segment.Start + segmentWritten;
+
+                        while (bytesHashed < available)
+                        {
+                            DWORD toRead = static_cast<DWORD>(std::min<LONGLONG>(bufferSize, available - bytesHashed));
+                            DWORD bytesRead = ReadFromFileAt(file.get(), bytesHashed, buffer.get(), toRead);
+                            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_READ_FAULT), bytesRead == 0);
+
+                            hashEngine.Add(buffer.get(), bytesRead);
+                            bytesHashed += bytesRead;
+                        }
+
+                        if (segmentWritten != segment.Length)
+                        {
+                            break;
+                        }
+
+                        ++hashSegment;
+                    }
+                }
+
+                if (workersDone)
+                {
+                    break;
+                }
+
+                // Wait on the segment that the hash is waiting for, or the last one if hashing is complete.
+                segments[std::min(hashSegment, segments.size() - 1)].Worker.wait_for(100ms);
+            }
+
+            stopWorkers.reset();
+
+            for (const auto& segment : segments)
+            {
+                if (segment.Exception)
+                {
+                    std::rethrow_exception(segment.Exception);
+                }
+            }
+
+            if (progress.IsCancelled())
+            {
+                AICLI_LOG(Core, Info, << "Download cancelled.");
+                result = {};
+                return true;
+            }
+
+            std::vector<BYTE> hash;
+            if (computeHash)
+            {
+                THROW_HR_IF(E_UNEXPECTED, bytesHashed != contentLength);
+                hash = hashEngine.Get();
+                AICLI_LOG(Core, Info, << "Download hash: " << SHA256::ConvertToString(hash));
+            }
+
+            AICLI_LOG(Core, Info, << "Download completed.");
+
+            result = std::move(hash);
+            return true;
+        }
+    }
+
+    #pragma warning(pop)
+
     std::optional<std::vector<BYTE>> WinINetDownloadToStream(
         const std::string& url,
         std::ostream& dest,
@@ -29,32 +741,10 @@ namespace AppInstaller::Utility
 
         AICLI_LOG(Core, Info, << "WinINet downloading from url: " << url);
 
-        wil::unique_hinternet session(InternetOpenA(
-            Runtime::GetDefaultUserAgent().get().c_str(),
-            INTERNET_OPEN_TYPE_PRECONFIG,
-            NULL,
-            NULL,
-            0));
-        THROW_LAST_ERROR_IF_NULL_MSG(session, "InternetOpen() failed.");
-
-        wil::unique_hinternet urlFile(InternetOpenUrlA(
-            session.get(),
-            url.c_str(),
-            NULL,
-            0,
-            INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
-            0));
-        THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+        wil::unique_hinternet urlFile = OpenWinINetUrl(GetWinINetSession(), url);
 
         // Check http return status
-        DWORD requestStatus = 0;
-        DWORD cbRequestStatus = sizeof(requestStatus);
-
-        THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile.get(),
-            HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
-            &requestStatus,
-            &cbRequestStatus,
-            nullptr), "Query download request status failed.");
+        DWORD requestStatus = GetWinINetStatusCode(urlFile.get());
 
         if (requestStatus != HTTP_STATUS_OK)
         {
@@ -79,8 +769,31 @@ namespace AppInstaller::Utility
         // Setup hash engine
         SHA256 hashEngine;
 
-        const int bufferSize = 1024 * 1024; // 1MB
-        auto buffer = std::make_unique<BYTE[]>(bufferSize);
+        const DWORD bufferSize = GetDownloadBufferSize();
+
+        // While one buffer is hashed and written by a worker, the next is read from the network into the other.
+        std::unique_ptr<BYTE[]> buffers[2] = { std::make_unique<BYTE[]>(bufferSize), std::make_unique<BYTE[]>(bufferSize) };
+        size_t currentBuffer = 0;
+        std::future<void> pendingWrite;
+        DownloadStageTimes stageTimes;
+
+        auto waitForPendingWrite = [&]()
+        {
+            if (pendingWrite.valid())
+            {
+                pendingWrite.get();
+                THROW_HR_IF_MSG(HRESULT_FROM_WIN32(ERROR_WRITE_FAULT), dest.fail(), "Writing the download failed.");
+            }
+        };
+
+        // The worker must never outlive the buffers
+        auto abandonPendingWrite = wil::scope_exit([&]()
+            {
+                if (pendingWrite.valid())
+                {
+                    pendingWrite.wait();
+                }
+            });
 
         BOOL readSuccess = true;
         DWORD bytesRead = 0;
@@ -94,28 +807,45 @@ namespace AppInstaller::Utility
                 return {};
             }
 
-            readSuccess = InternetReadFile(urlFile.get(), buffer.get(), bufferSize, &bytesRead);
+            auto readStart = std::chrono::steady_clock::now();
+            readSuccess = InternetReadFile(urlFile.get(), buffers[currentBuffer].get(), bufferSize, &bytesRead);
+            stageTimes.Network += std::chrono::steady_clock::now() - readStart;
 
             THROW_LAST_ERROR_IF_MSG(!readSuccess, "InternetReadFile() failed.");
 
-            if (computeHash)
+            if (bytesRead != 0)
             {
-                hashEngine.Add(buffer.get(), bytesRead);
-            }
+                waitForPendingWrite();
 
-            dest.write((char*)buffer.get(), bytesRead);
-
-            bytesDownloaded += bytesRead;
+                pendingWrite = std::async(std::launch::async, [&, buffer = buffers[currentBuffer].get(), size = bytesRead]()
+                    {
+                        if (computeHash)
+                        {
+                            auto hashStart = std::chrono::steady_clock::now();
+                            hashEngine.Add(buffer, size);
+                            stageTimes.Hash += std::chrono::steady_clock::now() - hashStart;
+                        }
+
+                        auto writeStart = std::chrono::steady_clock::now();
+                        dest.write(reinterpret_cast<const char*>(buffer), size);
+                        stageTimes.Write += std::chrono::steady_clock::now() - writeStart;
+                    });
+
+                currentBuffer = 1 - currentBuffer;
+                bytesDownloaded += bytesRead;
+                Performance::Counters::AddDownloadedBytes(bytesRead);
+                PaceDownloadedBytes(bytesRead);
 
-            if (bytesRead != 0)
-            {
                 progress.OnProgress(bytesDownloaded, contentLength, ProgressType::Bytes);
             }
 
         } while (bytesRead != 0);
 
+        waitForPendingWrite();
         dest.flush();
 
+        stageTimes.Log(bytesDownloaded, computeHash);
+
         // Check download size matches if content length is provided in response header
         if (contentLength > 0)
         {
@@ -139,12 +869,35 @@ namespace AppInstaller::Utility
     std::optional<std::vector<BYTE>> DownloadToStream(
         const std::string& url,
         std::ostream& dest,
-        DownloadType,
+        DownloadType type,
         IProgressCallback& progress,
         bool computeHash,
-        std::optional<DownloadInfo>)
+        std::optional<DownloadInfo> info)
     {
+        Performance::ScopedTimer timer{ "DownloadToStream" };
+        Performance::Counters::ActiveDownload activeDownload;
         THROW_HR_IF(E_INVALIDARG, url.empty());
+
+        DownloadSlot slot{ url, GetDownloadPriority(type, info && info->BackgroundPriority), progress };
+        if (!slot)
+        {
+            AICLI_LOG(Core, Info, << "Download was cancelled while waiting for a connection");
+            return {};
+        }
+
+        if (ShouldDownloadWithDO(type))
+        {
+            try
+            {
+                // The stream is only written to once the download succeeds, so there is nothing to undo before falling back.
+                return DODownloadToStream(url, dest, progress, computeHash, info);
+            }
+            catch (const wil::ResultException& re)
+            {
+                HandleDOFailure(url, re);
+            }
+        }
+
         return WinINetDownloadToStream(url, dest, progress, computeHash);
     }
 
@@ -156,6 +909,8 @@ namespace AppInstaller::Utility
         bool computeHash,
         std::optional<DownloadInfo> info)
     {
+        Performance::ScopedTimer timer{ "Download" };
+        Performance::Counters::ActiveDownload activeDownload;
         THROW_HR_IF(E_INVALIDARG, url.empty());
         THROW_HR_IF(E_INVALIDARG, dest.empty());
 
@@ -163,62 +918,59 @@ namespace AppInstaller::Utility
 
         std::filesystem::create_directories(dest.parent_path());
 
-        // Only Installers should be downloaded with DO currently, as:
-        //  - Index :: Constantly changing blob at same location is not what DO is for
-        //  - Manifest :: DO overhead is not needed for small files
-        //  - WinGetUtil :: Intentionally not using DO at this time
-        if (type == DownloadType::Installer)
+        // The slot covers all of the attempts, including the segments of a ranged download.
+        DownloadSlot slot{ url, GetDownloadPriority(type, info && info->BackgroundPriority), progress };
+        if (!slot)
         {
-            // Determine whether to try DO first or not, as this is the only choice currently supported.
-            InstallerDownloader setting = User().Get<Setting::NetworkDownloader>();
+            AICLI_LOG(Core, Info, << "Download was cancelled while waiting for a connection");
+            return {};
+        }
 
-            if (setting == InstallerDownloader::Default ||
-                setting == InstallerDownloader::DeliveryOptimization)
+        if (ShouldDownloadWithDO(type))
+        {
+            try
             {
-                try
-                {
-                    auto result = DODownload(url, dest, progress, computeHash, info);
-                    // Since we cannot pre-apply to the file with DO, post-apply the MotW to the file.
-                    // Only do so if the file exists, because cancellation will not throw here.
-                    if (std::filesystem::exists(dest))
-                    {
-                        ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
-                    }
-                    return result;
-                }
-                catch (const wil::ResultException& re)
-                {
-                    // Fall back to WinINet below unless the specific error is not one that should be ignored.
-                    // We need to be careful not to bypass metered networks or other reasons that might
-                    // intentionally cause the download to be blocked.
-                    HRESULT hr = re.GetErrorCode();
-                    if (IsDOErrorFatal(hr))
-                    {
-                        throw;
-                    }
-                    else
-                    {
-                        // Send telemetry so that we can understand the reasons for DO failing
-                        Logging::Telemetry().LogNonFatalDOError(url, hr);
-                    }
-                }
-
-                // If we reach this point, we are intending to fall through to WinINet.
-                // Remove any file that may have been placed in the target location.
+                auto result = DODownload(url, dest, progress, computeHash, info);
+                // Since we cannot pre-apply to the file with DO, post-apply the MotW to the file.
+                // Only do so if the file exists, because cancellation will not throw here.
                 if (std::filesystem::exists(dest))
                 {
-                    std::filesystem::remove(dest);
+                    ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
                 }
+                return result;
+            }
+            catch (const wil::ResultException& re)
+            {
+                HandleDOFailure(url, re);
+            }
+
+            // If we reach this point, we are intending to fall through to WinINet.
+            // Remove any file that may have been placed in the target location.
+            if (std::filesystem::exists(dest))
+            {
+                std::filesystem::remove(dest);
+            }
+        }
+
+        // Large installers are fetched with byte ranges when the server allows it, so that they can be
+        // split over multiple connections and resumed after a failure.
+        if (type == DownloadType::Installer)
+        {
+            std::optional<std::vector<BYTE>> rangedResult;
+            if (WinINetTryDownloadRanged(url, dest, progress, computeHash, rangedResult))
+            {
+                return rangedResult;
             }
         }
 
-        std::ofstream emptyDestFile(dest);
-        emptyDestFile.close();
-        ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
+        CreateEmptyDownloadFile(dest);
 
         // Use std::ofstream::app to append to previous empty file so that it will not
         // create a new file and clear motw.
-        std::ofstream outfile(dest, std::ofstream::binary | std::ofstream::app);
+        // The stream is unbuffered as the downloader already writes in large blocks.
+        std::ofstream outfile;
+        outfile.rdbuf()->pubsetbuf(nullptr, 0);
+        outfile.open(dest, std::ofstream::binary | std::ofstream::app);
         return WinINetDownloadToStream(url, outfile, progress, computeHash);
     }
 
@@ -249,6 +1001,35 @@ namespace AppInstaller::Utility
         return false;
     }
     
+    std::vector<std::string> GetMirroredUrls(const std::string& url, const std::vector<std::string>& mirrors)
+    {
+        std::vector<std::string> result;
+
+        constexpr std::string_view s_schemeSeparator = "://"sv;
+        size_t schemeEnd = url.find(s_schemeSeparator);
+
+        // Only remote urls can be mirrored
+        if (schemeEnd != std::string::npos && IsUrlRemote(url))
+        {
+            std::string_view hostAndPath = std::string_view{ url }.substr(schemeEnd + s_schemeSeparator.length());
+
+            for (const auto& mirror : mirrors)
+            {
+                std::string mirrored = mirror;
+                if (mirrored.empty() || mirrored.back() != '/')
+                {
+                    mirrored += '/';
+                }
+
+                mirrored += hostAndPath;
+                result.emplace_back(std::move(mirrored));
+            }
+        }
+
+        result.emplace_back(url);
+        return result;
+    }
+
     static inline bool FileSupportsMotw(const std::filesystem::path& path)
     {
         return SupportsNamedStreams(path);
@@ -363,4 +1144,11 @@ namespace AppInstaller::Utility
 
         return aesSaveResult;
     }
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+    void TestHook_SetDownloadBufferSize(DWORD size)
+    {
+        s_DownloadBufferSizeOverride = size;
+    }
+#endif
 }
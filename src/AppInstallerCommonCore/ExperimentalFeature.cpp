@@ -42,6 +42,8 @@ namespace AppInstaller::Settings
                 return userSettings.Get<Setting::EFDependencies>();
             case ExperimentalFeature::Feature::DirectMSI:
                 return userSettings.Get<Setting::EFDirectMSI>();
+            case ExperimentalFeature::Feature::UpgradeSnapshot:
+                return userSettings.Get<Setting::EFUpgradeSnapshot>();
             default:
                 THROW_HR(E_UNEXPECTED);
             }
@@ -73,6 +75,8 @@ namespace AppInstaller::Settings
             return ExperimentalFeature{ "Show Dependencies Information", "dependencies", "https://aka.ms/winget-settings", Feature::Dependencies };
         case Feature::DirectMSI:
             return ExperimentalFeature{ "Direct MSI Installation", "directMSI", "https://aka.ms/winget-settings", Feature::DirectMSI };
+        case Feature::UpgradeSnapshot:
+            return ExperimentalFeature{ "Upgrade Snapshot", "upgradeSnapshot", "https://aka.ms/winget-settings", Feature::UpgradeSnapshot };
         default:
             THROW_HR(E_UNEXPECTED);
         }
@@ -16,6 +16,42 @@ namespace AppInstaller::Logging
     static constexpr std::string_view s_fileLoggerDefaultFilePrefix = "WinGet"sv;
     static constexpr std::string_view s_fileLoggerDefaultFileExt = ".log"sv;
 
+    // The number of records that can be waiting for the writer before new ones are dropped.
+    static constexpr size_t s_fileLoggerMaximumQueuedRecords = 16 * 1024;
+
+    namespace
+    {
+        // Writes the records as a single block, followed by a note of any that were dropped.
+        void WriteBatch(std::ofstream& stream, const std::vector<std::string>& records, size_t droppedRecords) noexcept try
+        {
+            size_t totalSize = 0;
+            for (const auto& record : records)
+            {
+                totalSize += record.size();
+            }
+
+            std::string block;
+            block.reserve(totalSize);
+            for (const auto& record : records)
+            {
+                block += record;
+            }
+
+            stream.write(block.data(), static_cast<std::streamsize>(block.size()));
+
+            if (droppedRecords)
+            {
+                stream << "<" << droppedRecords << " log records were dropped>" << '\n';
+            }
+
+            stream.flush();
+        }
+        catch (...)
+        {
+            // Just eat any exceptions here; better than losing logs
+        }
+    }
+
     FileLogger::FileLogger() : FileLogger(s_fileLoggerDefaultFilePrefix) {}
 
     FileLogger::FileLogger(const std::filesystem::path& filePath)
@@ -23,7 +59,7 @@ namespace AppInstaller::Logging
         m_name = GetNameForPath(filePath);
         m_filePath = filePath;
 
-        m_stream.open(m_filePath);
+        Open();
     }
 
     FileLogger::FileLogger(const std::string_view fileNamePrefix)
@@ -32,12 +68,24 @@ namespace AppInstaller::Logging
         m_filePath = Runtime::GetPathTo(Runtime::PathName::DefaultLogLocation);
         m_filePath /= fileNamePrefix.data() + ('-' + Utility::GetCurrentTimeForFilename() + s_fileLoggerDefaultFileExt.data());
 
-        m_stream.open(m_filePath);
+        Open();
     }
 
     FileLogger::~FileLogger()
     {
-        m_stream.flush();
+        {
+            std::lock_guard<std::mutex> lock{ m_queueLock };
+            m_stopping = true;
+        }
+        m_queueSignal.notify_one();
+
+        if (m_writer.joinable())
+        {
+            m_writer.join();
+        }
+
+        // The writer may not have been started, or may have been terminated with the process before it could finish.
+        WriteBatch(m_stream, m_queue, m_droppedRecords);
     }
 
     std::string FileLogger::GetNameForPath(const std::filesystem::path& filePath)
@@ -63,10 +111,10 @@ namespace AppInstaller::Logging
 
     void FileLogger::Write(Channel channel, Level, std::string_view message) noexcept try
     {
-        // Send to a string first to create a single block to write to a file.
+        // Format on this thread so that the timestamp reflects when the log was made.
         std::stringstream strstr;
-        strstr << std::chrono::system_clock::now() << " [" << std::setw(GetMaxChannelNameLength()) << std::left << std::setfill(' ') << GetChannelName(channel) << "] " << message;
-        m_stream << strstr.str() << std::endl;
+        strstr << std::chrono::system_clock::now() << " [" << std::setw(GetMaxChannelNameLength()) << std::left << std::setfill(' ') << GetChannelName(channel) << "] " << message << '\n';
+        Enqueue(strstr.str());
     }
     catch (...)
     {
@@ -75,13 +123,94 @@ namespace AppInstaller::Logging
 
     void FileLogger::WriteDirect(std::string_view message) noexcept try
     {
-        m_stream << message << std::endl;
+        std::string record;
+        record.reserve(message.size() + 1);
+        record += message;
+        record += '\n';
+        Enqueue(std::move(record));
     }
     catch (...)
     {
         // Just eat any exceptions here; better than losing logs
     }
 
+    void FileLogger::Open()
+    {
+        m_stream.open(m_filePath);
+
+        try
+        {
+            m_writer = std::thread(&FileLogger::WriterThread, this);
+        }
+        catch (...)
+        {
+            // Without a writer, records are written as they are logged.
+        }
+    }
+
+    void FileLogger::Enqueue(std::string&& record) noexcept try
+    {
+        bool wasEmpty = false;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_queueLock };
+
+            if (!m_writer.joinable())
+            {
+                WriteBatch(m_stream, { std::move(record) }, 0);
+                return;
+            }
+
+            if (m_queue.size() >= s_fileLoggerMaximumQueuedRecords)
+            {
+                ++m_droppedRecords;
+                return;
+            }
+
+            wasEmpty = m_queue.empty();
+            m_queue.emplace_back(std::move(record));
+        }
+
+        // The writer only waits when the queue is empty, so there is no need to wake it otherwise.
+        if (wasEmpty)
+        {
+            m_queueSignal.notify_one();
+        }
+    }
+    catch (...)
+    {
+        // Just eat any exceptions here; better than losing logs
+    }
+
+    void FileLogger::WriterThread() noexcept
+    {
+        std::vector<std::string> batch;
+
+        for (;;)
+        {
+            size_t droppedRecords = 0;
+            bool stopping = false;
+
+            {
+                std::unique_lock<std::mutex> lock{ m_queueLock };
+                m_queueSignal.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+
+                // Everything that arrived while the previous batch was being written is taken at once.
+                batch.swap(m_queue);
+                droppedRecords = std::exchange(m_droppedRecords, 0);
+                stopping = m_stopping;
+            }
+
+            WriteBatch(m_stream, batch, droppedRecords);
+            batch.clear();
+
+            if (stopping)
+            {
+                return;
+            }
+        }
+    }
+
     void FileLogger::BeginCleanup(const std::filesystem::path& filePath)
     {
         std::thread([filePath]()
@@ -18,6 +18,116 @@ using namespace winrt::Windows::Web::Http::Filters;
 // The HRESULTs will be mapped to UI error code by the appropriate component
 namespace AppInstaller::Utility::HttpStream
 {
+    namespace
+    {
+        constexpr std::string_view s_MultipartByteRangesMediaType = "multipart/byteranges";
+
+        // Parses the first and last position from a Content-Range value of the form "bytes a-b/x"
+        bool TryParseContentRange(std::string_view value, ULONG64& first, ULONG64& last)
+        {
+            size_t spacePosition = value.find(' ');
+            size_t dashPosition = value.find('-', spacePosition);
+            size_t slashPosition = value.find('/', dashPosition);
+
+            if (spacePosition == std::string_view::npos || dashPosition == std::string_view::npos || slashPosition == std::string_view::npos)
+            {
+                return false;
+            }
+
+            try
+            {
+                first = std::stoull(std::string{ value.substr(spacePosition + 1, dashPosition - spacePosition - 1) });
+                last = std::stoull(std::string{ value.substr(dashPosition + 1, slashPosition - dashPosition - 1) });
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            return first <= last;
+        }
+
+        // Gets the boundary parameter from a multipart Content-Type value
+        std::string GetMultipartBoundary(std::string_view contentType)
+        {
+            static constexpr std::string_view s_boundaryParameter = "boundary=";
+
+            size_t position = Utility::ToLower(contentType).find(s_boundaryParameter);
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), position == std::string::npos);
+
+            std::string_view boundary = contentType.substr(position + s_boundaryParameter.length());
+            boundary = boundary.substr(0, boundary.find(';'));
+
+            if (boundary.length() >= 2 && boundary.front() == '"' && boundary.back() == '"')
+            {
+                boundary = boundary.substr(1, boundary.length() - 2);
+            }
+
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), boundary.empty());
+            return std::string{ boundary };
+        }
+
+        // Splits a multipart/byteranges body into its parts, using the Content-Range of each part to find its data.
+        std::vector<std::pair<ULONG64, IBuffer>> ParseMultipartByteRanges(const IBuffer& body, std::string_view boundary)
+        {
+            Microsoft::WRL::ComPtr<::Windows::Storage::Streams::IBufferByteAccess> bufferByteAccess;
+            ::IInspectable* bufferAbi = (::IInspectable*)winrt::get_abi(body);
+            winrt::check_hresult(bufferAbi->QueryInterface(IID_PPV_ARGS(&bufferByteAccess)));
+            byte* byteBuffer = nullptr;
+            winrt::check_hresult(bufferByteAccess->Buffer(&byteBuffer));
+
+            std::string_view content{ reinterpret_cast<const char*>(byteBuffer), body.Length() };
+            std::string delimiter = "--" + std::string{ boundary };
+
+            std::vector<std::pair<ULONG64, IBuffer>> result;
+            size_t position = content.find(delimiter);
+
+            while (position != std::string_view::npos)
+            {
+                position += delimiter.length();
+
+                // The final delimiter is followed by "--"
+                if (content.substr(position, 2) == "--")
+                {
+                    break;
+                }
+
+                size_t headersEnd = content.find("\r\n\r\n", position);
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), headersEnd == std::string_view::npos);
+
+                ULONG64 first = 0;
+                ULONG64 last = 0;
+                bool foundContentRange = false;
+
+                std::istringstream headers{ std::string{ content.substr(position, headersEnd - position) } };
+                std::string line;
+
+                while (std::getline(headers, line))
+                {
+                    size_t colonPosition = line.find(':');
+                    if (colonPosition != std::string::npos && Utility::CaseInsensitiveEquals(Utility::Trim(line.substr(0, colonPosition)), "Content-Range"))
+                    {
+                        std::string value = line.substr(colonPosition + 1);
+                        foundContentRange = TryParseContentRange(Utility::Trim(value), first, last);
+                    }
+                }
+
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), !foundContentRange);
+
+                size_t dataStart = headersEnd + 4;
+                ULONG64 dataSize = last - first + 1;
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), dataSize > content.length() - dataStart);
+
+                result.emplace_back(first, CryptographicBuffer::CreateFromByteArray(
+                    { byteBuffer + dataStart, byteBuffer + dataStart + static_cast<size_t>(dataSize) }));
+
+                position = content.find(delimiter, dataStart + static_cast<size_t>(dataSize));
+            }
+
+            return result;
+        }
+    }
+
     std::future<std::shared_ptr<HttpClientWrapper>> HttpClientWrapper::CreateAsync(const Uri& uri)
     {
         std::shared_ptr<HttpClientWrapper> instance = std::make_shared<HttpClientWrapper>();
@@ -67,6 +177,11 @@ namespace AppInstaller::Utility::HttpStream
             response.Content().Headers().Lookup(L"Content-Type")
             : L"";
 
+        if (response.Headers().HasKey(L"ETag"))
+        {
+            m_etagHeader = response.Headers().Lookup(L"ETag");
+        }
+
         // If the size wasn't resolved try with a GET 0-0 request
         if (m_sizeInBytes == 0)
         {
@@ -90,16 +205,7 @@ namespace AppInstaller::Utility::HttpStream
 
         HttpRequestMessage request(HttpMethod::Get(), m_requestUri);
         request.Headers().Append(L"Range", rangeHeaderValue);
-
-        if (!Utility::IsEmptyOrWhitespace(m_etagHeader))
-        {
-            request.Headers().Append(L"If-Match", m_etagHeader);
-        }
-
-        if (!Utility::IsEmptyOrWhitespace(m_lastModifiedHeader))
-        {
-            request.Headers().Append(L"If-Unmodified-Since", m_lastModifiedHeader);
-        }
+        AppendValidatorHeaders(request);
 
         HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead);
         HttpContentHeaderCollection contentHeaders = response.Content().Headers();
@@ -139,6 +245,74 @@ namespace AppInstaller::Utility::HttpStream
         co_return co_await response.Content().ReadAsBufferAsync();
     }
 
+    void HttpClientWrapper::AppendValidatorHeaders(HttpRequestMessage& request)
+    {
+        if (!Utility::IsEmptyOrWhitespace(m_etagHeader))
+        {
+            request.Headers().Append(L"If-Match", m_etagHeader);
+        }
+
+        if (!Utility::IsEmptyOrWhitespace(m_lastModifiedHeader))
+        {
+            request.Headers().Append(L"If-Unmodified-Since", m_lastModifiedHeader);
+        }
+    }
+
+    std::future<std::vector<std::pair<ULONG64, IBuffer>>> HttpClientWrapper::DownloadRangesAsync(
+        const std::vector<std::pair<ULONG64, UINT32>>& ranges,
+        const InputStreamOptions&)
+    {
+        THROW_HR_IF(E_INVALIDARG, ranges.empty());
+
+        std::wstring rangeHeaderValue = L"bytes=";
+        for (const auto& range : ranges)
+        {
+            THROW_HR_IF(E_INVALIDARG, range.second == 0);
+
+            unsigned long long endPosition = 0;
+            winrt::check_hresult(ULong64Add(range.first, range.second - 1, &endPosition));
+
+            if (rangeHeaderValue.back() != L'=')
+            {
+                rangeHeaderValue += L',';
+            }
+
+            rangeHeaderValue += std::to_wstring(range.first) + L"-" + std::to_wstring(endPosition);
+        }
+
+        HttpRequestMessage request(HttpMethod::Get(), m_requestUri);
+        request.Headers().Append(L"Range", rangeHeaderValue);
+        AppendValidatorHeaders(request);
+
+        HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead);
+        HttpContentHeaderCollection contentHeaders = response.Content().Headers();
+
+        if (response.StatusCode() != HttpStatusCode::PartialContent)
+        {
+            // throw HRESULT used for range-request error
+            THROW_HR(HRESULT_FROM_WIN32(ERROR_NO_RANGES_PROCESSED));
+        }
+
+        std::string contentType = contentHeaders.HasKey(L"Content-Type") ? Utility::ConvertToUTF8(contentHeaders.Lookup(L"Content-Type")) : std::string{};
+        IBuffer body = co_await response.Content().ReadAsBufferAsync();
+
+        if (Utility::CaseInsensitiveStartsWith(contentType, s_MultipartByteRangesMediaType))
+        {
+            co_return ParseMultipartByteRanges(body, GetMultipartBoundary(contentType));
+        }
+
+        // The server may merge the ranges into a single part
+        ULONG64 first = 0;
+        ULONG64 last = 0;
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NO_RANGES_PROCESSED), !contentHeaders.HasKey(L"Content-Range") ||
+            !TryParseContentRange(Utility::ConvertToUTF8(contentHeaders.Lookup(L"Content-Range")), first, last));
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), body.Length() != last - first + 1);
+
+        std::vector<std::pair<ULONG64, IBuffer>> result;
+        result.emplace_back(first, body);
+        co_return result;
+    }
+
     std::future<IBuffer> HttpClientWrapper::DownloadRangeAsync(
         const ULONG64 startPosition,
         const UINT32 requestedSizeInBytes,
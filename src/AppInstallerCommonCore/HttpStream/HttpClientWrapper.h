@@ -18,6 +18,13 @@ namespace AppInstaller::Utility::HttpStream
             const UINT32 requestedSizeInBytes,
             const winrt::Windows::Storage::Streams::InputStreamOptions& options);
 
+        // Downloads the given ranges, as pairs of start position and size, in a single request.
+        // Returns the parts of the response as pairs of start position and buffer. The server may have merged
+        // ranges in its response, so the parts are not necessarily the same as the requested ranges.
+        std::future<std::vector<std::pair<ULONG64, winrt::Windows::Storage::Streams::IBuffer>>> DownloadRangesAsync(
+            const std::vector<std::pair<ULONG64, UINT32>>& ranges,
+            const winrt::Windows::Storage::Streams::InputStreamOptions& options);
+
         unsigned long long GetFullFileSize()
         {
             return m_sizeInBytes;
@@ -33,6 +40,12 @@ namespace AppInstaller::Utility::HttpStream
             return m_contentType;
         }
 
+        // The ETag of the file, or empty if the server did not send one.
+        std::wstring GetETag()
+        {
+            return m_etagHeader;
+        }
+
     private:
         winrt::Windows::Web::Http::HttpClient m_httpClient;
         winrt::Windows::Foundation::Uri m_requestUri = nullptr;
@@ -44,6 +57,9 @@ namespace AppInstaller::Utility::HttpStream
 
         std::future<void> PopulateInfoAsync();
 
+        // Adds the headers that make range requests fail if the file changes between them.
+        void AppendValidatorHeaders(winrt::Windows::Web::Http::HttpRequestMessage& request);
+
         std::future<winrt::Windows::Storage::Streams::IBuffer> SendHttpRequestAsync(
             _In_ ULONG64 startPosition,
             _In_ UINT32 requestedSizeInBytes);
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "pch.h"
+#include "HttpDiskCache.h"
+#include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerRuntime.h"
+#include "Public/AppInstallerSHA256.h"
+#include "Public/AppInstallerStrings.h"
+
+using namespace winrt::Windows::Storage::Streams;
+using namespace winrt::Windows::Security::Cryptography;
+
+namespace AppInstaller::Utility::HttpStream
+{
+    namespace
+    {
+        constexpr std::wstring_view s_HttpDiskCache_Directory = L"PackageReadCache";
+
+        // A weak ETag only promises equivalent content, not the same bytes
+        bool IsStrongETag(std::wstring_view etag)
+        {
+            return !Utility::IsEmptyOrWhitespace(etag) && etag.substr(0, 2) != L"W/";
+        }
+
+        // Removes the least recently used entries until the rest fit in the maximum size.
+        void RemoveStaleEntries(const std::filesystem::path& root, const std::filesystem::path& keep, ULONG64 maximumSizeInBytes)
+        {
+            std::vector<std::tuple<std::filesystem::file_time_type, std::filesystem::path, ULONG64>> entries;
+            ULONG64 totalSize = 0;
+
+            for (const auto& entry : std::filesystem::directory_iterator{ root })
+            {
+                if (!entry.is_directory())
+                {
+                    continue;
+                }
+
+                ULONG64 entrySize = 0;
+                for (const auto& file : std::filesystem::directory_iterator{ entry.path() })
+                {
+                    if (file.is_regular_file())
+                    {
+                        entrySize += file.file_size();
+                    }
+                }
+
+                totalSize += entrySize;
+                entries.emplace_back(entry.last_write_time(), entry.path(), entrySize);
+            }
+
+            std::sort(entries.begin(), entries.end());
+
+            for (const auto& [lastWriteTime, path, entrySize] : entries)
+            {
+                if (totalSize <= maximumSizeInBytes)
+                {
+                    break;
+                }
+
+                if (path == keep)
+                {
+                    continue;
+                }
+
+                std::error_code error;
+                std::filesystem::remove_all(path, error);
+                if (!error)
+                {
+                    totalSize -= entrySize;
+                }
+            }
+        }
+    }
+
+    std::filesystem::path HttpDiskCache::GetDefaultRoot()
+    {
+        return Runtime::GetPathTo(Runtime::PathName::LocalState) / s_HttpDiskCache_Directory;
+    }
+
+    std::unique_ptr<HttpDiskCache> HttpDiskCache::Create(
+        const std::filesystem::path& root,
+        std::wstring_view uri,
+        std::wstring_view etag,
+        ULONG64 fileSize,
+        UINT32 pageSize,
+        ULONG64 maximumSizeInBytes)
+    {
+        if (!IsStrongETag(etag) || fileSize == 0 || pageSize == 0 || maximumSizeInBytes == 0)
+        {
+            return {};
+        }
+
+        // The page size is part of the key, as the pages are only valid for the size that they were saved with
+        std::string key = Utility::ConvertToUTF8(uri);
+        key += '\n';
+        key += Utility::ConvertToUTF8(etag);
+        key += '\n';
+        key += std::to_string(fileSize);
+        key += '\n';
+        key += std::to_string(pageSize);
+
+        std::filesystem::path directory = root / Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(key));
+
+        try
+        {
+            std::filesystem::create_directories(directory);
+
+            // Mark the entry as used, so that it is the last to be removed
+            std::filesystem::last_write_time(directory, std::filesystem::file_time_type::clock::now());
+
+            RemoveStaleEntries(root, directory, maximumSizeInBytes);
+        }
+        catch (...)
+        {
+            AICLI_LOG(Core, Warning, << "Failed to open the package read disk cache at " << directory);
+            return {};
+        }
+
+        return std::make_unique<HttpDiskCache>(std::move(directory), fileSize, pageSize);
+    }
+
+    HttpDiskCache::HttpDiskCache(std::filesystem::path directory, ULONG64 fileSize, UINT32 pageSize) :
+        m_directory(std::move(directory)), m_fileSize(fileSize), m_pageSize(pageSize)
+    {
+        THROW_HR_IF(E_INVALIDARG, m_directory.empty() || m_fileSize == 0 || m_pageSize == 0);
+    }
+
+    IBuffer HttpDiskCache::ReadPage(ULONG64 pageOffset) const
+    {
+        if (pageOffset % m_pageSize != 0 || pageOffset >= m_fileSize)
+        {
+            return nullptr;
+        }
+
+        std::filesystem::path pagePath = m_directory / std::to_wstring(pageOffset);
+
+        // Any failure to read the page is a miss
+        try
+        {
+            std::error_code error;
+            auto fileSize = std::filesystem::file_size(pagePath, error);
+            UINT32 pageLength = GetPageLength(pageOffset);
+
+            // A page of the wrong length was not completely written
+            if (error || fileSize != pageLength)
+            {
+                return nullptr;
+            }
+
+            std::vector<uint8_t> bytes(pageLength);
+            std::ifstream stream{ pagePath, std::ios_base::in | std::ios_base::binary };
+            stream.read(reinterpret_cast<char*>(bytes.data()), pageLength);
+
+            if (stream.gcount() != static_cast<std::streamsize>(pageLength))
+            {
+                return nullptr;
+            }
+
+            return CryptographicBuffer::CreateFromByteArray(bytes);
+        }
+        catch (...)
+        {
+            AICLI_LOG(Core, Verbose, << "Failed to read cached page from " << pagePath);
+            return nullptr;
+        }
+    }
+
+    void HttpDiskCache::WritePage(ULONG64 pageOffset, const IBuffer& buffer) const
+    {
+        if (pageOffset % m_pageSize != 0 || pageOffset >= m_fileSize || buffer.Length() != GetPageLength(pageOffset))
+        {
+            return;
+        }
+
+        std::filesystem::path pagePath = m_directory / std::to_wstring(pageOffset);
+
+        try
+        {
+            winrt::com_array<uint8_t> bytes;
+            CryptographicBuffer::CopyToByteArray(buffer, bytes);
+
+            // Write to a unique file and then move it into place, as other processes may be reading the same package
+            std::filesystem::path tempPath = pagePath;
+            tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId());
+
+            {
+                std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+                stream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+                THROW_HR_IF(E_FAIL, stream.fail());
+            }
+
+            std::filesystem::rename(tempPath, pagePath);
+        }
+        catch (...)
+        {
+            AICLI_LOG(Core, Verbose, << "Failed to write cached page to " << pagePath);
+        }
+    }
+
+    UINT32 HttpDiskCache::GetPageLength(ULONG64 pageOffset) const
+    {
+        // Conversion is safe as the result is no more than the page size
+        return static_cast<UINT32>(std::min<ULONG64>(m_pageSize, m_fileSize - pageOffset));
+    }
+}
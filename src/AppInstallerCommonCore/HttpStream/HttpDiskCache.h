@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace AppInstaller::Utility::HttpStream
+{
+    // A disk-backed tier under the HttpLocalCache. It keeps the pages read from one version of a remote file,
+    // so that reading the same package metadata in a later run does not download it again.
+    class HttpDiskCache
+    {
+    public:
+        // Gets the default location of the cache entries.
+        static std::filesystem::path GetDefaultRoot();
+
+        // Creates the cache for the given version of a file, or returns null if the version cannot be identified.
+        // Only a strong ETag identifies the version; without one, a cached page may be from a different file.
+        // Entries are removed, least recently used first, to keep the root under the maximum size.
+        static std::unique_ptr<HttpDiskCache> Create(
+            const std::filesystem::path& root,
+            std::wstring_view uri,
+            std::wstring_view etag,
+            ULONG64 fileSize,
+            UINT32 pageSize,
+            ULONG64 maximumSizeInBytes);
+
+        HttpDiskCache(std::filesystem::path directory, ULONG64 fileSize, UINT32 pageSize);
+
+        // Returns the cached page at the given offset, or null if it is not cached.
+        winrt::Windows::Storage::Streams::IBuffer ReadPage(ULONG64 pageOffset) const;
+
+        // Saves the page at the given offset. Failures are logged, as the cache is only an optimization.
+        void WritePage(ULONG64 pageOffset, const winrt::Windows::Storage::Streams::IBuffer& buffer) const;
+
+    private:
+        std::filesystem::path m_directory;
+        ULONG64 m_fileSize;
+        UINT32 m_pageSize;
+
+        // The expected length of the page at the given offset; only the last page of the file is shorter.
+        UINT32 GetPageLength(ULONG64 pageOffset) const;
+    };
+}
@@ -13,6 +13,58 @@ using namespace winrt::Windows::Security::Cryptography;
 // The HRESULTs will be mapped to UI error code by the appropriate component
 namespace AppInstaller::Utility::HttpStream
 {
+    namespace
+    {
+        // The read ahead for sequential reads doubles with each request, up to this number of pages.
+        constexpr UINT32 s_MaximumReadAheadPages = 32;
+
+        byte* GetBufferBytes(const IBuffer& buffer)
+        {
+            Microsoft::WRL::ComPtr<IBufferByteAccess> bufferByteAccess;
+            ::IInspectable* bufferAbi = (::IInspectable*)winrt::get_abi(buffer);
+            winrt::check_hresult(bufferAbi->QueryInterface(IID_PPV_ARGS(&bufferByteAccess)));
+            byte* byteBuffer = nullptr;
+            winrt::check_hresult(bufferByteAccess->Buffer(&byteBuffer));
+            return byteBuffer;
+        }
+
+        // A buffer over part of a cached page, which holds a reference to the page rather than a copy of it.
+        // The bytes are only meant to be read; they are shared with the cache.
+        struct PageView : winrt::implements<PageView, IBuffer, IBufferByteAccess>
+        {
+            PageView(IBuffer page, UINT32 offset, UINT32 length) :
+                m_page(std::move(page)), m_bytes(GetBufferBytes(m_page) + offset), m_capacity(length), m_length(length) {}
+
+            uint32_t Capacity() const { return m_capacity; }
+
+            uint32_t Length() const { return m_length; }
+
+            void Length(uint32_t value)
+            {
+                THROW_HR_IF(E_INVALIDARG, value > m_capacity);
+                m_length = value;
+            }
+
+            HRESULT __stdcall Buffer(byte** value) noexcept final
+            {
+                *value = m_bytes;
+                return S_OK;
+            }
+
+        private:
+            IBuffer m_page;
+            byte* m_bytes;
+            UINT32 m_capacity;
+            UINT32 m_length;
+        };
+    }
+
+    HttpLocalCache::HttpLocalCache(UINT32 pageSize, UINT32 maxPages, std::unique_ptr<HttpDiskCache> diskCache) :
+        m_pageSize(pageSize), m_maxPages(maxPages), m_diskCache(std::move(diskCache))
+    {
+        THROW_HR_IF(E_INVALIDARG, m_pageSize == 0 || m_maxPages == 0);
+    }
+
     std::future<IBuffer> HttpLocalCache::ReadFromCacheAndDownloadIfNecessaryAsync(
         const ULONG64 requestedPosition,
         const UINT32 requestedSize,
@@ -27,6 +79,15 @@ namespace AppInstaller::Utility::HttpStream
         std::vector<ULONG64> unsatisfiablePages;
         FindCachePages(requestedPosition, requestedSize, allPages, unsatisfiablePages);
 
+        // Only read ahead when a round trip is needed anyway
+        UINT32 readAheadPages = UpdateReadAhead(requestedPosition, requestedSize);
+        if (readAheadPages > 0 && !unsatisfiablePages.empty())
+        {
+            AddReadAheadPages(allPages.back(), readAheadPages, httpClientWrapper->GetFullFileSize(), unsatisfiablePages);
+        }
+
+        LoadPagesFromDiskCache(unsatisfiablePages);
+
         // download the missing pages
         co_await DownloadAndSaveToCacheAysnc(
             unsatisfiablePages,
@@ -34,25 +95,53 @@ namespace AppInstaller::Utility::HttpStream
             httpInputStreamOptions);
 
         // At this point, everything should be in the cache
-        IBuffer constructedBuffer = {};
+        IBuffer requestedBuffer = ReadRangeFromCache(requestedPosition, requestedSize, allPages);
+
+        VacateStaleEntriesFromCache();
+
+        co_return requestedBuffer;
+    }
 
-        for (UINT32 i = 0; i < allPages.size(); i++)
+    UINT32 HttpLocalCache::UpdateReadAhead(const ULONG64 requestedPosition, const UINT32 requestedSize)
+    {
+        // A read is sequential if it starts where the last one ended, or within the same page
+        bool isSequential = requestedPosition >= m_lastRequestEndPosition && (requestedPosition - m_lastRequestEndPosition) < m_pageSize;
+
+        if (isSequential)
         {
-            UINT64 pageOffset = allPages[i];
-            IBuffer cachedPageBuffer = ReadPageFromCache(pageOffset);
-            constructedBuffer = ConcatenateBuffers(constructedBuffer, cachedPageBuffer);
+            // Keep the read ahead well under the cache size, so that it cannot evict the pages being read
+            UINT32 maximumReadAheadPages = std::min(s_MaximumReadAheadPages, m_maxPages / 2);
+            m_readAheadPages = std::min(std::max(m_readAheadPages * 2, 1U), maximumReadAheadPages);
+        }
+        else
+        {
+            m_readAheadPages = 0;
         }
 
-        // trim buffer to match requested range
-        IBuffer requestedBuffer = TrimBufferToSatisfyRequest(
-            constructedBuffer,
-            requestedPosition,
-            requestedSize,
-            allPages);
+        winrt::check_hresult(ULong64Add(requestedPosition, requestedSize, &m_lastRequestEndPosition));
 
-        VacateStaleEntriesFromCache();
+        return m_readAheadPages;
+    }
 
-        co_return requestedBuffer;
+    void HttpLocalCache::AddReadAheadPages(
+        const ULONG64 lastRequestedPage,
+        const UINT32 readAheadPages,
+        const ULONG64 fileSize,
+        std::vector<ULONG64>& unsatisfiablePages)
+    {
+        ULONG64 currentPageOffset = lastRequestedPage;
+
+        for (UINT32 i = 0; i < readAheadPages; ++i)
+        {
+            winrt::check_hresult(ULong64Add(currentPageOffset, m_pageSize, &currentPageOffset));
+
+            if (currentPageOffset >= fileSize || m_localCache.find(currentPageOffset) != m_localCache.end())
+            {
+                break;
+            }
+
+            unsatisfiablePages.push_back(currentPageOffset);
+        }
     }
 
     void HttpLocalCache::FindCachePages(
@@ -64,7 +153,7 @@ namespace AppInstaller::Utility::HttpStream
         ULONG64 requestedEndPosition;
         ULONG64 currentPageOffset;
         winrt::check_hresult(ULong64Add(requestedPosition, requestedSize, &requestedEndPosition));
-        winrt::check_hresult(ULong64Mult((requestedPosition / PAGE_SIZE), PAGE_SIZE, &currentPageOffset));
+        winrt::check_hresult(ULong64Mult((requestedPosition / m_pageSize), m_pageSize, &currentPageOffset));
 
         // There's always at least one page for the range
         do
@@ -76,13 +165,38 @@ namespace AppInstaller::Utility::HttpStream
                 unsatisfiablePages.push_back(currentPageOffset);
             }
 
-            winrt::check_hresult(ULong64Add(currentPageOffset, PAGE_SIZE, &currentPageOffset));
+            winrt::check_hresult(ULong64Add(currentPageOffset, m_pageSize, &currentPageOffset));
 
         } while (currentPageOffset < requestedEndPosition);
     }
 
+    void HttpLocalCache::LoadPagesFromDiskCache(std::vector<ULONG64>& unsatisfiablePages)
+    {
+        if (!m_diskCache)
+        {
+            return;
+        }
+
+        auto newEnd = std::remove_if(unsatisfiablePages.begin(), unsatisfiablePages.end(), [&](ULONG64 pageOffset)
+            {
+                IBuffer buffer = m_diskCache->ReadPage(pageOffset);
+                if (!buffer)
+                {
+                    return false;
+                }
+
+                CachedPage page;
+                page.lastAccessCounter = m_accessCounter;
+                page.buffer = std::move(buffer);
+                m_localCache[pageOffset] = std::move(page);
+                return true;
+            });
+
+        unsatisfiablePages.erase(newEnd, unsatisfiablePages.end());
+    }
+
     // Breaks the provided buffer into smaller buffers and saves them to the cache at the corresponding 
-    // page offset position, starting at firstPageOffset. The smaller buffers are all PAGE_SIZE bytes,
+    // page offset position, starting at firstPageOffset. The smaller buffers are all the page size,
     // except for the one corresponding to the last page in the file
     void HttpLocalCache::SaveBufferToCache(const IBuffer& buffer, const ULONG64 firstPageOffset)
     {
@@ -93,7 +207,7 @@ namespace AppInstaller::Utility::HttpStream
         while (remainingBufferSize > 0)
         {
             // Extract the sub-buffer
-            UINT32 currentPageSize = std::min(remainingBufferSize, PAGE_SIZE);
+            UINT32 currentPageSize = std::min(remainingBufferSize, m_pageSize);
             IBuffer currentPageBuffer = CreateTrimmedBuffer(buffer, currentBufferIndex, currentPageSize);
 
             // Add it to the cache
@@ -102,10 +216,15 @@ namespace AppInstaller::Utility::HttpStream
             currentPage.buffer = currentPageBuffer;
             m_localCache[currentPageOffset] = currentPage;
 
+            if (m_diskCache)
+            {
+                m_diskCache->WritePage(currentPageOffset, currentPageBuffer);
+            }
+
             // update loop vars
             winrt::check_hresult(UInt32Sub(remainingBufferSize, currentPageSize, &remainingBufferSize));
             winrt::check_hresult(UInt32Add(currentBufferIndex, currentPageSize, &currentBufferIndex));
-            winrt::check_hresult(ULong64Add(currentPageOffset, PAGE_SIZE, &currentPageOffset));
+            winrt::check_hresult(ULong64Add(currentPageOffset, m_pageSize, &currentPageOffset));
         }
     }
 
@@ -122,24 +241,56 @@ namespace AppInstaller::Utility::HttpStream
         return page.buffer;
     }
 
-    // Trims a buffer that was constructed (by fetching pages from cache and downloading missing pages)
-    // in order to satisfy a request and return the exact buffer the consumer asked for.
-    IBuffer HttpLocalCache::TrimBufferToSatisfyRequest(
-        const IBuffer& constructedBuffer,
+    // Returns the exact buffer the consumer asked for from the cached pages. A range within a single page
+    // is returned as a view of that page. A range across pages is copied once, from each page straight
+    // into the returned buffer. The range is cut short at the end of the file.
+    IBuffer HttpLocalCache::ReadRangeFromCache(
         const ULONG64 requestedPosition,
         const UINT32 requestedSize,
-        const std::vector<ULONG64> allPages)
+        const std::vector<ULONG64>& allPages)
     {
-        ULONG64 fullBufferStartOffset = allPages[0];
+        ULONG64 firstPageStartIndex;
+        winrt::check_hresult(ULong64Sub(requestedPosition, allPages[0], &firstPageStartIndex));
+
+        // Conversion is safe as the index is within a page.
+        UINT32 startIndex = static_cast<UINT32>(firstPageStartIndex);
+
+        if (allPages.size() == 1)
+        {
+            IBuffer page = ReadPageFromCache(allPages[0]);
+            UINT32 pageLength = page.Length();
+            startIndex = std::min(startIndex, pageLength);
+
+            return winrt::make<PageView>(std::move(page), startIndex, std::min(requestedSize, pageLength - startIndex));
+        }
+
+        Buffer requestedBuffer{ requestedSize };
+        byte* destination = GetBufferBytes(requestedBuffer);
+        UINT32 bytesWritten = 0;
+
+        for (ULONG64 pageOffset : allPages)
+        {
+            IBuffer page = ReadPageFromCache(pageOffset);
+            UINT32 pageLength = page.Length();
 
-        ULONG64 trimmedBufferStartRelativeIndex;
-        winrt::check_hresult(ULong64Sub(requestedPosition, fullBufferStartOffset, &trimmedBufferStartRelativeIndex));
+            if (startIndex >= pageLength)
+            {
+                break;
+            }
 
-        IBuffer requestedBuffer = CreateTrimmedBuffer(
-            constructedBuffer,
-            (UINT32)trimmedBufferStartRelativeIndex, // Conversion is safe as buffer size is a UINT32.
-            requestedSize);
+            UINT32 bytesToCopy = std::min(pageLength - startIndex, requestedSize - bytesWritten);
+            memcpy(destination + bytesWritten, GetBufferBytes(page) + startIndex, bytesToCopy);
+            bytesWritten += bytesToCopy;
+            startIndex = 0;
 
+            // Only the last page of the file is shorter than the page size
+            if (pageLength < m_pageSize)
+            {
+                break;
+            }
+        }
+
+        requestedBuffer.Length(bytesWritten);
         return requestedBuffer;
     }
 
@@ -150,12 +301,61 @@ namespace AppInstaller::Utility::HttpStream
         HttpClientWrapper* httpClientWrapper,
         InputStreamOptions httpInputStreamOptions)
     {
-        // Determine the download job
-        // To make things easy, we will download the contiguous range that includes all the unsatisfiable ranges.
-        // Note that in theory, this may include cached pages. However, this situation is rarely expected to happen,
-        // if at all. The package reader usually reads things in chunks of 64 KB or less, so, we should expect to 
-        // always have up to two satisfiable and unsatisfiable pages in total.
         UINT64 fileSize = httpClientWrapper->GetFullFileSize();
+
+        // Merge adjacent missing pages into runs; when there are cached pages between the runs,
+        // request all of them at once rather than downloading the cached pages again.
+        std::vector<std::pair<ULONG64, UINT32>> missingRanges;
+        for (ULONG64 page : unsatisfiablePages)
+        {
+            ULONG64 pageEnd = 0U;
+            winrt::check_hresult(ULong64Add(page, m_pageSize, &pageEnd));
+            pageEnd = std::min(pageEnd, fileSize);
+
+            if (pageEnd <= page)
+            {
+                continue;
+            }
+
+            if (!missingRanges.empty() && missingRanges.back().first + missingRanges.back().second == page)
+            {
+                missingRanges.back().second += static_cast<UINT32>(pageEnd - page);
+            }
+            else
+            {
+                missingRanges.emplace_back(page, static_cast<UINT32>(pageEnd - page));
+            }
+        }
+
+        if (missingRanges.size() > 1 && !m_multipleRangesUnsupported)
+        {
+            std::vector<std::pair<ULONG64, IBuffer>> downloadedParts;
+
+            try
+            {
+                downloadedParts = co_await httpClientWrapper->DownloadRangesAsync(missingRanges, httpInputStreamOptions);
+            }
+            catch (...)
+            {
+                // Not all servers support multiple ranges in a single request; fall back to a single range from here on
+                AICLI_LOG(Core, Info, << "Request for multiple ranges failed; using single range requests");
+                m_multipleRangesUnsupported = true;
+            }
+
+            if (!m_multipleRangesUnsupported)
+            {
+                for (const auto& part : downloadedParts)
+                {
+                    SaveBufferToCache(part.second, part.first);
+                }
+
+                co_return;
+            }
+        }
+
+        // Determine the download job
+        // Download the contiguous range that includes all the unsatisfiable ranges. This may include cached pages,
+        // but only when the server does not support requests for multiple ranges.
         ULONG64 downloadJobStartPosition = 0U;
         ULONG64 downloadJobEndPosition = 0U;
         ULONG64 downloadJobSize = 0U;
@@ -163,7 +363,7 @@ namespace AppInstaller::Utility::HttpStream
         {
             downloadJobStartPosition = unsatisfiablePages[0];
             ULONG64 lastUnsatisfiableJob = unsatisfiablePages[unsatisfiablePages.size() - 1];
-            winrt::check_hresult(ULong64Add(lastUnsatisfiableJob, PAGE_SIZE, &downloadJobEndPosition));
+            winrt::check_hresult(ULong64Add(lastUnsatisfiableJob, m_pageSize, &downloadJobEndPosition));
 
             // make sure to not overflow file size
             downloadJobEndPosition = std::min(downloadJobEndPosition, fileSize);
@@ -201,7 +401,7 @@ namespace AppInstaller::Utility::HttpStream
 
         for (auto pageIter = orderedPageOffsets.begin(); pageIter != orderedPageOffsets.end(); pageIter++)
         {
-            if (m_localCache.size() > MAX_PAGES)
+            if (m_localCache.size() > m_maxPages)
             {
                 m_localCache.erase(pageIter->first);
             }
@@ -217,14 +417,7 @@ namespace AppInstaller::Utility::HttpStream
         UINT32 trimStartIndex,
         UINT32 size)
     {
-        originalBuffer.as<::IInspectable>();
-
-        // Get the byte array from the IBuffer object
-        Microsoft::WRL::ComPtr<IBufferByteAccess> bufferByteAccess;
-        ::IInspectable* bufferAbi = (::IInspectable*)winrt::get_abi(originalBuffer);
-        bufferAbi->QueryInterface(IID_PPV_ARGS(&bufferByteAccess));
-        byte* byteBuffer = nullptr;
-        bufferByteAccess->Buffer(&byteBuffer);
+        byte* byteBuffer = GetBufferBytes(originalBuffer);
 
         // Create the array of bytes holding the trimmed bytes
         IBuffer trimmedBuffer = CryptographicBuffer::CreateFromByteArray(
@@ -232,12 +425,4 @@ namespace AppInstaller::Utility::HttpStream
 
         return trimmedBuffer;
     }
-
-    IBuffer HttpLocalCache::ConcatenateBuffers(const IBuffer& buffer1, const IBuffer& buffer2)
-    {
-        DataWriter writer;
-        writer.WriteBuffer(buffer1);
-        writer.WriteBuffer(buffer2);
-        return writer.DetachBuffer();
-    }
 }
\ No newline at end of file
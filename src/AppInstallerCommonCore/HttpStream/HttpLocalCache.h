@@ -4,6 +4,7 @@
 #pragma once
 
 #include "HttpClientWrapper.h"
+#include "HttpDiskCache.h"
 
 namespace AppInstaller::Utility::HttpStream
 {
@@ -18,8 +19,11 @@ namespace AppInstaller::Utility::HttpStream
     class HttpLocalCache
     {
     public:
-        const UINT32 PAGE_SIZE = 2 << 16;   // each entry in the cache is 64 KB
-        const UINT32 MAX_PAGES = 200;       // cache size capped at 12.5 MB (200 * 64KB)
+        static constexpr UINT32 DEFAULT_PAGE_SIZE = 2 << 16;    // each entry in the cache is 128 KB
+        static constexpr UINT32 DEFAULT_MAX_PAGES = 200;        // cache size capped at 25 MB (200 * 128KB)
+
+        // When given, the disk cache is checked for pages missing from memory, and downloaded pages are saved to it.
+        HttpLocalCache(UINT32 pageSize = DEFAULT_PAGE_SIZE, UINT32 maxPages = DEFAULT_MAX_PAGES, std::unique_ptr<HttpDiskCache> diskCache = {});
 
         // Returns a buffer matching the requested range by reading the parts of the range that are cached
         // and downloading the rest using the provided httpClientWrapper object
@@ -30,9 +34,31 @@ namespace AppInstaller::Utility::HttpStream
             winrt::Windows::Storage::Streams::InputStreamOptions httpInputStreamOptions);
 
     private:
+        const UINT32 m_pageSize;
+        const UINT32 m_maxPages;
+        std::unique_ptr<HttpDiskCache> m_diskCache;
+
         std::map<ULONG64, CachedPage> m_localCache;
         UINT32 m_accessCounter = 0U;
 
+        // State used to detect sequential reads and grow the read ahead for them
+        ULONG64 m_lastRequestEndPosition = 0U;
+        UINT32 m_readAheadPages = 0U;
+
+        // Set once the server has failed a request for multiple ranges
+        bool m_multipleRangesUnsupported = false;
+
+        // Updates the sequential read state for the request and returns the number of pages to read ahead.
+        UINT32 UpdateReadAhead(const ULONG64 requestedPosition, const UINT32 requestedSize);
+
+        // Adds the missing pages that follow the requested range to the unsatisfiable pages, up to the given count,
+        // stopping at the first page that is already cached or at the end of the file.
+        void AddReadAheadPages(
+            const ULONG64 lastRequestedPage,
+            const UINT32 readAheadPages,
+            const ULONG64 fileSize,
+            std::vector<ULONG64>& unsatisfiablePages);
+
         // Returns a vector of all pages corresponding to a range, and another (subset)
         // vector of the pages missing from the cache.
         void FindCachePages(
@@ -41,6 +67,9 @@ namespace AppInstaller::Utility::HttpStream
             std::vector<ULONG64>& allPages,
             std::vector<ULONG64>& unsatisfiablePages);
 
+        // Moves the pages found in the disk cache into memory, and removes them from the unsatisfiable pages.
+        void LoadPagesFromDiskCache(std::vector<ULONG64>& unsatisfiablePages);
+
         void SaveBufferToCache(const winrt::Windows::Storage::Streams::IBuffer& buffer, const ULONG64 firstPageOffset);
 
         winrt::Windows::Storage::Streams::IBuffer ReadPageFromCache(const ULONG64 pageOffset);
@@ -52,19 +81,14 @@ namespace AppInstaller::Utility::HttpStream
             HttpClientWrapper* httpClientWrapper,
             const winrt::Windows::Storage::Streams::InputStreamOptions httpInputStreamOptions);
 
-        winrt::Windows::Storage::Streams::IBuffer TrimBufferToSatisfyRequest(
-            const winrt::Windows::Storage::Streams::IBuffer& constructedBuffer,
+        winrt::Windows::Storage::Streams::IBuffer ReadRangeFromCache(
             const ULONG64 requestedPosition,
             const UINT32 requestedSize,
-            const std::vector<ULONG64> allPages);
+            const std::vector<ULONG64>& allPages);
 
         winrt::Windows::Storage::Streams::IBuffer CreateTrimmedBuffer(
             const winrt::Windows::Storage::Streams::IBuffer& originalBuffer,
             UINT32 trimStartIndex,
             UINT32 size);
-
-        winrt::Windows::Storage::Streams::IBuffer ConcatenateBuffers(
-            const winrt::Windows::Storage::Streams::IBuffer& buffer1,
-            const winrt::Windows::Storage::Streams::IBuffer& buffer2);
     };
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "pch.h"
 #include "HttpRandomAccessStream.h"
+#include "Public/winget/MemoryBudget.h"
+#include "Public/winget/UserSettings.h"
 
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::Storage::Streams;
@@ -13,15 +15,43 @@ using namespace winrt::Windows::Storage::Streams;
 namespace AppInstaller::Utility::HttpStream
 {
     IAsyncOperation<IRandomAccessStream> HttpRandomAccessStream::CreateAsync(const Uri& uri)
+    {
+        UINT32 cachePageSize = Settings::User().Get<Settings::Setting::PackageReadCachePageSizeInKB>() * 1024;
+        UINT32 cacheMaxPages = Settings::User().Get<Settings::Setting::PackageReadCacheMaximumPages>();
+
+        auto cacheLimit = Performance::GetPackageReadCacheLimit();
+        if (cacheLimit)
+        {
+            cacheMaxPages = static_cast<UINT32>(std::clamp<uint64_t>(*cacheLimit / cachePageSize, 1, cacheMaxPages));
+        }
+
+        ULONG64 diskCacheSize = static_cast<ULONG64>(Settings::User().Get<Settings::Setting::PackageReadCacheDiskSizeInMB>()) * 1024 * 1024;
+
+        return CreateAsync(uri, cachePageSize, cacheMaxPages, diskCacheSize);
+    }
+
+    IAsyncOperation<IRandomAccessStream> HttpRandomAccessStream::CreateAsync(const Uri& uri, UINT32 cachePageSize, UINT32 cacheMaxPages, ULONG64 diskCacheSize)
     {
         winrt::com_ptr<HttpRandomAccessStream> stream = winrt::make_self<HttpRandomAccessStream>();
 
         stream->m_httpHelper = co_await HttpClientWrapper::CreateAsync(uri);
         stream->m_size = stream->m_httpHelper->GetFullFileSize();
-        stream->m_httpLocalCache = std::make_unique<HttpLocalCache>();
 
-        co_return stream.as<IRandomAccessStream>();
+        std::unique_ptr<HttpDiskCache> diskCache;
+        if (diskCacheSize > 0)
+        {
+            diskCache = HttpDiskCache::Create(
+                HttpDiskCache::GetDefaultRoot(),
+                std::wstring_view{ uri.AbsoluteUri() },
+                stream->m_httpHelper->GetETag(),
+                stream->m_size,
+                cachePageSize,
+                diskCacheSize);
+        }
 
+        stream->m_httpLocalCache = std::make_unique<HttpLocalCache>(cachePageSize, cacheMaxPages, std::move(diskCache));
+
+        co_return stream.as<IRandomAccessStream>();
     }
 
     uint64_t HttpRandomAccessStream::Size() const
@@ -19,6 +19,15 @@ namespace AppInstaller::Utility::HttpStream
     public:
         static winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Storage::Streams::IRandomAccessStream> CreateAsync(
             const winrt::Windows::Foundation::Uri& uri);
+
+        // Creates the stream with the given local cache policy, rather than that of the user settings.
+        // The disk cache is only used when its size is not 0.
+        static winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Storage::Streams::IRandomAccessStream> CreateAsync(
+            const winrt::Windows::Foundation::Uri& uri,
+            UINT32 cachePageSize,
+            UINT32 cacheMaxPages,
+            ULONG64 diskCacheSize = 0);
+
         uint64_t Size() const;
         void Size(uint64_t value);
         uint64_t Position() const;
@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/InstallerCache.h"
+#include "Public/winget/UserSettings.h"
+#include "Public/winget/PerformanceCounters.h"
+#include "Public/AppInstallerErrors.h"
+#include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerStrings.h"
+
+
+namespace AppInstaller::Utility
+{
+    namespace
+    {
+        // Files being added are written with this extension, then renamed into place.
+        constexpr std::wstring_view s_InstallerCache_PartialExtension = L".partial";
+
+        // Partial files older than this were left by an interrupted add and can be removed.
+        constexpr auto s_InstallerCache_AbandonedPartialAge = std::chrono::hours(24);
+
+        // Determines whether the file name is that of a complete cache entry (the hash string).
+        bool IsEntryFileName(const std::filesystem::path& path)
+        {
+            return path.filename().native().length() == SHA256::HashStringSizeInChars && !path.has_extension();
+        }
+    }
+
+    InstallerCache::InstallerCache(std::filesystem::path root, uint64_t maximumSizeInBytes) :
+        m_root(std::move(root)), m_maximumSizeInBytes(maximumSizeInBytes)
+    {
+        THROW_HR_IF(E_INVALIDARG, m_root.empty());
+    }
+
+    std::optional<InstallerCache> InstallerCache::GetUserCache()
+    {
+        const std::string& location = Settings::User().Get<Settings::Setting::InstallerCacheLocation>();
+        if (location.empty())
+        {
+            return {};
+        }
+
+        uint64_t maximumSize = static_cast<uint64_t>(Settings::User().Get<Settings::Setting::InstallerCacheMaximumSizeInMB>()) * 1024 * 1024;
+        return InstallerCache{ ConvertToUTF16(location), maximumSize };
+    }
+
+    bool InstallerCache::TryGet(const SHA256::HashBuffer& hash, const std::filesystem::path& target) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(hash);
+
+        std::error_code error;
+        if (!std::filesystem::exists(entryPath, error))
+        {
+            AICLI_LOG(Core, Verbose, << "Installer cache miss for " << SHA256::ConvertToString(hash));
+            Performance::Counters::RecordInstallerCacheLookup(false);
+            return false;
+        }
+
+        AICLI_LOG(Core, Info, << "Installer cache hit for " << SHA256::ConvertToString(hash) << " at " << entryPath);
+
+        // Entries can be removed by another machine at any point, so failures are cache misses
+        try
+        {
+            std::filesystem::copy_file(entryPath, target, std::filesystem::copy_options::overwrite_existing);
+        }
+        catch (const std::exception& e)
+        {
+            AICLI_LOG(Core, Warning, << "Failed to copy installer from cache: " << e.what());
+            Performance::Counters::RecordInstallerCacheLookup(false);
+            return false;
+        }
+
+        // Verify the copy rather than the entry, so that what is used is what was checked
+        SHA256::HashBuffer copyHash = SHA256::ComputeHashFromFile(target);
+
+        if (!SHA256::AreEqual(hash, copyHash))
+        {
+            AICLI_LOG(Core, Warning, << "Cached installer does not match its hash; removing " << entryPath);
+            std::filesystem::remove(target, error);
+            std::filesystem::remove(entryPath, error);
+            Performance::Counters::RecordInstallerCacheLookup(false);
+            return false;
+        }
+
+        // The last write time of an entry serves as its last use time for eviction
+        std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+
+        Performance::Counters::RecordInstallerCacheLookup(true, std::filesystem::file_size(target, error));
+        return true;
+    }
+
+    void InstallerCache::Add(const SHA256::HashBuffer& hash, const std::filesystem::path& source) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(hash);
+
+        std::error_code error;
+        if (std::filesystem::exists(entryPath, error))
+        {
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+            return;
+        }
+
+        std::filesystem::create_directories(entryPath.parent_path());
+
+        // Copy to a unique name and rename into place, so that readers never see a partial entry
+        GUID partialName;
+        THROW_IF_FAILED(CoCreateGuid(&partialName));
+        wchar_t partialNameBuffer[256];
+        THROW_HR_IF(E_UNEXPECTED, StringFromGUID2(partialName, partialNameBuffer, ARRAYSIZE(partialNameBuffer)) == 0);
+
+        std::filesystem::path partialPath = entryPath;
+        partialPath += L'.';
+        partialPath += partialNameBuffer;
+        partialPath += s_InstallerCache_PartialExtension;
+
+        std::filesystem::copy_file(source, partialPath, std::filesystem::copy_options::overwrite_existing);
+
+        std::filesystem::rename(partialPath, entryPath, error);
+        if (error)
+        {
+            // Most likely another machine added the same entry first
+            AICLI_LOG(Core, Info, << "Installer cache entry was not added: " << error.message());
+            std::filesystem::remove(partialPath, error);
+        }
+        else
+        {
+            // Copying keeps the last write time of the source, which would make the new entry look unused
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+            AICLI_LOG(Core, Info, << "Added installer to cache: " << entryPath);
+        }
+
+        Trim();
+    }
+
+    void InstallerCache::Trim() const
+    {
+        struct Entry
+        {
+            std::filesystem::path Path;
+            uint64_t Size;
+            std::filesystem::file_time_type LastUsed;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t totalSize = 0;
+
+        std::error_code error;
+        for (const auto& file : std::filesystem::recursive_directory_iterator{ m_root, error })
+        {
+            if (!file.is_regular_file(error))
+            {
+                continue;
+            }
+
+            if (file.path().extension() == s_InstallerCache_PartialExtension)
+            {
+                auto lastWrite = file.last_write_time(error);
+                if (!error && lastWrite + s_InstallerCache_AbandonedPartialAge < std::filesystem::file_time_type::clock::now())
+                {
+                    std::filesystem::remove(file.path(), error);
+                }
+
+                continue;
+            }
+
+            if (!IsEntryFileName(file.path()))
+            {
+                continue;
+            }
+
+            Entry entry{ file.path(), file.file_size(error), file.last_write_time(error) };
+            if (error)
+            {
+                continue;
+            }
+
+            totalSize += entry.Size;
+            entries.emplace_back(std::move(entry));
+        }
+
+        if (totalSize <= m_maximumSizeInBytes)
+        {
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.LastUsed < b.LastUsed; });
+
+        for (const auto& entry : entries)
+        {
+            if (totalSize <= m_maximumSizeInBytes)
+            {
+                break;
+            }
+
+            AICLI_LOG(Core, Info, << "Evicting installer from cache: " << entry.Path);
+            if (std::filesystem::remove(entry.Path, error) || !std::filesystem::exists(entry.Path, error))
+            {
+                totalSize -= entry.Size;
+            }
+        }
+    }
+
+    std::filesystem::path InstallerCache::GetEntryPath(const SHA256::HashBuffer& hash) const
+    {
+        THROW_HR_IF(E_INVALIDARG, hash.size() != SHA256::HashBufferSizeInBytes);
+
+        // Spread the entries over subdirectories named for the first byte of the hash
+        std::string hashString = SHA256::ConvertToString(hash);
+        return m_root / hashString.substr(0, 2) / hashString;
+    }
+}
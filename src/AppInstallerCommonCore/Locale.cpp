@@ -54,6 +54,73 @@ namespace AppInstaller::Locale
                 InterlockedExchangePointer(reinterpret_cast<PVOID*>(&g_bcp47), module);
             }
         }
+
+        double GetDistanceOfLanguageFromSystem(std::string_view target, std::string_view available)
+        {
+            // Before new SDK is released, we need to use LoadLibrary/GetProcAddress
+            InitializeBcp47Module();
+
+            if (g_bcp47 == nullptr)
+            {
+                // Didn't find an implementation. Just return 0 as no match.
+                AICLI_LOG(Core, Warning, << "bcp47 module not found.");
+                return 0;
+            }
+
+            GetDistanceOfClosestLanguageInListFunc func =
+                (GetDistanceOfClosestLanguageInListFunc)(GetProcAddress(g_bcp47, "GetDistanceOfClosestLanguageInList"));
+            if (func != nullptr)
+            {
+                double distance = 0;
+                auto wTarget = Utility::ConvertToUTF16(target);
+                auto wAvailable = Utility::ConvertToUTF16(available);
+
+                // Do not check HRESULT because the method returns ERROR_NO_MATCH on no match, which is a valid case.
+                (void)func(wTarget.c_str(), wAvailable.c_str(), L';' /* Not used, we compare one at a time */, &distance);
+                return distance;
+            }
+
+            // Should not reach here.
+            return 0;
+        }
+
+        // Caches the distance between pairs of languages for the life of the process, as each one is a call into the system
+        // and the same few pairs are compared for every installer of every package that is considered.
+        struct LanguageDistanceCache
+        {
+            static LanguageDistanceCache& Instance()
+            {
+                static LanguageDistanceCache s_instance;
+                return s_instance;
+            }
+
+            double GetDistance(std::string_view target, std::string_view available)
+            {
+                // Language tags are not case sensitive.
+                std::string key = Utility::ToLower(target);
+                key += '\0';
+                key += Utility::ToLower(available);
+
+                {
+                    auto lock = m_lock.lock_shared();
+                    auto itr = m_distances.find(key);
+                    if (itr != m_distances.end())
+                    {
+                        return itr->second;
+                    }
+                }
+
+                double distance = GetDistanceOfLanguageFromSystem(target, available);
+
+                auto lock = m_lock.lock_exclusive();
+                m_distances.emplace(std::move(key), distance);
+                return distance;
+            }
+
+        private:
+            wil::srwlock m_lock;
+            std::unordered_map<std::string, double> m_distances;
+        };
     }
 
     bool IsWellFormedBcp47Tag(std::string_view bcp47Tag)
@@ -81,31 +148,7 @@ namespace AppInstaller::Locale
 
     double GetDistanceOfLanguage(std::string_view target, std::string_view available)
     {
-        // Before new SDK is released, we need to use LoadLibrary/GetProcAddress
-        InitializeBcp47Module();
-
-        if (g_bcp47 == nullptr)
-        {
-            // Didn't find an implementation. Just return 0 as no match.
-            AICLI_LOG(Core, Warning, << "bcp47 module not found.");
-            return 0;
-        }
-
-        GetDistanceOfClosestLanguageInListFunc func =
-            (GetDistanceOfClosestLanguageInListFunc)(GetProcAddress(g_bcp47, "GetDistanceOfClosestLanguageInList"));
-        if (func != nullptr)
-        {
-            double distance = 0;
-            auto wTarget = Utility::ConvertToUTF16(target);
-            auto wAvailable = Utility::ConvertToUTF16(available);
-
-            // Do not check HRESULT because the method returns ERROR_NO_MATCH on no match, which is a valid case.
-            (void)func(wTarget.c_str(), wAvailable.c_str(), L';' /* Not used, we compare one at a time */, &distance);
-            return distance;
-        }
-
-        // Should not reach here.
-        return 0;
+        return LanguageDistanceCache::Instance().GetDistance(target, available);
     }
 
     std::vector<std::string> GetUserPreferredLanguages()
@@ -94,111 +94,111 @@ namespace AppInstaller::Manifest::YamlParser
 
             return result;
         }
-    }
 
-    Json::Value LoadSchemaDoc(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
-    {
-        std::string schemaStr;
-        
-        if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_2 })
+        // Gets the resource id of the schema for the given manifest version and type.
+        int GetSchemaResourceId(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
         {
-            switch (manifestType)
+            if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_2 })
             {
-            case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_2_SINGLETON), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Version:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_2_VERSION), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Installer:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_2_INSTALLER), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_2_DEFAULTLOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Locale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_2_LOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            default:
-                THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                switch (manifestType)
+                {
+                case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
+                    return IDX_MANIFEST_SCHEMA_V1_2_SINGLETON;
+                case AppInstaller::Manifest::ManifestTypeEnum::Version:
+                    return IDX_MANIFEST_SCHEMA_V1_2_VERSION;
+                case AppInstaller::Manifest::ManifestTypeEnum::Installer:
+                    return IDX_MANIFEST_SCHEMA_V1_2_INSTALLER;
+                case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
+                    return IDX_MANIFEST_SCHEMA_V1_2_DEFAULTLOCALE;
+                case AppInstaller::Manifest::ManifestTypeEnum::Locale:
+                    return IDX_MANIFEST_SCHEMA_V1_2_LOCALE;
+                default:
+                    THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                }
             }
-        }
-        else if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_1 })
-        {
-            switch (manifestType)
+            else if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_1 })
             {
-            case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_SINGLETON), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Version:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_VERSION), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Installer:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_INSTALLER), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_DEFAULTLOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Locale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_LOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            default:
-                THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                switch (manifestType)
+                {
+                case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
+                    return IDX_MANIFEST_SCHEMA_V1_1_SINGLETON;
+                case AppInstaller::Manifest::ManifestTypeEnum::Version:
+                    return IDX_MANIFEST_SCHEMA_V1_1_VERSION;
+                case AppInstaller::Manifest::ManifestTypeEnum::Installer:
+                    return IDX_MANIFEST_SCHEMA_V1_1_INSTALLER;
+                case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
+                    return IDX_MANIFEST_SCHEMA_V1_1_DEFAULTLOCALE;
+                case AppInstaller::Manifest::ManifestTypeEnum::Locale:
+                    return IDX_MANIFEST_SCHEMA_V1_1_LOCALE;
+                default:
+                    THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                }
             }
-        }
-        else if (manifestVersion >= ManifestVer{ s_ManifestVersionV1 })
-        {
-            switch (manifestType)
+            else if (manifestVersion >= ManifestVer{ s_ManifestVersionV1 })
+            {
+                switch (manifestType)
+                {
+                case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
+                    return IDX_MANIFEST_SCHEMA_V1_SINGLETON;
+                case AppInstaller::Manifest::ManifestTypeEnum::Version:
+                    return IDX_MANIFEST_SCHEMA_V1_VERSION;
+                case AppInstaller::Manifest::ManifestTypeEnum::Installer:
+                    return IDX_MANIFEST_SCHEMA_V1_INSTALLER;
+                case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
+                    return IDX_MANIFEST_SCHEMA_V1_DEFAULTLOCALE;
+                case AppInstaller::Manifest::ManifestTypeEnum::Locale:
+                    return IDX_MANIFEST_SCHEMA_V1_LOCALE;
+                default:
+                    THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                }
+            }
+            else
             {
-            case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_SINGLETON), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Version:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_VERSION), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Installer:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_INSTALLER), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_DEFAULTLOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Locale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_LOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            default:
-                THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                return IDX_MANIFEST_SCHEMA_PREVIEW;
             }
         }
-        else
+
+        // Gets the compiled schema for the given manifest version and type.
+        // Compiling a schema is far more expensive than validating against it, and a compiled schema is not
+        // modified by validation, so each one is compiled once and shared by every validation in the process.
+        std::shared_ptr<const valijson::Schema> GetCompiledSchema(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
         {
-            schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_PREVIEW), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
+            static std::mutex s_lock;
+            static std::map<int, std::shared_ptr<const valijson::Schema>> s_schemas;
+
+            int resourceId = GetSchemaResourceId(manifestVersion, manifestType);
+
+            std::lock_guard<std::mutex> lock{ s_lock };
+
+            auto itr = s_schemas.find(resourceId);
+            if (itr != s_schemas.end())
+            {
+                return itr->second;
+            }
+
+            auto schema = std::make_shared<valijson::Schema>();
+            JsonSchema::PopulateSchema(JsonSchema::LoadResourceAsSchemaDoc(MAKEINTRESOURCE(resourceId), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE)), *schema);
+
+            return s_schemas.emplace(resourceId, std::move(schema)).first->second;
         }
+    }
 
-        return JsonSchema::LoadSchemaDoc(schemaStr);
+    Json::Value LoadSchemaDoc(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
+    {
+        return JsonSchema::LoadResourceAsSchemaDoc(MAKEINTRESOURCE(GetSchemaResourceId(manifestVersion, manifestType)), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
     }
 
     std::vector<ValidationError> ValidateAgainstSchema(const std::vector<YamlManifestInfo>& manifestList, const ManifestVer& manifestVersion)
     {
         std::vector<ValidationError> errors;
-        // A list of schema validator to avoid multiple loadings of same schema
-        std::map<ManifestTypeEnum, valijson::Schema> schemaList;
 
         for (const auto& entry : manifestList)
         {
-            if (schemaList.find(entry.ManifestType) == schemaList.end())
-            {
-                // Copy constructor of valijson::Schema was private
-                valijson::Schema& newSchema = schemaList.emplace(
-                    std::piecewise_construct, std::make_tuple(entry.ManifestType), std::make_tuple()).first->second;
-                Json::Value schemaJson = LoadSchemaDoc(manifestVersion, entry.ManifestType);
-                JsonSchema::PopulateSchema(schemaJson, newSchema);
-            }
-
-            const auto& schema = schemaList.find(entry.ManifestType)->second;
+            auto schema = GetCompiledSchema(manifestVersion, entry.ManifestType);
             Json::Value manifestJson = ManifestYamlNodeToJson(entry.Root);
             valijson::ValidationResults results;
 
-            if (!JsonSchema::Validate(schema, manifestJson, results))
+            if (!JsonSchema::Validate(*schema, manifestJson, results))
             {
                 errors.emplace_back(ValidationError::MessageWithFile(JsonSchema::GetErrorStringFromResults(results), entry.FileName));
             }
@@ -206,4 +206,4 @@ namespace AppInstaller::Manifest::YamlParser
 
         return errors;
     }
-}
\ No newline at end of file
+}
@@ -7,6 +7,47 @@
 
 namespace AppInstaller::Manifest
 {
+    namespace
+    {
+        // The fields other than scope that identify an installer for uniqueness, referring to the installer rather than copying it.
+        struct InstallerKey
+        {
+            InstallerTypeEnum InstallerType;
+            Utility::Architecture Arch;
+            std::string_view Locale;
+
+            bool operator==(const InstallerKey& other) const
+            {
+                return InstallerType == other.InstallerType && Arch == other.Arch && Locale == other.Locale;
+            }
+        };
+
+        struct InstallerKeyHash
+        {
+            size_t operator()(const InstallerKey& key) const
+            {
+                size_t result = std::hash<std::string_view>{}(key.Locale);
+                result = result * 31 + static_cast<size_t>(key.InstallerType);
+                result = result * 31 + static_cast<size_t>(key.Arch);
+                return result;
+            }
+        };
+
+        // Records the scopes seen for each key, returning false if the installer duplicates one already seen.
+        // Unknown scope is considered equal to all other values for uniqueness.
+        bool AddUniqueInstaller(std::unordered_map<InstallerKey, uint32_t, InstallerKeyHash>& seenScopes, const ManifestInstaller& installer)
+        {
+            uint32_t& scopes = seenScopes[InstallerKey{ installer.InstallerType, installer.Arch, installer.Locale }];
+            uint32_t scopeBit = 1u << static_cast<uint32_t>(installer.Scope);
+            uint32_t unknownBit = 1u << static_cast<uint32_t>(ScopeEnum::Unknown);
+
+            bool duplicate = installer.Scope == ScopeEnum::Unknown ? scopes != 0 : (scopes & (scopeBit | unknownBit)) != 0;
+            scopes |= scopeBit;
+
+            return !duplicate;
+        }
+    }
+
     std::vector<ValidationError> ValidateManifest(const Manifest& manifest, bool fullValidation)
     {
         std::vector<ValidationError> resultErrors;
@@ -30,39 +71,13 @@ namespace AppInstaller::Manifest
         auto defaultLocErrors = ValidateManifestLocalization(manifest.DefaultLocalization);
         std::move(defaultLocErrors.begin(), defaultLocErrors.end(), std::inserter(resultErrors, resultErrors.end()));
 
-        // Comparison function to check duplicate installer entry. {installerType, arch, language and scope} combination is the key.
+        // Duplicate installer entries are found by the {installerType, arch, language and scope} combination.
         // Todo: use the comparator from ManifestComparator when that one is fully implemented.
-        auto installerCmp = [](const ManifestInstaller& in1, const ManifestInstaller& in2)
-        {
-            if (in1.InstallerType != in2.InstallerType)
-            {
-                return in1.InstallerType < in2.InstallerType;
-            }
-
-            if (in1.Arch != in2.Arch)
-            {
-                return in1.Arch < in2.Arch;
-            }
-
-            if (in1.Locale != in2.Locale)
-            {
-                return in1.Locale < in2.Locale;
-            }
-
-            // Unknown is considered equal to all other values for uniqueness.
-            // If either value is unknown, don't compare them.
-            if (in1.Scope != in2.Scope && in1.Scope != ScopeEnum::Unknown && in2.Scope != ScopeEnum::Unknown)
-            {
-                return in1.Scope < in2.Scope;
-            }
-
-            return false;
-        };
-
-        std::set<ManifestInstaller, decltype(installerCmp)> installerSet(installerCmp);
+        std::unordered_map<InstallerKey, uint32_t, InstallerKeyHash> installerScopes;
+        installerScopes.reserve(manifest.Installers.size());
         bool duplicateInstallerFound = false;
 
-        // Validate installers
+        // Validate installers, checking every rule in a single pass over them
         for (auto const& installer : manifest.Installers)
         {
             // If not full validation, for future compatibility, skip validating unknown installers.
@@ -71,7 +86,7 @@ namespace AppInstaller::Manifest
                 continue;
             }
 
-            if (!duplicateInstallerFound && !installerSet.insert(installer).second)
+            if (!duplicateInstallerFound && !AddUniqueInstaller(installerScopes, installer))
             {
                 AICLI_LOG(Core, Error, << "Duplicate installer: Type[" << InstallerTypeToString(installer.InstallerType) <<
                     "] Architecture[" << Utility::ToString(installer.Arch) << "] Locale[" << installer.Locale <<
@@ -170,16 +185,18 @@ namespace AppInstaller::Manifest
             }
 
             // Check expected return codes for duplicates between successful and expected error codes
-            std::set<DWORD> returnCodeSet;
-            returnCodeSet.insert(installer.InstallerSuccessCodes.begin(), installer.InstallerSuccessCodes.end());
-            for (const auto& code : installer.ExpectedReturnCodes)
+            if (!installer.ExpectedReturnCodes.empty())
             {
-                if (!returnCodeSet.insert(code.first).second)
+                std::set<DWORD> returnCodeSet{ installer.InstallerSuccessCodes.begin(), installer.InstallerSuccessCodes.end() };
+                for (const auto& code : installer.ExpectedReturnCodes)
                 {
-                    resultErrors.emplace_back(ManifestError::DuplicateReturnCodeEntry);
+                    if (!returnCodeSet.insert(code.first).second)
+                    {
+                        resultErrors.emplace_back(ManifestError::DuplicateReturnCodeEntry);
 
-                    // Stop checking to avoid repeated errors
-                    break;
+                        // Stop checking to avoid repeated errors
+                        break;
+                    }
                 }
             }
         }
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #include "pch.h"
+#include "AppInstallerLogging.h"
 #include "AppInstallerSHA256.h"
 #include "winget/ManifestYamlPopulator.h"
 
@@ -40,6 +41,23 @@ namespace AppInstaller::Manifest
             return result;
         }
 
+        // Gets the locale of a localization node without processing its other fields.
+        std::string GetLocalizationLocale(const YAML::Node& localizationNode, const ManifestVer& manifestVersion)
+        {
+            std::string_view localeField = manifestVersion.Major() == 0 ? "Language"sv : "PackageLocale"sv;
+            std::string result;
+
+            for (auto const& keyValuePair : localizationNode.Mapping())
+            {
+                if (Utility::CaseInsensitiveEquals(keyValuePair.first.as<std::string>(), localeField) && keyValuePair.second.IsScalar())
+                {
+                    result = keyValuePair.second.as<std::string>();
+                }
+            }
+
+            return result;
+        }
+
         std::vector<Manifest::string_t> ProcessStringSequenceNode(const YAML::Node& node, bool trim = true)
         {
             THROW_HR_IF(E_INVALIDARG, !node.IsSequence());
@@ -512,8 +530,8 @@ namespace AppInstaller::Manifest
             return resultErrors;
         }
 
-        // Keeps track of already processed fields. Used to check duplicate fields.
-        std::set<std::string> processedFields;
+        // Keeps track of already processed fields, by their index. Used to check duplicate fields.
+        std::vector<bool> processedFields(fieldInfos.size());
 
         for (auto const& keyValuePair : rootNode.Mapping())
         {
@@ -521,10 +539,12 @@ namespace AppInstaller::Manifest
             const YAML::Node& valueNode = keyValuePair.second;
 
             // We'll do case insensitive search first and validate correct case later.
+            // The hash is checked first, so that the names are only compared for the field that the key likely is.
+            uint64_t keyHash = HashFieldName(key);
             auto fieldIter = std::find_if(fieldInfos.begin(), fieldInfos.end(),
                 [&](auto const& s)
                 {
-                    return Utility::CaseInsensitiveEquals(s.Name, key);
+                    return s.NameHash == keyHash && Utility::CaseInsensitiveEquals(s.Name, key);
                 });
 
             if (fieldIter != fieldInfos.end())
@@ -538,10 +558,12 @@ namespace AppInstaller::Manifest
                 }
 
                 // Make sure it's not a duplicate key
-                if (!processedFields.insert(fieldInfo.Name).second)
+                size_t fieldIndex = static_cast<size_t>(fieldIter - fieldInfos.begin());
+                if (processedFields[fieldIndex])
                 {
                     resultErrors.emplace_back(ManifestError::FieldDuplicate, fieldInfo.Name, "", m_isMergedManifest ? 0 : keyValuePair.first.Mark().line, m_isMergedManifest ? 0 : keyValuePair.first.Mark().column);
                 }
+                processedFields[fieldIndex] = true;
 
                 if (fieldInfo.RequireVerifiedPublisher)
                 {
@@ -621,7 +643,7 @@ namespace AppInstaller::Manifest
         MarketsInfo markets;
         m_p_markets = &markets;
         auto errors = ValidateAndProcessFields(marketsNode, MarketsFieldInfos);
-        m_p_installer->Markets = markets;
+        m_p_installer->Markets = std::move(markets);
         return errors;
     }
 
@@ -641,7 +663,7 @@ namespace AppInstaller::Manifest
             appsAndFeaturesEntries.emplace_back(std::move(appsAndFeaturesEntry));
         }
 
-        m_p_installer->AppsAndFeaturesEntries = appsAndFeaturesEntries;
+        m_p_installer->AppsAndFeaturesEntries = std::move(appsAndFeaturesEntries);
 
         return resultErrors;
     }
@@ -666,7 +688,7 @@ namespace AppInstaller::Manifest
             }
         }
 
-        m_p_installer->ExpectedReturnCodes = returnCodes;
+        m_p_installer->ExpectedReturnCodes = std::move(returnCodes);
 
         return resultErrors;
     }
@@ -707,16 +729,35 @@ namespace AppInstaller::Manifest
         }
 
         // Populate installers
-        for (auto const& entry : m_p_installersNode->Sequence())
+        // Each installer starts from the root values, without those that are only copied in based on InstallerType
+        // or that the installer overrides; taking them out once here saves copying them into every installer to clear them.
+        ManifestInstaller installerDefaults;
+        {
+            ManifestInstaller& defaults = manifest.DefaultInstallerInfo;
+            auto packageFamilyName = std::move(defaults.PackageFamilyName);
+            auto productCode = std::move(defaults.ProductCode);
+            auto appsAndFeaturesEntries = std::move(defaults.AppsAndFeaturesEntries);
+            auto dependencies = std::move(defaults.Dependencies);
+
+            installerDefaults = defaults;
+            installerDefaults.PackageFamilyName.clear();
+            installerDefaults.ProductCode.clear();
+            installerDefaults.AppsAndFeaturesEntries.clear();
+            installerDefaults.Dependencies.Clear();
+
+            defaults.PackageFamilyName = std::move(packageFamilyName);
+            defaults.ProductCode = std::move(productCode);
+            defaults.AppsAndFeaturesEntries = std::move(appsAndFeaturesEntries);
+            defaults.Dependencies = std::move(dependencies);
+        }
+
+        const auto& installerNodes = m_p_installersNode->Sequence();
+        for (auto itr = installerNodes.begin(); itr != installerNodes.end(); ++itr)
         {
-            ManifestInstaller installer = manifest.DefaultInstallerInfo;
+            const auto& entry = *itr;
 
-            // Clear these defaults as PackageFamilyName, ProductCode, AppsAndFeaturesEntries need to be copied based on InstallerType
-            installer.PackageFamilyName.clear();
-            installer.ProductCode.clear();
-            installer.AppsAndFeaturesEntries.clear();
-            // Clear dependencies as installer overrides root dependencies
-            installer.Dependencies.Clear();
+            // The last installer can take the defaults, as no other installer needs them after it.
+            ManifestInstaller installer = (std::next(itr) == installerNodes.end()) ? std::move(installerDefaults) : installerDefaults;
 
             m_p_installer = &installer;
             auto errors = ValidateAndProcessFields(entry, InstallerFieldInfos);
@@ -746,12 +787,9 @@ namespace AppInstaller::Manifest
 
             // Populate installer default switches if not exists
             auto defaultSwitches = GetDefaultKnownSwitches(installer.InstallerType);
-            for (auto const& defaultSwitch : defaultSwitches)
+            for (auto& defaultSwitch : defaultSwitches)
             {
-                if (installer.Switches.find(defaultSwitch.first) == installer.Switches.end())
-                {
-                    installer.Switches[defaultSwitch.first] = defaultSwitch.second;
-                }
+                installer.Switches.try_emplace(defaultSwitch.first, std::move(defaultSwitch.second));
             }
 
             // Populate installer default return codes if not present in ExpectedReturnCodes and InstallerSuccessCodes
@@ -771,19 +809,68 @@ namespace AppInstaller::Manifest
         // Populate additional localizations
         if (m_p_localizationsNode && m_p_localizationsNode->IsSequence())
         {
-            for (auto const& entry : m_p_localizationsNode->Sequence())
+            // Usually only the localization that best matches the user's locale is read, so unless the errors are wanted,
+            // only the locale is read here and the rest of each localization is populated on first use.
+            std::shared_ptr<const YAML::Node> deferredNodes;
+            if (!m_validateOption.FullValidation && !m_validateOption.ThrowOnWarning && !m_validateOption.ErrorOnVerifiedPublisherFields)
+            {
+                deferredNodes = std::make_shared<const YAML::Node>(*m_p_localizationsNode);
+            }
+
+            const auto& localizationNodes = m_p_localizationsNode->Sequence();
+            for (size_t i = 0; i < localizationNodes.size(); ++i)
             {
+                const auto& entry = localizationNodes[i];
                 ManifestLocalization localization;
-                m_p_localization = &localization;
-                auto errors = ValidateAndProcessFields(entry, LocalizationFieldInfos);
-                std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
-                manifest.Localizations.emplace_back(std::move(std::move(localization)));
+
+                if (deferredNodes && entry.IsMap() && entry.size() != 0)
+                {
+                    localization.Locale = GetLocalizationLocale(entry, manifestVersion);
+                    localization.SetDeferredData(
+                        [deferredNodes, i, manifestVersion, validateOption = m_validateOption, isMergedManifest = m_isMergedManifest](ManifestLocalization& target)
+                        {
+                            PopulateLocalization(deferredNodes->Sequence()[i], target, manifestVersion, validateOption, isMergedManifest);
+                        });
+                }
+                else
+                {
+                    m_p_localization = &localization;
+                    auto errors = ValidateAndProcessFields(entry, LocalizationFieldInfos);
+                    std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
+                }
+
+                manifest.Localizations.emplace_back(std::move(localization));
             }
         }
 
         return resultErrors;
     }
 
+    void ManifestYamlPopulator::PopulateLocalization(
+        const YAML::Node& localizationNode,
+        ManifestLocalization& localization,
+        const ManifestVer& manifestVersion,
+        ManifestValidateOption validateOption,
+        bool isMergedManifest)
+    {
+        ManifestYamlPopulator populator;
+        populator.m_validateOption = validateOption;
+        populator.m_isMergedManifest = isMergedManifest;
+        populator.LocalizationFieldInfos = populator.GetLocalizationFieldProcessInfo(manifestVersion);
+        populator.AgreementFieldInfos = populator.GetAgreementFieldProcessInfo(manifestVersion);
+        populator.m_p_localization = &localization;
+
+        // The manifest has already been returned by now, so errors can only be logged.
+        auto errors = populator.ValidateAndProcessFields(localizationNode, populator.LocalizationFieldInfos);
+        for (const auto& error : errors)
+        {
+            if (error.ErrorLevel == ValidationError::Level::Error)
+            {
+                AICLI_LOG(Core, Warning, << "Error populating localization: " << error.Message << " Field: " << error.Field << " Value: " << error.Value);
+            }
+        }
+    }
+
     ValidationErrors ManifestYamlPopulator::PopulateManifest(
         const YAML::Node& rootNode,
         Manifest& manifest,
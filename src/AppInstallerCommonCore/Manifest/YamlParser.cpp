@@ -6,6 +6,7 @@
 #include "winget/ManifestSchemaValidation.h"
 #include "winget/ManifestYamlPopulator.h"
 #include "winget/ManifestYamlParser.h"
+#include "winget/ThreadGlobals.h"
 
 namespace AppInstaller::Manifest::YamlParser
 {
@@ -466,14 +467,72 @@ namespace AppInstaller::Manifest::YamlParser
         {
             if (std::filesystem::is_directory(inputPath))
             {
+                std::vector<std::filesystem::path> files;
                 for (const auto& file : std::filesystem::directory_iterator(inputPath))
                 {
                     THROW_HR_IF_MSG(HRESULT_FROM_WIN32(ERROR_DIRECTORY_NOT_SUPPORTED), std::filesystem::is_directory(file.path()), "Subdirectory not supported in manifest path");
+                    files.emplace_back(file.path());
+                }
+
+                // Loading the documents is independent for each file, so it is done in parallel.
+                // The list keeps the directory order so that merging and validation results do not depend on thread scheduling.
+                docList.resize(files.size());
+                std::vector<std::exception_ptr> failures(files.size());
+                std::atomic<size_t> nextFile = 0;
+
+                auto loadFiles = [&]()
+                {
+                    for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+                    {
+                        try
+                        {
+                            docList[i].Root = YAML::Load(files[i]);
+                            docList[i].FileName = files[i].filename().u8string();
+                        }
+                        catch (...)
+                        {
+                            failures[i] = std::current_exception();
+                        }
+                    }
+                };
+
+                size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), files.size());
+                ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+                std::vector<std::thread> threads;
+                for (size_t i = 1; i < threadCount; ++i)
+                {
+                    std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+                    if (parentThreadGlobals)
+                    {
+                        threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+                    }
 
-                    YamlManifestInfo doc;
-                    doc.Root = YAML::Load(file.path());
-                    doc.FileName = file.path().filename().u8string();
-                    docList.emplace_back(std::move(doc));
+                    threads.emplace_back([&, threadGlobals]()
+                        {
+                            std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                            if (threadGlobals)
+                            {
+                                previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                            }
+
+                            loadFiles();
+                        });
+                }
+
+                loadFiles();
+
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+
+                // Report the first failure in directory order, as the sequential load would have.
+                for (const auto& failure : failures)
+                {
+                    if (failure)
+                    {
+                        std::rethrow_exception(failure);
+                    }
                 }
             }
             else
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/MemoryBudget.h"
+#include "Public/winget/UserSettings.h"
+#include "Public/AppInstallerLogging.h"
+
+#include <Psapi.h>
+
+
+namespace AppInstaller::Performance
+{
+    namespace
+    {
+        // The share of the budget given to each cache.
+        constexpr uint64_t s_SQLiteCacheBudgetDivisor = 1024;
+        constexpr uint64_t s_PackageReadCacheBudgetDivisor = 64;
+
+        // The SQLite default is 2000 KiB; the budget only ever lowers it.
+        constexpr uint32_t s_MinimumSQLiteCacheSizeInKB = 128;
+        constexpr uint32_t s_MaximumSQLiteCacheSizeInKB = 2000;
+    }
+
+    std::optional<uint64_t> GetMemoryBudget()
+    {
+        uint32_t budgetInMB = Settings::User().Get<Settings::Setting::MemoryBudgetInMB>();
+        if (budgetInMB == 0)
+        {
+            return {};
+        }
+
+        return static_cast<uint64_t>(budgetInMB) * 1024 * 1024;
+    }
+
+    std::optional<uint32_t> GetSQLiteCacheSizeLimitInKB()
+    {
+        auto budget = GetMemoryBudget();
+        if (!budget)
+        {
+            return {};
+        }
+
+        uint64_t limit = *budget / s_SQLiteCacheBudgetDivisor / 1024;
+        return static_cast<uint32_t>(std::clamp<uint64_t>(limit, s_MinimumSQLiteCacheSizeInKB, s_MaximumSQLiteCacheSizeInKB));
+    }
+
+    std::optional<uint64_t> GetPackageReadCacheLimit()
+    {
+        auto budget = GetMemoryBudget();
+        if (!budget)
+        {
+            return {};
+        }
+
+        return *budget / s_PackageReadCacheBudgetDivisor;
+    }
+
+    uint64_t GetPeakWorkingSet()
+    {
+        PROCESS_MEMORY_COUNTERS counters{};
+        counters.cb = sizeof(counters);
+        THROW_LAST_ERROR_IF(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)));
+        return counters.PeakWorkingSetSize;
+    }
+
+    void LogPeakWorkingSet() try
+    {
+        uint64_t peak = GetPeakWorkingSet();
+        auto budget = GetMemoryBudget();
+
+        if (budget && peak > *budget)
+        {
+            AICLI_LOG(Core, Warning, << "Peak working set of " << (peak / (1024 * 1024)) << " MB was over the memory budget of " << (*budget / (1024 * 1024)) << " MB");
+        }
+        else
+        {
+            AICLI_LOG(Core, Info, << "Peak working set: " << (peak / (1024 * 1024)) << " MB");
+        }
+    }
+    CATCH_LOG();
+}
@@ -5,9 +5,11 @@
 #include "HttpStream/HttpRandomAccessStream.h"
 #include "Public/AppInstallerDownloader.h"
 #include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerSHA256.h"
 #include "Public/AppInstallerStrings.h"
 
 
+using namespace std::string_view_literals;
 using namespace winrt::Windows::Storage::Streams;
 using namespace Microsoft::WRL;
 using namespace AppInstaller::Utility::HttpStream;
@@ -16,6 +18,29 @@ namespace AppInstaller::Msix
 {
     namespace
     {
+        // The signature file is a PKCS #7 signed message prefixed with this marker.
+        constexpr std::string_view s_SignatureFileMarker = "PKCX"sv;
+
+        // The signed content holds the package digests after this marker, each as a tag followed by the digest.
+        constexpr std::string_view s_SignatureDigestsMarker = "APPX"sv;
+        constexpr std::string_view s_SignatureBlockMapDigestTag = "AXBM"sv;
+
+        // Reads the entire stream into a buffer.
+        std::vector<BYTE> ReadStreamToBuffer(IStream* stream)
+        {
+            STATSTG stat = { 0 };
+            THROW_IF_FAILED(stream->Stat(&stat, STATFLAG_NONAME));
+            THROW_HR_IF(E_UNEXPECTED, stat.cbSize.HighPart != 0);
+
+            std::vector<BYTE> result(stat.cbSize.LowPart);
+
+            ULONG bytesRead = 0;
+            THROW_IF_FAILED(stream->Read(result.data(), stat.cbSize.LowPart, &bytesRead));
+            THROW_HR_IF_MSG(E_UNEXPECTED, bytesRead != stat.cbSize.LowPart, "Failed to read the whole stream");
+
+            return result;
+        }
+
         // Gets the version from the manifest reader.
         UINT64 GetVersionFromManifestReader(IAppxManifestReader* reader)
         {
@@ -28,6 +53,14 @@ namespace AppInstaller::Msix
             return result;
         }
 
+        // Converts the UINT64 version into a dotted quad string.
+        std::string GetVersionString(UINT64 version)
+        {
+            std::ostringstream stream;
+            stream << ((version >> 48) & 0xFFFF) << '.' << ((version >> 32) & 0xFFFF) << '.' << ((version >> 16) & 0xFFFF) << '.' << (version & 0xFFFF);
+            return stream.str();
+        }
+
         // Gets the UINT64 version from the version struct.
         UINT64 GetVersionFromVersion(const winrt::Windows::ApplicationModel::PackageVersion& version)
         {
@@ -313,6 +346,18 @@ namespace AppInstaller::Msix
         }
     }
 
+    std::string GetPackageVersionFromManifestFile(const std::filesystem::path& manifest)
+    {
+        ComPtr<IStream> stream;
+        THROW_IF_FAILED(SHCreateStreamOnFileEx(manifest.c_str(),
+            STGM_READ | STGM_SHARE_DENY_WRITE | STGM_FAILIFTHERE, 0, FALSE, nullptr, &stream));
+
+        ComPtr<IAppxManifestReader> reader;
+        GetManifestReader(stream.Get(), &reader);
+
+        return GetVersionString(GetVersionFromManifestReader(reader.Get()));
+    }
+
     std::vector<byte> MsixInfo::GetSignature()
     {
         ComPtr<IAppxFile> signatureFile;
@@ -345,6 +390,113 @@ namespace AppInstaller::Msix
         return signatureContent;
     }
 
+    void MsixInfo::ValidateSignature(bool requireMicrosoftRoot)
+    {
+        THROW_HR_IF(E_NOT_VALID_STATE, m_isBundle);
+
+        std::vector<byte> signature = GetSignature();
+        THROW_HR_IF(TRUST_E_NOSIGNATURE, signature.size() <= s_SignatureFileMarker.size() ||
+            memcmp(signature.data(), s_SignatureFileMarker.data(), s_SignatureFileMarker.size()) != 0);
+
+        const BYTE* message = signature.data() + s_SignatureFileMarker.size();
+        DWORD messageSize = static_cast<DWORD>(signature.size() - s_SignatureFileMarker.size());
+
+        CRYPT_VERIFY_MESSAGE_PARA verifyParameters{};
+        verifyParameters.cbSize = sizeof(verifyParameters);
+        verifyParameters.dwMsgAndCertEncodingType = X509_ASN_ENCODING | PKCS_7_ASN_ENCODING;
+
+        DWORD contentSize = 0;
+        THROW_IF_WIN32_BOOL_FALSE(CryptVerifyMessageSignature(&verifyParameters, 0, message, messageSize, nullptr, &contentSize, nullptr));
+
+        std::vector<BYTE> content(contentSize);
+        wil::unique_cert_context signer;
+        THROW_IF_WIN32_BOOL_FALSE(CryptVerifyMessageSignature(&verifyParameters, 0, message, messageSize, content.data(), &contentSize, &signer));
+        content.resize(contentSize);
+
+        // The signer must chain to a trusted root for code signing.
+        LPSTR codeSigningUsage = const_cast<LPSTR>(szOID_PKIX_KP_CODE_SIGNING);
+
+        CERT_CHAIN_PARA chainParameters{};
+        chainParameters.cbSize = sizeof(chainParameters);
+        chainParameters.RequestedUsage.dwType = USAGE_MATCH_TYPE_AND;
+        chainParameters.RequestedUsage.Usage.cUsageIdentifier = 1;
+        chainParameters.RequestedUsage.Usage.rgpszUsageIdentifier = &codeSigningUsage;
+
+        wil::unique_cert_chain_context chain;
+        THROW_IF_WIN32_BOOL_FALSE(CertGetCertificateChain(nullptr, signer.get(), nullptr, signer.get()->hCertStore, &chainParameters, 0, nullptr, &chain));
+
+        auto verifyChainPolicy = [&](LPCSTR policy)
+        {
+            CERT_CHAIN_POLICY_PARA policyParameters{};
+            policyParameters.cbSize = sizeof(policyParameters);
+
+            CERT_CHAIN_POLICY_STATUS policyStatus{};
+            policyStatus.cbSize = sizeof(policyStatus);
+
+            THROW_IF_WIN32_BOOL_FALSE(CertVerifyCertificateChainPolicy(policy, chain.get(), &policyParameters, &policyStatus));
+            if (policyStatus.dwError != ERROR_SUCCESS)
+            {
+                THROW_HR_MSG(HRESULT_FROM_WIN32(policyStatus.dwError), "Package signature failed certificate chain policy");
+            }
+        };
+
+        verifyChainPolicy(CERT_CHAIN_POLICY_BASE);
+        if (requireMicrosoftRoot)
+        {
+            verifyChainPolicy(CERT_CHAIN_POLICY_MICROSOFT_ROOT);
+        }
+
+        // The signer must be the publisher of the package.
+        ComPtr<IAppxManifestReader> manifestReader;
+        THROW_IF_FAILED(m_packageReader->GetManifest(&manifestReader));
+
+        ComPtr<IAppxManifestPackageId> packageId;
+        THROW_IF_FAILED(manifestReader->GetPackageId(&packageId));
+
+        wil::unique_cotaskmem_string publisher;
+        THROW_IF_FAILED(packageId->GetPublisher(&publisher));
+
+        DWORD subjectLength = CertNameToStrW(X509_ASN_ENCODING, &signer.get()->pCertInfo->Subject, CERT_X500_NAME_STR | CERT_NAME_STR_REVERSE_FLAG, nullptr, 0);
+        std::wstring subject(subjectLength, L'\0');
+        subjectLength = CertNameToStrW(X509_ASN_ENCODING, &signer.get()->pCertInfo->Subject, CERT_X500_NAME_STR | CERT_NAME_STR_REVERSE_FLAG, &subject[0], subjectLength);
+        subject.resize(subjectLength ? subjectLength - 1 : 0);
+
+        if (!Utility::CaseInsensitiveEquals(Utility::ConvertToUTF8(subject), Utility::ConvertToUTF8(publisher.get())))
+        {
+            AICLI_LOG(Core, Error, << "Package signer [" << Utility::ConvertToUTF8(subject) << "] is not the package publisher [" << Utility::ConvertToUTF8(publisher.get()) << "]");
+            THROW_HR(TRUST_E_SUBJECT_NOT_TRUSTED);
+        }
+
+        // The signed content must hold the digest of the block map that will be used to verify the package files.
+        std::string_view contentView{ reinterpret_cast<const char*>(content.data()), content.size() };
+        size_t digestsPosition = contentView.rfind(s_SignatureDigestsMarker);
+        THROW_HR_IF_MSG(TRUST_E_BAD_DIGEST, digestsPosition == std::string_view::npos, "Package signature does not contain package digests");
+
+        size_t blockMapDigestPosition = contentView.find(s_SignatureBlockMapDigestTag, digestsPosition + s_SignatureDigestsMarker.size());
+        THROW_HR_IF_MSG(TRUST_E_BAD_DIGEST, blockMapDigestPosition == std::string_view::npos, "Package signature does not contain the block map digest");
+
+        // Only SHA256 digests are supported, as those are what the block map itself uses.
+        blockMapDigestPosition += s_SignatureBlockMapDigestTag.size();
+        THROW_HR_IF_MSG(TRUST_E_BAD_DIGEST, content.size() - blockMapDigestPosition < Utility::SHA256::HashBufferSizeInBytes, "Package signature block map digest is truncated");
+
+        ComPtr<IAppxFile> blockMapFile;
+        THROW_IF_FAILED(m_packageReader->GetFootprintFile(APPX_FOOTPRINT_FILE_TYPE_BLOCKMAP, &blockMapFile));
+
+        ComPtr<IStream> blockMapStream;
+        THROW_IF_FAILED(blockMapFile->GetStream(&blockMapStream));
+
+        std::vector<BYTE> blockMap = ReadStreamToBuffer(blockMapStream.Get());
+
+        Utility::SHA256::HashBuffer expectedHash{ content.begin() + blockMapDigestPosition, content.begin() + blockMapDigestPosition + Utility::SHA256::HashBufferSizeInBytes };
+        if (!Utility::SHA256::AreEqual(expectedHash, Utility::SHA256::ComputeHash(blockMap.data(), static_cast<std::uint32_t>(blockMap.size()))))
+        {
+            AICLI_LOG(Core, Error, << "Package block map does not match the signature");
+            THROW_HR(TRUST_E_BAD_DIGEST);
+        }
+
+        AICLI_LOG(Core, Info, << "Validated package signature from " << Utility::ConvertToUTF8(subject));
+    }
+
     std::wstring MsixInfo::GetPackageFullNameWide()
     {
         ComPtr<IAppxManifestPackageId> packageId;
@@ -399,6 +551,77 @@ namespace AppInstaller::Msix
         return (GetVersionFromManifestReader(manifestReader.Get()) > GetVersionFromVersion(otherVersion));
     }
 
+    std::string MsixInfo::GetPackageVersion()
+    {
+        THROW_HR_IF(E_NOT_VALID_STATE, m_isBundle);
+
+        ComPtr<IAppxManifestReader> manifestReader;
+        THROW_IF_FAILED(m_packageReader->GetManifest(&manifestReader));
+
+        return GetVersionString(GetVersionFromManifestReader(manifestReader.Get()));
+    }
+
+    bool MsixInfo::IsFileContentMatch(std::string_view packageFile, const std::filesystem::path& file)
+    {
+        THROW_HR_IF(E_NOT_VALID_STATE, m_isBundle);
+
+        // Every block in the block map covers this many bytes of the uncompressed file, other than the last.
+        constexpr UINT64 blockSize = 64 * 1024;
+
+        ComPtr<IAppxBlockMapReader> blockMapReader;
+        THROW_IF_FAILED(m_packageReader->GetBlockMap(&blockMapReader));
+
+        ComPtr<IAppxBlockMapFile> blockMapFile;
+        THROW_IF_FAILED(blockMapReader->GetFile(Utility::ConvertToUTF16(packageFile).c_str(), &blockMapFile));
+
+        UINT64 expectedSize = 0;
+        THROW_IF_FAILED(blockMapFile->GetUncompressedSize(&expectedSize));
+
+        if (std::filesystem::file_size(file) != expectedSize)
+        {
+            AICLI_LOG(Core, Info, << "File size does not match package file " << packageFile);
+            return false;
+        }
+
+        ComPtr<IAppxBlockMapBlocksEnumerator> blocks;
+        THROW_IF_FAILED(blockMapFile->GetBlocks(&blocks));
+
+        std::ifstream stream(file, std::ios_base::in | std::ios_base::binary);
+        THROW_LAST_ERROR_IF(stream.fail());
+
+        std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(blockSize);
+        UINT64 remaining = expectedSize;
+
+        BOOL hasCurrent = FALSE;
+        THROW_IF_FAILED(blocks->GetHasCurrent(&hasCurrent));
+
+        while (hasCurrent)
+        {
+            ComPtr<IAppxBlockMapBlock> block;
+            THROW_IF_FAILED(blocks->GetCurrent(&block));
+
+            UINT32 hashSize = 0;
+            wil::unique_cotaskmem_ptr<BYTE> hash;
+            THROW_IF_FAILED(block->GetHash(&hashSize, wil::out_param(hash)));
+
+            UINT64 bytesToRead = std::min(blockSize, remaining);
+            stream.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(bytesToRead));
+            THROW_HR_IF(E_UNEXPECTED, static_cast<UINT64>(stream.gcount()) != bytesToRead);
+            remaining -= bytesToRead;
+
+            Utility::SHA256::HashBuffer expectedHash{ hash.get(), hash.get() + hashSize };
+            if (!Utility::SHA256::AreEqual(expectedHash, Utility::SHA256::ComputeHash(buffer.get(), static_cast<std::uint32_t>(bytesToRead))))
+            {
+                AICLI_LOG(Core, Info, << "File content does not match package file " << packageFile << " at offset " << (expectedSize - remaining - bytesToRead));
+                return false;
+            }
+
+            THROW_IF_FAILED(blocks->MoveNext(&hasCurrent));
+        }
+
+        return (remaining == 0);
+    }
+
     void MsixInfo::WriteToFile(std::string_view packageFile, const std::filesystem::path& target, IProgressCallback& progress)
     {
         std::wstring fileUTF16 = Utility::ConvertToUTF16(packageFile);
@@ -22,6 +22,91 @@ namespace AppInstaller::Utility
             std::wstring Publisher;
         };
 
+        // A quick check of whether a regular expression could match an ASCII value.
+        // It must only return false when the expression definitely cannot match, as it is used to skip running it.
+        using Prefilter = bool(*)(std::wstring_view);
+
+        struct FilteredExpression
+        {
+            const Regex::SharedExpression* Expression;
+            Prefilter MayMatch;
+        };
+
+        bool IsAscii(std::wstring_view value)
+        {
+            return std::all_of(value.begin(), value.end(), [](wchar_t c) { return c < 0x80; });
+        }
+
+        bool IsAsciiLetter(wchar_t c)
+        {
+            return (c >= L'A' && c <= L'Z') || (c >= L'a' && c <= L'z');
+        }
+
+        bool IsAsciiLetterOrDigit(wchar_t c)
+        {
+            return IsAsciiLetter(c) || (c >= L'0' && c <= L'9');
+        }
+
+        bool ContainsAny(std::wstring_view value, std::wstring_view chars)
+        {
+            return value.find_first_of(chars) != std::wstring_view::npos;
+        }
+
+        bool ContainsAsciiCaseInsensitive(std::wstring_view value, std::wstring_view search)
+        {
+            return std::search(value.begin(), value.end(), search.begin(), search.end(),
+                [](wchar_t a, wchar_t b) { return std::towupper(a) == std::towupper(b); }) != value.end();
+        }
+
+        bool StartsWithAsciiCaseInsensitive(std::wstring_view value, std::wstring_view prefix)
+        {
+            return value.length() >= prefix.length() && ContainsAsciiCaseInsensitive(value.substr(0, prefix.length()), prefix);
+        }
+
+        bool MayContainDigit(std::wstring_view value) { return ContainsAny(value, L"0123456789"); }
+        bool MayBeFilePath(std::wstring_view value) { return value.find(L":\\") != std::wstring_view::npos; }
+        bool MayBeBracket(std::wstring_view value) { return ContainsAny(value, L"(["); }
+        bool MayBeBracketOrQuote(std::wstring_view value) { return ContainsAny(value, L"([\""); }
+        bool MayBeBracketEnclosed(std::wstring_view value) { return ContainsAny(value, L"([{\""); }
+        bool MayBeURI(std::wstring_view value) { return value.find(L"://") != std::wstring_view::npos; }
+
+        // The same names and publishers are normalized repeatedly, for instance when correlating installed packages
+        // with every source, so the results are kept for the lifetime of the process.
+        struct NormalizationCache
+        {
+            std::optional<NormalizedName> Find(std::string_view name, std::string_view publisher)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                auto itr = m_values.find(std::make_pair(std::string{ name }, std::string{ publisher }));
+                if (itr != m_values.end())
+                {
+                    return itr->second;
+                }
+
+                return std::nullopt;
+            }
+
+            void Add(std::string_view name, std::string_view publisher, const NormalizedName& value)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                // Rather than tracking use, simply start over if the cache grows too large.
+                if (m_values.size() >= s_MaximumSize)
+                {
+                    m_values.clear();
+                }
+
+                m_values.emplace(std::make_pair(std::string{ name }, std::string{ publisher }), value);
+            }
+
+        private:
+            static constexpr size_t s_MaximumSize = 16384;
+
+            std::mutex m_lock;
+            std::map<std::pair<std::string, std::string>, NormalizedName> m_values;
+        };
+
         // To maintain consistency, changes that result in different output must be done in a new version.
         // This can potentially be ignored (if thought through) when the changes will only increase the
         // number of matches being made, with no impact to existing matches. For instance, removing an
@@ -72,7 +157,7 @@ namespace AppInstaller::Utility
             }
 
             // Removes all matches from the input string.
-            static bool Remove(const Regex::Expression& re, std::wstring& input)
+            static bool Remove(const Regex::SharedExpression& re, std::wstring& input)
             {
                 std::wstring output = re.Replace(input, {});
                 bool result = (output != input);
@@ -104,13 +189,21 @@ namespace AppInstaller::Utility
             }
 
             // Removes all matches for the given regular expressions
-            static bool RemoveAll(const std::vector<Regex::Expression*>& regexes, std::wstring& value)
+            static bool RemoveAll(const std::vector<FilteredExpression>& regexes, std::wstring& value)
             {
                 bool result = false;
 
+                // Removing matches cannot introduce non-ASCII characters, so this holds for the entire loop.
+                bool useFilters = IsAscii(value);
+
                 for (const auto& re : regexes)
                 {
-                    result = Remove(*re, value) || result;
+                    if (useFilters && !re.MayMatch(value))
+                    {
+                        continue;
+                    }
+
+                    result = Remove(*re.Expression, value) || result;
                 }
 
                 return result;
@@ -122,6 +215,12 @@ namespace AppInstaller::Utility
                 bool localeFound = false;
                 std::wstring result;
 
+                // Every locale contains a dash
+                if (IsAscii(value) && value.find(L'-') == std::wstring::npos)
+                {
+                    return result;
+                }
+
                 std::wstring newValue;
                 auto newValueInserter = std::back_inserter(newValue);
 
@@ -182,7 +281,7 @@ namespace AppInstaller::Utility
 
             // Splits the string based on the regex matches, excluding empty/whitespace strings
             // and any values found in the exclusions.
-            static std::vector<std::wstring> Split(const Regex::Expression& re, const std::wstring& value, const std::vector<std::wstring>& exclusions, bool stopOnExclusion = false)
+            static std::vector<std::wstring> Split(const Regex::SharedExpression& re, const std::wstring& value, const std::vector<std::wstring>& exclusions, bool stopOnExclusion = false)
             {
                 std::vector<std::wstring> result;
 
@@ -230,77 +329,77 @@ namespace AppInstaller::Utility
             static constexpr Regex::Options reOptions = Regex::Options::CaseInsensitive;
 
             // Architecture
-            Regex::Expression ArchitectureX32{ R"((?<=^|[^\p{L}\p{Nd}])(X32|X86)(?=\P{Nd}|$)(?:\sEDITION)?)", reOptions };
-            Regex::Expression ArchitectureX64{ R"((?<=^|[^\p{L}\p{Nd}])(X64|AMD64|X86([\p{Pd}\p{Pc}]64))(?=\P{Nd}|$)(?:\sEDITION)?)", reOptions };
-            Regex::Expression Architecture32Bit{ R"((?<=^|[^\p{L}\p{Nd}])(32[\p{Pd}\p{Pc}\p{Z}]?BIT)S?(?:\sEDITION)?)", reOptions };
-            Regex::Expression Architecture64Bit{ R"((?<=^|[^\p{L}\p{Nd}])(64[\p{Pd}\p{Pc}\p{Z}]?BIT)S?(?:\sEDITION)?)", reOptions };
-            Regex::Expression Architecture32Or64Bit{ R"((?<=^|[^\p{L}\p{Nd}])((64[\\\/]32|32[\\\/]64)[\p{Pd}\p{Pc}\p{Z}]?BIT)S?(?:\sEDITION)?)", reOptions };
+            Regex::SharedExpression ArchitectureX32{ R"((?<=^|[^\p{L}\p{Nd}])(X32|X86)(?=\P{Nd}|$)(?:\sEDITION)?)", reOptions };
+            Regex::SharedExpression ArchitectureX64{ R"((?<=^|[^\p{L}\p{Nd}])(X64|AMD64|X86([\p{Pd}\p{Pc}]64))(?=\P{Nd}|$)(?:\sEDITION)?)", reOptions };
+            Regex::SharedExpression Architecture32Bit{ R"((?<=^|[^\p{L}\p{Nd}])(32[\p{Pd}\p{Pc}\p{Z}]?BIT)S?(?:\sEDITION)?)", reOptions };
+            Regex::SharedExpression Architecture64Bit{ R"((?<=^|[^\p{L}\p{Nd}])(64[\p{Pd}\p{Pc}\p{Z}]?BIT)S?(?:\sEDITION)?)", reOptions };
+            Regex::SharedExpression Architecture32Or64Bit{ R"((?<=^|[^\p{L}\p{Nd}])((64[\\\/]32|32[\\\/]64)[\p{Pd}\p{Pc}\p{Z}]?BIT)S?(?:\sEDITION)?)", reOptions };
 
             // Locale
-            Regex::Expression Locale{ R"((?<![A-Z])((?:\p{Lu}{2,3}(-(CANS|CYRL|LATN|MONG))?-\p{Lu}{2})(?![A-Z])(?:-VALENCIA)?))", reOptions };
+            Regex::SharedExpression Locale{ R"((?<![A-Z])((?:\p{Lu}{2,3}(-(CANS|CYRL|LATN|MONG))?-\p{Lu}{2})(?![A-Z])(?:-VALENCIA)?))", reOptions };
 
             // Specifically for SAP Business Objects programs
-            Regex::Expression SAPPackage{ R"(^(?:[\p{Lu}\p{Nd}]+[\._])+[\p{Lu}\p{Nd}]+(?:-(?:\p{Nd}+\.)+\p{Nd}+)(?:-(?:\p{Lu}{2}(?:_\p{Lu}{2})?|CORE))(?:-(?:\p{Lu}{2}|\p{Nd}{2}))$)", reOptions };
+            Regex::SharedExpression SAPPackage{ R"(^(?:[\p{Lu}\p{Nd}]+[\._])+[\p{Lu}\p{Nd}]+(?:-(?:\p{Nd}+\.)+\p{Nd}+)(?:-(?:\p{Lu}{2}(?:_\p{Lu}{2})?|CORE))(?:-(?:\p{Lu}{2}|\p{Nd}{2}))$)", reOptions };
 
             // Extract KB numbers from their parens to preserve them
-            Regex::Expression KBNumbers{ R"(\((KB\d+)\))", reOptions };
-
-            Regex::Expression NonLettersAndDigits{ R"([^\p{L}\p{Nd}])", reOptions };
-            Regex::Expression URIProtocol{ R"((?<!\p{L})(?:http[s]?|ftp):\/\/)", reOptions }; // remove protocol from URIs
-
-            Regex::Expression VersionDelimited{ R"(((?<!\p{L})(?:V|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)\P{L}?)?\p{Nd}+([\p{Po}\p{Pd}\p{Pc}]\p{Nd}?(RC|B|A|R|SP|K)?\p{Nd}+)+([\p{Po}\p{Pd}\p{Pc}]?[\p{L}\p{Nd}]+)*)", reOptions };
-            Regex::Expression Version{ R"((FOR\s)?(?<!\p{L})(?:P|V|R|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)(?:\P{L}|\P{L}\p{L})?(\p{Nd}|\.\p{Nd})+(?:RC|B|A|R|V|SP)?\p{Nd}?)", reOptions };
-            Regex::Expression VersionLetter{ R"((?<!\p{L})(?:(?:V|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)\P{L})?\p{Lu}\p{Nd}+(?:[\p{Po}\p{Pd}\p{Pc}]\p{Nd}+)+)", reOptions };
-            Regex::Expression NonNestedBracket{ R"(\([^\(\)]*\)|\[[^\[\]]*\])", reOptions }; // remove things in parentheses, if there aren't parentheses nested inside
-            Regex::Expression BracketEnclosed{ R"((?:\p{Ps}.*\p{Pe}|".*"))", reOptions }; // Impossible to properly handle nested parens with regex
-            Regex::Expression LeadingSymbols{ R"(^[^\p{L}\p{Nd}]+)", reOptions }; // remove symbols at the beginning
-            Regex::Expression TrailingNonLetters{ R"(\P{L}+$)", reOptions }; // remove non-letters at the end
-            Regex::Expression PrefixParens{ R"(^\(.*?\))", reOptions }; // remove things in parentheses at the front of program names
-            Regex::Expression EmptyParens{ R"((\(\s*\)|\[\s*\]|"\s*"))", reOptions }; // remove appearances of (), [], and "", with any number of spaces within
-            Regex::Expression EN{ R"(\sEN\s*$)", reOptions }; // remove appearances of EN (represents English language) at the ends of program names
-            Regex::Expression TrailingSymbols{ R"([^\p{L}\p{Nd}]+$)", reOptions }; // remove all non-letter/numbers at the end
-            Regex::Expression FilePath{ R"(((INSTALLED\sAT|IN)\s)?[CDEF]:\\(.+?\\)*[^\s]*\\?)", reOptions }; // remove file paths
-            Regex::Expression FilePathGHS{ R"(\(CHANGE #\d{1,2} TO [CDEF]:\\(.+?\\)*[^\s]*\\?\))", reOptions }; // remove file paths in certain Green Hills Software program names
-            Regex::Expression FilePathParens{ R"(\([CDEF]:\\(.+?\\)*[^\s]*\\?\))", reOptions }; // remove file paths within parentheses
-            Regex::Expression FilePathQuotes{ R"("[CDEF]:\\(.+?\\)*[^\s]*\\?")", reOptions }; // remove file paths within quotes
-            Regex::Expression Roblox{ R"((?<=^ROBLOX\s(PLAYER|STUDIO))(\sFOR\s.*))", reOptions }; // for Roblox programs
-            Regex::Expression Bomgar{ R"((?<=^BOMGAR\s(JUMP CLIENT|(ACCESS|REPRESENTATIVE) CONSOLE|BUTTON)|^EMBEDDED CALLBACK)(\s.*))", reOptions }; // for Bomgar programs
-            Regex::Expression AcronymSeparators{ R"((?:(?<=^\p{L})|(?<=\P{L}\p{L}))(\.|\/)(?=\p{L}(?:\P{L}|$)))", reOptions };
-            Regex::Expression NonLetters{ R"((?<=^|\s)[^\p{L}]+(?=\s|$))", reOptions }; // remove all non-letters not attached to 
-            Regex::Expression ProgramNameSplit{ R"([^\p{L}\p{Nd}\+\&])", reOptions }; // used to separate 'words' in program names
-            Regex::Expression PublisherNameSplit{ R"([^\p{L}\p{Nd}])", reOptions }; // used to separate 'words' in publisher names
-
-            const std::vector<Regex::Expression*> ProgramNameRegexes
+            Regex::SharedExpression KBNumbers{ R"(\((KB\d+)\))", reOptions };
+
+            Regex::SharedExpression NonLettersAndDigits{ R"([^\p{L}\p{Nd}])", reOptions };
+            Regex::SharedExpression URIProtocol{ R"((?<!\p{L})(?:http[s]?|ftp):\/\/)", reOptions }; // remove protocol from URIs
+
+            Regex::SharedExpression VersionDelimited{ R"(((?<!\p{L})(?:V|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)\P{L}?)?\p{Nd}+([\p{Po}\p{Pd}\p{Pc}]\p{Nd}?(RC|B|A|R|SP|K)?\p{Nd}+)+([\p{Po}\p{Pd}\p{Pc}]?[\p{L}\p{Nd}]+)*)", reOptions };
+            Regex::SharedExpression Version{ R"((FOR\s)?(?<!\p{L})(?:P|V|R|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)(?:\P{L}|\P{L}\p{L})?(\p{Nd}|\.\p{Nd})+(?:RC|B|A|R|V|SP)?\p{Nd}?)", reOptions };
+            Regex::SharedExpression VersionLetter{ R"((?<!\p{L})(?:(?:V|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)\P{L})?\p{Lu}\p{Nd}+(?:[\p{Po}\p{Pd}\p{Pc}]\p{Nd}+)+)", reOptions };
+            Regex::SharedExpression NonNestedBracket{ R"(\([^\(\)]*\)|\[[^\[\]]*\])", reOptions }; // remove things in parentheses, if there aren't parentheses nested inside
+            Regex::SharedExpression BracketEnclosed{ R"((?:\p{Ps}.*\p{Pe}|".*"))", reOptions }; // Impossible to properly handle nested parens with regex
+            Regex::SharedExpression LeadingSymbols{ R"(^[^\p{L}\p{Nd}]+)", reOptions }; // remove symbols at the beginning
+            Regex::SharedExpression TrailingNonLetters{ R"(\P{L}+$)", reOptions }; // remove non-letters at the end
+            Regex::SharedExpression PrefixParens{ R"(^\(.*?\))", reOptions }; // remove things in parentheses at the front of program names
+            Regex::SharedExpression EmptyParens{ R"((\(\s*\)|\[\s*\]|"\s*"))", reOptions }; // remove appearances of (), [], and "", with any number of spaces within
+            Regex::SharedExpression EN{ R"(\sEN\s*$)", reOptions }; // remove appearances of EN (represents English language) at the ends of program names
+            Regex::SharedExpression TrailingSymbols{ R"([^\p{L}\p{Nd}]+$)", reOptions }; // remove all non-letter/numbers at the end
+            Regex::SharedExpression FilePath{ R"(((INSTALLED\sAT|IN)\s)?[CDEF]:\\(.+?\\)*[^\s]*\\?)", reOptions }; // remove file paths
+            Regex::SharedExpression FilePathGHS{ R"(\(CHANGE #\d{1,2} TO [CDEF]:\\(.+?\\)*[^\s]*\\?\))", reOptions }; // remove file paths in certain Green Hills Software program names
+            Regex::SharedExpression FilePathParens{ R"(\([CDEF]:\\(.+?\\)*[^\s]*\\?\))", reOptions }; // remove file paths within parentheses
+            Regex::SharedExpression FilePathQuotes{ R"("[CDEF]:\\(.+?\\)*[^\s]*\\?")", reOptions }; // remove file paths within quotes
+            Regex::SharedExpression Roblox{ R"((?<=^ROBLOX\s(PLAYER|STUDIO))(\sFOR\s.*))", reOptions }; // for Roblox programs
+            Regex::SharedExpression Bomgar{ R"((?<=^BOMGAR\s(JUMP CLIENT|(ACCESS|REPRESENTATIVE) CONSOLE|BUTTON)|^EMBEDDED CALLBACK)(\s.*))", reOptions }; // for Bomgar programs
+            Regex::SharedExpression AcronymSeparators{ R"((?:(?<=^\p{L})|(?<=\P{L}\p{L}))(\.|\/)(?=\p{L}(?:\P{L}|$)))", reOptions };
+            Regex::SharedExpression NonLetters{ R"((?<=^|\s)[^\p{L}]+(?=\s|$))", reOptions }; // remove all non-letters not attached to 
+            Regex::SharedExpression ProgramNameSplit{ R"([^\p{L}\p{Nd}\+\&])", reOptions }; // used to separate 'words' in program names
+            Regex::SharedExpression PublisherNameSplit{ R"([^\p{L}\p{Nd}])", reOptions }; // used to separate 'words' in publisher names
+
+            const std::vector<FilteredExpression> ProgramNameRegexes
             {
-                &Roblox,
-                &Bomgar,
-                &PrefixParens,
-                &EmptyParens,
-                &FilePathGHS,
-                &FilePathParens,
-                &FilePathQuotes,
-                &FilePath,
-                &VersionLetter,
-                &VersionDelimited,
-                &Version,
-                &EN,
-                &NonNestedBracket,
-                &BracketEnclosed,
-                &URIProtocol,
-                &LeadingSymbols,
-                &TrailingSymbols
+                { &Roblox, [](std::wstring_view v) { return StartsWithAsciiCaseInsensitive(v, L"ROBLOX"); } },
+                { &Bomgar, [](std::wstring_view v) { return StartsWithAsciiCaseInsensitive(v, L"BOMGAR") || StartsWithAsciiCaseInsensitive(v, L"EMBEDDED CALLBACK"); } },
+                { &PrefixParens, [](std::wstring_view v) { return !v.empty() && v[0] == L'('; } },
+                { &EmptyParens, MayBeBracketOrQuote },
+                { &FilePathGHS, MayBeFilePath },
+                { &FilePathParens, MayBeFilePath },
+                { &FilePathQuotes, MayBeFilePath },
+                { &FilePath, MayBeFilePath },
+                { &VersionLetter, MayContainDigit },
+                { &VersionDelimited, MayContainDigit },
+                { &Version, MayContainDigit },
+                { &EN, [](std::wstring_view v) { return ContainsAsciiCaseInsensitive(v, L"EN"); } },
+                { &NonNestedBracket, MayBeBracket },
+                { &BracketEnclosed, MayBeBracketEnclosed },
+                { &URIProtocol, MayBeURI },
+                { &LeadingSymbols, [](std::wstring_view v) { return !v.empty() && !IsAsciiLetterOrDigit(v.front()); } },
+                { &TrailingSymbols, [](std::wstring_view v) { return !v.empty() && !IsAsciiLetterOrDigit(v.back()); } },
             };
 
-            const std::vector<Regex::Expression*> PublisherNameRegexes
+            const std::vector<FilteredExpression> PublisherNameRegexes
             {
-                &VersionDelimited,
-                &Version,
-                &NonNestedBracket,
-                &BracketEnclosed,
-                &URIProtocol,
-                &NonLetters,
-                &TrailingNonLetters,
-                &AcronymSeparators
+                { &VersionDelimited, MayContainDigit },
+                { &Version, MayContainDigit },
+                { &NonNestedBracket, MayBeBracket },
+                { &BracketEnclosed, MayBeBracketEnclosed },
+                { &URIProtocol, MayBeURI },
+                { &NonLetters, [](std::wstring_view v) { return !std::all_of(v.begin(), v.end(), IsAsciiLetter); } },
+                { &TrailingNonLetters, [](std::wstring_view v) { return !v.empty() && !IsAsciiLetter(v.back()); } },
+                { &AcronymSeparators, [](std::wstring_view v) { return ContainsAny(v, L"./"); } },
             };
 
             // Add values here but use Locales in code.
@@ -409,6 +508,21 @@ namespace AppInstaller::Utility
             }
 
             NormalizedName Normalize(std::string_view name, std::string_view publisher) const override
+            {
+                static NormalizationCache s_cache;
+
+                std::optional<NormalizedName> cached = s_cache.Find(name, publisher);
+                if (cached)
+                {
+                    return std::move(cached).value();
+                }
+
+                NormalizedName result = NormalizeUncached(name, publisher);
+                s_cache.Add(name, publisher, result);
+                return result;
+            }
+
+            NormalizedName NormalizeUncached(std::string_view name, std::string_view publisher) const
             {
                 InterimNameNormalizationResult nameResult = NormalizeNameInternal(name);
                 InterimPublisherNormalizationResult pubResult = NormalizePublisherInternal(publisher);
@@ -448,8 +562,12 @@ namespace AppInstaller::Utility
         switch (version)
         {
         case AppInstaller::Utility::NormalizationVersion::Initial:
-            m_normalizer = std::make_unique<NormalizationInitial>();
+        {
+            // Compiling the expressions is expensive, so they are only compiled once.
+            static std::shared_ptr<const NormalizationInitial> s_initial = std::make_shared<const NormalizationInitial>();
+            m_normalizer = s_initial;
             break;
+        }
         default:
             THROW_HR(E_INVALIDARG);
         }
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/Performance.h"
+
+
+namespace AppInstaller::Performance
+{
+    namespace details
+    {
+        // The timings of a single scope, beneath a particular parent scope.
+        struct TimingNode
+        {
+            TimingNode(std::string_view name, const void* function) : Name(name), Function(function) {}
+
+            std::string Name;
+            const void* Function;
+            size_t Count = 0;
+            std::chrono::nanoseconds Total{};
+            std::vector<std::unique_ptr<TimingNode>> Children;
+        };
+    }
+
+    namespace
+    {
+        using details::TimingNode;
+
+        std::atomic_bool s_collectionEnabled{ false };
+
+        // Guards the entire tree, which is only modified when entering a scope for the first time or leaving one.
+        std::mutex s_timingsLock;
+        TimingNode s_rootTiming{ {}, nullptr };
+
+        // The innermost active scope on this thread.
+        thread_local TimingNode* t_currentTiming = nullptr;
+
+        TimingNode* FindOrAddChild(TimingNode& parent, std::string_view name, const void* function)
+        {
+            for (const auto& child : parent.Children)
+            {
+                if (child->Function == function && child->Name == name)
+                {
+                    return child.get();
+                }
+            }
+
+            return parent.Children.emplace_back(std::make_unique<TimingNode>(name, function)).get();
+        }
+
+        // Gets a name for a function as its module and offset, which can be resolved against the symbols for the build.
+        std::string GetFunctionName(const void* function)
+        {
+            std::ostringstream stream;
+
+            HMODULE module = nullptr;
+            if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, reinterpret_cast<LPCWSTR>(function), &module))
+            {
+                wchar_t modulePath[MAX_PATH]{};
+                if (GetModuleFileNameW(module, modulePath, ARRAYSIZE(modulePath)))
+                {
+                    stream << std::filesystem::path{ modulePath }.filename().u8string() << '+';
+                    function = reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(function) - reinterpret_cast<uintptr_t>(module));
+                }
+            }
+
+            stream << "0x" << std::hex << reinterpret_cast<uintptr_t>(function);
+            return stream.str();
+        }
+
+        std::vector<TimingSummary> SummarizeChildren(const TimingNode& node)
+        {
+            std::vector<TimingSummary> result;
+            result.reserve(node.Children.size());
+
+            for (const auto& child : node.Children)
+            {
+                TimingSummary& summary = result.emplace_back();
+                summary.Name = (child->Function ? GetFunctionName(child->Function) : child->Name);
+                summary.Count = child->Count;
+                summary.Total = child->Total;
+                summary.Children = SummarizeChildren(*child);
+            }
+
+            return result;
+        }
+
+        Json::Value SummaryToJson(const std::vector<TimingSummary>& summary)
+        {
+            Json::Value result{ Json::ValueType::arrayValue };
+
+            for (const auto& entry : summary)
+            {
+                Json::Value value{ Json::ValueType::objectValue };
+                value["name"] = entry.Name;
+                value["count"] = static_cast<Json::UInt64>(entry.Count);
+                value["totalMs"] = std::chrono::duration<double, std::milli>(entry.Total).count();
+
+                if (!entry.Children.empty())
+                {
+                    value["children"] = SummaryToJson(entry.Children);
+                }
+
+                result.append(std::move(value));
+            }
+
+            return result;
+        }
+    }
+
+    void EnableCollection()
+    {
+        s_collectionEnabled = true;
+    }
+
+    bool IsCollectionEnabled()
+    {
+        return s_collectionEnabled;
+    }
+
+    ScopedTimer::ScopedTimer(std::string_view name, const void* function)
+    {
+        if (!s_collectionEnabled)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{ s_timingsLock };
+            m_node = FindOrAddChild(t_currentTiming ? *t_currentTiming : s_rootTiming, name, function);
+        }
+
+        m_previous = std::exchange(t_currentTiming, m_node);
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    ScopedTimer::~ScopedTimer()
+    {
+        if (!m_node)
+        {
+            return;
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+
+        {
+            std::lock_guard<std::mutex> lock{ s_timingsLock };
+            m_node->Count += 1;
+            m_node->Total += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+        }
+
+        t_currentTiming = m_previous;
+    }
+
+    std::vector<TimingSummary> GetTimingSummary()
+    {
+        std::lock_guard<std::mutex> lock{ s_timingsLock };
+        return SummarizeChildren(s_rootTiming);
+    }
+
+    std::string TimingSummaryToJson(const std::vector<TimingSummary>& summary)
+    {
+        Json::StreamWriterBuilder writerBuilder;
+        writerBuilder.settings_["indentation"] = "";
+        return Json::writeString(writerBuilder, SummaryToJson(summary));
+    }
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+    void TestHook_ResetTimings()
+    {
+        std::lock_guard<std::mutex> lock{ s_timingsLock };
+        s_collectionEnabled = false;
+        s_rootTiming.Children.clear();
+        t_currentTiming = nullptr;
+    }
+#endif
+}
@@ -0,0 +1,362 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/PerformanceCounters.h"
+#include "Public/AppInstallerLogging.h"
+
+#define AICLI_TraceLoggingStringView(_sv_,_name_) TraceLoggingCountedUtf8String(_sv_.data(), static_cast<ULONG>(_sv_.size()), _name_)
+#define AICLI_TraceLoggingWStringView(_sv_,_name_) TraceLoggingCountedWideString(_sv_.data(), static_cast<ULONG>(_sv_.size()), _name_)
+#define AICLI_TraceLoggingHistogram(_histogram_,_name_) \
+    TraceLoggingUInt64(_histogram_.Count, _name_ "Count"), \
+    TraceLoggingUInt64(static_cast<UINT64>(_histogram_.Total.count()), _name_ "TotalMicroseconds"), \
+    TraceLoggingUInt64(static_cast<UINT64>(_histogram_.Maximum.count()), _name_ "MaximumMicroseconds"), \
+    TraceLoggingUInt64Array(_histogram_.Buckets.data(), static_cast<UINT16>(_histogram_.Buckets.size()), _name_ "Buckets")
+
+namespace AppInstaller::Performance::Counters
+{
+    namespace details
+    {
+        struct LockCounter
+        {
+            std::atomic<uint64_t> Acquisitions{ 0 };
+            std::atomic<uint64_t> ContendedAcquisitions{ 0 };
+            std::atomic<uint64_t> WaitMicroseconds{ 0 };
+        };
+    }
+
+    namespace
+    {
+        // Written when a trace is listening, without the telemetry keyword so that these stay on the machine.
+        bool IsTraceEnabled()
+        {
+            return TraceLoggingProviderEnabled(g_hTraceProvider, WINEVENT_LEVEL_VERBOSE, 0);
+        }
+
+        void AddToHistogram(LatencyHistogram& histogram, std::chrono::nanoseconds duration)
+        {
+            auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+
+            ++histogram.Count;
+            histogram.Total += microseconds;
+            histogram.Maximum = std::max(histogram.Maximum, microseconds);
+
+            size_t bucket = 0;
+            while (bucket < LatencyBucketBounds.size() && duration > LatencyBucketBounds[bucket])
+            {
+                ++bucket;
+            }
+
+            ++histogram.Buckets[bucket];
+        }
+
+        // Guards everything but the download and request counts, which are updated often and so are atomic.
+        std::mutex s_countersLock;
+        std::map<std::string, QueueDepth, std::less<>> s_queues;
+        LatencyHistogram s_queueWait;
+        LatencyHistogram s_queueRun;
+        LatencyHistogram s_sourceOpen;
+        LatencyHistogram s_search;
+        // The counters are never removed, as the mutexes hold on to them.
+        std::map<std::string, std::unique_ptr<details::LockCounter>, std::less<>> s_locks;
+
+        std::atomic<size_t> s_activeDownloads{ 0 };
+        std::atomic<uint64_t> s_downloadedBytes{ 0 };
+        std::atomic<uint64_t> s_httpRequests{ 0 };
+        std::atomic<uint64_t> s_http2Requests{ 0 };
+        std::atomic<uint64_t> s_installerCacheHits{ 0 };
+        std::atomic<uint64_t> s_installerCacheMisses{ 0 };
+        std::atomic<uint64_t> s_installerCacheHitBytes{ 0 };
+
+        // Writes the counters at an interval until it is destroyed.
+        struct Publisher
+        {
+            Publisher(std::chrono::milliseconds interval) : m_interval(interval)
+            {
+                m_thread = std::thread([this]() { Run(); });
+            }
+
+            ~Publisher()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    m_stopping = true;
+                }
+
+                m_signal.notify_all();
+                m_thread.join();
+            }
+
+        private:
+            void Run() noexcept try
+            {
+                uint64_t previousBytes = s_downloadedBytes;
+                auto previousTime = std::chrono::steady_clock::now();
+
+                while (true)
+                {
+                    {
+                        std::unique_lock<std::mutex> lock{ m_lock };
+                        if (m_signal.wait_for(lock, m_interval, [this]() { return m_stopping; }))
+                        {
+                            return;
+                        }
+                    }
+
+                    auto snapshot = GetSnapshot();
+                    auto now = std::chrono::steady_clock::now();
+                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - previousTime);
+                    UINT64 bytesPerSecond = elapsed.count() > 0 ? (snapshot.DownloadedBytes - previousBytes) * 1000 / static_cast<UINT64>(elapsed.count()) : 0;
+
+                    previousBytes = snapshot.DownloadedBytes;
+                    previousTime = now;
+
+                    if (!IsTraceEnabled())
+                    {
+                        continue;
+                    }
+
+                    for (const auto& queue : snapshot.Queues)
+                    {
+                        TraceLoggingWrite(
+                            g_hTraceProvider,
+                            "OrchestratorQueueDepth",
+                            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                            AICLI_TraceLoggingStringView(queue.Name, "Queue"),
+                            TraceLoggingUInt64(queue.QueuedItems, "QueuedItems"),
+                            TraceLoggingUInt64(queue.RunningItems, "RunningItems"));
+                    }
+
+                    TraceLoggingWrite(
+                        g_hTraceProvider,
+                        "ServerCounters",
+                        TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                        TraceLoggingUInt64(snapshot.ActiveDownloads, "ActiveDownloads"),
+                        TraceLoggingUInt64(snapshot.DownloadedBytes, "DownloadedBytes"),
+                        TraceLoggingUInt64(bytesPerSecond, "DownloadBytesPerSecond"),
+                        TraceLoggingUInt64(snapshot.HttpRequests, "HttpRequests"),
+                        TraceLoggingUInt64(snapshot.Http2Requests, "Http2Requests"),
+                        TraceLoggingUInt64(snapshot.InstallerCacheHits, "InstallerCacheHits"),
+                        TraceLoggingUInt64(snapshot.InstallerCacheMisses, "InstallerCacheMisses"),
+                        TraceLoggingUInt64(snapshot.InstallerCacheHitBytes, "InstallerCacheHitBytes"),
+                        AICLI_TraceLoggingHistogram(snapshot.QueueWait, "QueueWait"),
+                        AICLI_TraceLoggingHistogram(snapshot.QueueRun, "QueueRun"),
+                        AICLI_TraceLoggingHistogram(snapshot.SourceOpen, "SourceOpen"),
+                        AICLI_TraceLoggingHistogram(snapshot.Search, "Search"));
+                }
+            }
+            catch (...)
+            {
+                // Losing the counters is better than losing the server.
+                LOG_CAUGHT_EXCEPTION();
+            }
+
+            std::chrono::milliseconds m_interval;
+            std::mutex m_lock;
+            std::condition_variable m_signal;
+            bool m_stopping = false;
+            std::thread m_thread;
+        };
+
+        std::mutex s_publisherLock;
+        std::unique_ptr<Publisher> s_publisher;
+    }
+
+    void SetQueueDepth(std::string_view queueName, size_t queuedItems, size_t runningItems)
+    {
+        std::lock_guard<std::mutex> lock{ s_countersLock };
+
+        auto itr = s_queues.find(queueName);
+        if (itr == s_queues.end())
+        {
+            itr = s_queues.emplace(std::string{ queueName }, QueueDepth{ std::string{ queueName } }).first;
+        }
+
+        itr->second.QueuedItems = queuedItems;
+        itr->second.RunningItems = runningItems;
+    }
+
+    void RecordQueueItem(std::string_view queueName, std::wstring_view packageId, std::chrono::nanoseconds waitTime, std::chrono::nanoseconds runTime, HRESULT result)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ s_countersLock };
+            AddToHistogram(s_queueWait, waitTime);
+            AddToHistogram(s_queueRun, runTime);
+        }
+
+        TraceLoggingWrite(
+            g_hTraceProvider,
+            "OrchestratorQueueItem",
+            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+            AICLI_TraceLoggingStringView(queueName, "Queue"),
+            AICLI_TraceLoggingWStringView(packageId, "PackageId"),
+            TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::milliseconds>(waitTime).count()), "WaitTimeMilliseconds"),
+            TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::milliseconds>(runTime).count()), "RunTimeMilliseconds"),
+            TraceLoggingHResult(result, "HResult"));
+    }
+
+    void AddDownloadedBytes(uint64_t bytes)
+    {
+        s_downloadedBytes += bytes;
+    }
+
+    void RecordHttpRequest(bool http2)
+    {
+        ++s_httpRequests;
+        if (http2)
+        {
+            ++s_http2Requests;
+        }
+    }
+
+    void RecordInstallerCacheLookup(bool hit, uint64_t bytes)
+    {
+        if (hit)
+        {
+            ++s_installerCacheHits;
+            s_installerCacheHitBytes += bytes;
+        }
+        else
+        {
+            ++s_installerCacheMisses;
+        }
+    }
+
+    ActiveDownload::ActiveDownload()
+    {
+        ++s_activeDownloads;
+    }
+
+    ActiveDownload::~ActiveDownload()
+    {
+        --s_activeDownloads;
+    }
+
+    CountedMutex::CountedMutex(std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock{ s_countersLock };
+
+        auto itr = s_locks.find(name);
+        if (itr == s_locks.end())
+        {
+            itr = s_locks.emplace(std::string{ name }, std::make_unique<details::LockCounter>()).first;
+        }
+
+        m_counter = itr->second.get();
+    }
+
+    void CountedMutex::lock()
+    {
+        // Only a lock that is already held is timed, so an uncontended lock costs no more than the counts
+        if (!m_mutex.try_lock())
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_mutex.lock();
+            m_counter->WaitMicroseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            ++m_counter->ContendedAcquisitions;
+        }
+
+        ++m_counter->Acquisitions;
+    }
+
+    bool CountedMutex::try_lock()
+    {
+        if (m_mutex.try_lock())
+        {
+            ++m_counter->Acquisitions;
+            return true;
+        }
+
+        return false;
+    }
+
+    void RecordSourceOpen(std::string_view sourceName, std::chrono::nanoseconds duration, bool succeeded)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ s_countersLock };
+            AddToHistogram(s_sourceOpen, duration);
+        }
+
+        TraceLoggingWrite(
+            g_hTraceProvider,
+            "SourceOpen",
+            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+            AICLI_TraceLoggingStringView(sourceName, "Source"),
+            TraceLoggingUInt64(static_cast<UINT64>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()), "DurationMilliseconds"),
+            TraceLoggingBool(succeeded, "Succeeded"));
+    }
+
+    void RecordSearch(std::chrono::nanoseconds duration)
+    {
+        std::lock_guard<std::mutex> lock{ s_countersLock };
+        AddToHistogram(s_search, duration);
+    }
+
+    CounterSnapshot GetSnapshot()
+    {
+        CounterSnapshot result;
+        result.ActiveDownloads = s_activeDownloads;
+        result.DownloadedBytes = s_downloadedBytes;
+        result.HttpRequests = s_httpRequests;
+        result.Http2Requests = s_http2Requests;
+        result.InstallerCacheHits = s_installerCacheHits;
+        result.InstallerCacheMisses = s_installerCacheMisses;
+        result.InstallerCacheHitBytes = s_installerCacheHitBytes;
+
+        std::lock_guard<std::mutex> lock{ s_countersLock };
+
+        for (const auto& queue : s_queues)
+        {
+            result.Queues.emplace_back(queue.second);
+        }
+
+        result.QueueWait = s_queueWait;
+        result.QueueRun = s_queueRun;
+        result.SourceOpen = s_sourceOpen;
+        result.Search = s_search;
+
+        for (const auto& counter : s_locks)
+        {
+            LockContention& contention = result.Locks.emplace_back();
+            contention.Name = counter.first;
+            contention.Acquisitions = counter.second->Acquisitions;
+            contention.ContendedAcquisitions = counter.second->ContendedAcquisitions;
+            contention.WaitTime = std::chrono::microseconds{ counter.second->WaitMicroseconds };
+        }
+
+        return result;
+    }
+
+    void StartPublishing(std::chrono::milliseconds interval)
+    {
+        std::lock_guard<std::mutex> lock{ s_publisherLock };
+
+        if (!s_publisher)
+        {
+            AICLI_LOG(Core, Info, << "Publishing performance counters every " << interval.count() << "ms");
+            s_publisher = std::make_unique<Publisher>(interval);
+        }
+    }
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+    void TestHook_ResetCounters()
+    {
+        std::lock_guard<std::mutex> lock{ s_countersLock };
+        s_queues.clear();
+        s_queueWait = {};
+        s_queueRun = {};
+        s_sourceOpen = {};
+        s_search = {};
+        for (const auto& counter : s_locks)
+        {
+            counter.second->Acquisitions = 0;
+            counter.second->ContendedAcquisitions = 0;
+            counter.second->WaitMicroseconds = 0;
+        }
+        s_activeDownloads = 0;
+        s_downloadedBytes = 0;
+        s_installerCacheHits = 0;
+        s_installerCacheMisses = 0;
+        s_installerCacheHitBytes = 0;
+    }
+#endif
+}
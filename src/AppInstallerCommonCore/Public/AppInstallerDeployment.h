@@ -5,6 +5,10 @@
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Management.Deployment.h>
 
+#include <optional>
+#include <string>
+#include <string_view>
+
 namespace AppInstaller::Deployment
 {
     // Calls winrt::Windows::Management::Deployment::PackageManager::AddPackageAsync if skipSmartScreen is true,
@@ -19,12 +23,29 @@ namespace AppInstaller::Deployment
     // Otherwise, calls winrt::Windows::Management::Deployment::PackageManager::RequestAddPackageAsync.
     // If the Add function fails due to the package being in use, we fall back to stage and register, which allows
     // a deferred registration.
+    // The full name of the package is read from it unless given, which for a remote package is another set of requests.
     // Returns true if the registration was deferred; false if not.
     bool AddPackageWithDeferredFallback(
         const std::string& uri,
         bool skipSmartScreen,
+        IProgressCallback& callback,
+        const std::optional<std::string>& packageFullName = {});
+
+    // Calls winrt::Windows::Management::Deployment::PackageManager::StagePackageAsync, which does not check SmartScreen.
+    // The package is not available to the user until it is registered with RegisterStagedPackage.
+    void StagePackage(
+        const std::string& uri,
         IProgressCallback& callback);
 
+    // Calls winrt::Windows::Management::Deployment::PackageManager::RegisterPackageByFullNameAsync for a staged package.
+    // Returns true if the registration was deferred because the package is in use; false if not.
+    bool RegisterStagedPackage(
+        std::string_view packageFullName,
+        IProgressCallback& callback);
+
+    // Determines whether the package with the given full name is installed for the current user.
+    bool IsPackageInstalled(std::string_view packageFullName);
+
     // Calls winrt::Windows::Management::Deployment::PackageManager::RemovePackageAsync
     void RemovePackage(
         std::string_view packageFullName,
@@ -29,6 +29,8 @@ namespace AppInstaller::Utility
     {
         std::string DisplayName;
         std::string ContentId;
+        // Lets the download yield the network to other uses, for downloads that are only needed later.
+        bool BackgroundPriority = false;
     };
 
     // Downloads a file from the given URL and places it in the given location.
@@ -63,6 +65,12 @@ namespace AppInstaller::Utility
     // Determines if the given url is secured.
     bool IsUrlSecure(std::string_view url);
 
+    // Gets the urls to try, in order, when downloading the given url through the given mirrors.
+    // Each mirror is a base url that serves content by the host and path of its original url,
+    // e.g. https://mirror/base/ serves https://host/path/file as https://mirror/base/host/path/file.
+    // The original url is always the last of the urls.
+    std::vector<std::string> GetMirroredUrls(const std::string& url, const std::vector<std::string>& mirrors);
+
     // Apply Mark of the web if the target file is on NTFS, otherwise does nothing.
     void ApplyMotwIfApplicable(const std::filesystem::path& filePath, URLZONE zone);
 
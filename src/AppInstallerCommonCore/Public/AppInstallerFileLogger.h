@@ -3,14 +3,21 @@
 #pragma once
 #include <AppInstallerLogging.h>
 
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 namespace AppInstaller::Logging
 {
     // Logs to a file.
+    // Records are formatted on the calling thread, then written in batches by a background thread so that verbose
+    // logging does not stall the caller on file I/O. If the writer falls too far behind, new records are dropped
+    // and a count of them is written in their place.
     struct FileLogger : public ILogger
     {
         FileLogger();
@@ -22,8 +29,8 @@ namespace AppInstaller::Logging
         FileLogger(const FileLogger&) = delete;
         FileLogger& operator=(const FileLogger&) = delete;
 
-        FileLogger(FileLogger&&) = default;
-        FileLogger& operator=(FileLogger&&) = default;
+        FileLogger(FileLogger&&) = delete;
+        FileLogger& operator=(FileLogger&&) = delete;
 
         static std::string GetNameForPath(const std::filesystem::path& filePath);
 
@@ -41,8 +48,24 @@ namespace AppInstaller::Logging
         static void BeginCleanup(const std::filesystem::path& filePath);
 
     private:
+        // Opens the file and starts the writer thread.
+        void Open();
+
+        // Queues a complete record for the writer thread.
+        void Enqueue(std::string&& record) noexcept;
+
+        // The body of the writer thread.
+        void WriterThread() noexcept;
+
         std::string m_name;
         std::filesystem::path m_filePath;
         std::ofstream m_stream;
+
+        std::mutex m_queueLock;
+        std::condition_variable m_queueSignal;
+        std::vector<std::string> m_queue;
+        size_t m_droppedRecords = 0;
+        bool m_stopping = false;
+        std::thread m_writer;
     };
 }
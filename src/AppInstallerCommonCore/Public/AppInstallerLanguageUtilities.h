@@ -114,6 +114,9 @@ namespace AppInstaller
         // Return a value indicating whether the given enum is stored in the map.
         bool Contains(Enum e) const { return (m_data.find(e) != m_data.end()); }
 
+        // Removes the value, if there is one.
+        void Remove(Enum e) { m_data.erase(e); }
+
         // Gets the value.
         template <Enum E>
         mapping_t<E>& Get()
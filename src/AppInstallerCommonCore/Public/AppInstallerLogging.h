@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <sstream>
@@ -40,6 +42,22 @@
         } \
     } while (0, 0)
 
+// Logs a structured event, one of those in winget/TraceEvents.h, with the given arguments.
+// The arguments are stored in a compact binary form rather than being formatted as text, so that loggers which
+// support it can record the event without any string formatting.
+#define AICLI_TRACE(_channel_,_level_,_event_,...) \
+    do { \
+        auto _aicli_log_channel = AppInstaller::Logging::Channel:: _channel_; \
+        auto _aicli_log_level = AppInstaller::Logging::Level:: _level_; \
+        auto& _aicli_log_log = AppInstaller::Logging::Log(); \
+        if (_aicli_log_log.IsEnabled(_aicli_log_channel, _aicli_log_level)) \
+        { \
+            AppInstaller::Logging::TraceEventArguments _aicli_trace_args; \
+            _aicli_trace_args.AddAll(__VA_ARGS__); \
+            _aicli_log_log.WriteEvent(_aicli_log_channel, _aicli_log_level, AppInstaller::Logging::TraceEvents:: _event_, _aicli_trace_args); \
+        } \
+    } while (0, 0)
+
 namespace AppInstaller::Logging
 {
     // The channel that the log is from.
@@ -72,6 +90,65 @@ namespace AppInstaller::Logging
         Crit,
     };
 
+    // Describes a structured trace event.
+    // The format contains a {} placeholder for each argument, in order.
+    struct TraceEventDescriptor
+    {
+        uint16_t Id;
+        std::string_view Format;
+    };
+
+    // The encoded arguments of a structured trace event.
+    // Each argument is a type byte followed by the value:
+    //  Integer : int64_t
+    //  Double  : double
+    //  Bool    : uint8_t
+    //  String  : uint32_t length, followed by the UTF-8 bytes
+    struct TraceEventArguments
+    {
+        enum class Type : uint8_t
+        {
+            Integer = 1,
+            Double = 2,
+            Bool = 3,
+            String = 4,
+        };
+
+        TraceEventArguments() = default;
+
+        TraceEventArguments(const TraceEventArguments&) = delete;
+        TraceEventArguments& operator=(const TraceEventArguments&) = delete;
+
+        TraceEventArguments(TraceEventArguments&&) = delete;
+        TraceEventArguments& operator=(TraceEventArguments&&) = delete;
+
+        template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+        void Add(T value) { AddInteger(static_cast<int64_t>(value)); }
+
+        void Add(bool value);
+        void Add(double value);
+        void Add(std::string_view value);
+        void Add(const char* value) { Add(std::string_view{ value }); }
+
+        template <typename... T>
+        void AddAll(T&&... values) { (Add(std::forward<T>(values)), ...); }
+
+        // Gets the encoded arguments.
+        std::string_view Get() const;
+
+    private:
+        void AddInteger(int64_t value);
+        void Append(const void* data, size_t size);
+
+        // Most events have a few small arguments, which fit without allocating.
+        char m_inline[128];
+        size_t m_inlineSize = 0;
+        std::string m_overflow;
+    };
+
+    // Formats the event as text by replacing each placeholder with the next argument.
+    std::string FormatTraceEvent(const TraceEventDescriptor& descriptor, std::string_view arguments);
+
     // The interface that a log target must implement.
     struct ILogger
     {
@@ -85,6 +162,10 @@ namespace AppInstaller::Logging
 
         // Informs the logger of the given log with the intention that no buffering occurs (in winget code).
         virtual void WriteDirect(std::string_view message) noexcept = 0;
+
+        // Informs the logger of the given structured event.
+        // By default the event is formatted as text and passed to Write.
+        virtual void WriteEvent(Channel channel, Level level, const TraceEventDescriptor& descriptor, std::string_view arguments) noexcept;
     };
 
     // This type contains the set of loggers that diagnostic logging will be sent to.
@@ -144,11 +225,15 @@ namespace AppInstaller::Logging
         // Use to make large logs more efficient by writing directly to the output streams.
         void WriteDirect(Channel channel, Level level, std::string_view message);
 
+        // Writes a structured event, if the given channel and level are enabled.
+        void WriteEvent(Channel channel, Level level, const TraceEventDescriptor& descriptor, const TraceEventArguments& arguments);
+
     private:
 
         std::vector<std::unique_ptr<ILogger>> m_loggers;
-        uint64_t m_enabledChannels = 0;
-        Level m_enabledLevel = Level::Info;
+        // Checked on every log call from any thread that shares this logger, so they are read without any lock.
+        std::atomic<uint64_t> m_enabledChannels = 0;
+        std::atomic<Level> m_enabledLevel = Level::Info;
     };
 
     DiagnosticLogger& Log();
@@ -161,6 +246,9 @@ namespace AppInstaller::Logging
     // Adds the trace logger to the DiagnosticLogger.
     void AddTraceLogger();
 
+    // Adds the binary trace logger to the DiagnosticLogger.
+    void AddBinaryTraceLogger();
+
     // Starts a background task to clean up old log files.
     void BeginLogFileCleanup();
 
@@ -42,6 +42,9 @@ namespace AppInstaller::Msix
     // Gets the package location from the given full name.
     std::optional<std::filesystem::path> GetPackageLocationFromFullName(std::string_view fullName);
 
+    // Gets the package version, as a dotted quad, from the given manifest file.
+    std::string GetPackageVersionFromManifestFile(const std::filesystem::path& manifest);
+
     // MsixInfo class handles all appx/msix related query.
     struct MsixInfo
     {
@@ -61,6 +64,13 @@ namespace AppInstaller::Msix
         // Full content of AppxSignature.p7x
         std::vector<byte> GetSignature();
 
+        // Verifies that the package is signed by a trusted code signing certificate whose subject is the package publisher,
+        // and that the signature covers the package block map. Every file read from the package is checked against the
+        // block map, so this ties the signature to any content extracted from the package without deploying it.
+        // If requireMicrosoftRoot is set, the certificate chain must also end in a Microsoft root.
+        // Throws if the signature is not valid.
+        void ValidateSignature(bool requireMicrosoftRoot = false);
+
         // Gets the package full name.
         std::wstring GetPackageFullNameWide();
         std::string GetPackageFullName();
@@ -70,6 +80,13 @@ namespace AppInstaller::Msix
 
         bool IsNewerThan(const winrt::Windows::ApplicationModel::PackageVersion& otherVersion);
 
+        // Gets the package version, as a dotted quad.
+        std::string GetPackageVersion();
+
+        // Determines whether the given file has the same content as the package file, using the hashes in the package block map.
+        // This allows a file that was produced by other means to be verified without reading the package file itself.
+        bool IsFileContentMatch(std::string_view packageFile, const std::filesystem::path& file);
+
         // Writes the package file to the given path.
         void WriteToFile(std::string_view packageFile, const std::filesystem::path& target, IProgressCallback& progress);
 
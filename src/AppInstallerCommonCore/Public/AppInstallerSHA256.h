@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
@@ -53,6 +54,10 @@ namespace AppInstaller::Utility {
         // Computes the hash from a given stream.
         static HashBuffer ComputeHash(std::istream& in);
 
+        // Computes the hash of the given file, reading ahead while hashing.
+        // Prefer this over the stream overload for large files.
+        static HashBuffer ComputeHashFromFile(const std::filesystem::path& path);
+
         static std::string ConvertToString(const HashBuffer& hashBuffer);
 
         static HashBuffer ConvertToBytes(const std::string& hashStr);
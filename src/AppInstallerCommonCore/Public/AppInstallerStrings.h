@@ -12,9 +12,15 @@ namespace AppInstaller::Utility
     // Converts the given UTF16 string to UTF8
     std::string ConvertToUTF8(std::wstring_view input);
 
+    // Converts the given UTF16 string to UTF8 into the output, reusing its capacity.
+    void ConvertToUTF8(std::wstring_view input, std::string& output);
+
     // Converts the given UTF8 string to UTF16
     std::wstring ConvertToUTF16(std::string_view input, UINT codePage = CP_UTF8);
 
+    // Converts the given UTF8 string to UTF16 into the output, reusing its capacity.
+    void ConvertToUTF16(std::string_view input, std::wstring& output, UINT codePage = CP_UTF8);
+
     // Normalizes a UTF8 string to the given form.
     std::string Normalize(std::string_view input, NORM_FORM form = NORM_FORM::NormalizationKC);
 
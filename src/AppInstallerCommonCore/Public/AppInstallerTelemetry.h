@@ -4,6 +4,8 @@
 #include <AppInstallerLanguageUtilities.h>
 #include <wil/result_macros.h>
 
+#include <chrono>
+#include <memory>
 #include <string_view>
 #include <vector>
 #include <cguid.h>
@@ -15,6 +17,11 @@ namespace AppInstaller::Settings
 
 namespace AppInstaller::Logging
 {
+    namespace details
+    {
+        struct TelemetryEventAggregator;
+    }
+
     enum class FailureTypeEnum : UINT32
     {
         None = 0x0,
@@ -132,6 +139,10 @@ namespace AppInstaller::Logging
     {
         TelemetryTraceLogger();
 
+        // If aggregateEvents is false, events that are normally coalesced and written from a background thread are written immediately.
+        // This is needed for a logger that may be destroyed while the loader lock is held, as the background thread could not be waited on.
+        explicit TelemetryTraceLogger(bool aggregateEvents);
+
         ~TelemetryTraceLogger();
 
         TelemetryTraceLogger(const TelemetryTraceLogger&) = default;
@@ -150,7 +161,8 @@ namespace AppInstaller::Logging
         // Return address of m_parentActivityId
         const GUID* GetParentActivityId() const;
 
-        // Capture if UserSettings is enabled and set user profile path
+        // Capture if UserSettings is enabled and set user profile path.
+        // This is otherwise done when the first event is logged while the provider is enabled, so that the settings are only loaded when needed.
         void Initialize();
 
         // Try to capture if UserSettings is enabled and set user profile path, returns whether the action is successfully completed.
@@ -217,6 +229,10 @@ namespace AppInstaller::Logging
         // Logs the Search Result
         void LogSearchResultCount(uint64_t resultCount) const noexcept;
 
+        // Logs a search of a single source, which can happen once for every installed package during correlation.
+        // These are coalesced per source and purpose, and written periodically from a background thread as summaries.
+        void LogSourceSearch(std::string_view sourceIdentifier, std::string_view purpose, uint64_t resultCount, bool failed, std::chrono::nanoseconds duration) const noexcept;
+
         // Logs a mismatch between the expected and actual hash values.
         void LogInstallerHashMismatch(
             std::string_view id,
@@ -255,16 +271,16 @@ namespace AppInstaller::Logging
     protected:
         bool IsTelemetryEnabled() const noexcept;
 
-        void InitializeInternal(const AppInstaller::Settings::UserSettings& userSettings);
+        void InitializeInternal(const AppInstaller::Settings::UserSettings& userSettings) const;
 
         // Used to anonymize a string to the best of our ability.
         // Should primarily be used on failure messages or paths if needed.
         std::wstring AnonymizeString(const wchar_t* input) const noexcept;
         std::wstring AnonymizeString(std::wstring_view input) const noexcept;
 
-        bool m_isSettingEnabled = true;
+        mutable bool m_isSettingEnabled = true;
         CopyConstructibleAtomic<bool> m_isRuntimeEnabled{ true };
-        CopyConstructibleAtomic<bool> m_isInitialized{ false };
+        mutable CopyConstructibleAtomic<bool> m_isInitialized{ false };
 
         CopyConstructibleAtomic<uint32_t> m_executionStage{ 0 };
 
@@ -274,10 +290,13 @@ namespace AppInstaller::Logging
         std::string m_caller;
 
         // Data that is needed by AnonymizeString
-        std::wstring m_userProfile;
+        mutable std::wstring m_userProfile;
 
         mutable TelemetrySummary m_summary;
 
+        // Shared with sub loggers, so that the events of an entire operation are coalesced together.
+        std::shared_ptr<details::TelemetryEventAggregator> m_aggregator;
+
         // TODO: This and all related code could be removed after transition to summary event in back end.
         uint32_t m_subExecutionId;
     };
@@ -76,8 +76,16 @@ namespace AppInstaller::Utility
         const std::vector<Part>& GetParts() const { return m_parts; }
 
     protected:
+        // Updates the cached state that is derived from the parts; must be called whenever they change.
+        void CacheComparisonState();
+
         std::string m_version;
         std::vector<Part> m_parts;
+
+        // Derived from the parts so that comparisons do not need to look at the strings when they can be avoided.
+        bool m_isLatest = false;
+        bool m_isUnknown = false;
+        bool m_hasOther = false;
     };
 
     // A channel string; existing solely to give a type.
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerLogging.h>
+#include <winget/TraceEvents.h>
+#include <wil/resource.h>
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace AppInstaller::Logging
+{
+    // Logs to a memory mapped file in a compact binary form.
+    // Structured events are stored as their id and encoded arguments, so logging them requires no text formatting.
+    // The file has a fixed capacity; once it is full, further records are counted and dropped.
+    //
+    // All values are little endian. The file begins with a header:
+    //  char[8]  Magic ("WGTRACE\0")
+    //  uint32_t Version
+    //  uint32_t HeaderSize
+    //  uint64_t Capacity       : the size of the file, including the header
+    //  uint64_t NextOffset     : the offset at which the next record will be written (may exceed capacity)
+    //  uint64_t DroppedRecords
+    // which is followed by records, each of which begins with:
+    //  uint32_t Size           : the size of the record, including this header; zero marks the end of the records
+    //  uint8_t  Type           : 1 = message, 2 = event definition, 3 = event
+    //  uint8_t  Channel
+    //  uint8_t  Level
+    //  uint8_t  Reserved
+    //  uint32_t ThreadId
+    //  int64_t  Timestamp      : in 100 nanosecond units since 1970-01-01 UTC
+    // and is followed by the payload:
+    //  message          : the UTF-8 text
+    //  event definition : uint16_t id, followed by the UTF-8 format, written before the first event with that id
+    //  event            : uint16_t id, followed by the encoded arguments (see TraceEventArguments)
+    // tools/Decode-WinGetTrace.ps1 converts a trace into the same text that the file logger would have written.
+    struct BinaryTraceLogger : public ILogger
+    {
+        BinaryTraceLogger();
+        explicit BinaryTraceLogger(const std::filesystem::path& filePath, size_t capacity = DefaultCapacity);
+
+        ~BinaryTraceLogger();
+
+        BinaryTraceLogger(const BinaryTraceLogger&) = delete;
+        BinaryTraceLogger& operator=(const BinaryTraceLogger&) = delete;
+
+        BinaryTraceLogger(BinaryTraceLogger&&) = delete;
+        BinaryTraceLogger& operator=(BinaryTraceLogger&&) = delete;
+
+        static constexpr size_t DefaultCapacity = 16 * 1024 * 1024;
+
+        static std::string_view DefaultExt();
+
+        // Gets the path of the trace file.
+        const std::filesystem::path& GetPath() const { return m_filePath; }
+
+        // ILogger
+        std::string GetName() const override;
+
+        void Write(Channel channel, Level level, std::string_view message) noexcept override;
+
+        void WriteDirect(std::string_view message) noexcept override;
+
+        void WriteEvent(Channel channel, Level level, const TraceEventDescriptor& descriptor, std::string_view arguments) noexcept override;
+
+    private:
+        enum class RecordType : uint8_t
+        {
+            Message = 1,
+            EventDefinition = 2,
+            Event = 3,
+        };
+
+        void Open(size_t capacity);
+
+        // Reserves space for and writes a single record; the payload is the concatenation of the given parts.
+        void WriteRecord(RecordType type, Channel channel, Level level, std::string_view first, std::string_view second = {}) noexcept;
+
+        std::string m_name;
+        std::filesystem::path m_filePath;
+        wil::unique_hfile m_file;
+        wil::unique_handle m_mapping;
+        wil::unique_mapview_ptr<uint8_t> m_view;
+        size_t m_capacity = 0;
+        std::array<std::atomic_bool, TraceEvents::MaximumId> m_definitionsWritten{};
+    };
+}
@@ -13,6 +13,10 @@ namespace AppInstaller::Manifest
 
         DependencyGraph(const Dependency& root, std::function<const DependencyList(const Dependency&)> infoFunction);
 
+        // Called with each breadth first frontier before its nodes are evaluated, so that the information for all of them
+        // can be retrieved at once; the information function is still called for each node, in the same order as without it.
+        void SetPrefetchFunction(std::function<void(const std::vector<Dependency>&)> prefetchFunction);
+
         void BuildGraph();
 
         void AddNode(const Dependency& node);
@@ -27,16 +31,18 @@ namespace AppInstaller::Manifest
 
         std::vector<Dependency> GetInstallationOrder();
 
-    private:
-        // TODO make this function iterative
-        bool HasLoopDFS(std::set<Dependency> visited, const Dependency& node);
+        // Gets the nodes of the first loop found, starting and ending with the same node; empty if there is no loop.
+        std::vector<Dependency> GetLoop();
 
+    private:
         const Dependency& m_root;
         std::map<Dependency, std::set<Dependency>> m_adjacents;
         std::function<const DependencyList(const Dependency&)> getDependencies;
+        std::function<void(const std::vector<Dependency>&)> m_prefetch;
         bool m_HasLoop = false;
         bool m_rootDependencyEvaluated = false;
         std::vector<Dependency> m_installationOrder;
+        std::vector<Dependency> m_loop;
         std::vector<Dependency> m_toCheck;
     };
 }
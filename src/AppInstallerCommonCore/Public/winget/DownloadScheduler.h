@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerDownloader.h>
+#include <AppInstallerProgress.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Utility
+{
+    // The classes of downloads, from the lowest priority to the highest. A download waiting for a connection
+    // to a host holds back the waiting downloads of lower classes to the same host.
+    enum class DownloadPriority
+    {
+        // Source indexes, and installers downloaded in the background ahead of their installs.
+        Index,
+        Manifest,
+        // Installers that an install is waiting on.
+        Installer,
+    };
+
+    // Gets the priority class of a download.
+    DownloadPriority GetDownloadPriority(DownloadType type, bool backgroundPriority = false);
+
+    // Gets the maximum number of connections to a single host, from the settings.
+    uint32_t GetMaximumConnectionsPerHost();
+
+    // A connection to a host granted by the download scheduler, which limits the number of connections to each host
+    // of the process and gives them to the waiting downloads in priority order. The connection is returned on destruction.
+    struct DownloadSlot
+    {
+        // Waits for a connection to the host of the url. The slot is empty if the progress is cancelled while waiting.
+        // Urls without a host, such as local paths, do not need a connection and always get one immediately.
+        DownloadSlot(std::string_view url, DownloadPriority priority, IProgressCallback& progress);
+
+        DownloadSlot(const DownloadSlot&) = delete;
+        DownloadSlot& operator=(const DownloadSlot&) = delete;
+
+        DownloadSlot(DownloadSlot&&) = delete;
+        DownloadSlot& operator=(DownloadSlot&&) = delete;
+
+        ~DownloadSlot();
+
+        // Determines if the connection was granted.
+        explicit operator bool() const { return m_acquired; }
+
+    private:
+        std::string m_host;
+        bool m_acquired = false;
+    };
+
+    // Paces the downloads of the process so that together they stay under the bandwidth limit of the settings, if there is one.
+    // Called by each download with the number of bytes it has just read; sleeps as long as needed to keep to the limit.
+    void PaceDownloadedBytes(uint64_t bytes);
+}
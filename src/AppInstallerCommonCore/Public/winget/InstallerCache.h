@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerSHA256.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+
+namespace AppInstaller::Utility
+{
+    // A content addressed store of installer files, keyed by the SHA256 hash of their contents.
+    // The location may be shared by many machines (for instance on a UNC path), so every operation
+    // tolerates files being added and removed concurrently by others.
+    struct InstallerCache
+    {
+        InstallerCache(std::filesystem::path root, uint64_t maximumSizeInBytes);
+
+        // Gets the cache configured in the user settings, if there is one.
+        static std::optional<InstallerCache> GetUserCache();
+
+        // Gets the root directory of the cache.
+        const std::filesystem::path& GetRoot() const { return m_root; }
+
+        // Copies the cached file with the given hash to the target path.
+        // The copy is verified against the hash; a cached file that does not match is removed.
+        // Returns true if the target now holds a verified copy of the content.
+        bool TryGet(const SHA256::HashBuffer& hash, const std::filesystem::path& target) const;
+
+        // Adds the file, which must already be verified to have the given hash, to the cache.
+        // Least recently used entries are then evicted to keep the cache within its maximum size.
+        void Add(const SHA256::HashBuffer& hash, const std::filesystem::path& source) const;
+
+        // Evicts least recently used entries until the cache is within its maximum size.
+        void Trim() const;
+
+    private:
+        std::filesystem::path GetEntryPath(const SHA256::HashBuffer& hash) const;
+
+        std::filesystem::path m_root;
+        uint64_t m_maximumSizeInBytes = 0;
+    };
+}
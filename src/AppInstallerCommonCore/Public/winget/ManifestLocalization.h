@@ -3,6 +3,11 @@
 #pragma once
 #include <AppInstallerStrings.h>
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <variant>
 
 namespace AppInstaller::Manifest
@@ -77,23 +82,30 @@ namespace AppInstaller::Manifest
         template <Localization L>
         void Add(typename details::LocalizationMapping<L>::value_t&& v)
         {
+            Materialize();
             m_data[L].emplace<details::LocalizationIndex(L)>(std::forward<typename details::LocalizationMapping<L>::value_t>(v));
         }
         template <Localization L>
         void Add(const typename details::LocalizationMapping<L>::value_t& v)
         {
+            Materialize();
             m_data[L].emplace<details::LocalizationIndex(L)>(v);
         }
 
         // Return a value indicating whether the given localization type exists.
-        bool Contains(Localization l) const { return (m_data.find(l) != m_data.end()); }
+        bool Contains(Localization l) const
+        {
+            const auto& data = GetData();
+            return (data.find(l) != data.end());
+        }
 
         // Gets the localization value if exists, otherwise empty for easier access
         template <Localization L>
         typename details::LocalizationMapping<L>::value_t Get() const
         {
-            auto itr = m_data.find(L);
-            if (itr == m_data.end())
+            const auto& data = GetData();
+            auto itr = data.find(L);
+            if (itr == data.end())
             {
                 return {};
             }
@@ -105,7 +117,9 @@ namespace AppInstaller::Manifest
 
         void ReplaceOrMergeWith(const ManifestLocalization& other)
         {
-            for (auto const& entry : other.m_data)
+            Materialize();
+
+            for (auto const& entry : other.GetData())
             {
                 this->m_data[entry.first] = entry.second;
             }
@@ -113,7 +127,61 @@ namespace AppInstaller::Manifest
             this->Locale = other.Locale;
         }
 
+        // Defers populating the localization data until it is first read, leaving its source unparsed until then.
+        // The function is called at most once across all copies of this object, with an empty localization to add the data to.
+        void SetDeferredData(std::function<void(ManifestLocalization&)> populate)
+        {
+            m_data.clear();
+            m_deferred = std::make_shared<DeferredData>();
+            m_deferred->Populate = std::move(populate);
+        }
+
+        // Returns a value indicating whether the localization data is yet to be populated.
+        bool IsDeferred() const { return m_deferred && !m_deferred->IsPopulated; }
+
     private:
-        std::map<Localization, details::LocalizationVariant> m_data;
+        using data_t = std::map<Localization, details::LocalizationVariant>;
+
+        // The data populated on first use; shared so that copies made before then do not each parse the source.
+        struct DeferredData
+        {
+            std::once_flag Once;
+            std::atomic_bool IsPopulated = false;
+            std::function<void(ManifestLocalization&)> Populate;
+            data_t Data;
+        };
+
+        const data_t& GetData() const
+        {
+            if (!m_deferred)
+            {
+                return m_data;
+            }
+
+            std::call_once(m_deferred->Once, [this]()
+                {
+                    ManifestLocalization populated;
+                    m_deferred->Populate(populated);
+                    m_deferred->Data = std::move(populated.m_data);
+                    m_deferred->Populate = nullptr;
+                    m_deferred->IsPopulated = true;
+                });
+
+            return m_deferred->Data;
+        }
+
+        // Takes a private copy of any deferred data so that it can be modified.
+        void Materialize()
+        {
+            if (m_deferred)
+            {
+                const auto& data = GetData();
+                m_data = (m_deferred.use_count() == 1) ? std::move(m_deferred->Data) : data;
+                m_deferred.reset();
+            }
+        }
+
+        data_t m_data;
+        std::shared_ptr<DeferredData> m_deferred;
     };
 }
\ No newline at end of file
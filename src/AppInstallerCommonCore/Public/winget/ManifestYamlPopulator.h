@@ -24,13 +24,27 @@ namespace AppInstaller::Manifest
         struct FieldProcessInfo
         {
             FieldProcessInfo(std::string name, std::function<std::vector<ValidationError>(const YAML::Node&)> func, bool requireVerifiedPublisher = false) :
-                Name(std::move(name)), ProcessFunc(func), RequireVerifiedPublisher(requireVerifiedPublisher) {}
+                Name(std::move(name)), NameHash(HashFieldName(Name)), ProcessFunc(func), RequireVerifiedPublisher(requireVerifiedPublisher) {}
 
             std::string Name;
+            // Keys are only compared with the names that have the same hash.
+            uint64_t NameHash;
             std::function<std::vector<ValidationError>(const YAML::Node&)> ProcessFunc;
             bool RequireVerifiedPublisher = false;
         };
 
+        // Hashes a field name or key (FNV-1a), ignoring ASCII case as the keys are matched to the fields.
+        static constexpr uint64_t HashFieldName(std::string_view name)
+        {
+            uint64_t result = 0xcbf29ce484222325;
+            for (char c : name)
+            {
+                result ^= static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+                result *= 0x100000001b3;
+            }
+            return result;
+        }
+
         std::vector<FieldProcessInfo> RootFieldInfos;
         std::vector<FieldProcessInfo> InstallerFieldInfos;
         std::vector<FieldProcessInfo> SwitchesFieldInfos;
@@ -84,6 +98,14 @@ namespace AppInstaller::Manifest
         std::vector<ValidationError> ProcessAppsAndFeaturesEntriesNode(const YAML::Node& appsAndFeaturesEntriesNode);
         std::vector<ValidationError> ProcessExpectedReturnCodesNode(const YAML::Node& returnCodesNode);
 
+        // Populates a single additional localization; used to populate deferred localizations on first use.
+        static void PopulateLocalization(
+            const YAML::Node& localizationNode,
+            ManifestLocalization& localization,
+            const ManifestVer& manifestVersion,
+            ManifestValidateOption validateOption,
+            bool isMergedManifest);
+
         std::vector<ValidationError> PopulateManifestInternal(
             const YAML::Node& rootNode,
             Manifest& manifest,
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <optional>
+
+
+namespace AppInstaller::Performance
+{
+    // Gets the memory budget set by the user, in bytes; there is no budget when this is empty.
+    std::optional<uint64_t> GetMemoryBudget();
+
+    // Gets the limit on the page cache of each SQLite connection, in KiB, derived from the budget.
+    // When this is empty, connections use the SQLite default.
+    std::optional<uint32_t> GetSQLiteCacheSizeLimitInKB();
+
+    // Gets the limit on the total size of the package read cache, in bytes, derived from the budget.
+    std::optional<uint64_t> GetPackageReadCacheLimit();
+
+    // Gets the peak working set of the process so far, in bytes.
+    uint64_t GetPeakWorkingSet();
+
+    // Logs the peak working set of the process, with a warning if it is over the budget.
+    void LogPeakWorkingSet();
+}
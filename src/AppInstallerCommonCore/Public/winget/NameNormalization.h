@@ -65,6 +65,7 @@ namespace AppInstaller::Utility
 
     // Helper that manages the lifetime of the internals required to
     // execute the name normalization.
+    // The internals of a version are shared by all of the normalizers of the process, and can be used from any thread.
     struct NameNormalizer
     {
         NameNormalizer(NormalizationVersion version);
@@ -74,6 +75,6 @@ namespace AppInstaller::Utility
         std::string NormalizePublisher(std::string_view publisher) const;
 
     private:
-        std::unique_ptr<details::INameNormalizer> m_normalizer;
+        std::shared_ptr<const details::INameNormalizer> m_normalizer;
     };
 }
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Performance
+{
+    // Begins collecting timings; until this is called, timers do nothing.
+    void EnableCollection();
+
+    // Determines whether timings are being collected.
+    bool IsCollectionEnabled();
+
+    namespace details
+    {
+        struct TimingNode;
+    }
+
+    // Records the time spent in a scope and the number of times it was entered.
+    // Scopes are nested beneath the innermost enclosing scope on the same thread; those with no
+    // enclosing scope on their thread, such as the work done by background threads, are recorded at the top level.
+    struct ScopedTimer
+    {
+        // The function is for scopes that are plain functions without a name, and is resolved to a name
+        // only when the summary is created.
+        explicit ScopedTimer(std::string_view name, const void* function = nullptr);
+
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ScopedTimer(ScopedTimer&&) = delete;
+        ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+    private:
+        details::TimingNode* m_node = nullptr;
+        details::TimingNode* m_previous = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // The timings recorded for a scope.
+    struct TimingSummary
+    {
+        std::string Name;
+        size_t Count = 0;
+        std::chrono::nanoseconds Total{};
+        std::vector<TimingSummary> Children;
+    };
+
+    // Gets the timings recorded so far, with scopes in the order that they were first entered.
+    std::vector<TimingSummary> GetTimingSummary();
+
+    // Converts the summary to compact JSON.
+    std::string TimingSummaryToJson(const std::vector<TimingSummary>& summary);
+}
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Performance::Counters
+{
+    using namespace std::chrono_literals;
+
+    // The upper bounds of the buckets of the latency histograms; the last bucket holds everything slower.
+    inline constexpr std::array<std::chrono::milliseconds, 8> LatencyBucketBounds{ 10ms, 50ms, 100ms, 250ms, 500ms, 1000ms, 5000ms, 30000ms };
+
+    // A count of operations by how long they took.
+    struct LatencyHistogram
+    {
+        uint64_t Count = 0;
+        std::chrono::microseconds Total{};
+        std::chrono::microseconds Maximum{};
+        std::array<uint64_t, LatencyBucketBounds.size() + 1> Buckets{};
+    };
+
+    // The depth of one of the orchestrator queues.
+    struct QueueDepth
+    {
+        std::string Name;
+        size_t QueuedItems = 0;
+        size_t RunningItems = 0;
+    };
+
+    // How often the locks of a name were taken, and how often and for how long their callers had to wait for them.
+    struct LockContention
+    {
+        std::string Name;
+        uint64_t Acquisitions = 0;
+        uint64_t ContendedAcquisitions = 0;
+        std::chrono::microseconds WaitTime{};
+    };
+
+    // The values of all of the counters at a point in time.
+    struct CounterSnapshot
+    {
+        std::vector<QueueDepth> Queues;
+        size_t ActiveDownloads = 0;
+        uint64_t DownloadedBytes = 0;
+        uint64_t HttpRequests = 0;
+        uint64_t Http2Requests = 0;
+        uint64_t InstallerCacheHits = 0;
+        uint64_t InstallerCacheMisses = 0;
+        uint64_t InstallerCacheHitBytes = 0;
+        LatencyHistogram QueueWait;
+        LatencyHistogram QueueRun;
+        LatencyHistogram SourceOpen;
+        LatencyHistogram Search;
+        std::vector<LockContention> Locks;
+    };
+
+    // Sets the current depth of an orchestrator queue.
+    void SetQueueDepth(std::string_view queueName, size_t queuedItems, size_t runningItems);
+
+    // Records an item that has finished running in an orchestrator queue, writing an event for it.
+    void RecordQueueItem(std::string_view queueName, std::wstring_view packageId, std::chrono::nanoseconds waitTime, std::chrono::nanoseconds runTime, HRESULT result);
+
+    // Adds bytes received by a download.
+    void AddDownloadedBytes(uint64_t bytes);
+
+    // Records an http request made by a download, and whether it was sent over HTTP/2.
+    // Requests to the same host over HTTP/2 share a single connection.
+    void RecordHttpRequest(bool http2);
+
+    // Records a lookup in the installer cache, and the size of the installer that it provided on a hit.
+    void RecordInstallerCacheLookup(bool hit, uint64_t bytes = 0);
+
+    // Counts a download as active for the lifetime of the object.
+    struct ActiveDownload
+    {
+        ActiveDownload();
+        ~ActiveDownload();
+
+        ActiveDownload(const ActiveDownload&) = delete;
+        ActiveDownload& operator=(const ActiveDownload&) = delete;
+
+        ActiveDownload(ActiveDownload&&) = delete;
+        ActiveDownload& operator=(ActiveDownload&&) = delete;
+    };
+
+    namespace details
+    {
+        struct LockCounter;
+    }
+
+    // A mutex that counts how often, and for how long, its callers have to wait for it.
+    // The mutexes of the same name are counted together, so that each instance of a type of lock does not need its own counter.
+    struct CountedMutex
+    {
+        CountedMutex(std::string_view name);
+
+        CountedMutex(const CountedMutex&) = delete;
+        CountedMutex& operator=(const CountedMutex&) = delete;
+
+        CountedMutex(CountedMutex&&) = delete;
+        CountedMutex& operator=(CountedMutex&&) = delete;
+
+        void lock();
+        bool try_lock();
+        void unlock() { m_mutex.unlock(); }
+
+    private:
+        std::mutex m_mutex;
+        details::LockCounter* m_counter;
+    };
+
+    // Records the opening of a source, writing an event for it.
+    void RecordSourceOpen(std::string_view sourceName, std::chrono::nanoseconds duration, bool succeeded);
+
+    // Records the duration of a search.
+    void RecordSearch(std::chrono::nanoseconds duration);
+
+    // Gets the current values of the counters.
+    CounterSnapshot GetSnapshot();
+
+    // Begins writing the counters as an event at the given interval, for the rest of the lifetime of the process.
+    // Nothing is written while no trace session is listening. Used by the COM server.
+    void StartPublishing(std::chrono::milliseconds interval = 5000ms);
+}
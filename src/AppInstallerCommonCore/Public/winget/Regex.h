@@ -3,6 +3,7 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
 
 
@@ -52,4 +53,32 @@ namespace AppInstaller::Regex
         struct impl;
         std::unique_ptr<impl> pImpl;
     };
+
+    // A compiled regular expression that any number of threads can use at the same time.
+    // An ICU expression holds the state of its current match, so each thread matches with its own clone
+    // of the compiled pattern; the clone is made on the first use by the thread and kept for the life of the thread.
+    struct SharedExpression
+    {
+        SharedExpression(std::string_view pattern, Options options = Options::None);
+
+        SharedExpression(const SharedExpression&) = delete;
+        SharedExpression& operator=(const SharedExpression&) = delete;
+
+        SharedExpression(SharedExpression&&) = default;
+        SharedExpression& operator=(SharedExpression&&) = default;
+
+        ~SharedExpression() = default;
+
+        // Gets the clone of the expression for the current thread.
+        const Expression& ForCurrentThread() const;
+
+        // The same as those of Expression, using the clone for the current thread.
+        bool IsMatch(std::wstring_view input) const { return ForCurrentThread().IsMatch(input); }
+        std::wstring Replace(std::wstring_view input, std::wstring_view replacement) const { return ForCurrentThread().Replace(input, replacement); }
+        void ForEach(std::wstring_view input, const std::function<bool(bool, std::wstring_view)>& f) const { ForCurrentThread().ForEach(input, f); }
+
+    private:
+        // Only ever cloned, never matched with, so that it is never modified.
+        std::shared_ptr<const Expression> m_compiled;
+    };
 }
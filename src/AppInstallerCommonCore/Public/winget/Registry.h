@@ -3,9 +3,11 @@
 #pragma once
 #include <wil/resource.h>
 
+#include <chrono>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 
@@ -65,6 +67,7 @@ namespace AppInstaller::Registry
 
     struct Key;
     struct ValueList;
+    struct ValueMap;
 
     // A registry value.
     struct Value
@@ -180,6 +183,23 @@ namespace AppInstaller::Registry
         wil::shared_hkey m_key;
     };
 
+    // The values of a key, read together so that looking up each of them does not need another registry call.
+    struct ValueMap
+    {
+        friend Key;
+
+        // Gets the value with the given name, or null if there is none; names are case insensitive.
+        const Value* operator[](std::wstring_view name) const;
+
+        size_t size() const { return m_values.size(); }
+
+    private:
+        ValueMap() = default;
+
+        // Keys rarely have more than a few dozen values, so a search is as fast as a lookup.
+        std::vector<std::pair<std::wstring, Value>> m_values;
+    };
+
     // A registry key.
     struct Key
     {
@@ -201,6 +221,10 @@ namespace AppInstaller::Registry
             // Opens the subkey.
             Key Open() const;
 
+            // Gets the last time that the subkey, or any of its values, was written.
+            // This is retrieved during enumeration, so it does not require opening the subkey.
+            std::chrono::system_clock::time_point GetLastWriteTime() const;
+
             operator bool() const { return m_parentKey.operator bool(); }
 
         private:
@@ -216,6 +240,7 @@ namespace AppInstaller::Registry
             wil::shared_hkey m_parentKey;
             REGSAM m_access = KEY_READ;
             std::wstring m_subKeyName;
+            FILETIME m_lastWriteTime{};
         };
 
         struct const_iterator
@@ -253,6 +278,16 @@ namespace AppInstaller::Registry
 
         ValueList Values() const;
 
+        // Reads all of the values in a single pass, for when several of them are needed.
+        ValueMap ReadAllValues() const;
+
+        // Gets the last time that the key, or any of its values, was written.
+        std::chrono::system_clock::time_point GetLastWriteTime() const;
+
+        // Requests that the event be signaled the next time that the key, any of its subkeys, or any of their values change.
+        // The request is for a single change; it must be made again to continue to be notified.
+        void NotifyOnChange(HANDLE event) const;
+
         operator bool() const { return m_key.operator bool(); }
 
         // Open a Key; will return an empty Key if the subkey does not exist.
@@ -266,4 +301,7 @@ namespace AppInstaller::Registry
         wil::shared_hkey m_key;
         REGSAM m_access = KEY_READ;
     };
+
+    // Gets the number of registry API calls that the process has made through these types.
+    size_t GetCallCount();
 }
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -60,6 +61,21 @@ namespace AppInstaller::Settings
         std::string_view Name;
     };
 
+    // Identifies a version of the contents of a stream, as seen by every process of the user in the session.
+    // Every change made through Stream::Set or Stream::Remove produces a new version; changes made by other means are not seen.
+    struct StreamVersion
+    {
+        // Identifies the shared counters that the version came from; zero if they were not available.
+        uint64_t Instance = 0;
+        uint64_t Counter = 0;
+
+        // An unavailable version is never equal to another, so that nothing is reused based on it.
+        bool IsAvailable() const { return Instance != 0; }
+
+        bool operator==(const StreamVersion& other) const { return IsAvailable() && Instance == other.Instance && Counter == other.Counter; }
+        bool operator!=(const StreamVersion& other) const { return !(*this == other); }
+    };
+
     // A setting stream; provides access to functionality on the stream.
     struct Stream
     {
@@ -70,6 +86,8 @@ namespace AppInstaller::Settings
         constexpr static StreamDefinition UserSources{ Type::Secure, "user_sources"sv };
         // The metadata about all sources.
         constexpr static StreamDefinition SourcesMetadata{ Type::Standard, "sources_metadata"sv };
+        // The last computed list of available upgrades.
+        constexpr static StreamDefinition UpgradeSnapshot{ Type::Standard, "upgrade_snapshot"sv };
         // The primary user settings file.
         constexpr static StreamDefinition PrimaryUserSettings{ Type::UserFile, "settings.json"sv };
         // The backup user settings file.
@@ -101,6 +119,10 @@ namespace AppInstaller::Settings
         // Gets the path to the stream.
         std::filesystem::path GetPath() const;
 
+        // Gets the current version of the stream.
+        // This should be read before the stream is, so that a change during the read produces a newer version.
+        StreamVersion GetVersion() const;
+
     private:
         const StreamDefinition m_streamDefinition;
         std::unique_ptr<details::ISettingsContainer> m_container;
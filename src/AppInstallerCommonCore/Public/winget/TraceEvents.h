@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerLogging.h>
+
+
+namespace AppInstaller::Logging::TraceEvents
+{
+    using namespace std::string_view_literals;
+
+    // The structured events logged via AICLI_TRACE.
+    // These are for the logs that are made often enough for their formatting to matter.
+    // Ids are written to binary traces, so an existing id must never be reused for a different event.
+
+    // SQL
+    inline constexpr TraceEventDescriptor SQLPrepareStatement{ 1, "Preparing statement #{}: {}"sv };
+    inline constexpr TraceEventDescriptor SQLReuseStatement{ 2, "Reusing cached statement #{}"sv };
+    inline constexpr TraceEventDescriptor SQLBindStatement{ 3, "Binding statement #{}: {} => {}"sv };
+    inline constexpr TraceEventDescriptor SQLStepStatement{ 4, "Stepping statement #{}"sv };
+    inline constexpr TraceEventDescriptor SQLStatementHasData{ 5, "Statement #{} has data"sv };
+    inline constexpr TraceEventDescriptor SQLStatementCompleted{ 6, "Statement #{} has completed"sv };
+    inline constexpr TraceEventDescriptor SQLResetStatement{ 7, "Reset statement #{}"sv };
+
+    // Repo
+    inline constexpr TraceEventDescriptor RepoCheckingMatch{ 100, "  Checking match with package id: {}"sv };
+
+    // All ids must be less than this value.
+    inline constexpr uint16_t MaximumId = 256;
+}
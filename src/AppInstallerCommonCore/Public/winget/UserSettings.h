@@ -8,6 +8,7 @@
 
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
@@ -57,6 +58,13 @@ namespace AppInstaller::Settings
         DeliveryOptimization,
     };
 
+    // The priority of downloads made with Delivery Optimization.
+    enum class DOPriority
+    {
+        Foreground,
+        Background,
+    };
+
     // Enum of settings.
     // Must start at 0 to enable direct access to variant in UserSettings.
     // Max must be last and unused.
@@ -68,6 +76,8 @@ namespace AppInstaller::Settings
     {
         ProgressBarVisualStyle,
         AutoUpdateTimeInMinutes,
+        BackgroundUpdateWindowInMinutes,
+        SourceDataOnlyStorage,
         EFExperimentalCmd,
         EFExperimentalArg,
         EFDependencies,
@@ -76,13 +86,35 @@ namespace AppInstaller::Settings
         InstallScopeRequirement,
         NetworkDownloader,
         NetworkDOProgressTimeoutInSeconds,
+        NetworkDOPriority,
+        NetworkDOIndexDownloads,
+        NetworkDOManifestDownloads,
+        NetworkDownloadConcurrency,
+        NetworkDownloadSegments,
+        NetworkMaxConnectionsPerHost,
+        NetworkBandwidthLimitInKBps,
+        NetworkRestSearchConcurrency,
+        NetworkHttp2,
+        NetworkInstallerMirrors,
+        InstallerCacheLocation,
+        InstallerCacheMaximumSizeInMB,
+        PackageReadCachePageSizeInKB,
+        PackageReadCacheMaximumPages,
+        PackageReadCacheDiskSizeInMB,
         InstallArchitecturePreference,
         InstallArchitectureRequirement,
         InstallLocalePreference,
         InstallLocaleRequirement,
+        InstallConcurrency,
+        InstallProgressIntervalInMilliseconds,
+        InstallMsiTransaction,
         EFDirectMSI,
+        EFUpgradeSnapshot,
         EnableSelfInitiatedMinidump,
         LoggingLevelPreference,
+        LoggingBinaryTrace,
+        MemoryBudgetInMB,
+        ServerIdleTimeoutInSeconds,
         Max
     };
 
@@ -118,6 +150,8 @@ namespace AppInstaller::Settings
 
         SETTINGMAPPING_SPECIALIZATION(Setting::ProgressBarVisualStyle, std::string, VisualStyle, VisualStyle::Accent, ".visual.progressBar"sv);
         SETTINGMAPPING_SPECIALIZATION_POLICY(Setting::AutoUpdateTimeInMinutes, uint32_t, std::chrono::minutes, 5min, ".source.autoUpdateIntervalInMinutes"sv, ValuePolicy::SourceAutoUpdateIntervalInMinutes);
+        SETTINGMAPPING_SPECIALIZATION(Setting::BackgroundUpdateWindowInMinutes, uint32_t, std::chrono::minutes, 1440min, ".source.backgroundUpdateWindowInMinutes"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::SourceDataOnlyStorage, bool, bool, false, ".source.dataOnlyStorage"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFExperimentalCmd, bool, bool, false, ".experimentalFeatures.experimentalCmd"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFExperimentalArg, bool, bool, false, ".experimentalFeatures.experimentalArg"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFDependencies, bool, bool, false, ".experimentalFeatures.dependencies"sv);
@@ -128,11 +162,34 @@ namespace AppInstaller::Settings
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallScopeRequirement, std::string, ScopePreference, ScopePreference::None, ".installBehavior.requirements.scope"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDownloader, std::string, InstallerDownloader, InstallerDownloader::Default, ".network.downloader"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDOProgressTimeoutInSeconds, uint32_t, std::chrono::seconds, 60s, ".network.doProgressTimeoutInSeconds"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDOPriority, std::string, DOPriority, DOPriority::Foreground, ".network.doPriority"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDOIndexDownloads, bool, bool, false, ".network.doIndexDownloads"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDOManifestDownloads, bool, bool, false, ".network.doManifestDownloads"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDownloadConcurrency, uint32_t, uint32_t, 3, ".network.downloadConcurrency"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDownloadSegments, uint32_t, uint32_t, 4, ".network.downloadSegments"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkMaxConnectionsPerHost, uint32_t, uint32_t, 6, ".network.maxConnectionsPerHost"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkBandwidthLimitInKBps, uint32_t, uint32_t, 0, ".network.bandwidthLimitInKBps"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkRestSearchConcurrency, uint32_t, uint32_t, 1, ".network.restSearchConcurrency"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkHttp2, bool, bool, true, ".network.http2"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkInstallerMirrors, std::vector<std::string>, std::vector<std::string>, {}, ".network.installerMirrors"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::InstallerCacheLocation, std::string, std::string, {}, ".network.installerCache.location"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::InstallerCacheMaximumSizeInMB, uint32_t, uint32_t, 10240, ".network.installerCache.maxSizeInMB"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::PackageReadCachePageSizeInKB, uint32_t, uint32_t, 128, ".network.packageReadCache.pageSizeInKB"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::PackageReadCacheMaximumPages, uint32_t, uint32_t, 200, ".network.packageReadCache.maxPages"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::PackageReadCacheDiskSizeInMB, uint32_t, uint32_t, 0, ".network.packageReadCache.diskSizeInMB"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallLocalePreference, std::vector<std::string>, std::vector<std::string>, {}, ".installBehavior.preferences.locale"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallLocaleRequirement, std::vector<std::string>, std::vector<std::string>, {}, ".installBehavior.requirements.locale"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::InstallConcurrency, uint32_t, uint32_t, 1, ".installBehavior.concurrency"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::InstallProgressIntervalInMilliseconds, uint32_t, std::chrono::milliseconds, 250ms, ".installBehavior.progressIntervalInMilliseconds"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::InstallMsiTransaction, bool, bool, false, ".installBehavior.msiTransaction"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFDirectMSI, bool, bool, false, ".experimentalFeatures.directMSI"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFUpgradeSnapshot, bool, bool, false, ".experimentalFeatures.upgradeSnapshot"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EnableSelfInitiatedMinidump, bool, bool, false, ".debugging.enableSelfInitiatedMinidump"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::LoggingLevelPreference, std::string, Logging::Level, Logging::Level::Info, ".logging.level"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::LoggingBinaryTrace, bool, bool, false, ".logging.binaryTrace"sv);
+        // Zero is not a valid value, and so means that there is no budget.
+        SETTINGMAPPING_SPECIALIZATION(Setting::MemoryBudgetInMB, uint32_t, uint32_t, 0, ".memory.budgetInMB"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::ServerIdleTimeoutInSeconds, uint32_t, std::chrono::seconds, 0s, ".server.idleTimeoutInSeconds"sv);
 
         // Used to deduce the SettingVariant type; making a variant that includes std::monostate and all SettingMapping types.
         template <size_t... I>
@@ -166,6 +223,9 @@ namespace AppInstaller::Settings
 
         static std::filesystem::path SettingsFilePath();
 
+        // The path to the snapshot of the parsed settings files.
+        static std::filesystem::path SnapshotFilePath();
+
         UserSettings(const UserSettings&) = delete;
         UserSettings& operator=(const UserSettings&) = delete;
 
@@ -184,16 +244,29 @@ namespace AppInstaller::Settings
             auto itr = m_settings.find(S);
             if (itr == m_settings.end())
             {
-                return details::SettingMapping<S>::DefaultValue;
+                const details::SettingVariant* decoded = GetDecodedValue(S);
+                if (!decoded)
+                {
+                    return details::SettingMapping<S>::DefaultValue;
+                }
+
+                return std::get<details::SettingIndex(S)>(*decoded);
             }
 
             return std::get<details::SettingIndex(S)>(itr->second);
         }
 
     protected:
+        // The values that are kept encoded until they are first read.
+        struct EncodedValues;
+
+        // Gets the value of a setting that was kept encoded, decoding it on first use; null if there is none.
+        const details::SettingVariant* GetDecodedValue(Setting setting) const;
+
         UserSettingsType m_type = UserSettingsType::Default;
         std::vector<Warning> m_warnings;
         std::map<Setting, details::SettingVariant> m_settings;
+        std::shared_ptr<EncodedValues> m_encoded;
 
         UserSettings();
         ~UserSettings() = default;
@@ -90,8 +90,7 @@ namespace AppInstaller::YAML
         template <typename... Args>
         Node& AddMappingNode(Node&& key, Args&&... args)
         {
-            Require(Type::Mapping);
-            return m_mapping->emplace(std::move(key), Node(std::forward<Args>(args)...))->second;
+            return AddMappingNodeInternal(std::move(key), Node(std::forward<Args>(args)...));
         }
 
         bool IsDefined() const { return m_type != Type::Invalid; }
@@ -130,12 +129,18 @@ namespace AppInstaller::YAML
         // Gets the nodes in the sequence.
         const std::vector<Node>& Sequence() const;
 
-        // Gets the nodes in the mapping.
-        const std::multimap<Node, Node>& Mapping() const;
+        // Gets the nodes in the mapping, ordered by key; entries with the same key remain in the order they were added.
+        const std::vector<std::pair<Node, Node>>& Mapping() const;
 
     private:
         Node(std::string_view key) : m_type(Type::Scalar), m_scalar(key) {}
 
+        // Inserts the pair into the mapping, keeping it ordered by key.
+        Node& AddMappingNodeInternal(Node&& key, Node&& value);
+
+        // Finds the range of entries in the mapping with the given key.
+        std::pair<size_t, size_t> FindMappingRange(std::string_view key) const;
+
         // Require certain node types to; throwing if the requirement is not met.
         void Require(Type type) const;
 
@@ -150,7 +155,8 @@ namespace AppInstaller::YAML
         YAML::Mark m_mark;
         std::string m_scalar;
         std::optional<std::vector<Node>> m_sequence;
-        std::optional<std::multimap<Node, Node>> m_mapping;
+        // Mappings in manifests are small, so a sorted vector is used rather than a tree to avoid an allocation per entry.
+        std::optional<std::vector<std::pair<Node, Node>>> m_mapping;
     };
 
     // Loads from the input; returns the root node of the first document.
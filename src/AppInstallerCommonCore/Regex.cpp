@@ -209,4 +209,35 @@ namespace AppInstaller::Regex
         THROW_HR_IF(E_NOT_VALID_STATE, !pImpl);
         return pImpl->ForEach(input, f);
     }
+
+    SharedExpression::SharedExpression(std::string_view pattern, Options options) :
+        m_compiled(std::make_shared<const Expression>(pattern, options)) {}
+
+    const Expression& SharedExpression::ForCurrentThread() const
+    {
+        THROW_HR_IF(E_NOT_VALID_STATE, !m_compiled);
+
+        // The compiled expression is held weakly, so that a new one allocated at the address of one that has been
+        // destroyed is not mistaken for it; the clones of destroyed expressions are dropped as new ones are added.
+        struct Clone
+        {
+            std::weak_ptr<const Expression> Compiled;
+            Expression Value;
+        };
+
+        thread_local std::unordered_map<const Expression*, Clone> t_clones;
+
+        auto itr = t_clones.find(m_compiled.get());
+        if (itr != t_clones.end() && !itr->second.Compiled.expired())
+        {
+            return itr->second.Value;
+        }
+
+        for (auto clone = t_clones.begin(); clone != t_clones.end();)
+        {
+            clone = clone->second.Compiled.expired() ? t_clones.erase(clone) : std::next(clone);
+        }
+
+        return t_clones.insert_or_assign(m_compiled.get(), Clone{ m_compiled, *m_compiled }).first->second.Value;
+    }
 }
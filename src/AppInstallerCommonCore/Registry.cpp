@@ -10,6 +10,15 @@ namespace AppInstaller::Registry
 {
     namespace
     {
+        std::atomic_size_t s_callCount{ 0 };
+
+        // Counts a call to the registry API, passing its status through.
+        LSTATUS CountCall(LSTATUS status)
+        {
+            s_callCount.fetch_add(1, std::memory_order_relaxed);
+            return status;
+        }
+
         std::wstring_view ConvertBytesToWideStringView(const std::vector<BYTE>& data)
         {
             // Remove any extra bytes because the data could just be dirty; better to not have a bad character than outright fail.
@@ -24,6 +33,16 @@ namespace AppInstaller::Registry
             return result;
         }
 
+        std::chrono::system_clock::time_point FiletimeToTimePoint(const FILETIME& filetime)
+        {
+            // A FILETIME is the number of 100 nanosecond intervals since January 1, 1601.
+            using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>;
+            constexpr filetime_duration unixEpochAsFiletime{ 116444736000000000LL };
+
+            filetime_duration sinceFiletimeEpoch{ static_cast<int64_t>(wil::filetime::to_int64(filetime)) };
+            return std::chrono::system_clock::time_point{ std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceFiletimeEpoch - unixEpochAsFiletime) };
+        }
+
         std::wstring ConvertBytesToWideString(const std::vector<BYTE>& data)
         {
             return std::wstring{ ConvertBytesToWideStringView(data) };
@@ -62,7 +81,7 @@ namespace AppInstaller::Registry
 
                 // We could also get the type and data here, but we read only the name instead
                 // to prevent duplication with the code that gets the data from the name.
-                status = RegEnumValueW(key.get(), index, &valueName[0], &charCount, nullptr, nullptr, nullptr, nullptr);
+                status = CountCall(RegEnumValueW(key.get(), index, &valueName[0], &charCount, nullptr, nullptr, nullptr, nullptr));
 
                 if (status == ERROR_MORE_DATA)
                 {
@@ -108,7 +127,7 @@ namespace AppInstaller::Registry
             while (data.size() < (64 << 20))
             {
                 byteCount = wil::safe_cast<DWORD>(data.size());
-                status = RegGetValueW(key.get(), nullptr, valueName.c_str(), RRF_RT_ANY | RRF_NOEXPAND, &type, data.data(), &byteCount);
+                status = CountCall(RegGetValueW(key.get(), nullptr, valueName.c_str(), RRF_RT_ANY | RRF_NOEXPAND, &type, data.data(), &byteCount));
 
                 if (status == ERROR_MORE_DATA && byteCount > data.size())
                 {
@@ -283,6 +302,11 @@ namespace AppInstaller::Registry
         return { m_parentKey.get(), m_subKeyName, 0, m_access };
     }
 
+    std::chrono::system_clock::time_point Key::SubKeyRef::GetLastWriteTime() const
+    {
+        return FiletimeToTimePoint(m_lastWriteTime);
+    }
+
     Key::SubKeyRef::SubKeyRef(const wil::shared_hkey& key, REGSAM access) :
         m_parentKey(key), m_access(access), m_subKeyName(64, L'\0')
     {
@@ -297,7 +321,7 @@ namespace AppInstaller::Registry
         while (m_subKeyName.size() < 4096)
         {
             charCount = wil::safe_cast<DWORD>(m_subKeyName.size());
-            status = RegEnumKeyExW(m_parentKey.get(), index, &m_subKeyName[0], &charCount, nullptr, nullptr, nullptr, nullptr);
+            status = CountCall(RegEnumKeyExW(m_parentKey.get(), index, &m_subKeyName[0], &charCount, nullptr, nullptr, nullptr, &m_lastWriteTime));
 
             if (status == ERROR_MORE_DATA)
             {
@@ -381,7 +405,10 @@ namespace AppInstaller::Registry
 
     std::optional<Value> Key::operator[](std::string_view name) const
     {
-        return operator[](Utility::ConvertToUTF16(name));
+        // Values are looked up by name many times for each key, so convert the names into a buffer rather than a new string each time.
+        thread_local std::wstring s_name;
+        Utility::ConvertToUTF16(name, s_name);
+        return operator[](s_name);
     }
 
     std::optional<Value> Key::operator[](const std::wstring& name) const
@@ -427,6 +454,77 @@ namespace AppInstaller::Registry
         return { m_key };
     }
 
+    ValueMap Key::ReadAllValues() const
+    {
+        ValueMap result;
+
+        DWORD valueCount = 0;
+        DWORD maxNameLength = 0;
+        DWORD maxDataLength = 0;
+        THROW_IF_WIN32_ERROR(CountCall(RegQueryInfoKeyW(m_key.get(), nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &valueCount, &maxNameLength, &maxDataLength, nullptr, nullptr)));
+
+        // The maximum name length does not include the terminating null; the data buffer is never empty so that it is not taken as a size query.
+        std::wstring valueName(static_cast<size_t>(maxNameLength) + 1, L'\0');
+        std::vector<BYTE> data(std::max<DWORD>(maxDataLength, 1));
+        result.m_values.reserve(valueCount);
+
+        for (DWORD index = 0;;)
+        {
+            DWORD charCount = wil::safe_cast<DWORD>(valueName.size());
+            DWORD byteCount = wil::safe_cast<DWORD>(data.size());
+            DWORD type = REG_NONE;
+
+            LSTATUS status = CountCall(RegEnumValueW(m_key.get(), index, &valueName[0], &charCount, nullptr, &type, data.data(), &byteCount));
+
+            if (status == ERROR_NO_MORE_ITEMS)
+            {
+                break;
+            }
+            else if (status == ERROR_MORE_DATA)
+            {
+                // A larger value was written since the sizes were read; grow the buffers and read this one again.
+                THROW_IF_WIN32_ERROR(CountCall(RegQueryInfoKeyW(m_key.get(), nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &maxNameLength, &maxDataLength, nullptr, nullptr)));
+                valueName.resize(std::max(valueName.size(), static_cast<size_t>(maxNameLength) + 1));
+                data.resize(std::max<size_t>({ data.size() * 2, maxDataLength, byteCount }));
+                continue;
+            }
+
+            THROW_IF_WIN32_ERROR(status);
+
+            result.m_values.emplace_back(std::wstring{ valueName.data(), charCount }, Value{ type, std::vector<BYTE>(data.begin(), data.begin() + byteCount) });
+            ++index;
+        }
+
+        return result;
+    }
+
+    const Value* ValueMap::operator[](std::wstring_view name) const
+    {
+        for (const auto& value : m_values)
+        {
+            // Value names are case insensitive
+            if (CompareStringOrdinal(value.first.data(), wil::safe_cast<int>(value.first.size()), name.data(), wil::safe_cast<int>(name.size()), TRUE) == CSTR_EQUAL)
+            {
+                return &value.second;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::chrono::system_clock::time_point Key::GetLastWriteTime() const
+    {
+        FILETIME lastWriteTime{};
+        THROW_IF_WIN32_ERROR(CountCall(RegQueryInfoKeyW(m_key.get(), nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &lastWriteTime)));
+        return FiletimeToTimePoint(lastWriteTime);
+    }
+
+    void Key::NotifyOnChange(HANDLE event) const
+    {
+        // Thread agnostic, as the request is often made again from a thread pool callback that does not live as long as the key.
+        THROW_IF_WIN32_ERROR(CountCall(RegNotifyChangeKeyValue(m_key.get(), TRUE, REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC, event, TRUE)));
+    }
+
     Key Key::OpenIfExists(HKEY key, std::string_view subKey, DWORD options, REGSAM access)
     {
         return OpenIfExists(key, Utility::ConvertToUTF16(subKey), options, access);
@@ -442,7 +540,7 @@ namespace AppInstaller::Registry
     bool Key::Initialize(HKEY key, const std::wstring& subKey, DWORD options, REGSAM access, bool ignoreErrorIfDoesNotExist)
     {
         m_access = access;
-        LSTATUS status = RegOpenKeyExW(key, subKey.c_str(), options, access, &m_key);
+        LSTATUS status = CountCall(RegOpenKeyExW(key, subKey.c_str(), options, access, &m_key));
 
         if (ignoreErrorIfDoesNotExist && status == ERROR_FILE_NOT_FOUND)
         {
@@ -453,4 +551,9 @@ namespace AppInstaller::Registry
         THROW_IF_WIN32_ERROR(status);
         return true;
     }
+
+    size_t GetCallCount()
+    {
+        return s_callCount.load(std::memory_order_relaxed);
+    }
 }
@@ -6,51 +6,33 @@
 #include "Public/AppInstallerSHA256.h"
 #include "Public/AppInstallerRuntime.h"
 #include "Public/AppInstallerErrors.h"
+#include "Public/winget/Performance.h"
 
 using namespace AppInstaller::Runtime;
 
 namespace AppInstaller::Utility {
 
+    // The SHA256 implementation behind CNG selects the SHA extensions of the processor (SHA-NI or ARMv8) when they are present.
+    // The algorithm pseudo-handle is used to avoid opening a provider for every hash.
     struct SHA256Context
     {
-        wil::unique_bcrypt_algorithm algHandle;
         wil::unique_bcrypt_hash hashHandle;
-        DWORD hashLength = 0;
+        DWORD hashLength = SHA256::HashBufferSizeInBytes;
     };
 
+    namespace
+    {
+        // Files are hashed in blocks of this size, reading the next block while the current one is hashed.
+        constexpr DWORD s_FileHashBlockSize = 4 * 1024 * 1024;
+    }
+
     SHA256::SHA256() : context(new SHA256Context{})
     {
-        BCRYPT_ALG_HANDLE algHandleT{};
         BCRYPT_HASH_HANDLE hashHandleT;
-        DWORD resultLength = 0;
-
-        // Open an algorithm handle
-        THROW_IF_NTSTATUS_FAILED_MSG(BCryptOpenAlgorithmProvider(
-            &algHandleT,                // Alg Handle pointer
-            BCRYPT_SHA256_ALGORITHM,    // Cryptographic Algorithm name (null terminated unicode string)
-            nullptr,                    // Provider name; if null, the default provider is loaded
-            0),                         // Flags
-            "failed opening SHA256 algorithm provider");
-        context->algHandle.reset(algHandleT);
-
-        // Obtain the length of the hash
-        THROW_IF_NTSTATUS_FAILED_MSG(BCryptGetProperty(
-            context->algHandle.get(),       // Handle to a CNG object
-            BCRYPT_HASH_LENGTH,             // Property name (null terminated unicode string)
-            (PBYTE) & (context->hashLength),  // Address of the output buffer which receives the property value
-            sizeof(context->hashLength),    // Size of the buffer in bytes
-            &resultLength,                  // Number of bytes that were copied into the buffer
-            0),                             // Flags
-            "failed getting SHA256 hash length");
-        
-        if (resultLength != sizeof(context->hashLength))
-        {
-            THROW_HR_MSG(E_UNEXPECTED, "failed getting SHA256 hash length");
-        }
 
         // Create a hash handle
         THROW_IF_NTSTATUS_FAILED_MSG(BCryptCreateHash(
-            context->algHandle.get(),   // Handle to an algorithm provider
+            BCRYPT_SHA256_ALG_HANDLE,   // Handle to an algorithm provider
             &hashHandleT,               // A pointer to a hash handle - can be a hash or hmac object
             nullptr,                    // Pointer to the buffer that receives the hash/hmac object
             0,                          // Size of the buffer in bytes
@@ -130,9 +112,19 @@ namespace AppInstaller::Utility {
 
     SHA256::HashBuffer SHA256::ComputeHash(const std::uint8_t* buffer, std::uint32_t cbBuffer)
     {
-        SHA256 hasher;
-        hasher.Add(buffer, cbBuffer);
-        return hasher.Get();
+        HashBuffer result(HashBufferSizeInBytes);
+
+        THROW_IF_NTSTATUS_FAILED_MSG(BCryptHash(
+            BCRYPT_SHA256_ALG_HANDLE,
+            nullptr,
+            0,
+            const_cast<PUCHAR>(buffer),
+            cbBuffer,
+            result.data(),
+            static_cast<ULONG>(result.size())),
+            "failed computing SHA256 hash");
+
+        return result;
     }
 
     SHA256::HashBuffer SHA256::ComputeHash(std::string_view buffer)
@@ -142,6 +134,7 @@ namespace AppInstaller::Utility {
 
     SHA256::HashBuffer SHA256::ComputeHash(std::istream& in)
     {
+        Performance::ScopedTimer timer{ "SHA256::ComputeHash" };
         // Throw exceptions on badbit
         auto excState = in.exceptions();
         auto revertExcState = wil::scope_exit([excState, &in]() { in.exceptions(excState); });
@@ -171,6 +164,104 @@ namespace AppInstaller::Utility {
         }
     }
 
+    SHA256::HashBuffer SHA256::ComputeHashFromFile(const std::filesystem::path& path)
+    {
+        Performance::ScopedTimer timer{ "SHA256::ComputeHashFromFile" };
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED, nullptr) };
+        THROW_LAST_ERROR_IF_MSG(!file, "failed opening file to hash");
+
+        struct Block
+        {
+            std::unique_ptr<uint8_t[]> Buffer = std::make_unique<uint8_t[]>(s_FileHashBlockSize);
+            wil::unique_event Event{ wil::EventOptions::ManualReset };
+            OVERLAPPED Overlapped{};
+            bool Pending = false;
+        };
+
+        Block blocks[2];
+
+        // Outstanding reads must complete before their buffers are released
+        auto cancelReads = wil::scope_exit([&]()
+            {
+                for (auto& block : blocks)
+                {
+                    if (block.Pending)
+                    {
+                        CancelIoEx(file.get(), &block.Overlapped);
+                        DWORD ignored = 0;
+                        GetOverlappedResult(file.get(), &block.Overlapped, &ignored, TRUE);
+                    }
+                }
+            });
+
+        auto startRead = [&](Block& block, uint64_t offset)
+        {
+            block.Overlapped = {};
+            block.Overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+            block.Overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            block.Overlapped.hEvent = block.Event.get();
+
+            if (!ReadFile(file.get(), block.Buffer.get(), s_FileHashBlockSize, nullptr, &block.Overlapped))
+            {
+                DWORD error = GetLastError();
+                if (error == ERROR_HANDLE_EOF)
+                {
+                    return;
+                }
+
+                THROW_WIN32_IF(error, error != ERROR_IO_PENDING);
+            }
+
+            block.Pending = true;
+        };
+
+        auto finishRead = [&](Block& block) -> DWORD
+        {
+            if (!block.Pending)
+            {
+                return 0;
+            }
+
+            DWORD bytesRead = 0;
+            BOOL result = GetOverlappedResult(file.get(), &block.Overlapped, &bytesRead, TRUE);
+            block.Pending = false;
+
+            if (!result)
+            {
+                DWORD error = GetLastError();
+                THROW_WIN32_IF(error, error != ERROR_HANDLE_EOF);
+                return 0;
+            }
+
+            return bytesRead;
+        };
+
+        SHA256 hasher;
+        uint64_t offset = 0;
+        size_t current = 0;
+
+        startRead(blocks[current], offset);
+
+        while (true)
+        {
+            DWORD bytesRead = finishRead(blocks[current]);
+            if (bytesRead == 0)
+            {
+                break;
+            }
+
+            offset += bytesRead;
+
+            size_t next = 1 - current;
+            startRead(blocks[next], offset);
+
+            hasher.Add(blocks[current].Buffer.get(), bytesRead);
+            current = next;
+        }
+
+        return hasher.Get();
+    }
+
     void SHA256::SHA256ContextDeleter::operator()(SHA256Context* context)
     {
         delete context;
@@ -399,6 +399,92 @@ namespace AppInstaller::Settings
         {
             return GetSettingsContainer(streamDefinition.Type, streamDefinition.Name);
         }
+
+        // Counts the changes made to streams, in memory shared by every process of the user in the session.
+        // Streams are assigned a counter by the hash of their name; streams that share a counter only see extra changes.
+        struct StreamChangeCounters
+        {
+            static StreamChangeCounters& Instance()
+            {
+                static StreamChangeCounters instance;
+                return instance;
+            }
+
+            StreamVersion GetVersion(std::string_view name) const
+            {
+                StreamVersion result;
+
+                if (m_counters)
+                {
+                    result.Instance = static_cast<uint64_t>(InterlockedCompareExchange64(&m_counters->Instance, 0, 0));
+                    result.Counter = static_cast<uint64_t>(InterlockedCompareExchange64(GetCounter(name), 0, 0));
+                }
+
+                return result;
+            }
+
+            void Increment(std::string_view name)
+            {
+                if (m_counters)
+                {
+                    InterlockedIncrement64(GetCounter(name));
+                }
+            }
+
+        private:
+            static constexpr size_t s_CounterCount = 64;
+
+            struct SharedCounters
+            {
+                volatile LONG64 Instance;
+                volatile LONG64 Counters[s_CounterCount];
+            };
+
+            StreamChangeCounters()
+            {
+                try
+                {
+                    // The settings locations are part of the name so that processes using other locations (such as tests) are separate.
+                    std::string locations = GetPathTo(PathName::StandardSettings).u8string() + '|' +
+                        GetPathTo(PathName::SecureSettings).u8string() + '|' + GetPathTo(PathName::UserFileSettings).u8string();
+                    std::wstring name = L"Local\\WinGetStreamVersions_" + ConvertToUTF16(SHA256::ConvertToString(SHA256::ComputeHash(locations)).substr(0, 16));
+
+                    m_mapping.reset(CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(SharedCounters), name.c_str()));
+                    THROW_LAST_ERROR_IF(!m_mapping);
+                    bool created = (GetLastError() != ERROR_ALREADY_EXISTS);
+
+                    m_view.reset(MapViewOfFile(m_mapping.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(SharedCounters)));
+                    THROW_LAST_ERROR_IF(!m_view);
+                    m_counters = static_cast<SharedCounters*>(m_view.get());
+
+                    if (created)
+                    {
+                        // A new instance is chosen each time the counters are created, as they restart from zero.
+                        // Until it is set, versions from the counters are unavailable.
+                        FILETIME now{};
+                        GetSystemTimePreciseAsFileTime(&now);
+                        LONG64 instance = ((static_cast<LONG64>(now.dwHighDateTime) << 32) | now.dwLowDateTime) ^ (static_cast<LONG64>(GetCurrentProcessId()) << 48);
+                        instance |= 1;
+                        InterlockedCompareExchange64(&m_counters->Instance, instance, 0);
+                    }
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    AICLI_LOG(Core, Warning, << "Stream change counters are not available");
+                    m_counters = nullptr;
+                }
+            }
+
+            volatile LONG64* GetCounter(std::string_view name) const
+            {
+                return &m_counters->Counters[std::hash<std::string_view>{}(name) % s_CounterCount];
+            }
+
+            wil::unique_handle m_mapping;
+            wil::unique_mapview_ptr<void> m_view;
+            SharedCounters* m_counters = nullptr;
+        };
     }
 
     std::string_view ToString(Type type)
@@ -431,13 +517,22 @@ namespace AppInstaller::Settings
     [[nodiscard]] bool Stream::Set(std::string_view value)
     {
         LogSettingAction("Set", m_streamDefinition);
-        return m_container->Set(value);
+        bool result = m_container->Set(value);
+
+        // Only after the change is made, so that a reader that gets the old version may only have read older contents.
+        if (result)
+        {
+            StreamChangeCounters::Instance().Increment(m_streamDefinition.Name);
+        }
+
+        return result;
     }
 
     void Stream::Remove()
     {
         LogSettingAction("Remove", m_streamDefinition);
         m_container->Remove();
+        StreamChangeCounters::Instance().Increment(m_streamDefinition.Name);
     }
 
     std::string_view Stream::GetName() const
@@ -449,4 +544,9 @@ namespace AppInstaller::Settings
     {
         return m_container->PathTo();
     }
+
+    StreamVersion Stream::GetVersion() const
+    {
+        return StreamChangeCounters::Instance().GetVersion(m_streamDefinition.Name);
+    }
 }
@@ -43,10 +43,8 @@ namespace AppInstaller::ThreadLocalStorage
             std::call_once(m_loggerInitOnceFlag, [this]()
                 {
                     m_pDiagnosticLogger = std::make_unique<DiagnosticLogger>();
+                    // The telemetry logger initializes itself from the settings when it is first used.
                     m_pTelemetryLogger = std::make_unique<TelemetryTraceLogger>();
-
-                    // The above make_unique for TelemetryTraceLogger will either create an object or will throw which is caught below.
-                    m_pTelemetryLogger->Initialize();
                 });
         }
         catch (...)
@@ -5,6 +5,7 @@
 #include "AppInstallerLanguageUtilities.h"
 #include "AppInstallerLogging.h"
 #include "JsonUtil.h"
+#include "AppInstallerSHA256.h"
 #include "winget/Settings.h"
 #include "winget/UserSettings.h"
 
@@ -72,16 +73,81 @@ namespace AppInstaller::Settings
             return convertedValue;
         }
 
-        std::optional<Json::Value> ParseFile(const StreamDefinition& setting, std::vector<UserSettings::Warning>& warnings)
+        // A warning, along with the setting that it is about; Setting::Max for those about the settings file as a whole.
+        using SettingWarning = std::pair<Setting, UserSettings::Warning>;
+
+        // The identity of a settings file that was read; used to determine whether a snapshot is still valid.
+        struct SettingsFileKey
+        {
+            bool Read = false;
+            bool Exists = false;
+            uint64_t Size = 0;
+            int64_t LastWriteTime = 0;
+            SHA256::HashBuffer Hash;
+        };
+
+        // The result of parsing the settings files, before any values from group policy are applied.
+        struct ParsedUserSettings
+        {
+            UserSettingsType Type = UserSettingsType::Default;
+            std::map<Setting, details::SettingVariant> Values;
+            // The values read from the snapshot, which stay encoded until they are used.
+            std::map<Setting, std::string> EncodedValues;
+            std::vector<SettingWarning> Warnings;
+            SettingsFileKey PrimaryKey;
+            SettingsFileKey BackupKey;
+        };
+
+        // Gets the current size and last write time of the settings file; the hash is not computed.
+        SettingsFileKey GetSettingsFileKey(const StreamDefinition& setting)
+        {
+            SettingsFileKey result;
+            result.Read = true;
+
+            std::filesystem::path path = Stream{ setting }.GetPath();
+            std::error_code ec;
+            auto size = std::filesystem::file_size(path, ec);
+            if (!ec)
+            {
+                auto lastWriteTime = std::filesystem::last_write_time(path, ec);
+                if (!ec)
+                {
+                    result.Exists = true;
+                    result.Size = size;
+                    result.LastWriteTime = lastWriteTime.time_since_epoch().count();
+                }
+            }
+
+            return result;
+        }
+
+        // Reads the settings file, returning an empty value if it does not exist.
+        std::optional<std::string> ReadSettingsFile(const StreamDefinition& setting)
         {
             auto stream = Stream{ setting }.Get();
-            if (stream)
+            if (!stream)
+            {
+                return {};
+            }
+
+            return Utility::ReadEntireStream(*stream);
+        }
+
+        std::optional<Json::Value> ParseFile(const StreamDefinition& setting, std::vector<SettingWarning>& warnings, SettingsFileKey& key)
+        {
+            // Get the identity before reading, so that a change during the read invalidates the result rather than hiding behind it.
+            key = GetSettingsFileKey(setting);
+
+            auto settingsContent = ReadSettingsFile(setting);
+            if (settingsContent)
             {
+                key.Hash = SHA256::ComputeHash(settingsContent.value());
+
                 Json::Value root;
                 Json::CharReaderBuilder builder;
                 const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
 
-                std::string settingsContentStr = Utility::ReadEntireStream(*stream);
+                const std::string& settingsContentStr = settingsContent.value();
                 std::string error;
 
                 if (reader->parse(settingsContentStr.c_str(), settingsContentStr.c_str() + settingsContentStr.size(), &root, &error))
@@ -90,7 +156,7 @@ namespace AppInstaller::Settings
                 }
 
                 AICLI_LOG(Core, Error, << "Error parsing " << setting.Name << ": " << error);
-                warnings.emplace_back(StringResource::String::SettingsWarningParseError, setting.Name, error, false);
+                warnings.emplace_back(Setting::Max, UserSettings::Warning{ StringResource::String::SettingsWarningParseError, setting.Name, error, false });
             }
 
             return {};
@@ -102,40 +168,50 @@ namespace AppInstaller::Settings
             return GroupPolicies().GetValue<details::SettingMapping<S>::Policy>();
         }
 
+        // Settings set by Group Policy override anything else; returns true if there is one for the setting.
         template <Setting S>
-        void Validate(
-            Json::Value& root,
+        bool ValidateFromPolicy(
             std::map<Setting, details::SettingVariant>& settings,
             std::vector<UserSettings::Warning>& warnings)
         {
-            // jsoncpp doesn't support std::string_view yet.
-            auto path = std::string(details::SettingMapping<S>::Path);
-
-            // Settings set by Group Policy override anything else. See if there is one.
             auto policyValue = GetValueFromPolicy<S>();
-            if (policyValue.has_value())
+            if (!policyValue.has_value())
             {
-                // If the value is valid, use it.
-                // Otherwise, fall back to default.
-                // In any case, we do not need to read the setting from the JSON.
-                auto validatedValue = details::SettingMapping<S>::Validate(policyValue.value());
-                if (validatedValue.has_value())
-                {
-                    // Add it to the map
-                    settings[S].emplace<details::SettingIndex(S)>(
-                        std::forward<typename details::SettingMapping<S>::value_t>(validatedValue.value()));
-                    AICLI_LOG(Core, Verbose, << "Valid setting from Group Policy. Field: " << path << " Value: " << GetValueString(policyValue.value()));
-                }
-                else
-                {
-                    auto valueAsString = GetValueString(policyValue.value());
-                    AICLI_LOG(Core, Error, << "Invalid setting from Group Policy. Field: " << path << " Value: " << valueAsString);
-                    warnings.emplace_back(StringResource::String::SettingsWarningInvalidValueFromPolicy, path, valueAsString);
-                }
+                return false;
+            }
 
-                return;
+            auto path = std::string(details::SettingMapping<S>::Path);
+
+            // If the value is valid, use it.
+            // Otherwise, fall back to default.
+            // In any case, we do not need to read the setting from the JSON.
+            auto validatedValue = details::SettingMapping<S>::Validate(policyValue.value());
+            if (validatedValue.has_value())
+            {
+                // Add it to the map
+                settings[S].emplace<details::SettingIndex(S)>(
+                    std::forward<typename details::SettingMapping<S>::value_t>(validatedValue.value()));
+                AICLI_LOG(Core, Verbose, << "Valid setting from Group Policy. Field: " << path << " Value: " << GetValueString(policyValue.value()));
+            }
+            else
+            {
+                auto valueAsString = GetValueString(policyValue.value());
+                AICLI_LOG(Core, Error, << "Invalid setting from Group Policy. Field: " << path << " Value: " << valueAsString);
+                warnings.emplace_back(StringResource::String::SettingsWarningInvalidValueFromPolicy, path, valueAsString);
             }
 
+            return true;
+        }
+
+        template <Setting S>
+        void ValidateFromJson(
+            Json::Value& root,
+            std::map<Setting, details::SettingVariant>& settings,
+            std::vector<SettingWarning>& warnings)
+        {
+            // jsoncpp doesn't support std::string_view yet.
+            auto path = std::string(details::SettingMapping<S>::Path);
+
             const Json::Path jsonPath(path);
             Json::Value result = jsonPath.resolve(root);
             if (!result.isNull())
@@ -157,13 +233,13 @@ namespace AppInstaller::Settings
                     {
                         auto valueAsString = GetValueString(jsonValue.value());
                         AICLI_LOG(Core, Error, << "Invalid field value. Field: " << path << " Value: " << valueAsString);
-                        warnings.emplace_back(StringResource::String::SettingsWarningInvalidFieldValue, path, valueAsString);
+                        warnings.emplace_back(S, UserSettings::Warning{ StringResource::String::SettingsWarningInvalidFieldValue, path, valueAsString });
                     }
                 }
                 else
                 {
                     AICLI_LOG(Core, Error, << "Invalid field format. Field: " << path << " Using default");
-                    warnings.emplace_back(StringResource::String::SettingsWarningInvalidFieldFormat, path);
+                    warnings.emplace_back(S, UserSettings::Warning{ StringResource::String::SettingsWarningInvalidFieldFormat, path });
                 }
             }
             else
@@ -173,14 +249,589 @@ namespace AppInstaller::Settings
         }
 
         template <size_t... S>
-        void ValidateAll(
+        void ValidateAllFromJson(
             Json::Value& root,
             std::map<Setting, details::SettingVariant>& settings,
-            std::vector<UserSettings::Warning>& warnings,
+            std::vector<SettingWarning>& warnings,
             std::index_sequence<S...>)
         {
             // Use folding to call each setting validate function.
-            (FoldHelper{}, ..., Validate<static_cast<Setting>(S)>(root, settings, warnings));
+            (FoldHelper{}, ..., ValidateFromJson<static_cast<Setting>(S)>(root, settings, warnings));
+        }
+
+        // Uses the value from group policy if there is one, or the value parsed from the settings file otherwise.
+        // A value that is still encoded is left for the first time that it is read.
+        template <Setting S>
+        void Apply(
+            ParsedUserSettings& parsed,
+            std::map<Setting, details::SettingVariant>& settings,
+            std::map<Setting, std::string>& encoded,
+            std::vector<UserSettings::Warning>& warnings)
+        {
+            if (ValidateFromPolicy<S>(settings, warnings))
+            {
+                return;
+            }
+
+            auto itr = parsed.Values.find(S);
+            if (itr != parsed.Values.end())
+            {
+                settings[S] = std::move(itr->second);
+            }
+
+            auto encodedItr = parsed.EncodedValues.find(S);
+            if (encodedItr != parsed.EncodedValues.end())
+            {
+                encoded[S] = std::move(encodedItr->second);
+            }
+
+            for (const auto& warning : parsed.Warnings)
+            {
+                if (warning.first == S)
+                {
+                    warnings.emplace_back(warning.second);
+                }
+            }
+        }
+
+        template <size_t... S>
+        void ApplyAll(
+            ParsedUserSettings& parsed,
+            std::map<Setting, details::SettingVariant>& settings,
+            std::map<Setting, std::string>& encoded,
+            std::vector<UserSettings::Warning>& warnings,
+            std::index_sequence<S...>)
+        {
+            (FoldHelper{}, ..., Apply<static_cast<Setting>(S)>(parsed, settings, encoded, warnings));
+        }
+
+        // Settings can be loaded from settings.json or settings.json.backup files.
+        // 1 - Use settings.json if exists and passes parsing.
+        // 2 - Use settings.backup.json if settings.json fails to parse.
+        // 3 - Use default (empty) if both settings files fail to load.
+        ParsedUserSettings ParseUserSettings()
+        {
+            ParsedUserSettings result;
+            Json::Value settingsRoot = Json::Value::nullSingleton();
+
+            auto settingsJson = ParseFile(Stream::PrimaryUserSettings, result.Warnings, result.PrimaryKey);
+            if (settingsJson.has_value())
+            {
+                AICLI_LOG(Core, Info, << "Settings loaded from " << Stream::PrimaryUserSettings.Name);
+                result.Type = UserSettingsType::Standard;
+                settingsRoot = settingsJson.value();
+            }
+
+            // Settings didn't parse or doesn't exist, try with backup.
+            if (settingsRoot.isNull())
+            {
+                auto settingsBackupJson = ParseFile(Stream::BackupUserSettings, result.Warnings, result.BackupKey);
+                if (settingsBackupJson.has_value())
+                {
+                    AICLI_LOG(Core, Info, << "Settings loaded from " << Stream::BackupUserSettings.Name);
+                    result.Warnings.emplace_back(Setting::Max, UserSettings::Warning{ StringResource::String::SettingsWarningLoadedBackupSettings });
+                    result.Type = UserSettingsType::Backup;
+                    settingsRoot = settingsBackupJson.value();
+                }
+            }
+
+            if (!settingsRoot.isNull())
+            {
+                ValidateAllFromJson(settingsRoot, result.Values, result.Warnings, std::make_index_sequence<static_cast<size_t>(Setting::Max)>());
+            }
+            else
+            {
+                AICLI_LOG(Core, Info, << "Valid settings file not found. Using default values.");
+            }
+
+            return result;
+        }
+
+        // The snapshot of the parsed settings is a binary file:
+        //  char[8]  Magic ("WGSETSNP")
+        //  uint32_t Format version
+        //  uint32_t Payload size
+        //  uint8_t[32] SHA256 of the payload
+        //  Payload : { string client version, uint32_t setting count, file key primary, file key backup, uint32_t type,
+        //              uint32_t warning count, warnings..., uint32_t value count, { uint32_t setting, string value }... }
+        // The client version and setting count are included so that a snapshot written by a different build is never used,
+        // as it may have validated the values differently.
+        // Each value is written as a string of its own, so that it can be kept as it is and only decoded if the setting is read.
+        constexpr std::string_view s_SettingsSnapshot_Magic = "WGSETSNP"sv;
+        constexpr uint32_t s_SettingsSnapshot_Version = 2;
+        constexpr size_t s_SettingsSnapshot_HeaderSize = s_SettingsSnapshot_Magic.size() + sizeof(uint32_t) * 2 + SHA256::HashBufferSizeInBytes;
+
+        // The file system only updates the last write time periodically, so a file that was written close to when the snapshot
+        // was may have been written again without the time changing. Those files are always hashed (as git does for its index).
+        constexpr auto s_SettingsSnapshot_RacyWindow = 2s;
+
+        // The warnings that can be stored in the snapshot; the index into this is stored rather than the resource id itself.
+        const StringResource::StringId* const s_SettingsSnapshot_Warnings[] =
+        {
+            &StringResource::String::SettingsWarningParseError,
+            &StringResource::String::SettingsWarningInvalidFieldFormat,
+            &StringResource::String::SettingsWarningInvalidFieldValue,
+            &StringResource::String::SettingsWarningLoadedBackupSettings,
+        };
+
+        template <typename T>
+        struct IsVector : std::false_type {};
+
+        template <typename T>
+        struct IsVector<std::vector<T>> : std::true_type {};
+
+        template <typename T>
+        struct IsDuration : std::false_type {};
+
+        template <typename R, typename P>
+        struct IsDuration<std::chrono::duration<R, P>> : std::true_type {};
+
+        struct SnapshotWriter
+        {
+            void Write(uint64_t value)
+            {
+                for (size_t i = 0; i < sizeof(value); ++i)
+                {
+                    m_buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+                }
+            }
+
+            void Write(std::string_view value)
+            {
+                Write(static_cast<uint64_t>(value.size()));
+                m_buffer.append(value);
+            }
+
+            template <typename T>
+            void WriteValue(const T& value)
+            {
+                if constexpr (std::is_same_v<T, std::string>)
+                {
+                    Write(std::string_view{ value });
+                }
+                else if constexpr (IsVector<T>::value)
+                {
+                    Write(static_cast<uint64_t>(value.size()));
+                    for (const auto& entry : value)
+                    {
+                        WriteValue(entry);
+                    }
+                }
+                else if constexpr (IsDuration<T>::value)
+                {
+                    Write(static_cast<uint64_t>(value.count()));
+                }
+                else if constexpr (std::is_enum_v<T>)
+                {
+                    Write(static_cast<uint64_t>(value));
+                }
+                else
+                {
+                    static_assert(std::is_integral_v<T>, "Add serialization for the new setting value type");
+                    Write(static_cast<uint64_t>(value));
+                }
+            }
+
+            void Write(const SettingsFileKey& key)
+            {
+                Write(static_cast<uint64_t>(key.Read));
+                Write(static_cast<uint64_t>(key.Exists));
+                Write(key.Size);
+                Write(static_cast<uint64_t>(key.LastWriteTime));
+                Write(std::string_view{ reinterpret_cast<const char*>(key.Hash.data()), key.Hash.size() });
+            }
+
+            const std::string& Buffer() const { return m_buffer; }
+
+        private:
+            std::string m_buffer;
+        };
+
+        // Reads the snapshot payload; errors are reported by throwing, as the snapshot is simply discarded.
+        struct SnapshotReader
+        {
+            SnapshotReader(std::string_view buffer) : m_buffer(buffer) {}
+
+            uint64_t ReadUInt64()
+            {
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), m_buffer.size() < sizeof(uint64_t));
+
+                uint64_t result = 0;
+                for (size_t i = 0; i < sizeof(result); ++i)
+                {
+                    result |= static_cast<uint64_t>(static_cast<uint8_t>(m_buffer[i])) << (i * 8);
+                }
+
+                m_buffer.remove_prefix(sizeof(result));
+                return result;
+            }
+
+            std::string ReadString()
+            {
+                uint64_t size = ReadUInt64();
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), m_buffer.size() < size);
+
+                std::string result{ m_buffer.substr(0, static_cast<size_t>(size)) };
+                m_buffer.remove_prefix(static_cast<size_t>(size));
+                return result;
+            }
+
+            template <typename T>
+            T ReadValue()
+            {
+                if constexpr (std::is_same_v<T, std::string>)
+                {
+                    return ReadString();
+                }
+                else if constexpr (IsVector<T>::value)
+                {
+                    uint64_t count = ReadUInt64();
+                    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), count > m_buffer.size());
+
+                    T result;
+                    for (uint64_t i = 0; i < count; ++i)
+                    {
+                        result.emplace_back(ReadValue<typename T::value_type>());
+                    }
+                    return result;
+                }
+                else if constexpr (IsDuration<T>::value)
+                {
+                    return T{ static_cast<typename T::rep>(ReadUInt64()) };
+                }
+                else
+                {
+                    return static_cast<T>(ReadUInt64());
+                }
+            }
+
+            SettingsFileKey ReadKey()
+            {
+                SettingsFileKey result;
+                result.Read = ReadUInt64() != 0;
+                result.Exists = ReadUInt64() != 0;
+                result.Size = ReadUInt64();
+                result.LastWriteTime = static_cast<int64_t>(ReadUInt64());
+                std::string hash = ReadString();
+                result.Hash.assign(hash.begin(), hash.end());
+                return result;
+            }
+
+            bool IsEmpty() const { return m_buffer.empty(); }
+
+        private:
+            std::string_view m_buffer;
+        };
+
+        template <Setting S>
+        void ReadSnapshotValue(SnapshotReader& reader, details::SettingVariant& value)
+        {
+            value.emplace<details::SettingIndex(S)>(reader.ReadValue<typename details::SettingMapping<S>::value_t>());
+        }
+
+        template <size_t... S>
+        void ReadSnapshotValue(Setting setting, SnapshotReader& reader, details::SettingVariant& value, std::index_sequence<S...>)
+        {
+            bool found = ((static_cast<Setting>(S) == setting ? (ReadSnapshotValue<static_cast<Setting>(S)>(reader, value), true) : false) || ...);
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), !found);
+        }
+
+        // Decodes a value that was kept as it was written to the snapshot.
+        details::SettingVariant DecodeSnapshotValue(Setting setting, std::string_view encoded)
+        {
+            details::SettingVariant result;
+            SnapshotReader reader{ encoded };
+            ReadSnapshotValue(setting, reader, result, std::make_index_sequence<static_cast<size_t>(Setting::Max)>());
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), !reader.IsEmpty());
+            return result;
+        }
+
+        std::filesystem::path GetSnapshotPath()
+        {
+            return GetPathTo(PathName::LocalState) / "settings.snapshot";
+        }
+
+        std::string GetSnapshotBuildIdentity()
+        {
+            return Runtime::GetClientVersion().get() + '/' + std::to_string(static_cast<size_t>(Setting::Max));
+        }
+
+        void WriteSnapshot(const ParsedUserSettings& parsed)
+        {
+            SnapshotWriter payload;
+            payload.Write(GetSnapshotBuildIdentity());
+            payload.Write(parsed.PrimaryKey);
+            payload.Write(parsed.BackupKey);
+            payload.Write(static_cast<uint64_t>(parsed.Type));
+
+            payload.Write(static_cast<uint64_t>(parsed.Warnings.size()));
+            for (const auto& warning : parsed.Warnings)
+            {
+                auto itr = std::find_if(std::begin(s_SettingsSnapshot_Warnings), std::end(s_SettingsSnapshot_Warnings),
+                    [&](const StringResource::StringId* id) { return *id == warning.second.Message; });
+                THROW_HR_IF(E_UNEXPECTED, itr == std::end(s_SettingsSnapshot_Warnings));
+
+                payload.Write(static_cast<uint64_t>(warning.first));
+                payload.Write(static_cast<uint64_t>(std::distance(std::begin(s_SettingsSnapshot_Warnings), itr)));
+                payload.Write(warning.second.Path);
+                payload.Write(warning.second.Data);
+                payload.Write(static_cast<uint64_t>(warning.second.IsFieldWarning));
+            }
+
+            payload.Write(static_cast<uint64_t>(parsed.Values.size() + parsed.EncodedValues.size()));
+            for (const auto& setting : parsed.Values)
+            {
+                SnapshotWriter value;
+                std::visit([&](const auto& settingValue)
+                    {
+                        using value_t = std::decay_t<decltype(settingValue)>;
+                        if constexpr (std::is_same_v<value_t, std::monostate>)
+                        {
+                            THROW_HR(E_UNEXPECTED);
+                        }
+                        else
+                        {
+                            value.WriteValue(settingValue);
+                        }
+                    }, setting.second);
+
+                payload.Write(static_cast<uint64_t>(setting.first));
+                payload.Write(value.Buffer());
+            }
+
+            for (const auto& setting : parsed.EncodedValues)
+            {
+                payload.Write(static_cast<uint64_t>(setting.first));
+                payload.Write(setting.second);
+            }
+
+            const std::string& payloadBuffer = payload.Buffer();
+            THROW_HR_IF(E_UNEXPECTED, payloadBuffer.size() > std::numeric_limits<uint32_t>::max());
+            SHA256::HashBuffer payloadHash = SHA256::ComputeHash(payloadBuffer);
+
+            std::string snapshot{ s_SettingsSnapshot_Magic };
+            for (uint32_t value : { s_SettingsSnapshot_Version, static_cast<uint32_t>(payloadBuffer.size()) })
+            {
+                snapshot.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+            snapshot.append(reinterpret_cast<const char*>(payloadHash.data()), payloadHash.size());
+            snapshot.append(payloadBuffer);
+
+            // Write beside the snapshot and rename over it, so that a concurrent reader sees either the old or the new one.
+            std::filesystem::path snapshotPath = GetSnapshotPath();
+            std::filesystem::path tempPath = snapshotPath;
+            tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L".tmp";
+
+            std::filesystem::create_directories(snapshotPath.parent_path());
+
+            {
+                std::ofstream stream{ tempPath, std::ios::binary | std::ios::trunc };
+                THROW_LAST_ERROR_IF(stream.fail());
+                stream.write(snapshot.data(), snapshot.size());
+                stream.flush();
+                THROW_LAST_ERROR_IF(stream.fail());
+            }
+
+            if (!MoveFileExW(tempPath.c_str(), snapshotPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+            {
+                DWORD error = GetLastError();
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                THROW_WIN32(error);
+            }
+
+            AICLI_LOG(Core, Verbose, << "Wrote settings snapshot");
+        }
+
+        // Determines whether the settings file still matches the key in the snapshot.
+        // Sets `rewrite` if it matched only by content, so that the next read can trust the file times again.
+        bool IsSettingsFileUnchanged(const StreamDefinition& setting, const SettingsFileKey& key, int64_t snapshotWriteTime, bool& rewrite)
+        {
+            if (!key.Read)
+            {
+                return true;
+            }
+
+            SettingsFileKey current = GetSettingsFileKey(setting);
+            if (current.Exists != key.Exists)
+            {
+                return false;
+            }
+
+            if (!current.Exists)
+            {
+                return true;
+            }
+
+            if (current.Size != key.Size)
+            {
+                return false;
+            }
+
+            auto racyWindow = std::chrono::duration_cast<std::filesystem::file_time_type::duration>(s_SettingsSnapshot_RacyWindow).count();
+            if (current.LastWriteTime == key.LastWriteTime && snapshotWriteTime - key.LastWriteTime >= racyWindow)
+            {
+                return true;
+            }
+
+            auto content = ReadSettingsFile(setting);
+            if (!content || !SHA256::AreEqual(SHA256::ComputeHash(content.value()), key.Hash))
+            {
+                return false;
+            }
+
+            rewrite = true;
+            return true;
+        }
+
+        // Reads the snapshot and returns its contents if all of the files that it was created from are unchanged.
+        std::optional<ParsedUserSettings> ReadSnapshot(bool& rewrite)
+        {
+            std::filesystem::path snapshotPath = GetSnapshotPath();
+
+            std::error_code ec;
+            auto snapshotWriteTime = std::filesystem::last_write_time(snapshotPath, ec);
+            if (ec)
+            {
+                AICLI_LOG(Core, Verbose, << "Settings snapshot not found");
+                return {};
+            }
+
+            std::string snapshot;
+            {
+                std::ifstream stream{ snapshotPath, std::ios::binary };
+                if (!stream)
+                {
+                    return {};
+                }
+
+                snapshot = Utility::ReadEntireStream(stream);
+            }
+
+            std::string_view snapshotView{ snapshot };
+            if (snapshotView.size() < s_SettingsSnapshot_HeaderSize || snapshotView.substr(0, s_SettingsSnapshot_Magic.size()) != s_SettingsSnapshot_Magic)
+            {
+                AICLI_LOG(Core, Warning, << "Settings snapshot is not valid");
+                return {};
+            }
+            snapshotView.remove_prefix(s_SettingsSnapshot_Magic.size());
+
+            uint32_t version = 0;
+            uint32_t payloadSize = 0;
+            std::memcpy(&version, snapshotView.data(), sizeof(version));
+            std::memcpy(&payloadSize, snapshotView.data() + sizeof(version), sizeof(payloadSize));
+            snapshotView.remove_prefix(sizeof(version) + sizeof(payloadSize));
+
+            SHA256::HashBuffer expectedHash{ snapshotView.begin(), snapshotView.begin() + SHA256::HashBufferSizeInBytes };
+            snapshotView.remove_prefix(SHA256::HashBufferSizeInBytes);
+
+            if (version != s_SettingsSnapshot_Version || payloadSize != snapshotView.size() ||
+                !SHA256::AreEqual(SHA256::ComputeHash(snapshotView), expectedHash))
+            {
+                AICLI_LOG(Core, Warning, << "Settings snapshot is not valid");
+                return {};
+            }
+
+            SnapshotReader reader{ snapshotView };
+            if (reader.ReadString() != GetSnapshotBuildIdentity())
+            {
+                AICLI_LOG(Core, Info, << "Settings snapshot was written by a different build");
+                return {};
+            }
+
+            ParsedUserSettings result;
+            result.PrimaryKey = reader.ReadKey();
+            result.BackupKey = reader.ReadKey();
+
+            int64_t snapshotTime = snapshotWriteTime.time_since_epoch().count();
+            if (!IsSettingsFileUnchanged(Stream::PrimaryUserSettings, result.PrimaryKey, snapshotTime, rewrite) ||
+                !IsSettingsFileUnchanged(Stream::BackupUserSettings, result.BackupKey, snapshotTime, rewrite))
+            {
+                AICLI_LOG(Core, Info, << "Settings have changed since the snapshot was written");
+                return {};
+            }
+
+            result.Type = static_cast<UserSettingsType>(reader.ReadUInt64());
+
+            uint64_t warningCount = reader.ReadUInt64();
+            for (uint64_t i = 0; i < warningCount; ++i)
+            {
+                Setting setting = static_cast<Setting>(reader.ReadUInt64());
+                uint64_t message = reader.ReadUInt64();
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), message >= ARRAYSIZE(s_SettingsSnapshot_Warnings));
+
+                UserSettings::Warning warning{ *s_SettingsSnapshot_Warnings[message] };
+                warning.Path = reader.ReadString();
+                warning.Data = reader.ReadString();
+                warning.IsFieldWarning = reader.ReadUInt64() != 0;
+                result.Warnings.emplace_back(setting, std::move(warning));
+            }
+
+            uint64_t valueCount = reader.ReadUInt64();
+            for (uint64_t i = 0; i < valueCount; ++i)
+            {
+                uint64_t setting = reader.ReadUInt64();
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), setting >= static_cast<uint64_t>(Setting::Max));
+                result.EncodedValues[static_cast<Setting>(setting)] = reader.ReadString();
+            }
+
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), !reader.IsEmpty());
+
+            AICLI_LOG(Core, Info, << "Settings loaded from snapshot");
+            return result;
+        }
+
+        // Records the current size and time of a file that was found to be unchanged by its content.
+        void RefreshSettingsFileKey(const StreamDefinition& setting, SettingsFileKey& key)
+        {
+            if (key.Read)
+            {
+                SettingsFileKey current = GetSettingsFileKey(setting);
+                current.Hash = std::move(key.Hash);
+                key = std::move(current);
+            }
+        }
+
+        // Gets the parsed settings from the snapshot if it is still valid, parsing the files and updating the snapshot if not.
+        ParsedUserSettings LoadUserSettings()
+        {
+            try
+            {
+                bool rewrite = false;
+                auto snapshot = ReadSnapshot(rewrite);
+                if (snapshot)
+                {
+                    if (rewrite)
+                    {
+                        // Record the current file times so that the next read does not need to hash the files.
+                        RefreshSettingsFileKey(Stream::PrimaryUserSettings, snapshot->PrimaryKey);
+                        RefreshSettingsFileKey(Stream::BackupUserSettings, snapshot->BackupKey);
+
+                        try
+                        {
+                            WriteSnapshot(snapshot.value());
+                        }
+                        CATCH_LOG();
+                    }
+
+                    return std::move(snapshot).value();
+                }
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(Core, Warning, << "Unable to read the settings snapshot");
+            }
+
+            ParsedUserSettings result = ParseUserSettings();
+
+            try
+            {
+                WriteSnapshot(result);
+            }
+            CATCH_LOG();
+
+            return result;
         }
     }
 
@@ -202,6 +853,13 @@ namespace AppInstaller::Settings
             return std::chrono::minutes(value);
         }
 
+        WINGET_VALIDATE_SIGNATURE(BackgroundUpdateWindowInMinutes)
+        {
+            return std::chrono::minutes(value);
+        }
+
+        WINGET_VALIDATE_PASS_THROUGH(SourceDataOnlyStorage)
+
         WINGET_VALIDATE_SIGNATURE(ProgressBarVisualStyle)
         {
             // progressBar property possible values
@@ -230,7 +888,12 @@ namespace AppInstaller::Settings
         WINGET_VALIDATE_PASS_THROUGH(EFDependencies)
         WINGET_VALIDATE_PASS_THROUGH(TelemetryDisable)
         WINGET_VALIDATE_PASS_THROUGH(EFDirectMSI)
+        WINGET_VALIDATE_PASS_THROUGH(EFUpgradeSnapshot)
         WINGET_VALIDATE_PASS_THROUGH(EnableSelfInitiatedMinidump)
+        WINGET_VALIDATE_PASS_THROUGH(LoggingBinaryTrace)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkHttp2)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkBandwidthLimitInKBps)
+        WINGET_VALIDATE_PASS_THROUGH(InstallMsiTransaction)
 
         WINGET_VALIDATE_SIGNATURE(InstallArchitecturePreference)
         {
@@ -291,6 +954,30 @@ namespace AppInstaller::Settings
             return SettingMapping<Setting::InstallLocalePreference>::Validate(value);
         }
 
+        WINGET_VALIDATE_SIGNATURE(InstallConcurrency)
+        {
+            static constexpr uint32_t s_maximumInstallConcurrency = 8;
+
+            if (value == 0 || value > s_maximumInstallConcurrency)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(InstallProgressIntervalInMilliseconds)
+        {
+            static constexpr uint32_t s_maximumIntervalInMilliseconds = 10000;
+
+            if (value > s_maximumIntervalInMilliseconds)
+            {
+                return {};
+            }
+
+            return std::chrono::milliseconds(value);
+        }
+
         WINGET_VALIDATE_SIGNATURE(NetworkDownloader)
         {
             static constexpr std::string_view s_downloader_default = "default";
@@ -313,11 +1000,176 @@ namespace AppInstaller::Settings
             return {};
         }
 
+        WINGET_VALIDATE_SIGNATURE(NetworkDOPriority)
+        {
+            static constexpr std::string_view s_priority_foreground = "foreground";
+            static constexpr std::string_view s_priority_background = "background";
+
+            if (Utility::CaseInsensitiveEquals(value, s_priority_foreground))
+            {
+                return DOPriority::Foreground;
+            }
+            else if (Utility::CaseInsensitiveEquals(value, s_priority_background))
+            {
+                return DOPriority::Background;
+            }
+
+            return {};
+        }
+
+        WINGET_VALIDATE_PASS_THROUGH(NetworkDOIndexDownloads)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkDOManifestDownloads)
+
         WINGET_VALIDATE_SIGNATURE(NetworkDOProgressTimeoutInSeconds)
         {
             return std::chrono::seconds(value);
         }
 
+        WINGET_VALIDATE_SIGNATURE(NetworkDownloadConcurrency)
+        {
+            static constexpr uint32_t s_maximumDownloadConcurrency = 16;
+
+            if (value == 0 || value > s_maximumDownloadConcurrency)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkDownloadSegments)
+        {
+            static constexpr uint32_t s_maximumDownloadSegments = 16;
+
+            if (value == 0 || value > s_maximumDownloadSegments)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkMaxConnectionsPerHost)
+        {
+            static constexpr uint32_t s_maximumConnectionsPerHost = 32;
+
+            if (value == 0 || value > s_maximumConnectionsPerHost)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkRestSearchConcurrency)
+        {
+            static constexpr uint32_t s_maximumRestSearchConcurrency = 16;
+
+            if (value == 0 || value > s_maximumRestSearchConcurrency)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkInstallerMirrors)
+        {
+            // Installers are only sent to a mirror that is secured, as it is trusted with the content
+            for (auto const& entry : value)
+            {
+                if (!Utility::CaseInsensitiveStartsWith(entry, "https://"))
+                {
+                    return {};
+                }
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(InstallerCacheLocation)
+        {
+            // Relative paths would depend on the working directory of each invocation
+            if (!value.empty() && std::filesystem::path{ Utility::ConvertToUTF16(value) }.is_relative())
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(InstallerCacheMaximumSizeInMB)
+        {
+            if (value == 0)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(PackageReadCachePageSizeInKB)
+        {
+            static constexpr uint32_t s_minimumPageSizeInKB = 4;
+            static constexpr uint32_t s_maximumPageSizeInKB = 4096;
+
+            if (value < s_minimumPageSizeInKB || value > s_maximumPageSizeInKB)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(PackageReadCacheMaximumPages)
+        {
+            static constexpr uint32_t s_maximumPages = 4096;
+
+            if (value == 0 || value > s_maximumPages)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(PackageReadCacheDiskSizeInMB)
+        {
+            static constexpr uint32_t s_maximumDiskSizeInMB = 4096;
+
+            if (value > s_maximumDiskSizeInMB)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(MemoryBudgetInMB)
+        {
+            // Below this, the limits derived from the budget would leave the caches too small to be of use.
+            static constexpr uint32_t s_minimumBudgetInMB = 64;
+
+            if (value < s_minimumBudgetInMB)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(ServerIdleTimeoutInSeconds)
+        {
+            static constexpr uint32_t s_maximumIdleTimeoutInSeconds = 3600;
+
+            if (value > s_maximumIdleTimeoutInSeconds)
+            {
+                return {};
+            }
+
+            return std::chrono::seconds(value);
+        }
+
         WINGET_VALIDATE_SIGNATURE(LoggingLevelPreference)
         {
             // logging preference possible values
@@ -404,15 +1256,27 @@ namespace AppInstaller::Settings
         return UserSettings::Instance();
     }
 
-    UserSettings::UserSettings() : m_type(UserSettingsType::Default)
+    // The values read from the snapshot, each of which is decoded the first time that it is read.
+    struct UserSettings::EncodedValues
     {
-        Json::Value settingsRoot = Json::Value::nullSingleton();
+        struct Value
+        {
+            Value(std::string encoded) : Encoded(std::move(encoded)) {}
 
-        // Settings can be loaded from settings.json or settings.json.backup files.
-        // 0 - Use default (empty) settings if disabled by group policy.
-        // 1 - Use settings.json if exists and passes parsing.
-        // 2 - Use settings.backup.json if settings.json fails to parse.
-        // 3 - Use default (empty) if both settings files fail to load.
+            std::string Encoded;
+            std::once_flag DecodeOnce;
+            details::SettingVariant Decoded;
+        };
+
+        std::map<Setting, Value> Values;
+    };
+
+    UserSettings::UserSettings() : m_type(UserSettingsType::Default)
+    {
+        // Settings are used as parsed from settings.json, or settings.json.backup if that fails; see ParseUserSettings.
+        // The result of parsing is kept in a snapshot that is reused until either file changes.
+        // Values from group policy are applied after, as they are not part of the snapshot.
+        // If group policy disables settings, the default (empty) settings are used.
 
         if (!GroupPolicies().IsEnabled(TogglePolicy::Policy::Settings))
         {
@@ -420,35 +1284,59 @@ namespace AppInstaller::Settings
             return;
         }
 
-        auto settingsJson = ParseFile(Stream::PrimaryUserSettings, m_warnings);
-        if (settingsJson.has_value())
+        ParsedUserSettings parsed = LoadUserSettings();
+        m_type = parsed.Type;
+
+        for (const auto& warning : parsed.Warnings)
         {
-            AICLI_LOG(Core, Info, << "Settings loaded from " << Stream::PrimaryUserSettings.Name);
-            m_type = UserSettingsType::Standard;
-            settingsRoot = settingsJson.value();
+            if (warning.first == Setting::Max)
+            {
+                m_warnings.emplace_back(warning.second);
+            }
         }
 
-        // Settings didn't parse or doesn't exist, try with backup.
-        if (settingsRoot.isNull())
+        if (m_type != UserSettingsType::Default)
         {
-            auto settingsBackupJson = ParseFile(Stream::BackupUserSettings, m_warnings);
-            if (settingsBackupJson.has_value())
+            std::map<Setting, std::string> encoded;
+            ApplyAll(parsed, m_settings, encoded, m_warnings, std::make_index_sequence<static_cast<size_t>(Setting::Max)>());
+
+            if (!encoded.empty())
             {
-                AICLI_LOG(Core, Info, << "Settings loaded from " << Stream::BackupUserSettings.Name);
-                m_warnings.emplace_back(StringResource::String::SettingsWarningLoadedBackupSettings);
-                m_type = UserSettingsType::Backup;
-                settingsRoot = settingsBackupJson.value();
+                m_encoded = std::make_shared<EncodedValues>();
+                for (auto& value : encoded)
+                {
+                    m_encoded->Values.emplace(std::piecewise_construct, std::forward_as_tuple(value.first), std::forward_as_tuple(std::move(value.second)));
+                }
             }
         }
+    }
 
-        if (!settingsRoot.isNull())
+    const details::SettingVariant* UserSettings::GetDecodedValue(Setting setting) const
+    {
+        if (!m_encoded)
         {
-            ValidateAll(settingsRoot, m_settings, m_warnings, std::make_index_sequence<static_cast<size_t>(Setting::Max)>());
+            return nullptr;
         }
-        else
+
+        auto itr = m_encoded->Values.find(setting);
+        if (itr == m_encoded->Values.end())
         {
-            AICLI_LOG(Core, Info, << "Valid settings file not found. Using default values.");
+            return nullptr;
         }
+
+        EncodedValues::Value& value = itr->second;
+        std::call_once(value.DecodeOnce, [&]()
+            {
+                value.Decoded = DecodeSnapshotValue(setting, value.Encoded);
+                value.Encoded.clear();
+            });
+
+        return &value.Decoded;
+    }
+
+    std::filesystem::path UserSettings::SnapshotFilePath()
+    {
+        return GetSnapshotPath();
     }
 
     void UserSettings::PrepareToShellExecuteFile() const
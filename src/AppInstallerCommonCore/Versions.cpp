@@ -19,6 +19,7 @@ namespace AppInstaller::Utility
     void Version::Assign(std::string&& version, std::string_view splitChars)
     {
         m_version = std::move(version);
+        m_parts.clear();
         size_t pos = 0;
 
         while (pos < m_version.length())
@@ -44,10 +45,26 @@ namespace AppInstaller::Utility
                 break;
             }
         }
+
+        CacheComparisonState();
+    }
+
+    void Version::CacheComparisonState()
+    {
+        m_isLatest = (m_parts.size() == 1 && m_parts[0].Integer == 0 && Utility::CaseInsensitiveEquals(m_parts[0].Other, s_Version_Part_Latest));
+        m_isUnknown = (m_parts.size() == 1 && m_parts[0].Integer == 0 && Utility::CaseInsensitiveEquals(m_parts[0].Other, s_Version_Part_Unknown));
+        m_hasOther = std::any_of(m_parts.begin(), m_parts.end(), [](const Part& part) { return !part.Other.empty(); });
     }
 
     bool Version::operator<(const Version& other) const
     {
+        // Most versions are only integers, which can be compared without any of the special cases below.
+        if (!m_hasOther && !other.m_hasOther)
+        {
+            return std::lexicographical_compare(m_parts.begin(), m_parts.end(), other.m_parts.begin(), other.m_parts.end(),
+                [](const Part& a, const Part& b) { return a.Integer < b.Integer; });
+        }
+
         // Sort Latest higher than any other values
         bool thisIsLatest = IsLatest();
         bool otherIsLatest = other.IsLatest();
@@ -117,11 +134,17 @@ namespace AppInstaller::Utility
             return true;
         }
 
-        if (m_parts.size() != other.m_parts.size())
+        if (m_parts.size() != other.m_parts.size() || m_hasOther != other.m_hasOther)
         {
             return false;
         }
 
+        if (!m_hasOther)
+        {
+            return std::equal(m_parts.begin(), m_parts.end(), other.m_parts.begin(),
+                [](const Part& a, const Part& b) { return a.Integer == b.Integer; });
+        }
+
         for (size_t i = 0; i < m_parts.size(); ++i)
         {
             if (m_parts[i] != other.m_parts[i])
@@ -140,7 +163,7 @@ namespace AppInstaller::Utility
 
     bool Version::IsLatest() const
     {
-        return (m_parts.size() == 1 && m_parts[0].Integer == 0 && Utility::CaseInsensitiveEquals(m_parts[0].Other, s_Version_Part_Latest));
+        return m_isLatest;
     }
 
     Version Version::CreateLatest()
@@ -148,12 +171,13 @@ namespace AppInstaller::Utility
         Version result;
         result.m_version = s_Version_Part_Latest;
         result.m_parts.emplace_back(0, std::string{ s_Version_Part_Latest });
+        result.CacheComparisonState();
         return result;
     }
 
     bool Version::IsUnknown() const
     {
-        return (m_parts.size() == 1 && m_parts[0].Integer == 0 && Utility::CaseInsensitiveEquals(m_parts[0].Other, s_Version_Part_Unknown));
+        return m_isUnknown;
     }
 
     Version Version::CreateUnknown()
@@ -161,6 +185,7 @@ namespace AppInstaller::Utility
         Version result;
         result.m_version = s_Version_Part_Unknown;
         result.m_parts.emplace_back(0, std::string{ s_Version_Part_Unknown });
+        result.CacheComparisonState();
         return result;
     }
 
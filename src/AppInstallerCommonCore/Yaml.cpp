@@ -156,35 +156,31 @@ namespace AppInstaller::YAML
     Node& Node::operator[](std::string_view key)
     {
         Require(Type::Mapping);
-        auto itrs = m_mapping->equal_range(key);
+        auto [first, last] = FindMappingRange(key);
 
-        if (itrs.first == itrs.second)
+        if (first == last)
         {
             return s_globalInvalidNode;
         }
 
-        Node& result = itrs.first->second;
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_DUPLICATE_MAPPING_KEY, last - first > 1);
 
-        THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_DUPLICATE_MAPPING_KEY, ++itrs.first != itrs.second);
-
-        return result;
+        return m_mapping.value()[first].second;
     }
 
     const Node& Node::operator[](std::string_view key) const
     {
         Require(Type::Mapping);
-        auto itrs = m_mapping->equal_range(key);
+        auto [first, last] = FindMappingRange(key);
 
-        if (itrs.first == itrs.second)
+        if (first == last)
         {
             return s_globalInvalidNode;
         }
 
-        const Node& result = itrs.first->second;
-
-        THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_DUPLICATE_MAPPING_KEY, ++itrs.first != itrs.second);
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_DUPLICATE_MAPPING_KEY, last - first > 1);
 
-        return result;
+        return m_mapping.value()[first].second;
     }
 
     Node& Node::operator[](size_t index)
@@ -222,12 +218,45 @@ namespace AppInstaller::YAML
         return m_sequence.value();
     }
 
-    const std::multimap<Node, Node>& Node::Mapping() const
+    const std::vector<std::pair<Node, Node>>& Node::Mapping() const
     {
         Require(Type::Mapping);
         return m_mapping.value();
     }
 
+    Node& Node::AddMappingNodeInternal(Node&& key, Node&& value)
+    {
+        Require(Type::Mapping);
+        key.Require(Type::Scalar);
+
+        auto& mapping = m_mapping.value();
+
+        // Keys mostly arrive in order when building, so check the end before searching.
+        auto itr = mapping.end();
+        if (!mapping.empty() && key.m_scalar < mapping.back().first.m_scalar)
+        {
+            itr = std::upper_bound(mapping.begin(), mapping.end(), key.m_scalar,
+                [](const std::string& k, const std::pair<Node, Node>& entry) { return k < entry.first.m_scalar; });
+        }
+
+        return mapping.emplace(itr, std::move(key), std::move(value))->second;
+    }
+
+    std::pair<size_t, size_t> Node::FindMappingRange(std::string_view key) const
+    {
+        const auto& mapping = m_mapping.value();
+
+        auto first = std::lower_bound(mapping.begin(), mapping.end(), key,
+            [](const std::pair<Node, Node>& entry, std::string_view k) { return std::string_view{ entry.first.m_scalar } < k; });
+        auto last = first;
+        while (last != mapping.end() && std::string_view{ last->first.m_scalar } == key)
+        {
+            ++last;
+        }
+
+        return { static_cast<size_t>(first - mapping.begin()), static_cast<size_t>(last - mapping.begin()) };
+    }
+
     void Node::Require(Type type) const
     {
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INVALID_OPERATION, m_type != type);
@@ -268,16 +297,7 @@ namespace AppInstaller::YAML
     Node Load(std::string_view input)
     {
         Wrapper::Parser parser(input);
-        Wrapper::Document document = parser.Load();
-
-        if (document.HasRoot())
-        {
-            return document.GetRoot();
-        }
-        else
-        {
-            return {};
-        }
+        return parser.Load();
     }
 
     Node Load(const std::string& input)
@@ -288,16 +308,7 @@ namespace AppInstaller::YAML
     Node Load(std::istream& input, Utility::SHA256::HashBuffer* hashOut)
     {
         Wrapper::Parser parser(input, hashOut);
-        Wrapper::Document document = parser.Load();
-
-        if (document.HasRoot())
-        {
-            return document.GetRoot();
-        }
-        else
-        {
-            return {};
-        }
+        return parser.Load();
     }
 
     Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer* hashOut)
@@ -11,23 +11,6 @@ namespace AppInstaller::YAML::Wrapper
 {
     namespace
     {
-        Node::Type ConvertNodeType(yaml_node_type_t type)
-        {
-            switch (type)
-            {
-            case YAML_NO_NODE:
-                return Node::Type::None;
-            case YAML_SCALAR_NODE:
-                return Node::Type::Scalar;
-            case YAML_SEQUENCE_NODE:
-                return Node::Type::Sequence;
-            case YAML_MAPPING_NODE:
-                return Node::Type::Mapping;
-            }
-
-            THROW_HR(E_UNEXPECTED);
-        }
-
         Exception::Type ConvertErrorType(yaml_error_type_t type)
         {
             switch (type)
@@ -65,14 +48,26 @@ namespace AppInstaller::YAML::Wrapper
             }
         }
 
-        std::string ConvertScalarToString(yaml_node_t* node)
+        Mark ConvertMark(const yaml_mark_t& mark)
         {
-            return ConvertYamlString(node->data.scalar.value, node->data.scalar.length);
+            return { mark.line + 1, mark.column + 1 };
         }
 
-        Mark ConvertMark(const yaml_mark_t& mark)
+        // Gets the tag of a node; a missing or non-specific tag, which the libyaml loader would resolve to the default
+        // for the node type, is left empty to avoid allocating the same long string for every node.
+        std::string ConvertTag(yaml_char_t* tag)
         {
-            return { mark.line + 1, mark.column + 1 };
+            if (!tag || strcmp(reinterpret_cast<char*>(tag), "!") == 0)
+            {
+                return {};
+            }
+
+            return ConvertYamlString(tag);
+        }
+
+        std::string ConvertAnchor(yaml_char_t* anchor)
+        {
+            return anchor ? ConvertYamlString(anchor) : std::string{};
         }
     }
 
@@ -101,99 +96,6 @@ namespace AppInstaller::YAML::Wrapper
         }
     }
 
-    bool Document::HasRoot()
-    {
-        return yaml_document_get_root_node(&m_document) != nullptr;
-    }
-
-    Node Document::GetRoot()
-    {
-        yaml_node_t* root = yaml_document_get_root_node(&m_document);
-
-        if (!root)
-        {
-            return {};
-        }
-
-        Node result(ConvertNodeType(root->type), ConvertYamlString(root->tag), ConvertMark(root->start_mark));
-
-        struct StackItem
-        {
-            StackItem(yaml_node_t* yn, Node* n) :
-                yamlNode(yn), node(n) {}
-
-            yaml_node_t* yamlNode = nullptr;
-            Node* node = nullptr;
-            size_t childOffset = 0;
-        };
-
-        std::stack<StackItem> resultStack;
-        resultStack.emplace(root, &result);
-
-        while (!resultStack.empty())
-        {
-            StackItem& stackItem = resultStack.top();
-            bool pop = false;
-
-            switch (stackItem.yamlNode->type)
-            {
-            case YAML_NO_NODE:
-                pop = true;
-                break;
-            case YAML_SCALAR_NODE:
-                stackItem.node->SetScalar(ConvertScalarToString(stackItem.yamlNode));
-                pop = true;
-                break;
-            case YAML_SEQUENCE_NODE:
-            {
-                yaml_node_item_t* child = stackItem.yamlNode->data.sequence.items.start + stackItem.childOffset++;
-                if (child < stackItem.yamlNode->data.sequence.items.top)
-                {
-                    yaml_node_t* childYamlNode = GetNode(*child);
-                    Node& childNode = stackItem.node->AddSequenceNode(ConvertNodeType(childYamlNode->type), ConvertYamlString(childYamlNode->tag), ConvertMark(childYamlNode->start_mark));
-                    resultStack.emplace(childYamlNode, &childNode);
-                }
-                else
-                {
-                    // We've reached the end of the sequence
-                    pop = true;
-                }
-                break;
-            }
-            case YAML_MAPPING_NODE:
-            {
-                yaml_node_pair_t* child = stackItem.yamlNode->data.mapping.pairs.start + stackItem.childOffset++;
-                if (child < stackItem.yamlNode->data.mapping.pairs.top)
-                {
-                    yaml_node_t* keyYamlNode = GetNode(child->key);
-                    THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INVALID_MAPPING_KEY, keyYamlNode->type != YAML_SCALAR_NODE);
-
-                    Node keyNode(ConvertNodeType(keyYamlNode->type), ConvertYamlString(keyYamlNode->tag), ConvertMark(keyYamlNode->start_mark));
-                    keyNode.SetScalar(ConvertScalarToString(keyYamlNode));
-
-                    yaml_node_t* valueYamlNode = GetNode(child->value);
-
-                    Node& childNode = stackItem.node->AddMappingNode(std::move(keyNode), ConvertNodeType(valueYamlNode->type), ConvertYamlString(valueYamlNode->tag), ConvertMark(valueYamlNode->start_mark));
-                    resultStack.emplace(valueYamlNode, &childNode);
-                }
-                else
-                {
-                    // We've reached the end of the mapping
-                    pop = true;
-                }
-                break;
-            }
-            }
-
-            if (pop)
-            {
-                resultStack.pop();
-            }
-        }
-
-        return result;
-    }
-
     int Document::AddScalar(std::string_view value)
     {
         int result = yaml_document_add_scalar(&m_document, NULL, reinterpret_cast<const yaml_char_t*>(value.data()), static_cast<int>(value.size()), YAML_ANY_SCALAR_STYLE);
@@ -231,13 +133,6 @@ namespace AppInstaller::YAML::Wrapper
         }
     }
 
-    yaml_node_t* Document::GetNode(yaml_node_item_t index)
-    {
-        yaml_node_t* result = yaml_document_get_node(&m_document, index);
-        THROW_HR_IF(E_BOUNDS, !result);
-        return result;
-    }
-
     Parser::Parser(std::string_view input) : m_token(true), m_input(input)
     {
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INIT_FAILED, !yaml_parser_initialize(&m_parser));
@@ -269,30 +164,144 @@ namespace AppInstaller::YAML::Wrapper
         }
     }
 
-    Document Parser::Load()
+    Node Parser::Load()
     {
-        Document result;
+        // The node is built directly from the parser events, rather than having libyaml compose a document
+        // that would then need to be copied, so that each value is only allocated once.
+        struct StackItem
+        {
+            StackItem(Node* n, std::string a) : node(n), anchor(std::move(a)) {}
+
+            Node* node = nullptr;
+            std::string anchor;
+            // For a mapping, the key that has been read and is waiting for its value.
+            std::optional<Node> key;
+        };
 
-        if (!yaml_parser_load(&m_parser, &result))
+        Node result;
+        std::vector<StackItem> resultStack;
+        std::map<std::string, Node> anchors;
+
+        // Places the completed (or started, for containers) node into its parent, returning its new location.
+        auto placeNode = [&](Node&& node) -> Node&
         {
-            Exception::Type type = ConvertErrorType(m_parser.error);
+            if (resultStack.empty())
+            {
+                result = std::move(node);
+                return result;
+            }
 
-            switch (type)
+            StackItem& parent = resultStack.back();
+
+            if (parent.node->IsSequence())
+            {
+                return parent.node->AddSequenceNode(std::move(node));
+            }
+
+            if (!parent.key)
+            {
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INVALID_MAPPING_KEY, !node.IsScalar());
+                parent.key = std::move(node);
+                return parent.key.value();
+            }
+
+            Node& value = parent.node->AddMappingNode(std::move(parent.key.value()), std::move(node));
+            parent.key.reset();
+            return value;
+        };
+
+        for (;;)
+        {
+            yaml_event_t event;
+            if (!yaml_parser_parse(&m_parser, &event))
+            {
+                ThrowError();
+            }
+
+            auto deleteEvent = wil::scope_exit([&]() { yaml_event_delete(&event); });
+
+            switch (event.type)
+            {
+            case YAML_NO_EVENT:
+            case YAML_STREAM_END_EVENT:
+            case YAML_DOCUMENT_END_EVENT:
+                // Only the first document is loaded.
+                return result;
+            case YAML_STREAM_START_EVENT:
+            case YAML_DOCUMENT_START_EVENT:
+                break;
+            case YAML_ALIAS_EVENT:
+            {
+                auto itr = anchors.find(ConvertYamlString(event.data.alias.anchor));
+                if (itr == anchors.end())
+                {
+                    THROW_EXCEPTION(Exception(Exception::Type::Composer, "found undefined alias", ConvertMark(event.start_mark)));
+                }
+
+                placeNode(Node{ itr->second });
+                break;
+            }
+            case YAML_SCALAR_EVENT:
+            {
+                Node node(Node::Type::Scalar, ConvertTag(event.data.scalar.tag), ConvertMark(event.start_mark));
+                node.SetScalar(ConvertYamlString(event.data.scalar.value, event.data.scalar.length));
+
+                Node& placed = placeNode(std::move(node));
+                if (event.data.scalar.anchor)
+                {
+                    anchors[ConvertYamlString(event.data.scalar.anchor)] = placed;
+                }
+                break;
+            }
+            case YAML_SEQUENCE_START_EVENT:
+            {
+                Node& placed = placeNode(Node(Node::Type::Sequence, ConvertTag(event.data.sequence_start.tag), ConvertMark(event.start_mark)));
+                resultStack.emplace_back(&placed, ConvertAnchor(event.data.sequence_start.anchor));
+                break;
+            }
+            case YAML_MAPPING_START_EVENT:
+            {
+                Node& placed = placeNode(Node(Node::Type::Mapping, ConvertTag(event.data.mapping_start.tag), ConvertMark(event.start_mark)));
+                resultStack.emplace_back(&placed, ConvertAnchor(event.data.mapping_start.anchor));
+                break;
+            }
+            case YAML_SEQUENCE_END_EVENT:
+            case YAML_MAPPING_END_EVENT:
             {
-            case Exception::Type::Memory:
-                THROW_EXCEPTION(Exception(type));
-            case Exception::Type::Reader:
-                THROW_EXCEPTION(Exception(type, m_parser.problem, m_parser.problem_offset, m_parser.problem_value));
-            case Exception::Type::Scanner:
-            case Exception::Type::Parser:
-            case Exception::Type::Composer:
-                THROW_EXCEPTION(Exception(type, m_parser.problem, ConvertMark(m_parser.problem_mark), m_parser.context, ConvertMark(m_parser.context_mark)));
+                THROW_HR_IF(E_UNEXPECTED, resultStack.empty());
+
+                StackItem& item = resultStack.back();
+                if (!item.anchor.empty())
+                {
+                    anchors[item.anchor] = *item.node;
+                }
+
+                resultStack.pop_back();
+                break;
+            }
             default:
-                THROW_EXCEPTION(Exception(type, "An unexpected error type occurred in Parser::Load"));
+                THROW_HR(E_UNEXPECTED);
             }
         }
+    }
 
-        return result;
+    void Parser::ThrowError()
+    {
+        Exception::Type type = ConvertErrorType(m_parser.error);
+
+        switch (type)
+        {
+        case Exception::Type::Memory:
+            THROW_EXCEPTION(Exception(type));
+        case Exception::Type::Reader:
+            THROW_EXCEPTION(Exception(type, m_parser.problem, m_parser.problem_offset, m_parser.problem_value));
+        case Exception::Type::Scanner:
+        case Exception::Type::Parser:
+        case Exception::Type::Composer:
+            THROW_EXCEPTION(Exception(type, m_parser.problem, ConvertMark(m_parser.problem_mark), m_parser.context, ConvertMark(m_parser.context_mark)));
+        default:
+            THROW_EXCEPTION(Exception(type, "An unexpected error type occurred in Parser::Load"));
+        }
     }
 
     void Parser::PrepareInput()
@@ -14,7 +14,7 @@
 namespace AppInstaller::YAML::Wrapper
 {
     // A libyaml yaml_document_t.
-    // A parsed document, created by the Parser.
+    // A document being built for the Emitter.
     struct Document
     {
         // Initializes the document.
@@ -34,12 +34,6 @@ namespace AppInstaller::YAML::Wrapper
         // it has been handed off to the emitter.
         void Detach() { m_token = false; }
 
-        // Determines whether the document has a root node.
-        bool HasRoot();
-
-        // Gets the root node of the document, if it has one.
-        Node GetRoot();
-
         // Adds a scalar node to the document.
         int AddScalar(std::string_view value);
 
@@ -56,9 +50,6 @@ namespace AppInstaller::YAML::Wrapper
         void AppendMappingPair(int mapping, int key, int value);
 
     private:
-        // Gets the node referenced by the index.
-        yaml_node_t* GetNode(yaml_node_item_t index);
-
         DestructionToken m_token;
         yaml_document_t m_document;
     };
@@ -80,13 +71,16 @@ namespace AppInstaller::YAML::Wrapper
 
         yaml_parser_t* operator&() { return &m_parser; }
 
-        // Loads the next document from the input, if one exists.
-        Document Load();
+        // Loads the root node of the next document from the input, if one exists.
+        Node Load();
 
     private:
         // Determines the type of encoding in use, transforming the input as necessary.
         void PrepareInput();
 
+        // Throws the error reported by the parser.
+        [[noreturn]] void ThrowError();
+
         DestructionToken m_token;
         yaml_parser_t m_parser;
         std::string m_input;
@@ -30,6 +30,7 @@
 #pragma warning( pop )
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cwctype>
@@ -40,8 +41,10 @@
 #include <iomanip>
 #include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <ostream>
 #include <regex>
 #include <set>
@@ -49,7 +52,9 @@
 #include <sstream>
 #include <stack>
 #include <string_view>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #pragma warning( push )
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/ARPKeySnapshot.h"
+#include "Microsoft/ARPHelper.h"
+#include <AppInstallerSHA256.h>
+
+
+namespace AppInstaller::Repository
+{
+#ifndef AICLI_DISABLE_TEST_HOOKS
+    namespace
+    {
+        static std::function<std::optional<ARPKeySnapshot>()> s_ARPKeySnapshot_TestHook_Override;
+    }
+
+    void TestHook_SetARPKeySnapshotOverride(std::function<std::optional<ARPKeySnapshot>()>&& snapshot)
+    {
+        s_ARPKeySnapshot_TestHook_Override = std::move(snapshot);
+    }
+#endif
+
+    std::optional<ARPKeySnapshot> ARPKeySnapshot::TryCreate() try
+    {
+#ifndef AICLI_DISABLE_TEST_HOOKS
+        if (s_ARPKeySnapshot_TestHook_Override)
+        {
+            return s_ARPKeySnapshot_TestHook_Override();
+        }
+#endif
+
+        Entries entries;
+
+        Microsoft::ARPHelper arpHelper;
+        arpHelper.SnapshotARPKeys(entries, Manifest::ScopeEnum::Machine);
+        arpHelper.SnapshotARPKeys(entries, Manifest::ScopeEnum::User);
+
+        return ARPKeySnapshot{ std::move(entries) };
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        AICLI_LOG(Repo, Warning, << "Failed to create a snapshot of the ARP keys");
+        return {};
+    }
+
+    std::vector<std::string> ARPKeySnapshot::GetChangedProductCodes(const ARPKeySnapshot& current) const
+    {
+        std::vector<std::string> result;
+
+        for (const auto& entry : current.m_entries)
+        {
+            auto itr = m_entries.find(entry.first);
+            if (itr == m_entries.end() || itr->second != entry.second)
+            {
+                result.emplace_back(entry.first.second);
+            }
+        }
+
+        // The same product code can be written to more than one location.
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+
+        return result;
+    }
+
+    std::string ARPKeySnapshot::GetFingerprint() const
+    {
+        Utility::SHA256 hash;
+
+        for (const auto& entry : m_entries)
+        {
+            std::string value = entry.first.first;
+            value += '|';
+            value += entry.first.second;
+            value += '|';
+            value += std::to_string(entry.second.time_since_epoch().count());
+            value += '\n';
+
+            hash.Add(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+        }
+
+        return Utility::SHA256::ConvertToString(hash.Get());
+    }
+}
@@ -0,0 +1,367 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "winget/CompletionIndex.h"
+#include "Microsoft/PreIndexedPackageSourceFactory.h"
+#include "SourceList.h"
+
+using namespace std::string_view_literals;
+
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        constexpr std::string_view s_CompletionIndex_Magic{ "WGCOMPL\0", 8 };
+        constexpr uint32_t s_CompletionIndex_Version = 1;
+
+        // The fields that are stored in the keys.
+        enum class KeyField : uint32_t
+        {
+            Id = 1,
+            Name = 2,
+            Moniker = 3,
+        };
+
+        std::optional<KeyField> ToKeyField(PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id: return KeyField::Id;
+            case PackageMatchField::Name: return KeyField::Name;
+            case PackageMatchField::Moniker: return KeyField::Moniker;
+            default: return std::nullopt;
+            }
+        }
+
+        std::optional<CompletionIndex> TryOpenForSource(const SourceDetails& details)
+        {
+            if (!Utility::CaseInsensitiveEquals(details.Type, Microsoft::PreIndexedPackageSourceFactory::Type()))
+            {
+                AICLI_LOG(Repo, Verbose, << "Source type does not have a completion index: " << details.Name << " => " << details.Type);
+                return std::nullopt;
+            }
+
+            std::filesystem::path path = Microsoft::PreIndexedPackageSourceFactory::GetCompletionIndexPath(details);
+
+            try
+            {
+                return CompletionIndex{ path };
+            }
+            catch (...)
+            {
+                AICLI_LOG(Repo, Info, << "Completion index not available for source: " << details.Name);
+                return std::nullopt;
+            }
+        }
+    }
+
+#pragma pack(push, 1)
+    struct CompletionIndex::Header
+    {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t KeyCount;
+        uint32_t PackageCount;
+        uint32_t VersionCount;
+        uint32_t StringsSize;
+        uint32_t Reserved;
+    };
+
+    struct CompletionIndex::StringRef
+    {
+        uint32_t Offset;
+        uint32_t Length;
+    };
+
+    struct CompletionIndex::KeyRecord
+    {
+        StringRef Value;
+        uint32_t Package;
+        uint32_t Field;
+    };
+
+    struct CompletionIndex::PackageRecord
+    {
+        StringRef Id;
+        StringRef Name;
+        StringRef Moniker;
+        uint32_t FirstVersion;
+        uint32_t VersionCount;
+    };
+
+    struct CompletionIndex::VersionRecord
+    {
+        StringRef Version;
+        StringRef Channel;
+    };
+#pragma pack(pop)
+
+    CompletionIndex::CompletionIndex(const std::filesystem::path& path)
+    {
+        // Allow the file to be replaced while it is mapped; the next update rewrites it under a new name and renames it over this one.
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        LARGE_INTEGER size{};
+        THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(file.get(), &size));
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, size.QuadPart < static_cast<LONGLONG>(sizeof(Header)) || size.HighPart != 0);
+        m_size = static_cast<size_t>(size.QuadPart);
+
+        m_mapping.reset(CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+        THROW_LAST_ERROR_IF(!m_mapping);
+
+        m_view.reset(static_cast<uint8_t*>(MapViewOfFile(m_mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+        THROW_LAST_ERROR_IF(!m_view);
+
+        const Header* header = reinterpret_cast<const Header*>(m_view.get());
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, std::string_view(header->Magic, sizeof(header->Magic)) != s_CompletionIndex_Magic);
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, header->Version != s_CompletionIndex_Version);
+
+        m_keyCount = header->KeyCount;
+        m_packageCount = header->PackageCount;
+        m_versionCount = header->VersionCount;
+        m_stringsSize = header->StringsSize;
+
+        uint64_t expectedSize = sizeof(Header) +
+            static_cast<uint64_t>(m_keyCount) * sizeof(KeyRecord) +
+            static_cast<uint64_t>(m_packageCount) * sizeof(PackageRecord) +
+            static_cast<uint64_t>(m_versionCount) * sizeof(VersionRecord) +
+            m_stringsSize;
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, expectedSize != m_size);
+
+        const uint8_t* current = m_view.get() + sizeof(Header);
+        m_keys = reinterpret_cast<const KeyRecord*>(current);
+        current += m_keyCount * sizeof(KeyRecord);
+        m_packages = reinterpret_cast<const PackageRecord*>(current);
+        current += m_packageCount * sizeof(PackageRecord);
+        m_versions = reinterpret_cast<const VersionRecord*>(current);
+        current += m_versionCount * sizeof(VersionRecord);
+        m_strings = reinterpret_cast<const char*>(current);
+    }
+
+    void CompletionIndex::Create(const std::filesystem::path& path, const std::vector<Package>& packages)
+    {
+        std::string strings;
+        auto addString = [&](std::string_view value)
+        {
+            StringRef result{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+            strings.append(value);
+            return result;
+        };
+
+        std::vector<std::pair<std::string, KeyRecord>> keys;
+        std::vector<PackageRecord> packageRecords;
+        std::vector<VersionRecord> versionRecords;
+        packageRecords.reserve(packages.size());
+
+        for (const auto& package : packages)
+        {
+            uint32_t packageIndex = static_cast<uint32_t>(packageRecords.size());
+            PackageRecord& record = packageRecords.emplace_back();
+            record.Id = addString(package.Id);
+            record.Name = addString(package.Name);
+            record.Moniker = addString(package.Moniker);
+            record.FirstVersion = static_cast<uint32_t>(versionRecords.size());
+            record.VersionCount = static_cast<uint32_t>(package.Versions.size());
+
+            for (const auto& version : package.Versions)
+            {
+                versionRecords.push_back({ addString(version.GetVersion().ToString()), addString(version.GetChannel().ToString()) });
+            }
+
+            for (auto [field, value] : { std::make_pair(KeyField::Id, std::string_view{ package.Id }), std::make_pair(KeyField::Name, std::string_view{ package.Name }), std::make_pair(KeyField::Moniker, std::string_view{ package.Moniker }) })
+            {
+                if (!value.empty())
+                {
+                    keys.emplace_back(Utility::FoldCase(value), KeyRecord{ {}, packageIndex, static_cast<uint32_t>(field) });
+                }
+            }
+        }
+
+        std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<KeyRecord> keyRecords;
+        keyRecords.reserve(keys.size());
+        for (auto& key : keys)
+        {
+            key.second.Value = addString(key.first);
+            keyRecords.emplace_back(key.second);
+        }
+
+        Header header{};
+        std::memcpy(header.Magic, s_CompletionIndex_Magic.data(), sizeof(header.Magic));
+        header.Version = s_CompletionIndex_Version;
+        header.KeyCount = static_cast<uint32_t>(keyRecords.size());
+        header.PackageCount = static_cast<uint32_t>(packageRecords.size());
+        header.VersionCount = static_cast<uint32_t>(versionRecords.size());
+        header.StringsSize = static_cast<uint32_t>(strings.size());
+
+        // Write beside the destination then rename over it, so that readers never see a partial file.
+        std::filesystem::path tempPath = path;
+        tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L".tmp";
+
+        {
+            std::ofstream stream{ tempPath, std::ios::binary | std::ios::trunc };
+            THROW_HR_IF(E_ACCESSDENIED, !stream);
+
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(keyRecords.data()), keyRecords.size() * sizeof(KeyRecord));
+            stream.write(reinterpret_cast<const char*>(packageRecords.data()), packageRecords.size() * sizeof(PackageRecord));
+            stream.write(reinterpret_cast<const char*>(versionRecords.data()), versionRecords.size() * sizeof(VersionRecord));
+            stream.write(strings.data(), strings.size());
+            stream.flush();
+            THROW_HR_IF(E_FAIL, !stream);
+        }
+
+        if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+        {
+            DWORD error = GetLastError();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            THROW_WIN32(error);
+        }
+
+        AICLI_LOG(Repo, Info, << "Wrote completion index with " << packageRecords.size() << " packages to " << path);
+    }
+
+    std::optional<std::vector<CompletionIndex>> CompletionIndex::TryOpenForSources(std::string_view sourceName)
+    {
+        SourceList sourceList;
+        std::vector<CompletionIndex> result;
+
+        if (sourceName.empty())
+        {
+            for (const auto& source : sourceList.GetCurrentSourceRefs())
+            {
+                auto index = TryOpenForSource(source.get());
+                if (!index)
+                {
+                    return std::nullopt;
+                }
+
+                result.emplace_back(std::move(index).value());
+            }
+        }
+        else
+        {
+            auto source = sourceList.GetCurrentSource(sourceName);
+            if (source)
+            {
+                auto index = TryOpenForSource(*source);
+                if (!index)
+                {
+                    return std::nullopt;
+                }
+
+                result.emplace_back(std::move(index).value());
+            }
+        }
+
+        if (result.empty())
+        {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+    std::vector<std::string> CompletionIndex::Complete(PackageMatchField field, std::string_view word) const
+    {
+        auto keyField = ToKeyField(field);
+        THROW_HR_IF(E_INVALIDARG, !keyField);
+
+        std::vector<std::string> result;
+
+        auto [begin, end] = FindKeys(Utility::FoldCase(word));
+        for (auto key = begin; key != end; ++key)
+        {
+            if (key->Field != static_cast<uint32_t>(keyField.value()))
+            {
+                continue;
+            }
+
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, key->Package >= m_packageCount);
+            const PackageRecord& package = m_packages[key->Package];
+
+            switch (keyField.value())
+            {
+            case KeyField::Id: result.emplace_back(GetString(package.Id)); break;
+            case KeyField::Name: result.emplace_back(GetString(package.Name)); break;
+            case KeyField::Moniker: result.emplace_back(GetString(package.Moniker)); break;
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<uint32_t> CompletionIndex::FindPackages(std::string_view value, const std::vector<PackageMatchField>& fields) const
+    {
+        std::vector<uint32_t> result;
+
+        std::string folded = Utility::FoldCase(value);
+        auto [begin, end] = FindKeys(folded);
+        for (auto key = begin; key != end; ++key)
+        {
+            if (GetString(key->Value).size() != folded.size())
+            {
+                continue;
+            }
+
+            bool fieldRequested = std::any_of(fields.begin(), fields.end(), [&](PackageMatchField field)
+                {
+                    auto keyField = ToKeyField(field);
+                    return keyField && static_cast<uint32_t>(keyField.value()) == key->Field;
+                });
+
+            if (fieldRequested && std::find(result.begin(), result.end(), key->Package) == result.end())
+            {
+                result.emplace_back(key->Package);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<Utility::VersionAndChannel> CompletionIndex::GetVersions(uint32_t package) const
+    {
+        THROW_HR_IF(E_INVALIDARG, package >= m_packageCount);
+        const PackageRecord& record = m_packages[package];
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, static_cast<uint64_t>(record.FirstVersion) + record.VersionCount > m_versionCount);
+
+        std::vector<Utility::VersionAndChannel> result;
+        result.reserve(record.VersionCount);
+
+        for (uint32_t i = 0; i < record.VersionCount; ++i)
+        {
+            const VersionRecord& version = m_versions[record.FirstVersion + i];
+            result.emplace_back(Utility::Version{ std::string{ GetString(version.Version) } }, Utility::Channel{ std::string{ GetString(version.Channel) } });
+        }
+
+        return result;
+    }
+
+    std::string_view CompletionIndex::GetString(const StringRef& ref) const
+    {
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, static_cast<uint64_t>(ref.Offset) + ref.Length > m_stringsSize);
+        return { m_strings + ref.Offset, ref.Length };
+    }
+
+    std::pair<const CompletionIndex::KeyRecord*, const CompletionIndex::KeyRecord*> CompletionIndex::FindKeys(std::string_view foldedPrefix) const
+    {
+        const KeyRecord* keysEnd = m_keys + m_keyCount;
+
+        const KeyRecord* begin = std::lower_bound(m_keys, keysEnd, foldedPrefix, [&](const KeyRecord& key, std::string_view value)
+            {
+                return GetString(key.Value) < value;
+            });
+
+        const KeyRecord* end = begin;
+        while (end != keysEnd && Utility::StartsWith(GetString(end->Value), foldedPrefix))
+        {
+            ++end;
+        }
+
+        return { begin, end };
+    }
+}
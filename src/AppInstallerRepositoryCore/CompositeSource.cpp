@@ -2,6 +2,13 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "CompositeSource.h"
+#include "SearchArena.h"
+#include <winget/NameNormalization.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/TraceEvents.h>
+
+#include <future>
+#include <unordered_map>
 
 namespace AppInstaller::Repository
 {
@@ -37,7 +44,7 @@ namespace AppInstaller::Repository
 
             for (auto&& match : matches)
             {
-                AICLI_LOG(Repo, Info, << "  Checking match with package id: " << match.Package->GetProperty(PackageProperty::Id));
+                AICLI_TRACE(Repo, Info, RepoCheckingMatch, match.Package->GetProperty(PackageProperty::Id));
 
                 if (IsStrongMatchField(match.MatchCriteria.Field))
                 {
@@ -344,6 +351,101 @@ namespace AppInstaller::Repository
             std::stable_sort(matches.begin(), matches.end(), ResultMatchComparator());
         }
 
+        // The outcome of searching a single source, holding the exception rather than the result if the search failed.
+        struct SourceSearchResult
+        {
+            SearchResult Result;
+            std::exception_ptr Exception;
+
+            // Gets the result, throwing the exception from the search if there was one.
+            SearchResult&& Get()
+            {
+                if (Exception)
+                {
+                    std::rethrow_exception(Exception);
+                }
+
+                return std::move(Result);
+            }
+        };
+
+        // Runs the search function against every source concurrently, returning the outcomes in the same order as the sources.
+        // The total time is that of the slowest source rather than the sum of them; the time taken by each is logged.
+        template <typename SearchFunc>
+        std::vector<SourceSearchResult> SearchSourcesInParallel(const std::vector<Source>& sources, SearchFunc&& search, std::string_view purpose)
+        {
+            std::vector<SourceSearchResult> results(sources.size());
+
+            auto searchOne = [&](size_t index)
+            {
+                auto start = std::chrono::steady_clock::now();
+
+                try
+                {
+                    results[index].Result = search(sources[index]);
+                }
+                catch (...)
+                {
+                    results[index].Exception = std::current_exception();
+                }
+
+                auto duration = std::chrono::steady_clock::now() - start;
+
+                AICLI_LOG(Repo, Verbose, << "Search for " << purpose << " in source [" << sources[index].GetIdentifier() << "] took " <<
+                    std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms");
+
+                Logging::Telemetry().LogSourceSearch(sources[index].GetIdentifier(), purpose,
+                    results[index].Exception ? 0 : results[index].Result.Matches.size(), static_cast<bool>(results[index].Exception), duration);
+            };
+
+            if (sources.size() <= 1)
+            {
+                for (size_t i = 0; i < sources.size(); ++i)
+                {
+                    searchOne(i);
+                }
+
+                return results;
+            }
+
+            // Logging is done through the thread globals, so the workers must share those of the calling thread.
+            ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+
+            std::vector<std::future<void>> workers;
+            workers.reserve(sources.size() - 1);
+
+            for (size_t i = 1; i < sources.size(); ++i)
+            {
+                // Created here rather than on the worker, as creating them touches the parent.
+                std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+                if (parentThreadGlobals)
+                {
+                    threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+                }
+
+                workers.emplace_back(std::async(std::launch::async, [&searchOne, threadGlobals, i]()
+                    {
+                        std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                        if (threadGlobals)
+                        {
+                            previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                        }
+
+                        searchOne(i);
+                    }));
+            }
+
+            // Use the calling thread for the first source rather than leaving it idle.
+            searchOne(0);
+
+            for (auto& worker : workers)
+            {
+                worker.get();
+            }
+
+            return results;
+        }
+
         // A copy of the standard match that holds a CompositePackage instead.
         struct CompositeResultMatch
         {
@@ -353,6 +455,15 @@ namespace AppInstaller::Repository
             CompositeResultMatch(std::shared_ptr<CompositePackage> p, PackageMatchFilter f) : Package(std::move(p)), MatchCriteria(std::move(f)) {}
         };
 
+        // Correlating this many installed packages or more is done with batched searches of the available sources.
+        constexpr size_t s_BatchedCorrelationMinimumPackages = 16;
+
+        // The maximum number of inclusions in a single batched correlation search.
+        constexpr size_t s_BatchedCorrelationMaximumInclusions = 100;
+
+        // A system reference string, folded and normalized in the same way that an exact search for it would be.
+        using CorrelationKey = std::tuple<PackageMatchField, std::string, std::string>;
+
         // Stores data to enable correlation between installed and available packages.
         struct CompositeResult
         {
@@ -385,6 +496,22 @@ namespace AppInstaller::Repository
                     return Field == other.Field && String1 == other.String1 && String2 == other.String2;
                 }
 
+                // Gets the key used to find this string in a correlation index.
+                CorrelationKey GetCorrelationKey(const Utility::NameNormalizer& normalizer) const
+                {
+                    switch (Field)
+                    {
+                    case PackageMatchField::NormalizedNameAndPublisher:
+                    {
+                        Utility::NormalizedName normalized = normalizer.Normalize(Utility::FoldCase(String1.get()), Utility::FoldCase(String2.get()));
+                        return { Field, normalized.Name(), normalized.Publisher() };
+                    }
+
+                    default:
+                        return { Field, Utility::FoldCase(String1.get()), {} };
+                    }
+                }
+
                 void AddToFilters(std::vector<PackageMatchFilter>& filters) const
                 {
                     switch (Field)
@@ -428,6 +555,60 @@ namespace AppInstaller::Repository
                 }
             };
 
+            // Maps the system reference strings of the packages found in a source to those packages.
+            // This allows many installed packages to be correlated against the source with a few batched searches,
+            // rather than a search for each of them.
+            struct CorrelationIndex
+            {
+                void Add(const CorrelationKey& key, const std::shared_ptr<IPackage>& package)
+                {
+                    auto& packages = m_packages[key];
+
+                    if (std::none_of(packages.begin(), packages.end(), [&](const std::shared_ptr<IPackage>& p) { return p->IsSame(package.get()); }))
+                    {
+                        packages.emplace_back(package);
+                    }
+                }
+
+                // Gets the packages that a search for the system reference strings would have matched.
+                std::vector<ResultMatch> Find(const PackageData& data, const Utility::NameNormalizer& normalizer) const
+                {
+                    std::vector<ResultMatch> result;
+
+                    for (const auto& srs : data.SystemReferenceStrings)
+                    {
+                        auto itr = m_packages.find(srs.GetCorrelationKey(normalizer));
+                        if (itr == m_packages.end())
+                        {
+                            continue;
+                        }
+
+                        std::vector<PackageMatchFilter> filters;
+                        srs.AddToFilters(filters);
+
+                        for (const auto& package : itr->second)
+                        {
+                            ResultMatch match{ package, filters[0] };
+
+                            auto existing = std::find_if(result.begin(), result.end(), [&](const ResultMatch& m) { return m.Package->IsSame(package.get()); });
+                            if (existing == result.end())
+                            {
+                                result.emplace_back(std::move(match));
+                            }
+                            else if (ResultMatchComparator{}(match, *existing))
+                            {
+                                existing->MatchCriteria = std::move(match.MatchCriteria);
+                            }
+                        }
+                    }
+
+                    return result;
+                }
+
+            private:
+                std::map<CorrelationKey, std::vector<std::shared_ptr<IPackage>>> m_packages;
+            };
+
             // For a given package version, prepares the results for it.
             PackageData GetSystemReferenceStrings(IPackageVersion* version)
             {
@@ -436,23 +617,76 @@ namespace AppInstaller::Repository
                 return result;
             }
 
+            // Searches the sources for all of the system reference strings at once, in batches, and indexes the packages found.
+            // The result contains an index for each source, in the same order; sources that do not support correlation are not searched.
+            std::vector<CorrelationIndex> CreateCorrelationIndices(const std::vector<Source>& sources, const std::set<SystemReferenceString>& strings, const Utility::NameNormalizer& normalizer)
+            {
+                std::vector<CorrelationIndex> result(sources.size());
+
+                std::vector<PackageMatchFilter> inclusions;
+                for (const auto& srs : strings)
+                {
+                    srs.AddToFilters(inclusions);
+                }
+
+                for (size_t begin = 0; begin < inclusions.size(); begin += s_BatchedCorrelationMaximumInclusions)
+                {
+                    SearchRequest request;
+                    request.Inclusions.assign(inclusions.begin() + begin, inclusions.begin() + std::min(begin + s_BatchedCorrelationMaximumInclusions, inclusions.size()));
+
+                    auto searchResults = SearchSourcesInParallel(sources,
+                        [&](const Source& source)
+                        {
+                            // Do not attempt to correlate local packages against this source
+                            return (source.GetDetails().SupportInstalledSearchCorrelation ? source.Search(request) : SearchResult{});
+                        }, "batched installed package correlation"sv);
+
+                    for (size_t i = 0; i < sources.size(); ++i)
+                    {
+                        SearchResult searchResult = HandleFailures(sources[i], std::move(searchResults[i]));
+
+                        if (searchResult.Truncated)
+                        {
+                            AICLI_LOG(Repo, Warning, << "Batched correlation search of source [" << sources[i].GetIdentifier() << "] was truncated");
+                        }
+
+                        for (const auto& match : searchResult.Matches)
+                        {
+                            std::set<CorrelationKey> keys;
+                            for (auto const& versionKey : match.Package->GetAvailableVersionKeys())
+                            {
+                                auto packageVersion = match.Package->GetAvailableVersion(versionKey);
+                                if (packageVersion)
+                                {
+                                    AddCorrelationKeys(packageVersion.get(), normalizer, keys);
+                                }
+                            }
+
+                            for (const auto& key : keys)
+                            {
+                                result[i].Add(key, match.Package);
+                            }
+                        }
+                    }
+                }
+
+                return result;
+            }
+
             // Check for a package already in the result that should have been correlated already.
             // If we find one, see if we should upgrade it's match criteria.
             // If we don't, return package data for further use.
             std::optional<PackageData> CheckForExistingResultFromAvailablePackageMatch(const ResultMatch& availableMatch)
             {
-                for (auto& match : Matches)
+                CompositeResultMatch* match = FindMatch(m_availablePackages, &CompositePackage::GetAvailablePackage, availableMatch.Package.get());
+                if (match)
                 {
-                    const std::shared_ptr<IPackage>& availablePackage = match.Package->GetAvailablePackage();
-                    if (availablePackage && availablePackage->IsSame(availableMatch.Package.get()))
+                    if (ResultMatchComparator{}(availableMatch, *match))
                     {
-                        if (ResultMatchComparator{}(availableMatch, match))
-                        {
-                            match.MatchCriteria = availableMatch.MatchCriteria;
-                        }
-
-                        return {};
+                        match->MatchCriteria = availableMatch.MatchCriteria;
                     }
+
+                    return {};
                 }
 
                 PackageData result;
@@ -469,18 +703,15 @@ namespace AppInstaller::Repository
             // If we don't, return package data for further use.
             std::optional<PackageData> CheckForExistingResultFromTrackingPackageMatch(const ResultMatch& trackingMatch)
             {
-                for (auto& match : Matches)
+                CompositeResultMatch* match = FindMatch(m_trackingPackages, &CompositePackage::GetTrackingPackage, trackingMatch.Package.get());
+                if (match)
                 {
-                    const std::shared_ptr<IPackage>& trackingPackage = match.Package->GetTrackingPackage();
-                    if (trackingPackage && trackingPackage->IsSame(trackingMatch.Package.get()))
+                    if (ResultMatchComparator{}(trackingMatch, *match))
                     {
-                        if (ResultMatchComparator{}(trackingMatch, match))
-                        {
-                            match.MatchCriteria = trackingMatch.MatchCriteria;
-                        }
-
-                        return {};
+                        match->MatchCriteria = trackingMatch.MatchCriteria;
                     }
+
+                    return {};
                 }
 
                 PackageData result;
@@ -495,16 +726,34 @@ namespace AppInstaller::Repository
             // Determines if the results contain the given installed package.
             bool ContainsInstalledPackage(const IPackage* installedPackage)
             {
-                for (auto& match : Matches)
+                return FindMatch(m_installedPackages, &CompositePackage::GetInstalledPackage, installedPackage) != nullptr;
+            }
+
+            // Determines whether a new match would be removed when the result is limited to the maximum, because at least that many
+            // matches are already ahead of it. The sort is stable and the criteria of a match only ever improve, so this cannot change.
+            bool WouldBeTrimmed(const ResultMatch& match, size_t maximumResults) const
+            {
+                if (maximumResults == 0 || Matches.size() < maximumResults)
                 {
-                    const std::shared_ptr<IPackage>& matchPackage = match.Package->GetInstalledPackage();
-                    if (matchPackage && matchPackage->IsSame(installedPackage))
-                    {
-                        return true;
-                    }
+                    return false;
                 }
 
-                return false;
+                size_t ahead = static_cast<size_t>(std::count_if(Matches.begin(), Matches.end(),
+                    [&](const CompositeResultMatch& existing) { return !ResultMatchComparator{}(match, existing); }));
+
+                return ahead >= maximumResults;
+            }
+
+            // Adds a match to the result, indexing its packages so that later matches can be checked against it without a scan.
+            void AddMatch(std::shared_ptr<CompositePackage> package, PackageMatchFilter criteria)
+            {
+                size_t index = Matches.size();
+                Matches.emplace_back(std::move(package), std::move(criteria));
+
+                CompositePackage& added = *Matches.back().Package;
+                AddToPackageIndex(m_installedPackages, added.GetInstalledPackage(), index);
+                AddToPackageIndex(m_availablePackages, added.GetAvailablePackage(), index);
+                AddToPackageIndex(m_trackingPackages, added.GetTrackingPackage(), index);
             }
 
             // Destructively converts the result to the standard variant.
@@ -542,12 +791,29 @@ namespace AppInstaller::Repository
             }
 
             SearchResult SearchAndHandleFailures(const Source& source, const SearchRequest& request)
+            {
+                SourceSearchResult searchResult;
+
+                try
+                {
+                    searchResult.Result = source.Search(request);
+                }
+                catch (...)
+                {
+                    searchResult.Exception = std::current_exception();
+                }
+
+                return HandleFailures(source, std::move(searchResult));
+            }
+
+            // Same as SearchAndHandleFailures, for a search that has already been performed.
+            SearchResult HandleFailures(const Source& source, SourceSearchResult&& searchResult)
             {
                 SearchResult result;
 
                 try
                 {
-                    result = source.Search(request);
+                    result = std::move(searchResult.Get());
                 }
                 catch (...)
                 {
@@ -567,11 +833,53 @@ namespace AppInstaller::Repository
                 return result;
             }
 
+            // Add to this with AddMatch, and only reorder it once no more matches will be checked against it.
             std::vector<CompositeResultMatch> Matches;
             bool Truncated = false;
             std::vector<SearchResult::Failure> Failures;
 
         private:
+            // Maps the folded package identifier to the positions in Matches of the packages with it.
+            // Packages that are the same have the same identifier, so only those with it need to be compared.
+            using PackageIndex = std::unordered_multimap<std::string, size_t>;
+
+            static void AddToPackageIndex(PackageIndex& index, const std::shared_ptr<IPackage>& package, size_t position)
+            {
+                if (package)
+                {
+                    index.emplace(Utility::FoldCase(package->GetProperty(PackageProperty::Id).get()), position);
+                }
+            }
+
+            CompositeResultMatch* FindMatch(const PackageIndex& index, const std::shared_ptr<IPackage>& (CompositePackage::*getPackage)(), const IPackage* package)
+            {
+                auto [begin, end] = index.equal_range(Utility::FoldCase(package->GetProperty(PackageProperty::Id).get()));
+
+                // Check in the order the matches were added, as the scan of every match did.
+                std::vector<size_t> positions;
+                for (auto itr = begin; itr != end; ++itr)
+                {
+                    positions.emplace_back(itr->second);
+                }
+                std::sort(positions.begin(), positions.end());
+
+                for (size_t position : positions)
+                {
+                    CompositeResultMatch& match = Matches[position];
+                    const std::shared_ptr<IPackage>& matchPackage = ((*match.Package).*getPackage)();
+                    if (matchPackage && matchPackage->IsSame(package))
+                    {
+                        return &match;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            PackageIndex m_installedPackages;
+            PackageIndex m_availablePackages;
+            PackageIndex m_trackingPackages;
+
             void AddSystemReferenceStrings(IPackageVersion* version, PackageData& data)
             {
                 GetSystemReferenceStrings(
@@ -603,6 +911,38 @@ namespace AppInstaller::Repository
                 }
             }
 
+            // Adds the keys of an available package version, for matching against those of installed packages.
+            void AddCorrelationKeys(IPackageVersion* version, const Utility::NameNormalizer& normalizer, std::set<CorrelationKey>& keys)
+            {
+                for (auto&& string : version->GetMultiProperty(PackageVersionMultiProperty::PackageFamilyName))
+                {
+                    keys.emplace(PackageMatchField::PackageFamilyName, Utility::FoldCase(string.get()), std::string{});
+                }
+
+                for (auto&& string : version->GetMultiProperty(PackageVersionMultiProperty::ProductCode))
+                {
+                    keys.emplace(PackageMatchField::ProductCode, Utility::FoldCase(string.get()), std::string{});
+                }
+
+                // Any name can match with any publisher, as the search does.
+                // Some sources return the values already normalized, so both forms are added.
+                auto names = version->GetMultiProperty(PackageVersionMultiProperty::Name);
+                auto publishers = version->GetMultiProperty(PackageVersionMultiProperty::Publisher);
+
+                for (const auto& name : names)
+                {
+                    for (const auto& publisher : publishers)
+                    {
+                        std::string foldedName = Utility::FoldCase(name.get());
+                        std::string foldedPublisher = Utility::FoldCase(publisher.get());
+
+                        Utility::NormalizedName normalized = normalizer.Normalize(foldedName, foldedPublisher);
+                        keys.emplace(PackageMatchField::NormalizedNameAndPublisher, normalized.Name(), normalized.Publisher());
+                        keys.emplace(PackageMatchField::NormalizedNameAndPublisher, std::move(foldedName), std::move(foldedPublisher));
+                    }
+                }
+            }
+
             void GetNameAndPublisher(
                 IPackageVersion* installedVersion,
                 PackageData& data)
@@ -717,6 +1057,9 @@ namespace AppInstaller::Repository
     {
         CompositeResult result;
 
+        // All of the composite packages for this search share an arena.
+        auto arena = std::make_shared<SearchArena>();
+
         // If the search behavior is for AllPackages or Installed then the result can contain packages that are
         // only in the Installed source, but do not have an AvailableVersion.
         if (m_searchBehavior == CompositeSearchBehavior::AllPackages || m_searchBehavior == CompositeSearchBehavior::Installed)
@@ -725,6 +1068,30 @@ namespace AppInstaller::Repository
             SearchResult installedResult = m_installedSource.Search(request);
             result.Truncated = installedResult.Truncated;
 
+            // When there are many installed packages, search the available sources for all of their system reference strings
+            // in a few large requests up front, rather than making a request per installed package.
+            std::optional<Utility::NameNormalizer> correlationNormalizer;
+            std::vector<CompositeResult::CorrelationIndex> correlationIndices;
+
+            if (installedResult.Matches.size() >= s_BatchedCorrelationMinimumPackages)
+            {
+                std::set<CompositeResult::SystemReferenceString> installedStrings;
+                for (const auto& match : installedResult.Matches)
+                {
+                    auto installedVersion = (match.Package ? match.Package->GetInstalledVersion() : nullptr);
+                    if (installedVersion)
+                    {
+                        auto installedPackageData = result.GetSystemReferenceStrings(installedVersion.get());
+                        installedStrings.insert(installedPackageData.SystemReferenceStrings.begin(), installedPackageData.SystemReferenceStrings.end());
+                    }
+                }
+
+                AICLI_LOG(Repo, Verbose, << "Correlating " << installedResult.Matches.size() << " installed packages with batched searches for " << installedStrings.size() << " system reference strings");
+
+                correlationNormalizer.emplace(Utility::NormalizationVersion::Initial);
+                correlationIndices = result.CreateCorrelationIndices(m_availableSources, installedStrings, correlationNormalizer.value());
+            }
+
             for (auto&& match : installedResult.Matches)
             {
                 if (!match.Package)
@@ -736,7 +1103,7 @@ namespace AppInstaller::Repository
                     continue;
                 }
 
-                auto compositePackage = std::make_shared<CompositePackage>(match.Package);
+                auto compositePackage = AllocateInArena<CompositePackage>(arena, match.Package);
 
                 auto installedVersion = compositePackage->GetInstalledVersion();
 
@@ -765,10 +1132,13 @@ namespace AppInstaller::Repository
                     // Check the tracking catalog first to see if there is a correlation there.
                     // TODO: When the issue with support for multiple available packages is fixed, this should move into
                     //       the below available sources loop as we will check all sources at that point.
-                    for (const auto& source : m_availableSources)
+                    auto trackingResults = SearchSourcesInParallel(m_availableSources,
+                        [&](const Source& source) { return source.GetTrackingCatalog().Search(systemReferenceSearch); }, "installed package tracking"sv);
+
+                    for (size_t i = 0; i < m_availableSources.size(); ++i)
                     {
-                        auto trackingCatalog = source.GetTrackingCatalog();
-                        SearchResult trackingResult = trackingCatalog.Search(systemReferenceSearch);
+                        const auto& source = m_availableSources[i];
+                        SearchResult trackingResult = std::move(trackingResults[i].Get());
 
                         std::shared_ptr<IPackage> candidatePackage = GetMatchingPackage(trackingResult.Matches,
                             [&]() {
@@ -799,32 +1169,74 @@ namespace AppInstaller::Repository
                         availablePackage = GetTrackedPackageFromAvailableSource(result, trackedSource, trackingPackage->GetProperty(PackageProperty::Id));
                     }
 
-                    if (!availablePackage)
+                    auto getMatchingAvailablePackage = [&](const Source& source, std::vector<ResultMatch>& matches)
                     {
+                        return GetMatchingPackage(matches,
+                            [&]() {
+                                AICLI_LOG(Repo, Info,
+                                    << "Found multiple matches for installed package [" << installedVersion->GetProperty(PackageVersionProperty::Id) <<
+                                    "] in source [" << source.GetIdentifier() << "] when searching for [" << systemReferenceSearch.ToString() << "]");
+                            }, [&] {
+                                AICLI_LOG(Repo, Warning, << "  Appropriate available package could not be determined");
+                            });
+                    };
+
+                    if (!availablePackage && !correlationIndices.empty())
+                    {
+                        // Use the packages found by the batched searches, in source order.
+                        for (size_t i = 0; i < m_availableSources.size(); ++i)
+                        {
+                            const auto& source = m_availableSources[i];
+
+                            // Do not attempt to correlate local packages against this source
+                            if (!source.GetDetails().SupportInstalledSearchCorrelation)
+                            {
+                                continue;
+                            }
+
+                            std::vector<ResultMatch> availableMatches = correlationIndices[i].Find(installedPackageData, correlationNormalizer.value());
+
+                            if (availableMatches.empty())
+                            {
+                                continue;
+                            }
+
+                            availablePackage = getMatchingAvailablePackage(source, availableMatches);
+
+                            // We found some matching packages here, don't keep going
+                            break;
+                        }
+                    }
+                    else if (!availablePackage)
+                    {
+                        // Search all of the sources at once, but consume the results in order so that the first source
+                        // with a match is used and failures are only recorded for the sources that would have been searched.
+                        auto availableResults = SearchSourcesInParallel(m_availableSources,
+                            [&](const Source& source)
+                            {
+                                // Do not attempt to correlate local packages against this source
+                                return (source.GetDetails().SupportInstalledSearchCorrelation ? source.Search(systemReferenceSearch) : SearchResult{});
+                            }, "installed package correlation"sv);
+
                         // Search sources and add to result
-                        for (const auto& source : m_availableSources)
+                        for (size_t i = 0; i < m_availableSources.size(); ++i)
                         {
+                            const auto& source = m_availableSources[i];
+
                             // Do not attempt to correlate local packages against this source
                             if (!source.GetDetails().SupportInstalledSearchCorrelation)
                             {
                                 continue;
                             }
 
-                            SearchResult availableResult = result.SearchAndHandleFailures(source, systemReferenceSearch);
+                            SearchResult availableResult = result.HandleFailures(source, std::move(availableResults[i]));
 
                             if (availableResult.Matches.empty())
                             {
                                 continue;
                             }
 
-                            availablePackage = GetMatchingPackage(availableResult.Matches,
-                                [&]() {
-                                    AICLI_LOG(Repo, Info,
-                                        << "Found multiple matches for installed package [" << installedVersion->GetProperty(PackageVersionProperty::Id) <<
-                                        "] in source [" << source.GetIdentifier() << "] when searching for [" << systemReferenceSearch.ToString() << "]");
-                                }, [&] {
-                                    AICLI_LOG(Repo, Warning, << "  Appropriate available package could not be determined");
-                                });
+                            availablePackage = getMatchingAvailablePackage(source, availableResult.Matches);
 
                             // We found some matching packages here, don't keep going
                             break;
@@ -836,7 +1248,7 @@ namespace AppInstaller::Repository
                 }
 
                 // Move the installed result into the composite result
-                result.Matches.emplace_back(std::move(compositePackage), std::move(match.MatchCriteria));
+                result.AddMatch(std::move(compositePackage), std::move(match.MatchCriteria));
             }
 
             // Optimization for the "everything installed" case, no need to allow for reverse correlations
@@ -846,12 +1258,25 @@ namespace AppInstaller::Repository
             }
         }
 
+        // Perform the initial searches of every available source at once; the correlation of the results is done in source order.
+        auto trackingResults = SearchSourcesInParallel(m_availableSources,
+            [&](const Source& source) { return source.GetTrackingCatalog().Search(request); }, "tracking"sv);
+
+        auto availableResults = SearchSourcesInParallel(m_availableSources,
+            [&](const Source& source)
+            {
+                // Do not attempt to correlate local packages against this source.
+                bool skip = (m_searchBehavior == CompositeSearchBehavior::Installed && !source.GetDetails().SupportInstalledSearchCorrelation);
+                return (skip ? SearchResult{} : source.Search(request));
+            }, "available"sv);
+
         // Search available sources
-        for (const auto& source : m_availableSources)
+        for (size_t i = 0; i < m_availableSources.size(); ++i)
         {
+            const auto& source = m_availableSources[i];
+
             // Search the tracking catalog as it can potentially get better correlations
-            auto trackingCatalog = source.GetTrackingCatalog();
-            SearchResult trackingResult = trackingCatalog.Search(request);
+            SearchResult trackingResult = std::move(trackingResults[i].Get());
 
             for (auto&& match : trackingResult.Matches)
             {
@@ -864,6 +1289,13 @@ namespace AppInstaller::Repository
                     continue;
                 }
 
+                // Skip the correlation of a match that would not make it into the limited result.
+                if (result.WouldBeTrimmed(match, request.MaximumResults))
+                {
+                    result.Truncated = true;
+                    continue;
+                }
+
                 // If no package was found that was already in the results, do a correlation lookup with the installed
                 // source to create a new composite package entry if we find any packages there.
                 if (packageData && !packageData->SystemReferenceStrings.empty())
@@ -885,13 +1317,13 @@ namespace AppInstaller::Repository
 
                     if (installedPackage && !result.ContainsInstalledPackage(installedPackage.get()))
                     {
-                        auto compositePackage = std::make_shared<CompositePackage>(
+                        auto compositePackage = AllocateInArena<CompositePackage>(arena,
                             std::move(installedPackage),
                             GetTrackedPackageFromAvailableSource(result, source, match.Package->GetProperty(PackageProperty::Id)));
 
                         compositePackage->SetTracking(source, std::move(match.Package));
 
-                        result.Matches.emplace_back(std::move(compositePackage), match.MatchCriteria);
+                        result.AddMatch(std::move(compositePackage), match.MatchCriteria);
                     }
                 }
             }
@@ -902,7 +1334,7 @@ namespace AppInstaller::Repository
                 continue;
             }
 
-            SearchResult availableResult = result.SearchAndHandleFailures(source, request);
+            SearchResult availableResult = result.HandleFailures(source, std::move(availableResults[i]));
 
             for (auto&& match : availableResult.Matches)
             {
@@ -915,6 +1347,13 @@ namespace AppInstaller::Repository
                     continue;
                 }
 
+                // Skip the correlation of a match that would not make it into the limited result.
+                if (result.WouldBeTrimmed(match, request.MaximumResults))
+                {
+                    result.Truncated = true;
+                    continue;
+                }
+
                 // If no package was found that was already in the results, do a correlation lookup with the installed
                 // source to create a new composite package entry if we find any packages there.
                 bool foundInstalledMatch = false;
@@ -939,14 +1378,14 @@ namespace AppInstaller::Repository
                     {
                         // TODO: Needs a whole separate change to fix the fact that we don't support multiple available packages and what the different search behaviors mean
                         foundInstalledMatch = true;
-                        result.Matches.emplace_back(std::make_shared<CompositePackage>(std::move(installedPackage), std::move(match.Package)), match.MatchCriteria);
+                        result.AddMatch(AllocateInArena<CompositePackage>(arena, std::move(installedPackage), std::move(match.Package)), match.MatchCriteria);
                     }
                 }
 
                 // If there was no correlation for this package, add it without one.
                 if ((m_searchBehavior == CompositeSearchBehavior::AllPackages || m_searchBehavior == CompositeSearchBehavior::AvailablePackages) && !foundInstalledMatch)
                 {
-                    result.Matches.emplace_back(std::make_shared<CompositePackage>(std::shared_ptr<IPackage>{}, std::move(match.Package)), match.MatchCriteria);
+                    result.AddMatch(AllocateInArena<CompositePackage>(arena, std::shared_ptr<IPackage>{}, std::move(match.Package)), match.MatchCriteria);
                 }
             }
         }
@@ -967,14 +1406,17 @@ namespace AppInstaller::Repository
     {
         SearchResult result;
 
-        // Search available sources
-        for (const auto& source : m_availableSources)
+        auto sourceResults = SearchSourcesInParallel(m_availableSources, [&](const Source& source) { return source.Search(request); }, "available"sv);
+
+        // Merge the results in source order so that the final order does not depend on which source responded first
+        for (size_t i = 0; i < m_availableSources.size(); ++i)
         {
+            const auto& source = m_availableSources[i];
             SearchResult oneSourceResult;
 
             try
             {
-                oneSourceResult = source.Search(request);
+                oneSourceResult = std::move(sourceResults[i].Get());
             }
             catch (...)
             {
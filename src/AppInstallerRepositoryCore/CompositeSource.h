@@ -41,6 +41,9 @@ namespace AppInstaller::Repository
         // Checks if any available sources are present
         bool HasAvailableSource() const { return !m_availableSources.empty(); }
 
+        // Gets the installed source; empty if none has been set.
+        Source GetInstalledSource() const { return m_installedSource; }
+
         // Sets the installed source to be composited.
         void SetInstalledSource(Source source, CompositeSearchBehavior searchBehavior = CompositeSearchBehavior::Installed);
 
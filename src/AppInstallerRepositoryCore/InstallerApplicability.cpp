@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/InstallerApplicability.h"
+
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        constexpr char s_InstallerSeparator = ';';
+        constexpr char s_FieldSeparator = '|';
+        constexpr char s_ValueSeparator = ' ';
+        constexpr size_t s_FieldCount = 5;
+
+        std::vector<std::string_view> Split(std::string_view value, char separator)
+        {
+            std::vector<std::string_view> result;
+
+            size_t start = 0;
+            for (size_t pos = value.find(separator); pos != std::string_view::npos; pos = value.find(separator, start))
+            {
+                result.emplace_back(value.substr(start, pos - start));
+                start = pos + 1;
+            }
+
+            result.emplace_back(value.substr(start));
+            return result;
+        }
+    }
+
+    std::string InstallerApplicability::Create(const Manifest::Manifest& manifest)
+    {
+        std::string result;
+
+        for (const auto& installer : manifest.Installers)
+        {
+            if (!result.empty())
+            {
+                result += s_InstallerSeparator;
+            }
+
+            result += Utility::ToString(installer.Arch);
+            result += s_FieldSeparator;
+            result += Manifest::ScopeToString(installer.Scope);
+            result += s_FieldSeparator;
+            result += Manifest::InstallerTypeToString(installer.InstallerType);
+            for (const auto& entry : installer.AppsAndFeaturesEntries)
+            {
+                result += s_ValueSeparator;
+                result += Manifest::InstallerTypeToString(entry.InstallerType);
+            }
+            result += s_FieldSeparator;
+            result += installer.MinOSVersion;
+            result += s_FieldSeparator;
+
+            bool first = true;
+            for (auto architecture : installer.UnsupportedOSArchitectures)
+            {
+                if (!first)
+                {
+                    result += s_ValueSeparator;
+                }
+
+                result += Utility::ToString(architecture);
+                first = false;
+            }
+        }
+
+        return result;
+    }
+
+    std::optional<std::vector<Manifest::ManifestInstaller>> InstallerApplicability::Parse(std::string_view summary)
+    {
+        std::vector<Manifest::ManifestInstaller> result;
+
+        if (summary.empty())
+        {
+            return result;
+        }
+
+        for (std::string_view installerSummary : Split(summary, s_InstallerSeparator))
+        {
+            auto fields = Split(installerSummary, s_FieldSeparator);
+            if (fields.size() != s_FieldCount)
+            {
+                return {};
+            }
+
+            Manifest::ManifestInstaller& installer = result.emplace_back();
+            installer.Arch = Utility::ConvertToArchitectureEnum(std::string{ fields[0] });
+            installer.Scope = Manifest::ConvertToScopeEnum(fields[1]);
+
+            auto types = Split(fields[2], s_ValueSeparator);
+            installer.InstallerType = Manifest::ConvertToInstallerTypeEnum(std::string{ types[0] });
+            for (size_t i = 1; i < types.size(); ++i)
+            {
+                installer.AppsAndFeaturesEntries.emplace_back().InstallerType = Manifest::ConvertToInstallerTypeEnum(std::string{ types[i] });
+            }
+
+            installer.MinOSVersion = fields[3];
+
+            if (!fields[4].empty())
+            {
+                for (std::string_view architecture : Split(fields[4], s_ValueSeparator))
+                {
+                    installer.UnsupportedOSArchitectures.emplace_back(Utility::ConvertToArchitectureEnum(std::string{ architecture }));
+                }
+            }
+        }
+
+        return result;
+    }
+}
@@ -2,9 +2,116 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "ARPHelper.h"
+#include <winget/ThreadGlobals.h>
+
+#include <future>
 
 namespace AppInstaller::Repository::Microsoft
 {
+    InstalledIndexEntries::InstalledIndexEntries(const SQLiteIndex& index)
+    {
+        for (const auto& match : index.Search({}).Matches)
+        {
+            for (const auto& versionKey : index.GetVersionKeysById(match.first))
+            {
+                auto manifestId = index.GetManifestIdByKey(match.first, versionKey.GetVersion().ToString(), versionKey.GetChannel().ToString());
+                if (!manifestId)
+                {
+                    continue;
+                }
+
+                auto path = index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::RelativePath);
+                if (!path)
+                {
+                    continue;
+                }
+
+                Entry entry;
+                entry.ManifestId = manifestId.value();
+
+                for (auto& metadata : index.GetMetadataByManifestId(entry.ManifestId))
+                {
+                    if (metadata.first == PackageVersionMetadata::InstalledCacheStamp)
+                    {
+                        entry.Stamp = std::move(metadata.second);
+                    }
+                }
+
+                m_entries.emplace(std::move(path).value(), std::move(entry));
+            }
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Found " << m_entries.size() << " existing installed index entries");
+    }
+
+    bool InstalledIndexEntries::KeepIfUnchanged(SQLiteIndex& index, const std::string& key, const std::string& stamp)
+    {
+        auto itr = m_entries.find(key);
+        if (itr == m_entries.end())
+        {
+            return false;
+        }
+
+        Entry& entry = itr->second;
+
+        // Either unchanged, or a duplicate of an entry that was already found during this pass.
+        if (entry.Seen || entry.Stamp == stamp)
+        {
+            entry.Seen = true;
+            return true;
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Installed index entry has changed: " << key);
+        index.RemoveManifestById(entry.ManifestId);
+        m_entries.erase(itr);
+        m_hasChanges = true;
+        return false;
+    }
+
+    bool InstalledIndexEntries::IsUnchanged(const std::string& key, const std::string& stamp) const
+    {
+        auto itr = m_entries.find(key);
+        return (itr != m_entries.end() && itr->second.Stamp == stamp);
+    }
+
+    void InstalledIndexEntries::Added(SQLiteIndex& index, SQLiteIndex::IdType manifestId, const std::string& key, const std::string& stamp)
+    {
+        index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledCacheStamp, stamp);
+
+        Entry& entry = m_entries[key];
+        entry.ManifestId = manifestId;
+        entry.Stamp = stamp;
+        entry.Seen = true;
+        m_hasChanges = true;
+    }
+
+    void InstalledIndexEntries::RemoveUnseen(SQLiteIndex& index)
+    {
+        RemoveUnseen(index, [](const std::string&, const std::string&) { return true; });
+    }
+
+    void InstalledIndexEntries::RemoveUnseen(SQLiteIndex& index, const std::function<bool(const std::string& key, const std::string& stamp)>& predicate)
+    {
+        SQLite::Savepoint savepoint = index.CreateSavepoint("installedindexentries_removeunseen");
+
+        for (auto itr = m_entries.begin(); itr != m_entries.end();)
+        {
+            if (itr->second.Seen || !predicate(itr->first, itr->second.Stamp))
+            {
+                ++itr;
+            }
+            else
+            {
+                AICLI_LOG(Repo, Verbose, << "Installed index entry is no longer present: " << itr->first);
+                index.RemoveManifestById(itr->second.ManifestId);
+                itr = m_entries.erase(itr);
+                m_hasChanges = true;
+            }
+        }
+
+        savepoint.Commit();
+    }
+
     Registry::Key ARPHelper::GetARPKey(Manifest::ScopeEnum scope, Utility::Architecture architecture) const
     {
         HKEY rootKey = NULL;
@@ -91,16 +198,16 @@ namespace AppInstaller::Repository::Microsoft
         }
     }
 
-    bool ARPHelper::GetBoolValue(const Registry::Key& arpKey, const std::wstring& name)
+    bool ARPHelper::GetBoolValue(const Registry::ValueMap& arpValues, const std::wstring& name)
     {
-        auto value = arpKey[name];
+        auto value = arpValues[name];
         return (value && value->GetType() == Registry::Value::Type::DWord && value->GetValue<Registry::Value::Type::DWord>());
     }
 
-    std::string ARPHelper::DetermineVersion(const Registry::Key& arpKey) const
+    std::string ARPHelper::DetermineVersion(const Registry::ValueMap& arpValues) const
     {
         // First check DisplayVersion for a complete version string
-        auto displayVersion = arpKey[DisplayVersion];
+        auto displayVersion = arpValues[DisplayVersion];
         if (displayVersion && displayVersion->GetType() == Registry::Value::Type::String)
         {
             std::string result = displayVersion->GetValue<Registry::Value::Type::String>();
@@ -113,8 +220,8 @@ namespace AppInstaller::Repository::Microsoft
         // Next attempt VersionMajor.VersionMinor, then MajorVersion.MinorVersion
         for (const auto& names : { std::make_pair(std::ref(VersionMajor), std::ref(VersionMinor)), std::make_pair(std::ref(MajorVersion), std::ref(MinorVersion)) })
         {
-            auto majorVersion = arpKey[names.first];
-            auto minorVersion = arpKey[names.second];
+            auto majorVersion = arpValues[names.first];
+            auto minorVersion = arpValues[names.second];
             if (majorVersion || minorVersion)
             {
                 uint32_t majorVersionInt = 0;
@@ -140,7 +247,7 @@ namespace AppInstaller::Repository::Microsoft
         }
 
         // Finally attempt to turn the Version DWORD into a version string
-        auto version = arpKey[Version];
+        auto version = arpValues[Version];
         if (version && version->GetType() == Registry::Value::Type::DWord)
         {
             uint32_t versionInt = version->GetValue<Registry::Value::Type::DWord>();
@@ -155,9 +262,9 @@ namespace AppInstaller::Repository::Microsoft
         return Utility::Version::CreateUnknown().ToString();
     }
 
-    void ARPHelper::AddMetadataIfPresent(const Registry::Key& key, const std::wstring& name, SQLiteIndex& index, SQLiteIndex::IdType manifestId, PackageVersionMetadata metadata) const
+    void ARPHelper::AddMetadataIfPresent(const Registry::ValueMap& values, const std::wstring& name, ARPEntryData& entry, PackageVersionMetadata metadata) const
     {
-        auto value = key[name];
+        auto value = values[name];
         if (value)
         {
             std::string valueString;
@@ -187,28 +294,130 @@ namespace AppInstaller::Repository::Microsoft
 
             if (!valueString.empty())
             {
-                index.SetMetadataByManifestId(manifestId, metadata, valueString);
+                entry.Metadata.emplace_back(metadata, std::move(valueString));
             }
         }
     }
 
-    void ARPHelper::PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope) const
+    void ARPHelper::PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope, InstalledIndexEntries* entries) const
     {
-        for (auto architecture : Utility::GetApplicableArchitectures())
+        PopulateIndexFromARP(index, std::vector<Manifest::ScopeEnum>{ scope }, entries);
+    }
+
+    void ARPHelper::PopulateIndexFromARP(SQLiteIndex& index, const std::vector<Manifest::ScopeEnum>& scopes, InstalledIndexEntries* entries) const
+    {
+        struct Location
         {
-            Registry::Key arpRootKey = GetARPKey(scope, architecture);
+            Registry::Key Key;
+            std::string_view Scope;
+            std::string_view Architecture;
+        };
 
-            if (arpRootKey)
+        std::vector<Location> locations;
+        for (auto scope : scopes)
+        {
+            for (auto architecture : Utility::GetApplicableArchitectures())
+            {
+                Registry::Key arpRootKey = GetARPKey(scope, architecture);
+
+                if (arpRootKey)
+                {
+                    locations.emplace_back(Location{ std::move(arpRootKey), Manifest::ScopeToString(scope), Utility::ToString(architecture) });
+                }
+            }
+        }
+
+        if (locations.empty())
+        {
+            return;
+        }
+
+        // Reading the registry values is the bulk of the work, and each location is independent, so they are read in parallel.
+        std::vector<std::vector<ARPEntryData>> readEntries(locations.size());
+        std::vector<std::exception_ptr> failures(locations.size());
+
+        auto readOne = [&](size_t i)
+        {
+            try
+            {
+                readEntries[i] = ReadEntriesFromKey(locations[i].Key, locations[i].Scope, locations[i].Architecture, entries);
+            }
+            catch (...)
+            {
+                failures[i] = std::current_exception();
+            }
+        };
+
+        // Logging is done through the thread globals, so the workers must share those of the calling thread.
+        ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+
+        std::vector<std::future<void>> workers;
+        workers.reserve(locations.size() - 1);
+
+        for (size_t i = 1; i < locations.size(); ++i)
+        {
+            // Created here rather than on the worker, as creating them touches the parent.
+            std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+            if (parentThreadGlobals)
             {
-                PopulateIndexFromKey(index, arpRootKey, Manifest::ScopeToString(scope), Utility::ToString(architecture));
+                threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
             }
+
+            workers.emplace_back(std::async(std::launch::async, [&readOne, threadGlobals, i]()
+                {
+                    std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                    if (threadGlobals)
+                    {
+                        previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    }
+
+                    readOne(i);
+                }));
         }
+
+        // Use the calling thread for the first location rather than leaving it idle.
+        readOne(0);
+
+        for (auto& worker : workers)
+        {
+            worker.get();
+        }
+
+        // Report the first failure in location order so that the result does not depend on thread scheduling.
+        for (const auto& failure : failures)
+        {
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        // The entries are added in location order, as the first of any duplicates is the one that is kept.
+        SQLite::Savepoint savepoint = index.CreateSavepoint("arphelper_populateindexfromarp");
+
+        for (size_t i = 0; i < locations.size(); ++i)
+        {
+            AddEntriesToIndex(index, readEntries[i], locations[i].Scope, locations[i].Architecture, entries);
+        }
+
+        savepoint.Commit();
+    }
+
+    void ARPHelper::PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture, InstalledIndexEntries* entries) const
+    {
+        std::vector<ARPEntryData> readEntries = ReadEntriesFromKey(key, scope, architecture, entries);
+
+        SQLite::Savepoint savepoint = index.CreateSavepoint("arphelper_populateindexfromkey");
+        AddEntriesToIndex(index, readEntries, scope, architecture, entries);
+        savepoint.Commit();
     }
 
-    void ARPHelper::PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const
+    std::vector<ARPEntryData> ARPHelper::ReadEntriesFromKey(const Registry::Key& key, std::string_view scope, std::string_view architecture, const InstalledIndexEntries* entries) const
     {
         AICLI_LOG(Repo, Info, << "Examining ARP entries for " << scope << " | " << architecture);
 
+        std::vector<ARPEntryData> result;
+
         for (const auto& arpEntry : key)
         {
             std::string productCode;
@@ -217,7 +426,27 @@ namespace AppInstaller::Repository::Microsoft
             {
                 productCode = arpEntry.Name();
 
-                Manifest::Manifest manifest;
+                ARPEntryData entry;
+                entry.ProductCode = productCode;
+
+                // Any write to the entry updates the last write time of its key, so there is no need to read (or even open) an entry that is unchanged.
+                if (entries)
+                {
+                    std::ostringstream stampStream;
+                    stampStream << scope << '|' << architecture << '|' << arpEntry.GetLastWriteTime().time_since_epoch().count();
+                    entry.Stamp = stampStream.str();
+
+                    if (entries->IsUnchanged(productCode, entry.Stamp))
+                    {
+                        result.emplace_back(std::move(entry));
+                        continue;
+                    }
+                }
+
+                // Read every value of the entry at once, as most of them are looked at.
+                Registry::ValueMap arpValues = arpEntry.Open().ReadAllValues();
+
+                Manifest::Manifest& manifest = entry.PackageManifest;
                 manifest.DefaultLocalization.Add<Manifest::Localization::Tags>({ "ARP" });
 
                 // Use the key name as the Id, as it is supposed to be unique.
@@ -234,17 +463,15 @@ namespace AppInstaller::Repository::Microsoft
                 //       if it is present.
                 manifest.Installers[0].ProductCode = productCode;
 
-                Registry::Key arpKey = arpEntry.Open();
-
                 // Ignore entries that are listed as SystemComponent
-                if (GetBoolValue(arpKey, SystemComponent))
+                if (GetBoolValue(arpValues, SystemComponent))
                 {
                     AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because it is a SystemComponent");
                     continue;
                 }
 
                 // If no name is provided, ignore this entry
-                auto displayName = arpKey[DisplayName];
+                auto displayName = arpValues[DisplayName];
                 if (!displayName || displayName->GetType() != Registry::Value::Type::String)
                 {
                     AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because DisplayName is not a REG_SZ value");
@@ -259,14 +486,14 @@ namespace AppInstaller::Repository::Microsoft
                 }
 
                 // If no version can be determined, ignore this entry
-                manifest.Version = DetermineVersion(arpKey);
+                manifest.Version = DetermineVersion(arpValues);
                 if (manifest.Version.empty())
                 {
                     AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because a version could not be determined");
                     continue;
                 }
 
-                auto publisher = arpKey[Publisher];
+                auto publisher = arpValues[Publisher];
                 if (publisher && publisher->GetType() == Registry::Value::Type::String)
                 {
                     manifest.DefaultLocalization.Add<Manifest::Localization::Publisher>(publisher->GetValue<Registry::Value::Type::String>());
@@ -283,32 +510,8 @@ namespace AppInstaller::Repository::Microsoft
                 // TODO: If we want to keep the constructed manifest around to allow for `show` type commands
                 //       against installed packages, we should use URLInfoAbout/HelpLink for the Homepage.
 
-                // TODO: Determine the best way to handle duplicates; sometimes the same package will be listed under
-                //       both x64 and x86 locations for ARP.
-                //       For now, we will attempt to insert and catch.
-                std::optional<SQLiteIndex::IdType> manifestIdOpt;
-
-                try
-                {
-                    // Use the ProductCode as a unique key for the path
-                    manifestIdOpt = index.AddManifest(manifest, Utility::ConvertToUTF16(manifest.Installers[0].ProductCode));
-                }
-                catch (...)
-                {
-                    // Ignore errors if they occur, they are most likely a duplicate value
-                }
-
-                if (!manifestIdOpt)
-                {
-                    AICLI_LOG(Repo, Warning,
-                        << "Ignoring duplicate ARP entry " << scope << '|' << architecture << '|' << productCode << " [" << manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>() << "]");
-                    continue;
-                }
-
-                SQLiteIndex::IdType manifestId = manifestIdOpt.value();
-
                 // Pass scope along to metadata.
-                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledScope, scope);
+                entry.Metadata.emplace_back(PackageVersionMetadata::InstalledScope, std::string{ scope });
 
                 // TODO: Pass along architecture, although there are cases where it is not clear what architecture the package
                 //       is from it's ARP location, despite it very clearly being a specific architecture. And note that user
@@ -317,32 +520,33 @@ namespace AppInstaller::Repository::Microsoft
                 // Publisher is needed for certain scenarios but we don't store it from the manifest
                 if (manifest.DefaultLocalization.Contains(Manifest::Localization::Publisher))
                 {
-                    index.SetMetadataByManifestId(
-                        manifestId, PackageVersionMetadata::Publisher,
-                        manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
+                    entry.Metadata.emplace_back(PackageVersionMetadata::Publisher, manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
                 }
 
                 // Pick up InstallLocation when upgrade supports remove/install to enable this location
                 // to survive across the removal.
-                AddMetadataIfPresent(arpKey, InstallLocation, index, manifestId, PackageVersionMetadata::InstalledLocation);
+                AddMetadataIfPresent(arpValues, InstallLocation, entry, PackageVersionMetadata::InstalledLocation);
 
                 // Pick up UninstallString and QuietUninstallString for uninstall.
-                AddMetadataIfPresent(arpKey, UninstallString, index, manifestId, PackageVersionMetadata::StandardUninstallCommand);
-                AddMetadataIfPresent(arpKey, QuietUninstallString, index, manifestId, PackageVersionMetadata::SilentUninstallCommand);
+                AddMetadataIfPresent(arpValues, UninstallString, entry, PackageVersionMetadata::StandardUninstallCommand);
+                AddMetadataIfPresent(arpValues, QuietUninstallString, entry, PackageVersionMetadata::SilentUninstallCommand);
 
                 // Pick up Language to enable proper selection of language for upgrade.
-                AddMetadataIfPresent(arpKey, Language, index, manifestId, PackageVersionMetadata::InstalledLocale);
+                AddMetadataIfPresent(arpValues, Language, entry, PackageVersionMetadata::InstalledLocale);
 
                 // Pick up WindowsInstaller to determine if this is an MSI install.
                 // TODO: Could also determine Inno (and maybe other types) through detecting other keys here.
                 auto installedType = Manifest::InstallerTypeEnum::Exe;
 
-                if (GetBoolValue(arpKey, WindowsInstaller))
+                if (GetBoolValue(arpValues, WindowsInstaller))
                 {
                     installedType = Manifest::InstallerTypeEnum::Msi;
                 }
 
-                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, Manifest::InstallerTypeToString(installedType));
+                entry.Metadata.emplace_back(PackageVersionMetadata::InstalledType, Manifest::InstallerTypeToString(installedType));
+
+                entry.IsRead = true;
+                result.emplace_back(std::move(entry));
             }
             catch (...)
             {
@@ -350,5 +554,94 @@ namespace AppInstaller::Repository::Microsoft
                 LOG_CAUGHT_EXCEPTION();
             }
         }
+
+        return result;
+    }
+
+    void ARPHelper::AddEntriesToIndex(SQLiteIndex& index, const std::vector<ARPEntryData>& readEntries, std::string_view scope, std::string_view architecture, InstalledIndexEntries* entries) const
+    {
+        for (const auto& entry : readEntries)
+        {
+            if (entries && entries->KeepIfUnchanged(index, entry.ProductCode, entry.Stamp))
+            {
+                continue;
+            }
+
+            if (!entry.IsRead)
+            {
+                // Only possible if the cached entry was removed during this pass, which the entry being unchanged precludes.
+                AICLI_LOG(Repo, Warning, << "Unchanged ARP entry is no longer in the index, ignoring it: " << scope << '|' << architecture << '|' << entry.ProductCode);
+                continue;
+            }
+
+            const Manifest::Manifest& manifest = entry.PackageManifest;
+
+            // TODO: Determine the best way to handle duplicates; sometimes the same package will be listed under
+            //       both x64 and x86 locations for ARP.
+            //       For now, we will attempt to insert and catch.
+            std::optional<SQLiteIndex::IdType> manifestIdOpt;
+
+            try
+            {
+                // Use the ProductCode as a unique key for the path
+                manifestIdOpt = index.AddManifest(manifest, Utility::ConvertToUTF16(manifest.Installers[0].ProductCode));
+            }
+            catch (...)
+            {
+                // Ignore errors if they occur, they are most likely a duplicate value
+            }
+
+            if (!manifestIdOpt)
+            {
+                AICLI_LOG(Repo, Warning,
+                    << "Ignoring duplicate ARP entry " << scope << '|' << architecture << '|' << entry.ProductCode << " [" << manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>() << "]");
+                continue;
+            }
+
+            SQLiteIndex::IdType manifestId = manifestIdOpt.value();
+
+            try
+            {
+                if (entries)
+                {
+                    entries->Added(index, manifestId, entry.ProductCode, entry.Stamp);
+                }
+
+                for (const auto& metadata : entry.Metadata)
+                {
+                    index.SetMetadataByManifestId(manifestId, metadata.first, metadata.second);
+                }
+            }
+            catch (...)
+            {
+                AICLI_LOG(Repo, Warning, << "Failed to add ARP entry metadata, ignoring it: " << scope << '|' << architecture << '|' << entry.ProductCode);
+                LOG_CAUGHT_EXCEPTION();
+            }
+        }
+    }
+
+    void ARPHelper::SnapshotARPKeys(ARPKeySnapshot::Entries& entries, Manifest::ScopeEnum scope) const
+    {
+        for (auto architecture : Utility::GetApplicableArchitectures())
+        {
+            Registry::Key arpRootKey = GetARPKey(scope, architecture);
+
+            if (arpRootKey)
+            {
+                SnapshotKey(entries, arpRootKey, Manifest::ScopeToString(scope), Utility::ToString(architecture));
+            }
+        }
+    }
+
+    void ARPHelper::SnapshotKey(ARPKeySnapshot::Entries& entries, const Registry::Key& key, std::string_view scope, std::string_view architecture) const
+    {
+        std::string location{ scope };
+        location += '|';
+        location += architecture;
+
+        for (const auto& arpEntry : key)
+        {
+            entries.emplace(std::make_pair(location, arpEntry.Name()), arpEntry.GetLastWriteTime());
+        }
     }
 }
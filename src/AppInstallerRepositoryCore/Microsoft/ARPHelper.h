@@ -3,14 +3,71 @@
 #pragma once
 #include "Microsoft/SQLiteIndex.h"
 #include <AppInstallerArchitecture.h>
+#include <winget/ARPKeySnapshot.h>
 #include <winget/Registry.h>
 #include <winget/ManifestInstaller.h>
 #include <wil/resource.h>
 
+#include <functional>
+#include <map>
 #include <string>
 
 namespace AppInstaller::Repository::Microsoft
 {
+    // The entries of an installed index that was populated previously, so that only the entries that have changed are read again.
+    // Every entry is identified by the unique path that it was added with, and records a stamp of the state of the system entry it was read from.
+    struct InstalledIndexEntries
+    {
+        // Reads the existing entries from the index.
+        InstalledIndexEntries(const SQLiteIndex& index);
+
+        // Returns true if the entry is already in the index and does not need to be read.
+        // This is the case when the stamp matches, or when an entry with the same key has already been seen; otherwise any
+        // stale version of the entry is removed from the index so that it can be added again.
+        bool KeepIfUnchanged(SQLiteIndex& index, const std::string& key, const std::string& stamp);
+
+        // Returns true if the entry is already in the index with the given stamp.
+        // This does not modify anything, so it can be used while reading entries on other threads.
+        bool IsUnchanged(const std::string& key, const std::string& stamp) const;
+
+        // Records the stamp of an entry that was just added to the index.
+        void Added(SQLiteIndex& index, SQLiteIndex::IdType manifestId, const std::string& key, const std::string& stamp);
+
+        // Removes the entries that were neither kept nor added, as they are no longer present on the system.
+        void RemoveUnseen(SQLiteIndex& index);
+
+        // Removes the entries that were neither kept nor added, limited to those for which the predicate returns true.
+        // Used when only some kinds of entries have been brought up to date.
+        void RemoveUnseen(SQLiteIndex& index, const std::function<bool(const std::string& key, const std::string& stamp)>& predicate);
+
+        // Determines whether the index was changed.
+        bool HasChanges() const { return m_hasChanges; }
+
+    private:
+        struct Entry
+        {
+            SQLiteIndex::IdType ManifestId = 0;
+            std::string Stamp;
+            bool Seen = false;
+        };
+
+        std::map<std::string, Entry> m_entries;
+        bool m_hasChanges = false;
+    };
+
+    // The values read from a single ARP entry, so that the registry can be read separately from adding to the index.
+    struct ARPEntryData
+    {
+        std::string ProductCode;
+        std::string Stamp;
+
+        // False if the entry is unchanged, in which case only the product code and stamp are present.
+        bool IsRead = false;
+
+        Manifest::Manifest PackageManifest;
+        std::vector<std::pair<PackageVersionMetadata, std::string>> Metadata;
+    };
+
     // A helper to find the various locations that contain ARP (Add/Remove Programs) entries.
     struct ARPHelper
     {
@@ -57,25 +114,46 @@ namespace AppInstaller::Repository::Microsoft
         Registry::Key GetARPKey(Manifest::ScopeEnum scope, Utility::Architecture architecture) const;
 
         // Returns true IFF the value exists and contains a non-zero DWORD.
-        static bool GetBoolValue(const Registry::Key& arpKey, const std::wstring& name);
+        static bool GetBoolValue(const Registry::ValueMap& arpValues, const std::wstring& name);
 
         // Determines the version from an ARP entry.
         // The priority is:
         //  DisplayVersion
         //  Version
         //  MajorVersion, MinorVersion
-        std::string DetermineVersion(const Registry::Key& arpKey) const;
+        std::string DetermineVersion(const Registry::ValueMap& arpValues) const;
 
-        // Reads a value and adds it to the metadata if it exists.
-        void AddMetadataIfPresent(const Registry::Key& key, const std::wstring& name, SQLiteIndex& index, SQLiteIndex::IdType manifestId, PackageVersionMetadata metadata) const;
+        // Reads a value and adds it to the metadata of the entry if it exists.
+        void AddMetadataIfPresent(const Registry::ValueMap& values, const std::wstring& name, ARPEntryData& entry, PackageVersionMetadata metadata) const;
 
         // Populates the index with the ARP entries from the given scope (machine/user).
         // Handles all of the architectures for the given scope.
-        void PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope) const;
+        // If entries are provided, only the ARP entries that have been written since they were added to the index are read.
+        void PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope, InstalledIndexEntries* entries = nullptr) const;
+
+        // Populates the index with the ARP entries from all of the given scopes.
+        // Every location is read in parallel, then all of the entries are added to the index in a single transaction.
+        void PopulateIndexFromARP(SQLiteIndex& index, const std::vector<Manifest::ScopeEnum>& scopes, InstalledIndexEntries* entries = nullptr) const;
 
         // Populates the index with the ARP entries from the given key.
         // This entry point is primarily to allow unit tests to operate of arbitrary keys;
         // product code should use PopulateIndexFromARP.
-        void PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const;
+        void PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture, InstalledIndexEntries* entries = nullptr) const;
+
+        // Reads the ARP entries from the given key; safe to call on multiple threads at once.
+        // If entries are provided, the entries that are unchanged are not read.
+        std::vector<ARPEntryData> ReadEntriesFromKey(const Registry::Key& key, std::string_view scope, std::string_view architecture, const InstalledIndexEntries* entries = nullptr) const;
+
+        // Adds the entries read from a key to the index.
+        void AddEntriesToIndex(SQLiteIndex& index, const std::vector<ARPEntryData>& readEntries, std::string_view scope, std::string_view architecture, InstalledIndexEntries* entries = nullptr) const;
+
+        // Records the last write time of the ARP entries from the given scope (machine/user) without reading any of their values.
+        // Handles all of the architectures for the given scope.
+        void SnapshotARPKeys(ARPKeySnapshot::Entries& entries, Manifest::ScopeEnum scope) const;
+
+        // Records the last write time of the ARP entries from the given key.
+        // This entry point is primarily to allow unit tests to operate of arbitrary keys;
+        // product code should use SnapshotARPKeys.
+        void SnapshotKey(ARPKeySnapshot::Entries& entries, const Registry::Key& key, std::string_view scope, std::string_view architecture) const;
     };
 }
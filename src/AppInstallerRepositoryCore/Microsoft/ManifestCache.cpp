@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/ManifestCache.h"
+
+using namespace AppInstaller::Utility;
+
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        constexpr std::wstring_view s_ManifestCache_Directory = L"ManifestCache";
+
+        constexpr uint64_t s_ManifestCache_DefaultMaximumSizeInBytes = 100 * 1024 * 1024;
+
+        // The fraction of the maximum size that can be added before the cache is trimmed again.
+        constexpr uint64_t s_ManifestCache_TrimDivisor = 8;
+
+        // Files being added are written with this extension, then renamed into place.
+        constexpr std::wstring_view s_ManifestCache_PartialExtension = L".partial";
+
+        // Partial files older than this were left by an interrupted add and can be removed.
+        constexpr auto s_ManifestCache_AbandonedPartialAge = std::chrono::hours(24);
+
+        // Determines whether the file name is that of a complete cache entry (the hash string).
+        bool IsEntryFileName(const std::filesystem::path& path)
+        {
+            return path.filename().native().length() == SHA256::HashStringSizeInChars && !path.has_extension();
+        }
+    }
+
+    ManifestCache::ManifestCache(std::filesystem::path root, uint64_t maximumSizeInBytes) :
+        m_root(std::move(root)), m_maximumSizeInBytes(maximumSizeInBytes)
+    {
+        THROW_HR_IF(E_INVALIDARG, m_root.empty());
+    }
+
+    std::shared_ptr<ManifestCache> ManifestCache::GetDefault()
+    {
+        static std::shared_ptr<ManifestCache> s_cache = []()
+            {
+                auto result = std::make_shared<ManifestCache>(Runtime::GetPathTo(Runtime::PathName::LocalState) / s_ManifestCache_Directory, s_ManifestCache_DefaultMaximumSizeInBytes);
+
+                try
+                {
+                    result->Trim();
+                }
+                CATCH_LOG();
+
+                return result;
+            }();
+
+        return s_cache;
+    }
+
+    std::optional<std::string> ManifestCache::Get(const SHA256::HashBuffer& hash) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(hash);
+
+        // The cache is only an optimization, so any failure to read it is a miss
+        try
+        {
+            std::error_code error;
+            if (!std::filesystem::exists(entryPath, error))
+            {
+                AICLI_LOG(Repo, Verbose, << "Manifest cache miss for " << SHA256::ConvertToString(hash));
+                return {};
+            }
+
+            std::string contents;
+            {
+                std::ifstream stream{ entryPath, std::ios_base::in | std::ios_base::binary };
+                contents = Utility::ReadEntireStream(stream);
+            }
+
+            if (!SHA256::AreEqual(hash, SHA256::ComputeHash(contents)))
+            {
+                AICLI_LOG(Repo, Warning, << "Cached manifest does not match its hash; removing " << entryPath);
+                std::filesystem::remove(entryPath, error);
+                return {};
+            }
+
+            AICLI_LOG(Repo, Info, << "Manifest cache hit for " << SHA256::ConvertToString(hash));
+
+            // The last write time of an entry serves as its last use time for eviction
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+
+            return contents;
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Verbose, << "Failed to read cached manifest from " << entryPath);
+            return {};
+        }
+    }
+
+    void ManifestCache::Add(const SHA256::HashBuffer& hash, std::string_view contents) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(hash);
+
+        std::error_code error;
+        if (std::filesystem::exists(entryPath, error))
+        {
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+            return;
+        }
+
+        std::filesystem::create_directories(entryPath.parent_path());
+
+        // Write to a unique file and then move it into place, so that readers never see a partial entry
+        std::filesystem::path partialPath = entryPath;
+        partialPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId());
+        partialPath += s_ManifestCache_PartialExtension;
+
+        {
+            std::ofstream stream{ partialPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+            stream << contents;
+            THROW_HR_IF(E_FAIL, stream.fail());
+        }
+
+        std::filesystem::rename(partialPath, entryPath, error);
+        if (error)
+        {
+            // Most likely another process added the same entry first
+            AICLI_LOG(Repo, Verbose, << "Manifest cache entry was not added: " << error.message());
+            std::filesystem::remove(partialPath, error);
+            return;
+        }
+
+        if ((m_addedSinceTrim += contents.size()) > m_maximumSizeInBytes / s_ManifestCache_TrimDivisor)
+        {
+            Trim();
+        }
+    }
+
+    void ManifestCache::Trim() const
+    {
+        m_addedSinceTrim = 0;
+
+        struct Entry
+        {
+            std::filesystem::path Path;
+            uint64_t Size;
+            std::filesystem::file_time_type LastUsed;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t totalSize = 0;
+
+        std::error_code error;
+        if (!std::filesystem::is_directory(m_root, error))
+        {
+            return;
+        }
+
+        for (const auto& file : std::filesystem::recursive_directory_iterator{ m_root, error })
+        {
+            if (!file.is_regular_file(error))
+            {
+                continue;
+            }
+
+            if (file.path().extension() == s_ManifestCache_PartialExtension)
+            {
+                auto lastWrite = file.last_write_time(error);
+                if (!error && lastWrite + s_ManifestCache_AbandonedPartialAge < std::filesystem::file_time_type::clock::now())
+                {
+                    std::filesystem::remove(file.path(), error);
+                }
+
+                continue;
+            }
+
+            if (!IsEntryFileName(file.path()))
+            {
+                continue;
+            }
+
+            Entry entry{ file.path(), file.file_size(error), file.last_write_time(error) };
+            if (error)
+            {
+                continue;
+            }
+
+            totalSize += entry.Size;
+            entries.emplace_back(std::move(entry));
+        }
+
+        if (totalSize <= m_maximumSizeInBytes)
+        {
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.LastUsed < b.LastUsed; });
+
+        for (const auto& entry : entries)
+        {
+            if (totalSize <= m_maximumSizeInBytes)
+            {
+                break;
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Evicting manifest from cache: " << entry.Path);
+            if (std::filesystem::remove(entry.Path, error) || !std::filesystem::exists(entry.Path, error))
+            {
+                totalSize -= entry.Size;
+            }
+        }
+    }
+
+    std::filesystem::path ManifestCache::GetEntryPath(const SHA256::HashBuffer& hash) const
+    {
+        THROW_HR_IF(E_INVALIDARG, hash.size() != SHA256::HashBufferSizeInBytes);
+
+        // Spread the entries over subdirectories named for the first byte of the hash
+        std::string hashString = SHA256::ConvertToString(hash);
+        return m_root / hashString.substr(0, 2) / hashString;
+    }
+}
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerSHA256.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // A content addressed store of the manifests downloaded for sources that record the hash of each manifest.
+    // Entries are verified against their hash when they are read, so the contents of the directory need not be trusted.
+    // Many processes may use the cache at once, so every operation tolerates files being added and removed concurrently.
+    struct ManifestCache
+    {
+        ManifestCache(std::filesystem::path root, uint64_t maximumSizeInBytes);
+
+        // Gets the cache in the default location, trimming it the first time it is used in the process.
+        static std::shared_ptr<ManifestCache> GetDefault();
+
+        // Gets the cached manifest with the given hash, if there is one that matches the hash.
+        // A cached file that does not match is removed.
+        std::optional<std::string> Get(const Utility::SHA256::HashBuffer& hash) const;
+
+        // Adds the manifest, which must already be verified to have the given hash, to the cache.
+        void Add(const Utility::SHA256::HashBuffer& hash, std::string_view contents) const;
+
+        // Evicts least recently used entries until the cache is within its maximum size.
+        void Trim() const;
+
+    private:
+        std::filesystem::path GetEntryPath(const Utility::SHA256::HashBuffer& hash) const;
+
+        std::filesystem::path m_root;
+        uint64_t m_maximumSizeInBytes = 0;
+        // The size of the entries added since the last trim; a trim walks the whole cache, so it is not done on every add.
+        mutable std::atomic<uint64_t> m_addedSinceTrim = 0;
+    };
+}
@@ -4,9 +4,11 @@
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
 #include "Microsoft/SQLiteIndex.h"
 #include "Microsoft/SQLiteIndexSource.h"
+#include "winget/CompletionIndex.h"
 
 #include <AppInstallerDeployment.h>
 #include <AppInstallerMsixInfo.h>
+#include <winget/Performance.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -18,6 +20,11 @@ namespace AppInstaller::Repository::Microsoft
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_PackageFileName = "source.msix"sv;
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_AppxManifestFileName = "AppxManifest.xml"sv;
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexFileName = "index.db"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_DeltaDirectoryName = "delta"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_DeltaFileExtension = ".delta"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_StagedFileExtension = ".staged"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_CompletionIndexFileName = "completion.idx"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_ResolvedPackageFileName = "package.resolved"sv;
         // TODO: This being hard coded to force using the Public directory name is not ideal.
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexFilePath = "Public\\index.db"sv;
 
@@ -35,6 +42,25 @@ namespace AppInstaller::Repository::Microsoft
             return result;
         }
 
+        // Construct the location of the delta between the two package versions from the given details.
+        // Expects the deltas to be alongside the package, as: delta/<from version>_<to version>.delta
+        std::string GetDeltaLocation(const SourceDetails& details, std::string_view fromVersion, std::string_view toVersion)
+        {
+            THROW_HR_IF(E_INVALIDARG, details.Arg.empty());
+            std::string result = details.Arg;
+            if (result.back() != '/')
+            {
+                result += '/';
+            }
+            result += s_PreIndexedPackageSourceFactory_DeltaDirectoryName;
+            result += '/';
+            result += fromVersion;
+            result += '_';
+            result += toVersion;
+            result += s_PreIndexedPackageSourceFactory_DeltaFileExtension;
+            return result;
+        }
+
         // Gets the package family name from the details.
         std::string GetPackageFamilyNameFromDetails(const SourceDetails& details)
         {
@@ -49,6 +75,65 @@ namespace AppInstaller::Repository::Microsoft
             return "PreIndexedSourceCPRWL_"s + GetPackageFamilyNameFromDetails(details);
         }
 
+        // Constructs the location that we will write files to.
+        std::filesystem::path GetStatePathFromDetails(const SourceDetails& details)
+        {
+            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::LocalState);
+            result /= PreIndexedPackageSourceFactory::Type();
+            result /= GetPackageFamilyNameFromDetails(details);
+            return result;
+        }
+
+        // Reads the latest identifier, name and moniker of every package in the index, along with all of its versions.
+        std::vector<CompletionIndex::Package> GetCompletionPackages(const SQLiteIndex& index)
+        {
+            auto searchResult = index.Search({});
+
+            std::vector<CompletionIndex::Package> result;
+            std::vector<SQLiteIndex::IdType> manifestIds;
+            result.reserve(searchResult.Matches.size());
+            manifestIds.reserve(searchResult.Matches.size());
+
+            for (const auto& match : searchResult.Matches)
+            {
+                auto manifestId = index.GetManifestIdByKey(match.first, {}, {});
+                if (!manifestId)
+                {
+                    continue;
+                }
+
+                CompletionIndex::Package& package = result.emplace_back();
+                package.Versions = index.GetVersionKeysById(match.first);
+                manifestIds.emplace_back(manifestId.value());
+            }
+
+            auto properties = index.GetPropertiesByManifestIds(manifestIds, { PackageVersionProperty::Id, PackageVersionProperty::Name, PackageVersionProperty::Moniker });
+
+            for (size_t i = 0; i < result.size(); ++i)
+            {
+                auto itr = properties.find(manifestIds[i]);
+                if (itr == properties.end())
+                {
+                    continue;
+                }
+
+                auto getProperty = [&](PackageVersionProperty property)
+                {
+                    auto propertyItr = itr->second.find(property);
+                    return (propertyItr == itr->second.end() ? std::string{} : propertyItr->second);
+                };
+
+                result[i].Id = getProperty(PackageVersionProperty::Id);
+                result[i].Name = getProperty(PackageVersionProperty::Name);
+                result[i].Moniker = getProperty(PackageVersionProperty::Moniker);
+            }
+
+            // Packages whose properties could not be read are not useful for completion.
+            result.erase(std::remove_if(result.begin(), result.end(), [](const CompletionIndex::Package& package) { return package.Id.empty(); }), result.end());
+
+            return result;
+        }
+
         // The base class for a package that comes from a preindexed packaged source.
         struct PreIndexedFactoryBase : public ISourceFactory
         {
@@ -90,27 +175,51 @@ namespace AppInstaller::Repository::Microsoft
                 details.Data = Msix::GetPackageFamilyNameFromFullName(fullName);
                 details.Identifier = Msix::GetPackageFamilyNameFromFullName(fullName);
 
-                auto lock = LockExclusive(details, progress);
-                if (!lock)
+                bool result = false;
                 {
-                    return false;
+                    auto lock = LockExclusive(details, progress);
+                    if (!lock)
+                    {
+                        return false;
+                    }
+
+                    result = UpdateInternal(packageLocation, packageInfo, details, progress);
                 }
 
-                return UpdateInternal(packageLocation, packageInfo, details, progress);
+                if (result)
+                {
+                    UpdateCompletionIndex(details, progress);
+                }
+
+                return result;
             }
 
             bool Update(const SourceDetails& details, IProgressCallback& progress) override final
             {
-                return UpdateBase(details, false, progress);
+                return UpdateBase(details, UpdateMode::Foreground, progress);
             }
 
             bool BackgroundUpdate(const SourceDetails& details, IProgressCallback& progress) override final
             {
-                return UpdateBase(details, true, progress);
+                return UpdateBase(details, UpdateMode::Background, progress);
+            }
+
+            bool DetachedUpdate(const SourceDetails& details, IProgressCallback& progress) override final
+            {
+                return UpdateBase(details, UpdateMode::Detached, progress);
             }
 
+            // *Should only be called when under an exclusive CrossProcessReaderWriteLock*
             virtual bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) = 0;
 
+            // Prepares the new data without preventing the source from being read, then takes the exclusive lock only to put it in place.
+            // A background update does not wait on the exclusive lock if the source is in use.
+            virtual bool StagedUpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, bool isBackground, IProgressCallback& progress) = 0;
+
+            // Gets the path to the index for the source, or an empty path if the source data is not present.
+            // *Should only be called when under a CrossProcessReaderWriteLock*
+            virtual std::filesystem::path GetIndexPath(const SourceDetails& details) = 0;
+
             bool Remove(const SourceDetails& details, IProgressCallback& progress) override final
             {
                 THROW_HR_IF(E_INVALIDARG, details.Type != PreIndexedPackageSourceFactory::Type());
@@ -120,12 +229,15 @@ namespace AppInstaller::Repository::Microsoft
                     return false;
                 }
 
+                std::error_code ec;
+                std::filesystem::remove(PreIndexedPackageSourceFactory::GetCompletionIndexPath(details), ec);
+
                 return RemoveInternal(details, progress);
             }
 
             virtual bool RemoveInternal(const SourceDetails& details, IProgressCallback&) = 0;
 
-        private:
+        protected:
             Synchronization::CrossProcessReaderWriteLock LockExclusive(const SourceDetails& details, IProgressCallback& progress, bool isBackground = false)
             {
                 if (isBackground)
@@ -139,7 +251,15 @@ namespace AppInstaller::Repository::Microsoft
                 }
             }
 
-            bool UpdateBase(const SourceDetails& details, bool isBackground, IProgressCallback& progress)
+        private:
+            enum class UpdateMode
+            {
+                Foreground,
+                Background,
+                Detached,
+            };
+
+            bool UpdateBase(const SourceDetails& details, UpdateMode mode, IProgressCallback& progress)
             {
                 THROW_HR_IF(E_INVALIDARG, details.Type != PreIndexedPackageSourceFactory::Type());
 
@@ -159,13 +279,52 @@ namespace AppInstaller::Repository::Microsoft
                     return false;
                 }
 
-                auto lock = LockExclusive(details, progress, isBackground);
-                if (!lock)
+                // Readers are only blocked while the staged data is put in place, not for the download and extraction.
+                bool result = StagedUpdateInternal(packageLocation, packageInfo, details, mode == UpdateMode::Background, progress);
+
+                if (result)
                 {
-                    return false;
+                    UpdateCompletionIndex(details, progress);
                 }
 
-                return UpdateInternal(packageLocation, packageInfo, details, progress);
+                return result;
+            }
+
+            // Rebuilds the completion index if it is older than the source index.
+            // The completion index is only an optimization, so failures are logged and otherwise ignored.
+            void UpdateCompletionIndex(const SourceDetails& details, IProgressCallback& progress)
+            {
+                try
+                {
+                    auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(details), progress);
+                    if (!lock)
+                    {
+                        return;
+                    }
+
+                    std::filesystem::path indexPath = GetIndexPath(details);
+                    if (indexPath.empty() || !std::filesystem::exists(indexPath))
+                    {
+                        return;
+                    }
+
+                    std::filesystem::path completionPath = PreIndexedPackageSourceFactory::GetCompletionIndexPath(details);
+                    if (std::filesystem::exists(completionPath) &&
+                        std::filesystem::last_write_time(completionPath) >= std::filesystem::last_write_time(indexPath))
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Completion index is up to date for source: " << details.Name);
+                        return;
+                    }
+
+                    Performance::ScopedTimer timer{ "PreIndexedPackageSourceFactory::UpdateCompletionIndex" };
+
+                    // The index in the state directory may be replaced while we are reading it, so read it in place rather than mapping it.
+                    SQLiteIndex index = SQLiteIndex::Open(indexPath.u8string(), SQLiteIndex::OpenDisposition::Read);
+
+                    std::filesystem::create_directories(completionPath.parent_path());
+                    CompletionIndex::Create(completionPath, GetCompletionPackages(index));
+                }
+                CATCH_LOG();
             }
         };
 
@@ -176,6 +335,103 @@ namespace AppInstaller::Repository::Microsoft
             return catalog.FindByPackageFamilyAndId(GetPackageFamilyNameFromDetails(details), Deployment::IndexDBId);
         }
 
+        // The index location of a deployed source package is kept in the state directory once it has been resolved through
+        // the extension catalog, along with the full name of the package and the size and write time of the index.
+        // Opening the source can then skip the catalog for as long as the package and its index are unchanged.
+        std::filesystem::path GetResolvedPackagePath(const SourceDetails& details)
+        {
+            std::filesystem::path result = GetStatePathFromDetails(details);
+            result /= s_PreIndexedPackageSourceFactory_ResolvedPackageFileName;
+            return result;
+        }
+
+        // Gets a stamp of the size and last write time of the index; empty if the file cannot be read.
+        std::string GetIndexStamp(const std::filesystem::path& indexLocation)
+        {
+            std::error_code error;
+            auto size = std::filesystem::file_size(indexLocation, error);
+            if (error)
+            {
+                return {};
+            }
+
+            auto writeTime = std::filesystem::last_write_time(indexLocation, error);
+            if (error)
+            {
+                return {};
+            }
+
+            return std::to_string(size) + '|' + std::to_string(writeTime.time_since_epoch().count());
+        }
+
+        // Gets the index location of the package as it was last resolved, or an empty path if that is no longer the installed package.
+        std::filesystem::path GetResolvedIndexLocation(const SourceDetails& details)
+        {
+            std::ifstream stream{ GetResolvedPackagePath(details) };
+            std::string fullName;
+            std::string indexLocation;
+            std::string indexStamp;
+
+            if (!stream || !std::getline(stream, fullName) || !std::getline(stream, indexLocation) || !std::getline(stream, indexStamp))
+            {
+                return {};
+            }
+
+            // The full name includes the version, so this also finds a package that has been updated since it was resolved.
+            auto currentFullName = Msix::GetPackageFullNameFromFamilyName(GetPackageFamilyNameFromDetails(details));
+            if (!currentFullName || currentFullName.value() != fullName)
+            {
+                AICLI_LOG(Repo, Info, << "Source package has changed since it was resolved: " << fullName);
+                return {};
+            }
+
+            std::filesystem::path result = Utility::ConvertToUTF16(indexLocation);
+            if (GetIndexStamp(result) != indexStamp)
+            {
+                AICLI_LOG(Repo, Info, << "Source package index has changed since it was resolved: " << indexLocation);
+                return {};
+            }
+
+            return result;
+        }
+
+        // Saves the index location of the package that was resolved; failures are only logged, as the package is resolved again on the next open.
+        void SaveResolvedIndexLocation(const SourceDetails& details, const std::filesystem::path& indexLocation)
+        {
+            try
+            {
+                auto fullName = Msix::GetPackageFullNameFromFamilyName(GetPackageFamilyNameFromDetails(details));
+                std::string indexStamp = GetIndexStamp(indexLocation);
+                if (!fullName || indexStamp.empty())
+                {
+                    return;
+                }
+
+                std::filesystem::path resolvedPath = GetResolvedPackagePath(details);
+                std::filesystem::create_directories(resolvedPath.parent_path());
+
+                // Written beside the file and renamed over it, as other processes may be opening the source at the same time.
+                std::filesystem::path tempPath = resolvedPath;
+                tempPath += "." + std::to_string(GetCurrentProcessId()) + "." + std::to_string(GetCurrentThreadId());
+
+                {
+                    std::ofstream stream{ tempPath, std::ios::out | std::ios::trunc };
+                    stream << fullName.value() << '\n' << indexLocation.u8string() << '\n' << indexStamp << '\n';
+                    THROW_HR_IF(E_FAIL, !stream);
+                }
+
+                std::filesystem::rename(tempPath, resolvedPath);
+            }
+            CATCH_LOG();
+        }
+
+        // Removes the resolved package, for when the package is being replaced or removed.
+        void RemoveResolvedIndexLocation(const SourceDetails& details)
+        {
+            std::error_code error;
+            std::filesystem::remove(GetResolvedPackagePath(details), error);
+        }
+
         struct PackagedContextSourceReference : public ISourceReference
         {
             PackagedContextSourceReference(const SourceDetails& details) : m_details(details)
@@ -198,28 +454,48 @@ namespace AppInstaller::Repository::Microsoft
                     return {};
                 }
 
-                auto extension = GetExtensionFromDetails(m_details);
-                if (!extension)
+                // The content integrity of the package is verified when it is resolved; the package cannot be changed
+                // in place afterward, and the resolved location is only used while the index has the same size and write time.
+                std::filesystem::path indexLocation = GetResolvedIndexLocation(m_details);
+
+                if (indexLocation.empty())
                 {
-                    AICLI_LOG(Repo, Info, << "Package not found " << m_details.Data);
-                    THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
-                }
+                    auto extension = GetExtensionFromDetails(m_details);
+                    if (!extension)
+                    {
+                        AICLI_LOG(Repo, Info, << "Package not found " << m_details.Data);
+                        THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
+                    }
+
+                    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NEEDS_REMEDIATION), !extension->VerifyContentIntegrity(progress));
 
-                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NEEDS_REMEDIATION), !extension->VerifyContentIntegrity(progress));
+                    // To work around an issue with accessing the public folder, we are temporarily
+                    // constructing the location ourself.  This was already the case for the non-packaged
+                    // runtime, and we can fix both in the future.  The only problem with this is that
+                    // the directory in the extension *must* be Public, rather than one set by the creator.
+                    indexLocation = extension->GetPackagePath();
+                    indexLocation /= s_PreIndexedPackageSourceFactory_IndexFilePath;
 
-                // To work around an issue with accessing the public folder, we are temporarily
-                // constructing the location ourself.  This was already the case for the non-packaged
-                // runtime, and we can fix both in the future.  The only problem with this is that
-                // the directory in the extension *must* be Public, rather than one set by the creator.
-                std::filesystem::path indexLocation = extension->GetPackagePath();
-                indexLocation /= s_PreIndexedPackageSourceFactory_IndexFilePath;
+                    SaveResolvedIndexLocation(m_details, indexLocation);
+                }
+                else
+                {
+                    AICLI_LOG(Repo, Verbose, << "Using resolved source package index: " << indexLocation);
+                }
+
+                auto openStart = std::chrono::steady_clock::now();
 
-                SQLiteIndex index = SQLiteIndex::Open(indexLocation.u8string(), SQLiteIndex::OpenDisposition::Immutable);
+                // The packaged index can never be written, so it is safe to read through a memory mapping.
+                SQLiteIndex index = SQLiteIndex::Open(indexLocation.u8string(), SQLiteIndex::OpenDisposition::ImmutableMapped);
+                AICLI_LOG(Repo, Info, << "Opened packaged source index in " <<
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - openStart).count() << "ms");
 
                 // We didn't use to store the source identifier, so we compute it here in case it's
                 // missing from the details.
                 m_details.Identifier = GetPackageFamilyNameFromDetails(m_details);
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                auto source = std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                source->EnableSearchResultCache(indexLocation);
+                return source;
             }
 
         private:
@@ -274,6 +550,8 @@ namespace AppInstaller::Repository::Microsoft
                     uri = winrt::Windows::Foundation::Uri(Utility::ConvertToUTF16(packageLocation));
                 }
 
+                RemoveResolvedIndexLocation(details);
+
                 Deployment::AddPackage(
                     uri,
                     winrt::Windows::Management::Deployment::DeploymentOptions::None,
@@ -311,8 +589,63 @@ namespace AppInstaller::Repository::Microsoft
                 return true;
             }
 
+            bool StagedUpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, bool isBackground, IProgressCallback& progress) override
+            {
+                {
+                    auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(details), progress);
+                    if (!lock)
+                    {
+                        return false;
+                    }
+
+                    auto extension = GetExtensionFromDetails(details);
+                    if (extension && !packageInfo.IsNewerThan(extension->GetPackageVersion()))
+                    {
+                        AICLI_LOG(Repo, Info, << "Remote source data was not newer than existing, no update needed");
+                        return true;
+                    }
+                }
+
+                // Download while the source can still be read, so that the exclusive lock is only held for deployment.
+                std::string localLocation = packageLocation;
+                std::filesystem::path tempFile;
+                auto removeTempFile = wil::scope_exit([&]()
+                    {
+                        if (!tempFile.empty())
+                        {
+                            std::error_code ec;
+                            std::filesystem::remove(tempFile, ec);
+                        }
+                    });
+
+                if (Utility::IsUrlRemote(packageLocation))
+                {
+                    tempFile = Runtime::GetPathTo(Runtime::PathName::Temp);
+                    tempFile /= GetPackageFamilyNameFromDetails(details) + ".detached.msix";
+
+                    Utility::Download(packageLocation, tempFile, Utility::DownloadType::Index, progress);
+                    localLocation = tempFile.u8string();
+                }
+
+                if (progress.IsCancelled())
+                {
+                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                    return false;
+                }
+
+                auto lock = LockExclusive(details, progress, isBackground);
+                if (!lock)
+                {
+                    return false;
+                }
+
+                return UpdateInternal(localLocation, packageInfo, details, progress);
+            }
+
             bool RemoveInternal(const SourceDetails& details, IProgressCallback& callback) override
             {
+                RemoveResolvedIndexLocation(details);
+
                 auto fullName = Msix::GetPackageFullNameFromFamilyName(GetPackageFamilyNameFromDetails(details));
 
                 if (!fullName)
@@ -327,15 +660,88 @@ namespace AppInstaller::Repository::Microsoft
 
                 return true;
             }
+
+            std::filesystem::path GetIndexPath(const SourceDetails& details) override
+            {
+                std::filesystem::path resolved = GetResolvedIndexLocation(details);
+                if (!resolved.empty())
+                {
+                    return resolved;
+                }
+
+                auto extension = GetExtensionFromDetails(details);
+                if (!extension)
+                {
+                    return {};
+                }
+
+                std::filesystem::path result = extension->GetPackagePath();
+                result /= s_PreIndexedPackageSourceFactory_IndexFilePath;
+                return result;
+            }
         };
 
-        // Constructs the location that we will write files to.
-        std::filesystem::path GetStatePathFromDetails(const SourceDetails& details)
+        // Attempts to create the new index at the output path by applying the delta from the existing index version to the remote version.
+        // Returns false if the delta is not available or could not be applied, in which case the output path is not written.
+        bool TryUpdateFromDelta(
+            Msix::MsixInfo& packageInfo,
+            const SourceDetails& details,
+            const std::filesystem::path& manifestPath,
+            const std::filesystem::path& indexPath,
+            const std::filesystem::path& outputPath,
+            IProgressCallback& progress)
         {
-            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::LocalState);
-            result /= PreIndexedPackageSourceFactory::Type();
-            result /= GetPackageFamilyNameFromDetails(details);
-            return result;
+            std::filesystem::path deltaPath = indexPath;
+            deltaPath += s_PreIndexedPackageSourceFactory_DeltaFileExtension;
+            std::filesystem::path patchedPath = indexPath;
+            patchedPath += ".patched";
+
+            auto removeFiles = wil::scope_exit([&]()
+                {
+                    std::error_code ec;
+                    std::filesystem::remove(deltaPath, ec);
+                    std::filesystem::remove(patchedPath, ec);
+                });
+
+            try
+            {
+                std::string deltaLocation = GetDeltaLocation(details, Msix::GetPackageVersionFromManifestFile(manifestPath), packageInfo.GetPackageVersion());
+                AICLI_LOG(Repo, Info, << "Attempting to update from delta at " << deltaLocation);
+
+                if (Utility::IsUrlRemote(deltaLocation))
+                {
+                    Utility::Download(deltaLocation, deltaPath, Utility::DownloadType::Index, progress);
+                }
+                else
+                {
+                    std::filesystem::copy_file(Utility::ConvertToUTF16(deltaLocation), deltaPath, std::filesystem::copy_options::overwrite_existing);
+                }
+
+                if (progress.IsCancelled())
+                {
+                    return false;
+                }
+
+                SQLiteIndex::ApplyDelta(indexPath, deltaPath, patchedPath);
+
+                // The delta is not signed; the result must match the index in the signed package.
+                if (!packageInfo.IsFileContentMatch(s_PreIndexedPackageSourceFactory_IndexFilePath, patchedPath))
+                {
+                    THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+                }
+
+                std::filesystem::rename(patchedPath, outputPath);
+
+                AICLI_LOG(Repo, Info, << "Updated index from delta");
+                return true;
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(Repo, Info, << "Unable to update from delta, falling back to the full package");
+            }
+
+            return false;
         }
 
         struct DesktopContextSourceReference : public ISourceReference
@@ -369,12 +775,21 @@ namespace AppInstaller::Repository::Microsoft
                     THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
                 }
 
-                SQLiteIndex index = SQLiteIndex::Open(packageLocation.u8string(), SQLiteIndex::OpenDisposition::Read);
+                auto openStart = std::chrono::steady_clock::now();
+
+                // The index is only replaced under the exclusive lock, and the shared lock is held for the lifetime of the source,
+                // so it cannot change while it is open. Mapping it lets every process reading it, such as concurrent CLI invocations
+                // and the COM server, share the same pages rather than each copying them into its own page cache.
+                SQLiteIndex index = SQLiteIndex::Open(packageLocation.u8string(), SQLiteIndex::OpenDisposition::ImmutableMapped);
+                AICLI_LOG(Repo, Info, << "Opened source index in " <<
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - openStart).count() << "ms");
 
                 // We didn't use to store the source identifier, so we compute it here in case it's
                 // missing from the details.
                 m_details.Identifier = GetPackageFamilyNameFromDetails(m_details);
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                auto source = std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                source->EnableSearchResultCache(packageLocation);
+                return source;
             }
 
         private:
@@ -406,6 +821,12 @@ namespace AppInstaller::Repository::Microsoft
                         AICLI_LOG(Repo, Info, << "Remote source data was not newer than existing, no update needed");
                         return true;
                     }
+
+                    if (TryUpdateFromDelta(packageInfo, details, manifestPath, indexPath, indexPath, progress))
+                    {
+                        packageInfo.WriteManifestToFile(manifestPath, progress);
+                        return true;
+                    }
                 }
 
                 if (progress.IsCancelled())
@@ -420,6 +841,87 @@ namespace AppInstaller::Repository::Microsoft
                 return true;
             }
 
+            bool StagedUpdateInternal(const std::string&, Msix::MsixInfo& packageInfo, const SourceDetails& details, bool isBackground, IProgressCallback& progress) override
+            {
+                std::filesystem::path packageState = GetStatePathFromDetails(details);
+                std::filesystem::create_directories(packageState);
+
+                std::filesystem::path manifestPath = packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName;
+                std::filesystem::path indexPath = packageState / s_PreIndexedPackageSourceFactory_IndexFileName;
+
+                // The new files are staged alongside the current ones, then renamed over them once no one is reading.
+                std::filesystem::path stagedManifestPath = manifestPath;
+                stagedManifestPath += s_PreIndexedPackageSourceFactory_StagedFileExtension;
+                std::filesystem::path stagedIndexPath = indexPath;
+                stagedIndexPath += s_PreIndexedPackageSourceFactory_StagedFileExtension;
+
+                auto removeFiles = wil::scope_exit([&]()
+                    {
+                        std::error_code ec;
+                        std::filesystem::remove(stagedManifestPath, ec);
+                        std::filesystem::remove(stagedIndexPath, ec);
+                    });
+
+                {
+                    auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(details), progress);
+                    if (!lock)
+                    {
+                        return false;
+                    }
+
+                    bool staged = false;
+
+                    if (std::filesystem::exists(manifestPath) && std::filesystem::exists(indexPath))
+                    {
+                        if (!packageInfo.IsNewerThan(manifestPath))
+                        {
+                            AICLI_LOG(Repo, Info, << "Remote source data was not newer than existing, no update needed");
+                            return true;
+                        }
+
+                        staged = TryUpdateFromDelta(packageInfo, details, manifestPath, indexPath, stagedIndexPath, progress);
+                    }
+
+                    if (progress.IsCancelled())
+                    {
+                        AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                        return false;
+                    }
+
+                    if (!staged)
+                    {
+                        packageInfo.WriteToFile(s_PreIndexedPackageSourceFactory_IndexFilePath, stagedIndexPath, progress);
+                    }
+
+                    packageInfo.WriteManifestToFile(stagedManifestPath, progress);
+                }
+
+                if (progress.IsCancelled())
+                {
+                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                    return false;
+                }
+
+                auto lock = LockExclusive(details, progress, isBackground);
+                if (!lock)
+                {
+                    return false;
+                }
+
+                // Another update may have completed while this one was staging.
+                if (std::filesystem::exists(manifestPath) && std::filesystem::exists(indexPath) && !packageInfo.IsNewerThan(manifestPath))
+                {
+                    AICLI_LOG(Repo, Info, << "Source data was updated while staging, discarding the staged data");
+                    return true;
+                }
+
+                std::filesystem::rename(stagedIndexPath, indexPath);
+                std::filesystem::rename(stagedManifestPath, manifestPath);
+
+                AICLI_LOG(Repo, Info, << "Swapped in the staged source data");
+                return true;
+            }
+
             bool RemoveInternal(const SourceDetails& details, IProgressCallback&) override
             {
                 std::filesystem::path packageState = GetStatePathFromDetails(details);
@@ -436,13 +938,104 @@ namespace AppInstaller::Repository::Microsoft
 
                 return true;
             }
+
+            std::filesystem::path GetIndexPath(const SourceDetails& details) override
+            {
+                return GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_IndexFileName;
+            }
+        };
+
+        // Source reference for data only storage within a packaged context.
+        // A source that was deployed before data only storage was enabled is read from its package until it is next updated.
+        struct DataOnlyContextSourceReference : public DesktopContextSourceReference
+        {
+            DataOnlyContextSourceReference(const SourceDetails& details) : DesktopContextSourceReference(details) {}
+
+            std::shared_ptr<ISource> Open(IProgressCallback& progress) override
+            {
+                const SourceDetails& details = GetDetails();
+
+                if (!details.Data.empty() && !std::filesystem::exists(GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_IndexFileName))
+                {
+                    AICLI_LOG(Repo, Info, << "Extracted data not found, opening deployed package for source: " << details.Name);
+                    PackagedContextSourceReference packagedReference{ details };
+                    auto source = packagedReference.Open(progress);
+                    GetDetails() = packagedReference.GetDetails();
+                    return source;
+                }
+
+                return DesktopContextSourceReference::Open(progress);
+            }
+        };
+
+        // Source factory for running within a packaged context without deploying the source package.
+        // The package signature is verified in place of deployment, then the data is extracted as it is outside of a package.
+        struct DataOnlyContextFactory : public DesktopContextFactory
+        {
+            std::shared_ptr<ISourceReference> CreateInternal(const SourceDetails& details) override
+            {
+                return std::make_shared<DataOnlyContextSourceReference>(details);
+            }
+
+            bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) override
+            {
+                ValidatePackage(packageInfo, details);
+                return DesktopContextFactory::UpdateInternal(packageLocation, packageInfo, details, progress);
+            }
+
+            bool StagedUpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, bool isBackground, IProgressCallback& progress) override
+            {
+                ValidatePackage(packageInfo, details);
+                return DesktopContextFactory::StagedUpdateInternal(packageLocation, packageInfo, details, isBackground, progress);
+            }
+
+            bool RemoveInternal(const SourceDetails& details, IProgressCallback& progress) override
+            {
+                DesktopContextFactory::RemoveInternal(details, progress);
+
+                // Remove any package deployed before data only storage was enabled.
+                auto fullName = Msix::GetPackageFullNameFromFamilyName(GetPackageFamilyNameFromDetails(details));
+                if (fullName)
+                {
+                    AICLI_LOG(Repo, Info, << "Removing package: " << *fullName);
+                    Deployment::RemovePackage(*fullName, progress);
+                }
+
+                return true;
+            }
+
+        private:
+            static void ValidatePackage(Msix::MsixInfo& packageInfo, const SourceDetails& details)
+            {
+                // Deployment would verify the signature; the Store origin cannot be checked without deployment,
+                // so those sources are instead required to be signed by a certificate issued from a Microsoft root.
+                try
+                {
+                    packageInfo.ValidateSignature(WI_IsFlagSet(details.TrustLevel, SourceTrustLevel::StoreOrigin));
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+                }
+            }
         };
     }
 
+    std::filesystem::path PreIndexedPackageSourceFactory::GetCompletionIndexPath(const SourceDetails& details)
+    {
+        return GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_CompletionIndexFileName;
+    }
+
     std::unique_ptr<ISourceFactory> PreIndexedPackageSourceFactory::Create()
     {
         if (Runtime::IsRunningInPackagedContext())
         {
+            if (Settings::User().Get<Settings::Setting::SourceDataOnlyStorage>())
+            {
+                return std::make_unique<DataOnlyContextFactory>();
+            }
+
             return std::make_unique<PackagedContextFactory>();
         }
         else
@@ -4,6 +4,7 @@
 #include "ISource.h"
 #include "SourceFactory.h"
 
+#include <filesystem>
 #include <string_view>
 
 namespace AppInstaller::Repository::Microsoft
@@ -29,5 +30,8 @@ namespace AppInstaller::Repository::Microsoft
 
         // Creates a source factory for this type.
         static std::unique_ptr<ISourceFactory> Create();
+
+        // Gets the path of the completion index that is kept beside the data for the source.
+        static std::filesystem::path GetCompletionIndexPath(const SourceDetails& details);
     };
 }
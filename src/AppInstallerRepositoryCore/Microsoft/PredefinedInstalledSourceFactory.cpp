@@ -9,6 +9,11 @@
 
 #include <winget/Registry.h>
 #include <AppInstallerArchitecture.h>
+#include <AppInstallerRuntime.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -17,85 +22,580 @@ namespace AppInstaller::Repository::Microsoft
 {
     namespace
     {
-        // Populates the index with the entries from MSIX.
-        void PopulateIndexFromMSIX(SQLiteIndex& index)
+        // The installed source is cached between invocations so that only the entries that have changed need to be read.
+        // The version must be incremented whenever the way that entries are written to the index changes.
+        constexpr std::string_view s_InstalledSourceCacheDirectory = "InstalledSourceCache"sv;
+        constexpr int s_InstalledSourceCacheVersion = 1;
+
+        std::filesystem::path GetInstalledSourceCachePath(PredefinedInstalledSourceFactory::Filter filter)
         {
-            using namespace winrt::Windows::ApplicationModel;
-            using namespace winrt::Windows::Management::Deployment;
+            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::LocalState);
+            result /= s_InstalledSourceCacheDirectory;
+            result /= "installed_v" + std::to_string(s_InstalledSourceCacheVersion) + "_" + std::string{ PredefinedInstalledSourceFactory::FilterToString(filter) } + ".db";
+            return result;
+        }
 
-            // TODO: Consider if Optional packages should also be enumerated
-            PackageManager packageManager;
-            auto packages = packageManager.FindPackagesForUserWithPackageTypes({}, PackageTypes::Main);
+        // Loads the cached index into memory, or creates a new one if there is no usable cache.
+        SQLiteIndex LoadInstalledSourceCache(const std::filesystem::path& cachePath)
+        {
+            if (std::filesystem::exists(cachePath))
+            {
+                try
+                {
+                    SQLiteIndex index = SQLiteIndex::OpenInMemoryCopy(cachePath.u8string());
 
-            // Reuse the same manifest object, as we will be setting the same values every time.
+                    if (index.GetVersion() == Schema::Version::Latest())
+                    {
+                        return index;
+                    }
+
+                    AICLI_LOG(Repo, Info, << "Installed source cache is from a different schema version and will be rebuilt");
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    AICLI_LOG(Repo, Warning, << "Failed to load the installed source cache; it will be rebuilt");
+                }
+            }
+
+            return SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
+        }
+
+        // Writes the index to the cache; the cache is only an optimization, so failures are not fatal.
+        void SaveInstalledSourceCache(const SQLiteIndex& index, const std::filesystem::path& cachePath)
+        {
+            try
+            {
+                std::filesystem::create_directories(cachePath.parent_path());
+                index.CopyTo(cachePath.u8string());
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(Repo, Warning, << "Failed to save the installed source cache");
+            }
+        }
+
+        constexpr std::string_view s_MSIXStampPrefix = "msix|"sv;
+
+        // Gets the stamp for an MSIX package; the full name covers changes to the version, and the install date covers reinstalls.
+        std::string GetMSIXStamp(const winrt::Windows::ApplicationModel::Package& package)
+        {
+            std::ostringstream strstr;
+            strstr << s_MSIXStampPrefix;
+
+            try
+            {
+                strstr << package.InstalledDate().time_since_epoch().count();
+            }
+            catch (...)
+            {
+                // Without the date, only changes to the full name are detected.
+            }
+
+            return strstr.str();
+        }
+
+        bool IsMSIXStamp(const std::string& stamp)
+        {
+            return std::string_view{ stamp }.substr(0, s_MSIXStampPrefix.length()) == s_MSIXStampPrefix;
+        }
+
+        // Creates the manifest that is reused for every MSIX package, as most of the values are the same for all of them.
+        Manifest::Manifest CreateMSIXManifestTemplate()
+        {
             Manifest::Manifest manifest;
             // Add one installer for storing the package family name.
             manifest.Installers.emplace_back();
             // Every package will have the same tags currently.
             manifest.DefaultLocalization.Add<Manifest::Localization::Tags>({ "msix" });
+            return manifest;
+        }
+
+        // Adds an MSIX package to the index.
+        // If entries are provided, the package is only read if it has changed since it was added to the index.
+        void AddMSIXPackageToIndex(SQLiteIndex& index, const winrt::Windows::ApplicationModel::Package& package, Manifest::Manifest& manifest, InstalledIndexEntries* entries)
+        {
+            using namespace winrt::Windows::ApplicationModel;
 
             // Fields in the index but not populated:
             //  AppMoniker - Not sure what we would put.
             //  Channel - We don't know this information here.
             //  Commands - We could open the manifest and look for these eventually.
             //  Tags - Not sure what else we could put in here.
+
+            // System packages are part of the OS, and cannot be managed by the user.
+            // Filter them out as there is no point in showing them in a package manager.
+            auto signatureKind = package.SignatureKind();
+            if (signatureKind == PackageSignatureKind::System)
+            {
+                return;
+            }
+
+            auto packageId = package.Id();
+
+            // Reading the display name is the expensive part, so check for an unchanged entry first.
+            std::string fullName;
+            std::string stamp;
+            if (entries)
+            {
+                fullName = Utility::ConvertToUTF8(packageId.FullName());
+                stamp = GetMSIXStamp(package);
+
+                if (entries->KeepIfUnchanged(index, fullName, stamp))
+                {
+                    return;
+                }
+            }
+
+            Utility::NormalizedString familyName = Utility::ConvertToUTF8(packageId.FamilyName());
+
+            manifest.Id = familyName;
+
+            bool isPackageNameSet = false;
+            // Attempt to get the DisplayName. Since this will retrieve the localized value, it has a chance to fail.
+            // Rather than completely skip this package in that case, we will simply fall back to using the package name below.
+            try
+            {
+                auto displayName = Utility::ConvertToUTF8(package.DisplayName());
+                if (!displayName.empty())
+                {
+                    manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(displayName);
+                    isPackageNameSet = true;
+                }
+            }
+            catch (const winrt::hresult_error& hre)
+            {
+                AICLI_LOG(Repo, Info, << "winrt::hresult_error[0x" << Logging::SetHRFormat << hre.code() << ": " <<
+                    Utility::ConvertToUTF8(hre.message()) << "] exception thrown when getting DisplayName for " << familyName);
+            }
+            catch (...)
+            {
+                AICLI_LOG(Repo, Info, << "Unknown exception thrown when getting DisplayName for " << familyName);
+            }
+
+            if (!isPackageNameSet)
+            {
+                manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(Utility::ConvertToUTF8(packageId.Name()));
+            }
+
+            std::ostringstream strstr;
+            auto packageVersion = packageId.Version();
+            strstr << packageVersion.Major << '.' << packageVersion.Minor << '.' << packageVersion.Build << '.' << packageVersion.Revision;
+
+            manifest.Version = strstr.str();
+
+            manifest.Installers[0].PackageFamilyName = familyName;
+
+            // Use the full name as a unique key for the path
+            auto manifestId = index.AddManifest(manifest, std::filesystem::path{ packageId.FullName().c_str() });
+
+            index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType,
+                Manifest::InstallerTypeToString(Manifest::InstallerTypeEnum::Msix));
+
+            if (entries)
+            {
+                entries->Added(index, manifestId, fullName, stamp);
+            }
+        }
+
+        // Populates the index with the entries from MSIX.
+        // If entries are provided, only the packages that have changed since they were added to the index are read.
+        void PopulateIndexFromMSIX(SQLiteIndex& index, InstalledIndexEntries* entries = nullptr)
+        {
+            using namespace winrt::Windows::ApplicationModel;
+            using namespace winrt::Windows::Management::Deployment;
+
+            // TODO: Consider if Optional packages should also be enumerated
+            PackageManager packageManager;
+            auto packages = packageManager.FindPackagesForUserWithPackageTypes({}, PackageTypes::Main);
+
+            // Reuse the same manifest object, as we will be setting the same values every time.
+            Manifest::Manifest manifest = CreateMSIXManifestTemplate();
+
+            // Add all of the packages in one transaction, rather than one for each of the rows written.
+            SQLite::Savepoint savepoint = index.CreateSavepoint("populateindexfrommsix");
+
+            for (const auto& package : packages)
+            {
+                AddMSIXPackageToIndex(index, package, manifest, entries);
+            }
+
+            savepoint.Commit();
+        }
+
+        // Populates the index with the entries from MSIX for a single package family.
+        void PopulateIndexFromMSIXFamily(SQLiteIndex& index, std::string_view familyName, InstalledIndexEntries* entries = nullptr)
+        {
+            using namespace winrt::Windows::ApplicationModel;
+            using namespace winrt::Windows::Management::Deployment;
+
+            PackageManager packageManager;
+            auto packages = packageManager.FindPackagesForUserWithPackageTypes({}, Utility::ConvertToUTF16(familyName), PackageTypes::Main);
+
+            Manifest::Manifest manifest = CreateMSIXManifestTemplate();
+
+            SQLite::Savepoint savepoint = index.CreateSavepoint("populateindexfrommsixfamily");
+
             for (const auto& package : packages)
             {
-                // System packages are part of the OS, and cannot be managed by the user.
-                // Filter them out as there is no point in showing them in a package manager.
-                auto signatureKind = package.SignatureKind();
-                if (signatureKind == PackageSignatureKind::System)
+                AddMSIXPackageToIndex(index, package, manifest, entries);
+            }
+
+            savepoint.Commit();
+        }
+
+        // Gets the keys of the entries in the index for the given package family.
+        std::set<std::string> GetKeysForMSIXFamily(const SQLiteIndex& index, std::string_view familyName)
+        {
+            std::set<std::string> result;
+
+            SearchRequest request;
+            request.Filters.emplace_back(PackageMatchField::PackageFamilyName, MatchType::CaseInsensitive, familyName);
+
+            for (const auto& match : index.Search(request).Matches)
+            {
+                for (const auto& versionKey : index.GetVersionKeysById(match.first))
                 {
-                    continue;
+                    auto manifestId = index.GetManifestIdByKey(match.first, versionKey.GetVersion().ToString(), versionKey.GetChannel().ToString());
+                    if (manifestId)
+                    {
+                        auto path = index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::RelativePath);
+                        if (path)
+                        {
+                            result.emplace(std::move(path).value());
+                        }
+                    }
                 }
+            }
 
-                auto packageId = package.Id();
-                Utility::NormalizedString familyName = Utility::ConvertToUTF8(packageId.FamilyName());
+            return result;
+        }
 
-                manifest.Id = familyName;
+        // Determines which MSIX entries must be up to date to answer the request.
+        // Returns false if all of them are needed; otherwise families contains the package family names that are needed.
+        bool GetRequiredMSIXFamilies(const SearchRequest& request, std::vector<std::string>& families)
+        {
+            if (request.Query || request.IsForEverything())
+            {
+                return false;
+            }
+
+            for (const auto* filters : { &request.Inclusions, &request.Filters })
+            {
+                for (const auto& filter : *filters)
+                {
+                    switch (filter.Field)
+                    {
+                    case PackageMatchField::ProductCode:
+                        // MSIX entries have no product code, so they can never match.
+                        break;
+                    case PackageMatchField::PackageFamilyName:
+                        if (filter.Type != MatchType::Exact && filter.Type != MatchType::CaseInsensitive)
+                        {
+                            return false;
+                        }
+                        families.emplace_back(filter.Value);
+                        break;
+                    default:
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // The installed source, where the MSIX entries are only brought up to date once a search needs them.
+        // Enumerating every MSIX package is expensive, and searches for product codes or package family names
+        // (as used to correlate with available packages) can be answered without it.
+        struct LazyMSIXInstalledSource : public SQLiteIndexSource
+        {
+            LazyMSIXInstalledSource(const SourceDetails& details, SQLiteIndex&& index, InstalledIndexEntries&& entries, std::filesystem::path cachePath) :
+                SQLiteIndexSource(details, std::move(index), Synchronization::CrossProcessReaderWriteLock{}, true),
+                m_state(std::make_unique<State>(std::move(entries), std::move(cachePath)))
+            {
+            }
+
+            SearchResult Search(const SearchRequest& request) const override
+            {
+                EnsureMSIXEntries(request);
+                return SQLiteIndexSource::Search(request);
+            }
+
+        private:
+            struct State
+            {
+                State(InstalledIndexEntries&& entries, std::filesystem::path&& cachePath) : Entries(std::move(entries)), CachePath(std::move(cachePath)) {}
+
+                std::mutex Lock;
+                InstalledIndexEntries Entries;
+                std::filesystem::path CachePath;
+                bool AllFamiliesRead = false;
+                std::set<std::string> FamiliesRead;
+            };
+
+            void EnsureMSIXEntries(const SearchRequest& request) const
+            {
+                std::lock_guard<std::mutex> lock{ m_state->Lock };
+
+                if (m_state->AllFamiliesRead)
+                {
+                    return;
+                }
+
+                SQLiteIndex& index = NonConstSharedFromThis()->GetIndex();
+
+                std::vector<std::string> families;
+                if (!GetRequiredMSIXFamilies(request, families))
+                {
+                    AICLI_LOG(Repo, Info, << "Reading all MSIX packages for the installed source");
+
+                    PopulateIndexFromMSIX(index, &m_state->Entries);
+                    m_state->Entries.RemoveUnseen(index, [](const std::string&, const std::string& stamp) { return IsMSIXStamp(stamp); });
+                    m_state->AllFamiliesRead = true;
+
+                    if (m_state->Entries.HasChanges())
+                    {
+                        SaveInstalledSourceCache(index, m_state->CachePath);
+                    }
+
+                    return;
+                }
+
+                for (const auto& family : families)
+                {
+                    if (!m_state->FamiliesRead.emplace(Utility::FoldCase(std::string_view{ family })).second)
+                    {
+                        continue;
+                    }
+
+                    AICLI_LOG(Repo, Verbose, << "Reading MSIX packages for family " << family);
+
+                    std::set<std::string> existingKeys = GetKeysForMSIXFamily(index, family);
+                    PopulateIndexFromMSIXFamily(index, family, &m_state->Entries);
+                    m_state->Entries.RemoveUnseen(index, [&](const std::string& key, const std::string& stamp) { return IsMSIXStamp(stamp) && existingKeys.count(key) != 0; });
+                }
+            }
+
+            std::unique_ptr<State> m_state;
+        };
+
+        // Brings a tracked index up to date with the system, reading only the kinds of entries that may have changed.
+        // Returns true if the index was changed.
+        bool UpdateTrackedIndex(SQLiteIndex& index, bool readARP, bool readMSIX)
+        {
+            InstalledIndexEntries entries{ index };
+
+            if (readARP)
+            {
+                ARPHelper arpHelper;
+                arpHelper.PopulateIndexFromARP(index, { Manifest::ScopeEnum::Machine, Manifest::ScopeEnum::User }, &entries);
+            }
+
+            if (readMSIX)
+            {
+                PopulateIndexFromMSIX(index, &entries);
+            }
+
+            entries.RemoveUnseen(index, [&](const std::string&, const std::string& stamp) { return IsMSIXStamp(stamp) ? readMSIX : readARP; });
+            return entries.HasChanges();
+        }
+
+        // Keeps an index for each filter in memory, watching the ARP keys and the MSIX package catalog so that an index
+        // is only brought up to date when something has changed, and then only for the kind of entries that changed.
+        // Once enabled it lives for the rest of the process, as undoing the registrations during process exit is not safe.
+        struct InstalledSourceTracker
+        {
+            // Gets the tracker, or null if tracking is not enabled.
+            static InstalledSourceTracker* Get()
+            {
+                return s_instance.load();
+            }
+
+            static void Enable()
+            {
+                static std::once_flag s_enableOnce;
+                std::call_once(s_enableOnce, []()
+                    {
+                        AICLI_LOG(Repo, Info, << "Enabling change tracking for the installed source");
+                        s_instance = new InstalledSourceTracker();
+                    });
+            }
+
+            // Gets an in memory copy of the up to date index for the filter.
+            SQLiteIndex GetIndex(PredefinedInstalledSourceFactory::Filter filter, const std::filesystem::path& cachePath)
+            {
+                TrackedIndex& tracked = m_indices[static_cast<size_t>(filter)];
+                std::lock_guard<std::mutex> lock{ tracked.Lock };
+
+                // The flags are cleared before reading, so that a change during the read is picked up by the next one.
+                // Without a working notification, the entries are read every time like an untracked source.
+                bool readARP = filter != PredefinedInstalledSourceFactory::Filter::MSIX && (tracked.ARPChanged.exchange(false) || !m_arpWatched);
+                bool readMSIX = filter != PredefinedInstalledSourceFactory::Filter::ARP && (tracked.MSIXChanged.exchange(false) || !m_msixWatched);
+
+                if (!tracked.Index)
+                {
+                    tracked.Index.emplace(LoadInstalledSourceCache(cachePath));
+                }
+
+                if (readARP || readMSIX)
+                {
+                    AICLI_LOG(Repo, Info, << "Updating the tracked installed source [" << PredefinedInstalledSourceFactory::FilterToString(filter) <<
+                        "] with ARP [" << readARP << "] and MSIX [" << readMSIX << ']');
+
+                    try
+                    {
+                        if (UpdateTrackedIndex(tracked.Index.value(), readARP, readMSIX))
+                        {
+                            SaveInstalledSourceCache(tracked.Index.value(), cachePath);
+                        }
+                    }
+                    catch (...)
+                    {
+                        // The index may be partially updated, so read those entries again next time.
+                        tracked.ARPChanged = tracked.ARPChanged || readARP;
+                        tracked.MSIXChanged = tracked.MSIXChanged || readMSIX;
+                        throw;
+                    }
+                }
+
+                return tracked.Index->CopyToMemory();
+            }
+
+        private:
+            struct TrackedIndex
+            {
+                std::mutex Lock;
+                std::optional<SQLiteIndex> Index;
+                std::atomic_bool ARPChanged{ true };
+                std::atomic_bool MSIXChanged{ true };
+            };
+
+            // A registration for changes to one of the ARP keys.
+            struct ARPWatch
+            {
+                InstalledSourceTracker* Tracker = nullptr;
+                Registry::Key Key;
+                wil::unique_event Event;
+                wil::unique_threadpool_wait_nowait Wait;
+            };
+
+            InstalledSourceTracker()
+            {
+                try
+                {
+                    WatchARP();
+                    m_arpWatched = true;
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    AICLI_LOG(Repo, Warning, << "Failed to watch the ARP keys; they will be read every time the installed source is opened");
+                }
 
-                bool isPackageNameSet = false;
-                // Attempt to get the DisplayName. Since this will retrieve the localized value, it has a chance to fail.
-                // Rather than completely skip this package in that case, we will simply fall back to using the package name below.
                 try
                 {
-                    auto displayName = Utility::ConvertToUTF8(package.DisplayName());
-                    if (!displayName.empty())
+                    WatchMSIX();
+                    m_msixWatched = true;
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    AICLI_LOG(Repo, Warning, << "Failed to watch the MSIX package catalog; it will be read every time the installed source is opened");
+                }
+            }
+
+            void WatchARP()
+            {
+                ARPHelper arpHelper;
+
+                for (auto scope : { Manifest::ScopeEnum::Machine, Manifest::ScopeEnum::User })
+                {
+                    for (auto architecture : Utility::GetApplicableArchitectures())
                     {
-                        manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(displayName);
-                        isPackageNameSet = true;
+                        Registry::Key arpRootKey = arpHelper.GetARPKey(scope, architecture);
+                        if (!arpRootKey)
+                        {
+                            continue;
+                        }
+
+                        auto watch = std::make_unique<ARPWatch>();
+                        watch->Tracker = this;
+                        watch->Key = std::move(arpRootKey);
+                        watch->Event.create();
+                        watch->Wait.reset(CreateThreadpoolWait(&OnARPChanged, watch.get(), nullptr));
+                        THROW_LAST_ERROR_IF(!watch->Wait);
+
+                        watch->Key.NotifyOnChange(watch->Event.get());
+                        SetThreadpoolWait(watch->Wait.get(), watch->Event.get(), nullptr);
+
+                        m_arpWatches.emplace_back(std::move(watch));
                     }
                 }
-                catch (const winrt::hresult_error& hre)
+            }
+
+            static void CALLBACK OnARPChanged(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WAIT wait, TP_WAIT_RESULT)
+            {
+                ARPWatch* watch = static_cast<ARPWatch*>(context);
+                InstalledSourceTracker* tracker = watch->Tracker;
+
+                // Ask for the next change before marking the indices, so that no change can go unnoticed.
+                try
                 {
-                    AICLI_LOG(Repo, Info, << "winrt::hresult_error[0x" << Logging::SetHRFormat << hre.code() << ": " <<
-                        Utility::ConvertToUTF8(hre.message()) << "] exception thrown when getting DisplayName for " << familyName);
+                    watch->Key.NotifyOnChange(watch->Event.get());
+                    SetThreadpoolWait(wait, watch->Event.get(), nullptr);
                 }
                 catch (...)
                 {
-                    AICLI_LOG(Repo, Info, << "Unknown exception thrown when getting DisplayName for " << familyName);
+                    LOG_CAUGHT_EXCEPTION();
+                    AICLI_LOG(Repo, Warning, << "Failed to continue watching an ARP key; they will be read every time the installed source is opened");
+                    tracker->m_arpWatched = false;
                 }
 
-                if (!isPackageNameSet)
+                for (auto& tracked : tracker->m_indices)
                 {
-                    manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(Utility::ConvertToUTF8(packageId.Name()));
+                    tracked.ARPChanged = true;
                 }
+            }
 
-                std::ostringstream strstr;
-                auto packageVersion = packageId.Version();
-                strstr << packageVersion.Major << '.' << packageVersion.Minor << '.' << packageVersion.Build << '.' << packageVersion.Revision;
+            void WatchMSIX()
+            {
+                using namespace winrt::Windows::ApplicationModel;
 
-                manifest.Version = strstr.str();
-                
-                manifest.Installers[0].PackageFamilyName = familyName;
+                m_catalog = PackageCatalog::OpenForCurrentUser();
 
-                // Use the full name as a unique key for the path
-                auto manifestId = index.AddManifest(manifest, std::filesystem::path{ packageId.FullName().c_str() });
+                // Only a completed operation changes what is installed.
+                auto onChanged = [this](const auto&, const auto& args)
+                {
+                    if (args.IsComplete())
+                    {
+                        for (auto& tracked : m_indices)
+                        {
+                            tracked.MSIXChanged = true;
+                        }
+                    }
+                };
 
-                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, 
-                    Manifest::InstallerTypeToString(Manifest::InstallerTypeEnum::Msix));
+                m_packageInstalling = m_catalog.PackageInstalling(winrt::auto_revoke, onChanged);
+                m_packageUninstalling = m_catalog.PackageUninstalling(winrt::auto_revoke, onChanged);
+                m_packageUpdating = m_catalog.PackageUpdating(winrt::auto_revoke, onChanged);
             }
-        }
+
+            static std::atomic<InstalledSourceTracker*> s_instance;
+
+            // Indexed by the filter value.
+            std::array<TrackedIndex, 3> m_indices;
+            std::atomic_bool m_arpWatched{ false };
+            std::atomic_bool m_msixWatched{ false };
+            std::vector<std::unique_ptr<ARPWatch>> m_arpWatches;
+            winrt::Windows::ApplicationModel::PackageCatalog m_catalog = nullptr;
+            winrt::Windows::ApplicationModel::PackageCatalog::PackageInstalling_revoker m_packageInstalling;
+            winrt::Windows::ApplicationModel::PackageCatalog::PackageUninstalling_revoker m_packageUninstalling;
+            winrt::Windows::ApplicationModel::PackageCatalog::PackageUpdating_revoker m_packageUpdating;
+        };
+
+        std::atomic<InstalledSourceTracker*> InstalledSourceTracker::s_instance = nullptr;
 
         struct PredefinedInstalledSourceReference : public ISourceReference
         {
@@ -117,20 +617,50 @@ namespace AppInstaller::Repository::Microsoft
                 PredefinedInstalledSourceFactory::Filter filter = PredefinedInstalledSourceFactory::StringToFilter(m_details.Arg);
                 AICLI_LOG(Repo, Info, << "Creating PredefinedInstalledSource with filter [" << PredefinedInstalledSourceFactory::FilterToString(filter) << ']');
 
-                // Create an in memory index
-                SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
+                std::filesystem::path cachePath = GetInstalledSourceCachePath(filter);
+
+                // A tracked source is kept up to date in memory, so it only needs to be copied
+                if (auto tracker = InstalledSourceTracker::Get())
+                {
+                    return std::make_shared<SQLiteIndexSource>(m_details, tracker->GetIndex(filter, cachePath), Synchronization::CrossProcessReaderWriteLock{}, true);
+                }
+
+                // Start from an in memory copy of the cached index, and bring it up to date with the system
+                SQLiteIndex index = LoadInstalledSourceCache(cachePath);
+                InstalledIndexEntries entries{ index };
 
                 // Put installed packages into the index
                 if (filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::ARP)
                 {
                     ARPHelper arpHelper;
-                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::Machine);
-                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::User);
+                    arpHelper.PopulateIndexFromARP(index, { Manifest::ScopeEnum::Machine, Manifest::ScopeEnum::User }, &entries);
+                }
+
+                // With both kinds of entries, the MSIX entries are left as they were cached until a search needs them
+                bool lazyMSIX = (filter == PredefinedInstalledSourceFactory::Filter::None);
+
+                if (filter == PredefinedInstalledSourceFactory::Filter::MSIX)
+                {
+                    PopulateIndexFromMSIX(index, &entries);
+                }
+
+                if (lazyMSIX)
+                {
+                    entries.RemoveUnseen(index, [](const std::string&, const std::string& stamp) { return !IsMSIXStamp(stamp); });
+                }
+                else
+                {
+                    entries.RemoveUnseen(index);
+                }
+
+                if (entries.HasChanges())
+                {
+                    SaveInstalledSourceCache(index, cachePath);
                 }
 
-                if (filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::MSIX)
+                if (lazyMSIX)
                 {
-                    PopulateIndexFromMSIX(index);
+                    return std::make_shared<LazyMSIXInstalledSource>(m_details, std::move(index), std::move(entries), std::move(cachePath));
                 }
 
                 return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), Synchronization::CrossProcessReaderWriteLock{}, true);
@@ -205,4 +735,9 @@ namespace AppInstaller::Repository::Microsoft
     {
         return std::make_unique<Factory>();
     }
+
+    void PredefinedInstalledSourceFactory::EnableChangeTracking()
+    {
+        InstalledSourceTracker::Enable();
+    }
 }
@@ -37,5 +37,9 @@ namespace AppInstaller::Repository::Microsoft
 
         // Creates a source factory for this type.
         static std::unique_ptr<ISourceFactory> Create();
+
+        // Keeps the installed packages in memory for the rest of the process, watching the ARP keys and the MSIX package catalog
+        // so that opening the source only reads the entries that changed. Intended for long running processes like the COM server.
+        static void EnableChangeTracking();
     };
 }
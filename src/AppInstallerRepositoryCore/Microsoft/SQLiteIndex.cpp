@@ -3,12 +3,77 @@
 #include "pch.h"
 #include "SQLiteIndex.h"
 #include "Schema/MetadataTable.h"
+#include <AppInstallerSHA256.h>
 #include <winget/ManifestYamlParser.h>
+#include <winget/MemoryBudget.h>
+#include <winget/Performance.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
 
 namespace AppInstaller::Repository::Microsoft
 {
     namespace
     {
+        using namespace std::string_view_literals;
+
+        // Writeable indices are small and written a few rows at a time, so the log is checkpointed well before the SQLite default of 1000 pages.
+        constexpr uint32_t s_WriteAheadLogAutoCheckpointPages = 256;
+
+        // Writes to a shared index are short; wait for them rather than failing.
+        constexpr std::chrono::milliseconds s_WriteAheadLogBusyTimeout = std::chrono::seconds(10);
+
+        // Reads the manifests at the given paths, in parallel as reading them is the bulk of the work and is independent for each one.
+        std::vector<Manifest::Manifest> ReadManifestsInParallel(const std::vector<std::filesystem::path>& manifestPaths)
+        {
+            std::vector<Manifest::Manifest> result(manifestPaths.size());
+            std::vector<std::exception_ptr> failures(manifestPaths.size());
+            std::atomic<size_t> nextManifest = 0;
+
+            auto parseManifests = [&]()
+            {
+                for (size_t i = nextManifest++; i < manifestPaths.size(); i = nextManifest++)
+                {
+                    try
+                    {
+                        result[i] = Manifest::YamlParser::CreateFromPath(manifestPaths[i]);
+                    }
+                    catch (...)
+                    {
+                        failures[i] = std::current_exception();
+                    }
+                }
+            };
+
+            size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), manifestPaths.size());
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < threadCount; ++i)
+            {
+                threads.emplace_back(parseManifests);
+            }
+
+            parseManifests();
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            // Report the first failure in input order so that the result does not depend on thread scheduling.
+            for (size_t i = 0; i < failures.size(); ++i)
+            {
+                if (failures[i])
+                {
+                    AICLI_LOG(Repo, Error, << "Failed to read manifest from file [" << manifestPaths[i] << "]");
+                    std::rethrow_exception(failures[i]);
+                }
+            }
+
+            return result;
+        }
+
         char const* const GetOpenDispositionString(SQLiteIndex::OpenDisposition disposition)
         {
             switch (disposition)
@@ -19,10 +84,188 @@ namespace AppInstaller::Repository::Microsoft
                 return "ReadWrite";
             case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::Immutable:
                 return "ImmutableRead";
+            case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::ImmutableMapped:
+                return "ImmutableMappedRead";
             default:
                 return "Unknown";
             }
         }
+
+        // The delta format is:
+        //  Header
+        //      char[8]     magic
+        //      uint32_t    format version
+        //      uint32_t    block size
+        //      uint64_t    source size
+        //      uint64_t    target size
+        //      uint8_t[32] source SHA256
+        //      uint8_t[32] target SHA256
+        //      uint64_t    block count
+        //  For each block
+        //      uint64_t    block index in the target
+        //      uint8_t[]   block contents; the block size, or the remainder of the target for the last block
+        constexpr std::string_view s_SQLiteIndexDelta_Magic = "WGIDXDLT"sv;
+        constexpr uint32_t s_SQLiteIndexDelta_FormatVersion = 1;
+        // Matches the page size of packaged indices, so that a changed page affects only a single block.
+        constexpr uint32_t s_SQLiteIndexDelta_BlockSize = 4096;
+
+        template <typename T>
+        void WriteDeltaValue(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        T ReadDeltaValue(std::istream& stream)
+        {
+            T result{};
+            stream.read(reinterpret_cast<char*>(&result), sizeof(T));
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, stream.gcount() != sizeof(T));
+            return result;
+        }
+
+        Utility::SHA256::HashBuffer ReadDeltaHash(std::istream& stream)
+        {
+            Utility::SHA256::HashBuffer result(Utility::SHA256::HashBufferSizeInBytes);
+            stream.read(reinterpret_cast<char*>(result.data()), result.size());
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, static_cast<size_t>(stream.gcount()) != result.size());
+            return result;
+        }
+
+        Utility::SHA256::HashBuffer ComputeFileHash(const std::filesystem::path& file)
+        {
+            return Utility::SHA256::ComputeHashFromFile(file);
+        }
+
+        // Reads the block at the given index, returning the number of bytes read.
+        size_t ReadBlock(std::istream& stream, uint64_t fileSize, uint64_t blockIndex, std::vector<char>& buffer)
+        {
+            uint64_t offset = blockIndex * s_SQLiteIndexDelta_BlockSize;
+            if (offset >= fileSize)
+            {
+                return 0;
+            }
+
+            size_t size = static_cast<size_t>(std::min<uint64_t>(s_SQLiteIndexDelta_BlockSize, fileSize - offset));
+            stream.seekg(offset);
+            stream.read(buffer.data(), size);
+            THROW_HR_IF(E_UNEXPECTED, static_cast<size_t>(stream.gcount()) != size);
+            return size;
+        }
+    }
+
+    // Additional connections to an immutable index, used by reads that arrive while the primary connection is busy.
+    // The index cannot change, so every connection sees the same data.
+    struct SQLiteIndex::ReadConnectionPool
+    {
+        ReadConnectionPool(std::string target, SQLite::Connection::OpenFlags flags) :
+            m_target(std::move(target)), m_flags(flags), m_maximum(std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+        // A connection checked out of the pool; it is returned when this is destroyed.
+        struct Lease
+        {
+            Lease(ReadConnectionPool& pool, SQLite::Connection&& connection) : m_pool(pool), m_connection(std::move(connection)) {}
+
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+
+            Lease(Lease&&) = delete;
+            Lease& operator=(Lease&&) = delete;
+
+            ~Lease() { m_pool.Return(std::move(m_connection)); }
+
+            const SQLite::Connection& Get() const { return m_connection; }
+
+        private:
+            ReadConnectionPool& m_pool;
+            SQLite::Connection m_connection;
+        };
+
+        // Checks out an idle connection, opening a new one if under the limit, or waits for one to be returned.
+        Lease Acquire()
+        {
+            {
+                std::unique_lock<std::mutex> lock{ m_lock };
+                m_returned.wait(lock, [this]() { return !m_idle.empty() || m_opened < m_maximum; });
+
+                if (!m_idle.empty())
+                {
+                    SQLite::Connection connection = std::move(m_idle.back());
+                    m_idle.pop_back();
+                    return { *this, std::move(connection) };
+                }
+
+                ++m_opened;
+            }
+
+            try
+            {
+                return { *this, Open() };
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    --m_opened;
+                }
+                m_returned.notify_one();
+                throw;
+            }
+        }
+
+    private:
+        SQLite::Connection Open()
+        {
+            SQLite::Connection result = SQLite::Connection::Create(m_target, SQLite::Connection::OpenDisposition::ReadOnly, m_flags);
+            result.EnableICU();
+
+            auto cacheSizeLimit = Performance::GetSQLiteCacheSizeLimitInKB();
+            if (cacheSizeLimit)
+            {
+                result.SetCacheSizeLimit(*cacheSizeLimit);
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Opened additional read connection to index");
+            return result;
+        }
+
+        void Return(SQLite::Connection&& connection)
+        {
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                m_idle.emplace_back(std::move(connection));
+            }
+            m_returned.notify_one();
+        }
+
+        std::string m_target;
+        SQLite::Connection::OpenFlags m_flags;
+        size_t m_maximum;
+
+        std::mutex m_lock;
+        std::condition_variable m_returned;
+        std::vector<SQLite::Connection> m_idle;
+        size_t m_opened = 0;
+    };
+
+    template <typename F>
+    auto SQLiteIndex::ReadWithConnection(F&& f) const
+    {
+        std::unique_lock<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock, std::defer_lock };
+
+        // Prefer the primary connection when it is free, as it has the warmest caches.
+        if (m_readConnections && !lockInterface.try_lock())
+        {
+            auto lease = m_readConnections->Acquire();
+            return f(lease.Get());
+        }
+
+        if (!lockInterface.owns_lock())
+        {
+            lockInterface.lock();
+        }
+
+        return f(m_dbconn);
     }
 
     SQLiteIndex SQLiteIndex::CreateNew(const std::string& filePath, Schema::Version version, CreateOptions options)
@@ -45,8 +288,131 @@ namespace AppInstaller::Repository::Microsoft
         return result;
     }
 
+    void SQLiteIndex::CreateDelta(const std::filesystem::path& from, const std::filesystem::path& to, const std::filesystem::path& delta)
+    {
+        AICLI_LOG(Repo, Info, << "Creating SQLite Index delta from '" << from << "' to '" << to << "'");
+
+        uint64_t fromSize = std::filesystem::file_size(from);
+        uint64_t toSize = std::filesystem::file_size(to);
+
+        std::ifstream fromStream(from, std::ios_base::in | std::ios_base::binary);
+        THROW_LAST_ERROR_IF(fromStream.fail());
+        std::ifstream toStream(to, std::ios_base::in | std::ios_base::binary);
+        THROW_LAST_ERROR_IF(toStream.fail());
+
+        std::vector<char> fromBuffer(s_SQLiteIndexDelta_BlockSize);
+        std::vector<char> toBuffer(s_SQLiteIndexDelta_BlockSize);
+
+        // Find the blocks of the target that differ from the source.
+        std::vector<uint64_t> changedBlocks;
+        uint64_t blockCount = (toSize + s_SQLiteIndexDelta_BlockSize - 1) / s_SQLiteIndexDelta_BlockSize;
+
+        for (uint64_t i = 0; i < blockCount; ++i)
+        {
+            size_t toRead = ReadBlock(toStream, toSize, i, toBuffer);
+            size_t fromRead = ReadBlock(fromStream, fromSize, i, fromBuffer);
+
+            if (toRead != fromRead || !std::equal(toBuffer.begin(), toBuffer.begin() + toRead, fromBuffer.begin()))
+            {
+                changedBlocks.push_back(i);
+            }
+        }
+
+        std::ofstream deltaStream(delta, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        THROW_LAST_ERROR_IF(deltaStream.fail());
+
+        deltaStream.write(s_SQLiteIndexDelta_Magic.data(), s_SQLiteIndexDelta_Magic.size());
+        WriteDeltaValue(deltaStream, s_SQLiteIndexDelta_FormatVersion);
+        WriteDeltaValue(deltaStream, s_SQLiteIndexDelta_BlockSize);
+        WriteDeltaValue(deltaStream, fromSize);
+        WriteDeltaValue(deltaStream, toSize);
+
+        auto fromHash = ComputeFileHash(from);
+        deltaStream.write(reinterpret_cast<const char*>(fromHash.data()), fromHash.size());
+        auto toHash = ComputeFileHash(to);
+        deltaStream.write(reinterpret_cast<const char*>(toHash.data()), toHash.size());
+
+        WriteDeltaValue(deltaStream, static_cast<uint64_t>(changedBlocks.size()));
+
+        for (uint64_t block : changedBlocks)
+        {
+            size_t toRead = ReadBlock(toStream, toSize, block, toBuffer);
+            WriteDeltaValue(deltaStream, block);
+            deltaStream.write(toBuffer.data(), toRead);
+        }
+
+        deltaStream.flush();
+        THROW_HR_IF(E_FAIL, deltaStream.fail());
+
+        AICLI_LOG(Repo, Info, << "Delta contains " << changedBlocks.size() << " of " << blockCount << " blocks");
+    }
+
+    void SQLiteIndex::ApplyDelta(const std::filesystem::path& from, const std::filesystem::path& delta, const std::filesystem::path& to)
+    {
+        AICLI_LOG(Repo, Info, << "Applying SQLite Index delta '" << delta << "' to '" << from << "'");
+
+        std::ifstream deltaStream(delta, std::ios_base::in | std::ios_base::binary);
+        THROW_LAST_ERROR_IF(deltaStream.fail());
+
+        char magic[s_SQLiteIndexDelta_Magic.size()]{};
+        deltaStream.read(magic, sizeof(magic));
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, std::string_view(magic, static_cast<size_t>(deltaStream.gcount())) != s_SQLiteIndexDelta_Magic);
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, ReadDeltaValue<uint32_t>(deltaStream) != s_SQLiteIndexDelta_FormatVersion);
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, ReadDeltaValue<uint32_t>(deltaStream) != s_SQLiteIndexDelta_BlockSize);
+
+        uint64_t fromSize = ReadDeltaValue<uint64_t>(deltaStream);
+        uint64_t toSize = ReadDeltaValue<uint64_t>(deltaStream);
+        auto fromHash = ReadDeltaHash(deltaStream);
+        auto toHash = ReadDeltaHash(deltaStream);
+
+        if (std::filesystem::file_size(from) != fromSize || !Utility::SHA256::AreEqual(fromHash, ComputeFileHash(from)))
+        {
+            AICLI_LOG(Repo, Info, << "Delta was not created from the current index");
+            THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+        }
+
+        std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(to, toSize);
+
+        auto removeTarget = wil::scope_exit([&]() { std::error_code ec; std::filesystem::remove(to, ec); });
+
+        {
+            std::fstream toStream(to, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+            THROW_LAST_ERROR_IF(toStream.fail());
+
+            std::vector<char> buffer(s_SQLiteIndexDelta_BlockSize);
+            uint64_t blockCount = ReadDeltaValue<uint64_t>(deltaStream);
+
+            for (uint64_t i = 0; i < blockCount; ++i)
+            {
+                uint64_t block = ReadDeltaValue<uint64_t>(deltaStream);
+                uint64_t offset = block * s_SQLiteIndexDelta_BlockSize;
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, offset >= toSize);
+
+                size_t size = static_cast<size_t>(std::min<uint64_t>(s_SQLiteIndexDelta_BlockSize, toSize - offset));
+                deltaStream.read(buffer.data(), size);
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, static_cast<size_t>(deltaStream.gcount()) != size);
+
+                toStream.seekp(offset);
+                toStream.write(buffer.data(), size);
+            }
+
+            toStream.flush();
+            THROW_HR_IF(E_FAIL, toStream.fail());
+        }
+
+        if (!Utility::SHA256::AreEqual(toHash, ComputeFileHash(to)))
+        {
+            AICLI_LOG(Repo, Info, << "Result of applying the delta does not match the expected index");
+            THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+        }
+
+        removeTarget.release();
+    }
+
     SQLiteIndex SQLiteIndex::Open(const std::string& filePath, OpenDisposition disposition)
     {
+        Performance::ScopedTimer timer{ "SQLiteIndex::Open" };
         AICLI_LOG(Repo, Info, << "Opening SQLite Index for " << GetOpenDispositionString(disposition) << " at '" << filePath << "'");
         switch (disposition)
         {
@@ -55,6 +421,7 @@ namespace AppInstaller::Repository::Microsoft
         case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::ReadWrite:
             return { filePath, SQLite::Connection::OpenDisposition::ReadWrite, SQLite::Connection::OpenFlags::None };
         case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::Immutable:
+        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::ImmutableMapped:
         {
             // Following the algorithm set forth at https://sqlite.org/uri.html [3.1] to convert to a URI path
             // The execution order builds out the string so that it shouldn't require any moves (other than growing)
@@ -99,17 +466,66 @@ namespace AppInstaller::Repository::Microsoft
 
             target += "?immutable=1";
 
-            return { target, SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri };
+            SQLite::Connection::OpenFlags flags = SQLite::Connection::OpenFlags::Uri;
+            if (disposition == OpenDisposition::ImmutableMapped)
+            {
+                flags |= SQLite::Connection::OpenFlags::ReadOnlyMapped;
+            }
+
+            SQLiteIndex result{ target, SQLite::Connection::OpenDisposition::ReadOnly, flags };
+            result.m_readConnections = std::make_shared<ReadConnectionPool>(target, flags);
+            return result;
         }
         default:
             THROW_HR(E_UNEXPECTED);
         }
     }
 
+    SQLiteIndex SQLiteIndex::OpenInMemoryCopy(const std::string& filePath)
+    {
+        AICLI_LOG(Repo, Info, << "Opening in memory copy of SQLite Index at '" << filePath << "'");
+
+        SQLite::Connection memory = SQLite::Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, SQLite::Connection::OpenDisposition::Create);
+
+        {
+            SQLite::Connection file = SQLite::Connection::Create(filePath, SQLite::Connection::OpenDisposition::ReadOnly);
+            file.CopyTo(memory);
+        }
+
+        return SQLiteIndex{ std::move(memory) };
+    }
+
+    void SQLiteIndex::CopyTo(const std::string& filePath) const
+    {
+        AICLI_LOG(Repo, Info, << "Copying SQLite Index to '" << filePath << "'");
+
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+
+        SQLite::Connection file = SQLite::Connection::Create(filePath, SQLite::Connection::OpenDisposition::Create);
+        m_dbconn.CopyTo(file);
+    }
+
+    SQLiteIndex SQLiteIndex::CopyToMemory() const
+    {
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+
+        SQLite::Connection memory = SQLite::Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, SQLite::Connection::OpenDisposition::Create);
+        m_dbconn.CopyTo(memory);
+
+        return SQLiteIndex{ std::move(memory) };
+    }
+
     SQLiteIndex::SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags) :
         m_dbconn(SQLite::Connection::Create(target, disposition, flags))
     {
         m_dbconn.EnableICU();
+
+        auto cacheSizeLimit = Performance::GetSQLiteCacheSizeLimitInKB();
+        if (cacheSizeLimit)
+        {
+            m_dbconn.SetCacheSizeLimit(*cacheSizeLimit);
+        }
+
         m_version = Schema::Version::GetSchemaVersion(m_dbconn);
         AICLI_LOG(Repo, Info, << "Opened SQLite Index with version [" << m_version << "], last write [" << GetLastWriteTime() << "]");
         m_interface = m_version.CreateISQLiteIndex();
@@ -124,6 +540,15 @@ namespace AppInstaller::Repository::Microsoft
         m_version = m_interface->GetVersion();
     }
 
+    SQLiteIndex::SQLiteIndex(SQLite::Connection&& connection) :
+        m_dbconn(std::move(connection))
+    {
+        m_dbconn.EnableICU();
+        m_version = Schema::Version::GetSchemaVersion(m_dbconn);
+        AICLI_LOG(Repo, Info, << "Opened SQLite Index with version [" << m_version << "], last write [" << GetLastWriteTime() << "]");
+        m_interface = m_version.CreateISQLiteIndex();
+    }
+
 #ifndef AICLI_DISABLE_TEST_HOOKS
     void SQLiteIndex::ForceVersion(const Schema::Version& version)
     {
@@ -136,7 +561,7 @@ namespace AppInstaller::Repository::Microsoft
         AICLI_LOG(Repo, Verbose, << "Adding manifest from file [" << manifestPath << "]");
 
         Manifest::Manifest manifest = Manifest::YamlParser::CreateFromPath(manifestPath);
-        return AddManifestInternal(manifest, relativePath);
+        return AddManifestInternal(manifest, relativePath, manifestPath);
     }
 
     SQLiteIndex::IdType SQLiteIndex::AddManifest(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
@@ -149,14 +574,120 @@ namespace AppInstaller::Repository::Microsoft
         return AddManifestInternal(manifest, {});
     }
 
-    SQLiteIndex::IdType SQLiteIndex::AddManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    std::vector<SQLiteIndex::IdType> SQLiteIndex::AddManifests(const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& manifests)
+    {
+        AICLI_LOG(Repo, Info, << "Adding " << manifests.size() << " manifests");
+
+        std::vector<std::filesystem::path> manifestPaths;
+        manifestPaths.reserve(manifests.size());
+        for (const auto& manifest : manifests)
+        {
+            manifestPaths.emplace_back(manifest.first);
+        }
+
+        std::vector<Manifest::Manifest> parsedManifests = ReadManifestsInParallel(manifestPaths);
+
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "sqliteindex_addmanifests");
+
+        std::vector<IdType> result;
+        result.reserve(manifests.size());
+
+        for (size_t i = 0; i < manifests.size(); ++i)
+        {
+            AICLI_LOG(Repo, Verbose, << "Adding manifest for [" << parsedManifests[i].Id << ", " << parsedManifests[i].Version << "] at relative path [" << manifests[i].second << "]");
+            result.emplace_back(m_interface->AddManifest(m_dbconn, parsedManifests[i], manifests[i].second));
+            SetManifestContentFromFile(result.back(), manifests[i].first);
+        }
+
+        SetLastWriteTime();
+
+        savepoint.Commit();
+
+        return result;
+    }
+
+    bool SQLiteIndex::ApplyManifestChanges(const std::vector<ManifestChange>& changes)
+    {
+        AICLI_LOG(Repo, Info, << "Applying " << changes.size() << " manifest changes");
+
+        std::vector<std::filesystem::path> manifestPaths;
+        for (const auto& change : changes)
+        {
+            if (change.Type != ManifestChangeType::Removed)
+            {
+                manifestPaths.emplace_back(change.ManifestPath);
+            }
+        }
+
+        std::vector<Manifest::Manifest> parsedManifests = ReadManifestsInParallel(manifestPaths);
+
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "sqliteindex_applymanifestchanges");
+        bool result = false;
+
+        for (const auto& change : changes)
+        {
+            if (change.Type == ManifestChangeType::Removed)
+            {
+                AICLI_LOG(Repo, Verbose, << "Removing manifest at relative path [" << change.RelativePath << "]");
+
+                auto manifestId = m_interface->GetManifestIdByRelativePath(m_dbconn, change.RelativePath);
+                THROW_HR_IF_MSG(E_NOT_SET, !manifestId, "No manifest at relative path [%ls]", change.RelativePath.c_str());
+
+                m_interface->RemoveManifestById(m_dbconn, manifestId.value());
+                result = true;
+            }
+        }
+
+        size_t parsedIndex = 0;
+        for (const auto& change : changes)
+        {
+            if (change.Type == ManifestChangeType::Removed)
+            {
+                continue;
+            }
+
+            const Manifest::Manifest& manifest = parsedManifests[parsedIndex++];
+
+            if (change.Type == ManifestChangeType::Added)
+            {
+                AICLI_LOG(Repo, Verbose, << "Adding manifest for [" << manifest.Id << ", " << manifest.Version << "] at relative path [" << change.RelativePath << "]");
+                IdType manifestId = m_interface->AddManifest(m_dbconn, manifest, change.RelativePath);
+                SetManifestContentFromFile(manifestId, change.ManifestPath);
+                result = true;
+            }
+            else if (!IsManifestUnchanged(manifest, change.RelativePath))
+            {
+                AICLI_LOG(Repo, Verbose, << "Updating manifest for [" << manifest.Id << ", " << manifest.Version << "] at relative path [" << change.RelativePath << "]");
+                auto [modified, manifestId] = m_interface->UpdateManifest(m_dbconn, manifest, change.RelativePath);
+                SetManifestContentFromFile(manifestId, change.ManifestPath);
+                result = modified || result;
+            }
+        }
+
+        if (result)
+        {
+            SetLastWriteTime();
+
+            savepoint.Commit();
+        }
+
+        return result;
+    }
+
+    SQLiteIndex::IdType SQLiteIndex::AddManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath, const std::filesystem::path& manifestPath)
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        Performance::ScopedTimer timer{ "SQLiteIndex::AddManifest" };
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         AICLI_LOG(Repo, Verbose, << "Adding manifest for [" << manifest.Id << ", " << manifest.Version << "] at relative path [" << relativePath.value_or("") << "]");
 
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "sqliteindex_addmanifest");
 
         IdType result = m_interface->AddManifest(m_dbconn, manifest, relativePath);
+        SetManifestContentFromFile(result, manifestPath);
 
         SetLastWriteTime();
 
@@ -170,7 +701,7 @@ namespace AppInstaller::Repository::Microsoft
         AICLI_LOG(Repo, Verbose, << "Updating manifest from file [" << manifestPath << "]");
 
         Manifest::Manifest manifest = Manifest::YamlParser::CreateFromPath(manifestPath);
-        return UpdateManifestInternal(manifest, relativePath);
+        return UpdateManifestInternal(manifest, relativePath, manifestPath);
     }
 
     bool SQLiteIndex::UpdateManifest(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
@@ -183,14 +714,23 @@ namespace AppInstaller::Repository::Microsoft
         return UpdateManifestInternal(manifest, {});
     }
 
-    bool SQLiteIndex::UpdateManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    bool SQLiteIndex::UpdateManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath, const std::filesystem::path& manifestPath)
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        Performance::ScopedTimer timer{ "SQLiteIndex::UpdateManifest" };
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         AICLI_LOG(Repo, Verbose, << "Updating manifest for [" << manifest.Id << ", " << manifest.Version << "] at relative path [" << relativePath.value_or("") << "]");
 
+        // There is nothing to update when the same content is already at the same path.
+        // This lets a publishing pipeline pass every manifest in a change without first working out which ones changed.
+        if (IsManifestUnchanged(manifest, relativePath))
+        {
+            return false;
+        }
+
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "sqliteindex_updatemanifest");
 
-        bool result = m_interface->UpdateManifest(m_dbconn, manifest, relativePath).first;
+        auto [result, manifestId] = m_interface->UpdateManifest(m_dbconn, manifest, relativePath);
+        SetManifestContentFromFile(manifestId, manifestPath);
 
         if (result)
         {
@@ -202,6 +742,43 @@ namespace AppInstaller::Repository::Microsoft
         return result;
     }
 
+    void SQLiteIndex::SetManifestContentFromFile(IdType manifestId, const std::filesystem::path& manifestPath)
+    {
+        // A manifest read from a directory is merged from several files, none of which is the whole manifest.
+        if (manifestPath.empty() || !std::filesystem::is_regular_file(manifestPath) || !m_interface->IsManifestContentSupported(m_dbconn))
+        {
+            return;
+        }
+
+        std::ifstream stream(manifestPath, std::ios_base::in | std::ios_base::binary);
+        THROW_LAST_ERROR_IF(stream.fail());
+
+        m_interface->SetManifestContentById(m_dbconn, manifestId, Utility::ReadEntireStream(stream));
+    }
+
+    bool SQLiteIndex::IsManifestUnchanged(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) const
+    {
+        if (!relativePath || manifest.StreamSha256.empty())
+        {
+            return false;
+        }
+
+        auto manifestId = m_interface->GetManifestIdByHash(m_dbconn, manifest.StreamSha256);
+        if (!manifestId)
+        {
+            return false;
+        }
+
+        auto existingPath = m_interface->GetPropertyByManifestId(m_dbconn, manifestId.value(), PackageVersionProperty::RelativePath);
+        if (existingPath && std::filesystem::path{ Utility::ConvertToUTF16(existingPath.value()) } == relativePath.value())
+        {
+            AICLI_LOG(Repo, Verbose, << "Manifest content and path are unchanged");
+            return true;
+        }
+
+        return false;
+    }
+
     void SQLiteIndex::RemoveManifest(const std::filesystem::path& manifestPath, const std::filesystem::path& relativePath)
     {
         AICLI_LOG(Repo, Verbose, << "Removing manifest from file [" << manifestPath << "]");
@@ -218,7 +795,7 @@ namespace AppInstaller::Repository::Microsoft
 
     void SQLiteIndex::RemoveManifest(const Manifest::Manifest& manifest)
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "sqliteindex_removemanifest");
 
         m_interface->RemoveManifest(m_dbconn, manifest);
@@ -239,9 +816,20 @@ namespace AppInstaller::Repository::Microsoft
         savepoint.Commit();
     }
 
+    SQLite::Savepoint SQLiteIndex::CreateSavepoint(std::string name)
+    {
+        return SQLite::Savepoint::Create(m_dbconn, std::move(name));
+    }
+
+    bool SQLiteIndex::EnableConcurrentReaders()
+    {
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+        return m_dbconn.EnableWriteAheadLogging(s_WriteAheadLogAutoCheckpointPages, s_WriteAheadLogBusyTimeout);
+    }
+
     void SQLiteIndex::PrepareForPackaging()
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         AICLI_LOG(Repo, Info, << "Preparing index for packaging");
 
         m_interface->PrepareForPackaging(m_dbconn);
@@ -249,10 +837,108 @@ namespace AppInstaller::Repository::Microsoft
 
     bool SQLiteIndex::CheckConsistency(bool log) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        std::vector<ConsistencyCheckResult> results;
+        return CheckConsistency(log, results);
+    }
+
+    bool SQLiteIndex::CheckConsistency(bool log, std::vector<ConsistencyCheckResult>& results) const
+    {
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         AICLI_LOG(Repo, Info, << "Checking index consistency...");
 
-        bool result = m_interface->CheckConsistency(m_dbconn, log);
+        std::vector<Schema::ISQLiteIndex::ConsistencyCheck> checks = m_interface->GetConsistencyChecks();
+        std::vector<std::optional<ConsistencyCheckResult>> checkResults(checks.size());
+        std::vector<std::exception_ptr> failures(checks.size());
+        std::atomic<size_t> nextCheck = 0;
+        std::atomic<bool> inconsistent = false;
+
+        auto runChecks = [&](const SQLite::Connection& connection)
+        {
+            for (size_t i = nextCheck++; i < checks.size(); i = nextCheck++)
+            {
+                // As with a single connection, stop at the first inconsistency unless everything is to be logged
+                if (!log && inconsistent)
+                {
+                    continue;
+                }
+
+                try
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    bool consistent = checks[i].Check(connection, log);
+                    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+                    checkResults[i] = ConsistencyCheckResult{ checks[i].Name, consistent, duration };
+
+                    if (!consistent)
+                    {
+                        inconsistent = true;
+                    }
+                }
+                catch (...)
+                {
+                    failures[i] = std::current_exception();
+                }
+            }
+        };
+
+        // Other connections only see committed changes, and there is nothing to connect to for an in-memory index.
+        std::string filePath = m_dbconn.GetFilePath();
+        size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), checks.size());
+
+        if (filePath.empty() || m_dbconn.IsInTransaction())
+        {
+            threadCount = 1;
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back([&]()
+                {
+                    try
+                    {
+                        SQLite::Connection connection = SQLite::Connection::Create(filePath, SQLite::Connection::OpenDisposition::ReadOnly);
+                        connection.EnableICU();
+                        runChecks(connection);
+                    }
+                    catch (...)
+                    {
+                        // The remaining checks are left to the other connections
+                        LOG_CAUGHT_EXCEPTION_MSG("Failed to open a connection for consistency checks");
+                    }
+                });
+        }
+
+        runChecks(m_dbconn);
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        // Report in the order of the checks so that the result does not depend on thread scheduling.
+        for (size_t i = 0; i < failures.size(); ++i)
+        {
+            if (failures[i])
+            {
+                AICLI_LOG(Repo, Error, << "Consistency check failed to run: " << checks[i].Name);
+                std::rethrow_exception(failures[i]);
+            }
+        }
+
+        results.clear();
+        bool result = true;
+
+        for (const auto& checkResult : checkResults)
+        {
+            if (checkResult)
+            {
+                AICLI_LOG(Repo, Info, << "  " << checkResult->Name << (checkResult->Consistent ? " was" : " was NOT") << " consistent [" << checkResult->Duration.count() << " ms]");
+                result = result && checkResult->Consistent;
+                results.emplace_back(*checkResult);
+            }
+        }
 
         AICLI_LOG(Repo, Info, << "...index *WAS" << (result ? "*" : " NOT*") << " consistent.");
 
@@ -261,28 +947,28 @@ namespace AppInstaller::Repository::Microsoft
 
     Schema::ISQLiteIndex::SearchResult SQLiteIndex::Search(const SearchRequest& request) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        Performance::ScopedTimer timer{ "SQLiteIndex::Search" };
         AICLI_LOG(Repo, Verbose, << "Performing search: " << request.ToString());
 
-        return m_interface->Search(m_dbconn, request);
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->Search(connection, request); });
     }
 
     std::optional<std::string> SQLiteIndex::GetPropertyByManifestId(IdType manifestId, PackageVersionProperty property) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
-        return m_interface->GetPropertyByManifestId(m_dbconn, manifestId, property);
+        Performance::ScopedTimer timer{ "SQLiteIndex::GetPropertyByManifestId" };
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetPropertyByManifestId(connection, manifestId, property); });
     }
 
     std::vector<std::string> SQLiteIndex::GetMultiPropertyByManifestId(IdType manifestId, PackageVersionMultiProperty property) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
-        return m_interface->GetMultiPropertyByManifestId(m_dbconn, manifestId, property);
+        Performance::ScopedTimer timer{ "SQLiteIndex::GetMultiPropertyByManifestId" };
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetMultiPropertyByManifestId(connection, manifestId, property); });
     }
 
     std::optional<SQLiteIndex::IdType> SQLiteIndex::GetManifestIdByKey(IdType id, std::string_view version, std::string_view channel) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
-        return m_interface->GetManifestIdByKey(m_dbconn, id, version, channel);
+        Performance::ScopedTimer timer{ "SQLiteIndex::GetManifestIdByKey" };
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetManifestIdByKey(connection, id, version, channel); });
     }
 
     std::optional<SQLiteIndex::IdType> SQLiteIndex::GetManifestIdByManifest(const Manifest::Manifest& manifest) const
@@ -290,27 +976,50 @@ namespace AppInstaller::Repository::Microsoft
         return m_interface->GetManifestIdByManifest(m_dbconn, manifest);
     }
 
+    std::optional<SQLiteIndex::IdType> SQLiteIndex::GetManifestIdByHash(const SQLite::blob_t& hash) const
+    {
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+        return m_interface->GetManifestIdByHash(m_dbconn, hash);
+    }
+
     std::vector<Utility::VersionAndChannel> SQLiteIndex::GetVersionKeysById(IdType id) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
-        return m_interface->GetVersionKeysById(m_dbconn, id);
+        Performance::ScopedTimer timer{ "SQLiteIndex::GetVersionKeysById" };
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetVersionKeysById(connection, id); });
+    }
+
+    SQLiteIndex::PropertiesResult SQLiteIndex::GetPropertiesByManifestIds(const std::vector<IdType>& manifestIds, const std::set<PackageVersionProperty>& properties) const
+    {
+        Performance::ScopedTimer timer{ "SQLiteIndex::GetPropertiesByManifestIds" };
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetPropertiesByManifestIds(connection, manifestIds, properties); });
     }
 
     SQLiteIndex::MetadataResult SQLiteIndex::GetMetadataByManifestId(SQLite::rowid_t manifestId) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
-        return m_interface->GetMetadataByManifestId(m_dbconn, manifestId);
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetMetadataByManifestId(connection, manifestId); });
     }
 
     void SQLiteIndex::SetMetadataByManifestId(IdType manifestId, PackageVersionMetadata metadata, std::string_view value)
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         m_interface->SetMetadataByManifestId(m_dbconn, manifestId, metadata, value);
     }
 
+    std::optional<std::string> SQLiteIndex::GetManifestContentById(IdType manifestId) const
+    {
+        Performance::ScopedTimer timer{ "SQLiteIndex::GetManifestContentById" };
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetManifestContentById(connection, manifestId); });
+    }
+
+    void SQLiteIndex::SetManifestContentVersions(uint32_t versions)
+    {
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
+        m_interface->SetManifestContentVersions(m_dbconn, versions);
+    }
+
     Utility::NormalizedName SQLiteIndex::NormalizeName(std::string_view name, std::string_view publisher) const
     {
-        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        std::lock_guard<Performance::Counters::CountedMutex> lockInterface{ *m_interfaceLock };
         return m_interface->NormalizeName(name, publisher);
     }
 
@@ -324,6 +1033,21 @@ namespace AppInstaller::Repository::Microsoft
         return m_interface->GetDependentsById(m_dbconn, packageId);
     }
 
+    std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> SQLiteIndex::GetDependencyClosureByManifestRowId(SQLite::rowid_t manifestRowId) const
+    {
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetDependencyClosureByManifestRowId(connection, manifestRowId); });
+    }
+
+    std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> SQLiteIndex::GetDependentClosureById(AppInstaller::Manifest::string_t packageId) const
+    {
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetDependentClosureById(connection, packageId); });
+    }
+
+    Schema::ISQLiteIndex::DependencySnapshot SQLiteIndex::GetDependencySnapshot() const
+    {
+        return ReadWithConnection([&](const SQLite::Connection& connection) { return m_interface->GetDependencySnapshot(connection); });
+    }
+
     // Recording last write time based on MSDN documentation stating that time returns a POSIX epoch time and thus
     // should be consistent across systems.
     void SQLiteIndex::SetLastWriteTime()
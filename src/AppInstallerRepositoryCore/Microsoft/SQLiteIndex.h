@@ -9,6 +9,7 @@
 #include <AppInstallerVersions.h>
 #include <winget/Manifest.h>
 #include <winget/NameNormalization.h>
+#include <winget/PerformanceCounters.h>
 
 #include <chrono>
 #include <filesystem>
@@ -33,6 +34,9 @@ namespace AppInstaller::Repository::Microsoft
         // The return type of GetMetadataByManifestId
         using MetadataResult = Schema::ISQLiteIndex::MetadataResult;
 
+        // The return type of GetPropertiesByManifestIds
+        using PropertiesResult = Schema::ISQLiteIndex::PropertiesResult;
+
         // Options for creating a new index.
         using CreateOptions = Schema::ISQLiteIndex::CreateOptions;
 
@@ -54,11 +58,34 @@ namespace AppInstaller::Repository::Microsoft
             ReadWrite,
             // The database will not change while in use; open for immutable read.
             Immutable,
+            // The database will not change while in use; open for immutable read through a memory mapping.
+            // Intended for indices that are only ever read, where file I/O dominates the cost of opening.
+            ImmutableMapped,
         };
 
         // Opens an existing index database.
         static SQLiteIndex Open(const std::string& filePath, OpenDisposition disposition);
 
+        // Opens an existing index database as an in memory copy; changes to the copy are not written to the file.
+        static SQLiteIndex OpenInMemoryCopy(const std::string& filePath);
+
+        // Writes the entire index to the given database file, replacing any existing contents.
+        void CopyTo(const std::string& filePath) const;
+
+        // Creates an in memory copy of the index; changes to the copy do not affect this index.
+        SQLiteIndex CopyToMemory() const;
+
+        // Creates a delta that transforms the index file at `from` into the index file at `to`.
+        // The delta is a list of the fixed size blocks that differ between the files, so it is most effective
+        // for indices that were both prepared for packaging. Packaging rebuilds each table contiguously, so the blocks of tables
+        // that did not change (such as the dependencies or metadata when only names changed) are not part of the delta.
+        static void CreateDelta(const std::filesystem::path& from, const std::filesystem::path& to, const std::filesystem::path& delta);
+
+        // Applies a delta created by CreateDelta to the index file at `from`, writing the result to `to`.
+        // Throws APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE if the delta was not created from the same
+        // file, or if the result does not match the file that it was created for.
+        static void ApplyDelta(const std::filesystem::path& from, const std::filesystem::path& delta, const std::filesystem::path& to);
+
         // Gets the schema version of the index.
         Schema::Version GetVersion() const { return m_version; }
 
@@ -86,12 +113,43 @@ namespace AppInstaller::Repository::Microsoft
         // Returns the manifest id.
         IdType AddManifest(const Manifest::Manifest& manifest);
 
+        // Adds the manifests at the given paths, with their repository relative paths, to the index.
+        // The manifests are parsed and validated in parallel, then inserted within a single transaction.
+        // If the function succeeds, all of the manifests have been added; if it fails, none have.
+        // Returns the manifest ids, in the same order as the input.
+        std::vector<IdType> AddManifests(const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& manifests);
+
+        // The type of change made to a manifest file in the repository.
+        enum class ManifestChangeType
+        {
+            Added,
+            Modified,
+            Removed,
+        };
+
+        // A change made to a manifest file in the repository, such as one reported by `git diff --name-status`.
+        struct ManifestChange
+        {
+            ManifestChangeType Type = ManifestChangeType::Added;
+            // The file to read the manifest from; not used for a removed manifest, as the file no longer exists.
+            std::filesystem::path ManifestPath;
+            std::filesystem::path RelativePath;
+        };
+
+        // Applies the changes made to the manifest files in the repository to the index.
+        // The added and modified manifests are parsed and validated in parallel, then all of the changes are made within a single transaction.
+        // Removed manifests are found by their relative path, and are removed first so that a manifest can be moved by removing and adding it.
+        // If the function succeeds, all of the changes have been made; if it fails, none have.
+        // The return value indicates whether the index was modified by the function.
+        bool ApplyManifestChanges(const std::vector<ManifestChange>& changes);
+
         // Updates the manifest with matching { Id, Version, Channel } in the index.
         // The return value indicates whether the index was modified by the function.
         bool UpdateManifest(const std::filesystem::path& manifestPath, const std::filesystem::path& relativePath);
 
         // Updates the manifest with matching { Id, Version, Channel } in the index.
         // The return value indicates whether the index was modified by the function.
+        // A manifest whose stream hash and relative path match those already in the index is not modified.
         bool UpdateManifest(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath);
 
         // Updates the manifest with matching { Id, Version, Channel } in the index.
@@ -110,13 +168,33 @@ namespace AppInstaller::Repository::Microsoft
         // Removes the manifest with the given id.
         void RemoveManifestById(IdType manifestId);
 
+        // Creates a savepoint on the index; changes made until it is committed are all applied, or none are.
+        // Grouping many changes in one savepoint avoids the cost of committing each of them separately.
+        SQLite::Savepoint CreateSavepoint(std::string name);
+
+        // Uses write-ahead logging for the index, so that other connections can read it while this one writes.
+        // Intended for writeable indices that are shared between installs; returns false if the index does not support it.
+        bool EnableConcurrentReaders();
+
         // Removes data that is no longer needed for an index that is to be published.
         void PrepareForPackaging();
 
+        // The outcome of one of the checks of CheckConsistency.
+        struct ConsistencyCheckResult
+        {
+            std::string Name;
+            bool Consistent = false;
+            std::chrono::milliseconds Duration{};
+        };
+
         // Checks the consistency of the index to ensure that every referenced row exists.
         // Returns true if index is consistent; false if it is not.
         bool CheckConsistency(bool log = false) const;
 
+        // Checks the consistency of the index, and gets the outcome of each of the checks that was run.
+        // For an index file with no pending changes, the checks run at the same time on separate read only connections.
+        bool CheckConsistency(bool log, std::vector<ConsistencyCheckResult>& results) const;
+
         // Performs a search based on the given criteria.
         SearchResult Search(const SearchRequest& request) const;
 
@@ -133,15 +211,30 @@ namespace AppInstaller::Repository::Microsoft
         // Gets the manifest id for the given manifest, if present.
         std::optional<IdType> GetManifestIdByManifest(const Manifest::Manifest& manifest) const;
 
+        // Gets the manifest id for the given manifest stream hash, if present.
+        // Returns an empty value if the index does not have the hashes indexed, in which case GetManifestIdByManifest should be used.
+        std::optional<IdType> GetManifestIdByHash(const SQLite::blob_t& hash) const;
+
         // Gets all versions and channels for the given id.
         std::vector<Utility::VersionAndChannel> GetVersionKeysById(IdType id) const;
 
+        // Gets the strings for the given properties of all of the given manifest ids, in as few queries as possible.
+        // Manifest ids that are not present in the index are not present in the result.
+        PropertiesResult GetPropertiesByManifestIds(const std::vector<IdType>& manifestIds, const std::set<PackageVersionProperty>& properties) const;
+
         // Gets the string for the given metadata and manifest id, if present.
         MetadataResult GetMetadataByManifestId(SQLite::rowid_t manifestId) const;
 
         // Sets the string for the given metadata and manifest id.
         void SetMetadataByManifestId(IdType manifestId, PackageVersionMetadata metadata, std::string_view value);
 
+        // Gets the content of the manifest file for the given manifest id, if the index stores it.
+        std::optional<std::string> GetManifestContentById(IdType manifestId) const;
+
+        // Sets the number of the highest versions of each package whose manifest content is kept by PrepareForPackaging.
+        // Only valid for an index created with CreateOptions::ManifestContentSupport.
+        void SetManifestContentVersions(uint32_t versions);
+
         // Normalizes a name using the internal rules used by the index.
         // Largely a utility function; should not be used to do work on behalf of the index by the caller.
         Utility::NormalizedName NormalizeName(std::string_view name, std::string_view publisher) const;
@@ -149,6 +242,13 @@ namespace AppInstaller::Repository::Microsoft
         // Get all the dependencies for a specific manifest.
         std::set<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependenciesByManifestRowId(SQLite::rowid_t manifestRowId) const;
         std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(AppInstaller::Manifest::string_t packageId) const;
+
+        // Get the transitive dependencies of a manifest, or the transitive dependents of a package, with a single query.
+        std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> GetDependencyClosureByManifestRowId(SQLite::rowid_t manifestRowId) const;
+        std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> GetDependentClosureById(AppInstaller::Manifest::string_t packageId) const;
+
+        // Gets the entire dependencies table, along with the version keys of every package that is depended on.
+        Schema::ISQLiteIndex::DependencySnapshot GetDependencySnapshot() const;
     private:
         // Constructor used to open an existing index.
         SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags);
@@ -156,16 +256,35 @@ namespace AppInstaller::Repository::Microsoft
         // Constructor used to create a new index.
         SQLiteIndex(const std::string& target, Schema::Version version);
 
+        // Constructor used to take ownership of a connection to an existing index.
+        SQLiteIndex(SQLite::Connection&& connection);
+
         // Internal functions to normalize on the relativePath being present.
-        IdType AddManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath);
-        bool UpdateManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath);
+        // The manifest path, if given, is the file that the manifest was read from.
+        IdType AddManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath, const std::filesystem::path& manifestPath = {});
+        bool UpdateManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath, const std::filesystem::path& manifestPath = {});
+
+        // Stores the content of the manifest file for the manifest, if the index supports it and the manifest was read from a single file.
+        // *Must be called while holding the interface lock*
+        void SetManifestContentFromFile(IdType manifestId, const std::filesystem::path& manifestPath);
+
+        // Determines whether the manifest is already in the index with the same content at the same path.
+        // *Must be called while holding the interface lock*
+        bool IsManifestUnchanged(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) const;
 
         // Sets the last write time metadata value in the index.
         void SetLastWriteTime();
 
+        // Runs a read operation on the primary connection, or on a pooled connection if the primary is in use and the index is immutable.
+        template <typename F>
+        auto ReadWithConnection(F&& f) const;
+
+        struct ReadConnectionPool;
+
         SQLite::Connection m_dbconn;
         Schema::Version m_version;
         std::unique_ptr<Schema::ISQLiteIndex> m_interface;
-        std::unique_ptr<std::mutex> m_interfaceLock = std::make_unique<std::mutex>();
+        std::unique_ptr<Performance::Counters::CountedMutex> m_interfaceLock = std::make_unique<Performance::Counters::CountedMutex>("SQLiteIndex");
+        std::shared_ptr<ReadConnectionPool> m_readConnections;
     };
 }
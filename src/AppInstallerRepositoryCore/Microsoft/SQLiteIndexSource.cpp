@@ -2,9 +2,13 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Microsoft/SQLiteIndexSource.h"
+#include "Microsoft/ManifestCache.h"
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
+#include "SearchArena.h"
 #include <winget/ManifestYamlParser.h>
 
+#include <list>
+
 
 using namespace AppInstaller::Utility;
 
@@ -31,11 +35,104 @@ namespace AppInstaller::Repository::Microsoft
             std::weak_ptr<SQLiteIndexSource> m_source;
         };
 
+        // Shared by all of the packages from a single search, so that the common properties of the latest version of
+        // every package are retrieved in a single query the first time that any one of them is needed.
+        struct SearchResultProperties
+        {
+            SearchResultProperties(std::vector<SQLiteIndex::IdType>&& idIds) : m_idIds(std::move(idIds)) {}
+
+            // Gets the manifest id of the latest version for the given package id.
+            std::optional<SQLiteIndex::IdType> GetLatestManifestId(const SQLiteIndex& index, SQLiteIndex::IdType idId)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                EnsureLatestManifestIds(index);
+
+                auto itr = m_latestManifestIds.find(idId);
+                if (itr != m_latestManifestIds.end())
+                {
+                    return itr->second;
+                }
+
+                return index.GetManifestIdByKey(idId, {}, {});
+            }
+
+            // Gets the value of the property for the given manifest id if it was prefetched.
+            std::optional<std::string> GetProperty(const SQLiteIndex& index, SQLiteIndex::IdType manifestId, PackageVersionProperty property)
+            {
+                if (!IsPrefetched(property))
+                {
+                    return {};
+                }
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                EnsureLatestManifestIds(index);
+
+                if (!m_properties)
+                {
+                    std::vector<SQLiteIndex::IdType> manifestIds;
+                    for (const auto& latest : m_latestManifestIds)
+                    {
+                        if (latest.second)
+                        {
+                            manifestIds.emplace_back(latest.second.value());
+                        }
+                    }
+
+                    m_properties = index.GetPropertiesByManifestIds(manifestIds, { std::begin(s_prefetchedProperties), std::end(s_prefetchedProperties) });
+                }
+
+                auto manifestItr = m_properties->find(manifestId);
+                if (manifestItr == m_properties->end())
+                {
+                    return {};
+                }
+
+                auto propertyItr = manifestItr->second.find(property);
+                if (propertyItr == manifestItr->second.end())
+                {
+                    return {};
+                }
+
+                return propertyItr->second;
+            }
+
+        private:
+            // The properties that are commonly displayed for every search result.
+            static constexpr PackageVersionProperty s_prefetchedProperties[] =
+            {
+                PackageVersionProperty::Id,
+                PackageVersionProperty::Name,
+                PackageVersionProperty::Version,
+                PackageVersionProperty::Channel,
+            };
+
+            static bool IsPrefetched(PackageVersionProperty property)
+            {
+                return std::find(std::begin(s_prefetchedProperties), std::end(s_prefetchedProperties), property) != std::end(s_prefetchedProperties);
+            }
+
+            void EnsureLatestManifestIds(const SQLiteIndex& index)
+            {
+                if (m_latestManifestIds.empty() && !m_idIds.empty())
+                {
+                    for (SQLiteIndex::IdType idId : m_idIds)
+                    {
+                        m_latestManifestIds.emplace(idId, index.GetManifestIdByKey(idId, {}, {}));
+                    }
+                }
+            }
+
+            std::mutex m_lock;
+            std::vector<SQLiteIndex::IdType> m_idIds;
+            std::map<SQLiteIndex::IdType, std::optional<SQLiteIndex::IdType>> m_latestManifestIds;
+            std::optional<SQLiteIndex::PropertiesResult> m_properties;
+        };
+
         // The IPackageVersion impl for SQLiteIndexSource.
         struct PackageVersion : public SourceReference, public IPackageVersion
         {
-            PackageVersion(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType manifestId) :
-                SourceReference(source), m_manifestId(manifestId) {}
+            PackageVersion(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType manifestId, const std::shared_ptr<SearchResultProperties>& resultProperties) :
+                SourceReference(source), m_manifestId(manifestId), m_resultProperties(resultProperties) {}
 
             // Inherited via IPackageVersion
             Utility::LocIndString GetProperty(PackageVersionProperty property) const override
@@ -47,8 +144,23 @@ namespace AppInstaller::Repository::Microsoft
                 case PackageVersionProperty::SourceName:
                     return LocIndString{ GetReferenceSource()->GetDetails().Name };
                 default:
+                {
+                    std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
+
+                    std::optional<std::string> value;
+                    if (m_resultProperties)
+                    {
+                        value = m_resultProperties->GetProperty(source->GetIndex(), m_manifestId, property);
+                    }
+
+                    if (!value)
+                    {
+                        value = source->GetIndex().GetPropertyByManifestId(m_manifestId, property);
+                    }
+
                     // Values coming from the index will always be localized/independent.
-                    return LocIndString{ GetReferenceSource()->GetIndex().GetPropertyByManifestId(m_manifestId, property).value() };
+                    return LocIndString{ std::move(value).value() };
+                }
                 }
             }
 
@@ -68,18 +180,7 @@ namespace AppInstaller::Repository::Microsoft
             Manifest::Manifest GetManifest() override
             {
                 std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
-
-                std::optional<std::string> relativePathOpt = source->GetIndex().GetPropertyByManifestId(m_manifestId, PackageVersionProperty::RelativePath);
-                THROW_HR_IF(E_NOT_SET, !relativePathOpt);
-
-                std::optional<std::string> manifestHashString = source->GetIndex().GetPropertyByManifestId(m_manifestId, PackageVersionProperty::ManifestSHA256Hash);
-                SHA256::HashBuffer manifestSHA256;
-                if (manifestHashString)
-                {
-                    manifestSHA256 = SHA256::ConvertToBytes(manifestHashString.value());
-                }
-
-                return GetManifestFromArgAndRelativePath(source->GetDetails().Arg, relativePathOpt.value(), manifestSHA256);
+                return source->GetManifest(m_manifestId, [&]() { return ParseManifest(*source); });
             }
 
             Source GetSource() const override
@@ -101,6 +202,34 @@ namespace AppInstaller::Repository::Microsoft
             }
 
         private:
+            Manifest::Manifest ParseManifest(const SQLiteIndexSource& source) const
+            {
+                std::optional<std::string> relativePathOpt = source.GetIndex().GetPropertyByManifestId(m_manifestId, PackageVersionProperty::RelativePath);
+                THROW_HR_IF(E_NOT_SET, !relativePathOpt);
+
+                std::optional<std::string> manifestHashString = source.GetIndex().GetPropertyByManifestId(m_manifestId, PackageVersionProperty::ManifestSHA256Hash);
+                SHA256::HashBuffer manifestSHA256;
+                if (manifestHashString)
+                {
+                    manifestSHA256 = SHA256::ConvertToBytes(manifestHashString.value());
+                }
+
+                // An index built with the content of its latest manifests can provide them without a download.
+                // The content is held to the same hash as a download would be, so a mismatch simply falls back to the download.
+                try
+                {
+                    std::optional<std::string> manifestContents = source.GetIndex().GetManifestContentById(m_manifestId);
+                    if (manifestContents && (manifestSHA256.empty() || SHA256::AreEqual(manifestSHA256, SHA256::ComputeHash(manifestContents.value()))))
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Using manifest content from the index");
+                        return Manifest::YamlParser::Create(manifestContents.value());
+                    }
+                }
+                CATCH_LOG();
+
+                return GetManifestFromArgAndRelativePath(source.GetDetails().Arg, relativePathOpt.value(), manifestSHA256);
+            }
+
             static Manifest::Manifest GetManifestFromArgAndRelativePath(const std::string& arg, const std::string& relativePath, const SHA256::HashBuffer& expectedHash)
             {
                 std::string fullPath = arg;
@@ -112,6 +241,23 @@ namespace AppInstaller::Repository::Microsoft
 
                 if (Utility::IsUrlRemote(fullPath))
                 {
+                    // The index records the hash of each manifest, so a cached copy with a matching hash is the same manifest
+                    std::shared_ptr<ManifestCache> cache;
+                    if (!expectedHash.empty())
+                    {
+                        try
+                        {
+                            cache = ManifestCache::GetDefault();
+
+                            auto cachedContents = cache->Get(expectedHash);
+                            if (cachedContents)
+                            {
+                                return Manifest::YamlParser::Create(cachedContents.value());
+                            }
+                        }
+                        CATCH_LOG();
+                    }
+
                     std::ostringstream manifestStream;
 
                     AICLI_LOG(Repo, Info, << "Downloading manifest");
@@ -155,7 +301,18 @@ namespace AppInstaller::Repository::Microsoft
                     std::string manifestContents = manifestStream.str();
                     AICLI_LOG(Repo, Verbose, << "Manifest contents: " << manifestContents);
 
-                    return Manifest::YamlParser::Create(manifestContents);
+                    Manifest::Manifest result = Manifest::YamlParser::Create(manifestContents);
+
+                    if (cache)
+                    {
+                        try
+                        {
+                            cache->Add(expectedHash, manifestContents);
+                        }
+                        CATCH_LOG();
+                    }
+
+                    return result;
                 }
                 else
                 {
@@ -173,13 +330,14 @@ namespace AppInstaller::Repository::Microsoft
             }
 
             SQLiteIndex::IdType m_manifestId;
+            std::shared_ptr<SearchResultProperties> m_resultProperties;
         };
 
         // The base for IPackage implementations here.
         struct PackageBase : public SourceReference
         {
-            PackageBase(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType idId) :
-                SourceReference(source), m_idId(idId) {}
+            PackageBase(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType idId, const std::shared_ptr<SearchResultProperties>& resultProperties) :
+                SourceReference(source), m_idId(idId), m_resultProperties(resultProperties) {}
 
             Utility::LocIndString GetProperty(PackageProperty property) const
             {
@@ -215,17 +373,27 @@ namespace AppInstaller::Repository::Microsoft
             std::shared_ptr<IPackageVersion> GetLatestVersionInternal() const
             {
                 std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
-                std::optional<SQLiteIndex::IdType> manifestId = source->GetIndex().GetManifestIdByKey(m_idId, {}, {});
+                std::optional<SQLiteIndex::IdType> manifestId;
+
+                if (m_resultProperties)
+                {
+                    manifestId = m_resultProperties->GetLatestManifestId(source->GetIndex(), m_idId);
+                }
+                else
+                {
+                    manifestId = source->GetIndex().GetManifestIdByKey(m_idId, {}, {});
+                }
 
                 if (manifestId)
                 {
-                    return std::make_shared<PackageVersion>(source, manifestId.value());
+                    return std::make_shared<PackageVersion>(source, manifestId.value(), m_resultProperties);
                 }
 
                 return {};
             }
 
             SQLiteIndex::IdType m_idId;
+            std::shared_ptr<SearchResultProperties> m_resultProperties;
         };
 
         // The IPackage impl for SQLiteIndexSource of Available packages.
@@ -276,7 +444,7 @@ namespace AppInstaller::Repository::Microsoft
 
                 if (manifestId)
                 {
-                    return std::make_shared<PackageVersion>(source, manifestId.value());
+                    return std::make_shared<PackageVersion>(source, manifestId.value(), m_resultProperties);
                 }
 
                 return {};
@@ -350,8 +518,56 @@ namespace AppInstaller::Repository::Microsoft
         };
     }
 
+    struct SQLiteIndexSource::RecentManifests
+    {
+        // Enough for the packages of any single install, along with their dependencies, while bounding the memory for long batches.
+        static constexpr size_t s_maximumManifests = 16;
+
+        std::optional<Manifest::Manifest> Get(SQLiteIndex::IdType manifestId)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            auto itr = std::find_if(m_manifests.begin(), m_manifests.end(), [&](const auto& entry) { return entry.first == manifestId; });
+            if (itr == m_manifests.end())
+            {
+                return {};
+            }
+
+            // Keep the most recently used at the front
+            m_manifests.splice(m_manifests.begin(), m_manifests, itr);
+            return m_manifests.front().second;
+        }
+
+        void Add(SQLiteIndex::IdType manifestId, const Manifest::Manifest& manifest)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            // Another thread may have parsed the same manifest in the meantime.
+            if (std::any_of(m_manifests.begin(), m_manifests.end(), [&](const auto& entry) { return entry.first == manifestId; }))
+            {
+                return;
+            }
+
+            m_manifests.emplace_front(manifestId, manifest);
+            if (m_manifests.size() > s_maximumManifests)
+            {
+                m_manifests.pop_back();
+            }
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_manifests.clear();
+        }
+
+    private:
+        std::mutex m_lock;
+        std::list<std::pair<SQLiteIndex::IdType, Manifest::Manifest>> m_manifests;
+    };
+
     SQLiteIndexSource::SQLiteIndexSource(const SourceDetails& details, SQLiteIndex&& index, Synchronization::CrossProcessReaderWriteLock&& lock, bool isInstalledSource) :
-        m_details(details), m_lock(std::move(lock)), m_isInstalled(isInstalledSource), m_index(std::move(index))
+        m_details(details), m_lock(std::move(lock)), m_isInstalled(isInstalledSource), m_recentManifests(std::make_shared<RecentManifests>()), m_index(std::move(index))
     {
     }
 
@@ -367,27 +583,53 @@ namespace AppInstaller::Repository::Microsoft
 
     SearchResult SQLiteIndexSource::Search(const SearchRequest& request) const
     {
-        auto indexResults = m_index.Search(request);
-
         SearchResult result;
+        result.Truncated = Search(request, [&](ResultMatch&& match)
+            {
+                result.Matches.emplace_back(std::move(match));
+                return true;
+            });
+        return result;
+    }
+
+    bool SQLiteIndexSource::Search(const SearchRequest& request, const SearchMatchCallback& onMatch) const
+    {
+        auto indexResults = SearchIndex(request);
+
+        std::vector<SQLiteIndex::IdType> idIds;
+        idIds.reserve(indexResults.Matches.size());
+        for (const auto& indexResult : indexResults.Matches)
+        {
+            idIds.emplace_back(indexResult.first);
+        }
+
+        // The package objects are all created together and generally released together, so place them in a single arena
+        // rather than making a separate heap allocation for each one.
+        auto arena = std::make_shared<SearchArena>();
+        auto resultProperties = AllocateInArena<SearchResultProperties>(arena, std::move(idIds));
+
         std::shared_ptr<SQLiteIndexSource> sharedThis = NonConstSharedFromThis();
-        for (auto& indexResult : indexResults.Matches)
+        for (size_t i = 0; i < indexResults.Matches.size(); ++i)
         {
-            std::unique_ptr<IPackage> package;
+            auto& indexResult = indexResults.Matches[i];
+            std::shared_ptr<IPackage> package;
 
             if (m_isInstalled)
             {
-                package = std::make_unique<InstalledPackage>(sharedThis, indexResult.first);
+                package = AllocateInArena<InstalledPackage>(arena, sharedThis, indexResult.first, resultProperties);
             }
             else
             {
-                package = std::make_unique<AvailablePackage>(sharedThis, indexResult.first);
+                package = AllocateInArena<AvailablePackage>(arena, sharedThis, indexResult.first, resultProperties);
             }
 
-            result.Matches.emplace_back(std::move(package), std::move(indexResult.second));
+            if (!onMatch(ResultMatch{ std::move(package), std::move(indexResult.second) }))
+            {
+                return (i + 1 < indexResults.Matches.size()) || indexResults.Truncated;
+            }
         }
-        result.Truncated = indexResults.Truncated;
-        return result;
+
+        return indexResults.Truncated;
     }
 
     bool SQLiteIndexSource::IsSame(const SQLiteIndexSource* other) const
@@ -395,11 +637,59 @@ namespace AppInstaller::Repository::Microsoft
         return (other && GetIdentifier() == other->GetIdentifier());
     }
 
+    void SQLiteIndexSource::EnableSearchResultCache(const std::filesystem::path& indexPath)
+    {
+        // The source works the same without the cache, so a failure to create it is not a failure to open the source.
+        try
+        {
+            m_searchResultCache = SearchResultCache::CreateForIndex(GetIdentifier(), indexPath, m_index);
+        }
+        CATCH_LOG();
+    }
+
+    SQLiteIndex::SearchResult SQLiteIndexSource::SearchIndex(const SearchRequest& request) const
+    {
+        if (!m_searchResultCache)
+        {
+            return m_index.Search(request);
+        }
+
+        auto cachedResult = m_searchResultCache->Get(request);
+        if (cachedResult)
+        {
+            return std::move(cachedResult).value();
+        }
+
+        auto result = m_index.Search(request);
+        m_searchResultCache->Add(request, result);
+        return result;
+    }
+
+    Manifest::Manifest SQLiteIndexSource::GetManifest(SQLiteIndex::IdType manifestId, const std::function<Manifest::Manifest()>& parseManifest) const
+    {
+        auto recentManifest = m_recentManifests->Get(manifestId);
+        if (recentManifest)
+        {
+            AICLI_LOG(Repo, Verbose, << "Using recently parsed manifest");
+            return std::move(recentManifest).value();
+        }
+
+        // Parsed outside of the lock, so that reading one manifest does not hold up the others.
+        Manifest::Manifest manifest = parseManifest();
+        m_recentManifests->Add(manifestId, manifest);
+        return manifest;
+    }
+
     std::shared_ptr<SQLiteIndexSource> SQLiteIndexSource::NonConstSharedFromThis() const
     {
         return const_cast<SQLiteIndexSource*>(this)->shared_from_this();
     }
 
+    void SQLiteIndexSource::ClearRecentManifests()
+    {
+        m_recentManifests->Clear();
+    }
+
     SQLiteIndexWriteableSource::SQLiteIndexWriteableSource(const SourceDetails& details, SQLiteIndex&& index, Synchronization::CrossProcessReaderWriteLock&& lock, bool isInstalledSource) :
         SQLiteIndexSource(details, std::move(index), std::move(lock), isInstalledSource)
     {
@@ -408,10 +698,12 @@ namespace AppInstaller::Repository::Microsoft
     void SQLiteIndexWriteableSource::AddPackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
     {
         m_index.AddManifest(manifest, relativePath);
+        ClearRecentManifests();
     }
     
     void SQLiteIndexWriteableSource::RemovePackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
     {
         m_index.RemoveManifest(manifest, relativePath);
+        ClearRecentManifests();
     }
 }
@@ -2,9 +2,11 @@
 // Licensed under the MIT License.
 #pragma once
 #include "Microsoft/SQLiteIndex.h"
+#include "Microsoft/SearchResultCache.h"
 #include "ISource.h"
 #include <AppInstallerSynchronization.h>
 
+#include <functional>
 #include <memory>
 
 
@@ -38,6 +40,14 @@ namespace AppInstaller::Repository::Microsoft
         // Execute a search on the source.
         SearchResult Search(const SearchRequest& request) const override;
 
+        // Called with each match as it is produced; return false to stop the search.
+        using SearchMatchCallback = std::function<bool(ResultMatch&&)>;
+
+        // Execute a search on the source, handing each match to the callback as soon as it is created rather than
+        // collecting them all first. Returns true if the results were truncated, either by the request limit or by
+        // the callback stopping the search.
+        bool Search(const SearchRequest& request, const SearchMatchCallback& onMatch) const;
+
         // Gets the index.
         SQLiteIndex& GetIndex() { return m_index; }
         const SQLiteIndex& GetIndex() const { return m_index; }
@@ -45,14 +55,34 @@ namespace AppInstaller::Repository::Microsoft
         // Determines if the other source refers to the same as this.
         bool IsSame(const SQLiteIndexSource* other) const;
 
+        // Keeps the results of searches in a persistent cache for the index at the given path.
+        // Only valid for an index that cannot be changed while the source is open.
+        void EnableSearchResultCache(const std::filesystem::path& indexPath);
+
+        // Gets the manifest with the given id, only calling parseManifest if it is not among those most recently parsed.
+        // Each request for a version creates a new object for it, so this is what lets the several reads of the same manifest
+        // during a command, from the version and from any composite package that wraps it, share a single download and parse.
+        Manifest::Manifest GetManifest(SQLiteIndex::IdType manifestId, const std::function<Manifest::Manifest()>& parseManifest) const;
+
     private:
-        std::shared_ptr<SQLiteIndexSource> NonConstSharedFromThis() const;
+        // Searches the index, using the search result cache if it is enabled.
+        SQLiteIndex::SearchResult SearchIndex(const SearchRequest& request) const;
+
+        // The most recently parsed manifests.
+        struct RecentManifests;
 
         SourceDetails m_details;
         Synchronization::CrossProcessReaderWriteLock m_lock;
         bool m_isInstalled;
+        std::shared_ptr<SearchResultCache> m_searchResultCache;
+        std::shared_ptr<RecentManifests> m_recentManifests;
 
     protected:
+        std::shared_ptr<SQLiteIndexSource> NonConstSharedFromThis() const;
+
+        // Forgets the recently parsed manifests, as the ids of those that are changed may be reused.
+        void ClearRecentManifests();
+
         SQLiteIndex m_index;
     };
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #pragma once
 #include "Microsoft/Schema/ISQLiteIndex.h"
+#include "Microsoft/Schema/1_0/PathPartTable.h"
 #include "Microsoft/Schema/1_0/SearchResultsTable.h"
 
 #include <memory>
@@ -20,14 +21,17 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         std::pair<bool, SQLite::rowid_t> UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
         SQLite::rowid_t RemoveManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest) override;
         void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
+        std::optional<SQLite::rowid_t> GetManifestIdByRelativePath(SQLite::Connection& connection, const std::filesystem::path& relativePath) override;
         void PrepareForPackaging(SQLite::Connection& connection) override;
         bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
+        std::vector<ConsistencyCheck> GetConsistencyChecks() const override;
         SearchResult Search(const SQLite::Connection& connection, const SearchRequest& request) const override;
         std::optional<std::string> GetPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const override;
         std::vector<std::string> GetMultiPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionMultiProperty property) const override;
         std::optional<SQLite::rowid_t> GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const override;
         std::optional<SQLite::rowid_t> GetManifestIdByManifest(const SQLite::Connection& connection, const Manifest::Manifest& manifest) const override;
         std::vector<Utility::VersionAndChannel> GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const override;
+        PropertiesResult GetPropertiesByManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& manifestIds, const std::set<PackageVersionProperty>& properties) const override;
 
         // Version 1.1
         MetadataResult GetMetadataByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
@@ -39,6 +43,18 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // Version 1.4 Get all the dependencies for a specific manifest.
         std::set<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependenciesByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const override;
         std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const override;   
+        std::vector<DependencyClosureEntry> GetDependencyClosureByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const override;
+        std::vector<DependencyClosureEntry> GetDependentClosureById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const override;
+        DependencySnapshot GetDependencySnapshot(const SQLite::Connection& connection) const override;
+
+        // Version 1.3
+        std::optional<SQLite::rowid_t> GetManifestIdByHash(const SQLite::Connection& connection, const SQLite::blob_t& hash) const override;
+
+        // Version 1.10
+        bool IsManifestContentSupported(const SQLite::Connection& connection) const override;
+        void SetManifestContentById(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view content) override;
+        std::optional<std::string> GetManifestContentById(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
+        void SetManifestContentVersions(SQLite::Connection& connection, uint32_t versions) override;
     
     protected:
         virtual bool NotNeeded(const SQLite::Connection& connection, std::string_view tableName, std::string_view valueName, SQLite::rowid_t id) const;
@@ -54,5 +70,9 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         // Gets a property already knowing that the manifest id is valid.
         virtual std::optional<std::string> GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const;
+
+        // Path parts found or created by this interface; speeds up adding many manifests that share directories.
+        // Must be cleared whenever path parts are removed from the index.
+        PathPartTable::Cache m_pathPartCache;
     };
 }
@@ -57,6 +57,78 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return result;
         }
 
+        // Estimates how many manifests a filter matches relative to other filters; lower values are expected to match fewer.
+        int GetFilterSelectivityRank(const PackageMatchFilter& filter)
+        {
+            int fieldRank = 0;
+            switch (filter.Field)
+            {
+            case PackageMatchField::Id:
+            case PackageMatchField::PackageFamilyName:
+            case PackageMatchField::ProductCode:
+            case PackageMatchField::NormalizedNameAndPublisher:
+                fieldRank = 0;
+                break;
+            case PackageMatchField::Moniker:
+                fieldRank = 1;
+                break;
+            case PackageMatchField::Name:
+                fieldRank = 2;
+                break;
+            case PackageMatchField::Command:
+                fieldRank = 3;
+                break;
+            case PackageMatchField::Tag:
+                fieldRank = 4;
+                break;
+            default:
+                fieldRank = 5;
+                break;
+            }
+
+            int typeRank = 0;
+            switch (filter.Type)
+            {
+            case MatchType::Exact:
+            case MatchType::CaseInsensitive:
+                typeRank = 0;
+                break;
+            case MatchType::StartsWith:
+                typeRank = 1;
+                break;
+            case MatchType::Fuzzy:
+            case MatchType::Substring:
+            case MatchType::FuzzySubstring:
+                typeRank = 2;
+                break;
+            default:
+                typeRank = 3;
+                break;
+            }
+
+            return typeRank * 10 + fieldRank;
+        }
+
+        // Gets the index of the filter to seed the results from; the first one unless another is expected to match fewer manifests.
+        size_t GetSeedFilterIndex(const std::vector<PackageMatchFilter>& filters)
+        {
+            size_t result = 0;
+            for (size_t i = 1; i < filters.size(); ++i)
+            {
+                // Later schemas rank substring and fuzzy matches as they are searched, which would then include the ranks of the seed.
+                if (filters[i].Type != MatchType::Exact && filters[i].Type != MatchType::CaseInsensitive && filters[i].Type != MatchType::StartsWith)
+                {
+                    continue;
+                }
+
+                if (GetFilterSelectivityRank(filters[i]) < GetFilterSelectivityRank(filters[result]))
+                {
+                    result = i;
+                }
+            }
+            return result;
+        }
+
         // Gets a manifest id by the given key values.
         std::optional<SQLite::rowid_t> StaticGetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version = "", std::string_view channel = "")
         {
@@ -186,7 +258,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_0");
 
-        auto [pathAdded, pathLeafId] = PathPartTable::EnsurePathExists(connection, relativePath, true);
+        auto [pathAdded, pathLeafId] = PathPartTable::EnsurePathExists(connection, relativePath, true, m_pathPartCache);
 
         // If we get false from the function, this manifest path already exists in the index.
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_ALREADY_EXISTS), relativePath && !pathAdded);
@@ -266,13 +338,14 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         // Update path table if necessary
         auto [existingPathLeafId] = ManifestTable::GetIdsById<PathPartTable>(connection, manifestId);
-        auto [pathAdded, newPathLeafId] = PathPartTable::EnsurePathExists(connection, relativePath, true);
+        auto [pathAdded, newPathLeafId] = PathPartTable::EnsurePathExists(connection, relativePath, true, m_pathPartCache);
 
         if (relativePath && pathAdded)
         {
             // Path was added, so we need to update the manifest table and delete the old path
             ManifestTable::UpdateValueIdById<PathPartTable>(connection, manifestId, newPathLeafId);
             PathPartTable::RemovePathById(connection, existingPathLeafId);
+            m_pathPartCache.Clear();
             indexModified = true;
         }
         else
@@ -292,7 +365,17 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
     SQLite::rowid_t Interface::RemoveManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest)
     {
-        auto manifestResult = GetExistingManifestId(connection, manifest);
+        // A manifest with the same content hash is the same manifest, and can be found without looking up each of its key values.
+        std::optional<SQLite::rowid_t> manifestResult;
+        if (!manifest.StreamSha256.empty())
+        {
+            manifestResult = GetManifestIdByHash(connection, manifest.StreamSha256);
+        }
+
+        if (!manifestResult)
+        {
+            manifestResult = GetExistingManifestId(connection, manifest);
+        }
 
         // If the manifest doesn't actually exist, fail the remove.
         THROW_HR_IF(E_NOT_SET, !manifestResult);
@@ -302,6 +385,19 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return manifestResult.value();
     }
 
+    std::optional<SQLite::rowid_t> Interface::GetManifestIdByRelativePath(SQLite::Connection& connection, const std::filesystem::path& relativePath)
+    {
+        auto [found, pathLeafId] = PathPartTable::EnsurePathExists(connection, relativePath, false, m_pathPartCache);
+
+        if (!found)
+        {
+            AICLI_LOG(Repo, Verbose, << "Did not find a path { " << relativePath << " }");
+            return {};
+        }
+
+        return ManifestTable::SelectByValueIds<PathPartTable>(connection, { pathLeafId });
+    }
+
     void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
     {
         // Get the ids of the values from the manifest table
@@ -341,6 +437,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         // Remove the path
         PathPartTable::RemovePathById(connection, pathLeafId);
+        m_pathPartCache.Clear();
 
         // Remove all of the 1:N data that is no longer referenced.
         TagsTable::DeleteIfNotNeededByManifestId(connection, manifestId);
@@ -357,6 +454,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     void Interface::PrepareForPackaging(SQLite::Connection& connection)
     {
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_0");
+        m_pathPartCache.Clear();
 
         IdTable::PrepareForPackaging_deprecated(connection);
         NameTable::PrepareForPackaging_deprecated(connection);
@@ -388,57 +486,36 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         bool result = true;
 
-        // Check the manifest table references to it's 1:1 tables
-        if (result || log)
-        {
-            result = ManifestTable::CheckConsistency<IdTable>(connection, log) && result;
-        }
-
-        if (result || log)
+        // If the index is still consistent, or if full logging of inconsistency was requested, run the next check.
+        for (const auto& check : GetConsistencyChecks())
         {
-            result = ManifestTable::CheckConsistency<NameTable>(connection, log) && result;
-        }
-
-        if (result || log)
-        {
-            result = ManifestTable::CheckConsistency<MonikerTable>(connection, log) && result;
-        }
-
-        if (result || log)
-        {
-            result = ManifestTable::CheckConsistency<VersionTable>(connection, log) && result;
-        }
-
-        if (result || log)
-        {
-            result = ManifestTable::CheckConsistency<ChannelTable>(connection, log) && result;
-        }
-
-        if (result || log)
-        {
-            result = ManifestTable::CheckConsistency<PathPartTable>(connection, log) && result;
-        }
-
-        // Check the pathpaths table for consistency
-        if (result || log)
-        {
-            result = PathPartTable::CheckConsistency(connection, log) && result;
-        }
-
-        // Check the 1:N map tables for consistency
-        if (result || log)
-        {
-            result = TagsTable::CheckConsistency(connection, log) && result;
-        }
-
-        if (result || log)
-        {
-            result = CommandsTable::CheckConsistency(connection, log) && result;
+            if (result || log)
+            {
+                result = check.Check(connection, log) && result;
+            }
         }
 
         return result;
     }
 
+    std::vector<ISQLiteIndex::ConsistencyCheck> Interface::GetConsistencyChecks() const
+    {
+        return {
+            // Check the manifest table references to it's 1:1 tables
+            { "manifest_ids", [](const SQLite::Connection& connection, bool log) { return ManifestTable::CheckConsistency<IdTable>(connection, log); } },
+            { "manifest_names", [](const SQLite::Connection& connection, bool log) { return ManifestTable::CheckConsistency<NameTable>(connection, log); } },
+            { "manifest_monikers", [](const SQLite::Connection& connection, bool log) { return ManifestTable::CheckConsistency<MonikerTable>(connection, log); } },
+            { "manifest_versions", [](const SQLite::Connection& connection, bool log) { return ManifestTable::CheckConsistency<VersionTable>(connection, log); } },
+            { "manifest_channels", [](const SQLite::Connection& connection, bool log) { return ManifestTable::CheckConsistency<ChannelTable>(connection, log); } },
+            { "manifest_pathparts", [](const SQLite::Connection& connection, bool log) { return ManifestTable::CheckConsistency<PathPartTable>(connection, log); } },
+            // Check the pathpaths table for consistency
+            { "pathparts", [](const SQLite::Connection& connection, bool log) { return PathPartTable::CheckConsistency(connection, log); } },
+            // Check the 1:N map tables for consistency
+            { "tags", [](const SQLite::Connection& connection, bool log) { return TagsTable::CheckConsistency(connection, log); } },
+            { "commands", [](const SQLite::Connection& connection, bool log) { return CommandsTable::CheckConsistency(connection, log); } },
+        };
+    }
+
     ISQLiteIndex::SearchResult Interface::Search(const SQLite::Connection& connection, const SearchRequest& request) const
     {
         if (request.IsForEverything())
@@ -485,41 +562,79 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             inclusionsAttempted = true;
         }
 
-        size_t filterIndex = 0;
-        if (!inclusionsAttempted)
+        auto seedOnFilter = [&](SearchResultsTable& table, PackageMatchFilter filter)
         {
-            THROW_HR_IF(E_UNEXPECTED, request.Filters.empty());
+            for (MatchType match : GetMatchTypeOrder(filter.Type))
+            {
+                filter.Type = match;
+                table.SearchOnField(filter);
+            }
 
-            // Perform search for just the field matching the first filter
-            PackageMatchFilter filter = request.Filters[0];
+            // Remove any duplicate manifest entries
+            table.RemoveDuplicateManifestRows();
+        };
+
+        auto filterOnFilter = [&](SearchResultsTable& table, PackageMatchFilter filter)
+        {
+            table.PrepareToFilter();
 
             for (MatchType match : GetMatchTypeOrder(filter.Type))
             {
                 filter.Type = match;
-                resultsTable->SearchOnField(filter);
+                table.FilterOnField(filter);
             }
 
+            table.CompleteFilter();
+        };
+
+        size_t filterIndex = 0;
+        if (!inclusionsAttempted)
+        {
+            THROW_HR_IF(E_UNEXPECTED, request.Filters.empty());
+
+            // The results are ordered and attributed by the first filter, but seeding them from a filter that matches far fewer
+            // manifests avoids holding a row for everything the first filter matches. Once the other filters have been applied,
+            // the first filter seeds the results again, restricted to the manifests that remain.
+            size_t seedIndex = GetSeedFilterIndex(request.Filters);
+            if (seedIndex != 0)
+            {
+                seedOnFilter(*resultsTable, request.Filters[seedIndex]);
+
+                for (size_t i = 1; i < request.Filters.size(); ++i)
+                {
+                    if (i != seedIndex)
+                    {
+                        filterOnFilter(*resultsTable, request.Filters[i]);
+                    }
+                }
+
+                if (resultsTable->RestrictToCurrentManifests())
+                {
+                    seedOnFilter(*resultsTable, request.Filters[0]);
+                    return resultsTable->GetSearchResults(request.MaximumResults);
+                }
+
+                // The seed matched too many manifests to hold in memory; fall back to seeding from the first filter.
+                AICLI_LOG(Repo, Verbose, << "Seed filter was not selective, searching again from the first filter");
+                resultsTable = CreateSearchResultsTable(connection);
+            }
+
+            // Perform search for just the field matching the first filter
+            seedOnFilter(*resultsTable, request.Filters[0]);
+
             // Skip the filter as we already know everything matches
             filterIndex = 1;
         }
-
-        // Remove any duplicate manifest entries
-        resultsTable->RemoveDuplicateManifestRows();
+        else
+        {
+            // Remove any duplicate manifest entries
+            resultsTable->RemoveDuplicateManifestRows();
+        }
 
         // Second phase, for remaining filters, flag matching search results, then remove unflagged values.
         for (size_t i = filterIndex; i < request.Filters.size(); ++i)
         {
-            PackageMatchFilter filter = request.Filters[i];
-
-            resultsTable->PrepareToFilter();
-
-            for (MatchType match : GetMatchTypeOrder(filter.Type))
-            {
-                filter.Type = match;
-                resultsTable->FilterOnField(filter);
-            }
-
-            resultsTable->CompleteFilter();
+            filterOnFilter(*resultsTable, request.Filters[i]);
         }
 
         return resultsTable->GetSearchResults(request.MaximumResults);
@@ -561,6 +676,46 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return {};
     }
 
+    std::vector<ISQLiteIndex::DependencyClosureEntry> Interface::GetDependencyClosureByManifestRowId(const SQLite::Connection&, SQLite::rowid_t) const
+    {
+        return {};
+    }
+
+    std::vector<ISQLiteIndex::DependencyClosureEntry> Interface::GetDependentClosureById(const SQLite::Connection&, AppInstaller::Manifest::string_t) const
+    {
+        return {};
+    }
+
+    ISQLiteIndex::DependencySnapshot Interface::GetDependencySnapshot(const SQLite::Connection&) const
+    {
+        return {};
+    }
+
+    std::optional<SQLite::rowid_t> Interface::GetManifestIdByHash(const SQLite::Connection&, const SQLite::blob_t&) const
+    {
+        return {};
+    }
+
+    bool Interface::IsManifestContentSupported(const SQLite::Connection&) const
+    {
+        return false;
+    }
+
+    void Interface::SetManifestContentById(SQLite::Connection&, SQLite::rowid_t, std::string_view)
+    {
+        THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+    }
+
+    std::optional<std::string> Interface::GetManifestContentById(const SQLite::Connection&, SQLite::rowid_t) const
+    {
+        return {};
+    }
+
+    void Interface::SetManifestContentVersions(SQLite::Connection&, uint32_t)
+    {
+        THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+    }
+
     std::vector<Utility::VersionAndChannel> Interface::GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const
     {
         auto versionsAndChannels = ManifestTable::GetAllValuesById<IdTable, VersionTable, ChannelTable>(connection, id);
@@ -577,6 +732,102 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return result;
     }
 
+    ISQLiteIndex::PropertiesResult Interface::GetPropertiesByManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& manifestIds, const std::set<PackageVersionProperty>& properties) const
+    {
+        using QCol = SQLite::Builder::QualifiedColumn;
+
+        // Keep the number of bound values well below the SQLite limit on host parameters.
+        constexpr size_t s_MaximumManifestIdsPerQuery = 250;
+
+        // Properties that are stored in a 1:1 table are retrieved with a join; all others are retrieved individually.
+        std::vector<std::pair<PackageVersionProperty, QCol>> joinedProperties;
+        std::vector<PackageVersionProperty> individualProperties;
+
+        for (PackageVersionProperty property : properties)
+        {
+            switch (property)
+            {
+            case PackageVersionProperty::Id:
+                joinedProperties.emplace_back(property, QCol{ IdTable::TableName(), IdTable::ValueName() });
+                break;
+            case PackageVersionProperty::Name:
+                joinedProperties.emplace_back(property, QCol{ NameTable::TableName(), NameTable::ValueName() });
+                break;
+            case PackageVersionProperty::Version:
+                joinedProperties.emplace_back(property, QCol{ VersionTable::TableName(), VersionTable::ValueName() });
+                break;
+            case PackageVersionProperty::Channel:
+                joinedProperties.emplace_back(property, QCol{ ChannelTable::TableName(), ChannelTable::ValueName() });
+                break;
+            default:
+                individualProperties.emplace_back(property);
+                break;
+            }
+        }
+
+        PropertiesResult result;
+
+        for (size_t begin = 0; begin < manifestIds.size(); begin += s_MaximumManifestIdsPerQuery)
+        {
+            size_t count = std::min(s_MaximumManifestIdsPerQuery, manifestIds.size() - begin);
+
+            // Build a statement like:
+            //  SELECT manifest.rowid, names.name, ... FROM manifest
+            //  JOIN names ON manifest.name = names.rowid ...
+            //  WHERE manifest.rowid IN (?, ...)
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select().Column(QCol{ ManifestTable::TableName(), SQLite::RowIDName });
+
+            for (const auto& joined : joinedProperties)
+            {
+                builder.Column(joined.second);
+            }
+
+            builder.From(ManifestTable::TableName());
+
+            for (const auto& joined : joinedProperties)
+            {
+                builder.Join(joined.second.Table).On(QCol{ ManifestTable::TableName(), joined.second.Column }, QCol{ joined.second.Table, SQLite::RowIDName });
+            }
+
+            builder.Where(QCol{ ManifestTable::TableName(), SQLite::RowIDName }).In(count);
+
+            SQLite::Statement select = builder.PrepareCached(connection);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                select.Bind(static_cast<int>(i + 1), manifestIds[begin + i]);
+            }
+
+            while (select.Step())
+            {
+                auto& values = result[select.GetColumn<SQLite::rowid_t>(0)];
+
+                for (size_t i = 0; i < joinedProperties.size(); ++i)
+                {
+                    values[joinedProperties[i].first] = select.GetColumn<std::string>(static_cast<int>(i + 1));
+                }
+            }
+        }
+
+        if (!individualProperties.empty())
+        {
+            for (auto& entry : result)
+            {
+                for (PackageVersionProperty property : individualProperties)
+                {
+                    std::optional<std::string> value = GetPropertyByManifestIdInternal(connection, entry.first, property);
+                    if (value)
+                    {
+                        entry.second[property] = std::move(value).value();
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
     ISQLiteIndex::MetadataResult Interface::GetMetadataByManifestId(const SQLite::Connection&, SQLite::rowid_t) const
     {
         return {};
@@ -42,7 +42,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
             builder.Limit(1);
 
-            SQLite::Statement select = builder.Prepare(connection);
+            SQLite::Statement select = builder.PrepareCached(connection);
 
             int bindIndex = 0;
             for (const auto& id : ids)
@@ -68,7 +68,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             SQLite::Builder::StatementBuilder builder;
             builder.Select(values).From(s_ManifestTable_Table_Name).Where(SQLite::RowIDName).Equals(id);
 
-            SQLite::Statement result = builder.Prepare(connection);
+            SQLite::Statement result = builder.PrepareCached(connection);
 
             THROW_HR_IF(E_NOT_SET, !result.Step());
 
@@ -98,7 +98,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
             builder.Where(QCol{ s_ManifestTable_Table_Name, SQLite::RowIDName }).Equals(id);
 
-            SQLite::Statement result = builder.Prepare(connection);
+            SQLite::Statement result = builder.PrepareCached(connection);
 
             THROW_HR_IF(E_NOT_SET, !result.Step());
 
@@ -138,7 +138,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 }
             }
 
-            SQLite::Statement select = builder.Prepare(connection);
+            SQLite::Statement select = builder.PrepareCached(connection);
 
             int bindIndex = 0;
             for (const auto& id : ids)
@@ -261,6 +261,14 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return builder.Prepare(connection);
         }
 
+        SQLite::Statement ManifestTableSelectByValue_Statement(const SQLite::Connection& connection, std::string_view valueName)
+        {
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select(SQLite::RowIDName).From(s_ManifestTable_Table_Name).Where(valueName).Equals(SQLite::Builder::Unbound).Limit(1);
+
+            return builder.PrepareCached(connection);
+        }
+
         bool ManifestTableCheckConsistency(const SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& target, bool log)
         {
             using QCol = SQLite::Builder::QualifiedColumn;
@@ -342,6 +350,11 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // Create an index on every value to improve performance
         for (const ManifestColumnInfo& value : values)
         {
+            if (value.Deferred)
+            {
+                continue;
+            }
+
             StatementBuilder createIndexBuilder;
 
             if (value.Unique)
@@ -434,7 +447,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         builder.EndValues();
 
-        builder.Execute(connection);
+        builder.PrepareCached(connection).Execute();
 
         return connection.GetLastInsertRowID();
     }
@@ -444,7 +457,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         SQLite::Builder::StatementBuilder builder;
         builder.Select(SQLite::Builder::RowCount).From(s_ManifestTable_Table_Name).Where(SQLite::RowIDName).Equals(id);
 
-        SQLite::Statement countStatement = builder.Prepare(connection);
+        SQLite::Statement countStatement = builder.PrepareCached(connection);
 
         THROW_HR_IF(E_UNEXPECTED, !countStatement.Step());
 
@@ -476,9 +489,14 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "pfpManifestTable_v1_0");
 
-        // Drop the index on the requested values
+        // Drop the index on the requested values; deferred indices were never created
         for (std::string_view value : values)
         {
+            if (!ValueIndexExists(connection, value))
+            {
+                continue;
+            }
+
             SQLite::Builder::StatementBuilder dropIndexBuilder;
             dropIndexBuilder.DropIndex({ s_ManifestTable_Table_Name, s_ManifestTable_Index_Separator, value, s_ManifestTable_Index_Suffix });
 
@@ -488,6 +506,57 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         savepoint.Commit();
     }
 
+    void ManifestTable::CreateCoveringIndex(SQLite::Connection& connection, std::initializer_list<std::string_view> values)
+    {
+        std::string indexName{ s_ManifestTable_Table_Name };
+        for (std::string_view value : values)
+        {
+            indexName += s_ManifestTable_Index_Separator;
+            indexName += value;
+        }
+        indexName += s_ManifestTable_Index_Suffix;
+
+        SQLite::Builder::StatementBuilder createIndexBuilder;
+        createIndexBuilder.CreateIndex(indexName).On(s_ManifestTable_Table_Name).Columns(values);
+
+        createIndexBuilder.Execute(connection);
+    }
+
+    void ManifestTable::CreateValueIndex(SQLite::Connection& connection, std::string_view value, bool unique)
+    {
+        SQLite::Builder::StatementBuilder createIndexBuilder;
+
+        if (unique)
+        {
+            createIndexBuilder.CreateUniqueIndex({ s_ManifestTable_Table_Name, s_ManifestTable_Index_Separator, value, s_ManifestTable_Index_Suffix });
+        }
+        else
+        {
+            createIndexBuilder.CreateIndex({ s_ManifestTable_Table_Name, s_ManifestTable_Index_Separator, value, s_ManifestTable_Index_Suffix });
+        }
+
+        createIndexBuilder.On(s_ManifestTable_Table_Name).Columns(value);
+
+        createIndexBuilder.Execute(connection);
+    }
+
+    bool ManifestTable::ValueIndexExists(const SQLite::Connection& connection, std::string_view value)
+    {
+        std::string indexName{ s_ManifestTable_Table_Name };
+        indexName += s_ManifestTable_Index_Separator;
+        indexName += value;
+        indexName += s_ManifestTable_Index_Suffix;
+
+        SQLite::Builder::StatementBuilder builder;
+        builder.Select(SQLite::Builder::RowCount).From(SQLite::Builder::Schema::MainTable).
+            Where(SQLite::Builder::Schema::TypeColumn).Equals(SQLite::Builder::Schema::Type_Index).And(SQLite::Builder::Schema::NameColumn).Equals(indexName);
+
+        SQLite::Statement statement = builder.Prepare(connection);
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+
+        return (statement.GetColumn<int64_t>(0) != 0);
+    }
+
     bool ManifestTable::IsValueReferenced(const SQLite::Connection& connection, std::string_view valueName, SQLite::rowid_t valueRowId)
     {
         return details::ManifestTableSelectByValueIds(connection, { valueName }, { valueRowId }).has_value();
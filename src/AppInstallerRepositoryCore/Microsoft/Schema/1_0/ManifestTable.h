@@ -59,6 +59,10 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // The second bind value will be the manifest rowid to modify.
         SQLite::Statement ManifestTableUpdateValueIdById_Statement(SQLite::Connection& connection, std::string_view valueName);
 
+        // Prepares a statement to select the rowid of the manifest with the given value in a single column.
+        // The first bind value will be the value to find.
+        SQLite::Statement ManifestTableSelectByValue_Statement(const SQLite::Connection& connection, std::string_view valueName);
+
         // Checks the consistency of the index to ensure that every referenced row exists.
         // Returns true if index is consistent; false if it is not.
         bool ManifestTableCheckConsistency(const SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& target, bool log);
@@ -70,6 +74,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         std::string_view Name;
         bool PrimaryKey;
         bool Unique;
+        // The value index is not created with the table; only valid for values whose index is dropped by PrepareForPackaging.
+        bool Deferred = false;
     };
 
     // Information on a column being added via ALTER TABLE
@@ -115,6 +121,21 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return details::ManifestTableSelectByValueIds(connection, { Tables::ValueName()... }, ids);
         }
 
+        // Select the rowid of the manifest with the given value in the column of the table, which is expected to be unique.
+        template <typename Table>
+        static std::optional<SQLite::rowid_t> SelectByValue(const SQLite::Connection& connection, const typename Table::id_t& value)
+        {
+            auto stmt = details::ManifestTableSelectByValue_Statement(connection, Table::ValueName());
+            stmt.Bind(1, value);
+
+            if (stmt.Step())
+            {
+                return stmt.GetColumn<SQLite::rowid_t>(0);
+            }
+
+            return {};
+        }
+
         // Gets the ids requested for the manifest with the given rowid.
         template <typename... Tables>
         static auto GetIdsById(const SQLite::Connection& connection, SQLite::rowid_t id)
@@ -177,6 +198,15 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // Removes data that is no longer needed for an index that is to be published.
         static void PrepareForPackaging_deprecated(SQLite::Connection& connection, std::initializer_list<std::string_view> values);
 
+        // Creates a single index over the given values, in order, so that queries reading only those values never touch the table.
+        static void CreateCoveringIndex(SQLite::Connection& connection, std::initializer_list<std::string_view> values);
+
+        // Creates an index on a single value, named as those created with the table so that PrepareForPackaging can drop it.
+        static void CreateValueIndex(SQLite::Connection& connection, std::string_view value, bool unique);
+
+        // Determines whether the index created by CreateValueIndex exists for the value.
+        static bool ValueIndexExists(const SQLite::Connection& connection, std::string_view value);
+
         // Checks if the row id is present in the column denoted by the value supplied.
         static bool IsValueReferenced(const SQLite::Connection& connection, std::string_view valueName, SQLite::rowid_t valueRowId);
 
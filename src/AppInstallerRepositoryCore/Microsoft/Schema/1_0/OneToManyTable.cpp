@@ -27,7 +27,32 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 insertMappingBuilder.InsertInto({ tableName, s_OneToManyTable_MapTable_Suffix }).
                     Columns({ s_OneToManyTable_MapTable_ManifestName, valueName }).Values(manifestId, SQLite::Builder::Unbound);
 
-                return insertMappingBuilder.Prepare(connection);
+                return insertMappingBuilder.PrepareCached(connection);
+            }
+
+            void CreateMapTableManifestIndex(SQLite::Connection& connection, std::string_view tableName)
+            {
+                SQLite::Builder::StatementBuilder createMapTableIndexBuilder;
+                createMapTableIndexBuilder.CreateIndex({ tableName, s_OneToManyTable_MapTable_Suffix, s_OneToManyTable_MapTable_IndexSuffix }).
+                    On({ tableName, s_OneToManyTable_MapTable_Suffix }).Columns(s_OneToManyTable_MapTable_ManifestName);
+
+                createMapTableIndexBuilder.Execute(connection);
+            }
+
+            bool MapTableManifestIndexExists(const SQLite::Connection& connection, std::string_view tableName)
+            {
+                std::string indexName{ tableName };
+                indexName += s_OneToManyTable_MapTable_Suffix;
+                indexName += s_OneToManyTable_MapTable_IndexSuffix;
+
+                SQLite::Builder::StatementBuilder builder;
+                builder.Select(SQLite::Builder::RowCount).From(SQLite::Builder::Schema::MainTable).
+                    Where(SQLite::Builder::Schema::TypeColumn).Equals(SQLite::Builder::Schema::Type_Index).And(SQLite::Builder::Schema::NameColumn).Equals(indexName);
+
+                SQLite::Statement statement = builder.Prepare(connection);
+                THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+
+                return (statement.GetColumn<int64_t>(0) != 0);
             }
 
             // Get a collection of the value ids associated with the given manifest id.
@@ -38,7 +63,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 SQLite::Builder::StatementBuilder selectMappingBuilder;
                 selectMappingBuilder.Select(valueName).From({ tableName, s_OneToManyTable_MapTable_Suffix }).Where(s_OneToManyTable_MapTable_ManifestName).Equals(manifestId);
 
-                SQLite::Statement selectMappingStatement = selectMappingBuilder.Prepare(connection);
+                SQLite::Statement selectMappingStatement = selectMappingBuilder.PrepareCached(connection);
 
                 while (selectMappingStatement.Step())
                 {
@@ -98,7 +123,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return s_OneToManyTable_MapTable_ManifestName;
         }
 
-        void CreateOneToManyTable(SQLite::Connection& connection, bool useNamedIndices, std::string_view tableName, std::string_view valueName)
+        void CreateOneToManyTable(SQLite::Connection& connection, bool useNamedIndices, std::string_view tableName, std::string_view valueName, bool deferManifestIndex)
         {
             using namespace SQLite::Builder;
 
@@ -136,11 +161,10 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 createMapTableBuilder.Execute(connection);
             }
 
-            StatementBuilder createMapTableIndexBuilder;
-            createMapTableIndexBuilder.CreateIndex({ tableName, s_OneToManyTable_MapTable_Suffix, s_OneToManyTable_MapTable_IndexSuffix }).
-                On({ tableName, s_OneToManyTable_MapTable_Suffix }).Columns(s_OneToManyTable_MapTable_ManifestName);
-
-            createMapTableIndexBuilder.Execute(connection);
+            if (!useNamedIndices || !deferManifestIndex)
+            {
+                CreateMapTableManifestIndex(connection, tableName);
+            }
 
             savepoint.Commit();
         }
@@ -160,7 +184,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 From({ tableName, s_OneToManyTable_MapTable_Suffix }).As("map").Join(tableName).
                 On(QCol("map", valueName), QCol(tableName, SQLite::RowIDName)).Where(QCol("map", s_OneToManyTable_MapTable_ManifestName)).Equals(manifestId);
 
-            SQLite::Statement statement = builder.Prepare(connection);
+            SQLite::Statement statement = builder.PrepareCached(connection);
 
             while (statement.Step())
             {
@@ -274,13 +298,20 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         void OneToManyTablePrepareForPackaging(SQLite::Connection& connection, std::string_view tableName, bool useNamedIndices, bool preserveManifestIndex, bool preserveValuesIndex)
         {
-            if (!preserveManifestIndex)
+            bool manifestIndexExists = !useNamedIndices || MapTableManifestIndexExists(connection, tableName);
+
+            if (!preserveManifestIndex && manifestIndexExists)
             {
                 SQLite::Builder::StatementBuilder dropMapTableIndexBuilder;
                 dropMapTableIndexBuilder.DropIndex({ tableName, s_OneToManyTable_MapTable_Suffix, s_OneToManyTable_MapTable_IndexSuffix });
 
                 dropMapTableIndexBuilder.Execute(connection);
             }
+            else if (preserveManifestIndex && !manifestIndexExists)
+            {
+                // The index was deferred when the table was created; build it now in a single pass.
+                CreateMapTableManifestIndex(connection, tableName);
+            }
 
             OneToOneTablePrepareForPackaging(connection, tableName, useNamedIndices, preserveValuesIndex);
         }
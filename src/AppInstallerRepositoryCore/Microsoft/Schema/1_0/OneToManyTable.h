@@ -18,7 +18,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         std::string_view OneToManyTableGetManifestColumnName();
 
         // Create the tables.
-        void CreateOneToManyTable(SQLite::Connection& connection, bool useNamedIndices, std::string_view tableName, std::string_view valueName);
+        // If deferManifestIndex is set, the index on the manifest column of the mapping table is only created by PrepareForPackaging, if it is preserved.
+        void CreateOneToManyTable(SQLite::Connection& connection, bool useNamedIndices, std::string_view tableName, std::string_view valueName, bool deferManifestIndex = false);
 
         // Gets all values associated with the given manifest id.
         std::vector<std::string> OneToManyTableGetValuesByManifestId(
@@ -74,9 +75,9 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         }
 
         // Creates the table with named indices.
-        static void Create(SQLite::Connection& connection)
+        static void Create(SQLite::Connection& connection, bool deferManifestIndex = false)
         {
-            details::CreateOneToManyTable(connection, true, TableInfo::TableName(), TableInfo::ValueName());
+            details::CreateOneToManyTable(connection, true, TableInfo::TableName(), TableInfo::ValueName(), deferManifestIndex);
         }
 
         // Creates the table with standard primary keys.
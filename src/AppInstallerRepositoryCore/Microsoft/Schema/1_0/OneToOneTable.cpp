@@ -64,7 +64,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 selectBuilder.Equals(value);
             }
 
-            SQLite::Statement select = selectBuilder.Prepare(connection);
+            SQLite::Statement select = selectBuilder.PrepareCached(connection);
 
             if (select.Step())
             {
@@ -81,7 +81,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             SQLite::Builder::StatementBuilder selectBuilder;
             selectBuilder.Select(valueName).From(tableName).Where(SQLite::RowIDName).Equals(id);
 
-            SQLite::Statement select = selectBuilder.Prepare(connection);
+            SQLite::Statement select = selectBuilder.PrepareCached(connection);
 
             if (select.Step())
             {
@@ -137,7 +137,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             SQLite::Builder::StatementBuilder insertBuilder;
             insertBuilder.InsertInto(tableName).Columns(valueName).Values(value);
 
-            insertBuilder.Execute(connection);
+            insertBuilder.PrepareCached(connection).Execute();
 
             return connection.GetLastInsertRowID();
         }
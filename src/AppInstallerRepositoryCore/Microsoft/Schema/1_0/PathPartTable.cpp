@@ -169,7 +169,23 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return s_PathPartTable_PartValue_Name;
     }
 
-    std::tuple<bool, SQLite::rowid_t> EnsurePathExistsInternal(SQLite::Connection& connection, const std::filesystem::path& relativePath, bool createIfNotFound)
+    void PathPartTable::Cache::Clear()
+    {
+        Roots.clear();
+    }
+
+    void PathPartTable::Cache::Validate(const SQLite::Connection& connection)
+    {
+        uint64_t rollbackCount = connection.GetRollbackCount();
+
+        if (m_rollbackCount != rollbackCount)
+        {
+            Clear();
+            m_rollbackCount = rollbackCount;
+        }
+    }
+
+    std::tuple<bool, SQLite::rowid_t> EnsurePathExistsInternal(SQLite::Connection& connection, const std::filesystem::path& relativePath, bool createIfNotFound, PathPartTable::Cache* cache)
     {
         THROW_HR_IF(E_INVALIDARG, !relativePath.has_relative_path());
         THROW_HR_IF(E_INVALIDARG, relativePath.has_root_path());
@@ -183,10 +199,30 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         bool partsAdded = false;
 
+        // The children of the parent part in the cache, or null once the path leaves what is cached
+        std::map<std::string, PathPartTable::Cache::Node, std::less<>>* cachedChildren = nullptr;
+        if (cache)
+        {
+            cache->Validate(connection);
+            cachedChildren = &cache->Roots;
+        }
+
         std::optional<SQLite::rowid_t> parent;
         for (const auto& part : relativePath)
         {
             std::string utf8part = part.u8string();
+
+            if (cachedChildren)
+            {
+                auto itr = cachedChildren->find(utf8part);
+                if (itr != cachedChildren->end())
+                {
+                    parent = itr->second.Id;
+                    cachedChildren = &itr->second.Children;
+                    continue;
+                }
+            }
+
             std::optional<SQLite::rowid_t> current = SelectPathPart(connection, parent, utf8part);
 
             if (!current)
@@ -204,6 +240,13 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
                 }
             }
 
+            if (cachedChildren)
+            {
+                auto& node = (*cachedChildren)[utf8part];
+                node.Id = current.value();
+                cachedChildren = &node.Children;
+            }
+
             parent = current;
         }
 
@@ -222,7 +265,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         if (relativePath)
         {
-            return EnsurePathExistsInternal(connection, relativePath.value(), createIfNotFound);
+            return EnsurePathExistsInternal(connection, relativePath.value(), createIfNotFound, nullptr);
         }
 
         std::unique_ptr<SQLite::Savepoint> savepoint;
@@ -261,6 +304,16 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return { (createIfNotFound ? partsAdded : true), noPathPart.value() };
     }
 
+    std::tuple<bool, SQLite::rowid_t> PathPartTable::EnsurePathExists(SQLite::Connection& connection, const std::optional<std::filesystem::path>& relativePath, bool createIfNotFound, Cache& cache)
+    {
+        if (relativePath)
+        {
+            return EnsurePathExistsInternal(connection, relativePath.value(), createIfNotFound, &cache);
+        }
+
+        return EnsurePathExists(connection, relativePath, createIfNotFound);
+    }
+
     std::optional<std::string> PathPartTable::GetPathById(const SQLite::Connection& connection, SQLite::rowid_t id)
     {
         SQLite::Builder::StatementBuilder builder;
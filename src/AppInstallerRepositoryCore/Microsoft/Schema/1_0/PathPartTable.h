@@ -3,6 +3,7 @@
 #pragma once
 #include "SQLiteWrapper.h"
 #include <filesystem>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -20,6 +21,29 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // The id used when no path is present.
         constexpr static id_t NoPathId = -1;
 
+        // A trie of the path parts known to exist, from the root part down, used when adding many paths.
+        // It is cleared when a savepoint is rolled back on the connection, or when parts are removed,
+        // as the parts that it holds may no longer exist.
+        struct Cache
+        {
+            struct Node
+            {
+                id_t Id = 0;
+                std::map<std::string, Node, std::less<>> Children;
+            };
+
+            // Removes everything from the cache.
+            void Clear();
+
+            // Clears the cache if a savepoint has been rolled back on the connection since it was last used.
+            void Validate(const SQLite::Connection& connection);
+
+            std::map<std::string, Node, std::less<>> Roots;
+
+        private:
+            std::optional<uint64_t> m_rollbackCount;
+        };
+
         // Creates the table with named indices.
         static void Create(SQLite::Connection& connection);
 
@@ -43,6 +67,9 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // If relativePath is not provided, will always map to an entry with NoPathId.
         static std::tuple<bool, SQLite::rowid_t> EnsurePathExists(SQLite::Connection& connection, const std::optional<std::filesystem::path>& relativePath, bool createIfNotFound);
 
+        // The same as above, but looks up the parts in the cache first, and adds the parts that it finds or creates to it.
+        static std::tuple<bool, SQLite::rowid_t> EnsurePathExists(SQLite::Connection& connection, const std::optional<std::filesystem::path>& relativePath, bool createIfNotFound, Cache& cache);
+
         // Gets the path string using the given id as the leaf.
         static std::optional<std::string> GetPathById(const SQLite::Connection& connection, SQLite::rowid_t id);
 
@@ -7,6 +7,7 @@
 #include "Public/winget/RepositorySearch.h"
 
 #include <optional>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -14,6 +15,7 @@
 namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 {
     // Table for holding temporary search results.
+    // The results are held in memory, and only moved into a temp table if there are too many of them.
     struct SearchResultsTable : public SQLite::TempTable
     {
         SearchResultsTable(const SQLite::Connection& connection);
@@ -24,8 +26,10 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         SearchResultsTable(SearchResultsTable&&) = default;
         SearchResultsTable& operator=(SearchResultsTable&&) = default;
 
+        virtual ~SearchResultsTable() = default;
+
         // Performs the requested search type on the requested field.
-        void SearchOnField(const PackageMatchFilter& filter);
+        virtual void SearchOnField(const PackageMatchFilter& filter);
 
         // Removes rows with manifest ids whose sort order is below the highest one.
         void RemoveDuplicateManifestRows();
@@ -34,17 +38,26 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         void PrepareToFilter();
 
         // Performs the requested filter type on the requested field.
-        void FilterOnField(const PackageMatchFilter& filter);
+        virtual void FilterOnField(const PackageMatchFilter& filter);
 
         // Completes a filtering pass, removing filtered rows.
         void CompleteFilter();
 
+        // Removes all rows, restricting the rows that later searches add to the manifests that were present.
+        // This allows the results to be seeded again, as if that had been done first.
+        // Returns false, leaving the table unchanged, if the rows have been moved into the temp table.
+        bool RestrictToCurrentManifests();
+
         // Gets the results from the table.
-        ISQLiteIndex::SearchResult GetSearchResults(size_t limit = 0);
+        virtual ISQLiteIndex::SearchResult GetSearchResults(size_t limit = 0);
 
     protected:
-        // Builds the search statement for the specified field and match type.
-        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, MatchType match) const;
+        // The aliases that the field specific sub-select must use for the manifest rowid and the matched value.
+        static std::string_view SubSelectManifestAlias();
+        static std::string_view SubSelectValueAlias();
+
+        // Builds the search statement for the specified filter.
+        virtual std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const;
 
         virtual std::vector<int> BuildSearchStatement(
             SQLite::Builder::StatementBuilder& builder,
@@ -59,7 +72,27 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         virtual void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex);
 
     private:
+        // A row of the results while they are held in memory.
+        struct ResultRow
+        {
+            SQLite::rowid_t Manifest;
+            PackageMatchField Field;
+            MatchType Type;
+            std::string Value;
+            int SortValue;
+            bool Filter;
+        };
+
+        // Creates the temp table and moves the in memory rows into it.
+        void MoveRowsToTable();
+
+        // Selects the manifest and value columns of the results of the filter; returns false if the field is not supported.
+        bool SelectForFilter(const PackageMatchFilter& filter, SQLite::Statement& statement);
+
         const SQLite::Connection& m_connection;
         int m_sortOrdinalValue = 0;
+        bool m_useTable = false;
+        std::vector<ResultRow> m_rows;
+        std::optional<std::unordered_set<SQLite::rowid_t>> m_restrictToManifests;
     };
 }
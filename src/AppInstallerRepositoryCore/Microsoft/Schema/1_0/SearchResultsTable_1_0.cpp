@@ -31,13 +31,22 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         constexpr std::string_view s_SearchResultsTable_SubSelect_TableAlias = "valueTable"sv;
         constexpr std::string_view s_SearchResultsTable_SubSelect_ManifestAlias = "m"sv;
         constexpr std::string_view s_SearchResultsTable_SubSelect_ValueAlias = "v"sv;
+
+        // Searches usually find a few hundred rows; past this many they are moved into the temp table.
+        constexpr size_t s_SearchResultsTable_MaximumInMemoryRows = 10000;
     }
 
     SearchResultsTable::SearchResultsTable(const SQLite::Connection& connection) :
         m_connection(connection)
+    {
+    }
+
+    void SearchResultsTable::MoveRowsToTable()
     {
         using namespace SQLite::Builder;
 
+        AICLI_LOG(Repo, Verbose, << "Moving " << m_rows.size() << " search result rows into a temp table");
+
         {
             StatementBuilder builder;
             builder.CreateTable(GetQualifiedName()).BeginColumns();
@@ -67,6 +76,62 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
             builder.Execute(m_connection);
         }
+
+        {
+            StatementBuilder builder;
+            builder.InsertInto(GetQualifiedName()).Columns({
+                s_SearchResultsTable_Manifest,
+                s_SearchResultsTable_MatchField,
+                s_SearchResultsTable_MatchType,
+                s_SearchResultsTable_MatchValue,
+                s_SearchResultsTable_SortValue,
+                s_SearchResultsTable_Filter }).Values(Unbound, Unbound, Unbound, Unbound, Unbound, Unbound);
+
+            SQLite::Statement insert = builder.Prepare(m_connection);
+
+            for (const auto& row : m_rows)
+            {
+                insert.Reset();
+                insert.Bind(1, row.Manifest);
+                insert.Bind(2, row.Field);
+                insert.Bind(3, row.Type);
+                insert.Bind(4, row.Value);
+                insert.Bind(5, row.SortValue);
+                insert.Bind(6, row.Filter);
+                insert.Execute();
+            }
+        }
+
+        m_rows.clear();
+        m_rows.shrink_to_fit();
+        m_useTable = true;
+    }
+
+    bool SearchResultsTable::SelectForFilter(const PackageMatchFilter& filter, SQLite::Statement& statement)
+    {
+        using namespace SQLite::Builder;
+
+        // Select directly from the field specific sub-select:
+        //      SELECT valueTable.m, valueTable.v FROM (<sub-select>) AS valueTable
+        StatementBuilder builder;
+        builder.Select().
+            Column(QualifiedColumn(s_SearchResultsTable_SubSelect_TableAlias, s_SearchResultsTable_SubSelect_ManifestAlias)).
+            Column(QualifiedColumn(s_SearchResultsTable_SubSelect_TableAlias, s_SearchResultsTable_SubSelect_ValueAlias)).
+        From().BeginParenthetical();
+
+        std::vector<int> bindIndex = BuildSearchStatement(builder, filter);
+
+        if (bindIndex.empty())
+        {
+            AICLI_LOG(Repo, Verbose, << "PackageMatchField not supported in this version: " << ToString(filter.Field));
+            return false;
+        }
+
+        builder.EndParenthetical().As(s_SearchResultsTable_SubSelect_TableAlias);
+
+        statement = builder.Prepare(m_connection);
+        BindStatementForMatchType(statement, filter, bindIndex);
+        return true;
     }
 
     void SearchResultsTable::SearchOnField(const PackageMatchFilter& filter)
@@ -75,6 +140,37 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         int sortOrdinal = m_sortOrdinalValue++;
 
+        if (!m_useTable)
+        {
+            SQLite::Statement select;
+            if (!SelectForFilter(filter, select))
+            {
+                return;
+            }
+
+            size_t previousCount = m_rows.size();
+            while (select.Step())
+            {
+                SQLite::rowid_t manifest = select.GetColumn<SQLite::rowid_t>(0);
+                if (m_restrictToManifests && m_restrictToManifests->count(manifest) == 0)
+                {
+                    continue;
+                }
+
+                m_rows.emplace_back(ResultRow{ manifest, filter.Field, filter.Type, select.GetColumn<std::string>(1), sortOrdinal, false });
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Search found " << (m_rows.size() - previousCount) << " rows");
+
+            // A restricted search cannot be moved into the table, as the restriction only applies to the rows held in memory.
+            if (!m_restrictToManifests && m_rows.size() > s_SearchResultsTable_MaximumInMemoryRows)
+            {
+                MoveRowsToTable();
+            }
+
+            return;
+        }
+
         // Create an insert statement to select values into the table as requested.
         // The goal is a statement like this:
         //      INSERT INTO <tempTable>
@@ -92,7 +188,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         From().BeginParenthetical();
 
         // Add the field specific portion
-        std::vector<int> bindIndex = BuildSearchStatement(builder, filter.Field, filter.Type);
+        std::vector<int> bindIndex = BuildSearchStatement(builder, filter);
 
         if (bindIndex.empty())
         {
@@ -112,6 +208,18 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         using namespace SQLite::Builder;
 
+        if (!m_useTable)
+        {
+            // Rows are added in sort order, so the first row for each manifest has the lowest sort order
+            std::unordered_set<SQLite::rowid_t> seenManifests;
+            size_t previousCount = m_rows.size();
+
+            m_rows.erase(std::remove_if(m_rows.begin(), m_rows.end(), [&](const ResultRow& row) { return !seenManifests.insert(row.Manifest).second; }), m_rows.end());
+
+            AICLI_LOG(Repo, Verbose, << "Removed " << (previousCount - m_rows.size()) << " duplicate rows");
+            return;
+        }
+
         // Create a delete statement to leave only one row with a given manifest.
         // This will arbitrarily choose one of the rows if multiple have the same lowest sort order.
         // The goal is a statement like this:
@@ -133,6 +241,16 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
     void SearchResultsTable::PrepareToFilter()
     {
+        if (!m_useTable)
+        {
+            for (auto& row : m_rows)
+            {
+                row.Filter = false;
+            }
+
+            return;
+        }
+
         // Reset all filter values to unselected
         SQLite::Builder::StatementBuilder builder;
         builder.Update(GetQualifiedName()).Set().Column(s_SearchResultsTable_Filter).Equals(false);
@@ -144,6 +262,34 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         using namespace SQLite::Builder;
 
+        if (!m_useTable)
+        {
+            SQLite::Statement select;
+            if (!SelectForFilter(filter, select))
+            {
+                return;
+            }
+
+            std::unordered_set<SQLite::rowid_t> foundManifests;
+            while (select.Step())
+            {
+                foundManifests.insert(select.GetColumn<SQLite::rowid_t>(0));
+            }
+
+            size_t keptCount = 0;
+            for (auto& row : m_rows)
+            {
+                if (!row.Filter && foundManifests.count(row.Manifest))
+                {
+                    row.Filter = true;
+                    ++keptCount;
+                }
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Filter kept " << keptCount << " rows");
+            return;
+        }
+
         // Create an update statement to mark rows that are found by the search.
         // This will arbitrarily choose one of the rows if multiple have the same lowest sort order.
         // The goal is a statement like this:
@@ -157,7 +303,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             Select(s_SearchResultsTable_SubSelect_ManifestAlias).From().BeginParenthetical();
 
         // Add the field specific portion
-        std::vector<int> bindIndex = BuildSearchStatement(builder, filter.Field, filter.Type);
+        std::vector<int> bindIndex = BuildSearchStatement(builder, filter);
 
         if (bindIndex.empty())
         {
@@ -175,6 +321,15 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
     void SearchResultsTable::CompleteFilter()
     {
+        if (!m_useTable)
+        {
+            size_t previousCount = m_rows.size();
+            m_rows.erase(std::remove_if(m_rows.begin(), m_rows.end(), [](const ResultRow& row) { return !row.Filter; }), m_rows.end());
+
+            AICLI_LOG(Repo, Verbose, << "Filter deleted " << (previousCount - m_rows.size()) << " rows");
+            return;
+        }
+
         // Delete all unselected values
         SQLite::Builder::StatementBuilder builder;
         builder.DeleteFrom(GetQualifiedName()).Where(s_SearchResultsTable_Filter).Equals(false);
@@ -183,10 +338,57 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         AICLI_LOG(Repo, Verbose, << "Filter deleted " << m_connection.GetChanges() << " rows");
     }
 
+    bool SearchResultsTable::RestrictToCurrentManifests()
+    {
+        if (m_useTable)
+        {
+            return false;
+        }
+
+        std::unordered_set<SQLite::rowid_t> manifests;
+        for (const auto& row : m_rows)
+        {
+            manifests.insert(row.Manifest);
+        }
+
+        m_rows.clear();
+        m_restrictToManifests = std::move(manifests);
+        return true;
+    }
+
     ISQLiteIndex::SearchResult SearchResultsTable::GetSearchResults(size_t limit)
     {
         constexpr std::string_view tempTableAlias = "t"sv;
 
+        if (!m_useTable)
+        {
+            // As with the table, keep only the earliest match of each id, and order the ids by that match.
+            // Rows are in sort order already, so the first row seen for an id is the one with the lowest sort order.
+            std::unordered_set<SQLite::rowid_t> seenIds;
+
+            ISQLiteIndex::SearchResult result;
+
+            for (const auto& row : m_rows)
+            {
+                SQLite::rowid_t id = std::get<0>(ManifestTable::GetIdsById<IdTable>(m_connection, row.Manifest));
+
+                if (!seenIds.insert(id).second)
+                {
+                    continue;
+                }
+
+                if (limit && result.Matches.size() >= limit)
+                {
+                    result.Truncated = true;
+                    break;
+                }
+
+                result.Matches.emplace_back(id, PackageMatchFilter(row.Field, row.Type, row.Value));
+            }
+
+            return result;
+        }
+
         using namespace SQLite::Builder;
         using QCol = QualifiedColumn;
 
@@ -225,9 +427,19 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return result;
     }
 
-    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, MatchType match) const
+    std::string_view SearchResultsTable::SubSelectManifestAlias()
+    {
+        return s_SearchResultsTable_SubSelect_ManifestAlias;
+    }
+
+    std::string_view SearchResultsTable::SubSelectValueAlias()
+    {
+        return s_SearchResultsTable_SubSelect_ValueAlias;
+    }
+
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
     {
-        return BuildSearchStatement(builder, field, s_SearchResultsTable_SubSelect_ManifestAlias, s_SearchResultsTable_SubSelect_ValueAlias, MatchUsesLike(match));
+        return BuildSearchStatement(builder, filter.Field, s_SearchResultsTable_SubSelect_ManifestAlias, s_SearchResultsTable_SubSelect_ValueAlias, MatchUsesLike(filter.Type));
     }
 
     std::vector<int> SearchResultsTable::BuildSearchStatement(
@@ -71,6 +71,9 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
     {
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_1");
 
+        bool deferIndices = WI_IsFlagSet(options, CreateOptions::DeferIndices);
+        bool pathUnique = WI_IsFlagClear(options, CreateOptions::SupportPathless);
+
         V1_0::IdTable::Create(connection);
         V1_0::NameTable::Create(connection);
         V1_0::MonikerTable::Create(connection);
@@ -83,15 +86,16 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
             { V1_0::IdTable::ValueName(), true, false },
             { V1_0::NameTable::ValueName(), false, false },
             { V1_0::MonikerTable::ValueName(), false, false },
-            { V1_0::VersionTable::ValueName(), true, false },
-            { V1_0::ChannelTable::ValueName(), true, false },
-            { V1_0::PathPartTable::ValueName(), false, WI_IsFlagClear(options, CreateOptions::SupportPathless) }
+            { V1_0::VersionTable::ValueName(), true, false, deferIndices },
+            { V1_0::ChannelTable::ValueName(), true, false, deferIndices },
+            // A unique index also rejects duplicate paths as they are added, so it is never deferred
+            { V1_0::PathPartTable::ValueName(), false, pathUnique, deferIndices && !pathUnique }
             });
 
-        V1_0::TagsTable::Create(connection);
-        V1_0::CommandsTable::Create(connection);
-        PackageFamilyNameTable::Create(connection);
-        ProductCodeTable::Create(connection);
+        V1_0::TagsTable::Create(connection, deferIndices);
+        V1_0::CommandsTable::Create(connection, deferIndices);
+        PackageFamilyNameTable::Create(connection, deferIndices);
+        ProductCodeTable::Create(connection, deferIndices);
 
         savepoint.Commit();
     }
@@ -261,6 +265,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
     void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
     {
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_1");
+        m_pathPartCache.Clear();
 
         V1_0::IdTable::PrepareForPackaging(connection);
         V1_0::NameTable::PrepareForPackaging(connection);
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/ISQLiteIndex.h"
+#include "Microsoft/Schema/1_9/Interface.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_10
+{
+    // Interface to this schema version exposed through ISQLiteIndex.
+    struct Interface : public V1_9::Interface
+    {
+        Interface(Utility::NormalizationVersion normVersion = Utility::NormalizationVersion::Initial);
+
+        // Version 1.0
+        Schema::Version GetVersion() const override;
+        void CreateTables(SQLite::Connection& connection, CreateOptions options) override;
+        std::pair<bool, SQLite::rowid_t> UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
+        void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
+        void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
+
+        // Version 1.10
+        bool IsManifestContentSupported(const SQLite::Connection& connection) const override;
+        void SetManifestContentById(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view content) override;
+        std::optional<std::string> GetManifestContentById(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
+        void SetManifestContentVersions(SQLite::Connection& connection, uint32_t versions) override;
+    };
+}
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_10/Interface.h"
+
+#include "Microsoft/Schema/MetadataTable.h"
+#include "Microsoft/Schema/1_10/ManifestContentTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_10
+{
+    namespace
+    {
+        // Unless the index is told otherwise, only the content of the highest version of each package is kept.
+        constexpr uint32_t s_DefaultManifestContentVersions = 1;
+    }
+
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_9::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 10 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_10");
+
+        V1_9::Interface::CreateTables(connection, options);
+
+        // The content makes the index much larger, so it is only stored when the index is built to carry it.
+        if (WI_IsFlagSet(options, CreateOptions::ManifestContentSupport))
+        {
+            ManifestContentTable::Create(connection);
+            MetadataTable::SetNamedValue(connection, s_MetadataValueName_ManifestContentVersions, static_cast<int64_t>(s_DefaultManifestContentVersions));
+        }
+
+        savepoint.Commit();
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_10");
+
+        auto [indexModified, manifestId] = V1_9::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        // The existing content no longer matches the manifest; it is replaced if the caller has the new content.
+        if (ManifestContentTable::Exists(connection))
+        {
+            ManifestContentTable::DeleteByManifestId(connection, manifestId);
+        }
+
+        savepoint.Commit();
+
+        return { indexModified, manifestId };
+    }
+
+    void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "removemanifest_v1_10");
+
+        V1_9::Interface::RemoveManifestById(connection, manifestId);
+
+        if (ManifestContentTable::Exists(connection))
+        {
+            ManifestContentTable::DeleteByManifestId(connection, manifestId);
+        }
+
+        savepoint.Commit();
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        if (ManifestContentTable::Exists(connection))
+        {
+            SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_10");
+
+            // The versions are ordered by their keys, so the content must be trimmed before those are.
+            int64_t versions = MetadataTable::GetNamedValue<int64_t>(connection, s_MetadataValueName_ManifestContentVersions);
+            ManifestContentTable::KeepLatestVersions(connection, static_cast<uint32_t>(versions));
+
+            savepoint.Commit();
+        }
+
+        // The vacuum must be done outside of an active transaction.
+        V1_9::Interface::PrepareForPackaging(connection, vacuum);
+    }
+
+    bool Interface::IsManifestContentSupported(const SQLite::Connection& connection) const
+    {
+        return ManifestContentTable::Exists(connection);
+    }
+
+    void Interface::SetManifestContentById(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view content)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED), !ManifestContentTable::Exists(connection));
+        ManifestContentTable::SetContentByManifestId(connection, manifestId, content);
+    }
+
+    std::optional<std::string> Interface::GetManifestContentById(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const
+    {
+        if (!ManifestContentTable::Exists(connection))
+        {
+            return {};
+        }
+
+        return ManifestContentTable::GetContentByManifestId(connection, manifestId);
+    }
+
+    void Interface::SetManifestContentVersions(SQLite::Connection& connection, uint32_t versions)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED), !ManifestContentTable::Exists(connection));
+        MetadataTable::SetNamedValue(connection, s_MetadataValueName_ManifestContentVersions, static_cast<int64_t>(versions));
+    }
+}
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "ManifestContentTable.h"
+#include "SQLiteStatementBuilder.h"
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/VersionTable.h"
+#include "Microsoft/Schema/1_6/VersionKeyTable.h"
+
+#include <compressapi.h>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_10
+{
+    using namespace SQLite;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_ManifestContentTable_Table_Name = "manifest_content"sv;
+    static constexpr std::string_view s_ManifestContentTable_Content_Column = "content"sv;
+
+    namespace
+    {
+        using unique_compressor_handle = wil::unique_any<COMPRESSOR_HANDLE, decltype(&::CloseCompressor), ::CloseCompressor>;
+        using unique_decompressor_handle = wil::unique_any<DECOMPRESSOR_HANDLE, decltype(&::CloseDecompressor), ::CloseDecompressor>;
+
+        // Manifests are mostly repeated keys and short strings, which XPRESS with Huffman coding handles well while staying fast to decompress.
+        constexpr DWORD s_ManifestContentCompressionAlgorithm = COMPRESS_ALGORITHM_XPRESS_HUFF;
+
+        blob_t Compress(std::string_view content)
+        {
+            unique_compressor_handle compressor;
+            THROW_LAST_ERROR_IF(!CreateCompressor(s_ManifestContentCompressionAlgorithm, nullptr, &compressor));
+
+            SIZE_T compressedSize = 0;
+            if (!::Compress(compressor.get(), content.data(), content.size(), nullptr, 0, &compressedSize))
+            {
+                THROW_LAST_ERROR_IF(GetLastError() != ERROR_INSUFFICIENT_BUFFER);
+            }
+
+            blob_t result(compressedSize);
+            THROW_LAST_ERROR_IF(!::Compress(compressor.get(), content.data(), content.size(), result.data(), result.size(), &compressedSize));
+            result.resize(compressedSize);
+
+            return result;
+        }
+
+        std::string Decompress(const blob_t& compressed)
+        {
+            unique_decompressor_handle decompressor;
+            THROW_LAST_ERROR_IF(!CreateDecompressor(s_ManifestContentCompressionAlgorithm, nullptr, &decompressor));
+
+            SIZE_T contentSize = 0;
+            if (!::Decompress(decompressor.get(), compressed.data(), compressed.size(), nullptr, 0, &contentSize))
+            {
+                THROW_LAST_ERROR_IF(GetLastError() != ERROR_INSUFFICIENT_BUFFER);
+            }
+
+            std::string result(contentSize, '\0');
+            THROW_LAST_ERROR_IF(!::Decompress(decompressor.get(), compressed.data(), compressed.size(), result.data(), result.size(), &contentSize));
+            result.resize(contentSize);
+
+            return result;
+        }
+    }
+
+    std::string_view ManifestContentTable::TableName()
+    {
+        return s_ManifestContentTable_Table_Name;
+    }
+
+    bool ManifestContentTable::Exists(const SQLite::Connection& connection)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+            Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals(s_ManifestContentTable_Table_Name);
+
+        Statement statement = builder.Prepare(connection);
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+        return statement.GetColumn<int64_t>(0) != 0;
+    }
+
+    void ManifestContentTable::Create(SQLite::Connection& connection)
+    {
+        using namespace SQLite::Builder;
+
+        StatementBuilder builder;
+        builder.CreateTable(s_ManifestContentTable_Table_Name).Columns({
+            IntegerPrimaryKey(),
+            ColumnBuilder(s_ManifestContentTable_Content_Column, Type::Blob).NotNull()
+            });
+
+        builder.Execute(connection);
+    }
+
+    std::optional<std::string> ManifestContentTable::GetContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(s_ManifestContentTable_Content_Column).From(s_ManifestContentTable_Table_Name).Where(SQLite::RowIDName).Equals(manifestId);
+
+        Statement select = builder.Prepare(connection);
+        if (select.Step())
+        {
+            return Decompress(select.GetColumn<blob_t>(0));
+        }
+
+        return {};
+    }
+
+    void ManifestContentTable::SetContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view content)
+    {
+        DeleteByManifestId(connection, manifestId);
+
+        Builder::StatementBuilder builder;
+        builder.InsertInto(s_ManifestContentTable_Table_Name).
+            Columns({ SQLite::RowIDName, s_ManifestContentTable_Content_Column }).
+            Values(manifestId, Compress(content));
+
+        builder.Execute(connection);
+    }
+
+    void ManifestContentTable::DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        Builder::StatementBuilder builder;
+        builder.DeleteFrom(s_ManifestContentTable_Table_Name).Where(SQLite::RowIDName).Equals(manifestId);
+
+        builder.Execute(connection);
+    }
+
+    void ManifestContentTable::KeepLatestVersions(SQLite::Connection& connection, uint32_t versions)
+    {
+        using namespace SQLite::Builder;
+        using QCol = QualifiedColumn;
+
+        std::string_view manifestTable = V1_0::ManifestTable::TableName();
+        std::string_view versionKeyTable = V1_6::VersionKeyTable::TableName();
+
+        // SELECT manifest_content.rowid, manifest.id FROM manifest_content
+        // JOIN manifest ON manifest_content.rowid = manifest.rowid
+        // JOIN version_keys ON manifest.version = version_keys.rowid
+        // ORDER BY manifest.id, version_keys.key DESC
+        StatementBuilder builder;
+        builder.Select({ QCol(s_ManifestContentTable_Table_Name, SQLite::RowIDName), QCol(manifestTable, V1_0::IdTable::ValueName()) }).
+            From(s_ManifestContentTable_Table_Name).
+            Join(manifestTable).On(QCol(s_ManifestContentTable_Table_Name, SQLite::RowIDName), QCol(manifestTable, SQLite::RowIDName)).
+            Join(versionKeyTable).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(versionKeyTable, SQLite::RowIDName)).
+            OrderBy({ QCol(manifestTable, V1_0::IdTable::ValueName()), QCol(versionKeyTable, V1_6::VersionKeyTable::KeyName()) }).Descending();
+
+        Statement select = builder.Prepare(connection);
+
+        std::vector<SQLite::rowid_t> toRemove;
+        std::optional<SQLite::rowid_t> currentId;
+        uint32_t kept = 0;
+
+        while (select.Step())
+        {
+            auto [manifestId, id] = select.GetRow<SQLite::rowid_t, SQLite::rowid_t>();
+
+            if (currentId != id)
+            {
+                currentId = id;
+                kept = 0;
+            }
+
+            if (kept < versions)
+            {
+                ++kept;
+            }
+            else
+            {
+                toRemove.push_back(manifestId);
+            }
+        }
+
+        for (SQLite::rowid_t manifestId : toRemove)
+        {
+            DeleteByManifestId(connection, manifestId);
+        }
+
+        AICLI_LOG(Repo, Info, << "Removed the content of " << toRemove.size() << " manifests beyond the latest " << versions << " versions of each package");
+    }
+}
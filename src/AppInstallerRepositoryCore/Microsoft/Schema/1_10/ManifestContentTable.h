@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_10
+{
+    // A table holding the compressed content of the manifest file of each manifest, so that it can be read without downloading it.
+    // The rowid of each row is the rowid of the manifest. The table is optional, and only created when requested.
+    struct ManifestContentTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Determine if the table currently exists in the database.
+        static bool Exists(const SQLite::Connection& connection);
+
+        // Creates the table.
+        static void Create(SQLite::Connection& connection);
+
+        // Gets the decompressed content for the given manifest, if it has one.
+        static std::optional<std::string> GetContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Compresses and sets the content for the given manifest, replacing any existing content.
+        static void SetContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view content);
+
+        // Removes the content for the given manifest.
+        static void DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Removes the content of all but the given number of the highest versions of each package.
+        static void KeepLatestVersions(SQLite::Connection& connection, uint32_t versions);
+    };
+}
@@ -117,8 +117,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_2
         // This will mean that one can match cross locale name and publisher, but the chance that this
         // leads to a confusion between packages is very small. More likely would be intentional attempts
         // to confuse the correlation, which could be fairly easily carried out even with linked values.
-        NormalizedPackageNameTable::Create(connection);
-        NormalizedPackagePublisherTable::Create(connection);
+        NormalizedPackageNameTable::Create(connection, WI_IsFlagSet(options, CreateOptions::DeferIndices));
+        NormalizedPackagePublisherTable::Create(connection, WI_IsFlagSet(options, CreateOptions::DeferIndices));
 
         savepoint.Commit();
     }
@@ -168,20 +168,12 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_2
         savepoint.Commit();
     }
 
-    bool Interface::CheckConsistency(const SQLite::Connection& connection, bool log) const
+    std::vector<ISQLiteIndex::ConsistencyCheck> Interface::GetConsistencyChecks() const
     {
-        bool result = V1_1::Interface::CheckConsistency(connection, log);
+        std::vector<ConsistencyCheck> result = V1_1::Interface::GetConsistencyChecks();
 
-        // If the v1.1 index was consistent, or if full logging of inconsistency was requested, check the v1.2 data.
-        if (result || log)
-        {
-            result = NormalizedPackageNameTable::CheckConsistency(connection, log) && result;
-        }
-
-        if (result || log)
-        {
-            result = NormalizedPackagePublisherTable::CheckConsistency(connection, log) && result;
-        }
+        result.push_back({ "norm_names", [](const SQLite::Connection& connection, bool log) { return NormalizedPackageNameTable::CheckConsistency(connection, log); } });
+        result.push_back({ "norm_publishers", [](const SQLite::Connection& connection, bool log) { return NormalizedPackagePublisherTable::CheckConsistency(connection, log); } });
 
         return result;
     }
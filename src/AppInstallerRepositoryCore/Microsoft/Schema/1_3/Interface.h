@@ -17,9 +17,18 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_3
         void CreateTables(SQLite::Connection& connection, CreateOptions options) override;
         SQLite::rowid_t AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
         std::pair<bool, SQLite::rowid_t> UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
-        
+
+        // Version 1.3
+        std::optional<SQLite::rowid_t> GetManifestIdByHash(const SQLite::Connection& connection, const SQLite::blob_t& hash) const override;
+
     protected:
         // Gets a property already knowing that the manifest id is valid.
         std::optional<std::string> GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const override;
+
+        void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
+
+    private:
+        // Whether the manifest hashes are indexed; indexes created before the index was added only have the column.
+        mutable std::optional<bool> m_manifestHashIndexed;
     };
 }
@@ -26,6 +26,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_3
         V1_2::Interface::CreateTables(connection, options);
 
         V1_0::ManifestTable::AddColumn(connection, { HashVirtualTable::ValueName(), HashVirtualTable::SQLiteType() });
+        V1_0::ManifestTable::CreateValueIndex(connection, HashVirtualTable::ValueName(), true);
+        m_manifestHashIndexed.reset();
 
         savepoint.Commit();
     }
@@ -74,6 +76,48 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_3
         return { indexModified, manifestId };
     }
 
+    std::optional<SQLite::rowid_t> Interface::GetManifestIdByHash(const SQLite::Connection& connection, const SQLite::blob_t& hash) const
+    {
+        THROW_HR_IF(E_INVALIDARG, hash.size() != Utility::SHA256::HashBufferSizeInBytes);
+
+        if (!m_manifestHashIndexed)
+        {
+            m_manifestHashIndexed = V1_0::ManifestTable::ValueIndexExists(connection, HashVirtualTable::ValueName());
+        }
+
+        if (!m_manifestHashIndexed.value())
+        {
+            return {};
+        }
+
+        return V1_0::ManifestTable::SelectByValue<HashVirtualTable>(connection, hash);
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_3");
+
+        V1_2::Interface::PrepareForPackaging(connection, false);
+
+        // Hash lookups are only used to maintain the index, so the index on them is not needed once published.
+        if (V1_0::ManifestTable::ValueIndexExists(connection, HashVirtualTable::ValueName()))
+        {
+            V1_0::ManifestTable::PrepareForPackaging_deprecated(connection, { HashVirtualTable::ValueName() });
+        }
+        m_manifestHashIndexed.reset();
+
+        savepoint.Commit();
+
+        if (vacuum)
+        {
+            // Force the database to actually shrink the file size.
+            // This *must* be done outside of an active transaction.
+            SQLite::Builder::StatementBuilder builder;
+            builder.Vacuum();
+            builder.Execute(connection);
+        }
+    }
+
     std::optional<std::string> Interface::GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const
     {
         switch (property)
@@ -25,6 +25,47 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
     static constexpr std::string_view s_DependenciesTable_MinVersion_Column_Name = "min_version"sv;
     static constexpr std::string_view s_DependenciesTable_PackageId_Column_Name = "package_id";
 
+    // The closure is built over package ids, which ends on its own when there is a loop, as UNION drops the rows that were already found.
+    // A manifest's dependencies lead to every version of the packages it depends on, as the version is not chosen until install.
+    static char const* const s_DependenciesTable_DependencyClosure = R"(
+WITH RECURSIVE [closure]([package]) AS (
+    SELECT [package_id] FROM [dependencies] WHERE [manifest] = ?1
+    UNION
+    SELECT [dep].[package_id] FROM [dependencies] AS [dep]
+    JOIN [manifest] AS [man] ON [dep].[manifest] = [man].[rowid]
+    JOIN [closure] ON [man].[id] = [closure].[package]
+)
+SELECT [dep].[manifest], [dep].[package_id], [minV].[version] FROM [dependencies] AS [dep]
+LEFT JOIN [versions] AS [minV] ON [dep].[min_version] = [minV].[rowid]
+WHERE [dep].[manifest] = ?1 OR [dep].[manifest] IN (SELECT [rowid] FROM [manifest] WHERE [id] IN (SELECT [package] FROM [closure]))
+)";
+
+    static char const* const s_DependenciesTable_DependentClosure = R"(
+WITH RECURSIVE [closure]([package]) AS (
+    SELECT [rowid] FROM [ids] WHERE [id] = ?1
+    UNION
+    SELECT [man].[id] FROM [dependencies] AS [dep]
+    JOIN [manifest] AS [man] ON [dep].[manifest] = [man].[rowid]
+    JOIN [closure] ON [dep].[package_id] = [closure].[package]
+)
+SELECT [dep].[manifest], [dep].[package_id], [minV].[version] FROM [dependencies] AS [dep]
+LEFT JOIN [versions] AS [minV] ON [dep].[min_version] = [minV].[rowid]
+WHERE [dep].[package_id] IN (SELECT [package] FROM [closure])
+)";
+
+    static char const* const s_DependenciesTable_AllDependencies = R"(
+SELECT [dep].[manifest], [dep].[package_id], [minV].[version] FROM [dependencies] AS [dep]
+LEFT JOIN [versions] AS [minV] ON [dep].[min_version] = [minV].[rowid]
+)";
+
+    static char const* const s_DependenciesTable_DependedOnManifests = R"(
+SELECT [man].[rowid], [man].[id], [ids].[id], [versions].[version], [channels].[channel] FROM [manifest] AS [man]
+JOIN [ids] ON [man].[id] = [ids].[rowid]
+JOIN [versions] ON [man].[version] = [versions].[rowid]
+JOIN [channels] ON [man].[channel] = [channels].[rowid]
+WHERE [man].[id] IN (SELECT DISTINCT [package_id] FROM [dependencies])
+)";
+
     namespace
     {
         struct DependencyTableRow 
@@ -44,6 +85,24 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
             }
         };
 
+        std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> ReadDependencyClosure(SQLite::Statement& statement)
+        {
+            std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> result;
+
+            while (statement.Step())
+            {
+                auto& entry = result.emplace_back();
+                entry.ManifestId = statement.GetColumn<SQLite::rowid_t>(0);
+                entry.PackageId = statement.GetColumn<SQLite::rowid_t>(1);
+                if (!statement.GetColumnIsNull(2))
+                {
+                    entry.MinVersion = statement.GetColumn<std::string>(2);
+                }
+            }
+
+            return result;
+        }
+
         void ThrowOnMissingPackageNodes(std::vector<Manifest::Dependency>& missingPackageNodes)
         {
             if (!missingPackageNodes.empty())
@@ -393,6 +452,56 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
         return resultSet;
     }
 
+    std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> DependenciesTable::GetDependencyClosureByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId)
+    {
+        if (!Exists(connection))
+        {
+            return {};
+        }
+
+        SQLite::Statement select = SQLite::Statement::Create(connection, s_DependenciesTable_DependencyClosure);
+        select.Bind(1, manifestRowId);
+        return ReadDependencyClosure(select);
+    }
+
+    std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> DependenciesTable::GetDependentClosureById(const SQLite::Connection& connection, Manifest::string_t packageId)
+    {
+        if (!Exists(connection))
+        {
+            return {};
+        }
+
+        SQLite::Statement select = SQLite::Statement::Create(connection, s_DependenciesTable_DependentClosure);
+        select.Bind(1, std::string{ packageId });
+        return ReadDependencyClosure(select);
+    }
+
+    Schema::ISQLiteIndex::DependencySnapshot DependenciesTable::GetDependencySnapshot(const SQLite::Connection& connection)
+    {
+        Schema::ISQLiteIndex::DependencySnapshot result;
+
+        if (!Exists(connection))
+        {
+            return result;
+        }
+
+        SQLite::Statement selectDependencies = SQLite::Statement::Create(connection, s_DependenciesTable_AllDependencies);
+        result.Dependencies = ReadDependencyClosure(selectDependencies);
+
+        SQLite::Statement selectManifests = SQLite::Statement::Create(connection, s_DependenciesTable_DependedOnManifests);
+        while (selectManifests.Step())
+        {
+            auto& entry = result.Manifests.emplace_back();
+            entry.ManifestId = selectManifests.GetColumn<SQLite::rowid_t>(0);
+            entry.PackageId = selectManifests.GetColumn<SQLite::rowid_t>(1);
+            entry.Id = selectManifests.GetColumn<std::string>(2);
+            entry.Version = selectManifests.GetColumn<std::string>(3);
+            entry.Channel = selectManifests.GetColumn<std::string>(4);
+        }
+
+        return result;
+    }
+
     void DependenciesTable::PrepareForPackaging(SQLite::Connection& connection)
     {
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareForPacking_V1_4");
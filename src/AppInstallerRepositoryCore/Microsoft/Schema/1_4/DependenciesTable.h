@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "SQLiteWrapper.h"
 #include "SQLiteStatementBuilder.h"
+#include "Microsoft/Schema/ISQLiteIndex.h"
 #include <winget/Manifest.h>
 
 namespace AppInstaller::Repository::Microsoft::Schema::V1_4
@@ -40,6 +41,15 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
         // Get dependencies by package id.
         static std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId);
 
+        // Get the dependencies of the manifest, and those of every version of the packages in its dependency closure, with a single query.
+        static std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> GetDependencyClosureByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId);
+
+        // Get the dependencies on the package, and on every package that depends on it transitively, with a single query.
+        static std::vector<Schema::ISQLiteIndex::DependencyClosureEntry> GetDependentClosureById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId);
+
+        // Get every dependency, and the version keys of every package that is depended on, so that a graph can be walked without further queries.
+        static Schema::ISQLiteIndex::DependencySnapshot GetDependencySnapshot(const SQLite::Connection& connection);
+
         // Check dependencies table consistency.
         static bool DependenciesTableCheckConsistency(const SQLite::Connection& connection, bool log);
 
@@ -18,11 +18,14 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
         SQLite::rowid_t AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
         std::pair<bool, SQLite::rowid_t> UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
         void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
-        bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
+        std::vector<ConsistencyCheck> GetConsistencyChecks() const override;
         void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
 
         std::set<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependenciesByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const override;
         std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const override;
+        std::vector<DependencyClosureEntry> GetDependencyClosureByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const override;
+        std::vector<DependencyClosureEntry> GetDependentClosureById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const override;
+        DependencySnapshot GetDependencySnapshot(const SQLite::Connection& connection) const override;
 
         bool NotNeeded(const SQLite::Connection& connection, std::string_view tableName, std::string_view valueName, SQLite::rowid_t id) const override;
     };
@@ -95,7 +95,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
     {
         SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_4");
 
-        V1_2::Interface::PrepareForPackaging(connection, false);
+        V1_3::Interface::PrepareForPackaging(connection, false);
 
         DependenciesTable::PrepareForPackaging(connection);
 
@@ -111,15 +111,11 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
         }
     }
 
-    bool Interface::CheckConsistency(const SQLite::Connection& connection, bool log) const
+    std::vector<ISQLiteIndex::ConsistencyCheck> Interface::GetConsistencyChecks() const
     {
-        bool result = V1_2::Interface::CheckConsistency(connection, log);
+        std::vector<ConsistencyCheck> result = V1_3::Interface::GetConsistencyChecks();
 
-        // If the v1.3 index was consistent, or if full logging of inconsistency was requested, check the v1.4 data.
-        if (result || log)
-        {
-            result = DependenciesTable::DependenciesTableCheckConsistency(connection, log) && result;
-        }
+        result.push_back({ "dependencies", [](const SQLite::Connection& connection, bool log) { return DependenciesTable::DependenciesTableCheckConsistency(connection, log); } });
 
         return result;
     }
@@ -133,4 +129,19 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_4
     {
         return DependenciesTable::GetDependentsById(connection, packageId);
     }
+
+    std::vector<ISQLiteIndex::DependencyClosureEntry> Interface::GetDependencyClosureByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const
+    {
+        return DependenciesTable::GetDependencyClosureByManifestRowId(connection, manifestRowId);
+    }
+
+    std::vector<ISQLiteIndex::DependencyClosureEntry> Interface::GetDependentClosureById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const
+    {
+        return DependenciesTable::GetDependentClosureById(connection, packageId);
+    }
+
+    ISQLiteIndex::DependencySnapshot Interface::GetDependencySnapshot(const SQLite::Connection& connection) const
+    {
+        return DependenciesTable::GetDependencySnapshot(connection);
+    }
 }
\ No newline at end of file
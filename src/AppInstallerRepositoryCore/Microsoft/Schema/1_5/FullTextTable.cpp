@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "FullTextTable.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/OneToManyTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    using namespace SQLite;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_FullTextTable_Table_Name = "search_fts"sv;
+    static constexpr std::string_view s_FullTextTable_Value_Column = "value"sv;
+    static constexpr std::string_view s_FullTextTable_Manifest_Column = "manifest"sv;
+    static constexpr std::string_view s_FullTextTable_Field_Column = "field"sv;
+    static constexpr std::string_view s_FullTextTable_Rank_Column = "rank"sv;
+
+    static constexpr std::string_view s_FullTextTable_Alias = "fts"sv;
+    static constexpr std::string_view s_FullTextTable_SecondaryAlias = "fts2"sv;
+
+    // The builder has no support for virtual tables, so the creation statement is written out directly.
+    // The manifest and field columns are only used for filtering the results, and so are not indexed.
+    static char const* const s_FullTextTable_Table_Create = R"(
+CREATE VIRTUAL TABLE [search_fts] USING fts5(
+    [value],
+    [manifest] UNINDEXED,
+    [field] UNINDEXED,
+    tokenize = 'trigram'
+))";
+
+    // The trigram tokenizer cannot match anything shorter than this.
+    static constexpr size_t s_FullTextTable_MinimumQueryLength = 3;
+
+    namespace details
+    {
+        void FullTextTablePopulateFrom(SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& column, bool isOneToOne, int field)
+        {
+            using namespace SQLite::Builder;
+            using QCol = QualifiedColumn;
+
+            std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+            // Build a statement like:
+            //      INSERT INTO search_fts (value, manifest, field)
+            //      SELECT names.name, manifest.rowid, <field> from manifest
+            //      join names on manifest.name = names.rowid
+            // OR
+            //      INSERT INTO search_fts (value, manifest, field)
+            //      SELECT tags.tag, manifest.rowid, <field> from manifest
+            //      join tags_map on manifest.rowid = tags_map.manifest
+            //      join tags on tags_map.tag = tags.rowid
+            StatementBuilder builder;
+            builder.InsertInto(s_FullTextTable_Table_Name).
+                Columns({ s_FullTextTable_Value_Column, s_FullTextTable_Manifest_Column, s_FullTextTable_Field_Column }).
+                Select().Column(column).Column(QCol(manifestTable, SQLite::RowIDName)).Value(field).
+                From(manifestTable);
+
+            if (isOneToOne)
+            {
+                builder.Join(column.Table).On(QCol(manifestTable, column.Column), QCol(column.Table, SQLite::RowIDName));
+            }
+            else
+            {
+                std::string mapTableName = V1_0::details::OneToManyTableGetMapTableName(column.Table);
+                builder.
+                    Join(mapTableName).On(QCol(manifestTable, SQLite::RowIDName), QCol(mapTableName, V1_0::details::OneToManyTableGetManifestColumnName())).
+                    Join(column.Table).On(QCol(mapTableName, column.Column), QCol(column.Table, SQLite::RowIDName));
+            }
+
+            builder.Execute(connection);
+            AICLI_LOG(Repo, Verbose, << "Added " << connection.GetChanges() << " full text rows from " << column.Table);
+        }
+    }
+
+    namespace
+    {
+        FullTextTable::Field GetPrimaryField(PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id:
+                return FullTextTable::Field::Id;
+            case PackageMatchField::Name:
+                return FullTextTable::Field::Name;
+            case PackageMatchField::Moniker:
+                return FullTextTable::Field::Moniker;
+            case PackageMatchField::Command:
+                return FullTextTable::Field::Command;
+            case PackageMatchField::Tag:
+                return FullTextTable::Field::Tag;
+            case PackageMatchField::NormalizedNameAndPublisher:
+                return FullTextTable::Field::NormalizedName;
+            default:
+                THROW_HR(E_UNEXPECTED);
+            }
+        }
+    }
+
+    std::string_view FullTextTable::TableName()
+    {
+        return s_FullTextTable_Table_Name;
+    }
+
+    bool FullTextTable::IsAvailable(const SQLite::Connection& connection)
+    {
+        {
+            Builder::StatementBuilder builder;
+            builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+                Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals(s_FullTextTable_Table_Name);
+
+            Statement statement = builder.Prepare(connection);
+            THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+
+            if (statement.GetColumn<int64_t>(0) == 0)
+            {
+                return false;
+            }
+        }
+
+        // An index may have been created by a SQLite build with FTS5 support, but be read by one without it.
+        try
+        {
+            Builder::StatementBuilder builder;
+            builder.Select(SQLite::RowIDName).From(s_FullTextTable_Table_Name).Limit(1);
+            builder.Prepare(connection);
+            return true;
+        }
+        catch (const SQLiteException&)
+        {
+            AICLI_LOG(Repo, Info, << "Full text table is present but not usable; falling back to standard search");
+            return false;
+        }
+    }
+
+    bool FullTextTable::TryCreate(SQLite::Connection& connection)
+    {
+        try
+        {
+            Statement create = Statement::Create(connection, s_FullTextTable_Table_Create);
+            create.Execute();
+            return true;
+        }
+        catch (const SQLiteException&)
+        {
+            AICLI_LOG(Repo, Info, << "FTS5 with the trigram tokenizer is not available; the full text table will not be created");
+            return false;
+        }
+    }
+
+    void FullTextTable::Optimize(SQLite::Connection& connection)
+    {
+        // The special command column shares the name of the table.
+        Builder::StatementBuilder builder;
+        builder.InsertInto(s_FullTextTable_Table_Name).Columns(s_FullTextTable_Table_Name).Values("optimize"sv);
+        builder.Execute(connection);
+    }
+
+    bool FullTextTable::SupportsField(PackageMatchField field)
+    {
+        switch (field)
+        {
+        case PackageMatchField::Id:
+        case PackageMatchField::Name:
+        case PackageMatchField::Moniker:
+        case PackageMatchField::Command:
+        case PackageMatchField::Tag:
+        case PackageMatchField::NormalizedNameAndPublisher:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool FullTextTable::IsQueryable(std::string_view value)
+    {
+        return Utility::UTF8Length(value) >= s_FullTextTable_MinimumQueryLength;
+    }
+
+    std::string FullTextTable::GetMatchExpression(std::string_view value)
+    {
+        // Quote the value as a single FTS5 string, which the trigram tokenizer treats as a substring search.
+        std::string result;
+        result.reserve(value.length() + 2);
+
+        result += '"';
+        for (char c : value)
+        {
+            if (c == '"')
+            {
+                result += '"';
+            }
+            result += c;
+        }
+        result += '"';
+
+        return result;
+    }
+
+    std::vector<int> FullTextTable::BuildSearchStatement(
+        SQLite::Builder::StatementBuilder& builder,
+        PackageMatchField field,
+        std::string_view manifestAlias,
+        std::string_view valueAlias,
+        std::string_view rankAlias)
+    {
+        using namespace SQLite::Builder;
+        using QCol = QualifiedColumn;
+
+        bool isNameAndPublisher = (field == PackageMatchField::NormalizedNameAndPublisher);
+
+        // Build a statement like:
+        //      SELECT fts.manifest as m, fts.value as v, fts.rank as r from search_fts as fts
+        //      where fts.search_fts MATCH <value> and fts.field = <field>
+        // OR, for the normalized name and publisher:
+        //      SELECT fts.manifest as m, '' as v, fts.rank as r from search_fts as fts
+        //      join search_fts as fts2 on fts.manifest = fts2.manifest
+        //      where fts.search_fts MATCH <name> and fts.field = <norm name> and fts2.search_fts MATCH <publisher> and fts2.field = <norm publisher>
+        builder.Select().
+            Column(QCol(s_FullTextTable_Alias, s_FullTextTable_Manifest_Column)).As(manifestAlias);
+
+        if (isNameAndPublisher)
+        {
+            builder.LiteralColumn("");
+        }
+        else
+        {
+            builder.Column(QCol(s_FullTextTable_Alias, s_FullTextTable_Value_Column));
+        }
+
+        builder.As(valueAlias).
+            Column(QCol(s_FullTextTable_Alias, s_FullTextTable_Rank_Column)).As(rankAlias).
+            From(s_FullTextTable_Table_Name).As(s_FullTextTable_Alias);
+
+        if (isNameAndPublisher)
+        {
+            builder.Join(s_FullTextTable_Table_Name).As(s_FullTextTable_SecondaryAlias).
+                On(QCol(s_FullTextTable_Alias, s_FullTextTable_Manifest_Column), QCol(s_FullTextTable_SecondaryAlias, s_FullTextTable_Manifest_Column));
+        }
+
+        std::vector<int> result;
+
+        builder.Where(QCol(s_FullTextTable_Alias, s_FullTextTable_Table_Name)).Match(Unbound);
+        result.push_back(builder.GetLastBindIndex());
+        builder.And(QCol(s_FullTextTable_Alias, s_FullTextTable_Field_Column)).Equals(static_cast<int>(GetPrimaryField(field)));
+
+        if (isNameAndPublisher)
+        {
+            builder.And(QCol(s_FullTextTable_SecondaryAlias, s_FullTextTable_Table_Name)).Match(Unbound);
+            result.push_back(builder.GetLastBindIndex());
+            builder.And(QCol(s_FullTextTable_SecondaryAlias, s_FullTextTable_Field_Column)).Equals(static_cast<int>(Field::NormalizedPublisher));
+        }
+
+        return result;
+    }
+}
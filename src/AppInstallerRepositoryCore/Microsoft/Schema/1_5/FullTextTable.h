@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include "SQLiteStatementBuilder.h"
+#include "Public/winget/RepositorySearch.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    namespace details
+    {
+        // Inserts the values of the given table into the full text table, tagged with the given source field.
+        void FullTextTablePopulateFrom(SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& column, bool isOneToOne, int field);
+    }
+
+    // An FTS5 virtual table holding the searchable strings of every manifest.
+    // The trigram tokenizer is used so that MATCH provides substring semantics in the same way that LIKE '%value%' does.
+    // The table is only created when preparing an index for packaging, and only if the SQLite build supports it;
+    // all readers must be prepared to fall back to the standard value tables when it is not present.
+    struct FullTextTable
+    {
+        // The source of a value in the table.
+        // These are not PackageMatchField values, as the normalized name and publisher must be kept separate.
+        enum class Field : int
+        {
+            Id = 0,
+            Name,
+            Moniker,
+            Command,
+            Tag,
+            NormalizedName,
+            NormalizedPublisher,
+        };
+
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Determine if the table exists in the database and can be queried by this SQLite build.
+        static bool IsAvailable(const SQLite::Connection& connection);
+
+        // Attempts to create the table in the database.
+        // Returns false if the SQLite build does not support FTS5 with the trigram tokenizer.
+        static bool TryCreate(SQLite::Connection& connection);
+
+        // Inserts the values of the given table into the full text table.
+        // This must be done before the source tables are prepared for packaging.
+        template <typename Table>
+        static void PopulateFrom(SQLite::Connection& connection, Field field)
+        {
+            details::FullTextTablePopulateFrom(connection, SQLite::Builder::QualifiedColumn{ Table::TableName(), Table::ValueName() }, Table::IsOneToOne(), static_cast<int>(field));
+        }
+
+        // Merges the table contents into as few b-trees as possible; should be done once all values are inserted.
+        static void Optimize(SQLite::Connection& connection);
+
+        // Determines whether the table can be used to search the given field.
+        static bool SupportsField(PackageMatchField field);
+
+        // Determines whether the value is long enough to produce at least one trigram.
+        static bool IsQueryable(std::string_view value);
+
+        // Converts the value into a MATCH expression that searches for it as a substring.
+        static std::string GetMatchExpression(std::string_view value);
+
+        // Builds a sub-select on the table for the given field, of the form:
+        //      SELECT fts.manifest as m, fts.value as v, fts.rank as r FROM fts WHERE fts MATCH <value> AND fts.field = <field>
+        // Returns the bind indices of the MATCH expressions, in the same order as the values of the filter.
+        static std::vector<int> BuildSearchStatement(
+            SQLite::Builder::StatementBuilder& builder,
+            PackageMatchField field,
+            std::string_view manifestAlias,
+            std::string_view valueAlias,
+            std::string_view rankAlias);
+    };
+}
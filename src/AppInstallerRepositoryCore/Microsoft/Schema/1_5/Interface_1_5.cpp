@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_5/Interface.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/VersionTable.h"
+#include "Microsoft/Schema/1_0/ChannelTable.h"
+#include "Microsoft/Schema/1_0/MonikerTable.h"
+#include "Microsoft/Schema/1_0/TagsTable.h"
+#include "Microsoft/Schema/1_0/CommandsTable.h"
+#include "Microsoft/Schema/1_1/PackageFamilyNameTable.h"
+#include "Microsoft/Schema/1_1/ProductCodeTable.h"
+#include "Microsoft/Schema/1_2/NormalizedPackageNameTable.h"
+#include "Microsoft/Schema/1_2/NormalizedPackagePublisherTable.h"
+
+#include "Microsoft/Schema/1_5/FullTextTable.h"
+#include "Microsoft/Schema/1_5/SearchResultsTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    namespace
+    {
+        using namespace std::string_view_literals;
+
+        // The published index is read through a memory mapping; matching the system page size means
+        // that every b-tree page read is satisfied by exactly one page of the mapping.
+        constexpr int s_PackagedIndexPageSize = 4096;
+
+        constexpr std::string_view s_StatisticsTable_Name = "sqlite_stat1"sv;
+
+        int64_t GetPragmaValue(const SQLite::Connection& connection, std::string_view pragma)
+        {
+            SQLite::Statement statement = SQLite::Statement::Create(connection, std::string{ "PRAGMA " }.append(pragma));
+            THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+            return statement.GetColumn<int64_t>(0);
+        }
+
+        // Logs how much of the values of the table are made up of prefixes shared with the value before them in sorted order.
+        // This is the most that front coding the values could save, before the compression of the package that carries the index.
+        template <typename Table>
+        void LogSharedPrefixes(const SQLite::Connection& connection)
+        {
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select(Table::ValueName()).From(Table::TableName()).OrderBy(Table::ValueName());
+
+            size_t count = 0;
+            size_t totalBytes = 0;
+            size_t sharedBytes = 0;
+            std::string previous;
+
+            SQLite::Statement select = builder.Prepare(connection);
+            while (select.Step())
+            {
+                std::string value = select.GetColumn<std::string>(0);
+
+                auto mismatch = std::mismatch(value.begin(), value.end(), previous.begin(), previous.end());
+                sharedBytes += static_cast<size_t>(mismatch.first - value.begin());
+                totalBytes += value.size();
+                ++count;
+
+                previous = std::move(value);
+            }
+
+            AICLI_LOG(Repo, Info, << "  Values [" << Table::TableName() << "] : " << count << " values of " << totalBytes << " bytes, " << sharedBytes << " bytes in shared prefixes");
+        }
+
+        // Logs the size of the index, the statistics gathered for each index and the plan for the most common lookup.
+        void LogPackagingReport(const SQLite::Connection& connection)
+        {
+            using namespace SQLite::Builder;
+            using QCol = QualifiedColumn;
+
+            int64_t pageSize = GetPragmaValue(connection, "page_size"sv);
+            int64_t pageCount = GetPragmaValue(connection, "page_count"sv);
+            AICLI_LOG(Repo, Info, << "Packaged index size is " << (pageSize * pageCount) << " bytes [" << pageCount << " pages of " << pageSize << " bytes]");
+
+            // The size of each table and index, so that the cost of an index can be weighed against the lookups that it serves.
+            if (sqlite3_compileoption_used("ENABLE_DBSTAT_VTAB"))
+            {
+                SQLite::Statement select = SQLite::Statement::Create(connection, "SELECT name, SUM(pgsize) FROM dbstat GROUP BY name ORDER BY 2 DESC"sv);
+                while (select.Step())
+                {
+                    AICLI_LOG(Repo, Info, << "  Size [" << select.GetColumn<std::string>(0) << "] : " << select.GetColumn<int64_t>(1) << " bytes");
+                }
+            }
+
+            {
+                StatementBuilder builder;
+                builder.Select({ "tbl"sv, "idx"sv, "stat"sv }).From(s_StatisticsTable_Name);
+
+                SQLite::Statement select = builder.Prepare(connection);
+                while (select.Step())
+                {
+                    AICLI_LOG(Repo, Info, << "  Statistics [" << select.GetColumn<std::string>(0) << "] [" <<
+                        (select.GetColumnIsNull(1) ? std::string{} : select.GetColumn<std::string>(1)) << "] : " << select.GetColumn<std::string>(2));
+                }
+            }
+
+            LogSharedPrefixes<V1_0::IdTable>(connection);
+            LogSharedPrefixes<V1_0::NameTable>(connection);
+            LogSharedPrefixes<V1_0::MonikerTable>(connection);
+            LogSharedPrefixes<V1_0::TagsTable>(connection);
+            LogSharedPrefixes<V1_0::CommandsTable>(connection);
+            LogSharedPrefixes<V1_1::PackageFamilyNameTable>(connection);
+            LogSharedPrefixes<V1_1::ProductCodeTable>(connection);
+            LogSharedPrefixes<V1_2::NormalizedPackageNameTable>(connection);
+            LogSharedPrefixes<V1_2::NormalizedPackagePublisherTable>(connection);
+
+            {
+                // The versions of every package in the search results are looked up this way.
+                std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+                StatementBuilder builder;
+                builder.ExplainQueryPlan().
+                    Select({ QCol(V1_0::VersionTable::TableName(), V1_0::VersionTable::ValueName()), QCol(V1_0::ChannelTable::TableName(), V1_0::ChannelTable::ValueName()) }).
+                    From(manifestTable).
+                    Join(V1_0::VersionTable::TableName()).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(V1_0::VersionTable::TableName(), SQLite::RowIDName)).
+                    Join(V1_0::ChannelTable::TableName()).On(QCol(manifestTable, V1_0::ChannelTable::ValueName()), QCol(V1_0::ChannelTable::TableName(), SQLite::RowIDName)).
+                    Where(QCol(manifestTable, V1_0::IdTable::ValueName())).Equals(Unbound);
+
+                SQLite::Statement explain = builder.Prepare(connection);
+                AICLI_LOG(Repo, Info, << "Query plan for version lookup:");
+                while (explain.Step())
+                {
+                    AICLI_LOG(Repo, Info, << "  " << explain.GetColumn<std::string>(3));
+                }
+            }
+        }
+    }
+
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_4::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 5 };
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_5");
+
+        // The full text table is populated from the value tables, so it must be done before they are trimmed.
+        // If the SQLite build cannot create it, searches will continue to use the value tables.
+        if (FullTextTable::TryCreate(connection))
+        {
+            FullTextTable::PopulateFrom<V1_0::IdTable>(connection, FullTextTable::Field::Id);
+            FullTextTable::PopulateFrom<V1_0::NameTable>(connection, FullTextTable::Field::Name);
+            FullTextTable::PopulateFrom<V1_0::MonikerTable>(connection, FullTextTable::Field::Moniker);
+            FullTextTable::PopulateFrom<V1_0::CommandsTable>(connection, FullTextTable::Field::Command);
+            FullTextTable::PopulateFrom<V1_0::TagsTable>(connection, FullTextTable::Field::Tag);
+            FullTextTable::PopulateFrom<V1_2::NormalizedPackageNameTable>(connection, FullTextTable::Field::NormalizedName);
+            FullTextTable::PopulateFrom<V1_2::NormalizedPackagePublisherTable>(connection, FullTextTable::Field::NormalizedPublisher);
+            FullTextTable::Optimize(connection);
+        }
+
+        V1_4::Interface::PrepareForPackaging(connection, false);
+
+        // Clients look up the versions of a package by its id, and the packaged index is never written again,
+        // so a single index holding all of those values replaces the one on the id alone.
+        V1_0::ManifestTable::CreateCoveringIndex(connection, {
+            V1_0::IdTable::ValueName(),
+            V1_0::VersionTable::ValueName(),
+            V1_0::ChannelTable::ValueName(),
+            });
+        V1_0::ManifestTable::PrepareForPackaging_deprecated(connection, { V1_0::IdTable::ValueName() });
+
+        // Keep the planner statistics in the published index; they are small and are otherwise never gathered by clients.
+        {
+            SQLite::Builder::StatementBuilder builder;
+            builder.Analyze();
+            builder.Execute(connection);
+        }
+
+        savepoint.Commit();
+
+        if (vacuum)
+        {
+            // The page size only takes effect when the database is rebuilt by the vacuum.
+            SQLite::Statement pageSize = SQLite::Statement::Create(connection, "PRAGMA page_size = " + std::to_string(s_PackagedIndexPageSize));
+            pageSize.Execute();
+
+            // Force the database to actually shrink the file size.
+            // This also rewrites every table in rowid order, leaving the rows of each table contiguous.
+            // This *must* be done outside of an active transaction.
+            SQLite::Builder::StatementBuilder builder;
+            builder.Vacuum();
+            builder.Execute(connection);
+        }
+
+        LogPackagingReport(connection);
+    }
+
+    std::unique_ptr<V1_0::SearchResultsTable> Interface::CreateSearchResultsTable(const SQLite::Connection& connection) const
+    {
+        return std::make_unique<SearchResultsTable>(connection);
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/1_2/SearchResultsTable.h"
+
+#include <map>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    // Table for holding temporary search results.
+    // Substring and fuzzy searches are performed against the full text table when it is available.
+    struct SearchResultsTable : public V1_2::SearchResultsTable
+    {
+        SearchResultsTable(const SQLite::Connection& connection);
+
+        SearchResultsTable(const SearchResultsTable&) = delete;
+        SearchResultsTable& operator=(const SearchResultsTable&) = delete;
+
+        SearchResultsTable(SearchResultsTable&&) = default;
+        SearchResultsTable& operator=(SearchResultsTable&&) = default;
+
+        void SearchOnField(const PackageMatchFilter& filter) override;
+
+        ISQLiteIndex::SearchResult GetSearchResults(size_t limit = 0) override;
+
+    protected:
+        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const override;
+
+        // Import all overrides of this function
+        using V1_0::SearchResultsTable::BindStatementForMatchType;
+
+        void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex) override;
+
+        // Determines whether the filter should be performed against the full text table.
+        bool UseFullTextTable(const PackageMatchFilter& filter) const;
+
+        // Records the rank of every id that the filter matches in the full text table.
+        void RecordRanks(const PackageMatchFilter& filter);
+
+    private:
+        const SQLite::Connection& m_connection;
+        bool m_fullTextAvailable = false;
+        std::map<SQLite::rowid_t, double> m_ranks;
+    };
+}
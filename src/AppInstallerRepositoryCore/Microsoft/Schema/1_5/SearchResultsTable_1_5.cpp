@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SearchResultsTable.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_5/FullTextTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    namespace
+    {
+        using namespace std::string_view_literals;
+
+        constexpr std::string_view s_SearchResultsTable_SubSelect_TableAlias = "valueTable"sv;
+        constexpr std::string_view s_SearchResultsTable_SubSelect_RankAlias = "r"sv;
+
+        bool IsFullTextMatchType(MatchType match)
+        {
+            return (match == MatchType::Substring || match == MatchType::Fuzzy || match == MatchType::FuzzySubstring);
+        }
+    }
+
+    SearchResultsTable::SearchResultsTable(const SQLite::Connection& connection) :
+        V1_2::SearchResultsTable(connection), m_connection(connection)
+    {
+        m_fullTextAvailable = FullTextTable::IsAvailable(m_connection);
+    }
+
+    void SearchResultsTable::SearchOnField(const PackageMatchFilter& filter)
+    {
+        V1_2::SearchResultsTable::SearchOnField(filter);
+
+        if (UseFullTextTable(filter))
+        {
+            RecordRanks(filter);
+        }
+    }
+
+    ISQLiteIndex::SearchResult SearchResultsTable::GetSearchResults(size_t limit)
+    {
+        ISQLiteIndex::SearchResult result = V1_2::SearchResultsTable::GetSearchResults(limit);
+
+        for (const auto& match : result.Matches)
+        {
+            auto itr = m_ranks.find(match.first);
+            if (itr != m_ranks.end())
+            {
+                result.Ranks.emplace(itr->first, itr->second);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
+    {
+        if (UseFullTextTable(filter))
+        {
+            return FullTextTable::BuildSearchStatement(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), s_SearchResultsTable_SubSelect_RankAlias);
+        }
+
+        return V1_0::SearchResultsTable::BuildSearchStatement(builder, filter);
+    }
+
+    void SearchResultsTable::BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex)
+    {
+        if (UseFullTextTable(filter))
+        {
+            statement.Bind(bindIndex[0], FullTextTable::GetMatchExpression(filter.Value));
+
+            if (filter.Field == PackageMatchField::NormalizedNameAndPublisher)
+            {
+                statement.Bind(bindIndex[1], FullTextTable::GetMatchExpression(filter.Additional.value()));
+            }
+        }
+        else
+        {
+            V1_2::SearchResultsTable::BindStatementForMatchType(statement, filter, bindIndex);
+        }
+    }
+
+    bool SearchResultsTable::UseFullTextTable(const PackageMatchFilter& filter) const
+    {
+        if (!m_fullTextAvailable || !IsFullTextMatchType(filter.Type) || !FullTextTable::SupportsField(filter.Field))
+        {
+            return false;
+        }
+
+        // Values too short for the tokenizer fall back to the standard search.
+        if (!FullTextTable::IsQueryable(filter.Value))
+        {
+            return false;
+        }
+
+        if (filter.Field == PackageMatchField::NormalizedNameAndPublisher && !FullTextTable::IsQueryable(filter.Additional.value()))
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    void SearchResultsTable::RecordRanks(const PackageMatchFilter& filter)
+    {
+        using namespace SQLite::Builder;
+        using QCol = QualifiedColumn;
+
+        // Select the rank of every id found by the search.
+        // The goal is a statement like this:
+        //      SELECT manifest.id, valueTable.r FROM
+        //      (SELECT fts.manifest as m, fts.value as v, fts.rank as r from search_fts as fts where ...) AS valueTable
+        //      join manifest on valueTable.m = manifest.rowid
+        StatementBuilder builder;
+        builder.Select({ QCol(V1_0::ManifestTable::TableName(), V1_0::IdTable::ValueName()), QCol(s_SearchResultsTable_SubSelect_TableAlias, s_SearchResultsTable_SubSelect_RankAlias) }).
+            From().BeginParenthetical();
+
+        std::vector<int> bindIndex = FullTextTable::BuildSearchStatement(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), s_SearchResultsTable_SubSelect_RankAlias);
+
+        builder.EndParenthetical().As(s_SearchResultsTable_SubSelect_TableAlias).
+            Join(V1_0::ManifestTable::TableName()).On(QCol(s_SearchResultsTable_SubSelect_TableAlias, SubSelectManifestAlias()), QCol(V1_0::ManifestTable::TableName(), SQLite::RowIDName));
+
+        SQLite::Statement select = builder.Prepare(m_connection);
+        BindStatementForMatchType(select, filter, bindIndex);
+
+        while (select.Step())
+        {
+            SQLite::rowid_t id = select.GetColumn<SQLite::rowid_t>(0);
+            double rank = select.GetColumn<double>(1);
+
+            auto itr = m_ranks.find(id);
+            if (itr == m_ranks.end())
+            {
+                m_ranks.emplace(id, rank);
+            }
+            else if (rank < itr->second)
+            {
+                itr->second = rank;
+            }
+        }
+    }
+}
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_6/Interface.h"
+
+#include "Microsoft/Schema/1_6/VersionKeyTable.h"
+
+#include "Microsoft/Schema/1_0/ChannelTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_5::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 6 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_6");
+
+        V1_5::Interface::CreateTables(connection, options);
+
+        VersionKeyTable::Create(connection);
+
+        savepoint.Commit();
+    }
+
+    SQLite::rowid_t Interface::AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_6");
+
+        SQLite::rowid_t manifestId = V1_5::Interface::AddManifest(connection, manifest, relativePath);
+
+        VersionKeyTable::EnsureExistsForManifest(connection, manifestId);
+
+        savepoint.Commit();
+
+        return manifestId;
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_6");
+
+        auto [indexModified, manifestId] = V1_5::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        // An update can change the case of the version string, which moves the manifest to a different version row.
+        if (indexModified)
+        {
+            VersionKeyTable::EnsureExistsForManifest(connection, manifestId);
+            VersionKeyTable::RemoveUnreferenced(connection);
+        }
+
+        savepoint.Commit();
+
+        return { indexModified, manifestId };
+    }
+
+    void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "removemanifest_v1_6");
+
+        V1_5::Interface::RemoveManifestById(connection, manifestId);
+
+        VersionKeyTable::RemoveUnreferenced(connection);
+
+        savepoint.Commit();
+    }
+
+    std::vector<ISQLiteIndex::ConsistencyCheck> Interface::GetConsistencyChecks() const
+    {
+        std::vector<ConsistencyCheck> result = V1_5::Interface::GetConsistencyChecks();
+
+        result.push_back({ "versionkeys", [](const SQLite::Connection& connection, bool log) { return VersionKeyTable::CheckConsistency(connection, log); } });
+
+        return result;
+    }
+
+    std::optional<SQLite::rowid_t> Interface::GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const
+    {
+        // There are only ever a handful of channels, so finding the channel by value is cheap even without an index on the values.
+        std::optional<SQLite::rowid_t> channelIdOpt = V1_0::ChannelTable::SelectIdByValue(connection, channel, true);
+        if (!channelIdOpt && !channel.empty())
+        {
+            // If an empty channel was given but none was found, we will just not filter on channel.
+            AICLI_LOG(Repo, Info, << "Did not find a Channel { " << channel << " }");
+            return {};
+        }
+
+        // Unlike earlier versions, the version is matched among the manifests with the id rather than looked up in the
+        // versions table, which has no index on its values in the packaged index. The keys also give the highest version
+        // directly rather than reading and sorting every version.
+        auto result = VersionKeyTable::GetManifestIdByKey(connection, id, version, channelIdOpt);
+        if (!result)
+        {
+            AICLI_LOG(Repo, Info, << "Did not find a Version { " << id << ", " << version << ", " << channel << " }");
+        }
+
+        return result;
+    }
+
+    std::vector<Utility::VersionAndChannel> Interface::GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const
+    {
+        // The keys put the rows in order, so unlike earlier versions there is no need to sort the results here.
+        auto versionsAndChannels = VersionKeyTable::GetSortedVersionsAndChannelsById(connection, id);
+
+        std::vector<Utility::VersionAndChannel> result;
+        result.reserve(versionsAndChannels.size());
+        for (auto&& vac : versionsAndChannels)
+        {
+            result.emplace_back(Utility::Version{ std::move(vac.first) }, Utility::Channel{ std::move(vac.second) });
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,269 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "VersionKeyTable.h"
+#include "SQLiteStatementBuilder.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/VersionTable.h"
+#include "Microsoft/Schema/1_0/ChannelTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    using namespace SQLite;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_VersionKeyTable_Table_Name = "version_keys"sv;
+    static constexpr std::string_view s_VersionKeyTable_Key_Column = "key"sv;
+
+    // The key is made of these markers, ordered so that memcmp gives the same result as comparing versions:
+    //  <Unknown>
+    //  | <Version> { <Part> <integer big endian> (<OtherPresent> <escaped other> <OtherEnd> | <OtherEmpty>) }* <End>
+    //  | <Latest>
+    static constexpr uint8_t s_VersionKey_Unknown = 0x00;
+    static constexpr uint8_t s_VersionKey_Version = 0x01;
+    static constexpr uint8_t s_VersionKey_Latest = 0x02;
+
+    static constexpr uint8_t s_VersionKey_End = 0x00;
+    static constexpr uint8_t s_VersionKey_Part = 0x01;
+
+    // An empty string part sorts higher than any other value for the same integer.
+    static constexpr uint8_t s_VersionKey_OtherPresent = 0x01;
+    static constexpr uint8_t s_VersionKey_OtherEmpty = 0x02;
+
+    // The string ends with two nulls, and an embedded null is followed by the escape,
+    // so that the end of the string sorts lower than any continuation of it.
+    static constexpr uint8_t s_VersionKey_OtherEnd = 0x00;
+    static constexpr uint8_t s_VersionKey_OtherNullEscape = 0xFF;
+
+    std::string_view VersionKeyTable::TableName()
+    {
+        return s_VersionKeyTable_Table_Name;
+    }
+
+    std::string_view VersionKeyTable::KeyName()
+    {
+        return s_VersionKeyTable_Key_Column;
+    }
+
+    void VersionKeyTable::Create(SQLite::Connection& connection)
+    {
+        using namespace SQLite::Builder;
+
+        StatementBuilder builder;
+        builder.CreateTable(s_VersionKeyTable_Table_Name).Columns({
+            IntegerPrimaryKey(),
+            ColumnBuilder(s_VersionKeyTable_Key_Column, Type::Blob).NotNull()
+            });
+
+        builder.Execute(connection);
+    }
+
+    SQLite::blob_t VersionKeyTable::GetKey(const Utility::Version& version)
+    {
+        SQLite::blob_t result;
+
+        if (version.IsUnknown())
+        {
+            result.push_back(s_VersionKey_Unknown);
+            return result;
+        }
+
+        if (version.IsLatest())
+        {
+            result.push_back(s_VersionKey_Latest);
+            return result;
+        }
+
+        result.push_back(s_VersionKey_Version);
+
+        for (const auto& part : version.GetParts())
+        {
+            result.push_back(s_VersionKey_Part);
+
+            for (int shift = 56; shift >= 0; shift -= 8)
+            {
+                result.push_back(static_cast<uint8_t>(part.Integer >> shift));
+            }
+
+            if (part.Other.empty())
+            {
+                result.push_back(s_VersionKey_OtherEmpty);
+            }
+            else
+            {
+                result.push_back(s_VersionKey_OtherPresent);
+
+                for (char c : part.Other)
+                {
+                    result.push_back(static_cast<uint8_t>(c));
+                    if (c == '\0')
+                    {
+                        result.push_back(s_VersionKey_OtherNullEscape);
+                    }
+                }
+
+                result.push_back(s_VersionKey_OtherEnd);
+                result.push_back(s_VersionKey_OtherEnd);
+            }
+        }
+
+        result.push_back(s_VersionKey_End);
+        return result;
+    }
+
+    void VersionKeyTable::EnsureExistsForManifest(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        using namespace SQLite::Builder;
+
+        auto [versionId] = V1_0::ManifestTable::GetIdsById<V1_0::VersionTable>(connection, manifestId);
+
+        {
+            StatementBuilder builder;
+            builder.Select(Builder::RowCount).From(s_VersionKeyTable_Table_Name).Where(SQLite::RowIDName).Equals(versionId);
+
+            Statement select = builder.Prepare(connection);
+            THROW_HR_IF(E_UNEXPECTED, !select.Step());
+
+            if (select.GetColumn<int64_t>(0) != 0)
+            {
+                return;
+            }
+        }
+
+        std::optional<std::string> version = V1_0::VersionTable::SelectValueById(connection, versionId);
+        THROW_HR_IF(E_UNEXPECTED, !version);
+
+        StatementBuilder builder;
+        builder.InsertInto(s_VersionKeyTable_Table_Name).
+            Columns({ SQLite::RowIDName, s_VersionKeyTable_Key_Column }).
+            Values(versionId, GetKey(Utility::Version{ std::move(version).value() }));
+
+        builder.Execute(connection);
+    }
+
+    void VersionKeyTable::RemoveUnreferenced(SQLite::Connection& connection)
+    {
+        using namespace SQLite::Builder;
+
+        // DELETE FROM version_keys WHERE rowid NOT IN (SELECT rowid FROM versions)
+        StatementBuilder builder;
+        builder.DeleteFrom(s_VersionKeyTable_Table_Name).Where(SQLite::RowIDName).Not().In().
+            BeginParenthetical().Select(SQLite::RowIDName).From(V1_0::VersionTable::TableName()).EndParenthetical();
+
+        builder.Execute(connection);
+    }
+
+    bool VersionKeyTable::CheckConsistency(const SQLite::Connection& connection, bool log)
+    {
+        using namespace SQLite::Builder;
+        using QCol = QualifiedColumn;
+
+        std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+        // SELECT manifest.rowid FROM manifest LEFT OUTER JOIN version_keys ON manifest.version = version_keys.rowid WHERE version_keys.key IS NULL
+        StatementBuilder builder;
+        builder.Select(QCol(manifestTable, SQLite::RowIDName)).From(manifestTable).
+            LeftOuterJoin(s_VersionKeyTable_Table_Name).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(s_VersionKeyTable_Table_Name, SQLite::RowIDName)).
+            Where(QCol(s_VersionKeyTable_Table_Name, s_VersionKeyTable_Key_Column)).IsNull();
+
+        if (!log)
+        {
+            builder.Limit(1);
+        }
+
+        Statement select = builder.Prepare(connection);
+        bool result = true;
+
+        while (select.Step())
+        {
+            result = false;
+
+            if (!log)
+            {
+                break;
+            }
+
+            AICLI_LOG(Repo, Info, << "  [INVALID] manifest [" << select.GetColumn<SQLite::rowid_t>(0) << "] refers to a version with no key");
+        }
+
+        return result;
+    }
+
+    std::vector<std::pair<std::string, std::string>> VersionKeyTable::GetSortedVersionsAndChannelsById(const SQLite::Connection& connection, SQLite::rowid_t id)
+    {
+        using namespace SQLite::Builder;
+        using QCol = QualifiedColumn;
+
+        std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+        // SELECT versions.version, channels.channel FROM manifest
+        // JOIN versions ON manifest.version = versions.rowid
+        // JOIN channels ON manifest.channel = channels.rowid
+        // JOIN version_keys ON manifest.version = version_keys.rowid
+        // WHERE manifest.id = ?
+        // ORDER BY channels.channel, version_keys.key DESC
+        StatementBuilder builder;
+        builder.Select({ QCol(V1_0::VersionTable::TableName(), V1_0::VersionTable::ValueName()), QCol(V1_0::ChannelTable::TableName(), V1_0::ChannelTable::ValueName()) }).
+            From(manifestTable).
+            Join(V1_0::VersionTable::TableName()).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(V1_0::VersionTable::TableName(), SQLite::RowIDName)).
+            Join(V1_0::ChannelTable::TableName()).On(QCol(manifestTable, V1_0::ChannelTable::ValueName()), QCol(V1_0::ChannelTable::TableName(), SQLite::RowIDName)).
+            Join(s_VersionKeyTable_Table_Name).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(s_VersionKeyTable_Table_Name, SQLite::RowIDName)).
+            Where(QCol(manifestTable, V1_0::IdTable::ValueName())).Equals(id).
+            OrderBy({ QCol(V1_0::ChannelTable::TableName(), V1_0::ChannelTable::ValueName()), QCol(s_VersionKeyTable_Table_Name, s_VersionKeyTable_Key_Column) }).Descending();
+
+        Statement select = builder.Prepare(connection);
+
+        std::vector<std::pair<std::string, std::string>> result;
+        while (select.Step())
+        {
+            auto [version, channel] = select.GetRow<std::string, std::string>();
+            result.emplace_back(std::move(version), std::move(channel));
+        }
+
+        return result;
+    }
+
+    std::optional<SQLite::rowid_t> VersionKeyTable::GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::optional<SQLite::rowid_t> channelId)
+    {
+        using namespace SQLite::Builder;
+        using QCol = QualifiedColumn;
+
+        std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+        // SELECT manifest.rowid FROM manifest
+        // JOIN versions ON manifest.version = versions.rowid
+        // JOIN version_keys ON manifest.version = version_keys.rowid
+        // WHERE manifest.id = ? [AND manifest.channel = ?] [AND versions.version LIKE ?]
+        // ORDER BY version_keys.key DESC LIMIT 1
+        StatementBuilder builder;
+        builder.Select(QCol(manifestTable, SQLite::RowIDName)).
+            From(manifestTable).
+            Join(V1_0::VersionTable::TableName()).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(V1_0::VersionTable::TableName(), SQLite::RowIDName)).
+            Join(s_VersionKeyTable_Table_Name).On(QCol(manifestTable, V1_0::VersionTable::ValueName()), QCol(s_VersionKeyTable_Table_Name, SQLite::RowIDName)).
+            Where(QCol(manifestTable, V1_0::IdTable::ValueName())).Equals(id);
+
+        if (channelId)
+        {
+            builder.And(QCol(manifestTable, V1_0::ChannelTable::ValueName())).Equals(channelId.value());
+        }
+
+        if (!version.empty())
+        {
+            builder.And(QCol(V1_0::VersionTable::TableName(), V1_0::VersionTable::ValueName())).LikeWithEscape(version);
+        }
+
+        builder.OrderBy(QCol(s_VersionKeyTable_Table_Name, s_VersionKeyTable_Key_Column)).Descending().Limit(1);
+
+        Statement select = builder.Prepare(connection);
+
+        if (select.Step())
+        {
+            return select.GetColumn<SQLite::rowid_t>(0);
+        }
+
+        return {};
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include <AppInstallerVersions.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    // A table holding a sortable key for each version that a manifest refers to.
+    // The rowid of each row is the rowid of the version in the versions table.
+    // Comparing two keys as blobs gives the same result as comparing the versions with Utility::Version.
+    struct VersionKeyTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Get the key column name.
+        static std::string_view KeyName();
+
+        // Creates the table.
+        static void Create(SQLite::Connection& connection);
+
+        // Gets the sortable key for the given version.
+        static SQLite::blob_t GetKey(const Utility::Version& version);
+
+        // Ensures that the version referenced by the given manifest has a key.
+        static void EnsureExistsForManifest(SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Removes the keys of versions that no longer exist.
+        static void RemoveUnreferenced(SQLite::Connection& connection);
+
+        // Checks that every manifest refers to a version that has a key.
+        static bool CheckConsistency(const SQLite::Connection& connection, bool log);
+
+        // Gets the version and channel strings of all manifests with the given id, in the order of Utility::VersionAndChannel.
+        static std::vector<std::pair<std::string, std::string>> GetSortedVersionsAndChannelsById(const SQLite::Connection& connection, SQLite::rowid_t id);
+
+        // Gets the manifest with the given id and version (compared case-insensitively), or with the highest version if none is given.
+        // The manifests are searched from those with the id, so that no lookup depends on an index over the version values.
+        static std::optional<SQLite::rowid_t> GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::optional<SQLite::rowid_t> channelId);
+    };
+}
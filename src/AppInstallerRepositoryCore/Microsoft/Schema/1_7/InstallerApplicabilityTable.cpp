@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "InstallerApplicabilityTable.h"
+#include "SQLiteStatementBuilder.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_7
+{
+    using namespace SQLite;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_InstallerApplicabilityTable_Table_Name = "installer_applicability"sv;
+    static constexpr std::string_view s_InstallerApplicabilityTable_Summary_Column = "summary"sv;
+
+    std::string_view InstallerApplicabilityTable::TableName()
+    {
+        return s_InstallerApplicabilityTable_Table_Name;
+    }
+
+    bool InstallerApplicabilityTable::Exists(const SQLite::Connection& connection)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+            Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals(s_InstallerApplicabilityTable_Table_Name);
+
+        Statement statement = builder.Prepare(connection);
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+        return statement.GetColumn<int64_t>(0) != 0;
+    }
+
+    void InstallerApplicabilityTable::Create(SQLite::Connection& connection)
+    {
+        using namespace SQLite::Builder;
+
+        StatementBuilder builder;
+        builder.CreateTable(s_InstallerApplicabilityTable_Table_Name).Columns({
+            IntegerPrimaryKey(),
+            ColumnBuilder(s_InstallerApplicabilityTable_Summary_Column, Type::Text).NotNull()
+            });
+
+        builder.Execute(connection);
+    }
+
+    std::optional<std::string> InstallerApplicabilityTable::GetSummaryByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(s_InstallerApplicabilityTable_Summary_Column).From(s_InstallerApplicabilityTable_Table_Name).Where(SQLite::RowIDName).Equals(manifestId);
+
+        Statement select = builder.Prepare(connection);
+        if (select.Step())
+        {
+            return select.GetColumn<std::string>(0);
+        }
+
+        return {};
+    }
+
+    bool InstallerApplicabilityTable::SetSummaryByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view summary)
+    {
+        auto existing = GetSummaryByManifestId(connection, manifestId);
+
+        if (existing)
+        {
+            if (existing.value() == summary)
+            {
+                return false;
+            }
+
+            Builder::StatementBuilder builder;
+            builder.Update(s_InstallerApplicabilityTable_Table_Name).Set().Column(s_InstallerApplicabilityTable_Summary_Column).Equals(summary).
+                Where(SQLite::RowIDName).Equals(manifestId);
+
+            builder.Execute(connection);
+        }
+        else
+        {
+            Builder::StatementBuilder builder;
+            builder.InsertInto(s_InstallerApplicabilityTable_Table_Name).
+                Columns({ SQLite::RowIDName, s_InstallerApplicabilityTable_Summary_Column }).
+                Values(manifestId, summary);
+
+            builder.Execute(connection);
+        }
+
+        return true;
+    }
+
+    void InstallerApplicabilityTable::DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        Builder::StatementBuilder builder;
+        builder.DeleteFrom(s_InstallerApplicabilityTable_Table_Name).Where(SQLite::RowIDName).Equals(manifestId);
+
+        builder.Execute(connection);
+    }
+}
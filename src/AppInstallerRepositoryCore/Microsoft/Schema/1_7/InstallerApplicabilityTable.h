@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_7
+{
+    // A table holding the installer applicability summary of each manifest; see InstallerApplicability.h.
+    // The rowid of each row is the rowid of the manifest. The table is optional, and only created when requested.
+    struct InstallerApplicabilityTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Determine if the table currently exists in the database.
+        static bool Exists(const SQLite::Connection& connection);
+
+        // Creates the table.
+        static void Create(SQLite::Connection& connection);
+
+        // Gets the summary for the given manifest, if it has one.
+        static std::optional<std::string> GetSummaryByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Sets the summary for the given manifest; returns true if the stored value changed.
+        static bool SetSummaryByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view summary);
+
+        // Removes the summary for the given manifest.
+        static void DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId);
+    };
+}
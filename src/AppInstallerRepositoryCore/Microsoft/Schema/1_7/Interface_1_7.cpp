@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_7/Interface.h"
+
+#include "Microsoft/Schema/1_7/InstallerApplicabilityTable.h"
+#include <winget/InstallerApplicability.h>
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_7
+{
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_6::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 7 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_7");
+
+        V1_6::Interface::CreateTables(connection, options);
+
+        // Only an index of available packages benefits from the summaries, so the table is not created by default.
+        if (WI_IsFlagSet(options, CreateOptions::InstallerApplicabilitySupport))
+        {
+            InstallerApplicabilityTable::Create(connection);
+        }
+
+        savepoint.Commit();
+    }
+
+    SQLite::rowid_t Interface::AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_7");
+
+        SQLite::rowid_t manifestId = V1_6::Interface::AddManifest(connection, manifest, relativePath);
+
+        if (InstallerApplicabilityTable::Exists(connection))
+        {
+            InstallerApplicabilityTable::SetSummaryByManifestId(connection, manifestId, InstallerApplicability::Create(manifest));
+        }
+
+        savepoint.Commit();
+
+        return manifestId;
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_7");
+
+        auto [indexModified, manifestId] = V1_6::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        // The installers are not otherwise in the index, so they can change without the update modifying anything else.
+        if (InstallerApplicabilityTable::Exists(connection))
+        {
+            indexModified = InstallerApplicabilityTable::SetSummaryByManifestId(connection, manifestId, InstallerApplicability::Create(manifest)) || indexModified;
+        }
+
+        savepoint.Commit();
+
+        return { indexModified, manifestId };
+    }
+
+    void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "removemanifest_v1_7");
+
+        V1_6::Interface::RemoveManifestById(connection, manifestId);
+
+        if (InstallerApplicabilityTable::Exists(connection))
+        {
+            InstallerApplicabilityTable::DeleteByManifestId(connection, manifestId);
+        }
+
+        savepoint.Commit();
+    }
+
+    ISQLiteIndex::MetadataResult Interface::GetMetadataByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const
+    {
+        ISQLiteIndex::MetadataResult result = V1_6::Interface::GetMetadataByManifestId(connection, manifestId);
+
+        if (InstallerApplicabilityTable::Exists(connection))
+        {
+            auto summary = InstallerApplicabilityTable::GetSummaryByManifestId(connection, manifestId);
+            if (summary)
+            {
+                result.emplace_back(PackageVersionMetadata::InstallerApplicability, std::move(summary).value());
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/ISQLiteIndex.h"
+#include "Microsoft/Schema/1_7/Interface.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    // Interface to this schema version exposed through ISQLiteIndex.
+    struct Interface : public V1_7::Interface
+    {
+        Interface(Utility::NormalizationVersion normVersion = Utility::NormalizationVersion::Initial);
+
+        // Version 1.0
+        Schema::Version GetVersion() const override;
+        void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
+
+    protected:
+        std::unique_ptr<V1_0::SearchResultsTable> CreateSearchResultsTable(const SQLite::Connection& connection) const override;
+    };
+}
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_8/Interface.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+
+#include "Microsoft/Schema/1_8/SearchResultsTable.h"
+#include "Microsoft/Schema/1_8/TrigramTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_7::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 8 };
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        {
+            SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_8");
+
+            // The trigrams are read from the value tables, so they must be added before those are trimmed.
+            TrigramTable::Create(connection);
+            TrigramTable::PopulateFrom<V1_0::IdTable>(connection, PackageMatchField::Id);
+            TrigramTable::PopulateFrom<V1_0::NameTable>(connection, PackageMatchField::Name);
+
+            savepoint.Commit();
+        }
+
+        // The vacuum must be done outside of an active transaction.
+        V1_7::Interface::PrepareForPackaging(connection, vacuum);
+    }
+
+    std::unique_ptr<V1_0::SearchResultsTable> Interface::CreateSearchResultsTable(const SQLite::Connection& connection) const
+    {
+        return std::make_unique<SearchResultsTable>(connection);
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/1_5/SearchResultsTable.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    // Table for holding temporary search results.
+    // Fuzzy searches on the id and name are performed against the trigram table when it is available.
+    struct SearchResultsTable : public V1_5::SearchResultsTable
+    {
+        SearchResultsTable(const SQLite::Connection& connection);
+
+        SearchResultsTable(const SearchResultsTable&) = delete;
+        SearchResultsTable& operator=(const SearchResultsTable&) = delete;
+
+        SearchResultsTable(SearchResultsTable&&) = default;
+        SearchResultsTable& operator=(SearchResultsTable&&) = default;
+
+        void SearchOnField(const PackageMatchFilter& filter) override;
+
+        void FilterOnField(const PackageMatchFilter& filter) override;
+
+        ISQLiteIndex::SearchResult GetSearchResults(size_t limit = 0) override;
+
+    protected:
+        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const override;
+
+        // Import all overrides of this function
+        using V1_0::SearchResultsTable::BindStatementForMatchType;
+
+        void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex) override;
+
+        // Determines whether the filter should be performed against the trigram table.
+        bool UseTrigramTable(const PackageMatchFilter& filter) const;
+
+        // Finds the values that fuzzy match the filter, for the statement of the current search to select.
+        void FindFuzzyMatches(const PackageMatchFilter& filter);
+
+    private:
+        const SQLite::Connection& m_connection;
+        bool m_trigramsAvailable = false;
+        std::vector<SQLite::rowid_t> m_fuzzyValues;
+        std::map<std::pair<PackageMatchField, std::string>, size_t> m_fuzzyDistances;
+    };
+}
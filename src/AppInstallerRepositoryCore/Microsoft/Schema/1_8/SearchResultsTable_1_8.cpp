@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SearchResultsTable.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+#include "Microsoft/Schema/1_8/TrigramTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    namespace
+    {
+        bool IsFuzzyMatchType(MatchType match)
+        {
+            return (match == MatchType::Fuzzy || match == MatchType::FuzzySubstring);
+        }
+    }
+
+    SearchResultsTable::SearchResultsTable(const SQLite::Connection& connection) :
+        V1_5::SearchResultsTable(connection), m_connection(connection)
+    {
+        m_trigramsAvailable = TrigramTable::IsAvailable(m_connection);
+    }
+
+    void SearchResultsTable::SearchOnField(const PackageMatchFilter& filter)
+    {
+        if (UseTrigramTable(filter))
+        {
+            FindFuzzyMatches(filter);
+
+            // The full text ranks are not comparable to the edit distances, so they are not recorded for this search.
+            V1_0::SearchResultsTable::SearchOnField(filter);
+            m_fuzzyValues.clear();
+        }
+        else
+        {
+            V1_5::SearchResultsTable::SearchOnField(filter);
+        }
+    }
+
+    void SearchResultsTable::FilterOnField(const PackageMatchFilter& filter)
+    {
+        if (UseTrigramTable(filter))
+        {
+            FindFuzzyMatches(filter);
+            V1_5::SearchResultsTable::FilterOnField(filter);
+            m_fuzzyValues.clear();
+        }
+        else
+        {
+            V1_5::SearchResultsTable::FilterOnField(filter);
+        }
+    }
+
+    ISQLiteIndex::SearchResult SearchResultsTable::GetSearchResults(size_t limit)
+    {
+        if (m_fuzzyDistances.empty())
+        {
+            return V1_5::SearchResultsTable::GetSearchResults(limit);
+        }
+
+        // The fuzzy matches must be ordered by their distance before the results are limited.
+        ISQLiteIndex::SearchResult result = V1_5::SearchResultsTable::GetSearchResults();
+
+        auto getDistance = [&](const PackageMatchFilter& match)
+        {
+            auto itr = m_fuzzyDistances.find({ match.Field, match.Value });
+            return (itr == m_fuzzyDistances.end() ? std::numeric_limits<size_t>::max() : itr->second);
+        };
+
+        // Matches from the same search are adjacent, and are put in the order of their distance within that run.
+        auto runBegin = result.Matches.begin();
+        while (runBegin != result.Matches.end())
+        {
+            auto runEnd = std::find_if(runBegin, result.Matches.end(), [&](const auto& match)
+                {
+                    return match.second.Field != runBegin->second.Field || match.second.Type != runBegin->second.Type;
+                });
+
+            if (IsFuzzyMatchType(runBegin->second.Type))
+            {
+                std::stable_sort(runBegin, runEnd, [&](const auto& a, const auto& b) { return getDistance(a.second) < getDistance(b.second); });
+            }
+
+            runBegin = runEnd;
+        }
+
+        if (limit && result.Matches.size() > limit)
+        {
+            result.Matches.resize(limit);
+            result.Truncated = true;
+        }
+
+        return result;
+    }
+
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
+    {
+        if (UseTrigramTable(filter))
+        {
+            switch (filter.Field)
+            {
+            case PackageMatchField::Id:
+                return TrigramTable::BuildSearchStatement<V1_0::IdTable>(builder, SubSelectManifestAlias(), SubSelectValueAlias(), m_fuzzyValues.size());
+            case PackageMatchField::Name:
+                return TrigramTable::BuildSearchStatement<V1_0::NameTable>(builder, SubSelectManifestAlias(), SubSelectValueAlias(), m_fuzzyValues.size());
+            default:
+                THROW_HR(E_UNEXPECTED);
+            }
+        }
+
+        return V1_5::SearchResultsTable::BuildSearchStatement(builder, filter);
+    }
+
+    void SearchResultsTable::BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex)
+    {
+        if (UseTrigramTable(filter))
+        {
+            // Any bind index beyond the values is left unbound, and so matches nothing.
+            for (size_t i = 0; i < m_fuzzyValues.size(); ++i)
+            {
+                statement.Bind(bindIndex[i], m_fuzzyValues[i]);
+            }
+        }
+        else
+        {
+            V1_5::SearchResultsTable::BindStatementForMatchType(statement, filter, bindIndex);
+        }
+    }
+
+    bool SearchResultsTable::UseTrigramTable(const PackageMatchFilter& filter) const
+    {
+        return (m_trigramsAvailable && IsFuzzyMatchType(filter.Type) && TrigramTable::SupportsField(filter.Field));
+    }
+
+    void SearchResultsTable::FindFuzzyMatches(const PackageMatchFilter& filter)
+    {
+        std::vector<TrigramMatch> matches;
+
+        switch (filter.Field)
+        {
+        case PackageMatchField::Id:
+            matches = TrigramTable::FindMatches<V1_0::IdTable>(m_connection, filter);
+            break;
+        case PackageMatchField::Name:
+            matches = TrigramTable::FindMatches<V1_0::NameTable>(m_connection, filter);
+            break;
+        default:
+            THROW_HR(E_UNEXPECTED);
+        }
+
+        m_fuzzyValues.clear();
+
+        for (auto& match : matches)
+        {
+            m_fuzzyValues.push_back(match.ValueId);
+
+            auto [itr, inserted] = m_fuzzyDistances.emplace(std::make_pair(filter.Field, std::move(match.Value)), match.Distance);
+            if (!inserted && match.Distance < itr->second)
+            {
+                itr->second = match.Distance;
+            }
+        }
+    }
+}
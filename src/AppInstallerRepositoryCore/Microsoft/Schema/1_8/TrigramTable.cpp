@@ -0,0 +1,342 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TrigramTable.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+
+#include <unordered_map>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    using namespace SQLite;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_TrigramTable_Table_Name = "fuzzy_trigrams"sv;
+    static constexpr std::string_view s_TrigramTable_Trigram_Column = "trigram"sv;
+    static constexpr std::string_view s_TrigramTable_Field_Column = "field"sv;
+    static constexpr std::string_view s_TrigramTable_Value_Column = "value"sv;
+
+    // Whole values are padded so that their first and last characters take part in as many trigrams as the others.
+    static constexpr wchar_t s_TrigramTable_Padding = L' ';
+
+    // More matches than this are not useful to a person, and would only make the sub-select of the manifests slow.
+    static constexpr size_t s_TrigramTable_MaximumMatches = 200;
+
+    namespace
+    {
+        using trigram_t = int64_t;
+
+        std::wstring FoldForTrigrams(std::string_view value)
+        {
+            return Utility::ConvertToUTF16(Utility::FoldCase(value));
+        }
+
+        trigram_t MakeTrigram(const std::wstring& value, size_t offset)
+        {
+            return (static_cast<trigram_t>(value[offset]) << 32) | (static_cast<trigram_t>(value[offset + 1]) << 16) | static_cast<trigram_t>(value[offset + 2]);
+        }
+
+        // Gets the distinct trigrams of the folded value; it is padded unless only a substring of a target is to be matched.
+        std::vector<trigram_t> GetTrigrams(const std::wstring& folded, bool padded)
+        {
+            std::wstring value;
+
+            if (padded)
+            {
+                value.reserve(folded.length() + 2);
+                value += s_TrigramTable_Padding;
+                value += folded;
+                value += s_TrigramTable_Padding;
+            }
+            else
+            {
+                value = folded;
+            }
+
+            std::vector<trigram_t> result;
+
+            for (size_t i = 0; i + 3 <= value.length(); ++i)
+            {
+                result.push_back(MakeTrigram(value, i));
+            }
+
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+
+            return result;
+        }
+
+        // The Levenshtein distance between the values, or to the closest substring of the target.
+        size_t GetFoldedDistance(const std::wstring& value, const std::wstring& target, bool substring)
+        {
+            // previous[j] is the distance between the value so far and the first j characters of the target.
+            // A substring match may start anywhere in the target, so skipping its leading characters is free.
+            std::vector<size_t> previous(target.length() + 1);
+            std::vector<size_t> current(target.length() + 1);
+
+            for (size_t j = 0; j <= target.length(); ++j)
+            {
+                previous[j] = (substring ? 0 : j);
+            }
+
+            for (size_t i = 1; i <= value.length(); ++i)
+            {
+                current[0] = i;
+
+                for (size_t j = 1; j <= target.length(); ++j)
+                {
+                    size_t substitution = previous[j - 1] + (value[i - 1] == target[j - 1] ? 0 : 1);
+                    current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitution });
+                }
+
+                std::swap(previous, current);
+            }
+
+            // Likewise, a substring match may end anywhere in the target.
+            return (substring ? *std::min_element(previous.begin(), previous.end()) : previous[target.length()]);
+        }
+
+        size_t GetFoldedMaximumDistance(const std::wstring& folded)
+        {
+            // Too short a value would match nearly everything with even a single edit.
+            if (folded.length() < 3)
+            {
+                return 0;
+            }
+
+            return std::min<size_t>(3, (folded.length() + 8) / 8);
+        }
+    }
+
+    namespace details
+    {
+        void TrigramTablePopulateFrom(SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& column, PackageMatchField field)
+        {
+            using namespace SQLite::Builder;
+
+            StatementBuilder insertBuilder;
+            insertBuilder.InsertInto(s_TrigramTable_Table_Name).
+                Columns({ s_TrigramTable_Trigram_Column, s_TrigramTable_Field_Column, s_TrigramTable_Value_Column }).
+                Values(Unbound, Unbound, Unbound);
+
+            Statement insert = insertBuilder.Prepare(connection);
+
+            // SELECT rowid, name FROM names
+            StatementBuilder selectBuilder;
+            selectBuilder.Select({ SQLite::RowIDName, column.Column }).From(column.Table);
+
+            Statement select = selectBuilder.Prepare(connection);
+
+            size_t valueCount = 0;
+            size_t trigramCount = 0;
+
+            while (select.Step())
+            {
+                SQLite::rowid_t value = select.GetColumn<SQLite::rowid_t>(0);
+
+                for (trigram_t trigram : GetTrigrams(FoldForTrigrams(select.GetColumn<std::string>(1)), true))
+                {
+                    insert.Reset();
+                    insert.Bind(1, trigram);
+                    insert.Bind(2, field);
+                    insert.Bind(3, value);
+                    insert.Execute();
+                    ++trigramCount;
+                }
+
+                ++valueCount;
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Added " << trigramCount << " trigrams of " << valueCount << " values from " << column.Table);
+        }
+
+        std::vector<TrigramMatch> TrigramTableFindMatches(
+            const SQLite::Connection& connection,
+            const SQLite::Builder::QualifiedColumn& column,
+            const PackageMatchFilter& filter)
+        {
+            using namespace SQLite::Builder;
+
+            std::vector<TrigramMatch> result;
+
+            bool substring = (filter.Type == MatchType::FuzzySubstring);
+            std::wstring folded = FoldForTrigrams(filter.Value);
+            size_t maximumDistance = GetFoldedMaximumDistance(folded);
+
+            // The value matches only itself, which the case insensitive search already finds.
+            if (maximumDistance == 0)
+            {
+                return result;
+            }
+
+            std::vector<trigram_t> trigrams = GetTrigrams(folded, !substring);
+            if (trigrams.empty())
+            {
+                return result;
+            }
+
+            // Each edit removes at most three trigrams, so a candidate must share all but that many with the value.
+            // When that would be none at all, a candidate only needs to share one; values that share none are not found.
+            size_t requiredShared = 1;
+            if (trigrams.size() > 3 * maximumDistance + 1)
+            {
+                requiredShared = trigrams.size() - 3 * maximumDistance;
+            }
+
+            // Count the trigrams that each value shares with the search value:
+            //      SELECT value FROM fuzzy_trigrams WHERE trigram IN (<trigrams>) AND field = <field>
+            std::unordered_map<SQLite::rowid_t, size_t> sharedCounts;
+            {
+                StatementBuilder builder;
+                builder.Select(s_TrigramTable_Value_Column).From(s_TrigramTable_Table_Name).
+                    Where(s_TrigramTable_Trigram_Column).In(trigrams.size()).
+                    And(s_TrigramTable_Field_Column).Equals(filter.Field);
+
+                Statement select = builder.Prepare(connection);
+                for (size_t i = 0; i < trigrams.size(); ++i)
+                {
+                    select.Bind(static_cast<int>(i + 1), trigrams[i]);
+                }
+
+                while (select.Step())
+                {
+                    ++sharedCounts[select.GetColumn<SQLite::rowid_t>(0)];
+                }
+            }
+
+            StatementBuilder valueBuilder;
+            valueBuilder.Select(column.Column).From(column.Table).Where(SQLite::RowIDName).Equals(Unbound);
+
+            Statement selectValue = valueBuilder.Prepare(connection);
+            size_t candidateCount = 0;
+
+            for (const auto& [value, shared] : sharedCounts)
+            {
+                if (shared < requiredShared)
+                {
+                    continue;
+                }
+
+                selectValue.Reset();
+                selectValue.Bind(1, value);
+                if (!selectValue.Step())
+                {
+                    continue;
+                }
+
+                ++candidateCount;
+                std::string targetValue = selectValue.GetColumn<std::string>(0);
+                std::wstring target = FoldForTrigrams(targetValue);
+
+                // The distance between whole values is at least the difference in their lengths.
+                if (!substring && (std::max(target.length(), folded.length()) - std::min(target.length(), folded.length())) > maximumDistance)
+                {
+                    continue;
+                }
+
+                size_t distance = GetFoldedDistance(folded, target, substring);
+                if (distance <= maximumDistance)
+                {
+                    result.emplace_back(TrigramMatch{ value, std::move(targetValue), distance });
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const TrigramMatch& a, const TrigramMatch& b) { return std::tie(a.Distance, a.ValueId) < std::tie(b.Distance, b.ValueId); });
+
+            if (result.size() > s_TrigramTable_MaximumMatches)
+            {
+                result.resize(s_TrigramTable_MaximumMatches);
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Fuzzy search of " << column.Table << " checked " << candidateCount << " of " << sharedCounts.size() << " values sharing trigrams, and found " << result.size());
+
+            return result;
+        }
+
+        std::vector<int> TrigramTableBuildSearchStatement(
+            SQLite::Builder::StatementBuilder& builder,
+            const SQLite::Builder::QualifiedColumn& column,
+            std::string_view manifestAlias,
+            std::string_view valueAlias,
+            size_t valueCount)
+        {
+            using namespace SQLite::Builder;
+            using QCol = QualifiedColumn;
+
+            std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+            // Build a statement like:
+            //      SELECT manifest.rowid as m, names.name as v from manifest
+            //      join names on manifest.name = names.rowid
+            //      where names.rowid in (<values>)
+            builder.Select().
+                Column(QCol(manifestTable, SQLite::RowIDName)).As(manifestAlias).
+                Column(column).As(valueAlias).
+                From(manifestTable).
+                Join(column.Table).On(QCol(manifestTable, column.Column), QCol(column.Table, SQLite::RowIDName));
+
+            size_t bindCount = std::max<size_t>(valueCount, 1);
+            builder.Where(QCol(column.Table, SQLite::RowIDName)).In(bindCount);
+
+            std::vector<int> result;
+            int firstIndex = builder.GetLastBindIndex() - static_cast<int>(bindCount) + 1;
+
+            for (size_t i = 0; i < bindCount; ++i)
+            {
+                result.push_back(firstIndex + static_cast<int>(i));
+            }
+
+            return result;
+        }
+    }
+
+    std::string_view TrigramTable::TableName()
+    {
+        return s_TrigramTable_Table_Name;
+    }
+
+    bool TrigramTable::IsAvailable(const SQLite::Connection& connection)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+            Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals(s_TrigramTable_Table_Name);
+
+        Statement statement = builder.Prepare(connection);
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+
+        return statement.GetColumn<int64_t>(0) != 0;
+    }
+
+    void TrigramTable::Create(SQLite::Connection& connection)
+    {
+        using namespace SQLite::Builder;
+
+        // The primary key serves the lookup of the values by trigram, so no other index is needed.
+        StatementBuilder builder;
+        builder.CreateTable(s_TrigramTable_Table_Name).Columns({
+            ColumnBuilder(s_TrigramTable_Trigram_Column, Type::Int64).NotNull(),
+            ColumnBuilder(s_TrigramTable_Field_Column, Type::Int).NotNull(),
+            ColumnBuilder(s_TrigramTable_Value_Column, Type::Int64).NotNull(),
+            PrimaryKeyBuilder({ s_TrigramTable_Trigram_Column, s_TrigramTable_Field_Column, s_TrigramTable_Value_Column })
+            });
+
+        builder.Execute(connection);
+    }
+
+    bool TrigramTable::SupportsField(PackageMatchField field)
+    {
+        return (field == PackageMatchField::Id || field == PackageMatchField::Name);
+    }
+
+    size_t TrigramTable::GetMaximumDistance(std::string_view value)
+    {
+        return GetFoldedMaximumDistance(FoldForTrigrams(value));
+    }
+
+    size_t TrigramTable::GetDistance(std::string_view value, std::string_view target, bool substring)
+    {
+        return GetFoldedDistance(FoldForTrigrams(value), FoldForTrigrams(target), substring);
+    }
+}
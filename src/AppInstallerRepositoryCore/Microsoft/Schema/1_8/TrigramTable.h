@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include "SQLiteStatementBuilder.h"
+#include "Public/winget/RepositorySearch.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    // A value that fuzzy matches the search value.
+    struct TrigramMatch
+    {
+        SQLite::rowid_t ValueId;
+        std::string Value;
+        size_t Distance;
+    };
+
+    namespace details
+    {
+        // Inserts the trigrams of every value of the given one to one table, tagged with the given field.
+        void TrigramTablePopulateFrom(SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& column, PackageMatchField field);
+
+        // Finds the values of the given one to one table that are within the edit distance allowed for the filter.
+        std::vector<TrigramMatch> TrigramTableFindMatches(
+            const SQLite::Connection& connection,
+            const SQLite::Builder::QualifiedColumn& column,
+            const PackageMatchFilter& filter);
+
+        // Builds a sub-select of the manifests that refer to any of the given number of values of the one to one table.
+        std::vector<int> TrigramTableBuildSearchStatement(
+            SQLite::Builder::StatementBuilder& builder,
+            const SQLite::Builder::QualifiedColumn& column,
+            std::string_view manifestAlias,
+            std::string_view valueAlias,
+            size_t valueCount);
+    }
+
+    // A posting table from each trigram of the case folded id and name values to the values that contain it.
+    // Fuzzy searches gather candidate values by the number of trigrams that they share with the search value,
+    // which is a lower bound implied by the edit distance, and then compute the actual distance for just those.
+    // The table is only created when preparing an index for packaging; readers must be prepared for it to be missing.
+    struct TrigramTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Determine if the table exists in the database.
+        static bool IsAvailable(const SQLite::Connection& connection);
+
+        // Creates the table, without any indices beyond its primary key.
+        static void Create(SQLite::Connection& connection);
+
+        // Inserts the trigrams of the values of the given table.
+        // This must be done before the source tables are prepared for packaging.
+        template <typename Table>
+        static void PopulateFrom(SQLite::Connection& connection, PackageMatchField field)
+        {
+            static_assert(Table::IsOneToOne(), "Only one to one tables are supported");
+            details::TrigramTablePopulateFrom(connection, SQLite::Builder::QualifiedColumn{ Table::TableName(), Table::ValueName() }, field);
+        }
+
+        // Determines whether the table can be used to search the given field.
+        static bool SupportsField(PackageMatchField field);
+
+        // Gets the largest edit distance that a value can be from the search value and still be a fuzzy match.
+        static size_t GetMaximumDistance(std::string_view value);
+
+        // Gets the edit distance between the two values, once they are case folded and normalized as the table is.
+        // For a substring match, the distance is to the closest substring of the target rather than the whole of it.
+        static size_t GetDistance(std::string_view value, std::string_view target, bool substring);
+
+        // Finds the values of the given table that fuzzy match the filter, closest first.
+        template <typename Table>
+        static std::vector<TrigramMatch> FindMatches(const SQLite::Connection& connection, const PackageMatchFilter& filter)
+        {
+            return details::TrigramTableFindMatches(connection, SQLite::Builder::QualifiedColumn{ Table::TableName(), Table::ValueName() }, filter);
+        }
+
+        // Builds a sub-select of the form:
+        //      SELECT manifest.rowid as m, names.name as v FROM manifest JOIN names ON manifest.name = names.rowid WHERE names.rowid IN (<values>)
+        // Returns the bind indices of the value rowids; there is always at least one, which is left unbound when there are no values.
+        template <typename Table>
+        static std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, std::string_view manifestAlias, std::string_view valueAlias, size_t valueCount)
+        {
+            return details::TrigramTableBuildSearchStatement(builder, SQLite::Builder::QualifiedColumn{ Table::TableName(), Table::ValueName() }, manifestAlias, valueAlias, valueCount);
+        }
+    };
+}
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "FoldedValueTable.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/OneToManyTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    using namespace SQLite;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_FoldedValueTable_Table_Name = "folded_values"sv;
+    static constexpr std::string_view s_FoldedValueTable_Field_Column = "field"sv;
+    static constexpr std::string_view s_FoldedValueTable_Folded_Column = "folded"sv;
+    static constexpr std::string_view s_FoldedValueTable_Value_Column = "value"sv;
+
+    static constexpr std::string_view s_FoldedValueTable_Alias = "fv"sv;
+
+    // No UTF-8 string contains this byte, so every value with a given prefix sorts below the prefix followed by it.
+    static constexpr char s_FoldedValueTable_PrefixEnd = static_cast<char>(0xFF);
+
+    namespace details
+    {
+        void FoldedValueTablePopulateFrom(SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& column, PackageMatchField field)
+        {
+            using namespace SQLite::Builder;
+
+            StatementBuilder insertBuilder;
+            insertBuilder.InsertInto(s_FoldedValueTable_Table_Name).
+                Columns({ s_FoldedValueTable_Field_Column, s_FoldedValueTable_Folded_Column, s_FoldedValueTable_Value_Column }).
+                Values(Unbound, Unbound, Unbound);
+
+            Statement insert = insertBuilder.Prepare(connection);
+
+            // SELECT rowid, name FROM names
+            StatementBuilder selectBuilder;
+            selectBuilder.Select({ SQLite::RowIDName, column.Column }).From(column.Table);
+
+            Statement select = selectBuilder.Prepare(connection);
+
+            size_t valueCount = 0;
+
+            while (select.Step())
+            {
+                insert.Reset();
+                insert.Bind(1, field);
+                insert.Bind(2, Utility::FoldCase(select.GetColumn<std::string>(1)));
+                insert.Bind(3, select.GetColumn<SQLite::rowid_t>(0));
+                insert.Execute();
+
+                ++valueCount;
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Added " << valueCount << " folded values from " << column.Table);
+        }
+
+        std::vector<int> FoldedValueTableBuildSearchStatement(
+            SQLite::Builder::StatementBuilder& builder,
+            const SQLite::Builder::QualifiedColumn& column,
+            bool isOneToOne,
+            PackageMatchField field,
+            std::string_view manifestAlias,
+            std::string_view valueAlias,
+            bool prefix)
+        {
+            using namespace SQLite::Builder;
+            using QCol = QualifiedColumn;
+
+            std::string_view manifestTable = V1_0::ManifestTable::TableName();
+
+            // Build a statement like:
+            //      SELECT manifest.rowid as m, names.name as v from folded_values as fv
+            //      join names on fv.value = names.rowid
+            //      join manifest on manifest.name = names.rowid
+            //      where fv.field = <field> and fv.folded = <value>
+            // OR
+            //      SELECT manifest.rowid as m, tags.tag as v from folded_values as fv
+            //      join tags on fv.value = tags.rowid
+            //      join tags_map on tags_map.tag = tags.rowid
+            //      join manifest on manifest.rowid = tags_map.manifest
+            //      where fv.field = <field> and fv.folded >= <value> and fv.folded < <value><end>
+            builder.Select().
+                Column(QCol(manifestTable, SQLite::RowIDName)).As(manifestAlias).
+                Column(column).As(valueAlias).
+                From(s_FoldedValueTable_Table_Name).As(s_FoldedValueTable_Alias).
+                Join(column.Table).On(QCol(s_FoldedValueTable_Alias, s_FoldedValueTable_Value_Column), QCol(column.Table, SQLite::RowIDName));
+
+            if (isOneToOne)
+            {
+                builder.Join(manifestTable).On(QCol(manifestTable, column.Column), QCol(column.Table, SQLite::RowIDName));
+            }
+            else
+            {
+                std::string mapTableName = V1_0::details::OneToManyTableGetMapTableName(column.Table);
+                builder.
+                    Join(mapTableName).On(QCol(mapTableName, column.Column), QCol(column.Table, SQLite::RowIDName)).
+                    Join(manifestTable).On(QCol(manifestTable, SQLite::RowIDName), QCol(mapTableName, V1_0::details::OneToManyTableGetManifestColumnName()));
+            }
+
+            builder.Where(QCol(s_FoldedValueTable_Alias, s_FoldedValueTable_Field_Column)).Equals(field);
+
+            std::vector<int> result;
+
+            if (prefix)
+            {
+                builder.And(QCol(s_FoldedValueTable_Alias, s_FoldedValueTable_Folded_Column)).GreaterThanOrEquals(Unbound);
+                result.push_back(builder.GetLastBindIndex());
+                builder.And(QCol(s_FoldedValueTable_Alias, s_FoldedValueTable_Folded_Column)).LessThan(Unbound);
+                result.push_back(builder.GetLastBindIndex());
+            }
+            else
+            {
+                builder.And(QCol(s_FoldedValueTable_Alias, s_FoldedValueTable_Folded_Column)).Equals(Unbound);
+                result.push_back(builder.GetLastBindIndex());
+            }
+
+            return result;
+        }
+    }
+
+    std::string_view FoldedValueTable::TableName()
+    {
+        return s_FoldedValueTable_Table_Name;
+    }
+
+    bool FoldedValueTable::IsAvailable(const SQLite::Connection& connection)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+            Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals(s_FoldedValueTable_Table_Name);
+
+        Statement statement = builder.Prepare(connection);
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+
+        return statement.GetColumn<int64_t>(0) != 0;
+    }
+
+    void FoldedValueTable::Create(SQLite::Connection& connection)
+    {
+        using namespace SQLite::Builder;
+
+        // The primary key serves both the equality and the range lookups, so no other index is needed.
+        StatementBuilder builder;
+        builder.CreateTable(s_FoldedValueTable_Table_Name).Columns({
+            ColumnBuilder(s_FoldedValueTable_Field_Column, Type::Int).NotNull(),
+            ColumnBuilder(s_FoldedValueTable_Folded_Column, Type::Text).NotNull(),
+            ColumnBuilder(s_FoldedValueTable_Value_Column, Type::Int64).NotNull(),
+            PrimaryKeyBuilder({ s_FoldedValueTable_Field_Column, s_FoldedValueTable_Folded_Column, s_FoldedValueTable_Value_Column })
+            });
+
+        builder.Execute(connection);
+    }
+
+    bool FoldedValueTable::SupportsField(PackageMatchField field)
+    {
+        switch (field)
+        {
+        case PackageMatchField::Id:
+        case PackageMatchField::Name:
+        case PackageMatchField::Moniker:
+        case PackageMatchField::Command:
+        case PackageMatchField::Tag:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool FoldedValueTable::SupportsMatchType(MatchType match)
+    {
+        return (match == MatchType::CaseInsensitive || match == MatchType::StartsWith);
+    }
+
+    void FoldedValueTable::BindSearchStatement(SQLite::Statement& statement, const std::vector<int>& bindIndex, std::string_view value, bool prefix)
+    {
+        std::string folded = Utility::FoldCase(value);
+
+        if (prefix)
+        {
+            statement.Bind(bindIndex[1], folded + s_FoldedValueTable_PrefixEnd);
+        }
+
+        statement.Bind(bindIndex[0], folded);
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include "SQLiteStatementBuilder.h"
+#include "Public/winget/RepositorySearch.h"
+
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    namespace details
+    {
+        // Inserts the case folded form of every value of the given table, tagged with the given field.
+        void FoldedValueTablePopulateFrom(SQLite::Connection& connection, const SQLite::Builder::QualifiedColumn& column, PackageMatchField field);
+
+        // Builds a sub-select of the manifests that refer to the values of the given table whose folded form matches.
+        std::vector<int> FoldedValueTableBuildSearchStatement(
+            SQLite::Builder::StatementBuilder& builder,
+            const SQLite::Builder::QualifiedColumn& column,
+            bool isOneToOne,
+            PackageMatchField field,
+            std::string_view manifestAlias,
+            std::string_view valueAlias,
+            bool prefix);
+    }
+
+    // A table holding the Utility::FoldCase form of each searchable value, indexed by its field and that form.
+    // Case insensitive and prefix searches then fold the search value once and compare bytes through the index,
+    // rather than calling the ICU LIKE implementation for every row of the value table.
+    // The table is only created when preparing an index for packaging; readers must be prepared for it to be missing.
+    struct FoldedValueTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Determine if the table exists in the database.
+        static bool IsAvailable(const SQLite::Connection& connection);
+
+        // Creates the table, without any indices beyond its primary key.
+        static void Create(SQLite::Connection& connection);
+
+        // Inserts the folded values of the given table.
+        // This must be done before the source tables are prepared for packaging.
+        template <typename Table>
+        static void PopulateFrom(SQLite::Connection& connection, PackageMatchField field)
+        {
+            details::FoldedValueTablePopulateFrom(connection, SQLite::Builder::QualifiedColumn{ Table::TableName(), Table::ValueName() }, field);
+        }
+
+        // Determines whether the table can be used to search the given field.
+        static bool SupportsField(PackageMatchField field);
+
+        // Determines whether the table can be used to perform the given match type.
+        static bool SupportsMatchType(MatchType match);
+
+        // Builds a sub-select of the form:
+        //      SELECT manifest.rowid as m, names.name as v FROM folded_values AS fv
+        //      JOIN names ON fv.value = names.rowid JOIN manifest ON manifest.name = names.rowid
+        //      WHERE fv.field = <field> AND fv.folded = <value>
+        // A prefix search compares the folded value against a range rather than for equality.
+        // Returns the bind indices of the folded value, or of the start and end of the range.
+        template <typename Table>
+        static std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, std::string_view manifestAlias, std::string_view valueAlias, bool prefix)
+        {
+            return details::FoldedValueTableBuildSearchStatement(
+                builder, SQLite::Builder::QualifiedColumn{ Table::TableName(), Table::ValueName() }, Table::IsOneToOne(), field, manifestAlias, valueAlias, prefix);
+        }
+
+        // Binds the search value to the statement built by BuildSearchStatement, folding it first.
+        static void BindSearchStatement(SQLite::Statement& statement, const std::vector<int>& bindIndex, std::string_view value, bool prefix);
+    };
+}
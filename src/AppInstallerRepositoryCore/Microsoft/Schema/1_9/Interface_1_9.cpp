@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_9/Interface.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+#include "Microsoft/Schema/1_0/MonikerTable.h"
+#include "Microsoft/Schema/1_0/TagsTable.h"
+#include "Microsoft/Schema/1_0/CommandsTable.h"
+
+#include "Microsoft/Schema/1_9/FoldedValueTable.h"
+#include "Microsoft/Schema/1_9/SearchResultsTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_8::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 9 };
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        {
+            SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_9");
+
+            // The folded values are read from the value tables, so they must be added before those are trimmed.
+            FoldedValueTable::Create(connection);
+            FoldedValueTable::PopulateFrom<V1_0::IdTable>(connection, PackageMatchField::Id);
+            FoldedValueTable::PopulateFrom<V1_0::NameTable>(connection, PackageMatchField::Name);
+            FoldedValueTable::PopulateFrom<V1_0::MonikerTable>(connection, PackageMatchField::Moniker);
+            FoldedValueTable::PopulateFrom<V1_0::TagsTable>(connection, PackageMatchField::Tag);
+            FoldedValueTable::PopulateFrom<V1_0::CommandsTable>(connection, PackageMatchField::Command);
+
+            savepoint.Commit();
+        }
+
+        // The vacuum must be done outside of an active transaction.
+        V1_8::Interface::PrepareForPackaging(connection, vacuum);
+    }
+
+    std::unique_ptr<V1_0::SearchResultsTable> Interface::CreateSearchResultsTable(const SQLite::Connection& connection) const
+    {
+        return std::make_unique<SearchResultsTable>(connection);
+    }
+}
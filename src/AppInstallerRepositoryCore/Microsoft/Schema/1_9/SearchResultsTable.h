@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/1_8/SearchResultsTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    // Table for holding temporary search results.
+    // Case insensitive and prefix searches are performed against the folded value table when it is available.
+    struct SearchResultsTable : public V1_8::SearchResultsTable
+    {
+        SearchResultsTable(const SQLite::Connection& connection);
+
+        SearchResultsTable(const SearchResultsTable&) = delete;
+        SearchResultsTable& operator=(const SearchResultsTable&) = delete;
+
+        SearchResultsTable(SearchResultsTable&&) = default;
+        SearchResultsTable& operator=(SearchResultsTable&&) = default;
+
+    protected:
+        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const override;
+
+        // Import all overrides of this function
+        using V1_0::SearchResultsTable::BindStatementForMatchType;
+
+        void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex) override;
+
+        // Determines whether the filter should be performed against the folded value table.
+        bool UseFoldedValueTable(const PackageMatchFilter& filter) const;
+
+    private:
+        bool m_foldedValuesAvailable = false;
+    };
+}
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SearchResultsTable.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+#include "Microsoft/Schema/1_0/MonikerTable.h"
+#include "Microsoft/Schema/1_0/TagsTable.h"
+#include "Microsoft/Schema/1_0/CommandsTable.h"
+#include "Microsoft/Schema/1_9/FoldedValueTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    SearchResultsTable::SearchResultsTable(const SQLite::Connection& connection) :
+        V1_8::SearchResultsTable(connection)
+    {
+        m_foldedValuesAvailable = FoldedValueTable::IsAvailable(connection);
+    }
+
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
+    {
+        if (UseFoldedValueTable(filter))
+        {
+            bool prefix = (filter.Type == MatchType::StartsWith);
+
+            switch (filter.Field)
+            {
+            case PackageMatchField::Id:
+                return FoldedValueTable::BuildSearchStatement<V1_0::IdTable>(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), prefix);
+            case PackageMatchField::Name:
+                return FoldedValueTable::BuildSearchStatement<V1_0::NameTable>(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), prefix);
+            case PackageMatchField::Moniker:
+                return FoldedValueTable::BuildSearchStatement<V1_0::MonikerTable>(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), prefix);
+            case PackageMatchField::Tag:
+                return FoldedValueTable::BuildSearchStatement<V1_0::TagsTable>(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), prefix);
+            case PackageMatchField::Command:
+                return FoldedValueTable::BuildSearchStatement<V1_0::CommandsTable>(builder, filter.Field, SubSelectManifestAlias(), SubSelectValueAlias(), prefix);
+            default:
+                THROW_HR(E_UNEXPECTED);
+            }
+        }
+
+        return V1_8::SearchResultsTable::BuildSearchStatement(builder, filter);
+    }
+
+    void SearchResultsTable::BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex)
+    {
+        if (UseFoldedValueTable(filter))
+        {
+            FoldedValueTable::BindSearchStatement(statement, bindIndex, filter.Value, filter.Type == MatchType::StartsWith);
+        }
+        else
+        {
+            V1_8::SearchResultsTable::BindStatementForMatchType(statement, filter, bindIndex);
+        }
+    }
+
+    bool SearchResultsTable::UseFoldedValueTable(const PackageMatchFilter& filter) const
+    {
+        return (m_foldedValuesAvailable && FoldedValueTable::SupportsMatchType(filter.Type) && FoldedValueTable::SupportsField(filter.Field));
+    }
+}
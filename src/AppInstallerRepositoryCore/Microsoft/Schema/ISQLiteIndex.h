@@ -9,7 +9,10 @@
 #include <winget/NameNormalization.h>
 
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <optional>
+#include <set>
 
 
 namespace AppInstaller::Repository::Microsoft::Schema
@@ -28,11 +31,49 @@ namespace AppInstaller::Repository::Microsoft::Schema
         {
             std::vector<std::pair<SQLite::rowid_t, PackageMatchFilter>> Matches;
             bool Truncated = false;
+
+            // Version 1.5
+            // The full text relevance of matches that were found through the full text table, keyed by id rowid.
+            // Lower values are more relevant; ids without a value were not ranked.
+            std::map<SQLite::rowid_t, double> Ranks{};
         };
 
         // The non-version specific return value of GetMetadataByManifestId.
         using MetadataResult = std::vector<std::pair<PackageVersionMetadata, std::string>>;
 
+        // The non-version specific entry in the return value of the dependency closure queries; one for each dependency row in the closure.
+        struct DependencyClosureEntry
+        {
+            // The manifest that has the dependency.
+            SQLite::rowid_t ManifestId = 0;
+            // The id of the package that is depended on.
+            SQLite::rowid_t PackageId = 0;
+            // The minimum version of the dependency; empty if there is none.
+            Utility::NormalizedString MinVersion;
+        };
+
+        // The non-version specific return value of GetDependencySnapshot.
+        struct DependencySnapshot
+        {
+            // A manifest of a package that is depended on by at least one manifest.
+            struct ManifestEntry
+            {
+                SQLite::rowid_t ManifestId = 0;
+                SQLite::rowid_t PackageId = 0;
+                std::string Id;
+                std::string Version;
+                std::string Channel;
+            };
+
+            // Every row in the dependencies table.
+            std::vector<DependencyClosureEntry> Dependencies;
+            std::vector<ManifestEntry> Manifests;
+        };
+
+        // The non-version specific return value of GetPropertiesByManifestIds.
+        // Maps from manifest id to the properties that are present for it.
+        using PropertiesResult = std::map<SQLite::rowid_t, std::map<PackageVersionProperty, std::string>>;
+
         // Version 1.0
 
         // Gets the schema version that this index interface is built for.
@@ -47,6 +88,13 @@ namespace AppInstaller::Repository::Microsoft::Schema
             SupportPathless = 0x1,
             // Disable support for dependencies
             DisableDependenciesSupport = 0x2,
+            // Enable storing a summary of the installers of each manifest, so that installer selection can rule out a version without its manifest
+            InstallerApplicabilitySupport = 0x4,
+            // Enable storing the content of the manifest files, so that the latest versions can be read without downloading them
+            ManifestContentSupport = 0x8,
+            // Create the indices that are only needed to update or remove manifests when the index is prepared for packaging, and those that
+            // packaging drops not at all; intended for building an index by adding manifests in bulk, where every insert would maintain them
+            DeferIndices = 0x10,
         };
 
         // Creates all of the version dependent tables within the database.
@@ -68,6 +116,10 @@ namespace AppInstaller::Repository::Microsoft::Schema
         // Removes the manifest with the given id.
         virtual void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) = 0;
 
+        // Gets the manifest id for the manifest at the repository relative path, if present.
+        // Allows a manifest to be found when its file is no longer available, such as when it has been deleted from the repository.
+        virtual std::optional<SQLite::rowid_t> GetManifestIdByRelativePath(SQLite::Connection& connection, const std::filesystem::path& relativePath) = 0;
+
         // Removes data that is no longer needed for an index that is to be published.
         virtual void PrepareForPackaging(SQLite::Connection& connection) = 0;
 
@@ -75,6 +127,17 @@ namespace AppInstaller::Repository::Microsoft::Schema
         // Returns true if index is consistent; false if it is not.
         virtual bool CheckConsistency(const SQLite::Connection& connection, bool log) const = 0;
 
+        // One of the checks that make up CheckConsistency, which only reads the index.
+        // The checks are independent of each other, so they can be run in any order, or at the same time.
+        struct ConsistencyCheck
+        {
+            std::string Name;
+            std::function<bool(const SQLite::Connection&, bool)> Check;
+        };
+
+        // Gets the checks that make up CheckConsistency.
+        virtual std::vector<ConsistencyCheck> GetConsistencyChecks() const = 0;
+
         // Performs a search based on the given criteria.
         virtual SearchResult Search(const SQLite::Connection& connection, const SearchRequest& request) const = 0;
 
@@ -94,6 +157,13 @@ namespace AppInstaller::Repository::Microsoft::Schema
         // Gets all versions and channels for the given id.
         virtual std::vector<Utility::VersionAndChannel> GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const = 0;
 
+        // Gets the strings for the given properties of all of the given manifest ids.
+        // Manifest ids that are not present in the index are not present in the result.
+        virtual PropertiesResult GetPropertiesByManifestIds(
+            const SQLite::Connection& connection,
+            const std::vector<SQLite::rowid_t>& manifestIds,
+            const std::set<PackageVersionProperty>& properties) const = 0;
+
         // Version 1.1
 
         // Gets the string for the given metadata and manifest id, if present.
@@ -110,6 +180,36 @@ namespace AppInstaller::Repository::Microsoft::Schema
         virtual std::set<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependenciesByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const = 0;
 
         virtual std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const = 0;
+
+        // Gets the dependencies of the manifest and, transitively, those of every version of the packages that it depends on.
+        virtual std::vector<DependencyClosureEntry> GetDependencyClosureByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const = 0;
+
+        // Gets the dependencies on the package and, transitively, those on every package with a version that depends on it.
+        virtual std::vector<DependencyClosureEntry> GetDependentClosureById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const = 0;
+
+        // Gets the entire dependencies table, along with the version keys of every package that is depended on.
+        virtual DependencySnapshot GetDependencySnapshot(const SQLite::Connection& connection) const = 0;
+
+        // Version 1.3
+
+        // Gets the manifest id for the given manifest stream hash, if present.
+        // Returns an empty value when the index does not have the hashes indexed, so that callers fall back
+        // to finding the manifest by its key rather than scanning every manifest.
+        virtual std::optional<SQLite::rowid_t> GetManifestIdByHash(const SQLite::Connection& connection, const SQLite::blob_t& hash) const = 0;
+
+        // Version 1.10
+
+        // Determines whether the index stores the content of the manifest files.
+        virtual bool IsManifestContentSupported(const SQLite::Connection& connection) const = 0;
+
+        // Sets the content of the manifest file for the given manifest id.
+        virtual void SetManifestContentById(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view content) = 0;
+
+        // Gets the content of the manifest file for the given manifest id, if present.
+        virtual std::optional<std::string> GetManifestContentById(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const = 0;
+
+        // Sets the number of the highest versions of each package that keep their content when the index is prepared for packaging.
+        virtual void SetManifestContentVersions(SQLite::Connection& connection, uint32_t versions) = 0;
     };
 
     DEFINE_ENUM_FLAG_OPERATORS(ISQLiteIndex::CreateOptions);
@@ -16,6 +16,9 @@ namespace AppInstaller::Repository::Microsoft::Schema
     static constexpr std::string_view s_MetadataValueName_MinorVersion = "minorVersion"sv;
     static constexpr std::string_view s_MetadataValueName_LastWriteTime = "lastwritetime"sv;
 
+    // Version 1.10
+    static constexpr std::string_view s_MetadataValueName_ManifestContentVersions = "manifestContentVersions"sv;
+
     // The metadata table for the index.
     // Contains a fixed-schema set of named values that can be used to determine how to read the rest of the index.
     struct MetadataTable
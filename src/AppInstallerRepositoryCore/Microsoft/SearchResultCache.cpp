@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/SearchResultCache.h"
+#include <AppInstallerDateTime.h>
+#include <AppInstallerSHA256.h>
+
+using namespace AppInstaller::Utility;
+using namespace std::string_view_literals;
+
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        constexpr std::wstring_view s_SearchResultCache_Directory = L"SearchResultCache";
+
+        // Changes to the format of the cache or to the meaning of an entry must change this version.
+        constexpr int s_SearchResultCache_Version = 1;
+
+        constexpr std::string_view s_SearchResultCache_IndexVersionName = "indexVersion"sv;
+
+        // The number of requests to keep the results of; the least recently used are removed beyond this.
+        constexpr int64_t s_SearchResultCache_MaximumEntries = 512;
+
+        // Results with more matches than this, such as listing the entire source, are cheap to find relative to their size.
+        constexpr size_t s_SearchResultCache_MaximumMatchesPerEntry = 1000;
+
+        // Other processes may be writing to the cache; wait briefly for them rather than missing.
+        constexpr int s_SearchResultCache_BusyTimeoutInMilliseconds = 250;
+
+        // Gets the key of the request, which includes all of the values that affect the result.
+        SHA256::HashBuffer GetRequestKey(const SearchRequest& request)
+        {
+            std::ostringstream stream;
+
+            // Values are length prefixed so that no combination of them can produce the same key as another.
+            auto writeValue = [&](std::string_view value)
+            {
+                stream << value.length() << ':' << value;
+            };
+
+            auto writeMatch = [&](const RequestMatch& match)
+            {
+                stream << ToIntegral(match.Type) << ',';
+                writeValue(match.Value);
+                if (match.Additional)
+                {
+                    stream << '+';
+                    writeValue(match.Additional.value());
+                }
+                stream << ';';
+            };
+
+            if (request.Query)
+            {
+                stream << 'Q';
+                writeMatch(request.Query.value());
+            }
+
+            for (const auto& inclusion : request.Inclusions)
+            {
+                stream << 'I' << ToIntegral(inclusion.Field) << ',';
+                writeMatch(inclusion);
+            }
+
+            for (const auto& filter : request.Filters)
+            {
+                stream << 'F' << ToIntegral(filter.Field) << ',';
+                writeMatch(filter);
+            }
+
+            stream << 'M' << request.MaximumResults;
+
+            return SHA256::ComputeHash(stream.str());
+        }
+
+        void CreateTables(SQLite::Connection& connection)
+        {
+            SQLite::Statement::Create(connection, "CREATE TABLE IF NOT EXISTS [metadata]([name] TEXT PRIMARY KEY NOT NULL, [value] TEXT NOT NULL)").Execute();
+            SQLite::Statement::Create(connection, "CREATE TABLE IF NOT EXISTS [requests]([rowid] INTEGER PRIMARY KEY, [key] BLOB UNIQUE NOT NULL, [truncated] INT NOT NULL, [last_used] INT64 NOT NULL)").Execute();
+            SQLite::Statement::Create(connection, "CREATE TABLE IF NOT EXISTS [matches]([request] INT64 NOT NULL, [ordinal] INT NOT NULL, [id] INT64 NOT NULL, [field] INT NOT NULL, "
+                "[type] INT NOT NULL, [value] TEXT NOT NULL, [additional] TEXT, PRIMARY KEY([request], [ordinal])) WITHOUT ROWID").Execute();
+        }
+    }
+
+    SearchResultCache::SearchResultCache(std::filesystem::path cacheFile, std::string indexVersion) :
+        m_cacheFile(std::move(cacheFile)), m_indexVersion(std::move(indexVersion))
+    {
+        THROW_HR_IF(E_INVALIDARG, m_cacheFile.empty());
+    }
+
+    std::shared_ptr<SearchResultCache> SearchResultCache::CreateForIndex(std::string_view sourceIdentifier, const std::filesystem::path& indexPath, SQLiteIndex& index)
+    {
+        THROW_HR_IF(E_INVALIDARG, sourceIdentifier.empty());
+
+        // The last write time of the index changes whenever it is rebuilt; the file properties catch an index that has been
+        // replaced without that, and the client version catches any change to how the index is searched.
+        std::ostringstream indexVersion;
+        indexVersion << s_SearchResultCache_Version << '|' << Runtime::GetClientVersion().get() << '|' << index.GetVersion() << '|' <<
+            ConvertSystemClockToUnixEpoch(index.GetLastWriteTime()) << '|' << std::filesystem::file_size(indexPath) << '|' <<
+            std::filesystem::last_write_time(indexPath).time_since_epoch().count();
+
+        std::filesystem::path cacheFile = Runtime::GetPathTo(Runtime::PathName::LocalState) / s_SearchResultCache_Directory;
+        cacheFile /= ConvertToUTF16(sourceIdentifier) + L".db";
+
+        return std::make_shared<SearchResultCache>(std::move(cacheFile), indexVersion.str());
+    }
+
+    std::optional<SQLiteIndex::SearchResult> SearchResultCache::Get(const SearchRequest& request) const
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        SQLite::Connection* connection = EnsureOpen();
+        if (!connection)
+        {
+            return {};
+        }
+
+        try
+        {
+            SQLite::Statement selectRequest = SQLite::Statement::Create(*connection, "SELECT [rowid], [truncated] FROM [requests] WHERE [key] = ?");
+            selectRequest.Bind(1, GetRequestKey(request));
+
+            if (!selectRequest.Step())
+            {
+                AICLI_LOG(Repo, Verbose, << "Search result cache miss for: " << request.ToString());
+                return {};
+            }
+
+            SQLite::rowid_t requestId = selectRequest.GetColumn<SQLite::rowid_t>(0);
+
+            SQLiteIndex::SearchResult result;
+            result.Truncated = selectRequest.GetColumn<bool>(1);
+
+            SQLite::Statement selectMatches = SQLite::Statement::Create(*connection,
+                "SELECT [id], [field], [type], [value], [additional] FROM [matches] WHERE [request] = ? ORDER BY [ordinal]");
+            selectMatches.Bind(1, requestId);
+
+            while (selectMatches.Step())
+            {
+                PackageMatchFilter filter{ selectMatches.GetColumn<PackageMatchField>(1), selectMatches.GetColumn<MatchType>(2), NormalizedString{ selectMatches.GetColumn<std::string>(3) } };
+                if (!selectMatches.GetColumnIsNull(4))
+                {
+                    filter.Additional = NormalizedString{ selectMatches.GetColumn<std::string>(4) };
+                }
+
+                result.Matches.emplace_back(selectMatches.GetColumn<SQLite::rowid_t>(0), std::move(filter));
+            }
+
+            SQLite::Statement updateLastUsed = SQLite::Statement::Create(*connection, "UPDATE [requests] SET [last_used] = ? WHERE [rowid] = ?");
+            updateLastUsed.Bind(1, GetCurrentUnixEpoch());
+            updateLastUsed.Bind(2, requestId);
+            updateLastUsed.Execute();
+
+            AICLI_LOG(Repo, Verbose, << "Search result cache hit with " << result.Matches.size() << " matches for: " << request.ToString());
+            return result;
+        }
+        CATCH_LOG();
+
+        return {};
+    }
+
+    void SearchResultCache::Add(const SearchRequest& request, const SQLiteIndex::SearchResult& result) const
+    {
+        if (result.Matches.size() > s_SearchResultCache_MaximumMatchesPerEntry)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        SQLite::Connection* connection = EnsureOpen();
+        if (!connection)
+        {
+            return;
+        }
+
+        try
+        {
+            SHA256::HashBuffer key = GetRequestKey(request);
+
+            SQLite::Savepoint savepoint = SQLite::Savepoint::Create(*connection, "SearchResultCache_Add");
+
+            SQLite::Statement deleteMatches = SQLite::Statement::Create(*connection, "DELETE FROM [matches] WHERE [request] IN (SELECT [rowid] FROM [requests] WHERE [key] = ?)");
+            deleteMatches.Bind(1, key);
+            deleteMatches.Execute();
+
+            SQLite::Statement deleteRequest = SQLite::Statement::Create(*connection, "DELETE FROM [requests] WHERE [key] = ?");
+            deleteRequest.Bind(1, key);
+            deleteRequest.Execute();
+
+            SQLite::Statement insertRequest = SQLite::Statement::Create(*connection, "INSERT INTO [requests]([key], [truncated], [last_used]) VALUES (?, ?, ?)");
+            insertRequest.Bind(1, key);
+            insertRequest.Bind(2, result.Truncated);
+            insertRequest.Bind(3, GetCurrentUnixEpoch());
+            insertRequest.Execute();
+
+            SQLite::rowid_t requestId = connection->GetLastInsertRowID();
+
+            SQLite::Statement insertMatch = SQLite::Statement::Create(*connection,
+                "INSERT INTO [matches]([request], [ordinal], [id], [field], [type], [value], [additional]) VALUES (?, ?, ?, ?, ?, ?, ?)");
+            for (size_t i = 0; i < result.Matches.size(); ++i)
+            {
+                const auto& [id, filter] = result.Matches[i];
+
+                insertMatch.Reset();
+                insertMatch.Bind(1, requestId);
+                insertMatch.Bind(2, static_cast<int>(i));
+                insertMatch.Bind(3, id);
+                insertMatch.Bind(4, filter.Field);
+                insertMatch.Bind(5, filter.Type);
+                insertMatch.Bind(6, static_cast<const std::string&>(filter.Value));
+                if (filter.Additional)
+                {
+                    insertMatch.Bind(7, static_cast<const std::string&>(filter.Additional.value()));
+                }
+                else
+                {
+                    insertMatch.Bind(7, nullptr);
+                }
+                insertMatch.Execute();
+            }
+
+            Trim(*connection);
+
+            savepoint.Commit();
+        }
+        CATCH_LOG();
+    }
+
+    SQLite::Connection* SearchResultCache::EnsureOpen() const
+    {
+        if (m_connection)
+        {
+            return &m_connection.value();
+        }
+
+        if (m_failed)
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            std::filesystem::create_directories(m_cacheFile.parent_path());
+
+            SQLite::Connection connection = SQLite::Connection::Create(m_cacheFile.u8string(), SQLite::Connection::OpenDisposition::Create);
+            sqlite3_busy_timeout(connection, s_SearchResultCache_BusyTimeoutInMilliseconds);
+
+            SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "SearchResultCache_Open");
+
+            CreateTables(connection);
+
+            SQLite::Statement selectVersion = SQLite::Statement::Create(connection, "SELECT [value] FROM [metadata] WHERE [name] = ?");
+            selectVersion.Bind(1, s_SearchResultCache_IndexVersionName);
+
+            if (!selectVersion.Step() || selectVersion.GetColumn<std::string>(0) != m_indexVersion)
+            {
+                AICLI_LOG(Repo, Info, << "Discarding search results cached for another version of the index: " << m_cacheFile);
+
+                SQLite::Statement::Create(connection, "DELETE FROM [matches]").Execute();
+                SQLite::Statement::Create(connection, "DELETE FROM [requests]").Execute();
+
+                SQLite::Statement setVersion = SQLite::Statement::Create(connection, "INSERT OR REPLACE INTO [metadata]([name], [value]) VALUES (?, ?)");
+                setVersion.Bind(1, s_SearchResultCache_IndexVersionName);
+                setVersion.Bind(2, m_indexVersion);
+                setVersion.Execute();
+            }
+
+            savepoint.Commit();
+
+            m_connection.emplace(std::move(connection));
+            return &m_connection.value();
+        }
+        catch (...)
+        {
+            LOG_CAUGHT_EXCEPTION();
+            AICLI_LOG(Repo, Warning, << "The search result cache could not be opened and will not be used: " << m_cacheFile);
+        }
+
+        m_failed = true;
+        return nullptr;
+    }
+
+    void SearchResultCache::Trim(SQLite::Connection& connection) const
+    {
+        SQLite::Statement countRequests = SQLite::Statement::Create(connection, "SELECT COUNT(*) FROM [requests]");
+        THROW_HR_IF(E_UNEXPECTED, !countRequests.Step());
+        int64_t count = countRequests.GetColumn<int64_t>(0);
+
+        if (count <= s_SearchResultCache_MaximumEntries)
+        {
+            return;
+        }
+
+        // Remove an extra eighth so that the trim is not repeated on every add.
+        int64_t removeCount = count - s_SearchResultCache_MaximumEntries + (s_SearchResultCache_MaximumEntries / 8);
+        AICLI_LOG(Repo, Verbose, << "Removing " << removeCount << " least recently used entries from the search result cache");
+
+        SQLite::Statement deleteMatches = SQLite::Statement::Create(connection,
+            "DELETE FROM [matches] WHERE [request] IN (SELECT [rowid] FROM [requests] ORDER BY [last_used], [rowid] LIMIT ?)");
+        deleteMatches.Bind(1, removeCount);
+        deleteMatches.Execute();
+
+        SQLite::Statement deleteRequests = SQLite::Statement::Create(connection,
+            "DELETE FROM [requests] WHERE [rowid] IN (SELECT [rowid] FROM [requests] ORDER BY [last_used], [rowid] LIMIT ?)");
+        deleteRequests.Bind(1, removeCount);
+        deleteRequests.Execute();
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/SQLiteIndex.h"
+#include "SQLiteWrapper.h"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // A persistent cache of the matches found by searches of a source index that cannot change while it is open, so that
+    // a search that is repeated by a later process skips the index queries.
+    // Entries are only valid for the exact index they were found in; opening the cache for any other version of the index,
+    // as after the source is updated, discards all of them. Any failure to use the cache is logged and treated as a miss.
+    struct SearchResultCache
+    {
+        // The index version must identify the contents of the index that the results come from.
+        SearchResultCache(std::filesystem::path cacheFile, std::string indexVersion);
+
+        SearchResultCache(const SearchResultCache&) = delete;
+        SearchResultCache& operator=(const SearchResultCache&) = delete;
+
+        // Creates the cache for the given source index in the default location.
+        static std::shared_ptr<SearchResultCache> CreateForIndex(std::string_view sourceIdentifier, const std::filesystem::path& indexPath, SQLiteIndex& index);
+
+        // Gets the cached result of the request, if there is one.
+        std::optional<SQLiteIndex::SearchResult> Get(const SearchRequest& request) const;
+
+        // Records the result of the request; results with very many matches are not recorded.
+        void Add(const SearchRequest& request, const SQLiteIndex::SearchResult& result) const;
+
+    private:
+        // Opens the database, discarding any entries for another version of the index.
+        // Returns null if the cache cannot be used. Must be called with the lock held.
+        SQLite::Connection* EnsureOpen() const;
+
+        // Removes the least recently used entries if there are too many. Must be called with the lock held.
+        void Trim(SQLite::Connection& connection) const;
+
+        std::filesystem::path m_cacheFile;
+        std::string m_indexVersion;
+        mutable std::mutex m_lock;
+        mutable std::optional<SQLite::Connection> m_connection;
+        mutable bool m_failed = false;
+    };
+}
@@ -88,7 +88,89 @@ namespace AppInstaller::Repository
 
             return std::make_pair(manifestRowId.value(), maxVersion.GetVersion());
         }
-    
+
+        // The dependencies table and the version keys of the packages in it, read once so that the graph can be walked without a query per node.
+        struct DependencySnapshot
+        {
+            using LatestVersion = std::optional<std::pair<SQLite::rowid_t, Utility::Version>>;
+
+            DependencySnapshot(SQLiteIndex* index) : m_index(index)
+            {
+                auto snapshot = index->GetDependencySnapshot();
+
+                for (auto& dependency : snapshot.Dependencies)
+                {
+                    m_dependencies[dependency.ManifestId].emplace_back(dependency.PackageId, std::move(dependency.MinVersion));
+                }
+
+                for (const auto& manifest : snapshot.Manifests)
+                {
+                    m_packageIds.emplace(manifest.PackageId, manifest.Id);
+
+                    // Matches GetPackageLatestVersion; the channel does not factor into the latest version.
+                    Utility::Version version{ manifest.Version };
+                    auto& latest = m_latestVersions[Utility::FoldCase(manifest.Id)];
+                    if (version > (latest ? latest->second : Utility::Version::CreateUnknown()))
+                    {
+                        latest = std::make_pair(manifest.ManifestId, std::move(version));
+                    }
+                }
+            }
+
+            // Gets the manifest row id and version of the latest version of the package.
+            const LatestVersion& GetLatestVersion(const Manifest::string_t& packageId)
+            {
+                std::string foldedId = Utility::FoldCase(packageId);
+                auto itr = m_latestVersions.find(foldedId);
+
+                if (itr == m_latestVersions.end())
+                {
+                    // Only a package that nothing depends on yet (a direct dependency of the manifest being validated) is not in the snapshot.
+                    itr = m_latestVersions.emplace(std::move(foldedId), GetPackageLatestVersion(m_index, packageId)).first;
+                }
+
+                return itr->second;
+            }
+
+            // Gets the dependencies of the manifest.
+            Manifest::DependencyList GetDependencies(SQLite::rowid_t manifestRowId) const
+            {
+                Manifest::DependencyList depList;
+
+                auto itr = m_dependencies.find(manifestRowId);
+                if (itr == m_dependencies.end())
+                {
+                    return depList;
+                }
+
+                for (const auto& dependency : itr->second)
+                {
+                    depList.Add(Manifest::Dependency(Manifest::DependencyType::Package, GetPackageId(dependency.first), dependency.second));
+                }
+
+                return depList;
+            }
+
+        private:
+            Manifest::string_t GetPackageId(SQLite::rowid_t packageRowId) const
+            {
+                auto itr = m_packageIds.find(packageRowId);
+                if (itr != m_packageIds.end())
+                {
+                    return itr->second;
+                }
+
+                // A package that is depended on always has a manifest, but fall back to the index rather than rely on that.
+                auto manifestRowId = m_index->GetManifestIdByKey(packageRowId, "", "");
+                return m_index->GetPropertyByManifestId(manifestRowId.value(), PackageVersionProperty::Id).value();
+            }
+
+            SQLiteIndex* m_index;
+            std::map<SQLite::rowid_t, std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>>> m_dependencies;
+            std::map<SQLite::rowid_t, std::string> m_packageIds;
+            std::map<std::string, LatestVersion> m_latestVersions;
+        };
+
         void ThrowOnManifestValidationFailed(
             std::vector<std::pair<DependentManifestInfo, Utility::Version>> failedManifests, std::string error)
         {
@@ -117,6 +199,7 @@ namespace AppInstaller::Repository
         Dependency rootId(DependencyType::Package, manifest.Id, manifest.Version);
         std::vector<ValidationError> dependenciesError;
         bool foundErrors = false;
+        DependencySnapshot snapshot{ index };
 
         DependencyGraph graph(rootId, [&](const Dependency& node) {
 
@@ -126,7 +209,7 @@ namespace AppInstaller::Repository
                 return GetDependencies(manifest, DependencyType::Package);
             }
 
-            auto packageLatest = GetPackageLatestVersion(index, node.Id);
+            const auto& packageLatest = snapshot.GetLatestVersion(node.Id);
             if (!packageLatest.has_value())
             {
                 std::string error = ManifestError::MissingManifestDependenciesNode;
@@ -145,19 +228,7 @@ namespace AppInstaller::Repository
                 return depList;
             }
 
-            auto packageLatestDependencies = index->GetDependenciesByManifestRowId(packageLatest.value().first);
-            std::for_each(
-                packageLatestDependencies.begin(),
-                packageLatestDependencies.end(),
-                [&](std::pair<SQLite::rowid_t, Utility::NormalizedString> row)
-                {
-                    auto manifestRowId = index->GetManifestIdByKey(row.first, "", "");
-                    auto packageId = index->GetPropertyByManifestId(manifestRowId.value(), PackageVersionProperty::Id);
-                    Dependency dep(DependencyType::Package, packageId.value(), row.second);
-                    depList.Add(dep);
-                });
-
-            return depList;
+            return snapshot.GetDependencies(packageLatest.value().first);
             });
 
         graph.BuildGraph();
@@ -8,6 +8,7 @@
 #include "AppInstallerDateTime.h"
 
 using namespace std::string_literals;
+using namespace std::string_view_literals;
 using namespace AppInstaller::Repository::Microsoft;
 
 
@@ -66,6 +67,9 @@ namespace AppInstaller::Repository
 
                 SQLiteIndex index = SQLiteIndex::Open(trackingDB.u8string(), SQLiteIndex::OpenDisposition::ReadWrite);
 
+                // Installs record to the catalog while other connections are searching it
+                index.EnableConcurrentReaders();
+
                 // TODO: Check schema version and upgrade as necessary when there is a relevant new schema.
                 //       Could write this all now but it will be better tested when there is a new schema.
 
@@ -117,6 +121,14 @@ namespace AppInstaller::Repository
                     std::filesystem::remove(trackingDB);
                 }
 
+                // Remove the write-ahead log and its index, which are left behind if a connection did not close cleanly
+                for (std::string_view suffix : { "-wal"sv, "-shm"sv })
+                {
+                    std::filesystem::path sidecar = trackingDB;
+                    sidecar += suffix;
+                    std::filesystem::remove(sidecar);
+                }
+
                 return true;
             }
         };
@@ -209,39 +221,73 @@ namespace AppInstaller::Repository
         THROW_HR(E_NOTIMPL);
     }
 
+    namespace
+    {
+        // Records the installation to the index, returning the id of the manifest.
+        SQLiteIndex::IdType RecordInstallToIndex(
+            SQLiteIndex& index,
+            const Manifest::Manifest& manifest,
+            const Manifest::ManifestInstaller& installer,
+            bool isUpgrade)
+        {
+            // TODO: Store additional information from these if needed
+            UNREFERENCED_PARAMETER(installer);
+            UNREFERENCED_PARAMETER(isUpgrade);
+
+            // Check for an existing manifest that matches this one (could be reinstalling)
+            auto manifestIdOpt = index.GetManifestIdByManifest(manifest);
+
+            if (manifestIdOpt)
+            {
+                index.UpdateManifest(manifest);
+            }
+            else
+            {
+                manifestIdOpt = index.AddManifest(manifest);
+            }
+
+            SQLiteIndex::IdType manifestId = manifestIdOpt.value();
+
+            // Write additional metadata for package tracking
+            std::ostringstream strstr;
+            strstr << Utility::GetCurrentUnixEpoch();
+            index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::TrackingWriteTime, strstr.str());
+
+            return manifestId;
+        }
+    }
+
     PackageTrackingCatalog::Version PackageTrackingCatalog::RecordInstall(
         const Manifest::Manifest& manifest,
         const Manifest::ManifestInstaller& installer,
         bool isUpgrade)
     {
-        // TODO: Store additional information from these if needed
-        UNREFERENCED_PARAMETER(installer);
-        UNREFERENCED_PARAMETER(isUpgrade);
+        std::shared_ptr<Version::implementation> result = std::make_shared<Version::implementation>();
+        result->Id = RecordInstallToIndex(m_implementation->Source->GetIndex(), manifest, installer, isUpgrade);
+        return { std::move(result) };
+    }
 
+    std::vector<PackageTrackingCatalog::Version> PackageTrackingCatalog::RecordInstalls(const std::vector<InstallRecord>& records)
+    {
         auto& index = m_implementation->Source->GetIndex();
 
-        // Check for an existing manifest that matches this one (could be reinstalling)
-        auto manifestIdOpt = index.GetManifestIdByManifest(manifest);
+        // Recording each one separately would commit each of them; a single commit is far cheaper for a large batch
+        SQLite::Savepoint savepoint = index.CreateSavepoint("recordinstalls");
 
-        if (manifestIdOpt)
-        {
-            index.UpdateManifest(manifest);
-        }
-        else
+        std::vector<Version> result;
+        result.reserve(records.size());
+
+        for (const auto& record : records)
         {
-            manifestIdOpt = index.AddManifest(manifest);
+            std::shared_ptr<Version::implementation> version = std::make_shared<Version::implementation>();
+            version->Id = RecordInstallToIndex(index, record.PackageManifest, record.Installer, record.IsUpgrade);
+            result.push_back(Version{ std::move(version) });
         }
 
-        SQLiteIndex::IdType manifestId = manifestIdOpt.value();
-
-        // Write additional metadata for package tracking
-        std::ostringstream strstr;
-        strstr << Utility::GetCurrentUnixEpoch();
-        index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::TrackingWriteTime, strstr.str());
+        savepoint.Commit();
 
-        std::shared_ptr<Version::implementation> result = std::make_shared<Version::implementation>();
-        result->Id = manifestId;
-        return { std::move(result) };
+        AICLI_LOG(Repo, Info, << "Recorded " << records.size() << " installs to the tracking catalog");
+        return result;
     }
 
     void PackageTrackingCatalog::RecordUninstall(const Utility::LocIndString& packageIdentifier)
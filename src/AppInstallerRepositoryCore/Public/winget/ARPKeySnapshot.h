@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace AppInstaller::Repository
+{
+    // A lightweight snapshot of the ARP (Add/Remove Programs) entries on the system.
+    // Only the name and last write time of each entry's key are recorded; none of the values are read,
+    // making this much cheaper to create than opening the ARP source.
+    struct ARPKeySnapshot
+    {
+        // The last write time of every entry, keyed by { scope|architecture, product code }.
+        using Entries = std::map<std::pair<std::string, std::string>, std::chrono::system_clock::time_point>;
+
+        ARPKeySnapshot() = default;
+        ARPKeySnapshot(Entries entries) : m_entries(std::move(entries)) {}
+
+        // Creates a snapshot of the ARP entries currently on the system.
+        // Returns an empty value if the snapshot could not be created.
+        static std::optional<ARPKeySnapshot> TryCreate();
+
+        // Gets the number of entries in the snapshot.
+        size_t Size() const { return m_entries.size(); }
+
+        // Gets the product codes of the entries in the given (later) snapshot that are not in this one,
+        // or that have been written since this one was created.
+        std::vector<std::string> GetChangedProductCodes(const ARPKeySnapshot& current) const;
+
+        // Gets a value that identifies the entries and their last write times; it changes when any entry is added, removed or written.
+        std::string GetFingerprint() const;
+
+    private:
+        Entries m_entries;
+    };
+}
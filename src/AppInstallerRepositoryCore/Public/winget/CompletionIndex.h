@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/RepositorySearch.h>
+#include <AppInstallerVersions.h>
+#include <wil/resource.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository
+{
+    struct SourceDetails;
+
+    // A compact, memory mapped index of the identifier, name and moniker of the latest version of every package in a source,
+    // along with the available versions of each; kept beside the source data so that completion does not need to open it.
+    // The values are sorted by their case folded form, so that a prefix lookup is a binary search followed by a sequential read.
+    //
+    // All values are little endian. The file begins with a header:
+    //  char[8]  Magic ("WGCOMPL\0")
+    //  uint32_t Version
+    //  uint32_t KeyCount
+    //  uint32_t PackageCount
+    //  uint32_t VersionCount
+    //  uint32_t StringsSize
+    //  uint32_t Reserved
+    // which is followed by the tables, each of which refers to the strings by { uint32_t offset, uint32_t length }:
+    //  Keys     : { string folded value, uint32_t package, uint32_t field }, sorted by the folded value
+    //  Packages : { string id, string name, string moniker, uint32_t first version, uint32_t version count }
+    //  Versions : { string version, string channel }
+    //  Strings  : the UTF-8 strings, without terminators
+    struct CompletionIndex
+    {
+        // The data used to create an index.
+        struct Package
+        {
+            std::string Id;
+            std::string Name;
+            std::string Moniker;
+            std::vector<Utility::VersionAndChannel> Versions;
+        };
+
+        // Opens the index at the given path.
+        explicit CompletionIndex(const std::filesystem::path& path);
+
+        CompletionIndex(const CompletionIndex&) = delete;
+        CompletionIndex& operator=(const CompletionIndex&) = delete;
+
+        CompletionIndex(CompletionIndex&&) = default;
+        CompletionIndex& operator=(CompletionIndex&&) = default;
+
+        // Writes an index of the given packages, replacing any existing file.
+        static void Create(const std::filesystem::path& path, const std::vector<Package>& packages);
+
+        // Opens the indexes of the current sources, or of just the named source if one is given.
+        // Returns an empty value if any of those sources does not have an index (or there are no sources), in which case completion must search the sources.
+        static std::optional<std::vector<CompletionIndex>> TryOpenForSources(std::string_view sourceName = {});
+
+        // Gets the values of the field that start with the given word, compared case insensitively.
+        // The field must be one of Id, Name or Moniker.
+        std::vector<std::string> Complete(PackageMatchField field, std::string_view word) const;
+
+        // Gets the index of every package that has a value equal to the given value, compared case insensitively, in one of the given fields.
+        std::vector<uint32_t> FindPackages(std::string_view value, const std::vector<PackageMatchField>& fields) const;
+
+        // Gets the available versions of the package, latest first.
+        std::vector<Utility::VersionAndChannel> GetVersions(uint32_t package) const;
+
+    private:
+        struct Header;
+        struct StringRef;
+        struct KeyRecord;
+        struct PackageRecord;
+        struct VersionRecord;
+
+        std::string_view GetString(const StringRef& ref) const;
+
+        // Gets the range of keys whose folded value starts with the given folded value.
+        std::pair<const KeyRecord*, const KeyRecord*> FindKeys(std::string_view foldedPrefix) const;
+
+        wil::unique_handle m_mapping;
+        wil::unique_mapview_ptr<uint8_t> m_view;
+        size_t m_size = 0;
+
+        const KeyRecord* m_keys = nullptr;
+        const PackageRecord* m_packages = nullptr;
+        const VersionRecord* m_versions = nullptr;
+        const char* m_strings = nullptr;
+        uint32_t m_keyCount = 0;
+        uint32_t m_packageCount = 0;
+        uint32_t m_versionCount = 0;
+        uint32_t m_stringsSize = 0;
+    };
+}
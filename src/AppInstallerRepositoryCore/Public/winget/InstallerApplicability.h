@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/Manifest.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository
+{
+    // A compact summary of the installers of a manifest, stored in the index so that installer selection can rule out a version
+    // without downloading its manifest. Only the fields that do not depend on the locale or market are kept:
+    // architecture, scope, installer type (along with those of the ARP entries), minimum OS version and unsupported OS architectures.
+    //
+    // Each installer is written as "arch|scope|type[ arpType...]|minOSVersion|[unsupportedArch...]", and installers are separated by ';'.
+    struct InstallerApplicability
+    {
+        // Creates the summary for the installers of the manifest.
+        static std::string Create(const Manifest::Manifest& manifest);
+
+        // Parses a summary into installers that have only the summarized fields set.
+        // Returns an empty value if the summary is not valid, as the caller must then look at the manifest itself.
+        static std::optional<std::vector<Manifest::ManifestInstaller>> Parse(std::string_view summary);
+    };
+}
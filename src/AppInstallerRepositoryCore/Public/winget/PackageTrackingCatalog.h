@@ -5,6 +5,7 @@
 #include <winget/Manifest.h>
 
 #include <memory>
+#include <vector>
 
 
 namespace AppInstaller::Repository
@@ -61,6 +62,18 @@ namespace AppInstaller::Repository
         // Records an installation of the given package.
         Version RecordInstall(const Manifest::Manifest& manifest, const Manifest::ManifestInstaller& installer, bool isUpgrade);
 
+        // An installation to be recorded along with others.
+        struct InstallRecord
+        {
+            Manifest::Manifest PackageManifest;
+            Manifest::ManifestInstaller Installer;
+            bool IsUpgrade = false;
+        };
+
+        // Records the installations of all of the given packages in a single transaction; either all of them are recorded or none are.
+        // The versions are returned in the same order as the records.
+        std::vector<Version> RecordInstalls(const std::vector<InstallRecord>& records);
+
         // Records an uninstall of the given package.
         void RecordUninstall(const Utility::LocIndString& packageIdentifier);
 
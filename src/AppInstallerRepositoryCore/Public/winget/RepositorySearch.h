@@ -172,6 +172,10 @@ namespace AppInstaller::Repository
         InstalledLocale,
         // The write time for the given version
         TrackingWriteTime,
+        // Identifies the state of the system entry that an installed package was read from
+        InstalledCacheStamp,
+        // The fields of each installer of an available package version that installer selection can reject it on; see InstallerApplicability.h
+        InstallerApplicability,
     };
 
     // Convert a PackageVersionMetadata to a string.
@@ -224,6 +224,9 @@ namespace AppInstaller::Repository
         // Gets the available sources if the source is composite.
         std::vector<Source> GetAvailableSources() const;
 
+        // Gets the installed source if the source is composite; empty if it is not or has no installed source.
+        Source GetInstalledSource() const;
+
         /* Writable sources */
 
         // Adds a package version to the source.
@@ -255,6 +258,14 @@ namespace AppInstaller::Repository
         // Get a list of all available SourceDetails.
         static std::vector<SourceDetails> GetCurrentSources();
 
+        // Waits for the updates started by opening a source, which run detached from that operation, to complete.
+        // The swap to the new data waits for readers of the source to close it, so no source should be held when this is called.
+        static void WaitForDetachedUpdates();
+
+        // Keeps the installed packages in memory for the rest of the process, updating them as the system reports changes,
+        // so that opening the installed source does not scan the system again. Intended for long running processes.
+        static void TrackInstalledChanges();
+
     private:
         void InitializeSourceReference(std::string_view name);
 
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/RepositorySource.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace AppInstaller::Repository
+{
+    // The list of installed packages that had an upgrade available, along with fingerprints of the installed packages
+    // and of the sources that it was computed from. While neither fingerprint has changed, the list is still current
+    // and can be reported without correlating the installed packages with the sources again.
+    struct UpgradeSnapshot
+    {
+        // A package with an upgrade available.
+        struct Entry
+        {
+            std::string Name;
+            std::string Id;
+            std::string InstalledVersion;
+            std::string AvailableVersion;
+            std::string SourceName;
+        };
+
+        std::string InstalledFingerprint;
+        std::string SourcesFingerprint;
+        std::vector<Entry> Entries;
+
+        // Gets a fingerprint of the installed packages, without reading their values.
+        // Returns an empty string if one could not be created.
+        static std::string GetInstalledFingerprint();
+
+        // Gets a fingerprint of the given available source, or of each source if it is a composite.
+        // Returns an empty string if any of the sources can change without being updated, as a snapshot of it would never be known to be current.
+        static std::string GetSourcesFingerprint(const Source& source);
+
+        // Determines whether the snapshot was computed from the given fingerprints; an empty fingerprint never matches.
+        bool IsCurrent(const std::string& installedFingerprint, const std::string& sourcesFingerprint) const;
+
+        // Loads the stored snapshot; returns an empty value if there is none or it cannot be read.
+        static std::optional<UpgradeSnapshot> Load();
+
+        // Stores the snapshot, replacing any existing one. Failures are only logged, as the snapshot is only an optimization.
+        void Save() const;
+    };
+}
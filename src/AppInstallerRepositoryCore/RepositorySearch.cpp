@@ -84,6 +84,8 @@ namespace AppInstaller::Repository
         case PackageVersionMetadata::Publisher: return "Publisher"sv;
         case PackageVersionMetadata::InstalledLocale: return "InstalledLocale"sv;
         case PackageVersionMetadata::TrackingWriteTime: return "TrackingWriteTime"sv;
+        case PackageVersionMetadata::InstalledCacheStamp: return "InstalledCacheStamp"sv;
+        case PackageVersionMetadata::InstallerApplicability: return "InstallerApplicability"sv;
         default: return "Unknown"sv;
         }
     }
@@ -17,6 +17,13 @@
 #endif
 
 #include <winget/GroupPolicy.h>
+#include <winget/Performance.h>
+#include <winget/PerformanceCounters.h>
+#include <winget/ThreadGlobals.h>
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
 
 using namespace AppInstaller::Settings;
 using namespace std::chrono_literals;
@@ -74,11 +81,63 @@ namespace AppInstaller::Repository
             return AddOrUpdateFromDetails(details, &ISourceFactory::Update, progress);
         }
 
+        // Updates the source as part of a source update operation, logging rather than throwing any failure.
+        bool TryUpdateSourceFromDetails(SourceDetails& details, IProgressCallback& progress)
+        {
+            try
+            {
+                if (UpdateSourceFromDetails(details, progress))
+                {
+                    return true;
+                }
+
+                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
+            }
+
+            return false;
+        }
+
+        // One of the updates run concurrently by a source update operation.
+        // The progress is recorded for the calling thread to combine with that of the other updates.
+        struct ConcurrentSourceUpdate : public IProgressSink
+        {
+            static constexpr uint32_t s_ProgressMaximum = 1000;
+
+            ConcurrentSourceUpdate(SourceDetails& details) : Details(details) {}
+
+            void OnProgress(uint64_t current, uint64_t maximum, ProgressType type) override
+            {
+                if (type != ProgressType::None && maximum != 0)
+                {
+                    Progress = static_cast<uint32_t>(std::min(current, maximum) * s_ProgressMaximum / maximum);
+                }
+            }
+
+            void BeginProgress() override {}
+
+            void EndProgress(bool) override {}
+
+            SourceDetails& Details;
+            ProgressCallback Callback{ this };
+            std::atomic<uint32_t> Progress = 0;
+            std::future<bool> Result;
+        };
+
         bool BackgroundUpdateSourceFromDetails(SourceDetails& details, IProgressCallback& progress)
         {
             return AddOrUpdateFromDetails(details, &ISourceFactory::BackgroundUpdate, progress);
         }
 
+        bool DetachedUpdateSourceFromDetails(SourceDetails& details, IProgressCallback& progress)
+        {
+            return AddOrUpdateFromDetails(details, &ISourceFactory::DetachedUpdate, progress);
+        }
+
         bool RemoveSourceFromDetails(const SourceDetails& details, IProgressCallback& progress)
         {
             auto factory = ISourceFactory::GetForType(details.Type);
@@ -119,6 +178,127 @@ namespace AppInstaller::Repository
             return false;
         }
 
+        // Determines whether an update that is due can run detached from the current operation.
+        // This is only done when the source has existing data that has not fallen too far behind.
+        bool CanUpdateDetached(const SourceDetails& details)
+        {
+            constexpr static auto s_ZeroMins = 0min;
+            auto window = User().Get<Setting::BackgroundUpdateWindowInMinutes>();
+
+            if (window == s_ZeroMins || details.LastUpdateTime == std::chrono::system_clock::time_point{})
+            {
+                return false;
+            }
+
+            auto timeSinceLastUpdate = std::chrono::system_clock::now() - details.LastUpdateTime;
+            return timeSinceLastUpdate <= (User().Get<Setting::AutoUpdateTimeInMinutes>() + window);
+        }
+
+        // Tracks the source updates that are running detached from the operations that requested them.
+        struct DetachedSourceUpdates
+        {
+            static DetachedSourceUpdates& Instance()
+            {
+                static DetachedSourceUpdates s_instance;
+                return s_instance;
+            }
+
+            // Starts an update of the source, unless one is already running in this process.
+            void Start(const SourceDetails& details)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    if (!m_running.emplace(details.Name).second)
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Detached update already running for source: " << details.Name);
+                        return;
+                    }
+                }
+
+                // Logging is done through the thread globals, so the worker must share those of the calling thread.
+                std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+                ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+                if (parentThreadGlobals)
+                {
+                    threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+                }
+
+                AICLI_LOG(Repo, Info, << "Starting detached update for source: " << details.Name);
+
+                try
+                {
+                    std::thread([this, details, threadGlobals]()
+                        {
+                            std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                            if (threadGlobals)
+                            {
+                                previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                            }
+
+                            Run(details);
+                        }).detach();
+                }
+                catch (...)
+                {
+                    Complete(details.Name);
+                    throw;
+                }
+            }
+
+            // Waits for all of the running updates to complete.
+            void WaitForAll()
+            {
+                std::unique_lock<std::mutex> lock{ m_lock };
+                m_completed.wait(lock, [this]() { return m_running.empty(); });
+            }
+
+        private:
+            void Run(SourceDetails details)
+            {
+                try
+                {
+                    ProgressCallback progress;
+                    if (DetachedUpdateSourceFromDetails(details, progress))
+                    {
+                        SourceList sourceList;
+                        auto detailsInternal = sourceList.GetSource(details.Name);
+                        if (detailsInternal)
+                        {
+                            detailsInternal->LastUpdateTime = details.LastUpdateTime;
+                            sourceList.SaveMetadata(*detailsInternal);
+                        }
+
+                        AICLI_LOG(Repo, Info, << "Detached update completed for source: " << details.Name);
+                    }
+                    else
+                    {
+                        AICLI_LOG(Repo, Warning, << "Detached update did not complete for source: " << details.Name);
+                    }
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    AICLI_LOG(Repo, Warning, << "Detached update failed for source: " << details.Name);
+                }
+
+                Complete(details.Name);
+            }
+
+            void Complete(const std::string& name)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    m_running.erase(name);
+                }
+
+                m_completed.notify_all();
+            }
+
+            std::mutex m_lock;
+            std::condition_variable m_completed;
+            std::set<std::string> m_running;
+        };
+
         SourceDetails GetPredefinedSourceDetails(PredefinedSource source)
         {
             SourceDetails details;
@@ -410,7 +590,12 @@ namespace AppInstaller::Repository
 
     SearchResult Source::Search(const SearchRequest& request) const
     {
+        Performance::ScopedTimer timer{ "Source::Search" };
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_source);
+
+        auto start = std::chrono::steady_clock::now();
+        auto recordSearch = wil::scope_exit([&]() { Performance::Counters::RecordSearch(std::chrono::steady_clock::now() - start); });
+
         return m_source->Search(request);
     }
 
@@ -463,6 +648,17 @@ namespace AppInstaller::Repository
         return compositeSource->GetAvailableSources();
     }
 
+    Source Source::GetInstalledSource() const
+    {
+        auto compositeSource = m_isComposite ? std::dynamic_pointer_cast<CompositeSource>(m_source) : nullptr;
+        if (!compositeSource)
+        {
+            return {};
+        }
+
+        return compositeSource->GetInstalledSource();
+    }
+
     void Source::AddPackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
     {
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_source);
@@ -481,10 +677,26 @@ namespace AppInstaller::Repository
 
     std::vector<SourceDetails> Source::Open(IProgressCallback& progress)
     {
+        Performance::ScopedTimer timer{ "Source::Open" };
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_isSourceToBeAdded || m_sourceReferences.empty());
 
         std::vector<SourceDetails> result;
 
+        // Records the time taken to open each of the sources.
+        auto openReference = [&progress](const std::shared_ptr<ISourceReference>& sourceReference)
+        {
+            auto start = std::chrono::steady_clock::now();
+            bool succeeded = false;
+            auto recordOpen = wil::scope_exit([&]()
+                {
+                    Performance::Counters::RecordSourceOpen(sourceReference->GetDetails().Name, std::chrono::steady_clock::now() - start, succeeded);
+                });
+
+            auto source = sourceReference->Open(progress);
+            succeeded = true;
+            return source;
+        };
+
         if (!m_source)
         {
             SourceList sourceList;
@@ -495,6 +707,21 @@ namespace AppInstaller::Repository
                 auto& details = sourceReference->GetDetails();
                 if (ShouldUpdateBeforeOpen(details))
                 {
+                    if (CanUpdateDetached(details))
+                    {
+                        try
+                        {
+                            // The existing data is used by this operation; the update is picked up by later ones.
+                            DetachedSourceUpdates::Instance().Start(details);
+                            continue;
+                        }
+                        catch (...)
+                        {
+                            LOG_CAUGHT_EXCEPTION();
+                            AICLI_LOG(Repo, Warning, << "Failed to start detached update, updating before open: " << details.Name);
+                        }
+                    }
+
                     try
                     {
                         // TODO: Consider adding a context callback to indicate we are doing the same action
@@ -533,7 +760,7 @@ namespace AppInstaller::Repository
                     try
 
                     {
-                        aggregatedSource->AddAvailableSource(sourceReference->Open(progress));
+                        aggregatedSource->AddAvailableSource(openReference(sourceReference));
                     }
                     catch (...)
                     {
@@ -556,7 +783,7 @@ namespace AppInstaller::Repository
             }
             else
             {
-                m_source = m_sourceReferences[0]->Open(progress);
+                m_source = openReference(m_sourceReferences[0]);
             }
         }
 
@@ -601,38 +828,105 @@ namespace AppInstaller::Repository
 
     std::vector<SourceDetails> Source::Update(IProgressCallback& progress)
     {
+        Performance::ScopedTimer timer{ "Source::Update" };
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_isSourceToBeAdded || m_source || m_sourceReferences.empty());
 
-        SourceList sourceList;
-        std::vector<SourceDetails> result;
-
         for (auto& sourceReference : m_sourceReferences)
         {
             THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !ContainsAvailablePackagesInternal(sourceReference->GetDetails().Origin));
+            AICLI_LOG(Repo, Info, << "Named source to be updated, found: " << sourceReference->GetDetails().Name);
+        }
 
-            auto& details = sourceReference->GetDetails();
-            AICLI_LOG(Repo, Info, << "Named source to be updated, found: " << details.Name);
+        std::vector<bool> updated(m_sourceReferences.size(), false);
 
-            try
+        if (m_sourceReferences.size() == 1)
+        {
+            updated[0] = TryUpdateSourceFromDetails(m_sourceReferences[0]->GetDetails(), progress);
+        }
+        else
+        {
+            // The sources are independent of each other, each being locked on its own, so the updates are run concurrently.
+            AICLI_LOG(Repo, Info, << "Updating " << m_sourceReferences.size() << " sources concurrently");
+
+            // Logging is done through the thread globals, so the workers must share those of the calling thread.
+            ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+
+            std::vector<std::unique_ptr<ConcurrentSourceUpdate>> updates;
+            updates.reserve(m_sourceReferences.size());
+
+            for (auto& sourceReference : m_sourceReferences)
             {
-                // TODO: Consider adding a context callback to indicate we are doing the same action
-                // to avoid the progress bar fill up multiple times.
-                if (UpdateSourceFromDetails(details, progress))
+                auto& update = *updates.emplace_back(std::make_unique<ConcurrentSourceUpdate>(sourceReference->GetDetails()));
+
+                // Created here rather than on the worker, as creating them touches the parent.
+                std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+                if (parentThreadGlobals)
                 {
-                    auto detailsInternal = sourceList.GetSource(details.Name);
-                    detailsInternal->LastUpdateTime = details.LastUpdateTime;
-                    sourceList.SaveMetadata(*detailsInternal);
+                    threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
                 }
-                else
+
+                update.Result = std::async(std::launch::async, [&update, threadGlobals]()
+                    {
+                        std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                        if (threadGlobals)
+                        {
+                            previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                        }
+
+                        bool result = TryUpdateSourceFromDetails(update.Details, update.Callback);
+                        update.Progress = ConcurrentSourceUpdate::s_ProgressMaximum;
+                        return result;
+                    });
+            }
+
+            // Report the combined progress of all of the updates, and pass along any cancellation.
+            bool cancelled = false;
+            for (auto& update : updates)
+            {
+                while (update->Result.wait_for(100ms) != std::future_status::ready)
                 {
-                    AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
-                    result.emplace_back(details);
+                    if (!cancelled && progress.IsCancelled())
+                    {
+                        AICLI_LOG(Repo, Info, << "Cancelling source updates upon request");
+                        for (auto& toCancel : updates)
+                        {
+                            toCancel->Callback.Cancel();
+                        }
+                        cancelled = true;
+                    }
+
+                    uint64_t current = 0;
+                    for (const auto& toReport : updates)
+                    {
+                        current += toReport->Progress;
+                    }
+
+                    progress.OnProgress(current, static_cast<uint64_t>(updates.size()) * ConcurrentSourceUpdate::s_ProgressMaximum, ProgressType::Percent);
                 }
             }
-            catch (...)
+
+            for (size_t i = 0; i < updates.size(); ++i)
+            {
+                updated[i] = updates[i]->Result.get();
+            }
+        }
+
+        // The update times are written once all of the updates have completed, rather than from each of the workers.
+        SourceList sourceList;
+        std::vector<SourceDetails> result;
+
+        for (size_t i = 0; i < m_sourceReferences.size(); ++i)
+        {
+            auto& details = m_sourceReferences[i]->GetDetails();
+
+            if (updated[i])
+            {
+                auto detailsInternal = sourceList.GetSource(details.Name);
+                detailsInternal->LastUpdateTime = details.LastUpdateTime;
+                sourceList.SaveMetadata(*detailsInternal);
+            }
+            else
             {
-                LOG_CAUGHT_EXCEPTION();
-                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
                 result.emplace_back(details);
             }
         }
@@ -669,6 +963,16 @@ namespace AppInstaller::Repository
         return m_trackingCatalog;
     }
 
+    void Source::WaitForDetachedUpdates()
+    {
+        DetachedSourceUpdates::Instance().WaitForAll();
+    }
+
+    void Source::TrackInstalledChanges()
+    {
+        Microsoft::PredefinedInstalledSourceFactory::EnableChangeTracking();
+    }
+
     std::vector<SourceDetails> Source::GetCurrentSources()
     {
         SourceList sourceList;
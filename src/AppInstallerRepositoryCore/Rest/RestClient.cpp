@@ -37,6 +37,18 @@ namespace AppInstaller::Repository::Rest
             headers.emplace(JsonHelper::GetUtilityString(WindowsPackageManagerHeader), JsonHelper::GetUtilityString(customHeader.value()));
             return headers;
         }
+
+        web::json::value GetInformationResponse(
+            const utility::string_t& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const HttpClientHelper& clientHelper)
+        {
+            // Call information endpoint
+            utility::string_t endpoint = RestHelper::AppendPathToUri(restApi, JsonHelper::GetUtilityString(InformationGetEndpoint));
+            std::optional<web::json::value> response = clientHelper.HandleGet(endpoint, additionalHeaders);
+
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_UNSUPPORTED_RESTSOURCE, !response);
+
+            return std::move(response).value();
+        }
     }
 
     RestClient::RestClient(std::unique_ptr<Schema::IRestClient> supportedInterface, std::string sourceIdentifier)
@@ -49,11 +61,31 @@ namespace AppInstaller::Repository::Rest
         return m_interface->GetManifestByVersion(packageId, version, channel);
     }
 
+    pplx::task<std::vector<Manifest::Manifest>> RestClient::GetManifestsAsync(const std::string& packageId) const
+    {
+        return m_interface->GetManifestsAsync(packageId);
+    }
+
+    std::vector<std::vector<Manifest::Manifest>> RestClient::GetManifestsForPackages(const std::vector<std::string>& packageIds) const
+    {
+        return m_interface->GetManifestsForPackages(packageIds);
+    }
+
+    bool RestClient::SupportsDependencyClosure() const
+    {
+        return m_interface->SupportsDependencyClosure();
+    }
+
     IRestClient::SearchResult RestClient::Search(const SearchRequest& request) const
     {
         return m_interface->Search(request);
     }
 
+    pplx::task<IRestClient::SearchResult> RestClient::SearchAsync(const SearchRequest& request) const
+    {
+        return m_interface->SearchAsync(request);
+    }
+
     std::string RestClient::GetSourceIdentifier() const
     {
         return m_sourceIdentifier;
@@ -67,16 +99,50 @@ namespace AppInstaller::Repository::Rest
     IRestClient::Information RestClient::GetInformation(
         const utility::string_t& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const HttpClientHelper& clientHelper)
     {
-        // Call information endpoint
-        utility::string_t endpoint = RestHelper::AppendPathToUri(restApi, JsonHelper::GetUtilityString(InformationGetEndpoint));
-        std::optional<web::json::value> response = clientHelper.HandleGet(endpoint, additionalHeaders);
+        InformationResponseDeserializer responseDeserializer;
+        IRestClient::Information information = responseDeserializer.Deserialize(GetInformationResponse(restApi, additionalHeaders, clientHelper));
+
+        return information;
+    }
+
+    RestInformationCache::Entry RestClient::GetInformationAndVersion(
+        const utility::string_t& restApi,
+        const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders,
+        const HttpClientHelper& clientHelper,
+        const RestInformationCache* informationCache)
+    {
+        if (informationCache)
+        {
+            std::optional<RestInformationCache::Entry> cached = informationCache->Get(restApi, additionalHeaders);
+
+            // A version that this client no longer supports is negotiated again.
+            if (cached && WingetSupportedContracts.count(cached->Version) != 0)
+            {
+                AICLI_LOG(Repo, Verbose, << "Using cached source information, with version " << cached->Version.ToString());
+                return std::move(cached).value();
+            }
+        }
 
-        THROW_HR_IF(APPINSTALLER_CLI_ERROR_UNSUPPORTED_RESTSOURCE, !response);
+        web::json::value response = GetInformationResponse(restApi, additionalHeaders, clientHelper);
 
         InformationResponseDeserializer responseDeserializer;
-        IRestClient::Information information = responseDeserializer.Deserialize(response.value());
+        RestInformationCache::Entry result;
+        result.Information = responseDeserializer.Deserialize(response);
 
-        return information;
+        std::optional<Version> latestCommonVersion = GetLatestCommonVersion(result.Information.ServerSupportedVersions, WingetSupportedContracts);
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_UNSUPPORTED_RESTSOURCE, !latestCommonVersion);
+        result.Version = std::move(latestCommonVersion).value();
+
+        if (informationCache)
+        {
+            try
+            {
+                informationCache->Put(restApi, additionalHeaders, response, result.Version);
+            }
+            CATCH_LOG();
+        }
+
+        return result;
     }
 
     std::optional<Version> RestClient::GetLatestCommonVersion(
@@ -120,32 +186,32 @@ namespace AppInstaller::Repository::Rest
         const std::string& api,
         const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders,
         const IRestClient::Information& information,
-        const Version& version)
+        const Version& version,
+        const HttpClientHelper& helper)
     {
         if (version == Version_1_0_0)
         {
-            return std::make_unique<Schema::V1_0::Interface>(api);
+            return std::make_unique<Schema::V1_0::Interface>(api, helper);
         }
         else if (version == Version_1_1_0)
         {
-            return std::make_unique<Schema::V1_1::Interface>(api, information, additionalHeaders);
+            return std::make_unique<Schema::V1_1::Interface>(api, information, additionalHeaders, helper);
         }
 
         THROW_HR(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_VERSION);
     }
 
-    RestClient RestClient::Create(const std::string& restApi, std::optional<std::string> customHeader, const HttpClientHelper& helper)
+    RestClient RestClient::Create(const std::string& restApi, std::optional<std::string> customHeader, const HttpClientHelper& helper, std::shared_ptr<RestInformationCache> informationCache)
     {
         utility::string_t restEndpoint = RestHelper::GetRestAPIBaseUri(restApi);
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_URL, !RestHelper::IsValidUri(restEndpoint));
 
         auto headers = GetHeaders(customHeader);
 
-        IRestClient::Information information = GetInformation(restEndpoint, headers, helper);
-        std::optional<Version> latestCommonVersion = GetLatestCommonVersion(information.ServerSupportedVersions, WingetSupportedContracts);
-        THROW_HR_IF(APPINSTALLER_CLI_ERROR_UNSUPPORTED_RESTSOURCE, !latestCommonVersion);
+        RestInformationCache::Entry informationAndVersion = GetInformationAndVersion(restEndpoint, headers, helper, informationCache.get());
+        const IRestClient::Information& information = informationAndVersion.Information;
 
-        std::unique_ptr<Schema::IRestClient> supportedInterface = GetSupportedInterface(utility::conversions::to_utf8string(restEndpoint), headers, information, latestCommonVersion.value());
+        std::unique_ptr<Schema::IRestClient> supportedInterface = GetSupportedInterface(utility::conversions::to_utf8string(restEndpoint), headers, information, informationAndVersion.Version, helper);
         return RestClient{ std::move(supportedInterface), information.SourceIdentifier };
     }
 }
@@ -5,6 +5,7 @@
 #include <cpprest/json.h>
 #include "Rest/Schema/IRestClient.h"
 #include "Rest/Schema/HttpClientHelper.h"
+#include "Rest/RestInformationCache.h"
 #include "cpprest/json.h"
 #include "ISource.h"
 
@@ -21,8 +22,20 @@ namespace AppInstaller::Repository::Rest
         // Performs a search based on the given criteria.
         Schema::IRestClient::SearchResult Search(const SearchRequest& request) const;
 
+        // Performs a search without blocking the calling thread while waiting on the source; the client must outlive the task.
+        pplx::task<Schema::IRestClient::SearchResult> SearchAsync(const SearchRequest& request) const;
+
         std::optional<Manifest::Manifest> GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const;
 
+        // Gets the manifests of all versions of the package without blocking the calling thread; the client must outlive the task.
+        pplx::task<std::vector<Manifest::Manifest>> GetManifestsAsync(const std::string& packageId) const;
+
+        // Gets the manifests of all versions of each of the given packages, in the same order as the package identifiers.
+        std::vector<std::vector<Manifest::Manifest>> GetManifestsForPackages(const std::vector<std::string>& packageIds) const;
+
+        // Determines whether the source can resolve the transitive dependencies of a package itself.
+        bool SupportsDependencyClosure() const;
+
         std::string GetSourceIdentifier() const;
 
         Schema::IRestClient::Information GetSourceInformation() const;
@@ -31,9 +44,14 @@ namespace AppInstaller::Repository::Rest
 
         static Schema::IRestClient::Information GetInformation(const utility::string_t& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::HttpClientHelper& httpClientHelper);
 
-        static std::unique_ptr<Schema::IRestClient> GetSupportedInterface(const std::string& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::IRestClient::Information& information, const AppInstaller::Utility::Version& version);
+        // Gets the information response and negotiates the version with the source; from the cache when it holds them for the source.
+        static RestInformationCache::Entry GetInformationAndVersion(const utility::string_t& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::HttpClientHelper& httpClientHelper, const RestInformationCache* informationCache);
+
+        // Creates the interface for the given version, which sends its requests through the given helper.
+        static std::unique_ptr<Schema::IRestClient> GetSupportedInterface(const std::string& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::IRestClient::Information& information, const AppInstaller::Utility::Version& version, const Schema::HttpClientHelper& helper = {});
 
-        static RestClient Create(const std::string& restApi, std::optional<std::string> customHeader, const Schema::HttpClientHelper& helper = {});
+        // Creates the client; the information of the source is read from and stored in the given cache, if any.
+        static RestClient Create(const std::string& restApi, std::optional<std::string> customHeader, const Schema::HttpClientHelper& helper = {}, std::shared_ptr<RestInformationCache> informationCache = {});
     private:
         RestClient(std::unique_ptr<Schema::IRestClient> supportedInterface, std::string sourceIdentifier);
 
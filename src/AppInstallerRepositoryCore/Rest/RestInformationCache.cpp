@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "RestInformationCache.h"
+#include "Rest/Schema/InformationResponseDeserializer.h"
+
+namespace AppInstaller::Repository::Rest
+{
+    namespace
+    {
+        constexpr std::wstring_view s_RestInformationCache_Directory = L"RestInformationCache";
+
+        // Entries older than this are requested again, so that changes to the source are picked up even without an update.
+        constexpr auto s_RestInformationCache_MaximumAge = std::chrono::hours(24);
+
+        const utility::string_t s_RestInformationCache_RestApiField = L"restApi";
+        const utility::string_t s_RestInformationCache_HeadersField = L"headers";
+        const utility::string_t s_RestInformationCache_ClientVersionField = L"clientVersion";
+        const utility::string_t s_RestInformationCache_RetrievedField = L"retrieved";
+        const utility::string_t s_RestInformationCache_VersionField = L"version";
+        const utility::string_t s_RestInformationCache_InformationField = L"information";
+
+        // The headers are kept as a single string so that they compare without regard to the order of the map.
+        utility::string_t SerializeHeaders(const std::unordered_map<utility::string_t, utility::string_t>& headers)
+        {
+            std::map<utility::string_t, utility::string_t> sortedHeaders{ headers.begin(), headers.end() };
+
+            utility::string_t result;
+            for (const auto& header : sortedHeaders)
+            {
+                result += header.first;
+                result += L':';
+                result += header.second;
+                result += L'\n';
+            }
+
+            return result;
+        }
+    }
+
+    RestInformationCache::RestInformationCache(std::filesystem::path root) : m_root(std::move(root))
+    {
+        THROW_HR_IF(E_INVALIDARG, m_root.empty());
+    }
+
+    std::shared_ptr<RestInformationCache> RestInformationCache::GetDefault()
+    {
+        return std::make_shared<RestInformationCache>(Runtime::GetPathTo(Runtime::PathName::LocalState) / s_RestInformationCache_Directory);
+    }
+
+    std::optional<RestInformationCache::Entry> RestInformationCache::Get(
+        const utility::string_t& restApi,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(restApi);
+
+        // The cache is only an optimization, so any failure to read it is a miss
+        try
+        {
+            std::error_code error;
+            if (!std::filesystem::exists(entryPath, error))
+            {
+                return {};
+            }
+
+            std::ifstream stream{ entryPath, std::ios_base::in | std::ios_base::binary };
+            web::json::value contents = web::json::value::parse(stream);
+
+            // Guard against the unlikely event of a hash collision, as well as changes that the cached response may depend on
+            if (!contents.has_string_field(s_RestInformationCache_RestApiField) || contents.at(s_RestInformationCache_RestApiField).as_string() != restApi ||
+                !contents.has_string_field(s_RestInformationCache_HeadersField) || contents.at(s_RestInformationCache_HeadersField).as_string() != SerializeHeaders(headers) ||
+                !contents.has_string_field(s_RestInformationCache_ClientVersionField) ||
+                utility::conversions::to_utf8string(contents.at(s_RestInformationCache_ClientVersionField).as_string()) != Runtime::GetClientVersion().get() ||
+                !contents.has_number_field(s_RestInformationCache_RetrievedField) ||
+                !contents.has_string_field(s_RestInformationCache_VersionField) ||
+                !contents.has_field(s_RestInformationCache_InformationField))
+            {
+                return {};
+            }
+
+            auto retrieved = Utility::ConvertUnixEpochToSystemClock(contents.at(s_RestInformationCache_RetrievedField).as_number().to_int64());
+            auto age = std::chrono::system_clock::now() - retrieved;
+            if (age < std::chrono::system_clock::duration::zero() || age > s_RestInformationCache_MaximumAge)
+            {
+                AICLI_LOG(Repo, Verbose, << "Cached source information has expired");
+                return {};
+            }
+
+            Schema::InformationResponseDeserializer deserializer;
+
+            Entry result;
+            result.Information = deserializer.Deserialize(contents.at(s_RestInformationCache_InformationField));
+            result.Version = Utility::Version{ utility::conversions::to_utf8string(contents.at(s_RestInformationCache_VersionField).as_string()) };
+
+            return result;
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Verbose, << "Failed to read cached source information from " << entryPath);
+            return {};
+        }
+    }
+
+    void RestInformationCache::Put(
+        const utility::string_t& restApi,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers,
+        const web::json::value& informationResponse,
+        const Utility::Version& version) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(restApi);
+
+        web::json::value contents;
+        contents[s_RestInformationCache_RestApiField] = web::json::value::string(restApi);
+        contents[s_RestInformationCache_HeadersField] = web::json::value::string(SerializeHeaders(headers));
+        contents[s_RestInformationCache_ClientVersionField] = web::json::value::string(utility::conversions::to_string_t(Runtime::GetClientVersion().get()));
+        contents[s_RestInformationCache_RetrievedField] = web::json::value::number(Utility::GetCurrentUnixEpoch());
+        contents[s_RestInformationCache_VersionField] = web::json::value::string(utility::conversions::to_string_t(version.ToString()));
+        contents[s_RestInformationCache_InformationField] = informationResponse;
+
+        std::filesystem::create_directories(m_root);
+
+        // Write to a unique file and then move it into place, as other processes may be using the same entry
+        std::filesystem::path tempPath = entryPath;
+        tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId());
+
+        {
+            std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+            stream << utility::conversions::to_utf8string(contents.serialize());
+            THROW_HR_IF(E_FAIL, stream.fail());
+        }
+
+        std::filesystem::rename(tempPath, entryPath);
+    }
+
+    void RestInformationCache::Remove(const utility::string_t& restApi) const
+    {
+        std::error_code error;
+        std::filesystem::remove(GetEntryPath(restApi), error);
+    }
+
+    std::filesystem::path RestInformationCache::GetEntryPath(const utility::string_t& restApi) const
+    {
+        return m_root / Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(utility::conversions::to_utf8string(restApi)));
+    }
+}
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Rest/Schema/IRestClient.h"
+#include <AppInstallerVersions.h>
+#include <cpprest/json.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace AppInstaller::Repository::Rest
+{
+    // An on disk cache of the information response of each rest source and the interface version negotiated with it,
+    // so that opening a source does not need to request its information endpoint every time.
+    // Entries are keyed by the rest api, and are only used with the same headers and client version that they were stored with.
+    struct RestInformationCache
+    {
+        // A cached information response.
+        struct Entry
+        {
+            Schema::IRestClient::Information Information;
+            Utility::Version Version;
+        };
+
+        RestInformationCache(std::filesystem::path root);
+
+        // Gets the cache in the default location.
+        static std::shared_ptr<RestInformationCache> GetDefault();
+
+        // Gets the cached information for the rest api, if there is one that has not expired.
+        std::optional<Entry> Get(
+            const utility::string_t& restApi,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers) const;
+
+        // Stores the information response and the negotiated version for the rest api.
+        void Put(
+            const utility::string_t& restApi,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers,
+            const web::json::value& informationResponse,
+            const Utility::Version& version) const;
+
+        // Removes the cached information for the rest api, so that it is requested again when the source is next opened.
+        void Remove(const utility::string_t& restApi) const;
+
+    private:
+        std::filesystem::path GetEntryPath(const utility::string_t& restApi) const;
+
+        std::filesystem::path m_root;
+    };
+}
@@ -29,11 +29,22 @@ namespace AppInstaller::Repository::Rest
             std::weak_ptr<RestSource> m_source;
         };
 
+        struct AvailablePackage;
+
+        // The packages returned by a single search. When the manifest of one of them is needed, those of all of them
+        // are retrieved together, as callers like upgrade go through every package in the result.
+        struct SearchResultPackages
+        {
+            std::mutex Lock;
+            std::vector<std::weak_ptr<AvailablePackage>> Packages;
+            bool ManifestsRetrieved = false;
+        };
+
         // The IPackage implementation for Available packages from RestSource.
         struct AvailablePackage : public std::enable_shared_from_this<AvailablePackage>, public SourceReference, public IPackage
         {
-            AvailablePackage(const std::shared_ptr<RestSource>& source, IRestClient::Package&& package) :
-                SourceReference(source), m_package(std::move(package))
+            AvailablePackage(const std::shared_ptr<RestSource>& source, IRestClient::Package&& package, std::shared_ptr<SearchResultPackages> searchResultPackages = {}) :
+                SourceReference(source), m_package(std::move(package)), m_searchResultPackages(std::move(searchResultPackages))
             {
                 SortVersionsInternal();
             }
@@ -153,7 +164,102 @@ namespace AppInstaller::Repository::Rest
                 return false;
             }
 
+            // Retrieves the manifests of all of the packages from the same search, if that has not been done yet.
+            void RetrieveSearchResultManifests()
+            {
+                if (!m_searchResultPackages)
+                {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock{ m_searchResultPackages->Lock };
+
+                // Only attempted once; packages that are not retrieved fall back to requesting their own manifests
+                if (m_searchResultPackages->ManifestsRetrieved)
+                {
+                    return;
+                }
+                m_searchResultPackages->ManifestsRetrieved = true;
+
+                std::vector<std::shared_ptr<AvailablePackage>> packages;
+                std::vector<std::string> packageIds;
+
+                for (const auto& weakPackage : m_searchResultPackages->Packages)
+                {
+                    std::shared_ptr<AvailablePackage> package = weakPackage.lock();
+                    if (package)
+                    {
+                        packageIds.emplace_back(package->PackageInfo().PackageIdentifier);
+                        packages.emplace_back(std::move(package));
+                    }
+                }
+
+                if (packages.size() <= 1)
+                {
+                    return;
+                }
+
+                AICLI_LOG(Repo, Info, << "Retrieving manifests for " << packages.size() << " packages from the search result");
+
+                try
+                {
+                    std::vector<std::vector<Manifest::Manifest>> manifests = GetReferenceSource()->GetRestClient().GetManifestsForPackages(packageIds);
+
+                    for (size_t i = 0; i < packages.size() && i < manifests.size(); ++i)
+                    {
+                        packages[i]->SetRetrievedManifests(std::move(manifests[i]));
+                    }
+                }
+                catch (...)
+                {
+                    AICLI_LOG(Repo, Warning, << "Failed to retrieve the manifests of the search result; they will be retrieved individually");
+                }
+            }
+
+            // Gets the manifest of the given version if it was retrieved with the search result.
+            std::optional<Manifest::Manifest> GetRetrievedManifest(const Utility::VersionAndChannel& versionAndChannel) const
+            {
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+
+                for (const auto& versionInfo : m_package.Versions)
+                {
+                    if (versionInfo.Manifest &&
+                        CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetVersion().ToString(), versionAndChannel.GetVersion().ToString()) &&
+                        CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetChannel().ToString(), versionAndChannel.GetChannel().ToString()))
+                    {
+                        return versionInfo.Manifest;
+                    }
+                }
+
+                return {};
+            }
+
+            // Keeps the manifest that a version requested on its own, so that the other objects for the same version share it.
+            void AddRetrievedManifest(const Manifest::Manifest& manifest)
+            {
+                SetRetrievedManifests({ manifest });
+            }
+
         private:
+            void SetRetrievedManifests(std::vector<Manifest::Manifest>&& manifests)
+            {
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+
+                for (auto& manifest : manifests)
+                {
+                    for (auto& versionInfo : m_package.Versions)
+                    {
+                        if (!versionInfo.Manifest &&
+                            CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetVersion().ToString(), manifest.Version) &&
+                            CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetChannel().ToString(), manifest.Channel))
+                        {
+                            versionInfo.Manifest = std::move(manifest);
+                            break;
+                        }
+                    }
+                }
+            }
+
             std::shared_ptr<AvailablePackage> NonConstSharedFromThis() const
             {
                 return const_cast<AvailablePackage*>(this)->shared_from_this();
@@ -175,6 +281,7 @@ namespace AppInstaller::Repository::Rest
             IRestClient::Package m_package;
             // Protects access to m_package.Versions
             mutable std::mutex m_packageVersionsLock;
+            std::shared_ptr<SearchResultPackages> m_searchResultPackages;
         };
 
         // The IPackageVersion impl for RestSource.
@@ -262,6 +369,8 @@ namespace AppInstaller::Repository::Rest
             {
                 AICLI_LOG(Repo, Verbose, << "Getting manifest");
 
+                std::lock_guard<std::mutex> lock{ m_manifestLock };
+
                 if (m_versionInfo.Manifest)
                 {
                     return m_versionInfo.Manifest.value();
@@ -273,6 +382,15 @@ namespace AppInstaller::Repository::Rest
                     return m_versionInfo.Manifest.value();
                 }
 
+                m_package->RetrieveSearchResultManifests();
+
+                std::optional<Manifest::Manifest> retrievedManifest = m_package->GetRetrievedManifest(m_versionInfo.VersionAndChannel);
+                if (retrievedManifest)
+                {
+                    m_versionInfo.Manifest = std::move(retrievedManifest);
+                    return m_versionInfo.Manifest.value();
+                }
+
                 std::optional<Manifest::Manifest> manifest = GetReferenceSource()->GetRestClient().GetManifestByVersion(
                     m_package->PackageInfo().PackageIdentifier, m_versionInfo.VersionAndChannel.GetVersion().ToString(), m_versionInfo.VersionAndChannel.GetChannel().ToString());
 
@@ -283,6 +401,7 @@ namespace AppInstaller::Repository::Rest
                 }
                 
                 m_versionInfo.Manifest = std::move(manifest.value());
+                m_package->AddRetrievedManifest(m_versionInfo.Manifest.value());
                 return m_versionInfo.Manifest.value();
             }
 
@@ -318,6 +437,8 @@ namespace AppInstaller::Repository::Rest
 
             std::shared_ptr<AvailablePackage> m_package;
             IRestClient::VersionInfo m_versionInfo;
+            // Protects the manifest in m_versionInfo, which is retrieved on first use
+            std::mutex m_manifestLock;
         };
 
         std::shared_ptr<IPackageVersion> AvailablePackage::GetAvailableVersion(const PackageVersionKey& versionKey) const
@@ -402,13 +523,35 @@ namespace AppInstaller::Repository::Rest
 
     SearchResult RestSource::Search(const SearchRequest& request) const
     {
-        IRestClient::SearchResult results = m_restClient.Search(request);
+        return CreateSearchResult(m_restClient.Search(request));
+    }
+
+    pplx::task<SearchResult> RestSource::SearchAsync(const SearchRequest& request) const
+    {
+        std::shared_ptr<RestSource> sharedThis = NonConstSharedFromThis();
+
+        return m_restClient.SearchAsync(request).then([sharedThis](IRestClient::SearchResult results)
+            {
+                return sharedThis->CreateSearchResult(std::move(results));
+            });
+    }
+
+    SearchResult RestSource::CreateSearchResult(IRestClient::SearchResult&& results) const
+    {
         SearchResult searchResult;
 
         std::shared_ptr<RestSource> sharedThis = NonConstSharedFromThis();
+        std::shared_ptr<SearchResultPackages> searchResultPackages = (results.Matches.size() > 1 ? std::make_shared<SearchResultPackages>() : nullptr);
+
         for (auto& result : results.Matches)
         {
-            std::shared_ptr<IPackage> package = std::make_shared<AvailablePackage>(sharedThis, std::move(result));
+            std::shared_ptr<AvailablePackage> availablePackage = std::make_shared<AvailablePackage>(sharedThis, std::move(result), searchResultPackages);
+            if (searchResultPackages)
+            {
+                searchResultPackages->Packages.emplace_back(availablePackage);
+            }
+
+            std::shared_ptr<IPackage> package = std::move(availablePackage);
 
             // TODO: Improve to use Package match filter to return relevant search results.
             PackageMatchFilter packageFilter{ {}, {}, {} };
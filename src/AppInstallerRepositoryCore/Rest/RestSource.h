@@ -32,6 +32,10 @@ namespace AppInstaller::Repository::Rest
         // Execute a search on the source.
         SearchResult Search(const SearchRequest& request) const override;
 
+        // Execute a search on the source without blocking the calling thread while waiting on the server.
+        // The task holds a reference to the source until it completes.
+        pplx::task<SearchResult> SearchAsync(const SearchRequest& request) const;
+
         // Gets the rest client.
         const RestClient& GetRestClient() const;
 
@@ -41,6 +45,9 @@ namespace AppInstaller::Repository::Rest
     private:
         std::shared_ptr<RestSource> NonConstSharedFromThis() const;
 
+        // Creates the packages of the search result from those returned by the client.
+        SearchResult CreateSearchResult(Schema::IRestClient::SearchResult&& results) const;
+
         SourceDetails m_details;
         SourceInformation m_information;
         RestClient m_restClient;
@@ -4,6 +4,7 @@
 #include "RestSourceFactory.h"
 #include "RestClient.h"
 #include "RestSource.h"
+#include "Rest/Schema/RestHelper.h"
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -12,6 +13,16 @@ namespace AppInstaller::Repository::Rest
 {
     namespace
     {
+        // Removes the cached information of the source, so that it is requested again when the source is next opened.
+        void RemoveCachedInformation(const SourceDetails& details)
+        {
+            try
+            {
+                RestInformationCache::GetDefault()->Remove(Schema::RestHelper::GetRestAPIBaseUri(details.Arg));
+            }
+            CATCH_LOG();
+        }
+
         struct RestSourceReference : public ISourceReference
         {
             RestSourceReference(const SourceDetails& details) : m_details(details) {}
@@ -40,8 +51,20 @@ namespace AppInstaller::Repository::Rest
             std::shared_ptr<ISource> Open(IProgressCallback&) override
             {
                 Initialize();
-                RestClient restClient = RestClient::Create(m_details.Arg, m_customHeader);
-                return std::make_shared<RestSource>(m_details, m_information, std::move(restClient));
+
+                // Use the client created to initialize, rather than creating another one for the same source.
+                std::optional<RestClient> restClient;
+                {
+                    std::lock_guard<std::mutex> lock{ m_restClientLock };
+                    restClient.swap(m_restClient);
+                }
+
+                if (!restClient)
+                {
+                    restClient.emplace(RestClient::Create(m_details.Arg, m_customHeader, {}, RestInformationCache::GetDefault()));
+                }
+
+                return std::make_shared<RestSource>(m_details, m_information, std::move(restClient).value());
             }
 
         private:
@@ -50,7 +73,7 @@ namespace AppInstaller::Repository::Rest
                 std::call_once(m_initializeFlag,
                     [&]()
                     {
-                        RestClient restClient = RestClient::Create(m_details.Arg, m_customHeader);
+                        RestClient restClient = RestClient::Create(m_details.Arg, m_customHeader, {}, RestInformationCache::GetDefault());
 
                         m_details.Identifier = restClient.GetSourceIdentifier();
 
@@ -65,6 +88,9 @@ namespace AppInstaller::Repository::Rest
                         {
                             m_information.SourceAgreements.emplace_back(agreement.Label, agreement.Text, agreement.Url);
                         }
+
+                        std::lock_guard<std::mutex> lock{ m_restClientLock };
+                        m_restClient.emplace(std::move(restClient));
                     });
             }
 
@@ -72,6 +98,8 @@ namespace AppInstaller::Repository::Rest
             SourceInformation m_information;
             std::optional<std::string> m_customHeader;
             std::once_flag m_initializeFlag;
+            std::mutex m_restClientLock;
+            std::optional<RestClient> m_restClient;
         };
 
         // The base class for data that comes from a rest based source.
@@ -99,18 +127,35 @@ namespace AppInstaller::Repository::Rest
                 THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_NOT_REMOTE, !Utility::IsUrlRemote(details.Arg));
                 THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_NOT_SECURE, !Utility::IsUrlSecure(details.Arg));
 
+                // A source previously added with the same url may have left its information behind.
+                RemoveCachedInformation(details);
+
                 return true;
             }
 
             bool Update(const SourceDetails& details, IProgressCallback&) override final
+            {
+                THROW_HR_IF(E_INVALIDARG, !Utility::CaseInsensitiveEquals(details.Type, RestSourceFactory::Type()));
+                RemoveCachedInformation(details);
+                return true;
+            }
+
+            // Automatic updates leave the cached information to expire on its own, as they happen far more often than it changes.
+            bool BackgroundUpdate(const SourceDetails& details, IProgressCallback&) override final
             {
                 THROW_HR_IF(E_INVALIDARG, !Utility::CaseInsensitiveEquals(details.Type, RestSourceFactory::Type()));
                 return true;
             }
 
+            bool DetachedUpdate(const SourceDetails& details, IProgressCallback& progress) override final
+            {
+                return BackgroundUpdate(details, progress);
+            }
+
             bool Remove(const SourceDetails& details, IProgressCallback&) override final
             {
                 THROW_HR_IF(E_INVALIDARG, !Utility::CaseInsensitiveEquals(details.Type, RestSourceFactory::Type()));
+                RemoveCachedInformation(details);
                 return true;
             }
         };
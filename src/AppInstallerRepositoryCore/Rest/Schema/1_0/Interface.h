@@ -3,6 +3,7 @@
 #pragma once
 #include "Rest/Schema/IRestClient.h"
 #include "Rest/Schema/HttpClientHelper.h"
+#include "Rest/Schema/1_0/Json/ManifestDeserializer.h"
 #include <cpprest/json.h>
 
 namespace AppInstaller::Repository::Rest::Schema::V1_0
@@ -21,13 +22,19 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         Utility::Version GetVersion() const override;
         IRestClient::Information GetSourceInformation() const override;
         IRestClient::SearchResult Search(const SearchRequest& request) const override;
+        pplx::task<IRestClient::SearchResult> SearchAsync(const SearchRequest& request) const override;
         std::optional<Manifest::Manifest> GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const override;
         std::vector<Manifest::Manifest> GetManifests(const std::string& packageId, const std::map<std::string_view, std::string>& params = {}) const override;
+        pplx::task<std::vector<Manifest::Manifest>> GetManifestsAsync(const std::string& packageId, const std::map<std::string_view, std::string>& params = {}) const override;
+
+        // Requests the manifests of each package separately, with a limited number of requests outstanding at a time.
+        std::vector<std::vector<Manifest::Manifest>> GetManifestsForPackages(const std::vector<std::string>& packageIds) const override;
+
+        // There is no way to report this in this version.
+        bool SupportsDependencyClosure() const override;
 
     protected:
         bool MeetsOptimizedSearchCriteria(const SearchRequest& request) const;
-        IRestClient::SearchResult OptimizedSearch(const SearchRequest& request) const;
-        IRestClient::SearchResult SearchInternal(const SearchRequest& request) const;
 
         // Check query params against source information and update if necessary.
         virtual std::map<std::string_view, std::string> GetValidatedQueryParams(const std::map<std::string_view, std::string>& params) const;
@@ -35,12 +42,46 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         // Check search request against source information and get json search body.
         virtual web::json::value GetValidatedSearchBody(const SearchRequest& searchRequest) const;
 
+        // Determines whether the source supports the inclusion, rather than ignoring it when validating the search body.
+        virtual bool IsInclusionSupported(const PackageMatchFilter& inclusion) const;
+
         virtual SearchResult GetSearchResult(const web::json::value& searchResponseObject) const;
-        virtual std::vector<Manifest::Manifest> GetParsedManifests(const web::json::value& manifestsResponseObject) const;
+        // The json of each version is released as it is deserialized, and only the selected versions are deserialized.
+        virtual std::vector<Manifest::Manifest> GetParsedManifests(web::json::value& manifestsResponseObject, const Json::ManifestDeserializer::VersionSelection& selection) const;
+
+        // Gets the manifests for the query parameters, deserializing only the selected versions of those returned.
+        std::vector<Manifest::Manifest> GetSelectedManifests(
+            const std::string& packageId, const std::map<std::string_view, std::string>& params, const Json::ManifestDeserializer::VersionSelection& selection) const;
+        pplx::task<std::vector<Manifest::Manifest>> GetSelectedManifestsAsync(
+            const std::string& packageId, const std::map<std::string_view, std::string>& params, const Json::ManifestDeserializer::VersionSelection& selection) const;
+
+        // Validates the received manifests, throwing if any of them has errors.
+        std::vector<Manifest::Manifest> ValidateManifests(std::vector<Manifest::Manifest>&& manifests) const;
+
+        const std::string& GetRestApiUri() const { return m_restApiUri; }
+        const HttpClientHelper& GetHttpClientHelper() const { return m_httpClientHelper; }
 
         std::unordered_map<utility::string_t, utility::string_t> m_requiredRestApiHeaders;
 
     private:
+        struct PagedSearch;
+        struct SplitSearch;
+
+        // Requests the page of the search for the continuation token.
+        pplx::task<std::optional<web::json::value>> RequestSearchPage(const PagedSearch& search, const utility::string_t& continuationToken) const;
+
+        // Adds the matches of the page to the search once it arrives, continuing with the next page if there is one.
+        pplx::task<IRestClient::SearchResult> ContinueSearch(std::shared_ptr<PagedSearch> search, pplx::task<std::optional<web::json::value>> page) const;
+
+        // Splits the request into a search for the query and one for each of the inclusions that the source supports.
+        std::vector<SearchRequest> SplitSearchRequest(const SearchRequest& request) const;
+
+        // Runs the separate searches with a limited number of them outstanding at a time, and merges the packages found by each of them.
+        pplx::task<IRestClient::SearchResult> SearchSeparately(std::vector<SearchRequest>&& requests, size_t maximumResults, size_t concurrency) const;
+
+        // Runs the next of the separate searches once the previous one in the chain completes.
+        pplx::task<void> ContinueSplitSearch(std::shared_ptr<SplitSearch> search) const;
+
         std::string m_restApiUri;
         utility::string_t m_searchEndpoint;
         HttpClientHelper m_httpClientHelper;
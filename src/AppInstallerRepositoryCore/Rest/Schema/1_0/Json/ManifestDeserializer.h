@@ -10,9 +10,24 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
     // Manifest Deserializer.
     struct ManifestDeserializer
     {
+        // The versions of the package to deserialize from a response; the others are skipped without being deserialized.
+        // With neither set, all of the versions are deserialized.
+        struct VersionSelection
+        {
+            // Only the version with this version string and the channel below.
+            std::optional<std::string> Version;
+            std::string Channel;
+            // Only the highest version with the channel below.
+            bool LatestOnly = false;
+        };
+
         // Gets the manifest from the given json object
         std::vector<Manifest::Manifest> Deserialize(const web::json::value& dataJsonObject) const;
 
+        // Gets the manifests from the given json object, releasing the json of each version as soon as it is deserialized.
+        // A response with many versions is then never held in full as both json and manifests.
+        std::vector<Manifest::Manifest> DeserializeAndRelease(web::json::value& dataJsonObject, const VersionSelection& selection = {}) const;
+
     protected:
 
         template <Manifest::Localization L>
@@ -22,11 +37,14 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
 
             if (JsonHelper::IsValidNonEmptyStringValue(value))
             {
-                manifestLocale.Add<L>(value.value());
+                manifestLocale.Add<L>(std::move(value.value()));
             }
         }
 
-        std::optional<std::vector<Manifest::Manifest>> DeserializeVersion(const web::json::value& dataJsonObject) const;
+        // The json is only modified when releaseVersions is set, which is only done from DeserializeAndRelease.
+        std::optional<std::vector<Manifest::Manifest>> DeserializeVersion(const web::json::value& dataJsonObject, const VersionSelection& selection, bool releaseVersions) const;
+
+        std::optional<Manifest::Manifest> DeserializeManifestVersion(const std::string& id, const web::json::value& versionItem) const;
 
         virtual std::optional<Manifest::ManifestLocalization> DeserializeLocale(const web::json::value& localeJsonObject) const;
 
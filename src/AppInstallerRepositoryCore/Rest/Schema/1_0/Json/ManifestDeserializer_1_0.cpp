@@ -93,7 +93,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
 
             if (JsonHelper::IsValidNonEmptyStringValue(value))
             {
-                installerSwitches[switchType] = value.value();
+                installerSwitches[switchType] = std::move(value.value());
             }
         }
     }
@@ -101,14 +101,23 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
     std::vector<Manifest::Manifest> ManifestDeserializer::Deserialize(const web::json::value& dataJsonObject) const
     {
         // Get manifest from json output.
-        std::optional<std::vector<Manifest::Manifest>> manifests = DeserializeVersion(dataJsonObject);
+        std::optional<std::vector<Manifest::Manifest>> manifests = DeserializeVersion(dataJsonObject, {}, false);
 
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, !manifests);
 
-        return manifests.value();
+        return std::move(manifests).value();
     }
 
-    std::optional<std::vector<Manifest::Manifest>> ManifestDeserializer::DeserializeVersion(const web::json::value& dataJsonObject) const
+    std::vector<Manifest::Manifest> ManifestDeserializer::DeserializeAndRelease(web::json::value& dataJsonObject, const VersionSelection& selection) const
+    {
+        std::optional<std::vector<Manifest::Manifest>> manifests = DeserializeVersion(dataJsonObject, selection, true);
+
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, !manifests);
+
+        return std::move(manifests).value();
+    }
+
+    std::optional<std::vector<Manifest::Manifest>> ManifestDeserializer::DeserializeVersion(const web::json::value& dataJsonObject, const VersionSelection& selection, bool releaseVersions) const
     {
         if (dataJsonObject.is_null())
         {
@@ -143,91 +152,75 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
                 return {};
             }
 
-            const web::json::array versionNodes = versions.value().get();
-            for (auto& versionItem : versionNodes)
+            const web::json::array& versionNodes = versions.value().get();
+
+            // Only the version strings are read to select the versions; the rest of each version is left alone.
+            std::vector<bool> selected(versionNodes.size(), true);
+            if (selection.Version || selection.LatestOnly)
             {
-                Manifest::Manifest manifest;
-                manifest.Id = id.value();
+                std::optional<size_t> latestIndex;
+                std::optional<Utility::Version> latestVersion;
 
-                std::optional<std::string> packageVersion = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageVersion));
-                if (!JsonHelper::IsValidNonEmptyStringValue(packageVersion))
+                for (size_t i = 0; i < versionNodes.size(); ++i)
                 {
-                    AICLI_LOG(Repo, Error, << "Missing package version in package: " << manifest.Id);
-                    return {};
-                }
-                manifest.Version = std::move(packageVersion.value());
-
-                manifest.Channel = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(Channel)).value_or("");
+                    const web::json::value& versionItem = versionNodes.at(i);
 
-                // Default locale
-                std::optional<std::reference_wrapper<const web::json::value>> defaultLocale =
-                    JsonHelper::GetJsonValueFromNode(versionItem, JsonHelper::GetUtilityString(DefaultLocale));
-                if (!defaultLocale)
-                {
-                    AICLI_LOG(Repo, Error, << "Missing default locale in package: " << manifest.Id);
-                    return {};
-                }
-                else
-                {
-                    std::optional<Manifest::ManifestLocalization> defaultLocaleObject = DeserializeLocale(defaultLocale.value().get());
-                    if (!defaultLocaleObject)
+                    std::optional<std::string> packageVersion = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageVersion));
+                    if (!JsonHelper::IsValidNonEmptyStringValue(packageVersion))
                     {
-                        AICLI_LOG(Repo, Error, << "Missing default locale in package: " << manifest.Id);
+                        AICLI_LOG(Repo, Error, << "Missing package version in package: " << id.value());
                         return {};
                     }
 
-                    if (!defaultLocaleObject.value().Contains(Manifest::Localization::PackageName) ||
-                        !defaultLocaleObject.value().Contains(Manifest::Localization::Publisher) ||
-                        !defaultLocaleObject.value().Contains(Manifest::Localization::ShortDescription))
+                    std::string channel = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(Channel)).value_or("");
+                    selected[i] = Utility::CaseInsensitiveEquals(channel, selection.Channel);
+
+                    if (selected[i] && selection.Version)
                     {
-                        AICLI_LOG(Repo, Error, << "Missing PackageName, Publisher or ShortDescription in default locale: " << manifest.Id);
-                        return {};
+                        selected[i] = Utility::CaseInsensitiveEquals(packageVersion.value(), selection.Version.value());
                     }
 
-                    manifest.DefaultLocalization = std::move(defaultLocaleObject.value());
-
-                    // Moniker is in Default locale
-                    manifest.Moniker = JsonHelper::GetRawStringValueFromJsonNode(defaultLocale.value().get(), JsonHelper::GetUtilityString(Moniker)).value_or("");
+                    if (selected[i] && selection.LatestOnly)
+                    {
+                        Utility::Version version{ std::move(packageVersion).value() };
+                        if (!latestVersion || latestVersion.value() < version)
+                        {
+                            latestVersion = std::move(version);
+                            latestIndex = i;
+                        }
+                    }
                 }
 
-                // Installers
-                std::optional<std::reference_wrapper<const web::json::array>> installers = JsonHelper::GetRawJsonArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(Installers));
-                if (!installers || installers.value().get().size() == 0)
+                if (selection.LatestOnly)
                 {
-                    AICLI_LOG(Repo, Error, << "Missing installers in package: " << manifest.Id);
-                    return {};
+                    std::fill(selected.begin(), selected.end(), false);
+                    if (latestIndex)
+                    {
+                        selected[latestIndex.value()] = true;
+                    }
                 }
+            }
 
-                for (auto& installer : installers.value().get())
+            for (size_t i = 0; i < versionNodes.size(); ++i)
+            {
+                if (!selected[i])
                 {
-                    std::optional<Manifest::ManifestInstaller> installerObject = DeserializeInstaller(installer);
-                    if (installerObject)
-                    {
-                        manifest.Installers.emplace_back(std::move(installerObject.value()));
-                    }
+                    continue;
                 }
 
-                if (manifest.Installers.size() == 0)
+                const web::json::value& versionItem = versionNodes.at(i);
+                std::optional<Manifest::Manifest> manifest = DeserializeManifestVersion(id.value(), versionItem);
+                if (!manifest)
                 {
-                    AICLI_LOG(Repo, Error, << "Missing valid installers in package: " << manifest.Id);
                     return {};
                 }
 
-                // Other locales
-                std::optional<std::reference_wrapper<const web::json::array>> locales = JsonHelper::GetRawJsonArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(Locales));
-                if (locales)
+                manifests.emplace_back(std::move(manifest).value());
+
+                if (releaseVersions)
                 {
-                    for (auto& locale : locales.value().get())
-                    {
-                        std::optional<Manifest::ManifestLocalization> localeObject = DeserializeLocale(locale);
-                        if (localeObject)
-                        {
-                            manifest.Localizations.emplace_back(std::move(localeObject.value()));
-                        }
-                    }
+                    const_cast<web::json::value&>(versionItem) = web::json::value::null();
                 }
-
-                manifests.emplace_back(std::move(manifest));
             }
 
             return manifests;
@@ -244,6 +237,92 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
         return {};
     }
 
+    std::optional<Manifest::Manifest> ManifestDeserializer::DeserializeManifestVersion(const std::string& id, const web::json::value& versionItem) const
+    {
+        Manifest::Manifest manifest;
+        manifest.Id = id;
+
+        std::optional<std::string> packageVersion = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageVersion));
+        if (!JsonHelper::IsValidNonEmptyStringValue(packageVersion))
+        {
+            AICLI_LOG(Repo, Error, << "Missing package version in package: " << manifest.Id);
+            return {};
+        }
+        manifest.Version = std::move(packageVersion.value());
+
+        manifest.Channel = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(Channel)).value_or("");
+
+        // Default locale
+        std::optional<std::reference_wrapper<const web::json::value>> defaultLocale =
+            JsonHelper::GetJsonValueFromNode(versionItem, JsonHelper::GetUtilityString(DefaultLocale));
+        if (!defaultLocale)
+        {
+            AICLI_LOG(Repo, Error, << "Missing default locale in package: " << manifest.Id);
+            return {};
+        }
+        else
+        {
+            std::optional<Manifest::ManifestLocalization> defaultLocaleObject = DeserializeLocale(defaultLocale.value().get());
+            if (!defaultLocaleObject)
+            {
+                AICLI_LOG(Repo, Error, << "Missing default locale in package: " << manifest.Id);
+                return {};
+            }
+
+            if (!defaultLocaleObject.value().Contains(Manifest::Localization::PackageName) ||
+                !defaultLocaleObject.value().Contains(Manifest::Localization::Publisher) ||
+                !defaultLocaleObject.value().Contains(Manifest::Localization::ShortDescription))
+            {
+                AICLI_LOG(Repo, Error, << "Missing PackageName, Publisher or ShortDescription in default locale: " << manifest.Id);
+                return {};
+            }
+
+            manifest.DefaultLocalization = std::move(defaultLocaleObject.value());
+
+            // Moniker is in Default locale
+            manifest.Moniker = JsonHelper::GetRawStringValueFromJsonNode(defaultLocale.value().get(), JsonHelper::GetUtilityString(Moniker)).value_or("");
+        }
+
+        // Installers
+        std::optional<std::reference_wrapper<const web::json::array>> installers = JsonHelper::GetRawJsonArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(Installers));
+        if (!installers || installers.value().get().size() == 0)
+        {
+            AICLI_LOG(Repo, Error, << "Missing installers in package: " << manifest.Id);
+            return {};
+        }
+
+        for (auto& installer : installers.value().get())
+        {
+            std::optional<Manifest::ManifestInstaller> installerObject = DeserializeInstaller(installer);
+            if (installerObject)
+            {
+                manifest.Installers.emplace_back(std::move(installerObject.value()));
+            }
+        }
+
+        if (manifest.Installers.size() == 0)
+        {
+            AICLI_LOG(Repo, Error, << "Missing valid installers in package: " << manifest.Id);
+            return {};
+        }
+
+        // Other locales
+        std::optional<std::reference_wrapper<const web::json::array>> locales = JsonHelper::GetRawJsonArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(Locales));
+        if (locales)
+        {
+            for (auto& locale : locales.value().get())
+            {
+                std::optional<Manifest::ManifestLocalization> localeObject = DeserializeLocale(locale);
+                if (localeObject)
+                {
+                    manifest.Localizations.emplace_back(std::move(localeObject.value()));
+                }
+            }
+        }
+
+        return manifest;
+    }
+
     std::optional<Manifest::ManifestLocalization> ManifestDeserializer::DeserializeLocale(const web::json::value& localeJsonObject) const
     {
         if (localeJsonObject.is_null())
@@ -277,7 +356,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
         auto tags = ConvertToManifestStringArray(JsonHelper::GetRawStringArrayFromJsonNode(localeJsonObject, JsonHelper::GetUtilityString(Tags)));
         if (!tags.empty())
         {
-            locale.Add<AppInstaller::Manifest::Localization::Tags>(tags);
+            locale.Add<AppInstaller::Manifest::Localization::Tags>(std::move(tags));
         }
 
         return locale;
@@ -433,16 +512,16 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
             dependencyList.Add(Dependency(DependencyType::WindowsFeature, std::move(id)));
         };
 
-        const auto& wlIds = ConvertToManifestStringArray(JsonHelper::GetRawStringArrayFromJsonNode(dependenciesObject, JsonHelper::GetUtilityString(WindowsLibraries)));
-        for (auto id : wlIds)
+        auto wlIds = ConvertToManifestStringArray(JsonHelper::GetRawStringArrayFromJsonNode(dependenciesObject, JsonHelper::GetUtilityString(WindowsLibraries)));
+        for (auto&& id : wlIds)
         {
-            dependencyList.Add(Dependency(DependencyType::WindowsLibrary, id));
+            dependencyList.Add(Dependency(DependencyType::WindowsLibrary, std::move(id)));
         };
 
-        const auto& extIds = ConvertToManifestStringArray(JsonHelper::GetRawStringArrayFromJsonNode(dependenciesObject, JsonHelper::GetUtilityString(ExternalDependencies)));
-        for (auto id : extIds)
+        auto extIds = ConvertToManifestStringArray(JsonHelper::GetRawStringArrayFromJsonNode(dependenciesObject, JsonHelper::GetUtilityString(ExternalDependencies)));
+        for (auto&& id : extIds)
         {
-            dependencyList.Add(Dependency(DependencyType::External, id));
+            dependencyList.Add(Dependency(DependencyType::External, std::move(id)));
         };
 
         // Package Dependencies
@@ -11,6 +11,7 @@
 #include "Rest/Schema/1_0/Json/ManifestDeserializer.h"
 #include "Rest/Schema/1_0/Json/SearchResponseDeserializer.h"
 #include "Rest/Schema/1_0/Json/SearchRequestSerializer.h"
+#include <winget/ThreadGlobals.h>
 
 using namespace std::string_view_literals;
 using namespace AppInstaller::Repository::Rest::Schema::V1_0::Json;
@@ -23,6 +24,9 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         constexpr std::string_view VersionQueryParam = "Version"sv;
         constexpr std::string_view ChannelQueryParam = "Channel"sv;
 
+        // The maximum number of manifest requests made at the same time when getting the manifests of many packages.
+        constexpr size_t s_MaximumConcurrentManifestRequests = 8;
+
         utility::string_t GetSearchEndpoint(const std::string& restApiUri)
         {
             return RestHelper::AppendPathToUri(JsonHelper::GetUtilityString(restApiUri), JsonHelper::GetUtilityString(ManifestSearchPostEndpoint));
@@ -39,8 +43,73 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
             // Create the endpoint with query parameters
             return RestHelper::AppendQueryParamsToUri(getManifestWithPackageIdPath, queryParameters);
         }
+
+        // Creates the search result from the manifests of all of the versions of a package.
+        IRestClient::SearchResult CreateOptimizedSearchResult(std::vector<Manifest::Manifest>&& manifests)
+        {
+            IRestClient::SearchResult searchResult;
+
+            if (!manifests.empty())
+            {
+                auto& manifest = manifests.at(0);
+                IRestClient::PackageInfo packageInfo = IRestClient::PackageInfo{
+                    manifest.Id,
+                    manifest.DefaultLocalization.Get<AppInstaller::Manifest::Localization::PackageName>(),
+                    manifest.DefaultLocalization.Get<AppInstaller::Manifest::Localization::Publisher>() };
+
+                // Add all the versions to the package info object
+                std::vector<IRestClient::VersionInfo> versions;
+                for (auto& manifestVersion : manifests)
+                {
+                    std::vector<std::string> packageFamilyNames;
+                    std::vector<std::string> productCodes;
+
+                    for (auto& installer : manifestVersion.Installers)
+                    {
+                        if (!installer.PackageFamilyName.empty())
+                        {
+                            packageFamilyNames.emplace_back(installer.PackageFamilyName);
+                        }
+
+                        if (!installer.ProductCode.empty())
+                        {
+                            productCodes.emplace_back(installer.ProductCode);
+                        }
+                    }
+
+                    std::vector<std::string> uniquePackageFamilyNames = RestHelper::GetUniqueItems(packageFamilyNames);
+                    std::vector<std::string> uniqueProductCodes = RestHelper::GetUniqueItems(productCodes);
+
+                    versions.emplace_back(
+                        IRestClient::VersionInfo{ AppInstaller::Utility::VersionAndChannel {manifestVersion.Version, manifestVersion.Channel},
+                        manifestVersion, std::move(uniquePackageFamilyNames), std::move(uniqueProductCodes) });
+                }
+
+                IRestClient::Package package = IRestClient::Package{ std::move(packageInfo), std::move(versions) };
+                searchResult.Matches.emplace_back(std::move(package));
+            }
+
+            return searchResult;
+        }
     }
 
+    // The state shared by the continuations that retrieve the pages of a search.
+    struct Interface::PagedSearch
+    {
+        size_t MaximumResults = 0;
+        web::json::value Body;
+        IRestClient::SearchResult Results;
+    };
+
+    // The state shared by the separate searches that a request is split into.
+    struct Interface::SplitSearch
+    {
+        size_t MaximumResults = 0;
+        std::vector<SearchRequest> Requests;
+        std::vector<IRestClient::SearchResult> Results;
+        std::atomic<size_t> NextRequest = 0;
+    };
+
     Interface::Interface(const std::string& restApi, const HttpClientHelper& httpClientHelper) : m_restApiUri(restApi), m_httpClientHelper(httpClientHelper)
     {
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_URL, !RestHelper::IsValidUri(JsonHelper::GetUtilityString(restApi)));
@@ -60,63 +129,206 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
     }
 
     IRestClient::SearchResult Interface::Search(const SearchRequest& request) const
+    {
+        return SearchAsync(request).get();
+    }
+
+    pplx::task<IRestClient::SearchResult> Interface::SearchAsync(const SearchRequest& request) const
     {
         // Optimization
         if (MeetsOptimizedSearchCriteria(request))
         {
-            return OptimizedSearch(request);
+            return GetManifestsAsync(request.Filters[0].Value).then([](std::vector<Manifest::Manifest> manifests)
+                {
+                    return CreateOptimizedSearchResult(std::move(manifests));
+                });
+        }
+
+        // Sources may limit the number of inclusions in a single search, so they can be sent separately instead.
+        size_t concurrency = Settings::User().Get<Settings::Setting::NetworkRestSearchConcurrency>();
+        if (concurrency > 1 && (request.Inclusions.size() + (request.Query ? 1 : 0)) > 1)
+        {
+            std::vector<SearchRequest> parts = SplitSearchRequest(request);
+            if (parts.size() > 1)
+            {
+                return SearchSeparately(std::move(parts), request.MaximumResults, concurrency);
+            }
         }
 
-        return SearchInternal(request);
+        auto search = std::make_shared<PagedSearch>();
+        search->MaximumResults = request.MaximumResults;
+        search->Body = GetValidatedSearchBody(request);
+
+        return ContinueSearch(search, m_httpClientHelper.HandlePostAsync(m_searchEndpoint, search->Body, m_requiredRestApiHeaders));
     }
 
-    IRestClient::SearchResult Interface::SearchInternal(const SearchRequest& request) const
+    pplx::task<std::optional<web::json::value>> Interface::RequestSearchPage(const PagedSearch& search, const utility::string_t& continuationToken) const
     {
-        SearchResult results;
-        utility::string_t continuationToken;
+        AICLI_LOG(Repo, Verbose, << "Received continuation token. Retrieving more results.");
+
         std::unordered_map<utility::string_t, utility::string_t> searchHeaders = m_requiredRestApiHeaders;
-        do
-        {
-            if (!continuationToken.empty())
-            {
-                AICLI_LOG(Repo, Verbose, << "Received continuation token. Retrieving more results.");
-                searchHeaders.insert_or_assign(JsonHelper::GetUtilityString(ContinuationToken), continuationToken);
-            }
+        searchHeaders.insert_or_assign(JsonHelper::GetUtilityString(ContinuationToken), continuationToken);
 
-            std::optional<web::json::value> jsonObject = m_httpClientHelper.HandlePost(m_searchEndpoint, GetValidatedSearchBody(request), searchHeaders);
+        return m_httpClientHelper.HandlePostAsync(m_searchEndpoint, search.Body, searchHeaders);
+    }
 
-            utility::string_t ct;
-            if (jsonObject)
+    pplx::task<IRestClient::SearchResult> Interface::ContinueSearch(std::shared_ptr<PagedSearch> search, pplx::task<std::optional<web::json::value>> page) const
+    {
+        return page.then(WithCallerThreadGlobals<std::optional<web::json::value>>([this, search](std::optional<web::json::value> jsonObject)
             {
-                SearchResult currentResult = GetSearchResult(jsonObject.value());
+                SearchResult& results = search->Results;
+                utility::string_t continuationToken;
 
-                size_t insertElements = !request.MaximumResults ? currentResult.Matches.size() :
-                    std::min(currentResult.Matches.size(), request.MaximumResults - results.Matches.size());
+                if (jsonObject)
+                {
+                    continuationToken = RestHelper::GetContinuationToken(jsonObject.value()).value_or(L"");
+
+                    // Request the next page before deserializing this one, so that waiting on the server overlaps with the deserialization.
+                    // The next page is not requested when the packages in this one are already enough to reach the maximum.
+                    std::optional<pplx::task<std::optional<web::json::value>>> nextPage;
+                    if (!continuationToken.empty())
+                    {
+                        auto pageData = JsonHelper::GetRawJsonArrayFromJsonNode(jsonObject.value(), JsonHelper::GetUtilityString(Data));
+                        size_t pageSize = pageData ? pageData->get().size() : 0;
+
+                        if (!search->MaximumResults || results.Matches.size() + pageSize < search->MaximumResults)
+                        {
+                            nextPage = RequestSearchPage(*search, continuationToken);
+                        }
+                    }
+
+                    SearchResult currentResult = GetSearchResult(jsonObject.value());
+                    jsonObject.reset();
+
+                    size_t insertElements = !search->MaximumResults ? currentResult.Matches.size() :
+                        std::min(currentResult.Matches.size(), search->MaximumResults - results.Matches.size());
+
+                    if (insertElements < currentResult.Matches.size())
+                    {
+                        results.Truncated = true;
+                    }
+
+                    std::move(currentResult.Matches.begin(), std::next(currentResult.Matches.begin(), insertElements), std::inserter(results.Matches, results.Matches.end()));
 
-                if (insertElements < currentResult.Matches.size())
+                    if (!continuationToken.empty() && (!search->MaximumResults || results.Matches.size() < search->MaximumResults))
+                    {
+                        if (!nextPage)
+                        {
+                            // This page had fewer matches than packages, so the next page is needed after all.
+                            nextPage = RequestSearchPage(*search, continuationToken);
+                        }
+
+                        return ContinueSearch(search, std::move(nextPage).value());
+                    }
+
+                    // A page is only requested ahead when it is expected to be needed, so there is rarely one left unused here.
+                }
+
+                if (!continuationToken.empty())
                 {
                     results.Truncated = true;
                 }
 
-                std::move(currentResult.Matches.begin(), std::next(currentResult.Matches.begin(), insertElements), std::inserter(results.Matches, results.Matches.end()));
-                ct = RestHelper::GetContinuationToken(jsonObject.value()).value_or(L"");
+                if (results.Matches.empty())
+                {
+                    AICLI_LOG(Repo, Verbose, << "No search results returned by rest source");
+                }
+
+                return pplx::task_from_result(std::move(results));
+            }));
+    }
+
+    std::vector<SearchRequest> Interface::SplitSearchRequest(const SearchRequest& request) const
+    {
+        std::vector<SearchRequest> result;
+
+        // The query and the inclusions each add packages to the results, so searching for each of them with the filters finds the same packages.
+        SearchRequest partTemplate;
+        partTemplate.Filters = request.Filters;
+        partTemplate.MaximumResults = request.MaximumResults;
+
+        if (request.Query)
+        {
+            SearchRequest& part = result.emplace_back(partTemplate);
+            part.Query = request.Query;
+        }
+
+        for (const auto& inclusion : request.Inclusions)
+        {
+            // An unsupported inclusion is ignored by the source, which on its own would leave a search for everything that matches the filters.
+            if (!IsInclusionSupported(inclusion))
+            {
+                continue;
             }
 
-            continuationToken = ct;
+            SearchRequest& part = result.emplace_back(partTemplate);
+            part.Inclusions.emplace_back(inclusion);
+        }
+
+        return result;
+    }
+
+    pplx::task<IRestClient::SearchResult> Interface::SearchSeparately(std::vector<SearchRequest>&& requests, size_t maximumResults, size_t concurrency) const
+    {
+        auto search = std::make_shared<SplitSearch>();
+        search->MaximumResults = maximumResults;
+        search->Requests = std::move(requests);
+        search->Results.resize(search->Requests.size());
 
-        } while (!continuationToken.empty() && (!request.MaximumResults || results.Matches.size() < request.MaximumResults));
+        AICLI_LOG(Repo, Verbose, << "Splitting search into " << search->Requests.size() << " searches, with up to " << concurrency << " at a time");
 
-        if (!continuationToken.empty())
+        std::vector<pplx::task<void>> chains;
+        for (size_t i = 0; i < std::min(search->Requests.size(), concurrency); ++i)
         {
-            results.Truncated = true;
+            chains.emplace_back(ContinueSplitSearch(search));
         }
 
-        if (results.Matches.empty())
+        return pplx::when_all(chains.begin(), chains.end()).then([search](pplx::task<void> completed)
+            {
+                // Rethrows the failure of any of the searches.
+                completed.get();
+
+                SearchResult result;
+                std::set<std::string> packageIdentifiers;
+
+                for (auto& partResult : search->Results)
+                {
+                    result.Truncated = result.Truncated || partResult.Truncated;
+
+                    for (auto& match : partResult.Matches)
+                    {
+                        if (!packageIdentifiers.emplace(Utility::FoldCase(std::string_view{ match.PackageInformation.PackageIdentifier })).second)
+                        {
+                            continue;
+                        }
+
+                        if (search->MaximumResults && result.Matches.size() >= search->MaximumResults)
+                        {
+                            result.Truncated = true;
+                            break;
+                        }
+
+                        result.Matches.emplace_back(std::move(match));
+                    }
+                }
+
+                return result;
+            });
+    }
+
+    pplx::task<void> Interface::ContinueSplitSearch(std::shared_ptr<SplitSearch> search) const
+    {
+        size_t i = search->NextRequest++;
+        if (i >= search->Requests.size())
         {
-            AICLI_LOG(Repo, Verbose, << "No search results returned by rest source");
+            return pplx::task_from_result();
         }
 
-        return results;
+        return SearchAsync(search->Requests[i]).then(WithCallerThreadGlobals<SearchResult>([this, search, i](SearchResult result)
+            {
+                search->Results[i] = std::move(result);
+                return ContinueSplitSearch(search);
+            }));
     }
 
     std::optional<Manifest::Manifest> Interface::GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const
@@ -132,17 +344,27 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
             queryParams.emplace(ChannelQueryParam, channel);
         }
 
-        std::vector<Manifest::Manifest> manifests = GetManifests(packageId, queryParams);
+        // The server may not support the parameters, or may ignore them and return every version anyway,
+        // so only the requested version is deserialized from the response.
+        ManifestDeserializer::VersionSelection selection;
+        selection.Channel = channel;
+        if (version.empty())
+        {
+            selection.LatestOnly = true;
+        }
+        else
+        {
+            selection.Version = version;
+        }
+
+        std::vector<Manifest::Manifest> manifests = GetSelectedManifests(packageId, queryParams, selection);
 
-        if (!manifests.empty())
+        for (Manifest::Manifest& manifest : manifests)
         {
-            for (Manifest::Manifest manifest : manifests)
+            if ((version.empty() || Utility::CaseInsensitiveEquals(manifest.Version, version)) &&
+                Utility::CaseInsensitiveEquals(manifest.Channel, channel))
             {
-                if (Utility::CaseInsensitiveEquals(manifest.Version, version) &&
-                    Utility::CaseInsensitiveEquals(manifest.Channel, channel))
-                {
-                    return manifest;
-                }
+                return std::move(manifest);
             }
         }
 
@@ -164,73 +386,112 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         return false;
     }
 
-    IRestClient::SearchResult Interface::OptimizedSearch(const SearchRequest& request) const
+    std::vector<Manifest::Manifest> Interface::GetManifests(const std::string& packageId, const std::map<std::string_view, std::string>& params) const
+    {
+        return GetSelectedManifests(packageId, params, {});
+    }
+
+    pplx::task<std::vector<Manifest::Manifest>> Interface::GetManifestsAsync(const std::string& packageId, const std::map<std::string_view, std::string>& params) const
+    {
+        return GetSelectedManifestsAsync(packageId, params, {});
+    }
+
+    std::vector<Manifest::Manifest> Interface::GetSelectedManifests(
+        const std::string& packageId, const std::map<std::string_view, std::string>& params, const ManifestDeserializer::VersionSelection& selection) const
     {
-        SearchResult searchResult;
-        std::vector<Manifest::Manifest> manifests = GetManifests(request.Filters[0].Value);
+        return GetSelectedManifestsAsync(packageId, params, selection).get();
+    }
+
+    pplx::task<std::vector<Manifest::Manifest>> Interface::GetSelectedManifestsAsync(
+        const std::string& packageId, const std::map<std::string_view, std::string>& params, const ManifestDeserializer::VersionSelection& selection) const
+    {
+        auto validatedParams = GetValidatedQueryParams(params);
+
+        return m_httpClientHelper.HandleGetAsync(GetManifestByVersionEndpoint(m_restApiUri, packageId, validatedParams), m_requiredRestApiHeaders).then(
+            WithCallerThreadGlobals<std::optional<web::json::value>>([this, packageId, selection](std::optional<web::json::value> jsonObject)
+            {
+                if (!jsonObject)
+                {
+                    AICLI_LOG(Repo, Verbose, << "No results were returned by the rest source for package id: " << packageId);
+                    return std::vector<Manifest::Manifest>{};
+                }
 
-        if (!manifests.empty())
+                // Parse json and return Manifests
+                return ValidateManifests(GetParsedManifests(jsonObject.value(), selection));
+            }));
+    }
+
+    bool Interface::SupportsDependencyClosure() const
+    {
+        return false;
+    }
+
+    std::vector<std::vector<Manifest::Manifest>> Interface::GetManifestsForPackages(const std::vector<std::string>& packageIds) const
+    {
+        std::vector<std::vector<Manifest::Manifest>> results(packageIds.size());
+        std::vector<std::exception_ptr> exceptions(packageIds.size());
+        std::atomic<size_t> nextIndex = 0;
+
+        // Each chain gets the manifests of one package after another, and a limited number of chains run at once.
+        // The requests are all asynchronous, so no thread is held waiting on any of them.
+        std::function<pplx::task<void>()> getNext = [&]() -> pplx::task<void>
         {
-            auto& manifest = manifests.at(0);
-            PackageInfo packageInfo = PackageInfo{
-                manifest.Id,
-                manifest.DefaultLocalization.Get<AppInstaller::Manifest::Localization::PackageName>(),
-                manifest.DefaultLocalization.Get<AppInstaller::Manifest::Localization::Publisher>() };
-
-            // Add all the versions to the package info object
-            std::vector<VersionInfo> versions;
-            for (auto& manifestVersion : manifests)
+            size_t i = nextIndex++;
+            if (i >= packageIds.size())
+            {
+                return pplx::task_from_result();
+            }
+
+            pplx::task<std::vector<Manifest::Manifest>> request;
+            try
             {
-                std::vector<std::string> packageFamilyNames;
-                std::vector<std::string> productCodes;
+                request = GetManifestsAsync(packageIds[i]);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+                return getNext();
+            }
 
-                for (auto& installer : manifestVersion.Installers)
+            return request.then([&, i](pplx::task<std::vector<Manifest::Manifest>> completed)
                 {
-                    if (!installer.PackageFamilyName.empty())
+                    try
                     {
-                        packageFamilyNames.emplace_back(installer.PackageFamilyName);
+                        results[i] = completed.get();
                     }
-
-                    if (!installer.ProductCode.empty())
+                    catch (...)
                     {
-                        productCodes.emplace_back(installer.ProductCode);
+                        exceptions[i] = std::current_exception();
                     }
-                }
 
-                std::vector<std::string> uniquePackageFamilyNames = RestHelper::GetUniqueItems(packageFamilyNames);
-                std::vector<std::string> uniqueProductCodes = RestHelper::GetUniqueItems(productCodes);
+                    return getNext();
+                });
+        };
 
-                versions.emplace_back(
-                    VersionInfo{ AppInstaller::Utility::VersionAndChannel {manifestVersion.Version, manifestVersion.Channel},
-                    manifestVersion, std::move(uniquePackageFamilyNames), std::move(uniqueProductCodes) });
-            }
+        std::vector<pplx::task<void>> chains;
+        for (size_t i = 0; i < std::min(packageIds.size(), s_MaximumConcurrentManifestRequests); ++i)
+        {
+            chains.emplace_back(getNext());
+        }
+
+        // The chains capture the locals, so all of them must complete before returning.
+        pplx::when_all(chains.begin(), chains.end()).wait();
 
-            Package package = Package{ std::move(packageInfo), std::move(versions) };
-            searchResult.Matches.emplace_back(std::move(package));
+        for (const auto& exception : exceptions)
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
         }
 
-        return searchResult;
+        return results;
     }
 
-    std::vector<Manifest::Manifest> Interface::GetManifests(const std::string& packageId, const std::map<std::string_view, std::string>& params) const
+    std::vector<Manifest::Manifest> Interface::ValidateManifests(std::vector<Manifest::Manifest>&& manifests) const
     {
-        auto validatedParams = GetValidatedQueryParams(params);
-
         std::vector<Manifest::Manifest> results;
-        utility::string_t continuationToken;
-        std::unordered_map<utility::string_t, utility::string_t> searchHeaders = m_requiredRestApiHeaders;
-        std::optional<web::json::value> jsonObject = m_httpClientHelper.HandleGet(GetManifestByVersionEndpoint(m_restApiUri, packageId, validatedParams), m_requiredRestApiHeaders);
-
-        if (!jsonObject)
-        {
-            AICLI_LOG(Repo, Verbose, << "No results were returned by the rest source for package id: " << packageId);
-            return results;
-        }
 
-        // Parse json and return Manifests
-        std::vector<Manifest::Manifest> manifests = GetParsedManifests(jsonObject.value());
-
-        // Manifest validation
         for (auto& manifestItem : manifests)
         {
             std::vector<AppInstaller::Manifest::ValidationError> validationErrors =
@@ -248,7 +509,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
 
             THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, errors > 0);
 
-            results.emplace_back(manifestItem);
+            results.emplace_back(std::move(manifestItem));
         }
 
         return results;
@@ -265,15 +526,20 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         return serializer.Serialize(searchRequest);
     }
 
+    bool Interface::IsInclusionSupported(const PackageMatchFilter&) const
+    {
+        return true;
+    }
+
     IRestClient::SearchResult Interface::GetSearchResult(const web::json::value& searchResponseObject) const
     {
         SearchResponseDeserializer searchResponseDeserializer;
         return searchResponseDeserializer.Deserialize(searchResponseObject);
     }
 
-    std::vector<Manifest::Manifest> Interface::GetParsedManifests(const web::json::value& manifestsResponseObject) const
+    std::vector<Manifest::Manifest> Interface::GetParsedManifests(web::json::value& manifestsResponseObject, const ManifestDeserializer::VersionSelection& selection) const
     {
         ManifestDeserializer manifestDeserializer;
-        return manifestDeserializer.Deserialize(manifestsResponseObject);
+        return manifestDeserializer.DeserializeAndRelease(manifestsResponseObject, selection);
     }
 }
@@ -19,18 +19,28 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         Utility::Version GetVersion() const override;
         IRestClient::Information GetSourceInformation() const override;
 
+        // Uses a single request for many packages when the source supports it.
+        std::vector<std::vector<Manifest::Manifest>> GetManifestsForPackages(const std::vector<std::string>& packageIds) const override;
+
+        // Reported through the supported features in the information.
+        bool SupportsDependencyClosure() const override;
+
     protected:
         // Check query params against source information and update if necessary.
         std::map<std::string_view, std::string> GetValidatedQueryParams(const std::map<std::string_view, std::string>& params) const override;
 
         // Check search request against source information and get json search body.
         web::json::value GetValidatedSearchBody(const SearchRequest& searchRequest) const override;
+        bool IsInclusionSupported(const PackageMatchFilter& inclusion) const override;
 
         SearchResult GetSearchResult(const web::json::value& searchResponseObject) const override;
-        std::vector<Manifest::Manifest> GetParsedManifests(const web::json::value& manifestsResponseObject) const override;
+        std::vector<Manifest::Manifest> GetParsedManifests(web::json::value& manifestsResponseObject, const V1_0::Json::ManifestDeserializer::VersionSelection& selection) const override;
 
         PackageMatchField ConvertStringToPackageMatchField(std::string_view field) const;
 
+        // Determines whether the source reported support for the given feature in its information.
+        bool IsFeatureSupported(std::string_view feature) const;
+
     private:
         IRestClient::Information m_information;
     };
@@ -25,6 +25,16 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         constexpr std::string_view RequiredPackageMatchFields = "RequiredPackageMatchFields"sv;
         constexpr std::string_view UnsupportedQueryParameters = "UnsupportedQueryParameters"sv;
         constexpr std::string_view RequiredQueryParameters = "RequiredQueryParameters"sv;
+
+        // The source accepts a POST to the package manifests endpoint with many package identifiers.
+        constexpr std::string_view BatchPackageManifestsFeature = "BatchPackageManifests"sv;
+        constexpr std::string_view PackageIdentifiers = "PackageIdentifiers"sv;
+
+        // The source can resolve the transitive dependencies of a package.
+        constexpr std::string_view DependencyClosureFeature = "DependencyClosure"sv;
+
+        // The maximum number of packages in a single request for many packages.
+        constexpr size_t s_MaximumPackagesPerBatchRequest = 100;
     }
 
     Interface::Interface(
@@ -51,6 +61,96 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         return m_information;
     }
 
+    std::vector<std::vector<Manifest::Manifest>> Interface::GetManifestsForPackages(const std::vector<std::string>& packageIds) const
+    {
+        if (!IsFeatureSupported(BatchPackageManifestsFeature))
+        {
+            return V1_0::Interface::GetManifestsForPackages(packageIds);
+        }
+
+        utility::string_t endpoint = RestHelper::AppendQueryParamsToUri(
+            RestHelper::AppendPathToUri(JsonHelper::GetUtilityString(GetRestApiUri()), JsonHelper::GetUtilityString(ManifestsForPackagesPostEndpoint)),
+            GetValidatedQueryParams({}));
+
+        std::vector<std::vector<Manifest::Manifest>> results(packageIds.size());
+
+        for (size_t batchStart = 0; batchStart < packageIds.size(); batchStart += s_MaximumPackagesPerBatchRequest)
+        {
+            size_t batchEnd = std::min(packageIds.size(), batchStart + s_MaximumPackagesPerBatchRequest);
+
+            web::json::value body = web::json::value::object();
+            web::json::value ids = web::json::value::array();
+            for (size_t i = batchStart; i < batchEnd; ++i)
+            {
+                ids[i - batchStart] = web::json::value::string(JsonHelper::GetUtilityString(packageIds[i]));
+            }
+            body[JsonHelper::GetUtilityString(PackageIdentifiers)] = std::move(ids);
+
+            AICLI_LOG(Repo, Verbose, << "Requesting manifests for " << (batchEnd - batchStart) << " packages");
+
+            utility::string_t continuationToken;
+            std::unordered_map<utility::string_t, utility::string_t> headers = m_requiredRestApiHeaders;
+            do
+            {
+                if (!continuationToken.empty())
+                {
+                    headers.insert_or_assign(JsonHelper::GetUtilityString(ContinuationToken), continuationToken);
+                }
+
+                std::optional<web::json::value> jsonObject = GetHttpClientHelper().HandlePost(endpoint, body, headers);
+                if (!jsonObject)
+                {
+                    break;
+                }
+
+                // Each item of the data is a package manifest, as returned for a single package
+                auto packages = JsonHelper::GetRawJsonArrayFromJsonNode(jsonObject.value(), JsonHelper::GetUtilityString(Data));
+                if (packages)
+                {
+                    // Each package is moved out of the response rather than copied, so that its json is released as it is deserialized.
+                    for (auto& package : jsonObject.value().at(JsonHelper::GetUtilityString(Data)).as_array())
+                    {
+                        web::json::value singlePackage = web::json::value::object();
+                        singlePackage[JsonHelper::GetUtilityString(Data)] = std::move(package);
+
+                        std::vector<Manifest::Manifest> manifests = ValidateManifests(GetParsedManifests(singlePackage, {}));
+                        if (manifests.empty())
+                        {
+                            continue;
+                        }
+
+                        auto itr = std::find_if(packageIds.begin() + batchStart, packageIds.begin() + batchEnd,
+                            [&](const std::string& id) { return Utility::CaseInsensitiveEquals(id, manifests[0].Id); });
+
+                        if (itr == packageIds.begin() + batchEnd)
+                        {
+                            AICLI_LOG(Repo, Warning, << "Received manifests for package that was not requested: " << manifests[0].Id);
+                            continue;
+                        }
+
+                        auto& packageResults = results[itr - packageIds.begin()];
+                        std::move(manifests.begin(), manifests.end(), std::back_inserter(packageResults));
+                    }
+                }
+
+                continuationToken = RestHelper::GetContinuationToken(jsonObject.value()).value_or(L"");
+            } while (!continuationToken.empty());
+        }
+
+        return results;
+    }
+
+    bool Interface::SupportsDependencyClosure() const
+    {
+        return IsFeatureSupported(DependencyClosureFeature);
+    }
+
+    bool Interface::IsFeatureSupported(std::string_view feature) const
+    {
+        return std::any_of(m_information.SupportedFeatures.begin(), m_information.SupportedFeatures.end(),
+            [&](const std::string& supported) { return Utility::CaseInsensitiveEquals(supported, feature); });
+    }
+
     std::map<std::string_view, std::string> Interface::GetValidatedQueryParams(const std::map<std::string_view, std::string>& params) const
     {
         std::map<std::string_view, std::string> result = params;
@@ -134,6 +234,13 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         return serializer.Serialize(resultSearchRequest);
     }
 
+    bool Interface::IsInclusionSupported(const PackageMatchFilter& inclusion) const
+    {
+        return m_information.UnsupportedPackageMatchFields.end() == std::find_if(
+            m_information.UnsupportedPackageMatchFields.begin(), m_information.UnsupportedPackageMatchFields.end(),
+            [&](const std::string& field) { return ConvertStringToPackageMatchField(field) == inclusion.Field; });
+    }
+
     IRestClient::SearchResult Interface::GetSearchResult(const web::json::value& searchResponseObject) const
     {
         IRestClient::SearchResult result = V1_0::Interface::GetSearchResult(searchResponseObject);
@@ -153,10 +260,10 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         return result;
     }
 
-    std::vector<Manifest::Manifest> Interface::GetParsedManifests(const web::json::value& manifestsResponseObject) const
+    std::vector<Manifest::Manifest> Interface::GetParsedManifests(web::json::value& manifestsResponseObject, const V1_0::Json::ManifestDeserializer::VersionSelection& selection) const
     {
         ManifestDeserializer manifestDeserializer;
-        auto result = manifestDeserializer.Deserialize(manifestsResponseObject);
+        auto result = manifestDeserializer.DeserializeAndRelease(manifestsResponseObject, selection);
 
         if (result.size() == 0)
         {
@@ -20,4 +20,5 @@ namespace AppInstaller::Repository::Rest::Schema
     constexpr std::string_view InformationGetEndpoint = "/information"sv;
     constexpr std::string_view ManifestSearchPostEndpoint = "/manifestSearch"sv;
     constexpr std::string_view ManifestByVersionAndChannelGetEndpoint = "/packageManifests/"sv;
+    constexpr std::string_view ManifestsForPackagesPostEndpoint = "/packageManifests"sv;
 }
@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "HttpClientHelper.h"
+#include <winget/DownloadScheduler.h>
+#include <winget/Performance.h>
+
+#include <winhttp.h>
 
 namespace AppInstaller::Repository::Rest::Schema
 {
@@ -17,15 +21,49 @@ namespace AppInstaller::Repository::Rest::Schema
                 request.headers().add(web::http::header_names::user_agent, c_defaultUserAgent);
             }
         }
+
+        // Has WinHTTP request gzip or deflate encoded responses and decompress them.
+        // The cpprest compression support is not built, as it depends on zlib.
+        // Also lets WinHTTP negotiate HTTP/2, so that the concurrent requests of a client share one connection to its host.
+        void ConfigureSession(web::http::client::native_handle session)
+        {
+            DWORD decompression = WINHTTP_DECOMPRESSION_FLAG_ALL;
+            if (!WinHttpSetOption(session, WINHTTP_OPTION_DECOMPRESSION, &decompression, sizeof(decompression)))
+            {
+                // Not supported before Windows 8.1; responses are simply not compressed
+                AICLI_LOG(Repo, Verbose, << "Failed to enable http response decompression: " << GetLastError());
+            }
+
+            if (Settings::User().Get<Settings::Setting::NetworkHttp2>())
+            {
+                DWORD protocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+                if (!WinHttpSetOption(session, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols)))
+                {
+                    // Not supported before Windows 10 1607; requests simply use HTTP/1.1
+                    AICLI_LOG(Repo, Verbose, << "Failed to enable HTTP/2: " << GetLastError());
+                }
+            }
+        }
+
+        std::optional<utility::string_t> GetHeader(const web::http::http_headers& headers, const utility::string_t& name)
+        {
+            auto itr = headers.find(name);
+            if (itr == headers.end() || itr->second.empty())
+            {
+                return {};
+            }
+
+            return itr->second;
+        }
     }
 
-    HttpClientHelper::HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> stage) : m_defaultRequestHandlerStage(stage) {}
+    HttpClientHelper::HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> stage, std::shared_ptr<HttpResponseCache> responseCache) :
+        m_defaultRequestHandlerStage(stage), m_clientPool(std::make_shared<ClientPool>()), m_responseCache(std::move(responseCache)) {}
 
     pplx::task<web::http::http_response> HttpClientHelper::Post(
         const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
         AICLI_LOG(Repo, Info, << "Sending http POST request to: " << utility::conversions::to_utf8string(uri));
-        web::http::client::http_client client = GetClient(uri);
         web::http::http_request request{ web::http::methods::POST };
         request.headers().set_content_type(web::http::details::mime_types::application_json);
         request.set_body(body.serialize());
@@ -39,26 +77,34 @@ namespace AppInstaller::Repository::Rest::Schema
 
         AICLI_LOG(Repo, Verbose, << "Http POST request details:\n" << utility::conversions::to_utf8string(request.to_string()));
 
-        return client.request(request);
+        return SendRequest(uri, request);
     }
 
     std::optional<web::json::value> HttpClientHelper::HandlePost(
         const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
-        web::http::http_response httpResponse;
-        HttpClientHelper::Post(uri, body, headers).then([&httpResponse](const web::http::http_response& response)
-            {
-                httpResponse = response;
-            }).wait();
+        Performance::ScopedTimer timer{ "HttpClientHelper::HandlePost" };
+        return HandlePostAsync(uri, body, headers).get();
+    }
 
-        return ValidateAndExtractResponse(httpResponse);
+    pplx::task<std::optional<web::json::value>> HttpClientHelper::HandlePostAsync(
+        const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
+    {
+        utility::string_t serializedBody = body.serialize();
+        std::optional<HttpResponseCache::Entry> cached = m_responseCache ? m_responseCache->Get(uri, serializedBody, headers) : std::nullopt;
+
+        // The continuation holds a copy of the helper, which shares the clients and cache, so that the task does not depend on this one.
+        return Post(uri, body, AddConditionalHeaders(headers, cached)).then(WithCallerThreadGlobals<web::http::http_response>(
+            [helper = *this, uri, serializedBody = std::move(serializedBody), headers, cached = std::move(cached)](web::http::http_response response)
+            {
+                return helper.ValidateAndCacheResponse(response, uri, serializedBody, headers, cached);
+            }));
     }
 
     pplx::task<web::http::http_response> HttpClientHelper::Get(
         const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
         AICLI_LOG(Repo, Info, << "Sending http GET request to: " << utility::conversions::to_utf8string(uri));
-        web::http::client::http_client client = GetClient(uri);
         web::http::http_request request{ web::http::methods::GET };
         request.headers().set_content_type(web::http::details::mime_types::application_json);
 
@@ -71,24 +117,44 @@ namespace AppInstaller::Repository::Rest::Schema
 
         AICLI_LOG(Repo, Verbose, << "Http GET request details:\n" << utility::conversions::to_utf8string(request.to_string()));
 
-        return client.request(request);
+        return SendRequest(uri, request);
     }
 
     std::optional<web::json::value> HttpClientHelper::HandleGet(
         const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
-        web::http::http_response httpResponse;
-        Get(uri, headers).then([&httpResponse](const web::http::http_response& response)
-            {
-                httpResponse = response;
-            }).wait();
+        Performance::ScopedTimer timer{ "HttpClientHelper::HandleGet" };
+        return HandleGetAsync(uri, headers).get();
+    }
+
+    pplx::task<std::optional<web::json::value>> HttpClientHelper::HandleGetAsync(
+        const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
+    {
+        std::optional<HttpResponseCache::Entry> cached = m_responseCache ? m_responseCache->Get(uri, {}, headers) : std::nullopt;
 
-        return ValidateAndExtractResponse(httpResponse);
+        return Get(uri, AddConditionalHeaders(headers, cached)).then(WithCallerThreadGlobals<web::http::http_response>(
+            [helper = *this, uri, headers, cached = std::move(cached)](web::http::http_response response)
+            {
+                return helper.ValidateAndCacheResponse(response, uri, {}, headers, cached);
+            }));
     }
 
-    web::http::client::http_client HttpClientHelper::GetClient(const utility::string_t& uri) const
+    web::http::client::http_client HttpClientHelper::GetClient(const web::uri& baseUri) const
     {
-        web::http::client::http_client client{ uri };
+        utility::string_t key = baseUri.to_string();
+
+        std::lock_guard<std::mutex> lock{ m_clientPool->Lock };
+
+        auto itr = m_clientPool->Clients.find(key);
+        if (itr != m_clientPool->Clients.end())
+        {
+            return itr->second;
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Creating http client for: " << utility::conversions::to_utf8string(key));
+        web::http::client::http_client_config config;
+        config.set_nativesessionhandle_options(ConfigureSession);
+        web::http::client::http_client client{ baseUri, config };
 
         // Add default custom handlers if any.
         if (m_defaultRequestHandlerStage)
@@ -96,9 +162,93 @@ namespace AppInstaller::Repository::Rest::Schema
             client.add_handler(m_defaultRequestHandlerStage.value());
         }
 
+        m_clientPool->Clients.emplace(std::move(key), client);
         return client;
     }
 
+    pplx::task<web::http::http_response> HttpClientHelper::SendRequest(const utility::string_t& uri, web::http::http_request& request) const
+    {
+        web::uri requestUri{ uri };
+        web::http::client::http_client client = GetClient(requestUri.authority());
+        request.set_request_uri(requestUri.resource());
+
+        // REST requests count toward the connection limit of their host, at the priority of manifest downloads.
+        // The connection is held until the whole response has been received, not just its headers.
+        static ProgressCallback s_noCancellation;
+        auto slot = std::make_shared<Utility::DownloadSlot>(
+            utility::conversions::to_utf8string(uri), Utility::DownloadPriority::Manifest, s_noCancellation);
+
+        // The task completes once the response headers are received, so this is the time to first byte
+        // including any connection setup; a reused connection shows up as a much shorter time.
+        auto start = std::chrono::steady_clock::now();
+
+        return client.request(request).then([start, slot](web::http::http_response response)
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                AICLI_LOG(Repo, Info, << "Response headers received in " << elapsed.count() << "ms");
+                response.content_ready().then([slot](pplx::task<web::http::http_response>) {});
+                return response;
+            });
+    }
+
+    std::unordered_map<utility::string_t, utility::string_t> HttpClientHelper::AddConditionalHeaders(
+        const std::unordered_map<utility::string_t, utility::string_t>& headers,
+        const std::optional<HttpResponseCache::Entry>& cached) const
+    {
+        std::unordered_map<utility::string_t, utility::string_t> result = headers;
+
+        if (cached)
+        {
+            if (!cached->ETag.empty())
+            {
+                result.emplace(web::http::header_names::if_none_match, cached->ETag);
+            }
+
+            if (!cached->LastModified.empty())
+            {
+                result.emplace(web::http::header_names::if_modified_since, cached->LastModified);
+            }
+        }
+
+        return result;
+    }
+
+    std::optional<web::json::value> HttpClientHelper::ValidateAndCacheResponse(
+        const web::http::http_response& response,
+        const utility::string_t& uri,
+        const utility::string_t& body,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers,
+        const std::optional<HttpResponseCache::Entry>& cached) const
+    {
+        if (cached && response.status_code() == web::http::status_codes::NotModified)
+        {
+            AICLI_LOG(Repo, Info, << "Response not modified; using cached response");
+            return cached->Body;
+        }
+
+        std::optional<web::json::value> result = ValidateAndExtractResponse(response);
+
+        if (m_responseCache && result && response.status_code() == web::http::status_codes::OK)
+        {
+            HttpResponseCache::Entry entry;
+            entry.ETag = GetHeader(response.headers(), web::http::header_names::etag).value_or(utility::string_t{});
+            entry.LastModified = GetHeader(response.headers(), web::http::header_names::last_modified).value_or(utility::string_t{});
+
+            if (!entry.ETag.empty() || !entry.LastModified.empty())
+            {
+                entry.Body = result.value();
+
+                try
+                {
+                    m_responseCache->Put(uri, body, headers, entry);
+                }
+                CATCH_LOG();
+            }
+        }
+
+        return result;
+    }
+
     std::optional<web::json::value> HttpClientHelper::ValidateAndExtractResponse(const web::http::http_response& response) const
     {
         AICLI_LOG(Repo, Info, << "Response status: " << response.status_code());
@@ -3,32 +3,97 @@
 #pragma once
 #include <cpprest/http_client.h>
 #include <cpprest/json.h>
+#include "Rest/Schema/HttpResponseCache.h"
+#include <winget/ThreadGlobals.h>
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 namespace AppInstaller::Repository::Rest::Schema
 {
+    // Wraps a task continuation so that it runs with the thread globals of the thread that wraps it, keeping its logging with that
+    // of the caller rather than losing it on the thread pool. The argument type is explicit, as tasks deduce the kind of continuation from it.
+    template <typename Argument, typename Func>
+    std::function<std::invoke_result_t<Func, Argument>(Argument)> WithCallerThreadGlobals(Func&& func)
+    {
+        std::shared_ptr<ThreadLocalStorage::ThreadGlobals> threadGlobals;
+        ThreadLocalStorage::ThreadGlobals* parentThreadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+        if (parentThreadGlobals)
+        {
+            threadGlobals = std::make_shared<ThreadLocalStorage::ThreadGlobals>(*parentThreadGlobals, ThreadLocalStorage::ThreadGlobals::create_sub_thread_globals_t{});
+        }
+
+        return [threadGlobals, func = std::forward<Func>(func)](Argument argument) mutable
+        {
+            std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+            if (threadGlobals)
+            {
+                previousThreadGlobals = threadGlobals->SetForCurrentThread();
+            }
+
+            return func(std::forward<Argument>(argument));
+        };
+    }
+
     struct HttpClientHelper
     {
-        HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> = {});
+        HttpClientHelper(
+            std::optional<std::shared_ptr<web::http::http_pipeline_stage>> = {},
+            std::shared_ptr<HttpResponseCache> responseCache = HttpResponseCache::GetDefault());
 
         pplx::task<web::http::http_response> Post(const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t> &headers = {}) const;
 
         std::optional<web::json::value> HandlePost(const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
 
+        // Sends the request and handles the response without blocking the calling thread.
+        pplx::task<std::optional<web::json::value>> HandlePostAsync(const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
+
         pplx::task<web::http::http_response> Get(const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
 
         std::optional<web::json::value> HandleGet(const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
+
+        // Sends the request and handles the response without blocking the calling thread.
+        pplx::task<std::optional<web::json::value>> HandleGetAsync(const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
     
     protected:
         std::optional<web::json::value> ValidateAndExtractResponse(const web::http::http_response& response) const;
 
         std::optional<web::json::value> ExtractJsonResponse(const web::http::http_response& response) const;
 
+        // Adds the conditional request headers for the cached response, if any.
+        std::unordered_map<utility::string_t, utility::string_t> AddConditionalHeaders(
+            const std::unordered_map<utility::string_t, utility::string_t>& headers,
+            const std::optional<HttpResponseCache::Entry>& cached) const;
+
+        // Validates the response, using the cached response if it was not modified and caching it otherwise.
+        std::optional<web::json::value> ValidateAndCacheResponse(
+            const web::http::http_response& response,
+            const utility::string_t& uri,
+            const utility::string_t& body,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers,
+            const std::optional<HttpResponseCache::Entry>& cached) const;
+
     private:
-        web::http::client::http_client GetClient(const utility::string_t& uri) const;
+        // Clients are kept per base URI (scheme and authority) so that connections and TLS sessions are reused.
+        // Copies of the helper share the same clients.
+        struct ClientPool
+        {
+            std::mutex Lock;
+            std::map<utility::string_t, web::http::client::http_client> Clients;
+        };
+
+        web::http::client::http_client GetClient(const web::uri& baseUri) const;
+
+        // Sends the request for the given uri through the client for its base URI.
+        pplx::task<web::http::http_response> SendRequest(const utility::string_t& uri, web::http::http_request& request) const;
 
         std::optional<std::shared_ptr<web::http::http_pipeline_stage>> m_defaultRequestHandlerStage;
+        std::shared_ptr<ClientPool> m_clientPool;
+        std::shared_ptr<HttpResponseCache> m_responseCache;
     };
 }
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "HttpResponseCache.h"
+
+namespace AppInstaller::Repository::Rest::Schema
+{
+    namespace
+    {
+        constexpr std::wstring_view s_HttpResponseCache_Directory = L"RestResponseCache";
+
+        // Entries that have not been used in this long are removed.
+        constexpr auto s_HttpResponseCache_MaximumAge = std::chrono::hours(24 * 14);
+
+        const utility::string_t s_HttpResponseCache_UriField = L"uri";
+        const utility::string_t s_HttpResponseCache_ETagField = L"etag";
+        const utility::string_t s_HttpResponseCache_LastModifiedField = L"lastModified";
+        const utility::string_t s_HttpResponseCache_BodyField = L"body";
+    }
+
+    HttpResponseCache::HttpResponseCache(std::filesystem::path root) : m_root(std::move(root))
+    {
+        THROW_HR_IF(E_INVALIDARG, m_root.empty());
+    }
+
+    std::shared_ptr<HttpResponseCache> HttpResponseCache::GetDefault()
+    {
+        static std::once_flag s_trimOnce;
+
+        auto result = std::make_shared<HttpResponseCache>(Runtime::GetPathTo(Runtime::PathName::LocalState) / s_HttpResponseCache_Directory);
+
+        std::call_once(s_trimOnce, [&]()
+            {
+                try
+                {
+                    result->Trim();
+                }
+                CATCH_LOG();
+            });
+
+        return result;
+    }
+
+    std::optional<HttpResponseCache::Entry> HttpResponseCache::Get(
+        const utility::string_t& uri,
+        const utility::string_t& body,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(uri, body, headers);
+
+        // The cache is only an optimization, so any failure to read it is a miss
+        try
+        {
+            std::error_code error;
+            if (!std::filesystem::exists(entryPath, error))
+            {
+                return {};
+            }
+
+            std::ifstream stream{ entryPath, std::ios_base::in | std::ios_base::binary };
+            web::json::value contents = web::json::value::parse(stream);
+
+            // Guard against the unlikely event of a hash collision
+            if (!contents.has_string_field(s_HttpResponseCache_UriField) || contents.at(s_HttpResponseCache_UriField).as_string() != uri ||
+                !contents.has_field(s_HttpResponseCache_BodyField))
+            {
+                return {};
+            }
+
+            Entry result;
+            if (contents.has_string_field(s_HttpResponseCache_ETagField))
+            {
+                result.ETag = contents.at(s_HttpResponseCache_ETagField).as_string();
+            }
+            if (contents.has_string_field(s_HttpResponseCache_LastModifiedField))
+            {
+                result.LastModified = contents.at(s_HttpResponseCache_LastModifiedField).as_string();
+            }
+            result.Body = contents.at(s_HttpResponseCache_BodyField);
+
+            if (result.ETag.empty() && result.LastModified.empty())
+            {
+                return {};
+            }
+
+            // Mark the entry as used so that it is not trimmed
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+
+            return result;
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Verbose, << "Failed to read cached response from " << entryPath);
+            return {};
+        }
+    }
+
+    void HttpResponseCache::Put(
+        const utility::string_t& uri,
+        const utility::string_t& body,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers,
+        const Entry& entry) const
+    {
+        std::filesystem::path entryPath = GetEntryPath(uri, body, headers);
+
+        web::json::value contents;
+        contents[s_HttpResponseCache_UriField] = web::json::value::string(uri);
+        contents[s_HttpResponseCache_ETagField] = web::json::value::string(entry.ETag);
+        contents[s_HttpResponseCache_LastModifiedField] = web::json::value::string(entry.LastModified);
+        contents[s_HttpResponseCache_BodyField] = entry.Body;
+
+        std::filesystem::create_directories(m_root);
+
+        // Write to a unique file and then move it into place, as other processes may be using the same entry
+        std::filesystem::path tempPath = entryPath;
+        tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId());
+
+        {
+            std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+            stream << utility::conversions::to_utf8string(contents.serialize());
+            THROW_HR_IF(E_FAIL, stream.fail());
+        }
+
+        std::filesystem::rename(tempPath, entryPath);
+    }
+
+    void HttpResponseCache::Trim() const
+    {
+        std::error_code error;
+        if (!std::filesystem::is_directory(m_root, error))
+        {
+            return;
+        }
+
+        auto cutoff = std::filesystem::file_time_type::clock::now() - s_HttpResponseCache_MaximumAge;
+
+        for (const auto& file : std::filesystem::directory_iterator{ m_root, error })
+        {
+            if (file.is_regular_file(error) && file.last_write_time(error) < cutoff)
+            {
+                std::filesystem::remove(file.path(), error);
+            }
+        }
+    }
+
+    std::filesystem::path HttpResponseCache::GetEntryPath(
+        const utility::string_t& uri,
+        const utility::string_t& body,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers) const
+    {
+        // Sort the headers so that the key does not depend on the order of the map
+        std::map<utility::string_t, utility::string_t> sortedHeaders{ headers.begin(), headers.end() };
+
+        std::string key = utility::conversions::to_utf8string(uri);
+        key += '\n';
+        key += utility::conversions::to_utf8string(body);
+
+        for (const auto& header : sortedHeaders)
+        {
+            key += '\n';
+            key += utility::conversions::to_utf8string(header.first);
+            key += ':';
+            key += utility::conversions::to_utf8string(header.second);
+        }
+
+        return m_root / Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(key));
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cpprest/json.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace AppInstaller::Repository::Rest::Schema
+{
+    // An on disk cache of REST responses, used to make conditional requests for responses that have been seen before.
+    // Entries are keyed by the request uri, body and headers, and only responses with a validator (ETag or Last-Modified) are stored.
+    struct HttpResponseCache
+    {
+        // A cached response.
+        struct Entry
+        {
+            utility::string_t ETag;
+            utility::string_t LastModified;
+            web::json::value Body;
+        };
+
+        HttpResponseCache(std::filesystem::path root);
+
+        // Gets the cache in the default location, removing stale entries the first time it is used in the process.
+        static std::shared_ptr<HttpResponseCache> GetDefault();
+
+        // Gets the cached response for the request, if there is one.
+        std::optional<Entry> Get(
+            const utility::string_t& uri,
+            const utility::string_t& body,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers) const;
+
+        // Stores the response for the request.
+        void Put(
+            const utility::string_t& uri,
+            const utility::string_t& body,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers,
+            const Entry& entry) const;
+
+        // Removes entries that have not been used recently.
+        void Trim() const;
+
+    private:
+        std::filesystem::path GetEntryPath(
+            const utility::string_t& uri,
+            const utility::string_t& body,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers) const;
+
+        std::filesystem::path m_root;
+    };
+}
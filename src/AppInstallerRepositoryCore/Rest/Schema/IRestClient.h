@@ -3,6 +3,7 @@
 #pragma once
 #include "Microsoft/Schema/Version.h"
 #include <AppInstallerVersions.h>
+#include <pplx/pplxtasks.h>
 #include <vector>
 
 namespace AppInstaller::Repository::Rest::Schema
@@ -67,6 +68,7 @@ namespace AppInstaller::Repository::Rest::Schema
         std::vector<std::string> RequiredPackageMatchFields;
         std::vector<std::string> UnsupportedQueryParameters;
         std::vector<std::string> RequiredQueryParameters;
+        std::vector<std::string> SupportedFeatures;
 
         Information() {}
         Information(std::string sourceId, std::vector<std::string> versions)
@@ -82,10 +84,27 @@ namespace AppInstaller::Repository::Rest::Schema
     // Performs a search based on the given criteria.
     virtual SearchResult Search(const SearchRequest& request) const = 0;
 
-    // Gets the manifest for given version
+    // Performs a search without blocking the calling thread while waiting on the source.
+    // The client must outlive the task.
+    virtual pplx::task<SearchResult> SearchAsync(const SearchRequest& request) const = 0;
+
+    // Gets the manifest for given version; if the version is empty, gets that of the latest version with the channel.
+    // Only the manifest of that version is deserialized, even if the source returns others.
     virtual std::optional<Manifest::Manifest> GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const = 0;
     
     // Gets the manifests for given query parameters
     virtual std::vector<Manifest::Manifest> GetManifests(const std::string& packageId, const std::map<std::string_view, std::string>& params = {}) const = 0;
+
+    // Gets the manifests without blocking the calling thread while waiting on the source.
+    // The client must outlive the task.
+    virtual pplx::task<std::vector<Manifest::Manifest>> GetManifestsAsync(const std::string& packageId, const std::map<std::string_view, std::string>& params = {}) const = 0;
+
+    // Gets the manifests of all versions of each of the given packages.
+    // The results are in the same order as the package identifiers.
+    virtual std::vector<std::vector<Manifest::Manifest>> GetManifestsForPackages(const std::vector<std::string>& packageIds) const = 0;
+
+    // Determines whether the source reported that it can resolve the transitive dependencies of a package itself.
+    // This is only a hint for callers deciding whether to walk the dependency graph one package at a time.
+    virtual bool SupportsDependencyClosure() const = 0;
     };
 }
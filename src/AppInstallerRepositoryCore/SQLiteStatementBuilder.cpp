@@ -313,6 +313,18 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::GreaterThanOrEquals(details::unbound_t)
+    {
+        AppendOpAndBinder(Op::GreaterThanOrEquals);
+        return *this;
+    }
+
+    StatementBuilder& StatementBuilder::LessThan(details::unbound_t)
+    {
+        AppendOpAndBinder(Op::LessThan);
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::LikeWithEscape(std::string_view value)
     {
         AddBindFunctor(AppendOpAndBinder(Op::Like), EscapeStringForLike(value));
@@ -325,6 +337,12 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::Match(details::unbound_t)
+    {
+        AppendOpAndBinder(Op::Match);
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::LiteralColumn(std::string_view value)
     {
         if (m_needsComma)
@@ -472,6 +490,18 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::OrderBy(std::initializer_list<QualifiedColumn> columns)
+    {
+        OutputColumns(m_stream, " ORDER BY ", columns);
+        return *this;
+    }
+
+    StatementBuilder& StatementBuilder::Descending()
+    {
+        m_stream << " DESC";
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::InsertInto(std::string_view table)
     {
         OutputOperationAndTable(m_stream, "INSERT INTO", table);
@@ -784,6 +814,18 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::Analyze()
+    {
+        m_stream << "ANALYZE";
+        return *this;
+    }
+
+    StatementBuilder& StatementBuilder::ExplainQueryPlan()
+    {
+        m_stream << "EXPLAIN QUERY PLAN ";
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::BeginParenthetical()
     {
         m_stream << '(';
@@ -812,6 +854,16 @@ namespace AppInstaller::Repository::SQLite::Builder
         return result;
     }
 
+    Statement StatementBuilder::PrepareCached(const Connection& connection)
+    {
+        Statement result = Statement::CreateCached(connection, m_stream.str());
+        for (const auto& f : m_binders)
+        {
+            f(result);
+        }
+        return result;
+    }
+
     void StatementBuilder::Execute(const Connection& connection)
     {
         Prepare(connection).Execute();
@@ -824,9 +876,18 @@ namespace AppInstaller::Repository::SQLite::Builder
         case Op::Equals:
             m_stream << " = ?";
             break;
+        case Op::GreaterThanOrEquals:
+            m_stream << " >= ?";
+            break;
+        case Op::LessThan:
+            m_stream << " < ?";
+            break;
         case Op::Like:
             m_stream << " LIKE ?";
             break;
+        case Op::Match:
+            m_stream << " MATCH ?";
+            break;
         case Op::Escape:
             m_stream << " ESCAPE ?";
             break;
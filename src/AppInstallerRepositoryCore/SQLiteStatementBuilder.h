@@ -240,9 +240,16 @@ namespace AppInstaller::Repository::SQLite::Builder
         StatementBuilder& Equals(details::unbound_t);
         StatementBuilder& Equals(std::nullptr_t);
 
+        // Comparisons for a range of values, such as all of those with a given prefix.
+        StatementBuilder& GreaterThanOrEquals(details::unbound_t);
+        StatementBuilder& LessThan(details::unbound_t);
+
         StatementBuilder& LikeWithEscape(std::string_view value);
         StatementBuilder& Like(details::unbound_t);
 
+        // Full text search match against an FTS virtual table (or one of its columns).
+        StatementBuilder& Match(details::unbound_t);
+
         StatementBuilder& LiteralColumn(std::string_view value);
 
         StatementBuilder& Escape(std::string_view escapeChar);
@@ -284,6 +291,10 @@ namespace AppInstaller::Repository::SQLite::Builder
         // Specify the ordering to use.
         StatementBuilder& OrderBy(std::string_view column);
         StatementBuilder& OrderBy(const QualifiedColumn& column);
+        StatementBuilder& OrderBy(std::initializer_list<QualifiedColumn> columns);
+
+        // Sorts on the previous ordering column in descending order.
+        StatementBuilder& Descending();
 
         // Limits the result set to the given number of rows.
         StatementBuilder& Limit(size_t rowCount);
@@ -391,6 +402,12 @@ namespace AppInstaller::Repository::SQLite::Builder
         // Output the set portion of an update statement.
         StatementBuilder& Vacuum();
 
+        // Output an analyze statement, which gathers statistics for the query planner.
+        StatementBuilder& Analyze();
+
+        // Prefixes the statement that follows so that it returns the query plan rather than executing.
+        StatementBuilder& ExplainQueryPlan();
+
         // General purpose functions to begin and end a parenthetical expression.
         StatementBuilder& BeginParenthetical();
         StatementBuilder& EndParenthetical();
@@ -405,6 +422,10 @@ namespace AppInstaller::Repository::SQLite::Builder
         // Prepares and returns the statement, applying any bindings that were requested.
         Statement Prepare(const Connection& connection);
 
+        // Same as Prepare, but retrieves the statement from the connection's prepared statement cache.
+        // Use for statements whose SQL text is stable and that are executed frequently.
+        Statement PrepareCached(const Connection& connection);
+
         // A convenience function that prepares, binds, and then executes a statement that does not return rows.
         void Execute(const Connection& connection);
 
@@ -412,7 +433,10 @@ namespace AppInstaller::Repository::SQLite::Builder
         enum class Op
         {
             Equals,
+            GreaterThanOrEquals,
+            LessThan,
             Like,
+            Match,
             Escape,
             Literal,
         };
@@ -6,14 +6,19 @@
 
 #include <wil/result_macros.h>
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <stack>
+#include <unordered_map>
+
 using namespace std::string_view_literals;
 
 // Enable this to have all Statement constructions output the associated query plan.
 #define WINGET_SQLITE_EXPLAIN_QUERY_PLAN_ENABLED 0
 
-#if WINGET_SQLITE_EXPLAIN_QUERY_PLAN_ENABLED
-#include <stack>
-#endif
+// Enable this to profile every connection, logging its most expensive statements when it is closed.
+#define WINGET_SQLITE_PROFILING_ENABLED 0
 
 #define THROW_SQLITE(_error_) \
     do { \
@@ -36,15 +41,162 @@ namespace AppInstaller::Repository::SQLite
 
     namespace
     {
+        // The number of statements prepared by the process, which is also the id of the latest one.
+        std::atomic_size_t s_statementId(0);
+
         size_t GetNextStatementId()
         {
-            static std::atomic_size_t statementId(0);
-            return ++statementId;
+            return ++s_statementId;
         }
+
+        // The number of times that statements have been stepped by the process.
+        std::atomic_size_t s_stepCount(0);
+
+        // The maximum number of idle statements held by a connection's cache.
+        constexpr size_t s_StatementCacheCapacity = 64;
     }
 
     namespace details
     {
+        // A least recently used cache of idle prepared statements, keyed by their SQL text.
+        // A statement is removed from the cache while it is in use, so concurrent users of the
+        // same SQL simply cause an additional statement to be prepared.
+        struct StatementCache
+        {
+            struct Entry
+            {
+                std::string SQL;
+                size_t Id = 0;
+                unique_stmt Statement;
+            };
+
+            // Takes the idle statement for the given SQL out of the cache, if one is present.
+            std::optional<Entry> Take(const std::string& sql)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                auto itr = m_index.find(sql);
+                if (itr == m_index.end())
+                {
+                    ++m_misses;
+                    return {};
+                }
+
+                ++m_hits;
+                Entry result = std::move(*itr->second);
+                m_entries.erase(itr->second);
+                m_index.erase(itr);
+                return result;
+            }
+
+            // Places the statement into the cache as the most recently used, evicting the least recently used if needed.
+            // The statement must already be reset and have its bindings cleared.
+            void Return(Entry&& entry)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                if (m_index.find(entry.SQL) != m_index.end())
+                {
+                    // An equivalent statement is already idle; let this one be finalized.
+                    return;
+                }
+
+                m_entries.emplace_front(std::move(entry));
+                m_index.emplace(m_entries.front().SQL, m_entries.begin());
+
+                if (m_entries.size() > s_StatementCacheCapacity)
+                {
+                    m_index.erase(m_entries.back().SQL);
+                    m_entries.pop_back();
+                }
+            }
+
+            Connection::StatementCacheStatistics GetStatistics() const
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                return { m_hits, m_misses };
+            }
+
+        private:
+            mutable std::mutex m_lock;
+            std::list<Entry> m_entries;
+            std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+            size_t m_hits = 0;
+            size_t m_misses = 0;
+        };
+
+        // Aggregates the trace events of a connection by the SQL of their statement.
+        struct StatementProfiler
+        {
+            StatementProfiler(size_t reportCount) : ReportCount(reportCount) {}
+
+            // The callback given to sqlite3_trace_v2, with this object as the context.
+            static int Trace(unsigned int type, void* context, void* p, void* x)
+            {
+                try
+                {
+                    auto profiler = static_cast<StatementProfiler*>(context);
+                    const char* sql = sqlite3_sql(static_cast<sqlite3_stmt*>(p));
+
+                    if (profiler && sql)
+                    {
+                        std::lock_guard<std::mutex> lock{ profiler->m_lock };
+                        auto& profile = profiler->GetEntry(sql);
+
+                        if (type == SQLITE_TRACE_PROFILE)
+                        {
+                            std::chrono::nanoseconds time{ *static_cast<sqlite3_int64*>(x) };
+                            ++profile.Executions;
+                            profile.TotalTime += time;
+                            profile.MaxTime = std::max(profile.MaxTime, time);
+                        }
+                        else if (type == SQLITE_TRACE_ROW)
+                        {
+                            ++profile.Rows;
+                        }
+                    }
+                }
+                CATCH_LOG();
+
+                return 0;
+            }
+
+            std::vector<Connection::StatementProfile> Get() const
+            {
+                std::vector<Connection::StatementProfile> result;
+
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    for (const auto& entry : m_statements)
+                    {
+                        result.emplace_back(entry.second);
+                    }
+                }
+
+                std::sort(result.begin(), result.end(), [](const Connection::StatementProfile& a, const Connection::StatementProfile& b) { return a.TotalTime > b.TotalTime; });
+                return result;
+            }
+
+            // The number of statements to log when the connection is closed.
+            const size_t ReportCount;
+
+        private:
+            Connection::StatementProfile& GetEntry(std::string_view sql)
+            {
+                auto itr = m_statements.find(sql);
+                if (itr == m_statements.end())
+                {
+                    itr = m_statements.emplace(std::string{ sql }, Connection::StatementProfile{}).first;
+                    itr->second.SQL = itr->first;
+                }
+
+                return itr->second;
+            }
+
+            mutable std::mutex m_lock;
+            std::map<std::string, Connection::StatementProfile, std::less<>> m_statements;
+        };
+
         void ParameterSpecificsImpl<nullptr_t>::Bind(sqlite3_stmt* stmt, int index, nullptr_t)
         {
             THROW_IF_SQLITE_FAILED(sqlite3_bind_null(stmt, index));
@@ -94,6 +246,16 @@ namespace AppInstaller::Repository::SQLite
             return sqlite3_column_int64(stmt, column);
         }
 
+        void ParameterSpecificsImpl<double>::Bind(sqlite3_stmt* stmt, int index, double v)
+        {
+            THROW_IF_SQLITE_FAILED(sqlite3_bind_double(stmt, index, v));
+        }
+
+        double ParameterSpecificsImpl<double>::GetColumn(sqlite3_stmt* stmt, int column)
+        {
+            return sqlite3_column_double(stmt, column);
+        }
+
         void ParameterSpecificsImpl<bool>::Bind(sqlite3_stmt* stmt, int index, bool v)
         {
             THROW_IF_SQLITE_FAILED(sqlite3_bind_int(stmt, index, (v ? 1 : 0)));
@@ -131,12 +293,40 @@ namespace AppInstaller::Repository::SQLite
         }
     }
 
+    void LogExplainQueryPlanResult(std::string_view sql, Statement& plan)
+    {
+        bool outputHeader = true;
+        std::stack<int> parents;
+
+        while (plan.Step())
+        {
+            if (outputHeader)
+            {
+                AICLI_LOG(SQL, Info, << "Query plan for: " << sql);
+                outputHeader = false;
+            }
+
+            int id = plan.GetColumn<int>(0);
+            int parent = plan.GetColumn<int>(1);
+
+            while (!parents.empty() && parents.top() != parent)
+            {
+                parents.pop();
+            }
+
+            AICLI_LOG(SQL, Info, << "|-" << std::string(parents.size() * 2, '-') << ' ' << plan.GetColumn<std::string>(3));
+
+            parents.push(id);
+        }
+    }
+
     Connection::Connection(const std::string& target, OpenDisposition disposition, OpenFlags flags)
     {
         AICLI_LOG(SQL, Info, << "Opening SQLite connection: '" << target << "' [" << std::hex << static_cast<int>(disposition) << ", " << std::hex << static_cast<int>(flags) << "]");
         // Always force connection serialization until we determine that there are situations where it is not needed
-        int resultingFlags = static_cast<int>(disposition) | static_cast<int>(flags) | SQLITE_OPEN_FULLMUTEX;
+        int resultingFlags = static_cast<int>(disposition) | static_cast<int>(flags & ~OpenFlags::ReadOnlyMapped) | SQLITE_OPEN_FULLMUTEX;
         THROW_IF_SQLITE_FAILED(sqlite3_open_v2(target.c_str(), &m_dbconn, resultingFlags, nullptr));
+        m_statementCache = std::make_shared<details::StatementCache>();
     }
 
     Connection Connection::Create(const std::string& target, OpenDisposition disposition, OpenFlags flags)
@@ -145,6 +335,32 @@ namespace AppInstaller::Repository::SQLite
         
         THROW_IF_SQLITE_FAILED(sqlite3_extended_result_codes(result.m_dbconn.get(), 1));
 
+#if WINGET_SQLITE_PROFILING_ENABLED
+        result.EnableProfiling();
+#endif
+
+        if (WI_IsFlagSet(flags, OpenFlags::ReadOnlyMapped))
+        {
+            THROW_HR_IF(E_INVALIDARG, disposition != OpenDisposition::ReadOnly);
+
+            // Reads come directly from the mapped file rather than being copied through the page cache,
+            // and query_only ensures that nothing can attempt to write through the mapping.
+            // The mapping covers the whole file, so that every process reading it shares the same pages.
+            Statement pageCount = Statement::Create(result, "PRAGMA page_count"sv);
+            THROW_HR_IF(E_UNEXPECTED, !pageCount.Step());
+            Statement pageSize = Statement::Create(result, "PRAGMA page_size"sv);
+            THROW_HR_IF(E_UNEXPECTED, !pageSize.Step());
+
+            int64_t fileSize = pageCount.GetColumn<int64_t>(0) * pageSize.GetColumn<int64_t>(0);
+            AICLI_LOG(SQL, Verbose, << "Mapping " << fileSize << " bytes");
+
+            Statement mmapSize = Statement::Create(result, "PRAGMA mmap_size = " + std::to_string(fileSize));
+            mmapSize.Step();
+
+            Statement queryOnly = Statement::Create(result, "PRAGMA query_only = 1"sv);
+            queryOnly.Execute();
+        }
+
         return result;
     }
 
@@ -164,50 +380,161 @@ namespace AppInstaller::Repository::SQLite
         return sqlite3_changes(m_dbconn.get());
     }
 
-    Statement::Statement(const Connection& connection, std::string_view sql)
+    std::string Connection::GetFilePath() const
     {
-        m_id = GetNextStatementId();
-        AICLI_LOG(SQL, Verbose, << "Preparing statement #" << m_id << ": " << sql);
-        // SQL string size should include the null terminator (https://www.sqlite.org/c3ref/prepare.html)
-        assert(sql.data()[sql.size()] == '\0');
-        THROW_IF_SQLITE_FAILED(sqlite3_prepare_v2(connection, sql.data(), static_cast<int>(sql.size() + 1), &m_stmt, nullptr));
+        const char* result = sqlite3_db_filename(m_dbconn.get(), "main");
+        return result ? result : std::string{};
     }
 
-#if WINGET_SQLITE_EXPLAIN_QUERY_PLAN_ENABLED
-#define WINGET_SQLITE_EXPLAIN_QUERY_PLAN(_connection_,_sql_) \
-    std::string _explainStatementSQL_ = "EXPLAIN QUERY PLAN "; \
-    _explainStatementSQL_.append(_sql_); \
-    try { \
-        Statement _explainStatement_(_connection_,_explainStatementSQL_); \
-        LogExplainQueryPlanResult(_sql_, _explainStatement_); \
-    } catch(...) {}
+    bool Connection::IsInTransaction() const
+    {
+        return sqlite3_get_autocommit(m_dbconn.get()) == 0;
+    }
 
-    void LogExplainQueryPlanResult(std::string_view sql, Statement& plan)
+    uint64_t Connection::GetRollbackCount() const
     {
-        bool outputHeader = true;
-        std::stack<int> parents;
+        return *m_rollbackCount;
+    }
 
-        while (plan.Step())
+    void Connection::SetCacheSizeLimit(uint32_t kibibytes)
+    {
+        AICLI_LOG(SQL, Verbose, << "Limiting page cache to " << kibibytes << " KiB");
+
+        // A negative value is a size in KiB rather than a count of pages.
+        Statement cacheSize = Statement::Create(*this, "PRAGMA cache_size = -" + std::to_string(kibibytes));
+        cacheSize.Execute();
+    }
+
+    bool Connection::EnableWriteAheadLogging(uint32_t autoCheckpointPages, std::chrono::milliseconds busyTimeout)
+    {
+        Statement journalMode = Statement::Create(*this, "PRAGMA journal_mode = WAL"sv);
+        THROW_HR_IF(E_UNEXPECTED, !journalMode.Step());
+
+        std::string resultingMode = journalMode.GetColumn<std::string>(0);
+        if (!Utility::CaseInsensitiveEquals(resultingMode, "wal"))
         {
-            if (outputHeader)
+            AICLI_LOG(SQL, Info, << "Write-ahead logging not available, journal mode is " << resultingMode);
+            return false;
+        }
+
+        AICLI_LOG(SQL, Verbose, << "Enabled write-ahead logging, checkpointing every " << autoCheckpointPages << " pages");
+
+        // In WAL mode, NORMAL only syncs at checkpoints; the database cannot be corrupted, though the most recent commits may be lost on power failure.
+        Statement synchronous = Statement::Create(*this, "PRAGMA synchronous = NORMAL"sv);
+        synchronous.Execute();
+
+        THROW_IF_SQLITE_FAILED(sqlite3_wal_autocheckpoint(m_dbconn.get(), static_cast<int>(autoCheckpointPages)));
+        THROW_IF_SQLITE_FAILED(sqlite3_busy_timeout(m_dbconn.get(), static_cast<int>(busyTimeout.count())));
+
+        return true;
+    }
+
+    Connection::StatementCacheStatistics Connection::GetStatementCacheStatistics() const
+    {
+        return m_statementCache ? m_statementCache->GetStatistics() : StatementCacheStatistics{};
+    }
+
+    void Connection::EnableProfiling(size_t reportCount)
+    {
+        if (m_profiler)
+        {
+            return;
+        }
+
+        auto profiler = std::make_shared<details::StatementProfiler>(reportCount);
+        THROW_IF_SQLITE_FAILED(sqlite3_trace_v2(m_dbconn.get(), SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW, &details::StatementProfiler::Trace, profiler.get()));
+        m_profiler = std::move(profiler);
+    }
+
+    std::vector<Connection::StatementProfile> Connection::GetProfile() const
+    {
+        return m_profiler ? m_profiler->Get() : std::vector<StatementProfile>{};
+    }
+
+    void Connection::LogProfile()
+    {
+        // Stop tracing first, so that explaining the statements does not change the statistics.
+        sqlite3_trace_v2(m_dbconn.get(), 0, nullptr, nullptr);
+
+        auto profile = m_profiler->Get();
+        size_t reportCount = std::min(profile.size(), m_profiler->ReportCount);
+        m_profiler.reset();
+
+        AICLI_LOG(SQL, Info, << "Profiled " << profile.size() << " distinct statements; the " << reportCount << " with the most total time are:");
+
+        for (size_t i = 0; i < reportCount; ++i)
+        {
+            const auto& entry = profile[i];
+            AICLI_LOG(SQL, Info, << '[' << (i + 1) << "] executions: " << entry.Executions <<
+                ", total: " << std::chrono::duration<double, std::milli>(entry.TotalTime).count() << "ms" <<
+                ", max: " << std::chrono::duration<double, std::milli>(entry.MaxTime).count() << "ms" <<
+                ", rows: " << entry.Rows << std::endl << entry.SQL);
+
+            try
             {
-                AICLI_LOG(SQL, Info, << "Query plan for: " << sql);
-                outputHeader = false;
+                Statement plan = Statement::Create(*this, "EXPLAIN QUERY PLAN " + entry.SQL);
+                LogExplainQueryPlanResult(entry.SQL, plan);
             }
+            CATCH_LOG();
+        }
+    }
 
-            int id = plan.GetColumn<int>(0);
-            int parent = plan.GetColumn<int>(1);
-
-            while (!parents.empty() && parents.top() != parent)
+    Connection::~Connection()
+    {
+        if (m_profiler && m_dbconn)
+        {
+            try
             {
-                parents.pop();
+                LogProfile();
             }
+            CATCH_LOG();
+        }
+    }
 
-            AICLI_LOG(SQL, Info, << "|-" << std::string(parents.size() * 2, '-') << ' ' << plan.GetColumn<std::string>(3));
+    void Connection::CopyTo(Connection& target) const
+    {
+        wil::unique_any<sqlite3_backup*, decltype(sqlite3_backup_finish), sqlite3_backup_finish> backup{ sqlite3_backup_init(target.m_dbconn.get(), "main", m_dbconn.get(), "main") };
+        if (!backup)
+        {
+            THROW_SQLITE(sqlite3_extended_errcode(target.m_dbconn.get()));
+        }
 
-            parents.push(id);
+        int result = sqlite3_backup_step(backup.get(), -1);
+        if (result != SQLITE_DONE)
+        {
+            THROW_SQLITE(result);
         }
+
+        THROW_IF_SQLITE_FAILED(sqlite3_backup_finish(backup.release()));
+    }
+
+    size_t Statement::GetPreparedCount()
+    {
+        return s_statementId.load();
+    }
+
+    size_t Statement::GetStepCount()
+    {
+        return s_stepCount.load(std::memory_order_relaxed);
     }
+
+    Statement::Statement(const Connection& connection, std::string_view sql)
+    {
+        m_id = GetNextStatementId();
+        AICLI_TRACE(SQL, Verbose, SQLPrepareStatement, m_id, sql);
+        // SQL string size should include the null terminator (https://www.sqlite.org/c3ref/prepare.html)
+        assert(sql.data()[sql.size()] == '\0');
+        THROW_IF_SQLITE_FAILED(sqlite3_prepare_v2(connection, sql.data(), static_cast<int>(sql.size() + 1), &m_stmt, nullptr));
+    }
+
+#if WINGET_SQLITE_EXPLAIN_QUERY_PLAN_ENABLED
+#define WINGET_SQLITE_EXPLAIN_QUERY_PLAN(_connection_,_sql_) \
+    std::string _explainStatementSQL_ = "EXPLAIN QUERY PLAN "; \
+    _explainStatementSQL_.append(_sql_); \
+    try { \
+        Statement _explainStatement_(_connection_,_explainStatementSQL_); \
+        LogExplainQueryPlanResult(_sql_, _explainStatement_); \
+    } catch(...) {}
 #else
 #define WINGET_SQLITE_EXPLAIN_QUERY_PLAN(_connection_,_sql_)
 #endif
@@ -231,20 +558,85 @@ namespace AppInstaller::Repository::SQLite
         return { connection, sql };
     }
 
+    Statement Statement::CreateCached(const Connection& connection, const std::string& sql)
+    {
+        if (!connection.m_statementCache)
+        {
+            return Create(connection, sql);
+        }
+
+        Statement result;
+
+        auto entry = connection.m_statementCache->Take(sql);
+        if (entry)
+        {
+            result.m_id = entry->Id;
+            result.m_stmt = std::move(entry->Statement);
+            AICLI_TRACE(SQL, Verbose, SQLReuseStatement, result.m_id);
+        }
+        else
+        {
+            result = Create(connection, sql);
+        }
+
+        result.m_cache = connection.m_statementCache;
+        result.m_cacheKey = sql;
+        return result;
+    }
+
+    Statement& Statement::operator=(Statement&& other)
+    {
+        if (this != &other)
+        {
+            ReturnToCache();
+
+            m_id = other.m_id;
+            m_stmt = std::move(other.m_stmt);
+            m_state = other.m_state;
+            m_cache = std::move(other.m_cache);
+            m_cacheKey = std::move(other.m_cacheKey);
+        }
+
+        return *this;
+    }
+
+    Statement::~Statement()
+    {
+        ReturnToCache();
+    }
+
+    void Statement::ReturnToCache()
+    {
+        if (m_cache && m_stmt)
+        {
+            try
+            {
+                // Reset now rather than on reuse so that an idle statement never holds a read transaction open.
+                sqlite3_reset(m_stmt.get());
+                sqlite3_clear_bindings(m_stmt.get());
+                m_cache->Return({ std::move(m_cacheKey), m_id, std::move(m_stmt) });
+            }
+            CATCH_LOG();
+        }
+
+        m_cache.reset();
+    }
+
     bool Statement::Step(bool failFastOnError)
     {
-        AICLI_LOG(SQL, Verbose, << "Stepping statement #" << m_id);
+        AICLI_TRACE(SQL, Verbose, SQLStepStatement, m_id);
+        s_stepCount.fetch_add(1, std::memory_order_relaxed);
         int result = sqlite3_step(m_stmt.get());
 
         if (result == SQLITE_ROW)
         {
-            AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has data");
+            AICLI_TRACE(SQL, Verbose, SQLStatementHasData, m_id);
             m_state = State::HasRow;
             return true;
         }
         else if (result == SQLITE_DONE)
         {
-            AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has completed");
+            AICLI_TRACE(SQL, Verbose, SQLStatementCompleted, m_id);
             m_state = State::Completed;
             return false;
         }
@@ -275,14 +667,14 @@ namespace AppInstaller::Repository::SQLite
 
     void Statement::Reset()
     {
-        AICLI_LOG(SQL, Verbose, << "Reset statement #" << m_id);
+        AICLI_TRACE(SQL, Verbose, SQLResetStatement, m_id);
         // Ignore return value from reset, as if it is an error, it was the error from the last call to step.
         sqlite3_reset(m_stmt.get());
         m_state = State::Prepared;
     }
 
     Savepoint::Savepoint(Connection& connection, std::string&& name) :
-        m_name(std::move(name))
+        m_name(std::move(name)), m_rollbackCount(connection.m_rollbackCount)
     {
         using namespace std::string_literals;
 
@@ -315,6 +707,7 @@ namespace AppInstaller::Repository::SQLite
             // this should have the effect of 'committing' nothing.
             m_release.Step(true);
             m_inProgress = false;
+            ++*m_rollbackCount;
         }
     }
 
@@ -6,8 +6,12 @@
 #include <winsqlite/winsqlite3.h>
 
 #include <AppInstallerLogging.h>
+#include <winget/TraceEvents.h>
 #include <AppInstallerLanguageUtilities.h>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -90,6 +94,14 @@ namespace AppInstaller::Repository::SQLite
             static int64_t GetColumn(sqlite3_stmt* stmt, int column);
         };
 
+        template <>
+        struct ParameterSpecificsImpl<double>
+        {
+            inline static double ToLog(double v) { return v; }
+            static void Bind(sqlite3_stmt* stmt, int index, double v);
+            static double GetColumn(sqlite3_stmt* stmt, int column);
+        };
+
         template <>
         struct ParameterSpecificsImpl<bool>
         {
@@ -125,6 +137,15 @@ namespace AppInstaller::Repository::SQLite
 
         template <typename T>
         using ParameterSpecifics = ParameterSpecificsImpl<std::decay_t<T>>;
+
+        // The owning handle type for a prepared statement.
+        using unique_stmt = wil::unique_any<sqlite3_stmt*, decltype(sqlite3_finalize), sqlite3_finalize>;
+
+        // The cache of prepared statements for a connection.
+        struct StatementCache;
+
+        // The collector of statement statistics for a connection that is being profiled.
+        struct StatementProfiler;
     }
 
     // A SQLite exception.
@@ -154,6 +175,9 @@ namespace AppInstaller::Repository::SQLite
             None = 0,
             // Indicate that the target can be a URI.
             Uri = SQLITE_OPEN_URI,
+            // Memory map the database and reject any writes; only for databases that are known to be read-only.
+            // This is not passed to SQLite when opening, but applied to the connection afterward.
+            ReadOnlyMapped = 0x40000000,
         };
 
         static Connection Create(const std::string& target, OpenDisposition disposition, OpenFlags flags = OpenFlags::None);
@@ -166,7 +190,7 @@ namespace AppInstaller::Repository::SQLite
         Connection(Connection&& other) = default;
         Connection& operator=(Connection&& other) = default;
 
-        ~Connection() = default;
+        ~Connection();
 
         // Enables the ICU integrations on this connection.
         void EnableICU();
@@ -177,12 +201,73 @@ namespace AppInstaller::Repository::SQLite
         // Gets the count of changed rows for the last executed statement.
         int GetChanges() const;
 
+        // Gets the path of the main database file; this is empty for an in-memory database.
+        std::string GetFilePath() const;
+
+        // Determines whether a transaction is open on this connection, and so changes may not yet be visible to other connections.
+        bool IsInTransaction() const;
+
+        // Gets the number of savepoints that have been rolled back on this connection.
+        // Anything cached from the database while the count was lower may no longer be there.
+        uint64_t GetRollbackCount() const;
+
+        // Limits the page cache of this connection to the given size.
+        void SetCacheSizeLimit(uint32_t kibibytes);
+
+        // Switches the database to write-ahead logging, so that readers on other connections are not blocked by a writer.
+        // Commits are made durable at checkpoints rather than on every commit, and the log is checkpointed once it
+        // reaches the given number of pages. Writers wait up to the busy timeout for each other rather than failing.
+        // Returns false if the database cannot use write-ahead logging, as for an in-memory database.
+        bool EnableWriteAheadLogging(uint32_t autoCheckpointPages, std::chrono::milliseconds busyTimeout);
+
+        // Statistics on the use of the prepared statement cache.
+        struct StatementCacheStatistics
+        {
+            size_t Hits = 0;
+            size_t Misses = 0;
+        };
+
+        // Gets the statistics for the prepared statement cache of this connection.
+        StatementCacheStatistics GetStatementCacheStatistics() const;
+
+        // The execution statistics of all of the runs of a statement with the same SQL.
+        struct StatementProfile
+        {
+            std::string SQL;
+            size_t Executions = 0;
+            std::chrono::nanoseconds TotalTime{};
+            std::chrono::nanoseconds MaxTime{};
+            size_t Rows = 0;
+        };
+
+        // Begins collecting the execution statistics of every statement run on this connection.
+        // When the connection is destroyed, the statements with the most total time are logged along with their query plans.
+        void EnableProfiling(size_t reportCount = 10);
+
+        // Gets the statistics collected since profiling was enabled, in descending order of total time.
+        std::vector<StatementProfile> GetProfile() const;
+
+        // Replaces the entire contents of the target database with the contents of this one, using the online backup API.
+        void CopyTo(Connection& target) const;
+
         operator sqlite3* () const { return m_dbconn.get(); }
 
     private:
+        friend struct Statement;
+        friend struct Savepoint;
+
         Connection(const std::string& target, OpenDisposition disposition, OpenFlags flags);
 
+        // Logs the most expensive statements and their query plans, and stops profiling.
+        void LogProfile();
+
+        // Declared before the connection so that it outlives any trace callback during close.
+        std::shared_ptr<details::StatementProfiler> m_profiler;
         wil::unique_any<sqlite3*, decltype(sqlite3_close_v2), sqlite3_close_v2> m_dbconn;
+        // Declared after the connection so that idle statements are finalized before it is closed.
+        std::shared_ptr<details::StatementCache> m_statementCache;
+        // Shared with the savepoints, so that they can count their rollbacks even if the connection is moved.
+        std::shared_ptr<std::atomic<uint64_t>> m_rollbackCount = std::make_shared<std::atomic<uint64_t>>(0);
     };
 
     // A SQL statement.
@@ -192,13 +277,25 @@ namespace AppInstaller::Repository::SQLite
         static Statement Create(const Connection& connection, std::string_view sql);
         static Statement Create(const Connection& connection, char const* const sql);
 
+        // Gets an idle prepared statement for the given SQL from the connection's cache, or prepares a new one.
+        // The statement has no bindings and is returned to the cache (reset) when it is destroyed.
+        static Statement CreateCached(const Connection& connection, const std::string& sql);
+
+        // Gets the number of statements that have been prepared by the process; statements reused from a cache are not counted.
+        static size_t GetPreparedCount();
+
+        // Gets the number of times that statements have been stepped by the process, including by Execute.
+        static size_t GetStepCount();
+
         Statement() = default;
 
         Statement(const Statement&) = delete;
         Statement& operator=(const Statement&) = delete;
 
         Statement(Statement&& other) = default;
-        Statement& operator=(Statement&& other) = default;
+        Statement& operator=(Statement&& other);
+
+        ~Statement();
 
         operator sqlite3_stmt* () const { return m_stmt.get(); }
 
@@ -223,7 +320,7 @@ namespace AppInstaller::Repository::SQLite
         template <typename Value>
         void Bind(int index, Value&& v)
         {
-            AICLI_LOG(SQL, Verbose, << "Binding statement #" << m_id << ": " << index << " => " << details::ParameterSpecifics<Value>::ToLog(std::forward<Value>(v)));
+            AICLI_TRACE(SQL, Verbose, SQLBindStatement, m_id, index, details::ParameterSpecifics<Value>::ToLog(std::forward<Value>(v)));
             details::ParameterSpecifics<Value>::Bind(m_stmt.get(), index, std::forward<Value>(v));
         }
 
@@ -266,6 +363,9 @@ namespace AppInstaller::Repository::SQLite
     private:
         Statement(const Connection& connection, std::string_view sql);
 
+        // Hands the underlying statement back to the cache it came from, if any.
+        void ReturnToCache();
+
         // Helper to receive the integer sequence from the public function.
         // This is equivalent to calling:
         //  for (i = 0 .. count of Values types)
@@ -279,8 +379,10 @@ namespace AppInstaller::Repository::SQLite
         }
 
         size_t m_id = 0;
-        wil::unique_any<sqlite3_stmt*, decltype(sqlite3_finalize), sqlite3_finalize> m_stmt;
+        details::unique_stmt m_stmt;
         State m_state = State::Prepared;
+        std::shared_ptr<details::StatementCache> m_cache;
+        std::string m_cacheKey;
     };
 
     // A SQLite savepoint.
@@ -310,6 +412,7 @@ namespace AppInstaller::Repository::SQLite
         DestructionToken m_inProgress = true;
         Statement m_rollbackTo;
         Statement m_release;
+        std::shared_ptr<std::atomic<uint64_t>> m_rollbackCount;
     };
 
     // The escape character used in the EscapeStringForLike function.
@@ -317,4 +420,6 @@ namespace AppInstaller::Repository::SQLite
 
     // Escapes the given input string for passing to a like operation.
     std::string EscapeStringForLike(std::string_view value);
+
+    DEFINE_ENUM_FLAG_OPERATORS(Connection::OpenFlags);
 }
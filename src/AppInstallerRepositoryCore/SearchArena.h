@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+
+
+namespace AppInstaller::Repository
+{
+    // A monotonic arena for the objects created by a single search.
+    // Deallocation does nothing; all of the memory is released at once when the last object allocated from the arena
+    // is destroyed. Only objects created once per result should be placed here, as repeated allocations are never reused.
+    struct SearchArena
+    {
+        SearchArena() = default;
+
+        SearchArena(const SearchArena&) = delete;
+        SearchArena& operator=(const SearchArena&) = delete;
+
+        SearchArena(SearchArena&&) = delete;
+        SearchArena& operator=(SearchArena&&) = delete;
+
+        // Allocates from the arena; safe to call from multiple threads.
+        void* Allocate(size_t bytes, size_t alignment)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            return m_resource.allocate(bytes, alignment);
+        }
+
+    private:
+        static constexpr size_t s_InitialBufferSize = 16 * 1024;
+
+        std::mutex m_lock;
+        std::pmr::monotonic_buffer_resource m_resource{ s_InitialBufferSize };
+    };
+
+    // An allocator over a SearchArena, for use with std::allocate_shared.
+    // Each copy holds a reference to the arena, so the arena lives until every block allocated from it is released.
+    template <typename T>
+    struct SearchArenaAllocator
+    {
+        using value_type = T;
+
+        SearchArenaAllocator(std::shared_ptr<SearchArena> arena) : m_arena(std::move(arena)) {}
+
+        template <typename U>
+        SearchArenaAllocator(const SearchArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+        T* allocate(size_t count)
+        {
+            if (count > std::numeric_limits<size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length{};
+            }
+
+            return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t) noexcept {}
+
+        template <typename U>
+        bool operator==(const SearchArenaAllocator<U>& other) const { return m_arena == other.m_arena; }
+
+        template <typename U>
+        bool operator!=(const SearchArenaAllocator<U>& other) const { return m_arena != other.m_arena; }
+
+    private:
+        template <typename U>
+        friend struct SearchArenaAllocator;
+
+        std::shared_ptr<SearchArena> m_arena;
+    };
+
+    // Creates an object in the arena, along with its shared_ptr control block.
+    template <typename T, typename... Args>
+    std::shared_ptr<T> AllocateInArena(const std::shared_ptr<SearchArena>& arena, Args&&... args)
+    {
+        return std::allocate_shared<T>(SearchArenaAllocator<T>{ arena }, std::forward<Args>(args)...);
+    }
+}
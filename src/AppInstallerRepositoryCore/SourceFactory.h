@@ -34,6 +34,15 @@ namespace AppInstaller::Repository
             return Update(details, progress);
         }
 
+        // Updates the source from the given details (may not change the details).
+        // This version is for updates that run detached from the operation that requested them, which may
+        // still have the source open. Any lengthy work should be done before waiting for exclusive access.
+        // Return value indicates whether the action completed.
+        virtual bool DetachedUpdate(const SourceDetails& details, IProgressCallback& progress)
+        {
+            return Update(details, progress);
+        }
+
         // Removes the source from the given details.
         // Return value indicates whether the action completed.
         virtual bool Remove(const SourceDetails& details, IProgressCallback& progress) = 0;
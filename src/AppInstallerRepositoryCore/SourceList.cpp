@@ -195,6 +195,259 @@ namespace AppInstaller::Repository
         {
             return details.IsTombstone || details.Origin == SourceOrigin::Metadata || !details.IsVisible;
         }
+
+        // A copy of the parsed user sources and metadata, in memory shared by every process of the user in the session.
+        // It is tagged with the versions of the streams that it was read from, and is only used while the streams still have those versions.
+        // Group policy and the default sources are not part of it, as they are applied whenever the list is loaded.
+        //
+        // The shared memory begins with the header, which is followed by the data:
+        //  uint32_t UserSourceCount, then for each: string Name, Type, Arg, Data, Identifier; uint32_t IsTombstone
+        //  uint32_t MetadataCount, then for each: string Name; int64_t LastUpdate; string AcceptedAgreementsIdentifier; int32_t AcceptedAgreementFields
+        // where each string is a uint32_t length followed by the UTF-8 value.
+        struct SourceListCache
+        {
+            static SourceListCache& Instance()
+            {
+                static SourceListCache instance;
+                return instance;
+            }
+
+            // Reads the sources from the cache if it was published for the given versions.
+            bool TryRead(
+                const StreamVersion& userSourcesVersion,
+                const StreamVersion& metadataVersion,
+                std::vector<SourceDetailsInternal>& userSources,
+                std::vector<SourceDetailsInternal>& metadata)
+            {
+                if (!EnsureMapped(userSourcesVersion))
+                {
+                    return false;
+                }
+
+                try
+                {
+                    auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(m_lockName);
+
+                    const Header* header = static_cast<const Header*>(m_view.get());
+                    if (memcmp(header->Magic, s_Magic, sizeof(s_Magic)) != 0 ||
+                        header->FormatVersion != s_FormatVersion ||
+                        header->DataSize > s_Size - sizeof(Header) ||
+                        header->UserSourcesCounter != userSourcesVersion.Counter ||
+                        header->MetadataCounter != metadataVersion.Counter ||
+                        metadataVersion.Instance != userSourcesVersion.Instance)
+                    {
+                        return false;
+                    }
+
+                    Reader reader{ reinterpret_cast<const uint8_t*>(header + 1), header->DataSize };
+
+                    std::vector<SourceDetailsInternal> userSourcesResult;
+                    uint32_t count = 0;
+                    if (!reader.Read(count)) { return false; }
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        SourceDetailsInternal& details = userSourcesResult.emplace_back();
+                        uint32_t isTombstone = 0;
+                        if (!reader.Read(details.Name) || !reader.Read(details.Type) || !reader.Read(details.Arg) ||
+                            !reader.Read(details.Data) || !reader.Read(details.Identifier) || !reader.Read(isTombstone))
+                        {
+                            return false;
+                        }
+                        details.IsTombstone = (isTombstone != 0);
+                    }
+
+                    std::vector<SourceDetailsInternal> metadataResult;
+                    if (!reader.Read(count)) { return false; }
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        SourceDetailsInternal& details = metadataResult.emplace_back();
+                        details.Origin = SourceOrigin::Metadata;
+                        int64_t lastUpdateInEpoch = 0;
+                        if (!reader.Read(details.Name) || !reader.Read(lastUpdateInEpoch) ||
+                            !reader.Read(details.AcceptedAgreementsIdentifier) || !reader.Read(details.AcceptedAgreementFields))
+                        {
+                            return false;
+                        }
+                        details.LastUpdateTime = Utility::ConvertUnixEpochToSystemClock(lastUpdateInEpoch);
+                    }
+
+                    userSources = std::move(userSourcesResult);
+                    metadata = std::move(metadataResult);
+                    return true;
+                }
+                CATCH_LOG();
+
+                return false;
+            }
+
+            // Publishes the sources, which were read from streams that had the given versions before they were read.
+            // This is best effort; if another process is publishing or the sources do not fit, nothing is published.
+            void TryWrite(
+                const StreamVersion& userSourcesVersion,
+                const StreamVersion& metadataVersion,
+                const std::vector<SourceDetailsInternal>& userSources,
+                const std::vector<SourceDetailsInternal>& metadata)
+            {
+                if (!EnsureMapped(userSourcesVersion) || metadataVersion.Instance != userSourcesVersion.Instance)
+                {
+                    return;
+                }
+
+                try
+                {
+                    std::string data;
+                    Write(data, static_cast<uint32_t>(userSources.size()));
+                    for (const auto& details : userSources)
+                    {
+                        WriteString(data, details.Name);
+                        WriteString(data, details.Type);
+                        WriteString(data, details.Arg);
+                        WriteString(data, details.Data);
+                        WriteString(data, details.Identifier);
+                        Write(data, static_cast<uint32_t>(details.IsTombstone ? 1 : 0));
+                    }
+
+                    Write(data, static_cast<uint32_t>(metadata.size()));
+                    for (const auto& details : metadata)
+                    {
+                        WriteString(data, details.Name);
+                        Write(data, Utility::ConvertSystemClockToUnixEpoch(details.LastUpdateTime));
+                        WriteString(data, details.AcceptedAgreementsIdentifier);
+                        Write(data, static_cast<int32_t>(details.AcceptedAgreementFields));
+                    }
+
+                    if (data.size() > s_Size - sizeof(Header))
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Source list is too large for the shared cache");
+                        return;
+                    }
+
+                    auto lock = Synchronization::CrossProcessReaderWriteLock::LockExclusive(m_lockName, 0ms);
+                    if (!lock)
+                    {
+                        return;
+                    }
+
+                    Header* header = static_cast<Header*>(m_view.get());
+
+                    // Invalidate the header while the data is written, in case this process ends part way through.
+                    memset(header->Magic, 0, sizeof(header->Magic));
+                    memcpy(header + 1, data.data(), data.size());
+                    header->FormatVersion = s_FormatVersion;
+                    header->DataSize = static_cast<uint32_t>(data.size());
+                    header->UserSourcesCounter = userSourcesVersion.Counter;
+                    header->MetadataCounter = metadataVersion.Counter;
+                    memcpy(header->Magic, s_Magic, sizeof(s_Magic));
+                }
+                CATCH_LOG();
+            }
+
+        private:
+            static constexpr char s_Magic[8] = { 'W', 'G', 'S', 'R', 'C', 'L', 'S', 'T' };
+            static constexpr uint32_t s_FormatVersion = 1;
+            static constexpr size_t s_Size = 64 * 1024;
+
+            struct Header
+            {
+                char Magic[8];
+                uint32_t FormatVersion;
+                uint32_t DataSize;
+                uint64_t UserSourcesCounter;
+                uint64_t MetadataCounter;
+            };
+
+            struct Reader
+            {
+                Reader(const uint8_t* data, size_t size) : m_current(data), m_end(data + size) {}
+
+                template <typename T>
+                bool Read(T& value)
+                {
+                    static_assert(std::is_integral_v<T>);
+                    if (static_cast<size_t>(m_end - m_current) < sizeof(T)) { return false; }
+                    memcpy(&value, m_current, sizeof(T));
+                    m_current += sizeof(T);
+                    return true;
+                }
+
+                bool Read(std::string& value)
+                {
+                    uint32_t size = 0;
+                    if (!Read(size) || static_cast<size_t>(m_end - m_current) < size) { return false; }
+                    value.assign(reinterpret_cast<const char*>(m_current), size);
+                    m_current += size;
+                    return true;
+                }
+
+            private:
+                const uint8_t* m_current;
+                const uint8_t* m_end;
+            };
+
+            template <typename T>
+            static void Write(std::string& data, T value)
+            {
+                static_assert(std::is_integral_v<T>);
+                data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            static void WriteString(std::string& data, std::string_view value)
+            {
+                Write(data, static_cast<uint32_t>(value.size()));
+                data.append(value);
+            }
+
+            // Maps the cache for the instance of the stream counters that the version is from.
+            // The counters restart with a new instance, so the cache is separate for each one.
+            bool EnsureMapped(const StreamVersion& version)
+            {
+                if (!version.IsAvailable())
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock{ m_mappingLock };
+
+                if (m_instance == version.Instance)
+                {
+                    return static_cast<bool>(m_view);
+                }
+
+                m_view.reset();
+                m_mapping.reset();
+                m_instance = version.Instance;
+
+                try
+                {
+                    std::ostringstream suffix;
+                    suffix << std::hex << std::setw(16) << std::setfill('0') << version.Instance;
+
+                    std::wstring mappingName = L"Local\\WinGetSourceListCache_" + Utility::ConvertToUTF16(suffix.str());
+                    m_mapping.reset(CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(s_Size), mappingName.c_str()));
+                    THROW_LAST_ERROR_IF(!m_mapping);
+
+                    m_view.reset(MapViewOfFile(m_mapping.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, s_Size));
+                    THROW_LAST_ERROR_IF(!m_view);
+
+                    m_lockName = "WinGetSourceListCache_" + suffix.str();
+                    return true;
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    m_view.reset();
+                    m_mapping.reset();
+                }
+
+                return false;
+            }
+
+            std::mutex m_mappingLock;
+            uint64_t m_instance = 0;
+            wil::unique_handle m_mapping;
+            wil::unique_mapview_ptr<void> m_view;
+            std::string m_lockName;
+        };
     }
 
     void SourceDetailsInternal::CopyMetadataFieldsTo(SourceDetailsInternal& target)
@@ -297,8 +550,24 @@ namespace AppInstaller::Repository
 
     SourceList::SourceList() : m_userSourcesStream(Stream::UserSources), m_metadataStream(Stream::SourcesMetadata)
     {
-        OverwriteSourceList();
-        OverwriteMetadata();
+        // The versions are read before the streams, so that a change made while reading them leaves the published copy out of date rather than wrong.
+        StreamVersion userSourcesVersion = m_userSourcesStream.GetVersion();
+        StreamVersion metadataVersion = m_metadataStream.GetVersion();
+
+        std::vector<SourceDetailsInternal> userSources;
+        std::vector<SourceDetailsInternal> metadata;
+
+        m_isFromCache = SourceListCache::Instance().TryRead(userSourcesVersion, metadataVersion, userSources, metadata);
+
+        if (!m_isFromCache)
+        {
+            userSources = GetUserSources();
+            metadata = GetMetadata();
+            SourceListCache::Instance().TryWrite(userSourcesVersion, metadataVersion, userSources, metadata);
+        }
+
+        OverwriteSourceList(std::move(userSources));
+        OverwriteMetadata(std::move(metadata));
     }
 
     std::vector<std::reference_wrapper<SourceDetailsInternal>> SourceList::GetCurrentSourceRefs()
@@ -344,6 +613,8 @@ namespace AppInstaller::Repository
 
     void SourceList::AddSource(const SourceDetailsInternal& details)
     {
+        ReloadIfFromCache();
+
         bool sourcesSet = false;
 
         for (size_t i = 0; !sourcesSet && i < 10; ++i)
@@ -379,6 +650,8 @@ namespace AppInstaller::Repository
         // Copy the incoming details because we might destroy the referenced structure
         // when reloading the source details from settings.
         SourceDetailsInternal details = detailsRef;
+        ReloadIfFromCache();
+
         bool sourcesSet = false;
 
         for (size_t i = 0; !sourcesSet && i < 10; ++i)
@@ -489,12 +762,30 @@ namespace AppInstaller::Repository
     }
 
     void SourceList::OverwriteSourceList()
+    {
+        OverwriteSourceList(GetUserSources());
+    }
+
+    void SourceList::OverwriteSourceList(std::vector<SourceDetailsInternal> userSources)
     {
         m_sourceList.clear();
 
         for (SourceOrigin origin : { SourceOrigin::GroupPolicy, SourceOrigin::User, SourceOrigin::Default })
         {
-            auto forOrigin = GetSourcesByOrigin(origin);
+            std::vector<SourceDetailsInternal> forOrigin;
+
+            if (origin == SourceOrigin::User)
+            {
+                forOrigin = FilterUserSources(std::move(userSources));
+                for (auto& source : forOrigin)
+                {
+                    source.Origin = origin;
+                }
+            }
+            else
+            {
+                forOrigin = GetSourcesByOrigin(origin);
+            }
 
             for (auto&& source : forOrigin)
             {
@@ -515,7 +806,11 @@ namespace AppInstaller::Repository
 
     void SourceList::OverwriteMetadata()
     {
-        auto metadata = GetMetadata();
+        OverwriteMetadata(GetMetadata());
+    }
+
+    void SourceList::OverwriteMetadata(std::vector<SourceDetailsInternal> metadata)
+    {
         for (auto& metaSource : metadata)
         {
             auto source = GetSource(metaSource.Name);
@@ -530,6 +825,16 @@ namespace AppInstaller::Repository
         }
     }
 
+    void SourceList::ReloadIfFromCache()
+    {
+        if (m_isFromCache)
+        {
+            OverwriteSourceList();
+            OverwriteMetadata();
+            m_isFromCache = false;
+        }
+    }
+
     // Gets the sources from a particular origin.
     std::vector<SourceDetailsInternal> SourceList::GetSourcesByOrigin(SourceOrigin origin)
     {
@@ -555,35 +860,8 @@ namespace AppInstaller::Repository
         }
         break;
         case SourceOrigin::User:
-        {
-            std::vector<SourceDetailsInternal> userSources = GetSourcesFromSetting(
-                m_userSourcesStream,
-                s_SourcesYaml_Sources,
-                [&](SourceDetailsInternal& details, const std::string& settingValue, const YAML::Node& source)
-                {
-                    std::string_view name = m_userSourcesStream.GetName();
-                    if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Name, details.Name)) { return false; }
-                    if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Type, details.Type)) { return false; }
-                    if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Arg, details.Arg)) { return false; }
-                    if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Data, details.Data)) { return false; }
-                    if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_IsTombstone, details.IsTombstone)) { return false; }
-                    TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Identifier, details.Identifier, false);
-                    return true;
-                });
-
-            for (auto& source : userSources)
-            {
-                // Check source against list of allowed sources and drop tombstones for required sources
-                if (!IsUserSourceAllowedByPolicy(source.Name, source.Type, source.Arg, source.IsTombstone))
-                {
-                    AICLI_LOG(Repo, Warning, << "User source " << source.Name << " dropped because of group policy");
-                    continue;
-                }
-
-                result.emplace_back(std::move(source));
-            }
-        }
-        break;
+            result = FilterUserSources(GetUserSources());
+            break;
         case SourceOrigin::GroupPolicy:
         {
             if (GroupPolicies().GetState(TogglePolicy::Policy::AdditionalSources) == PolicyState::Enabled)
@@ -619,6 +897,43 @@ namespace AppInstaller::Repository
         return result;
     }
 
+    std::vector<SourceDetailsInternal> SourceList::GetUserSources()
+    {
+        return GetSourcesFromSetting(
+            m_userSourcesStream,
+            s_SourcesYaml_Sources,
+            [&](SourceDetailsInternal& details, const std::string& settingValue, const YAML::Node& source)
+            {
+                std::string_view name = m_userSourcesStream.GetName();
+                if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Name, details.Name)) { return false; }
+                if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Type, details.Type)) { return false; }
+                if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Arg, details.Arg)) { return false; }
+                if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Data, details.Data)) { return false; }
+                if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_IsTombstone, details.IsTombstone)) { return false; }
+                TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Identifier, details.Identifier, false);
+                return true;
+            });
+    }
+
+    std::vector<SourceDetailsInternal> SourceList::FilterUserSources(std::vector<SourceDetailsInternal> userSources)
+    {
+        std::vector<SourceDetailsInternal> result;
+
+        for (auto& source : userSources)
+        {
+            // Check source against list of allowed sources and drop tombstones for required sources
+            if (!IsUserSourceAllowedByPolicy(source.Name, source.Type, source.Arg, source.IsTombstone))
+            {
+                AICLI_LOG(Repo, Warning, << "User source " << source.Name << " dropped because of group policy");
+                continue;
+            }
+
+            result.emplace_back(std::move(source));
+        }
+
+        return result;
+    }
+
     bool SourceList::SetSourcesByOrigin(SourceOrigin origin, const std::vector<SourceDetailsInternal>& sources)
     {
         switch (origin)
@@ -677,6 +992,25 @@ namespace AppInstaller::Repository
         // Copy the incoming details because we might overwrite the metadata
         // when reloading the source details from settings.
         SourceDetailsInternal details = detailsRef;
+
+        if (m_isFromCache)
+        {
+            ReloadIfFromCache();
+
+            auto target = FindSource(details.Name, true);
+            if (target != m_sourceList.end())
+            {
+                if (remove)
+                {
+                    m_sourceList.erase(target);
+                }
+                else
+                {
+                    details.CopyMetadataFieldsTo(*target);
+                }
+            }
+        }
+
         bool metadataSet = false;
 
         for (size_t i = 0; !metadataSet && i < 10; ++i)
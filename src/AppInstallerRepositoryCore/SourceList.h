@@ -72,14 +72,26 @@ namespace AppInstaller::Repository
     private:
         // Overwrites the source list with all sources.
         void OverwriteSourceList();
+        // Overwrites the source list with all sources, using the given (unfiltered) user sources.
+        void OverwriteSourceList(std::vector<SourceDetailsInternal> userSources);
 
         // Overwrites the source list with the current metadata.
         void OverwriteMetadata();
+        // Overwrites the source list with the given metadata.
+        void OverwriteMetadata(std::vector<SourceDetailsInternal> metadata);
+
+        // If the list was loaded from the shared cache, reloads it from the settings streams.
+        // Must be called before writing to the streams, as only reading them allows a write to detect a change made by another process.
+        void ReloadIfFromCache();
 
         // calls std::find_if and return the iterator.
         auto FindSource(std::string_view name, bool includeHidden = false);
 
         std::vector<SourceDetailsInternal> GetSourcesByOrigin(SourceOrigin origin);
+        // Gets the user sources from the settings stream, before any policy is applied.
+        std::vector<SourceDetailsInternal> GetUserSources();
+        // Gets the user sources that are allowed by policy.
+        static std::vector<SourceDetailsInternal> FilterUserSources(std::vector<SourceDetailsInternal> userSources);
         // Does *NOT* set metadata; call SaveMetadataInternal afterward.
         [[nodiscard]] bool SetSourcesByOrigin(SourceOrigin origin, const std::vector<SourceDetailsInternal>& sources);
 
@@ -93,5 +105,6 @@ namespace AppInstaller::Repository
         std::vector<SourceDetailsInternal> m_sourceList;
         Settings::Stream m_userSourcesStream;
         Settings::Stream m_metadataStream;
+        bool m_isFromCache = false;
     };
 }
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/UpgradeSnapshot.h"
+#include "Public/winget/ARPKeySnapshot.h"
+#include "Microsoft/PreIndexedPackageSourceFactory.h"
+#include <AppInstallerDateTime.h>
+#include <AppInstallerSHA256.h>
+#include <winget/Settings.h>
+#include <winget/Yaml.h>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        // The version must be incremented whenever the format or the meaning of the stored values changes.
+        constexpr int s_UpgradeSnapshotVersion = 1;
+
+        constexpr std::string_view s_UpgradeSnapshotYaml_Version = "Version"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_InstalledFingerprint = "InstalledFingerprint"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_SourcesFingerprint = "SourcesFingerprint"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_Upgrades = "Upgrades"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_Upgrade_Name = "Name"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_Upgrade_Id = "Id"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_Upgrade_InstalledVersion = "InstalledVersion"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_Upgrade_AvailableVersion = "AvailableVersion"sv;
+        constexpr std::string_view s_UpgradeSnapshotYaml_Upgrade_Source = "Source"sv;
+
+        void AddToHash(Utility::SHA256& hash, std::string_view value)
+        {
+            hash.Add(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+            hash.Add(reinterpret_cast<const uint8_t*>("\n"), 1);
+        }
+
+        // Gets a fingerprint of the MSIX packages of the user from their full names, which include the version.
+        std::string GetMSIXFingerprint()
+        {
+            using namespace winrt::Windows::Management::Deployment;
+
+            // Sorted, as the packages are not returned in any particular order.
+            std::vector<std::string> fullNames;
+
+            PackageManager packageManager;
+            for (const auto& package : packageManager.FindPackagesForUserWithPackageTypes({}, PackageTypes::Main))
+            {
+                fullNames.emplace_back(Utility::ConvertToUTF8(package.Id().FullName()));
+            }
+
+            std::sort(fullNames.begin(), fullNames.end());
+
+            Utility::SHA256 hash;
+            for (const auto& fullName : fullNames)
+            {
+                AddToHash(hash, fullName);
+            }
+
+            return Utility::SHA256::ConvertToString(hash.Get());
+        }
+    }
+
+    std::string UpgradeSnapshot::GetInstalledFingerprint() try
+    {
+        auto arpSnapshot = ARPKeySnapshot::TryCreate();
+        if (!arpSnapshot)
+        {
+            return {};
+        }
+
+        std::string result = arpSnapshot->GetFingerprint();
+        result += '|';
+        result += GetMSIXFingerprint();
+        return result;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        AICLI_LOG(Repo, Warning, << "Failed to create a fingerprint of the installed packages");
+        return {};
+    }
+
+    std::string UpgradeSnapshot::GetSourcesFingerprint(const Source& source)
+    {
+        std::vector<Source> sources;
+        if (source.IsComposite())
+        {
+            sources = source.GetAvailableSources();
+        }
+        else
+        {
+            sources.emplace_back(source);
+        }
+
+        if (sources.empty())
+        {
+            return {};
+        }
+
+        Utility::SHA256 hash;
+
+        for (const auto& availableSource : sources)
+        {
+            SourceDetails details = availableSource.GetDetails();
+
+            // Only the data of a pre-indexed source is fixed between its updates.
+            if (details.Type != Microsoft::PreIndexedPackageSourceFactory::Type())
+            {
+                AICLI_LOG(Repo, Verbose, << "Source '" << details.Name << "' of type " << details.Type << " cannot be part of an upgrade snapshot");
+                return {};
+            }
+
+            AddToHash(hash, details.Name);
+            AddToHash(hash, details.Identifier);
+            AddToHash(hash, details.Arg);
+            AddToHash(hash, std::to_string(Utility::ConvertSystemClockToUnixEpoch(details.LastUpdateTime)));
+        }
+
+        return Utility::SHA256::ConvertToString(hash.Get());
+    }
+
+    bool UpgradeSnapshot::IsCurrent(const std::string& installedFingerprint, const std::string& sourcesFingerprint) const
+    {
+        return !installedFingerprint.empty() && !sourcesFingerprint.empty() &&
+            InstalledFingerprint == installedFingerprint && SourcesFingerprint == sourcesFingerprint;
+    }
+
+    std::optional<UpgradeSnapshot> UpgradeSnapshot::Load() try
+    {
+        Settings::Stream stream{ Settings::Stream::UpgradeSnapshot };
+        auto in = stream.Get();
+        if (!in)
+        {
+            return {};
+        }
+
+        YAML::Node document = YAML::Load(Utility::ReadEntireStream(*in));
+
+        const auto& version = document[s_UpgradeSnapshotYaml_Version];
+        if (!version.IsScalar() || version.as<int>() != s_UpgradeSnapshotVersion)
+        {
+            AICLI_LOG(Repo, Info, << "Upgrade snapshot is from a different version and will be ignored");
+            return {};
+        }
+
+        UpgradeSnapshot result;
+        result.InstalledFingerprint = document[s_UpgradeSnapshotYaml_InstalledFingerprint].as<std::string>();
+        result.SourcesFingerprint = document[s_UpgradeSnapshotYaml_SourcesFingerprint].as<std::string>();
+
+        const auto& upgrades = document[s_UpgradeSnapshotYaml_Upgrades];
+        if (upgrades.IsSequence())
+        {
+            for (const auto& upgrade : upgrades.Sequence())
+            {
+                Entry entry;
+                entry.Name = upgrade[s_UpgradeSnapshotYaml_Upgrade_Name].as<std::string>();
+                entry.Id = upgrade[s_UpgradeSnapshotYaml_Upgrade_Id].as<std::string>();
+                entry.InstalledVersion = upgrade[s_UpgradeSnapshotYaml_Upgrade_InstalledVersion].as<std::string>();
+                entry.AvailableVersion = upgrade[s_UpgradeSnapshotYaml_Upgrade_AvailableVersion].as<std::string>();
+                entry.SourceName = upgrade[s_UpgradeSnapshotYaml_Upgrade_Source].as<std::string>();
+                result.Entries.emplace_back(std::move(entry));
+            }
+        }
+
+        return result;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        AICLI_LOG(Repo, Warning, << "Failed to read the upgrade snapshot");
+        return {};
+    }
+
+    void UpgradeSnapshot::Save() const try
+    {
+        YAML::Emitter out;
+        out << YAML::BeginMap;
+        out << YAML::Key << s_UpgradeSnapshotYaml_Version << YAML::Value << s_UpgradeSnapshotVersion;
+        out << YAML::Key << s_UpgradeSnapshotYaml_InstalledFingerprint << YAML::Value << InstalledFingerprint;
+        out << YAML::Key << s_UpgradeSnapshotYaml_SourcesFingerprint << YAML::Value << SourcesFingerprint;
+        out << YAML::Key << s_UpgradeSnapshotYaml_Upgrades;
+        out << YAML::BeginSeq;
+
+        for (const auto& entry : Entries)
+        {
+            out << YAML::BeginMap;
+            out << YAML::Key << s_UpgradeSnapshotYaml_Upgrade_Name << YAML::Value << entry.Name;
+            out << YAML::Key << s_UpgradeSnapshotYaml_Upgrade_Id << YAML::Value << entry.Id;
+            out << YAML::Key << s_UpgradeSnapshotYaml_Upgrade_InstalledVersion << YAML::Value << entry.InstalledVersion;
+            out << YAML::Key << s_UpgradeSnapshotYaml_Upgrade_AvailableVersion << YAML::Value << entry.AvailableVersion;
+            out << YAML::Key << s_UpgradeSnapshotYaml_Upgrade_Source << YAML::Value << entry.SourceName;
+            out << YAML::EndMap;
+        }
+
+        out << YAML::EndSeq;
+        out << YAML::EndMap;
+
+        // The snapshot is replaced as a whole, so it does not matter if another process wrote one in the meantime.
+        (void)Settings::Stream{ Settings::Stream::UpgradeSnapshot }.Set(out.str());
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        AICLI_LOG(Repo, Warning, << "Failed to save the upgrade snapshot");
+    }
+}
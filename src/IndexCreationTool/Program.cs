@@ -4,6 +4,7 @@
 namespace IndexCreationTool
 {
     using System;
+    using System.Collections.Generic;
     using System.Diagnostics;
     using System.IO;
 
@@ -18,6 +19,8 @@ namespace IndexCreationTool
             string rootDir = string.Empty;
             string appxManifestPath = string.Empty;
             string certPath = string.Empty;
+            string diffPath = string.Empty;
+            string workingIndexPath = string.Empty;
 
             for (int i = 0; i < args.Length; i++)
             {
@@ -33,11 +36,19 @@ namespace IndexCreationTool
                 {
                     certPath = args[i];
                 }
+                else if (args[i] == "-i" && ++i < args.Length)
+                {
+                    workingIndexPath = args[i];
+                }
+                else if (args[i] == "-g" && ++i < args.Length)
+                {
+                    diffPath = args[i];
+                }
             }
 
             if (string.IsNullOrEmpty(rootDir))
             {
-                Console.WriteLine("Usage: IndexCreationTool.exe -d <Path to search for yaml> [-m <appxmanifest for index package> [-c <cert for signing index package>]]");
+                Console.WriteLine("Usage: IndexCreationTool.exe -d <Path to search for yaml> [-i <working index kept between runs> [-g <output of git diff --name-status --relative run in the search path>]] [-m <appxmanifest for index package> [-c <cert for signing index package>]]");
                 return;
             }
 
@@ -48,12 +59,35 @@ namespace IndexCreationTool
                     File.Delete(IndexName);
                 }
 
-                using (var indexHelper = WinGetUtilWrapper.Create(IndexName))
+                if (string.IsNullOrEmpty(workingIndexPath))
+                {
+                    CreateIndex(IndexName, rootDir);
+                }
+                else
                 {
-                    foreach (string file in Directory.EnumerateFiles(rootDir, "*.yaml", SearchOption.AllDirectories))
+                    // The working index is never prepared for packaging, so that it can be updated with only the manifests that changed.
+                    if (!string.IsNullOrEmpty(diffPath) && File.Exists(workingIndexPath))
                     {
-                        indexHelper.AddManifest(file, Path.GetRelativePath(rootDir, file));
+                        using (var indexHelper = WinGetUtilWrapper.Open(workingIndexPath))
+                        {
+                            ApplyDiff(indexHelper, rootDir, diffPath);
+                        }
                     }
+                    else
+                    {
+                        if (File.Exists(workingIndexPath))
+                        {
+                            File.Delete(workingIndexPath);
+                        }
+
+                        CreateIndex(workingIndexPath, rootDir);
+                    }
+
+                    File.Copy(workingIndexPath, IndexName);
+                }
+
+                using (var indexHelper = WinGetUtilWrapper.Open(IndexName))
+                {
                     indexHelper.PrepareForPackaging();
                 }
 
@@ -81,6 +115,76 @@ namespace IndexCreationTool
             Environment.Exit(0);
         }
 
+        static void CreateIndex(string indexPath, string rootDir)
+        {
+            using (var indexHelper = WinGetUtilWrapper.Create(indexPath))
+            {
+                List<string> manifestPaths = new List<string>();
+                List<string> relativePaths = new List<string>();
+                foreach (string file in Directory.EnumerateFiles(rootDir, "*.yaml", SearchOption.AllDirectories))
+                {
+                    manifestPaths.Add(file);
+                    relativePaths.Add(Path.GetRelativePath(rootDir, file));
+                }
+                indexHelper.AddManifests(manifestPaths, relativePaths);
+            }
+        }
+
+        static void ApplyDiff(WinGetUtilWrapper indexHelper, string rootDir, string diffPath)
+        {
+            var changeTypes = new List<WinGetUtilWrapper.ManifestChangeType>();
+            var manifestPaths = new List<string>();
+            var relativePaths = new List<string>();
+
+            void AddChange(WinGetUtilWrapper.ManifestChangeType type, string relativePath)
+            {
+                if (relativePath.EndsWith(".yaml", StringComparison.OrdinalIgnoreCase))
+                {
+                    changeTypes.Add(type);
+                    manifestPaths.Add(Path.Combine(rootDir, relativePath));
+                    relativePaths.Add(relativePath);
+                }
+            }
+
+            // Each line is the status, then the path; renames and copies have a score after the status and both the old and new paths.
+            foreach (string line in File.ReadAllLines(diffPath))
+            {
+                string[] parts = line.Split('\t');
+                if (parts.Length < 2 || parts[0].Length == 0)
+                {
+                    continue;
+                }
+
+                switch (parts[0][0])
+                {
+                    case 'A':
+                        AddChange(WinGetUtilWrapper.ManifestChangeType.Added, parts[1]);
+                        break;
+                    case 'M':
+                        AddChange(WinGetUtilWrapper.ManifestChangeType.Modified, parts[1]);
+                        break;
+                    case 'D':
+                        AddChange(WinGetUtilWrapper.ManifestChangeType.Removed, parts[1]);
+                        break;
+                    case 'R':
+                        if (parts.Length >= 3)
+                        {
+                            AddChange(WinGetUtilWrapper.ManifestChangeType.Removed, parts[1]);
+                            AddChange(WinGetUtilWrapper.ManifestChangeType.Added, parts[2]);
+                        }
+                        break;
+                    case 'C':
+                        if (parts.Length >= 3)
+                        {
+                            AddChange(WinGetUtilWrapper.ManifestChangeType.Added, parts[2]);
+                        }
+                        break;
+                }
+            }
+
+            indexHelper.ApplyManifestChanges(changeTypes, manifestPaths, relativePaths);
+        }
+
         static void RunCommand(string command, string args)
         {
             Process p = new Process();
@@ -4,6 +4,8 @@
 namespace IndexCreationTool
 {
     using System;
+    using System.Collections.Generic;
+    using System.Linq;
     using System.Runtime.InteropServices;
 
     /// <summary>
@@ -18,6 +20,27 @@ namespace IndexCreationTool
 
         private const uint LatestVersion = unchecked((uint)-1);
 
+        /// <summary>
+        /// The type of change made to a manifest file in the repository.
+        /// </summary>
+        public enum ManifestChangeType
+        {
+            /// <summary>
+            /// The manifest was added.
+            /// </summary>
+            Added = 0,
+
+            /// <summary>
+            /// The manifest was modified.
+            /// </summary>
+            Modified = 1,
+
+            /// <summary>
+            /// The manifest was removed.
+            /// </summary>
+            Removed = 2,
+        }
+
         private IntPtr indexHandle;
 
         /// <summary>
@@ -91,6 +114,54 @@ namespace IndexCreationTool
             }
         }
 
+        /// <summary>
+        /// Adds a set of manifests to the index in a single operation.
+        /// </summary>
+        /// <param name="manifestPaths">Manifests to add.</param>
+        /// <param name="relativePaths">Paths of the manifests in the repository, in the same order.</param>
+        public void AddManifests(IList<string> manifestPaths, IList<string> relativePaths)
+        {
+            try
+            {
+                Console.WriteLine($"Adding {manifestPaths.Count} manifests on index file.");
+                WinGetSQLiteIndexAddManifests(this.indexHandle, manifestPaths.ToArray(), relativePaths.ToArray(), (uint)manifestPaths.Count);
+                return;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to add {manifestPaths.Count} manifests. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Applies a set of changes to the manifest files in the repository to the index in a single operation.
+        /// </summary>
+        /// <param name="changeTypes">Types of the changes.</param>
+        /// <param name="manifestPaths">Manifests to read, in the same order; ignored for removed manifests.</param>
+        /// <param name="relativePaths">Paths of the manifests in the repository, in the same order.</param>
+        /// <returns>True if index was modified.</returns>
+        public bool ApplyManifestChanges(IList<ManifestChangeType> changeTypes, IList<string> manifestPaths, IList<string> relativePaths)
+        {
+            try
+            {
+                Console.WriteLine($"Applying {changeTypes.Count} manifest changes on index file.");
+                WinGetSQLiteIndexApplyManifestChanges(
+                    this.indexHandle,
+                    changeTypes.Select(t => (int)t).ToArray(),
+                    manifestPaths.ToArray(),
+                    relativePaths.ToArray(),
+                    (uint)changeTypes.Count,
+                    out bool indexModified);
+                return indexModified;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to apply {changeTypes.Count} manifest changes. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
         /// <summary>
         /// Updates manifest in the index.
         /// </summary>
@@ -227,6 +298,42 @@ namespace IndexCreationTool
         [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
         private static extern IntPtr WinGetSQLiteIndexAddManifest(IntPtr index, string manifestPath, string relativePath);
 
+        /// <summary>
+        /// Adds the manifests at the repository relative paths to the index.
+        /// If the function succeeds, all of the manifests have been added; otherwise none have.
+        /// </summary>
+        /// <param name="index">Handle of the index.</param>
+        /// <param name="manifestPaths">Manifests to add.</param>
+        /// <param name="relativePaths">Paths of the manifests in the container.</param>
+        /// <param name="count">Number of manifests.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexAddManifests(
+            IntPtr index,
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] manifestPaths,
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] relativePaths,
+            uint count);
+
+        /// <summary>
+        /// Applies the changes made to the manifest files in the repository to the index.
+        /// If the function succeeds, all of the changes have been made; otherwise none have.
+        /// </summary>
+        /// <param name="index">Handle of the index.</param>
+        /// <param name="changeTypes">Types of the changes.</param>
+        /// <param name="manifestPaths">Manifests to read; may be null for removed manifests.</param>
+        /// <param name="relativePaths">Paths of the manifests in the container.</param>
+        /// <param name="count">Number of changes.</param>
+        /// <param name="indexModified">Out bool if the index is modified.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexApplyManifestChanges(
+            IntPtr index,
+            int[] changeTypes,
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] manifestPaths,
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] relativePaths,
+            uint count,
+            [MarshalAs(UnmanagedType.Bool)] out bool indexModified);
+
         /// <summary>
         /// Updates the manifest at the repository relative path in the index.
         /// The out value indicates whether the index was modified by the function.
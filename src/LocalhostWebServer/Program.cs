@@ -22,13 +22,16 @@ namespace LocalhostWebServer
             Startup.CertPath = config.GetValue<string>("CertPath");
             Startup.CertPassword = config.GetValue<string>("CertPassword");
             Startup.Port = config.GetValue<Int32>("Port", 5001);
+            Startup.ResponseDelayMs = config.GetValue<Int32>("ResponseDelayMs", 0);
+            Startup.BytesPerSecond = config.GetValue<Int64>("BytesPerSecond", 0);
             
             if (string.IsNullOrEmpty(Startup.StaticFileRoot) || 
                 string.IsNullOrEmpty(Startup.CertPath) || 
                 string.IsNullOrEmpty(Startup.CertPassword))
             {
                 Console.WriteLine("Usage: LocalhostWebServer.exe StaticFileRoot=<Path to Serve Static Root Directory> " +
-                    "CertPath=<Path to HTTPS Developer Certificate> CertPassword=<Certificate Password> <Port=Port Number>");
+                    "CertPath=<Path to HTTPS Developer Certificate> CertPassword=<Certificate Password> <Port=Port Number> " +
+                    "<ResponseDelayMs=Delay Before Each Response> <BytesPerSecond=Bandwidth Of Each Response>");
                 return;
             }
 
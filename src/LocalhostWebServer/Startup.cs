@@ -23,6 +23,10 @@ namespace LocalhostWebServer
 
         public static int Port { get; set; }
 
+        public static int ResponseDelayMs { get; set; }
+
+        public static long BytesPerSecond { get; set; }
+
         public Startup(IConfiguration configuration)
         {
             Configuration = configuration;
@@ -44,6 +48,10 @@ namespace LocalhostWebServer
 
             app.UseHttpsRedirection();
 
+            ThrottlingMiddleware.DefaultDelayMs = ResponseDelayMs;
+            ThrottlingMiddleware.DefaultBytesPerSecond = BytesPerSecond;
+            app.UseMiddleware<ThrottlingMiddleware>();
+
             //Add .yaml and .msix mappings
             var provider = new FileExtensionContentTypeProvider();
             provider.Mappings[".yaml"] = "application/x-yaml";
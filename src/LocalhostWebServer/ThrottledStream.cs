@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace LocalhostWebServer
+{
+    using System;
+    using System.Diagnostics;
+    using System.IO;
+    using System.Threading;
+    using System.Threading.Tasks;
+
+    /// <summary>
+    /// A write only stream that passes the data to another at no more than the given rate.
+    /// </summary>
+    public class ThrottledStream : Stream
+    {
+        // The number of writes per second that the data is split into, to keep the rate smooth.
+        private const int WritesPerSecond = 20;
+
+        private readonly Stream inner;
+        private readonly long bytesPerSecond;
+        private readonly Stopwatch stopwatch = Stopwatch.StartNew();
+        private long written = 0;
+
+        public ThrottledStream(Stream inner, long bytesPerSecond)
+        {
+            this.inner = inner;
+            this.bytesPerSecond = bytesPerSecond;
+        }
+
+        public override bool CanRead => false;
+
+        public override bool CanSeek => false;
+
+        public override bool CanWrite => true;
+
+        public override long Length => throw new NotSupportedException();
+
+        public override long Position
+        {
+            get => throw new NotSupportedException();
+            set => throw new NotSupportedException();
+        }
+
+        public override void Flush()
+        {
+            this.inner.Flush();
+        }
+
+        public override Task FlushAsync(CancellationToken cancellationToken)
+        {
+            return this.inner.FlushAsync(cancellationToken);
+        }
+
+        public override int Read(byte[] buffer, int offset, int count)
+        {
+            throw new NotSupportedException();
+        }
+
+        public override long Seek(long offset, SeekOrigin origin)
+        {
+            throw new NotSupportedException();
+        }
+
+        public override void SetLength(long value)
+        {
+            throw new NotSupportedException();
+        }
+
+        public override void Write(byte[] buffer, int offset, int count)
+        {
+            this.WriteAsync(buffer, offset, count, CancellationToken.None).GetAwaiter().GetResult();
+        }
+
+        public override Task WriteAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken)
+        {
+            return this.WriteAsync(new ReadOnlyMemory<byte>(buffer, offset, count), cancellationToken).AsTask();
+        }
+
+        public override async ValueTask WriteAsync(ReadOnlyMemory<byte> buffer, CancellationToken cancellationToken = default)
+        {
+            int chunkSize = (int)Math.Clamp(this.bytesPerSecond / WritesPerSecond, 1, int.MaxValue);
+
+            while (!buffer.IsEmpty)
+            {
+                var chunk = buffer.Slice(0, Math.Min(chunkSize, buffer.Length));
+                await this.inner.WriteAsync(chunk, cancellationToken);
+                this.written += chunk.Length;
+                buffer = buffer.Slice(chunk.Length);
+
+                var ahead = TimeSpan.FromSeconds((double)this.written / this.bytesPerSecond) - this.stopwatch.Elapsed;
+                if (ahead > TimeSpan.Zero)
+                {
+                    await Task.Delay(ahead, cancellationToken);
+                }
+            }
+        }
+    }
+}
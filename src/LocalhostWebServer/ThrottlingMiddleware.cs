@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace LocalhostWebServer
+{
+    using Microsoft.AspNetCore.Http;
+    using System;
+    using System.Threading.Tasks;
+
+    /// <summary>
+    /// Delays the start of responses and limits their bandwidth, so that downloads can be measured under network conditions.
+    /// The defaults come from the command line; a request can override them with the delayMs and bytesPerSecond query parameters.
+    /// </summary>
+    public class ThrottlingMiddleware
+    {
+        private readonly RequestDelegate next;
+
+        public ThrottlingMiddleware(RequestDelegate next)
+        {
+            this.next = next;
+        }
+
+        public static int DefaultDelayMs { get; set; }
+
+        public static long DefaultBytesPerSecond { get; set; }
+
+        public async Task InvokeAsync(HttpContext context)
+        {
+            int delayMs = (int)GetQueryValue(context, "delayMs", DefaultDelayMs);
+            long bytesPerSecond = GetQueryValue(context, "bytesPerSecond", DefaultBytesPerSecond);
+
+            if (delayMs > 0)
+            {
+                await Task.Delay(delayMs);
+            }
+
+            if (bytesPerSecond <= 0)
+            {
+                await this.next(context);
+                return;
+            }
+
+            var originalBody = context.Response.Body;
+            await using var throttledBody = new ThrottledStream(originalBody, bytesPerSecond);
+            context.Response.Body = throttledBody;
+
+            try
+            {
+                await this.next(context);
+            }
+            finally
+            {
+                context.Response.Body = originalBody;
+            }
+        }
+
+        private static long GetQueryValue(HttpContext context, string name, long defaultValue)
+        {
+            if (context.Request.Query.TryGetValue(name, out var value) && long.TryParse(value, out long result))
+            {
+                return result;
+            }
+
+            return defaultValue;
+        }
+    }
+}
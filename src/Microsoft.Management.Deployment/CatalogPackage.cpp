@@ -21,11 +21,21 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     }
     hstring CatalogPackage::Id()
     {
-        return winrt::to_hstring(m_package->GetProperty(::AppInstaller::Repository::PackageProperty::Id).get());
+        std::call_once(m_idOnceFlag,
+            [&]()
+            {
+                m_id = winrt::to_hstring(m_package->GetProperty(::AppInstaller::Repository::PackageProperty::Id).get());
+            });
+        return m_id;
     }
     hstring CatalogPackage::Name()
     {
-        return winrt::to_hstring(m_package->GetProperty(::AppInstaller::Repository::PackageProperty::Name));
+        std::call_once(m_nameOnceFlag,
+            [&]()
+            {
+                m_name = winrt::to_hstring(m_package->GetProperty(::AppInstaller::Repository::PackageProperty::Name));
+            });
+        return m_name;
     }
     Microsoft::Management::Deployment::PackageVersionInfo CatalogPackage::InstalledVersion()
     {
@@ -49,7 +59,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
             [&]()
             {
                 // Vector hasn't been populated yet.
-                for (auto const& versionKey : m_package.get()->GetAvailableVersionKeys())
+                for (auto const& versionKey : GetAvailableVersionKeys())
                 {
                     auto packageVersionId = winrt::make_self<wil::details::module_count_wrapper<
                         winrt::Microsoft::Management::Deployment::implementation::PackageVersionId>>();
@@ -94,7 +104,61 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     }
     bool CatalogPackage::IsUpdateAvailable()
     {
-        return m_package->IsUpdateAvailable();
+        std::call_once(m_isUpdateAvailableOnceFlag,
+            [&]()
+            {
+                m_isUpdateAvailable = m_package->IsUpdateAvailable();
+            });
+        return m_isUpdateAvailable;
+    }
+    uint32_t CatalogPackage::AvailableVersionCount()
+    {
+        return static_cast<uint32_t>(GetAvailableVersionKeys().size());
+    }
+    Windows::Foundation::Collections::IVectorView<Microsoft::Management::Deployment::PackageVersionId> CatalogPackage::GetAvailableVersions(uint32_t startIndex, uint32_t count)
+    {
+        const auto& versionKeys = GetAvailableVersionKeys();
+
+        auto result = winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::PackageVersionId>();
+        for (size_t i = startIndex; i < versionKeys.size() && i - startIndex < count; ++i)
+        {
+            auto packageVersionId = winrt::make_self<wil::details::module_count_wrapper<
+                winrt::Microsoft::Management::Deployment::implementation::PackageVersionId>>();
+            packageVersionId->Initialize(versionKeys[i]);
+            result.Append(*packageVersionId);
+        }
+        return result.GetView();
+    }
+    Microsoft::Management::Deployment::CatalogPackageSummary CatalogPackage::Summary()
+    {
+        // Built from the cached properties, so reading them individually afterwards is no more expensive.
+        Microsoft::Management::Deployment::CatalogPackageSummary summary{};
+        summary.Id = Id();
+        summary.Name = Name();
+
+        auto installedVersion = InstalledVersion();
+        if (installedVersion)
+        {
+            summary.InstalledVersion = installedVersion.Version();
+        }
+
+        auto defaultInstallVersion = DefaultInstallVersion();
+        if (defaultInstallVersion)
+        {
+            summary.DefaultInstallVersion = defaultInstallVersion.Version();
+        }
+
+        summary.IsUpdateAvailable = IsUpdateAvailable();
+        return summary;
+    }
+    const std::vector<::AppInstaller::Repository::PackageVersionKey>& CatalogPackage::GetAvailableVersionKeys()
+    {
+        std::call_once(m_availableVersionKeysOnceFlag,
+            [&]()
+            {
+                m_availableVersionKeys = m_package->GetAvailableVersionKeys();
+            });
+        return m_availableVersionKeys;
     }
     std::shared_ptr<::AppInstaller::Repository::IPackage> CatalogPackage::GetRepositoryPackage()
     {
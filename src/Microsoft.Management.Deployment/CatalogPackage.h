@@ -23,14 +23,29 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::PackageVersionInfo DefaultInstallVersion();
         winrt::Microsoft::Management::Deployment::PackageVersionInfo GetPackageVersionInfo(winrt::Microsoft::Management::Deployment::PackageVersionId const& versionKey);
         bool IsUpdateAvailable();
+        // Contract version 5
+        uint32_t AvailableVersionCount();
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::PackageVersionId> GetAvailableVersions(uint32_t startIndex, uint32_t count);
+        winrt::Microsoft::Management::Deployment::CatalogPackageSummary Summary();
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
+        // Gets the available version keys, reading them from the package the first time.
+        const std::vector<::AppInstaller::Repository::PackageVersionKey>& GetAvailableVersionKeys();
+
         ::AppInstaller::Repository::Source m_source;
         std::shared_ptr<::AppInstaller::Repository::IPackage> m_package;
+        hstring m_id;
+        hstring m_name;
+        bool m_isUpdateAvailable = false;
+        std::vector<::AppInstaller::Repository::PackageVersionKey> m_availableVersionKeys;
         Windows::Foundation::Collections::IVector<winrt::Microsoft::Management::Deployment::PackageVersionId> m_availableVersions{ winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::PackageVersionId>() };
         winrt::Microsoft::Management::Deployment::PackageVersionInfo m_installedVersion{ nullptr };
         winrt::Microsoft::Management::Deployment::PackageVersionInfo m_defaultInstallVersion{ nullptr };
+        std::once_flag m_idOnceFlag;
+        std::once_flag m_nameOnceFlag;
+        std::once_flag m_isUpdateAvailableOnceFlag;
+        std::once_flag m_availableVersionKeysOnceFlag;
         std::once_flag m_installedVersionOnceFlag;
         std::once_flag m_availableVersionsOnceFlag;
         std::once_flag m_defaultInstallVersionOnceFlag;
@@ -28,4 +28,16 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     {
         return m_wasLimitExceeded;
     }
+    winrt::com_array<winrt::Microsoft::Management::Deployment::CatalogPackageSummary> FindPackagesResult::GetPackageSummaries()
+    {
+        std::vector<winrt::Microsoft::Management::Deployment::CatalogPackageSummary> summaries;
+        summaries.reserve(m_matches.Size());
+
+        for (const auto& match : m_matches)
+        {
+            summaries.emplace_back(match.CatalogPackage().Summary());
+        }
+
+        return winrt::com_array<winrt::Microsoft::Management::Deployment::CatalogPackageSummary>{ std::move(summaries) };
+    }
 }
@@ -19,6 +19,8 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::FindPackagesResultStatus Status();
         winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::MatchResult> Matches();
         bool WasLimitExceeded();
+        // Contract version 5
+        winrt::com_array<winrt::Microsoft::Management::Deployment::CatalogPackageSummary> GetPackageSummaries();
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
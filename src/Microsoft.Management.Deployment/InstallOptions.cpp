@@ -112,6 +112,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     {
         m_allowUpgradeToUnknownVersion = value;
     }
+    winrt::Microsoft::Management::Deployment::PackageInstallPriority InstallOptions::PackageInstallPriority()
+    {
+        return m_packageInstallPriority;
+    }
+    void InstallOptions::PackageInstallPriority(winrt::Microsoft::Management::Deployment::PackageInstallPriority const& value)
+    {
+        m_packageInstallPriority = value;
+    }
 
     CoCreatableMicrosoftManagementDeploymentClass(InstallOptions);
 }
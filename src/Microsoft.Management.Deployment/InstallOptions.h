@@ -35,6 +35,8 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Windows::Foundation::Collections::IVector<winrt::Windows::System::ProcessorArchitecture> AllowedArchitectures();
         bool AllowUpgradeToUnknownVersion();
         void AllowUpgradeToUnknownVersion(bool value);
+        winrt::Microsoft::Management::Deployment::PackageInstallPriority PackageInstallPriority();
+        void PackageInstallPriority(winrt::Microsoft::Management::Deployment::PackageInstallPriority const& value);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
@@ -50,6 +52,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         Windows::Foundation::Collections::IVector<Windows::System::ProcessorArchitecture> m_allowedArchitectures{
             winrt::single_threaded_vector<winrt::Windows::System::ProcessorArchitecture>() };
         bool m_allowUpgradeToUnknownVersion = false;
+        winrt::Microsoft::Management::Deployment::PackageInstallPriority m_packageInstallPriority = winrt::Microsoft::Management::Deployment::PackageInstallPriority::Default;
 #endif
     };
 }
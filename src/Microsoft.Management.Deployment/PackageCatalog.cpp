@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #include "pch.h"
+#include <map>
 #include <mutex>
+#include <set>
 #include <winget/RepositorySource.h>
 #include "Workflows/WorkflowBase.h"
 #include "Converters.h"
@@ -11,6 +13,7 @@
 #include "FindPackagesResult.h"
 #include "MatchResult.h"
 #include "CatalogPackage.h"
+#include "PackageCatalogSearchSession.h"
 #include "Commands/RootCommand.h"
 #include "ExecutionContext.h"
 #pragma warning( push )
@@ -119,6 +122,46 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         return *findPackagesResult;
     }
 
+    Microsoft::Management::Deployment::MatchResult CreateMatchResult(const ::AppInstaller::Repository::Source& source, const ::AppInstaller::Repository::ResultMatch& match)
+    {
+        auto catalogPackage = winrt::make_self<wil::details::module_count_wrapper<
+            winrt::Microsoft::Management::Deployment::implementation::CatalogPackage>>();
+        catalogPackage->Initialize(source, match.Package);
+
+        auto packageMatchFilter = winrt::make_self<wil::details::module_count_wrapper<
+            winrt::Microsoft::Management::Deployment::implementation::PackageMatchFilter>>();
+        packageMatchFilter->Initialize(match.MatchCriteria);
+
+        auto matchResult = winrt::make_self<wil::details::module_count_wrapper<
+            winrt::Microsoft::Management::Deployment::implementation::MatchResult>>();
+        matchResult->Initialize(*catalogPackage, *packageMatchFilter);
+
+        return *matchResult;
+    }
+
+    // Gets the selector of options that only select by Id, which can be searched for alongside other such options.
+    std::optional<::AppInstaller::Repository::PackageMatchFilter> GetBatchableSelector(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options)
+    {
+        if (options.Filters().Size() != 0 || options.Selectors().Size() != 1)
+        {
+            return {};
+        }
+
+        Microsoft::Management::Deployment::PackageMatchFilter selector = options.Selectors().GetAt(0);
+        if (selector.Field() != Microsoft::Management::Deployment::PackageMatchField::Id || selector.Value().empty())
+        {
+            return {};
+        }
+
+        ::AppInstaller::Repository::MatchType matchType = GetRepositoryMatchType(selector.Option());
+        if (matchType != ::AppInstaller::Repository::MatchType::Exact && matchType != ::AppInstaller::Repository::MatchType::CaseInsensitive)
+        {
+            return {};
+        }
+
+        return ::AppInstaller::Repository::PackageMatchFilter(::AppInstaller::Repository::PackageMatchField::Id, matchType, winrt::to_string(selector.Value()));
+    }
+
     winrt::Microsoft::Management::Deployment::FindPackagesResult PackageCatalog::FindPackages(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options)
     {
         winrt::Microsoft::Management::Deployment::FindPackagesResultStatus::Ok;
@@ -148,27 +191,152 @@ namespace winrt::Microsoft::Management::Deployment::implementation
             }
 
             // Build the result object from the searchResult
-            for (size_t i = 0; i < searchResult.Matches.size(); ++i)
+            for (const auto& match : searchResult.Matches)
+            {
+                matches.Append(CreateMatchResult(m_source, match));
+            }
+            isTruncated = searchResult.Truncated;
+        }
+        WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
+
+        return GetFindPackagesResult(hr, isTruncated, matches);
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult>> PackageCatalog::FindPackagesBatchAsync(
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> options)
+    {
+        co_return FindPackagesBatch(options);
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult> PackageCatalog::FindPackagesBatch(
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> const& options)
+    {
+        std::vector<winrt::Microsoft::Management::Deployment::FindPackagesResult> results(options.Size(), nullptr);
+
+        // The options that only select by Id are answered from a single search with all of their selectors as inclusions.
+        // Results are given back to a request when either the package Id or the criteria it matched on equals its selector.
+        struct BatchedRequest
+        {
+            uint32_t Index = 0;
+            uint32_t ResultLimit = 0;
+            Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> Matches{ winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>() };
+            bool IsTruncated = false;
+        };
+
+        std::vector<BatchedRequest> batchedRequests;
+        std::map<std::string, std::vector<size_t>> exactRequests;
+        std::map<std::string, std::vector<size_t>> caseInsensitiveRequests;
+        ::AppInstaller::Repository::SearchRequest searchRequest;
+
+        for (uint32_t i = 0; i < options.Size(); ++i)
+        {
+            auto selector = GetBatchableSelector(options.GetAt(i));
+            if (!selector)
             {
-                auto match = searchResult.Matches[i];
-                auto catalogPackage = winrt::make_self<wil::details::module_count_wrapper<
-                    winrt::Microsoft::Management::Deployment::implementation::CatalogPackage>>();
-                catalogPackage->Initialize(m_source, match.Package);
+                results[i] = FindPackages(options.GetAt(i));
+                continue;
+            }
 
-                auto packageMatchFilter = winrt::make_self<wil::details::module_count_wrapper<
-                    winrt::Microsoft::Management::Deployment::implementation::PackageMatchFilter>>();
-                packageMatchFilter->Initialize(match.MatchCriteria);
+            BatchedRequest request;
+            request.Index = i;
+            request.ResultLimit = options.GetAt(i).ResultLimit();
 
-                auto matchResult = winrt::make_self<wil::details::module_count_wrapper<
-                    winrt::Microsoft::Management::Deployment::implementation::MatchResult>>();
-                matchResult->Initialize(*catalogPackage, *packageMatchFilter);
+            bool isExact = (selector->Type == ::AppInstaller::Repository::MatchType::Exact);
+            std::string key = isExact ? selector->Value : ::AppInstaller::Utility::FoldCase(selector->Value);
+            auto& requestsForKey = (isExact ? exactRequests : caseInsensitiveRequests)[key];
 
-                matches.Append(*matchResult);
+            // Only the first request for a value adds an inclusion to the search.
+            if (requestsForKey.empty())
+            {
+                searchRequest.Inclusions.emplace_back(std::move(selector).value());
+            }
+
+            requestsForKey.push_back(batchedRequests.size());
+            batchedRequests.emplace_back(std::move(request));
+        }
+
+        if (batchedRequests.empty())
+        {
+            return winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::FindPackagesResult>(std::move(results)).GetView();
+        }
+
+        HRESULT hr = S_OK;
+        try
+        {
+            auto searchResult = m_source.Search(searchRequest);
+
+            // Handle failures by just rethrowing the first one for now, as FindPackages does.
+            if (!searchResult.Failures.empty())
+            {
+                std::rethrow_exception(searchResult.Failures[0].Exception);
+            }
+
+            for (const auto& match : searchResult.Matches)
+            {
+                std::vector<std::string> values{ match.Package->GetProperty(::AppInstaller::Repository::PackageProperty::Id).get() };
+                if (match.MatchCriteria.Field == ::AppInstaller::Repository::PackageMatchField::Id && match.MatchCriteria.Value != values[0])
+                {
+                    values.emplace_back(match.MatchCriteria.Value);
+                }
+
+                std::set<size_t> matchedRequests;
+                for (const auto& value : values)
+                {
+                    auto exactItr = exactRequests.find(value);
+                    if (exactItr != exactRequests.end())
+                    {
+                        matchedRequests.insert(exactItr->second.begin(), exactItr->second.end());
+                    }
+
+                    auto caseInsensitiveItr = caseInsensitiveRequests.find(::AppInstaller::Utility::FoldCase(value));
+                    if (caseInsensitiveItr != caseInsensitiveRequests.end())
+                    {
+                        matchedRequests.insert(caseInsensitiveItr->second.begin(), caseInsensitiveItr->second.end());
+                    }
+                }
+
+                if (matchedRequests.empty())
+                {
+                    continue;
+                }
+
+                Microsoft::Management::Deployment::MatchResult matchResult = CreateMatchResult(m_source, match);
+                for (size_t requestIndex : matchedRequests)
+                {
+                    BatchedRequest& request = batchedRequests[requestIndex];
+                    if (request.ResultLimit != 0 && request.Matches.Size() >= request.ResultLimit)
+                    {
+                        request.IsTruncated = true;
+                    }
+                    else
+                    {
+                        request.Matches.Append(matchResult);
+                    }
+                }
             }
-            isTruncated = searchResult.Truncated;
         }
         WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
 
-        return GetFindPackagesResult(hr, isTruncated, matches);
+        for (const BatchedRequest& request : batchedRequests)
+        {
+            if (FAILED(hr))
+            {
+                results[request.Index] = GetFindPackagesResult(hr, false, winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>());
+            }
+            else
+            {
+                results[request.Index] = GetFindPackagesResult(hr, request.IsTruncated, request.Matches);
+            }
+        }
+
+        return winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::FindPackagesResult>(std::move(results)).GetView();
+    }
+
+    winrt::Microsoft::Management::Deployment::PackageCatalogSearchSession PackageCatalog::CreateSearchSession()
+    {
+        auto session = winrt::make_self<wil::details::module_count_wrapper<
+            winrt::Microsoft::Management::Deployment::implementation::PackageCatalogSearchSession>>();
+        session->Initialize(m_source);
+        return *session;
     }
 }
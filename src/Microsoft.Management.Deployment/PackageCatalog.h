@@ -20,6 +20,11 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo Info();
         winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> FindPackagesAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options);
         winrt::Microsoft::Management::Deployment::FindPackagesResult FindPackages(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options);
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult>> FindPackagesBatchAsync(
+            winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> options);
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult> FindPackagesBatch(
+            winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> const& options);
+        winrt::Microsoft::Management::Deployment::PackageCatalogSearchSession CreateSearchSession();
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
@@ -28,4 +33,18 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         bool m_isComposite = false;
 #endif
     };
+
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+    // Helpers shared with PackageCatalogSearchSession.
+    HRESULT PopulateSearchRequest(
+        ::AppInstaller::Repository::SearchRequest* searchRequest,
+        winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options);
+
+    winrt::Microsoft::Management::Deployment::FindPackagesResult GetFindPackagesResult(
+        HRESULT hr,
+        bool isTruncated,
+        Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> matches);
+
+    Microsoft::Management::Deployment::MatchResult CreateMatchResult(const ::AppInstaller::Repository::Source& source, const ::AppInstaller::Repository::ResultMatch& match);
+#endif
 }
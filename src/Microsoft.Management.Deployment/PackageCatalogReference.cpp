@@ -14,9 +14,138 @@
 #include <winget/GroupPolicy.h>
 #include <AppInstallerErrors.h>
 #include <Helpers.h>
+#include <winget/UserSettings.h>
+#include <future>
+#include <map>
+#include <mutex>
 
 namespace winrt::Microsoft::Management::Deployment::implementation
 {
+    namespace
+    {
+        // The sources opened by this server, shared by every catalog reference so that later connections do not open them again.
+        // A source is opened again once it has been updated, or once it is due a background update.
+        struct OpenedSourceCache
+        {
+            static OpenedSourceCache& Instance()
+            {
+                static OpenedSourceCache s_instance;
+                return s_instance;
+            }
+
+            ::AppInstaller::Repository::Source Open(const ::AppInstaller::Repository::Source& sourceReference, const std::optional<std::string>& customHeader, ::AppInstaller::IProgressCallback& progress)
+            {
+                ::AppInstaller::Repository::SourceDetails details = sourceReference.GetDetails();
+                std::string key = details.Identifier + '|' + details.Name + '|' + details.Type + '|' + details.Arg + '|' + customHeader.value_or("");
+
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+
+                    auto itr = m_sources.find(key);
+                    if (itr != m_sources.end())
+                    {
+                        if (details.LastUpdateTime <= itr->second.LastUpdateTime && !IsDueForUpdate(itr->second.LastUpdateTime))
+                        {
+                            return itr->second.OpenedSource;
+                        }
+
+                        m_sources.erase(itr);
+                    }
+                }
+
+                // Open outside of the lock, as this can take a while and other sources should not wait on it.
+                ::AppInstaller::Repository::Source source = sourceReference;
+                source.Open(progress);
+
+                if (source)
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    m_sources[key] = Entry{ source, source.GetDetails().LastUpdateTime };
+                }
+
+                return source;
+            }
+
+        private:
+            struct Entry
+            {
+                ::AppInstaller::Repository::Source OpenedSource;
+                std::chrono::system_clock::time_point LastUpdateTime;
+            };
+
+            // Mirrors the check that opening a source makes before doing a background update.
+            static bool IsDueForUpdate(std::chrono::system_clock::time_point lastUpdateTime)
+            {
+                auto autoUpdateTime = ::AppInstaller::Settings::User().Get<::AppInstaller::Settings::Setting::AutoUpdateTimeInMinutes>();
+                return autoUpdateTime != std::chrono::minutes::zero() && (std::chrono::system_clock::now() - lastUpdateTime) > autoUpdateTime;
+            }
+
+            std::mutex m_lock;
+            std::map<std::string, Entry> m_sources;
+        };
+    }
+
+    // The progress of each of the sources opened by a connection, so that cancelling the connection cancels all of them.
+    struct ConnectProgress
+    {
+        ConnectProgress(std::function<void(double)> reportFractionOpened = {}) : m_reportFractionOpened(std::move(reportFractionOpened)) {}
+
+        // Creates the progress for opening one of the sources.
+        ::AppInstaller::IProgressCallback& AddSource()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            auto& result = m_sources.emplace_back(std::make_unique<::AppInstaller::ProgressCallback>());
+            if (m_cancelled)
+            {
+                result->Cancel();
+            }
+
+            return *result;
+        }
+
+        // Records that one of the sources has been opened, reporting the fraction of them that are now open.
+        void SourceOpened()
+        {
+            double fractionOpened = 0;
+
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                ++m_opened;
+                fractionOpened = static_cast<double>(m_opened) / static_cast<double>(m_sources.size());
+            }
+
+            if (m_reportFractionOpened && !IsCancelled())
+            {
+                m_reportFractionOpened(fractionOpened);
+            }
+        }
+
+        void Cancel()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            m_cancelled = true;
+            for (const auto& source : m_sources)
+            {
+                source->Cancel();
+            }
+        }
+
+        bool IsCancelled()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            return m_cancelled;
+        }
+
+    private:
+        std::function<void(double)> m_reportFractionOpened;
+        std::mutex m_lock;
+        std::vector<std::unique_ptr<::AppInstaller::ProgressCallback>> m_sources;
+        size_t m_opened = 0;
+        bool m_cancelled = false;
+    };
+
     void PackageCatalogReference::Initialize(winrt::Microsoft::Management::Deployment::PackageCatalogInfo packageCatalogInfo, ::AppInstaller::Repository::Source sourceReference)
     {
         m_info = packageCatalogInfo;
@@ -34,62 +163,155 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     {
         return m_info;
     }
-    winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::ConnectResult> PackageCatalogReference::ConnectAsync()
-    {
-        co_return Connect();
-    }
     winrt::Microsoft::Management::Deployment::ConnectResult GetConnectCatalogErrorResult()
     {
         auto connectResult = winrt::make_self<wil::details::module_count_wrapper<winrt::Microsoft::Management::Deployment::implementation::ConnectResult>>();
         connectResult->Initialize(winrt::Microsoft::Management::Deployment::ConnectResultStatus::CatalogError, nullptr);
         return *connectResult;
     }
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::ConnectResult> PackageCatalogReference::ConnectAsync()
+    {
+        // The capability check uses the COM call context, so it must be made before leaving the calling thread.
+        if (FAILED(EnsureComCallerHasCapability(Capability::PackageQuery)))
+        {
+            co_return GetConnectCatalogErrorResult();
+        }
+
+        auto strongThis = get_strong();
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        co_await winrt::resume_background();
+
+        ConnectProgress progress;
+        cancellationToken.callback([&progress]() { progress.Cancel(); });
+
+        auto result = ConnectWithoutCapabilityCheck(progress);
+        // The progress goes away with this frame, so a late cancellation must no longer reach it.
+        cancellationToken.callback(nullptr);
+        co_return result;
+    }
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::ConnectResult, double> PackageCatalogReference::ConnectWithProgressAsync()
+    {
+        if (FAILED(EnsureComCallerHasCapability(Capability::PackageQuery)))
+        {
+            co_return GetConnectCatalogErrorResult();
+        }
+
+        auto strongThis = get_strong();
+        auto report_progress{ co_await winrt::get_progress_token() };
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        co_await winrt::resume_background();
+
+        ConnectProgress progress{ [&report_progress](double fractionOpened) { report_progress(fractionOpened); } };
+        cancellationToken.callback([&progress]() { progress.Cancel(); });
+
+        auto result = ConnectWithoutCapabilityCheck(progress);
+        cancellationToken.callback(nullptr);
+        co_return result;
+    }
     winrt::Microsoft::Management::Deployment::ConnectResult PackageCatalogReference::Connect()
     {
-        try
+        if (FAILED(EnsureComCallerHasCapability(Capability::PackageQuery)))
         {
-            if (FAILED(EnsureComCallerHasCapability(Capability::PackageQuery)))
-            {
-                // TODO: When more error codes are added, this should go back as something other than CatalogError.
-                return GetConnectCatalogErrorResult();
-            }
+            // TODO: When more error codes are added, this should go back as something other than CatalogError.
+            return GetConnectCatalogErrorResult();
+        }
 
-            ::AppInstaller::ProgressCallback progress;
+        ConnectProgress progress;
+        return ConnectWithoutCapabilityCheck(progress);
+    }
+    winrt::Microsoft::Management::Deployment::ConnectResult PackageCatalogReference::ConnectWithoutCapabilityCheck(ConnectProgress& progress)
+    {
+        try
+        {
             ::AppInstaller::Repository::Source source;
             if (m_compositePackageCatalogOptions)
             {
-                std::vector<::AppInstaller::Repository::Source> remoteSources;
+                // Create composite with installed source if needed.
+                ::AppInstaller::Repository::CompositeSearchBehavior searchBehavior = GetRepositoryCompositeSearchBehavior(m_compositePackageCatalogOptions.CompositeSearchBehavior());
+
+                // Every catalog is opened at the same time, as opening one has nothing to do with opening the others;
+                // the connection then takes as long as the slowest of them rather than all of them together.
+                // All of the progress is created up front so that the fraction opened is of the full set.
+                auto catalogs = m_compositePackageCatalogOptions.Catalogs();
+                std::vector<::AppInstaller::IProgressCallback*> remoteProgress;
+                for (uint32_t i = 0; i < catalogs.Size(); ++i)
+                {
+                    remoteProgress.emplace_back(&progress.AddSource());
+                }
+
+                // Check if search behavior indicates that the caller does not want to do local correlation.
+                bool includeInstalled = (m_compositePackageCatalogOptions.CompositeSearchBehavior() != Microsoft::Management::Deployment::CompositeSearchBehavior::RemotePackagesFromRemoteCatalogs);
+                ::AppInstaller::IProgressCallback* installedProgress = (includeInstalled ? &progress.AddSource() : nullptr);
+
+                std::vector<std::future<::AppInstaller::Repository::Source>> remoteOpens;
+                std::future<::AppInstaller::Repository::Source> installedOpen;
+
+                // Make sure that none of the opens are still using the progress if one of them fails.
+                auto waitForOpens = wil::scope_exit([&]()
+                    {
+                        progress.Cancel();
+
+                        for (const auto& remoteOpen : remoteOpens)
+                        {
+                            if (remoteOpen.valid())
+                            {
+                                remoteOpen.wait();
+                            }
+                        }
+
+                        if (installedOpen.valid())
+                        {
+                            installedOpen.wait();
+                        }
+                    });
+
+                for (uint32_t i = 0; i < catalogs.Size(); ++i)
+                {
+                    winrt::Microsoft::Management::Deployment::implementation::PackageCatalogReference* catalogImpl = get_self<winrt::Microsoft::Management::Deployment::implementation::PackageCatalogReference>(catalogs.GetAt(i));
+
+                    remoteOpens.emplace_back(std::async(std::launch::async,
+                        [&progress, sourceReference = catalogImpl->m_sourceReference, customHeader = catalogImpl->m_additionalPackageCatalogArguments, catalogProgress = remoteProgress[i]]()
+                        {
+                            ::AppInstaller::Repository::Source result = OpenedSourceCache::Instance().Open(sourceReference, customHeader, *catalogProgress);
+                            progress.SourceOpened();
+                            return result;
+                        }));
+                }
 
-                for (uint32_t i = 0; i < m_compositePackageCatalogOptions.Catalogs().Size(); ++i)
+                if (includeInstalled)
+                {
+                    installedOpen = std::async(std::launch::async, [&progress, installedProgress]()
+                        {
+                            ::AppInstaller::Repository::Source result{ ::AppInstaller::Repository::PredefinedSource::Installed };
+                            result.Open(*installedProgress);
+                            progress.SourceOpened();
+                            return result;
+                        });
+                }
+
+                std::vector<::AppInstaller::Repository::Source> remoteSources;
+                for (auto& remoteOpen : remoteOpens)
                 {
-                    auto catalog = m_compositePackageCatalogOptions.Catalogs().GetAt(i);
-                    winrt::Microsoft::Management::Deployment::implementation::PackageCatalogReference* catalogImpl = get_self<winrt::Microsoft::Management::Deployment::implementation::PackageCatalogReference>(catalog);
-                    auto copy = catalogImpl->m_sourceReference;
-                    copy.Open(progress);
-                    remoteSources.emplace_back(std::move(copy));
+                    remoteSources.emplace_back(remoteOpen.get());
                 }
 
                 // Create the aggregated source.
                 source = ::AppInstaller::Repository::Source{ remoteSources };
 
-                // Create composite with installed source if needed.
-                ::AppInstaller::Repository::CompositeSearchBehavior searchBehavior = GetRepositoryCompositeSearchBehavior(m_compositePackageCatalogOptions.CompositeSearchBehavior());
-
-                // Check if search behavior indicates that the caller does not want to do local correlation.
-                if (m_compositePackageCatalogOptions.CompositeSearchBehavior() != Microsoft::Management::Deployment::CompositeSearchBehavior::RemotePackagesFromRemoteCatalogs)
+                if (includeInstalled)
                 {
-                    ::AppInstaller::Repository::Source installedSource = ::AppInstaller::Repository::Source{ ::AppInstaller::Repository::PredefinedSource::Installed };
-                    installedSource.Open(progress);
-                    source = ::AppInstaller::Repository::Source{ installedSource, source, searchBehavior };
+                    source = ::AppInstaller::Repository::Source{ installedOpen.get(), source, searchBehavior };
                 }
+
+                waitForOpens.release();
             }
             else
             {
-                source = m_sourceReference;
-                source.Open(progress);
+                source = OpenedSourceCache::Instance().Open(m_sourceReference, m_additionalPackageCatalogArguments, progress.AddSource());
+                progress.SourceOpened();
             }
 
-            if (!source)
+            if (!source || progress.IsCancelled())
             {
                 // If source is null, return the error. There's no way to get the hresult that caused the error right now.
                 return GetConnectCatalogErrorResult();
@@ -6,6 +6,10 @@
 
 namespace winrt::Microsoft::Management::Deployment::implementation
 {
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+    struct ConnectProgress;
+#endif
+
     struct PackageCatalogReference : PackageCatalogReferenceT<PackageCatalogReference>
     {
         PackageCatalogReference() = default;
@@ -19,11 +23,16 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo Info();
         winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::ConnectResult> ConnectAsync();
         winrt::Microsoft::Management::Deployment::ConnectResult Connect();
+        // Contract version 5
+        winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::ConnectResult, double> ConnectWithProgressAsync();
         hstring AdditionalPackageCatalogArguments();
         void AdditionalPackageCatalogArguments(hstring const& value);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
+        // Opens the catalog, with the progress of opening each source tracked so that all of them can be cancelled.
+        winrt::Microsoft::Management::Deployment::ConnectResult ConnectWithoutCapabilityCheck(ConnectProgress& progress);
+
         winrt::Microsoft::Management::Deployment::CreateCompositePackageCatalogOptions m_compositePackageCatalogOptions{ nullptr };
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo m_info{ nullptr };
         ::AppInstaller::Repository::Source m_sourceReference;
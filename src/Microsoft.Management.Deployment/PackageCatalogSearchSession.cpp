@@ -0,0 +1,281 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include <winget/RepositorySource.h>
+#include "Workflows/WorkflowBase.h"
+#include "PackageCatalog.h"
+#include "PackageCatalogSearchSession.h"
+#include "PackageCatalogSearchSession.g.cpp"
+#include "FindPackagesResult.h"
+#include "MatchResult.h"
+#include <wil\cppwinrt_wrl.h>
+#include <AppInstallerErrors.h>
+#include <AppInstallerStrings.h>
+
+using namespace ::AppInstaller::Repository;
+
+namespace winrt::Microsoft::Management::Deployment::implementation
+{
+    namespace
+    {
+        // Gets the only selector of the request if it is one that an extended value can be found with by narrowing the previous result.
+        const PackageMatchFilter* GetNarrowableSelector(const SearchRequest& request)
+        {
+            if (request.Query || request.Inclusions.size() != 1)
+            {
+                return nullptr;
+            }
+
+            const PackageMatchFilter& selector = request.Inclusions[0];
+            if ((selector.Field != PackageMatchField::Id && selector.Field != PackageMatchField::Name) ||
+                (selector.Type != MatchType::StartsWith && selector.Type != MatchType::Substring) ||
+                selector.Additional)
+            {
+                return nullptr;
+            }
+
+            return &selector;
+        }
+
+        bool AreSameFilters(const std::vector<PackageMatchFilter>& a, const std::vector<PackageMatchFilter>& b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const PackageMatchFilter& left, const PackageMatchFilter& right)
+                {
+                    return left.Field == right.Field && left.Type == right.Type && left.Value == right.Value && left.Additional == right.Additional;
+                });
+        }
+
+        // Determines whether every package that the request would find is in the previous result.
+        // That holds when the previous result is complete and the request only extends the value of the previous selector,
+        // as a value that starts with or contains the extended value also starts with or contains the previous one.
+        bool CanNarrow(const SearchRequest& previous, const SearchResult& previousResult, const SearchRequest& request)
+        {
+            if (previousResult.Truncated || !previousResult.Failures.empty())
+            {
+                return false;
+            }
+
+            const PackageMatchFilter* previousSelector = GetNarrowableSelector(previous);
+            const PackageMatchFilter* selector = GetNarrowableSelector(request);
+            if (!previousSelector || !selector ||
+                previousSelector->Field != selector->Field ||
+                previousSelector->Type != selector->Type ||
+                !AreSameFilters(previous.Filters, request.Filters))
+            {
+                return false;
+            }
+
+            return ::AppInstaller::Utility::ICUCaseInsensitiveStartsWith(selector->Value, previousSelector->Value);
+        }
+
+        // The ranks of a match, in the order that they are returned in.
+        enum class MatchRank
+        {
+            Equals,
+            StartsWith,
+            Contains,
+            None,
+        };
+
+        MatchRank GetMatchRank(std::string_view value, std::string_view foldedQuery, MatchType type)
+        {
+            std::string folded = ::AppInstaller::Utility::FoldCase(value);
+            if (folded == foldedQuery)
+            {
+                return MatchRank::Equals;
+            }
+            else if (folded.compare(0, foldedQuery.size(), foldedQuery) == 0)
+            {
+                return MatchRank::StartsWith;
+            }
+            else if (type == MatchType::Substring && folded.find(foldedQuery) != std::string::npos)
+            {
+                return MatchRank::Contains;
+            }
+
+            return MatchRank::None;
+        }
+
+        // Orders the matches that start with the query before those that only contain it, keeping the order of the index otherwise.
+        // The index only distinguishes matches that equal the query from the rest.
+        void RankMatches(const SearchRequest& request, SearchResult& result)
+        {
+            const RequestMatch* query = request.Query ? &request.Query.value() : GetNarrowableSelector(request);
+            if (!query || query->Type != MatchType::Substring)
+            {
+                return;
+            }
+
+            std::string foldedQuery = ::AppInstaller::Utility::FoldCase(std::string_view{ query->Value });
+
+            std::vector<std::pair<MatchRank, size_t>> ranks;
+            ranks.reserve(result.Matches.size());
+            for (const auto& match : result.Matches)
+            {
+                MatchRank rank = GetMatchRank(match.MatchCriteria.Value, foldedQuery, MatchType::Substring);
+
+                // Matches on another field, or on a value that the index normalized, keep their place after the ranked matches.
+                ranks.emplace_back(rank == MatchRank::None ? MatchRank::Contains : rank, ranks.size());
+            }
+
+            std::stable_sort(ranks.begin(), ranks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            std::vector<ResultMatch> matches;
+            matches.reserve(result.Matches.size());
+            for (const auto& rank : ranks)
+            {
+                matches.emplace_back(std::move(result.Matches[rank.second]));
+            }
+
+            result.Matches = std::move(matches);
+        }
+
+        // Filters the previous result to the packages that match the extended selector of the request.
+        SearchResult Narrow(const SearchResult& previousResult, const SearchRequest& request)
+        {
+            const PackageMatchFilter& selector = *GetNarrowableSelector(request);
+            std::string foldedQuery = ::AppInstaller::Utility::FoldCase(std::string_view{ selector.Value });
+            PackageProperty property = (selector.Field == PackageMatchField::Id ? PackageProperty::Id : PackageProperty::Name);
+
+            std::vector<std::pair<MatchRank, ResultMatch>> ranked;
+            for (const auto& match : previousResult.Matches)
+            {
+                // The index matched on a value of any version, which is in the criteria, while the property is that of the latest one.
+                MatchRank rank = MatchRank::None;
+                std::string matchedValue;
+                if (match.MatchCriteria.Field == selector.Field)
+                {
+                    rank = GetMatchRank(match.MatchCriteria.Value, foldedQuery, selector.Type);
+                    matchedValue = match.MatchCriteria.Value;
+                }
+
+                if (rank == MatchRank::None)
+                {
+                    std::string propertyValue = match.Package->GetProperty(property).get();
+                    rank = GetMatchRank(propertyValue, foldedQuery, selector.Type);
+                    matchedValue = std::move(propertyValue);
+                }
+
+                if (rank == MatchRank::None)
+                {
+                    continue;
+                }
+
+                // Report the criteria as the index would have.
+                MatchType matchedType = (rank == MatchRank::Equals ? MatchType::CaseInsensitive : selector.Type);
+                ranked.emplace_back(rank, ResultMatch{ match.Package, PackageMatchFilter{ selector.Field, matchedType, matchedValue } });
+            }
+
+            std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            SearchResult result;
+            for (auto& match : ranked)
+            {
+                if (request.MaximumResults && result.Matches.size() >= request.MaximumResults)
+                {
+                    result.Truncated = true;
+                    break;
+                }
+
+                result.Matches.emplace_back(std::move(match.second));
+            }
+
+            return result;
+        }
+    }
+
+    void PackageCatalogSearchSession::Initialize(::AppInstaller::Repository::Source source)
+    {
+        m_source = std::move(source);
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> PackageCatalogSearchSession::FindPackagesAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options)
+    {
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> operation = FindPackagesInternalAsync(options);
+
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> previous{ nullptr };
+        {
+            std::lock_guard<std::mutex> lock{ m_inFlightLock };
+            previous = std::exchange(m_inFlight, operation);
+        }
+
+        // The new search replaces any that has not completed yet.
+        if (previous)
+        {
+            previous.Cancel();
+        }
+
+        return operation;
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> PackageCatalogSearchSession::FindPackagesInternalAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options)
+    {
+        auto strongThis = get_strong();
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        // co_await does not guarantee that it's on a background thread, so do so explicitly.
+        co_await winrt::resume_background();
+
+        bool isTruncated = false;
+        Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> matches{ winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>() };
+
+        HRESULT hr = S_OK;
+        try
+        {
+            std::lock_guard<std::mutex> searchLock{ m_searchLock };
+
+            // A search that was replaced while waiting for the previous one to complete is not run at all.
+            if (cancellationToken())
+            {
+                co_return GetFindPackagesResult(E_ABORT, isTruncated, matches);
+            }
+
+            SearchRequest searchRequest;
+            if (FAILED(hr = PopulateSearchRequest(&searchRequest, options)))
+            {
+                co_return GetFindPackagesResult(hr, isTruncated, matches);
+            }
+
+            searchRequest.MaximumResults = options.ResultLimit();
+            SearchResult searchResult = Search(searchRequest);
+
+            // Handle failures by just rethrowing the first one for now, as FindPackages does.
+            if (!searchResult.Failures.empty())
+            {
+                std::rethrow_exception(searchResult.Failures[0].Exception);
+            }
+
+            // The result is kept for the next search even if this one was replaced, as that one likely extends it.
+            if (!cancellationToken())
+            {
+                for (const auto& match : searchResult.Matches)
+                {
+                    matches.Append(CreateMatchResult(m_source, match));
+                }
+                isTruncated = searchResult.Truncated;
+            }
+
+            m_previousRequest = std::move(searchRequest);
+            m_previousResult = std::move(searchResult);
+        }
+        WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
+
+        co_return GetFindPackagesResult(hr, isTruncated, matches);
+    }
+
+    SearchResult PackageCatalogSearchSession::Search(const SearchRequest& request)
+    {
+        if (m_previousRequest && CanNarrow(m_previousRequest.value(), m_previousResult, request))
+        {
+            AICLI_LOG(Repo, Verbose, << "Narrowing the previous search result for: " << request.ToString());
+            return Narrow(m_previousResult, request);
+        }
+
+        // Drop the previous result first, so that it is not used if the search fails.
+        m_previousRequest.reset();
+        m_previousResult = {};
+
+        SearchResult result = m_source.Search(request);
+        RankMatches(request, result);
+        return result;
+    }
+}
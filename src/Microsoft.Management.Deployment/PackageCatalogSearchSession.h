@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "PackageCatalogSearchSession.g.h"
+#include <mutex>
+#include <optional>
+
+namespace winrt::Microsoft::Management::Deployment::implementation
+{
+    struct PackageCatalogSearchSession : PackageCatalogSearchSessionT<PackageCatalogSearchSession>
+    {
+        PackageCatalogSearchSession() = default;
+
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+        void Initialize(::AppInstaller::Repository::Source source);
+#endif
+
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> FindPackagesAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options);
+
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+    private:
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> FindPackagesInternalAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options);
+
+        // Gets the result for the request, from the previous result if it can be narrowed to it; must hold m_searchLock.
+        ::AppInstaller::Repository::SearchResult Search(const ::AppInstaller::Repository::SearchRequest& request);
+
+        ::AppInstaller::Repository::Source m_source;
+
+        std::mutex m_inFlightLock;
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> m_inFlight{ nullptr };
+
+        // Held while searching, along with the previous request and its result.
+        std::mutex m_searchLock;
+        std::optional<::AppInstaller::Repository::SearchRequest> m_previousRequest;
+        ::AppInstaller::Repository::SearchResult m_previousResult;
+#endif
+    };
+}
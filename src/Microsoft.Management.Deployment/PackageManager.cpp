@@ -233,6 +233,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 {
                     reportProgress = true;
                 }
+                else if (reportType == ReportType::ExecutionStageCompleted)
+                {
+                    // The installer is downloaded and verified, and is waiting for the install to start.
+                    reportProgress = true;
+                    downloadBytesDownloaded = current;
+                    downloadBytesRequired = maximum;
+                    downloadProgress = 1;
+                }
                 else if (progressType == ::AppInstaller::ProgressType::Bytes)
                 {
                     downloadBytesDownloaded = current;
@@ -519,7 +527,22 @@ namespace winrt::Microsoft::Management::Deployment::implementation
             AddInstalledVersionToContext(package.InstalledVersion(), comContext.get());
         }
 
-        return Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ packageVersionInfo.PackageCatalog().Info().Id() }, std::move(comContext), isUpgrade);
+        std::unique_ptr<Execution::OrchestratorQueueItem> queueItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ packageVersionInfo.PackageCatalog().Info().Id() }, std::move(comContext), isUpgrade);
+
+        if (options)
+        {
+            switch (options.PackageInstallPriority())
+            {
+            case PackageInstallPriority::Low:
+                queueItem->SetPriority(Execution::OrchestratorQueueItemPriority::Low);
+                break;
+            case PackageInstallPriority::High:
+                queueItem->SetPriority(Execution::OrchestratorQueueItemPriority::High);
+                break;
+            }
+        }
+
+        return queueItem;
     }
 
     std::unique_ptr<Execution::OrchestratorQueueItem> CreateQueueItemForUninstall(
@@ -543,6 +566,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::CatalogPackage package = nullptr,
         TOptions options = nullptr,
         std::wstring callerProcessInfoString = {},
+        DWORD callerProcessId = 0,
         bool isUpgrade = false)
     {
         winrt::hresult terminationHR = S_OK;
@@ -573,6 +597,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                     queueItem = CreateQueueItemForUninstall(std::move(comContext), package);
                 }
 
+                queueItem->SetCallerId(callerProcessId);
                 Execution::ContextOrchestrator::Instance().EnqueueAndRunItem(queueItem);
 
                 if constexpr (std::is_same_v<TProgress, winrt::Microsoft::Management::Deployment::PackageInstallProgressState>)
@@ -624,6 +649,12 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                     }
                 });
 
+            // Progress within the same state is coalesced, as each report to a client in another process is a cross-process call.
+            const std::chrono::milliseconds minimumProgressInterval = ::AppInstaller::Settings::User().Get<::AppInstaller::Settings::Setting::InstallProgressIntervalInMilliseconds>();
+            std::optional<TProgressState> lastReportedState;
+            std::chrono::steady_clock::time_point lastReportTime{};
+            DWORD waitTime = INFINITE;
+
             // Wait for completion or progress events.
             // Waiting for both on the same thread ensures that progress is never reported after the async operation itself has completed.
             bool completionEventFired = false;
@@ -636,19 +667,37 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                     _countof(operationEvents) /* number of events */,
                     operationEvents /* event array */,
                     FALSE /* bWaitAll, FALSE to wake on any event */,
-                    INFINITE /* wait until operation completion */);
+                    waitTime /* until operation completion, or until coalesced progress is due */);
 
                 switch (dwEvent)
                 {
                     // operationEvents[0] was signaled, progress
                 case WAIT_OBJECT_0 + 0:
-                    // The report_progress call will hang when making callbacks to suspended processes so it's important that this is now on a background thread.
-                    // Progress events are not queued - some will be missed if multiple progress events are fired from the ComContext to the callback 
-                    // while the report_progress call is hung\in progress.
-                    // Duplicate progress events can be fired if another progress event comes from the ComContext to the callback after the listener
-                    // has been awaked, but before it has gotten the installProgress.
-                    report_progress(operationProgress);
+                    // Coalesced progress is due
+                case WAIT_TIMEOUT:
+                {
+                    TProgress progress = operationProgress;
+                    auto sinceLastReport = std::chrono::steady_clock::now() - lastReportTime;
+
+                    if (dwEvent == WAIT_TIMEOUT || !lastReportedState || progress.State != lastReportedState.value() || sinceLastReport >= minimumProgressInterval)
+                    {
+                        // The report_progress call will hang when making callbacks to suspended processes so it's important that this is now on a background thread.
+                        // Progress events are not queued - some will be missed if multiple progress events are fired from the ComContext to the callback 
+                        // while the report_progress call is hung\in progress.
+                        // Duplicate progress events can be fired if another progress event comes from the ComContext to the callback after the listener
+                        // has been awaked, but before it has gotten the installProgress.
+                        report_progress(progress);
+                        lastReportedState = progress.State;
+                        lastReportTime = std::chrono::steady_clock::now();
+                        waitTime = INFINITE;
+                    }
+                    else
+                    {
+                        // Report the latest progress once the interval has passed, unless it changes state first.
+                        waitTime = static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(minimumProgressInterval - sinceLastReport).count()) + 1;
+                    }
                     break;
+                }
 
                     // operationEvents[1] was signaled, operation completed
                 case WAIT_OBJECT_0 + 1:
@@ -700,11 +749,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
         HRESULT hr = S_OK;
         std::wstring callerProcessInfoString;
+        DWORD callerProcessId = 0;
         try
         {
             // Check for permissions and get caller info for telemetry.
             // This must be done before any co_awaits since it requires info from the rpc caller thread.
-            auto [hrGetCallerId, callerProcessId] = GetCallerProcessId();
+            HRESULT hrGetCallerId = S_OK;
+            std::tie(hrGetCallerId, callerProcessId) = GetCallerProcessId();
             WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(hrGetCallerId);
             WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(EnsureProcessHasCapability(Capability::PackageManagement, callerProcessId));
             callerProcessInfoString = TryGetCallerProcessInfo(callerProcessId);
@@ -713,7 +764,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(hr);
 
         return GetPackageOperation<Deployment::InstallResult, Deployment::InstallProgress, Deployment::InstallOptions, Deployment::PackageInstallProgressState>(
-            true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString));
+            true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString), callerProcessId);
     }
 
     winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::InstallResult, winrt::Microsoft::Management::Deployment::InstallProgress> PackageManager::UpgradePackageAsync(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::InstallOptions options)
@@ -727,11 +778,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
         HRESULT hr = S_OK;
         std::wstring callerProcessInfoString;
+        DWORD callerProcessId = 0;
         try
         {
             // Check for permissions and get caller info for telemetry.
             // This must be done before any co_awaits since it requires info from the rpc caller thread.
-            auto [hrGetCallerId, callerProcessId] = GetCallerProcessId();
+            HRESULT hrGetCallerId = S_OK;
+            std::tie(hrGetCallerId, callerProcessId) = GetCallerProcessId();
             WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(hrGetCallerId);
             WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(EnsureProcessHasCapability(Capability::PackageManagement, callerProcessId));
             callerProcessInfoString = TryGetCallerProcessInfo(callerProcessId);
@@ -740,7 +793,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(hr);
 
         return GetPackageOperation<Deployment::InstallResult, Deployment::InstallProgress, Deployment::InstallOptions, Deployment::PackageInstallProgressState>(
-            true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString), true /* isUpgrade */);
+            true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString), callerProcessId, true /* isUpgrade */);
     }
 
     winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::InstallResult, winrt::Microsoft::Management::Deployment::InstallProgress> PackageManager::GetInstallProgress(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::PackageCatalogInfo catalogInfo)
@@ -792,11 +845,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
         HRESULT hr = S_OK;
         std::wstring callerProcessInfoString;
+        DWORD callerProcessId = 0;
         try
         {
             // Check for permissions and get caller info for telemetry.
             // This must be done before any co_awaits since it requires info from the rpc caller thread.
-            auto [hrGetCallerId, callerProcessId] = GetCallerProcessId();
+            HRESULT hrGetCallerId = S_OK;
+            std::tie(hrGetCallerId, callerProcessId) = GetCallerProcessId();
             WINGET_RETURN_UNINSTALL_RESULT_HR_IF_FAILED(hrGetCallerId);
             WINGET_RETURN_UNINSTALL_RESULT_HR_IF_FAILED(EnsureProcessHasCapability(Capability::PackageManagement, callerProcessId));
             callerProcessInfoString = TryGetCallerProcessInfo(callerProcessId);
@@ -805,7 +860,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         WINGET_RETURN_UNINSTALL_RESULT_HR_IF_FAILED(hr);
 
         return GetPackageOperation<Deployment::UninstallResult, Deployment::UninstallProgress, Deployment::UninstallOptions, Deployment::PackageUninstallProgressState>(
-            true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString));
+            true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString), callerProcessId);
     }
 
     winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::UninstallResult, winrt::Microsoft::Management::Deployment::UninstallProgress> PackageManager::GetUninstallProgress(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::PackageCatalogInfo catalogInfo)
@@ -25,9 +25,21 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     hstring PackageVersionInfo::GetMetadata(winrt::Microsoft::Management::Deployment::PackageVersionMetadataField const& metadataField)
     {
         ::AppInstaller::Repository::PackageVersionMetadata metadataKey = GetRepositoryPackageVersionMetadata(metadataField);
-        ::AppInstaller::Repository::IPackageVersion::Metadata metadata = m_packageVersion->GetMetadata();
-        auto result = metadata.find(metadataKey);
-        hstring resultString = winrt::to_hstring(result->second);
+        hstring resultString;
+        {
+            std::lock_guard<std::mutex> lock{ m_propertiesLock };
+            if (!m_metadata)
+            {
+                m_metadata = m_packageVersion->GetMetadata();
+            }
+
+            auto result = m_metadata->find(metadataKey);
+            if (result == m_metadata->end())
+            {
+                return {};
+            }
+            resultString = winrt::to_hstring(result->second);
+        }
         // The api uses "System" rather than "Machine" for install scope.
         if (metadataField == PackageVersionMetadataField::InstalledScope && resultString == L"Machine")
         {
@@ -35,60 +47,73 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         }
         return resultString;
     }
+    const hstring& PackageVersionInfo::GetCachedProperty(::AppInstaller::Repository::PackageVersionProperty property)
+    {
+        std::lock_guard<std::mutex> lock{ m_propertiesLock };
+        auto itr = m_properties.find(property);
+        if (itr == m_properties.end())
+        {
+            itr = m_properties.emplace(property, winrt::to_hstring(m_packageVersion->GetProperty(property).get())).first;
+        }
+        return itr->second;
+    }
     hstring PackageVersionInfo::Id()
     {
-        return winrt::to_hstring(m_packageVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Id).get());
+        return GetCachedProperty(::AppInstaller::Repository::PackageVersionProperty::Id);
     }
     hstring PackageVersionInfo::DisplayName()
     {
-        return winrt::to_hstring(m_packageVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Name).get());
+        return GetCachedProperty(::AppInstaller::Repository::PackageVersionProperty::Name);
     }
     hstring PackageVersionInfo::Version()
     {
-        return winrt::to_hstring(m_packageVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Version).get());
+        return GetCachedProperty(::AppInstaller::Repository::PackageVersionProperty::Version);
     }
     hstring PackageVersionInfo::Channel()
     {
-        return winrt::to_hstring(m_packageVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Channel).get());
+        return GetCachedProperty(::AppInstaller::Repository::PackageVersionProperty::Channel);
     }
     winrt::Windows::Foundation::Collections::IVectorView<hstring> PackageVersionInfo::PackageFamilyNames()
     {
-        if (!m_packageFamilyNames)
-        {
-            // Vector hasn't been created yet, create and populate it.
-            auto packageFamilyNames = winrt::single_threaded_vector<hstring>(); 
-            for (auto&& string : m_packageVersion->GetMultiProperty(::AppInstaller::Repository::PackageVersionMultiProperty::PackageFamilyName))
+        std::call_once(m_packageFamilyNamesOnceFlag,
+            [&]()
             {
-                packageFamilyNames.Append(winrt::to_hstring(string));
-            }
-            m_packageFamilyNames = packageFamilyNames;
-        }
+                // Vector hasn't been created yet, create and populate it.
+                auto packageFamilyNames = winrt::single_threaded_vector<hstring>();
+                for (auto&& string : m_packageVersion->GetMultiProperty(::AppInstaller::Repository::PackageVersionMultiProperty::PackageFamilyName))
+                {
+                    packageFamilyNames.Append(winrt::to_hstring(string));
+                }
+                m_packageFamilyNames = packageFamilyNames;
+            });
         return m_packageFamilyNames.GetView();
     }
     winrt::Windows::Foundation::Collections::IVectorView<hstring> PackageVersionInfo::ProductCodes()
     {
-        if (!m_productCodes)
-        {
-            // Vector hasn't been created yet, create and populate it.
-            auto productCodes = winrt::single_threaded_vector<hstring>();
-            for (auto&& string : m_packageVersion->GetMultiProperty(::AppInstaller::Repository::PackageVersionMultiProperty::ProductCode))
+        std::call_once(m_productCodesOnceFlag,
+            [&]()
             {
-                productCodes.Append(winrt::to_hstring(string));
-            }
-            m_productCodes = productCodes;
-        }
+                // Vector hasn't been created yet, create and populate it.
+                auto productCodes = winrt::single_threaded_vector<hstring>();
+                for (auto&& string : m_packageVersion->GetMultiProperty(::AppInstaller::Repository::PackageVersionMultiProperty::ProductCode))
+                {
+                    productCodes.Append(winrt::to_hstring(string));
+                }
+                m_productCodes = productCodes;
+            });
         return m_productCodes.GetView();
     }
     winrt::Microsoft::Management::Deployment::PackageCatalog PackageVersionInfo::PackageCatalog()
     {
-        if (!m_packageCatalog)
-        {
-            auto packageCatalogInfo = winrt::make_self<wil::details::module_count_wrapper<winrt::Microsoft::Management::Deployment::implementation::PackageCatalogInfo>>();
-            packageCatalogInfo->Initialize(m_packageVersion->GetSource().GetDetails());
-            auto packageCatalog = winrt::make_self<wil::details::module_count_wrapper<winrt::Microsoft::Management::Deployment::implementation::PackageCatalog>>();
-            packageCatalog->Initialize(*packageCatalogInfo, m_packageVersion->GetSource(), false);
-            m_packageCatalog = *packageCatalog;
-        }
+        std::call_once(m_packageCatalogOnceFlag,
+            [&]()
+            {
+                auto packageCatalogInfo = winrt::make_self<wil::details::module_count_wrapper<winrt::Microsoft::Management::Deployment::implementation::PackageCatalogInfo>>();
+                packageCatalogInfo->Initialize(m_packageVersion->GetSource().GetDetails());
+                auto packageCatalog = winrt::make_self<wil::details::module_count_wrapper<winrt::Microsoft::Management::Deployment::implementation::PackageCatalog>>();
+                packageCatalog->Initialize(*packageCatalogInfo, m_packageVersion->GetSource(), false);
+                m_packageCatalog = *packageCatalog;
+            });
         return m_packageCatalog;
     }
 
@@ -99,7 +124,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
             return CompareResult::Unknown;
         }
 
-        AppInstaller::Utility::Version thisVersion{ m_packageVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Version).get() };
+        AppInstaller::Utility::Version thisVersion{ AppInstaller::Utility::ConvertToUTF8(Version()) };
         AppInstaller::Utility::Version otherVersion{ AppInstaller::Utility::ConvertToUTF8(versionString) };
 
         if (thisVersion < otherVersion)
@@ -28,10 +28,19 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
+        // Gets a property of the version, reading it from the package version the first time.
+        const hstring& GetCachedProperty(::AppInstaller::Repository::PackageVersionProperty property);
+
         winrt::Microsoft::Management::Deployment::PackageCatalog m_packageCatalog{ nullptr };
         std::shared_ptr<::AppInstaller::Repository::IPackageVersion> m_packageVersion;
         Windows::Foundation::Collections::IVector<hstring> m_packageFamilyNames{ nullptr };
         Windows::Foundation::Collections::IVector<hstring> m_productCodes{ nullptr };
+        std::map<::AppInstaller::Repository::PackageVersionProperty, hstring> m_properties;
+        std::optional<::AppInstaller::Repository::IPackageVersion::Metadata> m_metadata;
+        std::mutex m_propertiesLock;
+        std::once_flag m_packageCatalogOnceFlag;
+        std::once_flag m_packageFamilyNamesOnceFlag;
+        std::once_flag m_productCodesOnceFlag;
 #endif
     };
 }
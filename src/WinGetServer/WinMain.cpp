@@ -34,7 +34,32 @@ int __stdcall wWinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPWSTR, _In_ int
     {
         // Register all the CoCreatableClassWrlCreatorMapInclude classes
         RETURN_IF_FAILED(WindowsPackageManagerServerModuleRegister());
-        _comServerExitEvent.wait();
+
+        UINT32 idleTimeout = 0;
+        LOG_IF_FAILED(WindowsPackageManagerServerGetIdleTimeout(&idleTimeout));
+
+        while (true)
+        {
+            _comServerExitEvent.wait();
+
+            if (!idleTimeout)
+            {
+                break;
+            }
+
+            // Stay running for a while with the sources and installed packages warm, for clients that connect again soon.
+            // The event is set again if a client comes and goes during the wait, which restarts the wait.
+            _comServerExitEvent.ResetEvent();
+            if (!_comServerExitEvent.wait(idleTimeout))
+            {
+                UINT32 objectCount = 0;
+                if (FAILED(WindowsPackageManagerServerModuleGetObjectCount(&objectCount)) || objectCount == 0)
+                {
+                    break;
+                }
+            }
+        }
+
         RETURN_IF_FAILED(WindowsPackageManagerServerModuleUnregister());
     }
     CATCH_RETURN()
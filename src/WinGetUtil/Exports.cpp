@@ -75,7 +75,36 @@ extern "C"
         std::string filePathUtf8 = ConvertToUTF8(filePath);
         Schema::Version internalVersion{ majorVersion, minorVersion };
 
-        std::unique_ptr<SQLiteIndex> result = std::make_unique<SQLiteIndex>(SQLiteIndex::CreateNew(filePathUtf8, internalVersion));
+        // The index created here is for a source of available packages, so it also records a summary of each manifest's installers.
+        std::unique_ptr<SQLiteIndex> result = std::make_unique<SQLiteIndex>(SQLiteIndex::CreateNew(filePathUtf8, internalVersion, SQLiteIndex::CreateOptions::InstallerApplicabilitySupport));
+
+        *index = static_cast<WINGET_SQLITE_INDEX_HANDLE>(result.release());
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexCreateV2(WINGET_STRING filePath, UINT32 majorVersion, UINT32 minorVersion, UINT32 manifestContentVersions, WINGET_SQLITE_INDEX_HANDLE* index) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !filePath);
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, !!*index);
+
+        std::string filePathUtf8 = ConvertToUTF8(filePath);
+        Schema::Version internalVersion{ majorVersion, minorVersion };
+
+        SQLiteIndex::CreateOptions options = SQLiteIndex::CreateOptions::InstallerApplicabilitySupport;
+        if (manifestContentVersions)
+        {
+            options |= SQLiteIndex::CreateOptions::ManifestContentSupport;
+        }
+
+        std::unique_ptr<SQLiteIndex> result = std::make_unique<SQLiteIndex>(SQLiteIndex::CreateNew(filePathUtf8, internalVersion, options));
+
+        if (manifestContentVersions)
+        {
+            result->SetManifestContentVersions(manifestContentVersions);
+        }
 
         *index = static_cast<WINGET_SQLITE_INDEX_HANDLE>(result.release());
 
@@ -121,6 +150,84 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetSQLiteIndexAddManifests(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        const WINGET_STRING* manifestPaths,
+        const WINGET_STRING* relativePaths,
+        UINT32 count) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, count && (!manifestPaths || !relativePaths));
+
+        std::vector<std::pair<std::filesystem::path, std::filesystem::path>> manifests;
+        manifests.reserve(count);
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            THROW_HR_IF(E_INVALIDARG, !manifestPaths[i]);
+            THROW_HR_IF(E_INVALIDARG, !relativePaths[i]);
+            manifests.emplace_back(manifestPaths[i], relativePaths[i]);
+        }
+
+        reinterpret_cast<SQLiteIndex*>(index)->AddManifests(manifests);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexApplyManifestChanges(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        const WinGetManifestChangeType* changeTypes,
+        const WINGET_STRING* manifestPaths,
+        const WINGET_STRING* relativePaths,
+        UINT32 count,
+        BOOL* indexModified) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, count && (!changeTypes || !manifestPaths || !relativePaths));
+
+        std::vector<SQLiteIndex::ManifestChange> changes;
+        changes.reserve(count);
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            SQLiteIndex::ManifestChange& change = changes.emplace_back();
+
+            switch (changeTypes[i])
+            {
+            case WinGetManifestChangeType::ManifestAdded:
+                change.Type = SQLiteIndex::ManifestChangeType::Added;
+                break;
+            case WinGetManifestChangeType::ManifestModified:
+                change.Type = SQLiteIndex::ManifestChangeType::Modified;
+                break;
+            case WinGetManifestChangeType::ManifestRemoved:
+                change.Type = SQLiteIndex::ManifestChangeType::Removed;
+                break;
+            default:
+                THROW_HR(E_INVALIDARG);
+            }
+
+            THROW_HR_IF(E_INVALIDARG, !relativePaths[i]);
+            change.RelativePath = relativePaths[i];
+
+            if (change.Type != SQLiteIndex::ManifestChangeType::Removed)
+            {
+                THROW_HR_IF(E_INVALIDARG, !manifestPaths[i]);
+                change.ManifestPath = manifestPaths[i];
+            }
+        }
+
+        bool result = reinterpret_cast<SQLiteIndex*>(index)->ApplyManifestChanges(changes);
+        if (indexModified)
+        {
+            *indexModified = (result ? TRUE : FALSE);
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetSQLiteIndexUpdateManifest(
         WINGET_SQLITE_INDEX_HANDLE index,
         WINGET_STRING manifestPath,
@@ -181,6 +288,49 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetSQLiteIndexCheckConsistencyV2(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        BOOL* succeeded,
+        WINGET_STRING_OUT* timings) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, !succeeded);
+
+        std::vector<SQLiteIndex::ConsistencyCheckResult> results;
+        bool result = reinterpret_cast<SQLiteIndex*>(index)->CheckConsistency(true, results);
+
+        if (timings)
+        {
+            std::ostringstream stream;
+            for (const auto& checkResult : results)
+            {
+                stream << checkResult.Name << '\t' << checkResult.Duration.count() << '\t' << (checkResult.Consistent ? "consistent" : "inconsistent") << '\n';
+            }
+
+            *timings = ::SysAllocString(ConvertToUTF16(stream.str()).c_str());
+        }
+
+        *succeeded = (result ? TRUE : FALSE);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexCreateDelta(
+        WINGET_STRING fromIndexPath,
+        WINGET_STRING toIndexPath,
+        WINGET_STRING deltaPath) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !fromIndexPath);
+        THROW_HR_IF(E_INVALIDARG, !toIndexPath);
+        THROW_HR_IF(E_INVALIDARG, !deltaPath);
+
+        SQLiteIndex::CreateDelta(fromIndexPath, toIndexPath, deltaPath);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetValidateManifest(
         WINGET_STRING manifestPath,
         BOOL* succeeded,
@@ -247,6 +397,95 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetValidateManifestsV2(
+        const WINGET_STRING* inputPaths,
+        BOOL* succeeded,
+        WINGET_STRING_OUT* messages,
+        UINT32 count,
+        WinGetValidateManifestOption option) try
+    {
+        THROW_HR_IF(E_INVALIDARG, count && (!inputPaths || !succeeded));
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            THROW_HR_IF(E_INVALIDARG, !inputPaths[i]);
+            succeeded[i] = FALSE;
+            if (messages)
+            {
+                messages[i] = nullptr;
+            }
+        }
+
+        ManifestValidateOption validateOption;
+        validateOption.FullValidation = true;
+        validateOption.ThrowOnWarning = true;
+        validateOption.SchemaValidationOnly = WI_IsFlagSet(option, WinGetValidateManifestOption::SchemaValidationOnly);
+        validateOption.ErrorOnVerifiedPublisherFields = WI_IsFlagSet(option, WinGetValidateManifestOption::ErrorOnVerifiedPublisherFields);
+
+        // Each manifest is validated independently, and the compiled schemas are shared, so the work is spread across threads.
+        std::vector<std::string> errorMessages(count);
+        std::vector<std::exception_ptr> failures(count);
+        std::atomic<UINT32> nextManifest = 0;
+
+        auto validateManifests = [&]()
+        {
+            for (UINT32 i = nextManifest++; i < count; i = nextManifest++)
+            {
+                try
+                {
+                    (void)YamlParser::CreateFromPath(inputPaths[i], validateOption);
+                    succeeded[i] = TRUE;
+                }
+                catch (const ManifestException& e)
+                {
+                    succeeded[i] = e.IsWarningOnly();
+                    errorMessages[i] = e.GetManifestErrorMessage();
+                }
+                catch (...)
+                {
+                    failures[i] = std::current_exception();
+                }
+            }
+        };
+
+        size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(validateManifests);
+        }
+
+        validateManifests();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        // Report the first failure in input order so that the result does not depend on thread scheduling.
+        for (const auto& failure : failures)
+        {
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        if (messages)
+        {
+            for (UINT32 i = 0; i < count; ++i)
+            {
+                if (!errorMessages[i].empty())
+                {
+                    messages[i] = ::SysAllocString(ConvertToUTF16(errorMessages[i]).c_str());
+                }
+            }
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetValidateManifestDependencies(
         WINGET_STRING inputPath,
         BOOL* succeeded,
@@ -319,6 +558,72 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetDownloads(
+        const WINGET_STRING* urls,
+        const WINGET_STRING* filePaths,
+        HRESULT* results,
+        BYTE* sha256Hashes,
+        UINT32 count,
+        UINT32 maxConcurrency) try
+    {
+        THROW_HR_IF(E_INVALIDARG, count && (!urls || !filePaths || !results));
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            THROW_HR_IF(E_INVALIDARG, !urls[i]);
+            THROW_HR_IF(E_INVALIDARG, !filePaths[i]);
+            results[i] = E_PENDING;
+        }
+
+        constexpr size_t c_sha256HashLength = 32;
+        constexpr UINT32 c_defaultConcurrency = 8;
+
+        // The downloads share the WinINet session of the process, so requests to the same host reuse its connections.
+        std::atomic<UINT32> nextDownload = 0;
+
+        auto runDownloads = [&]()
+        {
+            for (UINT32 i = nextDownload++; i < count; i = nextDownload++)
+            {
+                try
+                {
+                    AppInstaller::ProgressCallback callback;
+                    auto hashValue = Download(ConvertToUTF8(urls[i]), filePaths[i], DownloadType::WinGetUtil, callback, sha256Hashes != nullptr);
+
+                    if (sha256Hashes)
+                    {
+                        const auto& hash = hashValue.value();
+                        THROW_HR_IF(E_UNEXPECTED, hash.size() != c_sha256HashLength);
+                        std::copy(hash.begin(), hash.end(), sha256Hashes + (i * c_sha256HashLength));
+                    }
+
+                    results[i] = S_OK;
+                }
+                catch (...)
+                {
+                    results[i] = wil::ResultFromCaughtException();
+                }
+            }
+        };
+
+        size_t threadCount = std::min<size_t>(maxConcurrency ? maxConcurrency : c_defaultConcurrency, count);
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(runDownloads);
+        }
+
+        runDownloads();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetCompareVersions(
         WINGET_STRING versionA,
         WINGET_STRING versionB,
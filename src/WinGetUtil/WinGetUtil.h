@@ -30,6 +30,13 @@ extern "C"
         ForDelete = 0x1,
     };
 
+    enum WinGetManifestChangeType
+    {
+        ManifestAdded = 0,
+        ManifestModified = 1,
+        ManifestRemoved = 2,
+    };
+
     DEFINE_ENUM_FLAG_OPERATORS(WinGetValidateManifestOption);
 
     // Initializes the logging infrastructure.
@@ -48,6 +55,16 @@ extern "C"
         UINT32 minorVersion,
         WINGET_SQLITE_INDEX_HANDLE* index);
 
+    // Creates a new index file at filePath with the given version, in the same way as WinGetSQLiteIndexCreate.
+    // If manifestContentVersions is not zero, the index also stores the content of the manifest files that are added from a single file,
+    // and keeps it for that many of the highest versions of each package when it is prepared for packaging.
+    WINGET_UTIL_API WinGetSQLiteIndexCreateV2(
+        WINGET_STRING filePath,
+        UINT32 majorVersion,
+        UINT32 minorVersion,
+        UINT32 manifestContentVersions,
+        WINGET_SQLITE_INDEX_HANDLE* index);
+
     // Opens an existing index at filePath.
     WINGET_UTIL_API WinGetSQLiteIndexOpen(
         WINGET_STRING filePath, 
@@ -64,6 +81,28 @@ extern "C"
         WINGET_STRING manifestPath, 
         WINGET_STRING relativePath);
 
+    // Adds the manifests at the repository relative paths to the index.
+    // The manifests are read in parallel and added in a single transaction.
+    // If the function succeeds, all of the manifests have been added; if it fails, none have.
+    WINGET_UTIL_API WinGetSQLiteIndexAddManifests(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        const WINGET_STRING* manifestPaths,
+        const WINGET_STRING* relativePaths,
+        UINT32 count);
+
+    // Applies the changes made to the manifest files in the repository, such as those reported by `git diff --name-status`, to the index.
+    // The added and modified manifests are read in parallel, then all of the changes are made in a single transaction.
+    // Removed manifests are found by their repository relative path, so their manifest path may be null.
+    // If the function succeeds, all of the changes have been made; if it fails, none have.
+    // The out value indicates whether the index was modified by the function.
+    WINGET_UTIL_API WinGetSQLiteIndexApplyManifestChanges(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        const WinGetManifestChangeType* changeTypes,
+        const WINGET_STRING* manifestPaths,
+        const WINGET_STRING* relativePaths,
+        UINT32 count,
+        BOOL* indexModified);
+
     // Updates the manifest with matching { Id, Version, Channel } in the index.
     // The return value indicates whether the index was modified by the function.
     WINGET_UTIL_API WinGetSQLiteIndexUpdateManifest(
@@ -88,6 +127,22 @@ extern "C"
         WINGET_SQLITE_INDEX_HANDLE index,
         BOOL* succeeded);
 
+    // Checks the index for consistency in the same way as WinGetSQLiteIndexCheckConsistency.
+    // If timings is provided, it is set to one line for each check of the index, with the name of the check,
+    // the time in milliseconds that it took and whether it was consistent, separated by tabs.
+    WINGET_UTIL_API WinGetSQLiteIndexCheckConsistencyV2(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        BOOL* succeeded,
+        WINGET_STRING_OUT* timings);
+
+    // Creates a delta that updates the index file at fromIndexPath to the one at toIndexPath.
+    // Both indices should have been prepared for packaging, and neither should be open.
+    // Clients look for the delta at <source root>/delta/<from package version>_<to package version>.delta
+    WINGET_UTIL_API WinGetSQLiteIndexCreateDelta(
+        WINGET_STRING fromIndexPath,
+        WINGET_STRING toIndexPath,
+        WINGET_STRING deltaPath);
+
     // Validates a given manifest. Returns a bool for validation result and
     // a string representing validation errors if validation failed.
     WINGET_UTIL_API WinGetValidateManifest(
@@ -106,6 +161,16 @@ extern "C"
         WINGET_STRING mergedManifestPath,
         WinGetValidateManifestOption option);
 
+    // Validates the given manifests in parallel, each in the same way as WinGetValidateManifestV2 without a merged manifest.
+    // The succeeded and messages arrays must hold count elements; messages may be null, and the message
+    // for a manifest is only set if its validation produced one.
+    WINGET_UTIL_API WinGetValidateManifestsV2(
+        const WINGET_STRING* inputPaths,
+        BOOL* succeeded,
+        WINGET_STRING_OUT* messages,
+        UINT32 count,
+        WinGetValidateManifestOption option);
+
     // Validates a given manifest with dependencies. Returns a bool for validation result and
     // a string representing validation errors if validation failed.
     // If mergedManifestPath is provided, this method will write a merged manifest
@@ -124,6 +189,18 @@ extern "C"
         BYTE* sha256Hash,
         UINT32 sha256HashLength);
 
+    // Downloads files to the given paths in parallel, each in the same way as WinGetDownload.
+    // At most maxConcurrency downloads run at once; 0 uses a default. The results array must hold count elements,
+    // and receives the result of each download; a failed download does not stop the others.
+    // If sha256Hashes is provided, it must hold 32 bytes for each file, and receives the SHA 256 hash of each file that downloaded.
+    WINGET_UTIL_API WinGetDownloads(
+        const WINGET_STRING* urls,
+        const WINGET_STRING* filePaths,
+        HRESULT* results,
+        BYTE* sha256Hashes,
+        UINT32 count,
+        UINT32 maxConcurrency);
+
     // Compares two version strings, returning -1 if versionA is less than versionB, 0 if they're equal, or 1 if versionA is greater than versionB
     WINGET_UTIL_API WinGetCompareVersions(
         WINGET_STRING versionA,
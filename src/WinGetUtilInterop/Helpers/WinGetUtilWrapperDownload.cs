@@ -0,0 +1,88 @@
+﻿// -----------------------------------------------------------------------
+// <copyright file="WinGetUtilWrapperDownload.cs" company="Microsoft Corporation">
+//     Copyright (c) Microsoft Corporation. Licensed under the MIT License.
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace Microsoft.WinGetUtil.Helpers
+{
+    using System;
+    using System.Runtime.InteropServices;
+
+    /// <summary>
+    /// Wrapper class around WinGetUtil download native implementation.
+    /// For dll entry points are defined here:
+    ///     https://github.com/microsoft/winget-cli/blob/master/src/WinGetUtil/WinGetUtil.h.
+    /// </summary>
+    public sealed class WinGetUtilWrapperDownload
+    {
+        private const int Sha256HashLength = 32;
+
+        /// <summary>
+        /// Downloads files in parallel, returning the result and SHA 256 hash of each.
+        /// A failed download does not stop the others; its hash is null.
+        /// </summary>
+        /// <param name="urls">Urls to download.</param>
+        /// <param name="filePaths">Paths to download each url to.</param>
+        /// <param name="maxConcurrency">Maximum number of downloads at once. 0 uses the default.</param>
+        /// <returns>The HRESULT and hash of each download, in the order of the urls.</returns>
+        public static (int result, byte[] sha256Hash)[] Download(
+            string[] urls,
+            string[] filePaths,
+            uint maxConcurrency = 0)
+        {
+            if (urls == null)
+            {
+                throw new ArgumentNullException(nameof(urls));
+            }
+
+            if (filePaths == null)
+            {
+                throw new ArgumentNullException(nameof(filePaths));
+            }
+
+            if (urls.Length != filePaths.Length)
+            {
+                throw new ArgumentException("A file path is needed for each url.", nameof(filePaths));
+            }
+
+            int[] results = new int[urls.Length];
+            byte[] hashes = new byte[urls.Length * Sha256HashLength];
+
+            WinGetDownloads(urls, filePaths, results, hashes, (uint)urls.Length, maxConcurrency);
+
+            var downloads = new (int result, byte[] sha256Hash)[urls.Length];
+            for (int i = 0; i < urls.Length; ++i)
+            {
+                byte[] hash = null;
+                if (results[i] == 0)
+                {
+                    hash = new byte[Sha256HashLength];
+                    Array.Copy(hashes, i * Sha256HashLength, hash, 0, Sha256HashLength);
+                }
+
+                downloads[i] = (results[i], hash);
+            }
+
+            return downloads;
+        }
+
+        /// <summary>
+        /// Downloads files to the given paths in parallel, each in the same way as WinGetDownload.
+        /// </summary>
+        /// <param name="urls">Urls to download.</param>
+        /// <param name="filePaths">Paths to download each url to.</param>
+        /// <param name="results">Out HRESULT of each download.</param>
+        /// <param name="sha256Hashes">Out SHA 256 hash of each download, 32 bytes each.</param>
+        /// <param name="count">Number of downloads.</param>
+        /// <param name="maxConcurrency">Maximum number of downloads at once.</param>
+        [DllImport("WinGetUtil.dll", CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern void WinGetDownloads(
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] urls,
+            [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPWStr)] string[] filePaths,
+            [Out] int[] results,
+            [Out] byte[] sha256Hashes,
+            uint count,
+            uint maxConcurrency);
+    }
+}
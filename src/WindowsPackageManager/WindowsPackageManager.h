@@ -23,4 +23,10 @@ extern "C"
 
     // Unregisters the server module class factories.
     WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerModuleUnregister();
+
+    // Gets the number of objects that the server module has alive.
+    WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerModuleGetObjectCount(UINT32* count);
+
+    // Gets how long in milliseconds the server should stay running once it has no more objects.
+    WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerGetIdleTimeout(UINT32* milliseconds);
 }
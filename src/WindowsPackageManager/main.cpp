@@ -54,4 +54,20 @@ extern "C"
         RETURN_HR(::Microsoft::WRL::Module<::Microsoft::WRL::ModuleType::OutOfProc>::GetModule().UnregisterObjects());
     }
     CATCH_RETURN();
+
+    WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerModuleGetObjectCount(UINT32* count) try
+    {
+        RETURN_HR_IF_NULL(E_POINTER, count);
+        *count = static_cast<UINT32>(::Microsoft::WRL::Module<::Microsoft::WRL::ModuleType::OutOfProc>::GetModule().GetObjectCount());
+        return S_OK;
+    }
+    CATCH_RETURN();
+
+    WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerGetIdleTimeout(UINT32* milliseconds) try
+    {
+        RETURN_HR_IF_NULL(E_POINTER, milliseconds);
+        *milliseconds = static_cast<UINT32>(AppInstaller::CLI::ServerIdleTimeout().count());
+        return S_OK;
+    }
+    CATCH_RETURN();
 }
@@ -0,0 +1,149 @@
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+
+<#
+.SYNOPSIS
+    Converts a binary trace written by winget into text.
+.DESCRIPTION
+    The binary trace file logger (enabled with the logging.binaryTrace setting) writes a .wgtrace file.
+    This script converts it into the same text that the file logger would have written.
+    See src/AppInstallerCommonCore/Public/winget/BinaryTraceLogger.h for the format.
+.PARAMETER Path
+    The path to the .wgtrace file.
+.PARAMETER ShowThreadId
+    Include the id of the thread that wrote each record.
+.EXAMPLE
+    .\Decode-WinGetTrace.ps1 -Path "$env:LOCALAPPDATA\Packages\Microsoft.DesktopAppInstaller_8wekyb3d8bbwe\LocalState\DiagOutputDir\WinGet-2022-01-01-00-00-00.000.wgtrace" > trace.log
+#>
+[CmdletBinding()]
+param(
+    [Parameter(Mandatory=$true)]
+    [string]$Path,
+
+    [switch]$ShowThreadId
+)
+
+$ErrorActionPreference = "Stop"
+
+$channelNames = @("FAIL", "CLI", "SQL", "REPO", "YAML", "CORE", "TEST")
+$channelAll = 7
+$recordHeaderSize = 20
+$utf8 = [System.Text.Encoding]::UTF8
+
+$bytes = [System.IO.File]::ReadAllBytes((Resolve-Path $Path))
+
+if ($bytes.Length -lt 64 -or [System.Text.Encoding]::ASCII.GetString($bytes, 0, 7) -ne "WGTRACE")
+{
+    throw "The file is not a winget binary trace"
+}
+
+$version = [BitConverter]::ToUInt32($bytes, 8)
+if ($version -ne 1)
+{
+    throw "Unsupported trace version: $version"
+}
+
+$headerSize = [BitConverter]::ToUInt32($bytes, 12)
+$nextOffset = [BitConverter]::ToUInt64($bytes, 24)
+$droppedRecords = [BitConverter]::ToUInt64($bytes, 32)
+$end = [Math]::Min([uint64]$bytes.Length, $nextOffset)
+
+# Text payloads may be followed by padding.
+function Get-Text([int]$offset, [int]$length)
+{
+    while ($length -gt 0 -and $bytes[$offset + $length - 1] -eq 0)
+    {
+        $length--
+    }
+    return $utf8.GetString($bytes, $offset, $length)
+}
+
+# Replaces each placeholder in the format with the next encoded argument.
+function Format-Event([string]$format, [int]$offset, [int]$end)
+{
+    $result = [System.Text.StringBuilder]::new()
+    $parts = $format -split "\{\}", -1
+
+    [void]$result.Append($parts[0])
+    for ($i = 1; $i -lt $parts.Length; $i++)
+    {
+        $value = "{}"
+        if ($offset -lt $end)
+        {
+            switch ($bytes[$offset])
+            {
+                1 { $value = [BitConverter]::ToInt64($bytes, $offset + 1).ToString(); $offset += 9 }
+                2 { $value = [BitConverter]::ToDouble($bytes, $offset + 1).ToString([System.Globalization.CultureInfo]::InvariantCulture); $offset += 9 }
+                3 { $value = [string]$bytes[$offset + 1]; $offset += 2 }
+                4 {
+                    $length = [BitConverter]::ToUInt32($bytes, $offset + 1)
+                    $value = $utf8.GetString($bytes, $offset + 5, $length)
+                    $offset += 5 + $length
+                }
+                default { $offset = $end }
+            }
+        }
+        [void]$result.Append($value).Append($parts[$i])
+    }
+
+    return $result.ToString()
+}
+
+$formats = @{}
+$offset = [uint64]$headerSize
+
+while ($offset + $recordHeaderSize -le $end)
+{
+    $size = [BitConverter]::ToUInt32($bytes, $offset)
+    if ($size -eq 0)
+    {
+        break
+    }
+
+    $type = $bytes[$offset + 4]
+    $channel = $bytes[$offset + 5]
+    $threadId = [BitConverter]::ToUInt32($bytes, $offset + 8)
+    $ticks = [BitConverter]::ToInt64($bytes, $offset + 12)
+    $payload = [int]($offset + $recordHeaderSize)
+    $payloadEnd = [int]($offset + $size)
+
+    $message = $null
+    switch ($type)
+    {
+        1 { $message = Get-Text $payload ($payloadEnd - $payload) }
+        2 { $formats[[BitConverter]::ToUInt16($bytes, $payload)] = Get-Text ($payload + 2) ($payloadEnd - $payload - 2) }
+        3 {
+            $id = [BitConverter]::ToUInt16($bytes, $payload)
+            if ($formats.ContainsKey($id))
+            {
+                $message = Format-Event $formats[$id] ($payload + 2) $payloadEnd
+            }
+            else
+            {
+                $message = "<event $id with no definition>"
+            }
+        }
+    }
+
+    if ($null -ne $message)
+    {
+        if ($channel -eq $channelAll)
+        {
+            Write-Output $message
+        }
+        else
+        {
+            $time = [DateTimeOffset]::FromUnixTimeMilliseconds([Math]::Floor($ticks / 10000)).LocalDateTime.ToString("yyyy-MM-dd HH:mm:ss.fff")
+            $channelName = if ($channel -lt $channelNames.Length) { $channelNames[$channel] } else { "NONE" }
+            $thread = if ($ShowThreadId) { " <$threadId>" } else { "" }
+            Write-Output ("{0} [{1,-4}]{2} {3}" -f $time, $channelName, $thread, $message)
+        }
+    }
+
+    $offset += $size
+}
+
+if ($droppedRecords -gt 0)
+{
+    Write-Output "<$droppedRecords log records were dropped>"
+}
@@ -0,0 +1,60 @@
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT License.
+
+<#
+.SYNOPSIS
+    Measures how long winget takes to start for a set of common invocations.
+.DESCRIPTION
+    Runs each invocation repeatedly and reports the minimum, median and maximum wall clock time.
+    With -ShowStages, the invocations are also run once with the hidden --perf argument, which displays
+    the time spent in each startup stage (Startup::Logging, Startup::Telemetry, Startup::ParseArguments)
+    and in the command itself.
+.PARAMETER WinGet
+    The path to the winget executable to measure.
+.PARAMETER Iterations
+    The number of times to run each invocation.
+.PARAMETER ShowStages
+    Also display the --perf report for each invocation.
+.EXAMPLE
+    .\Measure-WinGetStartup.ps1 -WinGet ..\src\x64\Release\WindowsPackageManager\winget.exe -Iterations 50
+#>
+[CmdletBinding()]
+param(
+    [string]$WinGet = "winget",
+
+    [int]$Iterations = 20,
+
+    [switch]$ShowStages
+)
+
+$ErrorActionPreference = "Stop"
+
+$invocations = @(
+    @("--version"),
+    @("complete", "--word", "ins", "--commandline", "winget ins", "--position", "10"),
+    @("complete", "--word", "Microsoft.", "--commandline", "winget install Microsoft.", "--position", "25"),
+    @("--info"),
+    @("source", "list")
+)
+
+foreach ($invocation in $invocations)
+{
+    $times = @()
+    for ($i = 0; $i -lt $Iterations; ++$i)
+    {
+        $times += (Measure-Command { & $WinGet @invocation | Out-Null }).TotalMilliseconds
+    }
+
+    $sorted = $times | Sort-Object
+    [PSCustomObject]@{
+        Invocation = $invocation -join " "
+        MinMs = [Math]::Round($sorted[0], 1)
+        MedianMs = [Math]::Round($sorted[[int][Math]::Floor($sorted.Count / 2)], 1)
+        MaxMs = [Math]::Round($sorted[-1], 1)
+    }
+
+    if ($ShowStages)
+    {
+        & $WinGet @invocation --perf | Out-Host
+    }
+}